@@ -78,7 +78,7 @@ system and have headers present:
 
  - Armadillo >= 6.500.0 (with LAPACK support)
  - Boost (math_c99, program_options, serialization, unit_test_framework, heap,
-          spirit) >= 1.49
+          spirit, iostreams with zlib) >= 1.49
 
 For Python bindings, the following packages are required:
 
@@ -149,6 +149,11 @@ The full list of options mlpack allows:
        of CXXFLAGS (default OFF)
  - USE_OPENMP=(ON/OFF): if ON, then use OpenMP if the compiler supports it; if
        OFF, OpenMP support is manually disabled (default ON)
+ - USE_NVBLAS=(ON/OFF): if ON, link against NVBLAS (part of the CUDA toolkit)
+       so that large matrix multiplications, like those of the \c Linear and
+       recurrent layers of neural networks, run on the GPU; set the
+       \c NVBLAS_CONFIG_FILE environment variable to the \c nvblas.conf file in
+       the build directory when running mlpack (default OFF)
 
 Each option can be specified to CMake with the '-D' flag.  Other tools can also
 be used to configure CMake, but those are not documented here.
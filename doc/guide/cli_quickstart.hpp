@@ -193,6 +193,23 @@ Dr. Strangelove or: How I Learned to Stop Worrying and Love the Bomb (1964)
 Schindler's List (1993)
 @endcode
 
+@section cli_quickstart_server Running many queries with one model
+
+Each run of an mlpack program loads its input models from disk again, which
+can take longer than the queries themselves when the model is large.  With the
+\c --server option, a program instead reads the options of one run per line of
+its standard input, and keeps the input models loaded between the runs (a
+model is loaded again if its file changes).  After each run, the program
+writes \c "mlpack: done" (or \c "mlpack: failed") on a line of its standard
+output.
+
+@code{.sh}
+$ mlpack_knn --server <<EOF
+--input_model_file knn.bin --query_file q1.csv -k 5 --neighbors_file n1.csv
+--input_model_file knn.bin --query_file q2.csv -k 5 --neighbors_file n2.csv
+EOF
+@endcode
+
 @section cli_quickstart_nextsteps Next steps with mlpack
 
 Now that you have done some simple work with mlpack, you have seen how it can
@@ -0,0 +1,112 @@
+/**
+ * @file ann_benchmark.cpp
+ *
+ * Benchmarks of the forward and backward passes of neural network layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+using namespace mlpack::ann;
+
+/**
+ * Forward pass of a square Linear layer on a batch of 64 points; the argument
+ * of the benchmark is the size of the layer.
+ */
+static void BM_LinearForward(benchmark::State& state)
+{
+  math::RandomSeed(42);
+  Linear<> layer(state.range(0), state.range(0));
+  layer.Parameters().randu();
+  layer.Reset();
+
+  arma::mat input = arma::randu<arma::mat>(state.range(0), 64), output;
+  for (auto _ : state)
+  {
+    layer.Forward(std::move(input), std::move(output));
+    benchmark::DoNotOptimize(output.memptr());
+  }
+}
+
+/**
+ * Backward pass and gradient computation of a square Linear layer on a batch
+ * of 64 points; the argument of the benchmark is the size of the layer.
+ */
+static void BM_LinearBackward(benchmark::State& state)
+{
+  math::RandomSeed(42);
+  Linear<> layer(state.range(0), state.range(0));
+  layer.Parameters().randu();
+  layer.Reset();
+
+  arma::mat input = arma::randu<arma::mat>(state.range(0), 64), output;
+  arma::mat error = arma::randu<arma::mat>(state.range(0), 64), delta;
+  arma::mat gradient(layer.Parameters().n_elem, 1);
+  layer.Forward(std::move(input), std::move(output));
+  for (auto _ : state)
+  {
+    layer.Backward(std::move(output), std::move(error), std::move(delta));
+    layer.Gradient(std::move(input), std::move(error), std::move(gradient));
+    benchmark::DoNotOptimize(gradient.memptr());
+  }
+}
+
+/**
+ * Forward and backward pass of the given activation layer on a batch of 64
+ * points; the argument of the benchmark is the size of each point.
+ */
+template<typename LayerType>
+static void BM_ActivationForwardBackward(benchmark::State& state)
+{
+  math::RandomSeed(42);
+  LayerType layer;
+  arma::mat input = arma::randn<arma::mat>(state.range(0), 64), output;
+  arma::mat error = arma::randu<arma::mat>(state.range(0), 64), delta;
+  for (auto _ : state)
+  {
+    layer.Forward(std::move(input), std::move(output));
+    layer.Backward(std::move(output), std::move(error), std::move(delta));
+    benchmark::DoNotOptimize(delta.memptr());
+  }
+}
+
+/**
+ * Forward and backward pass of a 3x3 Convolution layer from 3 to 16 maps on
+ * one image; the argument of the benchmark is the width (and height) of the
+ * image.
+ */
+static void BM_ConvolutionForwardBackward(benchmark::State& state)
+{
+  math::RandomSeed(42);
+  const size_t size = state.range(0);
+  Convolution<> layer(3, 16, 3, 3, 1, 1, 1, 1, size, size);
+  layer.Parameters().randu();
+  layer.Reset();
+
+  arma::mat input = arma::randu<arma::mat>(3 * size * size, 1), output;
+  layer.Forward(std::move(input), std::move(output));
+  arma::mat error = arma::randu<arma::mat>(output.n_rows, 1), delta;
+  for (auto _ : state)
+  {
+    layer.Forward(std::move(input), std::move(output));
+    layer.Backward(std::move(output), std::move(error), std::move(delta));
+    benchmark::DoNotOptimize(delta.memptr());
+  }
+}
+
+BENCHMARK(BM_LinearForward)->Arg(64)->Arg(256)->Arg(1024);
+BENCHMARK(BM_LinearBackward)->Arg(64)->Arg(256)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_ActivationForwardBackward, SigmoidLayer<>)
+    ->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_ActivationForwardBackward, ReLULayer<>)
+    ->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_ActivationForwardBackward, TanHLayer<>)
+    ->Arg(256)->Arg(4096);
+BENCHMARK(BM_ConvolutionForwardBackward)->Arg(32)->Arg(64)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,15 @@
+/**
+ * @file benchmark_main.cpp
+ *
+ * Entry point of the mlpack_benchmark program.  Run mlpack_benchmark --help to
+ * see the Google Benchmark options; --benchmark_filter selects benchmarks and
+ * --benchmark_out saves the results (as JSON by default).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <benchmark/benchmark.h>
+
+BENCHMARK_MAIN();
@@ -0,0 +1,81 @@
+#!/usr/bin/env python
+"""
+compare_benchmarks.py: compare two sets of mlpack_benchmark results.
+
+The results are the JSON files written by 'make run_benchmarks' (or by
+mlpack_benchmark --benchmark_out=<file> --benchmark_out_format=json).  Each
+benchmark that is in both files is listed with its change in real time; if any
+benchmark got slower by more than the threshold, the script exits with status
+1, so that it can be used to catch performance regressions.
+
+mlpack is free software; you may redistribute it and/or modify it under the
+terms of the 3-clause BSD license.  You should have received a copy of the
+3-clause BSD license along with mlpack.  If not, see
+http://www.opensource.org/licenses/BSD-3-Clause for more information.
+"""
+import argparse
+import json
+import sys
+
+def load_results(filename):
+  """
+  Return a dictionary mapping the name of each benchmark in the given file to
+  its real time, in nanoseconds.  If the benchmarks were repeated, the mean of
+  the repetitions is used.
+  """
+  units = { 'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9 }
+  with open(filename) as f:
+    data = json.load(f)
+
+  times = {}
+  for b in data['benchmarks']:
+    # Only keep the aggregates of repeated benchmarks, if there are any.
+    if b.get('run_type') == 'aggregate' and b.get('aggregate_name') != 'mean':
+      continue
+    name = b.get('run_name', b['name'])
+    time = b['real_time'] * units[b.get('time_unit', 'ns')]
+    if b.get('run_type') == 'aggregate' or name not in times:
+      times[name] = time
+
+  return times
+
+def main():
+  parser = argparse.ArgumentParser(description='Compare two sets of '
+      'mlpack_benchmark results and report regressions.')
+  parser.add_argument('baseline', help='JSON results of the baseline build.')
+  parser.add_argument('contender', help='JSON results of the new build.')
+  parser.add_argument('-t', '--threshold', type=float, default=10.0,
+      help='Slowdown, in percent, above which a benchmark is reported as a '
+      'regression (default 10).')
+  args = parser.parse_args()
+
+  baseline = load_results(args.baseline)
+  contender = load_results(args.contender)
+
+  regressions = []
+  names = [n for n in sorted(contender) if n in baseline]
+  width = max([len(n) for n in names] + [9])
+  print('%-*s %14s %14s %9s' % (width, 'benchmark', 'baseline (ns)',
+      'new (ns)', 'change'))
+  for name in names:
+    change = 100.0 * (contender[name] - baseline[name]) / baseline[name]
+    flag = ''
+    if change > args.threshold:
+      regressions.append(name)
+      flag = '  REGRESSION'
+    print('%-*s %14.0f %14.0f %+8.1f%%%s' % (width, name, baseline[name],
+        contender[name], change, flag))
+
+  for name in sorted(set(baseline) ^ set(contender)):
+    print('%s: only in %s' % (name, args.baseline if name in baseline else
+        args.contender))
+
+  if regressions:
+    print('\n%d benchmark(s) slower by more than %.1f%%.' % (len(regressions),
+        args.threshold))
+    return 1
+
+  return 0
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,68 @@
+/**
+ * @file kmeans_benchmark.cpp
+ *
+ * Benchmarks of a single step of each k-means algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+#include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
+#include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+using namespace mlpack::kmeans;
+
+/**
+ * Run Lloyd iterations of the given type on a dataset of 10 Gaussian clusters,
+ * starting from the same random centroids each time; the argument of the
+ * benchmark is the number of points.  Each timed iteration builds the step
+ * object (and so its tree, if any) and runs five steps, since the pruning of
+ * the accelerated algorithms only pays off after the first step.
+ */
+template<template<class, class> class LloydStepType>
+static void BM_KMeansSteps(benchmark::State& state)
+{
+  math::RandomSeed(42);
+  const size_t clusters = 10;
+  arma::mat data = arma::randn<arma::mat>(5, state.range(0));
+  const arma::mat offsets = 10 * arma::randu<arma::mat>(5, clusters);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    data.col(i) += offsets.col(i % clusters);
+  const arma::mat initialCentroids = arma::randu<arma::mat>(5, clusters);
+
+  metric::EuclideanDistance metric;
+  for (auto _ : state)
+  {
+    LloydStepType<metric::EuclideanDistance, arma::mat> step(data, metric);
+    arma::mat centroids = initialCentroids;
+    arma::mat newCentroids;
+    arma::Col<size_t> counts(clusters);
+    for (size_t i = 0; i < 5; ++i)
+    {
+      step.Iterate(centroids, newCentroids, counts);
+      centroids.swap(newCentroids);
+    }
+
+    benchmark::DoNotOptimize(centroids.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * 5 * data.n_cols);
+}
+
+BENCHMARK(BM_KMeansSteps<NaiveKMeans>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_KMeansSteps<ElkanKMeans>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_KMeansSteps<HamerlyKMeans>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_KMeansSteps<PellegMooreKMeans>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_KMeansSteps<DefaultDualTreeKMeans>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
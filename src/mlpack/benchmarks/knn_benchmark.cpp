@@ -0,0 +1,58 @@
+/**
+ * @file knn_benchmark.cpp
+ *
+ * Benchmarks of dual-tree k-nearest-neighbor search with each type of tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::tree;
+
+/**
+ * Find the 5 nearest neighbors of every point of a uniformly random dataset
+ * with dual-tree search; the argument of the benchmark is the number of points.
+ * The trees are built before the timed loop, so only the search is measured.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+static void BM_DualTreeKNN(benchmark::State& state)
+{
+  math::RandomSeed(42);
+  arma::mat data = arma::randu<arma::mat>(5, state.range(0));
+  NeighborSearch<NearestNeighborSort, metric::EuclideanDistance, arma::mat,
+      TreeType> knn(std::move(data));
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  for (auto _ : state)
+  {
+    knn.Search(5, neighbors, distances);
+    benchmark::DoNotOptimize(distances.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_DualTreeKNN<KDTree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DualTreeKNN<BallTree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DualTreeKNN<StandardCoverTree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DualTreeKNN<RTree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DualTreeKNN<RStarTree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DualTreeKNN<VPTree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DualTreeKNN<Octree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,83 @@
+/**
+ * @file load_benchmark.cpp
+ *
+ * Benchmarks of loading CSV files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+
+using namespace mlpack;
+
+/**
+ * Load a numeric CSV file with 10 columns; the argument of the benchmark is
+ * the number of rows.  The file is written to the working directory before the
+ * timed loop and removed afterwards.
+ */
+static void BM_LoadCSV(benchmark::State& state)
+{
+  math::RandomSeed(42);
+  const std::string filename = "mlpack_benchmark_load.csv";
+  const arma::mat data = arma::randu<arma::mat>(10, state.range(0));
+  data::Save(filename, data, true);
+
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  const size_t bytes = file.tellg();
+  file.close();
+
+  arma::mat loaded;
+  for (auto _ : state)
+  {
+    data::Load(filename, loaded, true);
+    benchmark::DoNotOptimize(loaded.memptr());
+  }
+
+  state.SetBytesProcessed(state.iterations() * bytes);
+  remove(filename.c_str());
+}
+
+/**
+ * Load a CSV file with 5 numeric and 5 categorical columns into a matrix and a
+ * DatasetInfo; the argument of the benchmark is the number of rows.
+ */
+static void BM_LoadCategoricalCSV(benchmark::State& state)
+{
+  math::RandomSeed(42);
+  const std::string filename = "mlpack_benchmark_load_categorical.csv";
+  {
+    std::ofstream file(filename);
+    for (size_t i = 0; i < (size_t) state.range(0); ++i)
+    {
+      for (size_t j = 0; j < 5; ++j)
+        file << math::Random() << ",";
+      for (size_t j = 0; j < 5; ++j)
+        file << "c" << math::RandInt(100) << ((j < 4) ? "," : "\n");
+    }
+  }
+
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  const size_t bytes = file.tellg();
+  file.close();
+
+  arma::mat loaded;
+  for (auto _ : state)
+  {
+    data::DatasetInfo info;
+    data::Load(filename, loaded, info, true);
+    benchmark::DoNotOptimize(loaded.memptr());
+  }
+
+  state.SetBytesProcessed(state.iterations() * bytes);
+  remove(filename.c_str());
+}
+
+BENCHMARK(BM_LoadCSV)->Arg(10000)->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadCategoricalCSV)->Arg(10000)->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
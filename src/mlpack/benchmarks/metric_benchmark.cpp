@@ -0,0 +1,43 @@
+/**
+ * @file metric_benchmark.cpp
+ *
+ * Benchmarks of the LMetric distance kernels.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+using namespace mlpack::metric;
+
+/**
+ * Evaluate the distance between 1000 pairs of random points; the argument of
+ * the benchmark is the dimensionality of the points.
+ */
+template<int Power, bool TakeRoot>
+static void BM_LMetric(benchmark::State& state)
+{
+  math::RandomSeed(42);
+  const arma::mat a = arma::randu<arma::mat>(state.range(0), 1000);
+  const arma::mat b = arma::randu<arma::mat>(state.range(0), 1000);
+
+  for (auto _ : state)
+  {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.n_cols; ++i)
+      sum += LMetric<Power, TakeRoot>::Evaluate(a.col(i), b.col(i));
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * a.n_cols);
+}
+
+BENCHMARK_TEMPLATE(BM_LMetric, 1, false)->Arg(3)->Arg(32)->Arg(512);
+BENCHMARK_TEMPLATE(BM_LMetric, 2, false)->Arg(3)->Arg(32)->Arg(512);
+BENCHMARK_TEMPLATE(BM_LMetric, 2, true)->Arg(3)->Arg(32)->Arg(512);
+BENCHMARK_TEMPLATE(BM_LMetric, 3, true)->Arg(3)->Arg(32)->Arg(512);
+BENCHMARK_TEMPLATE(BM_LMetric, INT_MAX, false)->Arg(3)->Arg(32)->Arg(512);
@@ -0,0 +1,52 @@
+/**
+ * @file sgd_benchmark.cpp
+ *
+ * Benchmarks of SGD with each update policy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/adam/adam_update.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression_function.hpp>
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::regression;
+
+/**
+ * Run one epoch of SGD with the given update policy on a logistic regression
+ * problem; the argument of the benchmark is the dimensionality of the problem.
+ */
+template<typename UpdatePolicyType>
+static void BM_SGDEpoch(benchmark::State& state)
+{
+  math::RandomSeed(42);
+  const arma::mat predictors = arma::randn<arma::mat>(state.range(0), 10000);
+  const arma::Row<size_t> responses = arma::conv_to<arma::Row<size_t>>::from(
+      arma::sum(predictors, 0) > 0);
+  LogisticRegressionFunction<> f(predictors, responses, 0.001);
+
+  // A negative tolerance never stops the optimization early.
+  SGD<UpdatePolicyType> sgd(0.01, 32, predictors.n_cols, -1.0, false);
+  for (auto _ : state)
+  {
+    arma::mat coordinates = f.GetInitialPoint();
+    benchmark::DoNotOptimize(sgd.Optimize(f, coordinates));
+  }
+
+  state.SetItemsProcessed(state.iterations() * predictors.n_cols);
+}
+
+BENCHMARK_TEMPLATE(BM_SGDEpoch, VanillaUpdate)->Arg(10)->Arg(100)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SGDEpoch, MomentumUpdate)->Arg(10)->Arg(100)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SGDEpoch, NesterovMomentumUpdate)->Arg(10)->Arg(100)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SGDEpoch, AdamUpdate)->Arg(10)->Arg(100)
+    ->Unit(benchmark::kMillisecond);
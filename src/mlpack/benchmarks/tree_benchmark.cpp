@@ -0,0 +1,55 @@
+/**
+ * @file tree_benchmark.cpp
+ *
+ * Benchmarks of the construction of each type of tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/octree.hpp>
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+/**
+ * Build a tree of the given type on uniformly random points; the argument of
+ * the benchmark is the number of points.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+static void BM_TreeBuild(benchmark::State& state)
+{
+  math::RandomSeed(42);
+  const arma::mat data = arma::randu<arma::mat>(5, state.range(0));
+
+  for (auto _ : state)
+  {
+    TreeType<metric::EuclideanDistance, EmptyStatistic, arma::mat> tree(data);
+    benchmark::DoNotOptimize(tree.NumChildren());
+  }
+
+  state.SetItemsProcessed(state.iterations() * data.n_cols);
+}
+
+BENCHMARK(BM_TreeBuild<KDTree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TreeBuild<BallTree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TreeBuild<StandardCoverTree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TreeBuild<RTree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TreeBuild<RStarTree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TreeBuild<VPTree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TreeBuild<Octree>)->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
@@ -3,7 +3,8 @@
  * @author Ryan Curtin
  * @author Matthew Amidon
  *
- * Terminate the program; handle --verbose option; print output parameters.
+ * Terminate the program; handle --verbose and --timing_output options; print
+ * output parameters.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -14,11 +15,83 @@
 #define MLPACK_BINDINGS_CLI_END_PROGRAM_HPP
 
 #include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/memory_usage.hpp>
+#include "model_cache.hpp"
+#include <fstream>
+#include <iomanip>
+#include <unordered_set>
 
 namespace mlpack {
 namespace bindings {
 namespace cli {
 
+/**
+ * Delete the memory held by the parameters.  If we are holding any pointers,
+ * then we "own" them, except for the models held by the ModelCache when
+ * running as a server.  This is called by EndProgram(), and also after a
+ * request of the server fails.
+ */
+inline void CleanMemory()
+{
+  // We may hold the same pointer twice, so we have to be careful to not delete
+  // it multiple times.
+  const std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
+  std::map<std::string, util::ParamData>::const_iterator it =
+      parameters.begin();
+  std::unordered_map<void*, const util::ParamData*> memoryAddresses;
+  std::unordered_set<void*> outputAddresses;
+  while (it != parameters.end())
+  {
+    const util::ParamData& data = it->second;
+
+    void* result;
+    CLI::GetSingleton().functionMap[data.tname]["GetAllocatedMemory"](data,
+        NULL, (void*) &result);
+    if (result != NULL && memoryAddresses.count(result) == 0)
+      memoryAddresses[result] = &data;
+    if (result != NULL && !data.input && data.wasPassed)
+      outputAddresses.insert(result);
+
+    ++it;
+  }
+
+  // Now we have all the unique addresses that need to be deleted.  A cached
+  // model is kept, unless it is also an output model that the user asked to
+  // save: then the program may have modified it, and the cache gives it up.
+  std::unordered_map<void*, const util::ParamData*>::const_iterator it2;
+  it2 = memoryAddresses.begin();
+  while (it2 != memoryAddresses.end())
+  {
+    const util::ParamData& data = *(it2->second);
+
+    if (ModelCache::Contains(it2->first))
+    {
+      if (outputAddresses.count(it2->first) == 0)
+      {
+        ++it2;
+        continue;
+      }
+
+      ModelCache::Release(it2->first);
+    }
+
+    CLI::GetSingleton().functionMap[data.tname]["DeleteAllocatedMemory"](data,
+        NULL, NULL);
+
+    ++it2;
+  }
+}
+
+/**
+ * Format the given number of bytes for --verbose output, in MiB.
+ */
+inline std::string PrintMemory(const size_t bytes)
+{
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1) << (bytes / 1048576.0) << " MiB";
+  return oss.str();
+}
+
 /**
  * Handle command-line program termination.  If --help or --info was passed, we
  * won't make it here, so we don't have to write any contingencies for that.
@@ -28,6 +101,26 @@ inline void EndProgram()
   // Stop the CLI timers.
   CLI::GetSingleton().timer.StopAllTimers();
 
+  // Make sure all log messages are written before any output.
+  util::LogSink::Flush();
+
+  // Write the timers as a trace, if requested.
+  if (CLI::Parameters().count("timing_output") > 0 &&
+      CLI::HasParam("timing_output"))
+  {
+    const std::string filename = CLI::GetParam<std::string>("timing_output");
+    std::ofstream stream(filename.c_str());
+    if (!stream.is_open())
+    {
+      Log::Warn << "Could not open '" << filename << "' for writing; timers "
+          << "will not be saved." << std::endl;
+    }
+    else
+    {
+      CLI::GetSingleton().timer.WriteTrace(stream);
+    }
+  }
+
   // Print any output.
   const std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
   std::map<std::string, util::ParamData>::const_iterator it =
@@ -71,38 +164,38 @@ inline void EndProgram()
       Log::Info << "  " << it2.first << ": ";
       CLI::GetSingleton().timer.PrintTimer(it2.first);
     }
-  }
 
-  // Lastly clean up any memory.  If we are holding any pointers, then we "own"
-  // them.  But we may hold the same pointer twice, so we have to be careful to
-  // not delete it multiple times.
-  std::unordered_map<void*, const util::ParamData*> memoryAddresses;
-  it = parameters.begin();
-  while (it != parameters.end())
-  {
-    const util::ParamData& data = it->second;
-
-    void* result;
-    CLI::GetSingleton().functionMap[data.tname]["GetAllocatedMemory"](data,
-        NULL, (void*) &result);
-    if (result != NULL && memoryAddresses.count(result) == 0)
-      memoryAddresses[result] = &data;
+    const std::map<std::string, size_t> counters =
+        CLI::GetSingleton().timer.GetAllCounters();
+    if (!counters.empty())
+    {
+      Log::Info << "Program counters:" << std::endl;
+      for (auto it2 : counters)
+        Log::Info << "  " << it2.first << ": " << it2.second << std::endl;
+    }
 
-    ++it;
+    const std::map<std::string, MemoryStatistics> memory =
+        CLI::GetSingleton().timer.GetAllMemoryStatistics();
+    if (!memory.empty())
+    {
+      Log::Info << "Program memory usage:" << std::endl;
+      for (auto it2 : memory)
+      {
+        Log::Info << "  " << it2.first << ": peak " << PrintMemory(
+            it2.second.peak) << ", growth " << PrintMemory(it2.second.growth)
+            << ", at end " << PrintMemory(it2.second.current);
+        if (util::AllocationsTracked())
+          Log::Info << ", " << it2.second.allocations << " allocations";
+        Log::Info << std::endl;
+      }
+
+      Log::Info << "  peak resident memory: "
+          << PrintMemory(util::PeakResidentMemory()) << std::endl;
+    }
   }
 
-  // Now we have all the unique addresses that need to be deleted.
-  std::unordered_map<void*, const util::ParamData*>::const_iterator it2;
-  it2 = memoryAddresses.begin();
-  while (it2 != memoryAddresses.end())
-  {
-    const util::ParamData& data = *(it2->second);
-
-    CLI::GetSingleton().functionMap[data.tname]["DeleteAllocatedMemory"](data,
-        NULL, NULL);
-
-    ++it2;
-  }
+  // Lastly clean up any memory.
+  CleanMemory();
 }
 
 } // namespace cli
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "parameter_type.hpp"
+#include "model_cache.hpp"
 
 namespace mlpack {
 namespace bindings {
@@ -106,14 +107,23 @@ T*& GetParam(
     const typename boost::enable_if<data::HasSerialize<T>>::type* = 0)
 {
   // If the model is an input model, we have to load it from file.  'value'
-  // contains the filename.
+  // contains the filename.  When running as a server, the model may already
+  // have been loaded by an earlier request.
   typedef std::tuple<T*, std::string> TupleType;
   TupleType* tuple = boost::any_cast<TupleType>(&d.value);
   const std::string& value = std::get<1>(*tuple);
   if (d.input && !d.loaded)
   {
-    T* model = new T();
-    data::Load(value, "model", *model, true);
+    T* model;
+    if (ModelCache::Enabled())
+    {
+      model = ModelCache::Load<T>(value);
+    }
+    else
+    {
+      model = new T();
+      data::Load(value, "model", *model, true);
+    }
     d.loaded = true;
     std::get<0>(*tuple) = model;
   }
@@ -0,0 +1,164 @@
+/**
+ * @file model_cache.hpp
+ *
+ * A cache of the input models loaded by a command-line program running with
+ * --server, so that a model is only deserialized once for all the requests
+ * that use it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_MODEL_CACHE_HPP
+#define MLPACK_BINDINGS_CLI_MODEL_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/load.hpp>
+
+#include <sys/stat.h>
+#include <functional>
+#include <typeinfo>
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * The ModelCache holds the models loaded from input model files while the
+ * program runs as a server.  Each model is identified by its filename and its
+ * type, and is loaded again if the modification time or the size of the file
+ * changes.  The cache owns its models: EndProgram() does not delete them,
+ * unless the model is also held by an output model parameter that was passed,
+ * since the program may then have modified it (see Release()).
+ *
+ * The cache is disabled (and GetParam() loads a new model every time) unless
+ * Enabled() is set, which only RunServer() does.
+ */
+class ModelCache
+{
+ public:
+  //! Modify whether input models are cached.
+  static bool& Enabled()
+  {
+    static bool enabled = false;
+    return enabled;
+  }
+
+  /**
+   * Get the model stored in the given file, loading it if it isn't cached or
+   * if the file has changed since it was loaded.  An exception is thrown (by
+   * Log::Fatal) if the model can't be loaded.
+   *
+   * @param filename File to load the model from.
+   */
+  template<typename T>
+  static T* Load(const std::string& filename)
+  {
+    const KeyType key(filename, typeid(T).name());
+    const std::pair<time_t, off_t> version = FileVersion(filename);
+
+    std::map<KeyType, Entry>& entries = Entries();
+    typename std::map<KeyType, Entry>::iterator it = entries.find(key);
+    if (it != entries.end())
+    {
+      if (it->second.version == version)
+        return static_cast<T*>(it->second.model);
+
+      // The file has changed, so forget the old model.
+      it->second.deleter();
+      entries.erase(it);
+    }
+
+    T* model = new T();
+    try
+    {
+      data::Load(filename, "model", *model, true);
+    }
+    catch (...)
+    {
+      delete model;
+      throw;
+    }
+
+    Entry& entry = entries[key];
+    entry.model = model;
+    entry.version = version;
+    entry.deleter = [model]() { delete model; };
+    return model;
+  }
+
+  //! Return whether the given model is held by the cache.
+  static bool Contains(const void* model)
+  {
+    for (const std::pair<const KeyType, Entry>& entry : Entries())
+      if (entry.second.model == model)
+        return true;
+
+    return false;
+  }
+
+  /**
+   * Remove the given model from the cache without deleting it; the caller
+   * takes ownership of it.
+   */
+  static void Release(const void* model)
+  {
+    std::map<KeyType, Entry>& entries = Entries();
+    for (typename std::map<KeyType, Entry>::iterator it = entries.begin();
+         it != entries.end(); ++it)
+    {
+      if (it->second.model == model)
+      {
+        entries.erase(it);
+        return;
+      }
+    }
+  }
+
+  //! Delete all of the cached models.
+  static void Clear()
+  {
+    for (std::pair<const KeyType, Entry>& entry : Entries())
+      entry.second.deleter();
+    Entries().clear();
+  }
+
+ private:
+  //! The filename and the type name of a model.
+  typedef std::pair<std::string, std::string> KeyType;
+
+  //! A cached model.
+  struct Entry
+  {
+    //! The model.
+    void* model;
+    //! The modification time and size of the file when the model was loaded.
+    std::pair<time_t, off_t> version;
+    //! Delete the model.
+    std::function<void()> deleter;
+  };
+
+  //! Get the cached models.
+  static std::map<KeyType, Entry>& Entries()
+  {
+    static std::map<KeyType, Entry> entries;
+    return entries;
+  }
+
+  //! Get the modification time and size of a file (zero if it doesn't exist).
+  static std::pair<time_t, off_t> FileVersion(const std::string& filename)
+  {
+    struct stat status;
+    if (stat(filename.c_str(), &status) != 0)
+      return std::make_pair(time_t(0), off_t(0));
+
+    return std::make_pair(status.st_mtime, status.st_size);
+  }
+};
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
@@ -27,6 +27,19 @@ PARAM_STRING_IN("info", "Get help on a specific module or option.", "", "");
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_STRING_IN("timing_output", "If specified, write all timers and their "
+    "statistics (including the memory used while they run) to this file in "
+    "the Chrome trace-event JSON format.", "", "");
+PARAM_FLAG("server", "Run as a server: read the options of one run of the "
+    "program per line of standard input, keeping the input models loaded "
+    "between runs.", "");
+PARAM_INT_IN("threads", "Number of threads to use (0 uses one thread per "
+    "processor).  The BLAS library uses as many threads outside of the "
+    "parallel regions of the program, and one thread inside them.", "", 0);
+PARAM_FLAG("first_touch", "If set, the memory of each loaded matrix is first "
+    "written by the threads of the program, so that on NUMA systems each "
+    "thread's columns are on its own node (pin the threads with "
+    "OMP_PROC_BIND=close).", "");
 
 /**
  * Parse the command line, setting all of the options inside of the CLI object
@@ -174,6 +187,28 @@ void ParseCommandLine(int argc, char** argv)
     Log::Info.ignoreInput = false;
   }
 
+  // Track the memory used while each timer runs if the timers are printed or
+  // saved.
+  if (CLI::HasParam("verbose") || CLI::HasParam("timing_output"))
+    Timer::EnableMemoryTracking();
+
+  // Set the number of threads of OpenMP and of the BLAS library.
+  if (CLI::HasParam("threads"))
+  {
+    if (CLI::GetParam<int>("threads") < 0)
+    {
+      Log::Fatal << "Invalid value for --threads ("
+          << CLI::GetParam<int>("threads") << "); must be non-negative!"
+          << std::endl;
+    }
+
+    SetNumThreads((size_t) CLI::GetParam<int>("threads"));
+  }
+
+  // Place the loaded matrices on the NUMA nodes of the threads.
+  if (CLI::HasParam("first_touch"))
+    data::SetFirstTouch(true);
+
   // Now, issue an error if we forgot any required options.
   for (std::map<std::string, util::ParamData>::const_iterator iter =
        parameters.begin(); iter != parameters.end(); ++iter)
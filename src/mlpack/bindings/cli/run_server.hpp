@@ -0,0 +1,107 @@
+/**
+ * @file run_server.hpp
+ *
+ * Run a command-line program as a server that reads one set of options per
+ * line of its standard input, so that models are only loaded once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_RUN_SERVER_HPP
+#define MLPACK_BINDINGS_CLI_RUN_SERVER_HPP
+
+#include <mlpack/core/util/cli.hpp>
+#include <boost/program_options.hpp>
+#include "parse_command_line.hpp"
+#include "end_program.hpp"
+#include "model_cache.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Run the program once for each line of the standard input, until the end of
+ * the input.  Each line holds the options of one request, written as they
+ * would be on the command line (quotes and backslashes are handled as by a
+ * Unix shell); empty lines are ignored.  After each request, a line reading
+ * "mlpack: done" or, if the request failed, "mlpack: failed" is written to the
+ * standard output, so that the caller knows when the output files are ready.
+ *
+ * The input models are kept in the ModelCache between requests, so a model
+ * that is given to many requests is only loaded once (and again if its file
+ * changes).  --help, --info and --version can't be given to a request.
+ *
+ * The settings of the program, as they are before the command line is
+ * parsed, must have been stored under the given name with
+ * CLI::StoreSettings().
+ *
+ * @param settings Name of the stored settings of the program.
+ * @param programMain Function that runs the program.
+ */
+inline void RunServer(const std::string& settings, void (*programMain)())
+{
+  ModelCache::Enabled() = true;
+  const bool ignoreInfo = Log::Info.ignoreInput;
+  const std::string programName = CLI::GetSingleton().ProgramName();
+
+  std::string line;
+  while (std::getline(std::cin, line))
+  {
+    const std::vector<std::string> args =
+        boost::program_options::split_unix(line);
+    if (args.empty())
+      continue;
+
+    // Start from the parameters as they were before anything was parsed.
+    CLI::RestoreSettings(settings);
+    CLI::GetSingleton().timer.Reset();
+    Log::Info.ignoreInput = ignoreInfo;
+
+    bool success = true;
+    try
+    {
+      for (const std::string& arg : args)
+      {
+        if (arg == "--help" || arg == "-h" || arg == "--version" ||
+            arg == "-V" || arg.compare(0, 6, "--info") == 0)
+        {
+          Log::Fatal << "Option " << arg << " cannot be given in server mode."
+              << std::endl;
+        }
+      }
+
+      std::vector<char*> argv;
+      argv.push_back(const_cast<char*>(programName.c_str()));
+      for (const std::string& arg : args)
+        argv.push_back(const_cast<char*>(arg.c_str()));
+
+      ParseCommandLine((int) argv.size(), argv.data());
+      Timer::Start("total_time");
+      programMain();
+      EndProgram();
+    }
+    catch (std::exception& e)
+    {
+      // Make sure that nothing allocated by the failed request is leaked;
+      // later requests run in the same process.
+      Log::Warn << "Request failed: " << e.what() << std::endl;
+      success = false;
+      CLI::GetSingleton().timer.StopAllTimers();
+      CleanMemory();
+    }
+
+    std::cout << (success ? "mlpack: done" : "mlpack: failed") << std::endl;
+  }
+
+  ModelCache::Clear();
+  ModelCache::Enabled() = false;
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
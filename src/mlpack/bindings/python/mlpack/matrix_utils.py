@@ -39,7 +39,13 @@ except:
 
 def to_matrix(x, dtype=np.double, copy=False):
   """
-  Given some array-like X, return a numpy ndarray of the same type.
+  Given some array-like X, return a numpy ndarray of the given type, and whether
+  the bindings should take ownership of its memory.
+
+  A C-contiguous (row-major) ndarray of the right type, with one point per row,
+  is already the column-major matrix with one point per column that mlpack
+  expects, so it is returned as it is, and mlpack uses its memory directly.
+  Anything else is converted with a single copy, which the bindings then own.
   """
   # Make sure it's array-like at all.
   if not hasattr(x, '__len__') and \
@@ -47,13 +53,22 @@ def to_matrix(x, dtype=np.double, copy=False):
       not hasattr(x, '__array__'):
     raise TypeError("given argument is not array-like")
 
-  if (isinstance(x, np.ndarray) and x.dtype == dtype and x.flags.c_contiguous):
-    if copy: # Copy the matrix if required.
-      return x.copy("C"), True
-    else:
-      return x, False
+  if isinstance(x, np.ndarray) or hasattr(x, '__array__'):
+    # This doesn't copy ndarrays, and usually doesn't copy objects that hold
+    # an ndarray, like pandas DataFrames.  The memory of the result may belong
+    # to some other object, so only a conversion of it can be owned.
+    base = np.asarray(x)
+    out = np.asarray(base, dtype=dtype, order='C')
+    owned = out is not base
+  else:
+    # Lists and other sequences are always converted into a new array.
+    out = np.asarray(x, dtype=dtype, order='C')
+    owned = True
+
+  if copy and not owned:
+    return out.copy(order='C'), True
   else:
-    return np.array(x, copy=True, dtype=dtype, order='C'), True
+    return out, owned
 
 def to_matrix_with_info(x, dtype, copy=False):
   """
@@ -68,13 +83,10 @@ def to_matrix_with_info(x, dtype, copy=False):
 
   if isinstance(x, np.ndarray):
     # It is already an ndarray, so the vector of info is all 0s (all numeric).
+    # It may still need to be converted to the right type and layout.
     d = np.zeros([x.shape[1]], dtype=np.bool)
-
-    # Copy the matrix if needed.
-    if copy:
-      return (x.copy(order="C"), True, d)
-    else:
-      return (x, False, d)
+    t = to_matrix(x, dtype=dtype, copy=copy)
+    return (t[0], t[1], d)
 
   if isinstance(x, pd.DataFrame) or isinstance(x, pd.Series):
     # It's a pandas dataframe.  So we need to see if any of the dtypes are
@@ -39,6 +39,109 @@ void SerializeIn(T* t, const std::string& str, const std::string& name)
   b >> boost::serialization::make_nvp(name.c_str(), *t);
 }
 
+/**
+ * A stream buffer that only counts the characters written to it, so that the
+ * size of an archive can be known before it is written.
+ */
+class CountingStreamBuffer : public std::streambuf
+{
+ public:
+  CountingStreamBuffer() : count(0) { }
+
+  //! Get the number of characters written.
+  size_t Count() const { return count; }
+
+ protected:
+  std::streamsize xsputn(const char* /* s */, std::streamsize n)
+  {
+    count += n;
+    return n;
+  }
+
+  int_type overflow(int_type c)
+  {
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+      ++count;
+    return traits_type::not_eof(c);
+  }
+
+ private:
+  size_t count;
+};
+
+/**
+ * A stream buffer over a block of memory that is owned by someone else.
+ * Writing past the end of the block fails instead of reallocating it.
+ */
+class MemoryStreamBuffer : public std::streambuf
+{
+ public:
+  MemoryStreamBuffer(char* buffer, const size_t size)
+  {
+    setg(buffer, buffer, buffer + size);
+    setp(buffer, buffer + size);
+  }
+};
+
+/**
+ * Get the size of the binary archive of the given object, without storing the
+ * archive.
+ */
+template<typename T>
+size_t SerializedSize(T* t, const std::string& name)
+{
+  CountingStreamBuffer counter;
+  std::ostream stream(&counter);
+  {
+    boost::archive::binary_oarchive b(stream);
+
+    b << boost::serialization::make_nvp(name.c_str(), *t);
+  }
+  return counter.Count();
+}
+
+/**
+ * Write the binary archive of the given object into the given buffer, whose
+ * size must be the one returned by SerializedSize().  Together, the two
+ * functions let the caller allocate the final buffer (e.g. a Python
+ * bytearray) so that the archive is never copied.
+ */
+template<typename T>
+void SerializeOutBuffer(T* t,
+                        char* buffer,
+                        const size_t size,
+                        const std::string& name)
+{
+  MemoryStreamBuffer memory(buffer, size);
+  std::ostream stream(&memory);
+  {
+    boost::archive::binary_oarchive b(stream);
+
+    b << boost::serialization::make_nvp(name.c_str(), *t);
+  }
+
+  if (!stream.good())
+    throw std::runtime_error("SerializeOutBuffer(): the buffer is too small.");
+}
+
+/**
+ * Read the given object from the binary archive in the given buffer, without
+ * copying the buffer.
+ */
+template<typename T>
+void SerializeInBuffer(T* t,
+                       const char* buffer,
+                       const size_t size,
+                       const std::string& name)
+{
+  // The buffer is only read.
+  MemoryStreamBuffer memory(const_cast<char*>(buffer), size);
+  std::istream stream(&memory);
+  boost::archive::binary_iarchive b(stream);
+
+  b >> boost::serialization::make_nvp(name.c_str(), *t);
+}
+
 } // namespace python
 } // namespace bindings
 } // namespace mlpack
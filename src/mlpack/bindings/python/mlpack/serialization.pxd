@@ -12,3 +12,8 @@ from libcpp.string cimport string
 cdef extern from "serialization.hpp" namespace "mlpack::bindings::python" nogil:
   string SerializeOut[T](T* t, string name) nogil
   void SerializeIn[T](T* t, string str, string name) nogil
+  size_t SerializedSize[T](T* t, string name) nogil except +
+  void SerializeOutBuffer[T](T* t, char* buffer, size_t size,
+                             string name) nogil except +
+  void SerializeInBuffer[T](T* t, const char* buffer, size_t size,
+                            string name) nogil except +
@@ -69,13 +69,31 @@ void PrintClassDefn(
    *     del self.modelptr
    *
    *   def __getstate__(self):
-   *     return SerializeOut(self.modelptr, "<ModelType>")
+   *     cdef size_t size = SerializedSize(self.modelptr, "<ModelType>")
+   *     state = bytearray(size)
+   *     cdef char* buffer = state
+   *     SerializeOutBuffer(self.modelptr, buffer, size, "<ModelType>")
+   *     return state
    *
    *   def __setstate__(self, state):
-   *     SerializeIn(self.modelptr, state, "<ModelType>")
+   *     cdef Py_buffer view
+   *     PyObject_GetBuffer(state, &view, PyBUF_SIMPLE)
+   *     try:
+   *       SerializeInBuffer(self.modelptr, <const char*> view.buf, view.len,
+   *           "<ModelType>")
+   *     finally:
+   *       PyBuffer_Release(&view)
    *
-   *   def __reduce_ex__(self):
-   *     return (self.__class__, (), self.__getstate__())
+   *   def __reduce_ex__(self, version):
+   *     state = self.__getstate__()
+   *     if version >= 5 and PickleBuffer is not None:
+   *       state = PickleBuffer(state)
+   *     return (self.__class__, (), state)
+   *
+   * The archive is written straight into the bytearray that is pickled, and
+   * read straight from whatever buffer is unpickled.  With pickle protocol 5,
+   * the archive is a PickleBuffer, which can be passed out of band (e.g. in
+   * shared memory) without being copied into the pickle stream.
    */
   std::cout << "cdef class " << strippedType << "Type:" << std::endl;
   std::cout << "  cdef " << printedType << "* modelptr" << std::endl;
@@ -87,16 +105,28 @@ void PrintClassDefn(
   std::cout << "    del self.modelptr" << std::endl;
   std::cout << std::endl;
   std::cout << "  def __getstate__(self):" << std::endl;
-  std::cout << "    return SerializeOut(self.modelptr, \"" << printedType
-      << "\")" << std::endl;
+  std::cout << "    cdef size_t size = SerializedSize(self.modelptr, \""
+      << printedType << "\")" << std::endl;
+  std::cout << "    state = bytearray(size)" << std::endl;
+  std::cout << "    cdef char* buffer = state" << std::endl;
+  std::cout << "    SerializeOutBuffer(self.modelptr, buffer, size, \""
+      << printedType << "\")" << std::endl;
+  std::cout << "    return state" << std::endl;
   std::cout << std::endl;
   std::cout << "  def __setstate__(self, state):" << std::endl;
-  std::cout << "    SerializeIn(self.modelptr, state, \"" << printedType
-      << "\")" << std::endl;
+  std::cout << "    cdef Py_buffer view" << std::endl;
+  std::cout << "    PyObject_GetBuffer(state, &view, PyBUF_SIMPLE)" << std::endl;
+  std::cout << "    try:" << std::endl;
+  std::cout << "      SerializeInBuffer(self.modelptr, <const char*> view.buf, "
+      << "view.len, \"" << printedType << "\")" << std::endl;
+  std::cout << "    finally:" << std::endl;
+  std::cout << "      PyBuffer_Release(&view)" << std::endl;
   std::cout << std::endl;
   std::cout << "  def __reduce_ex__(self, version):" << std::endl;
-  std::cout << "    return (self.__class__, (), self.__getstate__())"
-      << std::endl;
+  std::cout << "    state = self.__getstate__()" << std::endl;
+  std::cout << "    if version >= 5 and PickleBuffer is not None:" << std::endl;
+  std::cout << "      state = PickleBuffer(state)" << std::endl;
+  std::cout << "    return (self.__class__, (), state)" << std::endl;
   std::cout << std::endl;
 }
 
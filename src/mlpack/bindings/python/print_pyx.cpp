@@ -79,9 +79,19 @@ void PrintPYX(const ProgramDoc& programInfo,
   cout << "from cli cimport SetParam, SetParamPtr, SetParamWithInfo, "
       << "GetParamPtr" << endl;
   cout << "from cli cimport EnableVerbose, DisableVerbose, DisableBacktrace, "
-      << "ResetTimers, EnableTimers" << endl;
+      << "EnableTimers" << endl;
   cout << "from matrix_utils import to_matrix, to_matrix_with_info" << endl;
-  cout << "from serialization cimport SerializeIn, SerializeOut" << endl;
+  cout << "from serialization cimport SerializeIn, SerializeOut, "
+      << "SerializedSize, SerializeInBuffer, SerializeOutBuffer" << endl;
+  cout << "from cpython.buffer cimport PyObject_GetBuffer, PyBuffer_Release, "
+      << "PyBUF_SIMPLE" << endl;
+  cout << endl;
+  cout << "# Pickle protocol 5 (Python 3.8+) can pass buffers out of band."
+      << endl;
+  cout << "try:" << endl;
+  cout << "  from pickle import PickleBuffer" << endl;
+  cout << "except ImportError:" << endl;
+  cout << "  PickleBuffer = None" << endl;
   cout << endl;
   cout << "import numpy as np" << endl;
   cout << "cimport numpy as np" << endl;
@@ -175,8 +185,9 @@ void PrintPYX(const ProgramDoc& programInfo,
       << "returned." << endl;
   cout << "  \"\"\"" << endl;
 
-  // Reset any timers and disable backtraces.
-  cout << "  ResetTimers()" << endl;
+  // Enable timers and disable backtraces.  The timers are shared by all
+  // threads, so they can't be reset here: that would stop the timers of
+  // other calls running at the same time.
   cout << "  EnableTimers()" << endl;
   cout << "  DisableBacktrace()" << endl;
   cout << "  DisableVerbose()" << endl;
@@ -209,9 +220,12 @@ void PrintPYX(const ProgramDoc& programInfo,
     cout << "  CLI.SetPassed(<const string> '" << d.name << "')" << endl;
   }
 
-  // Call the method.
+  // Call the method.  The parameters are held by the CLI singleton of this
+  // thread, so the GIL can be released and other Python threads can call
+  // mlpack bindings at the same time.
   cout << "  # Call the mlpack program." << endl;
-  cout << "  mlpackMain()" << endl;
+  cout << "  with nogil:" << endl;
+  cout << "    mlpackMain()" << endl;
 
   // Do any output processing and return.
   cout << "  # Initialize result dictionary." << endl;
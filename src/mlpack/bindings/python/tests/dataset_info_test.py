@@ -131,6 +131,43 @@ class TestToMatrix(unittest.TestCase):
 
     self.assertEqual(p1['data'], p2['data'])
 
+  def testNumpyViewToMatrix(self):
+    """
+    Make sure a C-contiguous view is not copied, and not owned.
+    """
+    m1 = np.random.randn(100, 5)
+    m2, owned = to_matrix(m1[10:20])
+
+    self.assertEqual(m2.shape[0], 10)
+    self.assertEqual(m2.shape[1], 5)
+    self.assertFalse(owned)
+    self.assertTrue(np.may_share_memory(m1, m2))
+
+  def testFortranNumpyToMatrix(self):
+    """
+    Make sure a column-major numpy matrix is converted to a row-major matrix,
+    which is owned.
+    """
+    m1 = np.asfortranarray(np.random.randn(100, 5))
+    m2, owned = to_matrix(m1)
+
+    self.assertTrue(owned)
+    self.assertTrue(m2.flags.c_contiguous)
+    self.assertTrue(np.array_equal(m1, m2))
+
+  def testFloat32NumpyToMatrix(self):
+    """
+    Make sure a float32 numpy matrix is converted once, to an owned float64
+    matrix.
+    """
+    m1 = np.random.randn(100, 5).astype(np.float32)
+    m2, owned = to_matrix(m1)
+
+    self.assertTrue(owned)
+    self.assertEqual(m2.dtype, np.dtype(np.double))
+    self.assertTrue(m2.flags.c_contiguous)
+    self.assertTrue(np.array_equal(m1, m2))
+
   def testPandasToMatrixNoCategorical(self):
     """
     Make sure that if we pass a Pandas dataframe with no categorical features,
@@ -13,6 +13,8 @@ import unittest
 import pandas as pd
 import numpy as np
 import copy
+import pickle
+import threading
 
 from mlpack.test_python_binding import test_python_binding
 
@@ -140,6 +142,27 @@ class TestPythonBinding(unittest.TestCase):
     for j in range(100):
       self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
 
+  def testFortranNumpyMatrix(self):
+    """
+    A column-major matrix must give the same results as a row-major one.
+    """
+    x = np.random.rand(100, 5);
+    z = np.asfortranarray(x)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 matrix_in=z)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(x[j, i], output['matrix_out'][j, i])
+
+    for j in range(100):
+      self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
+
   def testArraylikeMatrix(self):
     """
     Test that we can pass an arraylike matrix.
@@ -608,5 +631,65 @@ class TestPythonBinding(unittest.TestCase):
     self.assertEqual(output2['model_bw_out'], 20.0)
     self.assertEqual(output3['model_bw_out'], 20.0)
 
+  def testModelPickle(self):
+    """
+    Make sure a model can be pickled and unpickled with every protocol,
+    including protocol 5 with out-of-band buffers.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 build_model=True)
+
+    for protocol in range(pickle.HIGHEST_PROTOCOL + 1):
+      model = pickle.loads(pickle.dumps(output['model_out'], protocol))
+      output2 = test_python_binding(string_in='hello',
+                                    int_in=12,
+                                    double_in=4.0,
+                                    model_in=model)
+      self.assertEqual(output2['model_bw_out'], 20.0)
+
+    if pickle.HIGHEST_PROTOCOL >= 5:
+      buffers = []
+      data = pickle.dumps(output['model_out'], 5,
+                          buffer_callback=buffers.append)
+      self.assertEqual(len(buffers), 1)
+      model = pickle.loads(data, buffers=buffers)
+      output2 = test_python_binding(string_in='hello',
+                                    int_in=12,
+                                    double_in=4.0,
+                                    model_in=model)
+      self.assertEqual(output2['model_bw_out'], 20.0)
+
+  def testConcurrentCalls(self):
+    """
+    Make sure that the binding can be called from several threads at once, each
+    call with its own parameters.
+    """
+    results = [None] * 8
+    def run(i):
+      # Only the calls with even i get the right string and int.
+      results[i] = test_python_binding(string_in=('hello' if i % 2 == 0 else
+                                                  'goodbye'),
+                                       int_in=(12 if i % 2 == 0 else i),
+                                       double_in=4.0,
+                                       flag1=True,
+                                       matrix_in=np.full((50, 5), float(i)))
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(8)]
+    for t in threads:
+      t.start()
+    for t in threads:
+      t.join()
+
+    for i in range(8):
+      self.assertEqual(results[i]['string_out'],
+                       'hello2' if i % 2 == 0 else 'wrong')
+      self.assertEqual(results[i]['int_out'], 13 if i % 2 == 0 else 11)
+      self.assertEqual(results[i]['double_out'], 5.0)
+      self.assertEqual(results[i]['matrix_out'].shape, (50, 4))
+      self.assertEqual(results[i]['matrix_out'][0, 0], float(i))
+      self.assertEqual(results[i]['matrix_out'][0, 2], 2.0 * i)
+
 if __name__ == '__main__':
   unittest.main()
@@ -4,7 +4,6 @@ template<typename Archive>
 void Cube<eT>::serialize(Archive& ar, const unsigned int /* version */)
 {
   using boost::serialization::make_nvp;
-  using boost::serialization::make_array;
 
   const uword old_n_elem = n_elem;
 
@@ -31,5 +30,6 @@ void Cube<eT>::serialize(Archive& ar, const unsigned int /* version */)
     init_cold();
   }
 
-  ar & make_array(access::rwp(mem), n_elem);
+  // Floating-point elements are stored with the serialization precision.
+  ::mlpack::data::SerializeArray(ar, access::rwp(mem), n_elem);
 }
@@ -14,7 +14,6 @@ template<typename Archive>
 void Mat<eT>::serialize(Archive& ar, const unsigned int /* version */)
 {
   using boost::serialization::make_nvp;
-  using boost::serialization::make_array;
 
   const uword old_n_elem = n_elem;
 
@@ -40,5 +39,6 @@ void Mat<eT>::serialize(Archive& ar, const unsigned int /* version */)
     init_cold();
   }
 
-  ar & make_array(access::rwp(mem), n_elem);
+  // Floating-point elements are stored with the serialization precision.
+  ::mlpack::data::SerializeArray(ar, access::rwp(mem), n_elem);
 }
\ No newline at end of file
@@ -38,7 +38,8 @@ void SpMat<eT>::serialize(Archive& ar, const unsigned int /* version */)
     // column pointers, if necessary, so we don't need to worry about them.
   }
 
-  ar & make_array(access::rwp(values), n_nonzero);
+  // Floating-point values are stored with the serialization precision.
+  ::mlpack::data::SerializeArray(ar, access::rwp(values), n_nonzero);
   ar & make_array(access::rwp(row_indices), n_nonzero);
   ar & make_array(access::rwp(col_ptrs), n_cols + 1);
 }
\ No newline at end of file
@@ -48,6 +48,7 @@
 #include <boost/serialization/serialization.hpp>
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/array.hpp>
+#include "serialization_precision.hpp"
 
 #include <armadillo>
 
@@ -0,0 +1,242 @@
+/**
+ * @file serialization_precision.hpp
+ *
+ * The precision that floating-point Armadillo objects are serialized with, and
+ * the conversions to and from the reduced-precision representations.  This is
+ * included before Armadillo, since the serialize() functions of the Armadillo
+ * extensions use it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_ARMA_EXTEND_SERIALIZATION_PRECISION_HPP
+#define MLPACK_CORE_ARMA_EXTEND_SERIALIZATION_PRECISION_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace mlpack {
+namespace data {
+
+//! Define the precisions that floating-point matrices can be stored with.
+enum precision
+{
+  full,
+  float32,
+  float16
+};
+
+/**
+ * Get the precision that floating-point matrices, cubes and sparse matrices
+ * are currently serialized with.  This is set by data::Save() and data::Load()
+ * for the compressed formats, and is full otherwise; the setting is local to
+ * the thread.
+ */
+inline precision& SerializationPrecision()
+{
+  static thread_local precision current = full;
+  return current;
+}
+
+/**
+ * Set the serialization precision for the lifetime of the object, and restore
+ * the previous one when it is destroyed.
+ */
+class ScopedPrecision
+{
+ public:
+  //! Set the serialization precision to the given precision.
+  ScopedPrecision(const precision p) : previous(SerializationPrecision())
+  {
+    SerializationPrecision() = p;
+  }
+
+  //! Restore the previous serialization precision.
+  ~ScopedPrecision() { SerializationPrecision() = previous; }
+
+ private:
+  //! The precision to restore.
+  precision previous;
+};
+
+/**
+ * Convert a single-precision value to an IEEE 754 half-precision value,
+ * rounding to the nearest representable value (ties to even).
+ */
+inline uint16_t FloatToHalf(const float value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+
+  const uint16_t sign = (bits >> 16) & 0x8000;
+  const uint32_t absBits = bits & 0x7FFFFFFF;
+
+  // Infinity and NaN (which stays a NaN).
+  if (absBits >= 0x7F800000)
+    return sign | 0x7C00 | ((absBits > 0x7F800000) ? 0x0200 : 0);
+
+  // Values from 65520 on round to infinity.
+  if (absBits >= 0x477FF000)
+    return sign | 0x7C00;
+
+  // Values below 2^-14 become subnormal.
+  if (absBits < 0x38800000)
+  {
+    if (absBits < 0x33000000)
+      return sign;
+
+    const uint32_t shift = 126 - (absBits >> 23);
+    const uint32_t mantissa = (absBits & 0x007FFFFF) | 0x00800000;
+    uint32_t half = mantissa >> shift;
+    const uint32_t rest = mantissa & ((1u << shift) - 1);
+    const uint32_t halfway = 1u << (shift - 1);
+    if (rest > halfway || (rest == halfway && (half & 1)))
+      ++half;
+
+    return sign | (uint16_t) half;
+  }
+
+  // Rebias the exponent; a carry of the rounding moves to the exponent.
+  uint32_t half = (absBits - 0x38000000) >> 13;
+  const uint32_t rest = absBits & 0x1FFF;
+  if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+    ++half;
+
+  return sign | (uint16_t) half;
+}
+
+//! Convert an IEEE 754 half-precision value to a single-precision value.
+inline float HalfToFloat(const uint16_t half)
+{
+  const uint32_t sign = (uint32_t) (half & 0x8000) << 16;
+  const uint32_t exponent = (half >> 10) & 0x1F;
+  uint32_t mantissa = half & 0x03FF;
+
+  uint32_t bits;
+  if (exponent == 0x1F)
+  {
+    bits = sign | 0x7F800000 | (mantissa << 13);
+  }
+  else if (exponent != 0)
+  {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  else if (mantissa == 0)
+  {
+    bits = sign;
+  }
+  else
+  {
+    // Normalize the subnormal value.
+    uint32_t e = 113;
+    while (!(mantissa & 0x0400))
+    {
+      mantissa <<= 1;
+      --e;
+    }
+
+    bits = sign | (e << 23) | ((mantissa & 0x03FF) << 13);
+  }
+
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+namespace detail {
+
+//! Serialize an array of non-floating-point elements; always full precision.
+template<typename Archive, typename eT>
+void SerializeArray(Archive& ar,
+                    eT* mem,
+                    const size_t n,
+                    const std::false_type /* isFloatingPoint */)
+{
+  ar & boost::serialization::make_array(mem, n);
+}
+
+/**
+ * Serialize an array of floating-point elements with the current precision.
+ * Reduced-precision elements are converted in blocks, so no copy of the whole
+ * array is made.
+ */
+template<typename Archive, typename eT>
+void SerializeArray(Archive& ar,
+                    eT* mem,
+                    const size_t n,
+                    const std::true_type /* isFloatingPoint */)
+{
+  const precision p = SerializationPrecision();
+  if (p == full)
+  {
+    ar & boost::serialization::make_array(mem, n);
+    return;
+  }
+
+  const size_t blockSize = 4096;
+  float floats[blockSize];
+  uint16_t halves[blockSize];
+  for (size_t begin = 0; begin < n; begin += blockSize)
+  {
+    const size_t count = std::min(blockSize, n - begin);
+    eT* block = mem + begin;
+    if (p == float32)
+    {
+      if (!Archive::is_loading::value)
+      {
+        for (size_t i = 0; i < count; ++i)
+          floats[i] = (float) block[i];
+      }
+
+      ar & boost::serialization::make_array(floats, count);
+
+      if (Archive::is_loading::value)
+      {
+        for (size_t i = 0; i < count; ++i)
+          block[i] = (eT) floats[i];
+      }
+    }
+    else
+    {
+      if (!Archive::is_loading::value)
+      {
+        for (size_t i = 0; i < count; ++i)
+          halves[i] = FloatToHalf((float) block[i]);
+      }
+
+      ar & boost::serialization::make_array(halves, count);
+
+      if (Archive::is_loading::value)
+      {
+        for (size_t i = 0; i < count; ++i)
+          block[i] = (eT) HalfToFloat(halves[i]);
+      }
+    }
+  }
+}
+
+} // namespace detail
+
+/**
+ * Serialize the elements of an Armadillo object.  Floating-point elements
+ * are stored with the current serialization precision; all other elements
+ * are stored as they are.
+ *
+ * @param ar Archive to serialize to or from.
+ * @param mem The elements.
+ * @param n The number of elements.
+ */
+template<typename Archive, typename eT>
+void SerializeArray(Archive& ar, eT* mem, const size_t n)
+{
+  detail::SerializeArray(ar, mem, n, std::is_floating_point<eT>());
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -44,6 +44,23 @@ namespace cv {
  * the @c Shuffle() function.  Shuffling is performed at construction time if
  * the parameter @c shuffle is set to @c true in the constructor.
  *
+ * KFoldCV keeps a single copy of the data.  The data is rotated in place
+ * before each fold so that its training subset is a contiguous block of
+ * columns, and the models are trained on aliases of that block, so no fold
+ * subset is ever copied.
+ *
+ * The folds are independent, so they can be trained and evaluated in parallel
+ * by setting @c Parallel() to @c true; every fold then trains its own model, so
+ * training of MLAlgorithm has to be safe to run from several threads at once.
+ * Since the folds can't all be contiguous in one buffer, the training subset of
+ * each fold (except the first one) is copied in that case.
+ *
+ * A run can also be abandoned early: if @c MinFolds() is non-zero, the first
+ * @c MinFolds() folds are evaluated, and when their mean is not below
+ * @c Bound() the remaining folds are skipped and that mean is returned.  This
+ * lets a hyper-parameter search stop spending time on configurations that are
+ * already worse than the best one found so far.
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -180,6 +197,22 @@ class KFoldCV
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get whether the folds are trained and evaluated in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the folds are trained and evaluated in parallel.
+  bool& Parallel() { return parallel; }
+
+  //! Get the number of folds evaluated before a run can be abandoned (0 means
+  //! that all folds are always evaluated).
+  size_t MinFolds() const { return minFolds; }
+  //! Modify the number of folds evaluated before a run can be abandoned.
+  size_t& MinFolds() { return minFolds; }
+
+  //! Get the bound above which a run is abandoned after MinFolds() folds.
+  double Bound() const { return bound; }
+  //! Modify the bound above which a run is abandoned after MinFolds() folds.
+  double& Bound() { return bound; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -209,22 +242,34 @@ class KFoldCV
   //! The number of bins in the dataset.
   const size_t k;
 
-  //! The extended (by repeating the first k - 2 bins) data points.
+  //! The data points (rotated left by offset columns).
   MatType xs;
-  //! The extended (by repeating the first k - 2 bins) predictions.
+  //! The predictions (rotated left by offset columns).
   PredictionsType ys;
-  //! The extended (by repeating the first k - 2 bins) weights.
+  //! The weights (rotated left by offset columns).
   WeightsType weights;
 
-  //! The original size of the dataset.
+  //! The size of the last bin in terms of data points.
   size_t lastBinSize;
 
   //! The size of each bin in terms of data points.
   size_t binSize;
 
+  //! The number of columns the data is currently rotated left by.
+  size_t offset;
+
   //! A pointer to a model from the last run of k-fold cross-validation.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! Whether the folds are trained and evaluated in parallel.
+  bool parallel;
+
+  //! The number of folds evaluated before a run can be abandoned.
+  size_t minFolds;
+
+  //! The bound above which a run is abandoned after minFolds folds.
+  double bound;
+
   /**
    * Assert the k parameter and data consistency and initialize fields required
    * for running k-fold cross-validation.
@@ -247,12 +292,34 @@ class KFoldCV
           const bool shuffle);
 
   /**
-   * Initialize the given destination matrix with the given source joined with
-   * its first k - 2 bins.
+   * Initialize the given destination matrix with the given source, and the bin
+   * sizes with its number of columns.
    */
   template<typename DataType>
   void InitKFoldCVMat(const DataType& source, DataType& destination);
 
+  /**
+   * Rotate the data in place so that it starts at the given column of the
+   * original data.
+   */
+  void RotateTo(const size_t newOffset);
+
+  /**
+   * Rotate the columns of the given matrix left by the given number of columns
+   * in place.
+   */
+  template<typename ElementType>
+  static void RotateColumns(arma::Mat<ElementType>& m, const size_t shift);
+
+  /**
+   * Reorder the columns of the given matrix in place, so that its ith column
+   * is the ordering[i]th column of the original matrix.  Only one column is
+   * stored in addition to the matrix.
+   */
+  template<typename ElementType>
+  static void PermuteColumns(arma::Mat<ElementType>& m,
+                             const arma::uvec& ordering);
+
   /**
    * Train and run evaluation in the case of non-weighted learning.
    */
@@ -271,13 +338,41 @@ class KFoldCV
   double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
   /**
-   * Calculate the index of the first column of the ith validation subset.
+   * Train a model on each fold with the given callable and evaluate it on the
+   * corresponding validation subset, abandoning the run if the first minFolds
+   * folds don't reach the bound.
+   *
+   * @param train Callable taking the index of a fold and returning the model
+   *     trained on its training subset.
+   */
+  template<typename TrainFunction>
+  double EvaluateFolds(TrainFunction train);
+
+  /**
+   * Evaluate the folds [begin, end).
+   */
+  template<typename TrainFunction>
+  void EvaluateFolds(TrainFunction& train,
+                     const size_t begin,
+                     const size_t end,
+                     arma::vec& evaluations);
+
+  /**
+   * Calculate the index of the first column of the ith validation subset in
+   * the original data.
    *
    * We take the ith validation subset after the ith training subset if
    * i < k - 1 and before it otherwise.
    */
   inline size_t ValidationSubsetFirstCol(const size_t i);
 
+  /**
+   * Calculate the index of the first column of the ith training subset in the
+   * original data.  The training subset continues from there to the end of the
+   * data and wraps around to its beginning.
+   */
+  inline size_t TrainingSubsetFirstCol(const size_t i);
+
   /**
    * Get the ith training subset from a variable of a matrix type.
    */
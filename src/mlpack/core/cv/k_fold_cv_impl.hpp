@@ -135,7 +135,11 @@ KFoldCV<MLAlgorithm,
                               const PredictionsType& ys,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    offset(0),
+    parallel(false),
+    minFolds(0),
+    bound(DBL_MAX)
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -166,7 +170,11 @@ KFoldCV<MLAlgorithm,
                               const WeightsType& weights,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    offset(0),
+    parallel(false),
+    minFolds(0),
+    bound(DBL_MAX)
 {
   Base::AssertWeightsConsistency(xs, weights);
 
@@ -228,8 +236,83 @@ void KFoldCV<MLAlgorithm,
   binSize = source.n_cols / k;
   lastBinSize = source.n_cols - ((k - 1) * binSize);
 
-  destination = (k == 2) ? source : arma::join_rows(source,
-      source.cols(0, source.n_cols - lastBinSize - 1));
+  destination = source;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::RotateTo(const size_t newOffset)
+{
+  const size_t shift = (newOffset + xs.n_cols - offset) % xs.n_cols;
+  if (shift == 0)
+    return;
+
+  RotateColumns(xs, shift);
+  RotateColumns(ys, shift);
+  if (weights.n_elem > 0)
+    RotateColumns(weights, shift);
+
+  offset = newOffset;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename ElementType>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::RotateColumns(arma::Mat<ElementType>& m,
+                                         const size_t shift)
+{
+  // The columns are contiguous, so rotating the columns is rotating the
+  // elements, which std::rotate() does without extra memory.
+  std::rotate(m.memptr(), m.memptr() + shift * m.n_rows,
+      m.memptr() + m.n_elem);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename ElementType>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::PermuteColumns(arma::Mat<ElementType>& m,
+                                          const arma::uvec& ordering)
+{
+  // Follow each cycle of the permutation, moving every column once.
+  std::vector<bool> placed(m.n_cols, false);
+  arma::Col<ElementType> firstColumn;
+  for (size_t start = 0; start < m.n_cols; ++start)
+  {
+    if (placed[start])
+      continue;
+
+    firstColumn = m.col(start);
+    size_t current = start;
+    while (ordering[current] != start)
+    {
+      m.col(current) = m.col(ordering[current]);
+      placed[current] = true;
+      current = ordering[current];
+    }
+    m.col(current) = firstColumn;
+    placed[current] = true;
+  }
 }
 
 template<typename MLAlgorithm,
@@ -244,19 +327,11 @@ double KFoldCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
-  arma::vec evaluations(k);
-
-  for (size_t i = 0; i < k; ++i)
+  return EvaluateFolds([&](const size_t i)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
-        GetTrainingSubset(ys, i), args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
-  }
-
-  return arma::mean(evaluations);
+    return base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+        args...);
+  });
 }
 
 template<typename MLAlgorithm,
@@ -271,22 +346,81 @@ double KFoldCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
-  arma::vec evaluations(k);
-
-  for (size_t i = 0; i < k; ++i)
+  return EvaluateFolds([&](const size_t i)
   {
-    MLAlgorithm&& model = (weights.n_elem > 0) ?
+    return (weights.n_elem > 0) ?
         base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
             GetTrainingSubset(weights, i), args...) :
         base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
             args...);
+  });
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename TrainFunction>
+double KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::EvaluateFolds(TrainFunction train)
+{
+  arma::vec evaluations(k);
+
+  // Evaluate the first minFolds folds, and only go on if they reach the bound.
+  const size_t firstFolds = (minFolds > 0 && minFolds < k) ? minFolds : k;
+  EvaluateFolds(train, 0, firstFolds, evaluations);
+  if (firstFolds < k)
+  {
+    const double firstMean = arma::mean(evaluations.head(firstFolds));
+    if (firstMean >= bound)
+      return firstMean;
+
+    EvaluateFolds(train, firstFolds, k, evaluations);
+  }
+
+  return arma::mean(evaluations);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename TrainFunction>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::EvaluateFolds(TrainFunction& train,
+                                         const size_t begin,
+                                         const size_t end,
+                                         arma::vec& evaluations)
+{
+  // In parallel the data stays in its original order, and the training subsets
+  // that wrap around its end are copied.
+  if (parallel)
+    RotateTo(0);
+
+  // Each fold trains its own model and writes its own evaluation; only the
+  // model of the last evaluated fold is kept.
+  #pragma omp parallel for if (parallel) shared(train, evaluations)
+  for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
+  {
+    // One fold at a time, the data is rotated so that the training subset is
+    // contiguous.
+    if (!parallel)
+      RotateTo(TrainingSubsetFirstCol(i));
+
+    MLAlgorithm model = train(i);
     evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
         GetValidationSubset(ys, i));
-    if (i == k - 1)
+    if ((size_t) i == end - 1)
       modelPtr.reset(new MLAlgorithm(std::move(model)));
   }
-
-  return arma::mean(evaluations);
 }
 
 template<typename MLAlgorithm,
@@ -301,14 +435,15 @@ void KFoldCV<MLAlgorithm,
              PredictionsType,
              WeightsType>::Shuffle()
 {
-  MatType xsOrig = xs.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  PredictionsType ysOrig = ys.cols(0, (k - 1) * binSize + lastBinSize - 1);
+  RotateTo(0);
 
-  // Now shuffle the data.
-  math::ShuffleData(xsOrig, ysOrig, xsOrig, ysOrig);
+  // Generate the ordering as math::ShuffleData() does, but shuffle the data in
+  // place.
+  const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+      xs.n_cols - 1, xs.n_cols));
 
-  InitKFoldCVMat(xsOrig, xs);
-  InitKFoldCVMat(ysOrig, ys);
+  PermuteColumns(xs, ordering);
+  PermuteColumns(ys, ordering);
 }
 
 template<typename MLAlgorithm,
@@ -323,22 +458,17 @@ void KFoldCV<MLAlgorithm,
              PredictionsType,
              WeightsType>::Shuffle()
 {
-  MatType xsOrig = xs.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  PredictionsType ysOrig = ys.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  WeightsType weightsOrig;
-  if (weights.n_elem > 0)
-    weightsOrig = weights.cols(0, (k - 1) * binSize + lastBinSize - 1);
+  RotateTo(0);
 
-  // Now shuffle the data.
-  if (weights.n_elem > 0)
-    math::ShuffleData(xsOrig, ysOrig, weightsOrig, xsOrig, ysOrig, weightsOrig);
-  else
-    math::ShuffleData(xsOrig, ysOrig, xsOrig, ysOrig);
+  // Generate the ordering as math::ShuffleData() does, but shuffle the data in
+  // place.
+  const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+      xs.n_cols - 1, xs.n_cols));
 
-  InitKFoldCVMat(xsOrig, xs);
-  InitKFoldCVMat(ysOrig, ys);
+  PermuteColumns(xs, ordering);
+  PermuteColumns(ys, ordering);
   if (weights.n_elem > 0)
-    InitKFoldCVMat(weightsOrig, weights);
+    PermuteColumns(weights, ordering);
 }
 
 template<typename MLAlgorithm,
@@ -356,6 +486,20 @@ size_t KFoldCV<MLAlgorithm,
   return (i == 0) ? binSize * (k - 1) : binSize * (i - 1);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::TrainingSubsetFirstCol(const size_t i)
+{
+  return binSize * i;
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -376,8 +520,19 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
   const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
       (k - 1) * binSize;
 
-  return arma::Mat<ElementType>(m.colptr(binSize * i), m.n_rows, subsetSize,
-      false, true);
+  // The subset is an alias when it doesn't wrap around the end of the
+  // (rotated) data, which is always the case when the data has been rotated
+  // to this fold.
+  const size_t firstCol = (TrainingSubsetFirstCol(i) + m.n_cols - offset) %
+      m.n_cols;
+  if (firstCol + subsetSize <= m.n_cols)
+  {
+    return arma::Mat<ElementType>(m.colptr(firstCol), m.n_rows, subsetSize,
+        false, true);
+  }
+
+  return arma::join_rows(m.cols(firstCol, m.n_cols - 1),
+      m.cols(0, firstCol + subsetSize - m.n_cols - 1));
 }
 
 template<typename MLAlgorithm,
@@ -400,7 +555,13 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
   const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
       (k - 1) * binSize;
 
-  return arma::Row<ElementType>(r.colptr(binSize * i), subsetSize, false, true);
+  const size_t firstCol = (TrainingSubsetFirstCol(i) + r.n_cols - offset) %
+      r.n_cols;
+  if (firstCol + subsetSize <= r.n_cols)
+    return arma::Row<ElementType>(r.colptr(firstCol), subsetSize, false, true);
+
+  return arma::join_rows(r.cols(firstCol, r.n_cols - 1),
+      r.cols(0, firstCol + subsetSize - r.n_cols - 1));
 }
 
 template<typename MLAlgorithm,
@@ -418,8 +579,10 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
     const size_t i)
 {
   const size_t subsetSize = (i == 0) ? lastBinSize : binSize;
-  return arma::Mat<ElementType>(m.colptr(ValidationSubsetFirstCol(i)), m.n_rows,
-      subsetSize, false, true);
+  const size_t firstCol = (ValidationSubsetFirstCol(i) + m.n_cols - offset) %
+      m.n_cols;
+  return arma::Mat<ElementType>(m.colptr(firstCol), m.n_rows, subsetSize,
+      false, true);
 }
 
 template<typename MLAlgorithm,
@@ -437,8 +600,9 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
     const size_t i)
 {
   const size_t subsetSize = (i == 0) ? lastBinSize : binSize;
-  return arma::Row<ElementType>(r.colptr(ValidationSubsetFirstCol(i)),
-      subsetSize, false, true);
+  const size_t firstCol = (ValidationSubsetFirstCol(i) + r.n_cols - offset) %
+      r.n_cols;
+  return arma::Row<ElementType>(r.colptr(firstCol), subsetSize, false, true);
 }
 
 } // namespace cv
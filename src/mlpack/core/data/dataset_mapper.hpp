@@ -19,6 +19,7 @@
 #include <unordered_map>
 
 #include "map_policies/increment_policy.hpp"
+#include "map_policies/hashing_policy.hpp"
 
 namespace mlpack {
 namespace data {
@@ -0,0 +1,30 @@
+/**
+ * @file first_touch.cpp
+ *
+ * The setting of whether data::Load() places the matrices it loads with
+ * FirstTouch().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "first_touch.hpp"
+
+#include <atomic>
+
+namespace {
+
+std::atomic<bool> firstTouch(false);
+
+} // anonymous namespace
+
+void mlpack::data::SetFirstTouch(const bool enable)
+{
+  firstTouch = enable;
+}
+
+bool mlpack::data::FirstTouchEnabled()
+{
+  return firstTouch;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file first_touch.hpp
+ *
+ * Placement of the memory of a matrix on the NUMA nodes of the threads that
+ * work on it, by first touch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FIRST_TOUCH_HPP
+#define MLPACK_CORE_DATA_FIRST_TOUCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Copy the given matrix into new memory whose columns are first written by the
+ * threads of a parallel loop with a static schedule, so that, with the
+ * first-touch policy of the operating system (the default on Linux), each
+ * block of columns is placed on the NUMA node of the thread that wrote it.
+ * Parallel loops over the columns with a static schedule (and the same number
+ * of threads) then mostly read local memory.
+ *
+ * For the threads to stay on the same nodes, they should be pinned, for
+ * instance by running the program with OMP_PROC_BIND=close and
+ * OMP_PLACES=cores.  Nothing is done if the parallel regions use one thread.
+ *
+ * @param matrix Matrix to place.
+ */
+template<typename eT>
+void FirstTouch(arma::Mat<eT>& matrix)
+{
+  if (NumThreads() == 1 || matrix.n_elem == 0)
+    return;
+
+  // The memory of the new matrix is not initialized, so its pages are first
+  // touched by the copy.
+  arma::Mat<eT> touched(matrix.n_rows, matrix.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) matrix.n_cols; ++i)
+  {
+    std::copy(matrix.colptr(i), matrix.colptr(i) + matrix.n_rows,
+        touched.colptr(i));
+  }
+
+  matrix.swap(touched);
+}
+
+/**
+ * Set whether data::Load() places the matrices it loads with FirstTouch().
+ * This is disabled by default; the command-line programs enable it with the
+ * --first_touch option.
+ *
+ * @param enable Whether to place the loaded matrices.
+ */
+void SetFirstTouch(const bool enable);
+
+//! Return whether data::Load() places the matrices it loads with FirstTouch().
+bool FirstTouchEnabled();
+
+} // namespace data
+} // namespace mlpack
+
+#endif
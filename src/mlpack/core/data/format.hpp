@@ -16,15 +16,33 @@
 namespace mlpack {
 namespace data {
 
-//! Define the formats we can read through boost::serialization.
+/**
+ * Define the formats we can read through boost::serialization.  The compressed
+ * formats stream a binary archive through gzip compression; with
+ * compressed_float32 and compressed_float16, the floating-point elements of
+ * Armadillo objects are also stored in single or half precision.  Reduced
+ * precision suits models whose matrices are only read after loading (like the
+ * weights of a network); models that keep bounds computed from their data,
+ * like trees, should keep full precision.
+ */
 enum format
 {
   autodetect,
   text,
   xml,
-  binary
+  binary,
+  compressed,
+  compressed_float32,
+  compressed_float16
 };
 
+//! Return whether the given format is one of the compressed formats.
+inline bool IsCompressed(const format f)
+{
+  return (f == compressed || f == compressed_float32 ||
+      f == compressed_float16);
+}
+
 } // namespace data
 } // namespace mlpack
 
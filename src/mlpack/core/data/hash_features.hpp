@@ -0,0 +1,104 @@
+/**
+ * @file hash_features.hpp
+ *
+ * Defines HashFeatures(), which turns a dataset loaded with HashingPolicy into
+ * sparse features for linear models.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_HASH_FEATURES_HPP
+#define MLPACK_CORE_DATA_HASH_FEATURES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
+#include "map_policies/hashing_policy.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Given a dataset loaded with a DatasetMapper<HashingPolicy>, build the sparse
+ * matrix of hashed features: the numeric dimensions are kept, in order, as the
+ * first rows, and they are followed by one row per bucket.  Each categorical
+ * value of a point adds its sign (1, unless signed hashing is used) to the row
+ * of its bucket, so values of different dimensions that share a bucket are
+ * added up.  The result can be given to linear models that take sparse
+ * matrices, like LogisticRegression<arma::sp_mat> and
+ * SoftmaxRegression<arma::sp_mat>.
+ *
+ * @code
+ * data::HashingPolicy policy(1 << 18, true);
+ * data::DatasetMapper<data::HashingPolicy> info(policy);
+ * arma::mat dataset;
+ * data::Load("clicks.csv", dataset, info, true);
+ *
+ * arma::sp_mat features;
+ * data::HashFeatures(dataset, info, features);
+ * @endcode
+ *
+ * @param input Dataset loaded with the given DatasetMapper.
+ * @param info DatasetMapper the dataset was loaded with.
+ * @param output Sparse matrix to store the hashed features into.
+ */
+template<typename eT>
+void HashFeatures(const arma::Mat<eT>& input,
+                  const DatasetMapper<HashingPolicy>& info,
+                  arma::sp_mat& output)
+{
+  if (input.n_rows != info.Dimensionality())
+  {
+    Log::Fatal << "HashFeatures(): the dataset has " << input.n_rows
+        << " dimensions, but the DatasetMapper has " << info.Dimensionality()
+        << "!" << std::endl;
+  }
+
+  const HashingPolicy& policy = info.Policy();
+
+  // The row of every numeric dimension; categorical dimensions get none.
+  std::vector<size_t> rows(input.n_rows);
+  std::vector<char> categorical(input.n_rows);
+  size_t numNumeric = 0;
+  for (size_t d = 0; d < input.n_rows; ++d)
+  {
+    categorical[d] = (info.Type(d) == Datatype::categorical);
+    if (!categorical[d])
+      rows[d] = numNumeric++;
+  }
+
+  // Every point has one value per dimension; zeros (including collisions
+  // that cancel out) are removed when the matrix is built.
+  arma::umat locations(2, input.n_elem);
+  arma::vec values(input.n_elem);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    for (size_t d = 0; d < input.n_rows; ++d)
+    {
+      const size_t index = i * input.n_rows + d;
+      locations(1, index) = i;
+      if (categorical[d])
+      {
+        const size_t value = (size_t) input(d, i);
+        locations(0, index) = numNumeric + policy.Bucket(value);
+        values[index] = policy.Sign(value);
+      }
+      else
+      {
+        locations(0, index) = rows[d];
+        values[index] = (double) input(d, i);
+      }
+    }
+  }
+
+  output = arma::sp_mat(true, locations, values,
+      numNumeric + policy.NumBuckets(), input.n_cols);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
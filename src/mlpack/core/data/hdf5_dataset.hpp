@@ -0,0 +1,168 @@
+/**
+ * @file hdf5_dataset.hpp
+ *
+ * Read rectangular parts of a matrix stored in an HDF5 file, without loading
+ * the whole matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_HDF5_DATASET_HPP
+#define MLPACK_CORE_DATA_HDF5_DATASET_HPP
+
+#include <mlpack/prereqs.hpp>
+
+// Armadillo includes hdf5.h when it is configured with HDF5 support; without
+// it there is nothing to read HDF5 files with.
+#ifdef ARMA_USE_HDF5
+
+namespace mlpack {
+namespace data {
+
+/**
+ * HDF5Dataset gives access to parts of a matrix stored in an HDF5 file, in the
+ * layout that Armadillo (and so data::Save()) uses: a dataset with one or two
+ * dimensions, where the first HDF5 dimension is the column of the matrix.
+ * Each Read() selects a hyperslab of the dataset, so only the requested rows
+ * and columns are read from the file.  A range of columns is one contiguous
+ * block of the stored matrix; a range of rows is strided.
+ *
+ * Datasets stored in chunks can be read efficiently by requesting ranges that
+ * are aligned to the chunks (see ChunkCols() and ChunkRows()), since HDF5 then
+ * reads and decompresses each chunk once.  When the chunks are compressed with
+ * the deflate filter only and the stored element type is eT, the chunks are
+ * read raw and decompressed in parallel with OpenMP (this needs HDF5 1.10.3
+ * or newer); otherwise the selection is read with H5Dread().
+ *
+ * One HDF5Dataset must not be used from several threads at the same time,
+ * since HDF5 itself is usually not built to be thread-safe.
+ *
+ * @code
+ * data::HDF5Dataset<> dataset("points.h5");
+ * arma::mat block;
+ * // Columns 1000 to 1999, with all rows.
+ * dataset.Read(1000, 1000, block);
+ * @endcode
+ *
+ * @tparam eT Element type of the matrices to read into.
+ */
+template<typename eT = double>
+class HDF5Dataset
+{
+ public:
+  /**
+   * Open the given dataset of the given HDF5 file.  Throws std::runtime_error
+   * if the file or the dataset cannot be opened, or if the dataset does not
+   * have one or two dimensions.
+   *
+   * @param filename HDF5 file to open.
+   * @param datasetName Name of the dataset in the file; Armadillo uses
+   *     "dataset" by default.
+   */
+  HDF5Dataset(const std::string& filename,
+              const std::string& datasetName = "dataset");
+
+  //! Close the dataset and the file.
+  ~HDF5Dataset();
+
+  // An HDF5Dataset owns its HDF5 handles.
+  HDF5Dataset(const HDF5Dataset&) = delete;
+  HDF5Dataset& operator=(const HDF5Dataset&) = delete;
+
+  /**
+   * Read the given range of columns, with all rows.  Throws std::out_of_range
+   * if the range is not inside the matrix, and std::runtime_error if the read
+   * fails.
+   *
+   * @param firstCol First column to read.
+   * @param numCols Number of columns to read.
+   * @param matrix Matrix to store the columns in.
+   */
+  void Read(const size_t firstCol,
+            const size_t numCols,
+            arma::Mat<eT>& matrix) const
+  {
+    Read(0, this->numRows, firstCol, numCols, matrix);
+  }
+
+  /**
+   * Read the given block of the matrix.  Throws std::out_of_range if the block
+   * is not inside the matrix, and std::runtime_error if the read fails.
+   *
+   * @param firstRow First row to read.
+   * @param numRows Number of rows to read.
+   * @param firstCol First column to read.
+   * @param numCols Number of columns to read.
+   * @param matrix Matrix to store the block in.
+   */
+  void Read(const size_t firstRow,
+            const size_t numRows,
+            const size_t firstCol,
+            const size_t numCols,
+            arma::Mat<eT>& matrix) const;
+
+  //! Get the number of rows of the stored matrix.
+  size_t NumRows() const { return numRows; }
+  //! Get the number of columns of the stored matrix.
+  size_t NumCols() const { return numCols; }
+  //! Get whether the dataset is stored in chunks.
+  bool Chunked() const { return chunked; }
+  //! Get the number of rows of each chunk (NumRows() if it is not chunked).
+  size_t ChunkRows() const { return chunkRows; }
+  //! Get the number of columns of each chunk (NumCols() if it is not chunked).
+  size_t ChunkCols() const { return chunkCols; }
+
+ private:
+  //! Read the block with one hyperslab selection and H5Dread().
+  void ReadHyperslab(const size_t firstRow,
+                     const size_t numRows,
+                     const size_t firstCol,
+                     const size_t numCols,
+                     arma::Mat<eT>& matrix) const;
+
+  /**
+   * Read the block by reading the raw chunks that overlap it and decompressing
+   * them in parallel.  Returns false, without reading anything, if some of the
+   * chunks were never written (HDF5 then fills them in).
+   */
+  bool ReadChunks(const size_t firstRow,
+                  const size_t numRows,
+                  const size_t firstCol,
+                  const size_t numCols,
+                  arma::Mat<eT>& matrix) const;
+
+  //! The name of the file.
+  std::string filename;
+  //! The open file.
+  hid_t file;
+  //! The open dataset.
+  hid_t dataset;
+  //! Number of dimensions of the dataset (1 or 2).
+  int rank;
+  //! Number of rows of the stored matrix.
+  size_t numRows;
+  //! Number of columns of the stored matrix.
+  size_t numCols;
+  //! Whether the dataset is stored in chunks.
+  bool chunked;
+  //! Number of rows of each chunk.
+  size_t chunkRows;
+  //! Number of columns of each chunk.
+  size_t chunkCols;
+  //! Whether the raw chunks can be decompressed by ReadChunks().
+  bool rawChunks;
+  //! Whether the chunks are compressed with the deflate filter.
+  bool deflate;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "hdf5_dataset_impl.hpp"
+
+#endif // ARMA_USE_HDF5
+
+#endif
@@ -0,0 +1,371 @@
+/**
+ * @file hdf5_dataset_impl.hpp
+ *
+ * Implementation of HDF5Dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_HDF5_DATASET_IMPL_HPP
+#define MLPACK_CORE_DATA_HDF5_DATASET_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hdf5_dataset.hpp"
+
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+HDF5Dataset<eT>::HDF5Dataset(const std::string& filename,
+                             const std::string& datasetName) :
+    filename(filename),
+    file(-1),
+    dataset(-1),
+    rank(0),
+    numRows(0),
+    numCols(0),
+    chunked(false),
+    chunkRows(0),
+    chunkCols(0),
+    rawChunks(false),
+    deflate(false)
+{
+  // Don't let HDF5 print its error stack; the exceptions say what failed.
+  H5E_BEGIN_TRY
+  {
+    file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file >= 0)
+      dataset = H5Dopen(file, datasetName.c_str(), H5P_DEFAULT);
+  }
+  H5E_END_TRY;
+
+  if (file < 0)
+  {
+    std::ostringstream oss;
+    oss << "HDF5Dataset::HDF5Dataset(): cannot open '" << filename << "' as an "
+        << "HDF5 file!";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (dataset < 0)
+  {
+    H5Fclose(file);
+    std::ostringstream oss;
+    oss << "HDF5Dataset::HDF5Dataset(): '" << filename << "' has no dataset "
+        << "named '" << datasetName << "'!";
+    throw std::runtime_error(oss.str());
+  }
+
+  const hid_t space = H5Dget_space(dataset);
+  rank = H5Sget_simple_extent_ndims(space);
+  hsize_t dims[2] = { 0, 1 };
+  if (rank == 1 || rank == 2)
+    H5Sget_simple_extent_dims(space, dims, NULL);
+  H5Sclose(space);
+
+  if (rank != 1 && rank != 2)
+  {
+    H5Dclose(dataset);
+    H5Fclose(file);
+    std::ostringstream oss;
+    oss << "HDF5Dataset::HDF5Dataset(): dataset '" << datasetName << "' of '"
+        << filename << "' must have one or two dimensions, but it has " << rank
+        << "!";
+    throw std::runtime_error(oss.str());
+  }
+
+  // Armadillo stores the columns in the first (slowest) dimension.
+  numCols = dims[0];
+  numRows = dims[1];
+  chunkCols = numCols;
+  chunkRows = numRows;
+
+  const hid_t plist = H5Dget_create_plist(dataset);
+  if (H5Pget_layout(plist) == H5D_CHUNKED)
+  {
+    hsize_t chunkDims[2] = { 0, 1 };
+    H5Pget_chunk(plist, rank, chunkDims);
+    chunked = true;
+    chunkCols = chunkDims[0];
+    chunkRows = chunkDims[1];
+
+    // We can only decompress the raw chunks ourselves if deflate is the only
+    // filter and the elements are stored exactly as we want them.
+    rawChunks = true;
+    const int numFilters = H5Pget_nfilters(plist);
+    for (int i = 0; i < numFilters; ++i)
+    {
+      unsigned int flags = 0;
+      size_t numValues = 0;
+      const H5Z_filter_t filter = H5Pget_filter2(plist, (unsigned int) i,
+          &flags, &numValues, NULL, 0, NULL, NULL);
+      if (filter == H5Z_FILTER_DEFLATE)
+        deflate = true;
+      else
+        rawChunks = false;
+    }
+
+    const hid_t fileType = H5Dget_type(dataset);
+    const hid_t memType = arma::hdf5_misc::get_hdf5_type<eT>();
+    if (H5Tequal(fileType, memType) <= 0)
+      rawChunks = false;
+    H5Tclose(memType);
+    H5Tclose(fileType);
+  }
+  H5Pclose(plist);
+}
+
+template<typename eT>
+HDF5Dataset<eT>::~HDF5Dataset()
+{
+  H5Dclose(dataset);
+  H5Fclose(file);
+}
+
+template<typename eT>
+void HDF5Dataset<eT>::Read(const size_t firstRow,
+                           const size_t numRows,
+                           const size_t firstCol,
+                           const size_t numCols,
+                           arma::Mat<eT>& matrix) const
+{
+  if (firstRow > this->numRows || numRows > this->numRows - firstRow ||
+      firstCol > this->numCols || numCols > this->numCols - firstCol)
+  {
+    std::ostringstream oss;
+    oss << "HDF5Dataset::Read(): cannot read " << numRows << " rows from row "
+        << firstRow << " and " << numCols << " columns from column "
+        << firstCol << " of a " << this->numRows << " x " << this->numCols
+        << " matrix!";
+    throw std::out_of_range(oss.str());
+  }
+
+  matrix.set_size(numRows, numCols);
+  if (matrix.n_elem == 0)
+    return;
+
+  if (rawChunks && ReadChunks(firstRow, numRows, firstCol, numCols, matrix))
+    return;
+
+  ReadHyperslab(firstRow, numRows, firstCol, numCols, matrix);
+}
+
+template<typename eT>
+void HDF5Dataset<eT>::ReadHyperslab(const size_t firstRow,
+                                    const size_t numRows,
+                                    const size_t firstCol,
+                                    const size_t numCols,
+                                    arma::Mat<eT>& matrix) const
+{
+  // The selection has the same layout as the column-major block.
+  const hsize_t offset[2] = { firstCol, firstRow };
+  const hsize_t count[2] = { numCols, numRows };
+
+  const hid_t fileSpace = H5Dget_space(dataset);
+  const hid_t memSpace = H5Screate_simple(rank, count, NULL);
+  const hid_t memType = arma::hdf5_misc::get_hdf5_type<eT>();
+
+  herr_t status;
+  H5E_BEGIN_TRY
+  {
+    status = H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, offset, NULL,
+        count, NULL);
+    if (status >= 0)
+    {
+      status = H5Dread(dataset, memType, memSpace, fileSpace, H5P_DEFAULT,
+          matrix.memptr());
+    }
+  }
+  H5E_END_TRY;
+
+  H5Tclose(memType);
+  H5Sclose(memSpace);
+  H5Sclose(fileSpace);
+
+  if (status < 0)
+  {
+    std::ostringstream oss;
+    oss << "HDF5Dataset::Read(): unable to read from '" << filename << "'!";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+template<typename eT>
+bool HDF5Dataset<eT>::ReadChunks(const size_t firstRow,
+                                 const size_t numRows,
+                                 const size_t firstCol,
+                                 const size_t numCols,
+                                 arma::Mat<eT>& matrix) const
+{
+#if H5_VERSION_GE(1, 10, 3)
+  // Find the chunks that overlap the block, and make sure all of them exist.
+  const size_t firstChunkCol = firstCol / chunkCols;
+  const size_t lastChunkCol = (firstCol + numCols - 1) / chunkCols;
+  const size_t firstChunkRow = firstRow / chunkRows;
+  const size_t lastChunkRow = (firstRow + numRows - 1) / chunkRows;
+
+  std::vector<std::pair<size_t, size_t>> chunks;
+  std::vector<hsize_t> sizes;
+  for (size_t c = firstChunkCol; c <= lastChunkCol; ++c)
+  {
+    for (size_t r = firstChunkRow; r <= lastChunkRow; ++r)
+    {
+      const hsize_t offset[2] = { c * chunkCols, r * chunkRows };
+      hsize_t size = 0;
+      herr_t status;
+      H5E_BEGIN_TRY
+      {
+        status = H5Dget_chunk_storage_size(dataset, offset, &size);
+      }
+      H5E_END_TRY;
+
+      if (status < 0 || size == 0)
+        return false;
+
+      chunks.push_back(std::make_pair(c, r));
+      sizes.push_back(size);
+    }
+  }
+
+  #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+  #else
+    const size_t numThreads = 1;
+  #endif
+
+  // Reading from the file is serial, so the chunks are read in batches, and
+  // each batch is decompressed in parallel.  That also limits the memory that
+  // the raw chunks take.
+  const size_t batchSize = 2 * numThreads;
+  const size_t chunkElements = chunkRows * chunkCols;
+  std::vector<std::vector<char>> raw(batchSize);
+  std::vector<uint32_t> filterMasks(batchSize);
+  std::vector<std::vector<eT>> buffers(numThreads,
+      std::vector<eT>(deflate ? chunkElements : 0));
+
+  for (size_t batch = 0; batch < chunks.size(); batch += batchSize)
+  {
+    const size_t batchEnd = std::min(batch + batchSize, chunks.size());
+    for (size_t i = batch; i < batchEnd; ++i)
+    {
+      const hsize_t offset[2] = { chunks[i].first * chunkCols,
+                                  chunks[i].second * chunkRows };
+      std::vector<char>& data = raw[i - batch];
+      data.resize(sizes[i]);
+
+      herr_t status;
+      H5E_BEGIN_TRY
+      {
+        status = H5Dread_chunk(dataset, H5P_DEFAULT, offset,
+            &filterMasks[i - batch], data.data());
+      }
+      H5E_END_TRY;
+
+      if (status < 0)
+      {
+        std::ostringstream oss;
+        oss << "HDF5Dataset::Read(): unable to read a chunk from '" << filename
+            << "'!";
+        throw std::runtime_error(oss.str());
+      }
+    }
+
+    std::vector<char> failed(batchEnd - batch, 0);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = batch; i < (omp_size_t) batchEnd; ++i)
+    {
+      #ifdef HAS_OPENMP
+        const size_t thread = omp_get_thread_num();
+      #else
+        const size_t thread = 0;
+      #endif
+
+      const std::vector<char>& data = raw[i - batch];
+      const eT* chunk = reinterpret_cast<const eT*>(data.data());
+
+      // The deflate filter is the first one; its bit in the mask is set if it
+      // was skipped for this chunk.
+      if (deflate && !(filterMasks[i - batch] & 1))
+      {
+        try
+        {
+          namespace io = boost::iostreams;
+          io::filtering_istream in;
+          in.push(io::zlib_decompressor());
+          in.push(io::array_source(data.data(), data.size()));
+          in.read(reinterpret_cast<char*>(buffers[thread].data()),
+              std::streamsize(chunkElements * sizeof(eT)));
+          if (in.gcount() != std::streamsize(chunkElements * sizeof(eT)))
+            failed[i - batch] = 1;
+        }
+        catch (std::exception& /* e */)
+        {
+          failed[i - batch] = 1;
+        }
+
+        chunk = buffers[thread].data();
+      }
+      else if (data.size() < chunkElements * sizeof(eT))
+      {
+        failed[i - batch] = 1;
+      }
+
+      if (failed[i - batch])
+        continue;
+
+      // Copy the part of the chunk that is inside the block.  Chunks at the
+      // edges of the dataset have their full size too.
+      const size_t chunkFirstCol = chunks[i].first * chunkCols;
+      const size_t chunkFirstRow = chunks[i].second * chunkRows;
+      const size_t colBegin = std::max(firstCol, chunkFirstCol);
+      const size_t colEnd = std::min(firstCol + numCols,
+          chunkFirstCol + chunkCols);
+      const size_t rowBegin = std::max(firstRow, chunkFirstRow);
+      const size_t rowEnd = std::min(firstRow + numRows,
+          chunkFirstRow + chunkRows);
+
+      for (size_t col = colBegin; col < colEnd; ++col)
+      {
+        std::copy(chunk + (col - chunkFirstCol) * chunkRows +
+            (rowBegin - chunkFirstRow), chunk + (col - chunkFirstCol) *
+            chunkRows + (rowEnd - chunkFirstRow),
+            matrix.colptr(col - firstCol) + (rowBegin - firstRow));
+      }
+    }
+
+    if (std::find(failed.begin(), failed.end(), 1) != failed.end())
+    {
+      std::ostringstream oss;
+      oss << "HDF5Dataset::Read(): unable to decompress a chunk of '"
+          << filename << "'!";
+      throw std::runtime_error(oss.str());
+    }
+  }
+
+  return true;
+#else
+  // Raw chunks can't be read with this version of HDF5.
+  (void) firstRow;
+  (void) numRows;
+  (void) firstCol;
+  (void) numCols;
+  (void) matrix;
+  return false;
+#endif
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
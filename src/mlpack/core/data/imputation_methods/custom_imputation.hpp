@@ -14,6 +14,10 @@
 
 #include <mlpack/prereqs.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace data {
 /**
@@ -46,28 +50,16 @@ class CustomImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    // replace the target value to custom value
-    if (columnMajor)
-    {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          input(dimension, i) = customValue;
-        }
-      }
-    }
-    else
+    // Replace the target value with the custom value.  Every element of the
+    // dimension is independent, so they are checked in parallel.
+    const size_t n = columnMajor ? input.n_cols : input.n_rows;
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
-      {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          input(i, dimension) = customValue;
-        }
-      }
+      T& value = columnMajor ? input(dimension, i) : input(i, dimension);
+      if (value == mappedValue || std::isnan(value))
+        value = customValue;
     }
   }
 
@@ -14,6 +14,10 @@
 
 #include <mlpack/prereqs.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace data {
 /**
@@ -39,32 +43,55 @@ class ListwiseDeletion
               const size_t dimension,
               const bool columnMajor = true)
   {
-    std::vector<arma::uword> colsToKeep;
+    const size_t n = columnMajor ? input.n_cols : input.n_rows;
+
+    // Mark the points to keep in parallel.
+    std::vector<char> keep(n);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    {
+      const T value = columnMajor ? input(dimension, i) : input(i, dimension);
+      keep[i] = !(value == mappedValue || std::isnan(value));
+    }
 
+    std::vector<arma::uword> toKeep;
+    for (size_t i = 0; i < n; ++i)
+      if (keep[i])
+        toKeep.push_back(i);
+
+    if (toKeep.size() == n)
+      return;
+
+    // Compact the matrix once: every column of the output is copied by one
+    // thread, from a column of the input or from the kept rows of it.
+    arma::Mat<T> output;
     if (columnMajor)
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
+      output.set_size(input.n_rows, toKeep.size());
+
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) toKeep.size(); ++i)
       {
-         if (!(input(dimension, i) == mappedValue ||
-             std::isnan(input(dimension, i))))
-         {
-           colsToKeep.push_back(i);
-         }
+        std::copy(input.colptr(toKeep[i]), input.colptr(toKeep[i]) +
+            input.n_rows, output.colptr(i));
       }
-      input = input.cols(arma::uvec(colsToKeep));
     }
     else
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      output.set_size(toKeep.size(), input.n_cols);
+
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t j = 0; j < (omp_size_t) input.n_cols; ++j)
       {
-        if (!(input(i, dimension) == mappedValue ||
-             std::isnan(input(i, dimension))))
-        {
-           colsToKeep.push_back(i);
-        }
+        const T* inputCol = input.colptr(j);
+        T* outputCol = output.colptr(j);
+        for (size_t i = 0; i < toKeep.size(); ++i)
+          outputCol[i] = inputCol[toKeep[i]];
       }
-      input = input.rows(arma::uvec(colsToKeep));
     }
+
+    input = std::move(output);
   }
 }; // class ListwiseDeletion
 
@@ -14,6 +14,10 @@
 
 #include <mlpack/prereqs.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace data {
 /**
@@ -39,47 +43,53 @@ class MeanImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    double sum = 0;
-    size_t elems = 0; // excluding nan or missing target
+    #ifdef HAS_OPENMP
+      const size_t numThreads = omp_get_max_threads();
+    #else
+      const size_t numThreads = 1;
+    #endif
 
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
+    const size_t n = columnMajor ? input.n_cols : input.n_rows;
 
+    // Calculate the number of elements and their sum, excluding mapped values
+    // and NaNs.  Each thread sums its part of the dimension; the sums are added
+    // in a fixed order, so the mean doesn't depend on the scheduling.
+    std::vector<double> sums(numThreads, 0.0);
+    std::vector<size_t> counts(numThreads, 0);
 
-    // calculate number of elements and sum of them excluding mapped value or
-    // nan. while doing that, remember where mappedValue or NaN exists.
-    if (columnMajor)
+    #pragma omp parallel
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
+      #ifdef HAS_OPENMP
+        const size_t thread = omp_get_thread_num();
+      #else
+        const size_t thread = 0;
+      #endif
+
+      double sum = 0.0;
+      size_t count = 0;
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
       {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          targets.emplace_back(dimension, i);
-        }
-        else
+        const T value = columnMajor ? input(dimension, i) :
+            input(i, dimension);
+        if (!(value == mappedValue || std::isnan(value)))
         {
-          elems++;
-          sum += input(dimension, i);
+          sum += value;
+          ++count;
         }
       }
+
+      sums[thread] = sum;
+      counts[thread] = count;
     }
-    else
+
+    double sum = 0.0;
+    size_t elems = 0; // excluding nan or missing target
+    for (size_t t = 0; t < numThreads; ++t)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
-      {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-          elems++;
-          sum += input(i, dimension);
-        }
-      }
+      sum += sums[t];
+      elems += counts[t];
     }
 
     if (elems == 0)
@@ -87,13 +97,15 @@ class MeanImputation
           << "the dimension" << std::endl;
 
     // calculate mean;
-    const double mean = sum / elems;
+    const T mean = sum / elems;
 
-    // Now replace the calculated mean to the missing variables
-    // It only needs to loop through targets vector, not the whole matrix.
-    for (const PairType& target : targets)
+    // Now replace the missing values with the calculated mean, in place.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
     {
-      input(target.first, target.second) = mean;
+      T& value = columnMajor ? input(dimension, i) : input(i, dimension);
+      if (value == mappedValue || std::isnan(value))
+        value = mean;
     }
   }
 }; // class MeanImputation
@@ -14,6 +14,10 @@
 
 #include <mlpack/prereqs.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace data {
 /**
@@ -40,49 +44,68 @@ class MedianImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
-    // good elements are kept inside this vector.
-    std::vector<double> elemsToKeep;
+    #ifdef HAS_OPENMP
+      const size_t numThreads = omp_get_max_threads();
+    #else
+      const size_t numThreads = 1;
+    #endif
+
+    const size_t n = columnMajor ? input.n_cols : input.n_rows;
 
-    if (columnMajor)
+    // Good elements are collected by each thread, then concatenated.
+    std::vector<std::vector<double>> threadElems(numThreads);
+
+    #pragma omp parallel
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
+      #ifdef HAS_OPENMP
+        std::vector<double>& elems = threadElems[omp_get_thread_num()];
+      #else
+        std::vector<double>& elems = threadElems[0];
+      #endif
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
       {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          targets.emplace_back(dimension, i);
-        }
-        else
-        {
-          elemsToKeep.push_back(input(dimension, i));
-        }
+        const T value = columnMajor ? input(dimension, i) :
+            input(i, dimension);
+        if (!(value == mappedValue || std::isnan(value)))
+          elems.push_back(value);
       }
     }
-    else
+
+    std::vector<double> elemsToKeep = std::move(threadElems[0]);
+    for (size_t t = 1; t < numThreads; ++t)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
-      {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-           elemsToKeep.push_back(input(i, dimension));
-        }
-      }
+      elemsToKeep.insert(elemsToKeep.end(), threadElems[t].begin(),
+          threadElems[t].end());
     }
 
-    // calculate median
-    const double median = arma::median(arma::vec(elemsToKeep));
+    if (elemsToKeep.empty())
+      Log::Fatal << "it is impossible to calculate median; no valid elements "
+          << "in the dimension" << std::endl;
+
+    // Calculate the median by selection, without sorting: the upper middle
+    // element is put in place, and for an even number of elements the lower
+    // middle element is the largest of those before it.
+    const size_t middle = elemsToKeep.size() / 2;
+    std::nth_element(elemsToKeep.begin(), elemsToKeep.begin() + middle,
+        elemsToKeep.end());
+    double median = elemsToKeep[middle];
+    if (elemsToKeep.size() % 2 == 0)
+    {
+      const double lower = *std::max_element(elemsToKeep.begin(),
+          elemsToKeep.begin() + middle);
+      median = lower + (median - lower) / 2.0;
+    }
 
-    for (const PairType& target : targets)
+    // Now replace the missing values with the median, in place.
+    const T fill = median;
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
     {
-       input(target.first, target.second) = median;
+      T& value = columnMajor ? input(dimension, i) : input(i, dimension);
+      if (value == mappedValue || std::isnan(value))
+        value = fill;
     }
   }
 }; // class MedianImputation
@@ -0,0 +1,129 @@
+/**
+ * @file lazy_model.hpp
+ *
+ * A saved model whose header is loaded immediately and whose full contents are
+ * only loaded when they are first needed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LAZY_MODEL_HPP
+#define MLPACK_CORE_DATA_LAZY_MODEL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <memory>
+
+#include "load.hpp"
+#include "extension.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * LazyModel refers to a model saved with data::Save().  The constructor only
+ * loads the header of the model, which is read from the beginning of the file
+ * (for instance, neighbor::NSModelHeader for a neighbor::NSModel); the whole
+ * model, with its trees and reference set, is loaded the first time Model()
+ * is called.  This lets a program list, validate and choose between many
+ * saved models for the cost of reading a few bytes of each.
+ *
+ * Headers can only be read partially from binary and text archives; for an XML
+ * archive, the model is loaded by the constructor and the header is built from
+ * it.  The HeaderType must be default-constructible, constructible from a
+ * ModelType, and serializable (for loading) from the beginning of a ModelType
+ * archive.
+ *
+ * @code
+ * data::LazyModel<neighbor::NSModel<neighbor::NearestNeighborSort>,
+ *     neighbor::NSModelHeader<neighbor::NearestNeighborSort>>
+ *     model("knn.bin");
+ * if (model.Header().Dimensionality() == queries.n_rows)
+ *   model.Model().Search(std::move(queries), k, neighbors, distances);
+ * @endcode
+ *
+ * @tparam ModelType Type of the saved model.
+ * @tparam HeaderType Type of the header of the model.
+ */
+template<typename ModelType, typename HeaderType>
+class LazyModel
+{
+ public:
+  /**
+   * Load the header of the model in the given file.  A std::runtime_error is
+   * thrown if it can't be loaded.
+   *
+   * @param filename File the model was saved to.
+   * @param name Name the model was saved with.
+   * @param f Format of the file; by default, given by the extension.
+   */
+  LazyModel(const std::string& filename,
+            const std::string& name = "model",
+            const format f = format::autodetect) :
+      filename(filename),
+      name(name),
+      f(f)
+  {
+    if (f == format::xml ||
+        (f == format::autodetect && Extension(filename) == "xml"))
+    {
+      // XML archives can't be read partially.
+      Model();
+      header = HeaderType(*model);
+    }
+    else if (!data::Load(filename, name, header, false, f))
+    {
+      throw std::runtime_error("LazyModel: cannot load the header of the "
+          "model in '" + filename + "'.");
+    }
+  }
+
+  //! Get the header of the model.
+  const HeaderType& Header() const { return header; }
+
+  /**
+   * Get the model, loading it if this is the first call.  A
+   * std::runtime_error is thrown if it can't be loaded.  This is not
+   * thread-safe: the first call must not be concurrent with any other.
+   */
+  ModelType& Model()
+  {
+    if (!model)
+    {
+      std::unique_ptr<ModelType> loaded(new ModelType());
+      if (!data::Load(filename, name, *loaded, false, f))
+      {
+        throw std::runtime_error("LazyModel: cannot load the model in '" +
+            filename + "'.");
+      }
+
+      model = std::move(loaded);
+    }
+
+    return *model;
+  }
+
+  //! Get whether the model has been loaded.
+  bool Loaded() const { return (bool) model; }
+
+  //! Get the file the model is loaded from.
+  const std::string& Filename() const { return filename; }
+
+ private:
+  //! The file the model is loaded from.
+  std::string filename;
+  //! The name the model was saved with.
+  std::string name;
+  //! The format of the file.
+  format f;
+  //! The header of the model.
+  HeaderType header;
+  //! The model, once it is loaded.
+  std::unique_ptr<ModelType> model;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
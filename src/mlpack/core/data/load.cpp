@@ -84,5 +84,17 @@ template bool Load<double, IncrementPolicy>(const std::string&,
                                             const bool,
                                             const bool);
 
+template bool Load<float, HashingPolicy>(const std::string&,
+                                         arma::Mat<float>&,
+                                         DatasetMapper<HashingPolicy>&,
+                                         const bool,
+                                         const bool);
+
+template bool Load<double, HashingPolicy>(const std::string&,
+                                          arma::Mat<double>&,
+                                          DatasetMapper<HashingPolicy>&,
+                                          const bool,
+                                          const bool);
+
 } // namespace data
 } // namespace mlpack
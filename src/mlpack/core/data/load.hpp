@@ -40,6 +40,8 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
+ *  - Parquet, denoted by .parquet, and Arrow IPC, denoted by .arrow, .feather
+ *    or .ipc, if mlpack was built with Arrow (see LoadArrow())
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -120,6 +122,8 @@ extern template bool Load<double>(const std::string&,
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
+ *  - Parquet, denoted by .parquet, and Arrow IPC, denoted by .arrow, .feather
+ *    or .ipc, if mlpack was built with Arrow (see LoadArrow())
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -152,6 +156,8 @@ bool Load(const std::string& filename,
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
+ *  - Parquet, denoted by .parquet, and Arrow IPC, denoted by .arrow, .feather
+ *    or .ipc, if mlpack was built with Arrow (see LoadArrow())
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -170,16 +176,58 @@ bool Load(const std::string& filename,
           arma::Row<eT>& rowvec,
           const bool fatal = false);
 
+/**
+ * Load part of a matrix from an HDF5 file (.hdf, .hdf5, .h5, or .he5): only
+ * the given rows and columns are read, with a hyperslab selection, so a block
+ * of a matrix that does not fit in memory can be loaded.  The rows and columns
+ * are those of the loaded matrix; that is, of the transposed matrix if
+ * 'transpose' is true, just like for the other overloads of Load().  Use
+ * arma::span::all to select every row or every column.
+ *
+ * @code
+ * // Points 1000 to 1999 of a dataset saved with data::Save("data.h5", m).
+ * arma::mat block;
+ * data::Load("data.h5", block, arma::span::all, arma::span(1000, 1999));
+ * @endcode
+ *
+ * Reading a range of columns of the stored matrix (that is, of the loaded
+ * matrix if 'transpose' is false) reads one contiguous part of the file; to
+ * read a large dataset block by block, see StreamingDataset, and see
+ * HDF5Dataset for more control.
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the matrix does not load successfully.
+ *
+ * @param filename Name of HDF5 file to load.
+ * @param matrix Matrix to load the selected block into.
+ * @param rows Rows of the loaded matrix to select.
+ * @param cols Columns of the loaded matrix to select.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @param transpose If true, transpose the matrix after loading.
+ * @param datasetName Name of the dataset in the HDF5 file.
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::string& filename,
+          arma::Mat<eT>& matrix,
+          const arma::span& rows,
+          const arma::span& cols,
+          const bool fatal = false,
+          const bool transpose = true,
+          const std::string& datasetName = "dataset");
+
 /**
  * Loads a matrix from a file, guessing the filetype from the extension and
  * mapping categorical features with a DatasetMapper object.  This will
  * transpose the matrix (unless the transpose parameter is set to false).
- * This particular overload of Load() can only load text-based formats, such as
- * those given below:
+ * This particular overload of Load() can only load the formats given below:
  *
  * - CSV (csv_ascii), denoted by .csv, or optionally .txt
  * - TSV (raw_ascii), denoted by .tsv, .csv, or .txt
  * - ASCII (raw_ascii), denoted by .txt
+ * - ARFF, denoted by .arff
+ * - Parquet and Arrow IPC, denoted by .parquet, .arrow, .feather or .ipc, if
+ *   mlpack was built with Arrow; only DatasetInfo can be used with these
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -193,7 +241,10 @@ bool Load(const std::string& filename,
  * value of 'true'.
  *
  * The DatasetMapper object passed to this function will be re-created, so any
- * mappings from previous loads will be lost.
+ * mappings from previous loads will be lost; its policy is kept.  With
+ * HashingPolicy, categorical strings are hashed into a fixed number of buckets
+ * instead of being mapped, so no mappings are stored and the same string gets
+ * the same value in every file that is loaded with the same policy.
  *
  * @param filename Name of file to load.
  * @param matrix Matrix to load contents of file into.
@@ -251,6 +302,20 @@ extern template bool Load<double, IncrementPolicy>(
     const bool,
     const bool);
 
+extern template bool Load<float, HashingPolicy>(
+    const std::string&,
+    arma::Mat<float>&,
+    DatasetMapper<HashingPolicy>&,
+    const bool,
+    const bool);
+
+extern template bool Load<double, HashingPolicy>(
+    const std::string&,
+    arma::Mat<double>&,
+    DatasetMapper<HashingPolicy>&,
+    const bool,
+    const bool);
+
 /**
  * @endcond
  */
@@ -266,9 +331,12 @@ extern template bool Load<double, IncrementPolicy>(
  *  - text, denoted by .txt
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
+ *  - gzip-compressed binary, denoted by .gz
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary', and
+ * the compressed formats.  Any of the compressed formats loads a file saved
+ * with any of them, since the precision of the matrices is stored in the file.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
@@ -294,5 +362,7 @@ bool Load(const std::string& filename,
 #include "load_model_impl.hpp"
 // Include implementation of Load() for vectors.
 #include "load_vec_impl.hpp"
+// Include implementation of Load() for parts of HDF5 files.
+#include "load_hdf5_impl.hpp"
 
 #endif
@@ -14,7 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "dataset_mapper.hpp"
-#include <boost/tokenizer.hpp>
+#include "load_arff_parallel.hpp"
 
 namespace mlpack {
 namespace data {
@@ -44,6 +44,11 @@ void LoadARFF(const std::string& filename, arma::Mat<eT>& matrix);
  * loading the training set is not used, then the test set may be loaded with
  * different mappings---which can cause horrible problems!
  *
+ * The file is parsed in parallel with LoadARFFParallel; string and nominal
+ * attributes are categorical, and the values of a nominal attribute are mapped
+ * in the order they are declared.  Both dense and sparse ("{index value, ...}")
+ * instances can be loaded.
+ *
  * @param filename Name of ARFF file to load.
  * @param matrix Matrix to load data into.
  * @param info DatasetInfo object; can be default-constructed or pre-existing
@@ -54,6 +59,22 @@ void LoadARFF(const std::string& filename,
               arma::Mat<eT>& matrix,
               DatasetMapper<PolicyType>& info);
 
+/**
+ * Load an ARFF dataset into a sparse matrix, with one column per instance.
+ * Sparse instances are stored directly, so a dense matrix is never built; the
+ * DatasetInfo object is handled as by the dense overload.  An exception will
+ * be thrown upon failure.
+ *
+ * @param filename Name of ARFF file to load.
+ * @param matrix Sparse matrix to load data into.
+ * @param info DatasetInfo object; can be default-constructed or pre-existing
+ *     from another call to LoadARFF().
+ */
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::SpMat<eT>& matrix,
+              DatasetMapper<PolicyType>& info);
+
 } // namespace data
 } // namespace mlpack
 
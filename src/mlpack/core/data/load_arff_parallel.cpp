@@ -0,0 +1,214 @@
+/**
+ * @file load_arff_parallel.cpp
+ *
+ * Implementation of the non-templated parts of LoadARFFParallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "load_arff_parallel.hpp"
+
+namespace mlpack {
+namespace data {
+
+LoadARFFParallel::LoadARFFParallel(const std::string& file) :
+    filename(file),
+    contents(file),
+    dataLine(0)
+{
+  LoadCSVParallel::FindLines(contents, lineStarts);
+  ParseHeader();
+  FindPoints();
+}
+
+void LoadARFFParallel::ParseHeader()
+{
+  std::string buffer;
+  const size_t numLines = lineStarts.size() - 1;
+  for (size_t line = 0; line < numLines; ++line)
+  {
+    const char* pos;
+    const char* end;
+    LineBounds(line, pos, end);
+
+    // Skip empty lines and comments; anything else that isn't an annotation
+    // is ignored too.
+    if (pos == end || *pos != '@')
+      continue;
+
+    const char* annotationEnd = pos;
+    while (annotationEnd != end && !std::isspace((unsigned char) *annotationEnd)
+        && *annotationEnd != '%')
+      ++annotationEnd;
+
+    const std::string original(pos, annotationEnd);
+    std::string annotation(original);
+    std::transform(annotation.begin(), annotation.end(), annotation.begin(),
+        ::tolower);
+    pos = annotationEnd;
+
+    if (annotation == "@relation")
+    {
+      // We don't actually have anything to do with the name of the dataset.
+      continue;
+    }
+    else if (annotation == "@attribute")
+    {
+      // Skip the name of the attribute, which may be quoted.
+      while (pos != end && std::isspace((unsigned char) *pos))
+        ++pos;
+      if (pos != end && (*pos == '"' || *pos == '\''))
+      {
+        const char quote = *pos++;
+        while (pos != end && *pos != quote)
+        {
+          if (*pos == '\\' && pos + 1 != end)
+            ++pos;
+          ++pos;
+        }
+        if (pos != end)
+          ++pos;
+      }
+      else
+      {
+        while (pos != end && !std::isspace((unsigned char) *pos))
+          ++pos;
+      }
+      while (pos != end && std::isspace((unsigned char) *pos))
+        ++pos;
+
+      if (pos != end && *pos == '{')
+      {
+        // A nominal attribute; keep its values in order.
+        ++pos;
+        std::vector<std::string> values;
+        const char* tokenBegin;
+        const char* tokenEnd;
+        while (NextToken(pos, end, true, buffer, tokenBegin, tokenEnd))
+          values.push_back(std::string(tokenBegin, tokenEnd));
+
+        if (pos == end || *pos != '}')
+        {
+          std::ostringstream oss;
+          oss << "unterminated list of ARFF values on line " << (line + 1);
+          throw std::runtime_error(oss.str());
+        }
+
+        categorical.push_back(1);
+        nominalValues.push_back(std::move(values));
+        continue;
+      }
+
+      const char* typeEnd = pos;
+      while (typeEnd != end && !std::isspace((unsigned char) *typeEnd) &&
+          *typeEnd != '%')
+        ++typeEnd;
+
+      std::string type(pos, typeEnd);
+      std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+      if (type == "numeric" || type == "integer" || type == "real")
+      {
+        categorical.push_back(0);
+      }
+      else if (type == "string")
+      {
+        categorical.push_back(1);
+      }
+      else
+      {
+        std::ostringstream oss;
+        oss << "unsupported ARFF attribute type '" << std::string(pos, typeEnd)
+            << "' on line " << (line + 1);
+        throw std::runtime_error(oss.str());
+      }
+
+      nominalValues.push_back(std::vector<std::string>());
+    }
+    else if (annotation == "@data")
+    {
+      // The instances start on the next line.
+      dataLine = line + 1;
+      return;
+    }
+    else
+    {
+      throw std::runtime_error("unknown ARFF annotation '" + original + "'");
+    }
+  }
+
+  throw std::runtime_error("no @data section found");
+}
+
+void LoadARFFParallel::FindPoints()
+{
+  const size_t numLines = lineStarts.size() - 1;
+  std::vector<char> isPoint(numLines - dataLine);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t line = dataLine; line < (omp_size_t) numLines; ++line)
+  {
+    const char* begin;
+    const char* end;
+    LineBounds(line, begin, end);
+    isPoint[line - dataLine] = (begin != end && *begin != '%');
+  }
+
+  points.clear();
+  for (size_t line = dataLine; line < numLines; ++line)
+  {
+    if (isPoint[line - dataLine])
+      points.push_back(line);
+  }
+}
+
+bool LoadARFFParallel::NextToken(const char*& pos,
+                                 const char* end,
+                                 const bool sparse,
+                                 std::string& buffer,
+                                 const char*& tokenBegin,
+                                 const char*& tokenEnd)
+{
+  while (pos != end && (*pos == ' ' || *pos == '\t'))
+    ++pos;
+  if (pos == end || *pos == '%' || (sparse && *pos == '}'))
+    return false;
+
+  if (*pos == '"' || *pos == '\'')
+  {
+    // Copy the value without the quotes and the escape characters.
+    const char quote = *pos++;
+    buffer.clear();
+    while (pos != end && *pos != quote)
+    {
+      if (*pos == '\\' && pos + 1 != end)
+        ++pos;
+      buffer.push_back(*pos++);
+    }
+    if (pos != end)
+      ++pos;
+
+    tokenBegin = buffer.data();
+    tokenEnd = buffer.data() + buffer.size();
+
+    while (pos != end && (*pos == ' ' || *pos == '\t'))
+      ++pos;
+  }
+  else
+  {
+    tokenBegin = pos;
+    while (pos != end && *pos != ',' && *pos != '%' && !(sparse && *pos == '}'))
+      ++pos;
+    tokenEnd = pos;
+    LoadCSVParallel::Trim(tokenBegin, tokenEnd);
+  }
+
+  if (pos != end && *pos == ',')
+    ++pos;
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
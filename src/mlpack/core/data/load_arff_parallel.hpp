@@ -0,0 +1,172 @@
+/**
+ * @file load_arff_parallel.hpp
+ *
+ * An ARFF parser that memory-maps the file, reads the header, and then parses
+ * the instances of the @data section in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_ARFF_PARALLEL_HPP
+#define MLPACK_CORE_DATA_LOAD_ARFF_PARALLEL_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "dataset_mapper.hpp"
+#include "mapped_file.hpp"
+#include "load_csv_parallel.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Load an ARFF file with a DatasetMapper.  The header is read first, when the
+ * object is constructed: numeric, integer and real attributes are numeric, and
+ * string and nominal ({a, b, c}) attributes are categorical.  The lines of the
+ * file are found with the same parallel scan that LoadCSVParallel uses, and
+ * the instances of the @data section are then split between the threads:
+ *
+ *  - numeric values are parsed directly into the output by each thread;
+ *  - categorical values are kept by the thread that found them, and they are
+ *    mapped with the DatasetMapper in file order once all instances are
+ *    parsed, so the mappings are the ones a serial parser would create.
+ *
+ * The values of nominal attributes are mapped in the order they are declared
+ * before the data is parsed, so with IncrementPolicy the i'th declared value
+ * is mapped to i.
+ *
+ * Both dense instances ("1.5, red, 3") and sparse instances ("{0 1.5, 2 3}")
+ * are accepted, and they can be loaded into either a dense matrix or an
+ * arma::SpMat; a sparse matrix is filled directly, without ever building the
+ * dense matrix.  As in ARFF, the values left out of a sparse instance are 0;
+ * so are the values missing at the end of a dense instance (some files leave
+ * out the class attribute, for instance).
+ * Values may be quoted with single or double quotes, and '%' starts a comment
+ * anywhere outside of quotes.  Missing values ('?') are not supported.
+ */
+class LoadARFFParallel
+{
+ public:
+  /**
+   * Map the given file, find the boundaries of all its lines, and read the
+   * header.  Throws a std::runtime_error if the file cannot be opened or the
+   * header cannot be parsed.
+   *
+   * @param file Name of the file to load.
+   */
+  LoadARFFParallel(const std::string& file);
+
+  /**
+   * Load the instances into the given dense matrix, with one column per
+   * instance.  If info is empty (info.Dimensionality() is 0), it is set to the
+   * dimensionality of the file, keeping its policy; otherwise its
+   * dimensionality must match that of the file, and its mappings are reused.
+   * Throws exceptions on errors.
+   *
+   * @param matrix Matrix to load into.
+   * @param info DatasetMapper to use while loading.
+   */
+  template<typename T, typename PolicyType>
+  void Load(arma::Mat<T>& matrix, DatasetMapper<PolicyType>& info);
+
+  /**
+   * Load the instances into the given sparse matrix, with one column per
+   * instance.  The DatasetMapper is handled as by the dense overload.
+   *
+   * @param matrix Sparse matrix to load into.
+   * @param info DatasetMapper to use while loading.
+   */
+  template<typename T, typename PolicyType>
+  void Load(arma::SpMat<T>& matrix, DatasetMapper<PolicyType>& info);
+
+  //! Get the number of attributes.
+  size_t Dimensionality() const { return categorical.size(); }
+
+  //! Get the number of instances.
+  size_t NumPoints() const { return points.size(); }
+
+ private:
+  //! Read the header, up to and including the @data line.
+  void ParseHeader();
+
+  //! Find the lines of the @data section that hold instances.
+  void FindPoints();
+
+  //! Get the given line with whitespace removed from either side.
+  void LineBounds(const size_t line, const char*& begin, const char*& end) const
+  {
+    begin = contents.Data() + lineStarts[line];
+    end = contents.Data() + lineStarts[line + 1] - 1;
+    LoadCSVParallel::Trim(begin, end);
+  }
+
+  /**
+   * Set up the given DatasetMapper: reset it or check its dimensionality,
+   * set the type of each dimension, and map the declared nominal values.
+   */
+  template<typename T, typename PolicyType>
+  void PrepareInfo(DatasetMapper<PolicyType>& info) const;
+
+  /**
+   * Parse all instances in parallel.  Every value is passed to
+   * store(thread, point, dim, value), which returns a slot identifying where
+   * it was stored; categorical values are stored as 0 first, and are then
+   * mapped in file order and passed to assign(thread, slot, value).  Throws a
+   * std::runtime_error for the first line (in file order) that has an error.
+   */
+  template<typename T, typename PolicyType, typename StoreFunction,
+           typename AssignFunction>
+  void Parse(DatasetMapper<PolicyType>& info,
+             StoreFunction store,
+             AssignFunction assign) const;
+
+  /**
+   * Parse one instance, calling f(dim, begin, end) for each of its values,
+   * which returns false if the value can't be parsed.
+   *
+   * @return An empty string on success, or the error otherwise.
+   */
+  template<typename TokenFunction>
+  std::string ParseInstance(const size_t point,
+                            std::string& buffer,
+                            TokenFunction f) const;
+
+  /**
+   * Read the next value, ending at a ',', at a '%', or (if sparse is true) at
+   * a '}', and move pos past the value and the ',' that ends it.  Quoted
+   * values are unquoted into the buffer.
+   *
+   * @return false if there are no more values.
+   */
+  static bool NextToken(const char*& pos,
+                        const char* end,
+                        const bool sparse,
+                        std::string& buffer,
+                        const char*& tokenBegin,
+                        const char*& tokenEnd);
+
+  //! Name of file.
+  std::string filename;
+  //! View of the contents of the file.
+  MappedFile contents;
+  //! Offset of the start of each line, plus one past the end of the last line.
+  std::vector<size_t> lineStarts;
+  //! The first line after the @data line.
+  size_t dataLine;
+  //! Whether each dimension is categorical.
+  std::vector<char> categorical;
+  //! The declared values of each nominal dimension (empty for the others).
+  std::vector<std::vector<std::string>> nominalValues;
+  //! The line of each instance.
+  std::vector<size_t> points;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_arff_parallel_impl.hpp"
+
+#endif
@@ -0,0 +1,370 @@
+/**
+ * @file load_arff_parallel_impl.hpp
+ *
+ * Implementation of the templated parts of LoadARFFParallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_ARFF_PARALLEL_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_ARFF_PARALLEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_arff_parallel.hpp"
+#include "is_naninf.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+namespace detail {
+
+//! Parse a floating-point ARFF value; the whole value must be a number.
+template<typename T>
+bool ParseARFFNumber(const std::string& token,
+                     T& value,
+                     const std::true_type /* isFloatingPoint */)
+{
+  char* parseEnd;
+  const double result = std::strtod(token.c_str(), &parseEnd);
+  if (token.empty() || parseEnd != token.c_str() + token.size())
+    return IsNaNInf(value, token);
+
+  value = (T) result;
+  return true;
+}
+
+/**
+ * Parse an integer ARFF value.  As with an extraction from a stream, a real
+ * value is truncated.
+ */
+template<typename T>
+bool ParseARFFNumber(const std::string& token,
+                     T& value,
+                     const std::false_type /* isFloatingPoint */)
+{
+  if (token.empty())
+    return false;
+
+  char* parseEnd;
+  if (std::is_signed<T>::value)
+  {
+    const long long result = std::strtoll(token.c_str(), &parseEnd, 10);
+    value = (T) result;
+  }
+  else
+  {
+    const unsigned long long result = std::strtoull(token.c_str(), &parseEnd,
+        10);
+    value = (T) result;
+    if (token[0] == '-')
+      parseEnd = const_cast<char*>(token.c_str());
+  }
+
+  if (parseEnd == token.c_str() + token.size())
+    return true;
+
+  const double result = std::strtod(token.c_str(), &parseEnd);
+  if (parseEnd != token.c_str() + token.size())
+    return false;
+
+  value = (T) result;
+  return true;
+}
+
+} // namespace detail
+
+template<typename T, typename PolicyType>
+void LoadARFFParallel::Load(arma::Mat<T>& matrix,
+                            DatasetMapper<PolicyType>& info)
+{
+  PrepareInfo<T>(info);
+
+  // Sparse instances only give some of the values; the others are 0.
+  const size_t dims = Dimensionality();
+  matrix.zeros(dims, points.size());
+  T* mem = matrix.memptr();
+
+  Parse<T>(info,
+      [&](const size_t /* thread */, const size_t point, const size_t dim,
+          const T value)
+      {
+        const size_t slot = point * dims + dim;
+        mem[slot] = value;
+        return slot;
+      },
+      [&](const size_t /* thread */, const size_t slot, const T value)
+      {
+        mem[slot] = value;
+      });
+}
+
+template<typename T, typename PolicyType>
+void LoadARFFParallel::Load(arma::SpMat<T>& matrix,
+                            DatasetMapper<PolicyType>& info)
+{
+  PrepareInfo<T>(info);
+
+  #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+  #else
+    const size_t numThreads = 1;
+  #endif
+
+  // Each thread collects the values of its instances.
+  std::vector<std::vector<arma::uword>> rows(numThreads);
+  std::vector<std::vector<arma::uword>> cols(numThreads);
+  std::vector<std::vector<T>> values(numThreads);
+
+  Parse<T>(info,
+      [&](const size_t thread, const size_t point, const size_t dim,
+          const T value)
+      {
+        rows[thread].push_back(dim);
+        cols[thread].push_back(point);
+        values[thread].push_back(value);
+        return values[thread].size() - 1;
+      },
+      [&](const size_t thread, const size_t slot, const T value)
+      {
+        values[thread][slot] = value;
+      });
+
+  size_t numValues = 0;
+  for (size_t t = 0; t < numThreads; ++t)
+    numValues += values[t].size();
+
+  arma::umat locations(2, numValues);
+  arma::Col<T> allValues(numValues);
+  size_t index = 0;
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    for (size_t i = 0; i < values[t].size(); ++i, ++index)
+    {
+      locations(0, index) = rows[t][i];
+      locations(1, index) = cols[t][i];
+      allValues[index] = values[t][i];
+    }
+
+    std::vector<arma::uword>().swap(rows[t]);
+    std::vector<arma::uword>().swap(cols[t]);
+    std::vector<T>().swap(values[t]);
+  }
+
+  // Zeros (from dense instances, for example) are not stored.
+  matrix = arma::SpMat<T>(locations, allValues, Dimensionality(),
+      points.size());
+}
+
+template<typename T, typename PolicyType>
+void LoadARFFParallel::PrepareInfo(DatasetMapper<PolicyType>& info) const
+{
+  const size_t dims = Dimensionality();
+
+  // Reset the DatasetInfo object, if needed.
+  if (info.Dimensionality() == 0)
+  {
+    PolicyType policy(info.Policy());
+    info = DatasetMapper<PolicyType>(policy, dims);
+  }
+  else if (info.Dimensionality() != dims)
+  {
+    std::ostringstream oss;
+    oss << "data::LoadARFF(): given DatasetInfo has dimensionality "
+        << info.Dimensionality() << ", but data has dimensionality "
+        << dims;
+    throw std::invalid_argument(oss.str());
+  }
+
+  for (size_t d = 0; d < dims; ++d)
+  {
+    info.Type(d) = categorical[d] ? Datatype::categorical : Datatype::numeric;
+    for (const std::string& value : nominalValues[d])
+      info.template MapString<T>(value, d);
+  }
+}
+
+template<typename T, typename PolicyType, typename StoreFunction,
+         typename AssignFunction>
+void LoadARFFParallel::Parse(DatasetMapper<PolicyType>& info,
+                             StoreFunction store,
+                             AssignFunction assign) const
+{
+  #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+  #else
+    const size_t numThreads = 1;
+  #endif
+
+  // A categorical value that still has to be mapped.
+  struct Pending
+  {
+    size_t slot;
+    size_t dim;
+    std::string token;
+  };
+
+  const size_t numPoints = points.size();
+  std::vector<std::vector<Pending>> pending(numThreads);
+  std::vector<size_t> errorPoints(numThreads, numPoints);
+  std::vector<std::string> errors(numThreads);
+
+  #pragma omp parallel
+  {
+    #ifdef HAS_OPENMP
+      const size_t thread = omp_get_thread_num();
+    #else
+      const size_t thread = 0;
+    #endif
+
+    std::string buffer, number;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t p = 0; p < (omp_size_t) numPoints; ++p)
+    {
+      // The later instances of a thread that failed don't matter.
+      if (errorPoints[thread] != numPoints)
+        continue;
+
+      const size_t point = p;
+      std::string error = ParseInstance(point, buffer,
+          [&](const size_t dim, const char* begin, const char* end)
+      {
+        if (categorical[dim])
+        {
+          pending[thread].push_back(Pending { store(thread, point, dim, T(0)),
+              dim, std::string(begin, end) });
+          return true;
+        }
+
+        number.assign(begin, end);
+        T value = T(0);
+        if (!detail::ParseARFFNumber(number, value,
+            std::is_floating_point<T>()))
+          return false;
+
+        store(thread, point, dim, value);
+        return true;
+      });
+
+      if (!error.empty())
+      {
+        errorPoints[thread] = point;
+        errors[thread] = std::move(error);
+      }
+    }
+  }
+
+  size_t firstError = numThreads;
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    if (errorPoints[t] != numPoints && (firstError == numThreads ||
+        errorPoints[t] < errorPoints[firstError]))
+      firstError = t;
+  }
+
+  if (firstError != numThreads)
+    throw std::runtime_error(errors[firstError]);
+
+  // A static schedule gives each thread one contiguous block of instances, in
+  // the order of the threads, so this maps the values in file order.
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    for (const Pending& m : pending[t])
+      assign(t, m.slot, info.template MapString<T>(m.token, m.dim));
+  }
+}
+
+template<typename TokenFunction>
+std::string LoadARFFParallel::ParseInstance(const size_t point,
+                                            std::string& buffer,
+                                            TokenFunction f) const
+{
+  const size_t line = points[point];
+  const size_t dims = Dimensionality();
+
+  const char* pos;
+  const char* end;
+  LineBounds(line, pos, end);
+
+  std::ostringstream oss;
+  auto valueError = [&](const size_t dim, const char* first, const char* last)
+  {
+    const std::string token(first, last);
+    if (token == "?")
+      oss << "Missing values ('?') not supported, ";
+    else
+      oss << "Parse error ";
+    oss << "at line " << (line + 1) << " token " << dim << ": \"" << token
+        << "\".";
+    return oss.str();
+  };
+
+  const char* tokenBegin;
+  const char* tokenEnd;
+  if (pos != end && *pos == '{')
+  {
+    // A sparse instance: pairs of an index and a value.
+    ++pos;
+    while (true)
+    {
+      while (pos != end && (*pos == ' ' || *pos == '\t'))
+        ++pos;
+      if (pos == end || *pos == '%')
+      {
+        oss << "Unterminated sparse instance at line " << (line + 1) << ".";
+        return oss.str();
+      }
+      if (*pos == '}')
+        return std::string();
+
+      size_t dim = 0;
+      const char* digits = pos;
+      while (pos != end && *pos >= '0' && *pos <= '9')
+        dim = 10 * dim + (*pos++ - '0');
+
+      if (pos == digits || dim >= dims)
+      {
+        oss << "Invalid index at line " << (line + 1) << ".";
+        return oss.str();
+      }
+
+      if (!NextToken(pos, end, true, buffer, tokenBegin, tokenEnd))
+      {
+        oss << "Missing value for index " << dim << " at line " << (line + 1)
+            << ".";
+        return oss.str();
+      }
+
+      if (!f(dim, tokenBegin, tokenEnd))
+        return valueError(dim, tokenBegin, tokenEnd);
+    }
+  }
+
+  size_t dim = 0;
+  while (NextToken(pos, end, false, buffer, tokenBegin, tokenEnd))
+  {
+    if (dim >= dims)
+    {
+      oss << "Too many columns in line " << (line + 1) << ".";
+      return oss.str();
+    }
+
+    if (!f(dim, tokenBegin, tokenEnd))
+      return valueError(dim, tokenBegin, tokenEnd);
+
+    ++dim;
+  }
+
+  return std::string();
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
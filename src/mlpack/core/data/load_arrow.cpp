@@ -0,0 +1,480 @@
+/**
+ * @file load_arrow.cpp
+ *
+ * Implementation of the Parquet and Arrow IPC loading and saving functions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "load_arrow.hpp"
+#include "extension.hpp"
+
+#include <arrow/api.h>
+#include <arrow/io/api.h>
+#include <arrow/ipc/api.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/arrow/writer.h>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+//! The number of rows of each row group of the Parquet files we write.
+static const int64_t ParquetRowGroupSize = 1 << 20;
+
+//! Throw a std::runtime_error if the status is an error.
+static void ArrowCheck(const arrow::Status& status,
+                       const std::string& filename)
+{
+  if (!status.ok())
+  {
+    throw std::runtime_error("Arrow error with '" + filename + "': " +
+        status.ToString());
+  }
+}
+
+//! Get the value of the result, or throw a std::runtime_error.
+template<typename T>
+static T ArrowUnwrap(arrow::Result<T> result, const std::string& filename)
+{
+  ArrowCheck(result.status(), filename);
+  return std::move(result).ValueOrDie();
+}
+
+//! Get the Arrow type with the same representation as eT.
+template<typename eT>
+static std::shared_ptr<arrow::DataType> ArrowType()
+{
+  if (std::is_floating_point<eT>::value)
+    return (sizeof(eT) == 4) ? arrow::float32() : arrow::float64();
+  else if (std::is_signed<eT>::value)
+    return (sizeof(eT) == 4) ? arrow::int32() : arrow::int64();
+  else
+    return (sizeof(eT) == 4) ? arrow::uint32() : arrow::uint64();
+}
+
+//! Whether the column holds strings, possibly dictionary-encoded.
+static bool IsStringColumn(const arrow::DataType& type)
+{
+  if (type.id() == arrow::Type::DICTIONARY)
+  {
+    const arrow::DataType& valueType =
+        *static_cast<const arrow::DictionaryType&>(type).value_type();
+    return (valueType.id() == arrow::Type::STRING ||
+        valueType.id() == arrow::Type::LARGE_STRING);
+  }
+
+  return (type.id() == arrow::Type::STRING ||
+      type.id() == arrow::Type::LARGE_STRING);
+}
+
+//! Whether the column holds numbers that can be loaded.
+static bool IsNumericColumn(const arrow::DataType& type)
+{
+  switch (type.id())
+  {
+    case arrow::Type::BOOL:
+    case arrow::Type::INT8:
+    case arrow::Type::INT16:
+    case arrow::Type::INT32:
+    case arrow::Type::INT64:
+    case arrow::Type::UINT8:
+    case arrow::Type::UINT16:
+    case arrow::Type::UINT32:
+    case arrow::Type::UINT64:
+    case arrow::Type::FLOAT:
+    case arrow::Type::DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+//! Get the string at the given index of a string array.
+static std::string GetString(const arrow::Array& array, const int64_t i)
+{
+  if (array.IsNull(i))
+    return std::string();
+  else if (array.type_id() == arrow::Type::LARGE_STRING)
+    return static_cast<const arrow::LargeStringArray&>(array).GetString(i);
+  else
+    return static_cast<const arrow::StringArray&>(array).GetString(i);
+}
+
+/**
+ * Find the indices of the requested columns among the names of the columns of
+ * the file; all columns are used if none is requested.
+ */
+static std::vector<int> ColumnIndices(const std::vector<std::string>& names,
+                                      const std::vector<std::string>& columns,
+                                      const std::string& filename)
+{
+  std::vector<int> indices;
+  if (columns.empty())
+  {
+    for (size_t i = 0; i < names.size(); ++i)
+      indices.push_back((int) i);
+    return indices;
+  }
+
+  for (const std::string& column : columns)
+  {
+    const auto it = std::find(names.begin(), names.end(), column);
+    if (it == names.end())
+    {
+      throw std::runtime_error("LoadArrow(): '" + filename + "' has no column "
+          "named '" + column + "'.");
+    }
+
+    indices.push_back((int) (it - names.begin()));
+  }
+
+  return indices;
+}
+
+//! Read the requested columns of the file into a table.
+static std::shared_ptr<arrow::Table> ReadTable(
+    const std::string& filename,
+    const std::vector<std::string>& columns)
+{
+  // The file is memory-mapped, so the columns that are not requested are
+  // never read.
+  std::shared_ptr<arrow::io::MemoryMappedFile> file = ArrowUnwrap(
+      arrow::io::MemoryMappedFile::Open(filename, arrow::io::FileMode::READ),
+      filename);
+
+  std::shared_ptr<arrow::Table> table;
+  if (Extension(filename) == "parquet")
+  {
+    parquet::arrow::FileReaderBuilder builder;
+    ArrowCheck(builder.Open(file), filename);
+
+    const parquet::SchemaDescriptor* schema =
+        builder.raw_reader()->metadata()->schema();
+    std::vector<std::string> names(schema->num_columns());
+    for (size_t i = 0; i < names.size(); ++i)
+      names[i] = schema->Column((int) i)->name();
+    const std::vector<int> indices = ColumnIndices(names, columns, filename);
+
+    // Read the string columns as dictionaries, so each distinct string has to
+    // be mapped only once per row group; this is ignored for other columns.
+    parquet::ArrowReaderProperties properties;
+    for (const int index : indices)
+      properties.set_read_dictionary(index, true);
+
+    std::unique_ptr<parquet::arrow::FileReader> reader;
+    ArrowCheck(builder.properties(properties)->Build(&reader), filename);
+    ArrowCheck(reader->ReadTable(indices, &table), filename);
+  }
+  else
+  {
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader = ArrowUnwrap(
+        arrow::ipc::RecordBatchFileReader::Open(file), filename);
+
+    std::vector<std::string> names;
+    for (const auto& field : reader->schema()->fields())
+      names.push_back(field->name());
+    const std::vector<int> indices = ColumnIndices(names, columns, filename);
+
+    // The record batches point into the mapped file; nothing is copied here.
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches(
+        reader->num_record_batches());
+    for (size_t i = 0; i < batches.size(); ++i)
+      batches[i] = ArrowUnwrap(reader->ReadRecordBatch((int) i), filename);
+
+    table = ArrowUnwrap(arrow::Table::FromRecordBatches(reader->schema(),
+        batches), filename);
+    table = ArrowUnwrap(table->SelectColumns(indices), filename);
+  }
+
+  return table;
+}
+
+//! Convert a chunk of a numeric column, whose array type is ArrayType.
+template<typename ArrayType, typename eT>
+static void ConvertNumeric(const arrow::Array& chunk, eT* out)
+{
+  const ArrayType& array = static_cast<const ArrayType&>(chunk);
+  const int64_t length = array.length();
+
+  if (array.null_count() == 0)
+  {
+    for (int64_t i = 0; i < length; ++i)
+      out[i] = eT(array.Value(i));
+  }
+  else
+  {
+    // The columns with nulls were rejected if eT has no NaN.
+    for (int64_t i = 0; i < length; ++i)
+    {
+      out[i] = array.IsNull(i) ? std::numeric_limits<eT>::quiet_NaN() :
+          eT(array.Value(i));
+    }
+  }
+}
+
+//! Convert a chunk of a numeric column.
+template<typename eT>
+static void ConvertNumeric(const arrow::Array& chunk, eT* out)
+{
+  switch (chunk.type_id())
+  {
+    case arrow::Type::BOOL:
+      ConvertNumeric<arrow::BooleanArray>(chunk, out); break;
+    case arrow::Type::INT8:
+      ConvertNumeric<arrow::Int8Array>(chunk, out); break;
+    case arrow::Type::INT16:
+      ConvertNumeric<arrow::Int16Array>(chunk, out); break;
+    case arrow::Type::INT32:
+      ConvertNumeric<arrow::Int32Array>(chunk, out); break;
+    case arrow::Type::INT64:
+      ConvertNumeric<arrow::Int64Array>(chunk, out); break;
+    case arrow::Type::UINT8:
+      ConvertNumeric<arrow::UInt8Array>(chunk, out); break;
+    case arrow::Type::UINT16:
+      ConvertNumeric<arrow::UInt16Array>(chunk, out); break;
+    case arrow::Type::UINT32:
+      ConvertNumeric<arrow::UInt32Array>(chunk, out); break;
+    case arrow::Type::UINT64:
+      ConvertNumeric<arrow::UInt64Array>(chunk, out); break;
+    case arrow::Type::FLOAT:
+      ConvertNumeric<arrow::FloatArray>(chunk, out); break;
+    case arrow::Type::DOUBLE:
+      ConvertNumeric<arrow::DoubleArray>(chunk, out); break;
+    default:
+      break;
+  }
+}
+
+//! Load the table; info may be NULL if there are no string columns.
+template<typename eT>
+static void LoadArrowTable(const std::string& filename,
+                           arma::Mat<eT>& matrix,
+                           DatasetInfo* info,
+                           const std::vector<std::string>& columns,
+                           const bool transpose)
+{
+  std::shared_ptr<arrow::Table> table = ReadTable(filename, columns);
+  const size_t numColumns = table->num_columns();
+  const size_t numRows = table->num_rows();
+
+  if (info)
+    *info = DatasetInfo(numColumns);
+
+  // Check the types first, since nothing may be thrown in the parallel loop.
+  for (size_t c = 0; c < numColumns; ++c)
+  {
+    const arrow::Field& field = *table->schema()->field((int) c);
+    const std::shared_ptr<arrow::ChunkedArray>& column = table->column((int) c);
+
+    if (IsStringColumn(*field.type()))
+    {
+      if (!info)
+      {
+        throw std::runtime_error("LoadArrow(): column '" + field.name() +
+            "' of '" + filename + "' holds strings; load it with a "
+            "DatasetInfo.");
+      }
+    }
+    else if (!IsNumericColumn(*field.type()))
+    {
+      throw std::runtime_error("LoadArrow(): column '" + field.name() +
+          "' of '" + filename + "' has unsupported type " +
+          field.type()->ToString() + ".");
+    }
+    else if (!std::numeric_limits<eT>::has_quiet_NaN && column->null_count() > 0)
+    {
+      throw std::runtime_error("LoadArrow(): column '" + field.name() +
+          "' of '" + filename + "' has null values, which can't be loaded "
+          "into an integer matrix.");
+    }
+  }
+
+  matrix.set_size(numRows, numColumns);
+
+  // Map the strings serially, so the mappings don't depend on the number of
+  // threads.  The dictionaries are mapped into a table for each chunk, which
+  // is applied in the parallel loop; plain strings are mapped right away.
+  std::vector<std::vector<std::vector<eT>>> dictionaryMaps(numColumns);
+  for (size_t c = 0; c < numColumns; ++c)
+  {
+    const std::shared_ptr<arrow::ChunkedArray>& column = table->column((int) c);
+    if (!IsStringColumn(*column->type()))
+      continue;
+
+    info->Type(c) = Datatype::categorical;
+    if (column->type()->id() == arrow::Type::DICTIONARY)
+    {
+      dictionaryMaps[c].resize(column->num_chunks());
+      for (int k = 0; k < column->num_chunks(); ++k)
+      {
+        const arrow::DictionaryArray& chunk =
+            static_cast<const arrow::DictionaryArray&>(*column->chunk(k));
+        const arrow::Array& dictionary = *chunk.dictionary();
+
+        // The last entry of the table is the value of the nulls.
+        std::vector<eT>& map = dictionaryMaps[c][k];
+        map.resize(dictionary.length() + 1);
+        for (int64_t i = 0; i < dictionary.length(); ++i)
+          map[i] = info->template MapString<eT>(GetString(dictionary, i), c);
+        if (chunk.null_count() > 0)
+          map.back() = info->template MapString<eT>(std::string(), c);
+      }
+    }
+    else
+    {
+      eT* out = matrix.colptr(c);
+      for (const std::shared_ptr<arrow::Array>& chunk : column->chunks())
+      {
+        for (int64_t i = 0; i < chunk->length(); ++i)
+          out[i] = info->template MapString<eT>(GetString(*chunk, i), c);
+        out += chunk->length();
+      }
+    }
+  }
+
+  // Every column of the file is converted into its own column of the matrix.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numColumns; ++c)
+  {
+    const std::shared_ptr<arrow::ChunkedArray>& column = table->column((int) c);
+    if (IsStringColumn(*column->type()) &&
+        column->type()->id() != arrow::Type::DICTIONARY)
+      continue;
+
+    eT* out = matrix.colptr(c);
+    for (int k = 0; k < column->num_chunks(); ++k)
+    {
+      const arrow::Array& chunk = *column->chunk(k);
+      if (chunk.type_id() == arrow::Type::DICTIONARY)
+      {
+        const arrow::DictionaryArray& array =
+            static_cast<const arrow::DictionaryArray&>(chunk);
+        const std::vector<eT>& map = dictionaryMaps[c][k];
+        for (int64_t i = 0; i < array.length(); ++i)
+        {
+          out[i] = array.IsNull(i) ? map.back() :
+              map[array.GetValueIndex(i)];
+        }
+      }
+      else
+      {
+        ConvertNumeric(chunk, out);
+      }
+
+      out += chunk.length();
+    }
+  }
+
+  if (transpose)
+    arma::inplace_trans(matrix);
+}
+
+template<typename eT>
+void LoadArrow(const std::string& filename,
+               arma::Mat<eT>& matrix,
+               const std::vector<std::string>& columns,
+               const bool transpose)
+{
+  LoadArrowTable(filename, matrix, (DatasetInfo*) NULL, columns, transpose);
+}
+
+template<typename eT>
+void LoadArrow(const std::string& filename,
+               arma::Mat<eT>& matrix,
+               DatasetInfo& info,
+               const std::vector<std::string>& columns,
+               const bool transpose)
+{
+  LoadArrowTable(filename, matrix, &info, columns, transpose);
+}
+
+template<typename eT>
+void SaveArrow(const std::string& filename,
+               const arma::Mat<eT>& matrix,
+               const bool transpose)
+{
+  const size_t numColumns = transpose ? matrix.n_rows : matrix.n_cols;
+  const size_t numRows = transpose ? matrix.n_cols : matrix.n_rows;
+  const std::shared_ptr<arrow::DataType> type = ArrowType<eT>();
+
+  std::vector<std::shared_ptr<arrow::Field>> fields(numColumns);
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers(numColumns);
+  for (size_t c = 0; c < numColumns; ++c)
+  {
+    fields[c] = arrow::field(std::to_string(c), type, false);
+    buffers[c] = ArrowUnwrap(arrow::AllocateBuffer(numRows * sizeof(eT)),
+        filename);
+  }
+
+  // eT has the representation of the Arrow type, so the values are copied
+  // as they are.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numColumns; ++c)
+  {
+    eT* out = reinterpret_cast<eT*>(buffers[c]->mutable_data());
+    if (transpose)
+    {
+      for (size_t i = 0; i < numRows; ++i)
+        out[i] = matrix(c, i);
+    }
+    else
+    {
+      std::copy(matrix.colptr(c), matrix.colptr(c) + numRows, out);
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::Array>> arrays(numColumns);
+  for (size_t c = 0; c < numColumns; ++c)
+  {
+    arrays[c] = arrow::MakeArray(arrow::ArrayData::Make(type, numRows,
+        { nullptr, buffers[c] }, 0));
+  }
+
+  std::shared_ptr<arrow::Table> table = arrow::Table::Make(
+      arrow::schema(fields), arrays, numRows);
+
+  std::shared_ptr<arrow::io::FileOutputStream> file = ArrowUnwrap(
+      arrow::io::FileOutputStream::Open(filename), filename);
+
+  if (Extension(filename) == "parquet")
+  {
+    ArrowCheck(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(),
+        file, ParquetRowGroupSize), filename);
+  }
+  else
+  {
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> writer = ArrowUnwrap(
+        arrow::ipc::MakeFileWriter(file, table->schema()), filename);
+    ArrowCheck(writer->WriteTable(*table), filename);
+    ArrowCheck(writer->Close(), filename);
+  }
+
+  ArrowCheck(file->Close(), filename);
+}
+
+// Instantiate the functions for the same types as data::Load().
+#define MLPACK_INSTANTIATE_ARROW(eT) \
+    template void LoadArrow<eT>(const std::string&, arma::Mat<eT>&, \
+        const std::vector<std::string>&, const bool); \
+    template void LoadArrow<eT>(const std::string&, arma::Mat<eT>&, \
+        DatasetInfo&, const std::vector<std::string>&, const bool); \
+    template void SaveArrow<eT>(const std::string&, const arma::Mat<eT>&, \
+        const bool);
+
+MLPACK_INSTANTIATE_ARROW(int)
+MLPACK_INSTANTIATE_ARROW(unsigned int)
+MLPACK_INSTANTIATE_ARROW(unsigned long)
+MLPACK_INSTANTIATE_ARROW(unsigned long long)
+MLPACK_INSTANTIATE_ARROW(float)
+MLPACK_INSTANTIATE_ARROW(double)
+
+#undef MLPACK_INSTANTIATE_ARROW
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,128 @@
+/**
+ * @file load_arrow.hpp
+ *
+ * Load and save Parquet and Arrow IPC (Feather) files with Apache Arrow.
+ * These functions are only available if mlpack was built with USE_ARROW, in
+ * which case HAS_ARROW is defined.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_ARROW_HPP
+#define MLPACK_CORE_DATA_LOAD_ARROW_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Return whether the given (lowercase) extension denotes a file that is read
+ * and written with Arrow: .parquet for Parquet, and .arrow, .feather or .ipc
+ * for the Arrow IPC file format (Feather version 2 is the same format).
+ */
+inline bool IsArrowExtension(const std::string& extension)
+{
+  return (extension == "parquet" || extension == "arrow" ||
+      extension == "feather" || extension == "ipc");
+}
+
+/**
+ * Load the numeric columns of a Parquet or Arrow IPC file into a matrix.
+ * Each column of the file is a dimension and each row is a point, so if
+ * transpose is true (the default), the matrix has one column per row of the
+ * file, as with data::Load().  The file is memory-mapped and each column is
+ * converted straight into its column of the matrix, in parallel; if transpose
+ * is true, the matrix is then transposed in place.
+ *
+ * Boolean, integer and floating-point columns can be loaded.  Null values are
+ * loaded as NaN; they can't be loaded into integer matrices.  Use the overload
+ * that takes a DatasetInfo to load string columns.
+ *
+ * A std::runtime_error is thrown if the file can't be read.
+ *
+ * @param filename Name of the file to load; the format is given by the
+ *     extension (see IsArrowExtension()).
+ * @param matrix Matrix to load the file into.
+ * @param columns Names of the columns to load, in the order they should be
+ *     stored; if empty, all the columns are loaded.  Columns that are not
+ *     loaded are never read.
+ * @param transpose If true, each row of the file is a column of the matrix.
+ */
+template<typename eT>
+void LoadArrow(const std::string& filename,
+               arma::Mat<eT>& matrix,
+               const std::vector<std::string>& columns =
+                   std::vector<std::string>(),
+               const bool transpose = true);
+
+/**
+ * Load the columns of a Parquet or Arrow IPC file into a matrix, mapping the
+ * string columns with the given DatasetInfo, which is re-created.  String
+ * columns are categorical dimensions.  Dictionary-encoded columns (which is
+ * how Parquet files usually store strings) are mapped one dictionary entry at
+ * a time, so each distinct string is hashed once per dictionary instead of
+ * once per row, and the entries are mapped in dictionary order.  Null strings
+ * are mapped like the empty string.
+ *
+ * See the other overload for the other parameters.
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Matrix to load the file into.
+ * @param info DatasetInfo to store the types and mappings of the dimensions
+ *     in.
+ * @param columns Names of the columns to load; if empty, all the columns are
+ *     loaded.
+ * @param transpose If true, each row of the file is a column of the matrix.
+ */
+template<typename eT>
+void LoadArrow(const std::string& filename,
+               arma::Mat<eT>& matrix,
+               DatasetInfo& info,
+               const std::vector<std::string>& columns =
+                   std::vector<std::string>(),
+               const bool transpose = true);
+
+/**
+ * Arrow files can only be loaded with a DatasetInfo, since the mapping of
+ * dictionaries relies on IncrementPolicy; this overload throws a
+ * std::invalid_argument.
+ */
+template<typename eT, typename PolicyType>
+void LoadArrow(const std::string& filename,
+               arma::Mat<eT>& /* matrix */,
+               DatasetMapper<PolicyType>& /* info */,
+               const std::vector<std::string>& /* columns */ =
+                   std::vector<std::string>(),
+               const bool /* transpose */ = true)
+{
+  throw std::invalid_argument("LoadArrow(): cannot load '" + filename +
+      "' with a DatasetMapper whose policy is not IncrementPolicy.");
+}
+
+/**
+ * Save a matrix to a Parquet or Arrow IPC file.  If transpose is true (the
+ * default), each row of the matrix is a column of the file (and each point a
+ * row), as with data::Save().  The columns are named after the index of their
+ * dimension ("0", "1", ...) and have the Arrow type that matches eT.
+ *
+ * A std::runtime_error is thrown if the file can't be written.
+ *
+ * @param filename Name of the file to save to; the format is given by the
+ *     extension (see IsArrowExtension()).
+ * @param matrix Matrix to save.
+ * @param transpose If true, each column of the matrix is a row of the file.
+ */
+template<typename eT>
+void SaveArrow(const std::string& filename,
+               const arma::Mat<eT>& matrix,
+               const bool transpose = true);
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * @file load_csv_parallel.cpp
+ *
+ * Implementation of the non-templated parts of LoadCSVParallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "load_csv_parallel.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+LoadCSVParallel::LoadCSVParallel(const std::string& file) :
+    extension(Extension(file)),
+    filename(file),
+    contents(file)
+{
+  // These match the rules used by LoadCSV.
+  if (extension == "csv")
+  {
+    delimiter = ',';
+    excluded = ',';
+  }
+  else if (extension == "txt")
+  {
+    delimiter = ' ';
+    excluded = ',';
+  }
+  else // TSV.
+  {
+    delimiter = '\t';
+    excluded = '\t';
+  }
+
+  FindLines(contents, lineStarts);
+}
+
+void LoadCSVParallel::FindLines(const MappedFile& contents,
+                                std::vector<size_t>& lineStarts)
+{
+  const char* data = contents.Data();
+  const size_t size = contents.Size();
+
+  size_t numPieces = 1;
+  #ifdef HAS_OPENMP
+    numPieces = omp_get_max_threads();
+  #endif
+
+  // Each piece of the file collects the offsets just after each newline.
+  std::vector<std::vector<size_t>> pieceStarts(numPieces);
+
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t p = 0; p < (omp_size_t) numPieces; ++p)
+  {
+    const char* pos = data + (size / numPieces) * p;
+    const char* pieceEnd = (p == (omp_size_t) numPieces - 1) ? data + size :
+        data + (size / numPieces) * (p + 1);
+
+    while (pos != pieceEnd)
+    {
+      const char* newline = (const char*) std::memchr(pos, '\n',
+          pieceEnd - pos);
+      if (newline == NULL)
+        break;
+
+      pieceStarts[p].push_back(newline - data + 1);
+      pos = newline + 1;
+    }
+  }
+
+  size_t numStarts = 1;
+  for (size_t p = 0; p < numPieces; ++p)
+    numStarts += pieceStarts[p].size();
+
+  lineStarts.clear();
+  lineStarts.reserve(numStarts + 1);
+  lineStarts.push_back(0);
+  for (size_t p = 0; p < numPieces; ++p)
+  {
+    lineStarts.insert(lineStarts.end(), pieceStarts[p].begin(),
+        pieceStarts[p].end());
+  }
+
+  // If the last line has no trailing newline, pretend there is one just past
+  // the end of the file.
+  if (lineStarts.back() < size)
+    lineStarts.push_back(size + 1);
+}
+
+bool LoadCSVParallel::MatchDelimiter(const char*& pos, const char* end) const
+{
+  const char* p = pos;
+  if (delimiter == ' ')
+  {
+    // Any nonzero number of spaces.
+    while (p != end && *p == ' ')
+      ++p;
+    if (p == pos)
+      return false;
+  }
+  else
+  {
+    // A single delimiter, possibly with spaces on either side.
+    while (p != end && *p == ' ')
+      ++p;
+    if (p == end || *p != delimiter)
+      return false;
+    ++p;
+    while (p != end && *p == ' ')
+      ++p;
+  }
+
+  pos = p;
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
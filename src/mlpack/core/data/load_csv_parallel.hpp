@@ -0,0 +1,146 @@
+/**
+ * @file load_csv_parallel.hpp
+ *
+ * A CSV parser that memory-maps the file and parses the lines of the file in
+ * parallel.  It accepts the same formats as LoadCSV.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_CSV_PARALLEL_HPP
+#define MLPACK_CORE_DATA_LOAD_CSV_PARALLEL_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "extension.hpp"
+#include "dataset_mapper.hpp"
+#include "mapped_file.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Load a CSV, TSV or space-separated text file with a DatasetMapper.  This
+ * parses exactly the same dialect as LoadCSV, but works directly on a
+ * memory-mapped view of the file:
+ *
+ *  - the line boundaries are found in a single parallel scan of the file;
+ *  - if the MapPolicy needs a first pass, each thread runs it on its own block
+ *    of lines and the resulting dimension types are merged;
+ *  - each thread then parses its block of lines into the output matrix using a
+ *    private copy of the DatasetMapper;
+ *  - with IncrementPolicy, the mappings each thread created for the
+ *    categorical dimensions are merged into the shared DatasetMapper in file
+ *    order, and each thread translates its block of the matrix from its local
+ *    mapped values to the merged ones;
+ *  - finally, any other dimension for which some thread created a mapping is
+ *    mapped again, in file order, with the shared DatasetMapper.
+ *
+ * Either way, the mappings are identical to the ones LoadCSV would create.
+ */
+class LoadCSVParallel
+{
+ public:
+  /**
+   * Map the given file and find the boundaries of all its lines.  Throws a
+   * std::runtime_error if the file cannot be opened.
+   *
+   * @param file Name of the file to load.
+   */
+  LoadCSVParallel(const std::string& file);
+
+  /**
+   * Load the file into the given matrix with the given DatasetMapper object.
+   * The DatasetMapper is re-initialized with the correct dimensionality, but
+   * its policy is kept.  Throws exceptions on errors.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper to use while loading.
+   * @param transpose If true, the matrix should be transposed on loading
+   *     (default).
+   */
+  template<typename T, typename PolicyType>
+  void Load(arma::Mat<T>& inout,
+            DatasetMapper<PolicyType>& infoSet,
+            const bool transpose = true);
+
+  //! Get the number of lines in the file.
+  size_t NumLines() const { return lineStarts.size() - 1; }
+
+  /**
+   * Scan the given file in parallel and store the offset of the start of each
+   * line, plus one past the end of the last line, in lineStarts.  This is also
+   * used by LoadARFFParallel.
+   *
+   * @param contents View of the file.
+   * @param lineStarts Vector to store the offsets in.
+   */
+  static void FindLines(const MappedFile& contents,
+                        std::vector<size_t>& lineStarts);
+
+  //! Remove whitespace from either side of the given range.
+  static void Trim(const char*& begin, const char*& end)
+  {
+    while (begin != end && std::isspace((unsigned char) *begin))
+      ++begin;
+    while (end != begin && std::isspace((unsigned char) *(end - 1)))
+      --end;
+  }
+
+ private:
+
+  /**
+   * Get the given line with whitespace removed from either side.
+   */
+  void LineBounds(const size_t line, const char*& begin, const char*& end) const
+  {
+    begin = contents.Data() + lineStarts[line];
+    end = contents.Data() + lineStarts[line + 1] - 1;
+    Trim(begin, end);
+  }
+
+  /**
+   * Split the given line into tokens, calling f(index, begin, end) for each
+   * token.  As with LoadCSV, parsing stops at the first position where no
+   * delimiter can be matched.
+   *
+   * @return Number of tokens found on the line.
+   */
+  template<typename TokenFunction>
+  size_t ParseLine(const size_t line, TokenFunction f) const;
+
+  //! Return whether the given character may be part of a token.
+  bool IsTokenChar(const char c) const
+  {
+    return (c != ' ' && c != '\r' && c != '\n' && c != excluded);
+  }
+
+  /**
+   * Attempt to match a delimiter at the given position.  On success, pos is
+   * moved past the delimiter.
+   */
+  bool MatchDelimiter(const char*& pos, const char* end) const;
+
+  //! Extension (type) of file.
+  std::string extension;
+  //! Name of file.
+  std::string filename;
+  //! View of the contents of the file.
+  MappedFile contents;
+  //! Character separating tokens (',', '\t', or ' ').
+  char delimiter;
+  //! Character that may not appear inside of a token.
+  char excluded;
+  //! Offset of the start of each line, plus one past the end of the last line.
+  std::vector<size_t> lineStarts;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_csv_parallel_impl.hpp"
+
+#endif
@@ -0,0 +1,298 @@
+/**
+ * @file load_csv_parallel_impl.hpp
+ *
+ * Implementation of the templated parts of LoadCSVParallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_CSV_PARALLEL_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_CSV_PARALLEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_csv_parallel.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+template<typename TokenFunction>
+size_t LoadCSVParallel::ParseLine(const size_t line, TokenFunction f) const
+{
+  const char* pos;
+  const char* end;
+  LineBounds(line, pos, end);
+
+  size_t numTokens = 0;
+  while (true)
+  {
+    // A token may be empty (e.g. "1,,2").
+    const char* tokenBegin = pos;
+    while (pos != end && IsTokenChar(*pos))
+      ++pos;
+    const char* tokenEnd = pos;
+    Trim(tokenBegin, tokenEnd);
+
+    f(numTokens++, tokenBegin, tokenEnd);
+
+    if (pos == end || !MatchDelimiter(pos, end))
+      break;
+  }
+
+  return numTokens;
+}
+
+template<typename T, typename PolicyType>
+void LoadCSVParallel::Load(arma::Mat<T>& inout,
+                           DatasetMapper<PolicyType>& infoSet,
+                           const bool transpose)
+{
+  const size_t numLines = NumLines();
+
+  // The first line determines the number of tokens every line must have.
+  const size_t numTokens = (numLines == 0) ? 0 : ParseLine(0,
+      [](const size_t, const char*, const char*) { });
+
+  // When transposing, each line is a point; otherwise each line is a
+  // dimension.
+  const size_t rows = transpose ? numTokens : numLines;
+  const size_t cols = transpose ? numLines : numTokens;
+
+  PolicyType policy(infoSet.Policy());
+  infoSet = DatasetMapper<PolicyType>(policy, rows);
+
+  if (PolicyType::NeedsFirstPass)
+  {
+    // Each thread runs the first pass on its own lines; a dimension is then
+    // categorical if any thread decided that it is.
+    #pragma omp parallel
+    {
+      DatasetMapper<PolicyType> localInfo(infoSet);
+      std::string token;
+
+      #pragma omp for schedule(static)
+      for (omp_size_t line = 0; line < (omp_size_t) numLines; ++line)
+      {
+        ParseLine(line, [&](const size_t index, const char* begin,
+                            const char* end)
+        {
+          if (transpose && index >= rows)
+            return;
+
+          token.assign(begin, end);
+          localInfo.template MapFirstPass<T>(token, transpose ? index : line);
+        });
+      }
+
+      #pragma omp critical
+      {
+        for (size_t d = 0; d < rows; ++d)
+        {
+          if (localInfo.Type(d) == Datatype::categorical)
+            infoSet.Type(d) = Datatype::categorical;
+        }
+      }
+    }
+  }
+
+  inout.set_size(rows, cols);
+
+  #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+  #else
+    const size_t numThreads = 1;
+  #endif
+
+  // With IncrementPolicy, every token of a dimension that the first pass found
+  // categorical is mapped, and the mapped values are the indices of the
+  // mappings.  Each thread then records the mappings it creates in the order
+  // they appear; the local mappings are merged into infoSet in file order and
+  // each thread relabels its own lines through a local-to-global table, so the
+  // tokens never need to be parsed again.  Any other dimension for which a
+  // mapping was created is mapped again in file order.
+  const bool relabel = std::is_same<PolicyType, IncrementPolicy>::value;
+  std::vector<char> categorical(rows, 0);
+  if (relabel)
+  {
+    for (size_t d = 0; d < rows; ++d)
+      categorical[d] = (infoSet.Type(d) == Datatype::categorical);
+  }
+
+  struct NewMapping
+  {
+    size_t dim;
+    size_t value;
+    std::string token;
+  };
+
+  std::vector<std::vector<NewMapping>> newMappings(numThreads);
+  std::vector<std::vector<std::vector<T>>> tables(numThreads);
+  std::vector<size_t> firstLines(numThreads, numLines);
+
+  std::vector<char> remap(rows, 0);
+  size_t badLine = numLines;
+  size_t badNumTokens = 0;
+
+  #pragma omp parallel
+  {
+    #ifdef HAS_OPENMP
+      const size_t thread = omp_get_thread_num();
+    #else
+      const size_t thread = 0;
+    #endif
+
+    DatasetMapper<PolicyType> localInfo(infoSet);
+    std::vector<size_t> localCounts(relabel ? rows : 0, 0);
+    std::string token;
+    size_t localBadLine = numLines;
+    size_t localBadNumTokens = 0;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t line = 0; line < (omp_size_t) numLines; ++line)
+    {
+      if (firstLines[thread] == numLines)
+        firstLines[thread] = line;
+
+      const size_t lineTokens = ParseLine(line, [&](const size_t index,
+          const char* begin, const char* end)
+      {
+        if (index >= numTokens)
+          return;
+
+        token.assign(begin, end);
+        const size_t dim = transpose ? index : line;
+        const size_t point = transpose ? line : index;
+        const T value = localInfo.template MapString<T>(token, dim);
+        inout(dim, point) = value;
+
+        if (categorical[dim] && (size_t) value == localCounts[dim])
+        {
+          newMappings[thread].push_back(NewMapping { dim, (size_t) value,
+              token });
+          ++localCounts[dim];
+        }
+      });
+
+      if (lineTokens != numTokens && (size_t) line < localBadLine)
+      {
+        localBadLine = line;
+        localBadNumTokens = lineTokens;
+      }
+    }
+
+    #pragma omp critical
+    {
+      if (localBadLine < badLine)
+      {
+        badLine = localBadLine;
+        badNumTokens = localBadNumTokens;
+      }
+
+      for (size_t d = 0; d < rows; ++d)
+      {
+        if (!categorical[d] && localInfo.NumMappings(d) > 0)
+          remap[d] = 1;
+      }
+    }
+
+    #pragma omp barrier
+
+    // Merge the local mappings in the order of the lines of each thread.
+    #pragma omp single
+    {
+      if (relabel && badLine == numLines)
+      {
+        std::vector<size_t> order(numThreads);
+        for (size_t t = 0; t < numThreads; ++t)
+          order[t] = t;
+        std::sort(order.begin(), order.end(),
+            [&](const size_t a, const size_t b)
+            { return firstLines[a] < firstLines[b]; });
+
+        for (size_t t : order)
+        {
+          if (newMappings[t].empty())
+            continue;
+
+          tables[t].resize(rows);
+          for (const NewMapping& m : newMappings[t])
+          {
+            std::vector<T>& table = tables[t][m.dim];
+            if (table.size() <= m.value)
+              table.resize(m.value + 1);
+            table[m.value] = infoSet.template MapString<T>(m.token, m.dim);
+          }
+
+          std::vector<NewMapping>().swap(newMappings[t]);
+        }
+      }
+    }
+
+    // The iterations are divided as in the mapping loop, so each thread
+    // relabels the lines it mapped.
+    const std::vector<std::vector<T>>& localTables = tables[thread];
+
+    #pragma omp for schedule(static) nowait
+    for (omp_size_t line = 0; line < (omp_size_t) numLines; ++line)
+    {
+      if (localTables.empty())
+        continue;
+
+      if (transpose)
+      {
+        for (size_t d = 0; d < rows; ++d)
+        {
+          if (!localTables[d].empty())
+            inout(d, line) = localTables[d][(size_t) inout(d, line)];
+        }
+      }
+      else if (!localTables[line].empty())
+      {
+        const std::vector<T>& table = localTables[line];
+        for (size_t p = 0; p < cols; ++p)
+          inout(line, p) = table[(size_t) inout(line, p)];
+      }
+    }
+  }
+
+  if (badLine != numLines)
+  {
+    std::ostringstream oss;
+    oss << "LoadCSVParallel::Load(): wrong number of dimensions ("
+        << badNumTokens << ") on line " << badLine << "; should be "
+        << numTokens << " dimensions.";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (std::find(remap.begin(), remap.end(), 1) == remap.end())
+    return;
+
+  std::string token;
+  for (size_t line = 0; line < numLines; ++line)
+  {
+    if (!transpose && !remap[line])
+      continue;
+
+    ParseLine(line, [&](const size_t index, const char* begin,
+                        const char* end)
+    {
+      const size_t dim = transpose ? index : line;
+      const size_t point = transpose ? line : index;
+      if (!remap[dim])
+        return;
+
+      token.assign(begin, end);
+      inout(dim, point) = infoSet.template MapString<T>(token, dim);
+    });
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
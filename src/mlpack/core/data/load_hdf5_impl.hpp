@@ -0,0 +1,152 @@
+/**
+ * @file load_hdf5_impl.hpp
+ *
+ * Implementation of the Load() overload that reads part of a matrix from an
+ * HDF5 file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_HDF5_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_HDF5_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "load.hpp"
+
+#include <mlpack/core/util/timers.hpp>
+#include "extension.hpp"
+#include "first_touch.hpp"
+#include "hdf5_dataset.hpp"
+
+namespace mlpack {
+namespace data {
+
+namespace detail {
+
+/**
+ * Turn the given span into the first index and the number of indices, given
+ * the size of the dimension.  Returns false if the span is out of range.
+ */
+inline bool SpanRange(const arma::span& span,
+                      const size_t size,
+                      size_t& first,
+                      size_t& count)
+{
+  if (span.whole)
+  {
+    first = 0;
+    count = size;
+    return true;
+  }
+
+  if (span.a > span.b || span.b >= size)
+    return false;
+
+  first = span.a;
+  count = span.b - span.a + 1;
+  return true;
+}
+
+} // namespace detail
+
+template<typename eT>
+bool Load(const std::string& filename,
+          arma::Mat<eT>& matrix,
+          const arma::span& rows,
+          const arma::span& cols,
+          const bool fatal,
+          const bool transpose,
+          const std::string& datasetName)
+{
+  Timer::Start("loading_data");
+
+  const std::string extension = Extension(filename);
+  if (extension != "h5" && extension != "hdf5" && extension != "hdf" &&
+      extension != "he5")
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Cannot load part of '" << filename << "': only HDF5 files "
+          << "support loading rows and columns." << std::endl;
+    else
+      Log::Warn << "Cannot load part of '" << filename << "': only HDF5 files "
+          << "support loading rows and columns." << std::endl;
+
+    return false;
+  }
+
+#ifdef ARMA_USE_HDF5
+  Log::Info << "Loading part of '" << filename << "' as HDF5 data.  "
+      << std::flush;
+  try
+  {
+    HDF5Dataset<eT> dataset(filename, datasetName);
+
+    // The selection is given for the loaded matrix, so it is transposed too.
+    const arma::span& storedRows = transpose ? cols : rows;
+    const arma::span& storedCols = transpose ? rows : cols;
+    size_t firstRow, numRows, firstCol, numCols;
+    if (!detail::SpanRange(storedRows, dataset.NumRows(), firstRow, numRows) ||
+        !detail::SpanRange(storedCols, dataset.NumCols(), firstCol, numCols))
+    {
+      std::ostringstream oss;
+      oss << "the selection is out of range for the "
+          << (transpose ? dataset.NumCols() : dataset.NumRows()) << " x "
+          << (transpose ? dataset.NumRows() : dataset.NumCols())
+          << " matrix in '" << filename << "'.";
+      throw std::out_of_range(oss.str());
+    }
+
+    dataset.Read(firstRow, numRows, firstCol, numCols, matrix);
+  }
+  catch (std::exception& e)
+  {
+    Log::Info << std::endl;
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Loading from '" << filename << "' failed: " << e.what()
+          << std::endl;
+    else
+      Log::Warn << "Loading from '" << filename << "' failed: " << e.what()
+          << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
+      << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
+
+  if (transpose)
+    inplace_transpose(matrix);
+
+  if (FirstTouchEnabled())
+    FirstTouch(matrix);
+
+  Timer::Stop("loading_data");
+  return true;
+#else
+  Timer::Stop("loading_data");
+  if (fatal)
+    Log::Fatal << "Attempted to load '" << filename << "' as HDF5 data, but "
+        << "Armadillo was compiled without HDF5 support.  Load failed."
+        << std::endl;
+  else
+    Log::Warn << "Attempted to load '" << filename << "' as HDF5 data, but "
+        << "Armadillo was compiled without HDF5 support.  Load failed."
+        << std::endl;
+
+  (void) matrix;
+  (void) rows;
+  (void) cols;
+  (void) transpose;
+  (void) datasetName;
+  return false;
+#endif
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
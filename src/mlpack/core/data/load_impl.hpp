@@ -19,14 +19,17 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "load_csv.hpp"
+#include "load_csv_parallel.hpp"
 #include "load.hpp"
 #include "extension.hpp"
+#include "first_touch.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include "load_arff.hpp"
+#include "load_arrow.hpp"
 
 namespace mlpack {
 namespace data {
@@ -107,6 +110,46 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  if (IsArrowExtension(extension))
+  {
+#ifdef HAS_ARROW
+    Log::Info << "Loading '" << filename << "' with Arrow.  " << std::flush;
+    try
+    {
+      LoadArrow(filename, matrix, std::vector<std::string>(), transpose);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
+        << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
+    if (FirstTouchEnabled())
+      FirstTouch(matrix);
+    Timer::Stop("loading_data");
+    return true;
+#else
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Attempted to load '" << filename << "' with Arrow, but "
+          << "mlpack was compiled without Arrow support.  Load failed."
+          << std::endl;
+    else
+      Log::Warn << "Attempted to load '" << filename << "' with Arrow, but "
+          << "mlpack was compiled without Arrow support.  Load failed."
+          << std::endl;
+
+    return false;
+#endif
+  }
+
   bool unknownType = false;
   arma::file_type loadType;
   std::string stringType;
@@ -293,6 +336,9 @@ bool Load(const std::string& filename,
     inplace_transpose(matrix);
   }
 
+  if (FirstTouchEnabled())
+    FirstTouch(matrix);
+
   Timer::Stop("loading_data");
 
   // Finally, return the success indicator.
@@ -334,7 +380,7 @@ bool Load(const std::string& filename,
     Log::Info << "Loading '" << filename << "' as CSV dataset.  " << std::flush;
     try
     {
-      LoadCSV loader(filename);
+      LoadCSVParallel loader(filename);
       loader.Load(matrix, info, transpose);
     }
     catch (std::exception& e)
@@ -348,6 +394,39 @@ bool Load(const std::string& filename,
       return false;
     }
   }
+  else if (IsArrowExtension(extension))
+  {
+#ifdef HAS_ARROW
+    Log::Info << "Loading '" << filename << "' with Arrow.  " << std::flush;
+    try
+    {
+      LoadArrow(filename, matrix, info, std::vector<std::string>(),
+          transpose);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+#else
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Attempted to load '" << filename << "' with Arrow, but "
+          << "mlpack was compiled without Arrow support.  Load failed."
+          << std::endl;
+    else
+      Log::Warn << "Attempted to load '" << filename << "' with Arrow, but "
+          << "mlpack was compiled without Arrow support.  Load failed."
+          << std::endl;
+
+    return false;
+#endif
+  }
   else if (extension == "arff")
   {
     Log::Info << "Loading '" << filename << "' as ARFF dataset.  "
@@ -388,6 +467,9 @@ bool Load(const std::string& filename,
   Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
       << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
 
+  if (FirstTouchEnabled())
+    FirstTouch(matrix);
+
   Timer::Stop("loading_data");
 
   return true;
@@ -25,6 +25,8 @@
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string.hpp>
 
@@ -49,6 +51,8 @@ bool Load(const std::string& filename,
       f = format::binary;
     else if (extension == "txt")
       f = format::text;
+    else if (extension == "gz")
+      f = format::compressed;
     else
     {
       if (fatal)
@@ -65,7 +69,7 @@ bool Load(const std::string& filename,
   // Now load the given format.
   std::ifstream ifs;
 #ifdef _WIN32 // Open non-text in binary mode on Windows.
-  if (f == format::binary)
+  if (f == format::binary || IsCompressed(f))
     ifs.open(filename, std::ifstream::in | std::ifstream::binary);
   else
     ifs.open(filename, std::ifstream::in);
@@ -102,6 +106,21 @@ bool Load(const std::string& filename,
       boost::archive::binary_iarchive ar(ifs);
       ar >> boost::serialization::make_nvp(name.c_str(), t);
     }
+    else if (IsCompressed(f))
+    {
+      // The file is decompressed as it is read, straight into the objects;
+      // the precision the matrices were stored with comes first.
+      boost::iostreams::filtering_istream in;
+      in.push(boost::iostreams::gzip_decompressor());
+      in.push(ifs);
+
+      boost::archive::binary_iarchive ar(in);
+      int p = precision::full;
+      ar >> boost::serialization::make_nvp("precision", p);
+
+      ScopedPrecision scope((precision) p);
+      ar >> boost::serialization::make_nvp(name.c_str(), t);
+    }
 
     return true;
   }
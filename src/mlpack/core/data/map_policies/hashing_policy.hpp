@@ -0,0 +1,205 @@
+/**
+ * @file hashing_policy.hpp
+ *
+ * Feature hashing map policy for dataset info.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAP_POLICIES_HASHING_POLICY_HPP
+#define MLPACK_CORE_DATA_MAP_POLICIES_HASHING_POLICY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <cstdint>
+#include <mlpack/core/data/map_policies/datatype.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * HashingPolicy is used as a helper class for DatasetMapper.  Like
+ * IncrementPolicy, it makes a dimension categorical if any of its strings
+ * cannot be read as a number (or always, if 'forceAllMappings' is true), but
+ * instead of numbering the distinct strings it hashes each string (together
+ * with its dimension) into one of a fixed number of buckets.  No mappings are
+ * stored, so the memory used does not grow with the number of distinct
+ * strings, a string is mapped to the same bucket in every file, and strings
+ * can be mapped in parallel.  The price is that strings cannot be unmapped,
+ * NumMappings() is 0 for every dimension, and different strings may share a
+ * bucket.
+ *
+ * With signed hashing, a second bit of the hash gives each string a sign, so
+ * that collisions cancel out in expectation when the buckets are used as
+ * features (see HashFeatures()).  The sign is part of the mapped value: a
+ * string with bucket b is mapped to b if its sign is positive and to
+ * b + NumBuckets() if it is negative; Bucket() and Sign() decode the value.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{weinberger2009feature,
+ *   title     = {Feature hashing for large scale multitask learning},
+ *   author    = {Weinberger, Kilian and Dasgupta, Anirban and Langford, John
+ *                and Smola, Alex and Attenberg, Josh},
+ *   booktitle = {Proceedings of the 26th Annual International Conference
+ *                on Machine Learning},
+ *   pages     = {1113--1120},
+ *   year      = {2009}
+ * }
+ * @endcode
+ *
+ * The mapped values must be exactly representable by the matrix type, so with
+ * float matrices the number of buckets should be at most 2^23 (2^22 with
+ * signed hashing).
+ */
+class HashingPolicy
+{
+ public:
+  /**
+   * Create the HashingPolicy object.
+   *
+   * @param numBuckets Number of buckets to hash strings into.
+   * @param signedHashing If true, give each string a sign as well.
+   * @param forceAllMappings If true, hash every string, even numeric ones.
+   * @param seed Seed of the hash function.
+   */
+  HashingPolicy(const size_t numBuckets = 1 << 20,
+                const bool signedHashing = false,
+                const bool forceAllMappings = false,
+                const size_t seed = 0) :
+      numBuckets(numBuckets),
+      signedHashing(signedHashing),
+      forceAllMappings(forceAllMappings),
+      seed(seed)
+  {
+    if (numBuckets == 0)
+      Log::Fatal << "HashingPolicy: the number of buckets must be positive!"
+          << std::endl;
+  }
+
+  // typedef of MappedType
+  using MappedType = size_t;
+
+  //! We do need a first pass over the data to set the dimension types right.
+  static const bool NeedsFirstPass = true;
+
+  /**
+   * Determine if the dimension is numeric or categorical.
+   */
+  template<typename T>
+  void MapFirstPass(const std::string& input,
+                    const size_t dim,
+                    std::vector<Datatype>& types)
+  {
+    if (types[dim] == Datatype::categorical)
+      return;
+
+    if (forceAllMappings || !IsNumber<T>(input))
+      types[dim] = Datatype::categorical;
+  }
+
+  /**
+   * Given the input and the dimension to which it belongs, return its bucket
+   * (with the sign, if signed hashing is used), or its value if the dimension
+   * is numeric and the input can be read as a number.  The maps are never
+   * touched.
+   *
+   * @tparam MapType Type of unordered_map that contains mapped value pairs
+   * @param input Input to hash.
+   * @param dimension Index of the dimension of the input.
+   * @param maps Unordered map given by the DatasetMapper (unused).
+   * @param types Vector containing the type information about each dimensions.
+   */
+  template<typename MapType, typename T>
+  T MapString(const std::string& input,
+              const size_t dimension,
+              MapType& /* maps */,
+              std::vector<Datatype>& types)
+  {
+    if (types[dimension] == Datatype::numeric && !forceAllMappings)
+    {
+      std::stringstream token;
+      token << input;
+      T val;
+      token >> val;
+
+      if (!token.fail() && token.eof())
+        return val;
+    }
+
+    types[dimension] = Datatype::categorical;
+    return T(Hash(input, dimension));
+  }
+
+  /**
+   * Return the mapped value of the given input in the given dimension: its
+   * bucket, plus NumBuckets() if signed hashing gave it a negative sign.
+   */
+  size_t Hash(const std::string& input, const size_t dimension) const
+  {
+    // FNV-1a over the dimension and the string, followed by the finalizer of
+    // MurmurHash3 so that all bits of the result are well mixed.
+    uint64_t hash = 14695981039346656037ULL ^ (uint64_t) seed;
+    uint64_t dim = (uint64_t) dimension;
+    for (size_t i = 0; i < sizeof(dim); ++i, dim >>= 8)
+      hash = (hash ^ (dim & 0xFF)) * 1099511628211ULL;
+    for (const char c : input)
+      hash = (hash ^ (unsigned char) c) * 1099511628211ULL;
+
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+
+    const size_t bucket = (size_t) ((hash >> 1) % numBuckets);
+    return (signedHashing && (hash & 1)) ? bucket + numBuckets : bucket;
+  }
+
+  //! Return the bucket of a mapped value.
+  size_t Bucket(const size_t value) const { return value % numBuckets; }
+
+  //! Return the sign (1 or -1) of a mapped value.
+  double Sign(const size_t value) const
+  {
+    return (value < numBuckets) ? 1.0 : -1.0;
+  }
+
+  //! Get the number of buckets.
+  size_t NumBuckets() const { return numBuckets; }
+  //! Get whether signed hashing is used.
+  bool SignedHashing() const { return signedHashing; }
+  //! Get whether every string is hashed.
+  bool ForceAllMappings() const { return forceAllMappings; }
+  //! Get the seed of the hash function.
+  size_t Seed() const { return seed; }
+
+ private:
+  //! Return whether the input can be read as a T.
+  template<typename T>
+  static bool IsNumber(const std::string& input)
+  {
+    std::stringstream token;
+    token << input;
+    T val;
+    token >> val;
+
+    return !token.fail() && token.eof();
+  }
+
+  //! The number of buckets.
+  size_t numBuckets;
+  //! Whether signed hashing is used.
+  bool signedHashing;
+  //! Whether every string is hashed.
+  bool forceAllMappings;
+  //! The seed of the hash function.
+  size_t seed;
+}; // class HashingPolicy
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -109,37 +109,28 @@ class IncrementPolicy
       // Otherwise, we must map.
     }
 
-    // If this condition is true, either we have no mapping for the given input
-    // or we have no mappings for the given dimension at all.  In either case,
-    // we create a mapping.
-    if (maps.count(dimension) == 0 ||
-        maps[dimension].first.count(input) == 0)
+    // Look the dimension up only once; if it has no mappings yet, an empty
+    // entry is created, and the input will be its first mapping.
+    typename MapType::mapped_type& mapping = maps[dimension];
+    const auto it = mapping.first.find(input);
+    if (it != mapping.first.end())
     {
-      // This input does not exist yet.
-      size_t numMappings = maps[dimension].first.size();
+      // This input already exists in the mapping.
+      return it->second;
+    }
 
-      // Change type of the feature to categorical.
-      if (numMappings == 0)
-        types[dimension] = Datatype::categorical;
+    // This input does not exist yet.
+    const size_t numMappings = mapping.first.size();
 
-      typedef typename std::pair<InputType, MappedType> PairType;
-      maps[dimension].first.insert(PairType(input, numMappings));
+    // Change type of the feature to categorical.
+    if (numMappings == 0)
+      types[dimension] = Datatype::categorical;
 
-      // Do we need to create the second map?
-      if (maps[dimension].second.count(numMappings) == 0)
-      {
-        maps[dimension].second.insert(std::make_pair(numMappings,
-            std::vector<InputType>()));
-      }
-      maps[dimension].second[numMappings].push_back(input);
+    typedef typename std::pair<InputType, MappedType> PairType;
+    mapping.first.insert(PairType(input, numMappings));
+    mapping.second[numMappings].push_back(input);
 
-      return T(numMappings);
-    }
-    else
-    {
-      // This input already exists in the mapping.
-      return maps[dimension].first.at(input);
-    }
+    return T(numMappings);
   }
 
  private:
@@ -0,0 +1,107 @@
+/**
+ * @file mapped_file.cpp
+ *
+ * Implementation of the MappedFile class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "mapped_file.hpp"
+
+#include <fstream>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+MappedFile::MappedFile(const std::string& filename, const bool copyOnWrite) :
+    data(NULL),
+    size(0),
+    mapped(false)
+{
+#ifndef _WIN32
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd >= 0)
+  {
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode))
+    {
+      size = (size_t) fileStat.st_size;
+
+      // An empty file can't be mapped, but there is nothing to read anyway.
+      if (size == 0)
+      {
+        close(fd);
+        return;
+      }
+
+      const int protection = copyOnWrite ? (PROT_READ | PROT_WRITE) :
+          PROT_READ;
+      void* address = mmap(NULL, size, protection, MAP_PRIVATE, fd, 0);
+      if (address != MAP_FAILED)
+      {
+        // The file is parsed front to back, so tell the kernel to read ahead.
+        if (!copyOnWrite)
+          madvise(address, size, MADV_SEQUENTIAL);
+        data = (const char*) address;
+        mapped = true;
+      }
+    }
+    close(fd);
+
+    if (mapped)
+      return;
+  }
+#endif
+
+  // Fall back to reading the whole file into memory.
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'. " << std::endl;
+    throw std::runtime_error(oss.str());
+  }
+
+  buffer.assign(std::istreambuf_iterator<char>(stream),
+      std::istreambuf_iterator<char>());
+  size = buffer.size();
+  data = buffer.data();
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+  if (mapped)
+    munmap((void*) data, size);
+#endif
+}
+
+void PrefetchMapping(const void* address, const size_t length)
+{
+#ifndef _WIN32
+  if (length == 0)
+    return;
+
+  // madvise() needs an address on a page boundary.
+  static const size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+  const size_t start = (size_t) address;
+  const size_t alignedStart = start - (start % pageSize);
+  madvise((void*) alignedStart, length + (start - alignedStart),
+      MADV_WILLNEED);
+#else
+  (void) address;
+  (void) length;
+#endif
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,84 @@
+/**
+ * @file mapped_file.hpp
+ *
+ * A read-only view of the contents of a file.  Where possible the file is
+ * memory-mapped, so that very large files can be parsed without first being
+ * copied into memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_FILE_HPP
+#define MLPACK_CORE_DATA_MAPPED_FILE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * MappedFile gives read-only access to the bytes of a file.  On POSIX systems
+ * the file is mapped into memory with mmap(); elsewhere (or if mapping fails)
+ * the file is read into an internal buffer.  The object is not copyable.
+ */
+class MappedFile
+{
+ public:
+  /**
+   * Open and map the given file.  A std::runtime_error is thrown if the file
+   * cannot be opened.
+   *
+   * If copyOnWrite is true, the mapping may be modified through
+   * MutableData(): pages are shared with every other process mapping the file
+   * until they are written to, and changes never reach the file.  The kernel is
+   * also not told to expect sequential access, since such mappings usually
+   * hold data structures that are accessed randomly.
+   *
+   * @param filename Name of file to map.
+   * @param copyOnWrite Whether or not the mapping may be modified.
+   */
+  MappedFile(const std::string& filename, const bool copyOnWrite = false);
+
+  //! Unmap the file.
+  ~MappedFile();
+
+  // Copying makes no sense for a mapping.
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  //! Get a pointer to the first byte of the file.
+  const char* Data() const { return data; }
+  //! Get a modifiable pointer to the first byte of the file.  This may only
+  //! be used if the file was opened with copyOnWrite = true.
+  char* MutableData() { return const_cast<char*>(data); }
+  //! Get the size of the file in bytes.
+  size_t Size() const { return size; }
+
+ private:
+  //! Pointer to the contents of the file.
+  const char* data;
+  //! Size of the file in bytes.
+  size_t size;
+  //! Whether or not data points to a memory mapping.
+  bool mapped;
+  //! Buffer holding the file contents if the file could not be mapped.
+  std::vector<char> buffer;
+};
+
+/**
+ * Ask the operating system to start reading the given range of memory from
+ * disk in the background, if it belongs to a memory-mapped file whose pages are
+ * not in memory yet.  This returns immediately, and does nothing for memory
+ * that is not backed by a file, or on systems without madvise().
+ *
+ * @param address Start of the range.
+ * @param length Length of the range in bytes.
+ */
+void PrefetchMapping(const void* address, const size_t length);
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,227 @@
+/**
+ * @file moments.hpp
+ *
+ * Single-pass computation of the mean, variance, skewness, kurtosis, minimum
+ * and maximum of each dimension of a dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MOMENTS_HPP
+#define MLPACK_CORE_DATA_MOMENTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Moments accumulates the count, mean, central moments of order 2 to 4,
+ * minimum and maximum of a stream of values in one pass, with the updates of
+ * Welford, Terriberry and Pebay ("Formulas for robust, one-pass parallel
+ * computation of covariances and arbitrary-order statistical moments", 2008).
+ * Two accumulators can be merged, so a dataset can be split between threads
+ * and the results combined afterwards.
+ *
+ * The skewness and kurtosis are computed with the same conventions as
+ * mlpack_preprocess_describe: the sample statistics are the adjusted
+ * Fisher-Pearson coefficients, and the kurtosis is the excess kurtosis.
+ */
+class Moments
+{
+ public:
+  //! Create an empty accumulator.
+  Moments() :
+      count(0),
+      mean(0.0),
+      m2(0.0),
+      m3(0.0),
+      m4(0.0),
+      min(std::numeric_limits<double>::max()),
+      max(-std::numeric_limits<double>::max())
+  { }
+
+  //! Add a value.
+  void Add(const double x)
+  {
+    const double n1 = (double) count;
+    ++count;
+    const double n = (double) count;
+    const double delta = x - mean;
+    const double deltaN = delta / n;
+    const double deltaN2 = deltaN * deltaN;
+    const double term = delta * deltaN * n1;
+
+    mean += deltaN;
+    m4 += term * deltaN2 * (n * n - 3 * n + 3) + 6 * deltaN2 * m2 -
+        4 * deltaN * m3;
+    m3 += term * deltaN * (n - 2) - 3 * deltaN * m2;
+    m2 += term;
+
+    min = std::min(min, x);
+    max = std::max(max, x);
+  }
+
+  //! Add the values accumulated by another Moments object.
+  void Merge(const Moments& other)
+  {
+    if (other.count == 0)
+      return;
+    if (count == 0)
+    {
+      *this = other;
+      return;
+    }
+
+    const double na = (double) count;
+    const double nb = (double) other.count;
+    const double n = na + nb;
+    const double delta = other.mean - mean;
+    const double delta2 = delta * delta;
+
+    const double newM4 = m4 + other.m4 + delta2 * delta2 * na * nb *
+        (na * na - na * nb + nb * nb) / (n * n * n) + 6 * delta2 *
+        (na * na * other.m2 + nb * nb * m2) / (n * n) + 4 * delta *
+        (na * other.m3 - nb * m3) / n;
+    const double newM3 = m3 + other.m3 + delta2 * delta * na * nb * (na - nb) /
+        (n * n) + 3 * delta * (na * other.m2 - nb * m2) / n;
+    m2 += other.m2 + delta2 * na * nb / n;
+    m3 = newM3;
+    m4 = newM4;
+    mean += delta * nb / n;
+    count += other.count;
+
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+  }
+
+  //! Get the number of values.
+  size_t Count() const { return count; }
+  //! Get the mean.
+  double Mean() const { return mean; }
+  //! Get the smallest value.
+  double Min() const { return min; }
+  //! Get the largest value.
+  double Max() const { return max; }
+
+  //! Get the variance, of the population or (by default) of the sample.
+  double Variance(const bool population = false) const
+  {
+    const double n = (double) count;
+    return population ? m2 / n : m2 / (n - 1);
+  }
+
+  //! Get the standard deviation, of the population or of the sample.
+  double StdDev(const bool population = false) const
+  {
+    return std::sqrt(Variance(population));
+  }
+
+  //! Get the skewness, of the population or of the sample.
+  double Skewness(const bool population = false) const
+  {
+    const double n = (double) count;
+    const double s3 = std::pow(StdDev(population), 3);
+    if (population)
+      return m3 / (n * s3);
+    else
+      return n * m3 / ((n - 1) * (n - 2) * s3);
+  }
+
+  //! Get the excess kurtosis, of the population or of the sample.
+  double Kurtosis(const bool population = false) const
+  {
+    const double n = (double) count;
+    if (population)
+      return n * m4 / (m2 * m2) - 3;
+
+    const double s4 = std::pow(StdDev(false), 4);
+    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
+    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
+    return normC * (m4 / s4) - norm3;
+  }
+
+ private:
+  //! The number of values.
+  size_t count;
+  //! The mean of the values.
+  double mean;
+  //! The sums of the squares, cubes and fourth powers of the deviations.
+  double m2, m3, m4;
+  //! The smallest value.
+  double min;
+  //! The largest value.
+  double max;
+};
+
+/**
+ * Compute the moments of each dimension (row) of the given dataset in a single
+ * pass, or those of each point (column) if rowMajor is true.  The points are
+ * split into contiguous blocks, one per thread, that are merged in order, so
+ * the result doesn't depend on the scheduling.
+ *
+ * @param data Dataset to compute the moments of.
+ * @param moments Vector to store the moments of each dimension in.
+ * @param rowMajor If true, compute the moments of each column instead.
+ */
+template<typename eT>
+void ComputeMoments(const arma::Mat<eT>& data,
+                    std::vector<Moments>& moments,
+                    const bool rowMajor = false)
+{
+  if (rowMajor)
+  {
+    // Each column is contiguous, so it is handled by a single thread.
+    moments.assign(data.n_cols, Moments());
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      const eT* colPtr = data.colptr(i);
+      for (size_t j = 0; j < data.n_rows; ++j)
+        moments[i].Add((double) colPtr[j]);
+    }
+
+    return;
+  }
+
+  #ifdef HAS_OPENMP
+    const size_t numThreads = std::max(std::min((size_t) omp_get_max_threads(),
+        (size_t) data.n_cols / 1024), (size_t) 1);
+  #else
+    const size_t numThreads = 1;
+  #endif
+
+  std::vector<std::vector<Moments>> partials(numThreads,
+      std::vector<Moments>(data.n_rows));
+
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t t = 0; t < (omp_size_t) numThreads; ++t)
+  {
+    const size_t begin = data.n_cols * t / numThreads;
+    const size_t end = data.n_cols * (t + 1) / numThreads;
+    std::vector<Moments>& partial = partials[t];
+    for (size_t i = begin; i < end; ++i)
+    {
+      const eT* colPtr = data.colptr(i);
+      for (size_t j = 0; j < data.n_rows; ++j)
+        partial[j].Add((double) colPtr[j]);
+    }
+  }
+
+  moments = std::move(partials[0]);
+  for (size_t t = 1; t < numThreads; ++t)
+    for (size_t j = 0; j < data.n_rows; ++j)
+      moments[j].Merge(partials[t][j]);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
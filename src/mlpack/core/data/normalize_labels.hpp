@@ -23,7 +23,9 @@ namespace data {
  * Given a set of labels of a particular datatype, convert them to unsigned
  * labels in the range [0, n) where n is the number of different labels.  Also,
  * a reverse mapping from the new label to the old value is stored in the
- * 'mapping' vector.
+ * 'mapping' vector.  The labels are numbered in the order in which they first
+ * appear.  Labels are looked up in a hash table, and long label vectors are
+ * split into chunks that are normalized in parallel and then merged.
  *
  * @param labelsIn Input labels of arbitrary datatype.
  * @param labels Vector that unsigned labels will be stored in.
@@ -16,6 +16,12 @@
 // In case it hasn't been included yet.
 #include "normalize_labels.hpp"
 
+#include <unordered_map>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace data {
 
@@ -34,37 +40,76 @@ void NormalizeLabels(const RowType& labelsIn,
                      arma::Row<size_t>& labels,
                      arma::Col<eT>& mapping)
 {
-  // Loop over the input labels, and develop the mapping.  We'll first naively
-  // resize the mapping to the maximum possible size, and then when we fill it,
-  // we'll resize it back down to its actual size.
-  mapping.set_size(labelsIn.n_elem);
+  // Small label vectors aren't worth starting threads for.
+  #ifdef HAS_OPENMP
+    const size_t numChunks = (labelsIn.n_elem < 65536) ? 1 :
+        std::min((size_t) omp_get_max_threads(), labelsIn.n_elem / 16384);
+  #else
+    const size_t numChunks = 1;
+  #endif
+
+  // Each chunk of the labels is first normalized on its own, with its labels
+  // numbered in the order in which they first appear in the chunk.
   labels.set_size(labelsIn.n_elem);
-  size_t curLabel = 0;
-  for (size_t i = 0; i < labelsIn.n_elem; ++i)
+  std::vector<std::vector<eT>> chunkMappings(numChunks);
+
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
   {
-    bool found = false;
-    for (size_t j = 0; j < curLabel; ++j)
+    const size_t begin = labelsIn.n_elem * c / numChunks;
+    const size_t end = labelsIn.n_elem * (c + 1) / numChunks;
+
+    std::unordered_map<eT, size_t> seen;
+    std::vector<eT>& chunkMapping = chunkMappings[c];
+    for (size_t i = begin; i < end; ++i)
     {
-      // Is the label already in the list of labels we have seen?
-      if (labelsIn[i] == mapping[j])
+      const eT label = labelsIn[i];
+      typename std::unordered_map<eT, size_t>::const_iterator it =
+          seen.find(label);
+      if (it == seen.end())
       {
-        labels[i] = j;
-        found = true;
-        break;
+        it = seen.emplace(label, chunkMapping.size()).first;
+        chunkMapping.push_back(label);
       }
+
+      labels[i] = it->second;
     }
+  }
 
-    // Do we need to add this new label?
-    if (!found)
+  // Now merge the mappings of the chunks in order, so that the labels are
+  // numbered in the order of their first appearance in the whole vector.
+  std::unordered_map<eT, size_t> seen;
+  std::vector<eT> fullMapping;
+  std::vector<std::vector<size_t>> translations(numChunks);
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    translations[c].resize(chunkMappings[c].size());
+    for (size_t j = 0; j < chunkMappings[c].size(); ++j)
     {
-      mapping[curLabel] = labelsIn[i];
-      labels[i] = curLabel;
-      ++curLabel;
+      const eT label = chunkMappings[c][j];
+      typename std::unordered_map<eT, size_t>::const_iterator it =
+          seen.find(label);
+      if (it == seen.end())
+      {
+        it = seen.emplace(label, fullMapping.size()).first;
+        fullMapping.push_back(label);
+      }
+
+      translations[c][j] = it->second;
     }
   }
 
-  // Resize mapping back down to necessary size.
-  mapping.resize(curLabel);
+  // The first chunk is already numbered correctly.
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t c = 1; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t begin = labelsIn.n_elem * c / numChunks;
+    const size_t end = labelsIn.n_elem * (c + 1) / numChunks;
+    for (size_t i = begin; i < end; ++i)
+      labels[i] = translations[c][labels[i]];
+  }
+
+  mapping = arma::Col<eT>(fullMapping);
 }
 
 /**
@@ -83,7 +128,8 @@ void RevertLabels(const arma::Row<size_t>& labels,
   // We already have the mapping, so we just need to loop over each element.
   labelsOut.set_size(labels.n_elem);
 
-  for (size_t i = 0; i < labels.n_elem; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) labels.n_elem; ++i)
     labelsOut[i] = mapping[labels[i]];
 }
 
@@ -38,6 +38,13 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5 (hdf5_binary), denoted by .hdf5, .hdf, .h5, or .he5
+ *  - Parquet, denoted by .parquet, and Arrow IPC, denoted by .arrow, .feather
+ *    or .ipc, if mlpack was built with Arrow (see SaveArrow())
+ *  - TSV, denoted by .tsv
+ *
+ * CSV, TSV and ASCII files of real or integer matrices are written by
+ * SaveCSVParallel(), which formats the numbers in parallel with the fewest
+ * digits that read back exactly.
  *
  * If the file extension is not one of those types, an error will be given.  If
  * the 'fatal' parameter is set to true, a std::runtime_error exception will be
@@ -69,11 +76,16 @@ bool Save(const std::string& filename,
  *  - text, denoted by .txt
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
+ *  - gzip-compressed binary, denoted by .gz
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
- * The autodetect functionality operates on the file extension (so, "file.txt"
- * would be autodetected as text).
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary',
+ * 'format::compressed', 'format::compressed_float32' and
+ * 'format::compressed_float16'.  The last two also store the floating-point
+ * elements of matrices in single or half precision, which Load() reads back
+ * without having to be told.  The autodetect functionality operates on the
+ * file extension (so, "file.txt" would be autodetected as text, and
+ * "file.bin.gz" as compressed).
  *
  * The name parameter should be specified to indicate the name of the structure
  * to be saved.  If Load() is later called on the generated file, the name used
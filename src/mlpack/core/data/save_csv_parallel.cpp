@@ -0,0 +1,54 @@
+/**
+ * @file save_csv_parallel.cpp
+ *
+ * Implementation of the floating-point number formatting of SaveCSVParallel().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "save_csv_parallel.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace mlpack {
+namespace data {
+
+size_t FormatNumber(const double value, char* buffer)
+{
+  // Infinities and NaNs can't be read back as themselves, so they are written
+  // as they are.
+  if (!std::isfinite(value))
+    return std::snprintf(buffer, 32, "%g", value);
+
+  int length = 0;
+  for (int digits = 15; digits <= 17; ++digits)
+  {
+    length = std::snprintf(buffer, 32, "%.*g", digits, value);
+    if (digits == 17 || std::strtod(buffer, NULL) == value)
+      break;
+  }
+
+  return length;
+}
+
+size_t FormatNumber(const float value, char* buffer)
+{
+  if (!std::isfinite(value))
+    return std::snprintf(buffer, 32, "%g", (double) value);
+
+  int length = 0;
+  for (int digits = 6; digits <= 9; ++digits)
+  {
+    length = std::snprintf(buffer, 32, "%.*g", digits, (double) value);
+    if (digits == 9 || std::strtof(buffer, NULL) == value)
+      break;
+  }
+
+  return length;
+}
+
+} // namespace data
+} // namespace mlpack
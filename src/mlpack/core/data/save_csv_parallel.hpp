@@ -0,0 +1,67 @@
+/**
+ * @file save_csv_parallel.hpp
+ *
+ * A writer for CSV, TSV and space-separated text files that formats the
+ * numbers of the matrix in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SAVE_CSV_PARALLEL_HPP
+#define MLPACK_CORE_DATA_SAVE_CSV_PARALLEL_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Format the given value into the buffer with the fewest significant digits
+ * (15, 16 or 17) that read back as the same value, and return the number of
+ * characters written.  The buffer must hold at least 32 characters.
+ */
+size_t FormatNumber(const double value, char* buffer);
+
+/**
+ * Format the given value into the buffer with the fewest significant digits
+ * (6 to 9) that read back as the same value, and return the number of
+ * characters written.  The buffer must hold at least 32 characters.
+ */
+size_t FormatNumber(const float value, char* buffer);
+
+/**
+ * Format the given integer into the buffer and return the number of characters
+ * written.  The buffer must hold at least 32 characters.
+ */
+template<typename eT>
+typename std::enable_if<std::is_integral<eT>::value, size_t>::type
+FormatNumber(const eT value, char* buffer);
+
+/**
+ * Write the given matrix to the stream as delimited text, one line per column
+ * of the matrix if transpose is true (one line per row otherwise).  The lines
+ * are split into blocks that are formatted in parallel, each into the buffer
+ * of one thread, and the buffers are written in order; only the buffers of one
+ * round of blocks are kept in memory at once.  The matrix is transposed while
+ * it is formatted, so no transposed copy is made.
+ *
+ * @param stream Stream to write to.
+ * @param matrix Matrix to write.
+ * @param transpose If true, write one line per column of the matrix.
+ * @param delimiter Character separating the values of a line.
+ */
+template<typename eT>
+void SaveCSVParallel(std::ostream& stream,
+                     const arma::Mat<eT>& matrix,
+                     const bool transpose,
+                     const char delimiter);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "save_csv_parallel_impl.hpp"
+
+#endif
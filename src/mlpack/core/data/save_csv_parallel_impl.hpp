@@ -0,0 +1,126 @@
+/**
+ * @file save_csv_parallel_impl.hpp
+ *
+ * Implementation of the templated parts of SaveCSVParallel().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SAVE_CSV_PARALLEL_IMPL_HPP
+#define MLPACK_CORE_DATA_SAVE_CSV_PARALLEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "save_csv_parallel.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+namespace detail {
+
+//! Return whether the given signed integer is negative.
+template<typename eT>
+bool IsNegative(const eT value, const std::true_type /* isSigned */)
+{
+  return value < 0;
+}
+
+//! Unsigned integers are never negative.
+template<typename eT>
+bool IsNegative(const eT /* value */, const std::false_type /* isSigned */)
+{
+  return false;
+}
+
+} // namespace detail
+
+template<typename eT>
+typename std::enable_if<std::is_integral<eT>::value, size_t>::type
+FormatNumber(const eT value, char* buffer)
+{
+  typedef typename std::make_unsigned<eT>::type UnsignedType;
+
+  const bool negative = detail::IsNegative(value, std::is_signed<eT>());
+  UnsignedType magnitude = negative ? UnsignedType(0) - (UnsignedType) value :
+      (UnsignedType) value;
+
+  // Write the digits backwards, then copy them in order.
+  char digits[24];
+  size_t count = 0;
+  do
+  {
+    digits[count++] = (char) ('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+
+  size_t length = 0;
+  if (negative)
+    buffer[length++] = '-';
+  while (count > 0)
+    buffer[length++] = digits[--count];
+
+  return length;
+}
+
+template<typename eT>
+void SaveCSVParallel(std::ostream& stream,
+                     const arma::Mat<eT>& matrix,
+                     const bool transpose,
+                     const char delimiter)
+{
+  const size_t numLines = transpose ? matrix.n_cols : matrix.n_rows;
+  const size_t lineLength = transpose ? matrix.n_rows : matrix.n_cols;
+
+  // Blocks of about 64k values keep the buffers small and the work even.
+  const size_t linesPerBlock = std::max((size_t) 1,
+      (size_t) 65536 / std::max(lineLength, (size_t) 1));
+  const size_t numBlocks = (numLines + linesPerBlock - 1) / linesPerBlock;
+
+  #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+  #else
+    const size_t numThreads = 1;
+  #endif
+
+  std::vector<std::string> buffers(numThreads);
+  for (size_t round = 0; round < numBlocks; round += numThreads)
+  {
+    const size_t roundBlocks = std::min(numThreads, numBlocks - round);
+
+    #pragma omp parallel for schedule(static, 1)
+    for (omp_size_t b = 0; b < (omp_size_t) roundBlocks; ++b)
+    {
+      std::string& buffer = buffers[b];
+      buffer.clear();
+
+      char number[32];
+      const size_t begin = (round + b) * linesPerBlock;
+      const size_t end = std::min(begin + linesPerBlock, numLines);
+      for (size_t line = begin; line < end; ++line)
+      {
+        for (size_t i = 0; i < lineLength; ++i)
+        {
+          if (i > 0)
+            buffer.push_back(delimiter);
+
+          const eT value = transpose ? matrix(i, line) : matrix(line, i);
+          buffer.append(number, FormatNumber(value, number));
+        }
+        buffer.push_back('\n');
+      }
+    }
+
+    for (size_t b = 0; b < roundBlocks; ++b)
+      stream.write(buffers[b].data(), buffers[b].size());
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -15,15 +15,46 @@
 // In case it hasn't already been included.
 #include "save.hpp"
 #include "extension.hpp"
+#include "load_arrow.hpp"
+#include "save_csv_parallel.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/archive/xml_oarchive.hpp>
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
 
 namespace mlpack {
 namespace data {
 
+namespace detail {
+
+//! Write delimited text with the parallel writer; returns true.
+template<typename eT>
+bool SaveText(std::ostream& stream,
+              const arma::Mat<eT>& matrix,
+              const bool transpose,
+              const char delimiter,
+              const std::true_type /* isArithmetic */)
+{
+  SaveCSVParallel(stream, matrix, transpose, delimiter);
+  return true;
+}
+
+//! Other element types are written by Armadillo; returns false.
+template<typename eT>
+bool SaveText(std::ostream& /* stream */,
+              const arma::Mat<eT>& /* matrix */,
+              const bool /* transpose */,
+              const char /* delimiter */,
+              const std::false_type /* isArithmetic */)
+{
+  return false;
+}
+
+} // namespace detail
+
 template<typename eT>
 bool Save(const std::string& filename,
           const arma::Col<eT>& vec,
@@ -64,6 +95,43 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  // Arrow opens the file itself.
+  if (IsArrowExtension(extension))
+  {
+#ifdef HAS_ARROW
+    Log::Info << "Saving to '" << filename << "' with Arrow." << std::endl;
+    try
+    {
+      SaveArrow(filename, matrix, transpose);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Timer::Stop("saving_data");
+    return true;
+#else
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Attempted to save '" << filename << "' with Arrow, but "
+          << "mlpack was compiled without Arrow support.  Save failed."
+          << std::endl;
+    else
+      Log::Warn << "Attempted to save '" << filename << "' with Arrow, but "
+          << "mlpack was compiled without Arrow support.  Save failed."
+          << std::endl;
+
+    return false;
+#endif
+  }
+
   // Catch errors opening the file.
   std::fstream stream;
 #ifdef  _WIN32 // Always open in binary mode on Windows.
@@ -98,6 +166,12 @@ bool Save(const std::string& filename,
     saveType = arma::raw_ascii;
     stringType = "raw ASCII formatted data";
   }
+  else if (extension == "tsv")
+  {
+    // Armadillo has no TSV type; the values are written with tabs below.
+    saveType = arma::raw_ascii;
+    stringType = "TSV data";
+  }
   else if (extension == "bin")
   {
     saveType = arma::arma_binary;
@@ -153,6 +227,30 @@ bool Save(const std::string& filename,
   Log::Info << "Saving " << stringType << " to '" << filename << "'."
       << std::endl;
 
+  // Numbers in delimited text are formatted in parallel, and the matrix is
+  // transposed while it is written.
+  if (saveType == arma::csv_ascii || saveType == arma::raw_ascii)
+  {
+    const char delimiter = (extension == "csv") ? ',' :
+        (extension == "tsv") ? '\t' : ' ';
+    if (detail::SaveText(stream, matrix, transpose, delimiter,
+        std::is_arithmetic<eT>()))
+    {
+      Timer::Stop("saving_data");
+      if (!stream.good())
+      {
+        if (fatal)
+          Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+        else
+          Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+        return false;
+      }
+
+      return true;
+    }
+  }
+
   // Transpose the matrix.
   if (transpose)
   {
@@ -215,14 +313,16 @@ bool Save(const std::string& filename,
       f = format::binary;
     else if (extension == "txt")
       f = format::text;
+    else if (extension == "gz")
+      f = format::compressed;
     else
     {
       if (fatal)
         Log::Fatal << "Unable to detect type of '" << filename << "'; incorrect"
-            << " extension? (allowed: xml/bin/txt)" << std::endl;
+            << " extension? (allowed: xml/bin/txt/gz)" << std::endl;
       else
         Log::Warn << "Unable to detect type of '" << filename << "'; save "
-            << "failed.  Incorrect extension? (allowed: xml/bin/txt)"
+            << "failed.  Incorrect extension? (allowed: xml/bin/txt/gz)"
             << std::endl;
 
       return false;
@@ -232,7 +332,8 @@ bool Save(const std::string& filename,
   // Open the file to save to.
   std::ofstream ofs;
 #ifdef _WIN32
-  if (f == format::binary) // Open non-text types in binary mode on Windows.
+  // Open non-text types in binary mode on Windows.
+  if (f == format::binary || IsCompressed(f))
     ofs.open(filename, std::ofstream::out | std::ofstream::binary);
   else
     ofs.open(filename, std::ofstream::out);
@@ -269,6 +370,28 @@ bool Save(const std::string& filename,
       boost::archive::binary_oarchive ar(ofs);
       ar << boost::serialization::make_nvp(name.c_str(), t);
     }
+    else if (IsCompressed(f))
+    {
+      // The precision comes first, so that Load() knows how to read the
+      // matrices back.
+      int p = (f == format::compressed_float32) ? precision::float32 :
+          (f == format::compressed_float16) ? precision::float16 :
+          precision::full;
+
+      boost::iostreams::filtering_ostream out;
+      out.push(boost::iostreams::gzip_compressor());
+      out.push(ofs);
+      {
+        boost::archive::binary_oarchive ar(out);
+        ar << boost::serialization::make_nvp("precision", p);
+
+        ScopedPrecision scope((precision) p);
+        ar << boost::serialization::make_nvp(name.c_str(), t);
+      }
+
+      // Flush the compressor and write the gzip trailer.
+      out.reset();
+    }
 
     return true;
   }
@@ -0,0 +1,213 @@
+/**
+ * @file min_max_scaler.hpp
+ *
+ * Definition and implementation of the MinMaxScaler class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SCALER_METHODS_MIN_MAX_SCALER_HPP
+#define MLPACK_CORE_DATA_SCALER_METHODS_MIN_MAX_SCALER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A simple MinMax scaler class.  Each dimension is scaled linearly to the
+ * range [scaleMin, scaleMax], using the smallest and largest values of that
+ * dimension in the data given to Fit().  Dimensions whose values are all equal
+ * are only shifted.
+ *
+ * Fit() and the transformations are parallelized over the points, and the
+ * output of a transformation may be the input itself, in which case the data
+ * is transformed in place.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::mat output;
+ *
+ * // Scale the features to the range [0, 2].
+ * MinMaxScaler scale(0, 2);
+ * scale.Fit(input);
+ * scale.Transform(input, output);
+ *
+ * // Or scale the input itself, without a copy.
+ * scale.Transform(input, input);
+ * @endcode
+ */
+class MinMaxScaler
+{
+ public:
+  /**
+   * Create the scaler for the given range.
+   *
+   * @param min Lower limit of the output range.
+   * @param max Upper limit of the output range.
+   */
+  MinMaxScaler(const double min = 0, const double max = 1) :
+      scaleMin(min),
+      scaleMax(max)
+  {
+    if (scaleMin > scaleMax)
+    {
+      throw std::runtime_error("Range is not valid; the lower limit must not "
+          "be greater than the upper limit.");
+    }
+  }
+
+  /**
+   * Compute the minimum and maximum of each dimension of the given dataset.
+   *
+   * @param input Dataset to fit the scaler to.
+   */
+  template<typename MatType>
+  void Fit(const MatType& input)
+  {
+    #ifdef HAS_OPENMP
+      const size_t numThreads = std::max(std::min(
+          (size_t) omp_get_max_threads(), (size_t) input.n_cols / 1024),
+          (size_t) 1);
+    #else
+      const size_t numThreads = 1;
+    #endif
+
+    // Each thread handles a contiguous block of points.
+    std::vector<arma::vec> mins(numThreads, arma::vec(input.n_rows));
+    std::vector<arma::vec> maxs(numThreads, arma::vec(input.n_rows));
+
+    #pragma omp parallel for schedule(static, 1)
+    for (omp_size_t t = 0; t < (omp_size_t) numThreads; ++t)
+    {
+      arma::vec& tMin = mins[t];
+      arma::vec& tMax = maxs[t];
+      tMin.fill(std::numeric_limits<double>::max());
+      tMax.fill(-std::numeric_limits<double>::max());
+
+      const size_t begin = input.n_cols * t / numThreads;
+      const size_t end = input.n_cols * (t + 1) / numThreads;
+      for (size_t i = begin; i < end; ++i)
+      {
+        for (size_t j = 0; j < input.n_rows; ++j)
+        {
+          const double value = (double) input(j, i);
+          tMin[j] = std::min(tMin[j], value);
+          tMax[j] = std::max(tMax[j], value);
+        }
+      }
+    }
+
+    itemMin = std::move(mins[0]);
+    itemMax = std::move(maxs[0]);
+    for (size_t t = 1; t < numThreads; ++t)
+    {
+      itemMin = arma::min(itemMin, mins[t]);
+      itemMax = arma::max(itemMax, maxs[t]);
+    }
+
+    // Dimensions with a single value would divide by zero.
+    scale = itemMax - itemMin;
+    scale.transform([](double val) { return (val == 0) ? 1 : val; });
+    scale = (scaleMax - scaleMin) / scale;
+    scaleRowMin = scaleMin - itemMin % scale;
+  }
+
+  /**
+   * Scale the given dataset.  The output may be the input.
+   *
+   * @param input Dataset to scale.
+   * @param output Matrix to store the scaled dataset in.
+   */
+  template<typename MatType>
+  void Transform(const MatType& input, MatType& output) const
+  {
+    CheckDimensions(input.n_rows);
+    if (&output != &input)
+      output.copy_size(input);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      for (size_t j = 0; j < input.n_rows; ++j)
+        output(j, i) = input(j, i) * scale[j] + scaleRowMin[j];
+  }
+
+  /**
+   * Undo the scaling of the given dataset.  The output may be the input.
+   *
+   * @param input Scaled dataset.
+   * @param output Matrix to store the original dataset in.
+   */
+  template<typename MatType>
+  void InverseTransform(const MatType& input, MatType& output) const
+  {
+    CheckDimensions(input.n_rows);
+    if (&output != &input)
+      output.copy_size(input);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      for (size_t j = 0; j < input.n_rows; ++j)
+        output(j, i) = (input(j, i) - scaleRowMin[j]) / scale[j];
+  }
+
+  //! Get the minimum of each dimension.
+  const arma::vec& ItemMin() const { return itemMin; }
+  //! Get the maximum of each dimension.
+  const arma::vec& ItemMax() const { return itemMax; }
+  //! Get the scale of each dimension.
+  const arma::vec& Scale() const { return scale; }
+  //! Get the lower limit of the output range.
+  double ScaleMin() const { return scaleMin; }
+  //! Get the upper limit of the output range.
+  double ScaleMax() const { return scaleMax; }
+
+  //! Serialize the scaler.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(itemMin);
+    ar & BOOST_SERIALIZATION_NVP(itemMax);
+    ar & BOOST_SERIALIZATION_NVP(scale);
+    ar & BOOST_SERIALIZATION_NVP(scaleMin);
+    ar & BOOST_SERIALIZATION_NVP(scaleMax);
+    ar & BOOST_SERIALIZATION_NVP(scaleRowMin);
+  }
+
+ private:
+  //! Make sure the scaler was fitted to data of the given dimensionality.
+  void CheckDimensions(const size_t dimensions) const
+  {
+    if (dimensions != scale.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "MinMaxScaler: the data has " << dimensions << " dimensions, but "
+          << "the scaler was fitted to " << scale.n_elem << " dimensions.";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  //! The minimum of each dimension.
+  arma::vec itemMin;
+  //! The maximum of each dimension.
+  arma::vec itemMax;
+  //! The factor each dimension is multiplied by.
+  arma::vec scale;
+  //! The lower limit of the output range.
+  double scaleMin;
+  //! The upper limit of the output range.
+  double scaleMax;
+  //! The offset added to each dimension after it is multiplied.
+  arma::vec scaleRowMin;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file standard_scaler.hpp
+ *
+ * Definition and implementation of the StandardScaler class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SCALER_METHODS_STANDARD_SCALER_HPP
+#define MLPACK_CORE_DATA_SCALER_METHODS_STANDARD_SCALER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/moments.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A simple standard scaler class.  Each dimension is centered on its mean and
+ * divided by its (population) standard deviation, as computed from the data
+ * given to Fit(); dimensions whose values are all equal are only centered.
+ *
+ * Fit() computes the means and standard deviations in a single parallel pass
+ * with ComputeMoments(), and the transformations are parallelized over the
+ * points.  The output of a transformation may be the input itself, in which
+ * case the data is transformed in place.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::mat output;
+ *
+ * StandardScaler scale;
+ * scale.Fit(input);
+ * scale.Transform(input, output);
+ * @endcode
+ */
+class StandardScaler
+{
+ public:
+  /**
+   * Compute the mean and standard deviation of each dimension of the given
+   * dataset.
+   *
+   * @param input Dataset to fit the scaler to.
+   */
+  template<typename eT>
+  void Fit(const arma::Mat<eT>& input)
+  {
+    std::vector<Moments> moments;
+    ComputeMoments(input, moments);
+
+    itemMean.set_size(input.n_rows);
+    itemStdDev.set_size(input.n_rows);
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      itemMean[j] = moments[j].Mean();
+      itemStdDev[j] = moments[j].StdDev(true);
+
+      // Dimensions with a single value would divide by zero.
+      if (itemStdDev[j] == 0)
+        itemStdDev[j] = 1;
+    }
+  }
+
+  /**
+   * Scale the given dataset.  The output may be the input.
+   *
+   * @param input Dataset to scale.
+   * @param output Matrix to store the scaled dataset in.
+   */
+  template<typename MatType>
+  void Transform(const MatType& input, MatType& output) const
+  {
+    CheckDimensions(input.n_rows);
+    if (&output != &input)
+      output.copy_size(input);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      for (size_t j = 0; j < input.n_rows; ++j)
+        output(j, i) = (input(j, i) - itemMean[j]) / itemStdDev[j];
+  }
+
+  /**
+   * Undo the scaling of the given dataset.  The output may be the input.
+   *
+   * @param input Scaled dataset.
+   * @param output Matrix to store the original dataset in.
+   */
+  template<typename MatType>
+  void InverseTransform(const MatType& input, MatType& output) const
+  {
+    CheckDimensions(input.n_rows);
+    if (&output != &input)
+      output.copy_size(input);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      for (size_t j = 0; j < input.n_rows; ++j)
+        output(j, i) = input(j, i) * itemStdDev[j] + itemMean[j];
+  }
+
+  //! Get the mean of each dimension.
+  const arma::vec& ItemMean() const { return itemMean; }
+  //! Get the standard deviation of each dimension.
+  const arma::vec& ItemStdDev() const { return itemStdDev; }
+
+  //! Serialize the scaler.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(itemMean);
+    ar & BOOST_SERIALIZATION_NVP(itemStdDev);
+  }
+
+ private:
+  //! Make sure the scaler was fitted to data of the given dimensionality.
+  void CheckDimensions(const size_t dimensions) const
+  {
+    if (dimensions != itemMean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "StandardScaler: the data has " << dimensions << " dimensions, "
+          << "but the scaler was fitted to " << itemMean.n_elem
+          << " dimensions.";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  //! The mean of each dimension.
+  arma::vec itemMean;
+  //! The standard deviation of each dimension.
+  arma::vec itemStdDev;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -14,9 +14,150 @@
 #define MLPACK_CORE_DATA_SPLIT_DATA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/random.hpp>
+#include "streaming_dataset.hpp"
 
 namespace mlpack {
 namespace data {
+namespace details {
+
+/**
+ * Copy the given columns of the input, in the given order, to the output.  The
+ * columns are copied in parallel.
+ *
+ * @param input Matrix (or row) to copy from.
+ * @param order Indices of the columns to copy.
+ * @param begin Position in order of the first column to copy.
+ * @param count Number of columns to copy.
+ * @param output Matrix (or row) to store the copy in.
+ */
+template<typename MatType>
+void GatherColumns(const MatType& input,
+                   const arma::uvec& order,
+                   const size_t begin,
+                   const size_t count,
+                   MatType& output)
+{
+  output.set_size(input.n_rows, count);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) count; ++i)
+  {
+    const typename MatType::elem_type* column =
+        input.colptr(order[begin + i]);
+    std::copy(column, column + input.n_rows, output.colptr(i));
+  }
+}
+
+/**
+ * Reorder the columns of the given matrix in place, so that column i becomes
+ * the former column order[i].  The permutation is decomposed into cycles, and
+ * every cycle is applied to each block of rows separately, with a buffer of a
+ * single block: so no copy of the matrix is made, and the (cycle, block) pairs
+ * are independent tasks that are run in parallel.
+ *
+ * @param matrix Matrix (or row) to reorder.
+ * @param order Permutation of the column indices.
+ */
+template<typename MatType>
+void PermuteColumns(MatType& matrix, const arma::uvec& order)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Find the first column of every non-trivial cycle.
+  std::vector<char> visited(order.n_elem, 0);
+  std::vector<size_t> cycles;
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    if (visited[i])
+      continue;
+
+    if (order[i] != i)
+      cycles.push_back(i);
+
+    for (size_t j = i; !visited[j]; j = order[j])
+      visited[j] = 1;
+  }
+
+  const size_t rowBlockSize = 64;
+  const size_t rowBlocks = (matrix.n_rows + rowBlockSize - 1) / rowBlockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t task = 0; task < (omp_size_t) (cycles.size() * rowBlocks);
+      ++task)
+  {
+    const size_t start = cycles[task / rowBlocks];
+    const size_t rowBegin = (task % rowBlocks) * rowBlockSize;
+    const size_t rows = std::min(rowBlockSize,
+        (size_t) matrix.n_rows - rowBegin);
+
+    // Each column of the cycle is overwritten by the next one; the first one
+    // is kept in the buffer and goes in the last position.
+    ElemType buffer[rowBlockSize];
+    ElemType* first = matrix.colptr(start) + rowBegin;
+    std::copy(first, first + rows, buffer);
+
+    size_t j = start;
+    while (order[j] != start)
+    {
+      const ElemType* next = matrix.colptr(order[j]) + rowBegin;
+      std::copy(next, next + rows, matrix.colptr(j) + rowBegin);
+      j = order[j];
+    }
+
+    std::copy(buffer, buffer + rows, matrix.colptr(j) + rowBegin);
+  }
+}
+
+/**
+ * Get a random order of the points for a stratified split: the points of each
+ * class are shuffled, and the first testRatio of them (rounded down) go in the
+ * test set.  The training points come first in the returned order, and each of
+ * the two sets is shuffled, so the classes are mixed.
+ *
+ * @param labels Labels of the points.
+ * @param testRatio Percentage of each class to put in the test set.
+ * @param testSize Set to the number of points in the test set.
+ */
+template<typename U>
+arma::uvec StratifiedOrder(const arma::Row<U>& labels,
+                           const double testRatio,
+                           size_t& testSize)
+{
+  // Group the points by class.
+  const arma::uvec byLabel = arma::stable_sort_index(labels);
+
+  std::vector<arma::uword> train, test;
+  size_t begin = 0;
+  while (begin < byLabel.n_elem)
+  {
+    size_t end = begin + 1;
+    while (end < byLabel.n_elem &&
+           labels[byLabel[end]] == labels[byLabel[begin]])
+      ++end;
+
+    const arma::uvec shuffled = arma::shuffle(byLabel.subvec(begin, end - 1));
+    const size_t classTestSize = static_cast<size_t>(shuffled.n_elem *
+        testRatio);
+    for (size_t i = 0; i < shuffled.n_elem; ++i)
+    {
+      if (i < classTestSize)
+        test.push_back(shuffled[i]);
+      else
+        train.push_back(shuffled[i]);
+    }
+
+    begin = end;
+  }
+
+  testSize = test.size();
+  return arma::join_cols(arma::shuffle(arma::uvec(train)),
+      arma::shuffle(arma::uvec(test)));
+}
+
+} // namespace details
+
 /**
  * Given an input dataset and labels, split into a training set and test set.
  * Example usage below.  This overload places the split dataset into the four
@@ -56,26 +197,15 @@ void Split(const arma::Mat<T>& input,
 {
   const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
   const size_t trainSize = input.n_cols - testSize;
-  trainData.set_size(input.n_rows, trainSize);
-  testData.set_size(input.n_rows, testSize);
-  trainLabel.set_size(trainSize);
-  testLabel.set_size(testSize);
 
-  const arma::Col<size_t> order =
-      arma::shuffle(arma::linspace<arma::Col<size_t>>(0, input.n_cols - 1,
-                                                      input.n_cols));
-
-  for (size_t i = 0; i != trainSize; ++i)
-  {
-    trainData.col(i) = input.col(order[i]);
-    trainLabel(i) = inputLabel(order[i]);
-  }
+  const arma::uvec order =
+      arma::shuffle(arma::linspace<arma::uvec>(0, input.n_cols - 1,
+                                               input.n_cols));
 
-  for (size_t i = 0; i != testSize; ++i)
-  {
-    testData.col(i) = input.col(order[i + trainSize]);
-    testLabel(i) = inputLabel(order[i + trainSize]);
-  }
+  details::GatherColumns(input, order, 0, trainSize, trainData);
+  details::GatherColumns(input, order, trainSize, testSize, testData);
+  details::GatherColumns(inputLabel, order, 0, trainSize, trainLabel);
+  details::GatherColumns(inputLabel, order, trainSize, testSize, testLabel);
 }
 
 /**
@@ -107,21 +237,13 @@ void Split(const arma::Mat<T>& input,
 {
   const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
   const size_t trainSize = input.n_cols - testSize;
-  trainData.set_size(input.n_rows, trainSize);
-  testData.set_size(input.n_rows, testSize);
 
-  const arma::Col<size_t> order =
-      arma::shuffle(arma::linspace<arma::Col<size_t>>(0, input.n_cols -1,
-                                                      input.n_cols));
+  const arma::uvec order =
+      arma::shuffle(arma::linspace<arma::uvec>(0, input.n_cols - 1,
+                                               input.n_cols));
 
-  for (size_t i = 0; i != trainSize; ++i)
-  {
-    trainData.col(i) = input.col(order[i]);
-  }
-  for (size_t i = 0; i != testSize; ++i)
-  {
-    testData.col(i) = input.col(order[i + trainSize]);
-  }
+  details::GatherColumns(input, order, 0, trainSize, trainData);
+  details::GatherColumns(input, order, trainSize, testSize, testData);
 }
 
 /**
@@ -192,6 +314,239 @@ Split(const arma::Mat<T>& input,
                          std::move(testData));
 }
 
+/**
+ * Given an input dataset and labels, split into a training set and test set
+ * that hold the same proportion of every class: testRatio of the points of
+ * each class (rounded down) are put in the test set.  Both sets are shuffled.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> label = loadLabel();
+ * arma::mat trainData, testData;
+ * arma::Row<size_t> trainLabel, testLabel;
+ *
+ * StratifiedSplit(input, label, trainData, testData, trainLabel, testLabel,
+ *     0.3);
+ * @endcode
+ *
+ * @param input Input dataset to split.
+ * @param label Input labels to split.
+ * @param trainData Matrix to store training data into.
+ * @param testData Matrix to store test data into.
+ * @param trainLabel Vector to store training labels into.
+ * @param testLabel Vector to store test labels into.
+ * @param testRatio Percentage of each class to use for the test set (between 0
+ *     and 1).
+ */
+template<typename T, typename U>
+void StratifiedSplit(const arma::Mat<T>& input,
+                     const arma::Row<U>& inputLabel,
+                     arma::Mat<T>& trainData,
+                     arma::Mat<T>& testData,
+                     arma::Row<U>& trainLabel,
+                     arma::Row<U>& testLabel,
+                     const double testRatio)
+{
+  size_t testSize;
+  const arma::uvec order = details::StratifiedOrder(inputLabel, testRatio,
+      testSize);
+  const size_t trainSize = input.n_cols - testSize;
+
+  details::GatherColumns(input, order, 0, trainSize, trainData);
+  details::GatherColumns(input, order, trainSize, testSize, testData);
+  details::GatherColumns(inputLabel, order, 0, trainSize, trainLabel);
+  details::GatherColumns(inputLabel, order, trainSize, testSize, testLabel);
+}
+
+/**
+ * Given an input dataset, split into a training set and test set without
+ * copying it.  The columns of the input are shuffled in place, and trainData
+ * and testData are made aliases of the first and last columns of the input;
+ * so the input must not be resized or destroyed while they are in use, and
+ * modifying them modifies the input.  This takes no more memory than the
+ * dataset itself, which is the way to split datasets that only fit in memory
+ * once.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::mat trainData, testData;
+ * InPlaceSplit(input, trainData, testData, 0.3);
+ * @endcode
+ *
+ * @param input Input dataset to split; its columns are reordered.
+ * @param trainData Matrix to make an alias of the training data.
+ * @param testData Matrix to make an alias of the test data.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ */
+template<typename T>
+void InPlaceSplit(arma::Mat<T>& input,
+                  arma::Mat<T>& trainData,
+                  arma::Mat<T>& testData,
+                  const double testRatio)
+{
+  const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
+  const size_t trainSize = input.n_cols - testSize;
+
+  const arma::uvec order =
+      arma::shuffle(arma::linspace<arma::uvec>(0, input.n_cols - 1,
+                                               input.n_cols));
+  details::PermuteColumns(input, order);
+
+  math::MakeAlias(trainData, input.memptr(), input.n_rows, trainSize, false);
+  math::MakeAlias(testData, input.memptr() + trainSize * input.n_rows,
+      input.n_rows, testSize, false);
+}
+
+/**
+ * Given an input dataset and labels, split into a training set and test set
+ * without copying them, as with InPlaceSplit() above.  The columns of the
+ * input and the labels are shuffled in place, and the four outputs are made
+ * aliases of the parts of the input and labels.  If stratify is true, the
+ * split keeps the proportion of every class in both sets, as with
+ * StratifiedSplit().
+ *
+ * @param input Input dataset to split; its columns are reordered.
+ * @param inputLabel Input labels to split; they are reordered.
+ * @param trainData Matrix to make an alias of the training data.
+ * @param testData Matrix to make an alias of the test data.
+ * @param trainLabel Vector to make an alias of the training labels.
+ * @param testLabel Vector to make an alias of the test labels.
+ * @param testRatio Percentage of dataset (or of each class, if stratify is
+ *     true) to use for test set (between 0 and 1).
+ * @param stratify Whether to keep the proportion of every class.
+ */
+template<typename T, typename U>
+void InPlaceSplit(arma::Mat<T>& input,
+                  arma::Row<U>& inputLabel,
+                  arma::Mat<T>& trainData,
+                  arma::Mat<T>& testData,
+                  arma::Row<U>& trainLabel,
+                  arma::Row<U>& testLabel,
+                  const double testRatio,
+                  const bool stratify = false)
+{
+  size_t testSize;
+  arma::uvec order;
+  if (stratify)
+  {
+    order = details::StratifiedOrder(inputLabel, testRatio, testSize);
+  }
+  else
+  {
+    testSize = static_cast<size_t>(input.n_cols * testRatio);
+    order = arma::shuffle(arma::linspace<arma::uvec>(0, input.n_cols - 1,
+        input.n_cols));
+  }
+  const size_t trainSize = input.n_cols - testSize;
+
+  details::PermuteColumns(input, order);
+  details::PermuteColumns(inputLabel, order);
+
+  math::MakeAlias(trainData, input.memptr(), input.n_rows, trainSize, false);
+  math::MakeAlias(testData, input.memptr() + trainSize * input.n_rows,
+      input.n_rows, testSize, false);
+  math::MakeAlias(trainLabel, inputLabel.memptr(), trainSize, false);
+  math::MakeAlias(testLabel, inputLabel.memptr() + trainSize, testSize, false);
+}
+
+/**
+ * Split a dataset stored on disk into a training set and a test set that are
+ * written to disk, without ever holding more than two chunks of the dataset in
+ * memory.  The points are read in order, and each one is put in the test set
+ * with probability (test points still needed) / (points left) (selection
+ * sampling), so that the test set is a uniformly random subset of exactly
+ * testRatio of the points (rounded down).  The points keep their order in both
+ * sets; unlike with Split(), they are not shuffled.
+ *
+ * Both outputs are written in Armadillo binary format, so they can be split or
+ * streamed again.  Throws std::runtime_error if an output file can't be
+ * written.
+ *
+ * @param input Dataset to split.
+ * @param trainingFile File to write the training set to.
+ * @param testFile File to write the test set to.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @return Indices of the points put in the test set, in increasing order; for
+ *     instance, to split the labels.
+ */
+template<typename eT>
+arma::uvec StreamingSplit(StreamingDataset<eT>& input,
+                          const std::string& trainingFile,
+                          const std::string& testFile,
+                          const double testRatio)
+{
+  const size_t numCols = input.NumCols();
+  const size_t testSize = static_cast<size_t>(numCols * testRatio);
+  const size_t trainSize = numCols - testSize;
+
+  std::ofstream training(trainingFile.c_str(),
+      std::ios::out | std::ios::binary);
+  std::ofstream test(testFile.c_str(), std::ios::out | std::ios::binary);
+  if (!training.is_open() || !test.is_open())
+  {
+    std::ostringstream oss;
+    oss << "StreamingSplit(): cannot open '"
+        << (training.is_open() ? testFile : trainingFile) << "' for writing!";
+    throw std::runtime_error(oss.str());
+  }
+
+  // This is the header that Armadillo writes for arma_binary.
+  const std::string header = arma::diskio::gen_bin_header(arma::Mat<eT>());
+  training << header << '\n' << input.NumRows() << ' ' << trainSize << '\n';
+  test << header << '\n' << input.NumRows() << ' ' << testSize << '\n';
+
+  arma::uvec testIndices(testSize);
+  size_t numTest = 0;
+
+  arma::Mat<eT> chunk, part;
+  std::vector<arma::uword> trainCols, testCols;
+  for (size_t c = 0; c < input.NumChunks(); ++c)
+  {
+    input.Chunk(c, c + 1, chunk);
+    const size_t offset = c * input.ChunkSize();
+
+    trainCols.clear();
+    testCols.clear();
+    for (size_t i = 0; i < chunk.n_cols; ++i)
+    {
+      const size_t left = numCols - (offset + i);
+      if (math::Random() * left < testSize - numTest)
+      {
+        testCols.push_back(i);
+        testIndices[numTest++] = offset + i;
+      }
+      else
+      {
+        trainCols.push_back(i);
+      }
+    }
+
+    if (!trainCols.empty())
+    {
+      part = chunk.cols(arma::uvec(trainCols));
+      training.write(reinterpret_cast<const char*>(part.memptr()),
+          std::streamsize(part.n_elem * sizeof(eT)));
+    }
+
+    if (!testCols.empty())
+    {
+      part = chunk.cols(arma::uvec(testCols));
+      test.write(reinterpret_cast<const char*>(part.memptr()),
+          std::streamsize(part.n_elem * sizeof(eT)));
+    }
+  }
+
+  if (!training.good() || !test.good())
+  {
+    std::ostringstream oss;
+    oss << "StreamingSplit(): unable to write '"
+        << (training.good() ? testFile : trainingFile) << "'!";
+    throw std::runtime_error(oss.str());
+  }
+
+  return testIndices;
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -0,0 +1,130 @@
+/**
+ * @file streaming_dataset.hpp
+ *
+ * Read a dataset from disk in blocks of columns, so that algorithms can train
+ * on datasets that do not fit in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STREAMING_DATASET_HPP
+#define MLPACK_CORE_DATA_STREAMING_DATASET_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "extension.hpp"
+#include "hdf5_dataset.hpp"
+
+#include <fstream>
+#include <future>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * StreamingDataset gives access to a matrix stored on disk in Armadillo binary
+ * format (arma::arma_binary) one chunk of columns at a time.  Since Armadillo
+ * stores matrices in column-major order, each chunk is one contiguous read.
+ * Files in the right layout can be written with
+ * data::Save("file.bin", matrix, true, false) (that is, without transposing),
+ * or with matrix.save("file.bin", arma::arma_binary).
+ *
+ * If Armadillo was built with HDF5 support, HDF5 files (.h5, .hdf5, .hdf or
+ * .he5) in the same layout can be streamed too; each chunk is then read by
+ * HDF5Dataset as one hyperslab.  If the HDF5 dataset is stored in chunks, the
+ * chunk size is rounded up to a multiple of the number of columns of each HDF5
+ * chunk, so that no HDF5 chunk has to be read and decompressed twice.
+ *
+ * Chunks are double-buffered: when a chunk is requested, the chunk that will be
+ * needed next is read on a background thread, so that disk access overlaps
+ * with computation.  At most two chunks are held in memory at any time.
+ *
+ * @code
+ * data::StreamingDataset<> dataset("points.bin", 100000);
+ * arma::mat chunk;
+ * for (size_t i = 0; i < dataset.NumChunks(); ++i)
+ * {
+ *   dataset.Chunk(i, (i + 1) % dataset.NumChunks(), chunk);
+ *   // Work with chunk...
+ * }
+ * @endcode
+ *
+ * @tparam eT Element type of the stored matrix.
+ */
+template<typename eT = double>
+class StreamingDataset
+{
+ public:
+  /**
+   * Open the given file and read its header.  Throws std::runtime_error if the
+   * file cannot be opened or is not an Armadillo binary file of the right
+   * element type (or a readable HDF5 file, given an HDF5 extension).
+   *
+   * @param filename File to read.
+   * @param chunkSize Number of columns in each chunk (see above for HDF5
+   *     files).
+   */
+  StreamingDataset(const std::string& filename, const size_t chunkSize);
+
+  //! Wait for any outstanding read to finish.
+  ~StreamingDataset();
+
+  /**
+   * Get the given chunk, and start reading the next one in the background.
+   * The chunk that was read ahead is used if it is the requested one;
+   * otherwise the chunk is read synchronously.
+   *
+   * @param index Index of the chunk to get.
+   * @param nextIndex Index of the chunk to read ahead.
+   * @param chunk Matrix to store the chunk in.
+   */
+  void Chunk(const size_t index, const size_t nextIndex, arma::Mat<eT>& chunk);
+
+  //! Get the number of rows of the stored matrix.
+  size_t NumRows() const { return numRows; }
+  //! Get the number of columns of the stored matrix.
+  size_t NumCols() const { return numCols; }
+  //! Get the number of columns in each chunk (the last one may be smaller).
+  size_t ChunkSize() const { return chunkSize; }
+  //! Get the number of chunks.
+  size_t NumChunks() const { return (numCols + chunkSize - 1) / chunkSize; }
+
+ private:
+  //! Read the given chunk from the file into the given matrix.
+  void Read(const size_t index, arma::Mat<eT>& chunk);
+
+  //! The name of the file.
+  std::string filename;
+  //! The open file.
+  std::ifstream stream;
+  //! Position of the first element in the file.
+  std::streamoff dataOffset;
+  //! Number of rows of the stored matrix.
+  size_t numRows;
+  //! Number of columns of the stored matrix.
+  size_t numCols;
+  //! Number of columns in each chunk.
+  size_t chunkSize;
+
+  //! The chunk being read ahead.
+  arma::Mat<eT> nextChunk;
+  //! Index of the chunk being read ahead.
+  size_t nextChunkIndex;
+  //! Result of the background read, if any.
+  std::future<void> pending;
+
+#ifdef ARMA_USE_HDF5
+  //! The open HDF5 dataset, if the file is an HDF5 file.
+  std::unique_ptr<HDF5Dataset<eT>> hdf5;
+#endif
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_dataset_impl.hpp"
+
+#endif
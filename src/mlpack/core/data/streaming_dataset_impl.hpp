@@ -0,0 +1,169 @@
+/**
+ * @file streaming_dataset_impl.hpp
+ *
+ * Implementation of StreamingDataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STREAMING_DATASET_IMPL_HPP
+#define MLPACK_CORE_DATA_STREAMING_DATASET_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_dataset.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+StreamingDataset<eT>::StreamingDataset(const std::string& filename,
+                                       const size_t chunkSize) :
+    filename(filename),
+    stream(filename.c_str(), std::ios::in | std::ios::binary),
+    dataOffset(0),
+    numRows(0),
+    numCols(0),
+    chunkSize(chunkSize),
+    nextChunkIndex(0)
+{
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'. " << std::endl;
+    throw std::runtime_error(oss.str());
+  }
+
+  if (chunkSize == 0)
+  {
+    throw std::invalid_argument("StreamingDataset::StreamingDataset(): "
+        "chunkSize must be greater than 0!");
+  }
+
+  const std::string extension = Extension(filename);
+  if (extension == "h5" || extension == "hdf5" || extension == "hdf" ||
+      extension == "he5")
+  {
+#ifdef ARMA_USE_HDF5
+    hdf5.reset(new HDF5Dataset<eT>(filename));
+    numRows = hdf5->NumRows();
+    numCols = hdf5->NumCols();
+
+    // Align the chunks to the chunks of the HDF5 dataset.
+    if (hdf5->Chunked() && chunkSize % hdf5->ChunkCols() != 0)
+    {
+      this->chunkSize = (chunkSize / hdf5->ChunkCols() + 1) *
+          hdf5->ChunkCols();
+    }
+
+    return;
+#else
+    std::ostringstream oss;
+    oss << "StreamingDataset::StreamingDataset(): cannot read '" << filename
+        << "' as HDF5 data, because Armadillo was compiled without HDF5 "
+        << "support!";
+    throw std::runtime_error(oss.str());
+#endif
+  }
+
+  // The header is the same one that Armadillo writes for arma_binary.
+  const std::string expectedHeader =
+      arma::diskio::gen_bin_header(arma::Mat<eT>());
+  std::string header;
+  stream >> header;
+  stream >> numRows;
+  stream >> numCols;
+  // Skip the single newline that ends the header.
+  stream.get();
+
+  if (!stream.good() || header != expectedHeader)
+  {
+    std::ostringstream oss;
+    oss << "StreamingDataset::StreamingDataset(): '" << filename << "' is not "
+        << "an Armadillo binary file with header '" << expectedHeader << "'!";
+    throw std::runtime_error(oss.str());
+  }
+
+  dataOffset = stream.tellg();
+}
+
+template<typename eT>
+StreamingDataset<eT>::~StreamingDataset()
+{
+  if (pending.valid())
+    pending.wait();
+}
+
+template<typename eT>
+void StreamingDataset<eT>::Chunk(const size_t index,
+                                 const size_t nextIndex,
+                                 arma::Mat<eT>& chunk)
+{
+  if (pending.valid())
+  {
+    // Propagate any exception from the background read.
+    pending.get();
+    if (nextChunkIndex == index)
+      chunk.swap(nextChunk);
+    else
+      Read(index, chunk);
+  }
+  else
+  {
+    Read(index, chunk);
+  }
+
+  // Start reading the next chunk.  The stream and nextChunk are only used by
+  // the background thread until pending.get() is called.
+  if (nextIndex < NumChunks())
+  {
+    nextChunkIndex = nextIndex;
+    pending = std::async(std::launch::async, [this, nextIndex]()
+    {
+      Read(nextIndex, nextChunk);
+    });
+  }
+}
+
+template<typename eT>
+void StreamingDataset<eT>::Read(const size_t index, arma::Mat<eT>& chunk)
+{
+  if (index >= NumChunks())
+  {
+    std::ostringstream oss;
+    oss << "StreamingDataset::Chunk(): chunk index " << index << " is out of "
+        << "range; there are only " << NumChunks() << " chunks!";
+    throw std::out_of_range(oss.str());
+  }
+
+  const size_t begin = index * chunkSize;
+  const size_t cols = std::min(chunkSize, numCols - begin);
+
+#ifdef ARMA_USE_HDF5
+  if (hdf5)
+  {
+    hdf5->Read(begin, cols, chunk);
+    return;
+  }
+#endif
+
+  chunk.set_size(numRows, cols);
+  stream.clear();
+  stream.seekg(dataOffset + std::streamoff(begin * numRows * sizeof(eT)));
+  stream.read(reinterpret_cast<char*>(chunk.memptr()),
+      std::streamsize(chunk.n_elem * sizeof(eT)));
+
+  if (!stream.good())
+  {
+    std::ostringstream oss;
+    oss << "StreamingDataset::Chunk(): unable to read chunk " << index
+        << " from '" << filename << "'!";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
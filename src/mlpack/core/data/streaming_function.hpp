@@ -0,0 +1,196 @@
+/**
+ * @file streaming_function.hpp
+ *
+ * Wrap a decomposable function so that its data is read from disk one chunk at
+ * a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STREAMING_FUNCTION_HPP
+#define MLPACK_CORE_DATA_STREAMING_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
+
+#include "streaming_dataset.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * ChunkSetter is used by StreamingFunction to replace the data held by the
+ * wrapped function with a new chunk.  The default implementation works with
+ * any function that exposes modifiable Predictors() and Responses() (such as
+ * ann::FFN).  Functions that need more work when their data changes provide a
+ * specialization next to their definition.
+ *
+ * A ChunkSetter is constructed once from the wrapped function, before any
+ * chunk is set, so it may remember settings that need to be adapted to the
+ * size of each chunk.
+ */
+template<typename FunctionType>
+class ChunkSetter
+{
+ public:
+  ChunkSetter(const FunctionType& /* function */) { }
+
+  /**
+   * Give the chunk to the function.
+   *
+   * @param function Function to modify.
+   * @param predictors Predictors of the chunk.
+   * @param responses Responses of the chunk.
+   * @param numPoints Total number of points in the dataset.
+   */
+  template<typename PredictorsType, typename ResponsesType>
+  void Set(FunctionType& function,
+           PredictorsType&& predictors,
+           ResponsesType&& responses,
+           const size_t /* numPoints */)
+  {
+    // Don't overwrite memory the function may be aliasing.
+    math::ClearAlias(function.Predictors());
+    math::ClearAlias(function.Responses());
+
+    function.Predictors() = std::move(predictors);
+    function.Responses() = std::move(responses);
+  }
+};
+
+/**
+ * StreamingFunction presents a dataset that is stored on disk as a
+ * decomposable function, so that it can be optimized with SGD-type optimizers
+ * while only holding a bounded number of points in memory.  Predictors and
+ * responses are read through two StreamingDataset objects, which must have the
+ * same number of columns and the same chunk size; at most two chunks of each
+ * (the current one and the one being read ahead) are in memory at once.
+ *
+ * Whenever Evaluate() or Gradient() is called for points outside of the current
+ * chunk, the chunk holding those points is handed to the wrapped function (see
+ * ChunkSetter) and the call is forwarded with indices relative to the chunk.
+ * For results identical to in-memory training, the chunk size should be a
+ * multiple of the optimizer's batch size; otherwise batches that span two
+ * chunks are split in two.
+ *
+ * Shuffle() visits the chunks in a random order, and shuffles the points
+ * inside each chunk with the wrapped function's Shuffle().
+ *
+ * @code
+ * data::StreamingDataset<> predictors("predictors.bin", 50000);
+ * data::StreamingDataset<size_t> responses("responses.bin", 50000);
+ *
+ * regression::LogisticRegressionFunction<> lrf(arma::mat(), arma::Row<size_t>(),
+ *     0.01);
+ * data::StreamingFunction<regression::LogisticRegressionFunction<>, double,
+ *     size_t> f(lrf, predictors, responses);
+ *
+ * arma::mat coordinates(1, predictors.NumRows() + 1, arma::fill::zeros);
+ * optimization::StandardSGD sgd(0.01, 32);
+ * sgd.Optimize(f, coordinates);
+ * @endcode
+ *
+ * Optimizers call the wrapped function with the coordinates they are given, so
+ * for functions that keep their parameters internally (like ann::FFN), pass
+ * the function's own parameters (e.g. network.Parameters()) to Optimize().
+ *
+ * @tparam FunctionType Type of wrapped decomposable function.
+ * @tparam PredictorElemType Element type of the predictors on disk.
+ * @tparam ResponseElemType Element type of the responses on disk.
+ */
+template<typename FunctionType,
+         typename PredictorElemType = double,
+         typename ResponseElemType = double>
+class StreamingFunction
+{
+ public:
+  /**
+   * Wrap the given function.  The function and datasets are used by reference
+   * and must outlive this object.
+   *
+   * @param function Function to wrap.
+   * @param predictors Predictors on disk.
+   * @param responses Responses on disk.
+   */
+  StreamingFunction(FunctionType& function,
+                    StreamingDataset<PredictorElemType>& predictors,
+                    StreamingDataset<ResponseElemType>& responses);
+
+  //! Return the total number of points in the dataset.
+  size_t NumFunctions() const { return predictors.NumCols(); }
+
+  //! Visit the chunks, and the points in each chunk, in a random order.
+  void Shuffle();
+
+  /**
+   * Evaluate the wrapped function on the given points.
+   *
+   * @param coordinates Coordinates to evaluate at.
+   * @param begin Index of the first point.
+   * @param batchSize Number of points.
+   */
+  double Evaluate(const arma::mat& coordinates,
+                  const size_t begin,
+                  const size_t batchSize);
+
+  /**
+   * Compute the gradient of the wrapped function on the given points.
+   *
+   * @param coordinates Coordinates to evaluate at.
+   * @param begin Index of the first point.
+   * @param gradient Matrix to store the gradient in.
+   * @param batchSize Number of points.
+   */
+  void Gradient(const arma::mat& coordinates,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
+  //! Get the wrapped function.
+  const FunctionType& Function() const { return function; }
+  //! Modify the wrapped function.
+  FunctionType& Function() { return function; }
+
+ private:
+  //! Compute the index of the first point of each chunk, in the visit order.
+  void ComputeOffsets();
+
+  /**
+   * Make sure the chunk holding the given point is loaded, and return the
+   * position of the point within the chunk.
+   *
+   * @param point Index of the point, in the visit order.
+   * @param available Set to the number of points of the chunk from that point
+   *     on.
+   */
+  size_t Prepare(const size_t point, size_t& available);
+
+  //! The wrapped function.
+  FunctionType& function;
+  //! The predictors on disk.
+  StreamingDataset<PredictorElemType>& predictors;
+  //! The responses on disk.
+  StreamingDataset<ResponseElemType>& responses;
+  //! Object used to hand chunks to the function.
+  ChunkSetter<FunctionType> setter;
+
+  //! Order in which the chunks are visited.
+  arma::Col<size_t> order;
+  //! Index of the first point of each chunk (in order), and the number of
+  //! points at the end.
+  arma::Col<size_t> offsets;
+  //! Position (in order) of the currently loaded chunk.
+  size_t current;
+  //! Whether the points of each chunk should be shuffled.
+  bool shuffle;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_function_impl.hpp"
+
+#endif
@@ -0,0 +1,164 @@
+/**
+ * @file streaming_function_impl.hpp
+ *
+ * Implementation of StreamingFunction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STREAMING_FUNCTION_IMPL_HPP
+#define MLPACK_CORE_DATA_STREAMING_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_function.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename FunctionType,
+         typename PredictorElemType,
+         typename ResponseElemType>
+StreamingFunction<FunctionType, PredictorElemType, ResponseElemType>::
+StreamingFunction(FunctionType& function,
+                  StreamingDataset<PredictorElemType>& predictors,
+                  StreamingDataset<ResponseElemType>& responses) :
+    function(function),
+    predictors(predictors),
+    responses(responses),
+    setter(function),
+    order(arma::linspace<arma::Col<size_t>>(0, predictors.NumChunks() - 1,
+        predictors.NumChunks())),
+    current(predictors.NumChunks()),
+    shuffle(false)
+{
+  if (predictors.NumCols() != responses.NumCols() ||
+      predictors.ChunkSize() != responses.ChunkSize())
+  {
+    throw std::invalid_argument("StreamingFunction::StreamingFunction(): "
+        "predictors and responses must have the same number of columns and "
+        "the same chunk size!");
+  }
+
+  ComputeOffsets();
+}
+
+template<typename FunctionType,
+         typename PredictorElemType,
+         typename ResponseElemType>
+void StreamingFunction<FunctionType, PredictorElemType, ResponseElemType>::
+Shuffle()
+{
+  order = arma::shuffle(order);
+  shuffle = true;
+  ComputeOffsets();
+
+  // Force the first chunk of the new order to be loaded (and shuffled).
+  current = order.n_elem;
+}
+
+template<typename FunctionType,
+         typename PredictorElemType,
+         typename ResponseElemType>
+double StreamingFunction<FunctionType, PredictorElemType, ResponseElemType>::
+Evaluate(const arma::mat& coordinates,
+         const size_t begin,
+         const size_t batchSize)
+{
+  double objective = 0.0;
+  size_t done = 0;
+  while (done < batchSize)
+  {
+    size_t available;
+    const size_t offset = Prepare(begin + done, available);
+    const size_t count = std::min(batchSize - done, available);
+    objective += function.Evaluate(coordinates, offset, count);
+    done += count;
+  }
+
+  return objective;
+}
+
+template<typename FunctionType,
+         typename PredictorElemType,
+         typename ResponseElemType>
+void StreamingFunction<FunctionType, PredictorElemType, ResponseElemType>::
+Gradient(const arma::mat& coordinates,
+         const size_t begin,
+         arma::mat& gradient,
+         const size_t batchSize)
+{
+  size_t done = 0;
+  arma::mat partialGradient;
+  while (done < batchSize)
+  {
+    size_t available;
+    const size_t offset = Prepare(begin + done, available);
+    const size_t count = std::min(batchSize - done, available);
+
+    if (done == 0)
+    {
+      function.Gradient(coordinates, offset, gradient, count);
+    }
+    else
+    {
+      function.Gradient(coordinates, offset, partialGradient, count);
+      gradient += partialGradient;
+    }
+    done += count;
+  }
+}
+
+template<typename FunctionType,
+         typename PredictorElemType,
+         typename ResponseElemType>
+void StreamingFunction<FunctionType, PredictorElemType, ResponseElemType>::
+ComputeOffsets()
+{
+  // Only the last chunk of the dataset may be shorter than the others, but it
+  // can be visited at any position.
+  offsets.set_size(order.n_elem + 1);
+  offsets[0] = 0;
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    const size_t start = order[i] * predictors.ChunkSize();
+    offsets[i + 1] = offsets[i] + std::min(predictors.ChunkSize(),
+        predictors.NumCols() - start);
+  }
+}
+
+template<typename FunctionType,
+         typename PredictorElemType,
+         typename ResponseElemType>
+size_t StreamingFunction<FunctionType, PredictorElemType, ResponseElemType>::
+Prepare(const size_t point, size_t& available)
+{
+  // Find the last chunk that starts at or before the point.
+  const size_t position = std::upper_bound(offsets.begin(), offsets.end(),
+      point) - offsets.begin() - 1;
+  if (position != current)
+  {
+    const size_t next = (position + 1) % order.n_elem;
+
+    arma::Mat<PredictorElemType> predictorChunk;
+    arma::Mat<ResponseElemType> responseChunk;
+    predictors.Chunk(order[position], order[next], predictorChunk);
+    responses.Chunk(order[position], order[next], responseChunk);
+
+    setter.Set(function, std::move(predictorChunk), std::move(responseChunk),
+        predictors.NumCols());
+    if (shuffle)
+      function.Shuffle();
+
+    current = position;
+  }
+
+  available = offsets[position + 1] - point;
+  return point - offsets[position];
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
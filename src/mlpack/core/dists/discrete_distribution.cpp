@@ -49,6 +49,44 @@ arma::vec DiscreteDistribution::Random() const
   return result;
 }
 
+/**
+ * Calculate the probability of each of the given observations.
+ */
+void DiscreteDistribution::Probability(const arma::mat& x,
+                                       arma::vec& probabilities) const
+{
+  // Ensure the observations have the same dimension as the probabilities.
+  if (x.n_rows != this->probabilities.size())
+  {
+    Log::Fatal << "DiscreteDistribution::Probability(): observations have "
+        << "incorrect dimension " << x.n_rows << " but should have dimension "
+        << this->probabilities.size() << "!" << std::endl;
+  }
+
+  // Each dimension multiplies its probabilities into the result, so that only
+  // one table is read at a time.
+  probabilities.ones(x.n_cols);
+  for (size_t dimension = 0; dimension < x.n_rows; dimension++)
+  {
+    const arma::vec& table = this->probabilities[dimension];
+    for (size_t i = 0; i < x.n_cols; i++)
+    {
+      // Adding 0.5 helps ensure that we cast the floating point to a size_t
+      // correctly.
+      const size_t obs = size_t(x(dimension, i) + 0.5);
+
+      // Ensure that the observation is within the bounds.
+      if (obs >= table.n_elem)
+      {
+        Log::Fatal << "DiscreteDistribution::Probability(): received "
+            << "observation " << obs << "; observation must be in [0, "
+            << table.n_elem << "] for this distribution." << std::endl;
+      }
+      probabilities[i] *= table[obs];
+    }
+  }
+}
+
 /**
  * Estimate the probability distribution directly from the given observations.
  */
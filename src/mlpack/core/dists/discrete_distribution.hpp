@@ -168,6 +168,32 @@ class DiscreteDistribution
     return log(Probability(observation));
   }
 
+  /**
+   * Calculate the probability of each of the given observations (one per
+   * column).  This is much faster than calling Probability() on each
+   * observation, since the dimension and the bounds of each observation are
+   * checked in one pass over the data.  HMMs use this to compute all of their
+   * emission probabilities for a sequence at once.
+   *
+   * @param x List of observations.
+   * @param probabilities Output probabilities for each input observation.
+   */
+  void Probability(const arma::mat& x, arma::vec& probabilities) const;
+
+  /**
+   * Calculate the log probability of each of the given observations (one per
+   * column).
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   */
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const
+  {
+    Probability(x, logProbabilities);
+    logProbabilities = arma::log(logProbabilities);
+  }
+
   /**
    * Return a randomly generated observation (one-dimensional vector; one
    * observation) according to the probability distribution defined by this
@@ -176,23 +176,33 @@ inline void GaussianDistribution::LogProbability(
     const arma::mat& x,
     arma::vec& logProbabilities) const
 {
-  // Column i of 'diffs' is the difference between x.col(i) and the mean.
-  arma::mat diffs = x - (mean * arma::ones<arma::rowvec>(x.n_cols));
-
-  // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1 *
-  // diffs).  We just don't need any of the other elements.  We can calculate
-  // the right hand part of the equation (instead of the left side) so that
-  // later we are referencing columns, not rows -- that is faster.
-  const arma::mat rhs = -0.5 * invCov * diffs;
-  arma::vec logExponents(diffs.n_cols); // We will now fill this.
-  for (size_t i = 0; i < diffs.n_cols; i++)
-    logExponents(i) = accu(diffs.unsafe_col(i) % rhs.unsafe_col(i));
-
+  // The Mahalanobis distance of x to the mean is ||L^-1 (x - mean)||^2, where L
+  // is the (cached) lower Cholesky factor of the covariance.  One triangular
+  // solve for a block of points is half the work of multiplying the block by
+  // the inverse covariance, and we only need the column norms of the result.
+  // Blocks of points are processed in parallel.
   const size_t k = x.n_rows;
+  const double logConstant = -0.5 * k * log2pi - 0.5 * logDetCov;
 
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
-}
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (x.n_cols + blockSize - 1) / blockSize;
+  logProbabilities.set_size(x.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) x.n_cols) - 1;
 
+    // Column i of 'diffs' is the difference between x.col(i) and the mean.
+    arma::mat diffs = x.cols(begin, end);
+    diffs.each_col() -= mean;
+
+    const arma::mat whitened = arma::solve(arma::trimatl(covLower), diffs);
+    logProbabilities.subvec(begin, end) = logConstant -
+        0.5 * arma::sum(arma::square(whitened), 0).t();
+  }
+}
 
 } // namespace distribution
 } // namespace mlpack
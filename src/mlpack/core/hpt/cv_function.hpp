@@ -13,6 +13,7 @@
 #define MLPACK_CORE_HPT_CV_FUNCTION_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/cv/k_fold_cv.hpp>
 
 namespace mlpack {
 namespace hpt {
@@ -118,6 +119,19 @@ class CVFunction
   //! Minimum absolute increase of arguments for calculation of gradient.
   double minDelta;
 
+  /**
+   * Let KFoldCV abandon a configuration once it is known to be worse than the
+   * best objective so far.  Other cross-validation strategies evaluate every
+   * configuration completely.
+   */
+  template<typename CVClass>
+  static void SetBound(CVClass& /* cv */, const double /* bound */) { }
+
+  template<typename M, typename Me, typename Ma, typename P, typename W>
+  static void SetBound(mlpack::cv::KFoldCV<M, Me, Ma, P, W>& cv,
+                       const double bound)
+  { cv.Bound() = bound; }
+
   /**
    * Collect all arguments and run cross-validation.
    */
@@ -115,6 +115,7 @@ double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& /* parameters */,
     const Args&... args)
 {
+  SetBound(cv, bestObjective);
   double objective = cv.Evaluate(args...);
 
   // Change the best model if we have got a better score, or if we probably
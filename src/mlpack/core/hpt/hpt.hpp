@@ -67,6 +67,23 @@ namespace hpt {
  *     Fixed(useCholesky), lambda1Set, lambda2Set);
  * @endcode
  *
+ * With KFoldCV, the search can be made faster by evaluating the folds in
+ * parallel, and by abandoning each configuration whose first folds are already
+ * worse than the best configuration found so far.
+ *
+ * @code
+ * HyperParameterTuner<LARS, MSE, KFoldCV> hpt3(10, data, responses);
+ * hpt3.CV().Parallel() = true;
+ * // Only go on with the other eight folds when the first two look promising.
+ * hpt3.CV().MinFolds() = 2;
+ * std::tie(bestLambda1, bestLambda2) = hpt3.Optimize(Fixed(transposeData),
+ *     Fixed(useCholesky), lambda1Set, lambda2Set);
+ * @endcode
+ *
+ * Abandoning configurations early only makes sense with GridSearch: the
+ * objective of an abandoned configuration is the mean of its first folds, which
+ * would distort the numerical gradients used by GradientDescent.
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam CV A cross-validation strategy used to assess a set of
@@ -205,6 +222,12 @@ class HyperParameterTuner
       CV<MLAlgorithm, Negated<Metric>, MatType, PredictionsType,
           WeightsType>>::type;
 
+ public:
+  //! Access and modify the cross-validation object, e.g. to evaluate the folds
+  //! of KFoldCV in parallel or to let it abandon bad configurations early.
+  CVType& CV() { return cv; }
+
+ private:
 
   //! The cross-validation object for assessing sets of hyper-parameters.
   CVType cv;
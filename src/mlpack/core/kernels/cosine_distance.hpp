@@ -56,6 +56,9 @@ class KernelTraits<CosineDistance>
 
   //! The cosine kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+
+  //! The cosine kernel doesn't only depend on the distance between the points.
+  static const bool IsRadial = false;
 };
 
 } // namespace kernel
@@ -111,6 +111,8 @@ class KernelTraits<EpanechnikovKernel>
   static const bool IsNormalized = true;
   //! The Epanechnikov kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Epanechnikov kernel only depends on the distance between the points.
+  static const bool IsRadial = true;
 };
 
 } // namespace kernel
@@ -171,6 +171,8 @@ class KernelTraits<GaussianKernel>
   static const bool IsNormalized = true;
   //! The Gaussian kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Gaussian kernel only depends on the distance between the points.
+  static const bool IsRadial = true;
 };
 
 } // namespace kernel
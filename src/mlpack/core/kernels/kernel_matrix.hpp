@@ -0,0 +1,186 @@
+/**
+ * @file kernel_matrix.hpp
+ *
+ * Computation of the matrix of kernel evaluations between two sets of points,
+ * shared by the methods that need full kernel matrices (kernel PCA, the
+ * Nystroem method and naive FastMKS).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/core/kernels/polynomial_kernel.hpp>
+#include <mlpack/core/kernels/hyperbolic_tangent_kernel.hpp>
+#include <mlpack/core/kernels/cosine_distance.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * IsInnerProductKernel<KernelType>::value is true if K(x, y) can be computed
+ * from x^T y, ||x||^2 and ||y||^2, with an overload of
+ * KernelFromInnerProduct() for KernelType.
+ */
+template<typename KernelType>
+struct IsInnerProductKernel
+{
+  static const bool value = false;
+};
+
+//! The linear kernel is the inner product.
+template<>
+struct IsInnerProductKernel<LinearKernel>
+{
+  static const bool value = true;
+};
+
+//! The polynomial kernel is a function of the inner product.
+template<>
+struct IsInnerProductKernel<PolynomialKernel>
+{
+  static const bool value = true;
+};
+
+//! The hyperbolic tangent kernel is a function of the inner product.
+template<>
+struct IsInnerProductKernel<HyperbolicTangentKernel>
+{
+  static const bool value = true;
+};
+
+//! The cosine distance is the inner product divided by the norms.
+template<>
+struct IsInnerProductKernel<CosineDistance>
+{
+  static const bool value = true;
+};
+
+/**
+ * The KernelMatrix class computes matrices of kernel evaluations,
+ * K(i, j) = k(a_i, b_j).  For kernels that only depend on the distance between
+ * the points (KernelTraits<KernelType>::IsRadial) or on their inner product
+ * (IsInnerProductKernel<KernelType>::value), all the inner products are
+ * computed with one matrix product, and the kernel values follow from them and
+ * the norms of the points.  Otherwise, the kernel is evaluated on every pair of
+ * points, in square blocks of pairs that are processed in parallel.  When the
+ * kernel matrix of a set of points with itself is computed, only one half of
+ * the matrix is computed.
+ *
+ * Since the kernel may be evaluated by several threads at once,
+ * KernelType::Evaluate() must be thread-safe.
+ *
+ * Note that the distances computed from inner products lose some precision
+ * when the points are much closer to each other than to the origin.
+ *
+ * @tparam KernelType Type of the kernel.
+ */
+template<typename KernelType>
+class KernelMatrix
+{
+ public:
+  /**
+   * Compute the matrix of kernel evaluations between the points of a and the
+   * points of b: kernelMatrix(i, j) = K(a_i, b_j).
+   *
+   * @param a First set of points (one point per column).
+   * @param b Second set of points (one point per column).
+   * @param kernel Kernel to evaluate.
+   * @param kernelMatrix Matrix to store the evaluations into; it is resized to
+   *     a.n_cols x b.n_cols.
+   */
+  template<typename MatType>
+  static void Compute(const MatType& a,
+                      const MatType& b,
+                      KernelType& kernel,
+                      arma::mat& kernelMatrix);
+
+  /**
+   * Compute the symmetric matrix of kernel evaluations between the points of
+   * the given dataset: kernelMatrix(i, j) = K(x_i, x_j).
+   *
+   * @param data Set of points (one point per column).
+   * @param kernel Kernel to evaluate.
+   * @param kernelMatrix Matrix to store the evaluations into; it is resized to
+   *     data.n_cols x data.n_cols.
+   */
+  template<typename MatType>
+  static void Compute(const MatType& data,
+                      KernelType& kernel,
+                      arma::mat& kernelMatrix);
+
+  //! Whether the kernel matrix is computed from the inner products of the
+  //! points.
+  static const bool UsesInnerProducts = KernelTraits<KernelType>::IsRadial ||
+      IsInnerProductKernel<KernelType>::value;
+
+ private:
+  //! The number of points of each side of the blocks of pairs that are
+  //! evaluated without inner products.
+  static const size_t BlockSize = 64;
+
+  //! Compute the kernel matrix from the inner products.
+  template<typename MatType>
+  static void ComputeImpl(const MatType& a,
+                          const MatType& b,
+                          KernelType& kernel,
+                          arma::mat& kernelMatrix,
+                          const std::true_type /* usesInnerProducts */);
+
+  //! Compute the kernel matrix by evaluating the kernel on every pair.
+  template<typename MatType>
+  static void ComputeImpl(const MatType& a,
+                          const MatType& b,
+                          KernelType& kernel,
+                          arma::mat& kernelMatrix,
+                          const std::false_type /* usesInnerProducts */);
+
+  //! Compute the symmetric kernel matrix from the inner products.
+  template<typename MatType>
+  static void ComputeImpl(const MatType& data,
+                          KernelType& kernel,
+                          arma::mat& kernelMatrix,
+                          const std::true_type /* usesInnerProducts */);
+
+  //! Compute the symmetric kernel matrix by evaluating the kernel on every
+  //! pair.
+  template<typename MatType>
+  static void ComputeImpl(const MatType& data,
+                          KernelType& kernel,
+                          arma::mat& kernelMatrix,
+                          const std::false_type /* usesInnerProducts */);
+
+  //! Compute the squared norm of every point.
+  template<typename MatType>
+  static arma::vec SquaredNorms(const MatType& data);
+
+  //! Compute the value of a radial kernel from an inner product and the
+  //! squared norms of the points.
+  static double FromInnerProduct(const KernelType& kernel,
+                                 const double product,
+                                 const double sqNormA,
+                                 const double sqNormB,
+                                 const std::true_type /* isRadial */);
+
+  //! Compute the value of an inner product kernel from an inner product and
+  //! the squared norms of the points.
+  static double FromInnerProduct(const KernelType& kernel,
+                                 const double product,
+                                 const double sqNormA,
+                                 const double sqNormB,
+                                 const std::false_type /* isRadial */);
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "kernel_matrix_impl.hpp"
+
+#endif
@@ -0,0 +1,262 @@
+/**
+ * @file kernel_matrix_impl.hpp
+ *
+ * Implementation of the KernelMatrix class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kernel_matrix.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+//! The linear kernel is the inner product itself.
+inline double KernelFromInnerProduct(const LinearKernel& /* kernel */,
+                                     const double product,
+                                     const double /* sqNormA */,
+                                     const double /* sqNormB */)
+{
+  return product;
+}
+
+//! K(x, y) = (x^T y + offset)^degree.
+inline double KernelFromInnerProduct(const PolynomialKernel& kernel,
+                                     const double product,
+                                     const double /* sqNormA */,
+                                     const double /* sqNormB */)
+{
+  return pow(product + kernel.Offset(), kernel.Degree());
+}
+
+//! K(x, y) = tanh(scale * x^T y + offset).
+inline double KernelFromInnerProduct(const HyperbolicTangentKernel& kernel,
+                                     const double product,
+                                     const double /* sqNormA */,
+                                     const double /* sqNormB */)
+{
+  return tanh(kernel.Scale() * product + kernel.Offset());
+}
+
+//! K(x, y) = x^T y / (||x|| ||y||), or 0 if one of the norms is 0.
+inline double KernelFromInnerProduct(const CosineDistance& /* kernel */,
+                                     const double product,
+                                     const double sqNormA,
+                                     const double sqNormB)
+{
+  const double denominator = std::sqrt(sqNormA) * std::sqrt(sqNormB);
+  return (denominator == 0.0) ? 0.0 : product / denominator;
+}
+
+template<typename KernelType>
+template<typename MatType>
+void KernelMatrix<KernelType>::Compute(const MatType& a,
+                                       const MatType& b,
+                                       KernelType& kernel,
+                                       arma::mat& kernelMatrix)
+{
+  ComputeImpl(a, b, kernel, kernelMatrix,
+      std::integral_constant<bool, UsesInnerProducts>());
+}
+
+template<typename KernelType>
+template<typename MatType>
+void KernelMatrix<KernelType>::Compute(const MatType& data,
+                                       KernelType& kernel,
+                                       arma::mat& kernelMatrix)
+{
+  ComputeImpl(data, kernel, kernelMatrix,
+      std::integral_constant<bool, UsesInnerProducts>());
+}
+
+template<typename KernelType>
+template<typename MatType>
+void KernelMatrix<KernelType>::ComputeImpl(
+    const MatType& a,
+    const MatType& b,
+    KernelType& kernel,
+    arma::mat& kernelMatrix,
+    const std::true_type /* usesInnerProducts */)
+{
+  const arma::vec sqNormsA = SquaredNorms(a);
+  const arma::vec sqNormsB = SquaredNorms(b);
+
+  // All the inner products at once; then each one is replaced by the
+  // corresponding kernel value.
+  kernelMatrix = a.t() * b;
+
+  typedef std::integral_constant<bool, KernelTraits<KernelType>::IsRadial>
+      IsRadial;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) kernelMatrix.n_cols; ++j)
+  {
+    for (size_t i = 0; i < kernelMatrix.n_rows; ++i)
+    {
+      kernelMatrix(i, j) = FromInnerProduct(kernel, kernelMatrix(i, j),
+          sqNormsA[i], sqNormsB[j], IsRadial());
+    }
+  }
+}
+
+template<typename KernelType>
+template<typename MatType>
+void KernelMatrix<KernelType>::ComputeImpl(
+    const MatType& a,
+    const MatType& b,
+    KernelType& kernel,
+    arma::mat& kernelMatrix,
+    const std::false_type /* usesInnerProducts */)
+{
+  kernelMatrix.set_size(a.n_cols, b.n_cols);
+
+  // Each block of BlockSize x BlockSize pairs is evaluated by one thread.
+  const size_t rowBlocks = (a.n_cols + BlockSize - 1) / BlockSize;
+  const size_t colBlocks = (b.n_cols + BlockSize - 1) / BlockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t block = 0; block < (omp_size_t) (rowBlocks * colBlocks);
+      ++block)
+  {
+    const size_t rowBegin = (block % rowBlocks) * BlockSize;
+    const size_t rowEnd = std::min(rowBegin + BlockSize, (size_t) a.n_cols);
+    const size_t colBegin = (block / rowBlocks) * BlockSize;
+    const size_t colEnd = std::min(colBegin + BlockSize, (size_t) b.n_cols);
+
+    for (size_t j = colBegin; j < colEnd; ++j)
+      for (size_t i = rowBegin; i < rowEnd; ++i)
+        kernelMatrix(i, j) = kernel.Evaluate(a.col(i), b.col(j));
+  }
+}
+
+template<typename KernelType>
+template<typename MatType>
+void KernelMatrix<KernelType>::ComputeImpl(
+    const MatType& data,
+    KernelType& kernel,
+    arma::mat& kernelMatrix,
+    const std::true_type /* usesInnerProducts */)
+{
+  const arma::vec sqNorms = SquaredNorms(data);
+
+  kernelMatrix = data.t() * data;
+
+  typedef std::integral_constant<bool, KernelTraits<KernelType>::IsRadial>
+      IsRadial;
+
+  // Only the upper triangular part is transformed.  On the diagonal, the
+  // squared norm is used as the inner product, so that the distance of a point
+  // to itself is exactly zero.
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t j = 0; j < (omp_size_t) kernelMatrix.n_cols; ++j)
+  {
+    for (size_t i = 0; i < (size_t) j; ++i)
+    {
+      kernelMatrix(i, j) = FromInnerProduct(kernel, kernelMatrix(i, j),
+          sqNorms[i], sqNorms[j], IsRadial());
+    }
+
+    kernelMatrix(j, j) = FromInnerProduct(kernel, sqNorms[j], sqNorms[j],
+        sqNorms[j], IsRadial());
+  }
+
+  // Copy to the lower triangular part of the matrix.
+  for (size_t j = 0; j < kernelMatrix.n_cols; ++j)
+    for (size_t i = j + 1; i < kernelMatrix.n_rows; ++i)
+      kernelMatrix(i, j) = kernelMatrix(j, i);
+}
+
+template<typename KernelType>
+template<typename MatType>
+void KernelMatrix<KernelType>::ComputeImpl(
+    const MatType& data,
+    KernelType& kernel,
+    arma::mat& kernelMatrix,
+    const std::false_type /* usesInnerProducts */)
+{
+  kernelMatrix.set_size(data.n_cols, data.n_cols);
+
+  // Only the blocks on or above the diagonal are evaluated; the block in row
+  // r and column c (r <= c) has index c (c + 1) / 2 + r.
+  const size_t blocks = (data.n_cols + BlockSize - 1) / BlockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t block = 0; block < (omp_size_t) (blocks * (blocks + 1) / 2);
+      ++block)
+  {
+    size_t colBlock = (size_t) ((std::sqrt(8.0 * block + 1.0) - 1.0) / 2.0);
+    // Correct any rounding error of the square root.
+    while (colBlock * (colBlock + 1) / 2 > (size_t) block)
+      --colBlock;
+    while ((colBlock + 1) * (colBlock + 2) / 2 <= (size_t) block)
+      ++colBlock;
+    const size_t rowBlock = block - colBlock * (colBlock + 1) / 2;
+
+    const size_t rowBegin = rowBlock * BlockSize;
+    const size_t colBegin = colBlock * BlockSize;
+    const size_t colEnd = std::min(colBegin + BlockSize,
+        (size_t) data.n_cols);
+
+    for (size_t j = colBegin; j < colEnd; ++j)
+    {
+      // Only evaluate the pairs on or above the diagonal.
+      const size_t rowEnd = std::min(rowBegin + BlockSize, j + 1);
+      for (size_t i = rowBegin; i < rowEnd; ++i)
+        kernelMatrix(i, j) = kernel.Evaluate(data.col(i), data.col(j));
+    }
+  }
+
+  // Copy to the lower triangular part of the matrix.
+  for (size_t j = 0; j < kernelMatrix.n_cols; ++j)
+    for (size_t i = j + 1; i < kernelMatrix.n_rows; ++i)
+      kernelMatrix(i, j) = kernelMatrix(j, i);
+}
+
+template<typename KernelType>
+template<typename MatType>
+arma::vec KernelMatrix<KernelType>::SquaredNorms(const MatType& data)
+{
+  arma::vec sqNorms(data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    sqNorms[i] = arma::dot(data.col(i), data.col(i));
+
+  return sqNorms;
+}
+
+template<typename KernelType>
+double KernelMatrix<KernelType>::FromInnerProduct(
+    const KernelType& kernel,
+    const double product,
+    const double sqNormA,
+    const double sqNormB,
+    const std::true_type /* isRadial */)
+{
+  // ||a - b||^2 = ||a||^2 + ||b||^2 - 2 a^T b, which can be slightly negative
+  // because of rounding.
+  const double sqDistance = std::max(sqNormA + sqNormB - 2.0 * product, 0.0);
+  return kernel.Evaluate(std::sqrt(sqDistance));
+}
+
+template<typename KernelType>
+double KernelMatrix<KernelType>::FromInnerProduct(
+    const KernelType& kernel,
+    const double product,
+    const double sqNormA,
+    const double sqNormB,
+    const std::false_type /* isRadial */)
+{
+  return KernelFromInnerProduct(kernel, product, sqNormA, sqNormB);
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
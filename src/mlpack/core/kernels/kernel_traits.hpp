@@ -36,6 +36,13 @@ class KernelTraits
    * If true, then the kernel include a squared distance, ||x - y||^2 .
    */
   static const bool UsesSquaredDistance = false;
+
+  /**
+   * If true, then the kernel only depends on the distance between its
+   * arguments, K(x, y) = f(||x - y||), and Evaluate(const double t) returns
+   * f(t).
+   */
+  static const bool IsRadial = false;
 };
 
 } // namespace kernel
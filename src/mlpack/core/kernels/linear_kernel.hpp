@@ -15,6 +15,7 @@
 #define MLPACK_CORE_KERNELS_LINEAR_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/simd_kernels.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -39,8 +40,9 @@ class LinearKernel
   LinearKernel() { }
 
   /**
-   * Simple evaluation of the dot product.  This evaluation uses Armadillo's
-   * dot() function.
+   * Simple evaluation of the dot product.  This evaluation uses the vectorized
+   * kernel in simd_kernels.hpp for contiguous float and double vectors, and
+   * Armadillo's dot() function otherwise.
    *
    * @tparam VecTypeA Type of first vector (should be arma::vec or
    *      arma::sp_vec).
@@ -52,7 +54,7 @@ class LinearKernel
   template<typename VecTypeA, typename VecTypeB>
   static double Evaluate(const VecTypeA& a, const VecTypeB& b)
   {
-    return arma::dot(a, b);
+    return metric::simd::Dot(a, b);
   }
 
   //! Serialize the kernel (it has no members... do nothing).
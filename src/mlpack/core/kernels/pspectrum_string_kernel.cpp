@@ -84,4 +84,38 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
   }
 
   Log::Info << "Substring extraction complete." << std::endl;
+
+  IndexSubstrings();
+}
+
+/**
+ * Build the sparse p-spectrum of every string from the counts of its
+ * substrings.
+ */
+void mlpack::kernel::PSpectrumStringKernel::IndexSubstrings()
+{
+  // Give every distinct substring an index.
+  unordered_map<string, size_t> indices;
+  spectra.resize(counts.size());
+  for (size_t dataset = 0; dataset < counts.size(); ++dataset)
+  {
+    spectra[dataset].resize(counts[dataset].size());
+    for (size_t index = 0; index < counts[dataset].size(); ++index)
+    {
+      const map<string, int>& mapping = counts[dataset][index];
+      vector<pair<size_t, int> >& spectrum = spectra[dataset][index];
+
+      spectrum.clear();
+      spectrum.reserve(mapping.size());
+      map<string, int>::const_iterator it = mapping.begin();
+      for (; it != mapping.end(); ++it)
+      {
+        const size_t substring = indices.insert(make_pair(it->first,
+            indices.size())).first->second;
+        spectrum.push_back(make_pair(substring, it->second));
+      }
+
+      sort(spectrum.begin(), spectrum.end());
+    }
+  }
 }
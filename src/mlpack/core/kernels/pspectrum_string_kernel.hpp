@@ -18,6 +18,7 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <mlpack/prereqs.hpp>
@@ -61,6 +62,14 @@ namespace kernel {
  * the data according to the fake data matrix -- resulting in a meaningless
  * tree.  This kernel was originally written for the FastMKS method; so, at the
  * very least, it will work with that.
+ *
+ * Besides the counts of the substrings of each string, the kernel keeps the
+ * p-spectrum of each string as a sparse vector: every distinct substring of the
+ * datasets gets an integer index, and each string stores the indices of its
+ * substrings in ascending order along with their counts.  An evaluation is
+ * then a merge of two sorted integer arrays, without any string comparisons.
+ * Evaluate() is thread-safe, so kernel::KernelMatrix can compute kernel
+ * matrices (for instance for KernelPCA) in parallel.
  */
 class PSpectrumStringKernel
 {
@@ -89,12 +98,24 @@ class PSpectrumStringKernel
   template<typename VecType>
   double Evaluate(const VecType& a, const VecType& b) const;
 
+  /**
+   * Build the sparse p-spectrum of every string from the counts of its
+   * substrings.  This is done by the constructor, and has to be done again
+   * after the counts are modified; until then, Evaluate() uses the counts
+   * directly, which is slower.
+   */
+  void IndexSubstrings();
+
   //! Access the lists of substrings.
   const std::vector<std::vector<std::map<std::string, int> > >& Counts() const
   { return counts; }
-  //! Modify the lists of substrings.
+  //! Modify the lists of substrings.  This discards the sparse p-spectra; call
+  //! IndexSubstrings() after the modification to rebuild them.
   std::vector<std::vector<std::map<std::string, int> > >& Counts()
-  { return counts; }
+  {
+    spectra.clear();
+    return counts;
+  }
 
   //! Access the value of p.
   size_t P() const { return p; }
@@ -106,6 +127,11 @@ class PSpectrumStringKernel
   //! is not wonderful...
   std::vector<std::vector<std::map<std::string, int> > > counts;
 
+  //! The sparse p-spectrum of every string: the indices of its substrings in
+  //! ascending order, with their counts.  This is empty if the counts were
+  //! modified since it was built.
+  std::vector<std::vector<std::vector<std::pair<size_t, int> > > > spectra;
+
   //! The value of p to use in calculation.
   size_t p;
 };
@@ -36,6 +36,37 @@ template<typename VecType>
 double PSpectrumStringKernel::Evaluate(const VecType& a,
                                        const VecType& b) const
 {
+  if (!spectra.empty())
+  {
+    const std::vector<std::pair<size_t, int> >& aSpectrum =
+        spectra[a[0]][a[1]];
+    const std::vector<std::pair<size_t, int> >& bSpectrum =
+        spectra[b[0]][b[1]];
+
+    // The sparse dot product of the two spectra.
+    double eval = 0;
+    size_t i = 0, j = 0;
+    while ((i < aSpectrum.size()) && (j < bSpectrum.size()))
+    {
+      if (aSpectrum[i].first == bSpectrum[j].first)
+      {
+        eval += aSpectrum[i].second * bSpectrum[j].second;
+        ++i;
+        ++j;
+      }
+      else if (aSpectrum[i].first < bSpectrum[j].first)
+      {
+        ++i;
+      }
+      else
+      {
+        ++j;
+      }
+    }
+
+    return eval;
+  }
+
   // Get the map of substrings for the two strings we are interested in.
   const std::map<std::string, int>& aMap = counts[a[0]][a[1]];
   const std::map<std::string, int>& bMap = counts[b[0]][b[1]];
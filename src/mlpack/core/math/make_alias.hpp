@@ -66,6 +66,40 @@ arma::Col<ElemType> MakeAlias(arma::Col<ElemType>& input,
   return arma::Col<ElemType>(input.memptr(), input.n_elem, false, strict);
 }
 
+/**
+ * Reconstruct the given matrix as an alias of the given memory; whatever it
+ * held before is released.  This is what an output parameter needs, since
+ * assigning an alias to a matrix copies the memory.  If strict is true, then
+ * the alias cannot be resized or pointed at new memory.
+ */
+template<typename ElemType>
+void MakeAlias(arma::Mat<ElemType>& m,
+               ElemType* memory,
+               const size_t numRows,
+               const size_t numCols,
+               const bool strict = true)
+{
+  typedef arma::Mat<ElemType> MatType;
+  m.~MatType();
+  new (&m) MatType(memory, numRows, numCols, false, strict);
+}
+
+/**
+ * Reconstruct the given row as an alias of the given memory; whatever it held
+ * before is released.  If strict is true, then the alias cannot be resized or
+ * pointed at new memory.
+ */
+template<typename ElemType>
+void MakeAlias(arma::Row<ElemType>& r,
+               ElemType* memory,
+               const size_t numElem,
+               const bool strict = true)
+{
+  typedef arma::Row<ElemType> RowType;
+  r.~RowType();
+  new (&r) RowType(memory, numElem, false, strict);
+}
+
 /**
  * Make a copy of a sparse matrix (an alias is not possible).  The strict
  * parameter is ignored.
@@ -0,0 +1,172 @@
+/**
+ * @file philox.hpp
+ *
+ * The Philox4x32-10 counter-based random number generator.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_PHILOX_HPP
+#define MLPACK_CORE_MATH_PHILOX_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * Philox4x32-10 is the counter-based generator of Salmon et al. ("Parallel
+ * random numbers: as easy as 1, 2, 3", SC 2011): the n-th block of four 32-bit
+ * outputs is a keyed bijection of the 128-bit counter n, so any position of the
+ * stream can be reached in constant time and streams with different keys or
+ * different stream numbers are independent for all practical purposes.  The
+ * state is only a few words, which makes it cheap to have one generator per
+ * thread or per block of a matrix.
+ *
+ * The seed is the 64-bit key, and the stream number is the upper half of the
+ * counter; the lower half counts the blocks of the stream.  The class
+ * satisfies the UniformRandomBitGenerator requirements, so it can be used with
+ * the distributions of the standard library.
+ */
+class Philox
+{
+ public:
+  //! The type of the generated numbers.
+  typedef uint32_t result_type;
+
+  /**
+   * Create the generator for the given seed and stream.
+   *
+   * @param seed Key of the generator.
+   * @param stream Index of the stream.
+   */
+  Philox(const uint64_t seed = 0, const uint64_t stream = 0)
+  {
+    Seed(seed, stream);
+  }
+
+  /**
+   * Restart the generator at the beginning of the given stream.
+   *
+   * @param seed Key of the generator.
+   * @param stream Index of the stream.
+   */
+  void Seed(const uint64_t seed, const uint64_t stream = 0)
+  {
+    key[0] = (uint32_t) seed;
+    key[1] = (uint32_t) (seed >> 32);
+    counter[0] = 0;
+    counter[1] = 0;
+    counter[2] = (uint32_t) stream;
+    counter[3] = (uint32_t) (stream >> 32);
+    index = 4;
+  }
+
+  //! Get the next 32-bit number.
+  result_type operator()()
+  {
+    if (index == 4)
+    {
+      GenerateBlock();
+      index = 0;
+    }
+
+    return output[index++];
+  }
+
+  //! Get a uniform random number in [0, 1) with 53 random bits.
+  double Uniform()
+  {
+    const uint32_t a = (*this)() >> 5;
+    const uint32_t b = (*this)() >> 6;
+    return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
+  }
+
+  /**
+   * Skip the next n numbers of the stream, in constant time.
+   *
+   * @param n Number of outputs to skip.
+   */
+  void Discard(uint64_t n)
+  {
+    // Use what is left of the current block first.
+    while (n > 0 && index < 4)
+    {
+      ++index;
+      --n;
+    }
+
+    // Then skip whole blocks by moving the counter.
+    const uint64_t blocks = n / 4;
+    const uint64_t position = ((uint64_t) counter[1] << 32) + counter[0] +
+        blocks;
+    counter[0] = (uint32_t) position;
+    counter[1] = (uint32_t) (position >> 32);
+
+    if (n % 4 > 0)
+    {
+      GenerateBlock();
+      index = (size_t) (n % 4);
+    }
+  }
+
+  //! Get the smallest number that can be generated.
+  static constexpr result_type min() { return 0; }
+  //! Get the largest number that can be generated.
+  static constexpr result_type max() { return 0xFFFFFFFF; }
+
+ private:
+  //! Compute the block of outputs for the current counter, then increment it.
+  void GenerateBlock()
+  {
+    uint32_t c[4] = { counter[0], counter[1], counter[2], counter[3] };
+    uint32_t k[2] = { key[0], key[1] };
+
+    for (size_t round = 0; round < 10; ++round)
+    {
+      if (round > 0)
+      {
+        k[0] += 0x9E3779B9;
+        k[1] += 0xBB67AE85;
+      }
+
+      const uint64_t product0 = (uint64_t) 0xD2511F53 * c[0];
+      const uint64_t product1 = (uint64_t) 0xCD9E8D57 * c[2];
+      const uint32_t next[4] = {
+          (uint32_t) (product1 >> 32) ^ c[1] ^ k[0],
+          (uint32_t) product1,
+          (uint32_t) (product0 >> 32) ^ c[3] ^ k[1],
+          (uint32_t) product0 };
+      c[0] = next[0];
+      c[1] = next[1];
+      c[2] = next[2];
+      c[3] = next[3];
+    }
+
+    output[0] = c[0];
+    output[1] = c[1];
+    output[2] = c[2];
+    output[3] = c[3];
+
+    // Increment the block counter, carrying into the second word.
+    if (++counter[0] == 0)
+      ++counter[1];
+  }
+
+  //! The key.
+  uint32_t key[2];
+  //! The counter of the next block; the upper two words are the stream.
+  uint32_t counter[4];
+  //! The last block of outputs.
+  uint32_t output[4];
+  //! The index of the next output in the block (4 if it is used up).
+  size_t index;
+};
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -8,8 +8,7 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
-#include <random>
-#include <mlpack/mlpack_export.hpp>
+#include "random.hpp"
 
 namespace mlpack {
 namespace math {
@@ -20,6 +19,32 @@ MLPACK_EXPORT std::mt19937 randGen;
 MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist(0.0, 1.0);
 // Global normal distribution.
 MLPACK_EXPORT std::normal_distribution<> randNormalDist(0.0, 1.0);
+// The seed of the generators of the threads; this is also the default seed of
+// std::mt19937.
+MLPACK_EXPORT uint64_t randSeed = 5489;
+// The number of calls to RandomSeed(); it starts at one so that every thread
+// seeds its generator at first use.
+MLPACK_EXPORT size_t randSeedCount = 1;
+
+ThreadRandomState& GetThreadRandomState()
+{
+  static thread_local ThreadRandomState state;
+
+  if (state.seedCount != randSeedCount)
+  {
+    #ifdef HAS_OPENMP
+      const size_t thread = omp_get_thread_num();
+    #else
+      const size_t thread = 0;
+    #endif
+
+    state.generator.Seed(randSeed, thread);
+    state.normalDist.reset();
+    state.seedCount = randSeedCount;
+  }
+
+  return state;
+}
 
 } // namespace math
 } // namespace mlpack
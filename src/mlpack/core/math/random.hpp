@@ -15,6 +15,12 @@
 #include <mlpack/mlpack_export.hpp>
 #include <random>
 
+#include "philox.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
 
@@ -29,6 +35,105 @@ extern MLPACK_EXPORT std::mt19937 randGen;
 extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
 extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
+// The seed given to RandomSeed(), used for the generators of the threads.
+extern MLPACK_EXPORT uint64_t randSeed;
+// The number of calls to RandomSeed(), so that threads know when to reseed.
+extern MLPACK_EXPORT size_t randSeedCount;
+
+/**
+ * The random state of one thread.  Inside OpenMP parallel regions, the random
+ * functions below draw from the state of the calling thread instead of the
+ * global generator, which can't be shared between threads.  The generator of
+ * each thread is the stream of Philox keyed by the seed given to RandomSeed()
+ * whose index is the number of the thread in its team, so a parallel loop with
+ * a static schedule draws the same numbers in every run with the same number
+ * of threads.
+ */
+struct ThreadRandomState
+{
+  //! The generator of the thread.
+  Philox generator;
+  //! The normal distribution of the thread (it caches a second number).
+  std::normal_distribution<> normalDist;
+  //! The value of randSeedCount when the generator was seeded.
+  size_t seedCount;
+
+  ThreadRandomState() : seedCount(0) { }
+};
+
+/**
+ * Get the random state of the calling thread, (re)seeding it first if
+ * RandomSeed() has been called since it was last used.
+ */
+MLPACK_EXPORT ThreadRandomState& GetThreadRandomState();
+
+/**
+ * Get whether the calling thread must use its own random state even outside of
+ * parallel regions; see ThreadRandomStream.
+ */
+inline bool& ForceThreadRandomState()
+{
+  static thread_local bool force = false;
+  return force;
+}
+
+/**
+ * Return whether the random functions must use the state of the calling
+ * thread, that is, whether they are called inside an OpenMP parallel region
+ * (or while a ThreadRandomStream of the thread exists).
+ */
+inline bool UseThreadRandomState()
+{
+  #ifdef HAS_OPENMP
+    if (omp_in_parallel())
+      return true;
+  #endif
+
+  return ForceThreadRandomState();
+}
+
+/**
+ * While an object of this class exists, the random functions called by the
+ * thread that created it draw from the stream of Philox keyed by the given key,
+ * whether or not they are called inside a parallel region, and whatever the
+ * size of the team.  This lets a parallel loop give each iteration its own
+ * random numbers, so that the results don't depend on the number of threads
+ * (even if it is one).  The previous state of the thread is restored when the
+ * object is destroyed.
+ */
+class ThreadRandomStream
+{
+ public:
+  /**
+   * Start drawing random numbers from the stream with the given key.
+   *
+   * @param key Key of the stream, usually drawn with RandKey().
+   */
+  ThreadRandomStream(const uint64_t key) :
+      state(GetThreadRandomState()),
+      previous(state),
+      previousForce(ForceThreadRandomState())
+  {
+    state.generator.Seed(key);
+    state.normalDist.reset();
+    ForceThreadRandomState() = true;
+  }
+
+  //! Restore the random state the thread had before.
+  ~ThreadRandomStream()
+  {
+    state = previous;
+    ForceThreadRandomState() = previousForce;
+  }
+
+ private:
+  //! The random state of the thread.
+  ThreadRandomState& state;
+  //! The random state of the thread before this object was created.
+  ThreadRandomState previous;
+  //! Whether the thread was forced to use its random state before.
+  bool previousForce;
+};
 
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
@@ -43,6 +148,9 @@ inline void RandomSeed(const size_t seed)
     randGen.seed((uint32_t) seed);
     srand((unsigned int) seed);
     arma::arma_rng::set_seed(seed);
+    randNormalDist.reset();
+    randSeed = seed;
+    ++randSeedCount;
   #else
     (void) seed;
   #endif
@@ -62,6 +170,9 @@ inline void FixedRandomSeed()
   randGen.seed((uint32_t) seed);
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
+  randNormalDist.reset();
+  randSeed = seed;
+  ++randSeedCount;
 }
 #endif
 
@@ -70,6 +181,9 @@ inline void FixedRandomSeed()
  */
 inline double Random()
 {
+  if (UseThreadRandomState())
+    return GetThreadRandomState().generator.Uniform();
+
   return randUniformDist(randGen);
 }
 
@@ -78,7 +192,7 @@ inline double Random()
  */
 inline double Random(const double lo, const double hi)
 {
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * Random();
 }
 
 /**
@@ -97,7 +211,7 @@ inline double RandBernoulli(const double input)
  */
 inline int RandInt(const int hiExclusive)
 {
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive * Random());
 }
 
 /**
@@ -105,8 +219,22 @@ inline int RandInt(const int hiExclusive)
  */
 inline int RandInt(const int lo, const int hiExclusive)
 {
-  return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+  return lo + (int) std::floor((double) (hiExclusive - lo) * Random());
+}
+
+/**
+ * Generates a uniform random index in [0, hiExclusive).  Unlike RandInt(), the
+ * range is not limited to the values of an int.
+ *
+ * @param hiExclusive Number of possible indices; must be greater than 0.
+ */
+inline size_t RandIndex(const size_t hiExclusive)
+{
+  std::uniform_int_distribution<size_t> dist(0, hiExclusive - 1);
+  if (UseThreadRandomState())
+    return dist(GetThreadRandomState().generator);
+
+  return dist(randGen);
 }
 
 /**
@@ -114,6 +242,12 @@ inline int RandInt(const int lo, const int hiExclusive)
  */
 inline double RandNormal()
 {
+  if (UseThreadRandomState())
+  {
+    ThreadRandomState& state = GetThreadRandomState();
+    return state.normalDist(state.generator);
+  }
+
   return randNormalDist(randGen);
 }
 
@@ -126,7 +260,117 @@ inline double RandNormal()
  */
 inline double RandNormal(const double mean, const double variance)
 {
-  return variance * randNormalDist(randGen) + mean;
+  return variance * RandNormal() + mean;
+}
+
+/**
+ * Get a random 64-bit key from the global generator, or from the generator of
+ * the calling thread inside a parallel region.
+ */
+inline uint64_t RandKey()
+{
+  uint64_t high, low;
+  if (UseThreadRandomState())
+  {
+    Philox& generator = GetThreadRandomState().generator;
+    high = generator();
+    low = generator();
+  }
+  else
+  {
+    high = randGen();
+    low = randGen();
+  }
+
+  return (high << 32) | low;
+}
+
+/**
+ * Fill the given matrix with uniform random numbers in the specified range.
+ * The elements are split into blocks that are filled in parallel, each from
+ * its own stream of a Philox generator keyed by a number drawn with RandKey();
+ * since the stream of a block only depends on its position, the result for a
+ * given seed doesn't depend on the number of threads.
+ *
+ * @param matrix Matrix (or vector) to fill.
+ * @param lo Lower bound of the numbers.
+ * @param hi Upper bound of the numbers.
+ */
+template<typename MatType>
+void RandFill(MatType& matrix, const double lo = 0.0, const double hi = 1.0)
+{
+  const uint64_t key = RandKey();
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (matrix.n_elem + blockSize - 1) / blockSize;
+  typename MatType::elem_type* memory = matrix.memptr();
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    Philox generator(key, b);
+    const size_t end = std::min((size_t) (b + 1) * blockSize,
+        (size_t) matrix.n_elem);
+    for (size_t i = b * blockSize; i < end; ++i)
+      memory[i] = lo + (hi - lo) * generator.Uniform();
+  }
+}
+
+/**
+ * Fill the given matrix with normally distributed random numbers, as with
+ * RandNormal(mean, variance).  Like RandFill(), the blocks of the matrix are
+ * filled in parallel and the result doesn't depend on the number of threads.
+ *
+ * @param matrix Matrix (or vector) to fill.
+ * @param mean Mean of distribution.
+ * @param variance Variance of distribution.
+ */
+template<typename MatType>
+void RandNormalFill(MatType& matrix,
+                    const double mean = 0.0,
+                    const double variance = 1.0)
+{
+  const uint64_t key = RandKey();
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (matrix.n_elem + blockSize - 1) / blockSize;
+  typename MatType::elem_type* memory = matrix.memptr();
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    Philox generator(key, b);
+    std::normal_distribution<> normalDist;
+    const size_t end = std::min((size_t) (b + 1) * blockSize,
+        (size_t) matrix.n_elem);
+    for (size_t i = b * blockSize; i < end; ++i)
+      memory[i] = variance * normalDist(generator) + mean;
+  }
+}
+
+/**
+ * Replace every element of the given matrix, which must be a probability, by a
+ * Bernoulli sample with that probability, as with RandBernoulli().  Like
+ * RandFill(), the blocks of the matrix are sampled in parallel and the result
+ * doesn't depend on the number of threads.
+ *
+ * @param matrix Matrix (or vector) of probabilities to sample.
+ */
+template<typename MatType>
+void RandBernoulliFill(MatType& matrix)
+{
+  const uint64_t key = RandKey();
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (matrix.n_elem + blockSize - 1) / blockSize;
+  typename MatType::elem_type* memory = matrix.memptr();
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    Philox generator(key, b);
+    const size_t end = std::min((size_t) (b + 1) * blockSize,
+        (size_t) matrix.n_elem);
+    for (size_t i = b * blockSize; i < end; ++i)
+      memory[i] = (generator.Uniform() < memory[i]) ? 1 : 0;
+  }
 }
 
 /**
@@ -14,6 +14,7 @@
 
 // In case it hasn't been included.
 #include "lmetric.hpp"
+#include "simd_kernels.hpp"
 
 namespace mlpack {
 namespace metric {
@@ -35,14 +36,15 @@ typename VecTypeA::elem_type LMetric<Power, TakeRoot>::Evaluate(
   return std::pow(sum, (1.0 / Power));
 }
 
-// L1-metric specializations; the root doesn't matter.
+// L1-metric specializations; the root doesn't matter.  Contiguous float and
+// double vectors use the vectorized kernels (see simd_kernels.hpp).
 template<>
 template<typename VecTypeA, typename VecTypeB>
 typename VecTypeA::elem_type LMetric<1, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return arma::accu(abs(a - b));
+  return simd::Manhattan(a, b);
 }
 
 template<>
@@ -51,7 +53,7 @@ typename VecTypeA::elem_type LMetric<1, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return arma::accu(abs(a - b));
+  return simd::Manhattan(a, b);
 }
 
 // L2-metric specializations.
@@ -61,7 +63,7 @@ typename VecTypeA::elem_type LMetric<2, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return sqrt(arma::accu(square(a - b)));
+  return sqrt(simd::SquaredEuclidean(a, b));
 }
 
 template<>
@@ -70,7 +72,7 @@ typename VecTypeA::elem_type LMetric<2, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return accu(arma::square(a - b));
+  return simd::SquaredEuclidean(a, b);
 }
 
 // L3-metric specialization (not very likely to be used, but just in case).
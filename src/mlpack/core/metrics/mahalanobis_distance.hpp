@@ -37,10 +37,13 @@ namespace metric {
  *
  * If you wish to use the KNN class or other tree-based algorithms with this
  * distance, it is recommended to instead stretch the dataset first, by
- * decomposing Q = L^T L (perhaps via a Cholesky decomposition), and then
- * multiply the data by L.  If you still wish to use the KNN class with a custom
- * distance anyway, you will need to use a different tree type than the default
- * KDTree, which only works with the LMetric class.
+ * decomposing Q = L^T L, and then multiply the data by L.  Transformation()
+ * gives such a factor L (it is cached), and Transform() stretches a dataset
+ * with it; the Euclidean distance (LMetric<2, TakeRoot>) between stretched
+ * points is this distance between the original points.  If you still wish to
+ * use the KNN class with a custom distance anyway, you will need to use a
+ * different tree type than the default KDTree, which only works with the
+ * LMetric class.
  *
  * Similar to the LMetric class, this offers a template parameter TakeRoot
  * which, when set to false, will instead evaluate the distance
@@ -64,7 +67,7 @@ class MahalanobisDistance
    * Initialize the Mahalanobis distance with the empty matrix as covariance.
    * Don't call Evaluate() until you set the covariance with Covariance()!
    */
-  MahalanobisDistance() { }
+  MahalanobisDistance() : transformationValid(false) { }
 
   /**
    * Initialize the Mahalanobis distance with the identity matrix of the given
@@ -73,7 +76,8 @@ class MahalanobisDistance
    * @param dimensionality Dimesnsionality of the covariance matrix.
    */
   MahalanobisDistance(const size_t dimensionality) :
-      covariance(arma::eye<arma::mat>(dimensionality, dimensionality)) { }
+      covariance(arma::eye<arma::mat>(dimensionality, dimensionality)),
+      transformationValid(false) { }
 
   /**
    * Initialize the Mahalanobis distance with the given covariance matrix.  The
@@ -81,7 +85,9 @@ class MahalanobisDistance
    *
    * @param covariance The covariance matrix to use for this distance.
    */
-  MahalanobisDistance(const arma::mat& covariance) : covariance(covariance) { }
+  MahalanobisDistance(const arma::mat& covariance) :
+      covariance(covariance),
+      transformationValid(false) { }
 
   /**
    * Evaluate the distance between the two given points using this Mahalanobis
@@ -95,6 +101,45 @@ class MahalanobisDistance
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Evaluate the distance between every point (column) of a and every point of
+   * b.  Both sets of points are stretched by Transformation(), and the
+   * distances are computed from one matrix product, so this is much faster
+   * than calling Evaluate() for every pair.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param distances Matrix in which the distances will be stored; element
+   *     (i, j) is the distance between a.col(i) and b.col(j).
+   */
+  void Evaluate(const arma::mat& a,
+                const arma::mat& b,
+                arma::mat& distances) const;
+
+  /**
+   * Get a factor L of the covariance matrix, with Q = L^T L.  This is the
+   * Cholesky factor if Q is positive definite; otherwise it is computed from
+   * the eigendecomposition of Q, with negative eigenvalues treated as zero.
+   * Only the symmetric part of Q is used, since it is the only part that
+   * affects the distance.  The factor is computed on the first call after the
+   * covariance matrix changes, and cached.
+   */
+  const arma::mat& Transformation() const;
+
+  /**
+   * Stretch the given points by Transformation(), so that the Euclidean
+   * distance between the stretched points is this distance between the
+   * original points.  Trees and neighbor search can then be used on the
+   * stretched points with LMetric<2, TakeRoot>.
+   *
+   * @param data Points to transform (one per column).
+   * @param transformed Matrix in which the stretched points will be stored.
+   */
+  void Transform(const arma::mat& data, arma::mat& transformed) const
+  {
+    transformed = Transformation() * data;
+  }
+
   /**
    * Access the covariance matrix.
    *
@@ -103,11 +148,17 @@ class MahalanobisDistance
   const arma::mat& Covariance() const { return covariance; }
 
   /**
-   * Modify the covariance matrix.
+   * Modify the covariance matrix.  This invalidates the cached factor, so don't
+   * keep the reference to modify the covariance matrix after calling
+   * Transformation().
    *
    * @return Reference to the covariance matrix.
    */
-  arma::mat& Covariance() { return covariance; }
+  arma::mat& Covariance()
+  {
+    transformationValid = false;
+    return covariance;
+  }
 
   //! Serialize the Mahalanobis distance.
   template<typename Archive>
@@ -116,6 +167,10 @@ class MahalanobisDistance
  private:
   //! The covariance matrix associated with this distance.
   arma::mat covariance;
+  //! The cached factor of the covariance matrix.
+  mutable arma::mat transformation;
+  //! Whether the cached factor belongs to the current covariance matrix.
+  mutable bool transformationValid;
 };
 
 } // namespace metric
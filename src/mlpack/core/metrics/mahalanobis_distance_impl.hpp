@@ -26,8 +26,7 @@ double MahalanobisDistance<false>::Evaluate(const VecTypeA& a,
                                             const VecTypeB& b)
 {
   arma::vec m = (a - b);
-  arma::mat out = trans(m) * covariance * m; // 1x1
-  return out[0];
+  return arma::dot(m, covariance * m);
 }
 /**
  * Specialization for rooted case.  This requires one extra evaluation of
@@ -43,8 +42,51 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
     covariance = arma::eye<arma::mat>(a.n_elem, a.n_elem);
 
   arma::vec m = (a - b);
-  arma::mat out = trans(m) * covariance * m; // 1x1;
-  return sqrt(out[0]);
+  return sqrt(arma::dot(m, covariance * m));
+}
+
+template<bool TakeRoot>
+void MahalanobisDistance<TakeRoot>::Evaluate(const arma::mat& a,
+                                             const arma::mat& b,
+                                             arma::mat& distances) const
+{
+  const arma::mat& l = Transformation();
+  const arma::mat stretchedA = l * a;
+  const arma::mat stretchedB = l * b;
+
+  // ||x - y||^2 = ||x||^2 + ||y||^2 - 2 x^T y.
+  distances = -2.0 * (stretchedA.t() * stretchedB);
+  distances.each_col() += arma::sum(arma::square(stretchedA), 0).t();
+  distances.each_row() += arma::sum(arma::square(stretchedB), 0);
+
+  // Rounding could make distances between close points slightly negative.
+  distances.elem(arma::find(distances < 0.0)).zeros();
+
+  if (TakeRoot)
+    distances = arma::sqrt(distances);
+}
+
+template<bool TakeRoot>
+const arma::mat& MahalanobisDistance<TakeRoot>::Transformation() const
+{
+  if (transformationValid)
+    return transformation;
+
+  const arma::mat symmetric = 0.5 * (covariance + covariance.t());
+
+  // The upper Cholesky factor R satisfies Q = R^T R.
+  if (!arma::chol(transformation, symmetric))
+  {
+    arma::vec eigenvalues;
+    arma::mat eigenvectors;
+    arma::eig_sym(eigenvalues, eigenvectors, symmetric);
+    eigenvalues.elem(arma::find(eigenvalues < 0.0)).zeros();
+    transformation = arma::diagmat(arma::sqrt(eigenvalues)) *
+        eigenvectors.t();
+  }
+
+  transformationValid = true;
+  return transformation;
 }
 
 // Serialize the Mahalanobis distance.
@@ -54,6 +96,10 @@ void MahalanobisDistance<TakeRoot>::serialize(Archive& ar,
                                               const unsigned int /* version */)
 {
   ar & BOOST_SERIALIZATION_NVP(covariance);
+
+  // The factor is not saved, so it has to be recomputed after loading.
+  if (Archive::is_loading::value)
+    transformationValid = false;
 }
 
 } // namespace metric
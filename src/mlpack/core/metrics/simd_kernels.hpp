@@ -0,0 +1,440 @@
+/**
+ * @file simd_kernels.hpp
+ *
+ * Explicitly vectorized squared Euclidean distance, Manhattan distance and
+ * inner product kernels for contiguous float and double vectors, used by
+ * LMetric and LinearKernel.
+ *
+ * The instruction set is chosen at compile time from the flags the compiler
+ * was given: AVX-512F, then AVX2 with FMA, then NEON (on AArch64).  If none of
+ * those is available (or MLPACK_NO_SIMD_KERNELS is defined), the Armadillo
+ * types are handled by the usual Armadillo expressions and the raw pointer
+ * kernels are plain loops.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_SIMD_KERNELS_HPP
+#define MLPACK_CORE_METRICS_SIMD_KERNELS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifndef MLPACK_NO_SIMD_KERNELS
+  #if defined(__AVX512F__)
+    #define MLPACK_SIMD_AVX512
+  #elif defined(__AVX2__) && defined(__FMA__)
+    #define MLPACK_SIMD_AVX2
+  #elif defined(__ARM_NEON) && defined(__aarch64__)
+    #define MLPACK_SIMD_NEON
+  #endif
+#endif
+
+#if defined(MLPACK_SIMD_AVX512) || defined(MLPACK_SIMD_AVX2)
+  #include <immintrin.h>
+  #define MLPACK_HAS_SIMD_KERNELS
+#elif defined(MLPACK_SIMD_NEON)
+  #include <arm_neon.h>
+  #define MLPACK_HAS_SIMD_KERNELS
+#endif
+
+namespace mlpack {
+namespace metric {
+namespace simd {
+
+#ifdef MLPACK_HAS_SIMD_KERNELS
+
+/**
+ * The operations on one vector register of the selected instruction set that
+ * the kernels need.  This is only specialized for float and double.
+ */
+template<typename eT>
+struct Register;
+
+#if defined(MLPACK_SIMD_AVX512)
+
+template<>
+struct Register<double>
+{
+  typedef __m512d Type;
+  static const size_t width = 8;
+
+  static Type Zero() { return _mm512_setzero_pd(); }
+  static Type Load(const double* p) { return _mm512_loadu_pd(p); }
+  static Type Add(Type a, Type b) { return _mm512_add_pd(a, b); }
+  static Type Sub(Type a, Type b) { return _mm512_sub_pd(a, b); }
+  static Type MulAdd(Type a, Type b, Type c)
+  {
+    return _mm512_fmadd_pd(a, b, c);
+  }
+  static Type Abs(Type a) { return _mm512_abs_pd(a); }
+  static double Sum(Type a) { return _mm512_reduce_add_pd(a); }
+};
+
+template<>
+struct Register<float>
+{
+  typedef __m512 Type;
+  static const size_t width = 16;
+
+  static Type Zero() { return _mm512_setzero_ps(); }
+  static Type Load(const float* p) { return _mm512_loadu_ps(p); }
+  static Type Add(Type a, Type b) { return _mm512_add_ps(a, b); }
+  static Type Sub(Type a, Type b) { return _mm512_sub_ps(a, b); }
+  static Type MulAdd(Type a, Type b, Type c)
+  {
+    return _mm512_fmadd_ps(a, b, c);
+  }
+  static Type Abs(Type a) { return _mm512_abs_ps(a); }
+  static float Sum(Type a) { return _mm512_reduce_add_ps(a); }
+};
+
+#elif defined(MLPACK_SIMD_AVX2)
+
+template<>
+struct Register<double>
+{
+  typedef __m256d Type;
+  static const size_t width = 4;
+
+  static Type Zero() { return _mm256_setzero_pd(); }
+  static Type Load(const double* p) { return _mm256_loadu_pd(p); }
+  static Type Add(Type a, Type b) { return _mm256_add_pd(a, b); }
+  static Type Sub(Type a, Type b) { return _mm256_sub_pd(a, b); }
+  static Type MulAdd(Type a, Type b, Type c)
+  {
+    return _mm256_fmadd_pd(a, b, c);
+  }
+  // Clear the sign bit.
+  static Type Abs(Type a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+  static double Sum(Type a)
+  {
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(a),
+        _mm256_extractf128_pd(a, 1));
+    s = _mm_add_sd(s, _mm_unpackhi_pd(s, s));
+    return _mm_cvtsd_f64(s);
+  }
+};
+
+template<>
+struct Register<float>
+{
+  typedef __m256 Type;
+  static const size_t width = 8;
+
+  static Type Zero() { return _mm256_setzero_ps(); }
+  static Type Load(const float* p) { return _mm256_loadu_ps(p); }
+  static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+  static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+  static Type MulAdd(Type a, Type b, Type c)
+  {
+    return _mm256_fmadd_ps(a, b, c);
+  }
+  // Clear the sign bit.
+  static Type Abs(Type a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+  static float Sum(Type a)
+  {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(a),
+        _mm256_extractf128_ps(a, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+  }
+};
+
+#elif defined(MLPACK_SIMD_NEON)
+
+template<>
+struct Register<double>
+{
+  typedef float64x2_t Type;
+  static const size_t width = 2;
+
+  static Type Zero() { return vdupq_n_f64(0.0); }
+  static Type Load(const double* p) { return vld1q_f64(p); }
+  static Type Add(Type a, Type b) { return vaddq_f64(a, b); }
+  static Type Sub(Type a, Type b) { return vsubq_f64(a, b); }
+  static Type MulAdd(Type a, Type b, Type c) { return vfmaq_f64(c, a, b); }
+  static Type Abs(Type a) { return vabsq_f64(a); }
+  static double Sum(Type a) { return vaddvq_f64(a); }
+};
+
+template<>
+struct Register<float>
+{
+  typedef float32x4_t Type;
+  static const size_t width = 4;
+
+  static Type Zero() { return vdupq_n_f32(0.0f); }
+  static Type Load(const float* p) { return vld1q_f32(p); }
+  static Type Add(Type a, Type b) { return vaddq_f32(a, b); }
+  static Type Sub(Type a, Type b) { return vsubq_f32(a, b); }
+  static Type MulAdd(Type a, Type b, Type c) { return vfmaq_f32(c, a, b); }
+  static Type Abs(Type a) { return vabsq_f32(a); }
+  static float Sum(Type a) { return vaddvq_f32(a); }
+};
+
+#endif
+
+#endif // MLPACK_HAS_SIMD_KERNELS
+
+/**
+ * Return the squared Euclidean distance between the n-element arrays a and b.
+ * The element type must be float or double.
+ */
+template<typename eT>
+inline eT SquaredEuclidean(const eT* a, const eT* b, const size_t n)
+{
+  eT sum = 0;
+  size_t i = 0;
+
+#ifdef MLPACK_HAS_SIMD_KERNELS
+  typedef Register<eT> R;
+  // Two accumulators hide the latency of the fused multiply-add.
+  typename R::Type acc0 = R::Zero();
+  typename R::Type acc1 = R::Zero();
+  for (; i + 2 * R::width <= n; i += 2 * R::width)
+  {
+    const typename R::Type d0 = R::Sub(R::Load(a + i), R::Load(b + i));
+    const typename R::Type d1 = R::Sub(R::Load(a + i + R::width),
+        R::Load(b + i + R::width));
+    acc0 = R::MulAdd(d0, d0, acc0);
+    acc1 = R::MulAdd(d1, d1, acc1);
+  }
+  if (i + R::width <= n)
+  {
+    const typename R::Type d0 = R::Sub(R::Load(a + i), R::Load(b + i));
+    acc0 = R::MulAdd(d0, d0, acc0);
+    i += R::width;
+  }
+  sum = R::Sum(R::Add(acc0, acc1));
+#endif
+
+  for (; i < n; ++i)
+  {
+    const eT d = a[i] - b[i];
+    sum += d * d;
+  }
+
+  return sum;
+}
+
+/**
+ * Return the Manhattan (L1) distance between the n-element arrays a and b.
+ */
+template<typename eT>
+inline eT Manhattan(const eT* a, const eT* b, const size_t n)
+{
+  eT sum = 0;
+  size_t i = 0;
+
+#ifdef MLPACK_HAS_SIMD_KERNELS
+  typedef Register<eT> R;
+  typename R::Type acc0 = R::Zero();
+  typename R::Type acc1 = R::Zero();
+  for (; i + 2 * R::width <= n; i += 2 * R::width)
+  {
+    acc0 = R::Add(acc0, R::Abs(R::Sub(R::Load(a + i), R::Load(b + i))));
+    acc1 = R::Add(acc1, R::Abs(R::Sub(R::Load(a + i + R::width),
+        R::Load(b + i + R::width))));
+  }
+  if (i + R::width <= n)
+  {
+    acc0 = R::Add(acc0, R::Abs(R::Sub(R::Load(a + i), R::Load(b + i))));
+    i += R::width;
+  }
+  sum = R::Sum(R::Add(acc0, acc1));
+#endif
+
+  for (; i < n; ++i)
+    sum += std::abs(a[i] - b[i]);
+
+  return sum;
+}
+
+/**
+ * Return the inner product of the n-element arrays a and b.
+ */
+template<typename eT>
+inline eT Dot(const eT* a, const eT* b, const size_t n)
+{
+  eT sum = 0;
+  size_t i = 0;
+
+#ifdef MLPACK_HAS_SIMD_KERNELS
+  typedef Register<eT> R;
+  typename R::Type acc0 = R::Zero();
+  typename R::Type acc1 = R::Zero();
+  for (; i + 2 * R::width <= n; i += 2 * R::width)
+  {
+    acc0 = R::MulAdd(R::Load(a + i), R::Load(b + i), acc0);
+    acc1 = R::MulAdd(R::Load(a + i + R::width), R::Load(b + i + R::width),
+        acc1);
+  }
+  if (i + R::width <= n)
+  {
+    acc0 = R::MulAdd(R::Load(a + i), R::Load(b + i), acc0);
+    i += R::width;
+  }
+  sum = R::Sum(R::Add(acc0, acc1));
+#endif
+
+  for (; i < n; ++i)
+    sum += a[i] * b[i];
+
+  return sum;
+}
+
+/**
+ * Whether or not the elements of the given Armadillo type are stored
+ * contiguously in memory (and so can be passed to the raw pointer kernels).
+ */
+template<typename VecType>
+struct IsContiguous
+{
+  static const bool value = false;
+};
+
+template<typename eT>
+struct IsContiguous<arma::Mat<eT>>
+{
+  static const bool value = true;
+};
+
+template<typename eT>
+struct IsContiguous<arma::Col<eT>>
+{
+  static const bool value = true;
+};
+
+template<typename eT>
+struct IsContiguous<arma::Row<eT>>
+{
+  static const bool value = true;
+};
+
+template<typename eT>
+struct IsContiguous<arma::subview_col<eT>>
+{
+  static const bool value = true;
+};
+
+/**
+ * Whether or not the vectorized kernels are used for the given pair of vector
+ * types: both must be contiguous with the same element type, which must be
+ * float or double, and an instruction set must be available.
+ */
+template<typename VecTypeA, typename VecTypeB>
+struct UseKernels
+{
+  typedef typename VecTypeA::elem_type ElemType;
+
+  static const bool value =
+#ifdef MLPACK_HAS_SIMD_KERNELS
+      IsContiguous<VecTypeA>::value &&
+      IsContiguous<VecTypeB>::value &&
+      std::is_same<ElemType, typename VecTypeB::elem_type>::value &&
+      (std::is_same<ElemType, float>::value ||
+       std::is_same<ElemType, double>::value);
+#else
+      false;
+#endif
+};
+
+//! Get the memory of a contiguous Armadillo object.
+template<typename eT>
+inline const eT* Memory(const arma::Mat<eT>& v) { return v.memptr(); }
+//! Get the memory of a contiguous Armadillo object.
+template<typename eT>
+inline const eT* Memory(const arma::subview_col<eT>& v) { return v.colmem; }
+
+/**
+ * Return the squared Euclidean distance between two Armadillo vectors, using
+ * the vectorized kernel when UseKernels allows it.
+ */
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type SquaredEuclidean(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if<
+        UseKernels<VecTypeA, VecTypeB>::value>::type* = 0)
+{
+  // Let Armadillo report vectors of different sizes.
+  if (a.n_elem != b.n_elem)
+    return arma::accu(arma::square(a - b));
+
+  return SquaredEuclidean(Memory(a), Memory(b), a.n_elem);
+}
+
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type SquaredEuclidean(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if<
+        !UseKernels<VecTypeA, VecTypeB>::value>::type* = 0)
+{
+  return arma::accu(arma::square(a - b));
+}
+
+/**
+ * Return the Manhattan distance between two Armadillo vectors, using the
+ * vectorized kernel when UseKernels allows it.
+ */
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type Manhattan(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if<
+        UseKernels<VecTypeA, VecTypeB>::value>::type* = 0)
+{
+  // Let Armadillo report vectors of different sizes.
+  if (a.n_elem != b.n_elem)
+    return arma::accu(arma::abs(a - b));
+
+  return Manhattan(Memory(a), Memory(b), a.n_elem);
+}
+
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type Manhattan(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if<
+        !UseKernels<VecTypeA, VecTypeB>::value>::type* = 0)
+{
+  return arma::accu(arma::abs(a - b));
+}
+
+/**
+ * Return the inner product of two Armadillo vectors, using the vectorized
+ * kernel when UseKernels allows it.
+ */
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type Dot(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if<
+        UseKernels<VecTypeA, VecTypeB>::value>::type* = 0)
+{
+  // Let Armadillo report vectors of different sizes.
+  if (a.n_elem != b.n_elem)
+    return arma::dot(a, b);
+
+  return Dot(Memory(a), Memory(b), a.n_elem);
+}
+
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type Dot(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if<
+        !UseKernels<VecTypeA, VecTypeB>::value>::type* = 0)
+{
+  return arma::dot(a, b);
+}
+
+} // namespace simd
+} // namespace metric
+} // namespace mlpack
+
+#endif
@@ -134,6 +134,16 @@ class AdaGrad
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return optimizer.Shuffle(); }
 
+  //! Get the checkpointing settings.
+  const Checkpoint& Checkpointing() const { return optimizer.Checkpointing(); }
+  //! Modify the checkpointing settings.
+  Checkpoint& Checkpointing() { return optimizer.Checkpointing(); }
+
+  //! Get the callbacks.
+  const CallbackList& Callbacks() const { return optimizer.Callbacks(); }
+  //! Modify the callbacks.
+  CallbackList& Callbacks() { return optimizer.Callbacks(); }
+
  private:
   //! The Stochastic Gradient Descent object with AdaGrad policy.
   SGD<AdaGradUpdate> optimizer;
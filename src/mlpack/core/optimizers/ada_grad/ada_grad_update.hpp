@@ -89,6 +89,14 @@ class AdaGradUpdate
   //! Modify the value used to initialise the squared gradient parameter.
   double& Epsilon() { return epsilon; }
 
+  //! Serialize the update policy, including its state.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(squaredGradient);
+  }
+
  private:
   // The epsilon value used to initialise the squared gradient parameter.
   double epsilon;
@@ -13,6 +13,8 @@
  * simply a variant of Adam based on the infinity norm. AMSGrad is another
  * variant of Adam with guaranteed convergence. Nadam is another variant of 
  * Adam based on NAG. NadaMax is a variant for Nadam based on Infinity form.
+ * LazyAdam is a variant of Adam for sparse gradients that only updates the
+ * parameters whose gradient is not exactly zero.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -28,6 +30,7 @@
 #include "adam_update.hpp"
 #include "adamax_update.hpp"
 #include "amsgrad_update.hpp"
+#include "lazy_adam_update.hpp"
 #include "nadam_update.hpp"
 #include "nadamax_update.hpp"
 #include "optimisticadam_update.hpp"
@@ -172,6 +175,16 @@ class AdamType
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return optimizer.Shuffle(); }
 
+  //! Get the checkpointing settings.
+  const Checkpoint& Checkpointing() const { return optimizer.Checkpointing(); }
+  //! Modify the checkpointing settings.
+  Checkpoint& Checkpointing() { return optimizer.Checkpointing(); }
+
+  //! Get the callbacks.
+  const CallbackList& Callbacks() const { return optimizer.Callbacks(); }
+  //! Modify the callbacks.
+  CallbackList& Callbacks() { return optimizer.Callbacks(); }
+
  private:
   //! The Stochastic Gradient Descent object with Adam policy.
   SGD<UpdateRule> optimizer;
@@ -189,6 +202,8 @@ using NadaMax = AdamType<NadaMaxUpdate>;
 
 using OptimisticAdam = AdamType<OptimisticAdamUpdate>;
 
+using LazyAdam = AdamType<LazyAdamUpdate>;
+
 } // namespace optimization
 } // namespace mlpack
 
@@ -88,23 +88,28 @@ class AdamUpdate
     // Increment the iteration counter variable.
     ++iteration;
 
-    // And update the iterate.
-    m *= beta1;
-    m += (1 - beta1) * gradient;
-
-    v *= beta2;
-    v += (1 - beta2) * (gradient % gradient);
-
     const double biasCorrection1 = 1.0 - std::pow(beta1, iteration);
     const double biasCorrection2 = 1.0 - std::pow(beta2, iteration);
+    const double scale = stepSize * std::sqrt(biasCorrection2) /
+        biasCorrection1;
 
     /**
+     * Update both moments and the iterate in a single pass over the memory.
+     *
      * It should be noted that the term, m / (arma::sqrt(v) + eps), in the
      * following expression is an approximation of the following actual term;
      * m / (arma::sqrt(v) + (arma::sqrt(biasCorrection2) * eps).
      */
-    iterate -= (stepSize * std::sqrt(biasCorrection2) / biasCorrection1) *
-        m / (arma::sqrt(v) + epsilon);
+    double* it = iterate.memptr();
+    double* mMem = m.memptr();
+    double* vMem = v.memptr();
+    const double* g = gradient.memptr();
+    for (size_t i = 0; i < iterate.n_elem; ++i)
+    {
+      mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+      vMem[i] = beta2 * vMem[i] + (1 - beta2) * (g[i] * g[i]);
+      it[i] -= scale * mMem[i] / (std::sqrt(vMem[i]) + epsilon);
+    }
   }
 
   //! Get the value used to initialise the squared gradient parameter.
@@ -122,6 +127,18 @@ class AdamUpdate
   //! Modify the second moment coefficient.
   double& Beta2() { return beta2; }
 
+  //! Serialize the update policy, including its state.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(beta1);
+    ar & BOOST_SERIALIZATION_NVP(beta2);
+    ar & BOOST_SERIALIZATION_NVP(m);
+    ar & BOOST_SERIALIZATION_NVP(v);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+  }
+
  private:
   // The epsilon value used to initialise the squared gradient parameter.
   double epsilon;
@@ -90,18 +90,22 @@ class AdaMaxUpdate
     // Increment the iteration counter variable.
     ++iteration;
 
-    // And update the iterate.
-    m *= beta1;
-    m += (1 - beta1) * gradient;
-
-    // Update the exponentially weighted infinity norm.
-    u *= beta2;
-    u = arma::max(u, arma::abs(gradient));
-
     const double biasCorrection1 = 1.0 - std::pow(beta1, iteration);
-
-    if (biasCorrection1 != 0)
-      iterate -= (stepSize / biasCorrection1 * m / (u + epsilon));
+    const double scale = stepSize / biasCorrection1;
+
+    // Update the moment, the exponentially weighted infinity norm and the
+    // iterate in a single pass over the memory.
+    double* it = iterate.memptr();
+    double* mMem = m.memptr();
+    double* uMem = u.memptr();
+    const double* g = gradient.memptr();
+    for (size_t i = 0; i < iterate.n_elem; ++i)
+    {
+      mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+      uMem[i] = std::max(beta2 * uMem[i], std::abs(g[i]));
+      if (biasCorrection1 != 0)
+        it[i] -= scale * mMem[i] / (uMem[i] + epsilon);
+    }
   }
 
   //! Get the value used to initialise the squared gradient parameter.
@@ -119,6 +123,18 @@ class AdaMaxUpdate
   //! Modify the second moment coefficient.
   double& Beta2() { return beta2; }
 
+  //! Serialize the update policy, including its state.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(beta1);
+    ar & BOOST_SERIALIZATION_NVP(beta2);
+    ar & BOOST_SERIALIZATION_NVP(m);
+    ar & BOOST_SERIALIZATION_NVP(u);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+  }
+
  private:
   // The epsilon value used to initialise the squared gradient parameter.
   double epsilon;
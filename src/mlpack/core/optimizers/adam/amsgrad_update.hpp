@@ -84,21 +84,25 @@ class AMSGradUpdate
     // Increment the iteration counter variable.
     ++iteration;
 
-    // And update the iterate.
-    m *= beta1;
-    m += (1 - beta1) * gradient;
-
-    v *= beta2;
-    v += (1 - beta2) * (gradient % gradient);
-
     const double biasCorrection1 = 1.0 - std::pow(beta1, iteration);
     const double biasCorrection2 = 1.0 - std::pow(beta2, iteration);
-
-    // Element wise maximum of past and present squared gradients.
-    vImproved = arma::max(vImproved, v);
-
-    iterate -= (stepSize * std::sqrt(biasCorrection2) / biasCorrection1) *
-                m / (arma::sqrt(vImproved) + epsilon);
+    const double scale = stepSize * std::sqrt(biasCorrection2) /
+        biasCorrection1;
+
+    // Update the moments, their element wise maximum of past and present
+    // squared gradients, and the iterate in a single pass over the memory.
+    double* it = iterate.memptr();
+    double* mMem = m.memptr();
+    double* vMem = v.memptr();
+    double* vImprovedMem = vImproved.memptr();
+    const double* g = gradient.memptr();
+    for (size_t i = 0; i < iterate.n_elem; ++i)
+    {
+      mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+      vMem[i] = beta2 * vMem[i] + (1 - beta2) * (g[i] * g[i]);
+      vImprovedMem[i] = std::max(vImprovedMem[i], vMem[i]);
+      it[i] -= scale * mMem[i] / (std::sqrt(vImprovedMem[i]) + epsilon);
+    }
   }
 
   //! Get the value used to initialise the squared gradient parameter.
@@ -116,6 +120,19 @@ class AMSGradUpdate
   //! Modify the second moment coefficient.
   double& Beta2() { return beta2; }
 
+  //! Serialize the update policy, including its state.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(beta1);
+    ar & BOOST_SERIALIZATION_NVP(beta2);
+    ar & BOOST_SERIALIZATION_NVP(m);
+    ar & BOOST_SERIALIZATION_NVP(v);
+    ar & BOOST_SERIALIZATION_NVP(vImproved);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+  }
+
  private:
   // The epsilon value used to initialise the squared gradient parameter.
   double epsilon;
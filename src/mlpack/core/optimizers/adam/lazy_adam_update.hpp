@@ -0,0 +1,171 @@
+/**
+ * @file lazy_adam_update.hpp
+ *
+ * Lazy Adam update rule, which only updates the moments and parameters whose
+ * gradient is non-zero.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_ADAM_LAZY_ADAM_UPDATE_HPP
+#define MLPACK_CORE_OPTIMIZERS_ADAM_LAZY_ADAM_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Lazy Adam is a variant of Adam for sparse gradients, like the gradient of an
+ * embedding table (see mlpack::ann::Lookup), where only the rows of the tokens
+ * in the batch are non-zero.  The moment estimates of a parameter are only
+ * decayed and updated in the iterations where its gradient is non-zero, and
+ * only those parameters take a step; all other parameters and their moments
+ * are left untouched.  An entry is skipped whenever its gradient is exactly
+ * zero, so this only matches Adam if no entry of the gradient is ever exactly
+ * zero; an entry that is exactly zero in a dense gradient keeps its moments,
+ * where Adam would decay them and take a step.
+ *
+ * There is no sparse gradient path: the optimizers pass dense gradients, the
+ * network still computes and clears the whole gradient (including the whole
+ * embedding table of a Lookup layer) for every batch, and the non-zero entries
+ * are found by scanning the whole gradient in each iteration.  Only the Adam
+ * update itself is restricted to the non-zero entries.
+ *
+ * The bias correction uses the global number of iterations, as Adam does.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{Kingma2014,
+ *   author  = {Diederik P. Kingma and Jimmy Ba},
+ *   title   = {Adam: {A} Method for Stochastic Optimization},
+ *   journal = {CoRR},
+ *   year    = {2014},
+ *   url     = {http://arxiv.org/abs/1412.6980}
+ * }
+ * @endcode
+ */
+class LazyAdamUpdate
+{
+ public:
+  /**
+   * Construct the lazy Adam update policy with the given parameters.
+   *
+   * @param epsilon The epsilon value used to initialise the squared gradient
+   *        parameter.
+   * @param beta1 The smoothing parameter.
+   * @param beta2 The second moment coefficient.
+   */
+  LazyAdamUpdate(const double epsilon = 1e-8,
+                 const double beta1 = 0.9,
+                 const double beta2 = 0.999) :
+    epsilon(epsilon),
+    beta1(beta1),
+    beta2(beta2),
+    iteration(0)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * The Initialize method is called by SGD Optimizer method before the start of
+   * the iteration update process.
+   *
+   * @param rows Number of rows in the gradient matrix.
+   * @param cols Number of columns in the gradient matrix.
+   */
+  void Initialize(const size_t rows, const size_t cols)
+  {
+    m = arma::zeros<arma::mat>(rows, cols);
+    v = arma::zeros<arma::mat>(rows, cols);
+  }
+
+  /**
+   * Update step for lazy Adam; only the entries whose gradient is not exactly
+   * zero are updated.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient)
+  {
+    // Increment the iteration counter variable.
+    ++iteration;
+
+    const double biasCorrection1 = 1.0 - std::pow(beta1, iteration);
+    const double biasCorrection2 = 1.0 - std::pow(beta2, iteration);
+    const double step = stepSize * std::sqrt(biasCorrection2) /
+        biasCorrection1;
+
+    const double* g = gradient.memptr();
+    double* mPtr = m.memptr();
+    double* vPtr = v.memptr();
+    double* x = iterate.memptr();
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+    {
+      if (g[i] == 0.0)
+        continue;
+
+      mPtr[i] = beta1 * mPtr[i] + (1 - beta1) * g[i];
+      vPtr[i] = beta2 * vPtr[i] + (1 - beta2) * g[i] * g[i];
+      x[i] -= step * mPtr[i] / (std::sqrt(vPtr[i]) + epsilon);
+    }
+  }
+
+  //! Get the value used to initialise the squared gradient parameter.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used to initialise the squared gradient parameter.
+  double& Epsilon() { return epsilon; }
+
+  //! Get the smoothing parameter.
+  double Beta1() const { return beta1; }
+  //! Modify the smoothing parameter.
+  double& Beta1() { return beta1; }
+
+  //! Get the second moment coefficient.
+  double Beta2() const { return beta2; }
+  //! Modify the second moment coefficient.
+  double& Beta2() { return beta2; }
+
+  //! Serialize the update policy, including its state.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(beta1);
+    ar & BOOST_SERIALIZATION_NVP(beta2);
+    ar & BOOST_SERIALIZATION_NVP(m);
+    ar & BOOST_SERIALIZATION_NVP(v);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+  }
+
+ private:
+  // The epsilon value used to initialise the squared gradient parameter.
+  double epsilon;
+
+  // The smoothing parameter.
+  double beta1;
+
+  // The second moment coefficient.
+  double beta2;
+
+  // The exponential moving average of gradient values.
+  arma::mat m;
+
+  // The exponential moving average of squared gradient values.
+  arma::mat v;
+
+  // The number of iterations.
+  double iteration;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -87,13 +87,6 @@ class NadamUpdate
     // Increment the iteration counter variable.
     ++iteration;
 
-    // And update the iterate.
-    m *= beta1;
-    m += (1 - beta1) * gradient;
-
-    v *= beta2;
-    v += (1 - beta2) * gradient % gradient;
-
     double beta1T = beta1 * (1 - (0.5 *
         std::pow(0.96, iteration * scheduleDecay)));
 
@@ -108,12 +101,26 @@ class NadamUpdate
 
     const double biasCorrection3 = 1.0 - (cumBeta1 * beta1T1);
 
-    /* Note :- arma::sqrt(v) + epsilon * sqrt(biasCorrection2) is approximated
+    const double gradientScale = (1 - beta1T) / biasCorrection1;
+    const double mScale = beta1T1 / biasCorrection3;
+    const double sqrtBiasCorrection2 = std::sqrt(biasCorrection2);
+
+    /* Update both moments and the iterate in a single pass over the memory.
+     *
+     * Note :- arma::sqrt(v) + epsilon * sqrt(biasCorrection2) is approximated
      * as arma::sqrt(v) + epsilon
      */
-    iterate -= (stepSize * (((1 - beta1T) / biasCorrection1) * gradient
-        + (beta1T1 / biasCorrection3) * m) * sqrt(biasCorrection2))
-        / (arma::sqrt(v) + epsilon);
+    double* it = iterate.memptr();
+    double* mMem = m.memptr();
+    double* vMem = v.memptr();
+    const double* g = gradient.memptr();
+    for (size_t i = 0; i < iterate.n_elem; ++i)
+    {
+      mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+      vMem[i] = beta2 * vMem[i] + (1 - beta2) * g[i] * g[i];
+      it[i] -= (stepSize * (gradientScale * g[i] + mScale * mMem[i]) *
+          sqrtBiasCorrection2) / (std::sqrt(vMem[i]) + epsilon);
+    }
   }
 
   //! Get the value used to initialise the squared gradient parameter.
@@ -141,6 +148,20 @@ class NadamUpdate
   //! Modify the decay parameter for decay coefficients
   double& ScheduleDecay() { return scheduleDecay; }
 
+  //! Serialize the update policy, including its state.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(beta1);
+    ar & BOOST_SERIALIZATION_NVP(beta2);
+    ar & BOOST_SERIALIZATION_NVP(m);
+    ar & BOOST_SERIALIZATION_NVP(v);
+    ar & BOOST_SERIALIZATION_NVP(scheduleDecay);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+    ar & BOOST_SERIALIZATION_NVP(cumBeta1);
+  }
+
  private:
   // The epsilon value used to initialise the squared gradient parameter.
   double epsilon;
@@ -87,12 +87,6 @@ class NadaMaxUpdate
     // Increment the iteration counter variable.
     ++iteration;
 
-    // And update the iterate.
-    m *= beta1;
-    m += (1 - beta1) * gradient;
-
-    u = arma::max(u * beta2, arma::abs(gradient));
-
     double beta1T = beta1 * (1 - (0.5 *
         std::pow(0.96, iteration * scheduleDecay)));
 
@@ -105,10 +99,25 @@ class NadaMaxUpdate
 
     const double biasCorrection2 = 1.0 - (cumBeta1 * beta1T1);
 
-    if ((biasCorrection1 != 0) && (biasCorrection2 != 0))
+    const bool step = (biasCorrection1 != 0) && (biasCorrection2 != 0);
+    const double gradientScale = (1 - beta1T) / biasCorrection1;
+    const double mScale = beta1T1 / biasCorrection2;
+
+    // Update the moment, the exponentially weighted infinity norm and the
+    // iterate in a single pass over the memory.
+    double* it = iterate.memptr();
+    double* mMem = m.memptr();
+    double* uMem = u.memptr();
+    const double* g = gradient.memptr();
+    for (size_t i = 0; i < iterate.n_elem; ++i)
     {
-       iterate -= (stepSize * (((1 - beta1T) / biasCorrection1) * gradient
-           + (beta1T1 / biasCorrection2) * m)) / (u + epsilon);
+      mMem[i] = beta1 * mMem[i] + (1 - beta1) * g[i];
+      uMem[i] = std::max(uMem[i] * beta2, std::abs(g[i]));
+      if (step)
+      {
+        it[i] -= (stepSize * (gradientScale * g[i] + mScale * mMem[i])) /
+            (uMem[i] + epsilon);
+      }
     }
   }
 
@@ -137,6 +146,20 @@ class NadaMaxUpdate
   //! Modify the decay parameter for decay coefficients
   double& ScheduleDecay() { return scheduleDecay; }
 
+  //! Serialize the update policy, including its state.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(beta1);
+    ar & BOOST_SERIALIZATION_NVP(beta2);
+    ar & BOOST_SERIALIZATION_NVP(m);
+    ar & BOOST_SERIALIZATION_NVP(u);
+    ar & BOOST_SERIALIZATION_NVP(scheduleDecay);
+    ar & BOOST_SERIALIZATION_NVP(cumBeta1);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+  }
+
  private:
   // The epsilon value used to initialise the squared gradient parameter.
   double epsilon;
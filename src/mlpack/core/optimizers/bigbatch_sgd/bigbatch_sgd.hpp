@@ -108,13 +108,20 @@ class BigBatchSGD
    * @param tolerance Maximum absolute tolerance to terminate algorithm.
    * @param shuffle If true, the batch order is shuffled; otherwise, each
    *        batch is visited in linear order.
+   * @param parallel If true, the gradients and the gradient variance of each
+   *        batch are computed in parallel, with one part of the batch per
+   *        thread; then Gradient() has to be safe to call from several
+   *        threads at once.  The parallel variance is the exact sum of the
+   *        squared deviations of the gradients, so the batch sizes may differ
+   *        slightly from the serial estimate.
    */
   BigBatchSGD(const size_t batchSize = 1000,
               const double stepSize = 0.01,
               const double batchDelta = 0.1,
               const size_t maxIterations = 100000,
               const double tolerance = 1e-5,
-              const bool shuffle = true);
+              const bool shuffle = true,
+              const bool parallel = false);
   /**
    * Optimize the given function using big-batch SGD.  The given starting point
    * will be modified to store the finishing point of the algorithm, and the
@@ -159,12 +166,44 @@ class BigBatchSGD
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return shuffle; }
 
+  //! Get whether the batches are computed in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the batches are computed in parallel.
+  bool& Parallel() { return parallel; }
+
   //! Get the update policy.
   UpdatePolicyType UpdatePolicy() const { return updatePolicy; }
   //! Modify the update policy.
   UpdatePolicyType& UpdatePolicy() { return updatePolicy; }
 
  private:
+  /**
+   * Add the gradients of the given functions to the given gradient sum, and
+   * update the mean and the sum of squared deviations from the mean of all
+   * gradients seen so far.  Every thread accumulates a contiguous part of the
+   * functions with Welford's method, and the parts are merged in order, so
+   * the result does not depend on the scheduling.
+   *
+   * @param function Function to differentiate.
+   * @param iterate Point at which the gradients are computed.
+   * @param begin First function.
+   * @param count Number of functions.
+   * @param gradient Sum of the gradients (updated).
+   * @param mean Mean of the gradients (updated).
+   * @param variance Sum of the squared deviations of the gradients from their
+   *     mean (updated).
+   * @param n Number of gradients seen so far (updated).
+   */
+  template<typename DecomposableFunctionType>
+  void ParallelGradients(DecomposableFunctionType& function,
+                         const arma::mat& iterate,
+                         const size_t begin,
+                         const size_t count,
+                         arma::mat& gradient,
+                         arma::mat& mean,
+                         double& variance,
+                         size_t& n) const;
+
   //! The size of the current batch.
   size_t batchSize;
 
@@ -184,6 +223,9 @@ class BigBatchSGD
   //! iterating.
   bool shuffle;
 
+  //! Whether the batches are computed in parallel.
+  bool parallel;
+
   //! The update policy used to update the parameters in each iteration.
   UpdatePolicyType updatePolicy;
 };
@@ -16,6 +16,11 @@
 #include "bigbatch_sgd.hpp"
 
 #include <mlpack/core/optimizers/function.hpp>
+#include <mlpack/core/optimizers/full_gradient.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace optimization {
@@ -27,13 +32,15 @@ BigBatchSGD<UpdatePolicyType>::BigBatchSGD(
     const double batchDelta,
     const size_t maxIterations,
     const double tolerance,
-    const bool shuffle) :
+    const bool shuffle,
+    const bool parallel) :
     batchSize(batchSize),
     stepSize(stepSize),
     batchDelta(batchDelta),
     maxIterations(maxIterations),
     tolerance(tolerance),
     shuffle(shuffle),
+    parallel(parallel),
     updatePolicy(UpdatePolicyType())
 { /* Nothing to do. */ }
 
@@ -111,21 +118,33 @@ double BigBatchSGD<UpdatePolicyType>::Optimize(
     size_t k = 1;
     double vB = 0;
 
-    // Compute the stochastic gradient estimation.
-    f.Gradient(iterate, currentFunction, gradient, 1);
-
-    delta1 = gradient;
-    for (size_t j = 1; j < effectiveBatchSize; ++j, ++k)
+    if (parallel)
+    {
+      // Compute the gradient estimation and the sample variance with one part
+      // of the batch per thread.
+      k = 0;
+      gradient.zeros();
+      ParallelGradients(f, iterate, currentFunction, effectiveBatchSize,
+          gradient, delta1, vB, k);
+    }
+    else
     {
-      f.Gradient(iterate, currentFunction + j, functionGradient, 1);
-      delta0 = delta1 + (functionGradient - delta1) / k;
+      // Compute the stochastic gradient estimation.
+      f.Gradient(iterate, currentFunction, gradient, 1);
+
+      delta1 = gradient;
+      for (size_t j = 1; j < effectiveBatchSize; ++j, ++k)
+      {
+        f.Gradient(iterate, currentFunction + j, functionGradient, 1);
+        delta0 = delta1 + (functionGradient - delta1) / k;
 
-      // Compute sample variance.
-      vB += arma::norm(functionGradient - delta1, 2.0) *
-          arma::norm(functionGradient - delta0, 2.0);
+        // Compute sample variance.
+        vB += arma::norm(functionGradient - delta1, 2.0) *
+            arma::norm(functionGradient - delta0, 2.0);
 
-      delta1 = delta0;
-      gradient += functionGradient;
+        delta1 = delta0;
+        gradient += functionGradient;
+      }
     }
     double gB = std::pow(arma::norm(gradient / effectiveBatchSize, 2), 2.0);
 
@@ -149,17 +168,25 @@ double BigBatchSGD<UpdatePolicyType>::Optimize(
         // Update the stochastic gradient estimation.
         const size_t batchStart = (currentFunction + batchSize + batchOffset
             - 1) < numFunctions ? currentFunction + batchSize - 1 : 0;
-        for (size_t j = 0; j < batchOffset; ++j, ++k)
+        if (parallel)
         {
-          f.Gradient(iterate, batchStart + j, functionGradient, 1);
-          delta0 = delta1 + (functionGradient - delta1) / (k + 1);
-
-          // Compute sample variance.
-          vB += arma::norm(functionGradient - delta1, 2.0) *
-              arma::norm(functionGradient - delta0, 2.0);
-
-          delta1 = delta0;
-          gradient += functionGradient;
+          ParallelGradients(f, iterate, batchStart, batchOffset, gradient,
+              delta1, vB, k);
+        }
+        else
+        {
+          for (size_t j = 0; j < batchOffset; ++j, ++k)
+          {
+            f.Gradient(iterate, batchStart + j, functionGradient, 1);
+            delta0 = delta1 + (functionGradient - delta1) / (k + 1);
+
+            // Compute sample variance.
+            vB += arma::norm(functionGradient - delta1, 2.0) *
+                arma::norm(functionGradient - delta0, 2.0);
+
+            delta1 = delta0;
+            gradient += functionGradient;
+          }
         }
         gB = std::pow(arma::norm(gradient / (batchSize + batchOffset), 2), 2.0);
 
@@ -189,13 +216,75 @@ double BigBatchSGD<UpdatePolicyType>::Optimize(
       << "reached; terminating optimization." << std::endl;
 
   // Calculate final objective.
-  overallObjective = 0;
-  for (size_t i = 0; i < numFunctions; i += batchSize)
+  return FullObjective(f, iterate, batchSize, parallel);
+}
+
+template<typename UpdatePolicyType>
+template<typename DecomposableFunctionType>
+void BigBatchSGD<UpdatePolicyType>::ParallelGradients(
+    DecomposableFunctionType& function,
+    const arma::mat& iterate,
+    const size_t begin,
+    const size_t count,
+    arma::mat& gradient,
+    arma::mat& mean,
+    double& variance,
+    size_t& n) const
+{
+  #ifdef HAS_OPENMP
+    const size_t numParts = std::max(std::min((size_t) omp_get_max_threads(),
+        count), (size_t) 1);
+  #else
+    const size_t numParts = 1;
+  #endif
+
+  std::vector<arma::mat> sums(numParts), means(numParts);
+  std::vector<double> variances(numParts, 0.0);
+
+  #pragma omp parallel for schedule(static) num_threads(numParts)
+  for (omp_size_t p = 0; p < (omp_size_t) numParts; ++p)
+  {
+    const size_t partBegin = begin + (p * count) / numParts;
+    const size_t partEnd = begin + ((p + 1) * count) / numParts;
+
+    arma::mat functionGradient, delta;
+    sums[p].zeros(iterate.n_rows, iterate.n_cols);
+    means[p].zeros(iterate.n_rows, iterate.n_cols);
+    for (size_t j = partBegin; j < partEnd; ++j)
+    {
+      function.Gradient(iterate, j, functionGradient, 1);
+      sums[p] += functionGradient;
+
+      delta = functionGradient - means[p];
+      means[p] += delta / (double) (j - partBegin + 1);
+      variances[p] += arma::dot(delta, functionGradient - means[p]);
+    }
+  }
+
+  // Merge the parts into the running statistics in order.
+  for (size_t p = 0; p < numParts; ++p)
   {
-    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
-    overallObjective += f.Evaluate(iterate, i, effectiveBatchSize);
+    const size_t partSize = ((p + 1) * count) / numParts - (p * count) /
+        numParts;
+    if (partSize == 0)
+      continue;
+
+    gradient += sums[p];
+    if (n == 0)
+    {
+      mean = std::move(means[p]);
+      variance = variances[p];
+    }
+    else
+    {
+      const double total = (double) (n + partSize);
+      const arma::mat delta = means[p] - mean;
+      mean += delta * (partSize / total);
+      variance += variances[p] + arma::dot(delta, delta) * n * partSize /
+          total;
+    }
+    n += partSize;
   }
-  return overallObjective;
 }
 
 } // namespace optimization
@@ -0,0 +1,158 @@
+/**
+ * @file callback.hpp
+ *
+ * The interface for callbacks that optimizers invoke while they run, and a
+ * list of callbacks as held by an optimizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_CALLBACK_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_CALLBACK_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * A Callback is notified by an optimizer of the events of a run: the start and
+ * the end of the optimization, every evaluation of the objective, every step
+ * and, for optimizers that make passes over a separable function (like SGD),
+ * the end of every epoch.  Each method has an empty default implementation, so
+ * a callback only overrides the events it is interested in.
+ *
+ * The methods that return a bool can stop the optimization: if any callback
+ * returns true, the optimizer terminates as if it had converged.
+ *
+ * For example, a callback that prints the objective after every epoch:
+ *
+ * @code
+ * class PrintLoss : public Callback
+ * {
+ *  public:
+ *   bool EndEpoch(const arma::mat&, const size_t epoch, const double objective)
+ *   {
+ *     std::cout << "epoch " << epoch << ": " << objective << std::endl;
+ *     return false;
+ *   }
+ * };
+ *
+ * PrintLoss print;
+ * StandardSGD sgd;
+ * sgd.Callbacks().Add(print);
+ * sgd.Optimize(f, coordinates);
+ * @endcode
+ */
+class Callback
+{
+ public:
+  virtual ~Callback() { }
+
+  //! Called before the first iteration with the starting point.
+  virtual void BeginOptimization(const arma::mat& /* iterate */) { }
+
+  //! Called when the optimizer has evaluated the objective at the iterate.
+  virtual bool Evaluate(const arma::mat& /* iterate */,
+                        const double /* objective */)
+  {
+    return false;
+  }
+
+  //! Called after each step of the optimizer; the objective is the one the
+  //! step was computed with (for SGD, the objective of the batch).
+  virtual bool StepTaken(const arma::mat& /* iterate */,
+                         const double /* objective */)
+  {
+    return false;
+  }
+
+  //! Called after each full pass over the function (numbered from 1); the
+  //! objective is the sum of the objectives seen during the pass.
+  virtual bool EndEpoch(const arma::mat& /* iterate */,
+                        const size_t /* epoch */,
+                        const double /* objective */)
+  {
+    return false;
+  }
+
+  //! Called when the optimization ends, with the final point.  The iterate
+  //! may be modified (for instance, to restore the best point seen).
+  virtual void EndOptimization(arma::mat& /* iterate */) { }
+};
+
+/**
+ * The list of callbacks of an optimizer.  The callbacks are not owned by the
+ * list; they have to outlive every optimization they are added to.  Every
+ * event is passed to all callbacks in the order they were added, and an event
+ * stops the optimization if any of the callbacks asks for it.
+ */
+class CallbackList
+{
+ public:
+  //! Add a callback to the list.
+  void Add(Callback& callback) { callbacks.push_back(&callback); }
+
+  //! Remove all callbacks.
+  void Clear() { callbacks.clear(); }
+
+  //! Get the number of callbacks.
+  size_t Size() const { return callbacks.size(); }
+
+  //! Pass the start of the optimization to all callbacks.
+  void BeginOptimization(const arma::mat& iterate)
+  {
+    for (Callback* callback : callbacks)
+      callback->BeginOptimization(iterate);
+  }
+
+  //! Pass an evaluation to all callbacks; returns true if one of them asks to
+  //! terminate.
+  bool Evaluate(const arma::mat& iterate, const double objective)
+  {
+    bool terminate = false;
+    for (Callback* callback : callbacks)
+      terminate |= callback->Evaluate(iterate, objective);
+    return terminate;
+  }
+
+  //! Pass a step to all callbacks; returns true if one of them asks to
+  //! terminate.
+  bool StepTaken(const arma::mat& iterate, const double objective)
+  {
+    bool terminate = false;
+    for (Callback* callback : callbacks)
+      terminate |= callback->StepTaken(iterate, objective);
+    return terminate;
+  }
+
+  //! Pass the end of an epoch to all callbacks; returns true if one of them
+  //! asks to terminate.
+  bool EndEpoch(const arma::mat& iterate,
+                const size_t epoch,
+                const double objective)
+  {
+    bool terminate = false;
+    for (Callback* callback : callbacks)
+      terminate |= callback->EndEpoch(iterate, epoch, objective);
+    return terminate;
+  }
+
+  //! Pass the end of the optimization to all callbacks.
+  void EndOptimization(arma::mat& iterate)
+  {
+    for (Callback* callback : callbacks)
+      callback->EndOptimization(iterate);
+  }
+
+ private:
+  //! The callbacks (not owned).
+  std::vector<Callback*> callbacks;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
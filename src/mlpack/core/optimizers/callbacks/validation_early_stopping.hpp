@@ -0,0 +1,244 @@
+/**
+ * @file validation_early_stopping.hpp
+ *
+ * A callback that evaluates a held-out objective after every epoch in a
+ * background thread and stops the optimization when it stops improving.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_VALIDATION_EARLY_STOPPING_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_VALIDATION_EARLY_STOPPING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "callback.hpp"
+
+#include <exception>
+#include <functional>
+#include <thread>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * ValidationEarlyStopping evaluates a validation objective (for instance, the
+ * loss of a network on a held-out set) on a snapshot of the parameters at the
+ * end of every epoch.  The evaluation runs in a background thread, so it
+ * overlaps with the next epoch of training instead of stalling it.  If the
+ * validation objective has not improved by more than minDelta for `patience`
+ * epochs, the optimization is stopped; by default the iterate is then set to
+ * the best point seen.
+ *
+ * Because the validation of an epoch finishes during the next epoch, the
+ * decision to stop is made one epoch after the validation that triggered it.
+ * The decisions don't depend on timing, so runs are reproducible.
+ *
+ * The validation objective runs concurrently with the optimizer, so it must
+ * not touch the function being optimized.  For an FFN, use a second network
+ * of the same architecture:
+ *
+ * @code
+ * FFN<> model, validationModel;
+ * // ... add the same layers to both ...
+ * ValidationEarlyStopping earlyStopping([&](const arma::mat& parameters)
+ *     {
+ *       validationModel.Parameters() = parameters;
+ *       return validationModel.Evaluate(validX, validY);
+ *     }, 5);
+ *
+ * Adam adam;
+ * adam.Callbacks().Add(earlyStopping);
+ * model.Train(trainX, trainY, adam);
+ * @endcode
+ */
+class ValidationEarlyStopping : public Callback
+{
+ public:
+  //! The type of the validation objective.
+  typedef std::function<double(const arma::mat&)> ObjectiveType;
+
+  /**
+   * Create the callback.
+   *
+   * @param objective Validation objective to minimize.
+   * @param patience Number of epochs without improvement before stopping.
+   * @param minDelta Minimum decrease of the objective that counts as an
+   *     improvement.
+   * @param restoreBest If true, the iterate is set to the point with the best
+   *     validation objective at the end of the optimization.
+   */
+  ValidationEarlyStopping(const ObjectiveType& objective,
+                          const size_t patience = 5,
+                          const double minDelta = 0.0,
+                          const bool restoreBest = true) :
+      objective(objective),
+      patience(patience),
+      minDelta(minDelta),
+      restoreBest(restoreBest),
+      pendingEpoch(0),
+      pendingObjective(0.0),
+      bestObjective(DBL_MAX),
+      bestEpoch(0),
+      epochsWithoutImprovement(0),
+      stop(false)
+  { /* Nothing to do. */ }
+
+  //! Wait for a running validation before destruction.
+  ~ValidationEarlyStopping()
+  {
+    if (worker.joinable())
+      worker.join();
+  }
+
+  //! Reset the history for a new optimization.
+  void BeginOptimization(const arma::mat& /* iterate */)
+  {
+    if (worker.joinable())
+      worker.join();
+    error = std::exception_ptr();
+
+    pendingEpoch = 0;
+    objectives.clear();
+    bestObjective = DBL_MAX;
+    bestEpoch = 0;
+    bestIterate.reset();
+    epochsWithoutImprovement = 0;
+    stop = false;
+  }
+
+  /**
+   * Collect the validation of the last epoch and start validating this one.
+   * Returns true if the validation objective has not improved for `patience`
+   * epochs.
+   */
+  bool EndEpoch(const arma::mat& iterate,
+                const size_t epoch,
+                const double /* objective */)
+  {
+    Collect();
+    if (stop)
+      return true;
+
+    snapshot = iterate;
+    pendingEpoch = epoch;
+    worker = std::thread([this]()
+    {
+      try
+      {
+        pendingObjective = objective(snapshot);
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+    });
+
+    return false;
+  }
+
+  //! Collect the last validation and restore the best point if requested.
+  void EndOptimization(arma::mat& iterate)
+  {
+    Collect();
+    if (restoreBest && bestEpoch > 0)
+      iterate = bestIterate;
+  }
+
+  //! Get the validation objective of every epoch validated so far.
+  const std::vector<double>& Objectives() const { return objectives; }
+
+  //! Get the best validation objective.
+  double BestObjective() const { return bestObjective; }
+  //! Get the epoch with the best validation objective (0 if none).
+  size_t BestEpoch() const { return bestEpoch; }
+
+  //! Get the number of epochs without improvement before stopping.
+  size_t Patience() const { return patience; }
+  //! Modify the number of epochs without improvement before stopping.
+  size_t& Patience() { return patience; }
+
+  //! Get the minimum decrease that counts as an improvement.
+  double MinDelta() const { return minDelta; }
+  //! Modify the minimum decrease that counts as an improvement.
+  double& MinDelta() { return minDelta; }
+
+  //! Get whether the best point is restored at the end.
+  bool RestoreBest() const { return restoreBest; }
+  //! Modify whether the best point is restored at the end.
+  bool& RestoreBest() { return restoreBest; }
+
+ private:
+  //! Wait for the running validation, if any, and record its result.
+  void Collect()
+  {
+    if (!worker.joinable())
+      return;
+
+    worker.join();
+    if (error)
+    {
+      std::exception_ptr e = error;
+      error = std::exception_ptr();
+      std::rethrow_exception(e);
+    }
+
+    objectives.push_back(pendingObjective);
+    Log::Info << "ValidationEarlyStopping: epoch " << pendingEpoch
+        << ", validation objective " << pendingObjective << "." << std::endl;
+
+    if (pendingObjective < bestObjective - minDelta)
+    {
+      bestObjective = pendingObjective;
+      bestEpoch = pendingEpoch;
+      bestIterate.swap(snapshot);
+      epochsWithoutImprovement = 0;
+    }
+    else if (++epochsWithoutImprovement >= patience)
+    {
+      Log::Info << "ValidationEarlyStopping: no improvement for " << patience
+          << " epochs (best objective " << bestObjective << " at epoch "
+          << bestEpoch << "); terminating optimization." << std::endl;
+      stop = true;
+    }
+  }
+
+  //! The validation objective.
+  ObjectiveType objective;
+  //! The number of epochs without improvement before stopping.
+  size_t patience;
+  //! The minimum decrease that counts as an improvement.
+  double minDelta;
+  //! Whether to restore the best point at the end.
+  bool restoreBest;
+
+  //! The thread running the current validation.
+  std::thread worker;
+  //! The point being validated.
+  arma::mat snapshot;
+  //! The epoch being validated.
+  size_t pendingEpoch;
+  //! The result of the running validation.
+  double pendingObjective;
+  //! The exception thrown by the running validation, if any.
+  std::exception_ptr error;
+
+  //! The validation objectives so far.
+  std::vector<double> objectives;
+  //! The best validation objective.
+  double bestObjective;
+  //! The epoch of the best validation objective.
+  size_t bestEpoch;
+  //! The point with the best validation objective.
+  arma::mat bestIterate;
+  //! The number of epochs since the last improvement.
+  size_t epochsWithoutImprovement;
+  //! Whether the optimization should stop.
+  bool stop;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * @file checkpoint.hpp
+ *
+ * A small helper that optimizers use to periodically write their state to disk
+ * and to resume from a previously written state.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CHECKPOINT_HPP
+#define MLPACK_CORE_OPTIMIZERS_CHECKPOINT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/load.hpp>
+#include <mlpack/core/data/save.hpp>
+#include <mlpack/core/data/extension.hpp>
+#include <mlpack/core/data/has_serialize.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Checkpoint holds the checkpointing settings of an optimizer.  If a filename
+ * is given, the optimizer will serialize its complete state (the iterate, the
+ * update and decay policy state, and its iteration counters) to that file
+ * every `interval` epochs (or iterations, for optimizers without a notion of
+ * epochs).  When the optimizer is started and the file already exists, the
+ * state is loaded and the optimization continues where the earlier run left
+ * off.  An empty filename (the default) disables checkpointing entirely.
+ *
+ * The file format is chosen from the extension of the filename, just like
+ * data::Save() (so "sgd.bin" gives a binary checkpoint and "sgd.xml" an XML
+ * checkpoint).  Each checkpoint is first written to a temporary file which is
+ * then renamed over the old checkpoint, so a job that is killed while writing
+ * never leaves a corrupt checkpoint behind.
+ *
+ * For example, to make SGD resumable:
+ *
+ * @code
+ * StandardSGD sgd(0.01, 32, 100000000);
+ * sgd.Checkpointing() = Checkpoint("sgd_state.bin", 10);
+ * sgd.Optimize(f, coordinates); // Picks up from sgd_state.bin if it exists.
+ * @endcode
+ */
+class Checkpoint
+{
+ public:
+  /**
+   * Create the checkpoint settings.
+   *
+   * @param filename File to write checkpoints to; empty means checkpointing
+   *     is disabled.
+   * @param interval Number of epochs (or iterations) between checkpoints.
+   * @param resume If true and the file exists, the optimizer resumes from it.
+   */
+  Checkpoint(const std::string& filename = "",
+             const size_t interval = 1,
+             const bool resume = true) :
+      filename(filename),
+      interval(interval),
+      resume(resume)
+  {
+    if (interval == 0)
+      throw std::invalid_argument("Checkpoint: interval must be positive");
+  }
+
+  //! Return whether checkpointing is enabled.
+  bool Enabled() const { return !filename.empty(); }
+
+  /**
+   * Return whether a checkpoint should be written after the given number of
+   * completed epochs (or iterations).
+   */
+  bool Due(const size_t count) const
+  {
+    return Enabled() && (count > 0) && (count % interval == 0);
+  }
+
+  /**
+   * Serialize the given state to the checkpoint file.  The write is atomic:
+   * either the old checkpoint or the new one is present afterwards.
+   */
+  template<typename T>
+  void Save(T& state) const
+  {
+    const std::string extension = data::Extension(filename);
+    const std::string tmpFilename = filename + ".tmp." + extension;
+    if (!data::Save(tmpFilename, "checkpoint", state, false))
+    {
+      Log::Warn << "Checkpoint: could not write '" << tmpFilename << "'; "
+          << "continuing without a checkpoint." << std::endl;
+      return;
+    }
+
+    if (std::rename(tmpFilename.c_str(), filename.c_str()) != 0)
+    {
+      Log::Warn << "Checkpoint: could not rename '" << tmpFilename << "' to '"
+          << filename << "'; continuing without a checkpoint." << std::endl;
+      std::remove(tmpFilename.c_str());
+      return;
+    }
+
+    Log::Info << "Checkpoint: wrote '" << filename << "'." << std::endl;
+  }
+
+  /**
+   * Load the state from the checkpoint file, if resuming is enabled and the
+   * file exists.  Returns true if the state was loaded.  A file that exists
+   * but cannot be loaded is an error, since silently restarting from scratch
+   * would overwrite it with the first new checkpoint.
+   */
+  template<typename T>
+  bool Load(T& state) const
+  {
+    if (!Enabled() || !resume || !std::ifstream(filename).good())
+      return false;
+
+    data::Load(filename, "checkpoint", state, true);
+    Log::Info << "Checkpoint: resuming from '" << filename << "'."
+        << std::endl;
+    return true;
+  }
+
+  //! Get the checkpoint filename.
+  const std::string& Filename() const { return filename; }
+  //! Modify the checkpoint filename.
+  std::string& Filename() { return filename; }
+
+  //! Get the number of epochs between checkpoints.
+  size_t Interval() const { return interval; }
+  //! Modify the number of epochs between checkpoints.
+  size_t& Interval() { return interval; }
+
+  //! Get whether an existing checkpoint is resumed from.
+  bool Resume() const { return resume; }
+  //! Modify whether an existing checkpoint is resumed from.
+  bool& Resume() { return resume; }
+
+ private:
+  //! The file to write checkpoints to.
+  std::string filename;
+
+  //! The number of epochs between checkpoints.
+  size_t interval;
+
+  //! Whether to resume from an existing checkpoint.
+  bool resume;
+};
+
+/**
+ * Serialize the given policy into a checkpoint if it has a serialize() method.
+ * Policies written outside of mlpack may not have one; those are simply
+ * skipped, and the optimizer reinitializes them when it resumes.
+ */
+template<typename Archive, typename PolicyType>
+void SerializePolicy(
+    Archive& ar,
+    const char* name,
+    PolicyType& policy,
+    const typename std::enable_if<
+        data::HasSerialize<PolicyType>::value>::type* = 0)
+{
+  ar & boost::serialization::make_nvp(name, policy);
+}
+
+template<typename Archive, typename PolicyType>
+void SerializePolicy(
+    Archive& /* ar */,
+    const char* /* name */,
+    PolicyType& /* policy */,
+    const typename std::enable_if<
+        !data::HasSerialize<PolicyType>::value>::type* = 0)
+{
+  // Nothing to do; the policy has no state we know how to save.
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 #define MLPACK_CORE_OPTIMIZERS_CMAES_CMAES_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/population_evaluation.hpp>
 
 #include "full_selection.hpp"
 #include "random_selection.hpp"
@@ -83,6 +84,9 @@ class CMAES
    * @param tolerance Maximum absolute tolerance to terminate algorithm.
    * @param selectionPolicy Instantiated selection policy used to calculate the
    *     objective.
+   * @param evaluation How the offspring of each iteration are evaluated; the
+   *     parallel modes require that the function's Evaluate() uses the
+   *     parameters it is given.
    */
   CMAES(const size_t lambda = 0,
         const double lowerBound = -10,
@@ -90,7 +94,8 @@ class CMAES
         const size_t batchSize = 32,
         const size_t maxIterations = 1000,
         const double tolerance = 1e-5,
-        const SelectionPolicyType& selectionPolicy = SelectionPolicyType());
+        const SelectionPolicyType& selectionPolicy = SelectionPolicyType(),
+        const PopulationEvaluation evaluation = SERIAL_EVALUATION);
 
   /**
    * Optimize the given function using CMA-ES. The given starting point will be
@@ -140,6 +145,11 @@ class CMAES
   //! Modify the selection policy.
   SelectionPolicyType& SelectionPolicy() { return selectionPolicy; }
 
+  //! Get how the offspring are evaluated.
+  PopulationEvaluation Evaluation() const { return evaluation; }
+  //! Modify how the offspring are evaluated.
+  PopulationEvaluation& Evaluation() { return evaluation; }
+
  private:
   //! Population size.
   size_t lambda;
@@ -161,6 +171,9 @@ class CMAES
 
   //! The selection policy used to calculate the objective.
   SelectionPolicyType selectionPolicy;
+
+  //! How the offspring are evaluated.
+  PopulationEvaluation evaluation;
 };
 
 /**
@@ -30,14 +30,16 @@ CMAES<SelectionPolicyType>::CMAES(const size_t lambda,
                                   const size_t batchSize,
                                   const size_t maxIterations,
                                   const double tolerance,
-                                  const SelectionPolicyType& selectionPolicy) :
+                                  const SelectionPolicyType& selectionPolicy,
+                                  const PopulationEvaluation evaluation) :
     lambda(lambda),
     lowerBound(lowerBound),
     upperBound(upperBound),
     batchSize(batchSize),
     maxIterations(maxIterations),
     tolerance(tolerance),
-    selectionPolicy(selectionPolicy)
+    selectionPolicy(selectionPolicy),
+    evaluation(evaluation)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
@@ -146,12 +148,15 @@ double CMAES<SelectionPolicyType>::Optimize(
 
       pPosition.slice(idx(j)) = mPosition.slice(idx0) + sigma(idx0) *
           pStep.slice(idx(j));
-
-      // Calculate the objective function.
-      pObjective(idx(j)) = selectionPolicy.Select(function, batchSize,
-          pPosition.slice(idx(j)));
     }
 
+    // Calculate the objective function of all offspring; the offspring are
+    // sampled first, so the evaluation doesn't draw from the random number
+    // generator concurrently with the sampling.
+    EvaluatePopulation(function, pPosition, pObjective, evaluation,
+        [&](DecomposableFunctionType& f, const arma::mat& position)
+        { return selectionPolicy.Select(f, batchSize, position); });
+
     // Sort population.
     idx = sort_index(pObjective);
 
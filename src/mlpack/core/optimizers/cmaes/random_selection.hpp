@@ -54,10 +54,22 @@ class RandomSelection
     // Find the number of functions to use.
     const size_t numFunctions = function.NumFunctions();
 
+    // Draw the selections first, in one critical section, so that candidates
+    // can be evaluated in parallel.
+    std::vector<size_t> selections;
+    #pragma omp critical(randomSelection)
+    {
+      for (size_t f = 0; f < std::floor(numFunctions * fraction);
+          f += batchSize)
+      {
+        selections.push_back(math::RandInt(0, numFunctions));
+      }
+    }
+
     double objective = 0;
-    for (size_t f = 0; f < std::floor(numFunctions * fraction); f += batchSize)
+    for (size_t i = 0; i < selections.size(); ++i)
     {
-      const size_t selection = math::RandInt(0, numFunctions);
+      const size_t selection = selections[i];
       const size_t effectiveBatchSize = std::min(batchSize,
           numFunctions - selection);
 
@@ -17,6 +17,7 @@
 #define MLPACK_CORE_OPTIMIZERS_CNE_CNE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/population_evaluation.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -66,6 +67,14 @@ namespace optimization {
  *
  * The final value and the parameters are returned by the Optimize() method.
  *
+ * The candidates of a generation can be evaluated in parallel (see
+ * PopulationEvaluation).  In the steady-state variant there are no
+ * generations: every thread repeatedly breeds one child from the current elite,
+ * evaluates it, and replaces the worst candidate of the population with it if
+ * the child is better, so that no thread waits for the slowest evaluation of a
+ * generation.  The steady-state variant breeds as many children as
+ * maxGenerations generations would, and ignores objectiveChange.
+ *
  * For CNE to work, a FunctionType template parameter is required.
  * This class must implement the following function:
  *
@@ -94,6 +103,10 @@ class CNE
    * @param objectiveChange Minimum change in best fitness values between two
    *     consecutive generations should be greater than threshold. If set to
    *     negative value, objectiveChange is not considered.
+   * @param evaluation How the candidates are evaluated; the parallel modes
+   *     require that the function's Evaluate() uses the parameters it is
+   *     given.
+   * @param steadyState Whether to use the asynchronous steady-state variant.
    */
   CNE(const size_t populationSize = 500,
       const size_t maxGenerations = 5000,
@@ -101,7 +114,9 @@ class CNE
       const double mutationSize = 0.02,
       const double selectPercent = 0.2,
       const double tolerance = 1e-5,
-      const double objectiveChange = 1e-5);
+      const double objectiveChange = 1e-5,
+      const PopulationEvaluation evaluation = SERIAL_EVALUATION,
+      const bool steadyState = false);
 
   /**
    * Optimize the given function using CNE. The given
@@ -151,7 +166,38 @@ class CNE
   //! Modify the termination criteria of change in fitness value.
   double& ObjectiveChange() { return objectiveChange; }
 
+  //! Get how the candidates are evaluated.
+  PopulationEvaluation Evaluation() const { return evaluation; }
+  //! Modify how the candidates are evaluated.
+  PopulationEvaluation& Evaluation() { return evaluation; }
+
+  //! Get whether the steady-state variant is used.
+  bool SteadyState() const { return steadyState; }
+  //! Modify whether the steady-state variant is used.
+  bool& SteadyState() { return steadyState; }
+
  private:
+  /**
+   * Optimize the given function with the asynchronous steady-state variant,
+   * starting from the evaluated population.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType>
+  double OptimizeSteadyState(DecomposableFunctionType& function,
+                             arma::mat& iterate);
+
+  /**
+   * Breed one child from two different parents of the elite of the current
+   * population, with crossover and mutation.
+   *
+   * @param child The new child.
+   */
+  void Breed(arma::mat& child);
+
   //! Reproduce candidates to create the next generation.
   void Reproduce();
 
@@ -205,6 +251,12 @@ class CNE
   //! Minimum change in best fitness values between two generations.
   double objectiveChange;
 
+  //! How the candidates are evaluated.
+  PopulationEvaluation evaluation;
+
+  //! Whether the steady-state variant is used.
+  bool steadyState;
+
   //! Number of candidates to become parent for the next generation.
   size_t numElite;
 
@@ -27,7 +27,9 @@ CNE::CNE(const size_t populationSize,
          const double mutationSize,
          const double selectPercent,
          const double tolerance,
-         const double objectiveChange) :
+         const double objectiveChange,
+         const PopulationEvaluation evaluation,
+         const bool steadyState) :
     populationSize(populationSize),
     maxGenerations(maxGenerations),
     mutationProb(mutationProb),
@@ -35,6 +37,8 @@ CNE::CNE(const size_t populationSize,
     selectPercent(selectPercent),
     tolerance(tolerance),
     objectiveChange(objectiveChange),
+    evaluation(evaluation),
+    steadyState(steadyState),
     numElite(0),
     elements(0)
 { /* Nothing to do here. */ }
@@ -83,6 +87,9 @@ double CNE::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
   Log::Info << "CNE initialized successfully. Optimization started."
       << std::endl;
 
+  if (steadyState)
+    return OptimizeSteadyState(function, iterate);
+
   // Find the fitness before optimization using given iterate parameters.
   size_t lastBestFitness = function.Evaluate(iterate);
 
@@ -90,13 +97,22 @@ double CNE::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
   for (size_t gen = 1; gen <= maxGenerations; gen++)
   {
     // Calculating fitness values of all candidates.
-    for (size_t i = 0; i < populationSize; i++)
+    if (evaluation == SERIAL_EVALUATION)
     {
-       // Select a candidate and insert the parameters in the function.
-       iterate = population.slice(i);
+      for (size_t i = 0; i < populationSize; i++)
+      {
+         // Select a candidate and insert the parameters in the function.
+         iterate = population.slice(i);
 
-       // Find fitness of candidate.
-       fitnessValues[i] = function.Evaluate(iterate);
+         // Find fitness of candidate.
+         fitnessValues[i] = function.Evaluate(iterate);
+      }
+    }
+    else
+    {
+      EvaluatePopulation(function, population, fitnessValues, evaluation,
+          [](DecomposableFunctionType& f, const arma::mat& candidate)
+          { return f.Evaluate(candidate); });
     }
 
     Log::Info << "Generation number: " << gen << " best fitness = "
@@ -132,6 +148,127 @@ double CNE::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
   return function.Evaluate(iterate);
 }
 
+//! Optimize the function with the asynchronous steady-state variant.
+template<typename DecomposableFunctionType>
+double CNE::OptimizeSteadyState(DecomposableFunctionType& function,
+                                arma::mat& iterate)
+{
+  // Calculating fitness values of all candidates.
+  if (evaluation == SERIAL_EVALUATION)
+  {
+    for (size_t i = 0; i < populationSize; i++)
+    {
+      iterate = population.slice(i);
+      fitnessValues[i] = function.Evaluate(iterate);
+    }
+  }
+  else
+  {
+    EvaluatePopulation(function, population, fitnessValues, evaluation,
+        [](DecomposableFunctionType& f, const arma::mat& candidate)
+        { return f.Evaluate(candidate); });
+  }
+
+  // Breed as many children as the generations would have.
+  const size_t maxChildren = maxGenerations * (populationSize - numElite);
+  size_t children = 0;
+  bool stop = (tolerance >= fitnessValues.min());
+
+  const size_t numThreads = PopulationEvaluationThreads(evaluation);
+  std::vector<DecomposableFunctionType> functions;
+  if (evaluation == PARALLEL_COPY_EVALUATION)
+    functions.assign(numThreads, function);
+
+  #pragma omp parallel for shared(functions, children, stop)
+  for (omp_size_t t = 0; t < (omp_size_t) numThreads; ++t)
+  {
+    DecomposableFunctionType& threadFunction = functions.empty() ? function :
+        functions[PopulationEvaluationThread()];
+
+    arma::mat child;
+    while (true)
+    {
+      // Breed a child from the current population.  The population and the
+      // random number generator are only used inside the critical sections.
+      bool done = false;
+      #pragma omp critical(cneSteadyState)
+      {
+        if (stop || children >= maxChildren)
+        {
+          done = true;
+        }
+        else
+        {
+          ++children;
+          Breed(child);
+        }
+      }
+
+      if (done)
+        break;
+
+      // Find fitness of the child while the other threads keep breeding.
+      double fitness;
+      if (evaluation == SERIAL_EVALUATION)
+      {
+        iterate = child;
+        fitness = threadFunction.Evaluate(iterate);
+      }
+      else
+      {
+        fitness = threadFunction.Evaluate(child);
+      }
+
+      // Replace the worst candidate if the child is better.
+      #pragma omp critical(cneSteadyState)
+      {
+        const size_t worst = fitnessValues.index_max();
+        if (fitness < fitnessValues[worst])
+        {
+          population.slice(worst) = child;
+          fitnessValues[worst] = fitness;
+        }
+
+        if (tolerance >= fitnessValues.min())
+          stop = true;
+      }
+    }
+  }
+
+  Log::Info << "CNE::Optimize(): bred " << children << " children, best "
+      << "fitness = " << fitnessValues.min() << "." << std::endl;
+
+  // Set the best candidate into the network parameters.
+  iterate = population.slice(fitnessValues.index_min());
+
+  return function.Evaluate(iterate);
+}
+
+//! Breed one child from two different parents of the elite.
+void CNE::Breed(arma::mat& child)
+{
+  index = arma::sort_index(fitnessValues);
+
+  // Select 2 different parents from elite group randomly [0, numElite).
+  const size_t mom = mlpack::math::RandInt(0, numElite);
+  size_t dad = mlpack::math::RandInt(0, numElite - 1);
+  if (dad >= mom)
+    dad++;
+
+  // Mix the genome weights of the parents with equal probability.
+  const arma::mat& momGenome = population.slice(index[mom]);
+  const arma::mat& dadGenome = population.slice(index[dad]);
+  const arma::mat selection = arma::randu(population.n_rows,
+      population.n_cols);
+  const arma::uvec fromDad = arma::find(selection <= 0.5);
+  child = momGenome;
+  child.elem(fromDad) = dadGenome.elem(fromDad);
+
+  // Mutate the weights of the child with small noise values.
+  child += (arma::randu(population.n_rows, population.n_cols) < mutationProb)
+      % (mutationSize * arma::randn(population.n_rows, population.n_cols));
+}
+
 //! Reproduce candidates to create the next generation.
 void CNE::Reproduce()
 {
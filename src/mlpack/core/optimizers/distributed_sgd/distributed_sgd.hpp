@@ -0,0 +1,225 @@
+/**
+ * @file distributed_sgd.hpp
+ *
+ * Synchronous data-parallel stochastic gradient descent over several MPI
+ * processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_SGD_DISTRIBUTED_SGD_HPP
+#define MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_SGD_DISTRIBUTED_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/sgd/update_policies/vanilla_update.hpp>
+#include <mlpack/core/optimizers/sgd/decay_policies/no_decay.hpp>
+
+#ifdef HAS_MPI
+  #include <mpi.h>
+#endif
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * DistributedSGD is synchronous data-parallel stochastic gradient descent: it
+ * is run in every process of an MPI job, and each process holds its own part
+ * of the data in its copy of the function.  In every step, each process
+ * computes the gradient of a batch of its own points, the gradients of all
+ * processes are summed with an all-reduce, and every process takes the same
+ * step with its copy of the update policy, so the iterates of the processes
+ * stay identical.  One step therefore processes up to batchSize points in each
+ * process.
+ *
+ * Any update policy of SGD (like VanillaUpdate, MomentumUpdate or AdamUpdate)
+ * and any decay policy can be used.  The gradients can be sent in single
+ * precision to halve the communication, and the iterate can be saved by the
+ * first process every given number of steps.
+ *
+ * MPI must be initialized before Optimize() is called, and every process must
+ * call Optimize() with the same starting point.  If mlpack was built without
+ * MPI (see the USE_MPI CMake option), the optimizer runs in a single process
+ * and behaves like SGD.
+ *
+ * For DistributedSGD to work, a DecomposableFunctionType template parameter is
+ * required, with the same API as for SGD.
+ *
+ * @tparam UpdatePolicyType Update policy used to take a step with the summed
+ *     gradient.  By default the vanilla update policy (see
+ *     mlpack::optimization::VanillaUpdate) is used.
+ * @tparam DecayPolicyType Decay policy used to adjust the step size.  By
+ *     default the step size isn't adjusted (i.e. NoDecay is used).
+ */
+template<typename UpdatePolicyType = VanillaUpdate,
+         typename DecayPolicyType = NoDecay>
+class DistributedSGD
+{
+ public:
+  /**
+   * Construct the DistributedSGD optimizer with the given parameters.  The
+   * maximum number of iterations refers to the maximum number of points that
+   * are processed by all processes together.
+   *
+   * @param stepSize Step size for each iteration.
+   * @param batchSize Number of points each process uses in each step.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, each process shuffles its points before every
+   *     pass; otherwise, the points are visited in linear order.
+   * @param updatePolicy Instantiated update policy used to adjust the given
+   *     parameters.
+   * @param decayPolicy Instantiated decay policy used to adjust the step size.
+   * @param resetPolicy Flag that determines whether update policy parameters
+   *     are reset before every Optimize call.
+   * @param compressGradients If true, the gradients are sent in single
+   *     precision.
+   * @param checkpointInterval Number of steps between two checkpoints (0 means
+   *     no checkpoints).
+   * @param checkpointFile File the first process saves the iterate to.
+   */
+  DistributedSGD(const double stepSize = 0.01,
+                 const size_t batchSize = 32,
+                 const size_t maxIterations = 100000,
+                 const double tolerance = 1e-5,
+                 const bool shuffle = true,
+                 const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
+                 const DecayPolicyType& decayPolicy = DecayPolicyType(),
+                 const bool resetPolicy = true,
+                 const bool compressGradients = false,
+                 const size_t checkpointInterval = 0,
+                 const std::string& checkpointFile = "");
+
+  /**
+   * Optimize the given function using distributed stochastic gradient descent.
+   * The given starting point will be modified to store the finishing point of
+   * the algorithm, and the objective value of all processes together is
+   * returned.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @param function Function to optimize; it holds the points of this process.
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType>
+  double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
+
+  //! Get the index of this process.
+  static size_t Rank();
+  //! Get the number of processes.
+  static size_t Processes();
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the batch size of each process.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size of each process.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get whether or not the update policy parameters
+  //! are reset before Optimize call.
+  bool ResetPolicy() const { return resetPolicy; }
+  //! Modify whether or not the update policy parameters
+  //! are reset before Optimize call.
+  bool& ResetPolicy() { return resetPolicy; }
+
+  //! Get whether the gradients are sent in single precision.
+  bool CompressGradients() const { return compressGradients; }
+  //! Modify whether the gradients are sent in single precision.
+  bool& CompressGradients() { return compressGradients; }
+
+  //! Get the number of steps between two checkpoints (0 means none).
+  size_t CheckpointInterval() const { return checkpointInterval; }
+  //! Modify the number of steps between two checkpoints (0 means none).
+  size_t& CheckpointInterval() { return checkpointInterval; }
+
+  //! Get the file the checkpoints are saved to.
+  const std::string& CheckpointFile() const { return checkpointFile; }
+  //! Modify the file the checkpoints are saved to.
+  std::string& CheckpointFile() { return checkpointFile; }
+
+  //! Get the update policy.
+  const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
+  //! Modify the update policy.
+  UpdatePolicyType& UpdatePolicy() { return updatePolicy; }
+
+  //! Get the step size decay policy.
+  const DecayPolicyType& DecayPolicy() const { return decayPolicy; }
+  //! Modify the step size decay policy.
+  DecayPolicyType& DecayPolicy() { return decayPolicy; }
+
+ private:
+  /**
+   * Sum the given values over all processes; every process gets the sums.
+   *
+   * @param values Values to sum (will be modified).
+   * @param compress Whether to send the values in single precision.
+   */
+  static void AllReduce(arma::mat& values, const bool compress = false);
+
+  //! Return the largest of the given values of all processes.
+  static size_t AllReduceMax(const size_t value);
+
+  //! The step size for each example.
+  double stepSize;
+
+  //! The batch size of each process.
+  size_t batchSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the individual functions are shuffled when
+  //! iterating.
+  bool shuffle;
+
+  //! The update policy used to update the parameters in each iteration.
+  UpdatePolicyType updatePolicy;
+
+  //! The decay policy used to update the step size.
+  DecayPolicyType decayPolicy;
+
+  //! Flag indicating whether update policy
+  //! should be reset before running optimization.
+  bool resetPolicy;
+
+  //! Whether the gradients are sent in single precision.
+  bool compressGradients;
+
+  //! The number of steps between two checkpoints.
+  size_t checkpointInterval;
+
+  //! The file the checkpoints are saved to.
+  std::string checkpointFile;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_sgd_impl.hpp"
+
+#endif
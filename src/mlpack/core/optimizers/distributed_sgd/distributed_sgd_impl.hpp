@@ -0,0 +1,259 @@
+/**
+ * @file distributed_sgd_impl.hpp
+ *
+ * Implementation of synchronous data-parallel stochastic gradient descent over
+ * several MPI processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_SGD_DISTRIBUTED_SGD_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_SGD_DISTRIBUTED_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_sgd.hpp"
+
+#include <mlpack/core/optimizers/function.hpp>
+#include <mlpack/core/data/save.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+template<typename UpdatePolicyType, typename DecayPolicyType>
+DistributedSGD<UpdatePolicyType, DecayPolicyType>::DistributedSGD(
+    const double stepSize,
+    const size_t batchSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle,
+    const UpdatePolicyType& updatePolicy,
+    const DecayPolicyType& decayPolicy,
+    const bool resetPolicy,
+    const bool compressGradients,
+    const size_t checkpointInterval,
+    const std::string& checkpointFile) :
+    stepSize(stepSize),
+    batchSize(batchSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle),
+    updatePolicy(updatePolicy),
+    decayPolicy(decayPolicy),
+    resetPolicy(resetPolicy),
+    compressGradients(compressGradients),
+    checkpointInterval(checkpointInterval),
+    checkpointFile(checkpointFile)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename DecomposableFunctionType>
+double DistributedSGD<UpdatePolicyType, DecayPolicyType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::mat& iterate)
+{
+  typedef Function<DecomposableFunctionType> FullFunctionType;
+  FullFunctionType& f(static_cast<FullFunctionType&>(function));
+
+  // Make sure we have all the methods that we need.
+  traits::CheckDecomposableFunctionTypeAPI<FullFunctionType>();
+
+  #ifdef HAS_MPI
+  int initialized;
+  MPI_Initialized(&initialized);
+  if (!initialized)
+  {
+    Log::Fatal << "DistributedSGD::Optimize(): MPI must be initialized before "
+        << "optimizing." << std::endl;
+  }
+  #endif
+
+  // Every process takes the same number of steps in each pass, enough for the
+  // process with the most points; the others don't contribute to the last
+  // steps of a pass.
+  const size_t numFunctions = f.NumFunctions();
+  const size_t passSize = AllReduceMax(numFunctions);
+  if (passSize == 0)
+  {
+    Log::Fatal << "DistributedSGD::Optimize(): none of the processes has any "
+        << "points." << std::endl;
+  }
+
+  // To keep track of where we are and how things are going.
+  size_t currentFunction = 0;
+  double overallObjective = 0;
+  double lastObjective = DBL_MAX;
+
+  // Initialize the update policy.
+  if (resetPolicy)
+    updatePolicy.Initialize(iterate.n_rows, iterate.n_cols);
+
+  // The gradient is reduced together with the number of points it was computed
+  // on, which is stored after it.
+  arma::mat reduced(iterate.n_elem + 1, 1);
+  arma::mat gradient(reduced.memptr(), iterate.n_rows, iterate.n_cols, false,
+      true);
+
+  // Now iterate!
+  size_t steps = 0;
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  for (size_t i = 0; i < actualMaxIterations; /* incrementing done manually */)
+  {
+    // Is this iteration the start of a pass?
+    if (currentFunction >= passSize)
+    {
+      // The objective is the sum over the points of all processes, so that the
+      // processes agree on when to stop.
+      arma::mat objective(1, 1);
+      objective(0) = overallObjective;
+      AllReduce(objective);
+      overallObjective = objective(0);
+
+      // Output current objective function.
+      Log::Info << "DistributedSGD: iteration " << i << ", objective "
+          << overallObjective << "." << std::endl;
+
+      if (std::isnan(overallObjective) || std::isinf(overallObjective))
+      {
+        Log::Warn << "DistributedSGD: converged to " << overallObjective
+            << "; terminating with failure.  Try a smaller step size?"
+            << std::endl;
+        return overallObjective;
+      }
+
+      if (std::abs(lastObjective - overallObjective) < tolerance)
+      {
+        Log::Info << "DistributedSGD: minimized within tolerance " << tolerance
+            << "; terminating optimization." << std::endl;
+        return overallObjective;
+      }
+
+      // Reset the counter variables.
+      lastObjective = overallObjective;
+      overallObjective = 0;
+      currentFunction = 0;
+
+      if (shuffle) // Determine order of visitation.
+        f.Shuffle();
+    }
+
+    const size_t effectiveBatchSize = (currentFunction < numFunctions) ?
+        std::min(batchSize, numFunctions - currentFunction) : 0;
+
+    if (effectiveBatchSize > 0)
+    {
+      overallObjective += f.EvaluateWithGradient(iterate, currentFunction,
+          gradient, effectiveBatchSize);
+    }
+    else
+    {
+      gradient.zeros();
+    }
+
+    reduced(iterate.n_elem) = effectiveBatchSize;
+    AllReduce(reduced, compressGradients);
+
+    // Every process takes the same step with the summed gradient.
+    updatePolicy.Update(iterate, stepSize, gradient);
+
+    // Now update the learning rate if requested by the user.
+    decayPolicy.Update(iterate, stepSize, gradient);
+
+    i += (size_t) (reduced(iterate.n_elem) + 0.5);
+    currentFunction += batchSize;
+    ++steps;
+
+    if (checkpointInterval > 0 && steps % checkpointInterval == 0 &&
+        Rank() == 0)
+    {
+      data::Save(checkpointFile, iterate, false);
+    }
+  }
+
+  Log::Info << "DistributedSGD: maximum iterations (" << maxIterations << ") "
+      << "reached; terminating optimization." << std::endl;
+
+  // Calculate final objective.
+  arma::mat objective(1, 1);
+  objective(0) = 0;
+  for (size_t i = 0; i < numFunctions; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
+    objective(0) += f.Evaluate(iterate, i, effectiveBatchSize);
+  }
+
+  AllReduce(objective);
+  return objective(0);
+}
+
+template<typename UpdatePolicyType, typename DecayPolicyType>
+size_t DistributedSGD<UpdatePolicyType, DecayPolicyType>::Rank()
+{
+  #ifdef HAS_MPI
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  return (size_t) rank;
+  #else
+  return 0;
+  #endif
+}
+
+template<typename UpdatePolicyType, typename DecayPolicyType>
+size_t DistributedSGD<UpdatePolicyType, DecayPolicyType>::Processes()
+{
+  #ifdef HAS_MPI
+  int processes;
+  MPI_Comm_size(MPI_COMM_WORLD, &processes);
+  return (size_t) processes;
+  #else
+  return 1;
+  #endif
+}
+
+template<typename UpdatePolicyType, typename DecayPolicyType>
+void DistributedSGD<UpdatePolicyType, DecayPolicyType>::AllReduce(
+    arma::mat& values, const bool compress)
+{
+  #ifdef HAS_MPI
+  // MPI implementations use ring or tree reductions for large messages, so
+  // each process sends and receives about twice the size of the values.
+  if (compress)
+  {
+    arma::fmat compressed = arma::conv_to<arma::fmat>::from(values);
+    MPI_Allreduce(MPI_IN_PLACE, compressed.memptr(), (int) compressed.n_elem,
+        MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD);
+    values = arma::conv_to<arma::mat>::from(compressed);
+  }
+  else
+  {
+    MPI_Allreduce(MPI_IN_PLACE, values.memptr(), (int) values.n_elem,
+        MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  }
+  #else
+  // With a single process, the sums are the values themselves.
+  (void) values;
+  (void) compress;
+  #endif
+}
+
+template<typename UpdatePolicyType, typename DecayPolicyType>
+size_t DistributedSGD<UpdatePolicyType, DecayPolicyType>::AllReduceMax(
+    const size_t value)
+{
+  #ifdef HAS_MPI
+  unsigned long long maximum = value;
+  MPI_Allreduce(MPI_IN_PLACE, &maximum, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX,
+      MPI_COMM_WORLD);
+  return (size_t) maximum;
+  #else
+  return value;
+  #endif
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,157 @@
+/**
+ * @file dsgd.hpp
+ *
+ * Stratified distributed SGD (DSGD) for matrix factorization, which runs SGD
+ * in parallel on blocks of the rating matrix that share no users or items.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DSGD_DSGD_HPP
+#define MLPACK_CORE_OPTIMIZERS_DSGD_DSGD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * DSGD optimizes a matrix factorization objective with SGD in parallel,
+ * without locks or atomic updates.  The users and the items are split into P
+ * ranges each, which splits the rating matrix into a P x P grid of blocks.  A
+ * stratum is a set of P blocks that share no user range and no item range,
+ * like the diagonal of the grid; the ratings of its blocks touch disjoint
+ * factors, so the P blocks of a stratum are processed in parallel, one per
+ * thread.  An epoch processes the P strata one after the other, so every
+ * rating is visited once.  The blocks of an epoch and the ratings inside each
+ * block are visited in a random order if shuffling is enabled.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *   title     = {Large-scale matrix factorization with distributed stochastic
+ *                gradient descent},
+ *   author    = {Gemulla, Rainer and Nijkamp, Erik and Haas, Peter J. and
+ *                Sismanis, Yannis},
+ *   booktitle = {Proceedings of the 17th ACM SIGKDD International Conference
+ *                on Knowledge Discovery and Data Mining},
+ *   pages     = {69--77},
+ *   year      = {2011}
+ * }
+ * @endcode
+ *
+ * The function to optimize has to be a factorization of a (user, item, rating)
+ * table, like RegularizedSVDFunction, BiasSVDFunction and
+ * SVDPlusPlusFunction, and it has to implement the following methods:
+ *
+ *   const arma::mat& Dataset();
+ *   size_t NumFunctions();
+ *   size_t NumUsers();
+ *   size_t NumItems();
+ *   double Evaluate(const arma::mat& parameters,
+ *                   const size_t start,
+ *                   const size_t batchSize);
+ *   void StochasticUpdate(arma::mat& parameters,
+ *                         const size_t i,
+ *                         const double stepSize);
+ *   void FinishEpoch(arma::mat& parameters, const double stepSize);
+ *
+ * StochasticUpdate() takes the SGD step for rating i.  It may only change the
+ * parameters of the user and the item of the rating (and any state of the
+ * function that belongs to the user or the item), since it is called for
+ * ratings of other users and items at the same time.  Updates to parameters
+ * that are shared between users (like the implicit item factors of SVD++) have
+ * to be collected and applied by FinishEpoch(), which is called after every
+ * epoch.
+ */
+class DSGD
+{
+ public:
+  /**
+   * Construct the DSGD optimizer.
+   *
+   * @param stepSize Step size for each update.
+   * @param maxIterations Maximum number of epochs (0 means no limit).
+   * @param numBlocks Number of user and of item ranges (0 means one per
+   *     thread).
+   * @param tolerance Maximum absolute tolerance to terminate the algorithm.
+   * @param shuffle If true, the blocks and the ratings inside the blocks are
+   *     visited in a random order.
+   */
+  DSGD(const double stepSize = 0.01,
+       const size_t maxIterations = 10,
+       const size_t numBlocks = 0,
+       const double tolerance = 1e-5,
+       const bool shuffle = true);
+
+  /**
+   * Optimize the given function with DSGD.  The given starting point will be
+   * modified to store the finishing point of the algorithm, and the final
+   * objective value is returned.
+   *
+   * @tparam FunctionType Type of the factorization function.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType>
+  double Optimize(FunctionType& function, arma::mat& iterate);
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of epochs (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of epochs (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of user and item ranges (0 means one per thread).
+  size_t NumBlocks() const { return numBlocks; }
+  //! Modify the number of user and item ranges (0 means one per thread).
+  size_t& NumBlocks() { return numBlocks; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the blocks and ratings are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the blocks and ratings are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+ private:
+  //! Compute the objective over all ratings in parallel.
+  template<typename FunctionType>
+  static double Objective(const FunctionType& function,
+                          const arma::mat& iterate);
+
+  //! The step size for each update.
+  double stepSize;
+
+  //! The maximum number of epochs.
+  size_t maxIterations;
+
+  //! The number of user and item ranges.
+  size_t numBlocks;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Whether the blocks and ratings are shuffled.
+  bool shuffle;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "dsgd_impl.hpp"
+
+#endif
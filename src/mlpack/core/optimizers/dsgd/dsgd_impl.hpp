@@ -0,0 +1,163 @@
+/**
+ * @file dsgd_impl.hpp
+ *
+ * Implementation of the DSGD optimizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DSGD_DSGD_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_DSGD_DSGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "dsgd.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace optimization {
+
+inline DSGD::DSGD(const double stepSize,
+                  const size_t maxIterations,
+                  const size_t numBlocks,
+                  const double tolerance,
+                  const bool shuffle) :
+    stepSize(stepSize),
+    maxIterations(maxIterations),
+    numBlocks(numBlocks),
+    tolerance(tolerance),
+    shuffle(shuffle)
+{ /* Nothing to do. */ }
+
+template<typename FunctionType>
+double DSGD::Optimize(FunctionType& function, arma::mat& iterate)
+{
+  const arma::mat& data = function.Dataset();
+  const size_t numRatings = function.NumFunctions();
+  const size_t numUsers = function.NumUsers();
+  const size_t numItems = function.NumItems();
+
+  size_t p = numBlocks;
+  if (p == 0)
+  {
+    #ifdef HAS_OPENMP
+      p = omp_get_max_threads();
+    #else
+      p = 1;
+    #endif
+  }
+  p = std::max(std::min(p, std::min(numUsers, numItems)), (size_t) 1);
+
+  // Sort the ratings by block, with a counting sort; block (u, i) holds the
+  // ratings of user range u and item range i.
+  arma::Col<size_t> blockOf(numRatings);
+  arma::Col<size_t> blockStart(p * p + 1, arma::fill::zeros);
+  for (size_t r = 0; r < numRatings; ++r)
+  {
+    const size_t userBlock = ((size_t) data(0, r) * p) / numUsers;
+    const size_t itemBlock = ((size_t) data(1, r) * p) / numItems;
+    blockOf[r] = userBlock * p + itemBlock;
+    ++blockStart[blockOf[r] + 1];
+  }
+  for (size_t b = 0; b < p * p; ++b)
+    blockStart[b + 1] += blockStart[b];
+
+  arma::Col<size_t> order(numRatings);
+  {
+    arma::Col<size_t> fill = blockStart.subvec(0, p * p - 1);
+    for (size_t r = 0; r < numRatings; ++r)
+      order[fill[blockOf[r]]++] = r;
+  }
+
+  // The strata: stratum s holds the blocks (u, (u + s) mod p).
+  arma::Col<size_t> strata = arma::linspace<arma::Col<size_t>>(0, p - 1, p);
+
+  double overallObjective = Objective(function, iterate);
+  double lastObjective = DBL_MAX;
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  for (size_t epoch = 0; epoch < actualMaxIterations; ++epoch)
+  {
+    Log::Info << "DSGD: epoch " << epoch << ", objective " << overallObjective
+        << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "DSGD: converged to " << overallObjective << "; "
+          << "terminating with failure.  Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < tolerance)
+    {
+      Log::Info << "DSGD: minimized within tolerance " << tolerance << "; "
+          << "terminating optimization." << std::endl;
+      return overallObjective;
+    }
+
+    if (shuffle)
+    {
+      std::shuffle(strata.begin(), strata.end(), math::randGen);
+      for (size_t b = 0; b < p * p; ++b)
+      {
+        std::shuffle(order.begin() + blockStart[b],
+            order.begin() + blockStart[b + 1], math::randGen);
+      }
+    }
+
+    // The blocks of a stratum share no users and no items, so their updates
+    // don't conflict.
+    for (size_t s = 0; s < p; ++s)
+    {
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t u = 0; u < (omp_size_t) p; ++u)
+      {
+        const size_t block = u * p + (u + strata[s]) % p;
+        for (size_t j = blockStart[block]; j < blockStart[block + 1]; ++j)
+          function.StochasticUpdate(iterate, order[j], stepSize);
+      }
+    }
+
+    function.FinishEpoch(iterate, stepSize);
+
+    lastObjective = overallObjective;
+    overallObjective = Objective(function, iterate);
+  }
+
+  Log::Info << "DSGD: maximum iterations (" << maxIterations << ") reached; "
+      << "terminating optimization." << std::endl;
+
+  return overallObjective;
+}
+
+template<typename FunctionType>
+double DSGD::Objective(const FunctionType& function,
+                       const arma::mat& iterate)
+{
+  // Evaluate contiguous ranges of ratings, so that per-call setup of the
+  // function is not paid for every rating.
+  const size_t numRatings = function.NumFunctions();
+  const size_t rangeSize = 1024;
+  const size_t numRanges = (numRatings + rangeSize - 1) / rangeSize;
+
+  double objective = 0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:objective)
+  for (omp_size_t r = 0; r < (omp_size_t) numRanges; ++r)
+  {
+    const size_t begin = r * rangeSize;
+    objective += function.Evaluate(iterate, begin,
+        std::min(rangeSize, numRatings - begin));
+  }
+
+  return objective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
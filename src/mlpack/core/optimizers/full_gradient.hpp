@@ -0,0 +1,195 @@
+/**
+ * @file full_gradient.hpp
+ *
+ * Serial and parallel computation of the objective and the gradient of a
+ * decomposable function over all of its functions, as done at every outer
+ * iteration of the variance reduced optimizers (SVRG, SARAH and Katyusha), and
+ * over a single large batch (as used by SPALeRA SGD).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_FULL_GRADIENT_HPP
+#define MLPACK_CORE_OPTIMIZERS_FULL_GRADIENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Evaluate the sum of all functions of the given decomposable function, in
+ * batches of the given size.  In parallel, the batches are split among the
+ * threads, so Evaluate() has to be safe to call from several threads at once.
+ *
+ * @param function Decomposable function to evaluate.
+ * @param iterate Point at which to evaluate the function.
+ * @param batchSize Number of functions evaluated by each call to Evaluate().
+ * @param parallel Whether the batches are evaluated in parallel.
+ * @return The sum of the objectives of all functions.
+ */
+template<typename DecomposableFunctionType>
+double FullObjective(DecomposableFunctionType& function,
+                     const arma::mat& iterate,
+                     const size_t batchSize,
+                     const bool parallel)
+{
+  const size_t numFunctions = function.NumFunctions();
+  const size_t numBatches = (numFunctions + batchSize - 1) / batchSize;
+
+  double objective = 0;
+  #pragma omp parallel for reduction(+:objective) if (parallel)
+  for (omp_size_t b = 0; b < (omp_size_t) numBatches; ++b)
+  {
+    const size_t f = b * batchSize;
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
+    objective += function.Evaluate(iterate, f, effectiveBatchSize);
+  }
+
+  return objective;
+}
+
+/**
+ * Compute the average of the gradients of all functions of the given
+ * decomposable function, in batches of the given size.  In parallel, every
+ * thread sums the gradients of its batches, and the sums of the threads are
+ * added at the end, so Gradient() has to be safe to call from several threads
+ * at once.
+ *
+ * @param function Decomposable function to differentiate.
+ * @param iterate Point at which to compute the gradient.
+ * @param fullGradient The average gradient.
+ * @param gradient Storage for the gradient of one batch.
+ * @param batchSize Number of functions differentiated by each call to
+ *     Gradient().
+ * @param parallel Whether the batches are differentiated in parallel.
+ */
+template<typename DecomposableFunctionType>
+void FullGradient(DecomposableFunctionType& function,
+                  const arma::mat& iterate,
+                  arma::mat& fullGradient,
+                  arma::mat& gradient,
+                  const size_t batchSize,
+                  const bool parallel)
+{
+  const size_t numFunctions = function.NumFunctions();
+
+  if (!parallel)
+  {
+    size_t effectiveBatchSize = std::min(batchSize, numFunctions);
+    function.Gradient(iterate, 0, fullGradient, effectiveBatchSize);
+    for (size_t f = effectiveBatchSize; f < numFunctions;
+        /* incrementing done manually */)
+    {
+      // Find the effective batch size (the last batch may be smaller).
+      effectiveBatchSize = std::min(batchSize, numFunctions - f);
+
+      function.Gradient(iterate, f, gradient, effectiveBatchSize);
+      fullGradient += gradient;
+
+      f += effectiveBatchSize;
+    }
+    fullGradient /= (double) numFunctions;
+    return;
+  }
+
+  const size_t numBatches = (numFunctions + batchSize - 1) / batchSize;
+  fullGradient.zeros(iterate.n_rows, iterate.n_cols);
+
+  #pragma omp parallel shared(fullGradient)
+  {
+    arma::mat threadGradient(iterate.n_rows, iterate.n_cols, arma::fill::zeros);
+    arma::mat batchGradient;
+
+    #pragma omp for
+    for (omp_size_t b = 0; b < (omp_size_t) numBatches; ++b)
+    {
+      const size_t f = b * batchSize;
+      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
+      function.Gradient(iterate, f, batchGradient, effectiveBatchSize);
+      threadGradient += batchGradient;
+    }
+
+    #pragma omp critical(fullGradient)
+    fullGradient += threadGradient;
+  }
+
+  fullGradient /= (double) numFunctions;
+}
+
+/**
+ * Compute the objective and the gradient of one batch of the given decomposable
+ * function.  In parallel, the batch is split into one contiguous part per
+ * thread, every thread evaluates its part with a single call to
+ * EvaluateWithGradient(), and the objectives and gradients of the parts are
+ * summed in the order of the parts, so the result does not depend on the
+ * scheduling.  EvaluateWithGradient() then has to be safe to call from several
+ * threads at once.  Batches too small to give every thread minPartSize
+ * functions use fewer threads.
+ *
+ * @param function Decomposable function to evaluate.
+ * @param iterate Point at which to evaluate the function.
+ * @param begin First function of the batch.
+ * @param gradient The sum of the gradients of the batch.
+ * @param batchSize Number of functions in the batch.
+ * @param parallel Whether the batch is split among the threads.
+ * @param minPartSize Smallest number of functions given to one thread.
+ * @return The sum of the objectives of the batch.
+ */
+template<typename DecomposableFunctionType>
+double BatchEvaluateWithGradient(DecomposableFunctionType& function,
+                                 const arma::mat& iterate,
+                                 const size_t begin,
+                                 arma::mat& gradient,
+                                 const size_t batchSize,
+                                 const bool parallel,
+                                 const size_t minPartSize = 16)
+{
+  size_t numParts = 1;
+  #ifdef HAS_OPENMP
+    if (parallel)
+    {
+      numParts = std::min((size_t) omp_get_max_threads(),
+          std::max(batchSize / std::max(minPartSize, (size_t) 1), (size_t) 1));
+    }
+  #else
+    (void) parallel;
+    (void) minPartSize;
+  #endif
+
+  if (numParts == 1)
+    return function.EvaluateWithGradient(iterate, begin, gradient, batchSize);
+
+  std::vector<arma::mat> gradients(numParts);
+  std::vector<double> objectives(numParts);
+
+  #pragma omp parallel for schedule(static) num_threads(numParts)
+  for (omp_size_t p = 0; p < (omp_size_t) numParts; ++p)
+  {
+    const size_t partBegin = begin + (p * batchSize) / numParts;
+    const size_t partEnd = begin + ((p + 1) * batchSize) / numParts;
+    objectives[p] = function.EvaluateWithGradient(iterate, partBegin,
+        gradients[p], partEnd - partBegin);
+  }
+
+  double objective = objectives[0];
+  gradient = std::move(gradients[0]);
+  for (size_t p = 1; p < numParts; ++p)
+  {
+    objective += objectives[p];
+    gradient += gradients[p];
+  }
+
+  return objective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -21,6 +21,14 @@ namespace optimization {
 /**
  * Class to hold the information and operations of current atoms in the
  * soluton space.
+ *
+ * The atoms are stored as the columns of a sparse matrix, since the atoms
+ * given by the linear constrained solvers are usually sparse (one nonzero for
+ * the l1 ball, the support of one group for structured groups), so the memory
+ * used grows with the number of nonzeros instead of with the dimension of the
+ * problem.  The image A * atom of every atom is also kept (densely, since A
+ * usually has far fewer rows than columns), so the corrections only work with
+ * the small matrix of images and never multiply by A again.
  */
 class Atoms
 {
@@ -33,25 +41,68 @@ class Atoms
    * @param v new atom to be added.
    * @param c coefficient of the new atom.
    */
-  void AddAtom(const arma::vec& v, FuncSq& function, const double c = 0)
+  void AddAtom(const arma::sp_mat& v, FuncSq& function, const double c = 0)
+  {
+    AddAtom(v, arma::vec(function.MatrixA() * v), c);
+  }
+
+  /**
+   * Add atom into the solution space.  The atom is stored as a sparse vector.
+   *
+   * @param v new atom to be added.
+   * @param c coefficient of the new atom.
+   */
+  void AddAtom(const arma::mat& v, FuncSq& function, const double c = 0)
   {
-    if (currentAtoms.is_empty())
+    AddAtom(arma::sp_mat(v), function, c);
+  }
+
+  /**
+   * Add atom into the solution space, given its image A * v.
+   *
+   * @param v new atom to be added.
+   * @param image image of the new atom, A * v.
+   * @param c coefficient of the new atom.
+   */
+  void AddAtom(const arma::sp_mat& v, const arma::vec& image, const double c)
+  {
+    if (currentAtoms.n_cols == 0)
     {
-      CurrentAtoms() = v;
-      CurrentCoeffs().set_size(1);
-      CurrentCoeffs().fill(c);
+      currentAtoms = v;
+      atomImages = image;
+      currentCoeffs.set_size(1);
+      currentCoeffs.fill(c);
       atomSqTerm.set_size(1);
-      atomSqTerm(0) = std::pow(norm(function.MatrixA() * v, 2), 2);
+      atomSqTerm(0) = arma::dot(image, image);
     }
     else
     {
-      currentAtoms.insert_cols(0, v);
+      // The new atom goes first; the batch constructor sorts the locations.
+      arma::umat locations(2, currentAtoms.n_nonzero + v.n_nonzero);
+      arma::vec values(locations.n_cols);
+      size_t i = 0;
+      for (arma::sp_mat::const_iterator it = v.begin(); it != v.end(); ++it)
+      {
+        locations(0, i) = it.row();
+        locations(1, i) = 0;
+        values[i++] = *it;
+      }
+      for (arma::sp_mat::const_iterator it = currentAtoms.begin();
+          it != currentAtoms.end(); ++it)
+      {
+        locations(0, i) = it.row();
+        locations(1, i) = it.col() + 1;
+        values[i++] = *it;
+      }
+      currentAtoms = arma::sp_mat(locations, values, currentAtoms.n_rows,
+          currentAtoms.n_cols + 1);
+
+      atomImages.insert_cols(0, image);
       arma::vec cVec(1);
       cVec(0) = c;
       currentCoeffs.insert_rows(0, cVec);
-      double tmp = std::pow(norm(function.MatrixA() * v, 2), 2);
       arma::vec tmpVec(1);
-      tmpVec(0) = tmp;
+      tmpVec(0) = arma::dot(image, image);
       atomSqTerm.insert_rows(0, tmpVec);
     }
   }
@@ -63,6 +114,17 @@ class Atoms
     x = currentAtoms * currentCoeffs;
   }
 
+  /**
+   * Compute A * x, where x is the solution given by the current atoms and
+   * coefficients.
+   *
+   * @param image Vector to store A * x in.
+   */
+  void RecoverImage(arma::vec& image) const
+  {
+    image = atomImages * currentCoeffs;
+  }
+
   /**
    * Prune the support, delete previous atoms if they don't contribute much.
    * See Algorithm 2 of paper:
@@ -84,41 +146,35 @@ class Atoms
    */
   void PruneSupport(const double F, FuncSq& function)
   {
+    const arma::vec& b = function.Vectorb();
     arma::vec sqTerm = 0.5 * atomSqTerm % square(currentCoeffs);
 
     while (currentAtoms.n_cols > 1)
     {
-      // Solve for current gradient.
-      arma::mat x;
-      RecoverVector(x);
-      arma::mat gradient(size(x));
-      function.Gradient(x, gradient);
+      // The gradient is A^T (A x - b), so its inner product with the atoms is
+      // (A x - b)^T times their images.
+      RecoverImage(residual);
+      residual -= b;
 
       // Find possible atom to be deleted.
       arma::vec gap = sqTerm -
-          currentCoeffs % trans(gradient.t() * currentAtoms);
+          currentCoeffs % trans(residual.t() * atomImages);
       arma::uword ind;
       gap.min(ind);
 
       // Try deleting the atom.
-      arma::mat newAtoms(currentAtoms.n_rows, currentAtoms.n_cols - 1);
-      if (ind > 0)
-        newAtoms.cols(0, ind - 1) = currentAtoms.cols(0, ind - 1);
-      if (ind < (currentAtoms.n_cols - 1))
-      {
-        newAtoms.cols(ind, newAtoms.n_cols - 1) =
-            currentAtoms.cols(ind + 1, currentAtoms.n_cols - 1);
-      }
+      arma::mat newImages = atomImages;
+      newImages.shed_col(ind);
 
       // Reoptimize the coefficients, we brute-forcely reoptimize in the span,
       // which would be used in UpdateSpan class. Alternatively, if you want to
       // add an atom norm constraint, you could use projected gradient method,
       // see the implementaton of ProjectedGradientEnhancement().
-      arma::vec newCoeffs =
-          solve(function.MatrixA() * newAtoms, function.Vectorb());
+      arma::vec newCoeffs = solve(newImages, b);
 
       // Evaluate the function again.
-      double Fnew = function.Evaluate(newAtoms * newCoeffs);
+      residual = newImages * newCoeffs - b;
+      double Fnew = 0.5 * arma::dot(residual, residual);
 
       if (Fnew > F)
         // Should not delete the atom.
@@ -126,7 +182,8 @@ class Atoms
       else
       {
         // Delete the atom from current atoms.
-        currentAtoms = newAtoms;
+        currentAtoms.shed_col(ind);
+        atomImages = std::move(newImages);
         currentCoeffs = newCoeffs;
         atomSqTerm.shed_row(ind);
         sqTerm.shed_row(ind);
@@ -156,6 +213,10 @@ class Atoms
    * }
    * @endcode
    *
+   * The gradient with respect to the coefficients is computed from the images
+   * of the atoms, so each iteration only costs O(m k) for m rows of A and k
+   * atoms, and the vectors it needs are kept between calls.
+   *
    * @param function function to be minimized.
    * @param tau atom norm constraint.
    * @param stepSize step size for projected gradient method.
@@ -168,23 +229,23 @@ class Atoms
                                     size_t maxIteration = 100,
                                     double tolerance = 1e-3)
   {
-    arma::mat x;
-    RecoverVector(x);
-    double value = function.Evaluate(x);
+    const arma::vec& b = function.Vectorb();
+    RecoverImage(residual);
+    residual -= b;
+    double value = 0.5 * arma::dot(residual, residual);
 
     for (size_t iter = 1; iter<maxIteration; iter++)
     {
       // Update currentCoeffs with gradient descent method.
-      arma::mat g;
-      function.Gradient(x, g);
-      g = currentAtoms.t() * g;
-      currentCoeffs = currentCoeffs - stepSize * g;
+      coeffsGradient = atomImages.t() * residual;
+      currentCoeffs -= stepSize * coeffsGradient;
 
       // Projection of currentCoeffs to satisfy the atom norm constraint.
       Proximal::ProjectToL1Ball(currentCoeffs, tau);
 
-      RecoverVector(x);
-      double valueNew = function.Evaluate(x);
+      RecoverImage(residual);
+      residual -= b;
+      double valueNew = 0.5 * arma::dot(residual, residual);
 
       if ((value - valueNew) < tolerance)
         break;
@@ -200,20 +261,30 @@ class Atoms
   arma::vec& CurrentCoeffs() { return currentCoeffs; }
 
   //! Get the current atoms.
-  const arma::mat& CurrentAtoms() const { return currentAtoms; }
-  //! Modify the current atoms.
-  arma::mat& CurrentAtoms() { return currentAtoms; }
+  const arma::sp_mat& CurrentAtoms() const { return currentAtoms; }
+
+  //! Get the images A * atom of the current atoms.
+  const arma::mat& AtomImages() const { return atomImages; }
 
  private:
   //! Coefficients of current atoms.
   arma::vec currentCoeffs;
 
   //! Current atoms in the solution space.
-  arma::mat currentAtoms;
+  arma::sp_mat currentAtoms;
+
+  //! The image A * atom of each current atom.
+  arma::mat atomImages;
 
   //! Atom square term: ||A * atom||^2, used in PruneSupport(). It is computed
   //! when an atom is added.
   arma::vec atomSqTerm;
+
+  //! Workspace for the residual A * x - b.
+  arma::vec residual;
+
+  //! Workspace for the gradient with respect to the coefficients.
+  arma::vec coeffsGradient;
 }; // class Atoms
 }  // namespace optimization
 }  // namespace mlpack
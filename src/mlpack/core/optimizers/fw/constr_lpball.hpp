@@ -109,19 +109,14 @@ class ConstrLpBallSolver
     }
     else if (p == 1.0)
     {
-      // l1 ball, also used in OMP.
-      if (regFlag)
-        s = arma::abs(v / lambda);
-      else
-        s = arma::abs(v);
-
-      arma::uword k = 0;
-      s.max(k);  // k is the linear index of the largest element.
-      s.zeros();
+      // l1 ball, also used in OMP.  k is the linear index of the largest
+      // (scaled) element, and s has only that one nonzero element.
+      const arma::uword k = MaxScaledIndex(v);
+      s.zeros(v.n_rows, v.n_cols);
       s(k) = - mlpack::math::Sign(v(k));
 
       if (regFlag)
-        s = s / lambda;
+        s(k) /= lambda(k);
     }
     else
     {
@@ -147,6 +142,44 @@ class ConstrLpBallSolver
   arma::vec& Lambda() {return lambda;}
 
  private:
+  /**
+   * Return the index of the element of v with the largest absolute value
+   * (divided by lambda, if regularization is used); if there are several, the
+   * first one.  The elements are scanned in fixed blocks, in parallel, so the
+   * result does not depend on the number of threads.
+   */
+  arma::uword MaxScaledIndex(const arma::mat& v) const
+  {
+    const size_t blockSize = 65536;
+    const size_t numBlocks = (v.n_elem + blockSize - 1) / blockSize;
+    std::vector<double> blockMax(numBlocks, -1.0);
+    std::vector<arma::uword> blockIndex(numBlocks, 0);
+
+    #pragma omp parallel for schedule(static) if (numBlocks > 1)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t end = std::min((size_t) (b + 1) * blockSize,
+          (size_t) v.n_elem);
+      for (size_t i = b * blockSize; i < end; ++i)
+      {
+        const double value = regFlag ? std::abs(v[i] / lambda[i]) :
+            std::abs(v[i]);
+        if (value > blockMax[b])
+        {
+          blockMax[b] = value;
+          blockIndex[b] = i;
+        }
+      }
+    }
+
+    size_t best = 0;
+    for (size_t b = 1; b < numBlocks; ++b)
+      if (blockMax[b] > blockMax[best])
+        best = b;
+
+    return blockIndex[best];
+  }
+
   //! lp norm, 1<=p<=inf;
   //! use std::numeric_limits<double>::infinity() for inf norm.
   double p;
@@ -60,6 +60,10 @@ namespace optimization {
  *    ProjectToGroup(const arma::mat& v, const size_t groupId, arma::vec& y);
  *    void OptimalFromGroup(const arma::mat& v, const size_t groupId, arma::mat& s);
  *
+ *  The dual norms of the groups are computed in parallel with OpenMP, so
+ *  ProjectToGroup() and DualNorm() must be safe to call concurrently (as they
+ *  are for GroupLpBall).
+ *
  * @tparam GroupType Class that implements functions to map original vectors to
  *                   each group, and to solve linear optimization problem in the
  *                   unit ball defined by the norm of each group.
@@ -87,21 +91,32 @@ class ConstrStructGroupSolver
   void Optimize(const arma::mat& v, arma::mat& s)
   {
     size_t nGroups = groupExtractor.NumGroups();
-    double dualNorm = 0;
-    size_t optimalGroup = 1;
 
-    // Find the optimal group.
-    for (size_t i = 1; i <= nGroups; ++i)
+    // The dual norms of the groups are independent, so they are computed in
+    // parallel.
+    dualNorms.set_size(nGroups);
+    #pragma omp parallel
     {
       arma::vec y;
-      groupExtractor.ProjectToGroup(v, i, y);
-      double newNorm = groupExtractor.DualNorm(y, i);
 
-      // Find the group with largest dual norm.
-      if (newNorm > dualNorm)
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) nGroups; ++i)
+      {
+        groupExtractor.ProjectToGroup(v, i + 1, y);
+        dualNorms[i] = groupExtractor.DualNorm(y, i + 1);
+      }
+    }
+
+    // Find the group with largest dual norm (the first one, if there are
+    // several).
+    double dualNorm = 0;
+    size_t optimalGroup = 1;
+    for (size_t i = 1; i <= nGroups; ++i)
+    {
+      if (dualNorms[i - 1] > dualNorm)
       {
         optimalGroup = i;
-        dualNorm = newNorm;
+        dualNorm = dualNorms[i - 1];
       }
     }
 
@@ -111,6 +126,9 @@ class ConstrStructGroupSolver
  private:
   //! Information and methods for groups.
   GroupType& groupExtractor;
+
+  //! The dual norm of each group, reused between calls to Optimize().
+  arma::vec dualNorms;
 };
 
 /**
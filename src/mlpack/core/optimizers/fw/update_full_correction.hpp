@@ -63,15 +63,24 @@ class UpdateFullCorrection
               arma::mat& newCoords,
               const size_t /* numIter */)
   {
-    // Line search, with explicit solution here.
-    arma::mat v = tau * s - oldCoords;
-    arma::mat b = function.Vectorb();
-    arma::mat A = function.MatrixA();
-    double gamma = arma::dot(b - A * oldCoords, A * v);
-    gamma = gamma / std::pow(arma::norm(A * v, "fro"), 2);
+    // The atom is usually sparse, so its image is cheap to compute.  Once
+    // there are atoms, oldCoords is the solution they give (as FrankWolfe
+    // passes the last result back in), and its image is known too.
+    const arma::sp_mat atom(s);
+    const arma::vec atomImage = function.MatrixA() * atom;
+    if (atoms.CurrentAtoms().n_cols == 0)
+      oldImage = function.MatrixA() * oldCoords;
+    else
+      atoms.RecoverImage(oldImage);
+
+    // Line search, with explicit solution here; Av is A * (tau * s - x).
+    const arma::vec& b = function.Vectorb();
+    arma::vec Av = tau * atomImage - oldImage;
+    double gamma = arma::dot(b - oldImage, Av);
+    gamma = gamma / arma::dot(Av, Av);
     gamma = std::min(gamma, 1.0);
     atoms.CurrentCoeffs() = (1.0 - gamma) * atoms.CurrentCoeffs();
-    atoms.AddAtom(s, function, gamma * tau);
+    atoms.AddAtom(atom, atomImage, gamma * tau);
 
     // Projected gradient method for enhancement.
     atoms.ProjectedGradientEnhancement(function, tau, stepSize);
@@ -87,6 +96,9 @@ class UpdateFullCorrection
 
   //! Atoms information.
   Atoms atoms;
+
+  //! Workspace for the image A * x of the previous solution.
+  arma::vec oldImage;
 };
 
 } // namespace optimization
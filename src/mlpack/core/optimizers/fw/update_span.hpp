@@ -56,9 +56,9 @@ class UpdateSpan
     // Add new atom into soluton space.
     atoms.AddAtom(s, function);
 
-    // Reoptimize the solution in the current space.
-    arma::vec b = function.Vectorb();
-    atoms.CurrentCoeffs() = solve(function.MatrixA() * atoms.CurrentAtoms(), b);
+    // Reoptimize the solution in the current space, which is spanned by the
+    // images of the atoms.
+    atoms.CurrentCoeffs() = solve(atoms.AtomImages(), function.Vectorb());
 
     // x has coords of only the current atoms, recover the solution
     // to the original size.
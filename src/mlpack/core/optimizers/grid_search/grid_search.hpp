@@ -13,6 +13,7 @@
 #define MLPACK_CORE_OPTIMIZERS_GRID_SEARCH_GRID_SEARCH_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/population_evaluation.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -25,10 +26,26 @@ namespace optimization {
  * class must implement the following function:
  *
  *   double Evaluate(const arma::mat& coordinates);
+ *
+ * The points of the grid are independent, so they can be evaluated in parallel
+ * (see PopulationEvaluation).  The function has to be safe to evaluate from
+ * several threads at once, or copyable when each thread evaluates its own copy.
+ * CVFunction (used by HyperParameterTuner) is neither, since all its copies
+ * share one cross-validation object; the folds of KFoldCV can be evaluated in
+ * parallel instead.
  */
 class GridSearch
 {
  public:
+  /**
+   * Construct the GridSearch optimizer.
+   *
+   * @param evaluation How the points of the grid are evaluated.
+   */
+  GridSearch(const PopulationEvaluation evaluation = SERIAL_EVALUATION) :
+      evaluation(evaluation)
+  { /* Nothing to do. */ }
+
   /**
    * Optimize (minimize) the given function by iterating through the all
    * possible combinations of values for the parameters specified in
@@ -46,7 +63,15 @@ class GridSearch
       arma::mat& bestParameters,
       data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo);
 
+  //! Get how the points of the grid are evaluated.
+  PopulationEvaluation Evaluation() const { return evaluation; }
+  //! Modify how the points of the grid are evaluated.
+  PopulationEvaluation& Evaluation() { return evaluation; }
+
  private:
+  //! How the points of the grid are evaluated.
+  PopulationEvaluation evaluation;
+
   /**
    * Iterate through the last (parameterValueCollections.size() - i) dimensions
    * of the grid and change the arguments bestObjective and bestParameters if
@@ -62,6 +87,18 @@ class GridSearch
       arma::vec& currentParameters,
       data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
       size_t i);
+
+  /**
+   * Evaluate all points of the grid in parallel, and change the arguments
+   * bestObjective and bestParameters to the best one.  Ties are broken in the
+   * order in which the serial search visits the points.
+   */
+  template<typename FunctionType>
+  void OptimizeParallel(
+      FunctionType& function,
+      double& bestObjective,
+      arma::mat& bestParameters,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo);
 };
 
 } // namespace optimization
@@ -45,8 +45,15 @@ double GridSearch::Optimize(
   for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
     bestParameters(i, 0) = datasetInfo.UnmapString(0, i);
 
-  Optimize(function, bestObjective, bestParameters, currentParameters,
-      datasetInfo, 0);
+  if (evaluation == SERIAL_EVALUATION)
+  {
+    Optimize(function, bestObjective, bestParameters, currentParameters,
+        datasetInfo, 0);
+  }
+  else
+  {
+    OptimizeParallel(function, bestObjective, bestParameters, datasetInfo);
+  }
 
   return bestObjective;
 }
@@ -83,6 +90,52 @@ void GridSearch::Optimize(
   }
 }
 
+template<typename FunctionType>
+void GridSearch::OptimizeParallel(
+    FunctionType& function,
+    double& bestObjective,
+    arma::mat& bestParameters,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo)
+{
+  // Make sure we have the methods that we need.
+  traits::CheckNonDifferentiableFunctionTypeAPI<FunctionType>();
+
+  const size_t dimensionality = datasetInfo.Dimensionality();
+  size_t numPoints = 1;
+  for (size_t i = 0; i < dimensionality; ++i)
+    numPoints *= datasetInfo.NumMappings(i);
+
+  // Enumerate the points in the order of the recursive search, where the last
+  // dimension changes fastest.
+  arma::cube points(dimensionality, 1, numPoints);
+  for (size_t p = 0; p < numPoints; ++p)
+  {
+    size_t index = p;
+    for (size_t i = dimensionality; i > 0; --i)
+    {
+      const size_t numMappings = datasetInfo.NumMappings(i - 1);
+      points(i - 1, 0, p) = datasetInfo.UnmapString(index % numMappings, i - 1);
+      index /= numMappings;
+    }
+  }
+
+  arma::vec objectives;
+  EvaluatePopulation(function, points, objectives, evaluation,
+      [](FunctionType& f, const arma::mat& point)
+      {
+        return f.Evaluate(point);
+      });
+
+  for (size_t p = 0; p < numPoints; ++p)
+  {
+    if (objectives[p] < bestObjective)
+    {
+      bestObjective = objectives[p];
+      bestParameters = points.slice(p);
+    }
+  }
+}
+
 } // namespace optimization
 } // namespace mlpack
 
@@ -0,0 +1,163 @@
+/**
+ * @file liqn.hpp
+ *
+ * Limited-memory IQN (incremental quasi-Newton), which keeps a bounded history
+ * of curvature pairs instead of one Hessian approximation per function.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_IQN_LIQN_HPP
+#define MLPACK_CORE_OPTIMIZERS_IQN_LIQN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * LIQN is a limited-memory variant of IQN.  IQN keeps, for every batch of
+ * functions \f$ f_i \f$, the point \f$ z_i \f$ its gradient was last computed
+ * at, that gradient, and a dense BFGS approximation \f$ B_i \f$ of its
+ * Hessian, and it moves to
+ *
+ * \f[
+ * x = \left(\sum_i B_i\right)^{-1}
+ *     \left(\sum_i B_i z_i - \sum_i \nabla f_i(z_i)\right).
+ * \f]
+ *
+ * The matrices take \f$ O(n d^2) \f$ memory for \f$ n \f$ batches and \f$ d \f$
+ * parameters, and the step needs the inverse of a \f$ d \times d \f$ matrix,
+ * so IQN is limited to small problems.
+ *
+ * LIQN replaces the per-function matrices by one approximation \f$ H \f$ of the
+ * inverse of the average Hessian.  \f$ H \f$ is given in the compact form of
+ * L-BFGS by the last numBasis curvature pairs \f$ (z_i' - z_i, \nabla f_i(z_i')
+ * - \nabla f_i(z_i)) \f$ produced by the incremental updates of the functions;
+ * pairs that don't satisfy the curvature condition are skipped.  With the same
+ * approximation for all functions, the step of IQN becomes
+ *
+ * \f[
+ * x = \bar{z} - H \bar{g},
+ * \f]
+ *
+ * where \f$ \bar{z} \f$ and \f$ \bar{g} \f$ are the averages of the stored
+ * points and gradients, and it is computed by the two-loop recursion of L-BFGS
+ * in \f$ O(m d) \f$ time.  The memory used is \f$ O((n + m) d) \f$: the stored
+ * points and gradients (as in SAG-type methods) and the curvature pairs.
+ *
+ * LIQN needs the same methods from the function as IQN:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates,
+ *                   const size_t begin,
+ *                   const size_t batchSize);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t begin,
+ *                 arma::mat& gradient,
+ *                 const size_t batchSize);
+ */
+class LIQN
+{
+ public:
+  /**
+   * Construct the LIQN optimizer with the given parameters.  The maximum number
+   * of iterations refers to the maximum number of passes over the functions.
+   *
+   * @param stepSize Step size for each iteration.
+   * @param batchSize Size of each batch.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param numBasis Number of curvature pairs to keep.
+   */
+  LIQN(const double stepSize = 0.01,
+       const size_t batchSize = 10,
+       const size_t maxIterations = 100000,
+       const double tolerance = 1e-5,
+       const size_t numBasis = 10);
+
+  /**
+   * Optimize the given function using LIQN.  The given starting point will be
+   * modified to store the finishing point of the algorithm, and the final
+   * objective value is returned.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType>
+  double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the number of curvature pairs to keep.
+  size_t NumBasis() const { return numBasis; }
+  //! Modify the number of curvature pairs to keep.
+  size_t& NumBasis() { return numBasis; }
+
+ private:
+  /**
+   * Compute H * gradient with the two-loop recursion of L-BFGS, where H is
+   * given by the stored curvature pairs.
+   *
+   * @param gradient The vector to multiply.
+   * @param direction The product.
+   * @param s The differences of the points of the pairs.
+   * @param y The differences of the gradients of the pairs.
+   * @param rho The inverses of the inner products of the pairs.
+   * @param numPairs The number of stored pairs.
+   * @param newest The index of the newest pair.
+   */
+  void Direction(const arma::mat& gradient,
+                 arma::mat& direction,
+                 const arma::cube& s,
+                 const arma::cube& y,
+                 const arma::vec& rho,
+                 const size_t numPairs,
+                 const size_t newest) const;
+
+  //! The step size for each example.
+  double stepSize;
+
+  //! The size of each batch.
+  size_t batchSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! The number of curvature pairs to keep.
+  size_t numBasis;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "liqn_impl.hpp"
+
+#endif
@@ -0,0 +1,193 @@
+/**
+ * @file liqn_impl.hpp
+ *
+ * Implementation of the LIQN optimizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_IQN_LIQN_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_IQN_LIQN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "liqn.hpp"
+
+#include <mlpack/core/optimizers/function.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+inline LIQN::LIQN(const double stepSize,
+                  const size_t batchSize,
+                  const size_t maxIterations,
+                  const double tolerance,
+                  const size_t numBasis) :
+    stepSize(stepSize),
+    batchSize(batchSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    numBasis(numBasis)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename DecomposableFunctionType>
+double LIQN::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
+{
+  traits::CheckDecomposableFunctionTypeAPI<DecomposableFunctionType>();
+
+  if (numBasis == 0)
+    throw std::invalid_argument("LIQN::Optimize(): numBasis must be positive");
+
+  // Find the number of functions.
+  const size_t numFunctions = function.NumFunctions();
+  size_t numBatches = numFunctions / batchSize;
+  if (numFunctions % batchSize != 0)
+    ++numBatches; // Capture last few.
+
+  const size_t rows = iterate.n_rows;
+  const size_t cols = iterate.n_cols;
+
+  // The point and the average gradient of every batch at its last update, and
+  // their averages over the batches.  Every batch starts at the given point.
+  arma::cube z(rows, cols, numBatches);
+  arma::cube y(rows, cols, numBatches);
+  arma::mat averageZ = iterate;
+  arma::mat averageG(rows, cols, arma::fill::zeros);
+  for (size_t i = 0, b = 0; i < numFunctions; ++b)
+  {
+    // Find the effective batch size (the last batch may be smaller).
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
+
+    z.slice(b) = iterate;
+    function.Gradient(iterate, i, y.slice(b), effectiveBatchSize);
+    y.slice(b) /= (double) effectiveBatchSize;
+    averageG += y.slice(b);
+
+    i += effectiveBatchSize;
+  }
+  averageG /= (double) numBatches;
+
+  // The curvature pairs, in a ring buffer.
+  arma::cube s(rows, cols, numBasis);
+  arma::cube yDiff(rows, cols, numBasis);
+  arma::vec rho(numBasis);
+  size_t numPairs = 0;
+  size_t newest = numBasis - 1;
+
+  double overallObjective = 0;
+  arma::mat gradient(rows, cols);
+  arma::mat direction(rows, cols);
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  for (size_t i = 0; i < actualMaxIterations; ++i)
+  {
+    for (size_t b = 0; b < numBatches; ++b)
+    {
+      const size_t begin = b * batchSize;
+      const size_t effectiveBatchSize = std::min(batchSize, numFunctions -
+          begin);
+
+      // Refresh the batch, unless it was last computed at this point.
+      const arma::mat step = iterate - z.slice(b);
+      if (arma::norm(arma::vectorise(step)) > 0)
+      {
+        function.Gradient(iterate, begin, gradient, effectiveBatchSize);
+        gradient /= (double) effectiveBatchSize;
+        const arma::mat change = gradient - y.slice(b);
+
+        // Keep the pair if it satisfies the curvature condition.
+        const double sy = arma::dot(step, change);
+        if (sy > 1e-10 * arma::dot(change, change))
+        {
+          newest = (newest + 1) % numBasis;
+          s.slice(newest) = step;
+          yDiff.slice(newest) = change;
+          rho[newest] = 1.0 / sy;
+          numPairs = std::min(numPairs + 1, numBasis);
+        }
+
+        // Update the averages and the tables.
+        averageZ += step / (double) numBatches;
+        averageG += change / (double) numBatches;
+        z.slice(b) = iterate;
+        y.slice(b) = gradient;
+      }
+
+      // Without curvature pairs, this is a gradient step.
+      Direction(averageG, direction, s, yDiff, rho, numPairs, newest);
+      iterate = stepSize * (averageZ - direction) + (1 - stepSize) * iterate;
+    }
+
+    overallObjective = 0;
+    for (size_t f = 0; f < numFunctions; f += batchSize)
+    {
+      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
+      overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
+    }
+    overallObjective /= numFunctions;
+
+    // Output current objective function.
+    Log::Info << "LIQN: iteration " << i << ", objective " << overallObjective
+        << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "LIQN: converged to " << overallObjective << "; "
+          << "terminating with failure.  Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (overallObjective < tolerance)
+    {
+      Log::Info << "LIQN: minimized within tolerance " << tolerance << "; "
+          << "terminating optimization." << std::endl;
+      return overallObjective;
+    }
+  }
+
+  Log::Info << "LIQN: maximum iterations (" << maxIterations << ") reached; "
+      << "terminating optimization." << std::endl;
+
+  return overallObjective;
+}
+
+inline void LIQN::Direction(const arma::mat& gradient,
+                            arma::mat& direction,
+                            const arma::cube& s,
+                            const arma::cube& y,
+                            const arma::vec& rho,
+                            const size_t numPairs,
+                            const size_t newest) const
+{
+  direction = gradient;
+  if (numPairs == 0)
+    return;
+
+  const size_t size = s.n_slices;
+  arma::vec alpha(numPairs);
+  for (size_t k = 0; k < numPairs; ++k)
+  {
+    const size_t j = (newest + size - k) % size;
+    alpha[k] = rho[j] * arma::dot(s.slice(j), direction);
+    direction -= alpha[k] * y.slice(j);
+  }
+
+  // Scale by the curvature of the newest pair, as L-BFGS does.
+  direction *= 1.0 / (rho[newest] * arma::dot(y.slice(newest),
+      y.slice(newest)));
+
+  for (size_t k = numPairs; k > 0; --k)
+  {
+    const size_t j = (newest + size - (k - 1)) % size;
+    const double beta = rho[j] * arma::dot(y.slice(j), direction);
+    direction += (alpha[k - 1] - beta) * s.slice(j);
+  }
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_OPTIMIZERS_KATYUSHA_KATYUSHA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/full_gradient.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -82,6 +83,9 @@ class KatyushaType
    * @param tolerance Maximum absolute tolerance to terminate algorithm.
    * @param shuffle If true, the function order is shuffled; otherwise, each
    *    function is visited in linear order.
+   * @param parallelSnapshot Whether the objective and the full gradient of each
+   *     outer iteration are computed in parallel (then the function has to be
+   *     safe to evaluate from several threads at once).
    */
   KatyushaType(const double convexity = 1.0,
                const double lipschitz = 10.0,
@@ -89,7 +93,8 @@ class KatyushaType
                const size_t maxIterations = 1000,
                const size_t innerIterations = 0,
                const double tolerance = 1e-5,
-               const bool shuffle = true);
+               const bool shuffle = true,
+               const bool parallelSnapshot = false);
 
   /**
    * Optimize the given function using Katyusha. The given starting point will
@@ -139,6 +144,13 @@ class KatyushaType
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return shuffle; }
 
+  //! Get whether the objective and the full gradient are computed in
+  //! parallel.
+  bool ParallelSnapshot() const { return parallelSnapshot; }
+  //! Modify whether the objective and the full gradient are computed in
+  //! parallel.
+  bool& ParallelSnapshot() { return parallelSnapshot; }
+
  private:
   //! The convexity regularization term.
   double convexity;
@@ -161,6 +173,9 @@ class KatyushaType
   //! Controls whether or not the individual functions are shuffled when
   //! iterating.
   bool shuffle;
+
+  //! Whether the objective and the full gradient are computed in parallel.
+  bool parallelSnapshot;
 };
 
 // Convenience typedefs.
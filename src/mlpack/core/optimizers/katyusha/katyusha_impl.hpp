@@ -28,14 +28,16 @@ KatyushaType<Proximal>::KatyushaType(
     const size_t maxIterations,
     const size_t innerIterations,
     const double tolerance,
-    const bool shuffle) :
+    const bool shuffle,
+    const bool parallelSnapshot) :
     convexity(convexity),
     lipschitz(lipschitz),
     batchSize(batchSize),
     maxIterations(maxIterations),
     innerIterations(innerIterations),
     tolerance(tolerance),
-    shuffle(shuffle)
+    shuffle(shuffle),
+    parallelSnapshot(parallelSnapshot)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
@@ -93,12 +95,8 @@ double KatyushaType<Proximal>::Optimize(
   for (size_t i = 0; i < actualMaxIterations; ++i)
   {
     // Calculate the objective function.
-    overallObjective = 0;
-    for (size_t f = 0; f < numFunctions; f += batchSize)
-    {
-      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
-      overallObjective += function.Evaluate(iterate0, f, effectiveBatchSize);
-    }
+    overallObjective = FullObjective(function, iterate0, batchSize,
+        parallelSnapshot);
 
     if (std::isnan(overallObjective) || std::isinf(overallObjective))
     {
@@ -117,21 +115,9 @@ double KatyushaType<Proximal>::Optimize(
 
     lastObjective = overallObjective;
 
-    // Compute the full gradient.
-    size_t effectiveBatchSize = std::min(batchSize, numFunctions);
-    function.Gradient(iterate, 0, fullGradient, effectiveBatchSize);
-    for (size_t f = effectiveBatchSize; f < numFunctions;
-        /* incrementing done manually */)
-    {
-      // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - f);
-
-      function.Gradient(iterate0, f, gradient, effectiveBatchSize);
-      fullGradient += gradient;
-
-      f += effectiveBatchSize;
-    }
-    fullGradient /= (double) numFunctions;
+    // Compute the full gradient at the snapshot.
+    FullGradient(function, iterate0, fullGradient, gradient, batchSize,
+        parallelSnapshot);
 
     // To keep track of where we are and how things are going.
     double cw = 1;
@@ -151,7 +137,8 @@ double KatyushaType<Proximal>::Optimize(
       }
 
       // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - currentFunction);
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - currentFunction);
       iterate = tau1 * z + tau2 * iterate0 + (1 - tau1 - tau2) * y;
 
       // Calculate variance reduced gradient.
@@ -199,12 +186,8 @@ double KatyushaType<Proximal>::Optimize(
       << "; terminating optimization." << std::endl;
 
   // Calculate final objective.
-  overallObjective = 0;
-  for (size_t i = 0; i < numFunctions; i += batchSize)
-  {
-    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
-    overallObjective += function.Evaluate(iterate, i, effectiveBatchSize);
-  }
+  overallObjective = FullObjective(function, iterate, batchSize,
+      parallelSnapshot);
   return overallObjective;
 }
 
@@ -28,6 +28,8 @@ namespace optimization {
  *     (before giving up).
  * @param minStep The minimum step of the line search.
  * @param maxStep The maximum step of the line search.
+ * @param lineSearchBatchSize Number of trial steps of the line search that are
+ *     evaluated in parallel.
  */
 L_BFGS::L_BFGS(const size_t numBasis,
                const size_t maxIterations,
@@ -37,7 +39,8 @@ L_BFGS::L_BFGS(const size_t numBasis,
                const double factr,
                const size_t maxLineSearchTrials,
                const double minStep,
-               const double maxStep) :
+               const double maxStep,
+               const size_t lineSearchBatchSize) :
     numBasis(numBasis),
     maxIterations(maxIterations),
     armijoConstant(armijoConstant),
@@ -46,7 +49,8 @@ L_BFGS::L_BFGS(const size_t numBasis,
     factr(factr),
     maxLineSearchTrials(maxLineSearchTrials),
     minStep(minStep),
-    maxStep(maxStep)
+    maxStep(maxStep),
+    lineSearchBatchSize(lineSearchBatchSize)
 {
   // Nothing to do.
 }
@@ -59,17 +63,15 @@ L_BFGS::L_BFGS(const size_t numBasis,
  */
 double L_BFGS::ChooseScalingFactor(const size_t iterationNum,
                                    const arma::mat& gradient,
-                                   const arma::cube& s,
-                                   const arma::cube& y)
+                                   const arma::vec& sDotY,
+                                   const arma::vec& yDotY)
 {
   double scalingFactor = 1.0;
   if (iterationNum > 0)
   {
     int previousPos = (iterationNum - 1) % numBasis;
-    // Get s and y matrices once instead of multiple times.
-    const arma::mat& sMat = s.slice(previousPos);
-    const arma::mat& yMat = y.slice(previousPos);
-    scalingFactor = dot(sMat, yMat) / dot(yMat, yMat);
+    // The dot products were computed when the basis was updated.
+    scalingFactor = sDotY[previousPos] / yDotY[previousPos];
   }
   else
   {
@@ -92,38 +94,48 @@ void L_BFGS::SearchDirection(const arma::mat& gradient,
                              const double scalingFactor,
                              const arma::cube& s,
                              const arma::cube& y,
+                             const arma::vec& sDotY,
                              arma::mat& searchDirection)
 {
   // Start from this point.
   searchDirection = gradient;
 
   // See "A Recursive Formula to Compute H * g" in "Updating quasi-Newton
-  // matrices with limited storage" (Nocedal, 1980).
-
-  // Temporary variables.
-  arma::vec rho(numBasis);
-  arma::vec alpha(numBasis);
+  // matrices with limited storage" (Nocedal, 1980).  Each step of the loops
+  // updates the search direction and needs its dot product with the next basis
+  // vector, so the update and the next dot product are done in one pass.
+  const size_t n = searchDirection.n_elem;
+  double* direction = searchDirection.memptr();
 
   size_t limit = (numBasis > iterationNum) ? 0 : (iterationNum - numBasis);
+  alpha.set_size(numBasis);
+
+  double dotProduct = (iterationNum != limit) ? arma::dot(s.slice(
+      (iterationNum + (numBasis - 1)) % numBasis), searchDirection) : 0.0;
   for (size_t i = iterationNum; i != limit; i--)
   {
     int translatedPosition = (i + (numBasis - 1)) % numBasis;
-    rho[iterationNum - i] = 1.0 / arma::dot(y.slice(translatedPosition),
-                                            s.slice(translatedPosition));
-    alpha[iterationNum - i] = rho[iterationNum - i] *
-        arma::dot(s.slice(translatedPosition), searchDirection);
-    searchDirection -= alpha[iterationNum - i] * y.slice(translatedPosition);
+    alpha[iterationNum - i] = dotProduct / sDotY[translatedPosition];
+
+    const double* next = (i - 1 != limit) ?
+        s.slice((i - 1 + (numBasis - 1)) % numBasis).memptr() : NULL;
+    dotProduct = ScaleAddDot(-alpha[iterationNum - i],
+        y.slice(translatedPosition).memptr(), direction, next, n);
   }
 
   searchDirection *= scalingFactor;
 
+  dotProduct = (iterationNum != limit) ?
+      arma::dot(y.slice(limit % numBasis), searchDirection) : 0.0;
   for (size_t i = limit; i < iterationNum; i++)
   {
     int translatedPosition = i % numBasis;
-    double beta = rho[iterationNum - i - 1] *
-        arma::dot(y.slice(translatedPosition), searchDirection);
-    searchDirection += (alpha[iterationNum - i - 1] - beta) *
-        s.slice(translatedPosition);
+    double beta = dotProduct / sDotY[translatedPosition];
+
+    const double* next = (i + 1 < iterationNum) ?
+        y.slice((i + 1) % numBasis).memptr() : NULL;
+    dotProduct = ScaleAddDot(alpha[iterationNum - i - 1] - beta,
+        s.slice(translatedPosition).memptr(), direction, next, n);
   }
 
   // Negate the search direction so that it is a descent direction.
@@ -137,23 +149,56 @@ void L_BFGS::SearchDirection(const arma::mat& gradient,
  *
  * @param iterationNum Iteration number
  * @param iterate Current point
- * @param oldIterate Point at last iteration
  * @param gradient Gradient at current point (iterate)
- * @param oldGradient Gradient at last iteration point (oldIterate)
  */
 void L_BFGS::UpdateBasisSet(const size_t iterationNum,
                             const arma::mat& iterate,
-                            const arma::mat& oldIterate,
                             const arma::mat& gradient,
-                            const arma::mat& oldGradient,
                             arma::cube& s,
-                            arma::cube& y)
+                            arma::cube& y,
+                            arma::vec& sDotY,
+                            arma::vec& yDotY)
 {
   // Overwrite a certain position instead of pushing everything in the vector
-  // back one position.
+  // back one position.  The slices hold the old iterate and the old gradient,
+  // so no other copy of them is needed.
   int overwritePos = iterationNum % numBasis;
-  s.slice(overwritePos) = iterate - oldIterate;
-  y.slice(overwritePos) = gradient - oldGradient;
+  s.slice(overwritePos) = iterate - s.slice(overwritePos);
+  y.slice(overwritePos) = gradient - y.slice(overwritePos);
+
+  // Both loops of the search direction and the scaling factor need these, so
+  // compute them once per basis pair.
+  sDotY[overwritePos] = arma::dot(y.slice(overwritePos), s.slice(overwritePos));
+  yDotY[overwritePos] = arma::dot(y.slice(overwritePos), y.slice(overwritePos));
+}
+
+double L_BFGS::ScaleAddDot(const double a,
+                           const double* x,
+                           double* out,
+                           const double* next,
+                           const size_t n)
+{
+  // Below this size the parallel region costs more than it saves.
+  const size_t parallelSize = 100000;
+
+  if (next == NULL)
+  {
+    #pragma omp parallel for if (n >= parallelSize)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+      out[i] += a * x[i];
+
+    return 0.0;
+  }
+
+  double dotProduct = 0.0;
+  #pragma omp parallel for reduction(+:dotProduct) if (n >= parallelSize)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    out[i] += a * x[i];
+    dotProduct += next[i] * out[i];
+  }
+
+  return dotProduct;
 }
 
 } // namespace optimization
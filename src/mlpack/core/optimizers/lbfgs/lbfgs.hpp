@@ -15,6 +15,8 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/optimizers/function.hpp>
+#include <mlpack/core/optimizers/checkpoint.hpp>
+#include <mlpack/core/optimizers/callbacks/callback.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -51,6 +53,10 @@ class L_BFGS
    *     (before giving up).
    * @param minStep The minimum step of the line search.
    * @param maxStep The maximum step of the line search.
+   * @param lineSearchBatchSize Number of trial steps of the line search that
+   *     are evaluated in parallel.  Values larger than 1 require a function
+   *     whose EvaluateWithGradient() is safe to call from several threads at
+   *     once, and one copy of the iterate and the gradient per trial.
    */
   L_BFGS(const size_t numBasis = 10, /* same default as scipy */
          const size_t maxIterations = 10000, /* many but not infinite */
@@ -60,7 +66,8 @@ class L_BFGS
          const double factr = 1e-15,
          const size_t maxLineSearchTrials = 50,
          const double minStep = 1e-20,
-         const double maxStep = 1e20);
+         const double maxStep = 1e20,
+         const size_t lineSearchBatchSize = 1);
 
   /**
    * Return the point where the lowest function value has been found.
@@ -131,7 +138,67 @@ class L_BFGS
   //! Modify the maximum line search step size.
   double& MaxStep() { return maxStep; }
 
+  //! Get the number of line search trials evaluated in parallel.
+  size_t LineSearchBatchSize() const { return lineSearchBatchSize; }
+  //! Modify the number of line search trials evaluated in parallel.
+  size_t& LineSearchBatchSize() { return lineSearchBatchSize; }
+
+  //! Get the checkpointing settings.
+  const Checkpoint& Checkpointing() const { return checkpoint; }
+  //! Modify the checkpointing settings.  If a checkpoint file is set, the
+  //! state is written every Interval() iterations, and Optimize() resumes from
+  //! the file if it already exists.
+  Checkpoint& Checkpointing() { return checkpoint; }
+
+  //! Get the callbacks that are notified of steps and evaluations.
+  const CallbackList& Callbacks() const { return callbacks; }
+  //! Modify the callbacks that are notified of steps and evaluations.
+  CallbackList& Callbacks() { return callbacks; }
+
  private:
+  /**
+   * The state of a running optimization, as written to a checkpoint: the
+   * iterate, the last completed iteration and the stored basis pairs.  The objective
+   * and the gradient are recomputed when resuming.
+   */
+  class RunState
+  {
+   public:
+    RunState(arma::mat& iterate,
+             size_t& iteration,
+             arma::cube& s,
+             arma::cube& y,
+             arma::vec& sDotY,
+             arma::vec& yDotY) :
+        iterate(iterate),
+        iteration(iteration),
+        s(s),
+        y(y),
+        sDotY(sDotY),
+        yDotY(yDotY)
+    { /* Nothing to do. */ }
+
+    //! Serialize the state.
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int /* version */)
+    {
+      ar & BOOST_SERIALIZATION_NVP(iterate);
+      ar & BOOST_SERIALIZATION_NVP(iteration);
+      ar & BOOST_SERIALIZATION_NVP(s);
+      ar & BOOST_SERIALIZATION_NVP(y);
+      ar & BOOST_SERIALIZATION_NVP(sDotY);
+      ar & BOOST_SERIALIZATION_NVP(yDotY);
+    }
+
+   private:
+    arma::mat& iterate;
+    size_t& iteration;
+    arma::cube& s;
+    arma::cube& y;
+    arma::vec& sDotY;
+    arma::vec& yDotY;
+  };
+
   //! Size of memory for this L-BFGS optimizer.
   size_t numBasis;
   //! Maximum number of iterations.
@@ -150,6 +217,23 @@ class L_BFGS
   double minStep;
   //! Maximum step of the line search.
   double maxStep;
+  //! Number of trial steps of the line search evaluated in parallel.
+  size_t lineSearchBatchSize;
+
+  //! Trial points of the parallel line search.
+  std::vector<arma::mat> trialIterates;
+  //! Gradients at the trial points of the parallel line search.
+  std::vector<arma::mat> trialGradients;
+  //! Objective values at the trial points of the parallel line search.
+  arma::vec trialValues;
+  //! Storage for the coefficients of the two-loop recursion.
+  arma::vec alpha;
+
+  //! The checkpointing settings.
+  Checkpoint checkpoint;
+
+  //! The callbacks (not owned).
+  CallbackList callbacks;
 
   /**
    * Calculate the scaling factor, gamma, which is used to scale the Hessian
@@ -160,8 +244,8 @@ class L_BFGS
    */
   double ChooseScalingFactor(const size_t iterationNum,
                              const arma::mat& gradient,
-                             const arma::cube& s,
-                             const arma::cube& y);
+                             const arma::vec& sDotY,
+                             const arma::vec& yDotY);
 
   /**
    * Perform a back-tracking line search along the search direction to
@@ -184,6 +268,20 @@ class L_BFGS
                   arma::mat& newIterateTmp,
                   const arma::mat& searchDirection);
 
+  /**
+   * Evaluate the given number of trial steps of the line search in parallel,
+   * starting with the given step size and multiplying it with the given factor
+   * from one trial to the next.  The results are stored in trialValues and
+   * trialGradients.
+   */
+  template<typename FunctionType>
+  void EvaluateTrialSteps(FunctionType& function,
+                          const arma::mat& iterate,
+                          const arma::mat& searchDirection,
+                          const double stepSize,
+                          const double factor,
+                          const size_t trials);
+
   /**
    * Find the L-BFGS search direction.
    *
@@ -197,26 +295,38 @@ class L_BFGS
                        const double scalingFactor,
                        const arma::cube& s,
                        const arma::cube& y,
+                       const arma::vec& sDotY,
                        arma::mat& searchDirection);
 
   /**
    * Update the y and s matrices, which store the differences
    * between the iterate and old iterate and the differences between the
-   * gradient and the old gradient, respectively.
+   * gradient and the old gradient, respectively, along with their dot
+   * products.  The slices to overwrite must hold the old iterate and the old
+   * gradient.
    *
    * @param iterationNum Iteration number
    * @param iterate Current point
-   * @param oldIterate Point at last iteration
    * @param gradient Gradient at current point (iterate)
-   * @param oldGradient Gradient at last iteration point (oldIterate)
    */
   void UpdateBasisSet(const size_t iterationNum,
                       const arma::mat& iterate,
-                      const arma::mat& oldIterate,
                       const arma::mat& gradient,
-                      const arma::mat& oldGradient,
                       arma::cube& s,
-                      arma::cube& y);
+                      arma::cube& y,
+                      arma::vec& sDotY,
+                      arma::vec& yDotY);
+
+  /**
+   * Compute out += a * x and return the dot product of next and the updated
+   * out (or 0 if next is NULL) in a single pass over the memory.  The two loops
+   * of the search direction recursion are chains of such updates.
+   */
+  static double ScaleAddDot(const double a,
+                            const double* x,
+                            double* out,
+                            const double* next,
+                            const size_t n);
 };
 
 } // namespace optimization
@@ -74,59 +74,96 @@ bool L_BFGS::LineSearch(FunctionType& function,
   double bestStepSize = 1.0;
   double bestObjective = std::numeric_limits<double>::max();
 
-  while (true)
+  bool finished = false;
+  while (!finished)
   {
-    // Perform a step and evaluate the gradient and the function values at that
-    // point.
-    newIterateTmp = iterate;
-    newIterateTmp += stepSize * searchDirection;
-    functionValue = function.EvaluateWithGradient(newIterateTmp, gradient);
-    if (functionValue < bestObjective)
+    // Evaluate the next trial step.  With a parallel line search, also evaluate
+    // the steps the search tries after it as long as the step keeps being too
+    // long.  The trials are then processed in order, exactly as if they had
+    // been evaluated one at a time.
+    const size_t trials = std::max(std::min(lineSearchBatchSize,
+        maxLineSearchTrials - numIterations), (size_t) 1);
+    if (trials == 1)
     {
-      bestStepSize = stepSize;
-      bestObjective = functionValue;
+      // Perform a step and evaluate the gradient and the function values at
+      // that point.
+      newIterateTmp = iterate;
+      newIterateTmp += stepSize * searchDirection;
+      trialValues.set_size(1);
+      trialValues[0] = function.EvaluateWithGradient(newIterateTmp, gradient);
     }
-    numIterations++;
-
-    if (functionValue > initialFunctionValue + stepSize *
-        linearApproxFunctionValueDecrease)
+    else
     {
-      width = dec;
+      EvaluateTrialSteps(function, iterate, searchDirection, stepSize, dec,
+          trials);
     }
-    else
+
+    for (size_t t = 0; t < trials; ++t)
     {
-      // Check Wolfe's condition.
-      double searchDirectionDotGradient = arma::dot(gradient, searchDirection);
+      const arma::mat& trialGradient = (trials == 1) ? gradient :
+          trialGradients[t];
+      functionValue = trialValues[t];
+      if (functionValue < bestObjective)
+      {
+        bestStepSize = stepSize;
+        bestObjective = functionValue;
+      }
+      numIterations++;
 
-      if (searchDirectionDotGradient < wolfe *
-          initialSearchDirectionDotGradient)
+      if (functionValue > initialFunctionValue + stepSize *
+          linearApproxFunctionValueDecrease)
       {
-        width = inc;
+        width = dec;
       }
       else
       {
-        if (searchDirectionDotGradient > -wolfe *
+        // Check Wolfe's condition.
+        double searchDirectionDotGradient = arma::dot(trialGradient,
+            searchDirection);
+
+        if (searchDirectionDotGradient < wolfe *
             initialSearchDirectionDotGradient)
         {
-          width = dec;
+          width = inc;
         }
         else
         {
-          break;
+          if (searchDirectionDotGradient > -wolfe *
+              initialSearchDirectionDotGradient)
+          {
+            width = dec;
+          }
+          else
+          {
+            finished = true;
+          }
         }
       }
-    }
 
-    // Terminate when the step size gets too small or too big or it
-    // exceeds the max number of iterations.
-    const bool cond1 = (stepSize < minStep);
-    const bool cond2 = (stepSize > maxStep);
-    const bool cond3 = (numIterations >= maxLineSearchTrials);
-    if (cond1 || cond2 || cond3)
-      break;
+      // Terminate when the step size gets too small or too big or it
+      // exceeds the max number of iterations.
+      const bool cond1 = (stepSize < minStep);
+      const bool cond2 = (stepSize > maxStep);
+      const bool cond3 = (numIterations >= maxLineSearchTrials);
+      if (cond1 || cond2 || cond3)
+        finished = true;
+
+      if (finished)
+      {
+        // The gradient has to be the one of the last processed trial.
+        if (trials > 1)
+          gradient = trialGradients[t];
+        break;
+      }
+
+      // Scale the step size.
+      stepSize *= width;
 
-    // Scale the step size.
-    stepSize *= width;
+      // The remaining trials were evaluated for shorter steps, so they are of
+      // no use when the step grows.
+      if (width != dec)
+        break;
+    }
   }
 
   // Move to the new iterate.
@@ -134,6 +171,38 @@ bool L_BFGS::LineSearch(FunctionType& function,
   return true;
 }
 
+template<typename FunctionType>
+void L_BFGS::EvaluateTrialSteps(FunctionType& function,
+                                const arma::mat& iterate,
+                                const arma::mat& searchDirection,
+                                const double stepSize,
+                                const double factor,
+                                const size_t trials)
+{
+  // The buffers are kept from one line search to the next.
+  if (trialIterates.size() < trials)
+  {
+    trialIterates.resize(trials);
+    trialGradients.resize(trials);
+  }
+  trialValues.set_size(trials);
+
+  // Compute the step sizes in the same way as the serial search.
+  arma::vec stepSizes(trials);
+  stepSizes[0] = stepSize;
+  for (size_t t = 1; t < trials; ++t)
+    stepSizes[t] = stepSizes[t - 1] * factor;
+
+  #pragma omp parallel for
+  for (omp_size_t t = 0; t < (omp_size_t) trials; ++t)
+  {
+    trialIterates[t] = iterate;
+    trialIterates[t] += stepSizes[t] * searchDirection;
+    trialValues[t] = function.EvaluateWithGradient(trialIterates[t],
+        trialGradients[t]);
+  }
+}
+
 /**
  * Use L_BFGS to optimize the given function, starting at the given iterate
  * point and performing no more than the specified number of maximum iterations.
@@ -162,27 +231,46 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
   arma::mat newIterateTmp(rows, cols);
   arma::cube s(rows, cols, numBasis);
   arma::cube y(rows, cols, numBasis);
-
-  // The old iterate to be saved.
-  arma::mat oldIterate;
-  oldIterate.zeros(iterate.n_rows, iterate.n_cols);
+  arma::vec sDotY(numBasis);
+  arma::vec yDotY(numBasis);
 
   // Whether to optimize until convergence.
   bool optimizeUntilConvergence = (maxIterations == 0);
 
-  // The gradient: the current and the old.
+  // The gradient.
   arma::mat gradient(iterate.n_rows, iterate.n_cols, arma::fill::zeros);
-  arma::mat oldGradient(iterate.n_rows, iterate.n_cols, arma::fill::zeros);
 
   // The search direction.
   arma::mat searchDirection(iterate.n_rows, iterate.n_cols, arma::fill::zeros);
 
+  // Pick up from an earlier run, if there is a checkpoint.  The checkpoint
+  // holds the number of the last completed iteration.
+  size_t itNum = 0;
+  RunState state(iterate, itNum, s, y, sDotY, yDotY);
+  if (checkpoint.Load(state))
+  {
+    if (iterate.n_rows != rows || iterate.n_cols != cols ||
+        s.n_slices != numBasis)
+    {
+      std::ostringstream oss;
+      oss << "L_BFGS::Optimize(): checkpoint '" << checkpoint.Filename()
+          << "' does not match the size of the given iterate or the number of "
+          << "basis points";
+      throw std::invalid_argument(oss.str());
+    }
+
+    ++itNum;
+  }
+
   // The initial function value and gradient.
   double functionValue = f.EvaluateWithGradient(iterate, gradient);
   double prevFunctionValue = functionValue;
 
+  callbacks.BeginOptimization(iterate);
+  bool terminated = callbacks.Evaluate(iterate, functionValue);
+
   // The main optimization loop.
-  for (size_t itNum = 0; optimizeUntilConvergence || (itNum != maxIterations);
+  for (; !terminated && (optimizeUntilConvergence || itNum < maxIterations);
        ++itNum)
   {
 #ifdef DEBUG
@@ -217,15 +305,20 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
     }
 
     // Choose the scaling factor.
-    double scalingFactor = ChooseScalingFactor(itNum, gradient, s, y);
+    double scalingFactor = ChooseScalingFactor(itNum, gradient, sDotY, yDotY);
 
     // Build an approximation to the Hessian and choose the search
     // direction for the current iteration.
-    SearchDirection(gradient, itNum, scalingFactor, s, y, searchDirection);
-
-    // Save the old iterate and the gradient before stepping.
+    SearchDirection(gradient, itNum, scalingFactor, s, y, sDotY,
+        searchDirection);
+
+    // Save the old iterate and the gradient before stepping.  The search
+    // direction doesn't need the oldest basis pair anymore, so they are stored
+    // where the new pair goes instead of in separate matrices.
+    const size_t overwritePos = itNum % numBasis;
+    arma::mat& oldIterate = s.slice(overwritePos);
     oldIterate = iterate;
-    oldGradient = gradient;
+    y.slice(overwritePos) = gradient;
 
     // Do a line search and take a step.
     Timer::Start("line_search");
@@ -239,7 +332,7 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
 
     // It is possible that the difference between the two coordinates is zero.
     // In this case we terminate successfully.
-    if (accu(iterate != oldIterate) == 0)
+    if (std::equal(iterate.begin(), iterate.end(), oldIterate.begin()))
     {
       Log::Debug << "L-BFGS step size of 0 (terminating successfully)."
           << std::endl;
@@ -258,9 +351,24 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
     }
 
     // Overwrite an old basis set.
-    UpdateBasisSet(itNum, iterate, oldIterate, gradient, oldGradient, s, y);
+    UpdateBasisSet(itNum, iterate, gradient, s, y, sDotY, yDotY);
+
+    if (checkpoint.Due(itNum + 1))
+      checkpoint.Save(state);
+
+    if (callbacks.StepTaken(iterate, functionValue))
+    {
+      Log::Debug << "L-BFGS terminated by a callback." << std::endl;
+      break;
+    }
   } // End of the optimization loop.
 
+  // The callbacks may replace the iterate (for instance, with the best point
+  // seen), so the objective has to be recomputed if there are any.
+  callbacks.EndOptimization(iterate);
+  if (callbacks.Size() > 0)
+    functionValue = f.Evaluate(iterate);
+
   return functionValue;
 }
 
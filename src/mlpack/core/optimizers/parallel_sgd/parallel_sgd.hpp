@@ -15,6 +15,8 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/random.hpp>
 #include "decay_policies/constant_step.hpp"
+#include "update_policies/sparse_update.hpp"
+#include "update_policies/dense_batch_update.hpp"
 
 namespace mlpack {
 namespace optimization {
@@ -53,10 +55,19 @@ namespace optimization {
  * out-param for the gradient, as ParallelSGD is only expected to be relevant in
  * situations where the computed gradient is sparse.
  *
+ * How each thread applies its gradients to the shared iterate is controlled by
+ * the UpdatePolicyType.  The default, SparseUpdate, requires the sparse
+ * Gradient() above.  For functions with dense gradients, DenseBatchUpdate
+ * accumulates gradients per thread and merges them periodically; it requires a
+ * Gradient() that takes an arma::mat instead.
+ *
  * @tparam DecayPolicyType Step size update policy used by parallel SGD
  *     to update the stepsize after each iteration.
+ * @tparam UpdatePolicyType Policy used by each thread to apply its gradients
+ *     to the shared iterate.
  */
-template <typename DecayPolicyType = ConstantStep>
+template <typename DecayPolicyType = ConstantStep,
+          typename UpdatePolicyType = SparseUpdate>
 class ParallelSGD
 {
  public:
@@ -76,12 +87,14 @@ class ParallelSGD
    * @param shuffle If true, the function order is shuffled; otherwise, each
    *     function is visited in linear order.
    * @param decayPolicy The step size update policy to use.
+   * @param updatePolicy The policy used to apply gradients to the iterate.
   */
   ParallelSGD(const size_t maxIterations,
               const size_t threadShareSize,
               const double tolerance = 1e-5,
               const bool shuffle = true,
-              const DecayPolicyType& decayPolicy = DecayPolicyType());
+              const DecayPolicyType& decayPolicy = DecayPolicyType(),
+              const UpdatePolicyType& updatePolicy = UpdatePolicyType());
 
   /**
    * Optimize the given function using the parallel SGD algorithm. The given
@@ -124,6 +137,11 @@ class ParallelSGD
   //! Modify the step size decay policy.
   DecayPolicyType& DecayPolicy() { return decayPolicy; }
 
+  //! Get the update policy.
+  const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
+  //! Modify the update policy.
+  UpdatePolicyType& UpdatePolicy() { return updatePolicy; }
+
  private:
   //! The maximum number of allowed iterations.
   size_t maxIterations;
@@ -140,6 +158,9 @@ class ParallelSGD
 
   //! The step size decay policy.
   DecayPolicyType decayPolicy;
+
+  //! The policy used to apply gradients to the iterate.
+  UpdatePolicyType updatePolicy;
 };
 
 } // namespace optimization
@@ -20,29 +20,28 @@
 namespace mlpack {
 namespace optimization {
 
-template <typename DecayPolicyType>
-ParallelSGD<DecayPolicyType>::ParallelSGD(
+template <typename DecayPolicyType, typename UpdatePolicyType>
+ParallelSGD<DecayPolicyType, UpdatePolicyType>::ParallelSGD(
     const size_t maxIterations,
     const size_t threadShareSize,
     const double tolerance,
     const bool shuffle,
-    const DecayPolicyType& decayPolicy) :
+    const DecayPolicyType& decayPolicy,
+    const UpdatePolicyType& updatePolicy) :
     maxIterations(maxIterations),
     threadShareSize(threadShareSize),
     tolerance(tolerance),
     shuffle(shuffle),
-    decayPolicy(decayPolicy)
+    decayPolicy(decayPolicy),
+    updatePolicy(updatePolicy)
 { /* Nothing to do. */ }
 
-template <typename DecayPolicyType>
+template <typename DecayPolicyType, typename UpdatePolicyType>
 template <typename SparseFunctionType>
-double ParallelSGD<DecayPolicyType>::Optimize(
+double ParallelSGD<DecayPolicyType, UpdatePolicyType>::Optimize(
     SparseFunctionType& function,
     arma::mat& iterate)
 {
-  // Check that we have all the functions that we need.
-  traits::CheckSparseFunctionTypeAPI<SparseFunctionType>();
-
   double overallObjective = DBL_MAX;
   double lastObjective;
 
@@ -90,6 +89,9 @@ double ParallelSGD<DecayPolicyType>::Optimize(
           mlpack::math::randGen);
     }
 
+    // The threads update the iterate in parallel, so the BLAS calls of each
+    // use one thread.
+    util::SingleThreadedBLAS singleThreadedBLAS;
     #pragma omp parallel
     {
       // Each processor gets a subset of the instances.
@@ -99,30 +101,15 @@ double ParallelSGD<DecayPolicyType>::Optimize(
         threadId = omp_get_thread_num();
       #endif
 
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
-      {
-        // Each instance affects only some components of the decision variable.
-        // So the gradient is sparse.
-        arma::sp_mat gradient;
-
-        // Evaluate the sparse gradient.
-        function.Gradient(iterate, visitationOrder[j], gradient, 1);
-
-        // Update the decision variable with non-zero components of the
-        // gradient.
-        for (size_t i = 0; i < gradient.n_cols; ++i)
-        {
-          // Iterate over the non-zero elements.
-          for (arma::sp_mat::iterator cur = gradient.begin_col(i);
-              cur != gradient.end_col(i); ++cur)
-          {
-            #pragma omp atomic
-            iterate(cur.row(), i) -= stepSize * (*cur);
-          }
-        }
-      }
+      const size_t begin = std::min(threadId * threadShareSize,
+          (size_t) visitationOrder.n_elem);
+      const size_t end = std::min((threadId + 1) * threadShareSize,
+          (size_t) visitationOrder.n_elem);
+
+      // Apply the gradients of this thread's functions; the update policy also
+      // checks that the function has the API it needs.
+      updatePolicy.Update(function, iterate, visitationOrder, begin, end,
+          stepSize);
     }
   }
 
@@ -0,0 +1,130 @@
+/**
+ * @file dense_batch_update.hpp
+ *
+ * Update policy for parallel SGD which accumulates dense gradients in a
+ * thread-local buffer and merges them into the shared iterate periodically.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_DENSE_BATCH_UPDATE_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_DENSE_BATCH_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * The DenseBatchUpdate policy is meant for models whose gradients are dense or
+ * semi-dense, such as SoftmaxRegressionFunction or LogisticRegressionFunction.
+ * Applying those gradients element by element with atomics (as SparseUpdate
+ * does) makes the threads contend on every element of the iterate for every
+ * function.  Instead, each thread sums the gradients of mergeInterval
+ * functions into a private buffer, and then merges the buffer into the shared
+ * iterate without taking any lock, skipping elements that are zero.  This
+ * divides the number of writes to shared memory by mergeInterval.
+ *
+ * The gradients are still computed at the (possibly stale) shared iterate, as
+ * in HOGWILD!, so a mergeInterval of 1 gives the same updates as SparseUpdate
+ * would give for a dense gradient.
+ *
+ * The function to be optimized must provide
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * and Gradient() must be safe to call from several threads at once (this is
+ * true for functions whose Gradient() is const and does not modify any
+ * internal state; it is not true for ann::FFN).
+ */
+class DenseBatchUpdate
+{
+ public:
+  /**
+   * Create the update policy.
+   *
+   * @param mergeInterval Number of gradients each thread accumulates before
+   *     merging them into the shared iterate.
+   */
+  DenseBatchUpdate(const size_t mergeInterval = 32) :
+      mergeInterval(mergeInterval)
+  { /* Nothing to do. */ }
+
+  /**
+   * Process the functions visitationOrder[begin] through
+   * visitationOrder[end - 1].  This is called by every thread simultaneously.
+   *
+   * @param function Function being optimized.
+   * @param iterate Shared decision variable.
+   * @param visitationOrder Order in which to visit the functions.
+   * @param begin First position in visitationOrder to process.
+   * @param end One past the last position in visitationOrder to process.
+   * @param stepSize Step size for this iteration.
+   */
+  template<typename FunctionType>
+  void Update(FunctionType& function,
+              arma::mat& iterate,
+              const arma::Col<size_t>& visitationOrder,
+              const size_t begin,
+              const size_t end,
+              const double stepSize)
+  {
+    arma::mat gradient;
+    arma::mat accumulated(iterate.n_rows, iterate.n_cols, arma::fill::zeros);
+    size_t numAccumulated = 0;
+
+    for (size_t j = begin; j < end; ++j)
+    {
+      function.Gradient(iterate, visitationOrder[j], gradient, 1);
+      accumulated += gradient;
+
+      if (++numAccumulated == mergeInterval || j == end - 1)
+      {
+        Merge(iterate, accumulated, stepSize);
+        accumulated.zeros();
+        numAccumulated = 0;
+      }
+    }
+  }
+
+  //! Get the number of gradients accumulated before each merge.
+  size_t MergeInterval() const { return mergeInterval; }
+  //! Modify the number of gradients accumulated before each merge.
+  size_t& MergeInterval() { return mergeInterval; }
+
+ private:
+  /**
+   * Subtract stepSize * update from the shared iterate.  Each element is
+   * updated atomically, but there is no lock on the iterate as a whole.
+   */
+  static void Merge(arma::mat& iterate,
+                    const arma::mat& update,
+                    const double stepSize)
+  {
+    double* iterateMem = iterate.memptr();
+    const double* updateMem = update.memptr();
+    for (size_t i = 0; i < iterate.n_elem; ++i)
+    {
+      if (updateMem[i] == 0.0)
+        continue;
+
+      #pragma omp atomic
+      iterateMem[i] -= stepSize * updateMem[i];
+    }
+  }
+
+  //! Number of gradients accumulated before each merge.
+  size_t mergeInterval;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,86 @@
+/**
+ * @file sparse_update.hpp
+ *
+ * Update policy for parallel SGD which applies each sparse gradient to the
+ * shared iterate with one atomic operation per non-zero element.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_SPARSE_UPDATE_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_SPARSE_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/function.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * The SparseUpdate policy is the original HOGWILD! update: the sparse gradient
+ * of every function is computed and its non-zero elements are subtracted from
+ * the shared iterate atomically.  This is the best choice when each gradient
+ * touches only a few elements of the decision variable.
+ *
+ * The function to be optimized must satisfy the SparseFunctionType API; that
+ * is, it must provide
+ *
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::sp_mat& gradient,
+ *                 const size_t batchSize);
+ */
+class SparseUpdate
+{
+ public:
+  /**
+   * Process the functions visitationOrder[begin] through
+   * visitationOrder[end - 1].  This is called by every thread simultaneously.
+   *
+   * @param function Function being optimized.
+   * @param iterate Shared decision variable.
+   * @param visitationOrder Order in which to visit the functions.
+   * @param begin First position in visitationOrder to process.
+   * @param end One past the last position in visitationOrder to process.
+   * @param stepSize Step size for this iteration.
+   */
+  template<typename SparseFunctionType>
+  void Update(SparseFunctionType& function,
+              arma::mat& iterate,
+              const arma::Col<size_t>& visitationOrder,
+              const size_t begin,
+              const size_t end,
+              const double stepSize)
+  {
+    traits::CheckSparseFunctionTypeAPI<SparseFunctionType>();
+
+    // Each instance affects only some components of the decision variable, so
+    // the gradient is sparse.
+    arma::sp_mat gradient;
+    for (size_t j = begin; j < end; ++j)
+    {
+      // Evaluate the sparse gradient.
+      function.Gradient(iterate, visitationOrder[j], gradient, 1);
+
+      // Update the decision variable with non-zero components of the
+      // gradient.
+      for (size_t i = 0; i < gradient.n_cols; ++i)
+      {
+        // Iterate over the non-zero elements.
+        for (arma::sp_mat::iterator cur = gradient.begin_col(i);
+            cur != gradient.end_col(i); ++cur)
+        {
+          #pragma omp atomic
+          iterate(cur.row(), i) -= stepSize * (*cur);
+        }
+      }
+    }
+  }
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * @file population_evaluation.hpp
+ *
+ * Serial and parallel evaluation of the candidates of a population, used by
+ * the population-based optimizers (CMAES and CNE).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_POPULATION_EVALUATION_HPP
+#define MLPACK_CORE_OPTIMIZERS_POPULATION_EVALUATION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * How the candidates of a population are evaluated.  The parallel modes pass
+ * each candidate to the function as the parameters to evaluate, so they can
+ * only be used with functions whose Evaluate() uses the parameters it is given
+ * (the FFN and RNN classes evaluate their own parameters instead, and have to
+ * be optimized with SERIAL_EVALUATION).
+ */
+enum PopulationEvaluation
+{
+  //! Evaluate one candidate at a time with the given function.
+  SERIAL_EVALUATION,
+  //! Evaluate the candidates in parallel with the given function, whose
+  //! Evaluate() must be safe to call from several threads at once.
+  PARALLEL_EVALUATION,
+  //! Evaluate the candidates in parallel, each thread with its own copy of
+  //! the given function.
+  PARALLEL_COPY_EVALUATION
+};
+
+//! Get the number of threads the parallel evaluation uses.
+inline size_t PopulationEvaluationThreads(
+    const PopulationEvaluation evaluation)
+{
+  #ifdef HAS_OPENMP
+    if (evaluation != SERIAL_EVALUATION)
+      return omp_get_max_threads();
+  #else
+    (void) evaluation;
+  #endif
+
+  return 1;
+}
+
+//! Get the index of the calling thread in a parallel evaluation.
+inline size_t PopulationEvaluationThread()
+{
+  #ifdef HAS_OPENMP
+    return omp_get_thread_num();
+  #else
+    return 0;
+  #endif
+}
+
+/**
+ * Evaluate every candidate of the given population.
+ *
+ * @tparam FunctionType Type of the function to evaluate.
+ * @tparam EvaluateType Type of the callable that evaluates one candidate.
+ * @param function The function to evaluate.
+ * @param population The candidates, one per slice.
+ * @param objectives The objective of each candidate.
+ * @param evaluation How the candidates are evaluated.
+ * @param evaluate Callable taking a function and a candidate and returning
+ *     the objective of the candidate.
+ */
+template<typename FunctionType, typename EvaluateType>
+void EvaluatePopulation(FunctionType& function,
+                        const arma::cube& population,
+                        arma::vec& objectives,
+                        const PopulationEvaluation evaluation,
+                        EvaluateType evaluate)
+{
+  objectives.set_size(population.n_slices);
+
+  if (evaluation == SERIAL_EVALUATION)
+  {
+    for (size_t i = 0; i < population.n_slices; ++i)
+      objectives[i] = evaluate(function, population.slice(i));
+
+    return;
+  }
+
+  std::vector<FunctionType> functions;
+  if (evaluation == PARALLEL_COPY_EVALUATION)
+    functions.assign(PopulationEvaluationThreads(evaluation), function);
+
+  #pragma omp parallel for shared(functions, objectives)
+  for (omp_size_t i = 0; i < (omp_size_t) population.n_slices; ++i)
+  {
+    FunctionType& threadFunction = functions.empty() ? function :
+        functions[PopulationEvaluationThread()];
+    objectives[i] = evaluate(threadFunction, population.slice(i));
+  }
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -99,6 +99,15 @@ class RMSPropUpdate
   //! Modify the smoothing parameter.
   double& Alpha() { return alpha; }
 
+  //! Serialize the update policy, including its state.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(alpha);
+    ar & BOOST_SERIALIZATION_NVP(meanSquaredGradient);
+  }
+
  private:
   // The epsilon value used to initialise the squared gradient parameter.
   double epsilon;
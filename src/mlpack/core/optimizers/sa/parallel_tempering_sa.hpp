@@ -0,0 +1,255 @@
+/**
+ * @file parallel_tempering_sa.hpp
+ *
+ * Parallel tempering: simulated annealing with several chains at a ladder of
+ * temperatures that exchange their states.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SA_PARALLEL_TEMPERING_SA_HPP
+#define MLPACK_CORE_OPTIMIZERS_SA_PARALLEL_TEMPERING_SA_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/population_evaluation.hpp>
+
+#include "exponential_schedule.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * ParallelTemperingSA runs several simulated annealing chains at once, each at
+ * its own temperature.  The temperatures form a geometric ladder: the first
+ * (hottest) chain starts at initT, and every following chain is colder by a
+ * factor of ladderRatio.  Each chain makes the same moves as SA (one Laplace
+ * move per parameter with feedback move control).  After initMoves moves at
+ * the initial temperatures, the chains run in rounds of swapInterval moves.
+ *
+ * After every round, each temperature is cooled by as many steps of the
+ * cooling schedule as moves were made (the schedule is only called from the
+ * calling thread, so it needs no locking), and neighboring chains on the
+ * ladder propose to exchange their states, which is accepted with probability
+ *
+ * \f[
+ * \min\{1, \exp((1/T_i - 1/T_j)(E_i - E_j))\}.
+ * \f]
+ *
+ * The even and the odd pairs of neighbors alternate.  Good states found by the
+ * hot chains, which cross barriers easily, thus move down to the cold chains,
+ * which refine them.  The best point found by any chain is kept, and it is
+ * returned at the end.
+ *
+ * Between the exchanges the chains are independent, so they run in parallel
+ * when the evaluation mode allows it.  The parallel modes are the ones of the
+ * population-based optimizers (see PopulationEvaluation): PARALLEL_EVALUATION
+ * needs a function whose Evaluate() is safe to call from several threads at
+ * once, and PARALLEL_COPY_EVALUATION gives every thread its own copy of the
+ * function.  The chains draw their moves from the random stream of their
+ * thread, so a run is reproducible for a given seed and number of threads.
+ *
+ * The optimization terminates when the coldest chain is frozen (its energy has
+ * not changed by more than tolerance for maxToleranceSweep sweeps), or when
+ * every chain has made maxIterations moves.
+ *
+ * For ParallelTemperingSA to work, the FunctionType and CoolingScheduleType
+ * classes must implement the same methods as for SA.
+ *
+ * @tparam CoolingScheduleType Type of the cooling schedule.
+ */
+template<typename CoolingScheduleType = ExponentialSchedule>
+class ParallelTemperingSA
+{
+ public:
+  /**
+   * Construct the optimizer with the given parameters.
+   *
+   * @param coolingSchedule Instantiated cooling schedule.
+   * @param numChains Number of chains.
+   * @param ladderRatio Ratio between the temperatures of neighboring chains
+   *    (in (0, 1]).
+   * @param swapInterval Number of moves of every chain between exchanges.
+   * @param maxIterations Maximum number of moves of every chain
+   *    (0 indicates no limit).
+   * @param initT Initial temperature of the hottest chain.
+   * @param initMoves Number of initial moves without changing temperature.
+   * @param moveCtrlSweep Sweeps per feedback move control.
+   * @param tolerance Tolerance to consider the coldest chain frozen.
+   * @param maxToleranceSweep Maximum sweeps below tolerance to consider the
+   *    coldest chain frozen.
+   * @param maxMoveCoef Maximum move size.
+   * @param initMoveCoef Initial move size.
+   * @param gain Proportional control in feedback move control.
+   * @param evaluation How the chains are run; the parallel modes run them in
+   *    parallel.
+   */
+  ParallelTemperingSA(CoolingScheduleType& coolingSchedule,
+                      const size_t numChains = 4,
+                      const double ladderRatio = 0.5,
+                      const size_t swapInterval = 100,
+                      const size_t maxIterations = 1000000,
+                      const double initT = 10000.,
+                      const size_t initMoves = 1000,
+                      const size_t moveCtrlSweep = 100,
+                      const double tolerance = 1e-5,
+                      const size_t maxToleranceSweep = 3,
+                      const double maxMoveCoef = 20,
+                      const double initMoveCoef = 0.3,
+                      const double gain = 0.3,
+                      const PopulationEvaluation evaluation =
+                          SERIAL_EVALUATION);
+
+  /**
+   * Optimize the given function using parallel tempering.  The given starting
+   * point is the starting point of every chain; it will be modified to store
+   * the best point found, and the objective value of that point is returned.
+   *
+   * @tparam FunctionType Type of function to optimize.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the best point.
+   */
+  template<typename FunctionType>
+  double Optimize(FunctionType& function, arma::mat& iterate);
+
+  //! Get the number of chains.
+  size_t NumChains() const { return numChains; }
+  //! Modify the number of chains.
+  size_t& NumChains() { return numChains; }
+
+  //! Get the ratio between the temperatures of neighboring chains.
+  double LadderRatio() const { return ladderRatio; }
+  //! Modify the ratio between the temperatures of neighboring chains.
+  double& LadderRatio() { return ladderRatio; }
+
+  //! Get the number of moves between exchanges.
+  size_t SwapInterval() const { return swapInterval; }
+  //! Modify the number of moves between exchanges.
+  size_t& SwapInterval() { return swapInterval; }
+
+  //! Get the initial temperature of the hottest chain.
+  double Temperature() const { return temperature; }
+  //! Modify the initial temperature of the hottest chain.
+  double& Temperature() { return temperature; }
+
+  //! Get the initial moves.
+  size_t InitMoves() const { return initMoves; }
+  //! Modify the initial moves.
+  size_t& InitMoves() { return initMoves; }
+
+  //! Get sweeps per move control.
+  size_t MoveCtrlSweep() const { return moveCtrlSweep; }
+  //! Modify sweeps per move control.
+  size_t& MoveCtrlSweep() { return moveCtrlSweep; }
+
+  //! Get the tolerance.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the maxToleranceSweep.
+  size_t MaxToleranceSweep() const { return maxToleranceSweep; }
+  //! Modify the maxToleranceSweep.
+  size_t& MaxToleranceSweep() { return maxToleranceSweep; }
+
+  //! Get the gain.
+  double Gain() const { return gain; }
+  //! Modify the gain.
+  double& Gain() { return gain; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get how the chains are run.
+  PopulationEvaluation Evaluation() const { return evaluation; }
+  //! Modify how the chains are run.
+  PopulationEvaluation& Evaluation() { return evaluation; }
+
+  //! Get the number of exchanges accepted in the last optimization.
+  size_t AcceptedSwaps() const { return acceptedSwaps; }
+  //! Get the number of exchanges proposed in the last optimization.
+  size_t ProposedSwaps() const { return proposedSwaps; }
+
+ private:
+  //! The state of one chain.
+  struct Chain
+  {
+    //! The current point.
+    arma::mat iterate;
+    //! The energy of the current point.
+    double energy;
+    //! The current temperature.
+    double temperature;
+    //! The accepted moves of every parameter since the last move control.
+    arma::mat accept;
+    //! The move size of every parameter.
+    arma::mat moveSize;
+    //! The parameter to move next.
+    size_t idx;
+    //! The sweeps since the last move control.
+    size_t sweepCounter;
+    //! The number of consecutive moves within tolerance.
+    size_t frozenCount;
+    //! The best point of the chain since the last exchange.
+    arma::mat best;
+    //! The energy of the best point (DBL_MAX if none).
+    double bestEnergy;
+  };
+
+  /**
+   * Propose a move on the next parameter of the given chain, and accept it
+   * according to the Metropolis criterion at the temperature of the chain;
+   * this is the move of SA::GenerateMove().
+   */
+  template<typename FunctionType>
+  void GenerateMove(FunctionType& function, Chain& chain) const;
+
+  //! Adapt the move sizes of the given chain; see SA::MoveControl().
+  void MoveControl(const size_t nMoves, Chain& chain) const;
+
+  //! The cooling schedule being used.
+  CoolingScheduleType& coolingSchedule;
+  //! The number of chains.
+  size_t numChains;
+  //! The ratio between the temperatures of neighboring chains.
+  double ladderRatio;
+  //! The number of moves between exchanges.
+  size_t swapInterval;
+  //! The maximum number of iterations.
+  size_t maxIterations;
+  //! The initial temperature of the hottest chain.
+  double temperature;
+  //! The number of initial moves before reducing the temperature.
+  size_t initMoves;
+  //! The number of sweeps before a MoveControl() call.
+  size_t moveCtrlSweep;
+  //! Tolerance for convergence.
+  double tolerance;
+  //! Number of sweeps in tolerance before system is considered frozen.
+  size_t maxToleranceSweep;
+  //! Maximum move.
+  double maxMoveCoef;
+  //! Initial move size.
+  double initMoveCoef;
+  //! Proportional control in feedback move control.
+  double gain;
+  //! How the chains are run.
+  PopulationEvaluation evaluation;
+
+  //! The number of exchanges accepted in the last optimization.
+  size_t acceptedSwaps;
+  //! The number of exchanges proposed in the last optimization.
+  size_t proposedSwaps;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_tempering_sa_impl.hpp"
+
+#endif
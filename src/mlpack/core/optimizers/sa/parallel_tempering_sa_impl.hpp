@@ -0,0 +1,288 @@
+/**
+ * @file parallel_tempering_sa_impl.hpp
+ *
+ * Implementation of the ParallelTemperingSA optimizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SA_PARALLEL_TEMPERING_SA_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_SA_PARALLEL_TEMPERING_SA_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_tempering_sa.hpp"
+
+#include <mlpack/core/optimizers/function.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+template<typename CoolingScheduleType>
+ParallelTemperingSA<CoolingScheduleType>::ParallelTemperingSA(
+    CoolingScheduleType& coolingSchedule,
+    const size_t numChains,
+    const double ladderRatio,
+    const size_t swapInterval,
+    const size_t maxIterations,
+    const double initT,
+    const size_t initMoves,
+    const size_t moveCtrlSweep,
+    const double tolerance,
+    const size_t maxToleranceSweep,
+    const double maxMoveCoef,
+    const double initMoveCoef,
+    const double gain,
+    const PopulationEvaluation evaluation) :
+    coolingSchedule(coolingSchedule),
+    numChains(numChains),
+    ladderRatio(ladderRatio),
+    swapInterval(swapInterval),
+    maxIterations(maxIterations),
+    temperature(initT),
+    initMoves(initMoves),
+    moveCtrlSweep(moveCtrlSweep),
+    tolerance(tolerance),
+    maxToleranceSweep(maxToleranceSweep),
+    maxMoveCoef(maxMoveCoef),
+    initMoveCoef(initMoveCoef),
+    gain(gain),
+    evaluation(evaluation),
+    acceptedSwaps(0),
+    proposedSwaps(0)
+{
+  // Nothing to do.
+}
+
+//! Optimize the function (minimize).
+template<typename CoolingScheduleType>
+template<typename FunctionType>
+double ParallelTemperingSA<CoolingScheduleType>::Optimize(
+    FunctionType& function,
+    arma::mat& iterate)
+{
+  // Make sure we have the methods that we need.
+  traits::CheckNonDifferentiableFunctionTypeAPI<FunctionType>();
+
+  if (numChains == 0)
+  {
+    throw std::invalid_argument("ParallelTemperingSA::Optimize(): the number "
+        "of chains must be positive");
+  }
+
+  if (ladderRatio <= 0.0 || ladderRatio > 1.0)
+  {
+    throw std::invalid_argument("ParallelTemperingSA::Optimize(): the ladder "
+        "ratio must be in (0, 1]");
+  }
+
+  if (swapInterval == 0)
+  {
+    throw std::invalid_argument("ParallelTemperingSA::Optimize(): the swap "
+        "interval must be positive");
+  }
+
+  // All chains start from the given point.
+  const double initialEnergy = function.Evaluate(iterate);
+  std::vector<Chain> chains(numChains);
+  for (size_t c = 0; c < numChains; ++c)
+  {
+    chains[c].iterate = iterate;
+    chains[c].energy = initialEnergy;
+    chains[c].temperature = temperature * std::pow(ladderRatio, (double) c);
+    chains[c].accept.zeros(iterate.n_rows, iterate.n_cols);
+    chains[c].moveSize.set_size(iterate.n_rows, iterate.n_cols);
+    chains[c].moveSize.fill(initMoveCoef);
+    chains[c].idx = 0;
+    chains[c].sweepCounter = 0;
+    chains[c].frozenCount = 0;
+    chains[c].bestEnergy = DBL_MAX;
+  }
+
+  arma::mat bestIterate = iterate;
+  double bestEnergy = initialEnergy;
+  acceptedSwaps = 0;
+  proposedSwaps = 0;
+
+  std::vector<FunctionType> functions;
+  if (evaluation == PARALLEL_COPY_EVALUATION)
+    functions.assign(PopulationEvaluationThreads(evaluation), function);
+
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  const size_t frozenMoves = maxToleranceSweep * moveCtrlSweep *
+      iterate.n_elem;
+
+  // The initial moves are made at the initial temperatures, and then every
+  // round is followed by the exchanges.
+  size_t moves = 0;
+  bool initial = (initMoves > 0);
+  for (size_t round = 0; moves < actualMaxIterations; ++round)
+  {
+    const size_t roundMoves = initial ? initMoves :
+        std::min(swapInterval, actualMaxIterations - moves);
+
+    // The chains are independent during a round.
+    #pragma omp parallel for schedule(static) shared(functions, chains) \
+        if (evaluation != SERIAL_EVALUATION)
+    for (omp_size_t c = 0; c < (omp_size_t) numChains; ++c)
+    {
+      FunctionType& threadFunction = functions.empty() ? function :
+          functions[PopulationEvaluationThread()];
+      Chain& chain = chains[c];
+      for (size_t i = 0; i < roundMoves; ++i)
+      {
+        const double oldEnergy = chain.energy;
+        GenerateMove(threadFunction, chain);
+
+        if (std::abs(chain.energy - oldEnergy) < tolerance)
+          ++chain.frozenCount;
+        else
+          chain.frozenCount = 0;
+
+        if (chain.energy < chain.bestEnergy)
+        {
+          chain.bestEnergy = chain.energy;
+          chain.best = chain.iterate;
+        }
+      }
+    }
+
+    // Collect the best point in the order of the chains, so that ties are
+    // broken the same way in every run.
+    for (size_t c = 0; c < numChains; ++c)
+    {
+      if (chains[c].bestEnergy < bestEnergy)
+      {
+        bestEnergy = chains[c].bestEnergy;
+        bestIterate.swap(chains[c].best);
+      }
+      chains[c].bestEnergy = DBL_MAX;
+    }
+
+    if (initial)
+    {
+      initial = false;
+      for (size_t c = 0; c < numChains; ++c)
+        chains[c].frozenCount = 0;
+      continue;
+    }
+    moves += roundMoves;
+
+    // Cool every chain by as many steps as moves were made; the schedule is
+    // only called from this thread.
+    for (size_t c = 0; c < numChains; ++c)
+    {
+      for (size_t i = 0; i < roundMoves; ++i)
+      {
+        chains[c].temperature = coolingSchedule.NextTemperature(
+            chains[c].temperature, chains[c].energy);
+      }
+    }
+
+    // Terminate if the coldest chain is frozen.
+    if (chains.back().frozenCount >= frozenMoves)
+    {
+      Log::Debug << "ParallelTemperingSA: minimized within tolerance "
+          << tolerance << " for " << maxToleranceSweep << " sweeps after "
+          << moves << " iterations; terminating optimization." << std::endl;
+      break;
+    }
+
+    // Propose exchanges between the even or the odd neighbors.
+    for (size_t c = (round % 2); c + 1 < numChains; c += 2)
+    {
+      Chain& hot = chains[c];
+      Chain& cold = chains[c + 1];
+      const double exponent = (1.0 / hot.temperature - 1.0 / cold.temperature)
+          * (hot.energy - cold.energy);
+
+      ++proposedSwaps;
+      if (exponent >= 0.0 || math::Random() < std::exp(exponent))
+      {
+        hot.iterate.swap(cold.iterate);
+        std::swap(hot.energy, cold.energy);
+        hot.frozenCount = 0;
+        cold.frozenCount = 0;
+        ++acceptedSwaps;
+      }
+    }
+  }
+
+  if (moves >= actualMaxIterations)
+  {
+    Log::Debug << "ParallelTemperingSA: maximum iterations (" << maxIterations
+        << ") reached; terminating optimization." << std::endl;
+  }
+
+  Log::Debug << "ParallelTemperingSA: " << acceptedSwaps << " of "
+      << proposedSwaps << " exchanges accepted." << std::endl;
+
+  iterate = std::move(bestIterate);
+  return bestEnergy;
+}
+
+template<typename CoolingScheduleType>
+template<typename FunctionType>
+void ParallelTemperingSA<CoolingScheduleType>::GenerateMove(
+    FunctionType& function,
+    Chain& chain) const
+{
+  const size_t idx = chain.idx;
+  const double prevEnergy = chain.energy;
+  const double prevValue = chain.iterate(idx);
+
+  // Sample from a Laplace distribution with scale parameter moveSize(idx).
+  const double unif = 2.0 * math::Random() - 1.0;
+  const double move = (unif < 0) ? (chain.moveSize(idx) * std::log(1 + unif)) :
+      (-chain.moveSize(idx) * std::log(1 - unif));
+
+  chain.iterate(idx) += move;
+  chain.energy = function.Evaluate(chain.iterate);
+
+  // According to the Metropolis criterion, accept the move with probability
+  // min{1, exp(-(E_new - E_old) / T)}.
+  const double xi = math::Random();
+  const double delta = chain.energy - prevEnergy;
+  const double criterion = std::exp(-delta / chain.temperature);
+  if (delta <= 0. || criterion > xi)
+  {
+    chain.accept(idx) += 1.;
+  }
+  else // Reject the move; restore previous state.
+  {
+    chain.iterate(idx) = prevValue;
+    chain.energy = prevEnergy;
+  }
+
+  if (++chain.idx == chain.iterate.n_elem) // Finished with a sweep.
+  {
+    chain.idx = 0;
+    ++chain.sweepCounter;
+  }
+
+  if (chain.sweepCounter == moveCtrlSweep) // Do MoveControl().
+  {
+    MoveControl(moveCtrlSweep, chain);
+    chain.sweepCounter = 0;
+  }
+}
+
+template<typename CoolingScheduleType>
+inline void ParallelTemperingSA<CoolingScheduleType>::MoveControl(
+    const size_t nMoves,
+    Chain& chain) const
+{
+  chain.moveSize = arma::exp(arma::log(chain.moveSize) +
+      gain * (chain.accept / (double) nMoves - 0.44));
+  chain.moveSize.transform([this](const double m)
+      { return std::min(m, maxMoveCoef); });
+
+  chain.accept.zeros();
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_OPTIMIZERS_SARAH_SARAH_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/full_gradient.hpp>
 
 #include "sarah_update.hpp"
 #include "sarah_plus_update.hpp"
@@ -86,6 +87,9 @@ class SARAHType
    *     function is visited in linear order.
    * @param updatePolicy Instantiated update policy used to adjust the given
    *     parameters.
+   * @param parallelSnapshot Whether the objective and the full gradient of each
+   *     outer iteration are computed in parallel (then the function has to be
+   *     safe to evaluate from several threads at once).
    */
   SARAHType(const double stepSize = 0.01,
             const size_t batchSize = 32,
@@ -93,7 +97,8 @@ class SARAHType
             const size_t innerIterations = 0,
             const double tolerance = 1e-5,
             const bool shuffle = true,
-            const UpdatePolicyType& updatePolicy = UpdatePolicyType());
+            const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
+            const bool parallelSnapshot = false);
 
   /**
    * Optimize the given function using SARAH. The given starting point will be
@@ -143,6 +148,13 @@ class SARAHType
   //! Modify the update policy.
   UpdatePolicyType& UpdatePolicy() { return updatePolicy; }
 
+  //! Get whether the objective and the full gradient are computed in
+  //! parallel.
+  bool ParallelSnapshot() const { return parallelSnapshot; }
+  //! Modify whether the objective and the full gradient are computed in
+  //! parallel.
+  bool& ParallelSnapshot() { return parallelSnapshot; }
+
  private:
   //! The step size for each example.
   double stepSize;
@@ -165,6 +177,9 @@ class SARAHType
 
   //! The update policy used to update the parameters in each iteration.
   UpdatePolicyType updatePolicy;
+
+  //! Whether the objective and the full gradient are computed in parallel.
+  bool parallelSnapshot;
 };
 
 // Convenience typedefs.
@@ -28,14 +28,16 @@ SARAHType<UpdatePolicyType>::SARAHType(
     const size_t innerIterations,
     const double tolerance,
     const bool shuffle,
-    const UpdatePolicyType& updatePolicy) :
+    const UpdatePolicyType& updatePolicy,
+    const bool parallelSnapshot) :
     stepSize(stepSize),
     batchSize(batchSize),
     maxIterations(maxIterations),
     innerIterations(innerIterations),
     tolerance(tolerance),
     shuffle(shuffle),
-    updatePolicy(updatePolicy)
+    updatePolicy(updatePolicy),
+    parallelSnapshot(parallelSnapshot)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
@@ -73,12 +75,8 @@ double SARAHType<UpdatePolicyType>::Optimize(
   for (size_t i = 0; i < actualMaxIterations; ++i)
   {
     // Calculate the objective function.
-    overallObjective = 0;
-    for (size_t f = 0; f < numFunctions; f += batchSize)
-    {
-      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
-      overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
-    }
+    overallObjective = FullObjective(function, iterate, batchSize,
+        parallelSnapshot);
 
     if (std::isnan(overallObjective) || std::isinf(overallObjective))
     {
@@ -98,20 +96,7 @@ double SARAHType<UpdatePolicyType>::Optimize(
     lastObjective = overallObjective;
 
     // Compute the full gradient.
-    size_t effectiveBatchSize = std::min(batchSize, numFunctions);
-    function.Gradient(iterate, 0, v, effectiveBatchSize);
-    for (size_t f = effectiveBatchSize; f < numFunctions;
-        /* incrementing done manually */)
-    {
-      // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - f);
-
-      function.Gradient(iterate, f, gradient, effectiveBatchSize);
-      v += gradient;
-
-      f += effectiveBatchSize;
-    }
-    v /= (double) numFunctions;
+    FullGradient(function, iterate, v, gradient, batchSize, parallelSnapshot);
 
     // Update iterate with full gradient (v).
     iterate -= stepSize * v;
@@ -132,7 +117,8 @@ double SARAHType<UpdatePolicyType>::Optimize(
       }
 
       // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - currentFunction);
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - currentFunction);
 
       // Calculate variance reduced gradient.
       function.Gradient(iterate, currentFunction, gradient,
@@ -178,12 +164,8 @@ double SARAHType<UpdatePolicyType>::Optimize(
       << "terminating optimization." << std::endl;
 
   // Calculate final objective.
-  overallObjective = 0;
-  for (size_t i = 0; i < numFunctions; i += batchSize)
-  {
-    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
-    overallObjective += function.Evaluate(iterate, i, effectiveBatchSize);
-  }
+  overallObjective = FullObjective(function, iterate, batchSize,
+      parallelSnapshot);
   return overallObjective;
 }
 
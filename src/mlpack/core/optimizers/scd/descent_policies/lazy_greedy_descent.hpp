@@ -0,0 +1,157 @@
+/**
+ * @file lazy_greedy_descent.hpp
+ *
+ * Greedy descent policy for Stochastic Coordinate Descent (SCD) that keeps the
+ * partial gradient magnitudes in a max-heap.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SCD_DESCENT_POLICIES_LAZY_GREEDY_HPP
+#define MLPACK_CORE_OPTIMIZERS_SCD_DESCENT_POLICIES_LAZY_GREEDY_HPP
+
+#include <mlpack/core.hpp>
+#include <queue>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Lazy greedy descent policy for Stochastic Co-ordinate Descent(SCD).  Like
+ * GreedyDescent, this picks the co-ordinate with the largest partial gradient
+ * (the Gauss-Southwell rule), but instead of computing every partial gradient
+ * at every iteration, it keeps the last known magnitudes in a max-heap.  The
+ * top of the heap is recomputed at the current point until a co-ordinate stays
+ * on top after being recomputed, so most iterations only need a few partial
+ * gradients.
+ *
+ * The magnitudes in the heap are only refreshed when they reach the top, so if
+ * the partial gradient of a co-ordinate can grow when other co-ordinates are
+ * updated, the choice may be slightly worse than the exact greedy one.  For
+ * this reason the whole heap is rebuilt every rebuildInterval iterations.  For
+ * functions where each co-ordinate only affects its own partial gradient, the
+ * choice is always exact.
+ *
+ * For more information, refer to the following.
+ * @code
+ * @misc{Nutini2015,
+ *   author = {Julie Nutini and Mark Schmidt and Issam H.
+ *             Laradji and Michael Friedlander and Hoyt Koepke},
+ *   title  = {Coordinate Descent Converges Faster with the Gauss-Southwell Rule
+ *             Than Random Selection},
+ *   year   = {2015},
+ *   eprint = {arXiv:1506.00552}
+ * }
+ * @endcode
+ */
+class LazyGreedyDescent
+{
+ public:
+  /**
+   * Construct the lazy greedy descent policy.
+   *
+   * @param rebuildInterval The number of iterations after which all the partial
+   *    gradients are recomputed (0 means the number of features).
+   */
+  LazyGreedyDescent(const size_t rebuildInterval = 0) :
+      rebuildInterval(rebuildInterval),
+      iterationsSinceRebuild(0),
+      calls(0)
+  { /* Nothing to do. */ }
+
+  /**
+   * The DescentFeature method is used to get the descent coordinate for the
+   * current iteration.
+   *
+   * @tparam ResolvableFunctionType The type of the function to be optimized.
+   * @param iteration The iteration number for which the feature is to be
+   *    obtained.
+   * @param iterate The current value of the decision variable.
+   * @param function The function to be optimized.
+   * @return The index of the coordinate to be descended.
+   */
+  template <typename ResolvableFunctionType>
+  size_t DescentFeature(const size_t /* iteration */,
+                        const arma::mat& iterate,
+                        const ResolvableFunctionType& function)
+  {
+    const size_t numFeatures = function.NumFeatures();
+    const size_t interval = (rebuildInterval == 0) ? numFeatures :
+        rebuildInterval;
+
+    ++calls;
+    if (heap.size() != numFeatures || iterationsSinceRebuild >= interval)
+      Rebuild(iterate, function);
+    ++iterationsSinceRebuild;
+
+    // Refresh the top of the heap until it is up to date.  Every co-ordinate is
+    // refreshed at most once, so this terminates.
+    while (lastRefresh[heap.top().second] != calls)
+    {
+      const size_t feature = heap.top().second;
+      heap.pop();
+      heap.push(std::make_pair(Magnitude(iterate, function, feature),
+          feature));
+      lastRefresh[feature] = calls;
+    }
+
+    return heap.top().second;
+  }
+
+  //! Get the rebuild interval (0 indicates the number of features).
+  size_t RebuildInterval() const { return rebuildInterval; }
+  //! Modify the rebuild interval (0 indicates the number of features).
+  size_t& RebuildInterval() { return rebuildInterval; }
+
+ private:
+  //! Compute the magnitude of the partial gradient of the given feature.
+  template <typename ResolvableFunctionType>
+  static double Magnitude(const arma::mat& iterate,
+                          const ResolvableFunctionType& function,
+                          const size_t feature)
+  {
+    arma::sp_mat fGrad;
+    function.PartialGradient(iterate, feature, fGrad);
+    return arma::norm(fGrad, "fro");
+  }
+
+  //! Recompute the partial gradients of all features.
+  template <typename ResolvableFunctionType>
+  void Rebuild(const arma::mat& iterate,
+               const ResolvableFunctionType& function)
+  {
+    const size_t numFeatures = function.NumFeatures();
+
+    std::vector<std::pair<double, size_t>> magnitudes(numFeatures);
+    for (size_t i = 0; i < numFeatures; ++i)
+      magnitudes[i] = std::make_pair(Magnitude(iterate, function, i), i);
+
+    heap = std::priority_queue<std::pair<double, size_t>>(
+        std::less<std::pair<double, size_t>>(), std::move(magnitudes));
+    lastRefresh.assign(numFeatures, calls);
+    iterationsSinceRebuild = 0;
+  }
+
+  //! The number of iterations between two rebuilds of the heap.
+  size_t rebuildInterval;
+
+  //! The number of iterations since the heap was last rebuilt.
+  size_t iterationsSinceRebuild;
+
+  //! The number of calls to DescentFeature(), used to tell which magnitudes
+  //! were computed at the current point.
+  size_t calls;
+
+  //! The partial gradient magnitudes and their features.
+  std::priority_queue<std::pair<double, size_t>> heap;
+
+  //! The call at which the magnitude of each feature was last computed.
+  std::vector<size_t> lastRefresh;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
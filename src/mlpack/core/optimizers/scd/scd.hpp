@@ -55,6 +55,30 @@ namespace optimization {
  *  variable and PartialGradient is used to evaluate the partial gradient with
  *  respect to the jth feature.
  *
+ *  PartialGradient() must be safe to call from several threads at once if more
+ *  than one parallel update is requested.
+ *
+ *  With more than one parallel update, SCD runs Shotgun: at each iteration, it
+ *  picks several coordinates with the descent policy, computes their partial
+ *  gradients at the current point in parallel, and then updates all of them.
+ *  This converges like the sequential algorithm as long as the number of
+ *  parallel updates is at most d / rho + 1, where d is the number of features
+ *  and rho is the spectral radius of the Gram matrix of the normalized features;
+ *  ShotgunParallelism() estimates that bound for a given data matrix.
+ *
+ * @code
+ * @inproceedings{Bradley2011,
+ *   author    = {Bradley, Joseph K. and Kyrola, Aapo and Bickson, Danny and
+ *                Guestrin, Carlos},
+ *   title     = {Parallel Coordinate Descent for L1-Regularized Loss
+ *                Minimization},
+ *   booktitle = {Proceedings of the 28th International Conference on Machine
+ *                Learning},
+ *   series    = {ICML '11},
+ *   year      = {2011}
+ * }
+ * @endcode
+ *
  *  @tparam DescentPolicy Descent policy to decide the order in which the
  *      coordinate for descent is selected.
  */
@@ -78,12 +102,15 @@ class SCD
    *    reported and checked for convergence.
    * @param descentPolicy The policy to use for picking up the coordinate to
    *    descend on.
+   * @param numParallelUpdates The number of coordinates updated concurrently
+   *    at each iteration (1 means the sequential algorithm).
    */
   SCD(const double stepSize = 0.01,
       const size_t maxIterations = 100000,
       const double tolerance = 1e-5,
       const size_t updateInterval = 1e3,
-      const DescentPolicyType descentPolicy = DescentPolicyType());
+      const DescentPolicyType descentPolicy = DescentPolicyType(),
+      const size_t numParallelUpdates = 1);
 
   /**
    * Optimize the given function using stochastic coordinate descent. The
@@ -98,6 +125,21 @@ class SCD
   template <typename ResolvableFunctionType>
   double Optimize(ResolvableFunctionType& function, arma::mat& iterate);
 
+  /**
+   * Estimate the largest number of parallel updates for which Shotgun is
+   * expected to converge on a linear model over the given predictors
+   * (d / rho + 1, where rho is the spectral radius of the Gram matrix of the
+   * features scaled to unit norm).  rho is found with power iteration.
+   *
+   * @tparam MatType Type of the predictors (dense or sparse).
+   * @param predictors Data with one feature per row and one point per column.
+   * @param powerIterations Number of power iterations used to estimate rho.
+   * @return The number of parallel updates to use.
+   */
+  template<typename MatType>
+  static size_t ShotgunParallelism(const MatType& predictors,
+                                   const size_t powerIterations = 50);
+
   //! Get the step size.
   double StepSize() const { return stepSize; }
   //! Modify the step size.
@@ -123,6 +165,11 @@ class SCD
   //! Modify the descent policy.
   DescentPolicyType& DescentPolicy() { return descentPolicy; }
 
+  //! Get the number of coordinates updated concurrently.
+  size_t NumParallelUpdates() const { return numParallelUpdates; }
+  //! Modify the number of coordinates updated concurrently.
+  size_t& NumParallelUpdates() { return numParallelUpdates; }
+
  private:
   //! The step size for each example.
   double stepSize;
@@ -138,6 +185,9 @@ class SCD
 
   //! The descent policy used to pick the coordinates for the update.
   DescentPolicyType descentPolicy;
+
+  //! The number of coordinates updated concurrently at each iteration.
+  size_t numParallelUpdates;
 };
 
 } // namespace optimization
@@ -26,12 +26,14 @@ SCD<DescentPolicyType>::SCD(
     const size_t maxIterations,
     const double tolerance,
     const size_t updateInterval,
-    const DescentPolicyType descentPolicy) :
+    const DescentPolicyType descentPolicy,
+    const size_t numParallelUpdates) :
     stepSize(stepSize),
     maxIterations(maxIterations),
     tolerance(tolerance),
     updateInterval(updateInterval),
-    descentPolicy(descentPolicy)
+    descentPolicy(descentPolicy),
+    numParallelUpdates(numParallelUpdates)
 { /* Nothing to do */ }
 
 //! Optimize the function (minimize).
@@ -48,17 +50,53 @@ double SCD<DescentPolicyType>::Optimize(ResolvableFunctionType& function,
 
   arma::sp_mat gradient;
 
+  // Storage for the coordinates and steps of an iteration of Shotgun.
+  std::vector<size_t> features;
+  arma::mat steps;
+
   // Start iterating.
   for (size_t i = 1; i != maxIterations; ++i)
   {
-    // Get the coordinate to descend on.
-    size_t featureIdx = descentPolicy.DescentFeature(i, iterate, function);
+    if (numParallelUpdates <= 1)
+    {
+      // Get the coordinate to descend on.
+      size_t featureIdx = descentPolicy.DescentFeature(i, iterate, function);
+
+      // Get the partial gradient with respect to this feature.
+      function.PartialGradient(iterate, featureIdx, gradient);
 
-    // Get the partial gradient with respect to this feature.
-    function.PartialGradient(iterate, featureIdx, gradient);
+      // Update the decision variable with the partial gradient.
+      iterate.col(featureIdx) -= stepSize * gradient.col(featureIdx);
+    }
+    else
+    {
+      // The descent policy may keep state or draw random numbers, so the
+      // coordinates are picked sequentially.  A coordinate picked twice is
+      // only updated once.
+      features.resize(numParallelUpdates);
+      for (size_t p = 0; p < numParallelUpdates; ++p)
+      {
+        features[p] = descentPolicy.DescentFeature(
+            (i - 1) * numParallelUpdates + p + 1, iterate, function);
+      }
+      std::sort(features.begin(), features.end());
+      features.erase(std::unique(features.begin(), features.end()),
+          features.end());
+
+      // All partial gradients are taken at the same point, and the iterate is
+      // only modified once they are all known.
+      steps.set_size(iterate.n_rows, features.size());
+      #pragma omp parallel for
+      for (omp_size_t p = 0; p < (omp_size_t) features.size(); ++p)
+      {
+        arma::sp_mat featureGradient;
+        function.PartialGradient(iterate, features[p], featureGradient);
+        steps.col(p) = arma::vec(featureGradient.col(features[p]));
+      }
 
-    // Update the decision variable with the partial gradient.
-    iterate.col(featureIdx) -= stepSize * gradient.col(featureIdx);
+      for (size_t p = 0; p < features.size(); ++p)
+        iterate.col(features[p]) -= stepSize * steps.col(p);
+    }
 
     // Check for convergence.
     if (i % updateInterval == 0)
@@ -94,6 +132,41 @@ double SCD<DescentPolicyType>::Optimize(ResolvableFunctionType& function,
   return function.Evaluate(iterate);
 }
 
+template <typename DescentPolicyType>
+template <typename MatType>
+size_t SCD<DescentPolicyType>::ShotgunParallelism(
+    const MatType& predictors,
+    const size_t powerIterations)
+{
+  const size_t numFeatures = predictors.n_rows;
+  if (numFeatures == 0)
+    return 1;
+
+  // Scale every feature to unit norm; empty features don't interact with the
+  // others and are left out.
+  arma::vec scale(arma::sum(arma::square(predictors), 1));
+  for (size_t j = 0; j < numFeatures; ++j)
+    scale[j] = (scale[j] > 0) ? 1.0 / std::sqrt(scale[j]) : 0.0;
+
+  // Power iteration on the Gram matrix S X X^T S, without forming it.
+  arma::vec v(numFeatures, arma::fill::randu);
+  v /= arma::norm(v);
+  double rho = 0.0;
+  for (size_t k = 0; k < powerIterations; ++k)
+  {
+    const arma::vec projection(predictors.t() * (scale % v));
+    const arma::vec w = scale % arma::vec(predictors * projection);
+
+    rho = arma::norm(w);
+    if (rho == 0.0)
+      return numFeatures;
+    v = w / rho;
+  }
+
+  return std::min(numFeatures,
+      (size_t) (numFeatures / std::max(rho, 1.0)) + 1);
+}
+
 } // namespace optimization
 } // namespace mlpack
 
@@ -31,6 +31,13 @@ namespace optimization {
  * R(coordinates) matrix. So, be careful while using LRSDP with some other
  * optimizer. You may need to modify caching process of R * R^T matrix.
  * See EvaluateImpl() in lrsdp_function_impl.hpp for more details.
+ *
+ * Sparse constraints whose matrix only has a nonzero at (j, k) and (k, j), or
+ * only at (j, j), are "entry-wise" constraints: Tr(A_i * (R R^T)) is then a
+ * multiple of the dot product of rows j and k of R, which is computed directly
+ * and in parallel, and so is their part of the gradient.  Constraints of this
+ * kind are found by FindEntryConstraints().  When all the constraints are
+ * entry-wise (as in matrix completion), R * R^T is never formed.
  */
 template <typename SDPType>
 class LRSDPFunction
@@ -85,6 +92,43 @@ class LRSDPFunction
                           const arma::mat& coordinates,
                           arma::mat& gradient) const;
 
+  /**
+   * Find the entry-wise sparse constraints.  This is done by LRSDP::Optimize()
+   * and, if the number of sparse constraints changed, by the evaluation of the
+   * augmented Lagrangian; call it again after modifying the sparse
+   * constraints otherwise.  If the R * R^T matrix isn't needed anymore, it is
+   * released.
+   */
+  void FindEntryConstraints();
+
+  //! Get whether the R * R^T matrix is needed by the constraints that aren't
+  //! entry-wise.
+  bool UsesRRT() const
+  {
+    return !generalConstraints.empty() || sdp.NumDenseConstraints() > 0;
+  }
+
+  //! Get whether each sparse constraint is entry-wise.
+  const std::vector<bool>& IsEntryConstraint() const
+  {
+    return isEntryConstraint;
+  }
+  //! Get the rows j and k of R whose dot product gives each entry-wise sparse
+  //! constraint.
+  const arma::umat& EntryPositions() const { return entryPositions; }
+  //! Get the coefficient a_i such that Tr(A_i * (R R^T)) = a_i R_j^T R_k, for
+  //! each entry-wise sparse constraint.
+  const arma::vec& EntryCoefficients() const { return entryCoefficients; }
+  //! Get the indices of the sparse constraints that aren't entry-wise.
+  const std::vector<size_t>& GeneralConstraints() const
+  {
+    return generalConstraints;
+  }
+
+  //! Get the buffers that each thread accumulates its part of the gradient of
+  //! the entry-wise constraints in.
+  std::vector<arma::mat>& GradientBuffers() const { return gradientBuffers; }
+
   //! Get the total number of constraints in the LRSDP.
   size_t NumConstraints() const { return sdp.NumConstraints(); }
 
@@ -112,6 +156,17 @@ class LRSDPFunction
 
   //! Cache R*R^T matrix.
   arma::mat rrt;
+
+  //! Whether each sparse constraint is entry-wise.
+  std::vector<bool> isEntryConstraint;
+  //! The rows of R used by each entry-wise sparse constraint.
+  arma::umat entryPositions;
+  //! The coefficient of each entry-wise sparse constraint.
+  arma::vec entryCoefficients;
+  //! The indices of the sparse constraints that aren't entry-wise.
+  std::vector<size_t> generalConstraints;
+  //! Per-thread gradient buffers, kept between evaluations.
+  mutable std::vector<arma::mat> gradientBuffers;
 };
 
 // Declare specializations in lrsdp_function.cpp.
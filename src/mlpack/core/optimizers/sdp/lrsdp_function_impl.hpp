@@ -16,6 +16,10 @@
 
 #include "lrsdp_function.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace optimization {
 
@@ -30,8 +34,10 @@ LRSDPFunction<SDPType>::LRSDPFunction(const SDPType& sdp,
         << "more columns than rows.  It may be more efficient to find the "
         << "transposed solution." << std::endl;
 
-  // Initialize R*R^T matrix.
-  rrt = initialPoint * trans(initialPoint);
+  // Initialize R*R^T matrix, if the constraints need it.
+  FindEntryConstraints();
+  if (UsesRRT())
+    rrt = initialPoint * trans(initialPoint);
 }
 
 template <typename SDPType>
@@ -46,18 +52,80 @@ LRSDPFunction<SDPType>::LRSDPFunction(const size_t numSparseConstraints,
         << "more columns than rows.  It may be more efficient to find the "
         << "transposed solution." << std::endl;
 
-  // Initialize R*R^T matrix.
-  rrt = initialPoint * trans(initialPoint);
+  // The constraints aren't set yet, so they are only examined (and R*R^T
+  // computed, if needed) once the LRSDP is optimized.
 }
 
 template <typename SDPType>
-double LRSDPFunction<SDPType>::Evaluate(const arma::mat& /* coordinates */)
-                                        const
+void LRSDPFunction<SDPType>::FindEntryConstraints()
+{
+  const size_t numSparse = sdp.NumSparseConstraints();
+  isEntryConstraint.assign(numSparse, false);
+  entryPositions.zeros(2, numSparse);
+  entryCoefficients.zeros(numSparse);
+  generalConstraints.clear();
+
+  for (size_t i = 0; i < numSparse; ++i)
+  {
+    // Look at no more than the first three nonzero elements.
+    const arma::sp_mat& a = sdp.SparseA()[i];
+    size_t rows[2], cols[2];
+    double values[2];
+    size_t nonzeros = 0;
+    for (arma::sp_mat::const_iterator it = a.begin(); it != a.end() &&
+        nonzeros < 3; ++it, ++nonzeros)
+    {
+      if (nonzeros < 2)
+      {
+        rows[nonzeros] = it.row();
+        cols[nonzeros] = it.col();
+        values[nonzeros] = (*it);
+      }
+    }
+
+    if (nonzeros == 0)
+    {
+      // The constraint doesn't depend on R at all.
+      isEntryConstraint[i] = true;
+    }
+    else if (nonzeros == 1 && rows[0] == cols[0])
+    {
+      // Tr(A_i * (R R^T)) = a (R R^T)_jj.
+      isEntryConstraint[i] = true;
+      entryPositions(0, i) = rows[0];
+      entryPositions(1, i) = rows[0];
+      entryCoefficients[i] = values[0];
+    }
+    else if (nonzeros == 2 && rows[0] != cols[0] && rows[0] == cols[1] &&
+        cols[0] == rows[1] && values[0] == values[1])
+    {
+      // Tr(A_i * (R R^T)) = a (R R^T)_jk + a (R R^T)_kj.
+      isEntryConstraint[i] = true;
+      entryPositions(0, i) = rows[0];
+      entryPositions(1, i) = cols[0];
+      entryCoefficients[i] = 2.0 * values[0];
+    }
+    else
+    {
+      generalConstraints.push_back(i);
+    }
+  }
+
+  if (!UsesRRT())
+    rrt.reset();
+}
+
+template <typename SDPType>
+double LRSDPFunction<SDPType>::Evaluate(const arma::mat& coordinates) const
 {
   // Note: We don't require to update the R*R^T matrix here as the current
   // function is only used by AugLagrangian, which do not update the coordinates
   // matrix.
-  return accu(SDP().C() % rrt);
+  if (!rrt.is_empty())
+    return accu(SDP().C() % rrt);
+
+  // R*R^T isn't cached when the constraints don't need it.
+  return trace((trans(coordinates) * SDP().C()) * coordinates);
 }
 
 template <typename SDPType>
@@ -77,9 +145,24 @@ double LRSDPFunction<SDPType>::EvaluateConstraint(
   // function is only used by AugLagrangian, which do not update the coordinates
   // matrix.
 
-  // Using cached R*R^T gives better optimization for sparse matrices.
   if (index < SDP().NumSparseConstraints())
-    return accu(SDP().SparseA()[index] % rrt) - SDP().SparseB()[index];
+  {
+    // Entry-wise constraints only need one dot product of two rows of R.
+    if (entryPositions.n_cols == SDP().NumSparseConstraints() &&
+        isEntryConstraint[index])
+    {
+      return entryCoefficients[index] * arma::dot(
+          coordinates.row(entryPositions(0, index)),
+          coordinates.row(entryPositions(1, index))) - SDP().SparseB()[index];
+    }
+
+    // Using cached R*R^T gives better optimization for sparse matrices.
+    if (!rrt.is_empty())
+      return accu(SDP().SparseA()[index] % rrt) - SDP().SparseB()[index];
+
+    return trace(trans(coordinates) * (SDP().SparseA()[index] * coordinates))
+        - SDP().SparseB()[index];
+  }
   const size_t index1 = index - SDP().NumSparseConstraints();
 
   // For computation optimization we will be taking R^T * A first.
@@ -155,6 +238,74 @@ UpdateGradient(arma::mat& s,
   }
 }
 
+//! Utility function for calculating the values Tr(A_i * (R R^T)) - b_i of the
+//! entry-wise sparse constraints, in parallel; the values of the other sparse
+//! constraints are set to 0.  rt holds R^T, so that each row of R is
+//! contiguous.
+template <typename SDPType>
+static inline void
+EntryConstraintValues(const LRSDPFunction<SDPType>& function,
+                      const arma::mat& rt,
+                      arma::vec& values)
+{
+  const std::vector<bool>& isEntry = function.IsEntryConstraint();
+  const arma::umat& positions = function.EntryPositions();
+  const arma::vec& coefficients = function.EntryCoefficients();
+  const arma::vec& bis = function.SDP().SparseB();
+
+  values.zeros(positions.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) positions.n_cols; ++i)
+  {
+    if (!isEntry[i])
+      continue;
+
+    values[i] = coefficients[i] * arma::dot(rt.col(positions(0, i)),
+        rt.col(positions(1, i))) - bis[i];
+  }
+}
+
+//! Utility function for calculating the part of the objective of the sparse
+//! constraints that aren't entry-wise.
+static inline void
+UpdateGeneralObjective(double& objective,
+                       const arma::mat& rrt,
+                       const std::vector<arma::sp_mat>& ais,
+                       const std::vector<size_t>& generalConstraints,
+                       const arma::vec& bis,
+                       const arma::vec& lambda,
+                       const double sigma)
+{
+  for (size_t j = 0; j < generalConstraints.size(); ++j)
+  {
+    const size_t i = generalConstraints[j];
+    const double constraint = accu(ais[i] % rrt) - bis[i];
+    objective -= (lambda[i] * constraint);
+    objective += (sigma / 2.) * constraint * constraint;
+  }
+}
+
+//! Utility function for calculating the part of the gradient of the sparse
+//! constraints that aren't entry-wise.
+static inline void
+UpdateGeneralGradient(arma::mat& s,
+                      const arma::mat& rrt,
+                      const std::vector<arma::sp_mat>& ais,
+                      const std::vector<size_t>& generalConstraints,
+                      const arma::vec& bis,
+                      const arma::vec& lambda,
+                      const double sigma)
+{
+  for (size_t j = 0; j < generalConstraints.size(); ++j)
+  {
+    const size_t i = generalConstraints[j];
+    const double constraint = accu(ais[i] % rrt) - bis[i];
+    const double y = lambda[i] - sigma * constraint;
+    s -= y * ais[i];
+  }
+}
+
 template <typename SDPType>
 static inline double
 EvaluateImpl(LRSDPFunction<SDPType>& function,
@@ -180,27 +331,49 @@ EvaluateImpl(LRSDPFunction<SDPType>& function,
   // For computation optimization we will be taking R^T * C first.
   // Objective function = Tr((R^T * C) * R)
 
-  // Calculate R*R^T for updating cache.
-  const arma::mat rrt = coordinates * trans(coordinates);
+  // The sparse constraints may have been set since they were last examined.
+  if (function.EntryPositions().n_cols !=
+      function.SDP().NumSparseConstraints())
+    function.FindEntryConstraints();
 
-  // Update R*R^T matrix.
-  // Note that we can only use this optimization in case of L-BFGS optimizer
-  // or any other similar optimizer which calls Evaluate() before Gradient()
-  // with same coordinates matrix and uses only Evaluate() to update
-  // coordinates matrix.
-
-  // Note: In case optimizer also uses Gradient() for updating coordinates
-  // matrix than the same line of code can be used to update R*R^T through
-  // Gradient().
-  UpdateRRT(function, rrt);
+  // Calculate R*R^T for updating cache, if any constraint needs it.
+  arma::mat rrt;
+  if (function.UsesRRT())
+  {
+    rrt = coordinates * trans(coordinates);
+
+    // Update R*R^T matrix.
+    // Note that we can only use this optimization in case of L-BFGS optimizer
+    // or any other similar optimizer which calls Evaluate() before Gradient()
+    // with same coordinates matrix and uses only Evaluate() to update
+    // coordinates matrix.
+
+    // Note: In case optimizer also uses Gradient() for updating coordinates
+    // matrix than the same line of code can be used to update R*R^T through
+    // Gradient().
+    UpdateRRT(function, rrt);
+  }
 
   // Optimized objective function.
   double objective = trace((trans(coordinates) * function.SDP().C())
                          * coordinates);
 
-  // Now each constraint.
-  UpdateObjective(objective, rrt, function.SDP().SparseA(),
-      function.SDP().SparseB(), lambda, 0, sigma);
+  // Now each constraint.  The values of the entry-wise constraints are
+  // computed in parallel and summed in order.
+  arma::vec entryValues;
+  EntryConstraintValues(function, arma::mat(trans(coordinates)), entryValues);
+  const std::vector<bool>& isEntry = function.IsEntryConstraint();
+  for (size_t i = 0; i < entryValues.n_elem; ++i)
+  {
+    if (!isEntry[i])
+      continue;
+
+    objective -= (lambda[i] * entryValues[i]);
+    objective += (sigma / 2.) * entryValues[i] * entryValues[i];
+  }
+
+  UpdateGeneralObjective(objective, rrt, function.SDP().SparseA(),
+      function.GeneralConstraints(), function.SDP().SparseB(), lambda, sigma);
   UpdateObjective(objective, rrt, function.SDP().DenseA(),
       function.SDP().DenseB(), lambda, function.SDP().NumSparseConstraints(),
       sigma);
@@ -222,18 +395,76 @@ GradientImpl(const LRSDPFunction<SDPType>& function,
   // S' = C - sum_{i = 1}^{m} y'_i A_i
   // y'_i = y_i - sigma * (Trace(A_i * (R R^T)) - b_i)
 
-  // Directly reterive R*R^T from cache.
-  const arma::mat rrt = function.RRT();
-  arma::mat s(function.SDP().C());
+  // The part of S' that isn't entry-wise is only formed if some constraint
+  // needs it; otherwise 2 * C * R is computed directly.
+  if (function.UsesRRT())
+  {
+    // Directly reterive R*R^T from cache.
+    const arma::mat& rrt = function.RRT();
+    arma::mat s(function.SDP().C());
+
+    UpdateGeneralGradient(
+        s, rrt, function.SDP().SparseA(), function.GeneralConstraints(),
+        function.SDP().SparseB(), lambda, sigma);
+    UpdateGradient(
+        s, rrt, function.SDP().DenseA(), function.SDP().DenseB(),
+        lambda, function.SDP().NumSparseConstraints(), sigma);
+
+    gradient = 2 * s * coordinates;
+  }
+  else
+  {
+    gradient = 2 * (function.SDP().C() * coordinates);
+  }
 
-  UpdateGradient(
-      s, rrt, function.SDP().SparseA(), function.SDP().SparseB(),
-      lambda, 0, sigma);
-  UpdateGradient(
-      s, rrt, function.SDP().DenseA(), function.SDP().DenseB(),
-      lambda, function.SDP().NumSparseConstraints(), sigma);
+  // For an entry-wise constraint with coefficient a_i on rows j and k,
+  // 2 * A_i * R only has a_i * R_k in row j and a_i * R_j in row k.  Each
+  // thread accumulates its constraints in its own buffer (holding the
+  // transposed gradient, so that each row is contiguous), and the buffers are
+  // added in order.
+  const arma::umat& positions = function.EntryPositions();
+  if (positions.n_cols == 0)
+    return;
+
+  const arma::mat rt = trans(coordinates);
+  arma::vec entryValues;
+  EntryConstraintValues(function, rt, entryValues);
+
+  #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+  #else
+    const size_t numThreads = 1;
+  #endif
+
+  std::vector<arma::mat>& buffers = function.GradientBuffers();
+  buffers.resize(numThreads);
+  for (size_t t = 0; t < numThreads; ++t)
+    buffers[t].zeros(rt.n_rows, rt.n_cols);
+
+  const std::vector<bool>& isEntry = function.IsEntryConstraint();
+  const arma::vec& coefficients = function.EntryCoefficients();
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) positions.n_cols; ++i)
+  {
+    if (!isEntry[i])
+      continue;
+
+    #ifdef HAS_OPENMP
+      arma::mat& buffer = buffers[omp_get_thread_num()];
+    #else
+      arma::mat& buffer = buffers[0];
+    #endif
+
+    const double y = lambda[i] - sigma * entryValues[i];
+    const double scale = y * coefficients[i];
+    buffer.col(positions(0, i)) -= scale * rt.col(positions(1, i));
+    buffer.col(positions(1, i)) -= scale * rt.col(positions(0, i));
+  }
 
-  gradient = 2 * s * coordinates;
+  for (size_t t = 1; t < numThreads; ++t)
+    buffers[0] += buffers[t];
+  gradient += trans(buffers[0]);
 }
 
 // Template specializations for function and gradient evaluation.
@@ -30,6 +30,13 @@ LRSDP<SDPType>::LRSDP(const size_t numSparseConstraints,
 template <typename SDPType>
 double LRSDP<SDPType>::Optimize(arma::mat& coordinates)
 {
+  // Examine the constraints as they are now; R*R^T is only needed (and
+  // computed for the first evaluations of the constraints) if some of them
+  // aren't entry-wise.
+  function.FindEntryConstraints();
+  if (function.UsesRRT())
+    function.RRT() = coordinates * trans(coordinates);
+
   augLag.Sigma() = 10;
   augLag.Optimize(function, coordinates, maxIterations);
 
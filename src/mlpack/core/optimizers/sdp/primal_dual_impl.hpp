@@ -135,17 +135,78 @@ Alpha(const arma::mat& A, const arma::mat& dA, double tau, double& alpha)
  *
  *   AX + XA = H
  *
- * where A, H are symmetric matrices.
+ * where A, H are symmetric matrices, given the eigenvalue decomposition
+ * A = Q diag(lambda) Q^T.  In the basis of the eigenvectors the equation is
+ * diagonal, so (see Lemma 7.2 of [AHO98])
  *
- * TODO(stephentu): Note this method current uses arma's builtin arma::syl
- * method, which is overkill for this situation. See Lemma 7.2 of [AHO98] for
- * how to solve this Lyapunov equation using an eigenvalue decomposition of A.
+ *   X = Q ((Q^T H Q) ./ (lambda_i + lambda_j)) Q^T.
  *
+ * The decomposition is computed once per iteration and shared by all the
+ * equations of the iteration.
+ *
+ * @param X The solution.
+ * @param Q The eigenvectors of A.
+ * @param inverseSums The matrix of 1 / (lambda_i + lambda_j).
+ * @param H The right hand side, in the basis of the eigenvectors (Q^T H Q).
+ */
+static inline void
+SolveLyapunov(arma::mat& X,
+              const arma::mat& Q,
+              const arma::mat& inverseSums,
+              const arma::mat& H)
+{
+  X = Q * (H % inverseSums) * Q.t();
+}
+
+/**
+ * Compute P = W A Q for a sparse matrix A, with one rank one update for each
+ * nonzero of A, so that constraints with few nonzeros don't pay for dense
+ * matrix products.
+ */
+static inline void
+RotatedProduct(const arma::mat& W,
+               const arma::sp_mat& A,
+               const arma::mat& Q,
+               arma::mat& P)
+{
+  P.zeros(W.n_rows, Q.n_cols);
+  for (arma::sp_mat::const_iterator it = A.begin(); it != A.end(); ++it)
+    P += (*it) * W.col(it.row()) * Q.row(it.col());
+}
+
+/**
+ * Compute P = W A Q for a dense matrix A.
  */
 static inline void
-SolveLyapunov(arma::mat& X, const arma::mat& A, const arma::mat& H)
+RotatedProduct(const arma::mat& W,
+               const arma::mat& A,
+               const arma::mat& Q,
+               arma::mat& P)
 {
-  arma::syl(X, A, A, -H);
+  P = W * A * Q;
+}
+
+/**
+ * Compute E^(-1) F svec(A) for a constraint matrix A, that is, solve the
+ * following Lyapunov equation (for G)
+ *
+ *   ZG + GZ = XA + AX
+ *
+ * given W = Q^T X and the eigenvalue decomposition Z = Q diag(lambda) Q^T.
+ * Since A is symmetric, Q^T (XA + AX) Q = P + P^T with P = W A Q.
+ */
+template<typename MatType>
+static inline void
+SolveConstraintLyapunov(arma::vec& g,
+                        const arma::mat& Q,
+                        const arma::mat& inverseSums,
+                        const arma::mat& W,
+                        const MatType& A)
+{
+  arma::mat P, G;
+  RotatedProduct(W, A, Q, P);
+  SolveLyapunov(G, Q, inverseSums, P + P.t());
+  math::Svec(G, g);
 }
 
 /**
@@ -164,12 +225,18 @@ SolveLyapunov(arma::mat& X, const arma::mat& A, const arma::mat& H)
  *     E  = Z sym I
  *     F  = X sym I
  *
+ * The Schur complement M = A E^(-1) F A^T is given by its LU decomposition
+ * P^T L U = M, which is shared by the predictor and the corrector step, and
+ * Z by its eigenvalue decomposition (see SolveLyapunov()).
  */
 static inline void
 SolveKKTSystem(const arma::sp_mat& Asparse,
                const arma::mat& Adense,
-               const arma::mat& Z,
-               const arma::mat& M,
+               const arma::mat& Q,
+               const arma::mat& inverseSums,
+               const arma::mat& L,
+               const arma::mat& U,
+               const arma::mat& P,
                const arma::mat& F,
                const arma::vec& rp,
                const arma::vec& rd,
@@ -188,7 +255,8 @@ SolveKKTSystem(const arma::sp_mat& Asparse,
 
   // Compute the RHS of (2.12)
   math::Smat(F * rd - rc, Frd_rc_Mat);
-  SolveLyapunov(Einv_Frd_rc_Mat, Z, 2. * Frd_rc_Mat);
+  SolveLyapunov(Einv_Frd_rc_Mat, Q, inverseSums,
+      2. * Q.t() * Frd_rc_Mat * Q);
   math::Svec(Einv_Frd_rc_Mat, Einv_Frd_rc);
 
   arma::vec rhs = rp;
@@ -198,8 +266,9 @@ SolveKKTSystem(const arma::sp_mat& Asparse,
   if (Adense.n_rows)
     rhs(arma::span(Asparse.n_rows, numConstraints - 1)) += Adense * Einv_Frd_rc;
 
-  // TODO(stephentu): use a more efficient method (e.g. LU decomposition)
-  if (!arma::solve(dy, M, rhs))
+  arma::vec Ldy;
+  if (!arma::solve(Ldy, arma::trimatl(L), P * rhs) ||
+      !arma::solve(dy, arma::trimatu(U), Ldy))
     Log::Fatal << "PrimalDualSolver::SolveKKTSystem(): Could not solve KKT "
         << "system." << std::endl;
 
@@ -211,7 +280,8 @@ SolveKKTSystem(const arma::sp_mat& Asparse,
   // Compute dx from (2.13)
   math::Smat(F * (rd - Asparse.t() * dysparse - Adense.t() * dydense) - rc,
       Frd_ATdy_rc_Mat);
-  SolveLyapunov(Einv_Frd_ATdy_rc_Mat, Z, 2. * Frd_ATdy_rc_Mat);
+  SolveLyapunov(Einv_Frd_ATdy_rc_Mat, Q, inverseSums,
+      2. * Q.t() * Frd_ATdy_rc_Mat * Q);
   math::Svec(Einv_Frd_ATdy_rc_Mat, Einv_Frd_ATdy_rc);
   dsx = -Einv_Frd_ATdy_rc;
 
@@ -277,16 +347,18 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
   math::Svec(X, sx);
   math::Svec(Z, sz);
 
-  arma::vec rp, rd, rc, gk;
+  arma::vec rp, rd, rc;
 
-  arma::mat Rc, F, Einv_F_AsparseT, Einv_F_AdenseT, Gk,
-            M, DualCheck;
+  arma::mat Rc, F, Einv_F_AT, M, L, U, P, Q, inverseSums, W, DualCheck;
+  arma::vec lambda;
 
-  rp.set_size(sdp.NumConstraints());
+  const size_t numSparse = sdp.NumSparseConstraints();
+  const size_t numConstraints = sdp.NumConstraints();
 
-  Einv_F_AsparseT.set_size(n2bar, sdp.NumSparseConstraints());
-  Einv_F_AdenseT.set_size(n2bar, sdp.NumDenseConstraints());
-  M.set_size(sdp.NumConstraints(), sdp.NumConstraints());
+  rp.set_size(numConstraints);
+
+  Einv_F_AT.set_size(n2bar, numConstraints);
+  M.set_size(numConstraints, numConstraints);
 
   double primalObj = 0., alpha, beta;
   for (size_t iteration = 1; iteration != maxIterations; iteration++)
@@ -310,54 +382,61 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
 
     math::SymKronId(X, F);
 
-    // We compute E^(-1) F A^T by solving Lyapunov equations.
-    // See (2.16).
-    for (size_t i = 0; i < sdp.NumSparseConstraints(); i++)
+    // All the Lyapunov equations of this iteration have Z on the left hand
+    // side, so they are solved with one eigenvalue decomposition of Z.
+    if (!arma::eig_sym(lambda, Q, Z))
     {
-      SolveLyapunov(Gk, Z, X * sdp.SparseA()[i] + sdp.SparseA()[i] * X);
-      math::Svec(Gk, gk);
-      Einv_F_AsparseT.col(i) = gk;
+      Log::Warn << "PrimalDualSolver::Optimize(): eigendecomposition of Z "
+          << "failed!  Terminating optimization.";
+      return primalObj;
     }
-
-    for (size_t i = 0; i < sdp.NumDenseConstraints(); i++)
+    inverseSums = 1. / (arma::repmat(lambda, 1, n) +
+        arma::repmat(lambda.t(), n, 1));
+    W = Q.t() * X;
+
+    // We compute E^(-1) F A^T by solving Lyapunov equations, one for each
+    // constraint.  See (2.16).  The equations are independent, and the ones of
+    // sparse constraints only touch the nonzeros of the constraint before the
+    // final change of basis.
     {
-      SolveLyapunov(Gk, Z, X * sdp.DenseA()[i] + sdp.DenseA()[i] * X);
-      math::Svec(Gk, gk);
-      Einv_F_AdenseT.col(i) = gk;
-    }
+      util::SingleThreadedBLAS singleThreadedBLAS;
 
-    // Form the M = A E^(-1) F A^T matrix (2.15)
-    //
-    // Since we split A up into its sparse and dense components,
-    // we have to handle each block separately.
-    if (sdp.NumSparseConstraints())
-    {
-      M.submat(arma::span(0, sdp.NumSparseConstraints() - 1),
-               arma::span(0, sdp.NumSparseConstraints() - 1)) =
-          Asparse * Einv_F_AsparseT;
-      if (sdp.NumDenseConstraints())
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) numConstraints; ++i)
       {
-        M.submat(arma::span(0, sdp.NumSparseConstraints() - 1),
-                 arma::span(sdp.NumSparseConstraints(),
-                            sdp.NumConstraints() - 1)) =
-            Asparse * Einv_F_AdenseT;
+        arma::vec gk;
+        if ((size_t) i < numSparse)
+        {
+          SolveConstraintLyapunov(gk, Q, inverseSums, W,
+              sdp.SparseA()[i]);
+        }
+        else
+        {
+          SolveConstraintLyapunov(gk, Q, inverseSums, W,
+              sdp.DenseA()[i - numSparse]);
+        }
+        Einv_F_AT.col(i) = gk;
       }
     }
+
+    // Form the M = A E^(-1) F A^T matrix (2.15).  The rows of the sparse
+    // constraints are products with the sparse A, computed in parallel over
+    // the columns; the rows of the dense constraints are one matrix product.
+    if (numSparse)
+    {
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t j = 0; j < (omp_size_t) numConstraints; ++j)
+        M.submat(0, j, numSparse - 1, j) = Asparse * Einv_F_AT.col(j);
+    }
     if (sdp.NumDenseConstraints())
+      M.rows(numSparse, numConstraints - 1) = Adense * Einv_F_AT;
+
+    // M is the same for the predictor and the corrector step, so it is only
+    // factorized once.
+    if (!arma::lu(L, U, P, M))
     {
-      if (sdp.NumSparseConstraints())
-      {
-        M.submat(arma::span(sdp.NumSparseConstraints(),
-                            sdp.NumConstraints() - 1),
-                 arma::span(0,
-                            sdp.NumSparseConstraints() - 1)) =
-            Adense * Einv_F_AsparseT;
-      }
-      M.submat(arma::span(sdp.NumSparseConstraints(),
-                          sdp.NumConstraints() - 1),
-               arma::span(sdp.NumSparseConstraints(),
-                          sdp.NumConstraints() - 1)) =
-          Adense * Einv_F_AdenseT;
+      Log::Fatal << "PrimalDualSolver::Optimize(): Could not factorize the "
+          << "Schur complement." << std::endl;
     }
 
     const double sxdotsz = arma::dot(sx, sz);
@@ -369,8 +448,8 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
     // This solves step (1) of Section 7, the "predictor" step.
     Rc = -0.5*(X*Z + Z*X);
     math::Svec(Rc, rc);
-    SolveKKTSystem(Asparse, Adense, Z, M, F, rp, rd, rc, dsx, dysparse, dydense,
-        dsz);
+    SolveKKTSystem(Asparse, Adense, Q, inverseSums, L, U, P, F, rp, rd, rc, dsx,
+        dysparse, dydense, dsz);
     math::Smat(dsx, dX);
     math::Smat(dsz, dZ);
 
@@ -399,8 +478,8 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
     // Step (3), the "corrector" step.
     Rc = mu*arma::eye<arma::mat>(n, n) - 0.5*(X*Z + Z*X + dX*dZ + dZ*dX);
     math::Svec(Rc, rc);
-    SolveKKTSystem(Asparse, Adense, Z, M, F, rp, rd, rc, dsx, dysparse, dydense,
-        dsz);
+    SolveKKTSystem(Asparse, Adense, Q, inverseSums, L, U, P, F, rp, rd, rc, dsx,
+        dysparse, dydense, dsz);
     math::Smat(dsx, dX);
     math::Smat(dsz, dZ);
     if (!Alpha(X, dX, tau, alpha))
@@ -448,13 +527,10 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
         arma::dot(sdp.DenseB(), ydense);
     const double dualityGap = primalObj - dualObj;
 
-    // TODO(stephentu): this dual check is quite expensive,
-    // maybe make it optional?
-    DualCheck = Z - sdp.C();
-    for (size_t i = 0; i < sdp.NumSparseConstraints(); i++)
-      DualCheck += ysparse(i) * sdp.SparseA()[i];
-    for (size_t i = 0; i < sdp.NumDenseConstraints(); i++)
-      DualCheck += ydense(i) * sdp.DenseA()[i];
+    // Smat is linear, so the sum of the constraints weighted by y is the smat
+    // of the product with the svec'd constraints.
+    math::Smat(Asparse.t() * ysparse + Adense.t() * ydense, DualCheck);
+    DualCheck += Z - sdp.C();
     const double dualInfeas = arma::norm(DualCheck, "fro");
 
     Log::Debug
@@ -61,6 +61,10 @@ class NoDecay
   {
     // Nothing to do here.
   }
+
+  //! Serialize the decay policy (it has no state).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
 };
 
 } // namespace optimization
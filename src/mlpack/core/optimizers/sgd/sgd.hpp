@@ -16,6 +16,8 @@
 #define MLPACK_CORE_OPTIMIZERS_SGD_SGD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/checkpoint.hpp>
+#include <mlpack/core/optimizers/callbacks/callback.hpp>
 #include "update_policies/vanilla_update.hpp"
 #include "update_policies/momentum_update.hpp"
 #include "update_policies/nesterov_momentum_update.hpp"
@@ -172,7 +174,59 @@ class SGD
   //! Modify the step size decay policy.
   DecayPolicyType& DecayPolicy() { return decayPolicy; }
 
+  //! Get the checkpointing settings.
+  const Checkpoint& Checkpointing() const { return checkpoint; }
+  //! Modify the checkpointing settings.  If a checkpoint file is set, the
+  //! state is written every Interval() epochs, and Optimize() resumes from the
+  //! file if it already exists.
+  Checkpoint& Checkpointing() { return checkpoint; }
+
+  //! Get the callbacks that are notified of epochs, steps and evaluations.
+  const CallbackList& Callbacks() const { return callbacks; }
+  //! Modify the callbacks that are notified of epochs, steps and evaluations.
+  CallbackList& Callbacks() { return callbacks; }
+
  private:
+  /**
+   * The state of a running optimization, as written to a checkpoint: the
+   * iterate, the current step size, the update and decay policy state, and the
+   * iteration counters.  The user's settings (batch size, maximum number of
+   * iterations, tolerance) are not part of the state, so that they can be
+   * changed when resuming.
+   */
+  class RunState
+  {
+   public:
+    RunState(SGD& sgd,
+             arma::mat& iterate,
+             size_t& iteration,
+             double& lastObjective) :
+        sgd(sgd),
+        iterate(iterate),
+        iteration(iteration),
+        lastObjective(lastObjective)
+    { /* Nothing to do. */ }
+
+    //! Serialize the state.
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int /* version */)
+    {
+      ar & boost::serialization::make_nvp("stepSize", sgd.stepSize);
+      SerializePolicy(ar, "updatePolicy", sgd.updatePolicy);
+      SerializePolicy(ar, "decayPolicy", sgd.decayPolicy);
+      ar & BOOST_SERIALIZATION_NVP(iterate);
+      ar & BOOST_SERIALIZATION_NVP(iteration);
+      ar & BOOST_SERIALIZATION_NVP(lastObjective);
+    }
+
+   private:
+    SGD& sgd;
+    arma::mat& iterate;
+    size_t& iteration;
+    double& lastObjective;
+  };
+
+
   //! The step size for each example.
   double stepSize;
 
@@ -198,6 +252,12 @@ class SGD
   //! Flag indicating whether update policy
   //! should be reset before running optimization.
   bool resetPolicy;
+
+  //! The checkpointing settings.
+  Checkpoint checkpoint;
+
+  //! The callbacks (not owned).
+  CallbackList callbacks;
 };
 
 using StandardSGD = SGD<VanillaUpdate>;
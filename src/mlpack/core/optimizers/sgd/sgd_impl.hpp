@@ -62,19 +62,44 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
   size_t currentFunction = 0;
   double overallObjective = 0;
   double lastObjective = DBL_MAX;
+  size_t i = 0;
+
+  // Pick up from an earlier run, if there is a checkpoint.  Checkpoints are
+  // only written at the start of an epoch, so the counters that are not saved
+  // are all zero.
+  const size_t rows = iterate.n_rows;
+  const size_t cols = iterate.n_cols;
+  RunState state(*this, iterate, i, lastObjective);
+  const bool resumed = checkpoint.Load(state);
+  if (resumed && (iterate.n_rows != rows || iterate.n_cols != cols))
+  {
+    std::ostringstream oss;
+    oss << "SGD::Optimize(): checkpoint '" << checkpoint.Filename() << "' has "
+        << "an iterate of size " << iterate.n_rows << "x" << iterate.n_cols
+        << ", but the given iterate has size " << rows << "x" << cols;
+    throw std::invalid_argument(oss.str());
+  }
+  const size_t startIteration = i;
 
-  // Initialize the update policy.
-  if (resetPolicy)
+  // Initialize the update policy, unless its state came from the checkpoint.
+  if ((resetPolicy && !resumed) ||
+      (resumed && !data::HasSerialize<UpdatePolicyType>::value))
     updatePolicy.Initialize(iterate.n_rows, iterate.n_cols);
 
+  if (resumed && shuffle)
+    f.Shuffle();
+
+  callbacks.BeginOptimization(iterate);
+
   // Now iterate!
   arma::mat gradient(iterate.n_rows, iterate.n_cols);
   const size_t actualMaxIterations = (maxIterations == 0) ?
       std::numeric_limits<size_t>::max() : maxIterations;
-  for (size_t i = 0; i < actualMaxIterations; /* incrementing done manually */)
+  bool terminated = false;
+  while (i < actualMaxIterations)
   {
     // Is this iteration the start of a sequence?
-    if ((currentFunction % numFunctions) == 0 && i > 0)
+    if ((currentFunction % numFunctions) == 0 && i > startIteration)
     {
       // Output current objective function.
       Log::Info << "SGD: iteration " << i << ", objective " << overallObjective
@@ -84,6 +109,7 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
       {
         Log::Warn << "SGD: converged to " << overallObjective << "; terminating"
             << " with failure.  Try a smaller step size?" << std::endl;
+        callbacks.EndOptimization(iterate);
         return overallObjective;
       }
 
@@ -91,14 +117,24 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
       {
         Log::Info << "SGD: minimized within tolerance " << tolerance << "; "
             << "terminating optimization." << std::endl;
+        callbacks.EndOptimization(iterate);
         return overallObjective;
       }
 
+      if (callbacks.EndEpoch(iterate, i / numFunctions, overallObjective))
+      {
+        terminated = true;
+        break;
+      }
+
       // Reset the counter variables.
       lastObjective = overallObjective;
       overallObjective = 0;
       currentFunction = 0;
 
+      if (checkpoint.Due(i / numFunctions))
+        checkpoint.Save(state);
+
       if (shuffle) // Determine order of visitation.
         f.Shuffle();
     }
@@ -115,8 +151,14 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
 
     // Technically we are computing the objective before we take the step, but
     // for many FunctionTypes it may be much quicker to do it like this.
-    overallObjective += f.EvaluateWithGradient(iterate, currentFunction,
+    const double objective = f.EvaluateWithGradient(iterate, currentFunction,
         gradient, effectiveBatchSize);
+    overallObjective += objective;
+    if (callbacks.Evaluate(iterate, objective))
+    {
+      terminated = true;
+      break;
+    }
 
     // Use the update policy to take a step.
     updatePolicy.Update(iterate, stepSize, gradient);
@@ -126,17 +168,35 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
 
     i += effectiveBatchSize;
     currentFunction += effectiveBatchSize;
+
+    if (callbacks.StepTaken(iterate, objective))
+    {
+      terminated = true;
+      break;
+    }
+  }
+
+  if (terminated)
+  {
+    Log::Info << "SGD: a callback requested termination at iteration " << i
+        << "; terminating optimization." << std::endl;
+  }
+  else
+  {
+    Log::Info << "SGD: maximum iterations (" << maxIterations << ") reached; "
+        << "terminating optimization." << std::endl;
   }
 
-  Log::Info << "SGD: maximum iterations (" << maxIterations << ") reached; "
-      << "terminating optimization." << std::endl;
+  // The callbacks may replace the iterate (for instance, with the best point
+  // seen), so this comes before the final objective is computed.
+  callbacks.EndOptimization(iterate);
 
   // Calculate final objective.
   overallObjective = 0;
-  for (size_t i = 0; i < numFunctions; i += batchSize)
+  for (size_t j = 0; j < numFunctions; j += batchSize)
   {
-    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
-    overallObjective += f.Evaluate(iterate, i, effectiveBatchSize);
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - j);
+    overallObjective += f.Evaluate(iterate, j, effectiveBatchSize);
   }
   return overallObjective;
 }
@@ -104,6 +104,14 @@ class MomentumUpdate
     iterate += velocity;
   }
 
+  //! Serialize the update policy, including its state.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(momentum);
+    ar & BOOST_SERIALIZATION_NVP(velocity);
+  }
+
  private:
   // The momentum hyperparamter
   double momentum;
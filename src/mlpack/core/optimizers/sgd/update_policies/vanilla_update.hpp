@@ -57,6 +57,10 @@ class VanillaUpdate
     // Perform the vanilla SGD update.
     iterate -= stepSize * gradient;
   }
+
+  //! Serialize the update policy (it has no state).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
 };
 
 } // namespace optimization
@@ -111,6 +111,19 @@ class CyclicalDecay
   //! Modify the restart fraction.
   double& EpochBatches() { return epochBatches; }
 
+  //! Serialize the decay policy, including its state.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epochRestart);
+    ar & BOOST_SERIALIZATION_NVP(multFactor);
+    ar & BOOST_SERIALIZATION_NVP(constStepSize);
+    ar & BOOST_SERIALIZATION_NVP(nextRestart);
+    ar & BOOST_SERIALIZATION_NVP(batchRestart);
+    ar & BOOST_SERIALIZATION_NVP(epochBatches);
+    ar & BOOST_SERIALIZATION_NVP(epoch);
+  }
+
  private:
   //! Epoch where decay is applied.
   size_t epochRestart;
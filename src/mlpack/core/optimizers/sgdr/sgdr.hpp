@@ -127,6 +127,16 @@ class SGDR
     return optimizer.UpdatePolicy();
   }
 
+  //! Get the checkpointing settings.
+  const Checkpoint& Checkpointing() const { return optimizer.Checkpointing(); }
+  //! Modify the checkpointing settings.
+  Checkpoint& Checkpointing() { return optimizer.Checkpointing(); }
+
+  //! Get the callbacks.
+  const CallbackList& Callbacks() const { return optimizer.Callbacks(); }
+  //! Modify the callbacks.
+  CallbackList& Callbacks() { return optimizer.Callbacks(); }
+
  private:
   //! The size of each mini-batch.
   size_t batchSize;
@@ -141,6 +141,21 @@ class SnapshotEnsembles
   //! Modify the snapshots.
   std::vector<arma::mat>& Snapshots() { return snapshots; }
 
+  //! Serialize the decay policy, including its state.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epochRestart);
+    ar & BOOST_SERIALIZATION_NVP(multFactor);
+    ar & BOOST_SERIALIZATION_NVP(constStepSize);
+    ar & BOOST_SERIALIZATION_NVP(nextRestart);
+    ar & BOOST_SERIALIZATION_NVP(batchRestart);
+    ar & BOOST_SERIALIZATION_NVP(epochBatches);
+    ar & BOOST_SERIALIZATION_NVP(epoch);
+    ar & BOOST_SERIALIZATION_NVP(snapshotEpochs);
+    ar & BOOST_SERIALIZATION_NVP(snapshots);
+  }
+
  private:
   //! Epoch where decay is applied.
   size_t epochRestart;
@@ -0,0 +1,218 @@
+/**
+ * @file stochastic_weight_averaging.hpp
+ *
+ * Definition of the Stochastic Weight Averaging technique described in:
+ * "Averaging Weights Leads to Wider Optima and Better Generalization" by
+ * P. Izmailov et al.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SGDR_STOCHASTIC_WEIGHT_AVERAGING_HPP
+#define MLPACK_CORE_OPTIMIZERS_SGDR_STOCHASTIC_WEIGHT_AVERAGING_HPP
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Decay the step size with the same cyclical cosine schedule and warm
+ * restarts as SnapshotEnsembles, but instead of storing a snapshot of the
+ * parameters at each restart, add it to a running average of the snapshots.
+ * The average gives the accuracy of an ensemble of the snapshots, but only
+ * needs the memory of one extra copy of the parameters, and the averaged model
+ * costs as much to evaluate as a single one.
+ *
+ * The snapshots that are averaged are the ones SnapshotEnsembles would keep
+ * with the same parameters, so this can be used as a replacement for it.
+ *
+ * For more information, please refer to:
+ *
+ * @code
+ * @inproceedings{Izmailov2018,
+ *   title     = {Averaging Weights Leads to Wider Optima and Better
+ *                Generalization},
+ *   author    = {Pavel Izmailov, Dmitrii Podoprikhin, Timur Garipov,
+ *                Dmitry Vetrov, and Andrew Gordon Wilson},
+ *   booktitle = {Proceedings of the Conference on Uncertainty in Artificial
+ *                Intelligence (UAI)},
+ *   year      = {2018},
+ *   url       = {https://arxiv.org/abs/1803.05407}
+ * }
+ * @endcode
+ */
+class StochasticWeightAveraging
+{
+ public:
+  /**
+   * Construct the StochasticWeightAveraging decay policy.
+   *
+   * @param epochRestart Initial epoch where decay is applied.
+   * @param multFactor Factor to increase the number of epochs before a restart.
+   * @param stepSize Initial step size for each restart.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *        limit).
+   * @param snapshots Maximum number of snapshots to average.
+   */
+  StochasticWeightAveraging(const size_t epochRestart,
+                            const double multFactor,
+                            const double stepSize,
+                            const size_t maxIterations,
+                            const size_t snapshots) :
+    epochRestart(epochRestart),
+    multFactor(multFactor),
+    constStepSize(stepSize),
+    nextRestart(epochRestart),
+    batchRestart(0),
+    epochBatches(0),
+    epoch(0),
+    averaged(0)
+  {
+    // Compute the period of the first restart that is averaged, like
+    // SnapshotEnsembles; if there are fewer restarts than snapshots, all of
+    // them are averaged.
+    size_t restarts = 0;
+    for (size_t i = 0, er = epochRestart, nr = nextRestart;
+        i < maxIterations; ++i)
+    {
+      if (i > nr)
+      {
+        er *= multFactor;
+        nr += er;
+        restarts++;
+      }
+    }
+
+    snapshotEpochs = epochRestart * std::pow(multFactor,
+        (restarts + 1 > snapshots) ? restarts + 1 - snapshots : 0);
+  }
+
+  /**
+   * This function is called in each iteration after the policy update.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              double& stepSize,
+              const arma::mat& /* gradient */)
+  {
+    // Time to adjust the step size.
+    if (epoch >= epochRestart)
+    {
+      // n_t = n_min^i + 0.5(n_max^i - n_min^i)(1 + cos(T_cur/T_i * pi)).
+      stepSize = 0.5 * constStepSize * (1 + cos((batchRestart / epochBatches)
+          * M_PI));
+
+      // Keep track of the number of batches since the last restart.
+      batchRestart++;
+    }
+
+    // Time to restart.
+    if (epoch > nextRestart)
+    {
+      batchRestart = 0;
+
+      // Adjust the period of restarts.
+      epochRestart *= multFactor;
+
+      // Add the snapshot to the average.
+      if (epochRestart >= snapshotEpochs)
+        Accumulate(iterate);
+
+      // Update the time for the next restart.
+      nextRestart += epochRestart;
+    }
+
+    epoch++;
+  }
+
+  /**
+   * Add the given parameters to the running average.
+   *
+   * @param iterate Parameters to add to the average.
+   */
+  void Accumulate(const arma::mat& iterate)
+  {
+    if (averaged == 0)
+      average = iterate;
+    else
+      average += (iterate - average) / double(averaged + 1);
+
+    averaged++;
+  }
+
+  //! Get the step size.
+  double StepSize() const { return constStepSize; }
+  //! Modify the step size.
+  double& StepSize() { return constStepSize; }
+
+  //! Get the restart fraction.
+  double EpochBatches() const { return epochBatches; }
+  //! Modify the restart fraction.
+  double& EpochBatches() { return epochBatches; }
+
+  //! Get the average of the snapshots.
+  const arma::mat& Average() const { return average; }
+  //! Modify the average of the snapshots.
+  arma::mat& Average() { return average; }
+
+  //! Get the number of snapshots in the average.
+  size_t Averaged() const { return averaged; }
+  //! Modify the number of snapshots in the average.
+  size_t& Averaged() { return averaged; }
+
+  //! Serialize the decay policy, including its state.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epochRestart);
+    ar & BOOST_SERIALIZATION_NVP(multFactor);
+    ar & BOOST_SERIALIZATION_NVP(constStepSize);
+    ar & BOOST_SERIALIZATION_NVP(nextRestart);
+    ar & BOOST_SERIALIZATION_NVP(batchRestart);
+    ar & BOOST_SERIALIZATION_NVP(epochBatches);
+    ar & BOOST_SERIALIZATION_NVP(epoch);
+    ar & BOOST_SERIALIZATION_NVP(snapshotEpochs);
+    ar & BOOST_SERIALIZATION_NVP(average);
+    ar & BOOST_SERIALIZATION_NVP(averaged);
+  }
+
+ private:
+  //! Epoch where decay is applied.
+  size_t epochRestart;
+
+  //! Parameter to increase the number of epochs before a restart.
+  double multFactor;
+
+  //! The step size for each example.
+  double constStepSize;
+
+  //! Locally-stored restart time.
+  size_t nextRestart;
+
+  //! Locally-stored number of batches since the last restart.
+  size_t batchRestart;
+
+  //! Locally-stored restart fraction.
+  double epochBatches;
+
+  //! Locally-stored epoch.
+  size_t epoch;
+
+  //! Epochs where a new snapshot is averaged.
+  size_t snapshotEpochs;
+
+  //! Locally-stored average of the snapshots.
+  arma::mat average;
+
+  //! Locally-stored number of snapshots in the average.
+  size_t averaged;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
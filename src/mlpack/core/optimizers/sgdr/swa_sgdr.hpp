@@ -0,0 +1,220 @@
+/**
+ * @file swa_sgdr.hpp
+ *
+ * Definition of the Stochastic Gradient Descent with Restarts (SGDR) as
+ * described in: "SGDR: Stochastic Gradient Descent with Warm Restarts" by
+ * I. Loshchilov et al, which returns the average of the snapshots taken at the
+ * restarts (Stochastic Weight Averaging) as described in: "Averaging Weights
+ * Leads to Wider Optima and Better Generalization" by P. Izmailov et al.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SGDR_SWA_SGDR_HPP
+#define MLPACK_CORE_OPTIMIZERS_SGDR_SWA_SGDR_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+#include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/sgd/update_policies/momentum_update.hpp>
+#include "stochastic_weight_averaging.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+// This gives us a HasUpdateStatisticsCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a function has an
+// UpdateStatistics() method (like FFN).
+HAS_MEM_FUNC(UpdateStatistics, HasUpdateStatisticsCheck);
+
+/**
+ * This class is based on Mini-batch Stochastic Gradient Descent class and
+ * simulates a new warm-started run/restart once a number of epochs are
+ * performed, like SnapshotSGDR.  Instead of storing the snapshots taken at the
+ * restarts, they are averaged as they are taken (see
+ * StochasticWeightAveraging), and the optimization returns the average of the
+ * snapshots and the final point.  This gives ensemble-like accuracy with the
+ * memory and the evaluation cost of a single model.
+ *
+ * The statistics some layers keep over the training data (like the mean and
+ * variance of a BatchNorm layer) are not valid for the averaged parameters.
+ * If the function has a void UpdateStatistics(const size_t batchSize)
+ * method, like FFN, it is called with the averaged parameters, so that the
+ * statistics are computed again with one pass over the data.
+ *
+ * For more information, please refer to:
+ *
+ * @code
+ * @article{Loshchilov2016,
+ *   title   = {{SGDR:} Stochastic Gradient Descent with Restarts},
+ *   author  = {Ilya Loshchilov and Frank Hutter},
+ *   journal = {CoRR},
+ *   year    = {2016},
+ *   url     = {https://arxiv.org/abs/1608.03983}
+ * }
+ * @endcode
+ *
+ * @code
+ * @inproceedings{Izmailov2018,
+ *   title     = {Averaging Weights Leads to Wider Optima and Better
+ *                Generalization},
+ *   author    = {Pavel Izmailov, Dmitrii Podoprikhin, Timur Garipov,
+ *                Dmitry Vetrov, and Andrew Gordon Wilson},
+ *   booktitle = {Proceedings of the Conference on Uncertainty in Artificial
+ *                Intelligence (UAI)},
+ *   year      = {2018},
+ *   url       = {https://arxiv.org/abs/1803.05407}
+ * }
+ * @endcode
+ *
+ * @tparam UpdatePolicyType Update policy used during the iterative update
+ *         process. By default the momentum update policy
+ *         (see mlpack::optimization::MomentumUpdate) is used.
+ */
+template<typename UpdatePolicyType = MomentumUpdate>
+class SWASGDR
+{
+ public:
+  //! Convenience typedef for the internal optimizer construction.
+  using OptimizerType = SGD<UpdatePolicyType, StochasticWeightAveraging>;
+
+  /**
+   * Construct the SWASGDR optimizer with the given function and parameters.
+   * The defaults here are not necessarily good for the given problem, so it is
+   * suggested that the values used be tailored for the task at hand.  The
+   * maximum number of iterations refers to the maximum number of mini-batches
+   * that are processed.
+   *
+   * @param epochRestart Initial epoch where decay is applied.
+   * @param multFactor Factor to increase the number of epochs before a restart.
+   * @param batchSize Size of each mini-batch.
+   * @param stepSize Step size for each iteration.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *        limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the mini-batch order is shuffled; otherwise, each
+   *        mini-batch is visited in linear order.
+   * @param snapshots Maximum number of snapshots to average.
+   * @param updateStatistics If true, update the statistics of the function
+   *        with the averaged parameters, if it supports that.
+   * @param updatePolicy Instantiated update policy used to adjust the given
+   *        parameters.
+   */
+  SWASGDR(const size_t epochRestart = 50,
+          const double multFactor = 2.0,
+          const size_t batchSize = 1000,
+          const double stepSize = 0.01,
+          const size_t maxIterations = 100000,
+          const double tolerance = 1e-5,
+          const bool shuffle = true,
+          const size_t snapshots = 5,
+          const bool updateStatistics = true,
+          const UpdatePolicyType& updatePolicy = UpdatePolicyType());
+
+  /**
+   * Optimize the given function using SGDR.  The given starting point
+   * will be modified to store the average of the snapshots and the finishing
+   * point of the algorithm, and the objective value of the average is
+   * returned.
+   *
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the averaged point.
+   */
+  template<typename DecomposableFunctionType>
+  double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
+
+  //! Get the batch size.
+  size_t BatchSize() const { return optimizer.BatchSize(); }
+  //! Modify the batch size.
+  size_t& BatchSize() { return optimizer.BatchSize(); }
+
+  //! Get the step size.
+  double StepSize() const { return optimizer.StepSize(); }
+  //! Modify the step size.
+  double& StepSize() { return optimizer.StepSize(); }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return optimizer.MaxIterations(); }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return optimizer.MaxIterations(); }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return optimizer.Tolerance(); }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return optimizer.Tolerance(); }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return optimizer.Shuffle(); }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return optimizer.Shuffle(); }
+
+  //! Get the average of the snapshots.
+  const arma::mat& Average() const
+  {
+    return optimizer.DecayPolicy().Average();
+  }
+
+  //! Get the number of snapshots in the average.
+  size_t Averaged() const { return optimizer.DecayPolicy().Averaged(); }
+
+  //! Get whether the statistics of the function are updated.
+  bool UpdateStatistics() const { return updateStatistics; }
+  //! Modify whether the statistics of the function are updated.
+  bool& UpdateStatistics() { return updateStatistics; }
+
+  //! Get the update policy.
+  const UpdatePolicyType& UpdatePolicy() const
+  {
+    return optimizer.UpdatePolicy();
+  }
+  //! Modify the update policy.
+  UpdatePolicyType& UpdatePolicy()
+  {
+    return optimizer.UpdatePolicy();
+  }
+
+  //! Get the checkpointing settings.
+  const Checkpoint& Checkpointing() const { return optimizer.Checkpointing(); }
+  //! Modify the checkpointing settings.
+  Checkpoint& Checkpointing() { return optimizer.Checkpointing(); }
+
+  //! Get the callbacks.
+  const CallbackList& Callbacks() const { return optimizer.Callbacks(); }
+  //! Modify the callbacks.
+  CallbackList& Callbacks() { return optimizer.Callbacks(); }
+
+ private:
+  //! Update the statistics of the function, if it has an UpdateStatistics()
+  //! method.
+  template<typename DecomposableFunctionType>
+  typename std::enable_if<HasUpdateStatisticsCheck<DecomposableFunctionType,
+      void(DecomposableFunctionType::*)(const size_t)>::value, void>::type
+  FunctionUpdateStatistics(DecomposableFunctionType& function);
+
+  //! Do nothing if the function doesn't have an UpdateStatistics() method.
+  template<typename DecomposableFunctionType>
+  typename std::enable_if<!HasUpdateStatisticsCheck<DecomposableFunctionType,
+      void(DecomposableFunctionType::*)(const size_t)>::value, void>::type
+  FunctionUpdateStatistics(DecomposableFunctionType& /* function */) { }
+
+  //! The size of each mini-batch.
+  size_t batchSize;
+
+  //! Whether or not to update the statistics of the function.
+  bool updateStatistics;
+
+  //! Locally-stored optimizer instance.
+  OptimizerType optimizer;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "swa_sgdr_impl.hpp"
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file swa_sgdr_impl.hpp
+ *
+ * Implementation of SGDR method using stochastic weight averaging.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SGDR_SWA_SGDR_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_SGDR_SWA_SGDR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "swa_sgdr.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename UpdatePolicyType>
+SWASGDR<UpdatePolicyType>::SWASGDR(
+    const size_t epochRestart,
+    const double multFactor,
+    const size_t batchSize,
+    const double stepSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle,
+    const size_t snapshots,
+    const bool updateStatistics,
+    const UpdatePolicyType& updatePolicy) :
+    batchSize(batchSize),
+    updateStatistics(updateStatistics),
+    optimizer(OptimizerType(stepSize,
+                            batchSize,
+                            maxIterations,
+                            tolerance,
+                            shuffle,
+                            updatePolicy,
+                            StochasticWeightAveraging(
+                                epochRestart,
+                                multFactor,
+                                stepSize,
+                                maxIterations,
+                                snapshots)))
+{
+  /* Nothing to do here */
+}
+
+template<typename UpdatePolicyType>
+template<typename DecomposableFunctionType>
+double SWASGDR<UpdatePolicyType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::mat& iterate)
+{
+  // If the step size was changed, the step size of the decay policy has to be
+  // updated too.
+  if (optimizer.StepSize() != optimizer.DecayPolicy().StepSize())
+  {
+    optimizer.DecayPolicy().StepSize() = optimizer.StepSize();
+  }
+
+  // If a user changed the batch size we have to update the restart fraction
+  // of the cyclical decay instantiation.
+  if (optimizer.BatchSize() != batchSize)
+  {
+    batchSize = optimizer.BatchSize();
+  }
+
+  optimizer.DecayPolicy().EpochBatches() = function.NumFunctions() /
+      double(batchSize);
+
+  // Don't average the snapshots of a previous optimization.
+  optimizer.DecayPolicy().Averaged() = 0;
+  optimizer.DecayPolicy().Average().reset();
+
+  double overallObjective = optimizer.Optimize(function, iterate);
+
+  if (optimizer.DecayPolicy().Averaged() == 0)
+    return overallObjective;
+
+  // The final point is averaged too.  The average is copied into the memory of
+  // the iterate, since the function may hold aliases of it (like the layers of
+  // an FFN).
+  optimizer.DecayPolicy().Accumulate(iterate);
+  iterate = optimizer.DecayPolicy().Average();
+  optimizer.DecayPolicy().Average().reset();
+
+  if (updateStatistics)
+    FunctionUpdateStatistics(function);
+
+  // Calculate final objective.
+  overallObjective = 0;
+  for (size_t i = 0; i < function.NumFunctions(); ++i)
+    overallObjective += function.Evaluate(iterate, i, 1);
+
+  return overallObjective;
+}
+
+template<typename UpdatePolicyType>
+template<typename DecomposableFunctionType>
+typename std::enable_if<HasUpdateStatisticsCheck<DecomposableFunctionType,
+    void(DecomposableFunctionType::*)(const size_t)>::value, void>::type
+SWASGDR<UpdatePolicyType>::FunctionUpdateStatistics(
+    DecomposableFunctionType& function)
+{
+  function.UpdateStatistics(batchSize);
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -110,6 +110,10 @@ class SPALeRASGD
    * @param decayPolicy Instantiated decay policy used to adjust the step size.
    * @param resetPolicy Flag that determines whether update policy parameters
    *    are reset before every Optimize call.
+   * @param parallel If true, each batch is split into one part per thread,
+   *    and the objective is computed in parallel at the start and the end;
+   *    then EvaluateWithGradient() and Evaluate() have to be safe to call from
+   *    several threads at once.
    */
   SPALeRASGD(const double stepSize = 0.01,
              const size_t batchSize = 32,
@@ -121,7 +125,8 @@ class SPALeRASGD
              const double adaptRate = 3.10e-8,
              const bool shuffle = true,
              const DecayPolicyType& decayPolicy = DecayPolicyType(),
-             const bool resetPolicy = true);
+             const bool resetPolicy = true,
+             const bool parallel = false);
 
   /**
    * Optimize the given function using SPALeRA SGD.  The given starting point
@@ -178,6 +183,11 @@ class SPALeRASGD
   //! are reset before Optimize call.
   bool& ResetPolicy() { return resetPolicy; }
 
+  //! Get whether the batches are computed in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the batches are computed in parallel.
+  bool& Parallel() { return parallel; }
+
   //! Get the update policy.
   SPALeRAStepsize UpdatePolicy() const { return updatePolicy; }
   //! Modify the update policy.
@@ -217,6 +227,9 @@ class SPALeRASGD
   //! Flag that determines whether update policy parameters
   //! are reset before every Optimize call.
   bool resetPolicy;
+
+  //! Whether the batches are computed in parallel.
+  bool parallel;
 };
 
 } // namespace optimization
@@ -16,6 +16,7 @@
 #include "spalera_sgd.hpp"
 
 #include <mlpack/core/optimizers/function.hpp>
+#include <mlpack/core/optimizers/full_gradient.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -31,7 +32,8 @@ SPALeRASGD<DecayPolicyType>::SPALeRASGD(const double stepSize,
                                         const double adaptRate,
                                         const bool shuffle,
                                         const DecayPolicyType& decayPolicy,
-                                        const bool resetPolicy) :
+                                        const bool resetPolicy,
+                                        const bool parallel) :
     stepSize(stepSize),
     batchSize(batchSize),
     maxIterations(maxIterations),
@@ -40,7 +42,8 @@ SPALeRASGD<DecayPolicyType>::SPALeRASGD(const double stepSize,
     shuffle(shuffle),
     updatePolicy(SPALeRAStepsize(alpha, epsilon, adaptRate)),
     decayPolicy(decayPolicy),
-    resetPolicy(resetPolicy)
+    resetPolicy(resetPolicy),
+    parallel(parallel)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
@@ -63,11 +66,7 @@ double SPALeRASGD<DecayPolicyType>::Optimize(DecomposableFunctionType& function,
   double lastObjective = DBL_MAX;
 
   // Calculate the first objective function.
-  for (size_t i = 0; i < numFunctions; i += batchSize)
-  {
-    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
-    overallObjective += f.Evaluate(iterate, i, effectiveBatchSize);
-  }
+  overallObjective = FullObjective(f, iterate, batchSize, parallel);
 
   double currentObjective = overallObjective / numFunctions;
 
@@ -126,8 +125,8 @@ double SPALeRASGD<DecayPolicyType>::Optimize(DecomposableFunctionType& function,
         std::min(batchSize, actualMaxIterations - i),
         numFunctions - currentFunction);
 
-    currentObjective = f.EvaluateWithGradient(iterate, currentFunction,
-        gradient, effectiveBatchSize);
+    currentObjective = BatchEvaluateWithGradient(f, iterate, currentFunction,
+        gradient, effectiveBatchSize, parallel);
 
     // Use the update policy to take a step.
     if (!updatePolicy.Update(stepSize, currentObjective, effectiveBatchSize,
@@ -152,14 +151,7 @@ double SPALeRASGD<DecayPolicyType>::Optimize(DecomposableFunctionType& function,
       << ") reached; terminating optimization." << std::endl;
 
   // Calculate final objective.
-  overallObjective = 0;
-  for (size_t i = 0; i < numFunctions; i += batchSize)
-  {
-    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
-    overallObjective += f.Evaluate(iterate, i, effectiveBatchSize);
-  }
-
-  return overallObjective;
+  return FullObjective(f, iterate, batchSize, parallel);
 }
 
 } // namespace optimization
@@ -0,0 +1,174 @@
+/**
+ * @file async_svrg.hpp
+ *
+ * Asynchronous stochastic variance reduced gradient for sparse problems.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SVRG_ASYNC_SVRG_HPP
+#define MLPACK_CORE_OPTIMIZERS_SVRG_ASYNC_SVRG_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/optimizers/function.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An asynchronous variant of stochastic variance reduced gradient (SVRG) for
+ * functions with sparse gradients, in the lock-free style of ParallelSGD.
+ *
+ * Every outer iteration takes a snapshot of the iterate and computes the full
+ * gradient at it in parallel.  Then all threads take variance reduced steps on
+ * the shared iterate without locking it.  To keep the updates sparse, the step
+ * for function i only touches the coordinates in the support of its gradient at
+ * the snapshot, S_i, and the dense full gradient mu is replaced by its
+ * rescaled restriction D_i mu, where D_i holds the inverse of the fraction of
+ * the functions whose support contains each coordinate of S_i.  The expectation
+ * of D_i mu over i is mu, so the steps stay unbiased:
+ *
+ *   w_S <- w_S - stepSize * (g_i(w) - g_i(w_0) + D_i mu).
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{reddi2015variance,
+ *   title     = {On Variance Reduction in Stochastic Gradient Descent and its
+ *                Asynchronous Variants},
+ *   author    = {Reddi, Sashank J. and Hefny, Ahmed and Sra, Suvrit and
+ *                Poczos, Barnabas and Smola, Alex J.},
+ *   booktitle = {Advances in Neural Information Processing Systems},
+ *   pages     = {2647--2655},
+ *   year      = {2015}
+ * }
+ * @endcode
+ *
+ * @code
+ * @article{mania2015perturbed,
+ *   title   = {Perturbed Iterate Analysis for Asynchronous Stochastic
+ *              Optimization},
+ *   author  = {Mania, Horia and Pan, Xinghao and Papailiopoulos, Dimitris and
+ *              Recht, Benjamin and Ramchandran, Kannan and Jordan, Michael I.},
+ *   journal = {arXiv preprint arXiv:1507.06970},
+ *   year    = {2015}
+ * }
+ * @endcode
+ *
+ * For AsyncSVRG to work, a SparseFunctionType template parameter is required.
+ * This class must implement the following functions:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::sp_mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * Gradient() is called from several threads at once, so it has to be
+ * thread-safe.
+ */
+class AsyncSVRG
+{
+ public:
+  /**
+   * Construct the AsyncSVRG optimizer with the given parameters.
+   *
+   * @param stepSize Step size for each inner step.
+   * @param maxIterations Maximum number of outer iterations allowed (0 means
+   *     no limit).
+   * @param innerIterations The number of inner steps of each outer iteration,
+   *     shared among the threads (0 means the number of functions).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the function order is shuffled at every outer
+   *     iteration; otherwise, each function is visited in linear order.
+   */
+  AsyncSVRG(const double stepSize = 0.01,
+            const size_t maxIterations = 100,
+            const size_t innerIterations = 0,
+            const double tolerance = 1e-5,
+            const bool shuffle = true) :
+      stepSize(stepSize),
+      maxIterations(maxIterations),
+      innerIterations(innerIterations),
+      tolerance(tolerance),
+      shuffle(shuffle)
+  { /* Nothing to do. */ }
+
+  /**
+   * Optimize the given function using asynchronous SVRG.  The given starting
+   * point will be modified to store the finishing point of the algorithm, and
+   * the final objective value is returned.
+   *
+   * @tparam SparseFunctionType Type of function to be optimized.
+   * @param function Function to be optimized (minimized).
+   * @param iterate Starting point (will be modified).
+   * @return Objective value at the final point.
+   */
+  template<typename SparseFunctionType>
+  double Optimize(SparseFunctionType& function, arma::mat& iterate);
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of inner steps (0 indicates the number of functions).
+  size_t InnerIterations() const { return innerIterations; }
+  //! Modify the number of inner steps (0 indicates the number of functions).
+  size_t& InnerIterations() { return innerIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+ private:
+  /**
+   * Compute the full gradient at the snapshot in parallel, along with the
+   * inverse of the fraction of the functions whose gradient is non-zero at each
+   * coordinate (0 for the coordinates no function touches).
+   */
+  template<typename SparseFunctionType>
+  void Snapshot(SparseFunctionType& function,
+                const arma::mat& iterate0,
+                arma::mat& fullGradient,
+                arma::mat& inverseFrequency);
+
+  //! The step size for each inner step.
+  double stepSize;
+
+  //! The maximum number of allowed outer iterations.
+  size_t maxIterations;
+
+  //! The number of inner steps of each outer iteration.
+  size_t innerIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the individual functions are shuffled when
+  //! iterating.
+  bool shuffle;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "async_svrg_impl.hpp"
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ * @file async_svrg_impl.hpp
+ *
+ * Implementation of asynchronous stochastic variance reduced gradient.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SVRG_ASYNC_SVRG_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_SVRG_ASYNC_SVRG_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "async_svrg.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename SparseFunctionType>
+double AsyncSVRG::Optimize(SparseFunctionType& function, arma::mat& iterate)
+{
+  traits::CheckSparseFunctionTypeAPI<SparseFunctionType>();
+
+  const size_t numFunctions = function.NumFunctions();
+  const size_t actualInnerIterations = (innerIterations == 0) ?
+      numFunctions : innerIterations;
+
+  double overallObjective = DBL_MAX;
+  double lastObjective;
+
+  // The order in which the functions will be visited.
+  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
+      (numFunctions - 1), numFunctions);
+
+  arma::mat iterate0;
+  arma::mat fullGradient;
+  arma::mat inverseFrequency;
+
+  // Iterate till the objective is within tolerance or the maximum number of
+  // allowed iterations is reached.  If maxIterations is 0, this will iterate
+  // till convergence.
+  for (size_t i = 1; i != maxIterations; ++i)
+  {
+    // Calculate the overall objective.
+    lastObjective = overallObjective;
+
+    overallObjective = function.Evaluate(iterate);
+
+    // Output current objective function.
+    Log::Info << "Async SVRG: iteration " << i << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "Async SVRG: converged to " << overallObjective
+          << "; terminating with failure.  Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < tolerance)
+    {
+      Log::Info << "Async SVRG: minimized within tolerance " << tolerance
+          << "; terminating optimization." << std::endl;
+      return overallObjective;
+    }
+
+    // Take the snapshot.
+    iterate0 = iterate;
+    Snapshot(function, iterate0, fullGradient, inverseFrequency);
+
+    // Shuffle for uniform sampling of functions by each thread.
+    if (shuffle)
+    {
+      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
+          mlpack::math::randGen);
+    }
+
+    #pragma omp parallel
+    {
+      arma::sp_mat gradient, gradient0;
+
+      #pragma omp for
+      for (omp_size_t j = 0; j < (omp_size_t) actualInnerIterations; ++j)
+      {
+        const size_t f = visitationOrder[j % numFunctions];
+
+        // Both gradients are taken before touching the iterate, so a thread
+        // only ever writes single elements and never holds a lock.
+        function.Gradient(iterate, f, gradient, 1);
+        function.Gradient(iterate0, f, gradient0, 1);
+
+        for (arma::sp_mat::const_iterator cur = gradient.begin();
+            cur != gradient.end(); ++cur)
+        {
+          #pragma omp atomic
+          iterate(cur.row(), cur.col()) -= stepSize * (*cur);
+        }
+
+        // The correction is restricted to the support of the snapshot gradient
+        // and rescaled so that it is the full gradient on average.
+        for (arma::sp_mat::const_iterator cur = gradient0.begin();
+            cur != gradient0.end(); ++cur)
+        {
+          const double update = stepSize * ((*cur) -
+              fullGradient(cur.row(), cur.col()) *
+              inverseFrequency(cur.row(), cur.col()));
+
+          #pragma omp atomic
+          iterate(cur.row(), cur.col()) += update;
+        }
+      }
+    }
+  }
+
+  Log::Info << "Async SVRG: maximum iterations (" << maxIterations << ") "
+      << "reached; terminating optimization." << std::endl;
+
+  return function.Evaluate(iterate);
+}
+
+template<typename SparseFunctionType>
+void AsyncSVRG::Snapshot(SparseFunctionType& function,
+                         const arma::mat& iterate0,
+                         arma::mat& fullGradient,
+                         arma::mat& inverseFrequency)
+{
+  const size_t numFunctions = function.NumFunctions();
+
+  fullGradient.zeros(iterate0.n_rows, iterate0.n_cols);
+  arma::mat count(iterate0.n_rows, iterate0.n_cols, arma::fill::zeros);
+
+  #pragma omp parallel
+  {
+    arma::mat threadGradient(iterate0.n_rows, iterate0.n_cols,
+        arma::fill::zeros);
+    arma::mat threadCount(iterate0.n_rows, iterate0.n_cols, arma::fill::zeros);
+    arma::sp_mat gradient;
+
+    #pragma omp for
+    for (omp_size_t f = 0; f < (omp_size_t) numFunctions; ++f)
+    {
+      function.Gradient(iterate0, f, gradient, 1);
+      for (arma::sp_mat::const_iterator cur = gradient.begin();
+          cur != gradient.end(); ++cur)
+      {
+        threadGradient(cur.row(), cur.col()) += (*cur);
+        threadCount(cur.row(), cur.col()) += 1;
+      }
+    }
+
+    #pragma omp critical(asyncSVRGSnapshot)
+    {
+      fullGradient += threadGradient;
+      count += threadCount;
+    }
+  }
+
+  fullGradient /= (double) numFunctions;
+
+  inverseFrequency.zeros(iterate0.n_rows, iterate0.n_cols);
+  for (size_t k = 0; k < count.n_elem; ++k)
+  {
+    if (count[k] > 0)
+      inverseFrequency[k] = numFunctions / count[k];
+  }
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
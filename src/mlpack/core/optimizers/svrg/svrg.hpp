@@ -13,6 +13,7 @@
 #define MLPACK_CORE_OPTIMIZERS_SVRG_SVRG_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/full_gradient.hpp>
 #include <mlpack/core/optimizers/sgd/decay_policies/no_decay.hpp>
 
 #include "svrg_update.hpp"
@@ -124,6 +125,9 @@ class SVRGType
    * @param decayPolicy Instantiated decay policy used to adjust the step size.
    * @param resetPolicy Flag that determines whether update policy parameters
    *     are reset before every Optimize call.
+   * @param parallelSnapshot Whether the objective and the full gradient of each
+   *     outer iteration are computed in parallel (then the function has to be
+   *     safe to evaluate from several threads at once).
    */
   SVRGType(const double stepSize = 0.01,
            const size_t batchSize = 32,
@@ -133,7 +137,8 @@ class SVRGType
            const bool shuffle = true,
            const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
            const DecayPolicyType& decayPolicy = DecayPolicyType(),
-           const bool resetPolicy = true);
+           const bool resetPolicy = true,
+           const bool parallelSnapshot = false);
 
   /**
    * Optimize the given function using SVRG. The given starting point will be
@@ -185,6 +190,13 @@ class SVRGType
   //! are reset before Optimize call.
   bool& ResetPolicy() { return resetPolicy; }
 
+  //! Get whether the objective and the full gradient are computed in
+  //! parallel.
+  bool ParallelSnapshot() const { return parallelSnapshot; }
+  //! Modify whether the objective and the full gradient are computed in
+  //! parallel.
+  bool& ParallelSnapshot() { return parallelSnapshot; }
+
   //! Get the update policy.
   const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
   //! Modify the update policy.
@@ -224,6 +236,9 @@ class SVRGType
   //! Flag indicating whether update policy
   //! should be reset before running optimization.
   bool resetPolicy;
+
+  //! Whether the objective and the full gradient are computed in parallel.
+  bool parallelSnapshot;
 };
 
 // Convenience typedefs.
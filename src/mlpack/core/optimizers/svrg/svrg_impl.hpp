@@ -28,7 +28,8 @@ SVRGType<UpdatePolicyType, DecayPolicyType>::SVRGType(
     const bool shuffle,
     const UpdatePolicyType& updatePolicy,
     const DecayPolicyType& decayPolicy,
-    const bool resetPolicy) :
+    const bool resetPolicy,
+    const bool parallelSnapshot) :
     stepSize(stepSize),
     batchSize(batchSize),
     maxIterations(maxIterations),
@@ -37,7 +38,8 @@ SVRGType<UpdatePolicyType, DecayPolicyType>::SVRGType(
     shuffle(shuffle),
     updatePolicy(updatePolicy),
     decayPolicy(decayPolicy),
-    resetPolicy(resetPolicy)
+    resetPolicy(resetPolicy),
+    parallelSnapshot(parallelSnapshot)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
@@ -77,12 +79,8 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
   for (size_t i = 0; i < actualMaxIterations; ++i)
   {
     // Calculate the objective function.
-    overallObjective = 0;
-    for (size_t f = 0; f < numFunctions; f += batchSize)
-    {
-      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
-      overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
-    }
+    overallObjective = FullObjective(function, iterate, batchSize,
+        parallelSnapshot);
 
     if (std::isnan(overallObjective) || std::isinf(overallObjective))
     {
@@ -102,21 +100,9 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
     lastObjective = overallObjective;
 
     // Compute the full gradient.
-    size_t effectiveBatchSize = std::min(batchSize, numFunctions);
     arma::mat fullGradient(iterate.n_rows, iterate.n_cols);
-    function.Gradient(iterate, 0, fullGradient, effectiveBatchSize);
-    for (size_t f = effectiveBatchSize; f < numFunctions;
-        /* incrementing done manually */)
-    {
-      // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - f);
-
-      function.Gradient(iterate, f, gradient, effectiveBatchSize);
-      fullGradient += gradient;
-
-      f += effectiveBatchSize;
-    }
-    fullGradient /= (double) numFunctions;
+    FullGradient(function, iterate, fullGradient, gradient, batchSize,
+        parallelSnapshot);
 
     // Store current parameter for the calculation of the variance reduced
     // gradient.
@@ -136,7 +122,8 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
       }
 
       // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - currentFunction);
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - currentFunction);
 
       // Calculate variance reduced gradient.
       function.Gradient(iterate, currentFunction, gradient,
@@ -161,12 +148,8 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
       << "terminating optimization." << std::endl;
 
   // Calculate final objective.
-  overallObjective = 0;
-  for (size_t i = 0; i < numFunctions; i += batchSize)
-  {
-    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
-    overallObjective += function.Evaluate(iterate, i, effectiveBatchSize);
-  }
+  overallObjective = FullObjective(function, iterate, batchSize,
+      parallelSnapshot);
   return overallObjective;
 }
 
@@ -26,47 +26,208 @@
 #ifndef MLPACK_CORE_TREE_ADDRESS_HPP
 #define MLPACK_CORE_TREE_ADDRESS_HPP
 
+// Use the PDEP and PEXT instructions to interleave bits if the compiler was
+// given BMI2.
+#if defined(__BMI2__) && defined(__x86_64__)
+  #include <immintrin.h>
+  #define MLPACK_ADDRESS_BMI2
+#endif
+
 namespace mlpack {
 namespace bound {
 namespace addr {
 
 /**
- * Calculate the address of a point. Be careful, the point and the address
- * variables should be equal-sized and the type of the address should correspond
- * to the type of the vector.
- *
- * The function maps each floating point coordinate to an equal-sized unsigned
- * integer datatype in such a way that the transform preserves the ordering
- * (i.e. lower floating point values correspond to lower integers). Thus,
- * the mapping saves the exponent and the mantissa of each floating point value
- * consequently, furthermore the exponent is stored before the mantissa. In the
- * case of negative numbers the resulting integer value should be inverted.
- * In the multi-dimensional case, after we transform the representation, we
- * have to interleave the bits of the new representation across all the elements
- * in the address vector.
+ * Deposit the low bits of the value at the positions of the set bits of the
+ * mask, from the lowest to the highest (this is the PDEP instruction of BMI2).
+ */
+inline uint64_t DepositBits(const uint64_t value, uint64_t mask)
+{
+#ifdef MLPACK_ADDRESS_BMI2
+  return _pdep_u64(value, mask);
+#else
+  uint64_t result = 0;
+  for (uint64_t bit = 1; mask != 0; bit <<= 1)
+  {
+    const uint64_t lowest = mask & (~mask + 1);
+    if (value & bit)
+      result |= lowest;
+    mask ^= lowest;
+  }
+  return result;
+#endif
+}
+
+//! Deposit the low bits of the value at the set bits of the mask.
+inline uint32_t DepositBits(const uint32_t value, const uint32_t mask)
+{
+#ifdef MLPACK_ADDRESS_BMI2
+  return _pdep_u32(value, mask);
+#else
+  return (uint32_t) DepositBits((uint64_t) value, (uint64_t) mask);
+#endif
+}
+
+/**
+ * Gather the bits of the value at the positions of the set bits of the mask
+ * into the low bits of the result, from the lowest to the highest (this is the
+ * PEXT instruction of BMI2).
+ */
+inline uint64_t ExtractBits(const uint64_t value, uint64_t mask)
+{
+#ifdef MLPACK_ADDRESS_BMI2
+  return _pext_u64(value, mask);
+#else
+  uint64_t result = 0;
+  for (uint64_t bit = 1; mask != 0; bit <<= 1)
+  {
+    const uint64_t lowest = mask & (~mask + 1);
+    if (value & lowest)
+      result |= bit;
+    mask ^= lowest;
+  }
+  return result;
+#endif
+}
+
+//! Gather the bits of the value at the set bits of the mask.
+inline uint32_t ExtractBits(const uint32_t value, const uint32_t mask)
+{
+#ifdef MLPACK_ADDRESS_BMI2
+  return _pext_u32(value, mask);
+#else
+  return (uint32_t) ExtractBits((uint64_t) value, (uint64_t) mask);
+#endif
+}
+
+/**
+ * Interleave the bits of a number of equal-sized unsigned integers.  Bit i
+ * (counting from the most significant bit) of integer j goes to bit
+ * i * dimensionality + j of the result, where the bits of the result are
+ * counted from the most significant bit of its first element.
  *
- * @param address The resulting address.
- * @param point The point that is being translated to the address.
+ * The bits of one integer that go to one element of the result form a
+ * contiguous field, and they are spread out with a stride that only depends on
+ * the dimensionality.  So the positions of all the fields are computed once by
+ * the constructor, and each field is moved by a single deposit (or extract)
+ * instead of one bit at a time.
+ */
+template<typename AddressElemType>
+class BitInterleaver
+{
+ public:
+  //! Compute the fields for the given number of integers.
+  BitInterleaver(const size_t dimensionality) : dimensionality(dimensionality)
+  {
+    constexpr size_t order = sizeof(AddressElemType) * CHAR_BIT;
+
+    // Bits with the stride of the dimensionality, starting from bit 0.
+    AddressElemType comb = 1;
+    for (size_t k = dimensionality; k < order; k += dimensionality)
+      comb |= (AddressElemType) 1 << k;
+
+    for (size_t j = 0; j < dimensionality; j++)
+    {
+      const size_t firstRow = j / order;
+      const size_t lastRow = ((order - 1) * dimensionality + j) / order;
+      for (size_t row = firstRow; row <= lastRow; row++)
+      {
+        // The bits i of integer j with row * order <= i * dimensionality + j <
+        // (row + 1) * order.
+        const size_t lo = (row * order > j) ?
+            (row * order - j + dimensionality - 1) / dimensionality : 0;
+        const size_t hi = std::min(order - 1,
+            (row * order + order - 1 - j) / dimensionality);
+        if (lo > hi)
+          continue;
+
+        // The number of bits from the first to the last bit of the field.
+        const size_t span = (hi - lo) * dimensionality + 1;
+        Field field;
+        field.row = row;
+        field.dim = j;
+        field.shift = order - 1 - hi;
+        field.mask = (span >= order) ? comb :
+            comb & (((AddressElemType) 1 << span) - 1);
+        field.mask <<= order - 1 - (hi * dimensionality + j - row * order);
+        fields.push_back(field);
+      }
+    }
+  }
+
+  /**
+   * Interleave the bits of the given integers into the address.  Both should
+   * have dimensionality elements.
+   */
+  template<typename ValuesType, typename AddressType>
+  void Interleave(const ValuesType& values, AddressType& address) const
+  {
+    for (size_t i = 0; i < dimensionality; i++)
+      address[i] = 0;
+
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+      const Field& f = fields[i];
+      address[f.row] |= DepositBits((AddressElemType) (values[f.dim] >>
+          f.shift), f.mask);
+    }
+  }
+
+  /**
+   * Reverse Interleave(): recover the integers from the address.
+   */
+  template<typename AddressType, typename ValuesType>
+  void Deinterleave(const AddressType& address, ValuesType& values) const
+  {
+    for (size_t i = 0; i < dimensionality; i++)
+      values[i] = 0;
+
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+      const Field& f = fields[i];
+      values[f.dim] |= ExtractBits((AddressElemType) address[f.row], f.mask) <<
+          f.shift;
+    }
+  }
+
+  //! Get the number of interleaved integers.
+  size_t Dimensionality() const { return dimensionality; }
+
+ private:
+  //! The bits of one integer that go to one element of the address.
+  struct Field
+  {
+    //! The element of the address.
+    size_t row;
+    //! The integer.
+    size_t dim;
+    //! The position of the lowest bit of the field in the integer.
+    size_t shift;
+    //! The positions of the bits of the field in the element of the address.
+    AddressElemType mask;
+  };
+
+  //! The number of interleaved integers.
+  size_t dimensionality;
+  //! The fields.
+  std::vector<Field> fields;
+};
+
+/**
+ * Map each coordinate of the point to an equal-sized unsigned integer in a way
+ * that preserves the ordering, as described for PointToAddress().
  *
- * mlpack is free software; you may redistribute it and/or modify it under the
- * terms of the 3-clause BSD license.  You should have received a copy of the
- * 3-clause BSD license along with mlpack.  If not, see
- * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ * @param point The point to map.
+ * @param result The integers (one per coordinate).
  */
-template<typename AddressType, typename VecType>
-void PointToAddress(AddressType& address, const VecType& point)
+template<typename VecType, typename ResultType>
+void PointToOrderedIntegers(const VecType& point, ResultType& result)
 {
   typedef typename VecType::elem_type VecElemType;
-  // Check that the arguments are compatible.
   typedef typename std::conditional<sizeof(VecElemType) * CHAR_BIT <= 32,
                                     uint32_t,
                                     uint64_t>::type AddressElemType;
 
-  static_assert(std::is_same<typename AddressType::elem_type,
-      AddressElemType>::value == true, "The vector element type does not "
-      "correspond to the address element type.");
-  arma::Col<AddressElemType> result(point.n_elem);
-
   constexpr size_t order = sizeof(AddressElemType) * CHAR_BIT;
   // Calculate the number of bits for the exponent.
   const int numExpBits = std::ceil(std::log2(
@@ -76,9 +237,6 @@ void PointToAddress(AddressType& address, const VecType& point)
   // Calculate the number of bits for the mantissa.
   const int numMantBits = order - numExpBits - 1;
 
-  assert(point.n_elem == address.n_elem);
-  assert(address.n_elem > 0);
-
   for (size_t i = 0; i < point.n_elem; i++)
   {
     int e;
@@ -102,41 +260,168 @@ void PointToAddress(AddressType& address, const VecType& point)
 
     // Extract the mantissa.
     AddressElemType tmp = (AddressElemType) 1 << numMantBits;
-    result(i) = std::floor(normalizedVal * tmp);
+    AddressElemType value = std::floor(normalizedVal * tmp);
 
     // Add the exponent.
-    assert(result(i) < ((AddressElemType) 1 << numMantBits));
-    result(i) |= ((AddressElemType)
+    assert(value < ((AddressElemType) 1 << numMantBits));
+    value |= ((AddressElemType)
         (e - std::numeric_limits<VecElemType>::min_exponent)) << numMantBits;
 
-    assert(result(i) < ((AddressElemType) 1 << (order - 1)) - 1);
+    assert(value < ((AddressElemType) 1 << (order - 1)) - 1);
 
     // Negative values should be inverted.
     if (sgn)
     {
-      result(i) = ((AddressElemType) 1 << (order - 1)) - 1 - result(i);
-      assert((result(i) >> (order - 1)) == 0);
+      value = ((AddressElemType) 1 << (order - 1)) - 1 - value;
+      assert((value >> (order - 1)) == 0);
     }
     else
     {
-      result(i) |= (AddressElemType) 1 << (order - 1);
-      assert((result(i) >> (order - 1)) == 1);
+      value |= (AddressElemType) 1 << (order - 1);
+      assert((value >> (order - 1)) == 1);
     }
+
+    result[i] = value;
   }
+}
+
+/**
+ * Calculate the address of a point. Be careful, the point and the address
+ * variables should be equal-sized and the type of the address should correspond
+ * to the type of the vector.
+ *
+ * The function maps each floating point coordinate to an equal-sized unsigned
+ * integer datatype in such a way that the transform preserves the ordering
+ * (i.e. lower floating point values correspond to lower integers). Thus,
+ * the mapping saves the exponent and the mantissa of each floating point value
+ * consequently, furthermore the exponent is stored before the mantissa. In the
+ * case of negative numbers the resulting integer value should be inverted.
+ * In the multi-dimensional case, after we transform the representation, we
+ * have to interleave the bits of the new representation across all the elements
+ * in the address vector.
+ *
+ * @param address The resulting address.
+ * @param point The point that is being translated to the address.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+template<typename AddressType, typename VecType>
+void PointToAddress(AddressType& address, const VecType& point)
+{
+  typedef typename VecType::elem_type VecElemType;
+  // Check that the arguments are compatible.
+  typedef typename std::conditional<sizeof(VecElemType) * CHAR_BIT <= 32,
+                                    uint32_t,
+                                    uint64_t>::type AddressElemType;
+
+  static_assert(std::is_same<typename AddressType::elem_type,
+      AddressElemType>::value == true, "The vector element type does not "
+      "correspond to the address element type.");
+
+  assert(point.n_elem == address.n_elem);
+  assert(address.n_elem > 0);
 
-  address.zeros(point.n_elem);
+  arma::Col<AddressElemType> result(point.n_elem);
+  PointToOrderedIntegers(point, result);
 
   // Interleave the bits of the new representation across all the elements
   // in the address vector.
-  for (size_t i = 0; i < order; i++)
-    for (size_t j = 0; j < point.n_elem; j++)
+  BitInterleaver<AddressElemType>(point.n_elem).Interleave(result, address);
+}
+
+/**
+ * Calculate the addresses of all the points (columns) of the dataset, as
+ * PointToAddress() does.  The bit layout is only computed once, and the points
+ * are processed in parallel.
+ *
+ * @param addresses The resulting addresses, one column per point.
+ * @param points The points that are being translated to addresses.
+ */
+template<typename AddressMatType, typename MatType>
+void PointsToAddresses(AddressMatType& addresses, const MatType& points)
+{
+  typedef typename MatType::elem_type ElemType;
+  typedef typename std::conditional<sizeof(ElemType) * CHAR_BIT <= 32,
+                                    uint32_t,
+                                    uint64_t>::type AddressElemType;
+
+  static_assert(std::is_same<typename AddressMatType::elem_type,
+      AddressElemType>::value == true, "The matrix element type does not "
+      "correspond to the address element type.");
+
+  addresses.set_size(points.n_rows, points.n_cols);
+  const BitInterleaver<AddressElemType> interleaver(points.n_rows);
+
+  #pragma omp parallel
+  {
+    arma::Col<AddressElemType> result(points.n_rows);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) points.n_cols; i++)
     {
-      size_t bit = (i * point.n_elem + j) % order;
-      size_t row = (i * point.n_elem + j) / order;
+      PointToOrderedIntegers(points.col(i), result);
+      AddressElemType* address = addresses.colptr(i);
+      interleaver.Interleave(result, address);
+    }
+  }
+}
+
+/**
+ * Sort the addresses (columns) in ascending order.  This is a least significant
+ * digit radix sort on bytes, so it takes linear time in the number of
+ * addresses; a pass is skipped if all addresses have the same byte there.  The
+ * sort is stable.
+ *
+ * @param addresses The addresses to sort, one per column.
+ * @param order The indices of the addresses in sorted order.
+ */
+template<typename AddressElemType>
+void SortAddresses(const arma::Mat<AddressElemType>& addresses,
+                   std::vector<size_t>& order)
+{
+  const size_t n = addresses.n_cols;
+  order.resize(n);
+  for (size_t i = 0; i < n; i++)
+    order[i] = i;
+
+  if (n < 2)
+    return;
+
+  std::vector<size_t> buffer(n);
+  std::vector<size_t> offsets(256);
 
-      address(row) |= (((result(j) >> (order - 1 - i)) & 1) <<
-          (order - 1 - bit));
+  // The first element of an address is the most significant one.
+  for (size_t row = addresses.n_rows; row-- > 0; )
+  {
+    for (size_t shift = 0; shift < sizeof(AddressElemType) * CHAR_BIT;
+        shift += 8)
+    {
+      // The histogram doesn't depend on the order of the addresses.
+      std::fill(offsets.begin(), offsets.end(), 0);
+      for (size_t i = 0; i < n; i++)
+        ++offsets[(addresses(row, i) >> shift) & 0xFF];
+
+      if (offsets[(addresses(row, 0) >> shift) & 0xFF] == n)
+        continue;
+
+      size_t sum = 0;
+      for (size_t b = 0; b < offsets.size(); b++)
+      {
+        const size_t count = offsets[b];
+        offsets[b] = sum;
+        sum += count;
+      }
+
+      for (size_t i = 0; i < n; i++)
+        buffer[offsets[(addresses(row, order[i]) >> shift) & 0xFF]++] =
+            order[i];
+
+      order.swap(buffer);
     }
+  }
 }
 
 /**
@@ -176,15 +461,8 @@ void AddressToPoint(VecType& point, const AddressType& address)
   // Calculate the number of bits for the mantissa.
   const int numMantBits = order - numExpBits - 1;
 
-  for (size_t i = 0; i < order; i++)
-    for (size_t j = 0; j < address.n_elem; j++)
-    {
-      size_t bit = (i * address.n_elem + j) % order;
-      size_t row = (i * address.n_elem + j) / order;
-
-      rearrangedAddress(j) |= (((address(row) >> (order - 1 - bit)) & 1) <<
-          (order - 1 - i));
-    }
+  BitInterleaver<AddressElemType>(address.n_elem).Deinterleave(address,
+      rearrangedAddress);
 
   for (size_t i = 0; i < rearrangedAddress.n_elem; i++)
   {
@@ -0,0 +1,80 @@
+/**
+ * @file base_case_block.hpp
+ *
+ * Dispatch of the base cases between two leaves to RuleType::BaseCaseBlock(),
+ * for the rules that provide it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BASE_CASE_BLOCK_HPP
+#define MLPACK_CORE_TREE_BASE_CASE_BLOCK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace tree {
+
+HAS_MEM_FUNC(BaseCaseBlock, HasBaseCaseBlockCheck);
+
+/**
+ * HasBaseCaseBlock<RuleType, TreeType>::value is true if the rule can evaluate
+ * all the base cases between a query leaf and a reference leaf at once, with a
+ * method of the form
+ *
+ *   size_t BaseCaseBlock(TreeType& queryLeaf, TreeType& referenceLeaf);
+ *
+ * It has to give the same results as calling Score(queryIndex, referenceLeaf)
+ * for each query point and BaseCase() between each query point that is not
+ * pruned and each reference point, and it returns the number of base cases
+ * that were considered.
+ */
+template<typename RuleType, typename TreeType>
+struct HasBaseCaseBlock
+{
+  static const bool value = HasBaseCaseBlockCheck<RuleType,
+      size_t(RuleType::*)(TreeType&, TreeType&)>::value;
+};
+
+/**
+ * Evaluate the base cases between the two given leaves with
+ * RuleType::BaseCaseBlock(), and add their number to numBaseCases.
+ *
+ * @return true, since the base cases were evaluated.
+ */
+template<typename RuleType, typename TreeType>
+typename std::enable_if<HasBaseCaseBlock<RuleType, TreeType>::value,
+    bool>::type
+BaseCaseBlock(RuleType& rule,
+              TreeType& queryLeaf,
+              TreeType& referenceLeaf,
+              size_t& numBaseCases)
+{
+  numBaseCases += rule.BaseCaseBlock(queryLeaf, referenceLeaf);
+  return true;
+}
+
+/**
+ * The rule has no BaseCaseBlock(), so the traverser has to evaluate the base
+ * cases itself.
+ *
+ * @return false.
+ */
+template<typename RuleType, typename TreeType>
+typename std::enable_if<!HasBaseCaseBlock<RuleType, TreeType>::value,
+    bool>::type
+BaseCaseBlock(RuleType& /* rule */,
+              TreeType& /* queryLeaf */,
+              TreeType& /* referenceLeaf */,
+              size_t& /* numBaseCases */)
+{
+  return false;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,7 @@
 
 #include "../statistic.hpp"
 #include "midpoint_split.hpp"
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -88,6 +89,11 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! If PackNodes() was called on this node, the nodes below it, stored
+  //! contiguously; otherwise NULL.  This node owns the block.
+  BinarySpaceTree* packedNodes;
+  //! The number of nodes in packedNodes.
+  size_t numPackedNodes;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -492,7 +498,40 @@ class BinarySpaceTree
   //! Store the center of the bounding region in the given vector.
   void Center(arma::vec& center) const { bound.Center(center); }
 
+  /**
+   * Move every node below this one into one contiguous block of memory, in
+   * depth-first (preorder) order, so that a traversal walks through memory
+   * mostly forwards instead of jumping between separate allocations.  The left
+   * child of each node directly follows it.  The structure of the tree, the
+   * bounds and the statistics are unchanged, so the tree can be used exactly as
+   * before.  Since the addresses of the nodes below the root change, the
+   * statistics are built again, so this should be called after construction
+   * and before the tree is used.  Packing a tree twice does nothing.
+   *
+   * This is usually called on the root of the tree, and must not be called on
+   * a node that is itself in a packed block.  The block belongs to this node,
+   * so the packed nodes must not be deleted individually.
+   */
+  void PackNodes();
+
+  //! Return whether the nodes below this one were packed with PackNodes().
+  bool IsPacked() const { return packedNodes != NULL; }
+
+  /**
+   * Recompute the bounds, the distances and the statistics of this node and
+   * every node below it for the current values of the points in Dataset(),
+   * without changing which points each node holds.  This is useful when the
+   * points have moved (for instance, when they are transformed by a slowly
+   * changing linear map): the tree is then valid again for any search, without
+   * being built again, although its splits may be worse than those of a new
+   * tree.
+   */
+  void RefitBounds();
+
  private:
+  //! Delete the children of this node, whether they are packed or not.
+  void DeleteChildren();
+
   /**
    * Splits the current node, assigning its left and right children recursively.
    *
@@ -514,6 +553,52 @@ class BinarySpaceTree
                  const size_t maxLeafSize,
                  SplitType<BoundType<MetricType>, MatType>& splitter);
 
+  /**
+   * Construct a child node of the given parent without splitting it yet.  This
+   * is used by ParallelSplitNode(), which splits the node afterwards.
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of point to start tree construction with.
+   * @param count Number of points to use to construct tree.
+   */
+  BinarySpaceTree(BinarySpaceTree* parent,
+                  const size_t begin,
+                  const size_t count);
+
+  /**
+   * Split the current node like SplitNode(), but build the tree in parallel:
+   * the top of the tree is split serially until there are a few subtrees for
+   * every thread, and then the subtrees are built concurrently.  This is only
+   * used for the root of a large tree, and only if IsParallelSplit is true for
+   * the split type.
+   *
+   * @param oldFromNew Vector holding permuted indices, or NULL if they aren't
+   *     needed.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  void ParallelSplitNode(std::vector<size_t>* oldFromNew,
+                         const size_t maxLeafSize,
+                         SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  /**
+   * Compute the bound of the current node and split it once, creating children
+   * that are not split yet.
+   *
+   * @param oldFromNew Vector holding permuted indices, or NULL if they aren't
+   *     needed.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   * @return Whether the node was split.
+   */
+  bool SplitOnce(std::vector<size_t>* oldFromNew,
+                 const size_t maxLeafSize,
+                 SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  //! Compute the distances from the center of this node to the centers of its
+  //! children.
+  void SetChildParentDistances();
+
   /**
    * Update the bound of the current node. This method does not take into
    * account bound-specific properties.
@@ -531,6 +616,14 @@ class BinarySpaceTree
    */
   void UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate);
 
+  /**
+   * Update the bound of the current node.  This method is designed for
+   * HRectBound only; the bound of a large node is computed in parallel.
+   *
+   * @param boundToUpdate The bound to update.
+   */
+  void UpdateBound(bound::HRectBound<MetricType>& boundToUpdate);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -543,6 +636,9 @@ class BinarySpaceTree
   //! Friend access is given for the default constructor.
   friend class boost::serialization::access;
 
+  //! FlatTreeAccess reads and writes the flat on-disk layout of the tree.
+  template<typename> friend class FlatTreeAccess;
+
  public:
   /**
    * Serialize the tree.
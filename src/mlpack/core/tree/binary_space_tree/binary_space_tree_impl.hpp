@@ -17,6 +17,11 @@
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/log.hpp>
 #include <queue>
+#include <stack>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace tree {
@@ -40,7 +45,9 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -68,7 +75,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -102,7 +111,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -137,7 +148,9 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -165,7 +178,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -199,7 +214,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -238,7 +255,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -267,7 +286,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -301,7 +322,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -342,7 +365,9 @@ BinarySpaceTree(
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -400,7 +425,9 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    packedNodes(other.packedNodes),
+    numPackedNodes(other.numPackedNodes)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -412,6 +439,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.packedNodes = NULL;
+  other.numPackedNodes = 0;
 
   // Set new parent.
   if (left)
@@ -455,8 +484,7 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  DeleteChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
@@ -747,6 +775,16 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     SplitNode(const size_t maxLeafSize,
               SplitType<BoundType<MetricType>, MatType>& splitter)
 {
+  #ifdef HAS_OPENMP
+  // Large trees are built in parallel, if the split type allows it.
+  if (IsParallelSplit<Split>::value && parent == NULL && count >= 100000 &&
+      omp_get_max_threads() > 1)
+  {
+    ParallelSplitNode(NULL, maxLeafSize, splitter);
+    return;
+  }
+  #endif
+
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
 
@@ -789,17 +827,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
       splitter, maxLeafSize);
 
   // Calculate parent distances for those two nodes.
-  arma::vec center, leftCenter, rightCenter;
-  Center(center);
-  left->Center(leftCenter);
-  right->Center(rightCenter);
-
-  const ElemType leftParentDistance = MetricType::Evaluate(center, leftCenter);
-  const ElemType rightParentDistance = MetricType::Evaluate(center,
-      rightCenter);
-
-  left->ParentDistance() = leftParentDistance;
-  right->ParentDistance() = rightParentDistance;
+  SetChildParentDistances();
 }
 
 template<typename MetricType,
@@ -813,6 +841,16 @@ SplitNode(std::vector<size_t>& oldFromNew,
           const size_t maxLeafSize,
           SplitType<BoundType<MetricType>, MatType>& splitter)
 {
+  #ifdef HAS_OPENMP
+  // Large trees are built in parallel, if the split type allows it.
+  if (IsParallelSplit<Split>::value && parent == NULL && count >= 100000 &&
+      omp_get_max_threads() > 1)
+  {
+    ParallelSplitNode(&oldFromNew, maxLeafSize, splitter);
+    return;
+  }
+  #endif
+
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
 
@@ -856,6 +894,163 @@ SplitNode(std::vector<size_t>& oldFromNew,
       oldFromNew, splitter, maxLeafSize);
 
   // Calculate parent distances for those two nodes.
+  SetChildParentDistances();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(
+    BinarySpaceTree* parent,
+    const size_t begin,
+    const size_t count) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    begin(begin),
+    count(count),
+    bound(parent->Dataset().n_rows),
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
+{
+  // The node is split later by ParallelSplitNode().
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelSplitNode(std::vector<size_t>* oldFromNew,
+                  const size_t maxLeafSize,
+                  SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Split the largest node serially until there are a few subtrees for every
+  // thread, so that the threads stay busy even if the splits are unbalanced.
+  // The nodes that were split are kept in order, so that they can be finished
+  // from the bottom up once their children are built.
+  std::vector<BinarySpaceTree*> subtrees(1, this);
+  std::vector<BinarySpaceTree*> splitNodes;
+  std::vector<BinarySpaceTree*> leaves;
+  while (!subtrees.empty() && subtrees.size() < 4 * numThreads)
+  {
+    typename std::vector<BinarySpaceTree*>::iterator largest =
+        std::max_element(subtrees.begin(), subtrees.end(),
+        [](const BinarySpaceTree* a, const BinarySpaceTree* b)
+        {
+          return a->count < b->count;
+        });
+
+    // It isn't worth splitting small subtrees serially.
+    if ((*largest)->count < 1000)
+      break;
+
+    BinarySpaceTree* node = *largest;
+    subtrees.erase(largest);
+    if (node->SplitOnce(oldFromNew, maxLeafSize, splitter))
+    {
+      splitNodes.push_back(node);
+      subtrees.push_back(node->left);
+      subtrees.push_back(node->right);
+    }
+    else
+    {
+      leaves.push_back(node);
+    }
+  }
+
+  // Each subtree only rearranges its own columns of the dataset and of
+  // oldFromNew, so they can all be built at once.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    BinarySpaceTree* node = subtrees[i];
+    if (oldFromNew)
+      node->SplitNode(*oldFromNew, maxLeafSize, splitter);
+    else
+      node->SplitNode(maxLeafSize, splitter);
+
+    // The root's statistic is created by its constructor.
+    if (node != this)
+      node->stat = StatisticType(*node);
+  }
+
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    if (leaves[i] != this)
+      leaves[i]->stat = StatisticType(*leaves[i]);
+  }
+
+  for (size_t i = splitNodes.size(); i > 0; --i)
+  {
+    BinarySpaceTree* node = splitNodes[i - 1];
+    node->SetChildParentDistances();
+    if (node != this)
+      node->stat = StatisticType(*node);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+SplitOnce(std::vector<size_t>* oldFromNew,
+          const size_t maxLeafSize,
+          SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  // We need to expand the bounds of this node properly.
+  UpdateBound(bound);
+
+  // Calculate the furthest descendant distance.
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // First, check if we need to split at all.
+  if (count <= maxLeafSize)
+    return false;
+
+  // Find the partition of the node. This method does not perform the split.
+  typename Split::SplitInfo splitInfo;
+  if (!splitter.SplitNode(bound, *dataset, begin, count, splitInfo))
+    return false;
+
+  // Perform the actual splitting, but leave the children unsplit.
+  const size_t splitCol = (oldFromNew == NULL) ?
+      splitter.PerformSplit(*dataset, begin, count, splitInfo) :
+      splitter.PerformSplit(*dataset, begin, count, splitInfo, *oldFromNew);
+
+  assert(splitCol > begin);
+  assert(splitCol < begin + count);
+
+  left = new BinarySpaceTree(this, begin, splitCol - begin);
+  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol);
+
+  return true;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+SetChildParentDistances()
+{
   arma::vec center, leftCenter, rightCenter;
   Center(center);
   left->Center(leftCenter);
@@ -909,6 +1104,182 @@ UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate)
     boundToUpdate |= dataset->cols(begin, begin + count - 1);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+UpdateBound(bound::HRectBound<MetricType>& boundToUpdate)
+{
+  if (count == 0)
+    return;
+
+  #ifdef HAS_OPENMP
+  // The bounds of the nodes near the root of a large tree are computed by all
+  // the threads, each one finding the bound of some blocks of points.
+  const size_t blockSize = 16384;
+  if (count >= 4 * blockSize && !omp_in_parallel())
+  {
+    const size_t numBlocks = (count + blockSize - 1) / blockSize;
+
+    #pragma omp parallel
+    {
+      bound::HRectBound<MetricType> threadBound(dataset->n_rows);
+
+      #pragma omp for
+      for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+      {
+        const size_t first = begin + b * blockSize;
+        const size_t last = std::min(first + blockSize, begin + count) - 1;
+        threadBound |= dataset->cols(first, last);
+      }
+
+      #pragma omp critical(binarySpaceTreeBound)
+      boundToUpdate |= threadBound;
+    }
+
+    return;
+  }
+  #endif
+
+  boundToUpdate |= dataset->cols(begin, begin + count - 1);
+}
+
+/**
+ * Move every node below this one into one contiguous block, in preorder.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    PackNodes()
+{
+  if (packedNodes || !left)
+    return;
+
+  // Find the nodes below this one in preorder.
+  std::vector<BinarySpaceTree*> nodes;
+  std::stack<BinarySpaceTree*> stack;
+  if (right)
+    stack.push(right);
+  stack.push(left);
+  while (!stack.empty())
+  {
+    BinarySpaceTree* node = stack.top();
+    stack.pop();
+    nodes.push_back(node);
+
+    // A subtree that is already packed keeps its own block.
+    if (node->packedNodes)
+      continue;
+
+    if (node->right)
+      stack.push(node->right);
+    if (node->left)
+      stack.push(node->left);
+  }
+
+  BinarySpaceTree* block = static_cast<BinarySpaceTree*>(
+      ::operator new(nodes.size() * sizeof(BinarySpaceTree)));
+
+  // Parents come before their children, so when a node is moved its parent is
+  // already in the block.  The move constructor points the children at the new
+  // node; the parent has to be pointed at it here.
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    BinarySpaceTree* node = new (block + i) BinarySpaceTree(
+        std::move(*nodes[i]));
+    if (node->parent->left == nodes[i])
+      node->parent->left = node;
+    else
+      node->parent->right = node;
+
+    delete nodes[i];
+  }
+
+  packedNodes = block;
+  numPackedNodes = nodes.size();
+
+  // Statistics may hold pointers to the nodes, so build them again, children
+  // first.
+  for (size_t i = numPackedNodes; i > 0; --i)
+    packedNodes[i - 1].stat = StatisticType(packedNodes[i - 1]);
+  stat = StatisticType(*this);
+}
+
+/**
+ * Recompute the bounds of this node and every node below it for the current
+ * points.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    RefitBounds()
+{
+  // The nodes are visited in the same order as during construction, since some
+  // bounds depend on the bound of the sibling on the left.
+  bound = BoundType<MetricType>(dataset->n_rows);
+  UpdateBound(bound);
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  if (left)
+  {
+    left->RefitBounds();
+    right->RefitBounds();
+    SetChildParentDistances();
+  }
+
+  // The statistic may depend on the bound, so build it again once the children
+  // are done.
+  stat = StatisticType(*this);
+}
+
+/**
+ * Delete the children of this node.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeleteChildren()
+{
+  if (packedNodes)
+  {
+    // The nodes of the block are destroyed here, so they must not delete each
+    // other.
+    for (size_t i = 0; i < numPackedNodes; ++i)
+    {
+      packedNodes[i].left = NULL;
+      packedNodes[i].right = NULL;
+    }
+    for (size_t i = 0; i < numPackedNodes; ++i)
+      packedNodes[i].~BinarySpaceTree();
+    ::operator delete(packedNodes);
+
+    packedNodes = NULL;
+    numPackedNodes = 0;
+    left = NULL;
+    right = NULL;
+  }
+
+  delete left;
+  delete right;
+  left = NULL;
+  right = NULL;
+}
+
 // Default constructor (private), for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -926,7 +1297,9 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Nothing to do.
 }
@@ -947,10 +1320,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    DeleteChildren();
     if (!parent)
       delete dataset;
 
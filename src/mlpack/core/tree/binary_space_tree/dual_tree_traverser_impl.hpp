@@ -17,6 +17,8 @@
 // In case it hasn't been included yet.
 #include "dual_tree_traverser.hpp"
 
+#include <mlpack/core/tree/base_case_block.hpp>
+
 namespace mlpack {
 namespace tree {
 
@@ -56,9 +58,13 @@ DualTreeTraverser<RuleType>::Traverse(
   // Store the current traversal info.
   traversalInfo = rule.TraversalInfo();
 
-  // If both are leaves, we must evaluate the base case.
+  // If both are leaves, we must evaluate the base case.  The rule may be able
+  // to do it for the whole pair of leaves at once.
   if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
+    if (BaseCaseBlock(rule, queryNode, referenceNode, numBaseCases))
+      return;
+
     // Loop through each of the points in each node.
     const size_t queryEnd = queryNode.Begin() + queryNode.Count();
     const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
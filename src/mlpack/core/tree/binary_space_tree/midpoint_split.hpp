@@ -17,6 +17,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/perform_split.hpp>
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -119,6 +120,14 @@ class MidpointSplit
   }
 };
 
+//! MidpointSplit is stateless and only rearranges the points of the node it
+//! splits.
+template<typename BoundType, typename MatType>
+struct IsParallelSplit<MidpointSplit<BoundType, MatType>>
+{
+  static const bool value = true;
+};
+
 } // namespace tree
 } // namespace mlpack
 
@@ -0,0 +1,34 @@
+/**
+ * @file split_traits.hpp
+ *
+ * A trait class that tells whether the nodes of a BinarySpaceTree that uses a
+ * given split type may be split concurrently.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * IsParallelSplit<SplitType>::value is true if disjoint nodes can be split by
+ * the given split type at the same time: the split must not draw random
+ * numbers or keep state, and must only touch the points of the node it splits.
+ * BinarySpaceTree then builds large trees in parallel.  The default is false,
+ * so custom split types are always used serially.
+ */
+template<typename SplitType>
+struct IsParallelSplit
+{
+  static const bool value = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -96,19 +96,12 @@ class UBTreeSplit
   std::vector<std::pair<arma::Col<AddressElemType>, size_t>> addresses;
 
   /**
-   * Calculate addresses for all points in the dataset.
+   * Calculate addresses for all points in the dataset, and sort them in
+   * ascending order.
    *
    * @param data The dataset used by the binary space tree.
    */
   void InitializeAddresses(const MatType& data);
-
-  //! A comparator for sorting addresses.
-  static bool ComparePair(
-      const std::pair<arma::Col<AddressElemType>, size_t>& p1,
-      const std::pair<arma::Col<AddressElemType>, size_t>& p2)
-  {
-    return bound::addr::CompareAddresses(p1.first, p2.first) < 0;
-  }
 };
 
 } // namespace tree
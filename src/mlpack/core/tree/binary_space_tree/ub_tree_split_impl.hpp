@@ -29,13 +29,9 @@ bool UBTreeSplit<BoundType, MatType>::SplitNode(BoundType& bound,
   constexpr size_t order = sizeof(AddressElemType) * CHAR_BIT;
   if (begin == 0 && count == data.n_cols)
   {
-    // Calculate all addresses.
+    // Calculate all addresses, in sorted order.
     InitializeAddresses(data);
 
-    // Probably this is not a good idea. Maybe it is better to get
-    // a number of distinct samples and find the median.
-    std::sort(addresses.begin(), addresses.end(), ComparePair);
-
     // Save the vector in order to rearrange the dataset later.
     splitInfo.addresses = &addresses;
   }
@@ -145,14 +141,19 @@ bool UBTreeSplit<BoundType, MatType>::SplitNode(BoundType& bound,
 template<typename BoundType, typename MatType>
 void UBTreeSplit<BoundType, MatType>::InitializeAddresses(const MatType& data)
 {
-  addresses.resize(data.n_cols);
+  // Calculate all addresses at once and sort them with a radix sort, which
+  // takes linear time.
+  arma::Mat<AddressElemType> allAddresses;
+  bound::addr::PointsToAddresses(allAddresses, data);
 
-  // Calculate all addresses.
+  std::vector<size_t> order;
+  bound::addr::SortAddresses(allAddresses, order);
+
+  addresses.resize(data.n_cols);
   for (size_t i = 0; i < data.n_cols; i++)
   {
-    addresses[i].first.zeros(data.n_rows);
-    bound::addr::PointToAddress(addresses[i].first, data.col(i));
-    addresses[i].second = i;
+    addresses[i].first = allAddresses.col(order[i]);
+    addresses[i].second = order[i];
   }
 }
 
@@ -14,6 +14,10 @@
 
 #include <boost/math/distributions/normal.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -26,14 +30,14 @@ CosineTree::CosineTree(const arma::mat& dataset) :
 {
   // Initialize sizes of column indices and l2 norms.
   indices.resize(numColumns);
-  l2NormsSquared.zeros(numColumns);
+  l2NormsSquared.set_size(numColumns);
 
   // Set indices and calculate squared norms of the columns.
-  for (size_t i = 0; i < numColumns; i++)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     indices[i] = i;
-    double l2Norm = arma::norm(dataset.col(i), 2);
-    l2NormsSquared(i) = l2Norm * l2Norm;
+    l2NormsSquared(i) = arma::dot(dataset.col(i), dataset.col(i));
   }
 
   // Frobenius norm of columns in the node.
@@ -42,6 +46,7 @@ CosineTree::CosineTree(const arma::mat& dataset) :
   // Calculate centroid of columns in the node.
   CalculateCentroid();
 
+  CalculateDistribution();
   splitPointIndex = ColumnSampleLS();
 }
 
@@ -70,6 +75,7 @@ CosineTree::CosineTree(CosineTree& parentNode,
   // Calculate centroid of columns in the node.
   CalculateCentroid();
 
+  CalculateDistribution();
   splitPointIndex = ColumnSampleLS();
 }
 
@@ -123,27 +129,35 @@ CosineTree::CosineTree(const arma::mat& dataset,
     currentLeft = currentNode->Left();
     currentRight = currentNode->Right();
 
+    // Gather the basis vectors of the queue once, with two more columns for
+    // the basis vectors of the children.  These are zero until the vectors are
+    // computed, so they don't change the projections in the meantime.
+    arma::mat currentBasis;
+    QueueBasis(treeQueue, currentBasis, 2);
+
     // Calculate basis vectors of left and right children.
     arma::vec lBasisVector, rBasisVector;
 
-    ModifiedGramSchmidt(treeQueue, currentLeft->Centroid(), lBasisVector);
-    ModifiedGramSchmidt(treeQueue, currentRight->Centroid(), rBasisVector,
-                        &lBasisVector);
+    ModifiedGramSchmidt(currentBasis, currentLeft->Centroid(), lBasisVector);
+    currentBasis.col(treeQueue.size()) = lBasisVector;
+    ModifiedGramSchmidt(currentBasis, currentRight->Centroid(), rBasisVector);
+    currentBasis.col(treeQueue.size() + 1) = rBasisVector;
 
     // Add basis vectors to their respective nodes.
     currentLeft->BasisVector(lBasisVector);
     currentRight->BasisVector(rBasisVector);
 
     // Calculate Monte Carlo error estimates for child nodes.
-    MonteCarloError(currentLeft, treeQueue, &lBasisVector, &rBasisVector);
-    MonteCarloError(currentRight, treeQueue, &lBasisVector, &rBasisVector);
+    MonteCarloError(currentLeft, currentBasis);
+    MonteCarloError(currentRight, currentBasis);
 
     // Push child nodes into the priority queue.
     treeQueue.push(currentLeft);
     treeQueue.push(currentRight);
 
-    // Calculate Monte Carlo error estimate for the root node.
-    monteCarloError = MonteCarloError(&root, treeQueue);
+    // Calculate Monte Carlo error estimate for the root node.  The basis of the
+    // queue is now exactly currentBasis.
+    monteCarloError = MonteCarloError(&root, currentBasis);
   }
 
   // Construct the subspace basis from the current priority queue.
@@ -163,39 +177,51 @@ void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
                                      arma::vec& newBasisVector,
                                      arma::vec* addBasisVector)
 {
-  // Set new basis vector to centroid.
-  newBasisVector = centroid;
-
-  // Variables for iterating throught the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
-
-  // For every vector in the current basis, remove its projection from the
-  // centroid.
-  for ( ; i != treeQueue.end(); i++)
-  {
-    currentNode = *i;
+  arma::mat currentBasis;
+  QueueBasis(treeQueue, currentBasis, addBasisVector ? 1 : 0);
+  if (addBasisVector)
+    currentBasis.col(treeQueue.size()) = *addBasisVector;
 
-    double projection = arma::dot(currentNode->BasisVector(), centroid);
-    newBasisVector -= projection * currentNode->BasisVector();
-  }
+  ModifiedGramSchmidt(currentBasis, centroid, newBasisVector);
+}
 
-  // If additional basis vector is passed, take it into account.
-  if (addBasisVector)
-  {
-    double projection = arma::dot(*addBasisVector, centroid);
-    newBasisVector -= *addBasisVector * projection;
-  }
+void CosineTree::ModifiedGramSchmidt(const arma::mat& currentBasis,
+                                     const arma::vec& centroid,
+                                     arma::vec& newBasisVector)
+{
+  // Remove the projection of the centroid on every vector of the current
+  // basis, with two matrix-vector products.
+  newBasisVector = centroid;
+  if (currentBasis.n_cols > 0)
+    newBasisVector -= currentBasis * (currentBasis.t() * centroid);
 
   // Normalize the modified centroid vector.
-  if (arma::norm(newBasisVector, 2))
-    newBasisVector /= arma::norm(newBasisVector, 2);
+  const double norm = arma::norm(newBasisVector, 2);
+  if (norm)
+    newBasisVector /= norm;
 }
 
 double CosineTree::MonteCarloError(CosineTree* node,
                                    CosineNodeQueue& treeQueue,
                                    arma::vec* addBasisVector1,
                                    arma::vec* addBasisVector2)
+{
+  // The additional basis vectors are only used if both are passed.
+  const bool addVectors = (addBasisVector1 && addBasisVector2);
+
+  arma::mat currentBasis;
+  QueueBasis(treeQueue, currentBasis, addVectors ? 2 : 0);
+  if (addVectors)
+  {
+    currentBasis.col(treeQueue.size()) = *addBasisVector1;
+    currentBasis.col(treeQueue.size() + 1) = *addBasisVector2;
+  }
+
+  return MonteCarloError(node, currentBasis);
+}
+
+double CosineTree::MonteCarloError(CosineTree* node,
+                                   const arma::mat& currentBasis)
 {
   std::vector<size_t> sampledIndices;
   arma::vec probabilities;
@@ -205,57 +231,28 @@ double CosineTree::MonteCarloError(CosineTree* node,
   size_t numSamples = log(node->NumColumns()) + 1;
   node->ColumnSamplesLS(sampledIndices, probabilities, numSamples);
 
-  // Get pointer to the original dataset.
-  arma::mat dataset = node->GetDataset();
+  // Calculate the squared norm of the projection of each sample onto the
+  // current basis, all at once.  Only the sampled columns are copied.
+  const arma::mat& dataset = node->GetDataset();
+  arma::uvec sampledColumns(numSamples);
+  for (size_t i = 0; i < numSamples; i++)
+    sampledColumns[i] = sampledIndices[i];
 
-  // Initialize weighted projection magnitudes as zeros.
   arma::vec weightedMagnitudes;
-  weightedMagnitudes.zeros(numSamples);
-
-  // Set size of projection vector, depending on whether additional basis
-  // vectors are passed.
-  size_t projectionSize;
-  if (addBasisVector1 && addBasisVector2)
-    projectionSize = treeQueue.size() + 2;
+  if (currentBasis.n_cols > 0)
+  {
+    const arma::mat projections = currentBasis.t() *
+        dataset.cols(sampledColumns);
+    weightedMagnitudes = arma::sum(arma::square(projections), 0).t();
+  }
   else
-    projectionSize = treeQueue.size();
-
-  // For each sample, calculate the weighted projection onto the current basis.
-  for (size_t i = 0; i < numSamples; i++)
   {
-    // Initialize projection as a vector of zeros.
-    arma::vec projection;
-    projection.zeros(projectionSize);
-
-    CosineTree *currentNode;
-    CosineNodeQueue::const_iterator j = treeQueue.begin();
-
-    size_t k = 0;
-    // Compute the projection of the sampled vector onto the existing subspace.
-    for ( ; j != treeQueue.end(); j++, k++)
-    {
-      currentNode = *j;
-
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
-    }
-    // If two additional vectors are passed, take their projections.
-    if (addBasisVector1 && addBasisVector2)
-    {
-      projection(k++) = arma::dot(dataset.col(sampledIndices[i]),
-                                  *addBasisVector1);
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                *addBasisVector2);
-    }
-
-    // Calculate the Frobenius norm squared of the projected vector.
-    double frobProjection = arma::norm(projection, "frob");
-    double frobProjectionSquared = frobProjection * frobProjection;
-
-    // Calculate the weighted projection magnitude.
-    weightedMagnitudes(i) = frobProjectionSquared / probabilities(i);
+    weightedMagnitudes.zeros(numSamples);
   }
 
+  // Calculate the weighted projection magnitudes.
+  weightedMagnitudes /= probabilities;
+
   // Compute mean and standard deviation of the weighted samples.
   double mu = arma::mean(weightedMagnitudes);
   double sigma = arma::stddev(weightedMagnitudes);
@@ -279,20 +276,20 @@ double CosineTree::MonteCarloError(CosineTree* node,
 
 void CosineTree::ConstructBasis(CosineNodeQueue& treeQueue)
 {
-  // Initialize basis as matrix of zeros.
-  basis.zeros(dataset.n_rows, treeQueue.size());
+  QueueBasis(treeQueue, basis);
+}
 
-  // Variables for iterating through the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
+void CosineTree::QueueBasis(const CosineNodeQueue& treeQueue,
+                            arma::mat& currentBasis,
+                            const size_t extraColumns) const
+{
+  currentBasis.zeros(dataset.n_rows, treeQueue.size() + extraColumns);
 
   // Transfer basis vectors from the queue to the basis matrix.
   size_t j = 0;
+  CosineNodeQueue::const_iterator i = treeQueue.begin();
   for ( ; i != treeQueue.end(); i++, j++)
-  {
-    currentNode = *i;
-    basis.col(j) = currentNode->BasisVector();
-  }
+    currentBasis.col(j) = (*i)->BasisVector();
 }
 
 void CosineTree::CosineNodeSplit()
@@ -336,17 +333,6 @@ void CosineTree::ColumnSamplesLS(std::vector<size_t>& sampledIndices,
                                  arma::vec& probabilities,
                                  size_t numSamples)
 {
-  // Initialize the cumulative distribution vector size.
-  arma::vec cDistribution;
-  cDistribution.zeros(numColumns + 1);
-
-  // Calculate cumulative length-squared distribution for the node.
-  for (size_t i = 0; i < numColumns; i++)
-  {
-    cDistribution(i + 1) = cDistribution(i) +
-        (l2NormsSquared(i) / frobNormSquared);
-  }
-
   // Initialize sizes of the 'sampledIndices' and 'probabilities' vectors.
   sampledIndices.resize(numSamples);
   probabilities.zeros(numSamples);
@@ -372,17 +358,6 @@ size_t CosineTree::ColumnSampleLS()
     return 0;
   }
 
-  // Initialize the cumulative distribution vector size.
-  arma::vec cDistribution;
-  cDistribution.zeros(numColumns + 1);
-
-  // Calculate cumulative length-squared distribution for the node.
-  for (size_t i = 0; i < numColumns; i++)
-  {
-    cDistribution(i + 1) = cDistribution(i) +
-        (l2NormsSquared(i) / frobNormSquared);
-  }
-
   // Generate a random value for sampling.
   double randValue = arma::randu();
   size_t start = 0, end = numColumns;
@@ -424,34 +399,75 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
-  for (size_t i = 0; i < numColumns; i++)
+  // The squared norms of the columns are known already, so each cosine only
+  // needs one dot product.
+  const arma::vec splitPoint = dataset.col(indices[splitPointIndex]);
+  const double splitNormSquared = l2NormsSquared(splitPointIndex);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
     // between two vectors.
-    if (l2NormsSquared(i) == 0)
+    const double denominator = std::sqrt(splitNormSquared * l2NormsSquared(i));
+    if (denominator == 0)
     {
       cosines(i) = 0;
     }
     else
     {
-      cosines(i) =
-          std::abs(arma::norm_dot(dataset.col(indices[splitPointIndex]),
-                                  dataset.col(indices[i])));
+      cosines(i) = std::abs(arma::dot(splitPoint, dataset.col(indices[i]))) /
+          denominator;
     }
   }
 }
 
 void CosineTree::CalculateCentroid()
 {
-  // Initialize centroid as vector of zeros.
-  centroid.zeros(dataset.n_rows);
+  #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+  #else
+    const size_t numThreads = 1;
+  #endif
+
+  // Each thread sums its blocks of columns; the sums are added in a fixed
+  // order, so the result doesn't depend on the scheduling.
+  const size_t numBlocks = (numColumns + CentroidBlockSize - 1) /
+      CentroidBlockSize;
+  std::vector<arma::vec> partials(numThreads,
+      arma::zeros<arma::vec>(dataset.n_rows));
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    #ifdef HAS_OPENMP
+      arma::vec& partial = partials[omp_get_thread_num()];
+    #else
+      arma::vec& partial = partials[0];
+    #endif
+
+    const size_t begin = b * CentroidBlockSize;
+    const size_t end = std::min(begin + CentroidBlockSize, numColumns);
+    for (size_t i = begin; i < end; i++)
+      partial += dataset.col(indices[i]);
+  }
 
   // Calculate centroid of columns in the node.
+  centroid = std::move(partials[0]);
+  for (size_t t = 1; t < numThreads; ++t)
+    centroid += partials[t];
+  centroid /= numColumns;
+}
+
+void CosineTree::CalculateDistribution()
+{
+  // Calculate cumulative length-squared distribution for the node.
+  cDistribution.zeros(numColumns + 1);
   for (size_t i = 0; i < numColumns; i++)
   {
-    centroid += dataset.col(indices[i]);
+    cDistribution(i + 1) = cDistribution(i) +
+        (l2NormsSquared(i) / frobNormSquared);
   }
-  centroid /= numColumns;
 }
 
 } // namespace tree
@@ -152,8 +152,8 @@ class CosineTree
 
   /**
    * Calculate cosines of the columns present in the node, with respect to the
-   * sampled splitting point. The calculated cosine values are useful for
-   * splitting the node into its children.
+   * sampled splitting point, in parallel. The calculated cosine values are
+   * useful for splitting the node into its children.
    *
    * @param cosines Vector to store the cosine values in.
    */
@@ -162,6 +162,7 @@ class CosineTree
   /**
    * Calculate centroid of the columns present in the node. The calculated
    * centroid is used as a basis vector for the cosine tree being constructed.
+   * Blocks of columns are summed in parallel.
    */
   void CalculateCentroid();
 
@@ -213,6 +214,51 @@ class CosineTree
   size_t SplitPointIndex() const { return indices[splitPointIndex]; }
 
  private:
+  //! The number of columns summed by one thread at once in
+  //! CalculateCentroid().
+  static const size_t CentroidBlockSize = 256;
+
+  /**
+   * Calculate the orthonormalization of the passed centroid with respect to
+   * the subspace spanned by the columns of the given matrix, which must be
+   * orthonormal or zero.
+   *
+   * @param currentBasis Basis of the current subspace, one vector per column.
+   * @param centroid Centroid of the node being added to the basis.
+   * @param newBasisVector Orthonormalized centroid of the node.
+   */
+  void ModifiedGramSchmidt(const arma::mat& currentBasis,
+                           const arma::vec& centroid,
+                           arma::vec& newBasisVector);
+
+  /**
+   * Estimate the squared error of the projection of the input node's matrix
+   * onto the subspace spanned by the columns of the given matrix.  The
+   * projections of all the samples are computed with one matrix product.
+   *
+   * @param node Node for which Monte Carlo estimate is calculated.
+   * @param currentBasis Basis of the current subspace, one vector per column.
+   */
+  double MonteCarloError(CosineTree* node, const arma::mat& currentBasis);
+
+  /**
+   * Gather the basis vectors of the nodes in the queue into the columns of a
+   * matrix, followed by the given number of zero columns.
+   *
+   * @param treeQueue Priority queue of cosine nodes.
+   * @param currentBasis Matrix to store the basis vectors in.
+   * @param extraColumns Number of zero columns to add.
+   */
+  void QueueBasis(const CosineNodeQueue& treeQueue,
+                  arma::mat& currentBasis,
+                  const size_t extraColumns = 0) const;
+
+  /**
+   * Calculate the cumulative Length-Squared distribution of the columns of the
+   * node, which is kept for all the samples drawn from the node.
+   */
+  void CalculateDistribution();
+
   //! Matrix for which cosine tree is constructed.
   const arma::mat& dataset;
   //! Cumulative probability for Monte Carlo error lower bound.
@@ -229,6 +275,8 @@ class CosineTree
   std::vector<size_t> indices;
   //! L2-norm squared of columns in the node.
   arma::vec l2NormsSquared;
+  //! Cumulative Length-Squared distribution of columns in the node.
+  arma::vec cDistribution;
   //! Centroid of columns of input matrix in the node.
   arma::vec centroid;
   //! Orthonormalized basis vector of the node.
@@ -460,6 +460,13 @@ class CoverTree
    * first pointSetSize points in indices are calculated (so, this does not
    * necessarily need to use all of the points in the arrays).
    *
+   * The distances are independent of each other, so when there are at least
+   * MinimumParallelSize() of them (near the root, where the point sets are
+   * largest) they are split between threads with OpenMP.  Each distance is
+   * computed exactly as in the serial loop, so the tree is the same for any
+   * number of threads; the metric must be safe to call concurrently, as all of
+   * mlpack's metrics are.
+   *
    * @param pointIndex Point to build the distances for.
    * @param indices List of indices to compute distances for.
    * @param distances Vector to store calculated distances in.
@@ -469,6 +476,11 @@ class CoverTree
                         const arma::Col<size_t>& indices,
                         arma::vec& distances,
                         const size_t pointSetSize);
+
+  //! Point sets with at least this many points have their distances computed
+  //! in parallel, when OpenMP is available.
+  static size_t MinimumParallelSize() { return 1024; }
+
   /**
    * Split the given indices and distances into a near and a far set, returning
    * the number of points in the near set.  The distances must already be
@@ -545,6 +557,9 @@ class CoverTree
   //! Friend access is given for the default constructor.
   friend class boost::serialization::access;
 
+  //! FlatTreeAccess reads and writes the flat on-disk layout of the tree.
+  template<typename> friend class FlatTreeAccess;
+
  public:
   /**
    * Serialize the tree.
@@ -0,0 +1,158 @@
+/**
+ * @file flat_tree.hpp
+ *
+ * A flat binary on-disk layout for binary space trees and cover trees, which
+ * can be memory-mapped and used without copying the dataset.  This makes it
+ * possible to load very large tree models quickly, and to share one copy of the
+ * dataset (in the page cache) between several processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_FLAT_TREE_HPP
+#define MLPACK_CORE_TREE_FLAT_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
+#include "binary_space_tree.hpp"
+#include "cover_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The header at the start of a flat tree file.  Every field is 8 bytes wide, so
+ * that the node records that follow it and the dataset are suitably aligned.
+ * The dataset starts on a page boundary, and is stored column-major exactly as
+ * in memory.
+ */
+struct FlatTreeHeader
+{
+  //! Magic number identifying the file (and its byte order).
+  uint64_t magic;
+  //! Version of the layout.
+  uint64_t version;
+  //! Kind of tree stored in the file (see FlatTreeAccess).
+  uint64_t treeKind;
+  //! Size of one element of the dataset, in bytes.
+  uint64_t elemSize;
+  //! Number of rows of the dataset.
+  uint64_t rows;
+  //! Number of columns of the dataset.
+  uint64_t cols;
+  //! Number of nodes of the tree.
+  uint64_t numNodes;
+  //! Number of 8-byte slots in the record of each node.
+  uint64_t nodeSlots;
+  //! Offset of the first node record, in bytes.
+  uint64_t nodesOffset;
+  //! Number of elements of the stored oldFromNew mapping (may be 0).
+  uint64_t numOldFromNew;
+  //! Offset of the oldFromNew mapping, in bytes.
+  uint64_t oldFromNewOffset;
+  //! Offset of the dataset, in bytes.
+  uint64_t dataOffset;
+};
+
+/**
+ * FlatTreeAccess converts trees to and from the flat layout.  It is a friend of
+ * BinarySpaceTree and CoverTree, and is specialized for each of them; there is
+ * no need to use it directly, since SaveFlat() and MappedTree wrap it.
+ *
+ * The nodes are stored in breadth-first order, so that the children of each
+ * node are contiguous.  Statistics are not stored; they are rebuilt from the
+ * nodes when the tree is loaded.
+ */
+template<typename TreeType>
+class FlatTreeAccess;
+
+/**
+ * Save the given tree to the given file in the flat layout, so that it can
+ * later be loaded with MappedTree.  If the tree rearranged its dataset, the
+ * mapping from new point indices to old point indices can be stored in the file
+ * too.  A std::runtime_error is thrown if the file cannot be written.
+ *
+ * The layout is not portable between architectures with different byte orders;
+ * loading such a file fails with an error.
+ *
+ * @param filename Name of file to save to.
+ * @param tree Tree to save; this must be the root of the tree.
+ * @param oldFromNew Mapping from new point indices to old point indices (may be
+ *     empty).
+ */
+template<typename TreeType>
+void SaveFlat(const std::string& filename,
+              const TreeType& tree,
+              const std::vector<size_t>& oldFromNew = std::vector<size_t>());
+
+/**
+ * A tree loaded from a file saved with SaveFlat().  The file is memory-mapped,
+ * and the dataset of the tree is a matrix that points directly into the
+ * mapping (an Armadillo matrix built with copy_aux_mem = false), so loading
+ * does not read the dataset at all: its pages are brought in by the operating
+ * system as the tree is used, and are shared with every other process that maps
+ * the same file.  Only the nodes themselves are allocated, which takes a small
+ * fraction of the time and memory needed for the dataset.
+ *
+ * The mapping is copy-on-write, so the dataset may be modified, but changes are
+ * private to this process and are never written back to the file.
+ *
+ * The MappedTree must outlive every use of the tree.  The tree may be moved out
+ * of the MappedTree (for instance into a NeighborSearch object), in which case
+ * the MappedTree must outlive the object the tree was moved into.
+ *
+ * @code
+ * typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+ *     arma::mat> TreeType;
+ *
+ * MappedTree<TreeType> mapped("tree.bin");
+ * KNN knn(std::move(mapped.Tree()));
+ * @endcode
+ */
+template<typename TreeType>
+class MappedTree
+{
+ public:
+  /**
+   * Map the given file and rebuild the tree it holds.  A std::runtime_error is
+   * thrown if the file cannot be opened or is not a flat tree of the right
+   * type.
+   *
+   * @param filename Name of file to load.
+   */
+  MappedTree(const std::string& filename);
+
+  //! Delete the tree and unmap the file.
+  ~MappedTree();
+
+  // The tree refers to the mapping, so it can't be copied.
+  MappedTree(const MappedTree&) = delete;
+  MappedTree& operator=(const MappedTree&) = delete;
+
+  //! Get the tree.
+  const TreeType& Tree() const { return *tree; }
+  //! Modify the tree.
+  TreeType& Tree() { return *tree; }
+
+  //! Get the mapping from new point indices to old point indices stored with
+  //! the tree (this may be empty).
+  const std::vector<size_t>& OldFromNew() const { return oldFromNew; }
+
+ private:
+  //! The mapped file.
+  data::MappedFile file;
+  //! The tree.
+  TreeType* tree;
+  //! The mapping from new point indices to old point indices.
+  std::vector<size_t> oldFromNew;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_tree_impl.hpp"
+
+#endif
@@ -0,0 +1,491 @@
+/**
+ * @file flat_tree_impl.hpp
+ *
+ * Implementation of SaveFlat(), MappedTree, and the FlatTreeAccess
+ * specializations for BinarySpaceTree and CoverTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_FLAT_TREE_IMPL_HPP
+#define MLPACK_CORE_TREE_FLAT_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_tree.hpp"
+
+#include <cstring>
+#include <fstream>
+
+namespace mlpack {
+namespace tree {
+
+//! "MLPKFLAT", read as a little-endian 64-bit integer.
+const uint64_t flatTreeMagic = 0x54414c464b504c4dULL;
+//! The current version of the flat layout.
+const uint64_t flatTreeVersion = 1;
+//! The dataset starts at a multiple of this offset.
+const uint64_t flatTreeAlignment = 4096;
+
+//! Store a floating-point value in an 8-byte slot.
+inline uint64_t FlatTreeSlot(const double value)
+{
+  uint64_t slot;
+  std::memcpy(&slot, &value, sizeof(slot));
+  return slot;
+}
+
+//! Retrieve a floating-point value from an 8-byte slot.
+inline double FlatTreeValue(const uint64_t slot)
+{
+  double value;
+  std::memcpy(&value, &slot, sizeof(value));
+  return value;
+}
+
+/**
+ * The layout of a binary space tree.  Each node record holds, in order: the
+ * index of the first child, the number of children, the index of the first
+ * point, the number of points, the parent distance, the furthest descendant
+ * distance, the minimum bound distance, and the bound.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+class FlatTreeAccess<BinarySpaceTree<MetricType, StatisticType, MatType,
+    BoundType, SplitType>>
+{
+ public:
+  typedef BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+      SplitType> TreeType;
+
+  //! Get the kind of tree, which depends on the type of bound.
+  static uint64_t Kind() { return 1 + BoundKind(BoundType<MetricType>()); }
+
+  //! Get the number of slots of each node record.
+  static size_t NodeSlots(const size_t dimensionality)
+  {
+    return 7 + BoundSlots(BoundType<MetricType>(), dimensionality);
+  }
+
+  //! Get the dataset of the tree.
+  static const MatType& Dataset(const TreeType& tree) { return *tree.dataset; }
+
+  //! Fill the record of the given node.
+  static void Write(const TreeType& node,
+                    const size_t firstChild,
+                    uint64_t* record)
+  {
+    record[0] = firstChild;
+    record[1] = node.NumChildren();
+    record[2] = node.begin;
+    record[3] = node.count;
+    record[4] = FlatTreeSlot(node.parentDistance);
+    record[5] = FlatTreeSlot(node.furthestDescendantDistance);
+    record[6] = FlatTreeSlot(node.minimumBoundDistance);
+    WriteBound(node.bound, record + 7);
+  }
+
+  //! Rebuild the tree from the given (already checked) records.  The root takes
+  //! ownership of the dataset object.
+  static TreeType* Build(const uint64_t* records,
+                         const size_t numNodes,
+                         const size_t nodeSlots,
+                         MatType* dataset)
+  {
+    // Check the points of every node before anything is allocated.
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      const uint64_t* record = records + i * nodeSlots;
+      if ((record[1] != 0 && record[1] != 2) || record[2] > dataset->n_cols ||
+          record[3] > dataset->n_cols - record[2])
+      {
+        delete dataset;
+        throw std::runtime_error("MappedTree: node " + std::to_string(i) +
+            " is invalid");
+      }
+    }
+
+    std::vector<TreeType*> nodes(numNodes);
+    for (size_t i = 0; i < numNodes; ++i)
+      nodes[i] = new TreeType();
+
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      const uint64_t* record = records + i * nodeSlots;
+      TreeType* node = nodes[i];
+
+      if (record[1] == 2)
+      {
+        node->left = nodes[record[0]];
+        node->right = nodes[record[0] + 1];
+        node->left->parent = node;
+        node->right->parent = node;
+      }
+
+      node->begin = record[2];
+      node->count = record[3];
+      node->parentDistance = FlatTreeValue(record[4]);
+      node->furthestDescendantDistance = FlatTreeValue(record[5]);
+      node->minimumBoundDistance = FlatTreeValue(record[6]);
+      ReadBound(node->bound, record + 7, dataset->n_rows);
+      node->dataset = dataset;
+    }
+
+    // Children come after their parents, so building the statistics in reverse
+    // order means that the children are always complete first.
+    for (size_t i = numNodes; i > 0; --i)
+      nodes[i - 1]->stat = StatisticType(*nodes[i - 1]);
+
+    return nodes[0];
+  }
+
+ private:
+  template<typename BoundMetricType, typename ElemType>
+  static uint64_t BoundKind(const bound::HRectBound<BoundMetricType, ElemType>&)
+  {
+    return 0;
+  }
+
+  template<typename BoundMetricType, typename VecType>
+  static uint64_t BoundKind(const bound::BallBound<BoundMetricType, VecType>&)
+  {
+    return 1;
+  }
+
+  template<typename BoundMetricType, typename ElemType>
+  static size_t BoundSlots(const bound::HRectBound<BoundMetricType, ElemType>&,
+                           const size_t dimensionality)
+  {
+    return 1 + 2 * dimensionality;
+  }
+
+  template<typename BoundMetricType, typename VecType>
+  static size_t BoundSlots(const bound::BallBound<BoundMetricType, VecType>&,
+                           const size_t dimensionality)
+  {
+    return 1 + dimensionality;
+  }
+
+  template<typename BoundMetricType, typename ElemType>
+  static void WriteBound(
+      const bound::HRectBound<BoundMetricType, ElemType>& nodeBound,
+      uint64_t* slots)
+  {
+    slots[0] = FlatTreeSlot(nodeBound.MinWidth());
+    for (size_t d = 0; d < nodeBound.Dim(); ++d)
+    {
+      slots[1 + 2 * d] = FlatTreeSlot(nodeBound[d].Lo());
+      slots[2 + 2 * d] = FlatTreeSlot(nodeBound[d].Hi());
+    }
+  }
+
+  template<typename BoundMetricType, typename VecType>
+  static void WriteBound(
+      const bound::BallBound<BoundMetricType, VecType>& nodeBound,
+      uint64_t* slots)
+  {
+    slots[0] = FlatTreeSlot(nodeBound.Radius());
+    for (size_t d = 0; d < nodeBound.Dim(); ++d)
+      slots[1 + d] = FlatTreeSlot(nodeBound.Center()[d]);
+  }
+
+  template<typename BoundMetricType, typename ElemType>
+  static void ReadBound(
+      bound::HRectBound<BoundMetricType, ElemType>& nodeBound,
+      const uint64_t* slots,
+      const size_t dimensionality)
+  {
+    nodeBound = bound::HRectBound<BoundMetricType, ElemType>(dimensionality);
+    nodeBound.MinWidth() = FlatTreeValue(slots[0]);
+    for (size_t d = 0; d < dimensionality; ++d)
+    {
+      nodeBound[d] = math::RangeType<ElemType>(
+          FlatTreeValue(slots[1 + 2 * d]), FlatTreeValue(slots[2 + 2 * d]));
+    }
+  }
+
+  template<typename BoundMetricType, typename VecType>
+  static void ReadBound(
+      bound::BallBound<BoundMetricType, VecType>& nodeBound,
+      const uint64_t* slots,
+      const size_t dimensionality)
+  {
+    nodeBound = bound::BallBound<BoundMetricType, VecType>(dimensionality);
+    nodeBound.Radius() = FlatTreeValue(slots[0]);
+    for (size_t d = 0; d < dimensionality; ++d)
+      nodeBound.Center()[d] = FlatTreeValue(slots[1 + d]);
+  }
+};
+
+/**
+ * The layout of a cover tree.  Each node record holds, in order: the index of
+ * the first child, the number of children, the point, the scale, the base, the
+ * number of descendants, the parent distance, and the furthest descendant
+ * distance.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename RootPointPolicy>
+class FlatTreeAccess<CoverTree<MetricType, StatisticType, MatType,
+    RootPointPolicy>>
+{
+ public:
+  typedef CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>
+      TreeType;
+
+  //! Get the kind of tree.
+  static uint64_t Kind() { return 3; }
+
+  //! Get the number of slots of each node record.
+  static size_t NodeSlots(const size_t /* dimensionality */) { return 8; }
+
+  //! Get the dataset of the tree.
+  static const MatType& Dataset(const TreeType& tree) { return *tree.dataset; }
+
+  //! Fill the record of the given node.
+  static void Write(const TreeType& node,
+                    const size_t firstChild,
+                    uint64_t* record)
+  {
+    record[0] = firstChild;
+    record[1] = node.NumChildren();
+    record[2] = node.point;
+    record[3] = (uint64_t) (int64_t) node.scale;
+    record[4] = FlatTreeSlot(node.base);
+    record[5] = node.numDescendants;
+    record[6] = FlatTreeSlot(node.parentDistance);
+    record[7] = FlatTreeSlot(node.furthestDescendantDistance);
+  }
+
+  //! Rebuild the tree from the given (already checked) records.  The root takes
+  //! ownership of the dataset object.
+  static TreeType* Build(const uint64_t* records,
+                         const size_t numNodes,
+                         const size_t nodeSlots,
+                         MatType* dataset)
+  {
+    // Check the points of every node before anything is allocated.
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      const uint64_t* record = records + i * nodeSlots;
+      if (record[2] >= dataset->n_cols || record[5] > dataset->n_cols)
+      {
+        delete dataset;
+        throw std::runtime_error("MappedTree: node " + std::to_string(i) +
+            " is invalid");
+      }
+    }
+
+    std::vector<TreeType*> nodes(numNodes);
+    for (size_t i = 0; i < numNodes; ++i)
+      nodes[i] = new TreeType();
+
+    MetricType* metric = new MetricType();
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      const uint64_t* record = records + i * nodeSlots;
+      TreeType* node = nodes[i];
+
+      node->children.resize(record[1]);
+      for (size_t c = 0; c < record[1]; ++c)
+      {
+        node->children[c] = nodes[record[0] + c];
+        node->children[c]->parent = node;
+      }
+
+      node->point = record[2];
+      node->scale = (int) (int64_t) record[3];
+      node->base = FlatTreeValue(record[4]);
+      node->numDescendants = record[5];
+      node->parentDistance = FlatTreeValue(record[6]);
+      node->furthestDescendantDistance = FlatTreeValue(record[7]);
+      node->dataset = dataset;
+      node->metric = metric;
+    }
+
+    // The root owns the dataset and the metric.
+    nodes[0]->localDataset = true;
+    nodes[0]->localMetric = true;
+
+    // Children come after their parents, so building the statistics in reverse
+    // order means that the children are always complete first.
+    for (size_t i = numNodes; i > 0; --i)
+      nodes[i - 1]->stat = StatisticType(*nodes[i - 1]);
+
+    return nodes[0];
+  }
+};
+
+template<typename TreeType>
+void SaveFlat(const std::string& filename,
+              const TreeType& tree,
+              const std::vector<size_t>& oldFromNew)
+{
+  typedef FlatTreeAccess<TreeType> Access;
+  typedef typename TreeType::Mat MatType;
+  typedef typename MatType::elem_type ElemType;
+
+  if (tree.Parent() != NULL)
+  {
+    throw std::invalid_argument("SaveFlat(): the given tree node is not the "
+        "root of a tree");
+  }
+
+  const MatType& dataset = Access::Dataset(tree);
+
+  // Collect the nodes in breadth-first order, so that the children of each node
+  // are contiguous.
+  std::vector<const TreeType*> nodes(1, &tree);
+  std::vector<size_t> firstChild;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    firstChild.push_back(nodes.size());
+    for (size_t c = 0; c < nodes[i]->NumChildren(); ++c)
+      nodes.push_back(&nodes[i]->Child(c));
+  }
+
+  FlatTreeHeader header;
+  header.magic = flatTreeMagic;
+  header.version = flatTreeVersion;
+  header.treeKind = Access::Kind();
+  header.elemSize = sizeof(ElemType);
+  header.rows = dataset.n_rows;
+  header.cols = dataset.n_cols;
+  header.numNodes = nodes.size();
+  header.nodeSlots = Access::NodeSlots(dataset.n_rows);
+  header.nodesOffset = sizeof(FlatTreeHeader);
+  header.numOldFromNew = oldFromNew.size();
+  header.oldFromNewOffset = header.nodesOffset +
+      header.numNodes * header.nodeSlots * sizeof(uint64_t);
+  const uint64_t end = header.oldFromNewOffset +
+      header.numOldFromNew * sizeof(uint64_t);
+  header.dataOffset = ((end + flatTreeAlignment - 1) / flatTreeAlignment) *
+      flatTreeAlignment;
+
+  std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary |
+      std::ios::trunc);
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "' for writing. " << std::endl;
+    throw std::runtime_error(oss.str());
+  }
+
+  stream.write((const char*) &header, sizeof(header));
+
+  std::vector<uint64_t> record(header.nodeSlots);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    Access::Write(*nodes[i], firstChild[i], record.data());
+    stream.write((const char*) record.data(), record.size() * sizeof(uint64_t));
+  }
+
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    const uint64_t index = oldFromNew[i];
+    stream.write((const char*) &index, sizeof(index));
+  }
+
+  const std::vector<char> padding(header.dataOffset - end, 0);
+  stream.write(padding.data(), padding.size());
+  stream.write((const char*) dataset.memptr(), dataset.n_elem *
+      sizeof(ElemType));
+
+  if (!stream.good())
+  {
+    std::ostringstream oss;
+    oss << "Error writing to file '" << filename << "'. " << std::endl;
+    throw std::runtime_error(oss.str());
+  }
+}
+
+template<typename TreeType>
+MappedTree<TreeType>::MappedTree(const std::string& filename) :
+    file(filename, true),
+    tree(NULL)
+{
+  typedef FlatTreeAccess<TreeType> Access;
+  typedef typename TreeType::Mat MatType;
+  typedef typename MatType::elem_type ElemType;
+
+  const std::string error = "MappedTree: file '" + filename + "' ";
+  if (file.Size() < sizeof(FlatTreeHeader))
+    throw std::runtime_error(error + "is not a flat tree");
+
+  FlatTreeHeader header;
+  std::memcpy(&header, file.Data(), sizeof(header));
+
+  if (header.magic != flatTreeMagic)
+    throw std::runtime_error(error + "is not a flat tree");
+  if (header.version != flatTreeVersion)
+    throw std::runtime_error(error + "has an unsupported version");
+  if (header.treeKind != Access::Kind() || header.elemSize != sizeof(ElemType))
+    throw std::runtime_error(error + "holds a different type of tree");
+
+  // Make sure that every section of the file is where it should be, without
+  // overflowing.
+  const uint64_t size = file.Size();
+  const uint64_t nodesEnd = header.nodesOffset +
+      header.numNodes * header.nodeSlots * sizeof(uint64_t);
+  const uint64_t oldFromNewEnd = header.oldFromNewOffset +
+      header.numOldFromNew * sizeof(uint64_t);
+  if (header.numNodes == 0 ||
+      header.nodeSlots != Access::NodeSlots(header.rows) ||
+      header.nodesOffset != sizeof(FlatTreeHeader) ||
+      header.numNodes > size / (header.nodeSlots * sizeof(uint64_t)) ||
+      nodesEnd > header.oldFromNewOffset ||
+      header.oldFromNewOffset > size ||
+      header.numOldFromNew > size / sizeof(uint64_t) ||
+      oldFromNewEnd > header.dataOffset ||
+      header.dataOffset % flatTreeAlignment != 0 ||
+      header.dataOffset > size ||
+      header.rows > size ||
+      (header.rows != 0 && header.cols > (size - header.dataOffset) /
+          (header.rows * sizeof(ElemType))))
+  {
+    throw std::runtime_error(error + "is truncated or corrupt");
+  }
+
+  // The records must describe a tree in breadth-first order: the children of
+  // each node follow the children of the previous nodes.
+  const uint64_t* records = (const uint64_t*) (file.Data() +
+      header.nodesOffset);
+  uint64_t next = 1;
+  for (size_t i = 0; i < header.numNodes; ++i)
+  {
+    const uint64_t* record = records + i * header.nodeSlots;
+    if (record[1] > header.numNodes - next ||
+        (record[1] > 0 && record[0] != next))
+      throw std::runtime_error(error + "is truncated or corrupt");
+    next += record[1];
+  }
+  if (next != header.numNodes)
+    throw std::runtime_error(error + "is truncated or corrupt");
+
+  const uint64_t* oldFromNewSlots = (const uint64_t*) (file.Data() +
+      header.oldFromNewOffset);
+  oldFromNew.assign(oldFromNewSlots, oldFromNewSlots + header.numOldFromNew);
+
+  // The dataset aliases the mapping, so it is never read here.
+  ElemType* data = (ElemType*) (file.MutableData() + header.dataOffset);
+  MatType* dataset = new MatType(data, header.rows, header.cols, false, true);
+
+  tree = Access::Build(records, header.numNodes, header.nodeSlots, dataset);
+}
+
+template<typename TreeType>
+MappedTree<TreeType>::~MappedTree()
+{
+  delete tree;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
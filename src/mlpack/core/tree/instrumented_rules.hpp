@@ -0,0 +1,164 @@
+/**
+ * @file instrumented_rules.hpp
+ *
+ * A wrapper around the rules of a tree traversal that records the base cases
+ * and scores of the traversal, and the TraversalRules alias used by mlpack's
+ * tree-based algorithms to enable it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_INSTRUMENTED_RULES_HPP
+#define MLPACK_CORE_TREE_INSTRUMENTED_RULES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "traversal_statistics.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * InstrumentedRules wraps the RuleType of a traversal, for any traverser and
+ * any tree type, and records every call to BaseCase(), Score() and Rescore()
+ * in a TraversalStatistics object.  It derives from RuleType, so it can be
+ * constructed with the same arguments and it provides everything else that
+ * RuleType does.
+ *
+ * When an InstrumentedRules object is destroyed, its statistics are reported
+ * as timer counters under "traversal" (see TraversalStatistics::Report()), so
+ * that they are children of the timer that was running, e.g.
+ * "computing_neighbors/traversal/base_cases".  A copy, such as the per-thread
+ * copies made by ParallelDualTreeTraverser, starts with empty statistics and
+ * reports its own.
+ *
+ * The level of a node is found by following its parents, and each call is
+ * timed, so instrumentation slows traversals down noticeably.  RuleType's
+ * BaseCaseBlock() is also not used, so that each base case is counted.
+ *
+ * @tparam RuleType Rules of the traversal to instrument.
+ */
+template<typename RuleType>
+class InstrumentedRules : public RuleType
+{
+ public:
+  //! Construct the rules as RuleType would be.
+  using RuleType::RuleType;
+
+  //! Copy the rules, but not their statistics.
+  InstrumentedRules(const InstrumentedRules& other) : RuleType(other) { }
+
+  //! Copy the rules, but not their statistics.
+  InstrumentedRules& operator=(const InstrumentedRules& other)
+  {
+    RuleType::operator=(other);
+    return *this;
+  }
+
+  //! Report the statistics, if anything was recorded.
+  ~InstrumentedRules()
+  {
+    if (statistics.BaseCases() > 0 || statistics.Scores() > 0)
+      statistics.Report("traversal");
+  }
+
+  //! Evaluate and record a base case.
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex)
+  {
+    const Clock::time_point start = Clock::now();
+    const double result = RuleType::BaseCase(queryIndex, referenceIndex);
+    statistics.BaseCase(Clock::now() - start);
+    return result;
+  }
+
+  //! Score and record a combination of a query point and a reference node.
+  template<typename TreeType>
+  double Score(const size_t queryIndex, TreeType& referenceNode)
+  {
+    const Clock::time_point start = Clock::now();
+    const double score = RuleType::Score(queryIndex, referenceNode);
+    statistics.Score(Level(referenceNode), score == DBL_MAX,
+        Clock::now() - start);
+    return score;
+  }
+
+  //! Score and record a combination of a query node and a reference node.
+  template<typename TreeType>
+  double Score(TreeType& queryNode, TreeType& referenceNode)
+  {
+    const Clock::time_point start = Clock::now();
+    const double score = RuleType::Score(queryNode, referenceNode);
+    statistics.Score(Level(queryNode), Level(referenceNode), score == DBL_MAX,
+        Clock::now() - start);
+    return score;
+  }
+
+  //! Rescore and record a combination of a query point and a reference node.
+  template<typename TreeType>
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore)
+  {
+    const Clock::time_point start = Clock::now();
+    const double score = RuleType::Rescore(queryIndex, referenceNode,
+        oldScore);
+    statistics.Rescore(score == DBL_MAX, Clock::now() - start);
+    return score;
+  }
+
+  //! Rescore and record a combination of a query node and a reference node.
+  template<typename TreeType>
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore)
+  {
+    const Clock::time_point start = Clock::now();
+    const double score = RuleType::Rescore(queryNode, referenceNode, oldScore);
+    statistics.Rescore(score == DBL_MAX, Clock::now() - start);
+    return score;
+  }
+
+  //! Get the statistics of the traversal.
+  const TraversalStatistics& Statistics() const { return statistics; }
+  //! Modify the statistics of the traversal.
+  TraversalStatistics& Statistics() { return statistics; }
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  //! Get the level of the given node; the root is at level 0.
+  template<typename TreeType>
+  static size_t Level(const TreeType& node)
+  {
+    size_t level = 0;
+    for (const TreeType* n = node.Parent(); n != NULL; n = n->Parent())
+      ++level;
+    return level;
+  }
+
+  //! The statistics of the traversal.
+  TraversalStatistics statistics;
+};
+
+/**
+ * The rules that mlpack's tree-based algorithms (NeighborSearch, RangeSearch,
+ * RASearch, FastMKS, DualTreeBoruvka, DBSCAN and the tree-based k-means steps)
+ * traverse their trees with.  If mlpack is configured with
+ * -DTRAVERSAL_STATISTICS=ON, which defines MLPACK_TRAVERSAL_STATISTICS, this
+ * is InstrumentedRules<RuleType> and every traversal reports its statistics
+ * with the timers; otherwise it is RuleType itself, and the instrumentation
+ * costs nothing.
+ */
+#ifdef MLPACK_TRAVERSAL_STATISTICS
+template<typename RuleType>
+using TraversalRules = InstrumentedRules<RuleType>;
+#else
+template<typename RuleType>
+using TraversalRules = RuleType;
+#endif
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
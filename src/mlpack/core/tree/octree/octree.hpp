@@ -425,6 +425,93 @@ class Octree
                  std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize);
 
+  /**
+   * Construct a child node of the given parent without splitting it yet.  Only
+   * the bound, the parent distance and the furthest descendant distance are
+   * computed.  This is used by ParallelSplitNode(), which splits the node
+   * afterwards.
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of point to start tree construction with.
+   * @param count Number of points to use to construct tree.
+   */
+  Octree(Octree* parent, const size_t begin, const size_t count);
+
+  /**
+   * Reorder the points of the node so that the points of each child are
+   * contiguous, and store the index of the first point of each child (and one
+   * past the last point) in childBegins.
+   *
+   * @param center Center of the node.
+   * @param oldFromNew Mappings from old to new, or NULL if they aren't needed.
+   * @param childBegins Filled with the first point of each child.
+   */
+  void PartitionNode(const arma::vec& center,
+                     std::vector<size_t>* oldFromNew,
+                     arma::Col<size_t>& childBegins);
+
+  /**
+   * Compute the center of the child with the given index.
+   *
+   * @param center Center of the node.
+   * @param width Width of the node.
+   * @param child Index of the child; bit d is set if the child lies on the
+   *     right of the center in dimension d.
+   * @param childCenter Filled with the center of the child.
+   */
+  static void ChildCenter(const arma::vec& center,
+                          const double width,
+                          const size_t child,
+                          arma::vec& childCenter);
+
+  /**
+   * Sort the points of the node by their Morton code: the code of a point is
+   * made of the index of the child the point falls into at each level of the
+   * tree, so once the points are sorted every partition of the upper levels of
+   * the tree finds them in place.  The resulting tree is the same as without
+   * the sort.  This is used for the root of large trees.
+   *
+   * @param center Center of the node.
+   * @param width Width of the node.
+   * @param oldFromNew Mappings from old to new, or NULL if they aren't needed.
+   */
+  void MortonSort(const arma::vec& center,
+                  const double width,
+                  std::vector<size_t>* oldFromNew);
+
+  /**
+   * Split the node like SplitNode(), but build the tree in parallel: the top of
+   * the tree is split serially until there are a few subtrees for every
+   * thread, and then the subtrees are built concurrently.  This is only used
+   * for the root of a large tree.
+   *
+   * @param center Center of the node.
+   * @param width Width of the node.
+   * @param oldFromNew Mappings from old to new, or NULL if they aren't needed.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void ParallelSplitNode(const arma::vec& center,
+                         const double width,
+                         std::vector<size_t>* oldFromNew,
+                         const size_t maxLeafSize);
+
+  /**
+   * Split the node once, creating children that are not split yet, and store
+   * the center of each child.
+   *
+   * @param center Center of the node.
+   * @param width Width of the node.
+   * @param oldFromNew Mappings from old to new, or NULL if they aren't needed.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   * @param childCenters Filled with the center of each child.
+   * @return Whether the node was split.
+   */
+  bool SplitOnce(const arma::vec& center,
+                 const double width,
+                 std::vector<size_t>* oldFromNew,
+                 const size_t maxLeafSize,
+                 std::vector<arma::vec>& childCenters);
+
   /**
    * This is used for sorting points while splitting.
    */
@@ -16,6 +16,10 @@
 #include <mlpack/core/tree/perform_split.hpp>
 #include <stack>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -676,72 +680,26 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   if (count <= maxLeafSize)
     return;
 
-  // This will hold the index of the first point in each child.
-  arma::Col<size_t> childBegins(((size_t) 1 << dataset->n_rows) + 1);
-  childBegins[0] = begin;
-  childBegins[childBegins.n_elem - 1] = begin + count;
-
-  // We will make log2(dim) passes, splitting along the last down to the first
-  // dimension.  The tuple holds { dim, begin, count, leftChildIndex }.
-  std::stack<std::tuple<size_t, size_t, size_t, size_t>> stack;
-  stack.push(std::tuple<size_t, size_t, size_t, size_t>(dataset->n_rows - 1,
-      begin, count, 0));
-
-  while (!stack.empty())
+  // Large trees are sorted first, and built in parallel if possible.
+  if (parent == NULL && count >= 100000)
   {
-    std::tuple<size_t, size_t, size_t, size_t> t = stack.top();
-    stack.pop();
-
-    const size_t d = std::get<0>(t);
-    const size_t childBegin = std::get<1>(t);
-    const size_t childCount = std::get<2>(t);
-    const size_t leftChildIndex = std::get<3>(t);
-
-    // Perform a "half-split": after this split, all points belonging to
-    // children of index 2^(d - 1) - 1 and less will be on the left side, and
-    // all points belonging to children of index 2^(d - 1) and above will be on
-    // the right side.
-    typename SplitType::SplitInfo s(d, center);
-    const size_t firstRight = split::PerformSplit<MatType, SplitType>(*dataset,
-        childBegin, childCount, s);
-
-    // We can set the first index of the right child.  The first index of the
-    // left child is already set.
-    const size_t rightChildIndex = leftChildIndex + ((size_t) 1 << d);
-    childBegins[rightChildIndex] = firstRight;
+    MortonSort(center, width, NULL);
 
-    // Now we have to recurse, if this was not the last dimension.
-    if (d != 0)
+    #ifdef HAS_OPENMP
+    if (omp_get_max_threads() > 1)
     {
-      if (firstRight > childBegin)
-      {
-        stack.push(std::tuple<size_t, size_t, size_t, size_t>(d - 1, childBegin,
-            firstRight - childBegin, leftChildIndex));
-      }
-      else
-      {
-        // Set beginning indices correctly for all children below this level.
-        for (size_t c = leftChildIndex + 1; c < rightChildIndex; ++c)
-          childBegins[c] = childBegins[leftChildIndex];
-      }
-
-      if (firstRight < childBegin + childCount)
-      {
-        stack.push(std::tuple<size_t, size_t, size_t, size_t>(d - 1, firstRight,
-            childCount - (firstRight - childBegin), rightChildIndex));
-      }
-      else
-      {
-        // Set beginning indices correctly for all children below this level.
-        for (size_t c = rightChildIndex + 1;
-             c < rightChildIndex + (rightChildIndex - leftChildIndex); ++c)
-          childBegins[c] = childBegins[rightChildIndex];
-      }
+      ParallelSplitNode(center, width, NULL, maxLeafSize);
+      return;
     }
+    #endif
   }
 
+  // This will hold the index of the first point in each child.
+  arma::Col<size_t> childBegins;
+  PartitionNode(center, NULL, childBegins);
+
   // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
+  arma::vec childCenter;
   const double childWidth = width / 2.0;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
   {
@@ -749,16 +707,7 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     if (childBegins[i + 1] - childBegins[i] == 0)
       continue;
 
-    // Create the correct center.
-    for (size_t d = 0; d < center.n_elem; ++d)
-    {
-      // Is the dimension "right" (1) or "left" (0)?
-      if (((i >> d) & 1) == 0)
-        childCenter[d] = center[d] - childWidth;
-      else
-        childCenter[d] = center[d] + childWidth;
-    }
-
+    ChildCenter(center, width, i, childCenter);
     children.push_back(new Octree(this, childBegins[i],
         childBegins[i + 1] - childBegins[i], childCenter, childWidth,
         maxLeafSize));
@@ -778,8 +727,75 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   if (count <= maxLeafSize)
     return;
 
+  // Large trees are sorted first, and built in parallel if possible.
+  if (parent == NULL && count >= 100000)
+  {
+    MortonSort(center, width, &oldFromNew);
+
+    #ifdef HAS_OPENMP
+    if (omp_get_max_threads() > 1)
+    {
+      ParallelSplitNode(center, width, &oldFromNew, maxLeafSize);
+      return;
+    }
+    #endif
+  }
+
   // This will hold the index of the first point in each child.
-  arma::Col<size_t> childBegins(((size_t) 1 << dataset->n_rows) + 1);
+  arma::Col<size_t> childBegins;
+  PartitionNode(center, &oldFromNew, childBegins);
+
+  // Now that the dataset is reordered, we can create the children.
+  arma::vec childCenter;
+  const double childWidth = width / 2.0;
+  for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+  {
+    // If the child has no points, don't create it.
+    if (childBegins[i + 1] - childBegins[i] == 0)
+      continue;
+
+    ChildCenter(center, width, i, childCenter);
+    children.push_back(new Octree(this, childBegins[i],
+        childBegins[i + 1] - childBegins[i], oldFromNew, childCenter,
+        childWidth, maxLeafSize));
+  }
+}
+
+//! Construct a child node that is split later.
+template<typename MetricType, typename StatisticType, typename MatType>
+Octree<MetricType, StatisticType, MatType>::Octree(
+    Octree* parent,
+    const size_t begin,
+    const size_t count) :
+    begin(begin),
+    count(count),
+    bound(parent->dataset->n_rows),
+    dataset(parent->dataset),
+    parent(parent)
+{
+  // Calculate empirical center of data.
+  bound |= dataset->cols(begin, begin + count - 1);
+
+  // The children of the node don't change its bound, so the distances can be
+  // computed now.
+  arma::vec trueCenter, parentCenter;
+  bound.Center(trueCenter);
+  parent->Bound().Center(parentCenter);
+  parentDistance = metric.Evaluate(trueCenter, parentCenter);
+
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // The node is split later by ParallelSplitNode().
+}
+
+//! Reorder the points so that the points of each child are contiguous.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::PartitionNode(
+    const arma::vec& center,
+    std::vector<size_t>* oldFromNew,
+    arma::Col<size_t>& childBegins)
+{
+  childBegins.set_size(((size_t) 1 << dataset->n_rows) + 1);
   childBegins[0] = begin;
   childBegins[childBegins.n_elem - 1] = begin + count;
 
@@ -804,8 +820,11 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     // all points belonging to children of index 2^(d - 1) and above will be on
     // the right side.
     typename SplitType::SplitInfo s(d, center);
-    const size_t firstRight = split::PerformSplit<MatType, SplitType>(*dataset,
-        childBegin, childCount, s, oldFromNew);
+    const size_t firstRight = (oldFromNew == NULL) ?
+        split::PerformSplit<MatType, SplitType>(*dataset, childBegin,
+            childCount, s) :
+        split::PerformSplit<MatType, SplitType>(*dataset, childBegin,
+            childCount, s, *oldFromNew);
 
     // We can set the first index of the right child.  The first index of the
     // left child is already set.
@@ -841,30 +860,227 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
       }
     }
   }
+}
 
-  // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
+//! Compute the center of a child.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::ChildCenter(
+    const arma::vec& center,
+    const double width,
+    const size_t child,
+    arma::vec& childCenter)
+{
   const double childWidth = width / 2.0;
-  for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+  childCenter.set_size(center.n_elem);
+  for (size_t d = 0; d < center.n_elem; ++d)
   {
-    // If the child has no points, don't create it.
-    if (childBegins[i + 1] - childBegins[i] == 0)
+    // Is the dimension "right" (1) or "left" (0)?
+    if (((child >> d) & 1) == 0)
+      childCenter[d] = center[d] - childWidth;
+    else
+      childCenter[d] = center[d] + childWidth;
+  }
+}
+
+//! Sort the points of the node by Morton code.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::MortonSort(
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew)
+{
+  // Each level of the tree takes one bit per dimension of the code.
+  const size_t dim = dataset->n_rows;
+  if (dim == 0 || dim > 64)
+    return;
+  const size_t levels = 64 / dim;
+
+  // The code of a point is found by following the point down the tree, with
+  // exactly the same comparisons as SplitType and the same child centers as
+  // ChildCenter(), so that the order is the one the partitions would give.
+  std::vector<std::pair<uint64_t, size_t>> codes(count);
+  #pragma omp parallel
+  {
+    arma::vec nodeCenter(dim);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) count; ++i)
+    {
+      nodeCenter = center;
+      double nodeWidth = width;
+      uint64_t code = 0;
+      for (size_t level = 0; level < levels; ++level)
+      {
+        const double childWidth = nodeWidth / 2.0;
+        uint64_t child = 0;
+        for (size_t d = 0; d < dim; ++d)
+        {
+          if ((*dataset)(d, begin + i) < nodeCenter[d])
+          {
+            nodeCenter[d] = nodeCenter[d] - childWidth;
+          }
+          else
+          {
+            child |= ((uint64_t) 1 << d);
+            nodeCenter[d] = nodeCenter[d] + childWidth;
+          }
+        }
+
+        code = (level == 0) ? child : ((code << dim) | child);
+        nodeWidth = childWidth;
+      }
+
+      codes[i] = std::make_pair(code, begin + i);
+    }
+  }
+
+  std::sort(codes.begin(), codes.end());
+
+  // Apply the permutation with one swap per point.  position[p] is the current
+  // column of the point that was in column p, and original[c] is the original
+  // column of the point that is now in column c.
+  std::vector<size_t> position(count), original(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    position[i] = i;
+    original[i] = i;
+  }
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const size_t p = codes[i].second - begin;
+    const size_t current = position[p];
+    if (current == i)
       continue;
 
-    // Create the correct center.
-    for (size_t d = 0; d < center.n_elem; ++d)
+    dataset->swap_cols(begin + i, begin + current);
+    if (oldFromNew)
+      std::swap((*oldFromNew)[begin + i], (*oldFromNew)[begin + current]);
+
+    position[original[i]] = current;
+    original[current] = original[i];
+    original[i] = p;
+    position[p] = i;
+  }
+}
+
+//! Split the node, building the subtrees in parallel.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::ParallelSplitNode(
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Split the largest node serially until there are a few subtrees for every
+  // thread, so that the threads stay busy even if the splits are unbalanced.
+  // The nodes that were split are kept in order, so that their statistics can
+  // be computed from the bottom up once their children are built.
+  std::vector<Octree*> subtrees(1, this);
+  std::vector<arma::vec> centers(1, center);
+  std::vector<double> widths(1, width);
+  std::vector<Octree*> splitNodes;
+  std::vector<Octree*> leaves;
+  std::vector<arma::vec> childCenters;
+  while (!subtrees.empty() && subtrees.size() < 4 * numThreads)
+  {
+    size_t largest = 0;
+    for (size_t i = 1; i < subtrees.size(); ++i)
+      if (subtrees[i]->count > subtrees[largest]->count)
+        largest = i;
+
+    // It isn't worth splitting small subtrees serially.
+    if (subtrees[largest]->count < 1000)
+      break;
+
+    Octree* node = subtrees[largest];
+    const arma::vec nodeCenter = centers[largest];
+    const double nodeWidth = widths[largest];
+    subtrees.erase(subtrees.begin() + largest);
+    centers.erase(centers.begin() + largest);
+    widths.erase(widths.begin() + largest);
+
+    if (node->SplitOnce(nodeCenter, nodeWidth, oldFromNew, maxLeafSize,
+        childCenters))
     {
-      // Is the dimension "right" (1) or "left" (0)?
-      if (((i >> d) & 1) == 0)
-        childCenter[d] = center[d] - childWidth;
-      else
-        childCenter[d] = center[d] + childWidth;
+      splitNodes.push_back(node);
+      for (size_t i = 0; i < node->children.size(); ++i)
+      {
+        subtrees.push_back(node->children[i]);
+        centers.push_back(childCenters[i]);
+        widths.push_back(nodeWidth / 2.0);
+      }
+    }
+    else
+    {
+      leaves.push_back(node);
     }
+  }
 
+  // Each subtree only rearranges its own columns of the dataset and of
+  // oldFromNew, so they can all be built at once.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    Octree* node = subtrees[i];
+    if (oldFromNew)
+      node->SplitNode(centers[i], widths[i], *oldFromNew, maxLeafSize);
+    else
+      node->SplitNode(centers[i], widths[i], maxLeafSize);
+
+    // The root's statistic is created by its constructor.
+    if (node != this)
+      node->stat = StatisticType(*node);
+  }
+
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    if (leaves[i] != this)
+      leaves[i]->stat = StatisticType(*leaves[i]);
+  }
+
+  for (size_t i = splitNodes.size(); i > 0; --i)
+  {
+    if (splitNodes[i - 1] != this)
+      splitNodes[i - 1]->stat = StatisticType(*splitNodes[i - 1]);
+  }
+}
+
+//! Split the node once, without splitting the children.
+template<typename MetricType, typename StatisticType, typename MatType>
+bool Octree<MetricType, StatisticType, MatType>::SplitOnce(
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize,
+    std::vector<arma::vec>& childCenters)
+{
+  childCenters.clear();
+  if (count <= maxLeafSize)
+    return false;
+
+  arma::Col<size_t> childBegins;
+  PartitionNode(center, oldFromNew, childBegins);
+
+  arma::vec childCenter;
+  for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+  {
+    // If the child has no points, don't create it.
+    if (childBegins[i + 1] - childBegins[i] == 0)
+      continue;
+
+    ChildCenter(center, width, i, childCenter);
+    childCenters.push_back(childCenter);
     children.push_back(new Octree(this, childBegins[i],
-        childBegins[i + 1] - childBegins[i], oldFromNew, childCenter,
-        childWidth, maxLeafSize));
+        childBegins[i + 1] - childBegins[i]));
   }
+
+  return true;
 }
 
 } // namespace tree
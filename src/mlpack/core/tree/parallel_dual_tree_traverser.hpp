@@ -0,0 +1,134 @@
+/**
+ * @file parallel_dual_tree_traverser.hpp
+ *
+ * A dual-tree traverser which splits the query tree into a set of disjoint
+ * subtrees and traverses each of them against the reference tree in parallel,
+ * using one copy of the rules per thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "tree_traits.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The ParallelDualTreeTraverser runs an existing dual-tree traversal
+ * (DualTreeTraversalType) in parallel.  The query tree is expanded, largest
+ * node first, until it is split into at least a given number of disjoint
+ * subtrees; each of those subtrees is then traversed against the whole
+ * reference tree by one thread.
+ *
+ * Each thread works with its own copy of the rules, so that any per-query
+ * state held by the rules (for instance the candidate lists of
+ * NeighborSearchRules) is never shared between threads.  Since every query
+ * node below the split belongs to exactly one subtree, the bounds stored in
+ * the statistics of the query nodes are only ever modified by one thread, and
+ * no synchronization is needed.  This means that RuleType must satisfy the
+ * following:
+ *
+ *  - RuleType must be copy-constructible, and copies must be independent
+ *    except for state that is indexed by query point (such as result lists).
+ *  - Score() and BaseCase() must not modify the statistics of reference nodes.
+ *
+ * This holds for NeighborSearchRules and RangeSearchRules, but not for rules
+ * that carry global state shared by all query points, such as the rules used
+ * by dual-tree k-means, unless that state is synchronized (as the DTBRules do
+ * with atomics).
+ *
+ * Trees whose children may share points (UniqueNumDescendants is false, as for
+ * spill trees) cannot be split into disjoint subtrees, so for those types the
+ * traversal is always run sequentially with a single copy of the rules.
+ *
+ * After Traverse() is called, the results for the points of Subtree(i) are held
+ * by Rules()[SubtreeOwner(i)].
+ *
+ * @tparam TreeType Type of the query and reference trees.
+ * @tparam RuleType Type of rules to use for the traversal.
+ * @tparam DualTreeTraversalType Sequential dual-tree traverser to run on each
+ *     subtree.
+ */
+template<typename TreeType,
+         typename RuleType,
+         template<typename> class DualTreeTraversalType>
+class ParallelDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the parallel dual-tree traverser.  One copy of the given rules
+   * is made for each available thread.  If minSubtrees is 0, the query tree is
+   * split into four subtrees per thread (or not at all if only one thread is
+   * available).
+   *
+   * @param rule Rules to copy for each thread.
+   * @param minSubtrees Minimum number of subtrees to split the query tree into.
+   */
+  ParallelDualTreeTraverser(const RuleType& rule,
+                            const size_t minSubtrees = 0);
+
+  /**
+   * Traverse the two trees.  This does not reset the statistics of either
+   * tree.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  void Traverse(TreeType& queryNode, TreeType& referenceNode);
+
+  //! Get the per-thread rules.
+  const std::vector<RuleType>& Rules() const { return rules; }
+  //! Modify the per-thread rules.
+  std::vector<RuleType>& Rules() { return rules; }
+
+  //! Get the number of query subtrees used by the last traversal.
+  size_t NumSubtrees() const { return subtrees.size(); }
+  //! Get the given query subtree of the last traversal.
+  TreeType& Subtree(const size_t i) const { return *subtrees[i]; }
+  //! Get the index of the rules that were used to traverse the given subtree.
+  size_t SubtreeOwner(const size_t i) const { return owners[i]; }
+
+  //! Get the minimum number of subtrees to split the query tree into.
+  size_t MinSubtrees() const { return minSubtrees; }
+  //! Modify the minimum number of subtrees to split the query tree into.
+  size_t& MinSubtrees() { return minSubtrees; }
+
+  //! Get the number of prunes made by all threads.
+  size_t NumPrunes() const { return numPrunes; }
+
+ private:
+  //! Split the query tree into at least minSubtrees disjoint subtrees.
+  void SplitQueryTree(TreeType& queryNode);
+
+  //! One copy of the rules for each thread.
+  std::vector<RuleType> rules;
+  //! The minimum number of subtrees to split the query tree into.
+  size_t minSubtrees;
+  //! The traversal information every subtree traversal starts from, just like
+  //! the root combination would.
+  typename RuleType::TraversalInfoType traversalInfo;
+  //! The query subtrees of the last traversal.
+  std::vector<TreeType*> subtrees;
+  //! The index of the rules used for each query subtree.
+  std::vector<size_t> owners;
+  //! The number of prunes made by all threads.
+  size_t numPrunes;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_dual_tree_traverser_impl.hpp"
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file parallel_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the ParallelDualTreeTraverser class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType,
+         typename RuleType,
+         template<typename> class DualTreeTraversalType>
+ParallelDualTreeTraverser<TreeType, RuleType, DualTreeTraversalType>::
+ParallelDualTreeTraverser(const RuleType& rule, const size_t minSubtrees) :
+    minSubtrees(minSubtrees),
+    traversalInfo(rule.TraversalInfo()),
+    numPrunes(0)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+  if (TreeTraits<TreeType>::UniqueNumDescendants)
+    numThreads = omp_get_max_threads();
+  #endif
+
+  if (this->minSubtrees == 0)
+    this->minSubtrees = (numThreads > 1) ? 4 * numThreads : 1;
+
+  rules.reserve(numThreads);
+  for (size_t i = 0; i < numThreads; ++i)
+    rules.push_back(rule);
+}
+
+template<typename TreeType,
+         typename RuleType,
+         template<typename> class DualTreeTraversalType>
+void ParallelDualTreeTraverser<TreeType, RuleType, DualTreeTraversalType>::
+Traverse(TreeType& queryNode, TreeType& referenceNode)
+{
+  SplitQueryTree(queryNode);
+  owners.assign(subtrees.size(), 0);
+
+  size_t totalPrunes = 0;
+
+  // The team is limited to the number of copies of the rules, in case the
+  // number of available threads has changed since construction.
+  #pragma omp parallel num_threads(rules.size()) reduction(+:totalPrunes)
+  {
+    size_t thread = 0;
+    #ifdef HAS_OPENMP
+    thread = omp_get_thread_num();
+    #endif
+
+    RuleType& rule = rules[thread];
+    DualTreeTraversalType<RuleType> traverser(rule);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+    {
+      rule.TraversalInfo() = traversalInfo;
+      traverser.Traverse(*subtrees[i], referenceNode);
+      owners[i] = thread;
+    }
+
+    totalPrunes += traverser.NumPrunes();
+  }
+
+  numPrunes += totalPrunes;
+}
+
+template<typename TreeType,
+         typename RuleType,
+         template<typename> class DualTreeTraversalType>
+void ParallelDualTreeTraverser<TreeType, RuleType, DualTreeTraversalType>::
+SplitQueryTree(TreeType& queryNode)
+{
+  subtrees.clear();
+  subtrees.push_back(&queryNode);
+
+  if (!TreeTraits<TreeType>::UniqueNumDescendants)
+    return;
+
+  // Repeatedly replace the largest subtree by its children.
+  while (subtrees.size() < minSubtrees)
+  {
+    size_t largest = subtrees.size();
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (subtrees[i]->NumChildren() > 0 && (largest == subtrees.size() ||
+          subtrees[i]->NumDescendants() > subtrees[largest]->NumDescendants()))
+        largest = i;
+    }
+
+    // Every subtree is a leaf.
+    if (largest == subtrees.size())
+      break;
+
+    TreeType* node = subtrees[largest];
+    subtrees[largest] = &node->Child(0);
+    for (size_t i = 1; i < node->NumChildren(); ++i)
+      subtrees.push_back(&node->Child(i));
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
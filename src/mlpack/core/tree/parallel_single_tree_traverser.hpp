@@ -0,0 +1,134 @@
+/**
+ * @file parallel_single_tree_traverser.hpp
+ *
+ * A single-tree traverser which splits the query points into blocks and
+ * traverses the reference tree with each block in parallel, using one copy of
+ * the rules per thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_SINGLE_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_PARALLEL_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The ParallelSingleTreeTraverser runs an existing single-tree traversal
+ * (TraverserType) for a set of query points in parallel.  The query points are
+ * split into blocks of consecutive points, and each block is traversed by one
+ * thread.  Since the traversals of different query points are independent,
+ * this works with every tree type.
+ *
+ * Each thread works with its own copy of the rules, so that any state held by
+ * the rules is never shared between threads.  This means that RuleType must
+ * satisfy the following:
+ *
+ *  - RuleType must be copy-constructible, and copies must be independent
+ *    except for state that is indexed by query point (such as result lists).
+ *  - Score() and BaseCase() must not modify the statistics of reference nodes.
+ *
+ * This holds for NeighborSearchRules and RangeSearchRules, except with trees
+ * that have self-children (such as cover trees): for those the rules cache the
+ * last distance evaluation in the statistic of each reference node.  If the
+ * rules don't satisfy these conditions, the traverser can be told to use a
+ * single thread.
+ *
+ * After Traverse() is called, the results for query point i are held by
+ * Rules()[QueryOwner(i)].
+ *
+ * @tparam TreeType Type of the reference tree.
+ * @tparam RuleType Type of rules to use for the traversal.
+ * @tparam TraverserType Sequential single-tree traverser to run for each query
+ *     point; it must be constructible from a RuleType&.
+ */
+template<typename TreeType, typename RuleType, typename TraverserType>
+class ParallelSingleTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the parallel single-tree traverser.  One copy of the given
+   * rules is made for each available thread, or only one if parallel is false.
+   *
+   * @param rule Rules to copy for each thread.
+   * @param parallel Whether the traversal may use more than one thread.
+   * @param blockSize Number of consecutive query points given to a thread at
+   *     once.
+   */
+  ParallelSingleTreeTraverser(const RuleType& rule,
+                              const bool parallel = true,
+                              const size_t blockSize = 16);
+
+  /**
+   * Traverse the reference tree with every query point in [0, numQueries).
+   *
+   * @param numQueries Number of query points.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const size_t numQueries, TreeType& referenceNode);
+
+  /**
+   * Traverse the reference tree with every query point in [0, numQueries),
+   * calling setup(traverser) on the traverser of each thread before it is
+   * used, so that it can be configured.
+   *
+   * @param numQueries Number of query points.
+   * @param referenceNode The tree node to be traversed.
+   * @param setup Function called with each traverser.
+   */
+  template<typename SetupType>
+  void Traverse(const size_t numQueries,
+                TreeType& referenceNode,
+                const SetupType& setup);
+
+  //! Get the per-thread rules.
+  const std::vector<RuleType>& Rules() const { return rules; }
+  //! Modify the per-thread rules.
+  std::vector<RuleType>& Rules() { return rules; }
+
+  //! Get the index of the rules that were used to traverse with the given
+  //! query point.
+  size_t QueryOwner(const size_t queryIndex) const
+  {
+    return owners[queryIndex / blockSize];
+  }
+
+  //! Get the number of consecutive query points given to a thread at once.
+  size_t BlockSize() const { return blockSize; }
+
+  //! Get the number of prunes made by all threads.
+  size_t NumPrunes() const { return numPrunes; }
+
+ private:
+  //! The setup used when the traversers don't need to be configured.
+  struct NoSetup
+  {
+    void operator()(TraverserType& /* traverser */) const { }
+  };
+
+  //! One copy of the rules for each thread.
+  std::vector<RuleType> rules;
+  //! The number of consecutive query points given to a thread at once.
+  size_t blockSize;
+  //! The index of the rules used for each block of query points.
+  std::vector<size_t> owners;
+  //! The number of prunes made by all threads.
+  size_t numPrunes;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_single_tree_traverser_impl.hpp"
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * @file parallel_single_tree_traverser_impl.hpp
+ *
+ * Implementation of the ParallelSingleTreeTraverser class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_PARALLEL_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_single_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType, typename RuleType, typename TraverserType>
+ParallelSingleTreeTraverser<TreeType, RuleType, TraverserType>::
+ParallelSingleTreeTraverser(const RuleType& rule,
+                            const bool parallel,
+                            const size_t blockSize) :
+    blockSize(std::max(blockSize, (size_t) 1)),
+    numPrunes(0)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+  if (parallel)
+    numThreads = omp_get_max_threads();
+  #else
+  (void) parallel;
+  #endif
+
+  rules.reserve(numThreads);
+  for (size_t i = 0; i < numThreads; ++i)
+    rules.push_back(rule);
+}
+
+template<typename TreeType, typename RuleType, typename TraverserType>
+void ParallelSingleTreeTraverser<TreeType, RuleType, TraverserType>::Traverse(
+    const size_t numQueries,
+    TreeType& referenceNode)
+{
+  Traverse(numQueries, referenceNode, NoSetup());
+}
+
+template<typename TreeType, typename RuleType, typename TraverserType>
+template<typename SetupType>
+void ParallelSingleTreeTraverser<TreeType, RuleType, TraverserType>::Traverse(
+    const size_t numQueries,
+    TreeType& referenceNode,
+    const SetupType& setup)
+{
+  const size_t numBlocks = (numQueries + blockSize - 1) / blockSize;
+  owners.assign(numBlocks, 0);
+
+  size_t totalPrunes = 0;
+
+  // The team is limited to the number of copies of the rules, in case the
+  // number of available threads has changed since construction.  With small
+  // query sets, there is no point in starting more threads than blocks.
+  #pragma omp parallel num_threads(std::max(std::min(rules.size(), \
+      numBlocks), (size_t) 1)) reduction(+:totalPrunes)
+  {
+    size_t thread = 0;
+    #ifdef HAS_OPENMP
+    thread = omp_get_thread_num();
+    #endif
+
+    RuleType& rule = rules[thread];
+    TraverserType traverser(rule);
+    setup(traverser);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t end = std::min((size_t) (b + 1) * blockSize, numQueries);
+      for (size_t i = (size_t) b * blockSize; i < end; ++i)
+        traverser.Traverse(i, referenceNode);
+      owners[b] = thread;
+    }
+
+    totalPrunes += traverser.NumPrunes();
+  }
+
+  numPrunes += totalPrunes;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @file prefetching_single_tree_traverser.hpp
+ *
+ * A depth-first single-tree traverser that asks the operating system to read
+ * the points of leaves ahead of time, for trees whose dataset is memory-mapped
+ * from disk.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PREFETCHING_SINGLE_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_PREFETCHING_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
+#include "tree_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The PrefetchingSingleTreeTraverser visits the reference tree depth-first,
+ * best child first, like the single-tree traversers of the trees themselves.
+ * In addition, when a leaf is scored and not pruned, the memory holding its
+ * points is passed to data::PrefetchMapping(), so that if the dataset is a
+ * memory-mapped file (as with MappedTree), the operating system starts reading
+ * those points from disk in the background while the traversal works on the
+ * nodes that are visited first.  With a tree that was saved by SaveFlat() after
+ * rearranging its dataset (as BinarySpaceTree does), the points of each leaf
+ * are contiguous in the file, so each leaf needs a single read.
+ *
+ * This traverser can be given to NeighborSearch as its SingleTreeTraversalType,
+ * so that a tree larger than memory can be searched:
+ *
+ * @code
+ * MappedTree<KNN::Tree> mapped("tree.bin");
+ * NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, KDTree,
+ *     KNN::Tree::DualTreeTraverser, PrefetchingSingleTreeTraverser>
+ *     knn(std::move(mapped.Tree()), SINGLE_TREE_MODE);
+ * @endcode
+ *
+ * For data that is already in memory, the prefetch requests cost a system call
+ * per leaf for nothing, so the trees' own traversers should be used instead.
+ *
+ * Trees whose first point is a centroid (such as cover trees) and trees in
+ * which a point can belong to several leaves (such as spill trees) need their
+ * own traversers, and can't be used with this one.
+ *
+ * @tparam RuleType The rules of the traversal.
+ */
+template<typename RuleType>
+class PrefetchingSingleTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the traverser with the given rule set.
+   */
+  PrefetchingSingleTreeTraverser(RuleType& rule);
+
+  /**
+   * Traverse the tree with the given point.
+   *
+   * @param queryIndex The index of the point in the query set which is being
+   *     used as the query point.
+   * @param referenceNode The tree node to be traversed.
+   */
+  template<typename TreeType>
+  void Traverse(const size_t queryIndex, TreeType& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+ private:
+  //! Ask for the points of the given node to be read from disk.
+  template<typename TreeType>
+  static void Prefetch(const TreeType& node);
+
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "prefetching_single_tree_traverser_impl.hpp"
+
+#endif
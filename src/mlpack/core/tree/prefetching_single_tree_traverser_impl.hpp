@@ -0,0 +1,108 @@
+/**
+ * @file prefetching_single_tree_traverser_impl.hpp
+ *
+ * Implementation of the PrefetchingSingleTreeTraverser class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PREFETCHING_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_PREFETCHING_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "prefetching_single_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename RuleType>
+PrefetchingSingleTreeTraverser<RuleType>::PrefetchingSingleTreeTraverser(
+    RuleType& rule) :
+    rule(rule),
+    numPrunes(0)
+{ /* Nothing to do. */ }
+
+template<typename RuleType>
+template<typename TreeType>
+void PrefetchingSingleTreeTraverser<RuleType>::Traverse(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  static_assert(!TreeTraits<TreeType>::FirstPointIsCentroid,
+      "PrefetchingSingleTreeTraverser can't be used with trees whose first "
+      "point is a centroid");
+  static_assert(TreeTraits<TreeType>::UniqueNumDescendants,
+      "PrefetchingSingleTreeTraverser can't be used with trees whose leaves "
+      "may share points");
+
+  // Some trees hold points in internal nodes too.
+  for (size_t i = 0; i < referenceNode.NumPoints(); ++i)
+    rule.BaseCase(queryIndex, referenceNode.Point(i));
+
+  if (referenceNode.IsLeaf())
+    return;
+
+  // Score every child, and prefetch the leaves that may be visited.
+  std::vector<std::pair<double, size_t>> scores;
+  scores.reserve(referenceNode.NumChildren());
+  for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
+  {
+    const double score = rule.Score(queryIndex, referenceNode.Child(i));
+    if (score == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    if (referenceNode.Child(i).IsLeaf())
+      Prefetch(referenceNode.Child(i));
+    scores.push_back(std::make_pair(score, i));
+  }
+
+  // Visit the best children first; ties are visited in order.
+  std::stable_sort(scores.begin(), scores.end(),
+      [](const std::pair<double, size_t>& a,
+         const std::pair<double, size_t>& b) { return a.first < b.first; });
+
+  for (size_t i = 0; i < scores.size(); ++i)
+  {
+    TreeType& child = referenceNode.Child(scores[i].second);
+
+    // Is it still valid to recurse into this child?
+    if (i > 0 && rule.Rescore(queryIndex, child, scores[i].first) == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    Traverse(queryIndex, child);
+  }
+}
+
+template<typename RuleType>
+template<typename TreeType>
+void PrefetchingSingleTreeTraverser<RuleType>::Prefetch(const TreeType& node)
+{
+  typedef typename TreeType::ElemType ElemType;
+  const size_t columnBytes = node.Dataset().n_rows * sizeof(ElemType);
+
+  // Prefetch each run of consecutive points with a single request.
+  size_t i = 0;
+  while (i < node.NumPoints())
+  {
+    const size_t begin = node.Point(i);
+    size_t end = begin + 1;
+    while (++i < node.NumPoints() && node.Point(i) == end)
+      ++end;
+
+    data::PrefetchMapping(node.Dataset().colptr(begin),
+        (end - begin) * columnBytes);
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
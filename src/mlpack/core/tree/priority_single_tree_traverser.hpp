@@ -0,0 +1,120 @@
+/**
+ * @file priority_single_tree_traverser.hpp
+ *
+ * A best-first single-tree traverser that can be stopped after a given number
+ * of base cases or at a given time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PRIORITY_SINGLE_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_PRIORITY_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/tree_traits.hpp>
+#include <chrono>
+#include <queue>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The PrioritySingleTreeTraverser visits the nodes of the reference tree in
+ * order of their score, using a priority queue, so that the most promising
+ * nodes are visited first whatever the tree type.  This makes it useful for
+ * anytime search: the traversal can be stopped once a limit on the number of
+ * base cases or a deadline is reached, and the best score of the nodes that
+ * were not visited is then available from RemainingScore().  For neighbor
+ * search, that score is a bound on the distance of any point that was not
+ * looked at, so it tells how far the results can be from the true ones.
+ *
+ * The traversal is never stopped before the first leaf has been visited.
+ *
+ * @tparam TreeType The tree type to traverse; it must satisfy the TreeType
+ *     policy API.
+ * @tparam RuleType The rules of the traversal.
+ */
+template<typename TreeType, typename RuleType>
+class PrioritySingleTreeTraverser
+{
+ public:
+  //! The clock used for the deadline.
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * Instantiate the traverser with the given rule set.  There is no limit on
+   * the number of base cases and no deadline.
+   */
+  PrioritySingleTreeTraverser(RuleType& rule);
+
+  /**
+   * Traverse the tree with the given point, until all nodes have been visited
+   * or pruned, or until the limit on the number of base cases or the deadline
+   * is reached.
+   *
+   * @param queryIndex The index of the point in the query set which is being
+   *     used as the query point.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const size_t queryIndex, TreeType& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of base cases evaluated by all traversals.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of base cases evaluated by all traversals.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+  //! Get the limit on NumBaseCases() at which traversals stop.
+  size_t BaseCaseLimit() const { return baseCaseLimit; }
+  //! Modify the limit on NumBaseCases() at which traversals stop.
+  size_t& BaseCaseLimit() { return baseCaseLimit; }
+
+  //! Get the time at which traversals stop.
+  Clock::time_point Deadline() const { return deadline; }
+  //! Modify the time at which traversals stop.
+  Clock::time_point& Deadline() { return deadline; }
+
+  //! Get the best score of the nodes that were not visited by the last
+  //! traversal because it was stopped (DBL_MAX if it was complete).
+  double RemainingScore() const { return remainingScore; }
+
+ private:
+  //! Return whether the base case limit or the deadline has been reached.
+  bool BudgetExhausted() const;
+
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+
+  //! The number of base cases evaluated by all traversals.
+  size_t numBaseCases;
+
+  //! The limit on numBaseCases at which traversals stop.
+  size_t baseCaseLimit;
+
+  //! The time at which traversals stop.
+  Clock::time_point deadline;
+
+  //! The best score of the nodes that the last traversal did not visit.
+  double remainingScore;
+
+  //! For trees in which a point can belong to several leaves, the last query
+  //! for which each reference point was evaluated (plus one).
+  std::vector<size_t> lastQuery;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "priority_single_tree_traverser_impl.hpp"
+
+#endif
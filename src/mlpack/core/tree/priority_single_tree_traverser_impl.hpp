@@ -0,0 +1,128 @@
+/**
+ * @file priority_single_tree_traverser_impl.hpp
+ *
+ * Implementation of the best-first single-tree traverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PRIORITY_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_PRIORITY_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "priority_single_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType, typename RuleType>
+PrioritySingleTreeTraverser<TreeType, RuleType>::PrioritySingleTreeTraverser(
+    RuleType& rule) :
+    rule(rule),
+    numPrunes(0),
+    numBaseCases(0),
+    baseCaseLimit(std::numeric_limits<size_t>::max()),
+    deadline(Clock::time_point::max()),
+    remainingScore(DBL_MAX)
+{ /* Nothing to do. */ }
+
+template<typename TreeType, typename RuleType>
+bool PrioritySingleTreeTraverser<TreeType, RuleType>::BudgetExhausted() const
+{
+  if (numBaseCases >= baseCaseLimit)
+    return true;
+
+  return (deadline != Clock::time_point::max()) && (Clock::now() >= deadline);
+}
+
+template<typename TreeType, typename RuleType>
+void PrioritySingleTreeTraverser<TreeType, RuleType>::Traverse(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  remainingScore = DBL_MAX;
+
+  const double rootScore = rule.Score(queryIndex, referenceNode);
+  if (rootScore == DBL_MAX)
+  {
+    ++numPrunes;
+    return;
+  }
+
+  // If a point can be held by several leaves (as in spill trees), remember
+  // which points have been evaluated, so that no point is returned twice.
+  const bool checkDuplicates = !TreeTraits<TreeType>::UniqueNumDescendants;
+  if (checkDuplicates && lastQuery.size() != referenceNode.Dataset().n_cols)
+    lastQuery.assign(referenceNode.Dataset().n_cols, 0);
+
+  // The queue of nodes to visit, best score first.
+  typedef std::pair<double, TreeType*> Frame;
+  std::priority_queue<Frame, std::vector<Frame>, std::greater<Frame>> queue;
+  queue.push(std::make_pair(rootScore, &referenceNode));
+
+  bool leafVisited = false;
+  while (!queue.empty())
+  {
+    if (leafVisited && BudgetExhausted())
+    {
+      remainingScore = queue.top().first;
+      return;
+    }
+
+    const Frame frame = queue.top();
+    queue.pop();
+    TreeType& node = *frame.second;
+
+    // The bound may have improved since the node was scored.
+    if (rule.Rescore(queryIndex, node, frame.first) == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    // When the first point of a node is its centroid, Score() has already
+    // evaluated the base case with it (as in cover trees).
+    if (TreeTraits<TreeType>::FirstPointIsCentroid)
+    {
+      ++numBaseCases;
+    }
+    else
+    {
+      for (size_t i = 0; i < node.NumPoints(); ++i)
+      {
+        const size_t point = node.Point(i);
+        if (checkDuplicates)
+        {
+          if (lastQuery[point] == queryIndex + 1)
+            continue;
+          lastQuery[point] = queryIndex + 1;
+        }
+
+        rule.BaseCase(queryIndex, point);
+        ++numBaseCases;
+      }
+    }
+
+    if (node.IsLeaf())
+    {
+      leafVisited = true;
+      continue;
+    }
+
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      const double score = rule.Score(queryIndex, node.Child(i));
+      if (score == DBL_MAX)
+        ++numPrunes;
+      else
+        queue.push(std::make_pair(score, &node.Child(i)));
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
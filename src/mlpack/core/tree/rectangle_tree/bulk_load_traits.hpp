@@ -0,0 +1,40 @@
+/**
+ * @file bulk_load_traits.hpp
+ *
+ * A trait class that tells how a RectangleTree that uses a given split type
+ * may be built from a whole dataset at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_TRAITS_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * BulkLoadTraits<SplitType> tells the RectangleTree constructors how to build
+ * the tree on a whole dataset.  The default is to insert the points one at a
+ * time in the order of the dataset, so custom split types keep their
+ * behavior.
+ */
+template<typename SplitType>
+struct BulkLoadTraits
+{
+  //! If true, the tree is packed bottom-up with Sort-Tile-Recursive instead of
+  //! inserting the points.  This is only possible if the nodes of the tree
+  //! have no invariant other than their fill and bounds.
+  static const bool SortTileRecursive = false;
+
+  //! If true, the points are inserted in the order of their Hilbert values
+  //! instead of the order of the dataset.
+  static const bool HilbertOrder = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
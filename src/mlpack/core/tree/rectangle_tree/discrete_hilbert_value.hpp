@@ -14,6 +14,7 @@
 #define MLPACK_CORE_TREE_RECTANGLE_TREE_DISCRETE_HILBERT_VALUE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/address.hpp>
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -153,60 +153,11 @@ DiscreteHilbertValue<TreeElemType>::
 CalculateValue(const VecType& pt,
                typename std::enable_if_t<IsVector<VecType>::value>*)
 {
-  typedef typename VecType::elem_type VecElemType;
   arma::Col<HilbertElemType> res(pt.n_rows);
-  // Calculate the number of bits for the exponent.
-  const int numExpBits = std::ceil(std::log2(
-      std::numeric_limits<VecElemType>::max_exponent -
-      std::numeric_limits<VecElemType>::min_exponent + 1.0));
 
-  // Calculate the number of bits for the mantissa.
-  const int numMantBits = order - numExpBits - 1;
-
-  for (size_t i = 0; i < pt.n_rows; i++)
-  {
-    int e;
-    VecElemType normalizedVal = std::frexp(pt(i), &e);
-    bool sgn = std::signbit(normalizedVal);
-
-    if (pt(i) == 0)
-      e = std::numeric_limits<VecElemType>::min_exponent;
-
-    if (sgn)
-      normalizedVal = -normalizedVal;
-
-    if (e < std::numeric_limits<VecElemType>::min_exponent)
-    {
-      HilbertElemType tmp = (HilbertElemType) 1 <<
-          (std::numeric_limits<VecElemType>::min_exponent - e);
-
-      e = std::numeric_limits<VecElemType>::min_exponent;
-      normalizedVal /= tmp;
-    }
-
-    // Extract the mantissa.
-    HilbertElemType tmp = (HilbertElemType) 1 << numMantBits;
-    res(i) = std::floor(normalizedVal * tmp);
-
-    // Add the exponent.
-    assert(res(i) < ((HilbertElemType) 1 << numMantBits));
-    res(i) |= ((HilbertElemType)
-        (e - std::numeric_limits<VecElemType>::min_exponent)) << numMantBits;
-
-    assert(res(i) < ((HilbertElemType) 1 << (order - 1)) - 1);
-
-    // Negative values should be inverted.
-    if (sgn)
-    {
-      res(i) = ((HilbertElemType) 1 << (order - 1)) - 1 - res(i);
-      assert((res(i) >> (order - 1)) == 0);
-    }
-    else
-    {
-      res(i) |= (HilbertElemType) 1 << (order - 1);
-      assert((res(i) >> (order - 1)) == 1);
-    }
-  }
+  // Map the coordinates to integers in the same way as the addresses of the
+  // UB tree.
+  bound::addr::PointToOrderedIntegers(pt, res);
 
   HilbertElemType M = (HilbertElemType) 1 << (order - 1);
 
@@ -244,17 +195,9 @@ CalculateValue(const VecType& pt,
     res(i) ^= t;
 
   // We should rearrange bits in order to compare two Hilbert values faster.
-  arma::Col<HilbertElemType> rearrangedResult(pt.n_rows, arma::fill::zeros);
-
-  for (size_t i = 0; i < order; i++)
-    for (size_t j = 0; j < pt.n_rows; j++)
-    {
-      size_t bit = (i * pt.n_rows + j) % order;
-      size_t row = (i * pt.n_rows + j) / order;
-
-      rearrangedResult(row) |= (((res(j) >> (order - 1 - i)) & 1) <<
-          (order - 1 - bit));
-    }
+  arma::Col<HilbertElemType> rearrangedResult(pt.n_rows);
+  bound::addr::BitInterleaver<HilbertElemType>(pt.n_rows).Interleave(res,
+      rearrangedResult);
 
   return rearrangedResult;
 }
@@ -19,6 +19,8 @@
 #include <algorithm>
 #include <stack>
 
+#include <mlpack/core/tree/base_case_block.hpp>
+
 namespace mlpack {
 namespace tree {
 
@@ -66,6 +68,11 @@ DualTreeTraverser<RuleType>::Traverse(RectangleTree& queryNode,
 
   if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
+    // The rule may be able to evaluate the base cases for the whole pair of
+    // leaves at once.
+    if (BaseCaseBlock(rule, queryNode, referenceNode, numBaseCases))
+      return;
+
     // Evaluate the base case.  Do the query points on the outside so we can
     // possibly prune the reference node for that particular point.
     for (size_t query = 0; query < queryNode.Count(); ++query)
@@ -14,6 +14,7 @@
 #define MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_R_TREE_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "bulk_load_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -90,6 +91,16 @@ class HilbertRTreeSplit
                                        const size_t lastSibling);
 };
 
+//! The points of a Hilbert R tree are inserted in the order of their Hilbert
+//! values, so every insertion appends to the last leaf and the split only ever
+//! moves points between the last nodes.
+template<size_t splitOrder>
+struct BulkLoadTraits<HilbertRTreeSplit<splitOrder>>
+{
+  static const bool SortTileRecursive = false;
+  static const bool HilbertOrder = true;
+};
+
 } // namespace tree
 } // namespace mlpack
 
@@ -14,6 +14,7 @@
 #define MLPACK_CORE_TREE_RECTANGLE_TREE_R_STAR_TREE_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "bulk_load_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -76,6 +77,15 @@ class RStarTreeSplit
   }
 };
 
+//! An R* tree has no invariant other than the fill and the bounds of its nodes,
+//! so it is packed with Sort-Tile-Recursive.
+template<>
+struct BulkLoadTraits<RStarTreeSplit>
+{
+  static const bool SortTileRecursive = true;
+  static const bool HilbertOrder = false;
+};
+
 } // namespace tree
 } // namespace mlpack
 
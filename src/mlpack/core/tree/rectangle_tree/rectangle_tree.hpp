@@ -20,6 +20,7 @@
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "bulk_load_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -542,6 +543,28 @@ class RectangleTree
    */
   void SplitNode(std::vector<bool>& relevels);
 
+  /**
+   * Build the tree on the points of the dataset from firstDataIndex on, as
+   * given by BulkLoadTraits<SplitType>: pack the nodes with Sort-Tile-Recursive,
+   * or insert the points in the order of their Hilbert values or in the order
+   * of the dataset.
+   *
+   * @param firstDataIndex The index of the first point to add to the tree.
+   */
+  void BuildTree(const size_t firstDataIndex);
+
+  /**
+   * Pack the points of the dataset from firstDataIndex on into full leaves
+   * ordered with Sort-Tile-Recursive, and then pack every level into full
+   * parents in the same way until the nodes fit in this root node.
+   *
+   * @param firstDataIndex The index of the first point to add to the tree.
+   */
+  void SortTileRecursiveBuild(const size_t firstDataIndex);
+
+  //! Compute the statistics of this node and its descendants bottom-up.
+  void BuildStatistics();
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -18,6 +18,9 @@
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/log.hpp>
 
+#include "sort_tile_recursive.hpp"
+#include "discrete_hilbert_value.hpp"
+
 namespace mlpack {
 namespace tree {
 
@@ -54,11 +57,7 @@ RectangleTree(const MatType& data,
 {
   stat = StatisticType(*this);
 
-  // For now, just insert the points in order.
-  RectangleTree* root = this;
-
-  for (size_t i = firstDataIndex; i < data.n_cols; i++)
-    root->InsertPoint(i);
+  BuildTree(firstDataIndex);
 }
 
 template<typename MetricType,
@@ -94,11 +93,7 @@ RectangleTree(MatType&& data,
 {
   stat = StatisticType(*this);
 
-  // For now, just insert the points in order.
-  RectangleTree* root = this;
-
-  for (size_t i = firstDataIndex; i < dataset->n_cols; i++)
-    root->InsertPoint(i);
+  BuildTree(firstDataIndex);
 }
 
 template<typename MetricType,
@@ -893,6 +888,186 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
   }
 }
 
+/**
+ * Build the tree on the points of the dataset from firstDataIndex on.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BuildTree(const size_t firstDataIndex)
+{
+  // Packing is only possible if the auxiliary information has nothing to
+  // maintain.
+  if (BulkLoadTraits<SplitType>::SortTileRecursive &&
+      std::is_same<AuxiliaryInformation,
+                   NoAuxiliaryInformation<RectangleTree>>::value)
+  {
+    SortTileRecursiveBuild(firstDataIndex);
+    return;
+  }
+
+  std::vector<size_t> order(dataset->n_cols - firstDataIndex);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = firstDataIndex + i;
+
+  if (BulkLoadTraits<SplitType>::HilbertOrder)
+  {
+    typedef DiscreteHilbertValue<ElemType> HilbertValue;
+    typedef typename HilbertValue::HilbertElemType HilbertElemType;
+
+    // The Hilbert values are the expensive part, so compute them in parallel.
+    arma::Mat<HilbertElemType> values(dataset->n_rows, order.size());
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) order.size(); ++i)
+      values.col(i) = HilbertValue::CalculateValue(dataset->col(order[i]));
+
+    // Hilbert values are compared lexicographically.
+    std::sort(order.begin(), order.end(),
+        [&values, firstDataIndex](const size_t a, const size_t b)
+        {
+          const HilbertElemType* valueA = values.colptr(a - firstDataIndex);
+          const HilbertElemType* valueB = values.colptr(b - firstDataIndex);
+          return std::lexicographical_compare(valueA, valueA + values.n_rows,
+              valueB, valueB + values.n_rows);
+        });
+  }
+
+  for (size_t i = 0; i < order.size(); ++i)
+    InsertPoint(order[i]);
+}
+
+/**
+ * Pack the tree bottom-up with Sort-Tile-Recursive.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    SortTileRecursiveBuild(const size_t firstDataIndex)
+{
+  const size_t numPoints = dataset->n_cols - firstDataIndex;
+
+  // Small datasets fit in the root.
+  if (numPoints <= maxLeafSize)
+  {
+    for (size_t i = firstDataIndex; i < dataset->n_cols; ++i)
+    {
+      bound |= dataset->col(i);
+      points[count++] = i;
+    }
+    numDescendants = count;
+    return;
+  }
+
+  // Pack the points into the smallest possible number of leaves; since the
+  // sizes of the leaves differ by at most one, each leaf is more than half
+  // full.
+  std::vector<size_t> order(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    order[i] = firstDataIndex + i;
+
+  size_t numNodes = (numPoints + maxLeafSize - 1) / maxLeafSize;
+  SortTileRecursive::Order(*dataset, order, numNodes);
+
+  std::vector<RectangleTree*> nodes(numNodes);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numNodes; ++i)
+  {
+    RectangleTree* leaf = new RectangleTree(this);
+    const size_t first = SortTileRecursive::GroupBegin(numPoints, numNodes, i);
+    const size_t last = SortTileRecursive::GroupBegin(numPoints, numNodes,
+        i + 1);
+    for (size_t j = first; j < last; ++j)
+    {
+      leaf->bound |= dataset->col(order[j]);
+      leaf->points[leaf->count++] = order[j];
+    }
+    leaf->numDescendants = leaf->count;
+    nodes[i] = leaf;
+  }
+
+  // Pack every level into parents until the nodes fit in the root.  The nodes
+  // are tiled by the centers of their bounds.
+  while (nodes.size() > maxNumChildren)
+  {
+    arma::Mat<ElemType> centers(bound.Dim(), nodes.size());
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) nodes.size(); ++i)
+    {
+      arma::Col<ElemType> center;
+      nodes[i]->bound.Center(center);
+      centers.col(i) = center;
+    }
+
+    order.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+      order[i] = i;
+
+    numNodes = (nodes.size() + maxNumChildren - 1) / maxNumChildren;
+    SortTileRecursive::Order(centers, order, numNodes);
+
+    std::vector<RectangleTree*> parents(numNodes);
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) numNodes; ++i)
+    {
+      RectangleTree* node = new RectangleTree(this);
+      const size_t first = SortTileRecursive::GroupBegin(nodes.size(),
+          numNodes, i);
+      const size_t last = SortTileRecursive::GroupBegin(nodes.size(),
+          numNodes, i + 1);
+      for (size_t j = first; j < last; ++j)
+      {
+        RectangleTree* child = nodes[order[j]];
+        child->parent = node;
+        node->bound |= child->bound;
+        node->numDescendants += child->numDescendants;
+        node->children[node->numChildren++] = child;
+      }
+      parents[i] = node;
+    }
+
+    nodes.swap(parents);
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    nodes[i]->parent = this;
+    bound |= nodes[i]->bound;
+    numDescendants += nodes[i]->numDescendants;
+    children[numChildren++] = nodes[i];
+  }
+
+  // The nodes were empty when their statistics were built.
+  BuildStatistics();
+}
+
+/**
+ * Compute the statistics of this node and its descendants bottom-up.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::BuildStatistics()
+{
+  for (size_t i = 0; i < numChildren; ++i)
+    children[i]->BuildStatistics();
+
+  stat = StatisticType(*this);
+}
+
 //! Default constructor for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -0,0 +1,136 @@
+/**
+ * @file sort_tile_recursive.hpp
+ *
+ * Definition of the SortTileRecursive class, which orders a set of points so
+ * that they can be packed into the nodes of a RectangleTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_SORT_TILE_RECURSIVE_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_SORT_TILE_RECURSIVE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The Sort-Tile-Recursive (STR) packing order.  The items are split into
+ * groups whose sizes differ by at most one, so that consecutive groups of the
+ * returned order are small tiles of the space: the items are sorted along the
+ * dimension with the largest range and cut into S slabs, where S is the d-th
+ * root of the number of groups, and every slab is tiled recursively along the
+ * remaining dimensions.  The slabs of the first dimension are tiled in
+ * parallel.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{leutenegger1997str,
+ *   title     = {STR: A Simple and Efficient Algorithm for R-Tree Packing},
+ *   author    = {Leutenegger, Scott T. and Lopez, Mario A. and Edgington,
+ *                Jeffrey},
+ *   booktitle = {Proceedings of the 13th International Conference on Data
+ *                Engineering},
+ *   pages     = {497--506},
+ *   year      = {1997}
+ * }
+ * @endcode
+ */
+class SortTileRecursive
+{
+ public:
+  /**
+   * Return the position of the first item of the given group when numItems
+   * items are split into numGroups groups whose sizes differ by at most one.
+   */
+  static size_t GroupBegin(const size_t numItems,
+                           const size_t numGroups,
+                           const size_t group)
+  {
+    return group * (numItems / numGroups) +
+        std::min(group, numItems % numGroups);
+  }
+
+  /**
+   * Reorder the given items so that every group (see GroupBegin()) is a tile.
+   *
+   * @param coordinates The coordinates of the items, one column per item.
+   * @param order The columns of the items to order.  This will be modified.
+   * @param numGroups The number of groups the items will be split into.
+   */
+  template<typename MatType>
+  static void Order(const MatType& coordinates,
+                    std::vector<size_t>& order,
+                    const size_t numGroups)
+  {
+    // Tile the dimensions with the largest ranges first.
+    arma::Col<typename MatType::elem_type> lo(coordinates.n_rows);
+    arma::Col<typename MatType::elem_type> hi(coordinates.n_rows);
+    lo.fill(std::numeric_limits<typename MatType::elem_type>::max());
+    hi.fill(std::numeric_limits<typename MatType::elem_type>::lowest());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+      lo = arma::min(lo, coordinates.col(order[i]));
+      hi = arma::max(hi, coordinates.col(order[i]));
+    }
+    const arma::uvec dimensions = arma::sort_index(hi - lo, "descend");
+
+    Tile(coordinates, order, numGroups, 0, numGroups, dimensions, 0);
+  }
+
+ private:
+  /**
+   * Order the items of the groups [firstGroup, lastGroup), starting with the
+   * given dimension.
+   */
+  template<typename MatType>
+  static void Tile(const MatType& coordinates,
+                   std::vector<size_t>& order,
+                   const size_t numGroups,
+                   const size_t firstGroup,
+                   const size_t lastGroup,
+                   const arma::uvec& dimensions,
+                   const size_t dimension)
+  {
+    const size_t groups = lastGroup - firstGroup;
+    if (groups <= 1)
+      return;
+
+    const size_t first = GroupBegin(order.size(), numGroups, firstGroup);
+    const size_t last = GroupBegin(order.size(), numGroups, lastGroup);
+    const size_t dim = dimensions[dimension];
+    std::sort(order.begin() + first, order.begin() + last,
+        [&coordinates, dim](const size_t a, const size_t b)
+        {
+          return coordinates(dim, a) < coordinates(dim, b);
+        });
+
+    if (dimension + 1 == dimensions.n_elem)
+      return;
+
+    const size_t numSlabs = std::min(groups, (size_t) std::ceil(std::pow(
+        (double) groups, 1.0 / (dimensions.n_elem - dimension))));
+    const size_t groupsPerSlab = (groups + numSlabs - 1) / numSlabs;
+
+    #pragma omp parallel for schedule(dynamic) if (dimension == 0)
+    for (omp_size_t s = 0; s < (omp_size_t) numSlabs; ++s)
+    {
+      const size_t slabFirst = firstGroup + s * groupsPerSlab;
+      if (slabFirst < lastGroup)
+      {
+        Tile(coordinates, order, numGroups, slabFirst,
+            std::min(slabFirst + groupsPerSlab, lastGroup), dimensions,
+            dimension + 1);
+      }
+    }
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
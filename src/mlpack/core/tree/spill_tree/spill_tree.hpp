@@ -437,6 +437,55 @@ class SpillTree
                  const double tau,
                  const double rho);
 
+  /**
+   * Construct a child node of the given parent without splitting it yet.  This
+   * is used by ParallelSplitNode(), which splits the node afterwards.
+   *
+   * @param parent Parent of this node.
+   */
+  SpillTree(SpillTree* parent);
+
+  /**
+   * Split the current node like SplitNode(), but build the tree in parallel:
+   * the top of the tree is split serially until there are a few subtrees for
+   * every thread, and then the subtrees are built concurrently.  This is only
+   * used for the root of a large tree, and only with axis-orthogonal
+   * hyperplanes, since the other splits draw random numbers.
+   *
+   * @param points Vector of indexes of points to be included in this node.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   */
+  void ParallelSplitNode(arma::Col<size_t>& points,
+                         const size_t maxLeafSize,
+                         const double tau,
+                         const double rho);
+
+  /**
+   * Compute the bound of the current node and split its list of points, without
+   * creating the children.  If the node is not split, it becomes a leaf
+   * holding the given points.
+   *
+   * @param points Vector of indexes of points to be included in this node.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   * @param leftPoints Indexes of points to be included in left child.
+   * @param rightPoints Indexes of points to be included in right child.
+   * @return Whether the node was split.
+   */
+  bool SplitOnce(arma::Col<size_t>& points,
+                 const size_t maxLeafSize,
+                 const double tau,
+                 const double rho,
+                 arma::Col<size_t>& leftPoints,
+                 arma::Col<size_t>& rightPoints);
+
+  //! Once both children are built, compute the number of descendants and the
+  //! distances from the center of this node to the centers of its children.
+  void FinishSplit();
+
   /**
    * Split the list of points.
    *
@@ -16,6 +16,10 @@
 
 #include <queue>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -578,6 +582,156 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
               const size_t maxLeafSize,
               const double tau,
               const double rho)
+{
+  #ifdef HAS_OPENMP
+  // Large trees are built in parallel, if the splits are deterministic.
+  if (std::is_same<typename HyperplaneType<MetricType>::ProjVectorType,
+      AxisParallelProjVector>::value && parent == NULL &&
+      points.n_elem >= 100000 && omp_get_max_threads() > 1)
+  {
+    ParallelSplitNode(points, maxLeafSize, tau, rho);
+    return;
+  }
+  #endif
+
+  arma::Col<size_t> leftPoints, rightPoints;
+  if (!SplitOnce(points, maxLeafSize, tau, rho, leftPoints, rightPoints))
+    return; // We can't split this.
+
+  // Now we will recursively split the children by calling their constructors
+  // (which perform this splitting process).
+  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
+  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+
+  FinishSplit();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+SpillTree(SpillTree* parent) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    count(0),
+    pointsIndex(NULL),
+    overlappingNode(false),
+    hyperplane(),
+    bound(parent->Dataset().n_rows),
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    localDataset(false)
+{
+  // The node is split later by ParallelSplitNode().
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    ParallelSplitNode(arma::Col<size_t>& points,
+                      const size_t maxLeafSize,
+                      const double tau,
+                      const double rho)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Split the largest node serially until there are a few subtrees for every
+  // thread, so that the threads stay busy even if the splits are unbalanced.
+  // The nodes that were split are kept in order, so that they can be finished
+  // from the bottom up once their children are built.
+  std::vector<SpillTree*> subtrees(1, this);
+  std::vector<arma::Col<size_t>> subtreePoints(1);
+  subtreePoints[0].swap(points);
+  std::vector<SpillTree*> splitNodes;
+  std::vector<SpillTree*> leaves;
+  while (!subtrees.empty() && subtrees.size() < 4 * numThreads)
+  {
+    size_t largest = 0;
+    for (size_t i = 1; i < subtrees.size(); ++i)
+      if (subtreePoints[i].n_elem > subtreePoints[largest].n_elem)
+        largest = i;
+
+    // It isn't worth splitting small subtrees serially.
+    if (subtreePoints[largest].n_elem < 1000)
+      break;
+
+    SpillTree* node = subtrees[largest];
+    arma::Col<size_t> nodePoints;
+    nodePoints.swap(subtreePoints[largest]);
+    subtrees.erase(subtrees.begin() + largest);
+    subtreePoints.erase(subtreePoints.begin() + largest);
+
+    arma::Col<size_t> leftPoints, rightPoints;
+    if (node->SplitOnce(nodePoints, maxLeafSize, tau, rho, leftPoints,
+        rightPoints))
+    {
+      node->left = new SpillTree(node);
+      node->right = new SpillTree(node);
+      splitNodes.push_back(node);
+
+      subtrees.push_back(node->left);
+      subtreePoints.push_back(arma::Col<size_t>());
+      subtreePoints.back().swap(leftPoints);
+      subtrees.push_back(node->right);
+      subtreePoints.push_back(arma::Col<size_t>());
+      subtreePoints.back().swap(rightPoints);
+    }
+    else
+    {
+      leaves.push_back(node);
+    }
+  }
+
+  // The subtrees only read the dataset, so they can all be built at once.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    SpillTree* node = subtrees[i];
+    node->SplitNode(subtreePoints[i], maxLeafSize, tau, rho);
+
+    // The root's statistic is created by its constructor.
+    if (node != this)
+      node->stat = StatisticType(*node);
+  }
+
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    if (leaves[i] != this)
+      leaves[i]->stat = StatisticType(*leaves[i]);
+  }
+
+  for (size_t i = splitNodes.size(); i > 0; --i)
+  {
+    SpillTree* node = splitNodes[i - 1];
+    node->FinishSplit();
+    if (node != this)
+      node->stat = StatisticType(*node);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    SplitOnce(arma::Col<size_t>& points,
+              const size_t maxLeafSize,
+              const double tau,
+              const double rho,
+              arma::Col<size_t>& leftPoints,
+              arma::Col<size_t>& rightPoints)
 {
   // We need to expand the bounds of this node properly.
   for (size_t i = 0; i < points.n_elem; i++)
@@ -592,7 +746,7 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     pointsIndex = new arma::Col<size_t>();
     pointsIndex->swap(points);
     count = pointsIndex->n_elem;
-    return; // We can't split this.
+    return false; // We can't split this.
   }
 
   const bool split = SplitType<MetricType, MatType>::SplitSpace(bound,
@@ -604,21 +758,27 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     pointsIndex = new arma::Col<size_t>();
     pointsIndex->swap(points);
     count = pointsIndex->n_elem;
-    return; // We can't split this.
+    return false; // We can't split this.
   }
 
-  arma::Col<size_t> leftPoints, rightPoints;
   // Split the node.
   overlappingNode = SplitPoints(tau, rho, points, leftPoints, rightPoints);
 
   // We don't need the information in points, so lets clean it.
   arma::Col<size_t>().swap(points);
 
-  // Now we will recursively split the children by calling their constructors
-  // (which perform this splitting process).
-  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
-  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+  return true;
+}
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    FinishSplit()
+{
   // Update count number, to represent the number of descendant points.
   count = left->NumDescendants() + right->NumDescendants();
 
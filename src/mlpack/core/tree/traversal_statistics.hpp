@@ -0,0 +1,235 @@
+/**
+ * @file traversal_statistics.hpp
+ *
+ * Counters of the node combinations scored and pruned, per tree level, and of
+ * the base cases evaluated during a tree traversal.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/timers.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * TraversalStatistics collects what a traversal did: how many base cases were
+ * evaluated and how long they took, and how many times Score() and Rescore()
+ * were called, how long they took, and how many of the calls pruned.  The
+ * scores and prunes are also counted per level of the reference node and, for
+ * dual-tree traversals, per level of the query node; the root is at level 0.
+ *
+ * Each Score() call computes one distance (or kernel) bound between a node and
+ * a point or another node, and each base case usually one distance between two
+ * points, so BaseCases() + Scores() is the number of distance evaluations of
+ * the traversal (rules that cache base cases may evaluate fewer).
+ *
+ * The statistics are usually collected by InstrumentedRules and reported as
+ * counters of the mlpack timers with Report().
+ */
+class TraversalStatistics
+{
+ public:
+  //! Create empty statistics.
+  TraversalStatistics() :
+      baseCases(0),
+      scores(0),
+      prunes(0),
+      rescores(0),
+      rescorePrunes(0),
+      baseCaseTime(0),
+      scoreTime(0)
+  { }
+
+  //! Record a base case that took the given time.
+  void BaseCase(const std::chrono::nanoseconds& time)
+  {
+    ++baseCases;
+    baseCaseTime += time;
+  }
+
+  /**
+   * Record a call to Score() with a reference node at the given level, which
+   * took the given time.
+   *
+   * @param referenceLevel Level of the reference node.
+   * @param pruned Whether the combination was pruned.
+   * @param time Time taken by Score().
+   */
+  void Score(const size_t referenceLevel,
+             const bool pruned,
+             const std::chrono::nanoseconds& time)
+  {
+    ++scores;
+    scoreTime += time;
+    Count(referenceVisits, referenceLevel);
+    if (pruned)
+    {
+      ++prunes;
+      Count(referencePrunes, referenceLevel);
+    }
+  }
+
+  /**
+   * Record a call to Score() with a query node and a reference node at the
+   * given levels, which took the given time.
+   *
+   * @param queryLevel Level of the query node.
+   * @param referenceLevel Level of the reference node.
+   * @param pruned Whether the combination was pruned.
+   * @param time Time taken by Score().
+   */
+  void Score(const size_t queryLevel,
+             const size_t referenceLevel,
+             const bool pruned,
+             const std::chrono::nanoseconds& time)
+  {
+    Score(referenceLevel, pruned, time);
+    Count(queryVisits, queryLevel);
+    if (pruned)
+      Count(queryPrunes, queryLevel);
+  }
+
+  //! Record a call to Rescore() that took the given time.
+  void Rescore(const bool pruned, const std::chrono::nanoseconds& time)
+  {
+    ++rescores;
+    scoreTime += time;
+    if (pruned)
+      ++rescorePrunes;
+  }
+
+  //! Add the statistics of another traversal.
+  void Merge(const TraversalStatistics& other)
+  {
+    baseCases += other.baseCases;
+    scores += other.scores;
+    prunes += other.prunes;
+    rescores += other.rescores;
+    rescorePrunes += other.rescorePrunes;
+    baseCaseTime += other.baseCaseTime;
+    scoreTime += other.scoreTime;
+    Merge(referenceVisits, other.referenceVisits);
+    Merge(referencePrunes, other.referencePrunes);
+    Merge(queryVisits, other.queryVisits);
+    Merge(queryPrunes, other.queryPrunes);
+  }
+
+  /**
+   * Add the statistics to the counters of the mlpack timers (see
+   * Timer::AddCounter()), under the given name: for instance,
+   * "<name>/base_cases", "<name>/scores" and
+   * "<name>/reference_level_3/prunes".  The times are reported in
+   * microseconds, as "<name>/base_case_us" and "<name>/score_us".
+   *
+   * @param name Name to report the statistics under.
+   */
+  void Report(const std::string& name) const
+  {
+    Timer::AddCounter(name + "/base_cases", baseCases);
+    Timer::AddCounter(name + "/scores", scores);
+    Timer::AddCounter(name + "/prunes", prunes);
+    Timer::AddCounter(name + "/rescores", rescores);
+    Timer::AddCounter(name + "/rescore_prunes", rescorePrunes);
+    Timer::AddCounter(name + "/base_case_us", std::chrono::duration_cast<
+        std::chrono::microseconds>(baseCaseTime).count());
+    Timer::AddCounter(name + "/score_us", std::chrono::duration_cast<
+        std::chrono::microseconds>(scoreTime).count());
+
+    Report(name + "/reference_level_", referenceVisits, referencePrunes);
+    Report(name + "/query_level_", queryVisits, queryPrunes);
+  }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of calls to Score().
+  size_t Scores() const { return scores; }
+  //! Get the number of calls to Score() that pruned.
+  size_t Prunes() const { return prunes; }
+  //! Get the number of calls to Rescore().
+  size_t Rescores() const { return rescores; }
+  //! Get the number of calls to Rescore() that pruned.
+  size_t RescorePrunes() const { return rescorePrunes; }
+  //! Get the time spent in base cases.
+  std::chrono::nanoseconds BaseCaseTime() const { return baseCaseTime; }
+  //! Get the time spent in Score() and Rescore().
+  std::chrono::nanoseconds ScoreTime() const { return scoreTime; }
+
+  //! Get the number of calls to Score() for each reference level.
+  const std::vector<size_t>& ReferenceVisits() const { return referenceVisits; }
+  //! Get the number of prunes for each reference level.
+  const std::vector<size_t>& ReferencePrunes() const { return referencePrunes; }
+  //! Get the number of calls to Score() for each query level.
+  const std::vector<size_t>& QueryVisits() const { return queryVisits; }
+  //! Get the number of prunes for each query level.
+  const std::vector<size_t>& QueryPrunes() const { return queryPrunes; }
+
+ private:
+  //! Increment the count of the given level.
+  static void Count(std::vector<size_t>& histogram, const size_t level)
+  {
+    if (histogram.size() <= level)
+      histogram.resize(level + 1, 0);
+    ++histogram[level];
+  }
+
+  //! Add another histogram to the given one.
+  static void Merge(std::vector<size_t>& histogram,
+                    const std::vector<size_t>& other)
+  {
+    if (histogram.size() < other.size())
+      histogram.resize(other.size(), 0);
+    for (size_t i = 0; i < other.size(); ++i)
+      histogram[i] += other[i];
+  }
+
+  //! Report the visits and prunes of each level.
+  static void Report(const std::string& prefix,
+                     const std::vector<size_t>& visits,
+                     const std::vector<size_t>& prunes)
+  {
+    for (size_t i = 0; i < visits.size(); ++i)
+    {
+      std::ostringstream oss;
+      oss << prefix << i;
+      Timer::AddCounter(oss.str() + "/visits", visits[i]);
+      if (i < prunes.size())
+        Timer::AddCounter(oss.str() + "/prunes", prunes[i]);
+    }
+  }
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of calls to Score().
+  size_t scores;
+  //! The number of calls to Score() that pruned.
+  size_t prunes;
+  //! The number of calls to Rescore().
+  size_t rescores;
+  //! The number of calls to Rescore() that pruned.
+  size_t rescorePrunes;
+  //! The time spent in base cases.
+  std::chrono::nanoseconds baseCaseTime;
+  //! The time spent in Score() and Rescore().
+  std::chrono::nanoseconds scoreTime;
+
+  //! The number of calls to Score() for each reference level.
+  std::vector<size_t> referenceVisits;
+  //! The number of prunes for each reference level.
+  std::vector<size_t> referencePrunes;
+  //! The number of calls to Score() for each query level.
+  std::vector<size_t> queryVisits;
+  //! The number of prunes for each query level.
+  std::vector<size_t> queryPrunes;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
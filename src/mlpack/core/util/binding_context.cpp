@@ -0,0 +1,56 @@
+/**
+ * @file binding_context.cpp
+ *
+ * Implementation of BindingContext and ScopedBindingContext.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "binding_context.hpp"
+
+using namespace mlpack;
+using namespace mlpack::util;
+
+BindingContext::BindingContext(const std::string& settings) : cli(new CLI())
+{
+  try
+  {
+    ScopedBindingContext scope(*this);
+    CLI::RestoreSettings(settings);
+  }
+  catch (std::exception&)
+  {
+    delete cli;
+    throw;
+  }
+}
+
+BindingContext::~BindingContext()
+{
+  delete cli;
+}
+
+bool BindingContext::HasParam(const std::string& identifier)
+{
+  ScopedBindingContext scope(*this);
+  return CLI::HasParam(identifier);
+}
+
+void BindingContext::SetPassed(const std::string& identifier)
+{
+  ScopedBindingContext scope(*this);
+  CLI::SetPassed(identifier);
+}
+
+ScopedBindingContext::ScopedBindingContext(BindingContext& context) :
+    previous(CLI::CurrentContext())
+{
+  CLI::CurrentContext() = context.cli;
+}
+
+ScopedBindingContext::~ScopedBindingContext()
+{
+  CLI::CurrentContext() = previous;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file binding_context.hpp
+ *
+ * Definition of BindingContext, which holds the parameters of one run of a
+ * binding, and ScopedBindingContext, which makes a context active.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_BINDING_CONTEXT_HPP
+#define MLPACK_CORE_UTIL_BINDING_CONTEXT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "cli.hpp"
+
+namespace mlpack {
+namespace util {
+
+/**
+ * A BindingContext holds the parameters of one run of a binding.  It starts
+ * with the settings stored for the program with CLI::StoreSettings(), and
+ * while it is active in a thread (with Run() or a ScopedBindingContext), the
+ * static CLI methods called from that thread, such as CLI::GetParam() and
+ * CLI::HasParam(), use the parameters of the context instead of those of the
+ * thread.
+ *
+ * So a process can hold any number of runs of bindings at once, each in its
+ * own context, and run them in parallel in different threads; for instance, a
+ * server that embeds the mlpackMain() functions of bindings can handle many
+ * requests at the same time:
+ *
+ * @code
+ * // In each request, possibly in different threads.
+ * BindingContext context("knn");
+ * context.GetParam<arma::mat>("reference") = std::move(referenceSet);
+ * context.SetPassed("reference");
+ * context.GetParam<int>("k") = 5;
+ * context.SetPassed("k");
+ * context.SetPassed("neighbors");
+ *
+ * context.Run(mlpackMain);
+ * arma::Mat<size_t> neighbors =
+ *     std::move(context.GetParam<arma::Mat<size_t>>("neighbors"));
+ * @endcode
+ *
+ * Like CLI::ClearSettings(), destroying a context does not free the models
+ * that its parameters point to.  The stored settings, the ProgramDoc and the
+ * timers are shared by all contexts, as they are by all threads.
+ */
+class BindingContext
+{
+ public:
+  /**
+   * Create a context holding the settings stored under the given name with
+   * CLI::StoreSettings().  A std::invalid_argument is thrown if no settings are
+   * stored under that name.
+   *
+   * @param settings Name of the stored settings.
+   */
+  explicit BindingContext(const std::string& settings);
+
+  //! Destroy the context.
+  ~BindingContext();
+
+  BindingContext(const BindingContext&) = delete;
+  BindingContext& operator=(const BindingContext&) = delete;
+
+  /**
+   * Call the given function with this context active in the calling thread.
+   * The context must not be active in another thread at the same time.
+   *
+   * @param function Function to call (for instance mlpackMain).
+   */
+  template<typename FunctionType>
+  void Run(FunctionType&& function);
+
+  //! Get the value of the given parameter of this context (see
+  //! CLI::GetParam()).
+  template<typename T>
+  T& GetParam(const std::string& identifier);
+
+  //! Return whether the given parameter of this context was passed.
+  bool HasParam(const std::string& identifier);
+
+  //! Mark the given parameter of this context as passed.
+  void SetPassed(const std::string& identifier);
+
+ private:
+  //! The parameters of the context.
+  CLI* cli;
+
+  //! So that the context can be activated.
+  friend class ScopedBindingContext;
+};
+
+/**
+ * A ScopedBindingContext makes the given context active in the calling thread
+ * while it exists; the previously active context (or the thread's own
+ * parameters) is active again when it is destroyed.
+ */
+class ScopedBindingContext
+{
+ public:
+  //! Make the given context active.
+  explicit ScopedBindingContext(BindingContext& context);
+
+  //! Make the previously active context active again.
+  ~ScopedBindingContext();
+
+  ScopedBindingContext(const ScopedBindingContext&) = delete;
+  ScopedBindingContext& operator=(const ScopedBindingContext&) = delete;
+
+ private:
+  //! The previously active context.
+  CLI* previous;
+};
+
+template<typename FunctionType>
+void BindingContext::Run(FunctionType&& function)
+{
+  ScopedBindingContext scope(*this);
+  function();
+}
+
+template<typename T>
+T& BindingContext::GetParam(const std::string& identifier)
+{
+  ScopedBindingContext scope(*this);
+  return CLI::GetParam<T>(identifier);
+}
+
+} // namespace util
+} // namespace mlpack
+
+#endif
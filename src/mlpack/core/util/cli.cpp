@@ -31,13 +31,16 @@ static ProgramDoc emptyProgramDoc = ProgramDoc("", []() { return ""; });
 
 /* Constructors, Destructors, Copy */
 /* Make the constructor private, to preclude unauthorized instances */
-CLI::CLI() : didParse(false), doc(&emptyProgramDoc)
+CLI::CLI() : didParse(false), timer(Shared().timer), doc(Shared().doc)
 {
   return;
 }
 
 // Private copy constructor; don't want copies floating around.
-CLI::CLI(const CLI& /* other */) : didParse(false), doc(&emptyProgramDoc)
+CLI::CLI(const CLI& /* other */) :
+    didParse(false),
+    timer(Shared().timer),
+    doc(Shared().doc)
 {
   return;
 }
@@ -118,13 +121,37 @@ bool CLI::HasParam(const std::string& key)
   return (parameters.at(checkKey).wasPassed > 0);
 }
 
-// Returns the sole instance of this class.
+// Returns the instance of this class of the calling thread, or its active
+// context.
 CLI& CLI::GetSingleton()
 {
-  static CLI singleton;
+  CLI* context = CurrentContext();
+  if (context != NULL)
+    return *context;
+
+  static thread_local CLI singleton;
   return singleton;
 }
 
+// Returns the active context of the calling thread.
+CLI*& CLI::CurrentContext()
+{
+  static thread_local CLI* context = NULL;
+  return context;
+}
+
+// Returns the state shared by the instances of all threads.
+CLI::SharedState& CLI::Shared()
+{
+  static SharedState shared;
+  return shared;
+}
+
+CLI::SharedState::SharedState() : doc(&emptyProgramDoc)
+{
+  // Nothing to do.
+}
+
 /**
  * Registers a ProgramDoc object, which contains documentation about the
  * program.
@@ -175,9 +202,12 @@ void CLI::StoreSettings(const std::string& name)
 {
   // Take all of the parameters and put them in the map.  Clear anything old
   // first.
-  std::get<0>(GetSingleton().storageMap[name]) = GetSingleton().parameters;
-  std::get<1>(GetSingleton().storageMap[name]) = GetSingleton().aliases;
-  std::get<2>(GetSingleton().storageMap[name]) = GetSingleton().functionMap;
+  {
+    std::lock_guard<std::mutex> lock(Shared().storageMutex);
+    std::get<0>(Shared().storageMap[name]) = GetSingleton().parameters;
+    std::get<1>(Shared().storageMap[name]) = GetSingleton().aliases;
+    std::get<2>(Shared().storageMap[name]) = GetSingleton().functionMap;
+  }
 
   ClearSettings();
 }
@@ -185,21 +215,24 @@ void CLI::StoreSettings(const std::string& name)
 // Restore settings.
 void CLI::RestoreSettings(const std::string& name, const bool fatal)
 {
-  if (GetSingleton().storageMap.count(name) == 0 && fatal)
+  std::unique_lock<std::mutex> lock(Shared().storageMutex);
+  StorageMapType::const_iterator it = Shared().storageMap.find(name);
+  if (it == Shared().storageMap.end() && fatal)
   {
     throw std::invalid_argument("no settings stored under the name '" + name
         + "'");
   }
-  else if (GetSingleton().storageMap.count(name) == 0 && !fatal)
+  else if (it == Shared().storageMap.end() && !fatal)
   {
     // Nothing to do, just clear what's there.
+    lock.unlock();
     ClearSettings();
   }
   else
   {
-    GetSingleton().parameters = std::get<0>(GetSingleton().storageMap[name]);
-    GetSingleton().aliases = std::get<1>(GetSingleton().storageMap[name]);
-    GetSingleton().functionMap = std::get<2>(GetSingleton().storageMap[name]);
+    GetSingleton().parameters = std::get<0>(it->second);
+    GetSingleton().aliases = std::get<1>(it->second);
+    GetSingleton().functionMap = std::get<2>(it->second);
   }
 }
 
@@ -17,6 +17,7 @@
 #include <list>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <string>
 
 #include <boost/any.hpp>
@@ -36,6 +37,11 @@ namespace util {
 // program being run.
 class ProgramDoc;
 
+// Defined in binding_context.hpp; these can replace the parameters of the
+// calling thread.
+class BindingContext;
+class ScopedBindingContext;
+
 } // namespace util
 
 /**
@@ -148,6 +154,19 @@ class ProgramDoc;
  * const std::string filename = CLI::GetParam<std::string>("filename");
  * @endcode
  *
+ * @section threads Threads
+ *
+ * The parameters, aliases and function mappings that CLI holds belong to the
+ * calling thread: each thread starts with none, and gets those of a program
+ * with RestoreSettings().  So a binding can run in several threads at once
+ * (for instance, Python bindings called from different Python threads), each
+ * run with its own parameters.  The settings stored with StoreSettings(), the
+ * ProgramDoc and the timers are shared by all threads.
+ *
+ * A util::BindingContext holds the parameters of one run of a program
+ * explicitly; while it is active in a thread, CLI uses its parameters instead
+ * of those of the thread, so one thread can hold several runs.
+ *
  * @note
  * Options should only be defined in files which define `main()` (that is, main
  * executables).  If options are defined elsewhere, they may be spuriously
@@ -214,13 +233,15 @@ class CLI
   static T& GetRawParam(const std::string& identifier);
 
   /**
-   * Retrieve the singleton.  As an end user, if you are just using the CLI
-   * object, you should not need to use this function---the other static
-   * functions should be sufficient.
+   * Retrieve the singleton of the calling thread (or the active
+   * util::BindingContext of the thread, if there is one).  As an end user, if
+   * you are just using the CLI object, you should not need to use this
+   * function---the other static functions should be sufficient.
    *
    * In this case, the singleton is used to store data for the static methods,
    * as there is no point in defining static methods only to have users call
-   * private instance methods.
+   * private instance methods.  There is one singleton per thread; see the
+   * documentation of the class.
    *
    * @return The singleton instance for use in the static methods.
    */
@@ -291,8 +312,40 @@ class CLI
 
  private:
   //! Storage map for parameters.
-  std::map<std::string, std::tuple<std::map<std::string, util::ParamData>,
-      std::map<char, std::string>, FunctionMapType>> storageMap;
+  typedef std::map<std::string, std::tuple<std::map<std::string,
+      util::ParamData>, std::map<char, std::string>, FunctionMapType>>
+      StorageMapType;
+
+  /**
+   * The state that is shared by the singletons of all threads.  It is only
+   * created when it is first used, so that it can be used during static
+   * initialization (by the PARAM_*() macros).
+   */
+  struct SharedState
+  {
+    //! Create the shared state, with no stored settings and an empty
+    //! ProgramDoc.
+    SharedState();
+
+    //! The settings stored with StoreSettings().
+    StorageMapType storageMap;
+    //! The mutex protecting storageMap.
+    std::mutex storageMutex;
+    //! The timers of all threads.
+    Timers timer;
+    //! The ProgramDoc object.
+    util::ProgramDoc* doc;
+  };
+
+  //! Get the state that is shared by all threads.
+  static SharedState& Shared();
+
+  //! Get the active context of the calling thread (NULL if there is none).
+  static CLI*& CurrentContext();
+
+  //! So that contexts can create CLI objects and make them active.
+  friend class util::BindingContext;
+  friend class util::ScopedBindingContext;
 
  public:
   //! True, if CLI was used to parse command line options.
@@ -302,14 +355,14 @@ class CLI
   //! name (argv[0]) not what is given in ProgramDoc.
   std::string programName;
 
-  //! Holds the timer objects.
-  Timers timer;
+  //! Holds the timer objects (shared by all threads).
+  Timers& timer;
 
   //! So that Timer::Start() and Timer::Stop() can access the timer variable.
   friend class Timer;
 
-  //! Pointer to the ProgramDoc object.
-  util::ProgramDoc* doc;
+  //! Pointer to the ProgramDoc object (shared by all threads).
+  util::ProgramDoc*& doc;
 
  private:
   /**
@@ -17,6 +17,7 @@
 
 #include "prefixedoutstream.hpp"
 #include "nulloutstream.hpp"
+#include "log_message.hpp"
 
 namespace mlpack {
 
@@ -51,7 +52,20 @@ namespace mlpack {
  * mode.  Messages to Log::Info will only be shown when the --verbose flag is
  * given to the program (or rather, the CLI class).
  *
- * @see PrefixedOutStream, NullOutStream, CLI
+ * The operands of a message are evaluated and formatted even if the stream
+ * ignores them.  In hot loops and in parallel regions, use the
+ * MLPACK_LOG_DEBUG, MLPACK_LOG_INFO and MLPACK_LOG_WARN macros instead: they
+ * skip the whole statement, operands included, if the stream is disabled, and
+ * they write each message at once through the util::LogSink, so that they can
+ * be used from any number of threads.
+ *
+ * @code
+ * #pragma omp parallel for
+ * for (size_t i = 0; i < n; ++i)
+ *   MLPACK_LOG_INFO << "Point " << i << ": " << data.col(i).t();
+ * @endcode
+ *
+ * @see PrefixedOutStream, NullOutStream, LogMessage, LogSink, CLI
  */
 class Log
 {
@@ -95,4 +109,33 @@ class Log
 
 }; // namespace mlpack
 
+/**
+ * Write a message to Log::Info, as a util::LogMessage, unless Log::Info is
+ * ignoring its input, in which case nothing after the macro is evaluated.
+ */
+#define MLPACK_LOG_INFO \
+    (mlpack::Log::Info.ignoreInput) ? (void) 0 : mlpack::util::LogVoidify() & \
+    mlpack::util::LogMessage(mlpack::Log::Info)
+
+/**
+ * Write a message to Log::Warn, as a util::LogMessage, unless Log::Warn is
+ * ignoring its input, in which case nothing after the macro is evaluated.
+ */
+#define MLPACK_LOG_WARN \
+    (mlpack::Log::Warn.ignoreInput) ? (void) 0 : mlpack::util::LogVoidify() & \
+    mlpack::util::LogMessage(mlpack::Log::Warn)
+
+/**
+ * Write a message to Log::Debug, as a util::LogMessage, in debug mode.  In
+ * non-debug mode, nothing after the macro is evaluated.
+ */
+#ifdef DEBUG
+  #define MLPACK_LOG_DEBUG \
+      (mlpack::Log::Debug.ignoreInput) ? (void) 0 : \
+      mlpack::util::LogVoidify() & mlpack::util::LogMessage(mlpack::Log::Debug)
+#else
+  #define MLPACK_LOG_DEBUG \
+      true ? (void) 0 : mlpack::util::LogVoidify() & mlpack::Log::Debug
+#endif
+
 #endif
@@ -0,0 +1,110 @@
+/**
+ * @file log_message.hpp
+ *
+ * Definition of the LogMessage class, which collects one log message on the
+ * thread that writes it, and of the helper used by the MLPACK_LOG_* macros.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_LOG_MESSAGE_HPP
+#define MLPACK_CORE_UTIL_LOG_MESSAGE_HPP
+
+#include <sstream>
+
+#include "prefixedoutstream.hpp"
+#include "log_sink.hpp"
+
+namespace mlpack {
+namespace util {
+
+/**
+ * A LogMessage formats one message for a PrefixedOutStream into a private
+ * buffer, and hands the complete message to the LogSink when it is destroyed.
+ * Unlike writing to the PrefixedOutStream itself, this is safe from any number
+ * of threads at once.  LogMessage objects are usually created by the
+ * MLPACK_LOG_INFO, MLPACK_LOG_WARN and MLPACK_LOG_DEBUG macros, as temporaries
+ * that live until the end of the statement.
+ *
+ * A LogMessage never terminates the program, so it can't be used for
+ * Log::Fatal.
+ */
+class LogMessage
+{
+ public:
+  /**
+   * Start a message for the given stream.  The flags and precision of the
+   * stream's destination are used to format the message.
+   *
+   * @param stream Stream whose destination and prefix the message is for.
+   */
+  explicit LogMessage(PrefixedOutStream& stream) : stream(stream)
+  {
+    buffer.flags(stream.destination.flags());
+    buffer.precision(stream.destination.precision());
+  }
+
+  //! Write the message.
+  ~LogMessage()
+  {
+    LogSink::Write(stream.destination, stream.Prefix(), buffer.str());
+  }
+
+  // A LogMessage can be neither copied nor assigned.
+  LogMessage(const LogMessage&) = delete;
+  LogMessage& operator=(const LogMessage&) = delete;
+
+  //! Write anything to the message.
+  template<typename T>
+  LogMessage& operator<<(const T& val)
+  {
+    buffer << val;
+    return *this;
+  }
+
+  //! Write an ostream manipulator function, such as std::endl, to the message.
+  LogMessage& operator<<(std::ostream& (*pf)(std::ostream&))
+  {
+    pf(buffer);
+    return *this;
+  }
+
+  //! Write an ios manipulator function to the message.
+  LogMessage& operator<<(std::ios& (*pf)(std::ios&))
+  {
+    pf(buffer);
+    return *this;
+  }
+
+  //! Write an ios_base manipulator function to the message.
+  LogMessage& operator<<(std::ios_base& (*pf)(std::ios_base&))
+  {
+    pf(buffer);
+    return *this;
+  }
+
+ private:
+  //! The stream the message is for.
+  PrefixedOutStream& stream;
+  //! The message.
+  std::ostringstream buffer;
+};
+
+/**
+ * Turns the message of a MLPACK_LOG_* macro into a void expression, so that the
+ * macro can be one branch of a conditional expression.  operator& binds less
+ * tightly than operator<<, so the whole message is written first.
+ */
+struct LogVoidify
+{
+  //! Do nothing.
+  template<typename StreamType>
+  void operator&(const StreamType& /* stream */) const { }
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,236 @@
+/**
+ * @file log_sink.cpp
+ *
+ * Implementation of the LogSink class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "log_sink.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace mlpack::util;
+using namespace std;
+using namespace std::chrono;
+
+namespace {
+
+//! A message waiting to be written by the background thread.
+struct Record
+{
+  ostream* destination;
+  string prefix;
+  string message;
+  system_clock::time_point time;
+  size_t thread;
+};
+
+//! The state of the sink, shared by all threads.
+struct SinkState
+{
+  SinkState() : running(false), stopping(false), writing(false),
+      timestamps(true) { }
+
+  // Make sure the background thread is joined before it is destroyed.
+  ~SinkState();
+
+  //! Protects everything below, and serializes immediate writes.
+  mutex lock;
+  //! Wakes up the background thread.
+  condition_variable wakeWriter;
+  //! Wakes up threads waiting in Flush().
+  condition_variable wakeFlush;
+  //! The messages waiting to be written.
+  vector<Record> queue;
+  //! The index of each thread that has queued a message.
+  map<thread::id, size_t> threadIndices;
+  //! The background thread.
+  thread writer;
+  //! Whether the background thread is running.
+  bool running;
+  //! Whether the background thread has been asked to stop.
+  bool stopping;
+  //! Whether the background thread is writing a batch of messages.
+  bool writing;
+  //! Whether to write the time and thread of each message.
+  bool timestamps;
+};
+
+SinkState& State()
+{
+  static SinkState state;
+  return state;
+}
+
+SinkState::~SinkState()
+{
+  if (writer.joinable())
+  {
+    {
+      lock_guard<mutex> guard(lock);
+      stopping = true;
+      wakeWriter.notify_one();
+    }
+
+    writer.join();
+  }
+}
+
+// Write the lines of a message, each with the given header.
+void WriteLines(ostream& destination,
+                const string& header,
+                const string& message)
+{
+  size_t pos = 0;
+  do
+  {
+    size_t nl = message.find('\n', pos);
+    if (nl == string::npos)
+      nl = message.size();
+    destination << header;
+    destination.write(message.data() + pos, nl - pos);
+    destination << '\n';
+    pos = nl + 1;
+  } while (pos < message.size());
+}
+
+// Format the time and thread of a record.
+string Header(const Record& record, const bool timestamps)
+{
+  if (!timestamps)
+    return record.prefix;
+
+  const time_t time = system_clock::to_time_t(record.time);
+  const long micros = (long) (duration_cast<microseconds>(
+      record.time.time_since_epoch()).count() % 1000000);
+  // Only the background thread formats times, so localtime() is safe here.
+  char buffer[16];
+  strftime(buffer, sizeof(buffer), "%H:%M:%S", localtime(&time));
+
+  ostringstream oss;
+  oss << record.prefix << buffer << "." << setw(6) << setfill('0') << micros
+      << " [thread " << record.thread << "] ";
+  return oss.str();
+}
+
+// The loop of the background thread.
+void WriteQueued()
+{
+  SinkState& state = State();
+  unique_lock<mutex> lock(state.lock);
+  while (true)
+  {
+    state.wakeWriter.wait(lock, [&state]()
+        { return state.stopping || !state.queue.empty(); });
+    if (state.queue.empty())
+      break; // We were asked to stop and everything is written.
+
+    vector<Record> batch;
+    batch.swap(state.queue);
+    state.writing = true;
+    const bool timestamps = state.timestamps;
+    lock.unlock();
+
+    set<ostream*> destinations;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+      WriteLines(*batch[i].destination, Header(batch[i], timestamps),
+          batch[i].message);
+      destinations.insert(batch[i].destination);
+    }
+    for (ostream* destination : destinations)
+      destination->flush();
+
+    lock.lock();
+    state.writing = false;
+    state.wakeFlush.notify_all();
+  }
+}
+
+} // anonymous namespace
+
+void LogSink::Write(ostream& destination,
+                    const string& prefix,
+                    string message)
+{
+  // The message is complete; the newline is added by WriteLines().
+  if (!message.empty() && message.back() == '\n')
+    message.pop_back();
+
+  SinkState& state = State();
+  lock_guard<mutex> lock(state.lock);
+  if (!state.running)
+  {
+    WriteLines(destination, prefix, message);
+    destination.flush();
+    return;
+  }
+
+  Record record;
+  record.destination = &destination;
+  record.prefix = prefix;
+  record.message = std::move(message);
+  record.time = system_clock::now();
+  record.thread = state.threadIndices.insert(make_pair(this_thread::get_id(),
+      state.threadIndices.size())).first->second;
+  state.queue.push_back(std::move(record));
+  state.wakeWriter.notify_one();
+}
+
+void LogSink::StartAsync(const bool timestamps)
+{
+  SinkState& state = State();
+  lock_guard<mutex> lock(state.lock);
+  if (state.running)
+    return;
+
+  state.timestamps = timestamps;
+  state.running = true;
+  state.writer = thread(WriteQueued);
+}
+
+void LogSink::StopAsync()
+{
+  SinkState& state = State();
+  {
+    lock_guard<mutex> lock(state.lock);
+    if (!state.running || state.stopping)
+      return;
+    state.stopping = true;
+    state.wakeWriter.notify_one();
+  }
+
+  state.writer.join();
+
+  lock_guard<mutex> lock(state.lock);
+  state.running = false;
+  state.stopping = false;
+  state.threadIndices.clear();
+}
+
+void LogSink::Flush()
+{
+  SinkState& state = State();
+  unique_lock<mutex> lock(state.lock);
+  state.wakeFlush.wait(lock, [&state]()
+      { return !state.running || (state.queue.empty() && !state.writing); });
+}
+
+bool LogSink::Async()
+{
+  SinkState& state = State();
+  lock_guard<mutex> lock(state.lock);
+  return state.running;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file log_sink.hpp
+ *
+ * Definition of the LogSink class, which writes the messages of LogMessage
+ * objects either directly or from a background thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_LOG_SINK_HPP
+#define MLPACK_CORE_UTIL_LOG_SINK_HPP
+
+#include <ostream>
+#include <string>
+#include <mlpack/mlpack_export.hpp>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * LogSink writes complete log messages, so that messages written by different
+ * threads at the same time never interleave.  By default each message is
+ * written immediately, under a lock.  After StartAsync(), messages are instead
+ * queued and written by a background thread, so that the threads that log
+ * only pay for formatting their message; each line is then also stamped with
+ * the time the message was submitted and the index of the thread that
+ * submitted it (threads are numbered in the order they first log), e.g.
+ *
+ * @code
+ * [INFO ] 14:02:11.305128 [thread 2] Iteration 10; objective 0.734.
+ * @endcode
+ *
+ * Messages are given to the sink by LogMessage, usually through the
+ * MLPACK_LOG_INFO, MLPACK_LOG_WARN and MLPACK_LOG_DEBUG macros.  Output written
+ * directly to Log::Info and the other streams does not go through the sink.
+ */
+class LogSink
+{
+ public:
+  /**
+   * Write a message, each line of which is prefixed with the given prefix.  A
+   * message that doesn't end with a newline is terminated with one.
+   *
+   * @param destination Stream to write the message to.
+   * @param prefix Prefix of each line, e.g. "[INFO ] ".
+   * @param message Message to write.
+   */
+  static MLPACK_EXPORT void Write(std::ostream& destination,
+                                  const std::string& prefix,
+                                  std::string message);
+
+  /**
+   * Start writing messages from a background thread.  This does nothing if
+   * the background thread is already running.
+   *
+   * @param timestamps If true, write the time and thread index of each
+   *     message.
+   */
+  static MLPACK_EXPORT void StartAsync(const bool timestamps = true);
+
+  /**
+   * Write all queued messages and stop the background thread; later messages
+   * are written immediately again.
+   */
+  static MLPACK_EXPORT void StopAsync();
+
+  //! Wait until all queued messages have been written.
+  static MLPACK_EXPORT void Flush();
+
+  //! Get whether messages are written from a background thread.
+  static MLPACK_EXPORT bool Async();
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
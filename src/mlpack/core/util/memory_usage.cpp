@@ -0,0 +1,126 @@
+/**
+ * @file memory_usage.cpp
+ *
+ * Implementation of the functions to get the memory used by the process.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "memory_usage.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__) || defined(__APPLE__)
+  #include <sys/resource.h>
+  #include <unistd.h>
+#endif
+
+#ifdef __APPLE__
+  #include <mach/mach.h>
+#endif
+
+#ifdef MLPACK_TRACK_ALLOCATIONS
+
+namespace {
+
+std::atomic<size_t> allocationCount(0);
+
+} // anonymous namespace
+
+// Replace the global allocation functions to count the allocations.
+void* operator new(std::size_t size)
+{
+  ++allocationCount;
+  void* pointer = std::malloc((size == 0) ? 1 : size);
+  if (pointer == NULL)
+    throw std::bad_alloc();
+
+  return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+#endif
+
+size_t mlpack::util::ResidentMemory()
+{
+#if defined(__linux__)
+  // The second field of /proc/self/statm is the number of resident pages.
+  std::FILE* file = std::fopen("/proc/self/statm", "r");
+  if (file == NULL)
+    return 0;
+
+  unsigned long size = 0, resident = 0;
+  const int read = std::fscanf(file, "%lu %lu", &size, &resident);
+  std::fclose(file);
+  if (read != 2)
+    return 0;
+
+  return (size_t) resident * (size_t) sysconf(_SC_PAGESIZE);
+#elif defined(__APPLE__)
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) &info,
+      &count) != KERN_SUCCESS)
+    return 0;
+
+  return (size_t) info.resident_size;
+#else
+  return 0;
+#endif
+}
+
+size_t mlpack::util::PeakResidentMemory()
+{
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+
+  #ifdef __APPLE__
+    // OS X gives bytes...
+    return (size_t) usage.ru_maxrss;
+  #else
+    // ...and Linux kilobytes.
+    return (size_t) usage.ru_maxrss * 1024;
+  #endif
+#else
+  return 0;
+#endif
+}
+
+size_t mlpack::util::AllocationCount()
+{
+#ifdef MLPACK_TRACK_ALLOCATIONS
+  return allocationCount;
+#else
+  return 0;
+#endif
+}
+
+bool mlpack::util::AllocationsTracked()
+{
+#ifdef MLPACK_TRACK_ALLOCATIONS
+  return true;
+#else
+  return false;
+#endif
+}
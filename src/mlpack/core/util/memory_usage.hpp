@@ -0,0 +1,47 @@
+/**
+ * @file memory_usage.hpp
+ *
+ * Functions to get the memory used by the process, for the memory statistics
+ * of the timers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_MEMORY_USAGE_HPP
+#define MLPACK_CORE_UTIL_MEMORY_USAGE_HPP
+
+#include <cstddef>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * Get the resident memory of the process, in bytes (0 if it is not known on
+ * this platform; it is known on Linux and OS X).
+ */
+size_t ResidentMemory();
+
+/**
+ * Get the highest resident memory of the process since it started, in bytes (0
+ * if it is not known on this platform).
+ */
+size_t PeakResidentMemory();
+
+/**
+ * Get the number of allocations made with operator new since the process
+ * started.  Allocations are only counted if mlpack was configured with
+ * -DTRACK_ALLOCATIONS=ON, which replaces the global operator new; otherwise 0
+ * is returned.  The memory of Armadillo matrices is not allocated with operator
+ * new, so it is not counted (but it is part of the resident memory).
+ */
+size_t AllocationCount();
+
+//! Return whether allocations are counted (see AllocationCount()).
+bool AllocationsTracked();
+
+} // namespace util
+} // namespace mlpack
+
+#endif
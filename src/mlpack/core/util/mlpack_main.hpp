@@ -52,16 +52,28 @@ static const std::string testName = "";
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/run_server.hpp>
 
 static void mlpackMain(); // This is typically defined after this include.
 
 int main(int argc, char** argv)
 {
+  // Keep the options as they are before parsing, in case we run as a server.
+  mlpack::CLI::StoreSettings("mlpack_server");
+  mlpack::CLI::RestoreSettings("mlpack_server");
+
   // Parse the command-line options; put them into CLI.
   mlpack::bindings::cli::ParseCommandLine(argc, argv);
   // Enable timing.
   mlpack::Timer::EnableTiming();
 
+  // With --server, every line of the input is a run of the program.
+  if (mlpack::CLI::HasParam("server"))
+  {
+    mlpack::bindings::cli::RunServer("mlpack_server", mlpackMain);
+    return 0;
+  }
+
   // A "total_time" timer is run by default for each mlpack program.
   mlpack::Timer::Start("total_time");
 
@@ -0,0 +1,86 @@
+/**
+ * @file parallel_blocks.hpp
+ *
+ * Split a range of points into blocks of columns and process the blocks in
+ * parallel; this is how the batch Classify() and Predict() functions of the
+ * models are parallelized.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_PARALLEL_BLOCKS_HPP
+#define MLPACK_CORE_UTIL_PARALLEL_BLOCKS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * The default number of points in each block of ParallelBlocks().  It is
+ * large enough that a block can be handled with matrix operations efficiently,
+ * and small enough that the blocks of a few thousand points keep all the
+ * threads busy.
+ */
+static const size_t DefaultBlockSize = 1024;
+
+/**
+ * Call the given function for each block of blockSize consecutive points out of
+ * numPoints, in parallel with OpenMP.  The function is called as
+ * function(begin, end), where begin and end are the indices of the first and
+ * last point of the block (so it can use data.cols(begin, end)); each block
+ * should write its results into its own part of preallocated outputs.  The
+ * last block may be smaller than the others.
+ *
+ * With only one block, the function is called directly, so that small batches
+ * (and single points) don't pay for a parallel region.  During the parallel
+ * region the BLAS library uses one thread (see SingleThreadedBLAS), so that the
+ * threads can use matrix products on their blocks.  The function must not
+ * throw, since exceptions can't leave a parallel region; check the input
+ * before calling ParallelBlocks().
+ *
+ * @code
+ * predictions.set_size(data.n_cols);
+ * util::ParallelBlocks(data.n_cols, [&](const size_t begin, const size_t end)
+ * {
+ *   for (size_t i = begin; i <= end; ++i)
+ *     predictions[i] = tree.Classify(data.col(i));
+ * });
+ * @endcode
+ *
+ * @param numPoints Number of points to process.
+ * @param function Function to call for each block.
+ * @param blockSize Number of points in each block.
+ */
+template<typename FunctionType>
+void ParallelBlocks(const size_t numPoints,
+                    const FunctionType& function,
+                    const size_t blockSize = DefaultBlockSize)
+{
+  if (numPoints == 0)
+    return;
+
+  const size_t numBlocks = (numPoints + blockSize - 1) / blockSize;
+  if (numBlocks == 1)
+  {
+    function(0, numPoints - 1);
+    return;
+  }
+
+  SingleThreadedBLAS singleThreadedBLAS;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(numPoints, begin + blockSize) - 1;
+    function(begin, end);
+  }
+}
+
+} // namespace util
+} // namespace mlpack
+
+#endif
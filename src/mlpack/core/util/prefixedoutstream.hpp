@@ -111,6 +111,9 @@ class PrefixedOutStream
   template<typename T>
   PrefixedOutStream& operator<<(const T& s);
 
+  //! Get the prefix prepended to each line.
+  const std::string& Prefix() const { return prefix; }
+
   //! The output stream that all data is to be sent to; example: std::cout.
   std::ostream& destination;
 
@@ -43,6 +43,11 @@ PrefixedOutStream::BaseLogic(const T& val)
   bool newlined = false;
   std::string line;
 
+  // If the output is discarded and can't terminate the program, there is no
+  // need to convert it.
+  if (ignoreInput && !fatal)
+    return;
+
   // If we need to, output the prefix.
   PrefixIfNeeded();
 
@@ -154,6 +159,11 @@ PrefixedOutStream::BaseLogic(const T& val)
   bool newlined = false;
   std::string line;
 
+  // If the output is discarded and can't terminate the program, there is no
+  // need to convert it.
+  if (ignoreInput && !fatal)
+    return;
+
   // If we need to, output the prefix.
   PrefixIfNeeded();
 
@@ -0,0 +1,182 @@
+/**
+ * @file serve_queries.hpp
+ *
+ * A utility function that answers batches of queries read from a stream, so
+ * that a trained model can stay in memory and serve many requests.  This is
+ * used by the --server option of programs like mlpack_knn.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_SERVE_QUERIES_HPP
+#define MLPACK_CORE_UTIL_SERVE_QUERIES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * Parse one line of a query batch into the given vector.  Values may be
+ * separated by commas, spaces or tabs.  Returns false if a token is not a
+ * number.
+ */
+inline bool ParseQueryLine(const std::string& line, std::vector<double>& point)
+{
+  point.clear();
+
+  std::string copy(line);
+  std::replace(copy.begin(), copy.end(), ',', ' ');
+  std::istringstream iss(copy);
+
+  std::string token;
+  while (iss >> token)
+  {
+    std::istringstream tokenStream(token);
+    double value;
+    if (!(tokenStream >> value) || !tokenStream.eof())
+      return false;
+    point.push_back(value);
+  }
+
+  return true;
+}
+
+/**
+ * Answer batches of queries read from the input stream until it ends.  Each
+ * batch is a set of query points, one point per line, with values separated by
+ * commas or whitespace; a batch ends with an empty line or the end of the
+ * stream.  Lines starting with '#' are ignored.
+ *
+ * For each batch the given search function is called as
+ *
+ * @code
+ * search(queries, neighbors, results);
+ * @endcode
+ *
+ * with an arma::mat of queries (one column per point), and the answer is
+ * written to the output stream: one line per query point, holding the k
+ * neighbor indices followed by the k results (for instance distances), all
+ * separated by commas, and an empty line to end the batch.  If the batch is
+ * malformed or the search throws an exception, a single line starting with
+ * "error: " and an empty line are written instead, and serving continues with
+ * the next batch.  The output stream is flushed after each batch.
+ *
+ * @param input Stream to read query batches from.
+ * @param output Stream to write answers to.
+ * @param dimensionality Expected dimensionality of the query points, or 0 to
+ *     accept any dimensionality (as long as it is the same in a batch).
+ * @param search Function that performs the search.
+ * @return The number of batches that were answered successfully.
+ */
+template<typename SearchFunctionType>
+size_t ServeQueries(std::istream& input,
+                    std::ostream& output,
+                    const size_t dimensionality,
+                    SearchFunctionType search)
+{
+  size_t numAnswered = 0;
+  std::vector<double> values;
+  std::vector<double> point;
+  size_t numPoints = 0;
+  size_t batchDimensionality = dimensionality;
+  std::string error;
+  std::string line;
+
+  bool done = false;
+  while (!done)
+  {
+    done = !std::getline(input, line);
+
+    // Strip a trailing carriage return, in case the client sends CRLF.
+    if (!line.empty() && line[line.size() - 1] == '\r')
+      line.erase(line.size() - 1);
+
+    const bool endOfBatch = done || line.find_first_not_of(" \t") ==
+        std::string::npos;
+    if (!endOfBatch)
+    {
+      if (line[line.find_first_not_of(" \t")] == '#' || !error.empty())
+        continue;
+
+      if (!ParseQueryLine(line, point))
+      {
+        error = "could not parse query point " + std::to_string(numPoints);
+        continue;
+      }
+
+      if (batchDimensionality == 0)
+        batchDimensionality = point.size();
+
+      if (point.size() != batchDimensionality)
+      {
+        std::ostringstream oss;
+        oss << "query point " << numPoints << " has " << point.size()
+            << " dimensions, but " << batchDimensionality << " were expected";
+        error = oss.str();
+        continue;
+      }
+
+      values.insert(values.end(), point.begin(), point.end());
+      ++numPoints;
+      continue;
+    }
+
+    // An empty batch (for instance several empty lines) is not answered.
+    if (numPoints > 0 || !error.empty())
+    {
+      if (error.empty())
+      {
+        arma::mat queries(values.data(), batchDimensionality, numPoints);
+        arma::Mat<size_t> neighbors;
+        arma::mat results;
+
+        try
+        {
+          search(queries, neighbors, results);
+        }
+        catch (std::exception& e)
+        {
+          error = e.what();
+        }
+
+        if (error.empty())
+        {
+          for (size_t i = 0; i < neighbors.n_cols; ++i)
+          {
+            for (size_t j = 0; j < neighbors.n_rows; ++j)
+              output << neighbors(j, i) << ",";
+            for (size_t j = 0; j < results.n_rows; ++j)
+            {
+              output << std::setprecision(17) << results(j, i)
+                  << ((j + 1 < results.n_rows) ? "," : "");
+            }
+            output << "\n";
+          }
+          ++numAnswered;
+        }
+      }
+
+      if (!error.empty())
+        output << "error: " << error << "\n";
+      output << std::endl;
+    }
+
+    values.clear();
+    numPoints = 0;
+    batchDimensionality = dimensionality;
+    error.clear();
+  }
+
+  return numAnswered;
+}
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file threads.cpp
+ *
+ * Implementation of the control of the number of threads used by mlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "threads.hpp"
+
+#include <mutex>
+#include <thread>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+// The thread control functions of the BLAS libraries; CMake checks which of
+// them the BLAS library used by Armadillo provides.
+#if defined(HAS_OPENBLAS_THREADS)
+extern "C" void openblas_set_num_threads(int numThreads);
+extern "C" int openblas_get_num_threads();
+#elif defined(HAS_MKL_THREADS)
+extern "C" void MKL_Set_Num_Threads(int numThreads);
+extern "C" int MKL_Get_Max_Threads();
+#endif
+
+using namespace mlpack;
+using namespace mlpack::util;
+
+namespace {
+
+//! The state of the SingleThreadedBLAS objects.
+struct BLASState
+{
+  BLASState() : count(0), changed(false), previous(0) { }
+
+  //! Guards the other members.
+  std::mutex mutex;
+  //! The number of SingleThreadedBLAS objects.
+  size_t count;
+  //! Whether the number of BLAS threads was changed by the first object.
+  bool changed;
+  //! The number of BLAS threads to restore.
+  size_t previous;
+};
+
+BLASState& GetBLASState()
+{
+  static BLASState state;
+  return state;
+}
+
+//! Turn 0 into the number of processors.
+size_t ActualNumThreads(const size_t numThreads)
+{
+  if (numThreads > 0)
+    return numThreads;
+
+#ifdef HAS_OPENMP
+  return (size_t) omp_get_num_procs();
+#else
+  const size_t processors = std::thread::hardware_concurrency();
+  return (processors == 0) ? 1 : processors;
+#endif
+}
+
+} // anonymous namespace
+
+void mlpack::SetNumThreads(const size_t numThreads)
+{
+  const size_t actualThreads = ActualNumThreads(numThreads);
+
+#ifdef HAS_OPENMP
+  omp_set_num_threads((int) actualThreads);
+#endif
+
+  // If parallel regions are running, the BLAS library gets the new number of
+  // threads when they end.
+  BLASState& state = GetBLASState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (state.changed)
+    state.previous = actualThreads;
+  else
+    SetBLASNumThreads(actualThreads);
+}
+
+size_t mlpack::NumThreads()
+{
+#ifdef HAS_OPENMP
+  return (size_t) omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+ScopedNumThreads::ScopedNumThreads(const size_t numThreads) :
+    previous(NumThreads())
+{
+#ifdef HAS_OPENMP
+  omp_set_num_threads((int) ActualNumThreads(numThreads));
+#else
+  (void) numThreads;
+#endif
+}
+
+ScopedNumThreads::~ScopedNumThreads()
+{
+#ifdef HAS_OPENMP
+  omp_set_num_threads((int) previous);
+#endif
+}
+
+SingleThreadedBLAS::SingleThreadedBLAS()
+{
+  BLASState& state = GetBLASState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (state.count++ == 0 && NumThreads() > 1)
+  {
+    state.previous = BLASNumThreads();
+    state.changed = (state.previous > 1);
+    if (state.changed)
+      SetBLASNumThreads(1);
+  }
+}
+
+SingleThreadedBLAS::~SingleThreadedBLAS()
+{
+  BLASState& state = GetBLASState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (--state.count == 0 && state.changed)
+  {
+    SetBLASNumThreads(state.previous);
+    state.changed = false;
+  }
+}
+
+size_t mlpack::util::BLASNumThreads()
+{
+#if defined(HAS_OPENBLAS_THREADS)
+  return (size_t) openblas_get_num_threads();
+#elif defined(HAS_MKL_THREADS)
+  return (size_t) MKL_Get_Max_Threads();
+#else
+  return 0;
+#endif
+}
+
+void mlpack::util::SetBLASNumThreads(const size_t numThreads)
+{
+#if defined(HAS_OPENBLAS_THREADS)
+  openblas_set_num_threads((int) ActualNumThreads(numThreads));
+#elif defined(HAS_MKL_THREADS)
+  MKL_Set_Num_Threads((int) ActualNumThreads(numThreads));
+#else
+  (void) numThreads;
+#endif
+}
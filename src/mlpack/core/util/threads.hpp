@@ -0,0 +1,124 @@
+/**
+ * @file threads.hpp
+ *
+ * Control of the number of threads used by mlpack: the number of OpenMP
+ * threads, and the number of threads of the BLAS library, which is dropped to
+ * one in the parallel regions of mlpack so that the two don't multiply.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_THREADS_HPP
+#define MLPACK_CORE_UTIL_THREADS_HPP
+
+#include <cstddef>
+
+namespace mlpack {
+
+/**
+ * Set the number of threads mlpack uses.  This sets the number of OpenMP
+ * threads of the calling thread (as omp_set_num_threads() does), and, if the
+ * BLAS library can be told (OpenBLAS and MKL can), the number of threads of the
+ * BLAS library, which are used by the Armadillo calls outside of the parallel
+ * regions of mlpack.  Inside those regions, the BLAS library uses one thread
+ * (see util::SingleThreadedBLAS).
+ *
+ * @param numThreads Number of threads; 0 means the number of processors.
+ */
+void SetNumThreads(const size_t numThreads);
+
+/**
+ * Get the number of threads the parallel regions of mlpack started by the
+ * calling thread use (1 if mlpack was compiled without OpenMP).
+ */
+size_t NumThreads();
+
+namespace util {
+
+/**
+ * Change the number of OpenMP threads of the calling thread while the object
+ * exists, so that one call of an algorithm can use a different number of
+ * threads than the one set with SetNumThreads():
+ *
+ * @code
+ * {
+ *   util::ScopedNumThreads threads(4);
+ *   rf.Train(dataset, labels, numClasses); // Uses 4 threads.
+ * }
+ * @endcode
+ *
+ * The BLAS library is not changed.
+ */
+class ScopedNumThreads
+{
+ public:
+  /**
+   * Use the given number of OpenMP threads.
+   *
+   * @param numThreads Number of threads; 0 means the number of processors.
+   */
+  explicit ScopedNumThreads(const size_t numThreads);
+
+  //! Restore the previous number of OpenMP threads.
+  ~ScopedNumThreads();
+
+  ScopedNumThreads(const ScopedNumThreads&) = delete;
+  ScopedNumThreads& operator=(const ScopedNumThreads&) = delete;
+
+ private:
+  //! The previous number of OpenMP threads.
+  size_t previous;
+};
+
+/**
+ * While a SingleThreadedBLAS object exists, the BLAS library uses one thread,
+ * so that the Armadillo calls made by each of the threads of a parallel region
+ * don't each start as many BLAS threads as there are processors.  It should be
+ * created just before a parallel region whose iterations make BLAS calls:
+ *
+ * @code
+ * util::SingleThreadedBLAS singleThreadedBLAS;
+ * #pragma omp parallel for
+ * for (...)
+ * @endcode
+ *
+ * The number of BLAS threads is global, so the objects are counted: the BLAS
+ * library gets its previous number of threads back when the last one is
+ * destroyed, and an object can be created from any thread.  Nothing is done if
+ * the parallel regions use only one thread, or if the BLAS library can't be
+ * told how many threads to use.
+ */
+class SingleThreadedBLAS
+{
+ public:
+  //! Make the BLAS library use one thread.
+  SingleThreadedBLAS();
+
+  //! Restore the number of BLAS threads if this is the last object.
+  ~SingleThreadedBLAS();
+
+  SingleThreadedBLAS(const SingleThreadedBLAS&) = delete;
+  SingleThreadedBLAS& operator=(const SingleThreadedBLAS&) = delete;
+};
+
+/**
+ * Get the number of threads of the BLAS library (0 if the BLAS library can't
+ * be queried).
+ */
+size_t BLASNumThreads();
+
+/**
+ * Set the number of threads of the BLAS library, if it can be told (otherwise
+ * nothing is done).  Prefer SetNumThreads(), which also sets the number of
+ * OpenMP threads.
+ *
+ * @param numThreads Number of threads; 0 means the number of processors.
+ */
+void SetBLASNumThreads(const size_t numThreads);
+
+} // namespace util
+} // namespace mlpack
+
+#endif
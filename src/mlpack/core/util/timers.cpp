@@ -14,9 +14,11 @@
 #include "timers.hpp"
 #include "cli.hpp"
 #include "log.hpp"
+#include "memory_usage.hpp"
 
 #include <map>
 #include <string>
+#include <algorithm>
 
 using namespace mlpack;
 using namespace std;
@@ -46,6 +48,70 @@ microseconds Timer::Get(const string& name)
   return CLI::GetSingleton().timer.GetTimer(name);
 }
 
+/**
+ * Get the statistics of the given hierarchical timer, summing over all threads.
+ */
+TimerStatistics Timer::GetStatistics(const string& path)
+{
+  map<string, TimerStatistics> statistics =
+      CLI::GetSingleton().timer.GetAllStatistics();
+  map<string, TimerStatistics>::const_iterator it = statistics.find(path);
+  return (it == statistics.end()) ? TimerStatistics() : it->second;
+}
+
+/**
+ * Add to the given counter, under the innermost timer running on this thread.
+ */
+void Timer::AddCounter(const string& name, const size_t value)
+{
+  CLI::GetSingleton().timer.AddCounter(name, value, this_thread::get_id());
+}
+
+/**
+ * Get the given counter.
+ */
+size_t Timer::GetCounter(const string& path)
+{
+  map<string, size_t> counters = CLI::GetSingleton().timer.GetAllCounters();
+  map<string, size_t>::const_iterator it = counters.find(path);
+  return (it == counters.end()) ? 0 : it->second;
+}
+
+/**
+ * Enable the tracking of memory.
+ */
+void Timer::EnableMemoryTracking(const size_t samplingInterval)
+{
+  CLI::GetSingleton().timer.EnableMemoryTracking(samplingInterval);
+}
+
+/**
+ * Disable the tracking of memory.
+ */
+void Timer::DisableMemoryTracking()
+{
+  CLI::GetSingleton().timer.DisableMemoryTracking();
+}
+
+/**
+ * Get the memory statistics of the given hierarchical timer.
+ */
+MemoryStatistics Timer::GetMemoryStatistics(const string& path)
+{
+  const map<string, MemoryStatistics> memory =
+      CLI::GetSingleton().timer.GetAllMemoryStatistics();
+  map<string, MemoryStatistics>::const_iterator it = memory.find(path);
+  return (it == memory.end()) ? MemoryStatistics() : it->second;
+}
+
+// Stop the timer if it is still running.  It may have been stopped already if
+// all timers were reset or stopped while it was in scope.
+ScopedTimer::~ScopedTimer()
+{
+  if (CLI::GetSingleton().timer.GetState(name, this_thread::get_id()))
+    Timer::Stop(name);
+}
+
 // Enable timing.
 void Timer::EnableTiming()
 {
@@ -69,7 +135,14 @@ void Timers::Reset()
 {
   lock_guard<mutex> lock(timersMutex);
   timers.clear();
-  timerStartTime.clear();
+  runningTimers.clear();
+  threadIndices.clear();
+  statistics.clear();
+  counters.clear();
+  memoryStatistics.clear();
+  traceEvents.clear();
+  droppedTraceEvents = 0;
+  epoch = high_resolution_clock::now();
 }
 
 map<string, microseconds> Timers::GetAllTimers()
@@ -88,13 +161,127 @@ microseconds Timers::GetTimer(const string& timerName)
   return timers[timerName];
 }
 
+map<string, TimerStatistics> Timers::GetAllStatistics()
+{
+  lock_guard<mutex> lock(timersMutex);
+
+  map<string, TimerStatistics> result;
+  for (auto& it : statistics)
+    for (auto& it2 : it.second)
+      result[it.first].Add(it2.second);
+
+  return result;
+}
+
+map<size_t, map<string, TimerStatistics>> Timers::GetThreadStatistics()
+{
+  lock_guard<mutex> lock(timersMutex);
+
+  map<size_t, map<string, TimerStatistics>> result;
+  for (auto& it : statistics)
+    for (auto& it2 : it.second)
+      result[it2.first][it.first] = it2.second;
+
+  return result;
+}
+
+map<string, size_t> Timers::GetAllCounters()
+{
+  lock_guard<mutex> lock(timersMutex);
+  return counters;
+}
+
+void Timers::AddCounter(const string& name,
+                        const size_t value,
+                        const thread::id& threadId)
+{
+  // Don't do anything if we aren't timing.
+  if (!enabled)
+    return;
+
+  lock_guard<mutex> lock(timersMutex);
+
+  map<thread::id, vector<RunningTimer>>::const_iterator it =
+      runningTimers.find(threadId);
+  if (it == runningTimers.end() || it->second.empty())
+    counters[name] += value;
+  else
+    counters[it->second.back().path + "/" + name] += value;
+}
+
+map<string, MemoryStatistics> Timers::GetAllMemoryStatistics()
+{
+  lock_guard<mutex> lock(timersMutex);
+  return memoryStatistics;
+}
+
+Timers::~Timers()
+{
+  StopSampler();
+}
+
+void Timers::EnableMemoryTracking(const size_t samplingInterval)
+{
+  StopSampler();
+  memoryTracking = true;
+  if (samplingInterval > 0)
+  {
+    sampler = thread(&Timers::SampleMemory, this,
+        milliseconds(samplingInterval));
+  }
+}
+
+void Timers::DisableMemoryTracking()
+{
+  StopSampler();
+  memoryTracking = false;
+}
+
+void Timers::StopSampler()
+{
+  if (!sampler.joinable())
+    return;
+
+  {
+    lock_guard<mutex> lock(timersMutex);
+    stopSampler = true;
+  }
+  samplerCondition.notify_all();
+  sampler.join();
+
+  lock_guard<mutex> lock(timersMutex);
+  stopSampler = false;
+}
+
+void Timers::SampleMemory(const milliseconds interval)
+{
+  unique_lock<mutex> lock(timersMutex);
+  while (!samplerCondition.wait_for(lock, interval,
+      [this]() { return stopSampler; }))
+  {
+    if (runningTimers.empty())
+      continue;
+
+    const size_t memory = util::ResidentMemory();
+    for (auto& it : runningTimers)
+      for (size_t i = 0; i < it.second.size(); ++i)
+        it.second[i].peakMemory = std::max(it.second[i].peakMemory, memory);
+  }
+}
+
 bool Timers::GetState(const string& timerName,
                       const thread::id& threadId)
 {
   lock_guard<mutex> lock(timersMutex);
-  if (timerStartTime.count(threadId) == 0)
-    return 0;
-  return (timerStartTime[threadId].count(timerName) > 0);
+  if (runningTimers.count(threadId) == 0)
+    return false;
+
+  const vector<RunningTimer>& running = runningTimers[threadId];
+  for (size_t i = 0; i < running.size(); ++i)
+    if (running[i].name == timerName)
+      return true;
+
+  return false;
 }
 
 void Timers::PrintTimer(const string& timerName)
@@ -159,17 +346,16 @@ void Timers::PrintTimer(const string& timerName)
 
 void Timers::StopAllTimers()
 {
-  // Terminate the program timers.  Don't use StopTimer() since that modifies
-  // the map and would invalidate our iterators.
   lock_guard<mutex> lock(timersMutex);
 
+  // Stop the innermost timers first, as if they had been stopped in order.
   high_resolution_clock::time_point currTime = high_resolution_clock::now();
-  for (auto it : timerStartTime)
-    for (auto it2 : it.second)
-      timers[it2.first] += duration_cast<microseconds>(currTime - it2.second);
+  for (auto& it : runningTimers)
+    for (size_t i = it.second.size(); i > 0; --i)
+      Record(it.second[i - 1], it.first, currTime);
 
-  // If all timers are stopped, we can clear the maps.
-  timerStartTime.clear();
+  // If all timers are stopped, we can clear the map.
+  runningTimers.clear();
 }
 
 void Timers::StartTimer(const string& timerName,
@@ -181,16 +367,20 @@ void Timers::StartTimer(const string& timerName,
 
   lock_guard<mutex> lock(timersMutex);
 
-  if ((timerStartTime.count(threadId) > 0) &&
-      (timerStartTime[threadId].count(timerName)))
+  vector<RunningTimer>& running = runningTimers[threadId];
+  for (size_t i = 0; i < running.size(); ++i)
   {
-    ostringstream error;
-    error << "Timer::Start(): timer '" << timerName
-        << "' has already been started";
-    throw runtime_error(error.str());
+    if (running[i].name == timerName)
+    {
+      ostringstream error;
+      error << "Timer::Start(): timer '" << timerName
+          << "' has already been started";
+      throw runtime_error(error.str());
+    }
   }
 
-  high_resolution_clock::time_point currTime = high_resolution_clock::now();
+  // Number the thread in the order it first started a timer.
+  threadIndices.insert(make_pair(threadId, threadIndices.size()));
 
   // If the timer is added for the first time.
   if (timers.count(timerName) == 0)
@@ -198,7 +388,18 @@ void Timers::StartTimer(const string& timerName,
     timers[timerName] = (microseconds) 0;
   }
 
-  timerStartTime[threadId][timerName] = currTime;
+  // The timer is a child of the most recently started timer that is still
+  // running on this thread.
+  RunningTimer timer;
+  timer.name = timerName;
+  timer.path = running.empty() ? timerName :
+      running.back().path + "/" + timerName;
+  timer.trackMemory = memoryTracking;
+  timer.startMemory = timer.trackMemory ? util::ResidentMemory() : 0;
+  timer.peakMemory = timer.startMemory;
+  timer.startAllocations = timer.trackMemory ? util::AllocationCount() : 0;
+  timer.start = high_resolution_clock::now();
+  running.push_back(timer);
 }
 
 void Timers::StopTimer(const string& timerName,
@@ -208,10 +409,22 @@ void Timers::StopTimer(const string& timerName,
   if (!enabled)
     return;
 
+  high_resolution_clock::time_point currTime = high_resolution_clock::now();
+
   lock_guard<mutex> lock(timersMutex);
 
-  if ((timerStartTime.count(threadId) == 0) ||
-      (timerStartTime[threadId].count(timerName) == 0))
+  vector<RunningTimer>* running = NULL;
+  size_t index = 0;
+  if (runningTimers.count(threadId) > 0)
+  {
+    running = &runningTimers[threadId];
+    index = running->size();
+    for (size_t i = 0; i < running->size(); ++i)
+      if ((*running)[i].name == timerName)
+        index = i;
+  }
+
+  if (running == NULL || index == running->size())
   {
     ostringstream error;
     error << "Timer::Stop(): no timer with name '" << timerName
@@ -219,14 +432,162 @@ void Timers::StopTimer(const string& timerName,
     throw runtime_error(error.str());
   }
 
-  high_resolution_clock::time_point currTime = high_resolution_clock::now();
+  Record((*running)[index], threadId, currTime);
+
+  // Remove the entries.
+  running->erase(running->begin() + index);
+  if (running->empty())
+    runningTimers.erase(threadId);
+}
+
+void Timers::Record(const RunningTimer& timer,
+                    const thread::id& threadId,
+                    const high_resolution_clock::time_point& stop)
+{
+  const microseconds duration = duration_cast<microseconds>(stop -
+      timer.start);
+  const size_t thread = threadIndices[threadId];
 
   // Calculate the delta time.
-  timers[timerName] += duration_cast<microseconds>(currTime -
-      timerStartTime[threadId][timerName]);
+  timers[timer.name] += duration;
+  statistics[timer.path][thread].Add(duration);
 
-  // Remove the entries.
-  timerStartTime[threadId].erase(timerName);
-  if (timerStartTime[threadId].empty())
-    timerStartTime.erase(threadId);
+  if (timer.trackMemory)
+  {
+    const size_t memory = util::ResidentMemory();
+    memoryStatistics[timer.path].Add(timer.startMemory,
+        std::max(timer.peakMemory, memory), memory,
+        util::AllocationCount() - timer.startAllocations);
+  }
+
+  if (traceEvents.size() < maxTraceEvents)
+  {
+    TraceEvent event;
+    event.name = timer.name;
+    event.path = timer.path;
+    event.thread = thread;
+    event.start = duration_cast<microseconds>(timer.start - epoch);
+    event.duration = duration;
+    traceEvents.push_back(event);
+  }
+  else
+  {
+    ++droppedTraceEvents;
+  }
+}
+
+// Escape a string for output in JSON.
+static string EscapeJSON(const string& str)
+{
+  ostringstream oss;
+  for (size_t i = 0; i < str.size(); ++i)
+  {
+    const char c = str[i];
+    if (c == '"' || c == '\\')
+      oss << '\\' << c;
+    else if (c == '\n')
+      oss << "\\n";
+    else if ((unsigned char) c < 0x20)
+      oss << "\\u" << hex << setw(4) << setfill('0') << (int) c << dec;
+    else
+      oss << c;
+  }
+
+  return oss.str();
+}
+
+// Write the statistics of one timer as the start of a JSON object; the caller
+// closes the object.
+static void WriteStatistics(ostream& stream, const TimerStatistics& s)
+{
+  stream << "{\"count\": " << s.count << ", \"total_us\": " << s.total.count()
+      << ", \"min_us\": " << s.min.count() << ", \"max_us\": "
+      << s.max.count();
+}
+
+void Timers::WriteTrace(ostream& stream)
+{
+  lock_guard<mutex> lock(timersMutex);
+
+  stream << "{" << endl << "\"traceEvents\": [" << endl;
+
+  // Name the threads, so that trace viewers label them consistently.
+  bool first = true;
+  for (auto& it : threadIndices)
+  {
+    stream << (first ? "" : ",\n") << "  {\"name\": \"thread_name\", "
+        << "\"ph\": \"M\", \"pid\": 0, \"tid\": " << it.second
+        << ", \"args\": {\"name\": \"thread " << it.second << "\"}}";
+    first = false;
+  }
+
+  for (size_t i = 0; i < traceEvents.size(); ++i)
+  {
+    const TraceEvent& e = traceEvents[i];
+    stream << (first ? "" : ",\n") << "  {\"name\": \""
+        << EscapeJSON(e.name) << "\", \"cat\": \"mlpack\", \"ph\": \"X\", "
+        << "\"pid\": 0, \"tid\": " << e.thread << ", \"ts\": "
+        << e.start.count() << ", \"dur\": " << e.duration.count()
+        << ", \"args\": {\"path\": \"" << EscapeJSON(e.path) << "\"}}";
+    first = false;
+  }
+
+  stream << endl << "]," << endl << "\"displayTimeUnit\": \"ms\"," << endl
+      << "\"droppedEvents\": " << droppedTraceEvents << "," << endl
+      << "\"timers\": {" << endl;
+
+  first = true;
+  for (auto& it : statistics)
+  {
+    TimerStatistics total;
+    for (auto& it2 : it.second)
+      total.Add(it2.second);
+
+    stream << (first ? "" : ",\n") << "  \"" << EscapeJSON(it.first) << "\": ";
+    WriteStatistics(stream, total);
+    stream << ", \"threads\": {";
+    for (auto it2 = it.second.begin(); it2 != it.second.end(); ++it2)
+    {
+      stream << ((it2 == it.second.begin()) ? "" : ", ") << "\""
+          << it2->first << "\": ";
+      WriteStatistics(stream, it2->second);
+      stream << "}";
+    }
+    stream << "}}";
+    first = false;
+  }
+
+  stream << endl << "}," << endl << "\"counters\": {" << endl;
+
+  first = true;
+  for (auto& it : counters)
+  {
+    stream << (first ? "" : ",\n") << "  \"" << EscapeJSON(it.first) << "\": "
+        << it.second;
+    first = false;
+  }
+
+  stream << endl << "}";
+
+  if (!memoryStatistics.empty())
+  {
+    stream << "," << endl << "\"memory\": {" << endl;
+
+    first = true;
+    for (auto& it : memoryStatistics)
+    {
+      const MemoryStatistics& m = it.second;
+      stream << (first ? "" : ",\n") << "  \"" << EscapeJSON(it.first)
+          << "\": {\"peak_bytes\": " << m.peak << ", \"current_bytes\": "
+          << m.current << ", \"growth_bytes\": " << m.growth;
+      if (util::AllocationsTracked())
+        stream << ", \"allocations\": " << m.allocations;
+      stream << "}";
+      first = false;
+    }
+
+    stream << endl << "}";
+  }
+
+  stream << endl << "}" << endl;
 }
@@ -20,7 +20,11 @@
 #include <thread> // std::thread is used for thread safety.
 #include <mutex>
 #include <list>
+#include <vector>
+#include <ostream>
 #include <atomic>
+#include <algorithm>
+#include <condition_variable>
 
 #if defined(_WIN32)
   // uint64_t isn't defined on every windows.
@@ -35,12 +39,101 @@
 
 namespace mlpack {
 
+/**
+ * Statistics collected for one timer: the number of times it was run, and the
+ * total, shortest and longest run time.
+ */
+struct TimerStatistics
+{
+  //! Create empty statistics.
+  TimerStatistics() : count(0), total(0), min(0), max(0) { }
+
+  //! Add a run of the given duration.
+  void Add(const std::chrono::microseconds& duration)
+  {
+    if (count == 0 || duration < min)
+      min = duration;
+    if (count == 0 || duration > max)
+      max = duration;
+    total += duration;
+    ++count;
+  }
+
+  //! Add the runs summarized by other statistics.
+  void Add(const TimerStatistics& other)
+  {
+    if (other.count == 0)
+      return;
+    if (count == 0 || other.min < min)
+      min = other.min;
+    if (count == 0 || other.max > max)
+      max = other.max;
+    total += other.total;
+    count += other.count;
+  }
+
+  //! The number of times the timer was run.
+  size_t count;
+  //! The total time of all runs.
+  std::chrono::microseconds total;
+  //! The shortest run.
+  std::chrono::microseconds min;
+  //! The longest run.
+  std::chrono::microseconds max;
+};
+
+/**
+ * Memory statistics collected for one timer while memory tracking is enabled
+ * (see Timer::EnableMemoryTracking()).  The memory is the resident memory of
+ * the whole process, so the statistics of timers running at the same time in
+ * different threads overlap.
+ */
+struct MemoryStatistics
+{
+  //! Create empty statistics.
+  MemoryStatistics() : peak(0), current(0), growth(0), allocations(0) { }
+
+  /**
+   * Add a run of the timer.
+   *
+   * @param start Resident memory when the run started, in bytes.
+   * @param peakMemory Highest resident memory seen during the run, in bytes.
+   * @param end Resident memory when the run stopped, in bytes.
+   * @param runAllocations Number of allocations made during the run.
+   */
+  void Add(const size_t start,
+           const size_t peakMemory,
+           const size_t end,
+           const size_t runAllocations)
+  {
+    peak = std::max(peak, peakMemory);
+    current = end;
+    growth = std::max(growth, (peakMemory > start) ? peakMemory - start : 0);
+    allocations += runAllocations;
+  }
+
+  //! The highest resident memory seen during any run, in bytes.
+  size_t peak;
+  //! The resident memory when the last run stopped, in bytes.
+  size_t current;
+  //! The largest increase of the resident memory during a run, in bytes.
+  size_t growth;
+  //! The number of allocations made during all runs (see
+  //! util::AllocationCount()).
+  size_t allocations;
+};
+
 /**
  * The timer class provides a way for mlpack methods to be timed.  The three
  * methods contained in this class allow a named timer to be started and
  * stopped, and its value to be obtained.  A named timer is specific to the
  * thread it is running on, so if you start a timer in one thread, it cannot be
  * stopped from a different thread.
+ *
+ * Timers may be nested: a timer started while another timer is running on the
+ * same thread is a child of that timer, and its statistics are also recorded
+ * under a hierarchical path such as "total_time/tree_building".  Get() always
+ * returns the total over all paths and threads for the given name.
  */
 class Timer
 {
@@ -75,6 +168,55 @@ class Timer
    */
   static std::chrono::microseconds Get(const std::string& name);
 
+  /**
+   * Get the statistics of the given timer, summed over all threads.  The timer
+   * is identified by its hierarchical path, e.g. "total_time/tree_building".
+   *
+   * @param path Hierarchical path of the timer.
+   */
+  static TimerStatistics GetStatistics(const std::string& path);
+
+  /**
+   * Add the given value to a counter.  Like a timer started now, the counter is
+   * a child of the innermost timer running on this thread, so "base_cases"
+   * counted while "computing_neighbors" runs is recorded as
+   * "computing_neighbors/base_cases".  Nothing is recorded if timing is
+   * disabled.
+   *
+   * @param name Name of the counter.
+   * @param value Value to add to the counter.
+   */
+  static void AddCounter(const std::string& name, const size_t value = 1);
+
+  /**
+   * Get the value of the given counter, identified by its hierarchical path.
+   *
+   * @param path Hierarchical path of the counter.
+   */
+  static size_t GetCounter(const std::string& path);
+
+  /**
+   * Enable the tracking of memory: while timing is enabled, the resident memory
+   * of the process and the number of allocations are recorded when each timer
+   * starts and stops, and a thread samples the resident memory every
+   * samplingInterval milliseconds to find the peak of each running timer.
+   *
+   * @param samplingInterval Milliseconds between two samples; 0 only samples
+   *     when timers start and stop.
+   */
+  static void EnableMemoryTracking(const size_t samplingInterval = 10);
+
+  //! Disable the tracking of memory.
+  static void DisableMemoryTracking();
+
+  /**
+   * Get the memory statistics of the given timer, identified by its
+   * hierarchical path.
+   *
+   * @param path Hierarchical path of the timer.
+   */
+  static MemoryStatistics GetMemoryStatistics(const std::string& path);
+
   /**
    * Enable timing of mlpack programs.  Do not run this while timers are
    * running!
@@ -94,11 +236,58 @@ class Timer
   static void ResetAll();
 };
 
+/**
+ * A ScopedTimer starts the given timer when it is constructed and stops it when
+ * it goes out of scope, so that the timer is stopped even if an exception is
+ * thrown.
+ *
+ * @code
+ * {
+ *   ScopedTimer t("tree_building");
+ *   // Build the tree...
+ * } // The "tree_building" timer is stopped here.
+ * @endcode
+ */
+class ScopedTimer
+{
+ public:
+  /**
+   * Start the given timer.
+   *
+   * @param name Name of timer to be started.
+   */
+  explicit ScopedTimer(const std::string& name) : name(name)
+  {
+    Timer::Start(name);
+  }
+
+  //! Stop the timer, if it is still running.
+  ~ScopedTimer();
+
+  // A ScopedTimer can be neither copied nor assigned.
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  //! The name of the timer.
+  std::string name;
+};
+
 class Timers
 {
  public:
   //! Default to disabled.
-  Timers() : enabled(false) { }
+  Timers() :
+      epoch(std::chrono::high_resolution_clock::now()),
+      maxTraceEvents(100000),
+      droppedTraceEvents(0),
+      stopSampler(false),
+      enabled(false),
+      memoryTracking(false)
+  { }
+
+  //! Stop the memory sampling thread, if it is running.
+  ~Timers();
 
   /**
    * Returns a copy of all the timers used via this interface.
@@ -119,6 +308,56 @@ class Timers
    */
   std::chrono::microseconds GetTimer(const std::string& timerName);
 
+  /**
+   * Returns the statistics of all timers that have been stopped, summed over
+   * all threads, indexed by their hierarchical path.
+   */
+  std::map<std::string, TimerStatistics> GetAllStatistics();
+
+  /**
+   * Returns the statistics of all timers that have been stopped, separately for
+   * each thread.  Threads are numbered in the order they first started a timer.
+   */
+  std::map<size_t, std::map<std::string, TimerStatistics>>
+  GetThreadStatistics();
+
+  /**
+   * Returns a copy of all the counters, indexed by their hierarchical path.
+   */
+  std::map<std::string, size_t> GetAllCounters();
+
+  /**
+   * Returns the memory statistics of all timers that have been stopped while
+   * memory tracking was enabled, indexed by their hierarchical path.
+   */
+  std::map<std::string, MemoryStatistics> GetAllMemoryStatistics();
+
+  /**
+   * Enable the tracking of memory (see Timer::EnableMemoryTracking()).
+   *
+   * @param samplingInterval Milliseconds between two samples of the resident
+   *     memory; 0 only samples when timers start and stop.
+   */
+  void EnableMemoryTracking(const size_t samplingInterval);
+
+  //! Disable the tracking of memory, stopping the sampling thread.
+  void DisableMemoryTracking();
+
+  //! Get whether or not memory tracking is enabled.
+  bool MemoryTracking() const { return memoryTracking; }
+
+  /**
+   * Add the given value to a counter, which is a child of the innermost timer
+   * running on the given thread.
+   *
+   * @param name The name of the counter.
+   * @param value The value to add to the counter.
+   * @param threadId Id of the thread accessing the counter.
+   */
+  void AddCounter(const std::string& name,
+                  const size_t value,
+                  const std::thread::id& threadId = std::thread::id());
+
   /**
    * Prints the specified timer.  If it took longer than a minute to complete
    * the timer will be displayed in days, hours, and minutes as well.
@@ -162,22 +401,114 @@ class Timers
    */
   void StopAllTimers();
 
+  /**
+   * Write all the timers in the Chrome trace-event JSON format, which can be
+   * loaded with chrome://tracing or Perfetto.  Every run of a timer is written
+   * as one complete event (up to MaxTraceEvents() runs), and the aggregated
+   * statistics of each hierarchical timer are written under the "timers" key
+   * and the counters under the "counters" key.  If memory tracking was
+   * enabled, the memory statistics are written under the "memory" key.
+   *
+   * @param stream Stream to write the trace to.
+   */
+  void WriteTrace(std::ostream& stream);
+
+  //! Get the maximum number of timer runs to keep for WriteTrace().
+  size_t MaxTraceEvents() const { return maxTraceEvents; }
+  //! Modify the maximum number of timer runs to keep for WriteTrace().
+  size_t& MaxTraceEvents() { return maxTraceEvents; }
+
   //! Modify whether or not timing is enabled.
   std::atomic<bool>& Enabled() { return enabled; }
   //! Get whether or not timing is enabled.
   bool Enabled() const { return enabled; }
 
  private:
+  //! A timer that is currently running on some thread.
+  struct RunningTimer
+  {
+    //! The name of the timer.
+    std::string name;
+    //! The hierarchical path of the timer.
+    std::string path;
+    //! The time the timer was started at.
+    std::chrono::high_resolution_clock::time_point start;
+    //! Whether the memory is tracked for this run.
+    bool trackMemory;
+    //! The resident memory when the timer was started.
+    size_t startMemory;
+    //! The highest resident memory seen while the timer runs.
+    size_t peakMemory;
+    //! The allocation count when the timer was started.
+    size_t startAllocations;
+  };
+
+  //! One finished run of a timer, for WriteTrace().
+  struct TraceEvent
+  {
+    //! The name of the timer.
+    std::string name;
+    //! The hierarchical path of the timer.
+    std::string path;
+    //! The index of the thread the timer ran on.
+    size_t thread;
+    //! The start of the run, relative to the epoch.
+    std::chrono::microseconds start;
+    //! The duration of the run.
+    std::chrono::microseconds duration;
+  };
+
+  /**
+   * Sample the resident memory every interval until stopSampler is set, and
+   * update the peak memory of the running timers.
+   */
+  void SampleMemory(const std::chrono::milliseconds interval);
+
+  //! Stop the sampling thread, if it is running.  timersMutex must not be held.
+  void StopSampler();
+
+  /**
+   * Record a finished run of the given timer.  timersMutex must be held.
+   */
+  void Record(const RunningTimer& timer,
+              const std::thread::id& threadId,
+              const std::chrono::high_resolution_clock::time_point& stop);
+
   //! A map of all the timers that are being tracked.
   std::map<std::string, std::chrono::microseconds> timers;
   //! A mutex for modifying the timers.
   std::mutex timersMutex;
-  //! A map for the starting values of the timers.
-  std::map<std::thread::id, std::map<std::string,
-      std::chrono::high_resolution_clock::time_point>> timerStartTime;
+  //! The currently running timers of each thread, in the order they were
+  //! started.
+  std::map<std::thread::id, std::vector<RunningTimer>> runningTimers;
+  //! The index assigned to each thread that has started a timer.
+  std::map<std::thread::id, size_t> threadIndices;
+  //! The statistics of each hierarchical timer, for each thread index.
+  std::map<std::string, std::map<size_t, TimerStatistics>> statistics;
+  //! The value of each hierarchical counter.
+  std::map<std::string, size_t> counters;
+  //! The memory statistics of each hierarchical timer.
+  std::map<std::string, MemoryStatistics> memoryStatistics;
+  //! The finished runs kept for WriteTrace().
+  std::vector<TraceEvent> traceEvents;
+  //! The time trace events are relative to.
+  std::chrono::high_resolution_clock::time_point epoch;
+  //! The maximum number of runs to keep in traceEvents.
+  size_t maxTraceEvents;
+  //! The number of runs that did not fit in traceEvents.
+  size_t droppedTraceEvents;
+
+  //! The thread sampling the resident memory.
+  std::thread sampler;
+  //! Used to wake up the sampling thread when it must stop.
+  std::condition_variable samplerCondition;
+  //! Whether the sampling thread must stop (guarded by timersMutex).
+  bool stopSampler;
 
   //! Whether or not timing is enabled.
   std::atomic<bool> enabled;
+  //! Whether or not memory tracking is enabled.
+  std::atomic<bool> memoryTracking;
 };
 
 } // namespace mlpack
@@ -149,7 +149,11 @@ class AdaBoost
              const double tolerance = 1e-6);
 
   /**
-   * Classify the given test points.
+   * Classify the given test points.  The points are handled in blocks of
+   * ClassifyBlockSize points, in parallel; every weak learner classifies a
+   * block before the next block is looked at.  This means that the Classify()
+   * method of the weak learners must be safe to call from several threads at
+   * once (like those of Perceptron and DecisionStump).
    *
    * @param test Testing data.
    * @param predictedLabels Vector in which to the predicted labels of the test
@@ -164,6 +168,9 @@ class AdaBoost
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  //! The number of points classified by all the weak learners at once.
+  static const size_t ClassifyBlockSize = 1024;
+
   //! The number of classes in the model.
   size_t numClasses;
   // The tolerance for change in rt and when to stop.
@@ -28,6 +28,8 @@
 
 #include "adaboost.hpp"
 
+#include <mlpack/core/util/parallel_blocks.hpp>
+
 namespace mlpack {
 namespace adaboost {
 
@@ -86,13 +88,6 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   // To be used for prediction by the weak learner.
   arma::Row<size_t> predictedLabels(labels.n_cols);
 
-  // Use tempData to modify input data for incorporating weights.
-  MatType tempData(data);
-
-  // This matrix is a helper matrix used to calculate the final hypothesis.
-  arma::mat sumFinalH = arma::zeros<arma::mat>(numClasses,
-      predictedLabels.n_cols);
-
   // Load the initial weights into a 2-D matrix.
   const double initWeight = 1.0 / double(data.n_cols * numClasses);
   arma::mat D(numClasses, data.n_cols);
@@ -101,38 +96,31 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   // Weights are stored in this row vector.
   arma::rowvec weights(predictedLabels.n_cols);
 
-  // This is the final hypothesis.
-  arma::Row<size_t> finalH(predictedLabels.n_cols);
+  // The signed weight of each point: positive if the weak learner classifies
+  // it correctly, negative otherwise.
+  arma::rowvec signedWeights(predictedLabels.n_cols);
 
   // Now, start the boosting rounds.
   for (size_t i = 0; i < iterations; i++)
   {
-    // Initialized to zero in every round.  rt is used for calculation of
-    // alphat; it is the weighted error.
-    // rt = (sum) D(i) y(i) ht(xi)
-    rt = 0.0;
-
-    // zt is used for weight normalization.
-    zt = 0.0;
-
     // Build the weight vectors.
     weights = arma::sum(D);
 
-    // Use the existing weak learner to train a new one with new weights.
-    WeakLearnerType w(other, tempData, labels, numClasses, weights);
-    w.Classify(tempData, predictedLabels);
-
-    // Now from predictedLabels, build ht, the weak hypothesis
-    // buildClassificationMatrix(ht, predictedLabels);
+    // Use the existing weak learner to train a new one with new weights.  The
+    // weak learner takes the weights directly, so the data is never copied.
+    WeakLearnerType w(other, data, labels, numClasses, weights);
+    w.Classify(data, predictedLabels);
 
-    // Now, calculate alpha(t) using ht.
-    for (size_t j = 0; j < D.n_cols; j++) // instead of D, ht
+    // Now, calculate alpha(t) using ht.  rt is used for calculation of alphat;
+    // it is the weighted error.
+    // rt = (sum) D(i) y(i) ht(xi)
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) D.n_cols; j++)
     {
-      if (predictedLabels(j) == labels(j))
-        rt += arma::accu(D.col(j));
-      else
-        rt -= arma::accu(D.col(j));
+      signedWeights[j] = (predictedLabels[j] == labels[j]) ? weights[j] :
+          -weights[j];
     }
+    rt = arma::accu(signedWeights);
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
       break;
@@ -155,44 +143,20 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
-    for (size_t j = 0; j < D.n_cols; j++)
+    // Now start modifying the weights: each point's weights are only scaled,
+    // so the points are handled in parallel.
+    const double expo = exp(alphat);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) D.n_cols; j++)
     {
-      const double expo = exp(alphat);
-      if (predictedLabels(j) == labels(j))
-      {
-        for (size_t k = 0; k < D.n_rows; k++)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) /= expo;
-          zt += D(k, j); // * exp(-1 * alphat * yt(j,k) * ht(j,k));
-
-          // Add to the final hypothesis matrix.
-          // sumFinalH(k, j) += (alphat * ht(k, j));
-          if (k == labels(j))
-            sumFinalH(k, j) += (alphat); // * ht(k, j));
-          else
-            sumFinalH(k, j) -= (alphat);
-        }
-      }
+      if (predictedLabels[j] == labels[j])
+        D.unsafe_col(j) /= expo;
       else
-      {
-        for (size_t k = 0; k < D.n_rows; k++)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) *= expo;
-          zt += D(k, j);
-
-          // Add to the final hypothesis matrix.
-          if (k == labels(j))
-            sumFinalH(k, j) += alphat; // * ht(k, j));
-          else
-            sumFinalH(k, j) -= alphat;
-        }
-      }
+        D.unsafe_col(j) *= expo;
     }
 
-    // Normalize D.
+    // zt is the normalization constant; normalize D.
+    zt = arma::accu(D);
     D /= zt;
 
     // Accumulate the value of zt for the Hamming loss bound.
@@ -208,29 +172,32 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::Row<size_t> tempPredictedLabels(test.n_cols);
-  arma::mat cMatrix(numClasses, test.n_cols);
-
-  cMatrix.zeros();
   predictedLabels.set_size(test.n_cols);
 
-  for (size_t i = 0; i < wl.size(); i++)
+  // The points are split into blocks, and every weak learner classifies a
+  // block while it is still in cache.  The blocks are independent, so they are
+  // handled in parallel.
+  util::ParallelBlocks(test.n_cols, [&](const size_t begin, const size_t end)
   {
-    wl[i].Classify(test, tempPredictedLabels);
+    const MatType block = test.cols(begin, end);
+    arma::Row<size_t> tempPredictedLabels(block.n_cols);
+    arma::mat cMatrix = arma::zeros<arma::mat>(numClasses, block.n_cols);
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
-      cMatrix(tempPredictedLabels(j), j) += alpha[i];
-  }
+    for (size_t i = 0; i < wl.size(); i++)
+    {
+      wl[i].Classify(block, tempPredictedLabels);
 
-  arma::colvec cMRow;
-  arma::uword maxIndex = 0;
+      for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
+        cMatrix(tempPredictedLabels(j), j) += alpha[i];
+    }
 
-  for (size_t i = 0; i < predictedLabels.n_cols; i++)
-  {
-    cMRow = cMatrix.unsafe_col(i);
-    cMRow.max(maxIndex);
-    predictedLabels(i) = maxIndex;
-  }
+    arma::uword maxIndex = 0;
+    for (size_t j = 0; j < block.n_cols; j++)
+    {
+      cMatrix.unsafe_col(j).max(maxIndex);
+      predictedLabels(begin + j) = maxIndex;
+    }
+  }, ClassifyBlockSize);
 }
 
 /**
@@ -0,0 +1,71 @@
+/**
+ * @file sampled_product.hpp
+ *
+ * Evaluation of W * H only at the nonzero entries of a sparse matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_SAMPLED_PRODUCT_HPP
+#define MLPACK_METHODS_AMF_SAMPLED_PRODUCT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * Compute f(V(i, j), (W * H)(i, j)) for each nonzero entry V(i, j) of the
+ * sparse matrix V, and return the results as a sparse matrix with the same
+ * nonzero pattern as V.  This is a sampled dense-dense matrix product: W * H,
+ * which is dense and may be far too large to store, is never formed, and the
+ * cost is O(nnz(V) * rank).  The columns of V are processed in parallel.
+ *
+ * For example, the residual of the factorization at the nonzero entries is
+ *
+ * @code
+ * arma::sp_mat residual = SampledProduct(V, W, H,
+ *     [](const double v, const double wh) { return v - wh; });
+ * @endcode
+ *
+ * Entries for which f returns 0 are dropped from the result.
+ *
+ * @param V Sparse matrix giving the entries to evaluate.
+ * @param W Left factor (V.n_rows x rank).
+ * @param H Right factor (rank x V.n_cols).
+ * @param f Function of the entry of V and the entry of W * H.
+ */
+template<typename FunctionType>
+inline arma::sp_mat SampledProduct(const arma::sp_mat& V,
+                                   const arma::mat& W,
+                                   const arma::mat& H,
+                                   FunctionType f)
+{
+  // Rows of W are strided; the columns of its transpose are contiguous.
+  const arma::mat wt = W.t();
+
+  arma::vec values(V.n_nonzero);
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t j = 0; j < (omp_size_t) V.n_cols; ++j)
+  {
+    for (size_t k = V.col_ptrs[j]; k < V.col_ptrs[j + 1]; ++k)
+    {
+      const size_t i = V.row_indices[k];
+      values[k] = f(V.values[k], arma::dot(wt.col(i), H.col(j)));
+    }
+  }
+
+  // The result has exactly the structure of V.
+  const arma::uvec rowIndices(const_cast<arma::uword*>(V.row_indices),
+      V.n_nonzero, false, true);
+  const arma::uvec colPtrs(const_cast<arma::uword*>(V.col_ptrs),
+      V.n_cols + 1, false, true);
+  return arma::sp_mat(rowIndices, colPtrs, values, V.n_rows, V.n_cols);
+}
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
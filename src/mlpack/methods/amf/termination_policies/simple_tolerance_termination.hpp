@@ -13,6 +13,7 @@
 #define _MLPACK_METHODS_AMF_SIMPLE_TOLERANCE_TERMINATION_HPP_INCLUDED
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/amf/sampled_product.hpp>
 
 namespace mlpack {
 namespace amf {
@@ -68,32 +69,9 @@ class SimpleToleranceTermination
    */
   bool IsConverged(arma::mat& W, arma::mat& H)
   {
-    arma::mat WH;
-
-    WH = W * H;
-
     // compute residue
     residueOld = residue;
-    size_t n = V->n_rows;
-    size_t m = V->n_cols;
-    double sum = 0;
-    size_t count = 0;
-    for (size_t i = 0; i < n; i++)
-    {
-        for (size_t j = 0; j < m; j++)
-        {
-            double temp = 0;
-            if ((temp = (*V)(i, j)) != 0)
-            {
-                temp = (temp - WH(i, j));
-                temp = temp * temp;
-                sum += temp;
-                count++;
-            }
-        }
-    }
-    residue = sum / count;
-    residue = sqrt(residue);
+    residue = NonzeroRMSE(*V, W, H);
 
     // increment iteration count
     iteration++;
@@ -160,6 +138,44 @@ class SimpleToleranceTermination
   double& Tolerance() { return tolerance; }
 
  private:
+  //! Compute the RMSE of W * H over the nonzero entries of the dense matrix V.
+  template<typename VType>
+  static double NonzeroRMSE(const VType& V,
+                            const arma::mat& W,
+                            const arma::mat& H)
+  {
+    const arma::mat WH = W * H;
+
+    double sum = 0;
+    size_t count = 0;
+    for (size_t j = 0; j < V.n_cols; j++)
+    {
+      for (size_t i = 0; i < V.n_rows; i++)
+      {
+        if (V(i, j) != 0)
+        {
+          const double temp = V(i, j) - WH(i, j);
+          sum += temp * temp;
+          count++;
+        }
+      }
+    }
+
+    return std::sqrt(sum / count);
+  }
+
+  //! Compute the RMSE of W * H over the nonzero entries of the sparse matrix
+  //! V, without forming W * H.
+  static double NonzeroRMSE(const arma::sp_mat& V,
+                            const arma::mat& W,
+                            const arma::mat& H)
+  {
+    const arma::sp_mat residual = SampledProduct(V, W, H,
+        [](const double v, const double wh) { return v - wh; });
+
+    return std::sqrt(arma::accu(arma::square(residual)) / V.n_nonzero);
+  }
+
   //! tolerance
   double tolerance;
   //! iteration threshold
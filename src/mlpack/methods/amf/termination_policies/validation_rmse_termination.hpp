@@ -113,10 +113,6 @@ class ValidationRMSETermination
    */
   bool IsConverged(arma::mat& W, arma::mat& H)
   {
-    arma::mat WH;
-
-    WH = W * H;
-
     // compute validation RMSE
     if (iteration != 0)
     {
@@ -127,7 +123,7 @@ class ValidationRMSETermination
         size_t t_row = test_points(i, 0);
         size_t t_col = test_points(i, 1);
         double t_val = test_points(i, 2);
-        double temp = (t_val - WH(t_row, t_col));
+        double temp = (t_val - arma::dot(W.row(t_row), H.col(t_col)));
         temp *= temp;
         rmse += temp;
       }
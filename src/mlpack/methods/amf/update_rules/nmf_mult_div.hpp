@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_LMF_UPDATE_RULES_NMF_MULT_DIV_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/amf/sampled_product.hpp>
 
 namespace mlpack {
 namespace amf {
@@ -154,6 +155,44 @@ class NMFMultiplicativeDivergenceUpdate
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
 };
 
+/**
+ * WUpdate specialization for sparse matrices.  Zero entries of V contribute
+ * nothing to the sums, so V / (W H) is only evaluated at the nonzero entries
+ * of V, and W * H is never formed.
+ */
+template<>
+inline void NMFMultiplicativeDivergenceUpdate::WUpdate<arma::sp_mat>(
+    const arma::sp_mat& V,
+    arma::mat& W,
+    const arma::mat& H)
+{
+  const arma::sp_mat ratio = SampledProduct(V, W, H,
+      [](const double v, const double wh) { return v / wh; });
+  const arma::mat numerator = ratio * H.t();
+  const arma::rowvec hSums = arma::sum(H, 1).t();
+
+  W %= numerator.each_row() / hSums;
+}
+
+/**
+ * HUpdate specialization for sparse matrices.  Zero entries of V contribute
+ * nothing to the sums, so V / (W H) is only evaluated at the nonzero entries
+ * of V, and W * H is never formed.
+ */
+template<>
+inline void NMFMultiplicativeDivergenceUpdate::HUpdate<arma::sp_mat>(
+    const arma::sp_mat& V,
+    const arma::mat& W,
+    arma::mat& H)
+{
+  const arma::sp_mat ratio = SampledProduct(V, W, H,
+      [](const double v, const double wh) { return v / wh; });
+  const arma::mat numerator = W.t() * ratio;
+  const arma::vec wSums = arma::sum(W, 0).t();
+
+  H %= numerator.each_col() / wSums;
+}
+
 } // namespace amf
 } // namespace mlpack
 
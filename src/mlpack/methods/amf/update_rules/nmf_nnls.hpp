@@ -0,0 +1,263 @@
+/**
+ * @file nmf_nnls.hpp
+ *
+ * Alternating nonnegative least squares update rules for the Non-negative
+ * Matrix Factorization, solved with block principal pivoting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LMF_UPDATE_RULES_NMF_NNLS_HPP
+#define MLPACK_METHODS_LMF_UPDATE_RULES_NMF_NNLS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/parallel_blocks.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class implements alternating nonnegative least squares, where each
+ * update solves the nonnegativity-constrained least squares problem for W (or
+ * H) exactly, with the block principal pivoting method described in the
+ * following paper:
+ *
+ * @code
+ * @article{kim2011fast,
+ *   title={Fast nonnegative matrix factorization: An active-set-like method
+ *       and comparisons},
+ *   author={Kim, J. and Park, H.},
+ *   journal={SIAM Journal on Scientific Computing},
+ *   volume={33},
+ *   number={6},
+ *   pages={3261--3281},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * Unlike NMFALSUpdate, which computes the unconstrained solution and sets its
+ * negative elements to 0, the solution is the minimizer of
+ * \f$ \sqrt{\sum_i \sum_j(V-WH)^2} \f$ over the nonnegative W (or H), so the
+ * residue can't increase between iterations.
+ *
+ * Each column of H (and each row of W) is an independent problem that only
+ * depends on the Gram matrix \f$ W^T W \f$ (or \f$ H H^T \f$) and one column of
+ * \f$ W^T V \f$ (or \f$ H V^T \f$); these are computed once per update, and the
+ * columns are solved in parallel with OpenMP.  The previous solution gives the
+ * initial set of nonzero variables of each problem, so that after the first
+ * iterations only a few pivots are needed.
+ */
+class NMFNNLSUpdate
+{
+ public:
+  //! Empty constructor required for the UpdateRule template.
+  NMFNNLSUpdate() { }
+
+  /**
+   * Set initial values for the factorization.  In this case, we don't need to
+   * set anything.
+   */
+  template<typename MatType>
+  void Initialize(const MatType& /* dataset */, const size_t /* rank */)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * The update rule for the basis matrix W.  Each row of W is set to the
+   * nonnegative solution of
+   *
+   * \f[
+   * \min_{w \geq 0} \| H^T w - v \|
+   * \f]
+   *
+   * where v is the corresponding row of V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline static void WUpdate(const MatType& V,
+                             arma::mat& W,
+                             const arma::mat& H)
+  {
+    const arma::mat gram = H * H.t();
+    const arma::mat rhs = (V * H.t()).t();
+
+    arma::mat wt = W.t();
+    SolveNNLS(gram, rhs, wt);
+    W = wt.t();
+  }
+
+  /**
+   * The update rule for the encoding matrix H.  Each column of H is set to the
+   * nonnegative solution of
+   *
+   * \f[
+   * \min_{h \geq 0} \| W h - v \|
+   * \f]
+   *
+   * where v is the corresponding column of V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline static void HUpdate(const MatType& V,
+                             const arma::mat& W,
+                             arma::mat& H)
+  {
+    const arma::mat gram = W.t() * W;
+    const arma::mat rhs = W.t() * V;
+
+    SolveNNLS(gram, rhs, H);
+  }
+
+  /**
+   * Solve the nonnegative least squares problems
+   *
+   * \f[
+   * \min_{x_j \geq 0} \frac{1}{2} x_j^T G x_j - b_j^T x_j
+   * \f]
+   *
+   * for each column b_j of rhs, in parallel.  If x has the right size, its
+   * columns are used as the initial guesses.
+   *
+   * @param gram Gram matrix G of the problems.
+   * @param rhs Right-hand sides of the problems, one per column.
+   * @param x Matrix to store the solutions in.
+   */
+  inline static void SolveNNLS(const arma::mat& gram,
+                               const arma::mat& rhs,
+                               arma::mat& x)
+  {
+    if (x.n_rows != rhs.n_rows || x.n_cols != rhs.n_cols)
+      x.zeros(rhs.n_rows, rhs.n_cols);
+
+    util::ParallelBlocks(rhs.n_cols, [&](const size_t begin, const size_t end)
+    {
+      arma::vec column;
+      for (size_t j = begin; j <= end; ++j)
+      {
+        column = x.col(j);
+        SolveColumn(gram, rhs.col(j), column);
+        x.col(j) = column;
+      }
+    });
+  }
+
+  //! Serialize the object (in this case, there is nothing to serialize).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ private:
+  /**
+   * Solve one nonnegative least squares problem with block principal
+   * pivoting.  The variables that are positive in x on input are the initial
+   * passive (unconstrained) set.
+   *
+   * @param gram Gram matrix of the problem.
+   * @param rhs Right-hand side of the problem.
+   * @param x Initial guess, overwritten with the solution.
+   */
+  inline static void SolveColumn(const arma::mat& gram,
+                                 const arma::vec& rhs,
+                                 arma::vec& x)
+  {
+    const size_t k = gram.n_rows;
+    std::vector<bool> passive(k);
+    for (size_t i = 0; i < k; ++i)
+      passive[i] = (x[i] > 0.0);
+
+    // The number of infeasible variables has to decrease within three
+    // exchanges of whole blocks; otherwise only one variable is exchanged,
+    // which guarantees that the method terminates.
+    size_t fewestInfeasible = k + 1;
+    size_t blockExchanges = 3;
+    // Small negative values that come from roundoff don't make a variable
+    // infeasible; without this, the pivoting could go on forever.
+    const double tolerance = 1e-10 * arma::abs(rhs).max();
+    arma::vec y;
+    std::vector<size_t> infeasible;
+    const size_t maxPivots = 10 * (k + 1);
+    for (size_t pivot = 0; pivot < maxPivots; ++pivot)
+    {
+      SolvePassive(gram, rhs, passive, x, y);
+
+      infeasible.clear();
+      for (size_t i = 0; i < k; ++i)
+      {
+        if ((passive[i] && x[i] < -tolerance) ||
+            (!passive[i] && y[i] < -tolerance))
+          infeasible.push_back(i);
+      }
+
+      if (infeasible.empty())
+        break;
+
+      if (infeasible.size() < fewestInfeasible)
+      {
+        fewestInfeasible = infeasible.size();
+        blockExchanges = 3;
+      }
+      else if (blockExchanges > 0)
+      {
+        --blockExchanges;
+      }
+      else
+      {
+        // Only exchange the infeasible variable with the largest index.
+        infeasible.erase(infeasible.begin(), infeasible.end() - 1);
+      }
+
+      for (size_t i = 0; i < infeasible.size(); ++i)
+        passive[infeasible[i]] = !passive[infeasible[i]];
+    }
+
+    // Remove the negative values within the tolerance (or, if the pivoting did
+    // not converge, make the solution feasible).
+    x.elem(arma::find(x < 0.0)).zeros();
+  }
+
+  /**
+   * Solve the unconstrained problem for the passive variables, with the other
+   * variables set to 0, and compute the gradient y = G x - b.
+   */
+  inline static void SolvePassive(const arma::mat& gram,
+                                  const arma::vec& rhs,
+                                  const std::vector<bool>& passive,
+                                  arma::vec& x,
+                                  arma::vec& y)
+  {
+    size_t numPassive = 0;
+    for (size_t i = 0; i < passive.size(); ++i)
+      numPassive += passive[i] ? 1 : 0;
+
+    arma::uvec indices(numPassive);
+    for (size_t i = 0, p = 0; i < passive.size(); ++i)
+      if (passive[i])
+        indices[p++] = i;
+
+    x.zeros(gram.n_rows);
+    if (numPassive > 0)
+    {
+      const arma::mat subGram = gram.submat(indices, indices);
+      const arma::vec subRhs = rhs.elem(indices);
+      arma::vec solution;
+      if (!arma::solve(solution, subGram, subRhs))
+        solution = arma::pinv(subGram) * subRhs;
+      x.elem(indices) = solution;
+    }
+
+    y = gram * x - rhs;
+  }
+}; // class NMFNNLSUpdate
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
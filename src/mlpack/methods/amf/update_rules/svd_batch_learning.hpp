@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_AMF_UPDATE_RULES_SVD_BATCH_LEARNING_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/amf/sampled_product.hpp>
 
 namespace mlpack {
 namespace amf {
@@ -203,21 +204,13 @@ inline void SVDBatchLearning::WUpdate<arma::sp_mat>(const arma::sp_mat& V,
                                                     arma::mat& W,
                                                     const arma::mat& H)
 {
-  const size_t n = V.n_rows;
-  const size_t r = W.n_cols;
-
   mW = momentum * mW;
 
-  arma::mat deltaW;
-  deltaW.zeros(n, r);
-
-  for (arma::sp_mat::const_iterator it = V.begin(); it != V.end(); ++it)
-  {
-    const size_t row = it.row();
-    const size_t col = it.col();
-    deltaW.row(it.row()) += (*it - arma::dot(W.row(row), H.col(col))) *
-                                             arma::trans(H.col(col));
-  }
+  // The gradient only involves the residual at the nonzero entries of V, so
+  // W * H is only evaluated there.
+  const arma::sp_mat residual = SampledProduct(V, W, H,
+      [](const double v, const double wh) { return v - wh; });
+  arma::mat deltaW = residual * H.t();
 
   if (kw != 0)
     deltaW -= kw * W;
@@ -231,21 +224,13 @@ inline void SVDBatchLearning::HUpdate<arma::sp_mat>(const arma::sp_mat& V,
                                                     const arma::mat& W,
                                                     arma::mat& H)
 {
-  const size_t m = V.n_cols;
-  const size_t r = W.n_cols;
-
   mH = momentum * mH;
 
-  arma::mat deltaH;
-  deltaH.zeros(r, m);
-
-  for (arma::sp_mat::const_iterator it = V.begin(); it != V.end(); ++it)
-  {
-    const size_t row = it.row();
-    const size_t col = it.col();
-    deltaH.col(col) += (*it - arma::dot(W.row(row), H.col(col))) *
-        W.row(row).t();
-  }
+  // The gradient only involves the residual at the nonzero entries of V, so
+  // W * H is only evaluated there.
+  const arma::sp_mat residual = SampledProduct(V, W, H,
+      [](const double v, const double wh) { return v - wh; });
+  arma::mat deltaH = W.t() * residual;
 
   if (kh != 0)
     deltaH -= kh * H;
@@ -65,7 +65,7 @@ class RectifierFunction
   template<typename eT>
   static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
   {
-    y = arma::max(arma::zeros<arma::Mat<eT> >(x.n_rows, x.n_cols), x);
+    y = arma::clamp(x, 0, arma::Datum<eT>::inf);
   }
 
   /**
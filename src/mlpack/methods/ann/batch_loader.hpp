@@ -0,0 +1,187 @@
+/**
+ * @file batch_loader.hpp
+ *
+ * Definition of the BatchLoader class, which gathers the mini-batches of the
+ * FFN and RNN classes and prepares the next batch in a background thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_BATCH_LOADER_HPP
+#define MLPACK_METHODS_ANN_BATCH_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <exception>
+#include <functional>
+#include <thread>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The BatchLoader gathers the predictors and responses of a mini-batch from
+ * the data, in the order of visitation, into buffers, and optionally applies a
+ * transformation to the batch (for instance, data augmentation).  While the
+ * network trains on one batch, the loader prepares the batch that follows it
+ * in a background thread, so batch assembly overlaps with the forward and
+ * backward passes.  If the optimizer asks for a different batch than the one
+ * that was prepared, that batch is simply gathered on the calling thread.
+ *
+ * The loader holds no data itself: the data and the visitation order are
+ * passed to every call of Gather(), and they must not be modified until the
+ * next call to Gather() or Reset().
+ *
+ * @tparam DataType Type of the data (arma::mat for FFN, arma::cube for RNN,
+ *     where every column of every slice belongs to the batch).
+ */
+template<typename DataType = arma::mat>
+class BatchLoader
+{
+ public:
+  /**
+   * The type of the transformation applied to every batch.  It is called with
+   * the gathered predictors and responses of the batch, which it may modify
+   * in place, but it must keep their sizes.  The transformation is called from
+   * the background thread, so it must not touch the network, and it must be
+   * safe to call while the network trains.
+   */
+  typedef std::function<void(DataType& input, DataType& target)> TransformType;
+
+  /**
+   * Create the loader.
+   *
+   * @param prefetch Whether to prepare the next batch in a background thread.
+   */
+  BatchLoader(const bool prefetch = true);
+
+  //! Copy the settings of the given loader (but not its batches).
+  BatchLoader(const BatchLoader& other);
+
+  //! Take the settings and the batches of the given loader.
+  BatchLoader(BatchLoader&& other);
+
+  //! Copy the settings of the given loader (but not its batches).
+  BatchLoader& operator=(const BatchLoader& other);
+
+  //! Take the settings and the batches of the given loader.
+  BatchLoader& operator=(BatchLoader&& other);
+
+  //! Wait for the background thread.
+  ~BatchLoader();
+
+  /**
+   * Return whether the given batch has to be gathered.  If not, it can be used
+   * straight from the data: all of its points are past the visitation order
+   * (or the order is empty, which means the order of the data), and there is
+   * no transformation.
+   */
+  bool Gathers(const arma::Col<size_t>& order,
+               const size_t begin,
+               const size_t batchSize) const
+  {
+    return transform || (begin + batchSize <= order.n_elem);
+  }
+
+  /**
+   * Gather the given batch into Input() and Target(), and start preparing the
+   * batch after it.  Points past the end of the visitation order are taken in
+   * the order of the data.
+   *
+   * @param predictors The predictors of all points.
+   * @param responses The responses of all points.
+   * @param order The order of visitation of the points.
+   * @param begin Index (in the order of visitation) of the first point.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gather(const DataType& predictors,
+              const DataType& responses,
+              const arma::Col<size_t>& order,
+              const size_t begin,
+              const size_t batchSize);
+
+  /**
+   * Wait for the background thread and discard the prepared batch.  This has
+   * to be called before the data or the visitation order are modified.
+   */
+  void Reset();
+
+  //! Get the predictors of the last gathered batch.
+  DataType& Input() { return input; }
+  //! Get the responses of the last gathered batch.
+  DataType& Target() { return target; }
+
+  //! Get whether the next batch is prepared in a background thread.
+  bool Prefetch() const { return prefetch; }
+  //! Modify whether the next batch is prepared in a background thread.
+  bool& Prefetch() { return prefetch; }
+
+  //! Get the transformation applied to every batch.
+  const TransformType& Transform() const { return transform; }
+  //! Modify the transformation applied to every batch.  Call Reset() after
+  //! changing it while a batch may be prepared.
+  TransformType& Transform() { return transform; }
+
+ private:
+  //! Gather the given columns of the given matrix.
+  static void GatherColumns(const arma::mat& data,
+                            const arma::Col<size_t>& order,
+                            const size_t begin,
+                            const size_t batchSize,
+                            arma::mat& out);
+
+  //! Gather the given columns of every slice of the given cube.
+  static void GatherColumns(const arma::cube& data,
+                            const arma::Col<size_t>& order,
+                            const size_t begin,
+                            const size_t batchSize,
+                            arma::cube& out);
+
+  //! Gather and transform the given batch into the given buffers.
+  void Fill(const DataType& predictors,
+            const DataType& responses,
+            const arma::Col<size_t>& order,
+            const size_t begin,
+            const size_t batchSize,
+            DataType& batchInput,
+            DataType& batchTarget) const;
+
+  //! Whether to prepare the next batch in a background thread.
+  bool prefetch;
+
+  //! The transformation applied to every batch.
+  TransformType transform;
+
+  //! The predictors of the current batch.
+  DataType input;
+  //! The responses of the current batch.
+  DataType target;
+
+  //! The predictors of the prepared batch.
+  DataType nextInput;
+  //! The responses of the prepared batch.
+  DataType nextTarget;
+
+  //! The thread preparing the next batch.
+  std::thread worker;
+  //! Whether a batch was prepared (or is being prepared).
+  bool prepared;
+  //! The first point of the prepared batch.
+  size_t nextBegin;
+  //! The size of the prepared batch.
+  size_t nextBatchSize;
+  //! The memory of the data and order the prepared batch was gathered from.
+  const void* nextSource[2];
+  //! The exception thrown while preparing the batch, if any.
+  std::exception_ptr error;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "batch_loader_impl.hpp"
+
+#endif
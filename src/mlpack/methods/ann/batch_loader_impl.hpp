@@ -0,0 +1,219 @@
+/**
+ * @file batch_loader_impl.hpp
+ *
+ * Implementation of the BatchLoader class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_BATCH_LOADER_IMPL_HPP
+#define MLPACK_METHODS_ANN_BATCH_LOADER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "batch_loader.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename DataType>
+BatchLoader<DataType>::BatchLoader(const bool prefetch) :
+    prefetch(prefetch),
+    prepared(false),
+    nextBegin(0),
+    nextBatchSize(0),
+    nextSource{ NULL, NULL }
+{
+  // Nothing to do here.
+}
+
+template<typename DataType>
+BatchLoader<DataType>::BatchLoader(const BatchLoader& other) :
+    prefetch(other.prefetch),
+    transform(other.transform),
+    prepared(false),
+    nextBegin(0),
+    nextBatchSize(0),
+    nextSource{ NULL, NULL }
+{
+  // Nothing to do here.
+}
+
+template<typename DataType>
+BatchLoader<DataType>::BatchLoader(BatchLoader&& other) :
+    prefetch(other.prefetch),
+    transform(std::move(other.transform)),
+    prepared(false),
+    nextBegin(0),
+    nextBatchSize(0),
+    nextSource{ NULL, NULL }
+{
+  // The prepared batch would refer to the data of its old owner.
+  other.Reset();
+  input = std::move(other.input);
+  target = std::move(other.target);
+}
+
+template<typename DataType>
+BatchLoader<DataType>& BatchLoader<DataType>::operator=(
+    const BatchLoader& other)
+{
+  if (this != &other)
+  {
+    Reset();
+    prefetch = other.prefetch;
+    transform = other.transform;
+  }
+
+  return *this;
+}
+
+template<typename DataType>
+BatchLoader<DataType>& BatchLoader<DataType>::operator=(BatchLoader&& other)
+{
+  if (this != &other)
+  {
+    Reset();
+    other.Reset();
+    prefetch = other.prefetch;
+    transform = std::move(other.transform);
+    input = std::move(other.input);
+    target = std::move(other.target);
+  }
+
+  return *this;
+}
+
+template<typename DataType>
+BatchLoader<DataType>::~BatchLoader()
+{
+  if (worker.joinable())
+    worker.join();
+}
+
+template<typename DataType>
+void BatchLoader<DataType>::Gather(const DataType& predictors,
+                                   const DataType& responses,
+                                   const arma::Col<size_t>& order,
+                                   const size_t begin,
+                                   const size_t batchSize)
+{
+  if (worker.joinable())
+    worker.join();
+
+  if (error)
+  {
+    std::exception_ptr e = error;
+    error = std::exception_ptr();
+    prepared = false;
+    std::rethrow_exception(e);
+  }
+
+  // Use the prepared batch if it is the one that is asked for.
+  if (prepared && nextBegin == begin && nextBatchSize == batchSize &&
+      nextSource[0] == predictors.memptr() && nextSource[1] == order.memptr())
+  {
+    input.swap(nextInput);
+    target.swap(nextTarget);
+  }
+  else
+  {
+    Fill(predictors, responses, order, begin, batchSize, input, target);
+  }
+  prepared = false;
+
+  // Start preparing the batch that follows, if it is gathered at all.
+  const size_t following = begin + batchSize;
+  if (!prefetch || following >= predictors.n_cols)
+    return;
+
+  nextBegin = following;
+  nextBatchSize = std::min(batchSize, size_t(predictors.n_cols - following));
+  if (!Gathers(order, nextBegin, nextBatchSize))
+    return;
+
+  nextSource[0] = predictors.memptr();
+  nextSource[1] = order.memptr();
+  prepared = true;
+  worker = std::thread([this, &predictors, &responses, &order]()
+  {
+    try
+    {
+      Fill(predictors, responses, order, nextBegin, nextBatchSize, nextInput,
+          nextTarget);
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+  });
+}
+
+template<typename DataType>
+void BatchLoader<DataType>::Reset()
+{
+  if (worker.joinable())
+    worker.join();
+
+  prepared = false;
+  error = std::exception_ptr();
+}
+
+template<typename DataType>
+void BatchLoader<DataType>::GatherColumns(const arma::mat& data,
+                                          const arma::Col<size_t>& order,
+                                          const size_t begin,
+                                          const size_t batchSize,
+                                          arma::mat& out)
+{
+  out.set_size(data.n_rows, batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const size_t point = (begin + i < order.n_elem) ? order[begin + i] :
+        begin + i;
+    std::copy(data.colptr(point), data.colptr(point) + data.n_rows,
+        out.colptr(i));
+  }
+}
+
+template<typename DataType>
+void BatchLoader<DataType>::GatherColumns(const arma::cube& data,
+                                          const arma::Col<size_t>& order,
+                                          const size_t begin,
+                                          const size_t batchSize,
+                                          arma::cube& out)
+{
+  out.set_size(data.n_rows, batchSize, data.n_slices);
+  for (size_t s = 0; s < data.n_slices; ++s)
+  {
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      const size_t point = (begin + i < order.n_elem) ? order[begin + i] :
+          begin + i;
+      std::copy(data.slice(s).colptr(point), data.slice(s).colptr(point) +
+          data.n_rows, out.slice(s).colptr(i));
+    }
+  }
+}
+
+template<typename DataType>
+void BatchLoader<DataType>::Fill(const DataType& predictors,
+                                 const DataType& responses,
+                                 const arma::Col<size_t>& order,
+                                 const size_t begin,
+                                 const size_t batchSize,
+                                 DataType& batchInput,
+                                 DataType& batchTarget) const
+{
+  GatherColumns(predictors, order, begin, batchSize, batchInput);
+  GatherColumns(responses, order, begin, batchSize, batchTarget);
+
+  if (transform)
+    transform(batchInput, batchTarget);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
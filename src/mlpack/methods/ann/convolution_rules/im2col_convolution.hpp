@@ -0,0 +1,437 @@
+/**
+ * @file im2col_convolution.hpp
+ *
+ * Implementation of the convolution through the im2col transformation and a
+ * single matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by unrolling every filter-sized
+ * patch of the input into a column of a matrix (im2col), so that the
+ * convolution becomes a matrix product that is handed to BLAS.
+ *
+ * Like NaiveConvolution, the class can be used to convolve a single input map
+ * with a single filter, with the valid or the full border type.  In addition,
+ * the Forward(), Backward() and Gradient() functions process all input maps,
+ * output maps and samples of a batch with one matrix multiplication each;
+ * the Convolution and AtrousConvolution layers use these functions whenever
+ * Im2ColConvolution is passed as their convolution rule (see
+ * IsBatchConvolutionRule).
+ *
+ * For the batch functions, the layout of the data is the one used by the
+ * convolution layers: the input has inSize slices per sample, and the filter
+ * cube has outSize * inSize slices, where slice (o * inSize + i) connects
+ * input map i to output map o.  Strides and dilations along the rows are given
+ * by dW and dilationW, and along the columns by dH and dilationH.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).  This only affects the two-dimensional Convolution()
+ * functions.
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    const size_t outRows = (input.n_rows - (filter.n_rows - 1) * dilationW -
+        1) / dW + 1;
+    const size_t outCols = (input.n_cols - (filter.n_cols - 1) * dilationH -
+        1) / dH + 1;
+
+    arma::Mat<eT> columns(filter.n_elem, outRows * outCols);
+    Im2Col(input, filter.n_rows, filter.n_cols, outRows, outCols, dW, dH,
+        dilationW, dilationH, columns, 0, 0);
+
+    output.set_size(outRows, outCols);
+    arma::Col<eT> outputVector(output.memptr(), output.n_elem, false, true);
+    outputVector = columns.t() * arma::vectorise(filter);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    // Use the same output shape as NaiveConvolution, so that the two rules
+    // can be exchanged.
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filter.n_rows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filter.n_cols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; i++)
+    {
+      if (((((i + outputRows - 2 * (filter.n_rows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; i++)
+    {
+      if (((((i + outputCols - 2 * (filter.n_cols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        outputCols += i;
+        break;
+      }
+    }
+
+    // Pad the input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat((filter.n_rows - 1) * dilationW, (filter.n_cols - 1)
+        * dilationH, (filter.n_rows - 1) * dilationW + input.n_rows - 1,
+        (filter.n_cols - 1) * dilationH + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1, dilationW, dilationH);
+  }
+
+  /**
+   * Convolve every input map of every sample with the corresponding filters
+   * and sum over the input maps; this is the forward pass of a convolution
+   * layer, without the bias.
+   *
+   * @param input Input maps (inSize slices per sample), already padded.
+   * @param filter Filters (outSize * inSize slices).
+   * @param output Output maps (outSize slices per sample).  If output already
+   *     has the right size, its memory is reused.
+   * @param inSize Number of input maps per sample.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Forward(const arma::Cube<eT>& input,
+                      const arma::Cube<eT>& filter,
+                      arma::Cube<eT>& output,
+                      const size_t inSize,
+                      const size_t dW = 1,
+                      const size_t dH = 1,
+                      const size_t dilationW = 1,
+                      const size_t dilationH = 1)
+  {
+    const size_t outSize = filter.n_slices / inSize;
+    const size_t batchSize = input.n_slices / inSize;
+    const size_t outRows = (input.n_rows - (filter.n_rows - 1) * dilationW -
+        1) / dW + 1;
+    const size_t outCols = (input.n_cols - (filter.n_cols - 1) * dilationH -
+        1) / dH + 1;
+    const size_t mapSize = outRows * outCols;
+
+    arma::Mat<eT> columns;
+    Im2Col(input, filter.n_rows, filter.n_cols, inSize, outRows, outCols, dW,
+        dH, dilationW, dilationH, columns);
+
+    // Each sample is a block of rows, and each output map is a column.
+    const arma::Mat<eT> result = columns.t() * FilterMatrix(filter, inSize);
+
+    output.set_size(outRows, outCols, outSize * batchSize);
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      for (size_t o = 0; o < outSize; ++o)
+      {
+        const eT* resultPtr = result.colptr(o) + b * mapSize;
+        std::copy(resultPtr, resultPtr + mapSize,
+            output.slice_memptr(b * outSize + o));
+      }
+    }
+  }
+
+  /**
+   * Compute the gradient of the forward pass with respect to the input maps,
+   * given the error of the output maps.
+   *
+   * @param error Error of the output maps (outSize slices per sample).
+   * @param filter Filters (outSize * inSize slices).
+   * @param output Gradient with respect to the input maps.  This must already
+   *     have the size of the (padded) input that was given to Forward().
+   * @param inSize Number of input maps per sample.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Backward(const arma::Cube<eT>& error,
+                       const arma::Cube<eT>& filter,
+                       arma::Cube<eT>& output,
+                       const size_t inSize,
+                       const size_t dW = 1,
+                       const size_t dH = 1,
+                       const size_t dilationW = 1,
+                       const size_t dilationH = 1)
+  {
+    const size_t outSize = filter.n_slices / inSize;
+
+    arma::Mat<eT> errorMatrix;
+    StackMaps(error, outSize, errorMatrix);
+
+    const arma::Mat<eT> columns = FilterMatrix(filter, inSize) *
+        errorMatrix.t();
+
+    output.zeros();
+    Col2Im(columns, filter.n_rows, filter.n_cols, inSize, error.n_rows,
+        error.n_cols, dW, dH, dilationW, dilationH, output);
+  }
+
+  /**
+   * Compute the gradient of the forward pass with respect to the filters,
+   * given the input maps and the error of the output maps.
+   *
+   * @param input Input maps (inSize slices per sample), already padded.
+   * @param error Error of the output maps (outSize slices per sample).
+   * @param gradient Gradient with respect to the filters.  This must already
+   *     have the size of the filters.
+   * @param inSize Number of input maps per sample.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Gradient(const arma::Cube<eT>& input,
+                       const arma::Cube<eT>& error,
+                       arma::Cube<eT>& gradient,
+                       const size_t inSize,
+                       const size_t dW = 1,
+                       const size_t dH = 1,
+                       const size_t dilationW = 1,
+                       const size_t dilationH = 1)
+  {
+    const size_t outSize = gradient.n_slices / inSize;
+
+    arma::Mat<eT> columns;
+    Im2Col(input, gradient.n_rows, gradient.n_cols, inSize, error.n_rows,
+        error.n_cols, dW, dH, dilationW, dilationH, columns);
+
+    arma::Mat<eT> errorMatrix;
+    StackMaps(error, outSize, errorMatrix);
+
+    // The filter cube has the same layout as the filter matrix.
+    arma::Mat<eT> gradientMatrix(gradient.memptr(), columns.n_rows, outSize,
+        false, true);
+    gradientMatrix = columns * errorMatrix;
+  }
+
+  /**
+   * Unroll every patch of one input map into the rows [rowOffset, rowOffset +
+   * kW * kH) of consecutive columns of the given matrix, starting at column
+   * colOffset.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Mat<eT>& input,
+                     const size_t kW,
+                     const size_t kH,
+                     const size_t outRows,
+                     const size_t outCols,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     arma::Mat<eT>& columns,
+                     const size_t rowOffset,
+                     const size_t colOffset)
+  {
+    for (size_t j = 0; j < outCols; ++j)
+    {
+      for (size_t i = 0; i < outRows; ++i)
+      {
+        eT* columnPtr = columns.colptr(colOffset + j * outRows + i) +
+            rowOffset;
+        for (size_t kj = 0; kj < kH; ++kj)
+        {
+          const eT* inputPtr = input.colptr(j * dH + kj * dilationH) + i * dW;
+          for (size_t ki = 0; ki < kW; ++ki, inputPtr += dilationW)
+            *columnPtr++ = *inputPtr;
+        }
+      }
+    }
+  }
+
+  /**
+   * Unroll all input maps of all samples; the patches of input map i are
+   * stored in rows [i * kW * kH, (i + 1) * kW * kH), and each sample is a
+   * block of outRows * outCols columns.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Cube<eT>& input,
+                     const size_t kW,
+                     const size_t kH,
+                     const size_t inSize,
+                     const size_t outRows,
+                     const size_t outCols,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     arma::Mat<eT>& columns)
+  {
+    const size_t batchSize = input.n_slices / inSize;
+    columns.set_size(kW * kH * inSize, outRows * outCols * batchSize);
+
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      for (size_t i = 0; i < inSize; ++i)
+      {
+        Im2Col(input.slice(b * inSize + i), kW, kH, outRows, outCols, dW, dH,
+            dilationW, dilationH, columns, i * kW * kH, b * outRows * outCols);
+      }
+    }
+  }
+
+ private:
+  /**
+   * The inverse of Im2Col(): add every unrolled patch back to the position it
+   * was taken from.
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& columns,
+                     const size_t kW,
+                     const size_t kH,
+                     const size_t inSize,
+                     const size_t outRows,
+                     const size_t outCols,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     arma::Cube<eT>& output)
+  {
+    const size_t batchSize = output.n_slices / inSize;
+
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      for (size_t m = 0; m < inSize; ++m)
+      {
+        arma::Mat<eT>& map = output.slice(b * inSize + m);
+        for (size_t j = 0; j < outCols; ++j)
+        {
+          for (size_t i = 0; i < outRows; ++i)
+          {
+            const eT* columnPtr = columns.colptr(b * outRows * outCols +
+                j * outRows + i) + m * kW * kH;
+            for (size_t kj = 0; kj < kH; ++kj)
+            {
+              eT* mapPtr = map.colptr(j * dH + kj * dilationH) + i * dW;
+              for (size_t ki = 0; ki < kW; ++ki, mapPtr += dilationW)
+                *mapPtr += *columnPtr++;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Stack the maps of all samples into a matrix with a column per map and a
+   * block of rows per sample.
+   */
+  template<typename eT>
+  static void StackMaps(const arma::Cube<eT>& maps,
+                        const size_t numMaps,
+                        arma::Mat<eT>& matrix)
+  {
+    const size_t mapSize = maps.n_rows * maps.n_cols;
+    const size_t batchSize = maps.n_slices / numMaps;
+    matrix.set_size(mapSize * batchSize, numMaps);
+
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      for (size_t o = 0; o < numMaps; ++o)
+      {
+        const eT* mapPtr = maps.slice_memptr(b * numMaps + o);
+        std::copy(mapPtr, mapPtr + mapSize, matrix.colptr(o) + b * mapSize);
+      }
+    }
+  }
+
+  /**
+   * View the filters as a matrix with a column per output map; the rows of
+   * each column follow the layout of the columns produced by Im2Col().
+   */
+  template<typename eT>
+  static arma::Mat<eT> FilterMatrix(const arma::Cube<eT>& filter,
+                                    const size_t inSize)
+  {
+    return arma::Mat<eT>(const_cast<eT*>(filter.memptr()),
+        filter.n_rows * filter.n_cols * inSize, filter.n_slices / inSize,
+        false, true);
+  }
+};  // class Im2ColConvolution
+
+/**
+ * IsBatchConvolutionRule<T>::value is true if the convolution rule T provides
+ * the Forward(), Backward() and Gradient() functions that process all maps of
+ * a batch at once, as Im2ColConvolution does.
+ */
+template<typename ConvolutionRule>
+struct IsBatchConvolutionRule
+{
+  static const bool value = false;
+};
+
+template<typename BorderMode>
+struct IsBatchConvolutionRule<Im2ColConvolution<BorderMode> >
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
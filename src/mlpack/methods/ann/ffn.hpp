@@ -15,6 +15,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <memory>
+
 #include "visitor/delete_visitor.hpp"
 #include "visitor/delta_visitor.hpp"
 #include "visitor/output_height_visitor.hpp"
@@ -24,8 +26,11 @@
 #include "visitor/weight_size_visitor.hpp"
 #include "visitor/copy_visitor.hpp"
 #include "visitor/loss_visitor.hpp"
+#include "visitor/target_set_visitor.hpp"
+#include "visitor/execution_step.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "batch_loader.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/init_rules/random_init.hpp>
@@ -34,6 +39,16 @@
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
+//! ParameterPrecision represents the precisions the parameters of a network
+//! can be saved with.  The parameters are always trained and used in double
+//! precision.
+enum ParameterPrecision
+{
+  DOUBLE_PRECISION,
+  SINGLE_PRECISION,
+  BFLOAT16_PRECISION
+};
+
 /**
  * Implementation of a standard feed forward network.
  *
@@ -129,10 +144,18 @@ class FFN
    * If you want to pass in a parameter and discard the original parameter
    * object, be sure to use std::move to avoid unnecessary copy.
    *
+   * The predictors are passed through the network in blocks of batchSize
+   * columns, so that each layer performs a matrix-matrix product for the whole
+   * block instead of one matrix-vector product per point.
+   *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to predict at once; must be greater
+   *        than 0.
    */
-  void Predict(arma::mat predictors, arma::mat& results);
+  void Predict(arma::mat predictors,
+               arma::mat& results,
+               const size_t batchSize = 256);
 
   /**
    * Evaluate the feedforward network with the given ppredictors and responses.
@@ -245,14 +268,22 @@ class FFN
    * @param args The layer parameter.
    */
   template <class LayerType, class... Args>
-  void Add(Args... args) { network.push_back(new LayerType(args...)); }
+  void Add(Args... args)
+  {
+    network.push_back(new LayerType(args...));
+    ++generation;
+  }
 
   /*
    * Add a new module to the model.
    *
    * @param layer The Layer to be added to the model.
    */
-  void Add(LayerTypes<CustomLayers...> layer) { network.push_back(layer); }
+  void Add(LayerTypes<CustomLayers...> layer)
+  {
+    network.push_back(layer);
+    ++generation;
+  }
 
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
@@ -272,14 +303,92 @@ class FFN
   //! Modify the matrix of data points (predictors).
   arma::mat& Predictors() { return predictors; }
 
+  //! Get the precision the parameters are saved with.
+  ParameterPrecision Precision() const { return precision; }
+  /**
+   * Modify the precision the parameters are saved with.  Single precision
+   * halves the size of a saved model, and bfloat16 (the upper half of a single
+   * precision number, with 8 bits of mantissa) quarters it.
+   */
+  ParameterPrecision& Precision() { return precision; }
+
+  //! Get the number of threads a batch is split over during training.
+  size_t Threads() const { return threads; }
+  /**
+   * Modify the number of threads a batch is split over during training.  When
+   * this is larger than one (and mlpack is built with OpenMP),
+   * EvaluateWithGradient() splits each batch into one shard per thread, runs
+   * each shard on its own replica of the network, and sums the objectives and
+   * gradients of the shards.  The replicas share the parameters of the network.
+   *
+   * This is only equivalent to training on the whole batch if the output layer
+   * sums its objective over the points (as NegativeLogLikelihood and
+   * CrossEntropyError do, but MeanSquaredError doesn't), if every layer
+   * processes the points of a batch independently (BatchNorm doesn't), and if
+   * no layer adds a loss of its own.  Layers that update a state during
+   * training only see the first shard.
+   */
+  size_t& Threads() { return threads; }
+
+  //! Get the loader that gathers the batches during training.
+  const BatchLoader<>& Loader() const { return batchLoader; }
+  /**
+   * Modify the loader that gathers the batches during training.  Once the data
+   * is shuffled (or if a transformation is set), the loader gathers every
+   * batch and prepares the next one in a background thread while the network
+   * trains on the current one.
+   */
+  BatchLoader<>& Loader() { return batchLoader; }
+
   /**
    * Reset the module infomration (weights/parameters).
    */
   void ResetParameters();
 
+  /**
+   * Quantize the trained network for inference.  The Linear, LinearNoBias and
+   * Convolution modules are replaced by QuantizedLinear and
+   * QuantizedConvolution modules, which store their weights as 8-bit integers
+   * with one scale per output unit or map, and compute their output with
+   * integer matrix products.  The range of the input of each of these modules
+   * is calibrated with a forward pass over the given data, which should be
+   * representative of the data the network will be used on; larger inputs
+   * are clipped.
+   *
+   * The parameters of the other modules are kept, so the network can be used
+   * with Predict() and serialized as before, but the quantized modules can't
+   * be trained.
+   *
+   * @param calibrationData Input data to calibrate the input ranges with.
+   */
+  void Quantize(arma::mat calibrationData);
+
+  /**
+   * Fold every BatchNorm module that follows a Linear or LinearNoBias module
+   * into the weights and bias of that module, for inference.  The folded
+   * module computes the output the pair computes in deterministic mode, with
+   * the mean and variance over the training data, in a single pass.  A
+   * LinearNoBias module is replaced by a Linear module, since the folded
+   * module needs a bias.  The folded network should not be trained further.
+   */
+  void FoldBatchNorm();
+
+  /**
+   * Compute the statistics over the training data that the BatchNorm modules
+   * of the network use in deterministic mode again, with the current
+   * parameters: the statistics are reset, and the training data is passed
+   * forward once in training mode, in batches of the given size.  This is
+   * needed when the parameters were changed without training, for instance
+   * when they were set to an average of the parameters at several points of
+   * the optimization (see SWASGDR).
+   *
+   * @param batchSize Number of points in each forward pass.
+   */
+  void UpdateStatistics(const size_t batchSize);
+
   //! Serialize the model.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
   /**
    * Perform the forward pass of the data in real batch mode.
@@ -364,6 +473,87 @@ class FFN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Resolve the type of every layer once and build the execution plan that
+   * the forward, backward and gradient passes run through, if it is out of
+   * date.
+   */
+  void ResetPlan();
+
+  /**
+   * Return the sum of the losses of all modules that implement the Loss()
+   * function.
+   */
+  double Loss() const;
+
+  /**
+   * Run the forward and backward pass of the given input and target, and store
+   * the gradient of the parameters in the given matrix.
+   *
+   * @param input The input data.
+   * @param target The training target.
+   * @param gradient Matrix to output gradient into.
+   * @return Training error of the pass.
+   */
+  double ForwardBackward(arma::mat&& input,
+                         arma::mat&& target,
+                         arma::mat& gradient);
+
+  /**
+   * Split the given batch into one shard per thread, run each shard on the
+   * network or one of its replicas, and sum the objectives and gradients.
+   *
+   * @param input Memory of the predictors of the batch.
+   * @param target Memory of the responses of the batch.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points in the batch.
+   * @return Training error of the batch.
+   */
+  double ParallelEvaluateWithGradient(double* input,
+                                      double* target,
+                                      arma::mat& gradient,
+                                      const size_t batchSize);
+
+  /**
+   * Find the memory of the predictors and responses of the given batch, in the
+   * order of visitation.  Before the first call to Shuffle() this points into
+   * the data itself (unless the loader transforms the batches); afterwards the
+   * batch is gathered by the loader, which prepares the next batch while this
+   * one is used.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param input Set to the memory of the predictors of the batch.
+   * @param target Set to the memory of the responses of the batch.
+   */
+  void GatherBatch(const size_t begin,
+                   const size_t batchSize,
+                   double*& input,
+                   double*& target);
+
+  /**
+   * Create the given number of replicas of the network, which share its
+   * parameters, unless they are already up to date.
+   *
+   * @param count Number of replicas.
+   */
+  void ResetReplicas(const size_t count);
+
+  /**
+   * Set the parameters of the network after modules have been replaced or
+   * removed, and rebuild the execution plan.
+   *
+   * @param newParameter The parameters of all modules of the network, in
+   *     order.
+   */
+  void SetModuleParameters(const arma::mat& newParameter);
+
+  //! Round the given value to the nearest bfloat16 number.
+  static uint16_t ToBFloat16(const double value);
+
+  //! Convert the given bfloat16 number.
+  static double FromBFloat16(const uint16_t value);
+
   /**
    * Swap the content of this network with given network.
    *
@@ -390,12 +580,30 @@ class FFN
   //! Locally-stored model modules.
   std::vector<LayerTypes<CustomLayers...> > network;
 
+  //! The execution plan: one step for each module, with the module type
+  //! already resolved.
+  std::vector<ExecutionStep> plan;
+
+  //! The generation of the modules; it is incremented whenever modules are
+  //! added, replaced or loaded.
+  size_t generation;
+
+  //! The generation of the modules that the execution plan was built for.
+  size_t planGeneration;
+
   //! The matrix of data points (predictors).
   arma::mat predictors;
 
   //! The matrix of responses to the input data points.
   arma::mat responses;
 
+  //! The order in which the data points are visited (empty until the first
+  //! call to Shuffle(), which means the order of the data).
+  arma::Col<size_t> visitationOrder;
+
+  //! The loader that gathers shuffled batches and prepares the next one.
+  BatchLoader<> batchLoader;
+
   //! Matrix of (trained) parameters.
   arma::mat parameter;
 
@@ -450,6 +658,18 @@ class FFN
   //! Locally-stored copy visitor
   CopyVisitor<CustomLayers...> copyVisitor;
 
+  //! The number of threads a batch is split over during training.
+  size_t threads;
+
+  //! The replicas of the network that train on the other shards of a batch.
+  std::vector<std::unique_ptr<FFN> > replicas;
+
+  //! The gradients of the replicas.
+  std::vector<arma::mat> replicaGradients;
+
+  //! The precision the parameters are saved with.
+  ParameterPrecision precision;
+
   // The GAN class should have access to internal members.
   template<
     typename Model,
@@ -462,6 +682,26 @@ class FFN
 
 } // namespace ann
 } // namespace mlpack
+
+//! Set the serialization version of the FFN class.  Version 1 stores the
+//! precision of the parameters.
+namespace boost {
+namespace serialization {
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename... CustomLayers>
+struct version<mlpack::ann::FFN<
+    OutputLayerType, InitializationRuleType, CustomLayers...>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "ffn_impl.hpp"
 
@@ -23,8 +23,17 @@
 #include "visitor/set_input_height_visitor.hpp"
 #include "visitor/set_input_width_visitor.hpp"
 
+#include "layer/batch_norm.hpp"
+#include "layer/convolution.hpp"
+#include "layer/linear.hpp"
+#include "layer/linear_no_bias.hpp"
+#include "layer/quantized_convolution.hpp"
+#include "layer/quantized_linear.hpp"
+
 #include <boost/serialization/variant.hpp>
 
+#include <cstring>
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -38,8 +47,12 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     width(0),
     height(0),
     reset(false),
+    generation(1),
+    planGeneration(0),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    threads(1),
+    precision(DOUBLE_PRECISION)
 {
   /* Nothing to do here */
 }
@@ -57,9 +70,13 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
     arma::mat predictors, arma::mat responses)
 {
+  // The loader may be preparing a batch of the old data.
+  batchLoader.Reset();
+
   numFunctions = responses.n_cols;
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  visitationOrder.reset();
   this->deterministic = true;
   ResetDeterministic();
 
@@ -121,7 +138,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
 
   currentInput = std::move(inputs);
   Forward(std::move(currentInput));
-  results = boost::apply_visitor(outputParameterVisitor, network.back());
+  results = plan.back().OutputParameter();
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -129,19 +146,13 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
     arma::mat inputs, arma::mat& results, const size_t begin, const size_t end)
 {
-  boost::apply_visitor(ForwardVisitor(std::move(inputs), std::move(
-      boost::apply_visitor(outputParameterVisitor, network[begin]))),
-      network[begin]);
+  ResetPlan();
 
-  for (size_t i = 1; i < end - begin + 1; ++i)
-  {
-    boost::apply_visitor(ForwardVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, network[begin + i - 1])), std::move(
-        boost::apply_visitor(outputParameterVisitor, network[begin + i]))),
-        network[begin + i]);
-  }
+  plan[begin].Forward(inputs);
+  for (size_t i = begin + 1; i <= end; ++i)
+    plan[i].Forward(plan[i - 1].OutputParameter());
 
-  results = boost::apply_visitor(outputParameterVisitor, network[end]);
+  results = plan[end].OutputParameter();
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -149,16 +160,13 @@ template<typename OutputLayerType, typename InitializationRuleType,
 double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
     arma::mat targets, arma::mat& gradients)
 {
-  double res = outputLayer.Forward(std::move(boost::apply_visitor(
-      outputParameterVisitor, network.back())), std::move(targets));
+  double res = outputLayer.Forward(std::move(plan.back().OutputParameter()),
+      std::move(targets));
 
-  for (size_t i = 0; i < network.size(); ++i)
-  {
-    res += boost::apply_visitor(lossVisitor, network[i]);
-  }
+  res += Loss();
 
-  outputLayer.Backward(std::move(boost::apply_visitor(outputParameterVisitor,
-      network.back())), std::move(targets), std::move(error));
+  outputLayer.Backward(std::move(plan.back().OutputParameter()),
+      std::move(targets), std::move(error));
 
   gradients = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
 
@@ -172,8 +180,12 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
-    arma::mat predictors, arma::mat& results)
+    arma::mat predictors, arma::mat& results, const size_t batchSize)
 {
+  if (batchSize == 0)
+    Log::Fatal << "FFN::Predict(): the batch size must be greater than 0."
+        << std::endl;
+
   if (parameter.is_empty())
     ResetParameters();
 
@@ -183,23 +195,22 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  arma::mat resultsTemp;
-  Forward(std::move(arma::mat(predictors.colptr(0),
-      predictors.n_rows, 1, false, true)));
-  resultsTemp = boost::apply_visitor(outputParameterVisitor,
-      network.back()).col(0);
+  // Process in accordance with the given batch size.
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols - begin));
+
+    Forward(std::move(arma::mat(predictors.colptr(begin),
+        predictors.n_rows, effectiveBatchSize, false, true)));
 
-  results = arma::mat(resultsTemp.n_elem, predictors.n_cols);
-  results.col(0) = resultsTemp.col(0);
+    const arma::mat& output = plan.back().OutputParameter();
 
-  for (size_t i = 1; i < predictors.n_cols; i++)
-  {
-    Forward(std::move(arma::mat(predictors.colptr(i),
-        predictors.n_rows, 1, false, true)));
+    // The output dimensionality is only known after the first forward pass.
+    if (begin == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
 
-    resultsTemp = boost::apply_visitor(outputParameterVisitor,
-        network.back());
-    results.col(i) = resultsTemp.col(0);
+    results.cols(begin, begin + effectiveBatchSize - 1) = output;
   }
 }
 
@@ -219,13 +230,10 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
 
   Forward(std::move(predictors));
 
-  double res = outputLayer.Forward(std::move(boost::apply_visitor(
-      outputParameterVisitor, network.back())), std::move(responses));
+  double res = outputLayer.Forward(std::move(plan.back().OutputParameter()),
+      std::move(responses));
 
-  for (size_t i = 0; i < network.size(); ++i)
-  {
-    res += boost::apply_visitor(lossVisitor, network[i]);
-  }
+  res += Loss();
 
   return res;
 }
@@ -259,15 +267,18 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     ResetDeterministic();
   }
 
-  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
-  double res = outputLayer.Forward(
-      std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)));
+  double* input;
+  double* target;
+  GatherBatch(begin, batchSize, input, target);
 
-  for (size_t i = 0; i < network.size(); ++i)
-  {
-    res += boost::apply_visitor(lossVisitor, network[i]);
-  }
+  arma::mat targetBatch(target, responses.n_rows, batchSize, false, true);
+  boost::apply_visitor(TargetSetVisitor(targetBatch), network.back());
+
+  Forward(arma::mat(input, predictors.n_rows, batchSize, false, true));
+  double res = outputLayer.Forward(std::move(plan.back().OutputParameter()),
+      std::move(targetBatch));
+
+  res += Loss();
 
   return res;
 }
@@ -320,28 +331,159 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
-  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
-  double res = outputLayer.Forward(
-      std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)));
+  double* input;
+  double* target;
+  GatherBatch(begin, batchSize, input, target);
 
-  for (size_t i = 0; i < network.size(); ++i)
+  #ifdef HAS_OPENMP
+  if (threads > 1 && batchSize > 1)
+    return ParallelEvaluateWithGradient(input, target, gradient, batchSize);
+  #endif
+
+  // Wrap matrices around our data to avoid a copy.
+  return ForwardBackward(arma::mat(input, predictors.n_rows, batchSize, false,
+      true), arma::mat(target, responses.n_rows, batchSize, false, true),
+      gradient);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::GatherBatch(const size_t begin,
+                                       const size_t batchSize,
+                                       double*& input,
+                                       double*& target)
+{
+  // Points past the visitation order (like the generated points a GAN appends
+  // to the data of its discriminator) are never shuffled, so without a
+  // transformation they can be used straight from the data.
+  if (!batchLoader.Gathers(visitationOrder, begin, batchSize))
   {
-    res += boost::apply_visitor(lossVisitor, network[i]);
+    input = predictors.colptr(begin);
+    target = responses.colptr(begin);
+    return;
   }
 
-  outputLayer.Backward(
-      std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)),
-      std::move(error));
+  // This also starts preparing the next batch.
+  batchLoader.Gather(predictors, responses, visitationOrder, begin, batchSize);
+  input = batchLoader.Input().memptr();
+  target = batchLoader.Target().memptr();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::ForwardBackward(arma::mat&& input,
+                                             arma::mat&& target,
+                                             arma::mat& gradient)
+{
+  // Layers like SampledSoftmax need the targets in the forward pass.
+  boost::apply_visitor(TargetSetVisitor(target), network.back());
+
+  Forward(std::move(input));
+  double res = outputLayer.Forward(std::move(plan.back().OutputParameter()),
+      std::move(target));
+
+  res += Loss();
+
+  outputLayer.Backward(std::move(plan.back().OutputParameter()),
+      std::move(target), std::move(error));
 
   Backward();
   ResetGradients(gradient);
-  Gradient(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  Gradient(std::move(input));
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::ParallelEvaluateWithGradient(
+    double* input,
+    double* target,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  const size_t shards = std::min(threads, batchSize);
+  ResetReplicas(shards - 1);
+
+  // The first shard runs on the network itself, the others on the replicas.
+  // Each one only reads the shared parameters and data, and writes its own
+  // gradient.
+  double res = 0;
+  #pragma omp parallel for reduction(+:res)
+  for (omp_size_t s = 0; s < (omp_size_t) shards; ++s)
+  {
+    const size_t shardBegin = (s * batchSize) / shards;
+    const size_t shardSize = ((s + 1) * batchSize) / shards - shardBegin;
+
+    arma::mat shardInput(input + shardBegin * predictors.n_rows,
+        predictors.n_rows, shardSize, false, true);
+    arma::mat shardTarget(target + shardBegin * responses.n_rows,
+        responses.n_rows, shardSize, false, true);
+
+    if (s == 0)
+    {
+      res += ForwardBackward(std::move(shardInput), std::move(shardTarget),
+          gradient);
+    }
+    else
+    {
+      res += replicas[s - 1]->ForwardBackward(std::move(shardInput),
+          std::move(shardTarget), replicaGradients[s - 1]);
+    }
+  }
+
+  for (size_t i = 0; i < shards - 1; ++i)
+    gradient += replicaGradients[i];
 
   return res;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetReplicas(const size_t count)
+{
+  // The replicas alias the parameters of the network, so they only have to be
+  // rebuilt if the modules or the memory of the parameters changed.
+  if (replicas.size() == count && (count == 0 ||
+      (replicas.front()->network.size() == network.size() &&
+      replicas.front()->parameter.memptr() == parameter.memptr())))
+  {
+    return;
+  }
+
+  replicas.clear();
+  replicaGradients.clear();
+  for (size_t r = 0; r < count; ++r)
+  {
+    replicas.emplace_back(new FFN(outputLayer, initializeRule));
+    FFN& replica = *replicas.back();
+
+    replica.parameter = arma::mat(parameter.memptr(), parameter.n_rows,
+        parameter.n_cols, false, false);
+
+    size_t offset = 0;
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      replica.network.push_back(boost::apply_visitor(copyVisitor,
+          network[i]));
+
+      offset += boost::apply_visitor(WeightSetVisitor(std::move(
+          replica.parameter), offset), replica.network[i]);
+      boost::apply_visitor(resetVisitor, replica.network[i]);
+    }
+
+    replica.deterministic = false;
+    replica.ResetDeterministic();
+
+    replicaGradients.push_back(arma::zeros<arma::mat>(parameter.n_rows,
+        parameter.n_cols));
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
@@ -357,7 +499,18 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  math::ShuffleData(predictors, responses, predictors, responses);
+  // Only the order of visitation is shuffled; the batches are gathered from
+  // the data as they are needed, instead of copying all of it every epoch.
+  // The loader may be preparing a batch in the old order.
+  batchLoader.Reset();
+  if (visitationOrder.n_elem != predictors.n_cols)
+  {
+    visitationOrder = arma::linspace<arma::Col<size_t>>(0,
+        predictors.n_cols - 1, predictors.n_cols);
+  }
+
+  std::shuffle(visitationOrder.begin(), visitationOrder.end(),
+      math::randGen);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -373,6 +526,241 @@ void FFN<OutputLayerType, InitializationRuleType,
   networkInit.Initialize(network, parameter);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::Quantize(arma::mat calibrationData)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  // The input of every module is the output of the previous one; none of the
+  // modules that are quantized run in place, so no later module overwrites it.
+  Forward(std::move(calibrationData));
+
+  std::vector<double> inputRange(network.size());
+  inputRange[0] = arma::abs(calibrationData).max();
+  for (size_t i = 1; i < network.size(); ++i)
+    inputRange[i] = arma::abs(plan[i - 1].OutputParameter()).max();
+
+  // The parameters of the quantized modules are removed from the parameters
+  // of the network.
+  arma::mat quantizedParameter(parameter.n_elem, 1);
+  size_t offset = 0, quantizedOffset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t weights = boost::apply_visitor(weightSizeVisitor,
+        network[i]);
+
+    LayerTypes<CustomLayers...> layer;
+    bool quantized = true;
+    if (Linear<>** linear = boost::get<Linear<>*>(&network[i]))
+    {
+      const arma::mat& linearWeights = (*linear)->Parameters();
+      const size_t inSize = (*linear)->InputSize();
+      const size_t outSize = (*linear)->OutputSize();
+      layer = new QuantizedLinear<>(arma::reshape(linearWeights.rows(0,
+          outSize * inSize - 1), outSize, inSize), linearWeights.rows(
+          outSize * inSize, linearWeights.n_elem - 1), inputRange[i]);
+    }
+    else if (LinearNoBias<>** linear = boost::get<LinearNoBias<>*>(
+        &network[i]))
+    {
+      layer = new QuantizedLinear<>(arma::reshape((*linear)->Parameters(),
+          (*linear)->OutputSize(), (*linear)->InputSize()), arma::mat(),
+          inputRange[i]);
+    }
+    else if (Convolution<>** convolution = boost::get<Convolution<>*>(
+        &network[i]))
+    {
+      layer = new QuantizedConvolution<>((*convolution)->InputSize(),
+          (*convolution)->OutputSize(), (*convolution)->KernelWidth(),
+          (*convolution)->KernelHeight(), (*convolution)->StrideWidth(),
+          (*convolution)->StrideHeight(), (*convolution)->PadWidth(),
+          (*convolution)->PadHeight(), (*convolution)->InputWidth(),
+          (*convolution)->InputHeight(), (*convolution)->Parameters(),
+          inputRange[i]);
+    }
+    else
+    {
+      quantized = false;
+    }
+
+    if (quantized)
+    {
+      boost::apply_visitor(deleteVisitor, network[i]);
+      network[i] = layer;
+    }
+    else if (weights > 0)
+    {
+      quantizedParameter.rows(quantizedOffset, quantizedOffset + weights - 1) =
+          parameter.rows(offset, offset + weights - 1);
+      quantizedOffset += weights;
+    }
+
+    offset += weights;
+  }
+
+  quantizedParameter.resize(quantizedOffset, 1);
+  SetModuleParameters(quantizedParameter);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::FoldBatchNorm()
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  std::vector<LayerTypes<CustomLayers...> > foldedNetwork;
+  std::vector<arma::mat> foldedWeights;
+  for (size_t i = 0, offset = 0; i < network.size(); ++i)
+  {
+    const size_t weights = boost::apply_visitor(weightSizeVisitor,
+        network[i]);
+    const arma::mat layerWeights = (weights == 0) ? arma::mat() :
+        arma::mat(parameter.rows(offset, offset + weights - 1));
+    offset += weights;
+
+    BatchNorm<>** batchNorm = boost::get<BatchNorm<>*>(&network[i]);
+    if (batchNorm && !foldedNetwork.empty())
+    {
+      Linear<>** linear = boost::get<Linear<>*>(&foldedNetwork.back());
+      LinearNoBias<>** linearNoBias = boost::get<LinearNoBias<>*>(
+          &foldedNetwork.back());
+
+      size_t inSize = 0, outSize = 0;
+      if (linear)
+      {
+        inSize = (*linear)->InputSize();
+        outSize = (*linear)->OutputSize();
+      }
+      else if (linearNoBias)
+      {
+        inSize = (*linearNoBias)->InputSize();
+        outSize = (*linearNoBias)->OutputSize();
+      }
+
+      if (outSize != 0 && outSize == (*batchNorm)->InputSize())
+      {
+        // The folded module needs a bias.
+        if (linearNoBias)
+        {
+          boost::apply_visitor(deleteVisitor, foldedNetwork.back());
+          foldedNetwork.back() = new Linear<>(inSize, outSize);
+          foldedWeights.back().resize(outSize * inSize + outSize, 1);
+          foldedWeights.back().rows(outSize * inSize, outSize * inSize +
+              outSize - 1).zeros();
+        }
+
+        // In deterministic mode the BatchNorm module computes
+        // scale * x + shift for every unit.
+        const arma::mat scale = layerWeights.rows(0, outSize - 1) /
+            arma::sqrt((*batchNorm)->TrainingVariance() +
+            (*batchNorm)->Epsilon());
+        const arma::mat shift = layerWeights.rows(outSize, 2 * outSize - 1) -
+            (*batchNorm)->TrainingMean() % scale;
+
+        arma::mat& linearWeights = foldedWeights.back();
+        arma::mat weight(linearWeights.memptr(), outSize, inSize, false, true);
+        arma::mat bias(linearWeights.memptr() + weight.n_elem, outSize, 1,
+            false, true);
+        weight.each_col() %= scale;
+        bias = bias % scale + shift;
+
+        boost::apply_visitor(deleteVisitor, network[i]);
+        continue;
+      }
+    }
+
+    foldedNetwork.push_back(network[i]);
+    foldedWeights.push_back(layerWeights);
+  }
+
+  size_t weights = 0;
+  for (size_t i = 0; i < foldedWeights.size(); ++i)
+    weights += foldedWeights[i].n_elem;
+
+  arma::mat foldedParameter(weights, 1);
+  for (size_t i = 0, offset = 0; i < foldedWeights.size(); ++i)
+  {
+    if (foldedWeights[i].is_empty())
+      continue;
+
+    foldedParameter.rows(offset, offset + foldedWeights[i].n_elem - 1) =
+        arma::vectorise(foldedWeights[i]);
+    offset += foldedWeights[i].n_elem;
+  }
+
+  network = foldedNetwork;
+  SetModuleParameters(foldedParameter);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::UpdateStatistics(const size_t batchSize)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  bool hasStatistics = false;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    BatchNorm<>** batchNorm = boost::get<BatchNorm<>*>(&network[i]);
+    if (batchNorm)
+    {
+      (*batchNorm)->ResetStatistics();
+      hasStatistics = true;
+    }
+  }
+
+  if (!hasStatistics)
+    return;
+
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols - begin));
+    Evaluate(parameter, begin, effectiveBatchSize, false);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::SetModuleParameters(const arma::mat& newParameter)
+{
+  parameter = newParameter;
+
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+        offset), network[i]);
+
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+
+  // Reset() initializes the parameters of some modules (e.g. BatchNorm), so
+  // the parameters are copied again; the size doesn't change, so the memory
+  // the modules point to is kept.
+  parameter = newParameter;
+  ResetDeterministic();
+
+  // The plan and the replicas point to the replaced modules.
+  ++generation;
+  replicas.clear();
+  replicaGradients.clear();
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
@@ -396,14 +784,66 @@ void FFN<OutputLayerType, InitializationRuleType,
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetPlan()
+{
+  // The plan only holds pointers to the modules, so it stays valid until
+  // modules are added, replaced or loaded, which starts a new generation.
+  if (planGeneration == generation)
+    return;
+
+  plan.clear();
+  plan.reserve(network.size());
+  ExecutionPlanVisitor executionPlanVisitor;
+  for (size_t i = 0; i < network.size(); ++i)
+    plan.push_back(boost::apply_visitor(executionPlanVisitor, network[i]));
+  planGeneration = generation;
+
+  // Elementwise modules write their output over the output of the previous
+  // module when its Backward() function doesn't need it, and their delta over
+  // the delta of the next module, which only they read.  The first and the
+  // last module keep their own buffers, since those are also used outside of
+  // the plan.
+  if (plan.size() < 3)
+    return;
+
+  for (size_t i = 1; i < plan.size() - 1; ++i)
+  {
+    if (plan[i].IsInPlace() && !plan[i - 1].BackwardUsesOutput())
+      plan[i].ShareOutputParameter(plan[i - 1].OutputParameter());
+  }
+
+  for (size_t i = plan.size() - 2; i > 0; --i)
+  {
+    if (plan[i].IsInPlace())
+      plan[i].ShareDelta(plan[i + 1].Delta());
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::Loss() const
+{
+  double loss = 0;
+  for (size_t i = 0; i < plan.size(); ++i)
+    loss += plan[i].Loss();
+
+  return loss;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(arma::mat&& input)
 {
-  boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
-      boost::apply_visitor(outputParameterVisitor, network.front()))),
-      network.front());
+  ResetPlan();
+
+  // The modules are run through the execution plan; the visitors are only
+  // needed to set the input sizes of the modules on the first pass.
+  plan.front().Forward(input);
 
   if (!reset)
   {
@@ -418,7 +858,7 @@ void FFN<OutputLayerType, InitializationRuleType,
     }
   }
 
-  for (size_t i = 1; i < network.size(); ++i)
+  for (size_t i = 1; i < plan.size(); ++i)
   {
     if (!reset)
     {
@@ -429,9 +869,7 @@ void FFN<OutputLayerType, InitializationRuleType,
       boost::apply_visitor(SetInputHeightVisitor(height), network[i]);
     }
 
-    boost::apply_visitor(ForwardVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, network[i - 1])), std::move(
-        boost::apply_visitor(outputParameterVisitor, network[i]))), network[i]);
+    plan[i].Forward(plan[i - 1].OutputParameter());
 
     if (!reset)
     {
@@ -457,18 +895,9 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
-  boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-      outputParameterVisitor, network.back())), std::move(error), std::move(
-      boost::apply_visitor(deltaVisitor, network.back()))), network.back());
-
-  for (size_t i = 2; i < network.size(); ++i)
-  {
-    boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, network[network.size() - i])), std::move(
-        boost::apply_visitor(deltaVisitor, network[network.size() - i + 1])),
-        std::move(boost::apply_visitor(deltaVisitor,
-        network[network.size() - i]))), network[network.size() - i]);
-  }
+  plan.back().Backward(error);
+  for (size_t i = 2; i < plan.size(); ++i)
+    plan[plan.size() - i].Backward(plan[plan.size() - i + 1].Delta());
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -476,28 +905,64 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(arma::mat&& input)
 {
-  boost::apply_visitor(GradientVisitor(std::move(input), std::move(
-      boost::apply_visitor(deltaVisitor, network[1]))), network.front());
-
-  for (size_t i = 1; i < network.size() - 1; ++i)
-  {
-    boost::apply_visitor(GradientVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, network[i - 1])), std::move(
-        boost::apply_visitor(deltaVisitor, network[i + 1]))), network[i]);
-  }
+  plan.front().Gradient(input, plan[1].Delta());
+  for (size_t i = 1; i < plan.size() - 1; ++i)
+    plan[i].Gradient(plan[i - 1].OutputParameter(), plan[i + 1].Delta());
 
-  boost::apply_visitor(GradientVisitor(std::move(boost::apply_visitor(
-      outputParameterVisitor, network[network.size() - 2])), std::move(error)),
-      network[network.size() - 1]);
+  plan.back().Gradient(plan[plan.size() - 2].OutputParameter(), error);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename Archive>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
-    Archive& ar, const unsigned int /* version */)
+    Archive& ar, const unsigned int version)
 {
-  ar & BOOST_SERIALIZATION_NVP(parameter);
+  if (version == 0)
+  {
+    precision = DOUBLE_PRECISION;
+    ar & BOOST_SERIALIZATION_NVP(parameter);
+  }
+  else
+  {
+    ar & BOOST_SERIALIZATION_NVP(precision);
+
+    if (precision == DOUBLE_PRECISION)
+    {
+      ar & BOOST_SERIALIZATION_NVP(parameter);
+    }
+    else if (precision == SINGLE_PRECISION)
+    {
+      arma::fmat singleParameter;
+      if (Archive::is_saving::value)
+        singleParameter = arma::conv_to<arma::fmat>::from(parameter);
+
+      ar & BOOST_SERIALIZATION_NVP(singleParameter);
+
+      if (Archive::is_loading::value)
+        parameter = arma::conv_to<arma::mat>::from(singleParameter);
+    }
+    else
+    {
+      arma::Mat<uint16_t> bfloat16Parameter;
+      if (Archive::is_saving::value)
+      {
+        bfloat16Parameter.set_size(parameter.n_rows, parameter.n_cols);
+        for (size_t i = 0; i < parameter.n_elem; ++i)
+          bfloat16Parameter[i] = ToBFloat16(parameter[i]);
+      }
+
+      ar & BOOST_SERIALIZATION_NVP(bfloat16Parameter);
+
+      if (Archive::is_loading::value)
+      {
+        parameter.set_size(bfloat16Parameter.n_rows, bfloat16Parameter.n_cols);
+        for (size_t i = 0; i < parameter.n_elem; ++i)
+          parameter[i] = FromBFloat16(bfloat16Parameter[i]);
+      }
+    }
+  }
+
   ar & BOOST_SERIALIZATION_NVP(width);
   ar & BOOST_SERIALIZATION_NVP(height);
   ar & BOOST_SERIALIZATION_NVP(currentInput);
@@ -508,6 +973,9 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
     std::for_each(network.begin(), network.end(),
         boost::apply_visitor(deleteVisitor));
     network.clear();
+    plan.clear();
+    ++generation;
+    replicas.clear();
   }
 
   ar & BOOST_SERIALIZATION_NVP(network);
@@ -531,6 +999,35 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+uint16_t FFN<OutputLayerType, InitializationRuleType,
+             CustomLayers...>::ToBFloat16(const double value)
+{
+  const float single = (float) value;
+  uint32_t bits;
+  std::memcpy(&bits, &single, sizeof(float));
+
+  // Keep NaNs NaN, since rounding could turn them into infinities.
+  if ((bits & 0x7fffffff) > 0x7f800000)
+    return (uint16_t) ((bits >> 16) | 0x0040);
+
+  // Round to the nearest number, and to the even one on ties.
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return (uint16_t) (bits >> 16);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::FromBFloat16(const uint16_t value)
+{
+  const uint32_t bits = ((uint32_t) value) << 16;
+  float single;
+  std::memcpy(&single, &bits, sizeof(float));
+  return single;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
@@ -542,8 +1039,13 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(height, network.height);
   std::swap(reset, network.reset);
   std::swap(this->network, network.network);
+  std::swap(plan, network.plan);
+  std::swap(generation, network.generation);
+  std::swap(planGeneration, network.planGeneration);
   std::swap(predictors, network.predictors);
   std::swap(responses, network.responses);
+  std::swap(visitationOrder, network.visitationOrder);
+  std::swap(batchLoader, network.batchLoader);
   std::swap(parameter, network.parameter);
   std::swap(numFunctions, network.numFunctions);
   std::swap(error, network.error);
@@ -553,6 +1055,10 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(inputParameter, network.inputParameter);
   std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(threads, network.threads);
+  std::swap(replicas, network.replicas);
+  std::swap(replicaGradients, network.replicaGradients);
+  std::swap(precision, network.precision);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -564,8 +1070,12 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     width(network.width),
     height(network.height),
     reset(network.reset),
+    generation(1),
+    planGeneration(0),
     predictors(network.predictors),
     responses(network.responses),
+    visitationOrder(network.visitationOrder),
+    batchLoader(network.batchLoader),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
     error(network.error),
@@ -574,7 +1084,9 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    threads(network.threads),
+    precision(network.precision)
 {
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
@@ -582,6 +1094,12 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     this->network.push_back(boost::apply_visitor(copyVisitor,
         network.network[i]));
   }
+
+  // The copied modules hold their own copy of the weights; point them to the
+  // parameters of this network, so that modifying Parameters() modifies the
+  // weights the modules use.
+  if (!parameter.is_empty())
+    SetModuleParameters(network.parameter);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -593,8 +1111,12 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     width(network.width),
     height(network.height),
     reset(network.reset),
+    generation(network.generation),
+    planGeneration(network.planGeneration),
     predictors(std::move(network.predictors)),
     responses(std::move(network.responses)),
+    visitationOrder(std::move(network.visitationOrder)),
+    batchLoader(std::move(network.batchLoader)),
     parameter(std::move(network.parameter)),
     numFunctions(network.numFunctions),
     error(std::move(network.error)),
@@ -603,9 +1125,19 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    threads(network.threads),
+    replicas(std::move(network.replicas)),
+    replicaGradients(std::move(network.replicaGradients)),
+    precision(network.precision)
 {
   this->network = std::move(network.network);
+  this->plan = std::move(network.plan);
+
+  // Small matrices keep their elements inside the arma::mat object, so moving
+  // the parameters may have moved the memory the modules point to.
+  if (!parameter.is_empty())
+    SetModuleParameters(arma::mat(parameter));
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -615,6 +1147,12 @@ FFN<OutputLayerType, InitializationRuleType,
     CustomLayers...>::operator = (FFN network)
 {
   Swap(network);
+
+  // Small matrices keep their elements inside the arma::mat object, so the
+  // swap may have moved the memory the modules point to.
+  if (!parameter.is_empty())
+    SetModuleParameters(arma::mat(parameter));
+
   return *this;
 };
 
@@ -75,6 +75,8 @@ class GAN
    * @param multiplier Ratio of learning rate of Discriminator to the Generator.
    * @param clippingParameter Weight range for enforcing Lipschitz constraint.
    * @param lambda Parameter for setting the gradient penalty.
+   * @param parallel Whether to run the Generator on new noise while the
+   *     Discriminator runs on the real data, with two OpenMP threads.
    */
   GAN(arma::mat& trainData,
       Model generator,
@@ -87,7 +89,8 @@ class GAN
       const size_t preTrainSize,
       const double multiplier,
       const double clippingParameter = 0.01,
-      const double lambda = 10.0);
+      const double lambda = 10.0,
+      const bool parallel = false);
 
   //! Copy constructor.
   GAN(const GAN&);
@@ -294,11 +297,32 @@ class GAN
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
+  //! Get whether the Generator and Discriminator passes overlap.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the Generator and Discriminator passes overlap.
+  bool& Parallel() { return parallel; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Sample noise into the input of the Generator, run the Generator on it and
+   * write its output into the columns of the Discriminator data that hold the
+   * generated points.  If parallel is set, this runs at the same time as the
+   * given pass of the Discriminator on real data, which doesn't depend on the
+   * Generator.
+   *
+   * @param realPass Function running the pass on real data.
+   * @return The result of realPass.
+   */
+  template<typename PassType>
+  double GenerateWith(PassType&& realPass);
+
+  //! Set the responses of the generated points of the Discriminator data.
+  void SetGeneratedResponses(const double response);
+
   //! Locally stored parameter for training data + noise data.
   arma::mat predictors;
   //! Locally stored parameters of the network.
@@ -333,6 +357,8 @@ class GAN
   double lambda;
   //! Locally stored reset parameter.
   bool reset;
+  //! Whether the Generator and Discriminator passes overlap.
+  bool parallel;
   //! Locally stored delta visitor.
   DeltaVisitor deltaVisitor;
   //! Locally stored responses.
@@ -355,8 +381,6 @@ class GAN
   arma::mat noiseGradientDiscriminator;
   //! Locally stored norm of the gradient of Discriminator.
   arma::mat normGradientDiscriminator;
-  //! Locally stored noise using the noise function.
-  arma::mat noise;
   //! Locally stored gradient for Generator.
   arma::mat gradientGenerator;
   //! Locally stored output of the Generator network.
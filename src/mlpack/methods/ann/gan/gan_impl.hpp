@@ -41,7 +41,8 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     const size_t preTrainSize,
     const double multiplier,
     const double clippingParameter,
-    const double lambda):
+    const double lambda,
+    const bool parallel):
     predictors(predictors),
     generator(std::move(generator)),
     discriminator(std::move(discriminator)),
@@ -54,12 +55,15 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     multiplier(multiplier),
     clippingParameter(clippingParameter),
     lambda(lambda),
-    reset(false)
+    reset(false),
+    parallel(parallel)
 {
   // Insert IdentityLayer for joining the Generator and Discriminator.
   this->discriminator.network.insert(
       this->discriminator.network.begin(),
       new IdentityLayer<>());
+  // The execution plan of the discriminator has to include the new layer.
+  ++this->discriminator.generation;
 
   counter = 0;
   currentBatch = 0;
@@ -80,8 +84,7 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
 
   numFunctions = predictors.n_cols;
 
-  noise.set_size(noiseDim, batchSize);
-
+  // The noise is sampled straight into the data of the Generator.
   this->generator.predictors.set_size(noiseDim, batchSize);
   this->generator.responses.set_size(predictors.n_rows, batchSize);
 }
@@ -108,11 +111,11 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     clippingParameter(network.clippingParameter),
     lambda(network.lambda),
     reset(network.reset),
+    parallel(network.parallel),
     counter(network.counter),
     currentBatch(network.currentBatch),
     parameter(network.parameter),
-    numFunctions(network.numFunctions),
-    noise(network.noise)
+    numFunctions(network.numFunctions)
 {
   /* Nothing to do here */
 }
@@ -139,11 +142,11 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     clippingParameter(network.clippingParameter),
     lambda(network.lambda),
     reset(network.reset),
+    parallel(network.parallel),
     counter(network.counter),
     currentBatch(network.currentBatch),
     parameter(std::move(network.parameter)),
-    numFunctions(network.numFunctions),
-    noise(std::move(network.noise))
+    numFunctions(network.numFunctions)
 {
   /* Nothing to do here */
 }
@@ -223,21 +226,17 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   currentTarget = arma::mat(responses.memptr() + i, 1, batchSize, false,
       false);
 
-  discriminator.Forward(std::move(currentInput));
-  double res = discriminator.outputLayer.Forward(
-      std::move(boost::apply_visitor(
-      outputParameterVisitor,
-      discriminator.network.back())), std::move(currentTarget));
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
+  double res = GenerateWith([&]()
+  {
+    discriminator.Forward(std::move(currentInput));
+    return discriminator.outputLayer.Forward(
+        std::move(discriminator.plan.back().OutputParameter()),
+        std::move(currentTarget));
+  });
 
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  discriminator.Forward(std::move(discriminator.predictors.cols(numFunctions,
-      numFunctions + batchSize - 1)));
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      arma::zeros(1, batchSize);
+  discriminator.Forward(arma::mat(discriminator.predictors.colptr(
+      numFunctions), discriminator.predictors.n_rows, batchSize, false, true));
+  SetGeneratedResponses(0);
 
   currentTarget = arma::mat(discriminator.responses.memptr() + numFunctions,
       1, batchSize, false, false);
@@ -294,15 +293,12 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       discriminator.Parameters().n_elem, 1, false, false);
 
   // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      arma::zeros(1, batchSize);
+  double res = GenerateWith([&]()
+  {
+    return discriminator.EvaluateWithGradient(discriminator.parameter, i,
+        gradientDiscriminator, batchSize);
+  });
+  SetGeneratedResponses(0);
 
   // Get the gradients of the Generator.
   res += discriminator.EvaluateWithGradient(discriminator.parameter,
@@ -313,14 +309,11 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   {
     // Minimize -log(D(G(noise))).
     // Pass the error from Discriminator to Generator.
-    discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-        arma::ones(1, batchSize);
+    SetGeneratedResponses(1);
     discriminator.Gradient(discriminator.parameter, numFunctions,
         noiseGradientDiscriminator, batchSize);
-    generator.error = boost::apply_visitor(deltaVisitor,
-        discriminator.network[1]);
+    generator.error = discriminator.plan[1].Delta();
 
-    generator.Predictors() = noise;
     generator.ResetGradients(gradientGenerator);
     generator.Gradient(generator.parameter, 0, gradientGenerator, batchSize);
 
@@ -362,6 +355,57 @@ Gradient(const arma::mat& parameters,
   this->EvaluateWithGradient(parameters, i, gradient, batchSize);
 }
 
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+template<typename PassType>
+double GAN<Model, InitializationRuleType, Noise, PolicyType>::GenerateWith(
+    PassType&& realPass)
+{
+  // The noise is sampled before the passes start, so that the noise function
+  // is only called from one thread.  It's written into the buffer the
+  // Generator reads its data from, where Gradient() finds it again.
+  generator.predictors.imbue([&]() { return noiseFunction(); });
+
+  // The networks have their own modules and disjoint parts of the parameters,
+  // and the Generator only writes columns of the Discriminator data that the
+  // pass on real data doesn't read.
+  double res = 0;
+  #pragma omp parallel sections num_threads(2) if (parallel)
+  {
+    #pragma omp section
+    {
+      res = realPass();
+    }
+
+    #pragma omp section
+    {
+      generator.Forward(std::move(generator.predictors));
+      arma::mat generated(discriminator.predictors.colptr(numFunctions),
+          discriminator.predictors.n_rows, batchSize, false, true);
+      generated = generator.plan.back().OutputParameter();
+    }
+  }
+
+  return res;
+}
+
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+void GAN<Model, InitializationRuleType, Noise, PolicyType>::
+SetGeneratedResponses(const double response)
+{
+  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1)
+      .fill(response);
+}
+
 template<
   typename Model,
   typename InitializationRuleType,
@@ -42,21 +42,17 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   currentTarget = arma::mat(responses.memptr() + i, 1, batchSize, false,
       false);
 
-  discriminator.Forward(std::move(currentInput));
-  double res = discriminator.outputLayer.Forward(
-      std::move(boost::apply_visitor(
-      outputParameterVisitor,
-      discriminator.network.back())), std::move(currentTarget));
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
+  double res = GenerateWith([&]()
+  {
+    discriminator.Forward(std::move(currentInput));
+    return discriminator.outputLayer.Forward(
+        std::move(discriminator.plan.back().OutputParameter()),
+        std::move(currentTarget));
+  });
 
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  discriminator.Forward(std::move(discriminator.predictors.cols(numFunctions,
-      numFunctions + batchSize - 1)));
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  discriminator.Forward(arma::mat(discriminator.predictors.colptr(
+      numFunctions), discriminator.predictors.n_rows, batchSize, false, true));
+  SetGeneratedResponses(-1);
 
   currentTarget = arma::mat(discriminator.responses.memptr() + numFunctions,
       1, batchSize, false, false);
@@ -112,15 +108,12 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       discriminator.Parameters().n_elem, 1, false, false);
 
   // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  double res = GenerateWith([&]()
+  {
+    return discriminator.EvaluateWithGradient(discriminator.parameter, i,
+        gradientDiscriminator, batchSize);
+  });
+  SetGeneratedResponses(-1);
 
   // Get the gradients of the Generator.
   res += discriminator.EvaluateWithGradient(discriminator.parameter,
@@ -133,14 +126,11 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   {
     // Minimize -D(G(noise)).
     // Pass the error from Discriminator to Generator.
-    discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-        arma::ones(1, batchSize);
+    SetGeneratedResponses(1);
     discriminator.Gradient(discriminator.parameter, numFunctions,
         noiseGradientDiscriminator, batchSize);
-    generator.error = boost::apply_visitor(deltaVisitor,
-        discriminator.network[1]);
+    generator.error = discriminator.plan[1].Delta();
 
-    generator.Predictors() = noise;
     generator.ResetGradients(gradientGenerator);
     generator.Gradient(generator.parameter, 0, gradientGenerator, batchSize);
 
@@ -43,23 +43,18 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   currentTarget = arma::mat(responses.memptr() + i, 1, batchSize, false,
       false);
 
-  discriminator.Forward(std::move(currentInput));
-  double res = discriminator.outputLayer.Forward(
-      std::move(boost::apply_visitor(
-      outputParameterVisitor,
-      discriminator.network.back())), std::move(currentTarget));
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
+  double res = GenerateWith([&]()
+  {
+    discriminator.Forward(std::move(currentInput));
+    return discriminator.outputLayer.Forward(
+        std::move(discriminator.plan.back().OutputParameter()),
+        std::move(currentTarget));
+  });
 
-  arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
-      generator.network.back());
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      generatedData;
-  discriminator.Forward(std::move(discriminator.predictors.cols(numFunctions,
-      numFunctions + batchSize - 1)));
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  arma::mat generated(discriminator.predictors.colptr(numFunctions),
+      discriminator.predictors.n_rows, batchSize, false, true);
+  discriminator.Forward(std::move(generated));
+  SetGeneratedResponses(-1);
 
   currentTarget = arma::mat(discriminator.responses.memptr() + numFunctions,
       1, batchSize, false, false);
@@ -68,12 +63,11 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
       outputParameterVisitor,
       discriminator.network.back())), std::move(currentTarget));
 
-  // Gradient Penalty is calculated here.
+  // Gradient Penalty is calculated here, on points between the real and the
+  // generated ones, which are written over the generated points.
   double epsilon = math::Random();
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  generated = (epsilon * currentInput) +
+      ((1.0 - epsilon) * generator.plan.back().OutputParameter());
   discriminator.Gradient(discriminator.parameter, numFunctions,
       normGradientDiscriminator, batchSize);
   res += lambda * std::pow(arma::norm(normGradientDiscriminator, 2) - 1, 2);
@@ -129,42 +123,39 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       predictors.n_rows, batchSize, false, false);
 
   // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
+  double res = GenerateWith([&]()
+  {
+    return discriminator.EvaluateWithGradient(discriminator.parameter, i,
+        gradientDiscriminator, batchSize);
+  });
+  SetGeneratedResponses(-1);
 
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
-  arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
-      generator.network.back());
+  res += discriminator.EvaluateWithGradient(discriminator.parameter,
+      numFunctions, noiseGradientDiscriminator, batchSize);
+  gradientDiscriminator += noiseGradientDiscriminator;
 
-  // Gradient Penalty is calculated here.
+  // Gradient Penalty is calculated here, on points between the real and the
+  // generated ones.  They are written over the generated points, which are
+  // only copied back if the Generator is trained on them.
+  const arma::mat& generatedData = generator.plan.back().OutputParameter();
+  arma::mat generated(discriminator.predictors.colptr(numFunctions),
+      discriminator.predictors.n_rows, batchSize, false, true);
   double epsilon = math::Random();
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  generated = (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
   discriminator.Gradient(discriminator.parameter, numFunctions,
       normGradientDiscriminator, batchSize);
   res += lambda * std::pow(arma::norm(normGradientDiscriminator, 2) - 1, 2);
 
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      generatedData;
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
-  gradientDiscriminator += noiseGradientDiscriminator;
-
   if (currentBatch % generatorUpdateStep == 0 && preTrainSize == 0)
   {
     // Minimize -D(G(noise)).
     // Pass the error from Discriminator to Generator.
-    discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-        arma::ones(1, batchSize);
+    generated = generatedData;
+    SetGeneratedResponses(1);
     discriminator.Gradient(discriminator.parameter, numFunctions,
         noiseGradientDiscriminator, batchSize);
-    generator.error = boost::apply_visitor(deltaVisitor,
-        discriminator.network[1]);
+    generator.error = discriminator.plan[1].Delta();
 
-    generator.Predictors() = noise;
     generator.ResetGradients(gradientGenerator);
     generator.Gradient(generator.parameter, 0, gradientGenerator, batchSize);
 
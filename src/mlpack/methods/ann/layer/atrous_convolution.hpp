@@ -19,6 +19,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include "layer_types.hpp"
 
@@ -32,6 +33,10 @@ namespace ann /** Artificial Neural Network. */ {
  * spaces included between the kernel cells, in order to capture a larger
  * field of reception, without having to increase dicrete kernel sizes.
  *
+ * If all three rules are Im2ColConvolution, the whole batch is convolved with
+ * one matrix multiplication per pass instead of one 2-D convolution per pair
+ * of maps.
+ *
  * @tparam ForwardConvolutionRule Atrous Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Atrous Convolution to perform backward process.
  * @tparam GradientConvolutionRule Atrous Convolution to calculate gradient.
@@ -172,6 +177,68 @@ class AtrousConvolution
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /*
+   * Convolve the given (padded) input with the filters and store the result
+   * in outputTemp, one pair of maps at a time.
+   *
+   * @param input The (padded) input maps.
+   */
+  template<typename eT, typename Rule = ForwardConvolutionRule>
+  typename std::enable_if<!IsBatchConvolutionRule<Rule>::value, void>::type
+  ForwardConvolution(const arma::Cube<eT>& input);
+
+  /*
+   * Convolve the given (padded) input with the filters and store the result
+   * in outputTemp, for all maps at once.
+   *
+   * @param input The (padded) input maps.
+   */
+  template<typename eT, typename Rule = ForwardConvolutionRule>
+  typename std::enable_if<IsBatchConvolutionRule<Rule>::value, void>::type
+  ForwardConvolution(const arma::Cube<eT>& input);
+
+  /*
+   * Propagate the given error back to the input and store the result in
+   * gTemp, one pair of maps at a time.
+   *
+   * @param error The backpropagated error.
+   */
+  template<typename eT, typename Rule = BackwardConvolutionRule>
+  typename std::enable_if<!IsBatchConvolutionRule<Rule>::value, void>::type
+  BackwardConvolution(const arma::Cube<eT>& error);
+
+  /*
+   * Propagate the given error back to the input and store the result in
+   * gTemp, for all maps at once.
+   *
+   * @param error The backpropagated error.
+   */
+  template<typename eT, typename Rule = BackwardConvolutionRule>
+  typename std::enable_if<IsBatchConvolutionRule<Rule>::value, void>::type
+  BackwardConvolution(const arma::Cube<eT>& error);
+
+  /*
+   * Calculate the gradient of the filters and store it in gradientTemp, one
+   * pair of maps at a time.
+   *
+   * @param input The (padded) input maps.
+   * @param error The calculated error.
+   */
+  template<typename eT, typename Rule = GradientConvolutionRule>
+  typename std::enable_if<!IsBatchConvolutionRule<Rule>::value, void>::type
+  GradientConvolution(const arma::Cube<eT>& input, const arma::Cube<eT>& error);
+
+  /*
+   * Calculate the gradient of the filters and store it in gradientTemp, for
+   * all maps at once.
+   *
+   * @param input The (padded) input maps.
+   * @param error The calculated error.
+   */
+  template<typename eT, typename Rule = GradientConvolutionRule>
+  typename std::enable_if<IsBatchConvolutionRule<Rule>::value, void>::type
+  GradientConvolution(const arma::Cube<eT>& input, const arma::Cube<eT>& error);
+
   /*
    * Return the convolution output size.
    *
@@ -135,37 +135,10 @@ void AtrousConvolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
-  {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
-
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> convOutput;
-
-      if (padW != 0 || padH != 0)
-      {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
-            dilationW, dilationH);
-      }
-      else
-      {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
-            dilationW, dilationH);
-      }
-
-      outputTemp.slice(outMap) += convOutput;
-    }
+  ForwardConvolution((padW != 0 || padH != 0) ? inputPaddedTemp : inputTemp);
 
+  for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
     outputTemp.slice(outMap) += bias(outMap % outSize);
-  }
 
   outputWidth = outputTemp.n_rows;
   outputHeight = outputTemp.n_cols;
@@ -196,6 +169,122 @@ void AtrousConvolution<
       inputTemp.n_cols, inputTemp.n_slices, false, false);
   gTemp.zeros();
 
+  BackwardConvolution(mappedError);
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void AtrousConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::Gradient(
+    const arma::Mat<eT>&& /* input */,
+    arma::Mat<eT>&& error,
+    arma::Mat<eT>&& gradient)
+{
+  arma::cube mappedError(error.memptr(), outputWidth, outputHeight,
+      outSize * batchSize, false, false);
+
+  gradient.zeros(weights.n_elem, 1);
+  gradientTemp = arma::Cube<eT>(gradient.memptr(), weight.n_rows,
+      weight.n_cols, weight.n_slices, false, false);
+
+  GradientConvolution((padW != 0 || padH != 0) ? inputPaddedTemp : inputTemp,
+      mappedError);
+
+  // The bias gradient is the sum of the error over all samples.
+  for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
+  {
+    gradient(weight.n_elem + (outMap % outSize)) +=
+        arma::accu(mappedError.slice(outMap));
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT, typename Rule>
+typename std::enable_if<!IsBatchConvolutionRule<Rule>::value, void>::type
+AtrousConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardConvolution(const arma::Cube<eT>& input)
+{
+  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
+      outSize * batchSize; outMap++)
+  {
+    if (outMap != 0 && outMap % outSize == 0)
+    {
+      batchCount++;
+      outMapIdx = 0;
+    }
+
+    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    {
+      arma::Mat<eT> convOutput;
+      ForwardConvolutionRule::Convolution(input.slice(inMap +
+          batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
+          dilationW, dilationH);
+
+      outputTemp.slice(outMap) += convOutput;
+    }
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT, typename Rule>
+typename std::enable_if<IsBatchConvolutionRule<Rule>::value, void>::type
+AtrousConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardConvolution(const arma::Cube<eT>& input)
+{
+  ForwardConvolutionRule::Forward(input, weight, outputTemp, inSize, dW, dH,
+      dilationW, dilationH);
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT, typename Rule>
+typename std::enable_if<!IsBatchConvolutionRule<Rule>::value, void>::type
+AtrousConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::BackwardConvolution(const arma::Cube<eT>& error)
+{
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -210,7 +299,7 @@ void AtrousConvolution<
       arma::Mat<eT> output, rotatedFilter;
       Rotate180(weight.slice(outMapIdx), rotatedFilter);
 
-      BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
+      BackwardConvolutionRule::Convolution(error.slice(outMap),
           rotatedFilter, output, dW, dH, dilationW, dilationH);
 
       if (padW != 0 || padH != 0)
@@ -234,26 +323,53 @@ template<
     typename InputDataType,
     typename OutputDataType
 >
-template<typename eT>
-void AtrousConvolution<
+template<typename eT, typename Rule>
+typename std::enable_if<IsBatchConvolutionRule<Rule>::value, void>::type
+AtrousConvolution<
     ForwardConvolutionRule,
     BackwardConvolutionRule,
     GradientConvolutionRule,
     InputDataType,
     OutputDataType
->::Gradient(
-    const arma::Mat<eT>&& /* input */,
-    arma::Mat<eT>&& error,
-    arma::Mat<eT>&& gradient)
+>::BackwardConvolution(const arma::Cube<eT>& error)
 {
-  arma::cube mappedError(error.memptr(), outputWidth, outputHeight,
-      outSize * batchSize, false, false);
-
-  gradient.set_size(weights.n_elem, 1);
-  gradientTemp = arma::Cube<eT>(gradient.memptr(), weight.n_rows,
-      weight.n_cols, weight.n_slices, false, false);
-  gradientTemp.zeros();
+  if (padW != 0 || padH != 0)
+  {
+    // The gradient is computed for the padded input, and the padding is then
+    // removed.
+    arma::Cube<eT> paddedG(inputPaddedTemp.n_rows, inputPaddedTemp.n_cols,
+        inputPaddedTemp.n_slices);
+    BackwardConvolutionRule::Backward(error, weight, paddedG, inSize, dW, dH,
+        dilationW, dilationH);
+
+    gTemp = paddedG.tube(padW, padH, padW + gTemp.n_rows - 1,
+        padH + gTemp.n_cols - 1);
+  }
+  else
+  {
+    BackwardConvolutionRule::Backward(error, weight, gTemp, inSize, dW, dH,
+        dilationW, dilationH);
+  }
+}
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT, typename Rule>
+typename std::enable_if<!IsBatchConvolutionRule<Rule>::value, void>::type
+AtrousConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::GradientConvolution(const arma::Cube<eT>& input,
+                       const arma::Cube<eT>& error)
+{
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -265,21 +381,9 @@ void AtrousConvolution<
 
     for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
     {
-      arma::Mat<eT> inputSlice;
-      if (padW != 0 || padH != 0)
-      {
-        inputSlice = inputPaddedTemp.slice(inMap + batchCount * inSize);
-      }
-      else
-      {
-        inputSlice = inputTemp.slice(inMap + batchCount * inSize);
-      }
-
-      arma::Mat<eT> deltaSlice = mappedError.slice(outMap);
-
       arma::Mat<eT> output;
-      GradientConvolutionRule::Convolution(inputSlice, deltaSlice,
-          output, dW, dH, 1, 1);
+      GradientConvolutionRule::Convolution(input.slice(inMap +
+          batchCount * inSize), error.slice(outMap), output, dW, dH, 1, 1);
 
       if (dilationH > 1)
       {
@@ -311,12 +415,31 @@ void AtrousConvolution<
         gradientTemp.slice(outMapIdx) += output;
       }
     }
-
-    gradient.submat(weight.n_elem + (outMap % outSize), 0, weight.n_elem +
-        (outMap % outSize), 0) = arma::accu(mappedError.slice(outMap));
   }
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT, typename Rule>
+typename std::enable_if<IsBatchConvolutionRule<Rule>::value, void>::type
+AtrousConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::GradientConvolution(const arma::Cube<eT>& input,
+                       const arma::Cube<eT>& error)
+{
+  GradientConvolutionRule::Gradient(input, error, gradientTemp, inSize, dW,
+      dH, dilationW, dilationH);
+}
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_BASE_LAYER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 #include <mlpack/methods/ann/activation_functions/logistic_function.hpp>
 #include <mlpack/methods/ann/activation_functions/identity_function.hpp>
 #include <mlpack/methods/ann/activation_functions/rectifier_function.hpp>
@@ -83,7 +84,6 @@ class BaseLayer
                 arma::Mat<eT>&& gy,
                 arma::Mat<eT>&& g)
   {
-    arma::Mat<eT> derivative;
     ActivationFunction::Deriv(input, derivative);
     g = gy % derivative;
   }
@@ -113,8 +113,29 @@ class BaseLayer
 
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
+
+  //! Locally-stored derivative object, reused by every backward pass.
+  OutputDataType derivative;
 }; // class BaseLayer
 
+/**
+ * The activation is elementwise, and its derivative is computed from the
+ * output of the layer.
+ */
+template<class ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+class LayerTraits<BaseLayer<ActivationFunction, InputDataType, OutputDataType>>
+{
+ public:
+  static const bool IsBinary = false;
+  static const bool IsOutputLayer = false;
+  static const bool IsBiasLayer = false;
+  static const bool IsLSTMLayer = false;
+  static const bool IsConnection = false;
+  static const bool IsInPlace = true;
+  static const bool BackwardUsesOutput = true;
+};
+
 // Convenience typedefs.
 
 /**
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_BATCHNORM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -28,6 +29,11 @@ namespace ann /** Artificial Neural Network. */ {
  * calculated and the data is normalized. If it is set to true (testing) then
  * the mean and variance accrued over the training set is used.
  *
+ * The statistics, the normalization and the scale and shift are each computed
+ * in a single pass over the batch, and the normalized input and the inverse
+ * standard deviation are kept for the backward pass.  FFN::FoldBatchNorm()
+ * folds the layer into the preceding Linear layer for inference.
+ *
  * For more information, refer to the following paper,
  *
  * @code
@@ -133,16 +139,29 @@ class BatchNorm
   bool& Deterministic() { return deterministic; }
 
   //! Get the mean over the training data.
-  OutputDataType TrainingMean() { return stats.mean(); }
+  OutputDataType TrainingMean() { return runningMean; }
 
   //! Get the variance over the training data.
-  OutputDataType TrainingVariance() { return stats.var(1); }
+  OutputDataType TrainingVariance() { return runningVariance; }
+
+  /**
+   * Forget the mean and variance over the training data, so that they are
+   * computed again from the following forward passes in training mode (for
+   * instance after the weights of the network were changed).
+   */
+  void ResetStatistics();
+
+  //! Get the number of input units.
+  size_t InputSize() const { return size; }
+
+  //! Get the epsilon added to the variance.
+  double Epsilon() const { return eps; }
 
   /**
    * Serialize the layer
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
   //! Locally-stored number of input units.
@@ -172,8 +191,17 @@ class BatchNorm
   //! Locally-stored variance object.
   OutputDataType variance;
 
-  //! Locally-stored running statistics object.
-  arma::running_stat_vec<arma::colvec> stats;
+  //! Locally-stored inverse of the standard deviation.
+  OutputDataType stdInv;
+
+  //! Locally-stored number of training points seen.
+  size_t count;
+
+  //! Locally-stored mean over the training data.
+  OutputDataType runningMean;
+
+  //! Locally-stored variance over the training data.
+  OutputDataType runningVariance;
 
   //! Locally-stored gradient object.
   OutputDataType gradient;
@@ -186,11 +214,48 @@ class BatchNorm
 
   //! Locally-stored normalized input.
   OutputDataType normalized;
+
+  //! If true, the layer was loaded, and Reset() keeps gamma and beta.
+  bool loading;
 }; // class BatchNorm
 
+/**
+ * The Backward() function of the BatchNorm layer uses the normalized input it
+ * stored in the forward pass, so the output may be overwritten by the next
+ * layer.
+ */
+template<typename InputDataType, typename OutputDataType>
+class LayerTraits<BatchNorm<InputDataType, OutputDataType>>
+{
+ public:
+  static const bool IsBinary = false;
+  static const bool IsOutputLayer = false;
+  static const bool IsBiasLayer = false;
+  static const bool IsLSTMLayer = false;
+  static const bool IsConnection = false;
+  static const bool IsInPlace = false;
+  static const bool BackwardUsesOutput = false;
+};
+
 } // namespace ann
 } // namespace mlpack
 
+//! Set the serialization version of the BatchNorm class.  Version 1 stores the
+//! size and the statistics over the training data.
+namespace boost {
+namespace serialization {
+
+template<typename InputDataType, typename OutputDataType>
+struct version<mlpack::ann::BatchNorm<InputDataType, OutputDataType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include the implementation.
 #include "batch_norm_impl.hpp"
 
@@ -24,9 +24,12 @@ template<typename InputDataType, typename OutputDataType>
 BatchNorm<InputDataType, OutputDataType>::BatchNorm() :
     size(10),
     eps(1e-8),
-    deterministic(false)
+    deterministic(false),
+    count(0),
+    loading(false)
 {
-  // Nothing to do here.
+  runningMean.zeros(size, 1);
+  runningVariance.zeros(size, 1);
 }
 
 template <typename InputDataType, typename OutputDataType>
@@ -34,9 +37,13 @@ BatchNorm<InputDataType, OutputDataType>::BatchNorm(
     const size_t size, const double eps) :
     size(size),
     eps(eps),
-    deterministic(false)
+    deterministic(false),
+    count(0),
+    loading(false)
 {
   weights.set_size(size + size, 1);
+  runningMean.zeros(size, 1);
+  runningVariance.zeros(size, 1);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -45,9 +52,23 @@ void BatchNorm<InputDataType, OutputDataType>::Reset()
   gamma = arma::mat(weights.memptr(), size, 1, false, false);
   beta = arma::mat(weights.memptr() + gamma.n_elem, size, 1, false, false);
   deterministic = false;
-  gamma.fill(1.0);
-  beta.fill(0.0);
-  stats.reset();
+
+  // The parameters of a loaded layer are already in place.
+  if (!loading)
+  {
+    gamma.fill(1.0);
+    beta.fill(0.0);
+  }
+
+  loading = false;
+}
+
+template<typename InputDataType, typename OutputDataType>
+void BatchNorm<InputDataType, OutputDataType>::ResetStatistics()
+{
+  count = 0;
+  runningMean.zeros(size, 1);
+  runningVariance.zeros(size, 1);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -55,66 +76,121 @@ template<typename eT>
 void BatchNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
+  output.set_size(input.n_rows, input.n_cols);
+
   // Mean and variance over the entire training set will be used to compute
-  // the forward pass when deterministic is set to true.
+  // the forward pass when deterministic is set to true.  The normalization,
+  // scale and shift are then a single affine transformation of every unit.
   if (deterministic)
   {
-    // Mini--batch mean using the stats object.
-    mean = stats.mean();
-
-    // Mini--batch variance using the stats object.
-    variance = stats.var(1);
+    stdInv = 1.0 / arma::sqrt(runningVariance + eps);
+    const arma::mat scale = gamma % stdInv;
+    const arma::mat shift = beta - runningMean % scale;
+
+    for (size_t j = 0; j < input.n_cols; ++j)
+    {
+      const eT* inputPtr = input.colptr(j);
+      eT* outputPtr = output.colptr(j);
+      for (size_t i = 0; i < size; ++i)
+        outputPtr[i] = inputPtr[i] * scale[i] + shift[i];
+    }
+
+    return;
+  }
 
-    // Normalize the input and scale and shift the output.
-    output = input.each_col() - mean;
-    output.each_col() %= gamma / arma::sqrt(variance + eps);
-    output.each_col() += beta;
+  // Compute the mean and the variance of the batch in one pass with
+  // Welford's algorithm; the samples are the columns, so the inner loop is
+  // contiguous.
+  mean.zeros(size, 1);
+  variance.zeros(size, 1);
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    const eT* inputPtr = input.colptr(j);
+    const double weight = 1.0 / (j + 1);
+    for (size_t i = 0; i < size; ++i)
+    {
+      const double delta = inputPtr[i] - mean[i];
+      mean[i] += delta * weight;
+      variance[i] += delta * (inputPtr[i] - mean[i]);
+    }
   }
-  else
+  variance /= input.n_cols;
+
+  // Merge the statistics of the batch into the statistics of the training
+  // set.
+  const double previous = count;
+  const double batchSize = input.n_cols;
+  const double total = previous + batchSize;
+  const arma::mat meanDelta = mean - runningMean;
+  runningVariance = (runningVariance * previous + variance * batchSize +
+      arma::square(meanDelta) * (previous * batchSize / total)) / total;
+  runningMean += meanDelta * (batchSize / total);
+  count += input.n_cols;
+
+  // Normalize, scale and shift in one pass; the normalized input and the
+  // inverse standard deviation are reused in the backward and gradient step.
+  stdInv = 1.0 / arma::sqrt(variance + eps);
+  normalized.set_size(input.n_rows, input.n_cols);
+  for (size_t j = 0; j < input.n_cols; ++j)
   {
-    mean = arma::mean(input, 1);
-    variance = arma::var(input, 1, 1);
-
-    for (size_t i = 0; i < input.n_cols; i++)
-      stats(input.col(i));
-
-    // Normalize the input.
-    output = input.each_col() - mean;
-    output.each_col() /= arma::sqrt(variance + eps);
-
-    // Reused in the backward and gradient step.
-    normalized = output;
-
-    // Scale and shift the output.
-    output.each_col() %= gamma;
-    output.each_col() += beta;
+    const eT* inputPtr = input.colptr(j);
+    eT* normalizedPtr = normalized.colptr(j);
+    eT* outputPtr = output.colptr(j);
+    for (size_t i = 0; i < size; ++i)
+    {
+      normalizedPtr[i] = (inputPtr[i] - mean[i]) * stdInv[i];
+      outputPtr[i] = normalizedPtr[i] * gamma[i] + beta[i];
+    }
   }
 }
 
 template<typename InputDataType, typename OutputDataType>
 template<typename eT>
 void BatchNorm<InputDataType, OutputDataType>::Backward(
-    const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  const arma::mat inputMean = input.each_col() - mean;
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
+  g.set_size(gy.n_rows, gy.n_cols);
 
-  // Step 1: dl / dxhat
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // Step 2: sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 1) %
-      arma::pow(stdInv, 3.0) * -0.5;
+  // With the statistics of the training set, the layer is an affine
+  // transformation of every unit.
+  if (deterministic)
+  {
+    const arma::mat scale = gamma % stdInv;
+    g = gy.each_col() % scale;
+    return;
+  }
 
-  // Step 4: dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_col() % stdInv) + (inputMean.each_col() %
-      var * 2 / input.n_cols);
+  // The gradient with respect to the input is
+  // gamma * stdInv / m * (m * dy - sum(dy) - xhat * sum(dy * xhat)),
+  // where the sums are over the batch.
+  arma::mat errorSum(size, 1, arma::fill::zeros);
+  arma::mat normalizedErrorSum(size, 1, arma::fill::zeros);
+  for (size_t j = 0; j < gy.n_cols; ++j)
+  {
+    const eT* errorPtr = gy.colptr(j);
+    const eT* normalizedPtr = normalized.colptr(j);
+    for (size_t i = 0; i < size; ++i)
+    {
+      errorSum[i] += errorPtr[i];
+      normalizedErrorSum[i] += errorPtr[i] * normalizedPtr[i];
+    }
+  }
 
-  // Step 3: sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_col() += (arma::sum(norm.each_col() % -stdInv, 1) + (var %
-      arma::mean(-2 * inputMean, 1))) / input.n_cols;
+  const double m = gy.n_cols;
+  const arma::mat scale = gamma % stdInv;
+  errorSum /= m;
+  normalizedErrorSum /= m;
+  for (size_t j = 0; j < gy.n_cols; ++j)
+  {
+    const eT* errorPtr = gy.colptr(j);
+    const eT* normalizedPtr = normalized.colptr(j);
+    eT* gPtr = g.colptr(j);
+    for (size_t i = 0; i < size; ++i)
+    {
+      gPtr[i] = scale[i] * (errorPtr[i] - errorSum[i] - normalizedPtr[i] *
+          normalizedErrorSum[i]);
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -124,23 +200,53 @@ void BatchNorm<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient.set_size(size + size, 1);
-
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(normalized % error, 1);
+  gradient.zeros(size + size, 1);
 
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+  // Step 5: dl / dy * xhat; step 6: dl / dy.
+  double* gammaGradient = gradient.memptr();
+  double* betaGradient = gradient.memptr() + size;
+  for (size_t j = 0; j < error.n_cols; ++j)
+  {
+    const eT* errorPtr = error.colptr(j);
+    const eT* normalizedPtr = normalized.colptr(j);
+    for (size_t i = 0; i < size; ++i)
+    {
+      gammaGradient[i] += errorPtr[i] * normalizedPtr[i];
+      betaGradient[i] += errorPtr[i];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void BatchNorm<InputDataType, OutputDataType>::serialize(
-    Archive& ar, const unsigned int /* version */)
+    Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(gamma);
   ar & BOOST_SERIALIZATION_NVP(beta);
+
+  if (version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(size);
+    ar & BOOST_SERIALIZATION_NVP(eps);
+    ar & BOOST_SERIALIZATION_NVP(count);
+    ar & BOOST_SERIALIZATION_NVP(runningMean);
+    ar & BOOST_SERIALIZATION_NVP(runningVariance);
+  }
+  else if (Archive::is_loading::value)
+  {
+    // Older models don't store the statistics over the training data.
+    size = gamma.n_elem;
+    ResetStatistics();
+  }
+
+  // A network sets the weights to the parameters it loaded; otherwise they are
+  // restored from gamma and beta.  Either way, the next Reset() keeps them.
+  if (Archive::is_loading::value)
+  {
+    weights = arma::join_cols(gamma, beta);
+    loading = true;
+  }
 }
 
 } // namespace ann
@@ -100,6 +100,28 @@ class BilinearInterpolation
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Compute the interpolation table that maps a sourceRows x sourceCols image
+   * to a targetRows x targetCols image: for every target pixel, the offset of
+   * the top left of the 2 x 2 source pixels it is interpolated from and their
+   * four weights.
+   *
+   * @param sourceRows Number of rows of the source image.
+   * @param sourceCols Number of columns of the source image.
+   * @param targetRows Number of rows of the target image.
+   * @param targetCols Number of columns of the target image.
+   * @param clamp If true, the distances to the top left pixel are at most 1.
+   * @param offsets The offsets of the top left source pixels.
+   * @param weights The weights, one column per target pixel.
+   */
+  static void InterpolationTable(const size_t sourceRows,
+                                 const size_t sourceCols,
+                                 const size_t targetRows,
+                                 const size_t targetCols,
+                                 const bool clamp,
+                                 arma::Col<size_t>& offsets,
+                                 arma::mat& weights);
+
   //! Locally stored row size of the input.
   size_t inRowSize;
   //! Locally stored column size of the input.
@@ -112,6 +134,14 @@ class BilinearInterpolation
   size_t depth;
   //! Locally stored number of input points.
   size_t batchSize;
+  //! Locally-stored offsets of the input pixels of every output pixel.
+  arma::Col<size_t> forwardOffsets;
+  //! Locally-stored interpolation weights of every output pixel.
+  arma::mat forwardWeights;
+  //! Locally-stored offsets of the output pixels of every input pixel.
+  arma::Col<size_t> backwardOffsets;
+  //! Locally-stored down-sampling weights of every input pixel.
+  arma::mat backwardWeights;
   //! Locally-stored delta object.
   OutputDataType delta;
   //! Locally-stored output parameter object.
@@ -68,45 +68,25 @@ void BilinearInterpolation<InputDataType, OutputDataType>::Forward(
   assert(inRowSize >= 2);
   assert(inColSize >= 2);
 
-  arma::cube inputAsCube(const_cast<arma::Mat<eT>&&>(input).memptr(),
-      inRowSize, inColSize, depth * batchSize, false, false);
-  arma::cube outputAsCube(output.memptr(), outRowSize, outColSize,
-                          depth * batchSize, false, true);
-
-  double scaleRow = (double) inRowSize / (double) outRowSize;
-  double scaleCol = (double) inColSize / (double) outColSize;
+  if (forwardOffsets.n_elem != outRowSize * outColSize)
+  {
+    InterpolationTable(inRowSize, inColSize, outRowSize, outColSize, true,
+        forwardOffsets, forwardWeights);
+  }
 
-  arma::mat22 coeffs;
-  for (size_t i = 0; i < outRowSize; i++)
+  // Every slice (a channel of one point) is interpolated with the same table.
+  const size_t inSlice = inRowSize * inColSize;
+  const size_t outSlice = outRowSize * outColSize;
+  for (size_t k = 0; k < depth * batchSize; k++)
   {
-    size_t rOrigin = (size_t) std::floor(i * scaleRow);
-    if (rOrigin > inRowSize - 2)
-      rOrigin = inRowSize - 2;
-
-    // Scaled distance of the interpolated point from the topmost row.
-    double deltaR = i * scaleRow - rOrigin;
-    if (deltaR > 1)
-      deltaR = 1.0;
-    for (size_t j = 0; j < outColSize; j++)
+    const eT* in = input.memptr() + k * inSlice;
+    eT* out = output.memptr() + k * outSlice;
+    for (size_t p = 0; p < outSlice; p++)
     {
-      // Scaled distance of the interpolated point from the leftmost column.
-      size_t cOrigin = (size_t) std::floor(j * scaleCol);
-      if (cOrigin > inColSize - 2)
-        cOrigin = inColSize - 2;
-
-      double deltaC = j * scaleCol - cOrigin;
-      if (deltaC > 1)
-        deltaC = 1.0;
-      coeffs[0] = (1 - deltaR) * (1 - deltaC);
-      coeffs[1] = deltaR * (1 - deltaC);
-      coeffs[2] = (1 - deltaR) * deltaC;
-      coeffs[3] = deltaR * deltaC;
-
-      for (size_t k = 0; k < depth * batchSize; k++)
-      {
-        outputAsCube(i, j, k) = arma::accu(inputAsCube.slice(k).submat(
-            rOrigin, cOrigin, rOrigin + 1, cOrigin + 1) % coeffs);
-      }
+      const eT* corner = in + forwardOffsets[p];
+      const double* coeffs = forwardWeights.colptr(p);
+      out[p] = coeffs[0] * corner[0] + coeffs[1] * corner[1] +
+          coeffs[2] * corner[inRowSize] + coeffs[3] * corner[inRowSize + 1];
     }
   }
 }
@@ -129,46 +109,77 @@ void BilinearInterpolation<InputDataType, OutputDataType>::Backward(
   assert(outRowSize >= 2);
   assert(outColSize >= 2);
 
-  arma::cube gradientAsCube(gradient.memptr(), outRowSize, outColSize,
-                            depth * batchSize, false, false);
-  arma::cube outputAsCube(output.memptr(), inRowSize, inColSize,
-                          depth * batchSize, false, true);
-
   if (gradient.n_elem == output.n_elem)
   {
-    outputAsCube = gradientAsCube;
+    std::copy(gradient.begin(), gradient.end(), output.begin());
+    return;
   }
-  else
+
+  if (backwardOffsets.n_elem != inRowSize * inColSize)
   {
-    double scaleRow = (double)(outRowSize) / inRowSize;
-    double scaleCol = (double)(outColSize) / inColSize;
+    InterpolationTable(outRowSize, outColSize, inRowSize, inColSize, false,
+        backwardOffsets, backwardWeights);
+  }
 
-    arma::mat22 coeffs;
-    for (size_t i = 0; i < inRowSize; i++)
+  const size_t inSlice = inRowSize * inColSize;
+  const size_t outSlice = outRowSize * outColSize;
+  for (size_t k = 0; k < depth * batchSize; k++)
+  {
+    const eT* in = gradient.memptr() + k * outSlice;
+    eT* out = output.memptr() + k * inSlice;
+    for (size_t p = 0; p < inSlice; p++)
+    {
+      const eT* corner = in + backwardOffsets[p];
+      const double* coeffs = backwardWeights.colptr(p);
+      out[p] = coeffs[0] * corner[0] + coeffs[1] * corner[1] +
+          coeffs[2] * corner[outRowSize] + coeffs[3] * corner[outRowSize + 1];
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void BilinearInterpolation<InputDataType, OutputDataType>::InterpolationTable(
+    const size_t sourceRows,
+    const size_t sourceCols,
+    const size_t targetRows,
+    const size_t targetCols,
+    const bool clamp,
+    arma::Col<size_t>& offsets,
+    arma::mat& weights)
+{
+  const double scaleRow = (double) sourceRows / (double) targetRows;
+  const double scaleCol = (double) sourceCols / (double) targetCols;
+
+  offsets.set_size(targetRows * targetCols);
+  weights.set_size(4, targetRows * targetCols);
+  for (size_t j = 0; j < targetCols; j++)
+  {
+    // Scaled distance of the interpolated point from the leftmost column.
+    size_t cOrigin = (size_t) std::floor(j * scaleCol);
+    if (cOrigin > sourceCols - 2)
+      cOrigin = sourceCols - 2;
+
+    double deltaC = j * scaleCol - cOrigin;
+    if (clamp && deltaC > 1)
+      deltaC = 1.0;
+
+    for (size_t i = 0; i < targetRows; i++)
     {
       size_t rOrigin = (size_t) std::floor(i * scaleRow);
-      if (rOrigin > outRowSize - 2)
-        rOrigin = outRowSize - 2;
+      if (rOrigin > sourceRows - 2)
+        rOrigin = sourceRows - 2;
+
+      // Scaled distance of the interpolated point from the topmost row.
       double deltaR = i * scaleRow - rOrigin;
-      for (size_t j = 0; j < inColSize; j++)
-      {
-        size_t cOrigin = (size_t) std::floor(j * scaleCol);
-
-        if (cOrigin > outColSize - 2)
-          cOrigin = outColSize - 2;
-
-        double deltaC = j * scaleCol - cOrigin;
-        coeffs[0] = (1 - deltaR) * (1 - deltaC);
-        coeffs[1] = deltaR * (1 - deltaC);
-        coeffs[2] = (1 - deltaR) * deltaC;
-        coeffs[3] = deltaR * deltaC;
-
-        for (size_t k = 0; k < depth * batchSize; k++)
-        {
-          outputAsCube(i, j, k) = arma::accu(gradientAsCube.slice(k).submat(
-              rOrigin, cOrigin, rOrigin + 1, cOrigin + 1) % coeffs);
-        }
-      }
+      if (clamp && deltaR > 1)
+        deltaR = 1.0;
+
+      const size_t p = i + j * targetRows;
+      offsets[p] = rOrigin + cOrigin * sourceRows;
+      weights(0, p) = (1 - deltaR) * (1 - deltaC);
+      weights(1, p) = deltaR * (1 - deltaC);
+      weights(2, p) = (1 - deltaR) * deltaC;
+      weights(3, p) = deltaR * deltaC;
     }
   }
 }
@@ -183,6 +194,13 @@ void BilinearInterpolation<InputDataType, OutputDataType>::serialize(
   ar & BOOST_SERIALIZATION_NVP(outRowSize);
   ar & BOOST_SERIALIZATION_NVP(outColSize);
   ar & BOOST_SERIALIZATION_NVP(depth);
+
+  // The sizes may have changed, so the tables have to be computed again.
+  if (Archive::is_loading::value)
+  {
+    forwardOffsets.reset();
+    backwardOffsets.reset();
+  }
 }
 
 } // namespace ann
@@ -158,6 +158,49 @@ class Concat
   void serialize(Archive& /* ar */, const unsigned int /* version */);
 
  private:
+  /**
+   * Point the matrix of every module given by the visitor (its output or its
+   * delta) at the column of the buffer that belongs to the module, so that
+   * the module writes its result straight into the buffer.  Matrices that
+   * don't fit into the buffer are released instead.
+   *
+   * @param visitor Visitor that returns the matrix of a module.
+   * @param buffer Matrix with one column per module.
+   */
+  template<typename VisitorType>
+  void BindColumns(VisitorType& visitor, arma::mat& buffer);
+
+  /**
+   * Merge the matrices of the modules given by the visitor into the columns
+   * of the buffer, zero padded to the largest matrix.  Only the matrices that
+   * the modules didn't write into the buffer are copied; the buffer is
+   * reallocated if the sizes changed.
+   *
+   * @param visitor Visitor that returns the matrix of a module.
+   * @param buffer Matrix with one column per module.
+   */
+  template<typename VisitorType>
+  void GatherColumns(VisitorType& visitor, arma::mat& buffer);
+
+  //! Copy the given matrix into column i of the buffer, with zero padding.
+  static void CopyColumn(const arma::mat& matrix,
+                         arma::mat& buffer,
+                         const size_t i);
+
+  /**
+   * Get an alias of the part of the error that belongs to module i.
+   *
+   * @param error The backpropagated error of all modules.
+   * @param i The index of the module.
+   * @param offset The number of elements of the modules before module i.
+   * @param elements The number of elements of the output of module i.
+   */
+  template<typename eT>
+  static arma::Mat<eT> Error(arma::Mat<eT>& error,
+                             const size_t i,
+                             const size_t offset,
+                             const size_t elements);
+
   //! Parameter which indicates if the modules should be exposed.
   bool model;
 
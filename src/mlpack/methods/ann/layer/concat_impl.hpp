@@ -45,39 +45,17 @@ template<typename eT>
 void Concat<InputDataType, OutputDataType, CustomLayers...>::Forward(
     arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
-  size_t outSize = 0;
+  // The layers write their outputs straight into their column of the output.
+  BindColumns(outputParameterVisitor, output);
 
   for (size_t i = 0; i < network.size(); ++i)
   {
     boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
         boost::apply_visitor(outputParameterVisitor, network[i]))),
         network[i]);
-
-    if (boost::apply_visitor(
-        outputParameterVisitor, network[i]).n_elem > outSize)
-    {
-      outSize = boost::apply_visitor(outputParameterVisitor,
-          network[i]).n_elem;
-    }
   }
 
-  output = arma::zeros(outSize, network.size());
-  for (size_t i = 0; i < network.size(); ++i)
-  {
-    size_t elements = boost::apply_visitor(outputParameterVisitor,
-        network[i]).n_elem;
-
-    if (elements < outSize)
-    {
-      output.submat(0, i, elements - 1, i) = arma::vectorise(
-          boost::apply_visitor(outputParameterVisitor, network[i]));
-    }
-    else
-    {
-      output.col(i) = arma::vectorise(boost::apply_visitor(
-        outputParameterVisitor, network[i]));
-    }
-  }
+  GatherColumns(outputParameterVisitor, output);
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -86,33 +64,20 @@ template<typename eT>
 void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  size_t outSize = 0;
-  size_t elements = 0;
+  if (!same)
+    BindColumns(deltaVisitor, g);
 
+  size_t elements = 0;
   for (size_t i = 0, j = 0; i < network.size(); ++i, j += elements)
   {
     elements = boost::apply_visitor(outputParameterVisitor,
         network[i]).n_elem;
 
-    arma::mat delta;
-    if (gy.n_cols == 1)
-    {
-      delta = gy.submat(j, 0, j + elements - 1, 0);
-    }
-    else
-    {
-      delta = gy.submat(0, i, elements - 1, i);
-    }
-
+    arma::mat delta = Error(gy, i, j, elements);
     boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
         outputParameterVisitor, network[i])), std::move(delta), std::move(
         boost::apply_visitor(deltaVisitor, network[i]))), network[i]);
 
-    if (boost::apply_visitor(deltaVisitor, network[i]).n_elem > outSize)
-    {
-      outSize = boost::apply_visitor(deltaVisitor, network[i]).n_elem;
-    }
-
     if (same)
     {
       if (i == 0)
@@ -127,23 +92,7 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
   }
 
   if (!same)
-  {
-    g = arma::zeros(outSize, network.size());
-    for (size_t i = 0; i < network.size(); ++i)
-    {
-      size_t elements = boost::apply_visitor(deltaVisitor, network[i]).n_elem;
-      if (elements < outSize)
-      {
-        g.submat(0, i, elements - 1, i) = arma::vectorise(
-            boost::apply_visitor(deltaVisitor, network[i]));
-      }
-      else
-      {
-        g.col(i) = arma::vectorise(
-            boost::apply_visitor(deltaVisitor, network[i]));
-      }
-    }
-  }
+    GatherColumns(deltaVisitor, g);
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -154,13 +103,114 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& /* gradient */)
 {
-  for (size_t i = 0; i < network.size(); ++i)
+  size_t elements = 0;
+  for (size_t i = 0, j = 0; i < network.size(); ++i, j += elements)
   {
+    elements = boost::apply_visitor(outputParameterVisitor,
+        network[i]).n_elem;
+
+    arma::mat branchError = Error(error, i, j, elements);
     boost::apply_visitor(GradientVisitor(std::move(input),
-        std::move(error)), network[i]);
+        std::move(branchError)), network[i]);
   }
 }
 
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+template<typename VisitorType>
+void Concat<InputDataType, OutputDataType, CustomLayers...>::BindColumns(
+    VisitorType& visitor, arma::mat& buffer)
+{
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    arma::mat& matrix = boost::apply_visitor(visitor, network[i]);
+    if (matrix.n_elem == 0)
+      continue;
+
+    if (buffer.n_cols != network.size() || matrix.n_elem > buffer.n_rows)
+    {
+      // The matrix may still point into a buffer that doesn't exist anymore,
+      // so the layer has to allocate its own memory again.
+      matrix.reset();
+    }
+    else if (matrix.memptr() != buffer.colptr(i))
+    {
+      matrix = arma::mat(buffer.colptr(i), matrix.n_rows, matrix.n_cols,
+          false, false);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+template<typename VisitorType>
+void Concat<InputDataType, OutputDataType, CustomLayers...>::GatherColumns(
+    VisitorType& visitor, arma::mat& buffer)
+{
+  size_t outSize = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    outSize = std::max(outSize,
+        (size_t) boost::apply_visitor(visitor, network[i]).n_elem);
+  }
+
+  if (buffer.n_rows != outSize || buffer.n_cols != network.size())
+  {
+    // The layers may still point into the old buffer, so it is only released
+    // once the new buffer is filled.
+    arma::mat merged = arma::zeros(outSize, network.size());
+    for (size_t i = 0; i < network.size(); ++i)
+      CopyColumn(boost::apply_visitor(visitor, network[i]), merged, i);
+
+    buffer = std::move(merged);
+  }
+  else
+  {
+    // Only the layers that replaced their matrix have to be copied.
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      const arma::mat& matrix = boost::apply_visitor(visitor, network[i]);
+      if (matrix.memptr() != buffer.colptr(i))
+        CopyColumn(matrix, buffer, i);
+    }
+  }
+
+  BindColumns(visitor, buffer);
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+void Concat<InputDataType, OutputDataType, CustomLayers...>::CopyColumn(
+    const arma::mat& matrix, arma::mat& buffer, const size_t i)
+{
+  if (matrix.n_elem > 0)
+  {
+    buffer.submat(0, i, matrix.n_elem - 1, i) = arma::vectorise(matrix);
+  }
+
+  if (matrix.n_elem < buffer.n_rows)
+  {
+    buffer.submat(matrix.n_elem, i, buffer.n_rows - 1, i).zeros();
+  }
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+template<typename eT>
+arma::Mat<eT> Concat<InputDataType, OutputDataType, CustomLayers...>::Error(
+    arma::Mat<eT>& error,
+    const size_t i,
+    const size_t offset,
+    const size_t elements)
+{
+  // A single column holds the errors of all layers one after the other,
+  // otherwise every layer has its own column.
+  if (error.n_cols == 1)
+    return arma::Mat<eT>(error.memptr() + offset, elements, 1, false, true);
+
+  return arma::Mat<eT>(error.colptr(i), elements, 1, false, true);
+}
+
 template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 template<typename Archive>
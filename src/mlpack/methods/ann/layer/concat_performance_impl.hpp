@@ -51,7 +51,9 @@ double ConcatPerformance<
   double output = 0;
   for (size_t i = 0; i < input.n_elem; i+= elements)
   {
-    arma::mat subInput = input.submat(i, 0, i + elements - 1, 0);
+    // The segments are contiguous, so they are evaluated in place.
+    arma::Mat<eT> subInput(const_cast<eT*>(input.memptr()) + i, elements, 1,
+        false, true);
     output += outputLayer.Forward(std::move(subInput), std::move(target));
   }
 
@@ -75,22 +77,19 @@ void ConcatPerformance<
 {
   const size_t elements = input.n_elem / inSize;
 
-  arma::mat subInput = input.submat(0, 0, elements - 1, 0);
-  arma::mat subOutput;
-
-  outputLayer.Backward(std::move(subInput), std::move(target),
-      std::move(subOutput));
-
-  output = arma::zeros(subOutput.n_elem, inSize);
-  output.col(0) = subOutput;
-
-  for (size_t i = elements, j = 0; i < input.n_elem; i+= elements, j++)
+  output.set_size(elements, inSize);
+  for (size_t i = 0, j = 0; i < input.n_elem; i+= elements, j++)
   {
-    subInput = input.submat(i, 0, i + elements - 1, 0);
+    // The gradient of every segment is written straight into its column of
+    // the output; it is only copied if the output layer replaced the matrix.
+    arma::Mat<eT> subInput(const_cast<eT*>(input.memptr()) + i, elements, 1,
+        false, true);
+    arma::Mat<eT> subOutput(output.colptr(j), elements, 1, false, false);
     outputLayer.Backward(std::move(subInput), std::move(target),
-      std::move(subOutput));
+        std::move(subOutput));
 
-    output.col(j) = subOutput;
+    if (subOutput.memptr() != output.colptr(j))
+      output.col(j) = arma::vectorise(subOutput);
   }
 }
 
@@ -50,7 +50,12 @@ void Concatenate<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& gy,
     arma::Mat<eT>&& g)
 {
-  g = gy.submat(0, 0, inRows - 1, concat.n_cols - 1);
+  // With a single column the error of the input is contiguous, so g can point
+  // at it; the rows of several columns are strided and have to be copied.
+  if (gy.n_cols == 1)
+    g = arma::Mat<eT>(const_cast<eT*>(gy.memptr()), inRows, 1, false, false);
+  else
+    g = gy.submat(0, 0, inRows - 1, concat.n_cols - 1);
 }
 
 } // namespace ann
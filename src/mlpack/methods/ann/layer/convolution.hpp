@@ -18,6 +18,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include "layer_types.hpp"
 
@@ -28,6 +29,10 @@ namespace ann /** Artificial Neural Network. */ {
  * Implementation of the Convolution class. The Convolution class represents a
  * single layer of a neural network.
  *
+ * If all three rules are Im2ColConvolution, the whole batch is convolved with
+ * one matrix multiplication per pass instead of one 2-D convolution per pair
+ * of maps.
+ *
  * @tparam ForwardConvolutionRule Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Convolution to perform backward process.
  * @tparam GradientConvolutionRule Convolution to calculate gradient.
@@ -161,6 +166,30 @@ class Convolution
   //! Modify the output height.
   size_t& OutputHeight() { return outputHeight; }
 
+  //! Get the number of input maps.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the number of output maps.
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the width of the filter/kernel.
+  size_t KernelWidth() const { return kW; }
+
+  //! Get the height of the filter/kernel.
+  size_t KernelHeight() const { return kH; }
+
+  //! Get the stride of the filter in x-direction.
+  size_t StrideWidth() const { return dW; }
+
+  //! Get the stride of the filter in y-direction.
+  size_t StrideHeight() const { return dH; }
+
+  //! Get the padding width.
+  size_t PadWidth() const { return padW; }
+
+  //! Get the padding height.
+  size_t PadHeight() const { return padH; }
+
   /**
    * Serialize the layer
    */
@@ -168,6 +197,68 @@ class Convolution
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /*
+   * Convolve the given (padded) input with the filters and store the result
+   * in outputTemp, one pair of maps at a time.
+   *
+   * @param input The (padded) input maps.
+   */
+  template<typename eT, typename Rule = ForwardConvolutionRule>
+  typename std::enable_if<!IsBatchConvolutionRule<Rule>::value, void>::type
+  ForwardConvolution(const arma::Cube<eT>& input);
+
+  /*
+   * Convolve the given (padded) input with the filters and store the result
+   * in outputTemp, for all maps at once.
+   *
+   * @param input The (padded) input maps.
+   */
+  template<typename eT, typename Rule = ForwardConvolutionRule>
+  typename std::enable_if<IsBatchConvolutionRule<Rule>::value, void>::type
+  ForwardConvolution(const arma::Cube<eT>& input);
+
+  /*
+   * Propagate the given error back to the input and store the result in
+   * gTemp, one pair of maps at a time.
+   *
+   * @param error The backpropagated error.
+   */
+  template<typename eT, typename Rule = BackwardConvolutionRule>
+  typename std::enable_if<!IsBatchConvolutionRule<Rule>::value, void>::type
+  BackwardConvolution(const arma::Cube<eT>& error);
+
+  /*
+   * Propagate the given error back to the input and store the result in
+   * gTemp, for all maps at once.
+   *
+   * @param error The backpropagated error.
+   */
+  template<typename eT, typename Rule = BackwardConvolutionRule>
+  typename std::enable_if<IsBatchConvolutionRule<Rule>::value, void>::type
+  BackwardConvolution(const arma::Cube<eT>& error);
+
+  /*
+   * Calculate the gradient of the filters and store it in gradientTemp, one
+   * pair of maps at a time.
+   *
+   * @param input The (padded) input maps.
+   * @param error The calculated error.
+   */
+  template<typename eT, typename Rule = GradientConvolutionRule>
+  typename std::enable_if<!IsBatchConvolutionRule<Rule>::value, void>::type
+  GradientConvolution(const arma::Cube<eT>& input, const arma::Cube<eT>& error);
+
+  /*
+   * Calculate the gradient of the filters and store it in gradientTemp, for
+   * all maps at once.
+   *
+   * @param input The (padded) input maps.
+   * @param error The calculated error.
+   */
+  template<typename eT, typename Rule = GradientConvolutionRule>
+  typename std::enable_if<IsBatchConvolutionRule<Rule>::value, void>::type
+  GradientConvolution(const arma::Cube<eT>& input, const arma::Cube<eT>& error);
+
   /*
    * Return the convolution output size.
    *
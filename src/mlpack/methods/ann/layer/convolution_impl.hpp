@@ -130,35 +130,10 @@ void Convolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
-  {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
-
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> convOutput;
-
-      if (padW != 0 || padH != 0)
-      {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH);
-      }
-      else
-      {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH);
-      }
-
-      outputTemp.slice(outMap) += convOutput;
-    }
+  ForwardConvolution((padW != 0 || padH != 0) ? inputPaddedTemp : inputTemp);
 
+  for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
     outputTemp.slice(outMap) += bias(outMap % outSize);
-  }
 
   outputWidth = outputTemp.n_rows;
   outputHeight = outputTemp.n_cols;
@@ -189,6 +164,120 @@ void Convolution<
       inputTemp.n_cols, inputTemp.n_slices, false, false);
   gTemp.zeros();
 
+  BackwardConvolution(mappedError);
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::Gradient(
+    const arma::Mat<eT>&& /* input */,
+    arma::Mat<eT>&& error,
+    arma::Mat<eT>&& gradient)
+{
+  arma::cube mappedError(error.memptr(), outputWidth,
+      outputHeight, outSize * batchSize, false, false);
+
+  gradient.zeros(weights.n_elem, 1);
+  gradientTemp = arma::Cube<eT>(gradient.memptr(), weight.n_rows,
+      weight.n_cols, weight.n_slices, false, false);
+
+  GradientConvolution((padW != 0 || padH != 0) ? inputPaddedTemp : inputTemp,
+      mappedError);
+
+  // The bias gradient is the sum of the error over all samples.
+  for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
+  {
+    gradient(weight.n_elem + (outMap % outSize)) +=
+        arma::accu(mappedError.slice(outMap));
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT, typename Rule>
+typename std::enable_if<!IsBatchConvolutionRule<Rule>::value, void>::type
+Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardConvolution(const arma::Cube<eT>& input)
+{
+  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
+      outSize * batchSize; outMap++)
+  {
+    if (outMap != 0 && outMap % outSize == 0)
+    {
+      batchCount++;
+      outMapIdx = 0;
+    }
+
+    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    {
+      arma::Mat<eT> convOutput;
+      ForwardConvolutionRule::Convolution(input.slice(inMap +
+          batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH);
+
+      outputTemp.slice(outMap) += convOutput;
+    }
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT, typename Rule>
+typename std::enable_if<IsBatchConvolutionRule<Rule>::value, void>::type
+Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardConvolution(const arma::Cube<eT>& input)
+{
+  ForwardConvolutionRule::Forward(input, weight, outputTemp, inSize, dW, dH);
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT, typename Rule>
+typename std::enable_if<!IsBatchConvolutionRule<Rule>::value, void>::type
+Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::BackwardConvolution(const arma::Cube<eT>& error)
+{
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -203,7 +292,7 @@ void Convolution<
       arma::Mat<eT> output, rotatedFilter;
       Rotate180(weight.slice(outMapIdx), rotatedFilter);
 
-      BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
+      BackwardConvolutionRule::Convolution(error.slice(outMap),
           rotatedFilter, output, dW, dH);
 
       if (padW != 0 || padH != 0)
@@ -227,26 +316,51 @@ template<
     typename InputDataType,
     typename OutputDataType
 >
-template<typename eT>
-void Convolution<
+template<typename eT, typename Rule>
+typename std::enable_if<IsBatchConvolutionRule<Rule>::value, void>::type
+Convolution<
     ForwardConvolutionRule,
     BackwardConvolutionRule,
     GradientConvolutionRule,
     InputDataType,
     OutputDataType
->::Gradient(
-    const arma::Mat<eT>&& /* input */,
-    arma::Mat<eT>&& error,
-    arma::Mat<eT>&& gradient)
+>::BackwardConvolution(const arma::Cube<eT>& error)
 {
-  arma::cube mappedError(error.memptr(), outputWidth,
-      outputHeight, outSize * batchSize, false, false);
-
-  gradient.set_size(weights.n_elem, 1);
-  gradientTemp = arma::Cube<eT>(gradient.memptr(), weight.n_rows,
-      weight.n_cols, weight.n_slices, false, false);
-  gradientTemp.zeros();
+  if (padW != 0 || padH != 0)
+  {
+    // The gradient is computed for the padded input, and the padding is then
+    // removed.
+    arma::Cube<eT> paddedG(inputPaddedTemp.n_rows, inputPaddedTemp.n_cols,
+        inputPaddedTemp.n_slices);
+    BackwardConvolutionRule::Backward(error, weight, paddedG, inSize, dW, dH);
+
+    gTemp = paddedG.tube(padW, padH, padW + gTemp.n_rows - 1,
+        padH + gTemp.n_cols - 1);
+  }
+  else
+  {
+    BackwardConvolutionRule::Backward(error, weight, gTemp, inSize, dW, dH);
+  }
+}
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT, typename Rule>
+typename std::enable_if<!IsBatchConvolutionRule<Rule>::value, void>::type
+Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::GradientConvolution(const arma::Cube<eT>& input,
+                       const arma::Cube<eT>& error)
+{
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -258,21 +372,9 @@ void Convolution<
 
     for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
     {
-      arma::Mat<eT> inputSlice;
-      if (padW != 0 || padH != 0)
-      {
-        inputSlice = inputPaddedTemp.slice(inMap + batchCount * inSize);
-      }
-      else
-      {
-        inputSlice = inputTemp.slice(inMap + batchCount * inSize);
-      }
-
-      arma::Mat<eT> deltaSlice = mappedError.slice(outMap);
-
       arma::Mat<eT> output;
-      GradientConvolutionRule::Convolution(inputSlice, deltaSlice,
-          output, dW, dH);
+      GradientConvolutionRule::Convolution(input.slice(inMap +
+          batchCount * inSize), error.slice(outMap), output, dW, dH);
 
       if (gradientTemp.n_rows < output.n_rows ||
           gradientTemp.n_cols < output.n_cols)
@@ -291,12 +393,31 @@ void Convolution<
         gradientTemp.slice(outMapIdx) += output;
       }
     }
-
-    gradient.submat(weight.n_elem + (outMap % outSize), 0, weight.n_elem +
-        (outMap % outSize), 0) = arma::accu(mappedError.slice(outMap));
   }
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT, typename Rule>
+typename std::enable_if<IsBatchConvolutionRule<Rule>::value, void>::type
+Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::GradientConvolution(const arma::Cube<eT>& input,
+                       const arma::Cube<eT>& error)
+{
+  GradientConvolutionRule::Gradient(input, error, gradientTemp, inSize, dW,
+      dH);
+}
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_DROPOUT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -131,6 +132,22 @@ class Dropout
   bool deterministic;
 }; // class Dropout
 
+/**
+ * Dropout is elementwise, and its Backward() function only uses the mask.
+ */
+template<typename InputDataType, typename OutputDataType>
+class LayerTraits<Dropout<InputDataType, OutputDataType>>
+{
+ public:
+  static const bool IsBinary = false;
+  static const bool IsOutputLayer = false;
+  static const bool IsBiasLayer = false;
+  static const bool IsLSTMLayer = false;
+  static const bool IsConnection = false;
+  static const bool IsInPlace = true;
+  static const bool BackwardUsesOutput = false;
+};
+
 } // namespace ann
 } // namespace mlpack
 
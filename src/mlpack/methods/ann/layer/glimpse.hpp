@@ -267,24 +267,48 @@ class Glimpse
   }
 
   /**
-   * Apply ReSampling to the input and store the results in the output
-   * parameter.
+   * Compute the table used to resample an image with the given number of rows
+   * and columns to a size x size image: for every output pixel, the offsets of
+   * its 4 nearest neighbors in a matrix with the given number of rows, and the
+   * surfaces to each neighbor.  The table is only computed again if the sizes
+   * changed.
    *
-   * @param input The input to be apply the ReSampling rule.
-   * @param output The pooled result.
+   * @param rows Number of rows of the image the ratios are computed for.
+   * @param cols Number of columns of the image the ratios are computed for.
+   * @param stride Number of rows of the matrix the offsets index into.
+   * @param shape The sizes the table was computed for.
+   * @param offsets The offsets, one column per output pixel.
+   * @param weights The surfaces, one column per output pixel.
    */
-  template<typename eT>
-  void ReSampling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+  void ReSamplingTable(const size_t rows,
+                       const size_t cols,
+                       const size_t stride,
+                       arma::Col<size_t>& shape,
+                       arma::Mat<size_t>& offsets,
+                       arma::mat& weights)
   {
-    double wRatio = (double) (input.n_rows - 1) / (size - 1);
-    double hRatio = (double) (input.n_cols - 1) / (size - 1);
+    if (shape.n_elem == 3 && shape[0] == rows && shape[1] == cols &&
+        shape[2] == stride && offsets.n_cols == size * size)
+    {
+      return;
+    }
 
-    double iWidth = input.n_rows - 1;
-    double iHeight = input.n_cols - 1;
+    shape.set_size(3);
+    shape[0] = rows;
+    shape[1] = cols;
+    shape[2] = stride;
 
-    for (size_t y = 0; y < size; y++)
+    double wRatio = (double) (rows - 1) / (size - 1);
+    double hRatio = (double) (cols - 1) / (size - 1);
+
+    double iWidth = rows - 1;
+    double iHeight = cols - 1;
+
+    offsets.set_size(4, size * size);
+    weights.set_size(4, size * size);
+    for (size_t x = 0, p = 0; x < size; x++)
     {
-      for (size_t x = 0; x < size; x++)
+      for (size_t y = 0; y < size; y++, p++)
       {
         double ix = wRatio * x;
         double iy = hRatio * y;
@@ -295,21 +319,51 @@ class Glimpse
         double ixNe = ixNw + 1;
         double iySw = iyNw + 1;
 
+        const size_t top = (size_t) iyNw;
+        const size_t bottom = (size_t) std::min(iySw, iHeight);
+        const size_t left = (size_t) ixNw * stride;
+        const size_t right = (size_t) std::min(ixNe, iWidth) * stride;
+
+        offsets(0, p) = top + left;
+        offsets(1, p) = top + right;
+        offsets(2, p) = bottom + left;
+        offsets(3, p) = bottom + right;
+
         // Get surfaces to each neighbor.
-        double se = (ix - ixNw) * (iy - iyNw);
-        double sw = (ixNe - ix) * (iy - iyNw);
-        double ne = (ix - ixNw) * (iySw - iy);
-        double nw = (ixNe - ix) * (iySw - iy);
-
-        // Calculate the weighted sum.
-        output(y, x) = input(iyNw, ixNw) * nw +
-            input(iyNw, std::min(ixNe,  iWidth)) * ne +
-            input(std::min(iySw, iHeight), ixNw) * sw +
-            input(std::min(iySw, iHeight), std::min(ixNe, iWidth)) * se;
+        weights(0, p) = (ixNe - ix) * (iySw - iy);
+        weights(1, p) = (ix - ixNw) * (iySw - iy);
+        weights(2, p) = (ixNe - ix) * (iy - iyNw);
+        weights(3, p) = (ix - ixNw) * (iy - iyNw);
       }
     }
   }
 
+  /**
+   * Apply ReSampling to the input and store the results in the output
+   * parameter.
+   *
+   * @param input The input to be apply the ReSampling rule.
+   * @param output The pooled result.
+   */
+  template<typename eT>
+  void ReSampling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+  {
+    ReSamplingTable(input.n_rows, input.n_cols, input.n_rows, reSamplingShape,
+        reSamplingOffsets, reSamplingWeights);
+
+    const eT* in = input.memptr();
+    eT* out = output.memptr();
+    for (size_t p = 0; p < size * size; p++)
+    {
+      const size_t* offset = reSamplingOffsets.colptr(p);
+      const double* weight = reSamplingWeights.colptr(p);
+
+      // Calculate the weighted sum.
+      out[p] = in[offset[0]] * weight[0] + in[offset[1]] * weight[1] +
+          in[offset[2]] * weight[2] + in[offset[3]] * weight[3];
+    }
+  }
+
   /**
    * Apply DownwardReSampling to the input and store the results into the output
    * parameter.
@@ -323,41 +377,84 @@ class Glimpse
                           const arma::Mat<eT>& error,
                           arma::Mat<eT>& output)
   {
-    double iWidth = input.n_rows - 1;
-    double iHeight = input.n_cols - 1;
+    ReSamplingTable(input.n_rows, input.n_cols, output.n_rows,
+        downwardReSamplingShape, downwardReSamplingOffsets,
+        downwardReSamplingWeights);
 
-    double wRatio = iWidth / (size - 1);
-    double hRatio = iHeight / (size - 1);
-
-    for (size_t y = 0; y < size; y++)
+    const eT* grad = error.memptr();
+    eT* out = output.memptr();
+    for (size_t p = 0; p < size * size; p++)
     {
-      for (size_t x = 0; x < size; x++)
-      {
-        double ix = wRatio * x;
-        double iy = hRatio * y;
+      const size_t* offset = downwardReSamplingOffsets.colptr(p);
+      const double* weight = downwardReSamplingWeights.colptr(p);
+      const double ograd = grad[p];
+
+      out[offset[0]] += weight[0] * ograd;
+      out[offset[1]] += weight[1] * ograd;
+      out[offset[2]] += weight[2] * ograd;
+      out[offset[3]] += weight[3] * ograd;
+    }
+  }
 
-        // Get the 4 nearest neighbors.
-        double ixNw = std::floor(ix);
-        double iyNw = std::floor(iy);
-        double ixNe = ixNw + 1;
-        double iySw = iyNw + 1;
+  /**
+   * Crop the glimpseSize x glimpseSize patch at (x, y) of the given slice
+   * padded with padSize zeros on every side.
+   *
+   * @param slice The slice to crop from.
+   * @param padSize The padding of the slice.
+   * @param x The first row of the patch in the padded slice.
+   * @param y The first column of the patch in the padded slice.
+   * @param glimpseSize The size of the patch.
+   * @param patch The cropped patch.
+   */
+  template<typename eT>
+  void Crop(const arma::Mat<eT>& slice,
+            const size_t padSize,
+            const size_t x,
+            const size_t y,
+            const size_t glimpseSize,
+            arma::Mat<eT>& patch)
+  {
+    patch.zeros(glimpseSize, glimpseSize);
 
-        // Get surfaces to each neighbor.
-        double se = (ix - ixNw) * (iy - iyNw);
-        double sw = (ixNe - ix) * (iy - iyNw);
-        double ne = (ix - ixNw) * (iySw - iy);
-        double nw = (ixNe - ix) * (iySw - iy);
-
-        double ograd = error(y, x);
-
-        output(iyNw, ixNw) = output(iyNw, ixNw) + nw * ograd;
-        output(iyNw, std::min(ixNe, iWidth)) = output(iyNw,
-            std::min(ixNe, iWidth)) + ne * ograd;
-        output(std::min(iySw, iHeight), ixNw) = output(std::min(iySw, iHeight),
-            ixNw) + sw * ograd;
-        output(std::min(iySw, iHeight), std::min(ixNe, iWidth)) = output(
-            std::min(iySw, iHeight), std::min(ixNe, iWidth)) + se * ograd;
-      }
+    const size_t rowBegin = std::max(x, padSize);
+    const size_t rowEnd = std::min(x + glimpseSize, padSize + slice.n_rows);
+    const size_t colBegin = std::max(y, padSize);
+    const size_t colEnd = std::min(y + glimpseSize, padSize + slice.n_cols);
+    if (rowBegin < rowEnd && colBegin < colEnd)
+    {
+      patch.submat(rowBegin - x, colBegin - y, rowEnd - x - 1,
+          colEnd - y - 1) = slice.submat(rowBegin - padSize,
+          colBegin - padSize, rowEnd - padSize - 1, colEnd - padSize - 1);
+    }
+  }
+
+  /**
+   * Add the patch at (x, y) of the given slice padded with padSize zeros on
+   * every side to the slice; the part of the patch in the padding is dropped.
+   *
+   * @param patch The patch to add.
+   * @param padSize The padding of the slice.
+   * @param x The first row of the patch in the padded slice.
+   * @param y The first column of the patch in the padded slice.
+   * @param slice The slice to add the patch to.
+   */
+  template<typename eT>
+  void AddPatch(const arma::Mat<eT>& patch,
+                const size_t padSize,
+                const size_t x,
+                const size_t y,
+                arma::Mat<eT>& slice)
+  {
+    const size_t rowBegin = std::max(x, padSize);
+    const size_t rowEnd = std::min(x + patch.n_rows, padSize + slice.n_rows);
+    const size_t colBegin = std::max(y, padSize);
+    const size_t colEnd = std::min(y + patch.n_cols, padSize + slice.n_cols);
+    if (rowBegin < rowEnd && colBegin < colEnd)
+    {
+      slice.submat(rowBegin - padSize, colBegin - padSize,
+          rowEnd - padSize - 1, colEnd - padSize - 1) += patch.submat(
+          rowBegin - x, colBegin - y, rowEnd - x - 1, colEnd - y - 1);
     }
   }
 
@@ -414,6 +511,24 @@ class Glimpse
 
   //! If true use maximum a posteriori during the forward pass.
   bool deterministic;
+
+  //! Locally-stored sizes the resampling table was computed for.
+  arma::Col<size_t> reSamplingShape;
+
+  //! Locally-stored offsets of the neighbors of every resampled pixel.
+  arma::Mat<size_t> reSamplingOffsets;
+
+  //! Locally-stored surfaces to the neighbors of every resampled pixel.
+  arma::mat reSamplingWeights;
+
+  //! Locally-stored sizes the downward resampling table was computed for.
+  arma::Col<size_t> downwardReSamplingShape;
+
+  //! Locally-stored offsets of the neighbors of every resampled error.
+  arma::Mat<size_t> downwardReSamplingOffsets;
+
+  //! Locally-stored surfaces to the neighbors of every resampled error.
+  arma::mat downwardReSamplingWeights;
 }; // class GlimpseLayer
 
 } // namespace ann
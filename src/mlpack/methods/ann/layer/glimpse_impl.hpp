@@ -66,17 +66,10 @@ void Glimpse<InputDataType, OutputDataType>::Forward(
     {
       size_t padSize = std::floor((glimpseSize - 1) / 2);
 
-      arma::Cube<eT> inputPadded = arma::zeros<arma::Cube<eT> >(
-          inputTemp.n_rows + padSize * 2, inputTemp.n_cols + padSize * 2,
-          inputTemp.n_slices / inSize);
-
-      inputPadded.tube(padSize, padSize, padSize + inputTemp.n_rows - 1,
-          padSize + inputTemp.n_cols - 1) = inputTemp.subcube(0, 0,
-          inputIdx * inputDepth, inputTemp.n_rows - 1, inputTemp.n_cols - 1,
-          (inputIdx + 1) * inputDepth - 1);
-
-      size_t h = inputPadded.n_rows - glimpseSize;
-      size_t w = inputPadded.n_cols - glimpseSize;
+      // The patches are cropped straight from the input; the parts that fall
+      // into the zero padding are left zero.
+      size_t h = inputTemp.n_rows + padSize * 2 - glimpseSize;
+      size_t w = inputTemp.n_cols + padSize * 2 - glimpseSize;
 
       size_t x = std::min(h, (size_t) std::max(0.0,
           (location(0, inputIdx) + 1) / 2.0 * h));
@@ -88,9 +81,8 @@ void Glimpse<InputDataType, OutputDataType>::Forward(
         for (size_t j = (inputIdx + depthIdx), paddedSlice = 0;
             j < outputTemp.n_slices; j += (inSize * depth), paddedSlice++)
         {
-          outputTemp.slice(j) = inputPadded.subcube(x, y,
-              paddedSlice, x + glimpseSize - 1, y + glimpseSize - 1,
-              paddedSlice);
+          Crop(inputTemp.slice(inputIdx * inputDepth + paddedSlice), padSize,
+              x, y, glimpseSize, outputTemp.slice(j));
         }
       }
       else
@@ -98,9 +90,9 @@ void Glimpse<InputDataType, OutputDataType>::Forward(
         for (size_t j = (inputIdx + depthIdx * (depth - 1)), paddedSlice = 0;
             j < outputTemp.n_slices; j += (inSize * depth), paddedSlice++)
         {
-          arma::Mat<eT> poolingInput = inputPadded.subcube(x, y,
-              paddedSlice, x + glimpseSize - 1, y + glimpseSize - 1,
-              paddedSlice);
+          arma::Mat<eT> poolingInput;
+          Crop(inputTemp.slice(inputIdx * inputDepth + paddedSlice), padSize,
+              x, y, glimpseSize, poolingInput);
 
           if (scale == 2)
           {
@@ -157,12 +149,10 @@ void Glimpse<InputDataType, OutputDataType>::Backward(
     {
       size_t padSize = std::floor((glimpseSize - 1) / 2);
 
-      arma::Cube<eT> inputPadded = arma::zeros<arma::Cube<eT> >(
-          inputTemp.n_rows + padSize * 2, inputTemp.n_cols +
-          padSize * 2, inputTemp.n_slices / inSize);
-
-      size_t h = inputPadded.n_rows - glimpseSize;
-      size_t w = inputPadded.n_cols - glimpseSize;
+      // The errors of the patches are added straight to the input gradient;
+      // the parts that fall into the zero padding are dropped.
+      size_t h = inputTemp.n_rows + padSize * 2 - glimpseSize;
+      size_t w = inputTemp.n_cols + padSize * 2 - glimpseSize;
 
       size_t x = std::min(h, (size_t) std::max(0.0,
           (location(0, inputIdx) + 1) / 2.0 * h));
@@ -174,9 +164,8 @@ void Glimpse<InputDataType, OutputDataType>::Backward(
         for (size_t j = (inputIdx + depthIdx), paddedSlice = 0;
             j < mappedError.n_slices; j += (inSize * depth), paddedSlice++)
         {
-          inputPadded.subcube(x, y,
-              paddedSlice, x + glimpseSize - 1, y + glimpseSize - 1,
-              paddedSlice) = mappedError.slice(j);
+          AddPatch(mappedError.slice(j), padSize, x, y,
+              gTemp.slice(inputIdx * inputDepth + paddedSlice));
         }
       }
       else
@@ -184,9 +173,8 @@ void Glimpse<InputDataType, OutputDataType>::Backward(
         for (size_t j = (inputIdx + depthIdx * (depth - 1)), paddedSlice = 0;
             j < mappedError.n_slices; j += (inSize * depth), paddedSlice++)
         {
-          arma::Mat<eT> poolingOutput = inputPadded.subcube(x, y,
-               paddedSlice, x + glimpseSize - 1, y + glimpseSize - 1,
-               paddedSlice);
+          arma::Mat<eT> poolingOutput = arma::zeros<arma::Mat<eT> >(
+              glimpseSize, glimpseSize);
 
           if (scale == 2)
           {
@@ -199,14 +187,10 @@ void Glimpse<InputDataType, OutputDataType>::Backward(
                 mappedError.slice(j), poolingOutput);
           }
 
-          inputPadded.subcube(x, y,
-              paddedSlice, x + glimpseSize - 1, y + glimpseSize - 1,
-              paddedSlice) = poolingOutput;
+          AddPatch(poolingOutput, padSize, x, y,
+              gTemp.slice(inputIdx * inputDepth + paddedSlice));
         }
       }
-
-      gTemp += inputPadded.tube(padSize, padSize, padSize +
-          inputTemp.n_rows - 1, padSize + inputTemp.n_cols - 1);
     }
   }
 
@@ -0,0 +1,268 @@
+/**
+ * @file hierarchical_softmax.hpp
+ *
+ * Definition of the HierarchicalSoftmax layer, which computes the probability
+ * of a class as a product of binary decisions along a tree of the classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_HIERARCHICAL_SOFTMAX_HPP
+#define MLPACK_METHODS_ANN_LAYER_HIERARCHICAL_SOFTMAX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The hierarchical softmax layer replaces a linear layer and a log softmax over
+ * a large number of classes by a binary tree with the classes at the leaves.
+ * Every inner node n of the tree has a weight vector v_n and a bias, and the
+ * probability of going to its left child is sigma(v_n^T x + b_n); the
+ * probability of a class is the product of the probabilities of the decisions
+ * on the path from the root to it.  The probabilities of all classes sum to
+ * one, and the loss and gradient of a point only involve the O(log classes)
+ * nodes on the path of its target.  For more information, see
+ *
+ * @code
+ * @inproceedings{morin2005hierarchical,
+ *   title     = {Hierarchical Probabilistic Neural Network Language Model},
+ *   author    = {Morin, Frederic and Bengio, Yoshua},
+ *   booktitle = {Proceedings of the Tenth International Workshop on Artificial
+ *                Intelligence and Statistics},
+ *   pages     = {246--252},
+ *   year      = {2005}
+ * }
+ * @endcode
+ *
+ * The tree is the Huffman tree of the given class frequencies, so frequent
+ * classes get short paths (as in word2vec); without frequencies it is a
+ * balanced tree.  A custom tree can be given by its inner nodes.
+ *
+ * In deterministic mode (FFN::Predict()) the layer outputs the
+ * log-probabilities of all classes.  During training it outputs the negative
+ * log likelihood of the target of every point, as a row vector, so the network
+ * has to use the LargeSoftmaxLoss output layer.  The layer needs the targets in
+ * the forward pass; FFN passes them before every training step.
+ *
+ * The weights of an inner node are stored in one column of the parameters,
+ * followed by its bias, so that the parameters form a
+ * (inSize + 1) x (numClasses - 1) matrix.
+ *
+ * The layer is not part of LayerTypes, so it has to be given as a custom layer
+ * of the network:
+ *
+ * @code
+ * FFN<LargeSoftmaxLoss<>, RandomInitialization, HierarchicalSoftmax<>> model;
+ * model.Add<Linear<>>(inputSize, hiddenSize);
+ * ...
+ * model.Add<HierarchicalSoftmax<>>(hiddenSize, numClasses, frequencies);
+ * @endcode
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class HierarchicalSoftmax
+{
+ public:
+  //! Create the HierarchicalSoftmax object.
+  HierarchicalSoftmax();
+
+  /**
+   * Create the HierarchicalSoftmax layer object with the Huffman tree of the
+   * given class frequencies.
+   *
+   * @param inSize The number of input units.
+   * @param numClasses The number of classes.
+   * @param frequencies The frequencies of the classes; if empty, the tree is
+   *     balanced.
+   */
+  HierarchicalSoftmax(const size_t inSize,
+                      const size_t numClasses,
+                      const arma::vec& frequencies = arma::vec());
+
+  /**
+   * Create the HierarchicalSoftmax layer object with the given tree.  Node ids
+   * below numClasses are the classes (the leaves), and id numClasses + k is
+   * column k of children; the children of an inner node have to be created
+   * before it, so the root is the last column.
+   *
+   * @param inSize The number of input units.
+   * @param children The left (first row) and right (second row) children of
+   *     the numClasses - 1 inner nodes.
+   */
+  HierarchicalSoftmax(const size_t inSize, const arma::Mat<size_t>& children);
+
+  /**
+   * Ordinary feed forward pass of a neural network.  In deterministic mode the
+   * output holds the log-probabilities of all classes, otherwise the negative
+   * log likelihood of the target of every point.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, using the decisions of
+   * the last (training) forward pass.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>&& /* input */,
+                arma::Mat<eT>&& gy,
+                arma::Mat<eT>&& g);
+
+  /*
+   * Calculate the gradient of the weights of the nodes on the paths of the
+   * targets; this has to follow Backward().
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>&& input,
+                arma::Mat<eT>&& /* error */,
+                arma::Mat<eT>&& gradient);
+
+  //! Get the parameters.
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the targets of the batch.
+  arma::mat const& Target() const { return target; }
+  //! Modify the targets of the batch.
+  arma::mat& Target() { return target; }
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return gradient; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return gradient; }
+
+  //! The value of the deterministic parameter.
+  bool Deterministic() const { return deterministic; }
+  //! Modify the value of the deterministic parameter.
+  bool& Deterministic() { return deterministic; }
+
+  //! Get the number of input units.
+  size_t InputSize() const { return inSize; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Get the children of the inner nodes of the tree.
+  const arma::Mat<size_t>& Children() const { return children; }
+  //! Get the length of the path of the given class.
+  size_t PathLength(const size_t c) const
+  { return pathStart[c + 1] - pathStart[c]; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Build the Huffman tree of the given frequencies.
+  void BuildTree(const arma::vec& frequencies);
+
+  //! Compute the path of every class from the tree.
+  void BuildPaths();
+
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of classes.
+  size_t numClasses;
+
+  //! The children of the inner nodes.
+  arma::Mat<size_t> children;
+
+  //! The first entry of the path of every class in pathNodes and pathLeft.
+  arma::Col<size_t> pathStart;
+
+  //! The inner nodes on the paths of the classes.
+  arma::Col<size_t> pathNodes;
+
+  //! Whether the path goes to the left child of the node (1) or not (0).
+  arma::vec pathLeft;
+
+  //! If true, the probabilities of all classes are computed.
+  bool deterministic;
+
+  //! Locally-stored weight object.
+  OutputDataType weights;
+
+  //! The targets of the batch.
+  arma::mat target;
+
+  //! The derivatives of the loss with respect to the scores of the nodes on
+  //! the paths of the targets, for all points.
+  arma::vec coefficients;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored gradient object.
+  OutputDataType gradient;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class HierarchicalSoftmax
+
+/**
+ * The Backward() function of the HierarchicalSoftmax layer only uses the
+ * decisions of the forward pass, so the output may be overwritten.
+ */
+template<typename InputDataType, typename OutputDataType>
+class LayerTraits<HierarchicalSoftmax<InputDataType, OutputDataType>>
+{
+ public:
+  static const bool IsBinary = false;
+  static const bool IsOutputLayer = false;
+  static const bool IsBiasLayer = false;
+  static const bool IsLSTMLayer = false;
+  static const bool IsConnection = false;
+  static const bool IsInPlace = false;
+  static const bool BackwardUsesOutput = false;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "hierarchical_softmax_impl.hpp"
+
+#endif
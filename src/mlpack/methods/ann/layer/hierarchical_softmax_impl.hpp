@@ -0,0 +1,315 @@
+/**
+ * @file hierarchical_softmax_impl.hpp
+ *
+ * Implementation of the HierarchicalSoftmax layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_HIERARCHICAL_SOFTMAX_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_HIERARCHICAL_SOFTMAX_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "hierarchical_softmax.hpp"
+
+#include <queue>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+namespace hierarchical_softmax {
+
+//! Compute log(1 + exp(x)) without overflow.
+inline double Softplus(const double x)
+{
+  return std::max(x, 0.0) + std::log1p(std::exp(-std::abs(x)));
+}
+
+//! Compute 1 / (1 + exp(-x)) without overflow.
+inline double Sigmoid(const double x)
+{
+  if (x >= 0)
+    return 1 / (1 + std::exp(-x));
+
+  const double e = std::exp(x);
+  return e / (1 + e);
+}
+
+} // namespace hierarchical_softmax
+
+template<typename InputDataType, typename OutputDataType>
+HierarchicalSoftmax<InputDataType, OutputDataType>::HierarchicalSoftmax() :
+    inSize(0),
+    numClasses(0),
+    deterministic(false)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+HierarchicalSoftmax<InputDataType, OutputDataType>::HierarchicalSoftmax(
+    const size_t inSize,
+    const size_t numClasses,
+    const arma::vec& frequencies) :
+    inSize(inSize),
+    numClasses(numClasses),
+    deterministic(false)
+{
+  if (numClasses < 2)
+    Log::Fatal << "HierarchicalSoftmax: there have to be at least two classes."
+        << std::endl;
+
+  if (!frequencies.is_empty() && frequencies.n_elem != numClasses)
+  {
+    Log::Fatal << "HierarchicalSoftmax: " << frequencies.n_elem
+        << " frequencies given for " << numClasses << " classes." << std::endl;
+  }
+
+  BuildTree(frequencies.is_empty() ?
+      arma::vec(arma::ones<arma::vec>(numClasses)) : frequencies);
+  BuildPaths();
+  weights.set_size(inSize + 1, numClasses - 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+HierarchicalSoftmax<InputDataType, OutputDataType>::HierarchicalSoftmax(
+    const size_t inSize,
+    const arma::Mat<size_t>& children) :
+    inSize(inSize),
+    numClasses(children.n_cols + 1),
+    children(children),
+    deterministic(false)
+{
+  if (children.n_rows != 2 || children.n_cols == 0)
+    Log::Fatal << "HierarchicalSoftmax: the tree has to be given as a 2-row "
+        << "matrix of the children of the inner nodes." << std::endl;
+
+  BuildPaths();
+  weights.set_size(inSize + 1, numClasses - 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void HierarchicalSoftmax<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  using namespace hierarchical_softmax;
+
+  if (deterministic)
+  {
+    // The scores of all inner nodes, then the log-probabilities of the nodes
+    // from the root (the last inner node) down.
+    arma::Mat<eT> scores = weights.head_rows(inSize).t() * input;
+    scores.each_col() += weights.row(inSize).t();
+
+    output.set_size(numClasses, input.n_cols);
+    arma::Col<eT> innerLogProbabilities(numClasses - 1);
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      innerLogProbabilities[numClasses - 2] = 0;
+      for (size_t k = numClasses - 1; k > 0; --k)
+      {
+        const eT score = scores(k - 1, i);
+        const eT logProbability = innerLogProbabilities[k - 1];
+        for (size_t side = 0; side < 2; ++side)
+        {
+          const eT childLogProbability = logProbability -
+              Softplus(side == 0 ? -score : score);
+          const size_t child = children(side, k - 1);
+          if (child < numClasses)
+            output(child, i) = childLogProbability;
+          else
+            innerLogProbabilities[child - numClasses] = childLogProbability;
+        }
+      }
+    }
+
+    return;
+  }
+
+  if (target.n_cols != input.n_cols)
+  {
+    Log::Fatal << "HierarchicalSoftmax::Forward(): the targets of the batch "
+        << "are not set; the layer has to be the last layer of an FFN."
+        << std::endl;
+  }
+
+  size_t totalLength = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t currentTarget = target(i) - 1;
+    Log::Assert(currentTarget < numClasses, "Target class out of range.");
+    totalLength += PathLength(currentTarget);
+  }
+
+  // The binary decisions on the path of the target of every point.
+  coefficients.set_size(totalLength);
+  output.set_size(1, input.n_cols);
+  for (size_t i = 0, offset = 0; i < input.n_cols; ++i)
+  {
+    const size_t currentTarget = target(i) - 1;
+    const eT* x = input.colptr(i);
+
+    eT loss = 0;
+    for (size_t p = pathStart[currentTarget];
+         p < pathStart[currentTarget + 1]; ++p, ++offset)
+    {
+      const eT* w = weights.colptr(pathNodes[p]);
+      eT score = w[inSize];
+      for (size_t j = 0; j < inSize; ++j)
+        score += w[j] * x[j];
+
+      loss += Softplus(score) - pathLeft[p] * score;
+      coefficients[offset] = Sigmoid(score) - pathLeft[p];
+    }
+
+    output(0, i) = loss;
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void HierarchicalSoftmax<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  // Scale the derivatives by the error of every point; Gradient() uses the
+  // scaled derivatives.
+  g.zeros(inSize, gy.n_cols);
+  for (size_t i = 0, offset = 0; i < gy.n_cols; ++i)
+  {
+    const size_t currentTarget = target(i) - 1;
+    eT* d = g.colptr(i);
+    for (size_t p = pathStart[currentTarget];
+         p < pathStart[currentTarget + 1]; ++p, ++offset)
+    {
+      coefficients[offset] *= gy[i];
+      const eT* w = weights.colptr(pathNodes[p]);
+      for (size_t j = 0; j < inSize; ++j)
+        d[j] += coefficients[offset] * w[j];
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void HierarchicalSoftmax<InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>&& input,
+    arma::Mat<eT>&& /* error */,
+    arma::Mat<eT>&& gradient)
+{
+  // Only the columns of the nodes on the paths of the targets are nonzero.
+  gradient.zeros();
+  for (size_t i = 0, offset = 0; i < input.n_cols; ++i)
+  {
+    const size_t currentTarget = target(i) - 1;
+    const eT* x = input.colptr(i);
+    for (size_t p = pathStart[currentTarget];
+         p < pathStart[currentTarget + 1]; ++p, ++offset)
+    {
+      eT* w = gradient.colptr(pathNodes[p]);
+      for (size_t j = 0; j < inSize; ++j)
+        w[j] += coefficients[offset] * x[j];
+      w[inSize] += coefficients[offset];
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void HierarchicalSoftmax<InputDataType, OutputDataType>::BuildTree(
+    const arma::vec& frequencies)
+{
+  // Merge the two least frequent nodes until one is left; ties are broken by
+  // the node id, so equal frequencies give a balanced tree.
+  typedef std::pair<double, size_t> NodeType;
+  std::priority_queue<NodeType, std::vector<NodeType>,
+      std::greater<NodeType>> queue;
+  for (size_t c = 0; c < numClasses; ++c)
+    queue.push(NodeType(frequencies[c], c));
+
+  children.set_size(2, numClasses - 1);
+  for (size_t k = 0; k < numClasses - 1; ++k)
+  {
+    const NodeType left = queue.top();
+    queue.pop();
+    const NodeType right = queue.top();
+    queue.pop();
+
+    children(0, k) = left.second;
+    children(1, k) = right.second;
+    queue.push(NodeType(left.first + right.first, numClasses + k));
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void HierarchicalSoftmax<InputDataType, OutputDataType>::BuildPaths()
+{
+  // Find the parent of every node.
+  const size_t numNodes = 2 * numClasses - 1;
+  arma::Col<size_t> parent(numNodes);
+  parent.fill(numNodes);
+  std::vector<bool> isLeft(numNodes, false);
+  for (size_t k = 0; k < numClasses - 1; ++k)
+  {
+    for (size_t side = 0; side < 2; ++side)
+    {
+      const size_t child = children(side, k);
+      if (child >= numClasses + k || parent[child] != numNodes)
+      {
+        Log::Fatal << "HierarchicalSoftmax: invalid tree; every node has to "
+            << "be the child of exactly one inner node created after it."
+            << std::endl;
+      }
+
+      parent[child] = numClasses + k;
+      isLeft[child] = (side == 0);
+    }
+  }
+
+  const size_t root = numNodes - 1;
+  pathStart.set_size(numClasses + 1);
+  pathStart[0] = 0;
+  for (size_t c = 0; c < numClasses; ++c)
+  {
+    size_t length = 0;
+    for (size_t node = c; node != root; node = parent[node])
+      ++length;
+    pathStart[c + 1] = pathStart[c] + length;
+  }
+
+  pathNodes.set_size(pathStart[numClasses]);
+  pathLeft.set_size(pathStart[numClasses]);
+  for (size_t c = 0; c < numClasses; ++c)
+  {
+    size_t p = pathStart[c];
+    for (size_t node = c; node != root; node = parent[node], ++p)
+    {
+      pathNodes[p] = parent[node] - numClasses;
+      pathLeft[p] = isLeft[node] ? 1.0 : 0.0;
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void HierarchicalSoftmax<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(children);
+
+  // This is inefficient, but we have to allocate this memory so that
+  // WeightSetVisitor gets the right size.
+  if (Archive::is_loading::value)
+  {
+    BuildPaths();
+    weights.set_size(inSize + 1, numClasses - 1);
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
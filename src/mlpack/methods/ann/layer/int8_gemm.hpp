@@ -0,0 +1,118 @@
+/**
+ * @file int8_gemm.hpp
+ *
+ * Definition of the Int8Gemm class, which provides the 8-bit integer
+ * quantization and matrix multiplication used by the quantized layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_INT8_GEMM_HPP
+#define MLPACK_METHODS_ANN_LAYER_INT8_GEMM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <cstdint>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Int8Gemm provides symmetric 8-bit quantization: a value x is stored as the
+ * integer q = round(x / scale), clamped to [-127, 127], so that x ~ q * scale.
+ * The product of two quantized matrices is accumulated in 32-bit integers,
+ * which can't overflow for inner dimensions up to 2^31 / 127^2 (about 133000).
+ */
+class Int8Gemm
+{
+ public:
+  /**
+   * Quantize the given matrix with the given scale.
+   *
+   * @param input Matrix to quantize.
+   * @param scale Value of a quantization step.
+   * @param output The quantized matrix.
+   */
+  template<typename eT>
+  static void Quantize(const arma::Mat<eT>& input,
+                       const double scale,
+                       arma::Mat<int8_t>& output)
+  {
+    output.set_size(input.n_rows, input.n_cols);
+
+    const double inverseScale = (scale > 0.0) ? 1.0 / scale : 0.0;
+    const eT* inputPtr = input.memptr();
+    int8_t* outputPtr = output.memptr();
+    for (size_t i = 0; i < input.n_elem; ++i)
+    {
+      const double value = std::round(inputPtr[i] * inverseScale);
+      outputPtr[i] = (int8_t) std::max(-127.0, std::min(127.0, value));
+    }
+  }
+
+  /**
+   * Quantize every column of the given matrix with its own scale, chosen so
+   * that the largest absolute value of the column maps to 127.
+   *
+   * @param input Matrix to quantize.
+   * @param output The quantized matrix.
+   * @param scales The scale of each column.
+   */
+  static void QuantizeColumns(const arma::mat& input,
+                              arma::Mat<int8_t>& output,
+                              arma::vec& scales)
+  {
+    output.set_size(input.n_rows, input.n_cols);
+    scales.set_size(input.n_cols);
+
+    for (size_t j = 0; j < input.n_cols; ++j)
+    {
+      scales[j] = arma::abs(input.col(j)).max() / 127.0;
+
+      const arma::mat column(const_cast<double*>(input.colptr(j)),
+          input.n_rows, 1, false, true);
+      arma::Mat<int8_t> quantizedColumn(output.colptr(j), input.n_rows, 1,
+          false, true);
+      Quantize(column, scales[j], quantizedColumn);
+    }
+  }
+
+  /**
+   * Compute the product of the transpose of the first matrix and the second
+   * matrix.  Both matrices are stored so that the inner dimension is
+   * contiguous, which turns every output element into a dot product of two
+   * contiguous vectors.
+   *
+   * @param a First matrix (k x m).
+   * @param b Second matrix (k x n).
+   * @param output The product (m x n).
+   */
+  static void Multiply(const arma::Mat<int8_t>& a,
+                       const arma::Mat<int8_t>& b,
+                       arma::Mat<int32_t>& output)
+  {
+    output.set_size(a.n_cols, b.n_cols);
+
+    const size_t k = a.n_rows;
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      const int8_t* bPtr = b.colptr(j);
+      int32_t* outputPtr = output.colptr(j);
+      for (size_t i = 0; i < a.n_cols; ++i)
+      {
+        const int8_t* aPtr = a.colptr(i);
+        int32_t sum = 0;
+        for (size_t l = 0; l < k; ++l)
+          sum += (int32_t) aPtr[l] * (int32_t) bPtr[l];
+
+        outputPtr[i] = sum;
+      }
+    }
+  }
+}; // class Int8Gemm
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -33,7 +33,11 @@ void Join<InputDataType, OutputDataType>::Forward(
 {
   inSizeRows = input.n_rows;
   inSizeCols = input.n_cols;
-  output = arma::vectorise(input);
+
+  // The input is already stored as its vectorised form, so the output can
+  // point at its memory instead of copying it.
+  output = OutputType(const_cast<typename OutputType::elem_type*>(
+      input.memptr()), input.n_elem, 1, false, false);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -19,17 +19,21 @@
 #include "convolution.hpp"
 #include "dropconnect.hpp"
 #include "glimpse.hpp"
+#include "hierarchical_softmax.hpp"
 #include "layer_norm.hpp"
 #include "layer_types.hpp"
 #include "linear.hpp"
 #include "linear_no_bias.hpp"
 #include "lstm.hpp"
 #include "multiply_merge.hpp"
+#include "quantized_convolution.hpp"
+#include "quantized_linear.hpp"
 #include "gru.hpp"
 #include "fast_lstm.hpp"
 #include "recurrent.hpp"
 #include "recurrent_attention.hpp"
 #include "reparametrization.hpp"
+#include "sampled_softmax.hpp"
 #include "sequential.hpp"
 #include "subview.hpp"
 #include "concat.hpp"
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_ANN_LAYER_LAYERNORM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -179,10 +180,31 @@ class LayerNorm
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
+  //! Locally-stored inverse of the standard deviation of every sample.
+  OutputDataType stdInv;
+
   //! Locally-stored normalized input.
   OutputDataType normalized;
 }; // class LayerNorm
 
+/**
+ * The Backward() function of the LayerNorm layer uses the normalized input it
+ * stored in the forward pass, so the output may be overwritten by the next
+ * layer.
+ */
+template<typename InputDataType, typename OutputDataType>
+class LayerTraits<LayerNorm<InputDataType, OutputDataType>>
+{
+ public:
+  static const bool IsBinary = false;
+  static const bool IsOutputLayer = false;
+  static const bool IsBiasLayer = false;
+  static const bool IsLSTMLayer = false;
+  static const bool IsConnection = false;
+  static const bool IsInPlace = false;
+  static const bool BackwardUsesOutput = false;
+};
+
 } // namespace ann
 } // namespace mlpack
 
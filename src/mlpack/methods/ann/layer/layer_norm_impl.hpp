@@ -50,45 +50,75 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
-  mean = arma::mean(input, 0);
-  variance = arma::var(input, 1, 0);
-
-  // Normalize the input.
-  output = input.each_row() - mean;
-  output.each_row() /= arma::sqrt(variance + eps);
-
-  // Reused in the backward and gradient step.
-  normalized = output;
-
-  // Scale and shift the output.
-  output.each_col() %= gamma;
-  output.each_col() += beta;
+  mean.set_size(1, input.n_cols);
+  variance.set_size(1, input.n_cols);
+  stdInv.set_size(1, input.n_cols);
+  normalized.set_size(input.n_rows, input.n_cols);
+  output.set_size(input.n_rows, input.n_cols);
+
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    // Compute the mean and the variance of the sample in one pass with
+    // Welford's algorithm.
+    const eT* inputPtr = input.colptr(j);
+    double sampleMean = 0.0, sampleM2 = 0.0;
+    for (size_t i = 0; i < input.n_rows; ++i)
+    {
+      const double delta = inputPtr[i] - sampleMean;
+      sampleMean += delta / (i + 1);
+      sampleM2 += delta * (inputPtr[i] - sampleMean);
+    }
+
+    mean[j] = sampleMean;
+    variance[j] = sampleM2 / input.n_rows;
+    stdInv[j] = 1.0 / std::sqrt(variance[j] + eps);
+
+    // Normalize, scale and shift in one pass; the normalized input and the
+    // inverse standard deviation are reused in the backward and gradient
+    // step.
+    eT* normalizedPtr = normalized.colptr(j);
+    eT* outputPtr = output.colptr(j);
+    for (size_t i = 0; i < input.n_rows; ++i)
+    {
+      normalizedPtr[i] = (inputPtr[i] - sampleMean) * stdInv[j];
+      outputPtr[i] = normalizedPtr[i] * gamma[i] + beta[i];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
 template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Backward(
-    const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  const arma::mat inputMean = input.each_row() - mean;
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // dl / dxhat
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 0) %
-      arma::pow(stdInv, 3.0) * -0.5;
-
-  // dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_row() % stdInv) + (inputMean.each_row() %
-      var * 2 / input.n_rows);
-
-  // sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_row() += (arma::sum(norm.each_row() % -stdInv, 0) + (var %
-      arma::mean(-2 * inputMean, 0))) / input.n_rows;
+  g.set_size(gy.n_rows, gy.n_cols);
+
+  // With dxhat = dy * gamma, the gradient with respect to the input is
+  // stdInv / m * (m * dxhat - sum(dxhat) - xhat * sum(dxhat * xhat)), where
+  // the sums are over the units of the sample.
+  const double m = gy.n_rows;
+  for (size_t j = 0; j < gy.n_cols; ++j)
+  {
+    const eT* errorPtr = gy.colptr(j);
+    const eT* normalizedPtr = normalized.colptr(j);
+
+    double errorSum = 0.0, normalizedErrorSum = 0.0;
+    for (size_t i = 0; i < gy.n_rows; ++i)
+    {
+      const double normError = errorPtr[i] * gamma[i];
+      errorSum += normError;
+      normalizedErrorSum += normError * normalizedPtr[i];
+    }
+    errorSum /= m;
+    normalizedErrorSum /= m;
+
+    eT* gPtr = g.colptr(j);
+    for (size_t i = 0; i < gy.n_rows; ++i)
+    {
+      gPtr[i] = stdInv[j] * (errorPtr[i] * gamma[i] - errorSum -
+          normalizedPtr[i] * normalizedErrorSum);
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -98,14 +128,21 @@ void LayerNorm<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient.set_size(size + size, 1);
-
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(normalized % error, 1);
-
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+  gradient.zeros(size + size, 1);
+
+  // Step 5: dl / dy * xhat; step 6: dl / dy.
+  double* gammaGradient = gradient.memptr();
+  double* betaGradient = gradient.memptr() + size;
+  for (size_t j = 0; j < error.n_cols; ++j)
+  {
+    const eT* errorPtr = error.colptr(j);
+    const eT* normalizedPtr = normalized.colptr(j);
+    for (size_t i = 0; i < size; ++i)
+    {
+      gammaGradient[i] += errorPtr[i] * normalizedPtr[i];
+      betaGradient[i] += errorPtr[i];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
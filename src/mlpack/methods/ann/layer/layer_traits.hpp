@@ -53,6 +53,19 @@ class LayerTraits
    * This is true if the layer is a connection layer.
    **/
   static const bool IsConnection = false;
+
+  /**
+   * This is true if the layer is elementwise and has no Gradient() function,
+   * so that it can write its output over its input and its delta over the
+   * backpropagated error.
+   */
+  static const bool IsInPlace = false;
+
+  /**
+   * This is true if the Backward() function of the layer reads the output
+   * parameter that is passed to it.
+   */
+  static const bool BackwardUsesOutput = true;
 };
 
 // This gives us a HasGradientCheck<T, U> type (where U is a function pointer)
@@ -108,6 +121,10 @@ HAS_MEM_FUNC(Rho, HasRho);
 // can use with SFINAE to catch when a type has a Loss() function.
 HAS_MEM_FUNC(Loss, HasLoss);
 
+// This gives us a HasTargetCheck<T, U> type (where U is a function pointer) we
+// can use with SFINAE to catch when a type has a Target() function.
+HAS_MEM_FUNC(Target, HasTargetCheck);
+
 } // namespace ann
 } // namespace mlpack
 
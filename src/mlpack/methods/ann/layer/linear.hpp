@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_LINEAR_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 
 #include "layer_types.hpp"
 
@@ -113,6 +114,12 @@ class Linear
   //! Modify the gradient.
   OutputDataType& Gradient() { return gradient; }
 
+  //! Get the number of input units.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the number of output units.
+  size_t OutputSize() const { return outSize; }
+
   /**
    * Serialize the layer
    */
@@ -148,6 +155,23 @@ class Linear
   OutputDataType outputParameter;
 }; // class Linear
 
+/**
+ * The Backward() function of the Linear layer only uses the weights, so the
+ * output may be overwritten by the next layer.
+ */
+template<typename InputDataType, typename OutputDataType>
+class LayerTraits<Linear<InputDataType, OutputDataType>>
+{
+ public:
+  static const bool IsBinary = false;
+  static const bool IsOutputLayer = false;
+  static const bool IsBiasLayer = false;
+  static const bool IsLSTMLayer = false;
+  static const bool IsConnection = false;
+  static const bool IsInPlace = false;
+  static const bool BackwardUsesOutput = false;
+};
+
 } // namespace ann
 } // namespace mlpack
 
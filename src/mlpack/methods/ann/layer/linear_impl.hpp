@@ -67,10 +67,13 @@ void Linear<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
-      error * input.t());
-  gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+  // Write both parts straight into the gradient, without temporaries.
+  arma::Mat<eT> weightGradient(gradient.memptr(), weight.n_rows,
+      weight.n_cols, false, true);
+  weightGradient = error * input.t();
+  arma::Col<eT> biasGradient(gradient.memptr() + weight.n_elem, bias.n_elem,
+      false, true);
+  biasGradient = arma::sum(error, 1);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_LINEAR_NO_BIAS_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 
 #include "layer_types.hpp"
 
@@ -112,6 +113,12 @@ class LinearNoBias
   //! Modify the gradient.
   OutputDataType& Gradient() { return gradient; }
 
+  //! Get the number of input units.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the number of output units.
+  size_t OutputSize() const { return outSize; }
+
   /**
    * Serialize the layer
    */
@@ -144,6 +151,23 @@ class LinearNoBias
   OutputDataType outputParameter;
 }; // class LinearNoBias
 
+/**
+ * The Backward() function of the LinearNoBias layer only uses the weights, so
+ * the output may be overwritten by the next layer.
+ */
+template<typename InputDataType, typename OutputDataType>
+class LayerTraits<LinearNoBias<InputDataType, OutputDataType>>
+{
+ public:
+  static const bool IsBinary = false;
+  static const bool IsOutputLayer = false;
+  static const bool IsBiasLayer = false;
+  static const bool IsLSTMLayer = false;
+  static const bool IsConnection = false;
+  static const bool IsInPlace = false;
+  static const bool BackwardUsesOutput = false;
+};
+
 } // namespace ann
 } // namespace mlpack
 
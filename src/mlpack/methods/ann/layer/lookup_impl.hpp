@@ -54,8 +54,15 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient = arma::zeros<arma::Mat<eT> >(weights.n_rows, weights.n_cols);
-  gradient.cols(arma::conv_to<arma::uvec>::from(input) - 1) = error;
+  const arma::uvec columns = arma::conv_to<arma::uvec>::from(input) - 1;
+
+  // The gradient may hold anything on entry (inside an FFN it is part of the
+  // optimizer's gradient), so the whole table is cleared.
+  gradient.zeros(weights.n_rows, weights.n_cols);
+
+  // A token can appear more than once in a batch.
+  for (size_t i = 0; i < columns.n_elem; ++i)
+    gradient.col(columns[i]) += error.col(i);
 }
 
 template<typename InputDataType, typename OutputDataType>
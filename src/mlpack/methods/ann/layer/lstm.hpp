@@ -48,8 +48,14 @@ namespace ann /** Artificial Neural Network. */ {
  * }
  * @endcode
  *
- * \see FastLSTM for a faster LSTM version which combines the calculation of the
- * input, forget, output gates and hidden state in a single step.
+ * The four gates are computed together: one matrix multiplication for the
+ * input and one for the previous output give the pre-activations of all of
+ * them, and the peephole connections, gate activations, cell and output are
+ * then computed in a single elementwise pass.  The backward pass is fused in
+ * the same way.
+ *
+ * \see FastLSTM for a faster LSTM version without peephole connections, which
+ * uses an approximation of the sigmoid function.
  *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
@@ -102,7 +108,9 @@ class LSTM
                 GradientType&& g);
 
   /*
-   * Reset the layer parameter.
+   * Reset the layer parameter.  If the layer was loaded from a model that
+   * stores the weights of each gate separately (serialization version 0), the
+   * weights are rearranged into the current layout here.
    */
   void Reset();
 
@@ -131,9 +139,12 @@ class LSTM
   //! Modify the maximum number of steps to backpropagate through time (BPTT).
   size_t& Rho() { return rho; }
 
-  //! Get the parameters.
+  //! Get the parameters.  After an older model (serialization version 0) is
+  //! loaded, they keep the old layout until Reset() is called; FFN and RNN
+  //! call it when they load a model.
   OutputDataType const& Parameters() const { return weights; }
-  //! Modify the parameters.
+  //! Modify the parameters.  After an older model is loaded, Reset() must be
+  //! called once they are in their final location, see Parameters() const.
   OutputDataType& Parameters() { return weights; }
 
   //! Get the output parameter.
@@ -152,10 +163,13 @@ class LSTM
   OutputDataType& Gradient() { return grad; }
 
   /**
-   * Serialize the layer
+   * Serialize the layer.  The weights of an older model (version 0) are not
+   * converted when it is loaded, because a network may still point them at its
+   * own parameters, which hold the same old layout; the conversion happens in
+   * the next call to Reset().
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
   //! Locally-stored number of input units.
@@ -179,9 +193,6 @@ class LSTM
   //! Locally-stored weight object.
   OutputDataType weights;
 
-  //! Locally-stored previous output.
-  OutputDataType prevOutput;
-
   //! Locally-stored batch size.
   size_t batchSize;
 
@@ -192,9 +203,6 @@ class LSTM
   //! step.
   size_t gradientStepIdx;
 
-  //! Locally-stored cell activation error.
-  OutputDataType cellActivationError;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -204,86 +212,36 @@ class LSTM
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Weights between the output and input gate.
-  OutputDataType output2GateInputWeight;
+  //! Weights between the input and the four gates (input gate, output gate,
+  //! forget gate and hidden layer, in that order).
+  OutputDataType input2GateWeight;
 
-  //! Weights between the input and gate.
-  OutputDataType input2GateInputWeight;
+  //! Bias of the four gates.
+  OutputDataType input2GateBias;
 
-  //! Bias between the input and input gate.
-  OutputDataType input2GateInputBias;
+  //! Weights between the previous output and the four gates.
+  OutputDataType output2GateWeight;
 
   //! Weights between the cell and input gate.
   OutputDataType cell2GateInputWeight;
 
-  //! Weights between the output and forget gate.
-  OutputDataType output2GateForgetWeight;
-
-  //! Weights between the input and gate.
-  OutputDataType input2GateForgetWeight;
-
-  //! Bias between the input and gate.
-  OutputDataType input2GateForgetBias;
-
-  //! Bias between the input and gate.
+  //! Weights between the cell and forget gate.
   OutputDataType cell2GateForgetWeight;
 
-  //! Weights between the output and gate.
-  OutputDataType output2GateOutputWeight;
-
-  //! Weights between the input and gate.
-  OutputDataType input2GateOutputWeight;
-
-  //! Bias between the input and gate.
-  OutputDataType input2GateOutputBias;
-
   //! Weights between cell and output gate.
   OutputDataType cell2GateOutputWeight;
 
-  //! Locally-stored input gate parameter.
-  OutputDataType inputGate;
-
-  //! Locally-stored forget gate parameter.
-  OutputDataType forgetGate;
-
-  //! Locally-stored hidden layer parameter.
-  OutputDataType hiddenLayer;
-
-  //! Locally-stored output gate parameter.
-  OutputDataType outputGate;
-
-  //! Locally-stored input gate activation.
-  OutputDataType inputGateActivation;
-
-  //! Locally-stored forget gate activation.
-  OutputDataType forgetGateActivation;
-
-  //! Locally-stored output gate activation.
-  OutputDataType outputGateActivation;
-
-  //! Locally-stored hidden layer activation.
-  OutputDataType hiddenLayerActivation;
-
-  //! Locally-stored input to hidden weight.
-  OutputDataType input2HiddenWeight;
-
-  //! Locally-stored input to hidden bias.
-  OutputDataType input2HiddenBias;
-
-  //! Locally-stored output to hidden weight.
-  OutputDataType output2HiddenWeight;
+  //! Locally-stored activations of the four gates.
+  OutputDataType gateActivation;
 
   //! Locally-stored cell parameter.
   OutputDataType cell;
 
-  //! Locally-stored cell activation error.
+  //! Locally-stored cell activation.
   OutputDataType cellActivation;
 
-  //! Locally-stored forget gate error.
-  OutputDataType forgetGateError;
-
-  //! Locally-stored output gate error.
-  OutputDataType outputGateError;
+  //! Locally-stored error of the four gates.
+  OutputDataType gateError;
 
   //! Locally-stored previous error.
   OutputDataType prevError;
@@ -294,22 +252,44 @@ class LSTM
   //! Locally-stored input cell error parameter.
   OutputDataType inputCellError;
 
-  //! Locally-stored input gate error.
-  OutputDataType inputGateError;
-
-  //! Locally-stored hidden layer error.
-  OutputDataType hiddenError;
-
   //! Locally-stored current rho size.
   size_t rhoSize;
 
   //! Current backpropagate through time steps.
   size_t bpttSteps;
+
+  //! Whether the weights were loaded from a model that stores the weights of
+  //! each gate separately, and have to be rearranged by the next Reset().
+  bool legacyWeights;
+
+  //! Rearrange the weights of a model that stores the weights of each gate
+  //! separately into the layout used by this layer.
+  void ConvertLegacyWeights();
+
+  //! Allocate the errors of a single step for the current batch size.
+  void ResetErrors();
 }; // class LSTM
 
 } // namespace ann
 } // namespace mlpack
 
+//! Set the serialization version of the LSTM class.  Version 1 stores the
+//! weights of the four gates together.  (BOOST_TEMPLATE_CLASS_VERSION() can't
+//! be used, since the template has two parameters.)
+namespace boost {
+namespace serialization {
+
+template<typename InputDataType, typename OutputDataType>
+struct version<mlpack::ann::LSTM<InputDataType, OutputDataType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "lstm_impl.hpp"
 
@@ -19,7 +19,7 @@ namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
 template<typename InputDataType, typename OutputDataType>
-LSTM<InputDataType, OutputDataType>::LSTM()
+LSTM<InputDataType, OutputDataType>::LSTM() : legacyWeights(false)
 {
   // Nothing to do here.
 }
@@ -37,12 +37,89 @@ LSTM<InputDataType, OutputDataType>::LSTM(
     batchStep(0),
     gradientStepIdx(0),
     rhoSize(rho),
-    bpttSteps(0)
+    bpttSteps(0),
+    legacyWeights(false)
 {
   weights.set_size(4 * outSize * inSize + 7 * outSize +
       4 * outSize * outSize, 1);
 }
 
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::Reset()
+{
+  // Set the weight parameter for the input to gate connections; the rows hold
+  // the input gate, output gate, forget gate and hidden layer in that order.
+  input2GateWeight = OutputDataType(weights.memptr(), 4 * outSize, inSize,
+      false, false);
+  input2GateBias = OutputDataType(weights.memptr() + input2GateWeight.n_elem,
+      4 * outSize, 1, false, false);
+  size_t offset = input2GateWeight.n_elem + input2GateBias.n_elem;
+
+  // Set the weight parameter for the output to gate connections.
+  output2GateWeight = OutputDataType(weights.memptr() + offset, 4 * outSize,
+      outSize, false, false);
+  offset += output2GateWeight.n_elem;
+
+  // Set the weight parameter for the peephole connections.
+  cell2GateInputWeight = OutputDataType(weights.memptr() + offset, outSize, 1,
+      false, false);
+  offset += cell2GateInputWeight.n_elem;
+
+  cell2GateForgetWeight = OutputDataType(weights.memptr() + offset, outSize, 1,
+      false, false);
+  offset += cell2GateForgetWeight.n_elem;
+
+  cell2GateOutputWeight = OutputDataType(weights.memptr() + offset, outSize, 1,
+      false, false);
+
+  if (legacyWeights)
+    ConvertLegacyWeights();
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::ConvertLegacyWeights()
+{
+  // Older models hold the weights of each gate separately, with the output
+  // gate first: the input weights and bias of the output gate, forget gate,
+  // input gate and hidden layer, then their output weights in the same order,
+  // then the output, forget and input peephole weights.  The weights may alias
+  // the parameters of a network, so they are rearranged in place.
+  const OutputDataType oldWeights = weights;
+  const size_t inputBlock = outSize * inSize + outSize;
+  const size_t outputOffset = 4 * inputBlock;
+  const size_t peepholeOffset = outputOffset + 4 * outSize * outSize;
+
+  // The position of each gate (input, output, forget, hidden) and each
+  // peephole (input, forget, output) in the old layout.
+  const size_t oldGate[4] = { 2, 0, 1, 3 };
+  const size_t oldPeephole[3] = { 2, 1, 0 };
+
+  for (size_t g = 0; g < 4; ++g)
+  {
+    const size_t row = g * outSize;
+    const size_t start = oldGate[g] * inputBlock;
+    input2GateWeight.rows(row, row + outSize - 1) = arma::reshape(
+        oldWeights.rows(start, start + outSize * inSize - 1), outSize, inSize);
+    input2GateBias.rows(row, row + outSize - 1) = oldWeights.rows(
+        start + outSize * inSize, start + inputBlock - 1);
+
+    const size_t outputStart = outputOffset + oldGate[g] * outSize * outSize;
+    output2GateWeight.rows(row, row + outSize - 1) = arma::reshape(
+        oldWeights.rows(outputStart, outputStart + outSize * outSize - 1),
+        outSize, outSize);
+  }
+
+  for (size_t p = 0; p < 3; ++p)
+  {
+    const size_t start = peepholeOffset + oldPeephole[p] * outSize;
+    weights.rows(peepholeOffset + p * outSize,
+        peepholeOffset + (p + 1) * outSize - 1) = oldWeights.rows(start,
+        start + outSize - 1);
+  }
+
+  legacyWeights = false;
+}
+
 template<typename InputDataType, typename OutputDataType>
 void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
 {
@@ -61,20 +138,10 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
   gradientStep = batchSize * size - 1;
 
   const size_t rhoBatchSize = size * batchSize;
-  if (inputGate.is_empty() || inputGate.n_cols < rhoBatchSize)
+  if (gateActivation.is_empty() || gateActivation.n_cols < rhoBatchSize)
   {
-    inputGate.set_size(outSize, rhoBatchSize);
-    forgetGate.set_size(outSize, rhoBatchSize);
-    hiddenLayer.set_size(outSize, rhoBatchSize);
-    outputGate.set_size(outSize, rhoBatchSize);
-
-    inputGateActivation.set_size(outSize, rhoBatchSize);
-    forgetGateActivation.set_size(outSize, rhoBatchSize);
-    outputGateActivation.set_size(outSize, rhoBatchSize);
-    hiddenLayerActivation.set_size(outSize, rhoBatchSize);
-
+    gateActivation.set_size(4 * outSize, rhoBatchSize);
     cellActivation.set_size(outSize, rhoBatchSize);
-    prevError.set_size(4 * outSize, batchSize);
 
     if (cell.is_empty())
     {
@@ -91,72 +158,22 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
       outParameter.resize(outSize, (size + 1) * batchSize);
     }
   }
+
+  // A smaller batch size may have written outputs into the leading columns,
+  // which hold the initial output of the new chain.
+  outParameter.cols(0, batchSize - 1).zeros();
+
+  // The errors hold a single step, so unlike the storage above they have to
+  // match the batch size exactly, also when it shrinks.
+  ResetErrors();
 }
 
 template<typename InputDataType, typename OutputDataType>
-void LSTM<InputDataType, OutputDataType>::Reset()
+void LSTM<InputDataType, OutputDataType>::ResetErrors()
 {
-  // Set the weight parameter for the output gate.
-  input2GateOutputWeight = OutputDataType(weights.memptr(), outSize, inSize,
-      false, false);
-  input2GateOutputBias = OutputDataType(weights.memptr() +
-      input2GateOutputWeight.n_elem, outSize, 1, false, false);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // Set the weight parameter for the forget gate.
-  input2GateForgetWeight = OutputDataType(weights.memptr() + offset,
-      outSize, inSize, false, false);
-  input2GateForgetBias = OutputDataType(weights.memptr() +
-      offset + input2GateForgetWeight.n_elem, outSize, 1, false, false);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // Set the weight parameter for the input gate.
-  input2GateInputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, inSize, false, false);
-  input2GateInputBias = OutputDataType(weights.memptr() +
-      offset + input2GateInputWeight.n_elem, outSize, 1, false, false);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // Set the weight parameter for the hidden gate.
-  input2HiddenWeight = OutputDataType(weights.memptr() +
-      offset, outSize, inSize, false, false);
-  input2HiddenBias = OutputDataType(weights.memptr() +
-      offset + input2HiddenWeight.n_elem, outSize, 1, false, false);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // Set the weight parameter for the output multiplication.
-  output2GateOutputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, outSize, false, false);
-  offset += output2GateOutputWeight.n_elem;
-
-  // Set the weight parameter for the output multiplication.
-  output2GateForgetWeight = OutputDataType(weights.memptr() +
-      offset, outSize, outSize, false, false);
-  offset += output2GateForgetWeight.n_elem;
-
-  // Set the weight parameter for the input multiplication.
-  output2GateInputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, outSize, false, false);
-  offset += output2GateInputWeight.n_elem;
-
-  // Set the weight parameter for the hidden multiplication.
-  output2HiddenWeight = OutputDataType(weights.memptr() +
-      offset, outSize, outSize, false, false);
-  offset += output2HiddenWeight.n_elem;
-
-  // Set the weight parameter for the cell multiplication.
-  cell2GateOutputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, 1, false, false);
-  offset += cell2GateOutputWeight.n_elem;
-
-  // Set the weight parameter for the cell - forget gate multiplication.
-  cell2GateForgetWeight = OutputDataType(weights.memptr() +
-      offset, outSize, 1, false, false);
-  offset += cell2GateOutputWeight.n_elem;
-
-  // Set the weight parameter for the cell - input gate multiplication.
-  cell2GateInputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, 1, false, false);
+  gateError.set_size(4 * outSize, batchSize);
+  prevError.set_size(outSize, batchSize);
+  inputCellError.set_size(outSize, batchSize);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -164,6 +181,8 @@ template<typename InputType, typename OutputType>
 void LSTM<InputDataType, OutputDataType>::Forward(
     InputType&& input, OutputType&& output)
 {
+  typedef typename OutputDataType::elem_type ElemType;
+
   // Check if the batch size changed, the number of cols is defines the input
   // batch size.
   if (input.n_cols != batchSize)
@@ -173,79 +192,63 @@ void LSTM<InputDataType, OutputDataType>::Forward(
     ResetCell(rhoSize);
   }
 
-  inputGate.cols(forwardStep, forwardStep + batchStep) = input2GateInputWeight *
-      input + output2GateInputWeight * outParameter.cols(forwardStep,
-      forwardStep + batchStep);
-  inputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateInputBias;
-
-  forgetGate.cols(forwardStep, forwardStep + batchStep) = input2GateForgetWeight
-      * input + output2GateForgetWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-  forgetGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateForgetBias;
-
-  if (forwardStep > 0)
-  {
-    inputGate.cols(forwardStep, forwardStep + batchStep) +=
-        arma::repmat(cell2GateInputWeight, 1, batchSize) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
-
-    forgetGate.cols(forwardStep, forwardStep + batchStep) +=
-        arma::repmat(cell2GateForgetWeight, 1, batchSize) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
-  }
-
-  inputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-inputGate.cols(forwardStep, forwardStep + batchStep)));
-
-  forgetGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-forgetGate.cols(forwardStep, forwardStep + batchStep)));
-
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep) = input2HiddenWeight *
-      input + output2HiddenWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2HiddenBias;
-
-  hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(hiddenLayer.cols(forwardStep, forwardStep + batchStep));
-
-  if (forwardStep == 0)
-  {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
-  }
-  else
+  // The pre-activations of all four gates, computed with one matrix
+  // multiplication for the input and one for the previous output, straight
+  // into the storage of this step.
+  OutputDataType gate(gateActivation.colptr(forwardStep), 4 * outSize,
+      batchSize, false, true);
+  gate = input2GateWeight * input;
+  gate += output2GateWeight * OutputDataType(outParameter.colptr(forwardStep),
+      outSize, batchSize, false, true);
+
+  // Everything else is elementwise, so it is done in a single pass over the
+  // units, which replaces the pre-activations with the activations.
+  const ElemType* inputPeephole = cell2GateInputWeight.memptr();
+  const ElemType* forgetPeephole = cell2GateForgetWeight.memptr();
+  const ElemType* outputPeephole = cell2GateOutputWeight.memptr();
+  const ElemType* bias = input2GateBias.memptr();
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        forgetGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep)
-        + inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
+    const size_t col = forwardStep + j;
+    ElemType* gates = gateActivation.colptr(col);
+    ElemType* c = cell.colptr(col);
+    ElemType* cActivation = cellActivation.colptr(col);
+    ElemType* h = outParameter.colptr(col + batchSize);
+    const ElemType* prevCell = (forwardStep > 0) ?
+        cell.colptr(col - batchSize) : NULL;
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      ElemType inputGate = gates[i] + bias[i];
+      ElemType forgetGate = gates[2 * outSize + i] + bias[2 * outSize + i];
+      if (prevCell)
+      {
+        inputGate += inputPeephole[i] * prevCell[i];
+        forgetGate += forgetPeephole[i] * prevCell[i];
+      }
+
+      inputGate = 1.0 / (1.0 + std::exp(-inputGate));
+      forgetGate = 1.0 / (1.0 + std::exp(-forgetGate));
+      const ElemType hidden = std::tanh(gates[3 * outSize + i] +
+          bias[3 * outSize + i]);
+
+      c[i] = inputGate * hidden;
+      if (prevCell)
+        c[i] += forgetGate * prevCell[i];
+
+      const ElemType outputGate = 1.0 / (1.0 + std::exp(-(gates[outSize + i] +
+          bias[outSize + i] + outputPeephole[i] * c[i])));
+
+      cActivation[i] = std::tanh(c[i]);
+      h[i] = cActivation[i] * outputGate;
+
+      gates[i] = inputGate;
+      gates[outSize + i] = outputGate;
+      gates[2 * outSize + i] = forgetGate;
+      gates[3 * outSize + i] = hidden;
+    }
   }
 
-  outputGate.cols(forwardStep, forwardStep + batchStep) = input2GateOutputWeight
-      * input + output2GateOutputWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep) + cell.cols(forwardStep,
-      forwardStep + batchStep).each_col() % cell2GateOutputWeight;
-
-  outputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateOutputBias;
-
-  outputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-outputGate.cols(forwardStep, forwardStep + batchStep)));
-
-  cellActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(cell.cols(forwardStep, forwardStep + batchStep));
-
-  outParameter.cols(forwardStep + batchSize,
-      forwardStep + batchSize + batchStep) =
-      cellActivation.cols(forwardStep, forwardStep + batchStep) %
-      outputGateActivation.cols(forwardStep, forwardStep + batchStep);
-
   output = OutputType(outParameter.memptr() +
       (forwardStep + batchSize) * outSize, outSize, batchSize, false, false);
 
@@ -261,68 +264,70 @@ template<typename InputType, typename ErrorType, typename GradientType>
 void LSTM<InputDataType, OutputDataType>::Backward(
   const InputType&& /* input */, ErrorType&& gy, GradientType&& g)
 {
-  if (gradientStepIdx > 0)
-  {
-    gy += prevError;
-  }
-
-  outputGateError =
-      gy % cellActivation.cols(backwardStep - batchStep, backwardStep) %
-      (outputGateActivation.cols(backwardStep - batchStep, backwardStep) %
-      (1.0 - outputGateActivation.cols(backwardStep - batchStep,
-      backwardStep)));
-
-  OutputDataType cellError = gy %
-      outputGateActivation.cols(backwardStep - batchStep, backwardStep) %
-      (1 - arma::pow(cellActivation.cols(backwardStep -
-      batchStep, backwardStep), 2)) + outputGateError.each_col() %
-      cell2GateOutputWeight;
-
-  if (gradientStepIdx > 0)
-  {
-    cellError += inputCellError;
-  }
-
-  if (backwardStep > batchStep)
+  typedef typename OutputDataType::elem_type ElemType;
+
+  // The errors of all four gates are computed in a single pass over the units.
+  const size_t first = backwardStep - batchStep;
+  const ElemType* inputPeephole = cell2GateInputWeight.memptr();
+  const ElemType* forgetPeephole = cell2GateForgetWeight.memptr();
+  const ElemType* outputPeephole = cell2GateOutputWeight.memptr();
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    forgetGateError = cell.cols((backwardStep - batchSize) - batchStep,
-      (backwardStep - batchSize)) % cellError % (forgetGateActivation.cols(
-      backwardStep - batchStep, backwardStep) % (1.0 -
-      forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
-  }
-  else
-  {
-    forgetGateError.zeros();
+    const size_t col = first + j;
+    const ElemType* gates = gateActivation.colptr(col);
+    const ElemType* cActivation = cellActivation.colptr(col);
+    const ElemType* prevCell = (backwardStep > batchStep) ?
+        cell.colptr(col - batchSize) : NULL;
+    const ElemType* error = gy.colptr(j);
+    const ElemType* recurrentError = prevError.colptr(j);
+    ElemType* cellCarry = inputCellError.colptr(j);
+    ElemType* errors = gateError.colptr(j);
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      const ElemType inputGate = gates[i];
+      const ElemType outputGate = gates[outSize + i];
+      const ElemType forgetGate = gates[2 * outSize + i];
+      const ElemType hidden = gates[3 * outSize + i];
+
+      ElemType outputError = error[i];
+      if (gradientStepIdx > 0)
+        outputError += recurrentError[i];
+
+      const ElemType outputGateError = outputError * cActivation[i] *
+          outputGate * (1.0 - outputGate);
+
+      ElemType cellError = outputError * outputGate *
+          (1.0 - cActivation[i] * cActivation[i]) +
+          outputGateError * outputPeephole[i];
+      if (gradientStepIdx > 0)
+        cellError += cellCarry[i];
+
+      const ElemType forgetGateError = prevCell ? prevCell[i] * cellError *
+          forgetGate * (1.0 - forgetGate) : 0.0;
+      const ElemType inputGateError = hidden * cellError * inputGate *
+          (1.0 - inputGate);
+      const ElemType hiddenError = inputGate * cellError *
+          (1.0 - hidden * hidden);
+
+      cellCarry[i] = forgetGate * cellError + forgetGateError *
+          forgetPeephole[i] + inputGateError * inputPeephole[i];
+
+      errors[i] = inputGateError;
+      errors[outSize + i] = outputGateError;
+      errors[2 * outSize + i] = forgetGateError;
+      errors[3 * outSize + i] = hiddenError;
+    }
   }
 
-  inputGateError = hiddenLayerActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError %
-      (inputGateActivation.cols(backwardStep - batchStep, backwardStep) %
-      (1.0 - inputGateActivation.cols(backwardStep - batchStep, backwardStep)));
-
-  hiddenError = inputGateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError % (1 - arma::pow(hiddenLayerActivation.cols(
-      backwardStep - batchStep, backwardStep), 2));
-
-  inputCellError = forgetGateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError + forgetGateError.each_col() %
-      cell2GateForgetWeight + inputGateError.each_col() % cell2GateInputWeight;
-
-  g = input2GateInputWeight.t() * inputGateError +
-      input2HiddenWeight.t() * hiddenError +
-      input2GateForgetWeight.t() * forgetGateError +
-      input2GateOutputWeight.t() * outputGateError;
-
-  prevError = output2GateOutputWeight.t() * outputGateError +
-      output2GateForgetWeight.t() * forgetGateError +
-      output2GateInputWeight.t() * inputGateError +
-      output2HiddenWeight.t() * hiddenError;
+  g = input2GateWeight.t() * gateError;
+  prevError = output2GateWeight.t() * gateError;
 
   backwardStep -= batchSize;
   gradientStepIdx++;
   if (gradientStepIdx == bpttSteps)
   {
-    backwardStep = bpttSteps - 1;
+    backwardStep = batchSize * bpttSteps - 1;
     gradientStepIdx = 0;
   }
 }
@@ -332,90 +337,49 @@ template<typename InputType, typename ErrorType, typename GradientType>
 void LSTM<InputDataType, OutputDataType>::Gradient(
     InputType&& input, ErrorType&& /* error */, GradientType&& gradient)
 {
-  // Input2GateOutputWeight and input2GateOutputBias gradients.
-  gradient.submat(0, 0, input2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError * input.t());
-  gradient.submat(input2GateOutputWeight.n_elem, 0,
-      input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem - 1, 0) =
-      arma::sum(outputGateError, 1);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // Input2GateForgetWeight and input2GateForgetBias gradients.
-  gradient.submat(offset, 0, offset + input2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError * input.t());
-  gradient.submat(offset + input2GateForgetWeight.n_elem, 0,
-      offset + input2GateForgetWeight.n_elem +
-      input2GateForgetBias.n_elem - 1, 0) = arma::sum(forgetGateError, 1);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // Input2GateInputWeight and input2GateInputBias gradients.
-  gradient.submat(offset, 0, offset + input2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError * input.t());
-  gradient.submat(offset + input2GateInputWeight.n_elem, 0,
-      offset + input2GateInputWeight.n_elem +
-      input2GateInputBias.n_elem - 1, 0) = arma::sum(inputGateError, 1);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // Input2HiddenWeight and input2HiddenBias gradients.
-  gradient.submat(offset, 0, offset + input2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError * input.t());
-  gradient.submat(offset + input2HiddenWeight.n_elem, 0,
-      offset + input2HiddenWeight.n_elem + input2HiddenBias.n_elem - 1, 0) =
-      arma::sum(hiddenError, 1);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // Output2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateOutputWeight.n_elem;
-
-  // Output2GateForgetWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateForgetWeight.n_elem;
-
-  // Output2GateInputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateInputWeight.n_elem;
-
-  // Output2HiddenWeight gradients.
-  gradient.submat(offset, 0, offset + output2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2HiddenWeight.n_elem;
-
-  // Cell2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + cell2GateOutputWeight.n_elem - 1, 0) =
-      arma::sum(outputGateError %
-      cell.cols(gradientStep - batchStep, gradientStep), 1);
-  offset += cell2GateOutputWeight.n_elem;
+  typedef typename OutputDataType::elem_type ElemType;
+  ElemType* gradientPtr = gradient.memptr();
+
+  // Input to gate weight and bias gradients.
+  OutputDataType(gradientPtr, 4 * outSize, inSize, false, true) =
+      gateError * input.t();
+  gradientPtr += input2GateWeight.n_elem;
+  OutputDataType(gradientPtr, 4 * outSize, 1, false, true) =
+      arma::sum(gateError, 1);
+  gradientPtr += input2GateBias.n_elem;
+
+  // Output to gate weight gradients.
+  OutputDataType(gradientPtr, 4 * outSize, outSize, false, true) = gateError *
+      OutputDataType(outParameter.colptr(gradientStep - batchStep), outSize,
+      batchSize, false, true).t();
+  gradientPtr += output2GateWeight.n_elem;
+
+  // Peephole gradients; the input and forget gates see the previous cell, and
+  // the output gate sees the current cell.
+  OutputDataType inputPeepholeGradient(gradientPtr, outSize, 1, false, true);
+  OutputDataType forgetPeepholeGradient(gradientPtr + outSize, outSize, 1,
+      false, true);
+  OutputDataType outputPeepholeGradient(gradientPtr + 2 * outSize, outSize, 1,
+      false, true);
 
-  // Cell2GateForgetWeight and cell2GateInputWeight gradients.
   if (gradientStep > batchStep)
   {
-    gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
-        arma::sum(forgetGateError %
-                  cell.cols((gradientStep - batchSize) - batchStep,
-                            (gradientStep - batchSize)), 1);
-    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
-        arma::sum(inputGateError %
-                  cell.cols((gradientStep - batchSize) - batchStep,
-                            (gradientStep - batchSize)), 1);
+    const auto prevCell = cell.cols((gradientStep - batchSize) - batchStep,
+        gradientStep - batchSize);
+    inputPeepholeGradient = arma::sum(gateError.rows(0, outSize - 1) %
+        prevCell, 1);
+    forgetPeepholeGradient = arma::sum(gateError.rows(2 * outSize,
+        3 * outSize - 1) % prevCell, 1);
   }
   else
   {
-    gradient.submat(offset, 0, offset +
-        cell2GateForgetWeight.n_elem - 1, 0).zeros();
-    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem +
-        cell2GateInputWeight.n_elem - 1, 0).zeros();
+    inputPeepholeGradient.zeros();
+    forgetPeepholeGradient.zeros();
   }
 
+  outputPeepholeGradient = arma::sum(gateError.rows(outSize, 2 * outSize - 1) %
+      cell.cols(gradientStep - batchStep, gradientStep), 1);
+
   if (gradientStep == 0)
   {
     gradientStep = batchSize * bpttSteps - 1;
@@ -429,7 +393,7 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void LSTM<InputDataType, OutputDataType>::serialize(
-    Archive& ar, const unsigned int /* version */)
+    Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(weights);
   ar & BOOST_SERIALIZATION_NVP(inSize);
@@ -443,13 +407,37 @@ void LSTM<InputDataType, OutputDataType>::serialize(
   ar & BOOST_SERIALIZATION_NVP(gradientStep);
   ar & BOOST_SERIALIZATION_NVP(gradientStepIdx);
   ar & BOOST_SERIALIZATION_NVP(cell);
-  ar & BOOST_SERIALIZATION_NVP(inputGateActivation);
-  ar & BOOST_SERIALIZATION_NVP(forgetGateActivation);
-  ar & BOOST_SERIALIZATION_NVP(outputGateActivation);
-  ar & BOOST_SERIALIZATION_NVP(hiddenLayerActivation);
+
+  if (version == 0)
+  {
+    // The weights are rearranged by the next call to Reset(), once they have
+    // been set to their final location.
+    legacyWeights = true;
+
+    // The activations of the gates are stored separately too.
+    OutputDataType inputGateActivation, forgetGateActivation,
+        outputGateActivation, hiddenLayerActivation;
+    ar & BOOST_SERIALIZATION_NVP(inputGateActivation);
+    ar & BOOST_SERIALIZATION_NVP(forgetGateActivation);
+    ar & BOOST_SERIALIZATION_NVP(outputGateActivation);
+    ar & BOOST_SERIALIZATION_NVP(hiddenLayerActivation);
+    gateActivation = arma::join_cols(
+        arma::join_cols(inputGateActivation, outputGateActivation),
+        arma::join_cols(forgetGateActivation, hiddenLayerActivation));
+  }
+  else
+  {
+    ar & BOOST_SERIALIZATION_NVP(gateActivation);
+  }
+
   ar & BOOST_SERIALIZATION_NVP(cellActivation);
   ar & BOOST_SERIALIZATION_NVP(prevError);
   ar & BOOST_SERIALIZATION_NVP(outParameter);
+
+  // The errors of the gates aren't stored, and older models store the error
+  // of all four gates as the previous error.
+  if (Archive::is_loading::value)
+    ResetErrors();
 }
 
 } // namespace ann
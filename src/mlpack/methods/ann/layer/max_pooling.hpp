@@ -136,55 +136,47 @@ class MaxPooling
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
- /**
-   * Apply pooling to the input and store the results.
+  /**
+   * Apply pooling to one slice (one channel of one point) of the input.  The
+   * windows are scanned column by column, and the first maximum in that order
+   * is taken, as MaxPoolingRule does.
    *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
+   * @param input The slice of the input, of size inputWidth x inputHeight.
+   * @param output The pooled slice, of size outputWidth x outputHeight.
+   * @param poolingIndices The index in the input slice of the maximum of each
+   *     window; this is not written if it is NULL.
    */
   template<typename eT>
-  void PoolingOperation(const arma::Mat<eT>& input,
-                        arma::Mat<eT>& output,
-                        arma::Mat<eT>& poolingIndices)
+  void PoolingOperation(const eT* input,
+                        eT* output,
+                        size_t* poolingIndices) const
   {
-    for (size_t j = 0, colidx = 0; j < output.n_cols; ++j, colidx += dW)
+    for (size_t j = 0, colidx = 0; j < outputHeight; ++j, colidx += dW)
     {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dH)
+      const size_t colEnd = std::min(colidx + kH - offset, inputHeight);
+      for (size_t i = 0, rowidx = 0; i < outputWidth; ++i, rowidx += dH)
       {
-        arma::mat subInput = input(arma::span(rowidx, rowidx + kW - 1 - offset),
-            arma::span(colidx, colidx + kH - 1 - offset));
-
-        const size_t idx = pooling.Pooling(subInput);
-        output(i, j) = subInput(idx);
+        const size_t rowEnd = std::min(rowidx + kW - offset, inputWidth);
 
-        if (!deterministic)
+        size_t bestIndex = colidx * inputWidth + rowidx;
+        eT best = input[bestIndex];
+        for (size_t c = colidx; c < colEnd; ++c)
         {
-          arma::Mat<size_t> subIndices = indices(arma::span(rowidx,
-              rowidx + kW - 1 - offset),
-              arma::span(colidx, colidx + kH - 1 - offset));
-
-          poolingIndices(i, j) = subIndices(idx);
+          const eT* column = input + c * inputWidth;
+          for (size_t r = rowidx; r < rowEnd; ++r)
+          {
+            if (column[r] > best)
+            {
+              best = column[r];
+              bestIndex = c * inputWidth + r;
+            }
+          }
         }
-      }
-    }
-  }
 
-  /**
-   * Apply unpooling to the input and store the results.
-   *
-   * @param error The backward error.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
-   */
-  template<typename eT>
-  void Unpooling(const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output,
-                 arma::Mat<eT>& poolingIndices)
-  {
-    for (size_t i = 0; i < poolingIndices.n_elem; ++i)
-    {
-      output(poolingIndices(i)) += error(i);
+        output[j * outputWidth + i] = best;
+        if (poolingIndices)
+          poolingIndices[j * outputWidth + i] = bestIndex;
+      }
     }
   }
 
@@ -209,9 +201,6 @@ class MaxPooling
   //! Locally-stored number of output channels.
   size_t outSize;
 
-  //! Locally-stored reset parameter used to initialize the module once.
-  bool reset;
-
   //! Locally-stored input width.
   size_t inputWidth;
 
@@ -233,18 +222,6 @@ class MaxPooling
   //! Locally-stored number of input units.
   size_t batchSize;
 
-  //! Locally-stored output parameter.
-  arma::cube outputTemp;
-
-  //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
-
-  //! Locally-stored transformed output parameter.
-  arma::cube gTemp;
-
-  //! Locally-stored pooling strategy.
-  MaxPoolingRule pooling;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -254,14 +231,13 @@ class MaxPooling
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored indices matrix parameter.
-  arma::Mat<size_t> indices;
-
-  //! Locally-stored indices column parameter.
-  arma::Col<size_t> indicesCol;
+  //! Locally-stored pooling indices of the forward passes that have not been
+  //! backpropagated yet (the first poolingDepth elements); the buffers are kept
+  //! and reused by later passes.
+  std::vector<arma::Col<size_t> > poolingIndices;
 
-  //! Locally-stored pooling indicies.
-  std::vector<arma::cube> poolingIndices;
+  //! Number of forward passes that have not been backpropagated yet.
+  size_t poolingDepth;
 }; // class MaxPooling
 
 } // namespace ann
@@ -20,7 +20,8 @@ namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
 template<typename InputDataType, typename OutputDataType>
-MaxPooling<InputDataType, OutputDataType>::MaxPooling()
+MaxPooling<InputDataType, OutputDataType>::MaxPooling() :
+    poolingDepth(0)
 {
   // Nothing to do here.
 }
@@ -39,14 +40,14 @@ MaxPooling<InputDataType, OutputDataType>::MaxPooling(
     floor(floor),
     inSize(0),
     outSize(0),
-    reset(false),
     inputWidth(0),
     inputHeight(0),
     outputWidth(0),
     outputHeight(0),
     deterministic(false),
     offset(0),
-    batchSize(0)
+    batchSize(0),
+    poolingDepth(0)
 {
   // Nothing to do here.
 }
@@ -58,8 +59,6 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
 {
   batchSize = input.n_cols;
   inSize = input.n_elem / (inputWidth * inputHeight * batchSize);
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&&>(input).memptr(),
-      inputWidth, inputHeight, batchSize * inSize, false, false);
 
   if (floor)
   {
@@ -74,45 +73,31 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
+  // Every slice is one channel of one point.
+  const size_t slices = batchSize * inSize;
+  const size_t inputSliceSize = inputWidth * inputHeight;
+  const size_t outputSliceSize = outputWidth * outputHeight;
+  output.set_size(outputSliceSize * inSize, batchSize);
 
+  size_t* indices = NULL;
   if (!deterministic)
   {
-    poolingIndices.push_back(outputTemp);
+    // Reuse the buffer of an earlier pass if there is one.
+    if (poolingIndices.size() == poolingDepth)
+      poolingIndices.push_back(arma::Col<size_t>());
+    poolingIndices[poolingDepth].set_size(outputSliceSize * slices);
+    indices = poolingIndices[poolingDepth].memptr();
+    ++poolingDepth;
   }
 
-  if (!reset)
+  for (size_t s = 0; s < slices; s++)
   {
-    size_t elements = inputWidth * inputHeight;
-    indicesCol = arma::linspace<arma::Col<size_t> >(0, (elements - 1),
-        elements);
-
-    indices = arma::Mat<size_t>(indicesCol.memptr(), inputWidth, inputHeight);
-
-    reset = true;
-  }
-
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-  {
-    if (!deterministic)
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-        poolingIndices.back().slice(s));
-    }
-    else
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-          inputTemp.slice(s));
-    }
+    PoolingOperation(input.memptr() + s * inputSliceSize,
+        output.memptr() + s * outputSliceSize,
+        indices ? indices + s * outputSliceSize : NULL);
   }
 
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
-      batchSize);
-
-  outputWidth = outputTemp.n_rows;
-  outputHeight = outputTemp.n_cols;
-  outSize = batchSize * inSize;
+  outSize = slices;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -120,21 +105,20 @@ template<typename eT>
 void MaxPooling<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  arma::cube mappedError = arma::cube(gy.memptr(), outputWidth,
-      outputHeight, outSize, false, false);
-
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
-
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  const size_t inputSliceSize = inputWidth * inputHeight;
+  const size_t outputSliceSize = outputWidth * outputHeight;
+  g.zeros(inputSliceSize * inSize, batchSize);
+
+  // Route the error of every window to its maximum.
+  --poolingDepth;
+  const size_t* indices = poolingIndices[poolingDepth].memptr();
+  const eT* error = gy.memptr();
+  for (size_t s = 0; s < outSize; s++)
   {
-    Unpooling(mappedError.slice(s), gTemp.slice(s),
-        poolingIndices.back().slice(s));
+    eT* slice = g.memptr() + s * inputSliceSize;
+    for (size_t k = s * outputSliceSize; k < (s + 1) * outputSliceSize; ++k)
+      slice[indices[k]] += error[k];
   }
-
-  poolingIndices.pop_back();
-
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
 }
 
 template<typename InputDataType, typename OutputDataType>
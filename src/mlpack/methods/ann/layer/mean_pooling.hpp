@@ -123,20 +123,25 @@ class MeanPooling
    * @param output The pooled result.
    */
   template<typename eT>
-  void Pooling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+  void Pooling(const eT* input, eT* output) const
   {
-    const size_t rStep = kW;
-    const size_t cStep = kH;
-
-    for (size_t j = 0, colidx = 0; j < output.n_cols; ++j, colidx += dH)
+    for (size_t j = 0, colidx = 0; j < outputHeight; ++j, colidx += dH)
     {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dW)
+      const size_t colEnd = std::min(colidx + kH - offset, inputHeight);
+      for (size_t i = 0, rowidx = 0; i < outputWidth; ++i, rowidx += dW)
       {
-        arma::mat subInput = input(
-            arma::span(rowidx, rowidx + rStep - 1 - offset),
-            arma::span(colidx, colidx + cStep - 1 - offset));
-
-        output(i, j) = arma::mean(arma::mean(subInput));
+        const size_t rowEnd = std::min(rowidx + kW - offset, inputWidth);
+
+        eT sum = 0;
+        for (size_t c = colidx; c < colEnd; ++c)
+        {
+          const eT* column = input + c * inputWidth;
+          for (size_t r = rowidx; r < rowEnd; ++r)
+            sum += column[r];
+        }
+
+        output[j * outputWidth + i] = sum / ((rowEnd - rowidx) *
+            (colEnd - colidx));
       }
     }
   }
@@ -155,19 +160,13 @@ class MeanPooling
     const size_t rStep = input.n_rows / error.n_rows - offset;
     const size_t cStep = input.n_cols / error.n_cols - offset;
 
-    arma::Mat<eT> unpooledError;
     for (size_t j = 0; j < input.n_cols - cStep; j += cStep)
     {
       for (size_t i = 0; i < input.n_rows - rStep; i += rStep)
       {
-        const arma::Mat<eT>& inputArea = input(arma::span(i, i + rStep - 1),
-            arma::span(j, j + cStep - 1));
-
-        unpooledError = arma::Mat<eT>(inputArea.n_rows, inputArea.n_cols);
-        unpooledError.fill(error(i / rStep, j / cStep) / inputArea.n_elem);
-
         output(arma::span(i, i + rStep - 1 - offset),
-            arma::span(j, j + cStep - 1 - offset)) += unpooledError;
+            arma::span(j, j + cStep - 1 - offset)) +=
+            error(i / rStep, j / cStep) / (rStep * cStep);
       }
     }
   }
@@ -217,9 +216,6 @@ class MeanPooling
   //! Locally-stored number of input units.
   size_t batchSize;
 
-  //! Locally-stored output parameter.
-  arma::cube outputTemp;
-
   //! Locally-stored transformed input parameter.
   arma::cube inputTemp;
 
@@ -76,17 +76,12 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
-
+  // Pool every slice (one channel of one point) directly into the output.
+  const size_t outputSliceSize = outputWidth * outputHeight;
+  output.set_size(outputSliceSize * inSize, batchSize);
   for (size_t s = 0; s < inputTemp.n_slices; s++)
-    Pooling(inputTemp.slice(s), outputTemp.slice(s));
-
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
-      batchSize);
+    Pooling(inputTemp.slice_memptr(s), output.memptr() + s * outputSliceSize);
 
-  outputWidth = outputTemp.n_rows;
-  outputHeight = outputTemp.n_cols;
   outSize = batchSize * inSize;
 }
 
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_MULTIPLY_CONSTANT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -87,6 +88,23 @@ class MultiplyConstant
   OutputDataType outputParameter;
 }; // class MultiplyConstant
 
+/**
+ * MultiplyConstant is elementwise, and its Backward() function only uses the
+ * constant.
+ */
+template<typename InputDataType, typename OutputDataType>
+class LayerTraits<MultiplyConstant<InputDataType, OutputDataType>>
+{
+ public:
+  static const bool IsBinary = false;
+  static const bool IsOutputLayer = false;
+  static const bool IsBiasLayer = false;
+  static const bool IsLSTMLayer = false;
+  static const bool IsConnection = false;
+  static const bool IsInPlace = true;
+  static const bool BackwardUsesOutput = false;
+};
+
 } // namespace ann
 } // namespace mlpack
 
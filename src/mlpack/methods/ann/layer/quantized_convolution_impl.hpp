@@ -0,0 +1,183 @@
+/**
+ * @file quantized_convolution_impl.hpp
+ *
+ * Implementation of the QuantizedConvolution layer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedConvolution<InputDataType, OutputDataType>::QuantizedConvolution() :
+    inSize(0),
+    outSize(0),
+    kW(0),
+    kH(0),
+    dW(1),
+    dH(1),
+    padW(0),
+    padH(0),
+    inputWidth(0),
+    inputHeight(0),
+    outputWidth(0),
+    outputHeight(0),
+    inputScale(0.0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedConvolution<InputDataType, OutputDataType>::QuantizedConvolution(
+    const size_t inSize,
+    const size_t outSize,
+    const size_t kW,
+    const size_t kH,
+    const size_t dW,
+    const size_t dH,
+    const size_t padW,
+    const size_t padH,
+    const size_t inputWidth,
+    const size_t inputHeight,
+    const arma::mat& weights,
+    const double inputRange) :
+    inSize(inSize),
+    outSize(outSize),
+    kW(kW),
+    kH(kH),
+    dW(dW),
+    dH(dH),
+    padW(padW),
+    padH(padH),
+    inputWidth(inputWidth),
+    inputHeight(inputHeight),
+    outputWidth(0),
+    outputHeight(0),
+    inputScale(inputRange / 127.0)
+{
+  // The filters of each output map are contiguous in the parameters of the
+  // Convolution layer, in the order of the rows of the im2col patches.
+  const size_t filterSize = kW * kH * inSize;
+  const arma::mat filters(const_cast<double*>(weights.memptr()), filterSize,
+      outSize, false, true);
+  Int8Gemm::QuantizeColumns(filters, weight, weightScale);
+
+  bias = weights.rows(filterSize * outSize, filterSize * outSize + outSize -
+      1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedConvolution<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  const size_t batchSize = input.n_cols;
+
+  arma::Mat<int8_t> quantized;
+  Int8Gemm::Quantize(input, inputScale, quantized);
+  arma::Cube<int8_t> maps(quantized.memptr(), inputWidth, inputHeight,
+      inSize * batchSize, false, true);
+
+  // Zero is quantized exactly, so the quantized input can be padded.
+  if (padW != 0 || padH != 0)
+  {
+    quantizedInput.zeros(inputWidth + 2 * padW, inputHeight + 2 * padH,
+        maps.n_slices);
+    quantizedInput.tube(padW, padH, padW + inputWidth - 1,
+        padH + inputHeight - 1) = maps;
+  }
+
+  const arma::Cube<int8_t>& paddedMaps = (padW != 0 || padH != 0) ?
+      quantizedInput : maps;
+
+  outputWidth = (paddedMaps.n_rows - kW) / dW + 1;
+  outputHeight = (paddedMaps.n_cols - kH) / dH + 1;
+  const size_t mapSize = outputWidth * outputHeight;
+
+  Im2ColConvolution<>::Im2Col(paddedMaps, kW, kH, inSize, outputWidth,
+      outputHeight, dW, dH, 1, 1, columns);
+  Int8Gemm::Multiply(weight, columns, product);
+
+  output.set_size(mapSize * outSize, batchSize);
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    eT* outputPtr = output.colptr(b);
+    for (size_t o = 0; o < outSize; ++o)
+    {
+      const double scale = weightScale[o] * inputScale;
+      for (size_t i = 0; i < mapSize; ++i)
+        *outputPtr++ = product(o, b * mapSize + i) * scale + bias(o);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedConvolution<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  const size_t batchSize = gy.n_cols;
+
+  arma::mat dequantizedWeight = arma::conv_to<arma::mat>::from(weight);
+  dequantizedWeight.each_row() %= weightScale.t();
+  const arma::cube filters(dequantizedWeight.memptr(), kW, kH,
+      outSize * inSize, false, true);
+
+  const arma::cube mappedError(gy.memptr(), outputWidth, outputHeight,
+      outSize * batchSize, false, true);
+
+  g.set_size(inputWidth * inputHeight * inSize, batchSize);
+  arma::cube gTemp(g.memptr(), inputWidth, inputHeight, inSize * batchSize,
+      false, true);
+
+  if (padW != 0 || padH != 0)
+  {
+    arma::cube paddedG(inputWidth + 2 * padW, inputHeight + 2 * padH,
+        inSize * batchSize);
+    Im2ColConvolution<>::Backward(mappedError, filters, paddedG, inSize, dW,
+        dH);
+
+    gTemp = paddedG.tube(padW, padH, padW + inputWidth - 1,
+        padH + inputHeight - 1);
+  }
+  else
+  {
+    Im2ColConvolution<>::Backward(mappedError, filters, gTemp, inSize, dW,
+        dH);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void QuantizedConvolution<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+  ar & BOOST_SERIALIZATION_NVP(kW);
+  ar & BOOST_SERIALIZATION_NVP(kH);
+  ar & BOOST_SERIALIZATION_NVP(dW);
+  ar & BOOST_SERIALIZATION_NVP(dH);
+  ar & BOOST_SERIALIZATION_NVP(padW);
+  ar & BOOST_SERIALIZATION_NVP(padH);
+  ar & BOOST_SERIALIZATION_NVP(inputWidth);
+  ar & BOOST_SERIALIZATION_NVP(inputHeight);
+  ar & BOOST_SERIALIZATION_NVP(weight);
+  ar & BOOST_SERIALIZATION_NVP(weightScale);
+  ar & BOOST_SERIALIZATION_NVP(bias);
+  ar & BOOST_SERIALIZATION_NVP(inputScale);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
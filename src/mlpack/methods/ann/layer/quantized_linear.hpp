@@ -0,0 +1,146 @@
+/**
+ * @file quantized_linear.hpp
+ *
+ * Definition of the QuantizedLinear layer class, an inference-only linear
+ * layer with 8-bit integer weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "int8_gemm.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the QuantizedLinear layer class, which computes the same
+ * affine transformation as the Linear (or LinearNoBias) layer it was created
+ * from, with the weights stored as 8-bit integers with one scale per output
+ * unit.  The input is quantized with a fixed scale, calibrated on a sample of
+ * the data (see FFN::Quantize()), and the product is computed in integer
+ * arithmetic.  The layer has no trainable parameters; the Backward() function
+ * only passes the error through the dequantized weights.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class QuantizedLinear
+{
+ public:
+  //! Create the QuantizedLinear object.
+  QuantizedLinear();
+
+  /**
+   * Create the QuantizedLinear layer object from the given weights.
+   *
+   * @param weight The weight matrix (output units x input units).
+   * @param bias The bias of each output unit; an empty matrix means no bias.
+   * @param inputRange The largest absolute value of the input; larger values
+   *     are clipped.
+   */
+  QuantizedLinear(const arma::mat& weight,
+                  const arma::mat& bias,
+                  const double inputRange);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>&& /* input */,
+                arma::Mat<eT>&& gy,
+                arma::Mat<eT>&& g);
+
+  //! Get the quantized weights (input units x output units).
+  const arma::Mat<int8_t>& Weight() const { return weight; }
+  //! Get the scale of the weights of each output unit.
+  const arma::vec& WeightScale() const { return weightScale; }
+  //! Get the bias.
+  const OutputDataType& Bias() const { return bias; }
+  //! Get the scale the input is quantized with.
+  double InputScale() const { return inputScale; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Locally-stored quantized weights; column i holds the weights of output
+  //! unit i.
+  arma::Mat<int8_t> weight;
+
+  //! Locally-stored scale of the weights of each output unit.
+  arma::vec weightScale;
+
+  //! Locally-stored bias term parameters.
+  OutputDataType bias;
+
+  //! Locally-stored scale the input is quantized with.
+  double inputScale;
+
+  //! Locally-stored quantized input.
+  arma::Mat<int8_t> quantizedInput;
+
+  //! Locally-stored integer product of the weights and the input.
+  arma::Mat<int32_t> product;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class QuantizedLinear
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_linear_impl.hpp"
+
+#endif
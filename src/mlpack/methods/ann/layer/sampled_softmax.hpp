@@ -0,0 +1,267 @@
+/**
+ * @file sampled_softmax.hpp
+ *
+ * Definition of the SampledSoftmax layer, a softmax output layer for large
+ * numbers of classes that is trained on a sample of the classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SAMPLED_SOFTMAX_HPP
+#define MLPACK_METHODS_ANN_LAYER_SAMPLED_SOFTMAX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The sampled softmax layer is a linear layer followed by a log softmax over a
+ * large number of classes, where the training only evaluates the scores of the
+ * targets and of a few classes sampled from a proposal distribution Q.  The
+ * samples of a batch are shared by all of its points, and the scores are
+ * corrected by log(numSamples * Q(c)), so that the gradient is an unbiased
+ * estimate of the gradient of the full softmax for large sample sizes; a
+ * sampled class equal to the target of a point is left out for that point.
+ * This is the method of
+ *
+ * @code
+ * @inproceedings{jean2015using,
+ *   title     = {On Using Very Large Target Vocabulary for Neural Machine
+ *                Translation},
+ *   author    = {Jean, S{\'e}bastien and Cho, Kyunghyun and Memisevic, Roland
+ *                and Bengio, Yoshua},
+ *   booktitle = {Proceedings of the 53rd Annual Meeting of the Association for
+ *                Computational Linguistics},
+ *   pages     = {1--10},
+ *   year      = {2015}
+ * }
+ * @endcode
+ *
+ * A training step takes O(hidden * (numSamples + batch)) time instead of
+ * O(hidden * classes * batch).  In deterministic mode (FFN::Predict()) the
+ * layer outputs the log-probabilities of all classes.  During training it
+ * outputs the (sampled) negative log likelihood of the target of every point,
+ * as a row vector, so the network has to use the LargeSoftmaxLoss output layer.
+ * The layer needs the targets in the forward pass; FFN passes them before
+ * every training step.
+ *
+ * The weights of a class are stored in one column of the parameters, followed
+ * by its bias, so that the parameters form a (inSize + 1) x numClasses matrix.
+ *
+ * The layer is not part of LayerTypes, so it has to be given as a custom layer
+ * of the network:
+ *
+ * @code
+ * FFN<LargeSoftmaxLoss<>, RandomInitialization, SampledSoftmax<>> model;
+ * model.Add<Lookup<>>(numItems, embeddingSize);
+ * ...
+ * model.Add<SampledSoftmax<>>(hiddenSize, numClasses, 100);
+ * @endcode
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class SampledSoftmax
+{
+ public:
+  //! Create the SampledSoftmax object.
+  SampledSoftmax();
+
+  /**
+   * Create the SampledSoftmax layer object.
+   *
+   * @param inSize The number of input units.
+   * @param numClasses The number of classes.
+   * @param numSamples The number of classes sampled for every batch.
+   * @param proposal The (unnormalized) probabilities of the classes to be
+   *     sampled, e.g. their frequencies; every class needs a positive
+   *     probability.  If empty, the classes are sampled uniformly.
+   */
+  SampledSoftmax(const size_t inSize,
+                 const size_t numClasses,
+                 const size_t numSamples,
+                 const arma::vec& proposal = arma::vec());
+
+  /**
+   * Ordinary feed forward pass of a neural network.  In deterministic mode the
+   * output holds the log-probabilities of all classes, otherwise the sampled
+   * negative log likelihood of the target of every point.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, using the scores of the
+   * last (training) forward pass.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>&& /* input */,
+                arma::Mat<eT>&& gy,
+                arma::Mat<eT>&& g);
+
+  /*
+   * Calculate the gradient of the weights of the sampled and target classes;
+   * this has to follow Backward().
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>&& input,
+                arma::Mat<eT>&& /* error */,
+                arma::Mat<eT>&& gradient);
+
+  //! Get the parameters.
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the targets of the batch.
+  arma::mat const& Target() const { return target; }
+  //! Modify the targets of the batch.
+  arma::mat& Target() { return target; }
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return gradient; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return gradient; }
+
+  //! The value of the deterministic parameter.
+  bool Deterministic() const { return deterministic; }
+  //! Modify the value of the deterministic parameter.
+  bool& Deterministic() { return deterministic; }
+
+  //! Get the number of input units.
+  size_t InputSize() const { return inSize; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Get the number of classes sampled for every batch.
+  size_t NumSamples() const { return numSamples; }
+  //! Get the (normalized) proposal distribution; empty if it is uniform.
+  const arma::vec& Proposal() const { return proposal; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Normalize the proposal and compute its cumulative distribution.
+  void InitializeProposal();
+
+  //! Draw the sampled classes of a batch and their corrections.
+  void Sample();
+
+  //! Get log(numSamples * Q(c)) for the given class.
+  double Correction(const size_t c) const;
+
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of classes.
+  size_t numClasses;
+
+  //! Locally-stored number of classes sampled for every batch.
+  size_t numSamples;
+
+  //! The normalized proposal distribution (empty if uniform).
+  arma::vec proposal;
+
+  //! The cumulative proposal distribution.
+  arma::vec cumulative;
+
+  //! If true, the full softmax is computed.
+  bool deterministic;
+
+  //! Locally-stored weight object.
+  OutputDataType weights;
+
+  //! The targets of the batch.
+  arma::mat target;
+
+  //! The classes sampled for the batch.
+  arma::uvec samples;
+
+  //! The corrections of the scores of the sampled classes.
+  arma::vec corrections;
+
+  //! The weights of the sampled classes.
+  arma::mat sampledWeights;
+
+  //! The derivatives of the loss with respect to the sampled scores.
+  arma::mat coefficients;
+
+  //! The derivatives of the loss with respect to the target scores.
+  arma::rowvec targetCoefficients;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored gradient object.
+  OutputDataType gradient;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class SampledSoftmax
+
+/**
+ * The Backward() function of the SampledSoftmax layer only uses the scores of
+ * the forward pass, so the output may be overwritten.
+ */
+template<typename InputDataType, typename OutputDataType>
+class LayerTraits<SampledSoftmax<InputDataType, OutputDataType>>
+{
+ public:
+  static const bool IsBinary = false;
+  static const bool IsOutputLayer = false;
+  static const bool IsBiasLayer = false;
+  static const bool IsLSTMLayer = false;
+  static const bool IsConnection = false;
+  static const bool IsInPlace = false;
+  static const bool BackwardUsesOutput = false;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "sampled_softmax_impl.hpp"
+
+#endif
@@ -0,0 +1,249 @@
+/**
+ * @file sampled_softmax_impl.hpp
+ *
+ * Implementation of the SampledSoftmax layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SAMPLED_SOFTMAX_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_SAMPLED_SOFTMAX_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "sampled_softmax.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+SampledSoftmax<InputDataType, OutputDataType>::SampledSoftmax() :
+    inSize(0),
+    numClasses(0),
+    numSamples(0),
+    deterministic(false)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+SampledSoftmax<InputDataType, OutputDataType>::SampledSoftmax(
+    const size_t inSize,
+    const size_t numClasses,
+    const size_t numSamples,
+    const arma::vec& proposal) :
+    inSize(inSize),
+    numClasses(numClasses),
+    numSamples(numSamples),
+    proposal(proposal),
+    deterministic(false)
+{
+  if (numClasses < 2)
+    Log::Fatal << "SampledSoftmax: there have to be at least two classes."
+        << std::endl;
+
+  if (!proposal.is_empty() && (proposal.n_elem != numClasses ||
+      proposal.min() <= 0))
+  {
+    Log::Fatal << "SampledSoftmax: the proposal has to give a positive "
+        << "probability to each of the " << numClasses << " classes."
+        << std::endl;
+  }
+
+  InitializeProposal();
+  weights.set_size(inSize + 1, numClasses);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void SampledSoftmax<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  if (deterministic)
+  {
+    // The log softmax of the scores of all classes.
+    output = weights.head_rows(inSize).t() * input;
+    output.each_col() += weights.row(inSize).t();
+    for (size_t i = 0; i < output.n_cols; ++i)
+    {
+      eT* scores = output.colptr(i);
+      const eT maxScore = output.col(i).max();
+      eT sum = 0;
+      for (size_t j = 0; j < output.n_rows; ++j)
+        sum += std::exp(scores[j] - maxScore);
+
+      const eT logSum = maxScore + std::log(sum);
+      for (size_t j = 0; j < output.n_rows; ++j)
+        scores[j] -= logSum;
+    }
+
+    return;
+  }
+
+  if (target.n_cols != input.n_cols)
+  {
+    Log::Fatal << "SampledSoftmax::Forward(): the targets of the batch are not "
+        << "set; the layer has to be the last layer of an FFN." << std::endl;
+  }
+
+  // The scores of the sampled classes, for all points.
+  Sample();
+  sampledWeights = weights.cols(samples);
+  coefficients = sampledWeights.head_rows(inSize).t() * input;
+  coefficients.each_col() += sampledWeights.row(inSize).t() - corrections;
+
+  targetCoefficients.set_size(input.n_cols);
+  output.set_size(1, input.n_cols);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t currentTarget = target(i) - 1;
+    Log::Assert(currentTarget < numClasses, "Target class out of range.");
+
+    const eT targetScore = arma::dot(weights.col(currentTarget).head(inSize),
+        input.col(i)) + weights(inSize, currentTarget) -
+        Correction(currentTarget);
+
+    // Softmax over the target and the sampled classes that differ from it.
+    eT* scores = coefficients.colptr(i);
+    eT maxScore = targetScore;
+    for (size_t j = 0; j < numSamples; ++j)
+    {
+      if (samples[j] != currentTarget)
+        maxScore = std::max(maxScore, scores[j]);
+    }
+
+    eT sum = std::exp(targetScore - maxScore);
+    for (size_t j = 0; j < numSamples; ++j)
+    {
+      scores[j] = (samples[j] == currentTarget) ? 0 :
+          std::exp(scores[j] - maxScore);
+      sum += scores[j];
+    }
+
+    for (size_t j = 0; j < numSamples; ++j)
+      scores[j] /= sum;
+
+    targetCoefficients[i] = std::exp(targetScore - maxScore) / sum - 1;
+    output(0, i) = maxScore + std::log(sum) - targetScore;
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void SampledSoftmax<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  // Scale the derivatives by the error of every point; Gradient() uses the
+  // scaled derivatives.
+  coefficients.each_row() %= gy;
+  targetCoefficients %= gy;
+
+  g = sampledWeights.head_rows(inSize) * coefficients;
+  for (size_t i = 0; i < g.n_cols; ++i)
+  {
+    const size_t currentTarget = target(i) - 1;
+    g.col(i) += targetCoefficients[i] *
+        weights.col(currentTarget).head(inSize);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void SampledSoftmax<InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>&& input,
+    arma::Mat<eT>&& /* error */,
+    arma::Mat<eT>&& gradient)
+{
+  // Only the columns of the sampled and the target classes are nonzero.
+  gradient.zeros();
+
+  const arma::Mat<eT> sampledGradient = input * coefficients.t();
+  const arma::Col<eT> sampledBiasGradient = arma::sum(coefficients, 1);
+  for (size_t j = 0; j < numSamples; ++j)
+  {
+    gradient.col(samples[j]).head(inSize) += sampledGradient.col(j);
+    gradient(inSize, samples[j]) += sampledBiasGradient[j];
+  }
+
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t currentTarget = target(i) - 1;
+    gradient.col(currentTarget).head(inSize) += targetCoefficients[i] *
+        input.col(i);
+    gradient(inSize, currentTarget) += targetCoefficients[i];
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void SampledSoftmax<InputDataType, OutputDataType>::InitializeProposal()
+{
+  if (proposal.is_empty())
+  {
+    cumulative.clear();
+    return;
+  }
+
+  proposal /= arma::accu(proposal);
+  cumulative = arma::cumsum(proposal);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void SampledSoftmax<InputDataType, OutputDataType>::Sample()
+{
+  samples.set_size(numSamples);
+  corrections.set_size(numSamples);
+
+  // Armadillo's generator is used, since the replicas of a network may sample
+  // in parallel.
+  const arma::vec u = arma::randu<arma::vec>(numSamples);
+  for (size_t j = 0; j < numSamples; ++j)
+  {
+    if (cumulative.is_empty())
+    {
+      samples[j] = std::min((size_t) (u[j] * numClasses), numClasses - 1);
+    }
+    else
+    {
+      const double* position = std::upper_bound(cumulative.begin(),
+          cumulative.end(), u[j] * cumulative[numClasses - 1]);
+      samples[j] = std::min((size_t) (position - cumulative.begin()),
+          numClasses - 1);
+    }
+
+    corrections[j] = Correction(samples[j]);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+double SampledSoftmax<InputDataType, OutputDataType>::Correction(
+    const size_t c) const
+{
+  const double probability = proposal.is_empty() ? 1.0 / numClasses :
+      proposal[c];
+  return std::log(numSamples * probability);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void SampledSoftmax<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(numSamples);
+  ar & BOOST_SERIALIZATION_NVP(proposal);
+
+  // This is inefficient, but we have to allocate this memory so that
+  // WeightSetVisitor gets the right size.
+  if (Archive::is_loading::value)
+  {
+    InitializeProposal();
+    weights.set_size(inSize + 1, numClasses);
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
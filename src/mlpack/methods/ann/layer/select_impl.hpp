@@ -33,14 +33,10 @@ template<typename eT>
 void Select<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
-  if (elements == 0)
-  {
-    output = input.col(index);
-  }
-  else
-  {
-    output = input.submat(0, index, elements - 1, index);
-  }
+  // The selected elements are contiguous in the column, so the output points
+  // at the memory of the input instead of copying it.
+  output = arma::Mat<eT>(const_cast<eT*>(input.colptr(index)),
+      (elements == 0) ? input.n_rows : elements, 1, false, false);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -52,11 +48,11 @@ void Select<InputDataType, OutputDataType>::Backward(
 {
   if (elements == 0)
   {
-    g = gy;
+    g = arma::Mat<eT>(gy.memptr(), gy.n_rows, gy.n_cols, false, false);
   }
   else
   {
-    g = gy.submat(0, 0, elements - 1, 0);
+    g = arma::Mat<eT>(gy.memptr(), elements, 1, false, false);
   }
 }
 
@@ -0,0 +1,112 @@
+/**
+ * @file large_softmax_loss.hpp
+ *
+ * Definition of the LargeSoftmaxLoss class, the output layer of the softmax
+ * approximations for large numbers of classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTIONS_LARGE_SOFTMAX_LOSS_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTIONS_LARGE_SOFTMAX_LOSS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The output layer to use with the SampledSoftmax and HierarchicalSoftmax
+ * layers.  During training those layers only evaluate the classes they need
+ * for the targets, and they output the negative log likelihood of the target
+ * of every point, as a row vector; the loss is then the sum of that row.  In
+ * deterministic mode (e.g. in FFN::Predict() and FFN::Evaluate()) they output
+ * the log-probabilities of all classes, and the loss is the negative log
+ * likelihood, as for NegativeLogLikelihood.
+ *
+ * The layer expects a class index, in the range between 1 and the number of
+ * classes, as target.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class LargeSoftmaxLoss
+{
+ public:
+  /**
+   * Create the LargeSoftmaxLoss object.
+   */
+  LargeSoftmaxLoss();
+
+  /*
+   * Computes the negative log likelihood of the targets.
+   *
+   * @param input The negative log likelihood of every point, or the
+   *        log-probabilities of all classes.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   */
+  template<typename InputType, typename TargetType>
+  double Forward(const InputType&& input, TargetType&& target);
+
+  /**
+   * Ordinary feed backward pass of a neural network.
+   *
+   * @param input The negative log likelihood of every point, or the
+   *        log-probabilities of all classes.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   * @param output The calculated error.
+   */
+  template<typename InputType, typename TargetType, typename OutputType>
+  void Backward(const InputType&& input,
+                const TargetType&& target,
+                OutputType&& output);
+
+  //! Get the input parameter.
+  InputDataType& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */);
+
+ private:
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class LargeSoftmaxLoss
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "large_softmax_loss_impl.hpp"
+
+#endif
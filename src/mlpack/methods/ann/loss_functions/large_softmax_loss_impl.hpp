@@ -0,0 +1,83 @@
+/**
+ * @file large_softmax_loss_impl.hpp
+ *
+ * Implementation of the LargeSoftmaxLoss class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTIONS_LARGE_SOFTMAX_LOSS_IMPL_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTIONS_LARGE_SOFTMAX_LOSS_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "large_softmax_loss.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+LargeSoftmaxLoss<InputDataType, OutputDataType>::LargeSoftmaxLoss()
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType>
+double LargeSoftmaxLoss<InputDataType, OutputDataType>::Forward(
+    const InputType&& input, TargetType&& target)
+{
+  // The layers have at least two classes, so a single row holds the losses of
+  // the points.
+  if (input.n_rows == 1)
+    return arma::accu(input);
+
+  double output = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    size_t currentTarget = target(i) - 1;
+    Log::Assert(currentTarget < input.n_rows, "Target class out of range.");
+
+    output -= input(currentTarget, i);
+  }
+
+  return output;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType, typename OutputType>
+void LargeSoftmaxLoss<InputDataType, OutputDataType>::Backward(
+    const InputType&& input,
+    const TargetType&& target,
+    OutputType&& output)
+{
+  if (input.n_rows == 1)
+  {
+    output.ones(1, input.n_cols);
+    return;
+  }
+
+  output.zeros(input.n_rows, input.n_cols);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    size_t currentTarget = target(i) - 1;
+    Log::Assert(currentTarget < input.n_rows, "Target class out of range.");
+
+    output(currentTarget, i) = -1;
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void LargeSoftmaxLoss<InputDataType, OutputDataType>::serialize(
+    Archive& /* ar */,
+    const unsigned int /* version */)
+{
+  // Nothing to do here.
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
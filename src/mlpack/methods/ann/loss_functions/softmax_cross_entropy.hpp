@@ -0,0 +1,126 @@
+/**
+ * @file softmax_cross_entropy.hpp
+ *
+ * Definition of the SoftmaxCrossEntropy class, which fuses the log softmax
+ * layer and the negative log likelihood output layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SOFTMAX_CROSS_ENTROPY_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SOFTMAX_CROSS_ENTROPY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The softmax cross-entropy output layer computes the negative log likelihood
+ * of the softmax of its input.  It is equivalent to a LogSoftMax layer followed
+ * by the NegativeLogLikelihood output layer, but it takes the raw scores
+ * (logits) of the last layer directly: the loss of every column is computed as
+ * log(sum(exp(x - max(x)))) + max(x) - x(target), which is stable for large
+ * scores, and the gradient softmax(x) - onehot(target) is written straight into
+ * the error matrix.  No log-probability matrix or intermediate delta is stored,
+ * and every column is visited a constant number of times, so it is cheaper in
+ * both time and memory for networks with many classes.
+ *
+ * Like NegativeLogLikelihood, the layer expects a class index, in the range
+ * between 1 and the number of classes, as target.
+ *
+ * @code
+ * FFN<SoftmaxCrossEntropy<>> model;
+ * model.Add<Linear<>>(inputSize, numClasses);
+ * // No LogSoftMax layer at the end.
+ * @endcode
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class SoftmaxCrossEntropy
+{
+ public:
+  /**
+   * Create the SoftmaxCrossEntropy object.
+   */
+  SoftmaxCrossEntropy();
+
+  /*
+   * Computes the negative log likelihood of the softmax of the input.
+   *
+   * @param input The scores of the classes, one column per point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   */
+  template<typename InputType, typename TargetType>
+  double Forward(const InputType&& input, TargetType&& target);
+
+  /**
+   * Ordinary feed backward pass of a neural network; the gradient of the loss
+   * with respect to the scores is the softmax of the scores minus one for the
+   * target class.
+   *
+   * @param input The scores of the classes, one column per point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   * @param output The calculated error.
+   */
+  template<typename InputType, typename TargetType, typename OutputType>
+  void Backward(const InputType&& input,
+                const TargetType&& target,
+                OutputType&& output);
+
+  //! Get the input parameter.
+  InputDataType& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */);
+
+ private:
+  //! Get the zero-based target class of the given point, and check it.
+  template<typename TargetType>
+  static size_t Target(const TargetType& target,
+                       const size_t i,
+                       const size_t numClasses);
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class SoftmaxCrossEntropy
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "softmax_cross_entropy_impl.hpp"
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file softmax_cross_entropy_impl.hpp
+ *
+ * Implementation of the SoftmaxCrossEntropy class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SOFTMAX_CROSS_ENTROPY_IMPL_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SOFTMAX_CROSS_ENTROPY_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "softmax_cross_entropy.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+SoftmaxCrossEntropy<InputDataType, OutputDataType>::SoftmaxCrossEntropy()
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType>
+double SoftmaxCrossEntropy<InputDataType, OutputDataType>::Forward(
+    const InputType&& input, TargetType&& target)
+{
+  typedef typename InputType::elem_type ElemType;
+
+  double output = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t currentTarget = Target(target, i, input.n_rows);
+    const ElemType* scores = input.colptr(i);
+
+    ElemType maxScore = scores[0];
+    for (size_t j = 1; j < input.n_rows; ++j)
+      maxScore = std::max(maxScore, scores[j]);
+
+    double sum = 0;
+    for (size_t j = 0; j < input.n_rows; ++j)
+      sum += std::exp(scores[j] - maxScore);
+
+    output += std::log(sum) + maxScore - scores[currentTarget];
+  }
+
+  return output;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType, typename OutputType>
+void SoftmaxCrossEntropy<InputDataType, OutputDataType>::Backward(
+    const InputType&& input,
+    const TargetType&& target,
+    OutputType&& output)
+{
+  typedef typename InputType::elem_type ElemType;
+
+  // The error matrix of the network is reused from batch to batch, so this
+  // only allocates when the batch size changes.
+  output.set_size(input.n_rows, input.n_cols);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t currentTarget = Target(target, i, input.n_rows);
+    const ElemType* scores = input.colptr(i);
+    ElemType* gradient = output.colptr(i);
+
+    ElemType maxScore = scores[0];
+    for (size_t j = 1; j < input.n_rows; ++j)
+      maxScore = std::max(maxScore, scores[j]);
+
+    // Store the unnormalized probabilities, then scale them.
+    ElemType sum = 0;
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      gradient[j] = std::exp(scores[j] - maxScore);
+      sum += gradient[j];
+    }
+
+    const ElemType scale = 1 / sum;
+    for (size_t j = 0; j < input.n_rows; ++j)
+      gradient[j] *= scale;
+
+    gradient[currentTarget] -= 1;
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename TargetType>
+size_t SoftmaxCrossEntropy<InputDataType, OutputDataType>::Target(
+    const TargetType& target, const size_t i, const size_t numClasses)
+{
+  const size_t currentTarget = target(i) - 1;
+  Log::Assert(currentTarget < numClasses, "Target class out of range.");
+  return currentTarget;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void SoftmaxCrossEntropy<InputDataType, OutputDataType>::serialize(
+    Archive& /* ar */,
+    const unsigned int /* version */)
+{
+  // Nothing to do here.
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -56,6 +56,10 @@ class RBM
    * @param slabPenalty Regulariser of slab variables.
    * @param radius Feasible regions for visible layer samples.
    * @param persistence Indicates whether to use Persistent CD or not.
+   * @param numChains Number of persistent chains, which start at random
+   *        training points and are sampled together as one matrix (0 means one
+   *        chain per point of the batch, started at the batch).  This only
+   *        applies to the BinaryRBM, with persistence.
    */
   RBM(arma::Mat<ElemType> predictors,
       InitializationRuleType initializeRule,
@@ -67,7 +71,8 @@ class RBM
       const size_t poolSize = 2,
       const ElemType slabPenalty = 8,
       const ElemType radius = 1,
-      const bool persistence = false);
+      const bool persistence = false,
+      const size_t numChains = 0);
 
   // Reset the network.
   template<typename Policy = PolicyType>
@@ -151,7 +156,8 @@ class RBM
 
   /**
    * This function samples the hidden layer given the visible layer using
-   * Bernoulli function.
+   * Bernoulli function.  All the units of all the columns are sampled at once
+   * with math::RandBernoulliFill(), in parallel.
    *
    * @param input Visible layer input.
    * @param output The sampled hidden layer.
@@ -176,7 +182,8 @@ class RBM
 
   /**
    * This function samples the visible layer given the hidden layer using
-   * Bernoulli function.
+   * Bernoulli function.  All the units of all the columns are sampled at once
+   * with math::RandBernoulliFill(), in parallel.
    *
    * @param input Hidden layer of the network.
    * @param output The sampled visible layer.
@@ -329,6 +336,11 @@ class RBM
   //! Return the number of steps of Gibbs Sampling.
   size_t NumSteps() const { return numSteps; }
 
+  //! Get the number of persistent chains (0 means one per batch point).
+  size_t NumChains() const { return numChains; }
+  //! Modify the number of persistent chains (0 means one per batch point).
+  size_t& NumChains() { return numChains; }
+
   //! Return the parameters of the network.
   const arma::Mat<ElemType>& Parameters() const { return parameter; }
   //! Modify the parameters of the network.
@@ -374,6 +386,13 @@ class RBM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  //! Whether the negative samples come from numChains persistent chains.
+  bool UseChains() const
+  {
+    return persistence && numChains > 0 &&
+        std::is_same<PolicyType, BinaryRBM>::value;
+  }
+
   //! Locally stored parameters of the network.
   arma::Mat<ElemType> parameter;
   //! The matrix of data points (predictors).
@@ -398,6 +417,8 @@ class RBM
   size_t poolSize;
   //! Locally stored number of Sampling steps.
   size_t steps;
+  //! Locally-stored number of persistent chains.
+  size_t numChains;
   //! Locally stored weight of the network.
   arma::Cube<ElemType> weight;
   //! Locally stored biases of the visible layer.
@@ -35,7 +35,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::RBM(
     const size_t poolSize,
     const ElemType slabPenalty,
     const ElemType radius,
-    const bool persistence):
+    const bool persistence,
+    const size_t numChains):
     predictors(std::move(predictors)),
     initializeRule(initializeRule),
     visibleSize(visibleSize),
@@ -44,6 +45,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::RBM(
     numSteps(numSteps),
     negSteps(negSteps),
     poolSize(poolSize),
+    numChains(numChains),
     slabPenalty(slabPenalty),
     radius(2 * radius),
     persistence(persistence),
@@ -138,9 +140,11 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
   DataType visibleBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem +
       hiddenBiasGrad.n_elem, visibleSize, 1, false, false);
 
-  HiddenMean(std::move(input), std::move(hiddenBiasGrad));
-  weightGrad.slice(0) = hiddenBiasGrad * input.t();
-  visibleBiasGrad = input;
+  // The gradients are summed over the columns of the input.
+  HiddenMean(std::move(input), std::move(hiddenReconstruction));
+  weightGrad.slice(0) = hiddenReconstruction * input.t();
+  hiddenBiasGrad = arma::sum(hiddenReconstruction, 1);
+  visibleBiasGrad = arma::sum(input, 1);
 }
 
 template<
@@ -155,8 +159,14 @@ double RBM<InitializationRuleType, DataType, PolicyType>::Evaluate(
 {
   Gibbs(std::move(predictors.cols(i, i + batchSize - 1)),
       std::move(negativeSamples));
+
+  // The free energy sums over the columns, so the energy of the persistent
+  // chains is scaled to the batch.
+  const double negativeScale = !UseChains() ? 1.0 :
+      (double) batchSize / negativeSamples.n_cols;
   return std::fabs(FreeEnergy(std::move(predictors.cols(i,
-      i + batchSize - 1))) - FreeEnergy(std::move(negativeSamples)));
+      i + batchSize - 1))) - negativeScale *
+      FreeEnergy(std::move(negativeSamples)));
 }
 
 template<
@@ -171,11 +181,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
     arma::Mat<ElemType>&& output)
 {
   HiddenMean(std::move(input), std::move(output));
-
-  for (size_t i = 0; i < output.n_elem; i++)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  math::RandBernoulliFill(output);
 }
 
 template<
@@ -190,11 +196,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
     arma::Mat<ElemType>&& output)
 {
   VisibleMean(std::move(input), std::move(output));
-
-  for (size_t i = 0; i < output.n_elem; i++)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  math::RandBernoulliFill(output);
 }
 
 template<
@@ -239,6 +241,14 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gibbs(
 {
   this->steps = (steps == SIZE_MAX) ? this->numSteps : steps;
 
+  // Start the persistent chains at random training points.
+  if (UseChains() && state.is_empty())
+  {
+    state.set_size(visibleSize, numChains);
+    for (size_t c = 0; c < numChains; ++c)
+      state.col(c) = predictors.col(math::RandInt(predictors.n_cols));
+  }
+
   if (persistence && !state.is_empty())
   {
     SampleHidden(std::move(state), std::move(gibbsTemporary));
@@ -278,13 +288,19 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
   Phase(std::move(predictors.cols(i, i + batchSize - 1)),
       std::move(positiveGradient));
 
-  for (size_t i = 0; i < negSteps; i++)
+  // The gradients sum over the columns, so the gradient of the persistent
+  // chains is scaled to the batch.
+  for (size_t step = 0; step < negSteps; step++)
   {
     Gibbs(std::move(predictors.cols(i, i + batchSize - 1)),
         std::move(negativeSamples));
     Phase(std::move(negativeSamples), std::move(tempNegativeGradient));
 
-    negativeGradient += tempNegativeGradient;
+    if (!UseChains())
+      negativeGradient += tempNegativeGradient;
+    else
+      negativeGradient += ((double) batchSize / negativeSamples.n_cols) *
+          tempNegativeGradient;
   }
 
   gradient = ((negativeGradient / negSteps) - positiveGradient);
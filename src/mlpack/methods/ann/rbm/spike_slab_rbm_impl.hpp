@@ -162,10 +162,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
 
   for (k = 0; k < numMaxTrials; k++)
   {
-    for (size_t i = 0; i < visibleSize; i++)
-    {
-      output(i) = math::RandNormal(visibleMean(i), 1.0 / visiblePenalty(0));
-    }
+    math::RandNormalFill(output, 0.0, 1.0 / visiblePenalty(0));
+    output += visibleMean;
     if (arma::norm(output, 2) < radius)
     {
       break;
@@ -258,10 +256,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSpike(
     DataType&& spikeMean,
     DataType&& spike)
 {
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    spike(i) = math::RandBernoulli(spikeMean(i));
-  }
+  spike = spikeMean;
+  math::RandBernoulliFill(spike);
 }
 
 template<
@@ -294,13 +290,9 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSlab(
     DataType&& slabMean,
     DataType&& slab)
 {
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    for (size_t j = 0; j < poolSize; j++)
-    {
-      slab(j, i) = math::RandNormal(slabMean(j, i), 1.0 / slabPenalty);
-    }
-  }
+  DataType noise(slabMean.n_rows, slabMean.n_cols);
+  math::RandNormalFill(noise, 0.0, 1.0 / slabPenalty);
+  slab = slabMean + noise;
 }
 
 } // namespace ann
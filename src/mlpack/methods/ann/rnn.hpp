@@ -20,6 +20,7 @@
 #include "visitor/reset_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "batch_loader.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/init_rules/random_init.hpp>
@@ -31,6 +32,11 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard recurrent neural network container.
  *
+ * During training, the outputs that backpropagation through time reads are
+ * stored for each of the rho steps, so memory grows linearly with rho.  The
+ * recurrent state is reset at the start of every sequence; Predict() does not
+ * carry it over from one call to the next.
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  */
@@ -141,7 +147,8 @@ class RNN
    *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
-   * @param batchSize Number of points to predict at once.
+   * @param batchSize Number of points to predict at once; must be greater
+   *        than 0.
    */
   void Predict(arma::cube predictors,
                arma::cube& results,
@@ -259,6 +266,16 @@ class RNN
   //! Modify the matrix of data points (predictors).
   arma::cube& Predictors() { return predictors; }
 
+  //! Get the loader that gathers the batches during training.
+  const BatchLoader<arma::cube>& Loader() const { return batchLoader; }
+  /**
+   * Modify the loader that gathers the batches during training.  Once the data
+   * is shuffled (or if a transformation is set), the loader gathers every
+   * batch and prepares the next one in a background thread while the network
+   * trains on the current one.
+   */
+  BatchLoader<arma::cube>& Loader() { return batchLoader; }
+
   /**
    * Reset the state of the network.  This ensures that all internally-held
    * gradients are set to 0, all memory cells are reset, and the parameters
@@ -314,6 +331,24 @@ class RNN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Find the predictors and responses of the given batch, in the order of
+   * visitation.  The batch is either used straight from the data, or gathered
+   * by the loader; in both cases the batch is given by the columns of input
+   * and target starting at offset.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param input Set to the cube holding the predictors of the batch.
+   * @param target Set to the cube holding the responses of the batch.
+   * @param offset Set to the column of the first point in input and target.
+   */
+  void GatherBatch(const size_t begin,
+                   const size_t batchSize,
+                   arma::cube*& input,
+                   arma::cube*& target,
+                   size_t& offset);
+
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
 
@@ -348,6 +383,13 @@ class RNN
   //! The matrix of responses to the input data points.
   arma::cube responses;
 
+  //! The order in which the data points are visited (empty until the first
+  //! call to Shuffle(), which means the order of the data).
+  arma::Col<size_t> visitationOrder;
+
+  //! The loader that gathers shuffled batches and prepares the next one.
+  BatchLoader<arma::cube> batchLoader;
+
   //! Matrix of (trained) parameters.
   arma::mat parameter;
 
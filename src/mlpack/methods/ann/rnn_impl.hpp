@@ -21,6 +21,7 @@
 #include "visitor/backward_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/execution_step.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
 #include "visitor/weight_set_visitor.hpp"
@@ -69,6 +70,10 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
     arma::cube responses,
     OptimizerType& optimizer)
 {
+  // The loader may be preparing a batch of the old data.
+  batchLoader.Reset();
+  visitationOrder.reset();
+
   numFunctions = responses.n_cols;
 
   this->predictors = std::move(predictors);
@@ -109,6 +114,10 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
     arma::cube predictors,
     arma::cube responses)
 {
+  // The loader may be preparing a batch of the old data.
+  batchLoader.Reset();
+  visitationOrder.reset();
+
   numFunctions = responses.n_cols;
 
   this->predictors = std::move(predictors);
@@ -138,6 +147,10 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     arma::cube predictors, arma::cube& results, const size_t batchSize)
 {
+  if (batchSize == 0)
+    Log::Fatal << "RNN::Predict(): the batch size must be greater than 0."
+        << std::endl;
+
   ResetCells();
 
   if (parameter.is_empty())
@@ -198,6 +211,11 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     targetSize = responses.n_rows;
   }
 
+  arma::cube* input;
+  arma::cube* target;
+  size_t offset;
+  GatherBatch(begin, batchSize, input, target, offset);
+
   ResetCells();
 
   double performance = 0;
@@ -206,7 +224,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
   for (size_t seqNum = 0; seqNum < rho; ++seqNum)
   {
     // Wrap a matrix around our data to avoid a copy.
-    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
+    arma::mat stepData(input->slice(seqNum).colptr(offset),
         predictors.n_rows, batchSize, false, true);
     Forward(std::move(stepData));
     if (!single)
@@ -214,18 +232,9 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
       responseSeq = seqNum;
     }
 
-    if (!deterministic)
-    {
-      for (size_t l = 0; l < network.size(); ++l)
-      {
-        boost::apply_visitor(SaveOutputParameterVisitor(
-            std::move(moduleOutputParameter)), network[l]);
-      }
-    }
-
     performance += outputLayer.Forward(std::move(boost::apply_visitor(
         outputParameterVisitor, network.back())),
-        std::move(arma::mat(responses.slice(responseSeq).colptr(begin),
+        std::move(arma::mat(target->slice(responseSeq).colptr(offset),
             responses.n_rows, batchSize, false, true)));
   }
 
@@ -288,15 +297,33 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     targetSize = responses.n_rows;
   }
 
+  arma::cube* input;
+  arma::cube* target;
+  size_t offset;
+  GatherBatch(begin, batchSize, input, target, offset);
+
   ResetCells();
 
+  // Only the outputs that are read during backpropagation through time are
+  // kept for every step: the output of the last layer, the outputs of the
+  // layers whose Backward() function reads them, and the inputs of the layers
+  // that implement the Gradient() function.
+  std::vector<bool> saveOutput(network.size());
+  for (size_t l = 0; l < network.size(); ++l)
+  {
+    saveOutput[l] = (l == network.size() - 1) ||
+        boost::apply_visitor(ExecutionPlanVisitor(),
+        network[l]).BackwardUsesOutput() || boost::apply_visitor(
+        ExecutionPlanVisitor(), network[l + 1]).HasGradient();
+  }
+
   double performance = 0;
   size_t responseSeq = 0;
 
   for (size_t seqNum = 0; seqNum < rho; ++seqNum)
   {
     // Wrap a matrix around our data to avoid a copy.
-    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
+    arma::mat stepData(input->slice(seqNum).colptr(offset),
         predictors.n_rows, batchSize, false, true);
     Forward(std::move(stepData));
     if (!single)
@@ -304,9 +331,9 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       responseSeq = seqNum;
     }
 
-    if (!deterministic)
+    for (size_t l = 0; l < network.size(); ++l)
     {
-      for (size_t l = 0; l < network.size(); ++l)
+      if (saveOutput[l])
       {
         boost::apply_visitor(SaveOutputParameterVisitor(
             std::move(moduleOutputParameter)), network[l]);
@@ -315,7 +342,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
     performance += outputLayer.Forward(std::move(boost::apply_visitor(
         outputParameterVisitor, network.back())),
-        std::move(arma::mat(responses.slice(responseSeq).colptr(begin),
+        std::move(arma::mat(target->slice(responseSeq).colptr(offset),
             responses.n_rows, batchSize, false, true)));
   }
 
@@ -338,10 +365,13 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   {
     currentGradient.zeros();
 
-    for (size_t l = 0; l < network.size(); ++l)
+    for (size_t l = network.size(); l > 0; --l)
     {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          std::move(moduleOutputParameter)), network[network.size() - 1 - l]);
+      if (saveOutput[l - 1])
+      {
+        boost::apply_visitor(LoadOutputParameterVisitor(
+            std::move(moduleOutputParameter)), network[l - 1]);
+      }
     }
 
     if (single && seqNum > 0)
@@ -352,20 +382,20 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     {
       outputLayer.Backward(std::move(boost::apply_visitor(
           outputParameterVisitor, network.back())),
-          std::move(arma::mat(responses.slice(0).colptr(begin),
+          std::move(arma::mat(target->slice(0).colptr(offset),
           responses.n_rows, batchSize, false, true)), std::move(error));
     }
     else
     {
       outputLayer.Backward(std::move(boost::apply_visitor(
           outputParameterVisitor, network.back())),
-          std::move(arma::mat(responses.slice(rho - seqNum - 1).colptr(begin),
+          std::move(arma::mat(target->slice(rho - seqNum - 1).colptr(offset),
           responses.n_rows, batchSize, false, true)), std::move(error));
     }
 
     Backward();
     Gradient(std::move(
-        arma::mat(predictors.slice(rho - seqNum - 1).colptr(begin),
+        arma::mat(input->slice(rho - seqNum - 1).colptr(offset),
         predictors.n_rows, batchSize, false, true)));
     gradient += currentGradient;
   }
@@ -388,11 +418,42 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  arma::cube newPredictors, newResponses;
-  math::ShuffleData(predictors, responses, newPredictors, newResponses);
+  // Only the order of visitation is shuffled; the batches are gathered from
+  // the data as they are needed, instead of copying all of it every epoch.
+  // The loader may be preparing a batch in the old order.
+  batchLoader.Reset();
+  if (visitationOrder.n_elem != predictors.n_cols)
+  {
+    visitationOrder = arma::linspace<arma::Col<size_t>>(0,
+        predictors.n_cols - 1, predictors.n_cols);
+  }
+
+  std::shuffle(visitationOrder.begin(), visitationOrder.end(),
+      math::randGen);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::GatherBatch(const size_t begin,
+                                       const size_t batchSize,
+                                       arma::cube*& input,
+                                       arma::cube*& target,
+                                       size_t& offset)
+{
+  if (!batchLoader.Gathers(visitationOrder, begin, batchSize))
+  {
+    input = &predictors;
+    target = &responses;
+    offset = begin;
+    return;
+  }
 
-  predictors = std::move(newPredictors);
-  responses = std::move(newResponses);
+  // This also starts preparing the next batch.
+  batchLoader.Gather(predictors, responses, visitationOrder, begin, batchSize);
+  input = &batchLoader.Input();
+  target = &batchLoader.Target();
+  offset = 0;
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -0,0 +1,188 @@
+/**
+ * @file execution_step.hpp
+ *
+ * This file provides the ExecutionStep class, which holds a layer whose type
+ * has been resolved once, so that the Forward(), Backward(), Gradient() and
+ * Loss() functions of the layer can be called without visiting the layer
+ * variant each time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_EXECUTION_STEP_HPP
+#define MLPACK_METHODS_ANN_VISITOR_EXECUTION_STEP_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include "forward_visitor.hpp"
+#include "backward_visitor.hpp"
+#include "gradient_visitor.hpp"
+#include "loss_visitor.hpp"
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * An ExecutionStep is one step of the execution plan of a network: it holds a
+ * pointer to a layer together with functions that call the Forward(),
+ * Backward(), Gradient() and Loss() functions of the concrete layer type, and
+ * pointers to the output parameter and delta of the layer.  The type of the
+ * layer is resolved once, when the step is created (see ExecutionPlanVisitor),
+ * so running a step costs a single indirect call.
+ *
+ * The output parameter and delta of an elementwise layer (see
+ * LayerTraits::IsInPlace) may be shared with its neighbors, so that the layer
+ * runs in place and its own buffers are never used.
+ *
+ * A step does not own the layer; it is only valid as long as the layer lives.
+ */
+class ExecutionStep
+{
+ public:
+  //! Create the step for the given layer.
+  template<typename LayerType>
+  explicit ExecutionStep(LayerType* layer);
+
+  //! Run the Forward() function of the layer on the given input; the result is
+  //! stored in the output parameter of the layer.
+  void Forward(arma::mat& input) const
+  {
+    forward(layer, input, *outputParameter);
+  }
+
+  //! Run the Backward() function of the layer with the given error; the result
+  //! is stored in the delta of the layer.
+  void Backward(arma::mat& error) const
+  {
+    backward(layer, *outputParameter, error, *delta);
+  }
+
+  //! Run the Gradient() function of the layer with the given input and error,
+  //! if the layer has one.
+  void Gradient(arma::mat& input, arma::mat& error) const
+  {
+    if (gradient)
+      gradient(layer, input, error);
+  }
+
+  //! Get the loss of the layer (0 if the layer has none).
+  double Loss() const { return loss ? loss(layer) : 0.0; }
+
+  //! Get the output parameter of the layer.
+  arma::mat& OutputParameter() const { return *outputParameter; }
+  //! Get the delta of the layer.
+  arma::mat& Delta() const { return *delta; }
+
+  //! Return whether the layer can write its output over its input and its
+  //! delta over the backpropagated error.
+  bool IsInPlace() const { return isInPlace; }
+  //! Return whether the Backward() function of the layer reads its output.
+  bool BackwardUsesOutput() const { return backwardUsesOutput; }
+  //! Return whether the layer implements the Gradient() function.
+  bool HasGradient() const { return gradient != NULL; }
+
+  //! Store the output of the layer in the given matrix, which is the input of
+  //! the layer, instead of the output parameter of the layer.
+  void ShareOutputParameter(arma::mat& input) { outputParameter = &input; }
+  //! Store the delta of the layer in the given matrix, which is the
+  //! backpropagated error of the layer, instead of the delta of the layer.
+  void ShareDelta(arma::mat& error) { delta = &error; }
+
+ private:
+  //! Call the Forward() function of the layer.
+  template<typename LayerType>
+  static void LayerForward(void* layer, arma::mat& input, arma::mat& output);
+
+  //! Call the Backward() function of the layer.
+  template<typename LayerType>
+  static void LayerBackward(void* layer,
+                            arma::mat& input,
+                            arma::mat& error,
+                            arma::mat& delta);
+
+  //! Call the Gradient() function of the layer.
+  template<typename LayerType>
+  static void LayerGradient(void* layer, arma::mat& input, arma::mat& error);
+
+  //! Get the loss of the layer.
+  template<typename LayerType>
+  static double LayerLoss(void* layer);
+
+  //! Return the Gradient() function if the layer implements it.
+  template<typename T>
+  static typename std::enable_if<
+      HasGradientCheck<T, arma::mat&(T::*)()>::value,
+      void(*)(void*, arma::mat&, arma::mat&)>::type
+  GradientFunction();
+
+  //! Return NULL if the layer doesn't implement the Gradient() function.
+  template<typename T>
+  static typename std::enable_if<
+      !HasGradientCheck<T, arma::mat&(T::*)()>::value,
+      void(*)(void*, arma::mat&, arma::mat&)>::type
+  GradientFunction();
+
+  //! Return the Loss() function if the layer implements the Loss() or Model()
+  //! function.
+  template<typename T>
+  static typename std::enable_if<
+      HasLoss<T, double(T::*)()>::value || HasModelCheck<T>::value,
+      double(*)(void*)>::type
+  LossFunction();
+
+  //! Return NULL if the layer doesn't implement the Loss() or Model()
+  //! function.
+  template<typename T>
+  static typename std::enable_if<
+      !HasLoss<T, double(T::*)()>::value && !HasModelCheck<T>::value,
+      double(*)(void*)>::type
+  LossFunction();
+
+  //! The layer.
+  void* layer;
+
+  //! The Forward() function of the layer.
+  void (*forward)(void*, arma::mat&, arma::mat&);
+  //! The Backward() function of the layer.
+  void (*backward)(void*, arma::mat&, arma::mat&, arma::mat&);
+  //! The Gradient() function of the layer (NULL if it has none).
+  void (*gradient)(void*, arma::mat&, arma::mat&);
+  //! The Loss() function of the layer (NULL if it has none).
+  double (*loss)(void*);
+
+  //! The output parameter of the layer.
+  arma::mat* outputParameter;
+  //! The delta of the layer.
+  arma::mat* delta;
+
+  //! Whether the layer can run in place.
+  bool isInPlace;
+  //! Whether the Backward() function of the layer reads its output.
+  bool backwardUsesOutput;
+};
+
+/**
+ * ExecutionPlanVisitor creates the ExecutionStep of the given layer.
+ */
+class ExecutionPlanVisitor : public boost::static_visitor<ExecutionStep>
+{
+ public:
+  //! Create the ExecutionStep of the given layer.
+  template<typename LayerType>
+  ExecutionStep operator()(LayerType* layer) const
+  {
+    return ExecutionStep(layer);
+  }
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "execution_step_impl.hpp"
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * @file execution_step_impl.hpp
+ *
+ * Implementation of the ExecutionStep class, which holds a layer whose type has
+ * been resolved once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_EXECUTION_STEP_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_EXECUTION_STEP_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "execution_step.hpp"
+
+namespace mlpack {
+namespace ann {
+
+template<typename LayerType>
+inline ExecutionStep::ExecutionStep(LayerType* layer) :
+    layer(layer),
+    forward(&LayerForward<LayerType>),
+    backward(&LayerBackward<LayerType>),
+    gradient(GradientFunction<LayerType>()),
+    loss(LossFunction<LayerType>()),
+    outputParameter(&layer->OutputParameter()),
+    delta(&layer->Delta()),
+    isInPlace(LayerTraits<LayerType>::IsInPlace && !gradient),
+    backwardUsesOutput(LayerTraits<LayerType>::BackwardUsesOutput)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void ExecutionStep::LayerForward(void* layer,
+                                        arma::mat& input,
+                                        arma::mat& output)
+{
+  ForwardVisitor(std::move(input), std::move(output))(
+      static_cast<LayerType*>(layer));
+}
+
+template<typename LayerType>
+inline void ExecutionStep::LayerBackward(void* layer,
+                                         arma::mat& input,
+                                         arma::mat& error,
+                                         arma::mat& delta)
+{
+  BackwardVisitor(std::move(input), std::move(error), std::move(delta))(
+      static_cast<LayerType*>(layer));
+}
+
+template<typename LayerType>
+inline void ExecutionStep::LayerGradient(void* layer,
+                                         arma::mat& input,
+                                         arma::mat& error)
+{
+  GradientVisitor(std::move(input), std::move(error))(
+      static_cast<LayerType*>(layer));
+}
+
+template<typename LayerType>
+inline double ExecutionStep::LayerLoss(void* layer)
+{
+  return LossVisitor()(static_cast<LayerType*>(layer));
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasGradientCheck<T, arma::mat&(T::*)()>::value,
+    void(*)(void*, arma::mat&, arma::mat&)>::type
+ExecutionStep::GradientFunction()
+{
+  return &LayerGradient<T>;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasGradientCheck<T, arma::mat&(T::*)()>::value,
+    void(*)(void*, arma::mat&, arma::mat&)>::type
+ExecutionStep::GradientFunction()
+{
+  return NULL;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasLoss<T, double(T::*)()>::value || HasModelCheck<T>::value,
+    double(*)(void*)>::type
+ExecutionStep::LossFunction()
+{
+  return &LayerLoss<T>;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasLoss<T, double(T::*)()>::value && !HasModelCheck<T>::value,
+    double(*)(void*)>::type
+ExecutionStep::LossFunction()
+{
+  return NULL;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
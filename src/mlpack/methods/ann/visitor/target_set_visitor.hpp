@@ -0,0 +1,60 @@
+/**
+ * @file target_set_visitor.hpp
+ *
+ * This file provides an abstraction for the Target() function for different
+ * layers and automatically directs any parameter to the right layer type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_TARGET_SET_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_TARGET_SET_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * TargetSetVisitor passes the targets of the current batch to layers that need
+ * them in the forward pass (like SampledSoftmax and HierarchicalSoftmax).
+ */
+class TargetSetVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Set the target parameter given the targets of the batch.
+  TargetSetVisitor(const arma::mat& target);
+
+  //! Set the target parameter.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+ private:
+  //! The targets of the batch.
+  const arma::mat& target;
+
+  //! Set the target parameter if the module implements the Target() function.
+  template<typename T>
+  typename std::enable_if<
+      HasTargetCheck<T, arma::mat&(T::*)()>::value, void>::type
+  LayerTarget(T* layer) const;
+
+  //! Do not set the target parameter if the module doesn't implement the
+  //! Target() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasTargetCheck<T, arma::mat&(T::*)()>::value, void>::type
+  LayerTarget(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "target_set_visitor_impl.hpp"
+
+#endif
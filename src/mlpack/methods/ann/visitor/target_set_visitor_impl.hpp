@@ -0,0 +1,52 @@
+/**
+ * @file target_set_visitor_impl.hpp
+ *
+ * Implementation of the Target() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_TARGET_SET_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_TARGET_SET_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "target_set_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! TargetSetVisitor visitor class.
+inline TargetSetVisitor::TargetSetVisitor(const arma::mat& target) :
+    target(target)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void TargetSetVisitor::operator()(LayerType* layer) const
+{
+  LayerTarget(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasTargetCheck<T, arma::mat&(T::*)()>::value, void>::type
+TargetSetVisitor::LayerTarget(T* layer) const
+{
+  layer->Target() = target;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasTargetCheck<T, arma::mat&(T::*)()>::value, void>::type
+TargetSetVisitor::LayerTarget(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
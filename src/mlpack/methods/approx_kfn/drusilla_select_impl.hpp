@@ -16,9 +16,9 @@
 #include "drusilla_select.hpp"
 
 #include <queue>
-#include <mlpack/methods/neighbor_search/neighbor_search_rules.hpp>
+#include <mlpack/methods/neighbor_search/candidate_list.hpp>
 #include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
-#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 #include <algorithm>
 
 namespace mlpack {
@@ -179,19 +179,44 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
     throw std::invalid_argument("DrusillaSelect::Search(): requested k is "
         "greater than number of points in candidate set!  Increase l or m.");
 
-  // We'll use the NeighborSearchRules class to perform our brute-force search.
-  // Note that we aren't using trees for our search, so we can use 'int' as a
-  // TreeType.
-  metric::EuclideanDistance metric;
-  NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
-      tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic, MatType>>
-      rules(candidateSet, querySet, k, metric, 0, false);
+  // Perform a brute-force search of the candidate set.  The query points are
+  // split into blocks that are searched in parallel, and each block goes
+  // through the candidate set one block of candidates at a time, so that the
+  // candidates stay in cache while they are compared with every query point
+  // of the block.  The candidates of each query point are still considered in
+  // order, so the results don't depend on the blocking.
+  const size_t queryBlockSize = 16;
+  const size_t candidateBlockSize = 256;
+  const size_t numQueryBlocks = (querySet.n_cols + queryBlockSize - 1) /
+      queryBlockSize;
+
+  CandidateList<FurthestNeighborSort> results(querySet.n_cols, k);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numQueryBlocks; ++b)
+  {
+    const size_t queryBegin = b * queryBlockSize;
+    const size_t queryEnd = std::min(queryBegin + queryBlockSize,
+        (size_t) querySet.n_cols);
+    for (size_t r = 0; r < candidateSet.n_cols; r += candidateBlockSize)
+    {
+      const size_t candidateEnd = std::min(r + candidateBlockSize,
+          (size_t) candidateSet.n_cols);
+      for (size_t q = queryBegin; q < queryEnd; ++q)
+      {
+        for (size_t c = r; c < candidateEnd; ++c)
+        {
+          results.Insert(q, metric::EuclideanDistance::Evaluate(
+              querySet.col(q), candidateSet.col(c)), c);
+        }
+      }
+    }
+  }
 
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
   for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
-
-  rules.GetResults(neighbors, distances);
+    results.GetResults(neighbors, distances, q);
 
   // Map the neighbors back to their original indices in the reference set.
   for (size_t i = 0; i < neighbors.n_elem; ++i)
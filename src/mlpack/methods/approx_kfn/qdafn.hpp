@@ -73,6 +73,9 @@ class QDAFN
    * can contain just one point, that is okay.)  The results will be stored in
    * the given neighbors and distances matrices, in the same format as the
    * mlpack NeighborSearch and LSHSearch classes.
+   *
+   * All the query points are projected onto the lines at once, and the query
+   * points are then searched in parallel.
    */
   void Search(const MatType& querySet,
               const size_t k,
@@ -81,15 +84,22 @@ class QDAFN
 
   //! Serialize the model.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
   //! Get the number of projections.
-  size_t NumProjections() const { return candidateSet.size(); }
+  size_t NumProjections() const { return candidates.n_cols / m; }
+
+  //! Get a copy of the candidate set for the given projection table.
+  MatType CandidateSet(const size_t t) const
+  {
+    return candidates.cols(t * m, (t + 1) * m - 1);
+  }
 
-  //! Get the candidate set for the given projection table.
-  const MatType& CandidateSet(const size_t t) const { return candidateSet[t]; }
-  //! Modify the candidate set for the given projection table.  Careful!
-  MatType& CandidateSet(const size_t t) { return candidateSet[t]; }
+  //! Get the candidate sets of all the projection tables; the candidate set of
+  //! table t is held by columns [t * m, (t + 1) * m).
+  const MatType& Candidates() const { return candidates; }
+  //! Modify the candidate sets of all the projection tables.  Careful!
+  MatType& Candidates() { return candidates; }
 
  private:
   //! The number of projections.
@@ -106,13 +116,18 @@ class QDAFN
   //! Values of a_i * x for each point in S.
   arma::mat sValues;
 
-  // Candidate sets; one element in the vector for each table.
-  std::vector<MatType> candidateSet;
+  //! Candidate sets of every table, stored one after the other; column
+  //! j + t * m holds the jth point of table t.
+  MatType candidates;
 };
 
 } // namespace neighbor
 } // namespace mlpack
 
+//! Set the serialization version of the QDAFN class.
+BOOST_TEMPLATE_CLASS_VERSION(template<typename MatType>,
+    mlpack::neighbor::QDAFN<MatType>, 1);
+
 // Include implementation.
 #include "qdafn_impl.hpp"
 
@@ -70,13 +70,14 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
   // top m elements.
   projections = referenceSet.t() * lines;
 
-  // Loop over each projection and find the top m elements.
+  // Loop over each projection and find the top m elements.  The projections
+  // are independent, so they are sorted in parallel.
   sIndices.set_size(m, l);
   sValues.set_size(m, l);
-  candidateSet.resize(l);
-  for (size_t i = 0; i < l; ++i)
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) l; ++i)
   {
-    candidateSet[i].set_size(referenceSet.n_rows, m);
     arma::uvec sortedIndices = arma::sort_index(projections.col(i), "descend");
 
     // Grab the top m elements.
@@ -84,9 +85,15 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
     {
       sIndices(j, i) = sortedIndices[j];
       sValues(j, i) = projections(sortedIndices[j], i);
-      candidateSet[i].col(j) = referenceSet.col(sortedIndices[j]);
     }
   }
+
+  // Copy the candidates of every table into one matrix.  This isn't done in
+  // parallel, since writing to a sparse matrix isn't thread-safe.  sIndices has
+  // the same layout as the candidates.
+  candidates.set_size(referenceSet.n_rows, l * m);
+  for (size_t i = 0; i < sIndices.n_elem; ++i)
+    candidates.col(i) = referenceSet.col(sIndices[i]);
 }
 
 // Search.
@@ -104,8 +111,12 @@ void QDAFN<MatType>::Search(const MatType& querySet,
   neighbors.fill(size_t() - 1);
   distances.zeros(k, querySet.n_cols);
 
+  // Project every query point onto every line at once.
+  const arma::mat queryProjections = querySet.t() * lines;
+
   // Search for each point.
-  for (size_t q = 0; q < querySet.n_cols; ++q)
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
   {
     // Initialize a priority queue.
     // The size_t represents the index of the table, and the double represents
@@ -113,8 +124,7 @@ void QDAFN<MatType>::Search(const MatType& querySet,
     std::priority_queue<std::pair<double, size_t>> queue;
     for (size_t i = 0; i < l; ++i)
     {
-      const double val = sValues(0, i) - arma::dot(querySet.col(q),
-          lines.col(i));
+      const double val = sValues(0, i) - queryProjections(q, i);
       queue.push(std::make_pair(val, i));
     }
 
@@ -122,29 +132,18 @@ void QDAFN<MatType>::Search(const MatType& querySet,
     // in each table (they start at 0).
     arma::Col<size_t> tableLocations = arma::zeros<arma::Col<size_t>>(l);
 
-    // Now that the queue is initialized, iterate over m elements.
-    std::vector<std::pair<double, size_t>> v(k, std::make_pair(-1.0,
-        size_t(-1)));
-    std::priority_queue<std::pair<double, size_t>>
-        resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
+    // Now that the queue is initialized, iterate over m elements.  The order
+    // the candidates are visited in only depends on the projections, so the
+    // candidates are collected first and their distances computed afterwards.
+    arma::Col<size_t> visited(m);
     for (size_t i = 0; i < m; ++i)
     {
-      std::pair<size_t, double> p = queue.top();
+      std::pair<double, size_t> p = queue.top();
       queue.pop();
 
       // Get index of reference point to look at.
       const size_t tableIndex = tableLocations[p.second];
-
-      // Calculate distance from query point.
-      const double dist = mlpack::metric::EuclideanDistance::Evaluate(
-          querySet.col(q), candidateSet[p.second].col(tableIndex));
-
-      // Is this neighbor good enough to insert into the results?
-      if (dist > resultsQueue.top().first)
-      {
-        resultsQueue.pop();
-        resultsQueue.push(std::make_pair(dist, sIndices(tableIndex, p.second)));
-      }
+      visited[i] = p.second * m + tableIndex;
 
       // Now (line 14) get the next element and insert into the queue.  Do this
       // by adjusting the previous value.  Don't insert anything if we are at
@@ -159,6 +158,30 @@ void QDAFN<MatType>::Search(const MatType& querySet,
       }
     }
 
+    // Calculate the distances from the query point to all the visited
+    // candidates.
+    arma::vec candidateDistances(m);
+    for (size_t i = 0; i < m; ++i)
+    {
+      candidateDistances[i] = mlpack::metric::EuclideanDistance::Evaluate(
+          querySet.col(q), candidates.col(visited[i]));
+    }
+
+    std::vector<std::pair<double, size_t>> v(k, std::make_pair(-1.0,
+        size_t(-1)));
+    std::priority_queue<std::pair<double, size_t>>
+        resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
+    for (size_t i = 0; i < m; ++i)
+    {
+      // Is this neighbor good enough to insert into the results?
+      if (candidateDistances[i] > resultsQueue.top().first)
+      {
+        resultsQueue.pop();
+        resultsQueue.push(std::make_pair(candidateDistances[i],
+            sIndices[visited[i]]));
+      }
+    }
+
     // Extract the results.
     for (size_t j = 1; j <= k; ++j)
     {
@@ -171,7 +194,7 @@ void QDAFN<MatType>::Search(const MatType& querySet,
 
 template<typename MatType>
 template<typename Archive>
-void QDAFN<MatType>::serialize(Archive& ar, const unsigned int /* version */)
+void QDAFN<MatType>::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(l);
   ar & BOOST_SERIALIZATION_NVP(m);
@@ -179,9 +202,21 @@ void QDAFN<MatType>::serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(projections);
   ar & BOOST_SERIALIZATION_NVP(sIndices);
   ar & BOOST_SERIALIZATION_NVP(sValues);
-  if (Archive::is_loading::value)
-    candidateSet.clear();
-  ar & BOOST_SERIALIZATION_NVP(candidateSet);
+
+  // Before version 1, each candidate set was stored in its own matrix.
+  if (version == 0)
+  {
+    std::vector<MatType> candidateSet;
+    ar & BOOST_SERIALIZATION_NVP(candidateSet);
+
+    candidates.set_size(lines.n_rows, candidateSet.size() * m);
+    for (size_t t = 0; t < candidateSet.size(); ++t)
+      candidates.cols(t * m, (t + 1) * m - 1) = candidateSet[t];
+  }
+  else
+  {
+    ar & BOOST_SERIALIZATION_NVP(candidates);
+  }
 }
 
 } // namespace neighbor
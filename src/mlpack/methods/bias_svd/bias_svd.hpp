@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/dsgd/dsgd.hpp>
 #include <mlpack/methods/cf/cf.hpp>
 
 #include "bias_svd_function.hpp"
@@ -60,6 +61,8 @@ class BiasSVD
   /**
    * Constructor of Bias SVD. By default SGD optimizer is used in BiasSVD.
    * The optimizer uses a template specialization of Optimize().
+   * If OptimizerType is optimization::DSGD, the epochs are run with DSGD
+   * instead, which uses all threads without conflicting updates.
    *
    * @param iterations Number of optimization iterations.
    * @param alpha Learning rate for the SGD optimizer.
@@ -87,6 +90,24 @@ class BiasSVD
              arma::vec& q);
 
  private:
+  /**
+   * Run SGD for the given number of epochs.  This uses the specialization of
+   * StandardSGD for the function.
+   */
+  template<typename FunctionType>
+  void Optimize(FunctionType& function,
+                arma::mat& parameters,
+                const std::false_type /* useDSGD */) const;
+
+  /**
+   * Run DSGD for the given number of epochs, which processes blocks of
+   * ratings that share no users and no items in parallel.
+   */
+  template<typename FunctionType>
+  void Optimize(FunctionType& function,
+                arma::mat& parameters,
+                const std::true_type /* useDSGD */) const;
+
   //! Number of optimization iterations.
   size_t iterations;
   //! Learning rate for the SGD optimizer.
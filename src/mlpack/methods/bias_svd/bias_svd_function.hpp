@@ -102,6 +102,28 @@ class BiasSVDFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Take an SGD step on the given training example.  Only the parameters of
+   * the user and the item of the example are changed, so steps on examples
+   * that share no user and no item may be taken at the same time; this is
+   * used by the DSGD optimizer.
+   *
+   * @param parameters Parameters(user/item matrices/bias) of the
+   *     decomposition.
+   * @param i Index of the training example.
+   * @param stepSize Step size of the update.
+   */
+  void StochasticUpdate(arma::mat& parameters,
+                        const size_t i,
+                        const double stepSize) const;
+
+  /**
+   * Finish an epoch of StochasticUpdate() calls.  There is nothing to do,
+   * since every update only touches the parameters of its example.
+   */
+  void FinishEpoch(arma::mat& /* parameters */,
+                   const double /* stepSize */) const { }
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
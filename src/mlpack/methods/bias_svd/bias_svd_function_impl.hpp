@@ -178,6 +178,38 @@ void BiasSVDFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template <typename MatType>
+void BiasSVDFunction<MatType>::StochasticUpdate(arma::mat& parameters,
+                                                const size_t i,
+                                                const double stepSize) const
+{
+  // Indices for accessing the the correct parameter columns.
+  const size_t user = data(0, i);
+  const size_t item = data(1, i) + numUsers;
+
+  // Prediction error for the example.
+  const double rating = data(2, i);
+  const double userBias = parameters(rank, user);
+  const double itemBias = parameters(rank, item);
+  const double ratingError = rating - userBias - itemBias -
+      arma::dot(parameters.col(user).subvec(0, rank - 1),
+                parameters.col(item).subvec(0, rank - 1));
+
+  // This is the step of the SGD specialization below, except that the item
+  // step uses the user vector from before the update.
+  const arma::vec userVec = parameters.col(user).subvec(0, rank - 1);
+  parameters.col(user).subvec(0, rank - 1) -= stepSize * 2 * (
+      lambda * userVec -
+      ratingError * parameters.col(item).subvec(0, rank - 1));
+  parameters.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
+      lambda * parameters.col(item).subvec(0, rank - 1) -
+      ratingError * userVec);
+  parameters(rank, user) -= stepSize * 2 * (
+      lambda * parameters(rank, user) - ratingError);
+  parameters(rank, item) -= stepSize * 2 * (
+      lambda * parameters(rank, item) - ratingError);
+}
+
 } // namespace svd
 } // namespace mlpack
 
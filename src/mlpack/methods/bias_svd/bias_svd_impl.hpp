@@ -38,18 +38,16 @@ void BiasSVD<OptimizerType>::Apply(const arma::mat& data,
 {
   // batchSize is 1 in our implementation of Bias SVD.
   // batchSize other than 1 has not been supported yet.
-  const int batchSize = 1;
   Log::Warn << "The batch size for optimizing BiasSVD is 1."
       << std::endl;
 
   // Make the optimizer object using a BiasSVDFunction object.
   BiasSVDFunction<arma::mat> biasSVDFunc(data, rank, lambda);
-  mlpack::optimization::StandardSGD optimizer(alpha, batchSize,
-      iterations * data.n_cols);
 
   // Get optimized parameters.
   arma::mat parameters = biasSVDFunc.GetInitialPoint();
-  optimizer.Optimize(biasSVDFunc, parameters);
+  Optimize(biasSVDFunc, parameters,
+      std::is_same<OptimizerType, optimization::DSGD>());
 
   // Constants for extracting user and item matrices.
   const size_t numUsers = max(data.row(0)) + 1;
@@ -63,6 +61,29 @@ void BiasSVD<OptimizerType>::Apply(const arma::mat& data,
   q = parameters.row(rank).subvec(0, numUsers - 1).t();
 }
 
+template<typename OptimizerType>
+template<typename FunctionType>
+void BiasSVD<OptimizerType>::Optimize(
+    FunctionType& function,
+    arma::mat& parameters,
+    const std::false_type /* useDSGD */) const
+{
+  mlpack::optimization::StandardSGD optimizer(alpha, 1,
+      iterations * function.NumFunctions());
+  optimizer.Optimize(function, parameters);
+}
+
+template<typename OptimizerType>
+template<typename FunctionType>
+void BiasSVD<OptimizerType>::Optimize(
+    FunctionType& function,
+    arma::mat& parameters,
+    const std::true_type /* useDSGD */) const
+{
+  mlpack::optimization::DSGD optimizer(alpha, iterations);
+  optimizer.Optimize(function, parameters);
+}
+
 } // namespace svd
 } // namespace mlpack
 
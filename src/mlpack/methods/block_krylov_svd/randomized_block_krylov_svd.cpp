@@ -11,6 +11,7 @@
  */
 
 #include "randomized_block_krylov_svd.hpp"
+#include <mlpack/methods/randomized_svd/streaming_products.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -92,5 +93,50 @@ void RandomizedBlockKrylovSVD::Apply(const arma::mat& data,
   u = Q * u;
 }
 
+void RandomizedBlockKrylovSVD::Apply(data::StreamingDataset<>& data,
+                                     arma::mat& u,
+                                     arma::vec& s,
+                                     const size_t rank,
+                                     const bool center)
+{
+  if (rank > data.NumRows() || rank > data.NumCols())
+  {
+    Log::Fatal << "RandomizedBlockKrylovSVD::Apply(): rank " << rank << " is "
+        << "larger than the dimensions of the data (" << data.NumRows() << " x "
+        << data.NumCols() << ")!" << std::endl;
+  }
+
+  if (blockSize == 0)
+  {
+    blockSize = rank + 10;
+  }
+
+  arma::vec mean;
+  if (center)
+    StreamingProducts::Mean(data, mean);
+  const arma::vec* meanPtr = center ? &mean : NULL;
+
+  // Construct and orthonormalize the Krylov subspace, with blocks
+  // (C C^T)^i G for a random block G.
+  const size_t numVectors = std::min(blockSize, (size_t) data.NumRows());
+  arma::mat K(data.NumRows(), numVectors * (maxIterations + 1));
+  arma::mat block = arma::randn<arma::mat>(data.NumRows(), numVectors);
+  arma::mat products, R;
+  for (size_t i = 0; i <= maxIterations; ++i)
+  {
+    StreamingProducts::GramProduct(data, block, meanPtr, products);
+    arma::qr_econ(block, R, products);
+    K.cols(i * numVectors, (i + 1) * numVectors - 1) = block;
+  }
+
+  arma::mat Q;
+  arma::qr_econ(Q, R, K);
+
+  // Approximate the singular values and vectors using the Rayleigh-Ritz
+  // method.
+  StreamingProducts::RayleighRitz(data, Q, meanPtr, std::min(rank,
+      (size_t) Q.n_cols), u, s);
+}
+
 } // namespace svd
 } // namespace mlpack
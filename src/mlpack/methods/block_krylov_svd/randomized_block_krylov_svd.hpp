@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_BLOCK_KRYLOV_SVD_RANDOMIZED_BLOCK_KRYLOV_SVD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/streaming_dataset.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -104,6 +105,30 @@ class RandomizedBlockKrylovSVD
              arma::mat& v,
              const size_t rank);
 
+  /**
+   * Compute the leading singular values and left singular vectors of a matrix
+   * that is read from disk one chunk of columns at a time, so that it never
+   * needs to fit in memory.  If center is true, the mean of the columns is
+   * subtracted from every column on the fly, as for Principal Component
+   * Analysis, without forming the centered matrix.
+   *
+   * The Krylov subspace is built from powers of the Gram matrix of the data,
+   * so each block of it takes one pass over the data; the singular values are
+   * extracted with one more pass, and centering adds one pass to compute the
+   * mean.
+   *
+   * @param data Dataset to decompose.
+   * @param u First unitary matrix.
+   * @param s Vector of singular values.
+   * @param rank Rank of the approximation.
+   * @param center Whether to center the columns of the data.
+   */
+  void Apply(data::StreamingDataset<>& data,
+             arma::mat& u,
+             arma::vec& s,
+             const size_t rank,
+             const bool center = false);
+
   //! Get the number of iterations for the power method.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the number of iterations for the power method.
@@ -22,6 +22,8 @@
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
 #include <mlpack/methods/cf/normalization/no_normalization.hpp>
+#include <mlpack/methods/cf/normalization/overall_mean_normalization.hpp>
+#include <mlpack/methods/cf/normalization/normalization_traits.hpp>
 #include <mlpack/methods/cf/decomposition_policies/nmf_method.hpp>
 #include <mlpack/methods/cf/neighbor_search_policies/lmetric_search.hpp>
 #include <mlpack/methods/cf/interpolation_policies/average_interpolation.hpp>
@@ -143,6 +145,23 @@ class CFType
              const double minResidue = 1e-5,
              const bool mit = false);
 
+  /**
+   * Fold new ratings into the trained model, without refactorizing the whole
+   * rating matrix.  The ratings may be for new users and items, and replace
+   * any existing ratings of the same user and item.  Only the factors that the
+   * new ratings touch are recomputed, by the Update() function of the
+   * DecompositionPolicy (so this is not available for BiasSVDPolicy and
+   * SVDPlusPlusPolicy).
+   *
+   * The normalization fit in Train() is kept, so this is only supported with
+   * NoNormalization and OverallMeanNormalization, which shift every rating by
+   * the same amount.
+   *
+   * @param data New ratings, as a (user, item, rating) table.
+   * @param iterations Number of iterations of the fold-in.
+   */
+  void Update(const arma::mat& data, const size_t iterations = 5);
+
   //! Sets number of users for calculating similarity.
   void NumUsersForSimilarity(const size_t num)
   {
@@ -213,6 +232,33 @@ class CFType
                           arma::Mat<size_t>& recommendations,
                           const arma::Col<size_t>& users);
 
+  /**
+   * Generates the given number of recommendations for the specified users,
+   * finding the best items for each user with the given ranking policy (such
+   * as FastMKSRanking) instead of scoring every item.  The ranking policy must
+   * have been trained on the decomposition of this model.  The items are
+   * ranked by their normalized ratings, so this can't be used with
+   * normalizations that depend on the item (such as ItemMeanNormalization).
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   * @tparam RankingPolicy The policy used to find the best items.
+   *
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations.
+   * @param users Users for which recommendations are to be generated.
+   * @param ranking Trained ranking policy.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation,
+           typename RankingPolicy>
+  void GetRecommendations(const size_t numRecs,
+                          arma::Mat<size_t>& recommendations,
+                          const arma::Col<size_t>& users,
+                          RankingPolicy& ranking);
+
   //! Converts the User, Item, Value Matrix to User-Item Table.
   static void CleanData(const arma::mat& data, arma::sp_mat& cleanedData);
 
@@ -274,10 +320,13 @@ class CFType
   //! Candidate represents a possible recommendation (value, item).
   typedef std::pair<double, size_t> Candidate;
 
-  //! Compare two candidates based on the value.
+  //! Compare two candidates based on the value; better candidates are "less
+  //! than" worse ones, and ties are broken by the item index.
   struct CandidateCmp {
-    bool operator()(const Candidate& c1, const Candidate& c2)
+    bool operator()(const Candidate& c1, const Candidate& c2) const
     {
+      if (c1.first == c2.first)
+        return c1.second < c2.second;
       return c1.first > c2.first;
     };
   };
@@ -154,6 +154,57 @@ Train(const arma::sp_mat& data,
   Timer::Stop("cf_factorization");
 }
 
+// Fold new ratings into the model.
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+Update(const arma::mat& data, const size_t iterations)
+{
+  static_assert(std::is_same<NormalizationType, NoNormalization>::value ||
+      std::is_same<NormalizationType, OverallMeanNormalization>::value,
+      "CFType::Update() is only supported with NoNormalization and "
+      "OverallMeanNormalization.");
+
+  if (data.n_rows != 3)
+  {
+    Log::Fatal << "CFType::Update(): new ratings must be a (user, item, "
+        << "rating) table with 3 rows, but " << data.n_rows << " rows were "
+        << "given!" << std::endl;
+  }
+
+  if (data.n_cols == 0)
+    return;
+
+  // Normalize the new ratings like those the model was trained on; both
+  // supported normalizations shift every rating by the same amount.
+  arma::mat normalizedData(data);
+  const double shift = normalization.Denormalize(0, 0, 0.0);
+  for (size_t i = 0; i < normalizedData.n_cols; ++i)
+  {
+    normalizedData(2, i) -= shift;
+    // The algorithm omits rating of zero. If normalized rating equals zero,
+    // it is set to the smallest positive double value.
+    if (normalizedData(2, i) == 0)
+      normalizedData(2, i) = std::numeric_limits<double>::min();
+  }
+
+  arma::sp_mat newData;
+  CleanData(normalizedData, newData);
+
+  const size_t numItems = std::max(cleanedData.n_rows, newData.n_rows);
+  const size_t numUsers = std::max(cleanedData.n_cols, newData.n_cols);
+  cleanedData.resize(numItems, numUsers);
+  newData.resize(numItems, numUsers);
+
+  // New ratings replace existing ratings of the same user and item.
+  cleanedData = cleanedData - cleanedData % arma::spones(newData) + newData;
+
+  Timer::Start("cf_update");
+  decomposition.Update(normalizedData, cleanedData, iterations);
+  Timer::Stop("cf_update");
+}
+
 template<typename DecompositionPolicy,
          typename NormalizationType>
 template<typename NeighborSearchPolicy,
@@ -201,72 +252,224 @@ GetRecommendations(const size_t numRecs,
   // Generate recommendations for each query user by finding the maximum numRecs
   // elements in the ratings vector.
   recommendations.set_size(numRecs, users.n_elem);
-  arma::mat values(numRecs, users.n_elem);
-  recommendations.fill(SIZE_MAX);
-  values.fill(DBL_MAX);
 
   // Initialization of an InterpolationPolicy object should be put ahead of the
   // following loop, because the initialization may takes a relatively long
   // time and we don't want to repeat the initialization process in each loop.
   InterpolationPolicy interpolation(cleanedData);
 
+  // Calculate interpolation weights.  Some interpolation policies cache
+  // results between calls, so this is done serially.
+  arma::mat weights(numUsersForSimilarity, users.n_elem);
   for (size_t i = 0; i < users.n_elem; i++)
   {
-    // First, calculate the weighted sum of neighborhood values.
-    arma::vec ratings;
-    ratings.zeros(cleanedData.n_rows);
-
-    // Calculate interpolation weights.
-    arma::vec weights(numUsersForSimilarity);
-    interpolation.GetWeights(weights, decomposition, users(i),
+    interpolation.GetWeights(weights.col(i), decomposition, users(i),
         neighborhood.col(i), similarities.col(i), cleanedData);
+  }
 
-    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+  // Whether enough recommendations could be found for each user.
+  std::vector<char> incomplete(users.n_elem, 0);
+
+  #pragma omp parallel
+  {
+    // Buffers for each thread, reused for all of its users.
+    arma::mat neighborRatings(cleanedData.n_rows, neighborhood.n_rows);
+    arma::vec ratings(cleanedData.n_rows);
+    std::vector<char> rated(cleanedData.n_rows, 0);
+    std::vector<Candidate> candidates;
+    candidates.reserve(cleanedData.n_rows);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; i++)
     {
-      arma::vec neighborRatings;
-      decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
-      ratings += weights(j) * neighborRatings;
-    }
+      // First, calculate the weighted sum of neighborhood values, with one
+      // matrix-vector product.
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+      {
+        // This aliases the column, so the rating is written in place.
+        arma::vec neighborRating(neighborRatings.colptr(j),
+            neighborRatings.n_rows, false, true);
+        decomposition.GetRatingOfUser(neighborhood(j, i), neighborRating);
+      }
+      ratings = neighborRatings * weights.col(i);
+
+      // Mark the items the user has already rated.  The algorithm omits rating
+      // of zero. Thus, when normalizing original ratings in Normalize(), if
+      // normalized rating equals zero, it is set to the smallest positive
+      // double value.
+      const arma::sp_mat::const_iterator itBegin =
+          cleanedData.begin_col(users(i));
+      const arma::sp_mat::const_iterator itEnd = cleanedData.end_col(users(i));
+      for (arma::sp_mat::const_iterator it = itBegin; it != itEnd; ++it)
+        rated[it.row()] = 1;
+
+      // Let's build the list of candidate recomendations for the given user.
+      // Denormalize ratings before comparison.
+      candidates.clear();
+      for (size_t j = 0; j < ratings.n_elem; ++j)
+      {
+        if (!rated[j])
+        {
+          candidates.push_back(std::make_pair(normalization.Denormalize(
+              users(i), j, ratings[j]), j));
+        }
+      }
 
-    // Let's build the list of candidate recomendations for the given user.
-    // Default candidate: the smallest possible value and invalid item number.
-    const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
-    std::vector<Candidate> vect(numRecs, def);
-    typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-        CandidateList;
-    CandidateList pqueue(CandidateCmp(), std::move(vect));
+      for (arma::sp_mat::const_iterator it = itBegin; it != itEnd; ++it)
+        rated[it.row()] = 0;
 
-    // Look through the ratings column corresponding to the current user.
-    for (size_t j = 0; j < ratings.n_rows; ++j)
-    {
-      // Ensure that the user hasn't already rated the item.
-      // The algorithm omits rating of zero. Thus, when normalizing original
-      // ratings in Normalize(), if normalized rating equals zero, it is set
-      // to the smallest positive double value.
-      if (cleanedData(j, users(i)) != 0.0)
-        continue; // The user already rated the item.
-
-      // Is the estimated value better than the worst candidate?
-      // Denormalize rating before comparison.
-      double realRating = normalization.Denormalize(users(i), j, ratings[j]);
-      if (realRating > pqueue.top().first)
+      // Only the best numRecs candidates need to be sorted.
+      const size_t found = std::min(numRecs, candidates.size());
+      std::nth_element(candidates.begin(), candidates.begin() + found,
+          candidates.end(), CandidateCmp());
+      std::sort(candidates.begin(), candidates.begin() + found,
+          CandidateCmp());
+
+      // Invalid item numbers are given if there are not enough candidates.
+      for (size_t p = 0; p < numRecs; p++)
       {
-        Candidate c = std::make_pair(realRating, j);
-        pqueue.pop();
-        pqueue.push(c);
+        recommendations(p, i) = (p < found) ? candidates[p].second :
+            cleanedData.n_rows;
       }
+
+      if (found < numRecs)
+        incomplete[i] = 1;
     }
+  }
 
-    for (size_t p = 1; p <= numRecs; p++)
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; i++)
+  {
+    if (incomplete[i])
+      Log::Warn << "Could not provide " << numRecs << " recommendations "
+          << "for user " << users(i) << " (not enough un-rated items)!"
+          << std::endl;
+  }
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy,
+         typename RankingPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetRecommendations(const size_t numRecs,
+                   arma::Mat<size_t>& recommendations,
+                   const arma::Col<size_t>& users,
+                   RankingPolicy& ranking)
+{
+  static_assert(!NormalizationTraits<NormalizationType>::IsItemDependent,
+      "CFType::GetRecommendations(): a ranking policy ranks the normalized "
+      "ratings, so it can't be used with a normalization that depends on the "
+      "item.");
+
+  if (ranking.Items().n_cols != cleanedData.n_rows)
+  {
+    Log::Fatal << "CFType::GetRecommendations(): the ranking policy holds "
+        << ranking.Items().n_cols << " items, but the model has "
+        << cleanedData.n_rows << " items!" << std::endl;
+  }
+
+  // Temporary storage for neighborhood of the queried users.
+  arma::Mat<size_t> neighborhood;
+  // Resulting similarities.
+  arma::mat similarities;
+
+  // Calculate the neighborhood of the queried users.  Note that the query user
+  // is part of the neighborhood---this is intentional.
+  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
+      users, numUsersForSimilarity, neighborhood, similarities);
+
+  recommendations.set_size(numRecs, users.n_elem);
+  if (users.n_elem == 0)
+    return;
+
+  // Calculate interpolation weights, and from them the query of each user.
+  InterpolationPolicy interpolation(cleanedData);
+  arma::vec weights(numUsersForSimilarity);
+  arma::vec query;
+  arma::mat queries;
+  size_t totalRated = 0;
+  for (size_t i = 0; i < users.n_elem; i++)
+  {
+    interpolation.GetWeights(weights, decomposition, users(i),
+        neighborhood.col(i), similarities.col(i), cleanedData);
+    ranking.Query(decomposition, neighborhood.col(i), weights, query);
+    if (i == 0)
+      queries.set_size(query.n_elem, users.n_elem);
+    queries.col(i) = query;
+
+    totalRated += cleanedData.col(users(i)).n_nonzero;
+  }
+
+  // Items the user has already rated are skipped, so some more candidates than
+  // numRecs are needed; users that have rated more items than average are
+  // handled below.
+  const size_t numCandidates = std::min((size_t) cleanedData.n_rows, numRecs +
+      (totalRated + users.n_elem - 1) / users.n_elem);
+  arma::Mat<size_t> indices;
+  arma::mat products;
+  ranking.Search(queries, numCandidates, indices, products);
+
+  std::vector<char> incomplete(users.n_elem, 0);
+
+  #pragma omp parallel
+  {
+    std::vector<char> rated(cleanedData.n_rows, 0);
+    std::vector<Candidate> candidates;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; i++)
     {
-      recommendations(numRecs - p, i) = pqueue.top().second;
-      values(numRecs - p, i) = pqueue.top().first;
-      pqueue.pop();
+      const arma::sp_mat::const_iterator itBegin =
+          cleanedData.begin_col(users(i));
+      const arma::sp_mat::const_iterator itEnd = cleanedData.end_col(users(i));
+      for (arma::sp_mat::const_iterator it = itBegin; it != itEnd; ++it)
+        rated[it.row()] = 1;
+
+      size_t found = 0;
+      for (size_t j = 0; j < numCandidates && found < numRecs; ++j)
+        if (!rated[indices(j, i)])
+          recommendations(found++, i) = indices(j, i);
+
+      // If there are not enough unrated items among the candidates, score all
+      // the items for this user.
+      if (found < numRecs && numCandidates < cleanedData.n_rows)
+      {
+        const arma::vec scores = ranking.Items().t() * queries.col(i);
+        candidates.clear();
+        for (size_t j = 0; j < scores.n_elem; ++j)
+          if (!rated[j])
+            candidates.push_back(std::make_pair(scores[j], j));
+
+        found = std::min(numRecs, candidates.size());
+        std::nth_element(candidates.begin(), candidates.begin() + found,
+            candidates.end(), CandidateCmp());
+        std::sort(candidates.begin(), candidates.begin() + found,
+            CandidateCmp());
+        for (size_t p = 0; p < found; ++p)
+          recommendations(p, i) = candidates[p].second;
+      }
+
+      for (arma::sp_mat::const_iterator it = itBegin; it != itEnd; ++it)
+        rated[it.row()] = 0;
+
+      // Invalid item numbers are given if there are not enough candidates.
+      for (size_t p = found; p < numRecs; ++p)
+        recommendations(p, i) = cleanedData.n_rows;
+
+      if (found < numRecs)
+        incomplete[i] = 1;
     }
+  }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(numRecs - 1, i) == def.second)
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; i++)
+  {
+    if (incomplete[i])
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
           << std::endl;
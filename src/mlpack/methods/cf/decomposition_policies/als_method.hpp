@@ -0,0 +1,294 @@
+/**
+ * @file als_method.hpp
+ *
+ * Implementation of alternating least squares for use in Collaborative
+ * Filtering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/cf/fold_in.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Implementation of the alternating least squares (ALS) policy to act as a
+ * wrapper when accessing ALS from within CFType.  Only the observed ratings
+ * are fit.  Each iteration solves for the factors of every item with the user
+ * factors fixed, and then for the factors of every user with the item factors
+ * fixed.  Each of these is a small ridge regression over the ratings of one
+ * item or user, so they are solved in parallel without any conflicts.  The
+ * regularization of a factor is weighted by its number of ratings, as in
+ * ALS-WR:
+ *
+ * @code
+ * @inproceedings{zhou2008large,
+ *   title     = {Large-scale parallel collaborative filtering for the Netflix
+ *                prize},
+ *   author    = {Zhou, Yunhong and Wilkinson, Dennis and Schreiber, Robert and
+ *                Pan, Rong},
+ *   booktitle = {Algorithmic Aspects in Information and Management},
+ *   pages     = {337--348},
+ *   year      = {2008}
+ * }
+ * @endcode
+ *
+ * An example of how to use ALSPolicy in CF is shown below:
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * // Users for whom recommendations are generated.
+ * extern arma::Col<size_t> users;
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * CFType<ALSPolicy> cf(data);
+ *
+ * // Generate 10 recommendations for all users.
+ * cf.GetRecommendations(10, recommendations);
+ * @endcode
+ */
+class ALSPolicy
+{
+ public:
+  /**
+   * Use alternating least squares to perform collaborative filtering.
+   *
+   * @param lambda Regularization parameter for the least squares problems.
+   */
+  ALSPolicy(const double lambda = 0.05) : lambda(lambda)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Collaborative Filtering to the provided data set using alternating
+   * least squares.
+   *
+   * @param data Data matrix: dense matrix (coordinate lists)
+   *    or sparse matrix(cleaned).
+   * @param cleanedData item user table in form of sparse matrix.
+   * @param rank Rank parameter for matrix factorization.
+   * @param maxIterations Maximum number of iterations.
+   * @param minResidue Residue required to terminate.
+   * @param mit Whether to terminate only when maxIterations is reached.
+   */
+  template<typename MatType>
+  void Apply(const MatType& /* data */,
+             const arma::sp_mat& cleanedData,
+             const size_t rank,
+             const size_t maxIterations,
+             const double minResidue,
+             const bool mit)
+  {
+    // The item factors are solved for first, so only the user factors need a
+    // starting point.
+    w.set_size(cleanedData.n_rows, rank);
+    h.randu(rank, cleanedData.n_cols);
+
+    // The ratings of every item, with one column per item.
+    const arma::sp_mat itemRatings = cleanedData.t();
+
+    // The least squares problems are solved in parallel, so each should only
+    // use one thread.
+    util::SingleThreadedBLAS singleThreadedBLAS;
+
+    double lastError = DBL_MAX;
+    for (size_t iteration = 0; iteration < maxIterations; ++iteration)
+    {
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) itemRatings.n_cols; ++i)
+      {
+        arma::vec factors;
+        Solve(itemRatings, i, h, factors);
+        w.row(i) = factors.t();
+      }
+
+      const arma::mat wt = w.t();
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t u = 0; u < (omp_size_t) cleanedData.n_cols; ++u)
+      {
+        arma::vec factors;
+        Solve(cleanedData, u, wt, factors);
+        h.col(u) = factors;
+      }
+
+      if (mit)
+        continue;
+
+      // Terminate when the root mean squared error on the ratings has
+      // stopped changing.
+      double error = 0;
+      #pragma omp parallel for schedule(dynamic) reduction(+:error)
+      for (omp_size_t u = 0; u < (omp_size_t) cleanedData.n_cols; ++u)
+      {
+        arma::sp_mat::const_iterator it = cleanedData.begin_col(u);
+        for (; it != cleanedData.end_col(u); ++it)
+        {
+          const double diff = (*it) - arma::dot(w.row(it.row()), h.col(u));
+          error += diff * diff;
+        }
+      }
+      error = std::sqrt(error / cleanedData.n_nonzero);
+
+      Log::Info << "ALSPolicy: iteration " << iteration << ", RMSE " << error
+          << "." << std::endl;
+      if (std::abs(lastError - error) < minResidue)
+        break;
+      lastError = error;
+    }
+  }
+
+  /**
+   * Return predicted rating given user ID and item ID.
+   *
+   * @param user User ID.
+   * @param item Item ID.
+   */
+  double GetRating(const size_t user, const size_t item) const
+  {
+    double rating = arma::as_scalar(w.row(item) * h.col(user));
+    return rating;
+  }
+
+  /**
+   * Get predicted ratings for a user.
+   *
+   * @param user User ID.
+   * @param rating Resulting rating vector.
+   */
+  void GetRatingOfUser(const size_t user, arma::vec& rating) const
+  {
+    rating = w * h.col(user);
+  }
+
+  /**
+   * Fold new ratings into the factorization: solve for the factors of the new
+   * items and of the users with new ratings with a few steps of alternating
+   * least squares, keeping the other factors fixed.
+   *
+   * @param data New ratings, as a (user, item, rating) table.
+   * @param cleanedData Item user table with all the ratings, including the new
+   *     ones.
+   * @param iterations Number of fold-in iterations.
+   */
+  void Update(const arma::mat& data,
+              const arma::sp_mat& cleanedData,
+              const size_t iterations)
+  {
+    FoldInRatings(data, cleanedData, w, h, iterations, lambda);
+  }
+
+  /**
+   * Get the neighborhood and corresponding similarities for a set of users.
+   *
+   * @tparam NeighborSearchPolicy The policy to perform neighbor search.
+   *
+   * @param users Users whose neighborhood is to be computed.
+   * @param numUsersForSimilarity The number of neighbors returned for
+   *     each user.
+   * @param neighborhood Neighbors represented by user IDs.
+   * @param similarities Similarity between each user and each of its
+   *     neighbors.
+   */
+  template<typename NeighborSearchPolicy>
+  void GetNeighborhood(const arma::Col<size_t>& users,
+                       const size_t numUsersForSimilarity,
+                       arma::Mat<size_t>& neighborhood,
+                       arma::mat& similarities) const
+  {
+    // We want to avoid calculating the full rating matrix, so we will do
+    // nearest neighbor search only on the H matrix, using the observation that
+    // if the rating matrix X = W*H, then d(X.col(i), X.col(j)) = d(W H.col(i),
+    // W H.col(j)).  This can be seen as nearest neighbor search on the H
+    // matrix with the Mahalanobis distance where M^{-1} = W^T W.  So, we'll
+    // decompose M^{-1} = L L^T (the Cholesky decomposition), and then multiply
+    // H by L^T. Then we can perform nearest neighbor search.
+    arma::mat l = arma::chol(w.t() * w);
+    arma::mat stretchedH = l * h; // Due to the Armadillo API, l is L^T.
+
+    // Temporarily store feature vector of queried users.
+    arma::mat query(stretchedH.n_rows, users.n_elem);
+    // Select feature vectors of queried users.
+    for (size_t i = 0; i < users.n_elem; i++)
+      query.col(i) = stretchedH.col(users(i));
+
+    NeighborSearchPolicy neighborSearch(stretchedH);
+    neighborSearch.Search(
+        query, numUsersForSimilarity, neighborhood, similarities);
+  }
+
+  //! Get the Item Matrix.
+  const arma::mat& W() const { return w; }
+  //! Get the User Matrix.
+  const arma::mat& H() const { return h; }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  /**
+   * Serialization.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(lambda);
+    ar & BOOST_SERIALIZATION_NVP(w);
+    ar & BOOST_SERIALIZATION_NVP(h);
+  }
+
+ private:
+  /**
+   * Solve the ridge regression for one column of the given ratings: the
+   * factors x minimizing sum_j (r_j - f_j^T x)^2 + lambda n ||x||^2, where j
+   * runs over the n nonzero ratings of the column and f_j is column j of
+   * fixed.  A column without ratings gets zero factors.
+   */
+  void Solve(const arma::sp_mat& ratings,
+             const size_t column,
+             const arma::mat& fixed,
+             arma::vec& factors) const
+  {
+    const size_t rank = fixed.n_rows;
+    arma::mat gram(rank, rank, arma::fill::zeros);
+    arma::vec rhs(rank, arma::fill::zeros);
+    size_t count = 0;
+    arma::sp_mat::const_iterator it = ratings.begin_col(column);
+    for (; it != ratings.end_col(column); ++it)
+    {
+      gram += fixed.col(it.row()) * fixed.col(it.row()).t();
+      rhs += (*it) * fixed.col(it.row());
+      ++count;
+    }
+
+    if (count == 0)
+    {
+      factors.zeros(rank);
+      return;
+    }
+
+    gram.diag() += lambda * count;
+    factors = arma::solve(gram, rhs);
+  }
+
+  //! Regularization parameter for the least squares problems.
+  double lambda;
+  //! Item matrix.
+  arma::mat w;
+  //! User matrix.
+  arma::mat h;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
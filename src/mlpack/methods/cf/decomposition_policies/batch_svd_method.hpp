@@ -18,6 +18,7 @@
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
+#include <mlpack/methods/cf/fold_in.hpp>
 
 namespace mlpack {
 namespace cf {
@@ -107,6 +108,23 @@ class BatchSVDPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Fold new ratings into the factorization: solve for the factors of the new
+   * items and of the users with new ratings with a few steps of alternating
+   * least squares, keeping the other factors fixed.
+   *
+   * @param data New ratings, as a (user, item, rating) table.
+   * @param cleanedData Item user table with all the ratings, including the new
+   *     ones.
+   * @param iterations Number of fold-in iterations.
+   */
+  void Update(const arma::mat& data,
+              const arma::sp_mat& cleanedData,
+              const size_t iterations)
+  {
+    FoldInRatings(data, cleanedData, w, h, iterations);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -47,13 +47,17 @@ class BiasSVDPolicy
    * @param maxIterations Number of iterations.
    * @param alpha Learning rate for optimization.
    * @param Regularization parameter for optimization.
+   * @param parallel Whether to optimize with DSGD, which runs on all threads,
+   *     instead of SGD.
    */
   BiasSVDPolicy(const size_t maxIterations = 10,
                 const double alpha = 0.02,
-                const double lambda = 0.05) :
+                const double lambda = 0.05,
+                const bool parallel = false) :
       maxIterations(maxIterations),
       alpha(alpha),
-      lambda(lambda)
+      lambda(lambda),
+      parallel(parallel)
   {
     /* Nothing to do here */
   }
@@ -78,8 +82,16 @@ class BiasSVDPolicy
              const bool /* mit */)
   {
     // Perform decomposition using the bias SVD algorithm.
-    svd::BiasSVD<> biassvd(maxIterations, alpha, lambda);
-    biassvd.Apply(data, rank, w, h, p, q);
+    if (parallel)
+    {
+      svd::BiasSVD<optimization::DSGD> biassvd(maxIterations, alpha, lambda);
+      biassvd.Apply(data, rank, w, h, p, q);
+    }
+    else
+    {
+      svd::BiasSVD<> biassvd(maxIterations, alpha, lambda);
+      biassvd.Apply(data, rank, w, h, p, q);
+    }
   }
 
   /**
@@ -160,6 +172,11 @@ class BiasSVDPolicy
   //! Modify regularization parameter.
   double& Lambda() { return lambda; }
 
+  //! Get whether DSGD is used instead of SGD.
+  bool Parallel() const { return parallel; }
+  //! Modify whether DSGD is used instead of SGD.
+  bool& Parallel() { return parallel; }
+
   /**
    * Serialization.
    */
@@ -182,6 +199,8 @@ class BiasSVDPolicy
   double alpha;
   //! Regularization parameter for optimization.
   double lambda;
+  //! Whether DSGD is used instead of SGD.
+  bool parallel;
   //! Item matrix.
   arma::mat w;
   //! User matrix.
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/randomized_svd/randomized_svd.hpp>
+#include <mlpack/methods/cf/fold_in.hpp>
 
 namespace mlpack {
 namespace cf {
@@ -113,6 +114,23 @@ class RandomizedSVDPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Fold new ratings into the factorization: solve for the factors of the new
+   * items and of the users with new ratings with a few steps of alternating
+   * least squares, keeping the other factors fixed.
+   *
+   * @param data New ratings, as a (user, item, rating) table.
+   * @param cleanedData Item user table with all the ratings, including the new
+   *     ones.
+   * @param iterations Number of fold-in iterations.
+   */
+  void Update(const arma::mat& data,
+              const arma::sp_mat& cleanedData,
+              const size_t iterations)
+  {
+    FoldInRatings(data, cleanedData, w, h, iterations);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
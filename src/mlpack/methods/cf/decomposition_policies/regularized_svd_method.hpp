@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/regularized_svd/regularized_svd.hpp>
+#include <mlpack/methods/cf/fold_in.hpp>
 
 namespace mlpack {
 namespace cf {
@@ -46,9 +47,14 @@ class RegSVDPolicy
    *
    * @param maxIterations Number of iterations for the power method
    *        (Default: 2).
+   * @param parallel Whether to optimize with DSGD, which runs on all threads,
+   *     instead of SGD.
    */
-  RegSVDPolicy(const size_t maxIterations = 10) :
-      maxIterations(maxIterations)
+  RegSVDPolicy(const size_t maxIterations = 10,
+               const bool parallel = false) :
+      maxIterations(maxIterations),
+      onlineUpdate(false),
+      parallel(parallel)
   {
     /* Nothing to do here */
   }
@@ -73,8 +79,16 @@ class RegSVDPolicy
              const bool /* mit */)
   {
     // Do singular value decomposition using the regularized SVD algorithm.
-    svd::RegularizedSVD<> regsvd(maxIterations);
-    regsvd.Apply(data, rank, w, h);
+    if (parallel)
+    {
+      svd::RegularizedSVD<optimization::DSGD> regsvd(maxIterations);
+      regsvd.Apply(data, rank, w, h);
+    }
+    else
+    {
+      svd::RegularizedSVD<> regsvd(maxIterations);
+      regsvd.Apply(data, rank, w, h);
+    }
   }
 
   /**
@@ -100,6 +114,39 @@ class RegSVDPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Fold new ratings into the factorization.  By default, the factors of the
+   * new items and of the users with new ratings are solved for with a few
+   * steps of alternating least squares, keeping the other factors fixed.  If
+   * OnlineUpdate() is set, the given number of SGD epochs over the new ratings
+   * are run instead, which also nudges the factors of the existing items that
+   * were rated.
+   *
+   * @param data New ratings, as a (user, item, rating) table.
+   * @param cleanedData Item user table with all the ratings, including the new
+   *     ones.
+   * @param iterations Number of fold-in iterations, or of SGD epochs.
+   */
+  void Update(const arma::mat& data,
+              const arma::sp_mat& cleanedData,
+              const size_t iterations)
+  {
+    if (onlineUpdate && parallel)
+    {
+      svd::RegularizedSVD<optimization::DSGD> regsvd(iterations);
+      regsvd.Update(data, w, h);
+      return;
+    }
+    else if (onlineUpdate)
+    {
+      svd::RegularizedSVD<> regsvd(iterations);
+      regsvd.Update(data, w, h);
+      return;
+    }
+
+    FoldInRatings(data, cleanedData, w, h, iterations);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -149,6 +196,16 @@ class RegSVDPolicy
   //! Modify the number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get whether Update() runs SGD epochs instead of least squares steps.
+  bool OnlineUpdate() const { return onlineUpdate; }
+  //! Modify whether Update() runs SGD epochs instead of least squares steps.
+  bool& OnlineUpdate() { return onlineUpdate; }
+
+  //! Get whether DSGD is used instead of SGD.
+  bool Parallel() const { return parallel; }
+  //! Modify whether DSGD is used instead of SGD.
+  bool& Parallel() { return parallel; }
+
   /**
    * Serialization.
    */
@@ -162,6 +219,10 @@ class RegSVDPolicy
  private:
   //! Locally stored number of iterations.
   size_t maxIterations;
+  //! Whether Update() runs SGD epochs instead of least squares steps.
+  bool onlineUpdate;
+  //! Whether DSGD is used instead of SGD.
+  bool parallel;
   //! Item matrix.
   arma::mat w;
   //! User matrix.
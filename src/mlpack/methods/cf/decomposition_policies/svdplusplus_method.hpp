@@ -47,13 +47,17 @@ class SVDPlusPlusPolicy
    * @param maxIterations Number of iterations.
    * @param alpha Learning rate for optimization.
    * @param Regularization parameter for optimization.
+   * @param parallel Whether to optimize with DSGD, which runs on all threads,
+   *     instead of SGD.
    */
   SVDPlusPlusPolicy(const size_t maxIterations = 10,
                     const double alpha = 0.001,
-                    const double lambda = 0.1) :
+                    const double lambda = 0.1,
+                    const bool parallel = false) :
       maxIterations(maxIterations),
       alpha(alpha),
-      lambda(lambda)
+      lambda(lambda),
+      parallel(parallel)
   {
     /* Nothing to do here */
   }
@@ -77,14 +81,21 @@ class SVDPlusPlusPolicy
              const double /* minResidue */,
              const bool /* mit */)
   {
-    svd::SVDPlusPlus<> svdpp(maxIterations, alpha, lambda);
-
     // Save implicit data in the form of sparse matrix.
     arma::mat implicitDenseData = data.submat(0, 0, 1, data.n_cols - 1);
-    svdpp.CleanData(implicitDenseData, implicitData, data);
+    svd::SVDPlusPlus<>::CleanData(implicitDenseData, implicitData, data);
 
     // Perform decomposition using the svdplusplus algorithm.
-    svdpp.Apply(data, implicitDenseData, rank, w, h, p, q, y);
+    if (parallel)
+    {
+      svd::SVDPlusPlus<optimization::DSGD> svdpp(maxIterations, alpha, lambda);
+      svdpp.Apply(data, implicitDenseData, rank, w, h, p, q, y);
+    }
+    else
+    {
+      svd::SVDPlusPlus<> svdpp(maxIterations, alpha, lambda);
+      svdpp.Apply(data, implicitDenseData, rank, w, h, p, q, y);
+    }
   }
 
   /**
@@ -199,6 +210,11 @@ class SVDPlusPlusPolicy
   //! Modify regularization parameter.
   double& Lambda() { return lambda; }
 
+  //! Get whether DSGD is used instead of SGD.
+  bool Parallel() const { return parallel; }
+  //! Modify whether DSGD is used instead of SGD.
+  bool& Parallel() { return parallel; }
+
   /**
    * Serialization.
    */
@@ -223,6 +239,8 @@ class SVDPlusPlusPolicy
   double alpha;
   //! Regularization parameter for optimization.
   double lambda;
+  //! Whether DSGD is used instead of SGD.
+  bool parallel;
   //! Item matrix.
   arma::mat w;
   //! User matrix.
@@ -0,0 +1,101 @@
+/**
+ * @file fold_in.hpp
+ *
+ * Fold new ratings into an existing factorization of the rating matrix with a
+ * few steps of alternating least squares.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_FOLD_IN_HPP
+#define MLPACK_METHODS_CF_FOLD_IN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Fold new ratings into a factorization cleanedData ~ w * h, without
+ * refactorizing the whole rating matrix.  w and h are grown to the size of
+ * cleanedData.  Then, for the given number of iterations, the factors of the
+ * new items are solved for with the user factors fixed, and the factors of the
+ * users that have new ratings are solved for with the item factors fixed.
+ * Each of these is a small ridge regression over the ratings of one item or
+ * user, so the cost only depends on the number of ratings that are touched.
+ * The factors of the other users and items are not changed.
+ *
+ * @param data New (normalized) ratings, as a (user, item, rating) table.
+ * @param cleanedData Item user table with all the ratings, including the new
+ *     ones.
+ * @param w Item matrix to update.
+ * @param h User matrix to update.
+ * @param iterations Number of alternating iterations.
+ * @param lambda Regularization parameter of the least squares problems.
+ */
+inline void FoldInRatings(const arma::mat& data,
+                          const arma::sp_mat& cleanedData,
+                          arma::mat& w,
+                          arma::mat& h,
+                          const size_t iterations,
+                          const double lambda = 0.01)
+{
+  const size_t rank = w.n_cols;
+  const size_t oldItems = w.n_rows;
+
+  // New items and users start with zero factors.
+  w.resize(cleanedData.n_rows, rank);
+  h.resize(rank, cleanedData.n_cols);
+
+  const arma::uvec users = arma::conv_to<arma::uvec>::from(
+      arma::unique(data.row(0)));
+
+  // The ratings of the new items, with one column per item.
+  arma::sp_mat itemRatings;
+  if (cleanedData.n_rows > oldItems)
+    itemRatings = cleanedData.rows(oldItems, cleanedData.n_rows - 1).t();
+
+  const arma::mat regularization = lambda * arma::eye<arma::mat>(rank, rank);
+
+  for (size_t iteration = 0; iteration < iterations; ++iteration)
+  {
+    // Solve for the factors of the new items.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) itemRatings.n_cols; ++i)
+    {
+      arma::mat gram(regularization);
+      arma::vec rhs(rank, arma::fill::zeros);
+      arma::sp_mat::const_iterator it = itemRatings.begin_col(i);
+      for (; it != itemRatings.end_col(i); ++it)
+      {
+        gram += h.col(it.row()) * h.col(it.row()).t();
+        rhs += (*it) * h.col(it.row());
+      }
+
+      w.row(oldItems + i) = arma::solve(gram, rhs).t();
+    }
+
+    // Solve for the factors of the users with new ratings.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t u = 0; u < (omp_size_t) users.n_elem; ++u)
+    {
+      arma::mat gram(regularization);
+      arma::vec rhs(rank, arma::fill::zeros);
+      arma::sp_mat::const_iterator it = cleanedData.begin_col(users[u]);
+      for (; it != cleanedData.end_col(users[u]); ++it)
+      {
+        gram += w.row(it.row()).t() * w.row(it.row());
+        rhs += (*it) * w.row(it.row()).t();
+      }
+
+      h.col(users[u]) = arma::solve(gram, rhs);
+    }
+  }
+}
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_CF_NORMALIZATION_COMBINED_NORMALIZATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "normalization_traits.hpp"
 
 namespace mlpack {
 namespace cf {
@@ -203,6 +204,18 @@ class CombinedNormalization
   { }
 };
 
+//! A sequence of normalizations is item dependent if any of them is.
+template<typename NormalizationType, typename... NormalizationTypes>
+class NormalizationTraits<CombinedNormalization<NormalizationType,
+                                                 NormalizationTypes...>>
+{
+ public:
+  static const bool IsItemDependent =
+      NormalizationTraits<NormalizationType>::IsItemDependent ||
+      NormalizationTraits<CombinedNormalization<NormalizationTypes...>>::
+          IsItemDependent;
+};
+
 } // namespace cf
 } // namespace mlpack
 
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_CF_NORMALIZATION_ITEM_MEAN_NORMALIZATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "normalization_traits.hpp"
 
 namespace mlpack {
 namespace cf {
@@ -166,6 +167,14 @@ class ItemMeanNormalization
   arma::vec itemMean;
 };
 
+//! Each item is shifted by its own mean.
+template<>
+class NormalizationTraits<ItemMeanNormalization>
+{
+ public:
+  static const bool IsItemDependent = true;
+};
+
 } // namespace cf
 } // namespace mlpack
 
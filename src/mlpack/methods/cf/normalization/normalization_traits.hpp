@@ -0,0 +1,40 @@
+/**
+ * @file normalization_traits.hpp
+ *
+ * Compile-time information on the normalization methods of CF.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_NORMALIZATION_NORMALIZATION_TRAITS_HPP
+#define MLPACK_METHODS_CF_NORMALIZATION_NORMALIZATION_TRAITS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * The NormalizationTraits class provides compile-time information on a
+ * normalization method.  Specialize it for normalizations whose traits differ
+ * from the defaults below.
+ */
+template<typename NormalizationType>
+class NormalizationTraits
+{
+ public:
+  /**
+   * This is true if the normalization changes the ratings of some items
+   * differently from those of others, so that the ranking of the items by
+   * their normalized predicted ratings is not the ranking by their
+   * denormalized predicted ratings.
+   */
+  static const bool IsItemDependent = false;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
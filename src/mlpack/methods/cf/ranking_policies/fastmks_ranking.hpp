@@ -0,0 +1,176 @@
+/**
+ * @file fastmks_ranking.hpp
+ *
+ * Ranking of items for CF recommendations with maximum inner product search
+ * over the item factors.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_FASTMKS_RANKING_HPP
+#define MLPACK_METHODS_CF_FASTMKS_RANKING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
+#include <mlpack/methods/cf/decomposition_policies/bias_svd_method.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * FastMKSRanking finds the best items for a user with maximum inner product
+ * search, instead of scoring every item.  It can be used with decomposition
+ * policies whose predicted ratings are W * h for a user vector h (for instance
+ * NMFPolicy, RegSVDPolicy, RandomizedSVDPolicy, BatchSVDPolicy and the
+ * SVDComplete/SVDIncomplete policies) and with BiasSVDPolicy.  Since the
+ * predicted rating of a user is a weighted sum of the ratings of its
+ * neighbors, it is also the inner product of each item's factors with the
+ * same weighted sum of the neighbors' factors; so FastMKS with the linear
+ * kernel, on a cover tree built once over the item factors, finds the top
+ * items for each user.
+ *
+ * Items are ranked by their normalized predicted ratings.  This is the same
+ * ranking as that of the denormalized ratings for every normalization that
+ * does not depend on the item, so CFType::GetRecommendations() rejects
+ * ItemMeanNormalization (and combinations including it) at compile time.
+ *
+ * An example of how to use FastMKSRanking in CF is shown below:
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * // Users for whom recommendations are generated.
+ * extern arma::Col<size_t> users;
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * CFType<RegSVDPolicy> cf(data, RegSVDPolicy());
+ *
+ * // The index can be reused for any number of calls.
+ * FastMKSRanking ranking(cf.Decomposition());
+ * cf.GetRecommendations(10, recommendations, users, ranking);
+ * @endcode
+ */
+class FastMKSRanking
+{
+ public:
+  /**
+   * Create an empty FastMKSRanking object.  Be sure to call Train() before
+   * using it.
+   */
+  FastMKSRanking() { }
+
+  /**
+   * Build the index over the item factors of the given decomposition.
+   *
+   * @param decomposition Trained decomposition policy.
+   */
+  template<typename DecompositionPolicy>
+  FastMKSRanking(const DecompositionPolicy& decomposition)
+  {
+    Train(decomposition);
+  }
+
+  // The FastMKS object refers to the items matrix, so copies are not allowed.
+  FastMKSRanking(const FastMKSRanking& other) = delete;
+  FastMKSRanking& operator=(const FastMKSRanking& other) = delete;
+
+  /**
+   * Build the index over the item factors of the given decomposition, whose
+   * predicted ratings are W * h.
+   *
+   * @param decomposition Trained decomposition policy.
+   */
+  template<typename DecompositionPolicy>
+  void Train(const DecompositionPolicy& decomposition)
+  {
+    items = decomposition.W().t();
+    fastmks.Train(items);
+  }
+
+  /**
+   * Build the index over the item factors of a BiasSVDPolicy.  The item biases
+   * are appended to the factors as an extra dimension.
+   *
+   * @param decomposition Trained decomposition policy.
+   */
+  void Train(const BiasSVDPolicy& decomposition)
+  {
+    items = arma::join_cols(decomposition.W().t(), decomposition.P().t());
+    fastmks.Train(items);
+  }
+
+  /**
+   * Compute the query vector of a user from its neighbors and the
+   * interpolation weights of the neighbors.
+   *
+   * @param decomposition Trained decomposition policy.
+   * @param neighbors Neighbors of the user.
+   * @param weights Interpolation weights of the neighbors.
+   * @param query Vector to store the query in.
+   */
+  template<typename DecompositionPolicy, typename NeighborsType,
+           typename WeightsType>
+  void Query(const DecompositionPolicy& decomposition,
+             const NeighborsType& neighbors,
+             const WeightsType& weights,
+             arma::vec& query) const
+  {
+    query.zeros(decomposition.H().n_rows);
+    for (size_t j = 0; j < neighbors.n_elem; ++j)
+      query += weights[j] * decomposition.H().col(neighbors[j]);
+  }
+
+  /**
+   * Compute the query vector of a user for a BiasSVDPolicy.  The user biases
+   * are the same for every item, so they don't change the ranking and are
+   * left out.
+   */
+  template<typename NeighborsType, typename WeightsType>
+  void Query(const BiasSVDPolicy& decomposition,
+             const NeighborsType& neighbors,
+             const WeightsType& weights,
+             arma::vec& query) const
+  {
+    query.zeros(decomposition.H().n_rows + 1);
+    for (size_t j = 0; j < neighbors.n_elem; ++j)
+    {
+      query.head(decomposition.H().n_rows) += weights[j] *
+          decomposition.H().col(neighbors[j]);
+    }
+
+    // The item biases are weighted by the sum of the weights.
+    query[decomposition.H().n_rows] = arma::accu(weights);
+  }
+
+  /**
+   * Find the k items with the largest inner product with each query.
+   *
+   * @param queries Set of queries, one per column.
+   * @param k Number of items to find.
+   * @param indices Matrix to store the indices of the items in.
+   * @param products Matrix to store the inner products in.
+   */
+  void Search(const arma::mat& queries,
+              const size_t k,
+              arma::Mat<size_t>& indices,
+              arma::mat& products)
+  {
+    fastmks.Search(queries, k, indices, products);
+  }
+
+  //! Get the item factors (one column per item).
+  const arma::mat& Items() const { return items; }
+
+ private:
+  //! The item factors.
+  arma::mat items;
+  //! The index over the item factors.
+  fastmks::FastMKS<kernel::LinearKernel> fastmks;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
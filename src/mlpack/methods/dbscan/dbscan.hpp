@@ -15,8 +15,10 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
 #include <mlpack/methods/emst/union_find.hpp>
 #include "random_point_selection.hpp"
+#include "dbscan_rules.hpp"
 #include <boost/dynamic_bitset.hpp>
 
 namespace mlpack {
@@ -154,6 +156,41 @@ class DBSCAN
   template<typename MatType>
   void BatchCluster(const MatType& data,
                     emst::UnionFind& uf);
+
+  /**
+   * Merge the points of the given dataset in the given UnionFind structure
+   * with a parallel dual-tree traversal that never stores the neighbors of any
+   * point.  This is used by BatchCluster() when the range search is done with
+   * trees.
+   *
+   * @param rangeSearch RangeSearch object whose tree type and metric are used.
+   * @param data Dataset to cluster.
+   * @param uf UnionFind structure that will be modified.
+   * @return true, since the dual-tree traversal can always be used.
+   */
+  template<typename MetricType,
+           typename MatType,
+           template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  bool DualTreeCluster(range::RangeSearch<MetricType, MatType, TreeType>&
+                           rangeSearch,
+                       const MatType& data,
+                       emst::UnionFind& uf);
+
+  /**
+   * Fallback for range search types other than RangeSearch, whose trees cannot
+   * be traversed with DBSCANRules.
+   *
+   * @return false, so that BatchCluster() uses the range search results.
+   */
+  template<typename OtherRangeSearchType, typename MatType>
+  bool DualTreeCluster(OtherRangeSearchType& /* rangeSearch */,
+                       const MatType& /* data */,
+                       emst::UnionFind& /* uf */)
+  {
+    return false;
+  }
 };
 
 } // namespace dbscan
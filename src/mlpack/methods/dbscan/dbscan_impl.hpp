@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_DBSCAN_DBSCAN_IMPL_HPP
 
 #include "dbscan.hpp"
+#include <mlpack/core/tree/instrumented_rules.hpp>
 
 namespace mlpack {
 namespace dbscan {
@@ -102,12 +103,16 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
 {
   // Initialize the UnionFind object.
   emst::UnionFind uf(data.n_cols);
-  rangeSearch.Train(data);
 
   if (batchMode)
+  {
     BatchCluster(data, uf);
+  }
   else
+  {
+    rangeSearch.Train(data);
     PointwiseCluster(data, uf);
+  }
 
   // Now set assignments.
   assignments.set_size(data.n_cols);
@@ -181,6 +186,10 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     const MatType& data,
     emst::UnionFind& uf)
 {
+  // With trees, the neighborhoods don't need to be stored at all.
+  if (DualTreeCluster(rangeSearch, data, uf))
+    return;
+
   // For each point, find the points in epsilon-nighborhood and their distances.
   std::vector<std::vector<size_t>> neighbors;
   std::vector<std::vector<double>> distances;
@@ -198,6 +207,56 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
   }
 }
 
+/**
+ * Merge all the points within epsilon of each other with a parallel dual-tree
+ * traversal, without storing any neighborhoods.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+bool DBSCAN<RangeSearchType, PointSelectionPolicy>::DualTreeCluster(
+    range::RangeSearch<MetricType, MatType, TreeType>& rangeSearch,
+    const MatType& data,
+    emst::UnionFind& uf)
+{
+  if (rangeSearch.Naive())
+    return false;
+
+  typedef typename range::RangeSearch<MetricType, MatType, TreeType>::Tree
+      Tree;
+  typedef tree::TraversalRules<DBSCANRules<MetricType, Tree>> RuleType;
+
+  Log::Info << "Performing dual-tree clustering." << std::endl;
+
+  std::vector<size_t> oldFromNew;
+  Tree* tree = range::BuildTree<Tree>(data, oldFromNew);
+
+  MetricType metric;
+  RuleType rules(tree->Dataset(), epsilon, metric, uf,
+      tree::TreeTraits<Tree>::RearrangesDataset ? &oldFromNew : NULL);
+
+  tree::ParallelDualTreeTraverser<Tree, RuleType,
+      Tree::template DualTreeTraverser> traverser(rules);
+  traverser.Traverse(*tree, *tree);
+
+  // Merge whatever each thread still has buffered.
+  size_t baseCases = 0;
+  for (size_t i = 0; i < traverser.Rules().size(); ++i)
+  {
+    traverser.Rules()[i].Flush();
+    baseCases += traverser.Rules()[i].BaseCases();
+  }
+
+  Log::Info << "Dual-tree clustering complete (" << baseCases
+      << " base cases)." << std::endl;
+
+  delete tree;
+  return true;
+}
+
 } // namespace dbscan
 } // namespace mlpack
 
@@ -0,0 +1,152 @@
+/**
+ * @file dbscan_rules.hpp
+ *
+ * Rules for a dual-tree traversal that finds the connected components of the
+ * epsilon-neighborhood graph of a dataset, without storing the neighborhood of
+ * any point.  Used by DBSCAN in batch mode.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DBSCAN_DBSCAN_RULES_HPP
+#define MLPACK_METHODS_DBSCAN_DBSCAN_RULES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/methods/emst/union_find.hpp>
+
+namespace mlpack {
+namespace dbscan {
+
+/**
+ * The DBSCANRules class is used for a monochromatic dual-tree traversal that
+ * merges, in a UnionFind structure, every pair of points that are within
+ * epsilon of each other.  Instead of building a list of neighbors for each
+ * point, each pair found is added to a small buffer of edges, which is merged
+ * into the UnionFind structure when it is full (and by Flush()).  When every
+ * point of a query node is within epsilon of every point of a reference node,
+ * all of the points of both nodes are merged at once and the pair is pruned,
+ * so dense regions cost time proportional to the number of points and not the
+ * number of pairs.
+ *
+ * The UnionFind structure is shared by all copies of the rules; merges are done
+ * in a critical section, so the rules can be used with the
+ * ParallelDualTreeTraverser.  The memory used by each copy is bounded by the
+ * size of the edge buffer.
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ */
+template<typename MetricType, typename TreeType>
+class DBSCANRules
+{
+ public:
+  /**
+   * Construct the DBSCANRules object.  If the tree rearranges the dataset,
+   * oldFromNew must be the mapping from the indices of the tree to the indices
+   * of the points in the UnionFind structure; otherwise it should be NULL.
+   *
+   * @param dataset Dataset held by the tree.
+   * @param epsilon Maximum distance between two points to be merged.
+   * @param metric Instantiated metric.
+   * @param uf UnionFind structure to merge points in.
+   * @param oldFromNew Mapping of tree indices to original indices, or NULL.
+   * @param maxEdges Number of edges to buffer before merging them.
+   */
+  DBSCANRules(const arma::mat& dataset,
+              const double epsilon,
+              MetricType& metric,
+              emst::UnionFind& uf,
+              const std::vector<size_t>* oldFromNew = NULL,
+              const size_t maxEdges = 65536);
+
+  /**
+   * Compute the distance between the two points, and merge them if they are
+   * within epsilon of each other.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndex Index of reference point.
+   */
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Get the score for recursion order.  The node combination is pruned if the
+   * nodes are too far apart to hold any pair within epsilon; if every pair is
+   * within epsilon, all the points are merged and the combination is pruned
+   * too.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   */
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  Nothing changes during the
+   * traversal that could allow more pruning, so the old score is returned.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  //! Merge all the buffered edges into the UnionFind structure.
+  void Flush();
+
+  typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
+
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores (that is, calls to RangeDistance()).
+  size_t Scores() const { return scores; }
+
+ private:
+  //! The dataset.
+  const arma::mat& dataset;
+  //! The maximum distance between two points to be merged.
+  double epsilon;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The UnionFind structure shared by all copies of the rules.
+  emst::UnionFind& uf;
+  //! Mapping from tree indices to original indices (NULL if not needed).
+  const std::vector<size_t>* oldFromNew;
+
+  //! Edges found but not yet merged, with the original indices of the points.
+  std::vector<std::pair<size_t, size_t>> edges;
+  //! Number of edges to buffer before merging them.
+  size_t maxEdges;
+
+  //! The last query index.
+  size_t lastQueryIndex;
+  //! The last reference index.
+  size_t lastReferenceIndex;
+
+  TraversalInfoType traversalInfo;
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of scores.
+  size_t scores;
+
+  //! Buffer the edge between the two given points (indices of the tree).
+  void AddEdge(const size_t a, const size_t b);
+
+  //! Buffer edges that merge every point of both nodes.
+  void MergeNodes(TreeType& queryNode, TreeType& referenceNode);
+};
+
+} // namespace dbscan
+} // namespace mlpack
+
+// Include implementation.
+#include "dbscan_rules_impl.hpp"
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file dbscan_rules_impl.hpp
+ *
+ * Implementation of the rules used by DBSCAN to merge neighboring points during
+ * a dual-tree traversal.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DBSCAN_DBSCAN_RULES_IMPL_HPP
+#define MLPACK_METHODS_DBSCAN_DBSCAN_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "dbscan_rules.hpp"
+
+namespace mlpack {
+namespace dbscan {
+
+template<typename MetricType, typename TreeType>
+DBSCANRules<MetricType, TreeType>::DBSCANRules(
+    const arma::mat& dataset,
+    const double epsilon,
+    MetricType& metric,
+    emst::UnionFind& uf,
+    const std::vector<size_t>* oldFromNew,
+    const size_t maxEdges) :
+    dataset(dataset),
+    epsilon(epsilon),
+    metric(metric),
+    uf(uf),
+    oldFromNew(oldFromNew),
+    maxEdges(std::max(maxEdges, (size_t) 1)),
+    lastQueryIndex(dataset.n_cols),
+    lastReferenceIndex(dataset.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename TreeType>
+inline force_inline
+double DBSCANRules<MetricType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  // A point is always in its own cluster.
+  if (queryIndex == referenceIndex)
+    return 0.0;
+
+  // If we have just performed this base case, don't do it again.
+  if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
+    return 0.0;
+
+  const double distance = metric.Evaluate(dataset.unsafe_col(queryIndex),
+      dataset.unsafe_col(referenceIndex));
+  ++baseCases;
+
+  lastQueryIndex = queryIndex;
+  lastReferenceIndex = referenceIndex;
+
+  // Both (i, j) and (j, i) are visited, so only one of them has to be merged.
+  if (distance <= epsilon && queryIndex < referenceIndex)
+    AddEdge(queryIndex, referenceIndex);
+
+  return distance;
+}
+
+template<typename MetricType, typename TreeType>
+double DBSCANRules<MetricType, TreeType>::Score(TreeType& queryNode,
+                                                TreeType& referenceNode)
+{
+  math::Range distances;
+  if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+  {
+    // It is possible that the base case has already been calculated.
+    double baseCase = 0.0;
+    if ((traversalInfo.LastQueryNode() != NULL) &&
+        (traversalInfo.LastReferenceNode() != NULL) &&
+        (traversalInfo.LastQueryNode()->Point(0) == queryNode.Point(0)) &&
+        (traversalInfo.LastReferenceNode()->Point(0) == referenceNode.Point(0)))
+    {
+      baseCase = traversalInfo.LastBaseCase();
+      lastQueryIndex = queryNode.Point(0);
+      lastReferenceIndex = referenceNode.Point(0);
+    }
+    else
+    {
+      baseCase = BaseCase(queryNode.Point(0), referenceNode.Point(0));
+    }
+
+    distances.Lo() = baseCase - queryNode.FurthestDescendantDistance()
+        - referenceNode.FurthestDescendantDistance();
+    distances.Hi() = baseCase + queryNode.FurthestDescendantDistance()
+        + referenceNode.FurthestDescendantDistance();
+
+    traversalInfo.LastBaseCase() = baseCase;
+  }
+  else
+  {
+    distances = referenceNode.RangeDistance(queryNode);
+    ++scores;
+  }
+
+  // No pair of points can be within epsilon.
+  if (distances.Lo() > epsilon)
+    return DBL_MAX;
+
+  // Every pair of points is within epsilon, so all of the points of both nodes
+  // are in the same cluster.
+  if (distances.Hi() <= epsilon)
+  {
+    MergeNodes(queryNode, referenceNode);
+    return DBL_MAX;
+  }
+
+  // Otherwise the score doesn't matter; recursion order is irrelevant here.
+  traversalInfo.LastQueryNode() = &queryNode;
+  traversalInfo.LastReferenceNode() = &referenceNode;
+  return 0.0;
+}
+
+template<typename MetricType, typename TreeType>
+double DBSCANRules<MetricType, TreeType>::Rescore(
+    TreeType& /* queryNode */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  // If it wasn't pruned before, it isn't pruned now.
+  return oldScore;
+}
+
+template<typename MetricType, typename TreeType>
+void DBSCANRules<MetricType, TreeType>::Flush()
+{
+  if (edges.empty())
+    return;
+
+  #pragma omp critical(dbscan_union_find)
+  {
+    for (size_t i = 0; i < edges.size(); ++i)
+      uf.Union(edges[i].first, edges[i].second);
+  }
+
+  edges.clear();
+}
+
+template<typename MetricType, typename TreeType>
+void DBSCANRules<MetricType, TreeType>::AddEdge(const size_t a, const size_t b)
+{
+  if (oldFromNew)
+    edges.push_back(std::make_pair((*oldFromNew)[a], (*oldFromNew)[b]));
+  else
+    edges.push_back(std::make_pair(a, b));
+
+  if (edges.size() >= maxEdges)
+    Flush();
+}
+
+template<typename MetricType, typename TreeType>
+void DBSCANRules<MetricType, TreeType>::MergeNodes(TreeType& queryNode,
+                                                   TreeType& referenceNode)
+{
+  // Two points of the same node may be further apart than epsilon, but each is
+  // within epsilon of every point of the other node, so they are connected
+  // through it.  It is enough to connect every point to a single one.
+  const size_t representative = queryNode.Descendant(0);
+  for (size_t i = 1; i < queryNode.NumDescendants(); ++i)
+    AddEdge(representative, queryNode.Descendant(i));
+  for (size_t i = 0; i < referenceNode.NumDescendants(); ++i)
+    AddEdge(representative, referenceNode.Descendant(i));
+}
+
+} // namespace dbscan
+} // namespace mlpack
+
+#endif
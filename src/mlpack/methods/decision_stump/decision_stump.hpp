@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_DECISION_STUMP_DECISION_STUMP_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <memory>
 
 namespace mlpack {
 namespace decision_stump {
@@ -51,7 +52,10 @@ class DecisionStump
   /**
    * Alternate constructor which copies the parameters bucketSize and classes
    * from an already initiated decision stump, other. It appropriately sets the
-   * weight vector.
+   * weight vector.  If other was trained on the same data object, the order of
+   * the points along each dimension is taken from other instead of sorting the
+   * data again (so the data must not have been modified in the meantime); this
+   * is what AdaBoost does in every round.
    *
    * @param other The other initiated Decision Stump object from
    *      which we copy the values.
@@ -134,6 +138,9 @@ class DecisionStump
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  // Stumps on other matrix types share the sort order of other.
+  template<typename> friend class DecisionStump;
+
   //! The number of classes (we must store this for boosting).
   size_t numClasses;
   //! The minimum number of points in a bucket.
@@ -146,16 +153,31 @@ class DecisionStump
   //! Stores the labels for each splitting bin.
   arma::Col<size_t> binLabels;
 
+  //! The order of the points along each dimension of the training data, one
+  //! column per dimension; it is shared with the stumps trained from this one.
+  std::shared_ptr<const arma::umat> sortedIndices;
+  //! The data sortedIndices was computed for.
+  const void* sortedData;
+
+  /**
+   * Make sure that sortedIndices holds the order of the points of the given
+   * data along each dimension, sorting the dimensions (in parallel) if it was
+   * computed for other data.
+   *
+   * @param data Dataset to train on.
+   */
+  void SortDimensions(const MatType& data);
+
   /**
    * Sets up dimension as if it were splitting on it and finds entropy when
    * splitting on dimension.
    *
-   * @param dimension A row from the training data, which might be a
-   *     candidate for the splitting dimension.
+   * @param sortedIndexDim The order of the points along a dimension of the
+   *     training data, which might be a candidate for the splitting dimension.
    * @tparam UseWeights Whether we need to run a weighted Decision Stump.
    */
-  template<bool UseWeights, typename VecType>
-  double SetupSplitDimension(const VecType& dimension,
+  template<bool UseWeights, typename IndexVecType>
+  double SetupSplitDimension(const IndexVecType& sortedIndexDim,
                              const arma::Row<size_t>& labels,
                              const arma::rowvec& weightD);
 
@@ -165,9 +187,11 @@ class DecisionStump
    *
    * @tparam dimension dimension is the dimension decided by the constructor
    *      on which we now train the decision stump.
+   * @param sortedIndexDim The order of the points along the dimension.
    */
-  template<typename VecType>
+  template<typename VecType, typename IndexVecType>
   void TrainOnDim(const VecType& dimension,
+                  const IndexVecType& sortedIndexDim,
                   const arma::Row<size_t>& labels);
 
   /**
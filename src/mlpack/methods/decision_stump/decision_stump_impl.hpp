@@ -32,7 +32,8 @@ DecisionStump<MatType>::DecisionStump(const MatType& data,
                                       const size_t numClasses,
                                       const size_t bucketSize) :
     numClasses(numClasses),
-    bucketSize(bucketSize)
+    bucketSize(bucketSize),
+    sortedData(NULL)
 {
   arma::rowvec weights;
   Train<false>(data, labels, weights);
@@ -47,7 +48,8 @@ DecisionStump<MatType>::DecisionStump() :
     bucketSize(0),
     splitDimension(0),
     split(1),
-    binLabels(1)
+    binLabels(1),
+    sortedData(NULL)
 {
   split[0] = DBL_MAX;
   binLabels[0] = 0;
@@ -65,6 +67,9 @@ void DecisionStump<MatType>::Train(const MatType& data,
   this->numClasses = numClasses;
   this->bucketSize = bucketSize;
 
+  // The data may have changed since the last training, so it is sorted again.
+  sortedIndices.reset();
+
   // Pass to unweighted training function.
   arma::rowvec weights;
   Train<false>(data, labels, weights);
@@ -85,6 +90,9 @@ void DecisionStump<MatType>::Train(const MatType& data,
   this->numClasses = numClasses;
   this->bucketSize = bucketSize;
 
+  // The data may have changed since the last training, so it is sorted again.
+  sortedIndices.reset();
+
   // Pass to weighted training function.
   Train<true>(data, labels, weights);
 }
@@ -102,38 +110,71 @@ void DecisionStump<MatType>::Train(const MatType& data,
                                    const arma::Row<size_t>& labels,
                                    const arma::rowvec& weights)
 {
+  SortDimensions(data);
+
   // If classLabels are not all identical, proceed with training.
-  size_t bestDim = 0;
-  double entropy;
   const double rootEntropy = CalculateEntropy<UseWeights>(labels, weights);
 
-  double gain, bestGain = 0.0;
-  for (size_t i = 0; i < data.n_rows; i++)
+  // The dimensions are evaluated independently, in parallel.  A dimension
+  // whose values are all identical gets a gain of zero, so it is never picked.
+  arma::vec gains(data.n_rows, arma::fill::zeros);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; i++)
   {
-    // Go through each dimension of the data.
+    // For each dimension with non-identical values, treat it as a potential
+    // splitting dimension and calculate entropy if split on it.
     if (IsDistinct(data.row(i)))
     {
-      // For each dimension with non-identical values, treat it as a potential
-      // splitting dimension and calculate entropy if split on it.
-      entropy = SetupSplitDimension<UseWeights>(data.row(i), labels, weights);
-
-      gain = rootEntropy - entropy;
-      // Find the dimension with the best entropy so that the gain is
-      // maximized.
+      gains[i] = rootEntropy - SetupSplitDimension<UseWeights>(
+          sortedIndices->col(i), labels, weights);
+    }
+  }
 
-      // We are maximizing gain, which is what is returned from
-      // SetupSplitDimension().
-      if (gain < bestGain)
-      {
-        bestDim = i;
-        bestGain = gain;
-      }
+  // Find the dimension with the best entropy so that the gain is maximized.
+  // The dimensions are visited in order, so ties go to the first one.
+  size_t bestDim = 0;
+  double bestGain = 0.0;
+  for (size_t i = 0; i < data.n_rows; i++)
+  {
+    // We are maximizing gain, which is what is returned from
+    // SetupSplitDimension().
+    if (gains[i] < bestGain)
+    {
+      bestDim = i;
+      bestGain = gains[i];
     }
   }
   splitDimension = bestDim;
 
   // Once the splitting column/dimension has been decided, train on it.
-  TrainOnDim(data.row(splitDimension), labels);
+  TrainOnDim(data.row(splitDimension), sortedIndices->col(splitDimension),
+      labels);
+}
+
+/**
+ * Sort each dimension of the data, unless the order was already computed for
+ * this data.
+ */
+template<typename MatType>
+void DecisionStump<MatType>::SortDimensions(const MatType& data)
+{
+  if (sortedIndices && sortedData == (const void*) &data &&
+      sortedIndices->n_rows == data.n_cols &&
+      sortedIndices->n_cols == data.n_rows)
+    return;
+
+  // The result may be shared with other stumps, so it is never modified in
+  // place.
+  std::shared_ptr<arma::umat> indices(new arma::umat(data.n_cols,
+      data.n_rows));
+
+  // This sort is stable.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; i++)
+    indices->col(i) = arma::stable_sort_index(data.row(i).t());
+
+  sortedIndices = indices;
+  sortedData = &data;
 }
 
 /**
@@ -149,7 +190,10 @@ void DecisionStump<MatType>::Classify(const MatType& test,
                                       arma::Row<size_t>& predictedLabels)
 {
   predictedLabels.set_size(test.n_cols);
-  for (size_t i = 0; i < test.n_cols; i++)
+
+  // Every point is classified independently.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) test.n_cols; i++)
   {
     // Determine which bin the test point falls into.
     // Assume first that it falls into the first bin, then proceed through the
@@ -188,7 +232,9 @@ DecisionStump<MatType>::DecisionStump(const DecisionStump<>& other,
                                       const size_t numClasses,
                                       const arma::rowvec& weights) :
     numClasses(numClasses),
-    bucketSize(other.bucketSize)
+    bucketSize(other.bucketSize),
+    sortedIndices(other.sortedIndices),
+    sortedData(other.sortedData)
 {
   Train<true>(data, labels, weights);
 }
@@ -208,6 +254,13 @@ void DecisionStump<MatType>::serialize(Archive& ar,
   ar & BOOST_SERIALIZATION_NVP(splitDimension);
   ar & BOOST_SERIALIZATION_NVP(split);
   ar & BOOST_SERIALIZATION_NVP(binLabels);
+
+  // The sort order belongs to the data the stump was trained on.
+  if (Archive::is_loading::value)
+  {
+    sortedIndices.reset();
+    sortedData = NULL;
+  }
 }
 
 /**
@@ -219,23 +272,21 @@ void DecisionStump<MatType>::serialize(Archive& ar,
  * @param UseWeights Whether we need to run a weighted Decision Stump.
  */
 template<typename MatType>
-template<bool UseWeights, typename VecType>
+template<bool UseWeights, typename IndexVecType>
 double DecisionStump<MatType>::SetupSplitDimension(
-    const VecType& dimension,
+    const IndexVecType& sortedIndexDim,
     const arma::Row<size_t>& labels,
     const arma::rowvec& weights)
 {
   size_t i, count, begin, end;
   double entropy = 0.0;
 
-  // Store the indices of the sorted dimension to build a vector of sorted
-  // labels.  This sort is stable.
-  arma::uvec sortedIndexDim = arma::stable_sort_index(dimension.t());
+  // Use the indices of the sorted dimension to build a vector of sorted
+  // labels.
+  arma::Row<size_t> sortedLabels(sortedIndexDim.n_elem);
+  arma::rowvec sortedWeights(sortedIndexDim.n_elem);
 
-  arma::Row<size_t> sortedLabels(dimension.n_elem);
-  arma::rowvec sortedWeights(dimension.n_elem);
-
-  for (i = 0; i < dimension.n_elem; i++)
+  for (i = 0; i < sortedIndexDim.n_elem; i++)
   {
     sortedLabels(i) = labels(sortedIndexDim(i));
 
@@ -309,19 +360,20 @@ double DecisionStump<MatType>::SetupSplitDimension(
  *      which we now train the decision stump.
  */
 template<typename MatType>
-template<typename VecType>
+template<typename VecType, typename IndexVecType>
 void DecisionStump<MatType>::TrainOnDim(const VecType& dimension,
+                                        const IndexVecType& sortedIndexDim,
                                         const arma::Row<size_t>& labels)
 {
   size_t i, count, begin, end;
 
-  typename MatType::row_type sortedSplitDim = arma::sort(dimension);
-  arma::uvec sortedSplitIndexDim = arma::stable_sort_index(dimension.t());
+  arma::rowvec sortedSplitDim(dimension.n_elem);
   arma::Row<size_t> sortedLabels(dimension.n_elem);
-  sortedLabels.fill(0);
-
   for (i = 0; i < dimension.n_elem; i++)
-    sortedLabels(i) = labels(sortedSplitIndexDim(i));
+  {
+    sortedSplitDim(i) = dimension(sortedIndexDim(i));
+    sortedLabels(i) = labels(sortedIndexDim(i));
+  }
 
   arma::rowvec subCols;
   double mostFreq;
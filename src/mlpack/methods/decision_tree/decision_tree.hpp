@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 #include "gini_gain.hpp"
 #include "best_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
 #include "all_categorical_split.hpp"
 #include "all_dimension_select.hpp"
 #include <type_traits>
@@ -371,6 +372,9 @@ class DecisionTree :
    */
   arma::vec classProbabilities;
 
+  //! FlatForest reads the nodes to compile them into its own layout.
+  template<typename> friend class FlatForest;
+
   //! Note that this class will also hold the members of the NumericSplit and
   //! CategoricalSplit AuxiliarySplitInfo classes, since it inherits from them.
   //! We'll define some convenience typedefs here.
@@ -379,6 +383,10 @@ class DecisionTree :
   typedef typename CategoricalSplit::template AuxiliarySplitInfo<ElemType>
       CategoricalAuxiliarySplitInfo;
 
+  //! Nodes with at least this many points evaluate their dimensions and build
+  //! their children in parallel, when OpenMP is available.
+  static size_t MinimumParallelSize() { return 1024; }
+
   /**
    * Calculate the class probabilities of the given labels.
    */
@@ -436,6 +444,32 @@ class DecisionTree :
              arma::rowvec& weights,
              const size_t minimumLeafSize = 10,
              const double minimumGainSplit = 1e-7);
+
+  /**
+   * Find the best of the given candidate dimensions to split on, leaving its
+   * split in classProbabilities and the auxiliary split information.  The
+   * function evaluate(dimension, gain, classProbabilities, numericAux,
+   * categoricalAux) should return the gain of the best split of the dimension
+   * that is better than the given gain, or that gain if there is none.
+   *
+   * For nodes with fewer than MinimumParallelSize() points, the dimensions are
+   * evaluated in order, each against the best gain found so far.  For larger
+   * nodes, every dimension is evaluated against the gain of not splitting, in
+   * parallel; then the dimensions that may still beat the best gain are
+   * evaluated again against it, so both give the same split.
+   *
+   * @param dimensions Candidate dimensions, in the order they were selected.
+   * @param count Number of points in this node.
+   * @param noSplit Value to return if no dimension gives a better split.
+   * @param bestGain Gain of not splitting; set to the gain of the best split.
+   * @param evaluate Function evaluating a split on one dimension.
+   */
+  template<typename EvaluateFunction>
+  size_t BestDimension(const std::vector<size_t>& dimensions,
+                       const size_t count,
+                       const size_t noSplit,
+                       double& bestGain,
+                       EvaluateFunction evaluate);
 };
 
 /**
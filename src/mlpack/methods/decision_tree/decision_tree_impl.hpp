@@ -12,6 +12,16 @@
 #ifndef MLPACK_METHODS_DECISION_TREE_DECISION_TREE_IMPL_HPP
 #define MLPACK_METHODS_DECISION_TREE_DECISION_TREE_IMPL_HPP
 
+// Evaluating dimensions and building subtrees concurrently needs OpenMP tasks
+// (OpenMP 3.0); with older implementations, such as Visual Studio's, training
+// is serial.
+#if defined(HAS_OPENMP) && defined(_OPENMP) && (_OPENMP >= 200805)
+  #include <omp.h>
+  #define MLPACK_DECISION_TREE_USE_TASKS
+#endif
+
+#include <mlpack/core/util/parallel_blocks.hpp>
+
 namespace mlpack {
 namespace tree {
 
@@ -535,6 +545,21 @@ void DecisionTree<FitnessFunction,
                                       const size_t minimumLeafSize,
                                       const double minimumGainSplit)
 {
+#ifdef MLPACK_DECISION_TREE_USE_TASKS
+  // The root of a large tree opens the parallel region that the tasks for the
+  // dimensions and subtrees of the whole tree run in.
+  if (omp_get_level() == 0 && count >= MinimumParallelSize())
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      Train<UseWeights>(data, begin, count, datasetInfo, labels, numClasses,
+          weights, minimumLeafSize, minimumGainSplit);
+    }
+    return;
+  }
+#endif
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -549,15 +574,21 @@ void DecisionTree<FitnessFunction,
       labels.subvec(begin, begin + count - 1),
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
+  std::vector<size_t> candidates;
   DimensionSelectionType dimensions(datasetInfo.Dimensionality());
   for (size_t i = dimensions.Begin(); i != dimensions.End();
        i = dimensions.Next())
+    candidates.push_back(i);
+
+  auto evaluate = [&](const size_t i,
+                      const double gain,
+                      arma::vec& probabilities,
+                      NumericAuxiliarySplitInfo& numericAux,
+                      CategoricalAuxiliarySplitInfo& categoricalAux) -> double
   {
-    double dimGain = -DBL_MAX;
     if (datasetInfo.Type(i) == data::Datatype::categorical)
     {
-      dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
+      return CategoricalSplit::template SplitIfBetter<UseWeights>(gain,
           data.cols(begin, begin + count - 1).row(i),
           datasetInfo.NumMappings(i),
           labels.subvec(begin, begin + count - 1),
@@ -565,33 +596,28 @@ void DecisionTree<FitnessFunction,
           UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
           minimumLeafSize,
           minimumGainSplit,
-          classProbabilities,
-          *this);
+          probabilities,
+          categoricalAux);
     }
     else if (datasetInfo.Type(i) == data::Datatype::numeric)
     {
-      dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+      return NumericSplit::template SplitIfBetter<UseWeights>(gain,
           data.cols(begin, begin + count - 1).row(i),
           labels.subvec(begin, begin + count - 1),
           numClasses,
           UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
           minimumLeafSize,
           minimumGainSplit,
-          classProbabilities,
-          *this);
+          probabilities,
+          numericAux);
     }
 
-    // Was there an improvement?  If so mark that it's the new best dimension.
-    if (dimGain > bestGain)
-    {
-      bestDim = i;
-      bestGain = dimGain;
-    }
+    return -DBL_MAX;
+  };
 
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain >= 0.0)
-      break;
-  }
+  // datasetInfo.Dimensionality() means "no split".
+  const size_t bestDim = BestDimension(candidates, count,
+      datasetInfo.Dimensionality(), bestGain, evaluate);
 
   // Did we split or not?  If so, then split the data and create the children.
   if (bestDim != datasetInfo.Dimensionality())
@@ -628,7 +654,12 @@ void DecisionTree<FitnessFunction,
     for (size_t i = begin; i < begin + count; ++i)
       childCounts[childAssignments[i - begin]]++;
 
-    // Split into children.
+    // Split into children.  The children are trained through pointers, so
+    // that tasks share the dataset instead of copying it.
+    MatType* dataPtr = &data;
+    const data::DatasetInfo* datasetInfoPtr = &datasetInfo;
+    arma::Row<size_t>* labelsPtr = &labels;
+    arma::rowvec* weightsPtr = &weights;
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
@@ -646,22 +677,32 @@ void DecisionTree<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
+      // Now build the child recursively.  The points of each child are only
+      // touched by that child, so large children can be built as tasks while
+      // the remaining points are partitioned.  This is only done when the
+      // dimension selection type draws no random numbers, since math::randGen
+      // must not be used from several threads at once.
       DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit);
-      }
-      else
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit);
-      }
       children.push_back(child);
+
+      const size_t childBegin = currentChildBegin;
+      const size_t childCount = currentCol - currentChildBegin;
+      const size_t childLeafSize = NoRecursion ? childCount : minimumLeafSize;
+#ifdef MLPACK_DECISION_TREE_USE_TASKS
+      const bool deferChild = std::is_same<DimensionSelectionType,
+          AllDimensionSelect>::value && childCount >= MinimumParallelSize();
+      #pragma omp task if(deferChild) firstprivate(child, childBegin, \
+          childCount, childLeafSize, dataPtr, datasetInfoPtr, labelsPtr, \
+          weightsPtr)
+#endif
+      child->Train<UseWeights>(*dataPtr, childBegin, childCount,
+          *datasetInfoPtr, *labelsPtr, numClasses, *weightsPtr, childLeafSize,
+          minimumGainSplit);
     }
+
+#ifdef MLPACK_DECISION_TREE_USE_TASKS
+    #pragma omp taskwait
+#endif
   }
   else
   {
@@ -699,6 +740,21 @@ void DecisionTree<FitnessFunction,
                                       const size_t minimumLeafSize,
                                       const double minimumGainSplit)
 {
+#ifdef MLPACK_DECISION_TREE_USE_TASKS
+  // The root of a large tree opens the parallel region that the tasks for the
+  // dimensions and subtrees of the whole tree run in.
+  if (omp_get_level() == 0 && count >= MinimumParallelSize())
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      Train<UseWeights>(data, begin, count, labels, numClasses, weights,
+          minimumLeafSize, minimumGainSplit);
+    }
+    return;
+  }
+#endif
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -716,11 +772,18 @@ void DecisionTree<FitnessFunction,
       labels.subvec(begin, begin + count - 1),
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  size_t bestDim = data.n_rows; // This means "no split".
+  std::vector<size_t> candidates(data.n_rows);
   for (size_t i = 0; i < data.n_rows; ++i)
+    candidates[i] = i;
+
+  auto evaluate = [&](const size_t i,
+                      const double gain,
+                      arma::vec& probabilities,
+                      NumericAuxiliarySplitInfo& numericAux,
+                      CategoricalAuxiliarySplitInfo& /* categoricalAux */)
   {
-    const double dimGain = NumericSplitType<FitnessFunction>::template
-        SplitIfBetter<UseWeights>(bestGain,
+    return NumericSplitType<FitnessFunction>::template
+        SplitIfBetter<UseWeights>(gain,
                                   data.cols(begin, begin + count - 1).row(i),
                                   labels.cols(begin, begin + count - 1),
                                   numClasses,
@@ -729,19 +792,13 @@ void DecisionTree<FitnessFunction,
                                       weights,
                                   minimumLeafSize,
                                   minimumGainSplit,
-                                  classProbabilities,
-                                  *this);
+                                  probabilities,
+                                  numericAux);
+  };
 
-    if (dimGain > bestGain)
-    {
-      bestDim = i;
-      bestGain = dimGain;
-    }
-
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain >= 0.0)
-      break;
-  }
+  // data.n_rows means "no split".
+  const size_t bestDim = BestDimension(candidates, count, data.n_rows,
+      bestGain, evaluate);
 
   // Did we split or not?  If so, then split the data and create the children.
   if (bestDim != data.n_rows)
@@ -766,6 +823,11 @@ void DecisionTree<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
       childCounts[childAssignments[j - begin]]++;
 
+    // The children are trained through pointers, so that tasks share the
+    // dataset instead of copying it.
+    MatType* dataPtr = &data;
+    arma::Row<size_t>* labelsPtr = &labels;
+    arma::rowvec* weightsPtr = &weights;
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
@@ -783,22 +845,27 @@ void DecisionTree<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
+      // Now build the child recursively.  The points of each child are only
+      // touched by that child, so large children can be built as tasks while
+      // the remaining points are partitioned.
       DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit);
-      }
-      else
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit);
-      }
       children.push_back(child);
+
+      const size_t childBegin = currentChildBegin;
+      const size_t childCount = currentCol - currentChildBegin;
+      const size_t childLeafSize = NoRecursion ? childCount : minimumLeafSize;
+#ifdef MLPACK_DECISION_TREE_USE_TASKS
+      #pragma omp task if(childCount >= MinimumParallelSize()) \
+          firstprivate(child, childBegin, childCount, childLeafSize, dataPtr, \
+          labelsPtr, weightsPtr)
+#endif
+      child->Train<UseWeights>(*dataPtr, childBegin, childCount, *labelsPtr,
+          numClasses, *weightsPtr, childLeafSize, minimumGainSplit);
     }
+
+#ifdef MLPACK_DECISION_TREE_USE_TASKS
+    #pragma omp taskwait
+#endif
   }
   else
   {
@@ -813,6 +880,107 @@ void DecisionTree<FitnessFunction,
   }
 }
 
+//! Find the best dimension to split on.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename EvaluateFunction>
+size_t DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::BestDimension(
+    const std::vector<size_t>& dimensions,
+    const size_t count,
+    const size_t noSplit,
+    double& bestGain,
+    EvaluateFunction evaluate)
+{
+  size_t bestDim = noSplit;
+  if (count < MinimumParallelSize() || dimensions.size() < 2)
+  {
+    // Each dimension must improve on the best split found so far.
+    for (size_t i = 0; i < dimensions.size(); ++i)
+    {
+      const double dimGain = evaluate(dimensions[i], bestGain,
+          classProbabilities, *this, *this);
+
+      // Was there an improvement?  If so mark that it's the new best dimension.
+      if (dimGain > bestGain)
+      {
+        bestDim = dimensions[i];
+        bestGain = dimGain;
+      }
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+
+    return bestDim;
+  }
+
+  // Evaluate every dimension against the gain of not splitting, each with its
+  // own split information, so that they can be evaluated at the same time.
+  const double noSplitGain = bestGain;
+  std::vector<double> gains(dimensions.size());
+  std::vector<arma::vec> probabilities(dimensions.size());
+  std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+  std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(dimensions.size());
+  for (size_t i = 0; i < dimensions.size(); ++i)
+  {
+    const size_t dimension = dimensions[i];
+#ifdef MLPACK_DECISION_TREE_USE_TASKS
+    #pragma omp task firstprivate(i, dimension, noSplitGain, evaluate) \
+        shared(gains, probabilities, numericAux, categoricalAux)
+#endif
+    gains[i] = evaluate(dimension, noSplitGain, probabilities[i],
+        numericAux[i], categoricalAux[i]);
+  }
+
+#ifdef MLPACK_DECISION_TREE_USE_TASKS
+  #pragma omp taskwait
+#endif
+
+  // Take the dimensions in order, as above, so that ties go to the first one.
+  // Until a dimension wins, each gain is exactly what the serial loop would
+  // have found.  After that, the serial loop requires a split to beat the
+  // best gain by the minimum gain split margin, and the split found depends on
+  // the gain it has to beat, so a dimension that may win is evaluated again
+  // against the best gain.  A dimension whose gain does not beat the best gain
+  // cannot win, since no split in it beats its gain by more than the margin.
+  size_t best = dimensions.size();
+  for (size_t i = 0; i < dimensions.size(); ++i)
+  {
+    if (gains[i] > bestGain && best != dimensions.size())
+    {
+      gains[i] = evaluate(dimensions[i], bestGain, probabilities[i],
+          numericAux[i], categoricalAux[i]);
+    }
+
+    if (gains[i] > bestGain)
+    {
+      best = i;
+      bestGain = gains[i];
+    }
+
+    if (bestGain >= 0.0)
+      break;
+  }
+
+  if (best == dimensions.size())
+    return bestDim;
+
+  classProbabilities = std::move(probabilities[best]);
+  NumericAuxiliarySplitInfo::operator=(numericAux[best]);
+  CategoricalAuxiliarySplitInfo::operator=(categoricalAux[best]);
+  return dimensions[best];
+}
+
 //! Return the class.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -888,9 +1056,13 @@ void DecisionTree<FitnessFunction,
     return;
   }
 
-  // Loop over each point.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    predictions[i] = Classify(data.col(i));
+  // Each point goes down the tree on its own; blocks of points are handled in
+  // parallel.
+  util::ParallelBlocks(data.n_cols, [&](const size_t begin, const size_t end)
+  {
+    for (size_t i = begin; i <= end; ++i)
+      predictions[i] = Classify(data.col(i));
+  });
 }
 
 //! Return the class probabilities for a set of points.
@@ -925,11 +1097,14 @@ void DecisionTree<FitnessFunction,
     node = &node->Child(0);
   probabilities.set_size(node->classProbabilities.n_elem, data.n_cols);
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  util::ParallelBlocks(data.n_cols, [&](const size_t begin, const size_t end)
   {
-    arma::vec v = probabilities.unsafe_col(i); // Alias of column.
-    Classify(data.col(i), predictions[i], v);
-  }
+    for (size_t i = begin; i <= end; ++i)
+    {
+      arma::vec v = probabilities.unsafe_col(i); // Alias of column.
+      Classify(data.col(i), predictions[i], v);
+    }
+  });
 }
 
 //! Serialize the tree.
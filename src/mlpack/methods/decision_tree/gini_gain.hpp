@@ -175,6 +175,33 @@ class GiniGain
     return -impurity;
   }
 
+  /**
+   * Evaluate the Gini impurity of a set of points, given the (possibly
+   * weighted) number of points in each class.  This returns the same value as
+   * Evaluate() does on the labels the counts were built from.
+   *
+   * @param counts Number (or total weight) of points in each class.
+   * @param numClasses Number of classes in the dataset.
+   * @param totalCount Sum of the counts.
+   */
+  static double EvaluateCounts(const double* counts,
+                               const size_t numClasses,
+                               const double totalCount)
+  {
+    // Corner case: if there are no elements, the impurity is zero.
+    if (totalCount == 0.0)
+      return 0.0;
+
+    double impurity = 0.0;
+    for (size_t i = 0; i < numClasses; ++i)
+    {
+      const double f = counts[i] / totalCount;
+      impurity += f * (1.0 - f);
+    }
+
+    return -impurity;
+  }
+
   /**
    * Return the range of the Gini impurity for the given number of classes.
    * (That is, the difference between the maximum possible value and the minimum
@@ -0,0 +1,170 @@
+/**
+ * @file histogram_numeric_split_impl.hpp
+ *
+ * Implementation of the histogram-based binary numeric split.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "histogram_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2) || data.n_elem == 0)
+    return bestGain;
+
+  // Find the range of the values.
+  ElemType minValue = data[0];
+  ElemType maxValue = data[0];
+  for (size_t i = 1; i < data.n_elem; ++i)
+  {
+    if (data[i] < minValue)
+      minValue = data[i];
+    else if (data[i] > maxValue)
+      maxValue = data[i];
+  }
+
+  // If every value is the same, there is nothing to split.
+  if (minValue == maxValue)
+    return bestGain;
+
+  // Build the histogram: the (weighted) count of each class in each bin, the
+  // number of points in each bin, and the smallest and largest value in each
+  // bin.  Since bins are ordered by value, every value in a bin is smaller than
+  // every value in the bins after it.
+  const size_t numBins = std::min(MaxBins(), (size_t) data.n_elem);
+  const double scale = double(numBins) / (double(maxValue) -
+      double(minValue));
+
+  arma::mat classCounts(numClasses, numBins, arma::fill::zeros);
+  arma::Col<size_t> binPoints(numBins, arma::fill::zeros);
+  arma::Col<ElemType> binMin(numBins);
+  arma::Col<ElemType> binMax(numBins);
+  binMin.fill(maxValue);
+  binMax.fill(minValue);
+
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const ElemType value = data[i];
+    const size_t bin = std::min((size_t) ((double(value) - double(minValue)) *
+        scale), numBins - 1);
+
+    classCounts(labels[i], bin) += UseWeights ? (double) weights[i] : 1.0;
+    ++binPoints[bin];
+    if (value < binMin[bin])
+      binMin[bin] = value;
+    if (value > binMax[bin])
+      binMax[bin] = value;
+  }
+
+  const arma::vec totalCounts = arma::sum(classCounts, 1);
+  const double total = arma::accu(totalCounts);
+
+  // Catch edge case: if there are no weights, there is nothing to gain.
+  if (total == 0.0)
+    return bestGain;
+
+  // Loop through the boundaries between non-empty bins, choosing the best one.
+  // Also, force a minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = bestGain;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  arma::vec leftCounts(numClasses, arma::fill::zeros);
+  arma::vec rightCounts(numClasses);
+  size_t leftPoints = 0;
+  double leftTotal = 0.0;
+  for (size_t bin = 0; bin < numBins - 1; ++bin)
+  {
+    if (binPoints[bin] == 0)
+      continue;
+
+    leftCounts += classCounts.col(bin);
+    leftTotal += arma::accu(classCounts.col(bin));
+    leftPoints += binPoints[bin];
+
+    // The split point lies between this bin and the next non-empty one.
+    size_t next = bin + 1;
+    while (next < numBins && binPoints[next] == 0)
+      ++next;
+    if (next == numBins)
+      break;
+
+    if (leftPoints < minimum)
+      continue;
+    if (data.n_elem - leftPoints < minimum)
+      break;
+
+    rightCounts = totalCounts - leftCounts;
+    const double rightTotal = total - leftTotal;
+
+    // Calculate the gain for the left and right child.
+    const double leftGain = FitnessFunction::EvaluateCounts(
+        leftCounts.memptr(), numClasses, leftTotal);
+    const double rightGain = FitnessFunction::EvaluateCounts(
+        rightCounts.memptr(), numClasses, rightTotal);
+
+    // Calculate the gain at this split point.  Without weights, the totals are
+    // the number of points in each child.
+    const double gain = (leftTotal / total) * leftGain +
+        (rightTotal / total) * rightGain;
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[bin] + binMin[next]) / 2.0;
+      return gain;
+    }
+    else if (gain > bestFoundGain + minimumGainSplit)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[bin] + binMin[next]) / 2.0;
+    }
+  }
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
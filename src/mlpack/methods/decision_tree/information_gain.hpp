@@ -172,6 +172,34 @@ class InformationGain
     return gain;
   }
 
+  /**
+   * Calculate the information gain of a set of points, given the (possibly
+   * weighted) number of points in each class.  This returns the same value as
+   * Evaluate() does on the labels the counts were built from.
+   *
+   * @param counts Number (or total weight) of points in each class.
+   * @param numClasses Number of classes in the dataset.
+   * @param totalCount Sum of the counts.
+   */
+  static double EvaluateCounts(const double* counts,
+                               const size_t numClasses,
+                               const double totalCount)
+  {
+    // Edge case: if there are no elements, the gain is zero.
+    if (totalCount == 0.0)
+      return 0.0;
+
+    double gain = 0.0;
+    for (size_t i = 0; i < numClasses; ++i)
+    {
+      const double f = counts[i] / totalCount;
+      if (f > 0.0)
+        gain += f * std::log2(f);
+    }
+
+    return gain;
+  }
+
   /**
    * Return the range of the information gain for the given number of classes.
    * (That is, the difference between the maximum possible value and the minimum
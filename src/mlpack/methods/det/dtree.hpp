@@ -181,6 +181,16 @@ class DTree
    */
   double ComputeValue(const VecType& query) const;
 
+  /**
+   * Compute the density estimate of each of the given query points.  The points
+   * are processed in parallel if OpenMP is available, which makes this much
+   * faster than calling ComputeValue() on each point.
+   *
+   * @param queries Points to estimate density of.
+   * @param values Vector to store the density estimates in.
+   */
+  void ComputeValue(const MatType& queries, arma::rowvec& values) const;
+
   /**
    * Index the buckets for possible usage later; this results in every leaf in
    * the tree having a specific tag (accessible with BucketTag()).  This
@@ -335,14 +345,58 @@ class DTree
   // Utility methods.
 
   /**
-   * Find the dimension to split on.
+   * The values of every dimension of the points, kept in sorted order within
+   * the points of each node while the tree is grown; when a node is split,
+   * they are partitioned in linear time instead of being sorted again by each
+   * child.  Row i holds the values at position i of the dataset, and column d
+   * those of dimension d, so that the values of each dimension are contiguous.
+   */
+  struct SortedDimensions
+  {
+    //! The sorted values of each dimension.
+    arma::Mat<ElemType> values;
+    //! The column of the dataset each value came from, when sorting started.
+    arma::Mat<size_t> points;
+    //! Whether each point goes to the left child of the node being split.
+    std::vector<char> goesLeft;
+  };
+
+  /**
+   * Grow the tree, using the given sorted dimensions of the points of this
+   * node if they are not NULL.
+   */
+  double Grow(MatType& data,
+              arma::Col<size_t>& oldFromNew,
+              const bool useVolReg,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              SortedDimensions* sorted);
+
+  /**
+   * Find the dimension to split on.  The best split of each dimension is
+   * searched for in parallel.  If sorted is not NULL, it must hold the sorted
+   * dimensions of the points of this node.
    */
   bool FindSplit(const MatType& data,
                  size_t& splitDim,
                  ElemType& splitValue,
                  double& leftError,
                  double& rightError,
-                 const size_t minLeafSize = 5) const;
+                 const size_t minLeafSize = 5,
+                 const SortedDimensions* sorted = NULL) const;
+
+  /**
+   * Sort every dimension of the points of this node.
+   */
+  void SortDimensions(const MatType& data, SortedDimensions& sorted) const;
+
+  /**
+   * Partition the sorted dimensions of the points of this node between its two
+   * children, in the same way as SplitData().
+   */
+  void SplitSortedDimensions(SortedDimensions& sorted,
+                             const size_t splitDim,
+                             const ElemType splitValue) const;
 
   /**
    * Split the data, returning the number of points left of the split.
@@ -57,22 +57,17 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
   }
 }
 
-// Now the custom arma::Mat implementation.
+// Put all splits of the given sorted values in a vector.  This is shared by the
+// dense implementation and by the presorted dimensions of DTree::Grow().
 template<typename ElemType>
-void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
-                   const arma::Mat<ElemType>& data,
-                   size_t dim,
-                   const size_t start,
-                   const size_t end,
-                   const size_t minLeafSize)
+void ExtractSortedSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
+                         const ElemType* dimVec,
+                         const size_t n_elem,
+                         const size_t minLeafSize)
 {
   typedef std::pair<ElemType, size_t> SplitItem;
-  arma::rowvec dimVec = data(dim, arma::span(start, end - 1));
 
-  // We sort these, in-place (it's a copy of the data, anyways).
-  std::sort(dimVec.begin(), dimVec.end());
-
-  for (size_t i = minLeafSize - 1; i < dimVec.n_elem - minLeafSize; ++i)
+  for (size_t i = minLeafSize - 1; i < n_elem - minLeafSize; ++i)
   {
     // This makes sense for real continuous data. This kinda corrupts the data
     // and estimation if the data is ordinal. Potentially we can fix that by
@@ -85,6 +80,23 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
   }
 }
 
+// Now the custom arma::Mat implementation.
+template<typename ElemType>
+void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
+                   const arma::Mat<ElemType>& data,
+                   size_t dim,
+                   const size_t start,
+                   const size_t end,
+                   const size_t minLeafSize)
+{
+  arma::Row<ElemType> dimVec = data(dim, arma::span(start, end - 1));
+
+  // We sort these, in-place (it's a copy of the data, anyways).
+  std::sort(dimVec.begin(), dimVec.end());
+
+  ExtractSortedSplits(splitVec, dimVec.memptr(), dimVec.n_elem, minLeafSize);
+}
+
 // This the custom, sparse optimized implementation of the same routine.
 template<typename ElemType>
 void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
@@ -439,7 +451,8 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
                                         ElemType& splitValue,
                                         double& leftError,
                                         double& rightError,
-                                        const size_t minLeafSize) const
+                                        const size_t minLeafSize,
+                                        const SortedDimensions* sorted) const
 {
   typedef std::pair<ElemType, size_t> SplitItem;
 
@@ -450,17 +463,19 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
 
   const size_t points = end - start;
 
-  double minError = logNegError;
-  bool splitFound = false;
+  // The best split of each dimension is searched for in parallel, and then the
+  // dimensions are compared in order, so that the split that is chosen does
+  // not depend on the number of threads.
+  arma::vec dimMinErrors(maxVals.n_elem);
+  arma::vec dimLeftErrors(maxVals.n_elem);
+  arma::vec dimRightErrors(maxVals.n_elem);
+  arma::vec volumesWithoutDim(maxVals.n_elem);
+  std::vector<ElemType> dimSplitValues(maxVals.n_elem);
+  std::vector<char> dimSplitsFound(maxVals.n_elem, 0);
 
   // Loop through each dimension.
-#ifdef _WIN32
-  #pragma omp parallel for default(shared)
-  for (intmax_t dim = 0; dim < (intmax_t) maxVals.n_elem; ++dim)
-#else
-  #pragma omp parallel for default(shared)
-  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
-#endif
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t dim = 0; dim < (omp_size_t) maxVals.n_elem; ++dim)
   {
     const ElemType min = minVals[dim];
     const ElemType max = maxVals[dim];
@@ -470,7 +485,7 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
       continue; // Skip to next dimension.
 
     // Find the log volume of all the other dimensions.
-    const double volumeWithoutDim = logVolume - std::log(max - min);
+    volumesWithoutDim[dim] = logVolume - std::log(max - min);
 
     // Initializing all other stuff for this dimension.
     bool dimSplitFound = false;
@@ -480,16 +495,21 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
     double dimRightError = 0.0; // always be set to something else before use.
     ElemType dimSplitValue = 0.0;
 
-    // Get the values for splitting. The old implementation:
-    //   dimVec = data.row(dim).subvec(start, end - 1);
-    //   dimVec = arma::sort(dimVec);
-    // could be quite inefficient for sparse matrices, due to
-    // copy operations (3). This one has custom implementation for dense and
-    // sparse matrices.
-
+    // Get the values for splitting.  If the dimensions were sorted when the
+    // tree started growing, the values of this node are already in order;
+    // otherwise they are extracted and sorted, with custom implementations for
+    // dense and sparse matrices.
     std::vector<SplitItem> splitVec;
-    details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
-        minLeafSize);
+    if (sorted)
+    {
+      details::ExtractSortedSplits<ElemType>(splitVec,
+          sorted->values.colptr(dim) + start, points, minLeafSize);
+    }
+    else
+    {
+      details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
+          minLeafSize);
+    }
 
     // Iterate on all the splits for this dimension
     for (typename std::vector<SplitItem>::iterator i = splitVec.begin();
@@ -528,22 +548,37 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
       }
     }
 
-    const double actualMinDimError = std::log(minDimError)
+    dimMinErrors[dim] = minDimError;
+    dimLeftErrors[dim] = dimLeftError;
+    dimRightErrors[dim] = dimRightError;
+    dimSplitValues[dim] = dimSplitValue;
+    dimSplitsFound[dim] = dimSplitFound;
+  }
+
+  double minError = logNegError;
+  bool splitFound = false;
+  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
+  {
+    if (!dimSplitsFound[dim])
+      continue;
+
+    const double actualMinDimError = std::log(dimMinErrors[dim])
       - 2 * std::log((double) data.n_cols)
-      - volumeWithoutDim;
+      - volumesWithoutDim[dim];
 
-#pragma omp critical(DTreeFindUpdate)
-    if ((actualMinDimError > minError) && dimSplitFound)
+    if (actualMinDimError > minError)
     {
       // Calculate actual error (in logspace) by adding terms back to our
       // estimate.
       minError = actualMinDimError;
       splitDim = dim;
-      splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
-        - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
-        - volumeWithoutDim;
+      splitValue = dimSplitValues[dim];
+      leftError = std::log(dimLeftErrors[dim])
+        - 2 * std::log((double) data.n_cols)
+        - volumesWithoutDim[dim];
+      rightError = std::log(dimRightErrors[dim])
+        - 2 * std::log((double) data.n_cols)
+        - volumesWithoutDim[dim];
       splitFound = true;
     } // end if better split found in this dimension.
   }
@@ -585,6 +620,80 @@ size_t DTree<MatType, TagType>::SplitData(MatType& data,
   return left;
 }
 
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::SortDimensions(const MatType& data,
+                                             SortedDimensions& sorted) const
+{
+  // The rows before start are not used, so that the values of a node are at
+  // the same positions as its columns in the dataset.
+  sorted.values.set_size(end, data.n_rows);
+  sorted.points.set_size(end, data.n_rows);
+  sorted.goesLeft.resize(end);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t dim = 0; dim < (omp_size_t) data.n_rows; ++dim)
+  {
+    std::vector<std::pair<ElemType, size_t>> dimVec;
+    dimVec.reserve(end - start);
+    for (size_t i = start; i < end; ++i)
+      dimVec.push_back(std::make_pair(data(dim, i), i));
+
+    std::sort(dimVec.begin(), dimVec.end());
+
+    for (size_t i = start; i < end; ++i)
+    {
+      sorted.values(i, dim) = dimVec[i - start].first;
+      sorted.points(i, dim) = dimVec[i - start].second;
+    }
+  }
+}
+
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::SplitSortedDimensions(
+    SortedDimensions& sorted,
+    const size_t splitDim,
+    const ElemType splitValue) const
+{
+  // Find the points that go to the left child, with the same test as
+  // SplitData().
+  for (size_t i = start; i < end; ++i)
+  {
+    sorted.goesLeft[sorted.points(i, splitDim)] =
+        (sorted.values(i, splitDim) <= splitValue);
+  }
+
+  // Now partition the values of each dimension, keeping them in order on each
+  // side.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t dim = 0; dim < (omp_size_t) sorted.values.n_cols; ++dim)
+  {
+    ElemType* values = sorted.values.colptr(dim);
+    size_t* points = sorted.points.colptr(dim);
+
+    std::vector<std::pair<ElemType, size_t>> rightVec;
+    size_t next = start;
+    for (size_t i = start; i < end; ++i)
+    {
+      if (sorted.goesLeft[points[i]])
+      {
+        values[next] = values[i];
+        points[next] = points[i];
+        ++next;
+      }
+      else
+      {
+        rightVec.push_back(std::make_pair(values[i], points[i]));
+      }
+    }
+
+    for (size_t i = 0; i < rightVec.size(); ++i)
+    {
+      values[next + i] = rightVec[i].first;
+      points[next + i] = rightVec[i].second;
+    }
+  }
+}
+
 // Greedily expand the tree.
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::Grow(MatType& data,
@@ -592,6 +701,25 @@ double DTree<MatType, TagType>::Grow(MatType& data,
                                      const bool useVolReg,
                                      const size_t maxLeafSize,
                                      const size_t minLeafSize)
+{
+  // Sparse matrices are cheap to sort, since only the nonzero values are
+  // sorted.  The dimensions of dense matrices are sorted once here instead,
+  // and then kept in order while the nodes are split.
+  if (arma::is_SpMat<MatType>::value)
+    return Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize, NULL);
+
+  SortedDimensions sorted;
+  SortDimensions(data, sorted);
+  return Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize, &sorted);
+}
+
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::Grow(MatType& data,
+                                     arma::Col<size_t>& oldFromNew,
+                                     const bool useVolReg,
+                                     const size_t maxLeafSize,
+                                     const size_t minLeafSize,
+                                     SortedDimensions* sorted)
 {
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
@@ -614,11 +742,14 @@ double DTree<MatType, TagType>::Grow(MatType& data,
     size_t dim;
     double splitValueTmp;
     double leftError, rightError;
-    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize))
+    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize,
+        sorted))
     {
       // Move the data around for the children to have points in a node lie
       // contiguously (to increase efficiency during the training).
       const size_t splitIndex = SplitData(data, dim, splitValueTmp, oldFromNew);
+      if (sorted)
+        SplitSortedDimensions(*sorted, dim, splitValueTmp);
 
       // Make max and min vals for the children.
       StatType maxValsL(maxVals);
@@ -638,9 +769,9 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
       leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                         minLeafSize);
+                         minLeafSize, sorted);
       rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                           minLeafSize);
+                           minLeafSize, sorted);
 
       // Store values of R(T~) and |T~|.
       subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
@@ -889,6 +1020,45 @@ double DTree<MatType, TagType>::ComputeValue(const VecType& query) const
   return 0.0;
 }
 
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::ComputeValue(const MatType& queries,
+                                           arma::rowvec& values) const
+{
+  Log::Assert(queries.n_rows == maxVals.n_elem);
+
+  values.set_size(queries.n_cols);
+
+  // The query points are independent, so they are split between the threads.
+  // The tree is descended iteratively, reading the values straight from the
+  // matrix, so no point is ever copied.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) queries.n_cols; ++i)
+  {
+    // Check if the query is within range, if we are the root.
+    bool withinRange = true;
+    for (size_t d = 0; root && withinRange && (d < queries.n_rows); ++d)
+    {
+      const ElemType value = queries(d, i);
+      withinRange = (value >= minVals[d]) && (value <= maxVals[d]);
+    }
+
+    if (!withinRange)
+    {
+      values[i] = 0.0;
+      continue;
+    }
+
+    const DTree* node = this;
+    while (node->subtreeLeaves != 1)
+    {
+      node = (queries(node->splitDim, i) <= node->splitValue) ? node->left :
+          node->right;
+    }
+
+    values[i] = std::exp(std::log(node->ratio) - node->logVolume);
+  }
+}
+
 // Index the buckets for possible usage later.
 template<typename MatType, typename TagType>
 TagType DTree<MatType, TagType>::TagTree(const TagType& tag, bool every)
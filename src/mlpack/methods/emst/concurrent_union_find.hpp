@@ -0,0 +1,122 @@
+/**
+ * @file concurrent_union_find.hpp
+ *
+ * Implements a union-find data structure that can be used by several threads
+ * at once.  It is used by DualTreeBoruvka, where the components are looked up
+ * from every thread during the parallel traversal.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A lock-free Union-Find data structure.  Like UnionFind, it tracks the
+ * components of a graph: each point is initially in its own component,
+ * Union(x, y) unites the components containing x and y, and Find(x) returns
+ * the index of the component containing x.  Unlike UnionFind, any number of
+ * threads may call Find() and Union() at the same time.
+ *
+ * The parent of each element is held in an atomic.  Find() compresses the path
+ * it walks by path halving (each element visited is pointed to its
+ * grandparent), which only ever moves an element closer to its root, so it is
+ * safe to do while other threads walk the same path.  Union() links the root
+ * with the larger index below the root with the smaller index with a single
+ * compare-and-swap, and retries if another thread linked either root first.
+ * Since every element has a parent with an index no larger than its own, no
+ * cycle can be created, and the component index of a set is always its
+ * smallest element that has been a root.
+ */
+class ConcurrentUnionFind
+{
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) :
+      parent(new std::atomic<size_t>[size]),
+      size(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  //! The structure cannot be copied.
+  ConcurrentUnionFind(const ConcurrentUnionFind& other) = delete;
+  //! The structure cannot be copied.
+  ConcurrentUnionFind& operator=(const ConcurrentUnionFind& other) = delete;
+
+  /**
+   * Returns the component containing an element.
+   *
+   * @param x The element to find the component of.
+   * @return The index of the component containing x.
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t p = parent[x].load(std::memory_order_acquire);
+      if (p == x)
+        return x;
+
+      const size_t grandparent = parent[p].load(std::memory_order_acquire);
+      if (grandparent == p)
+        return p;
+
+      // Path halving.  If another thread changed the parent of x in the
+      // meantime, its new parent is also an ancestor, so failure is harmless.
+      parent[x].compare_exchange_weak(p, grandparent,
+          std::memory_order_acq_rel, std::memory_order_acquire);
+      x = grandparent;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.
+   *
+   * @param x One element.
+   * @param y The other element.
+   * @return true if the components were different and have been merged.
+   */
+  bool Union(size_t x, size_t y)
+  {
+    while (true)
+    {
+      x = Find(x);
+      y = Find(y);
+      if (x == y)
+        return false;
+
+      if (x > y)
+        std::swap(x, y);
+
+      // y is still a root only if no other thread linked it in the meantime.
+      size_t expected = y;
+      if (parent[y].compare_exchange_strong(expected, x,
+          std::memory_order_acq_rel, std::memory_order_acquire))
+        return true;
+    }
+  }
+
+  //! Get the number of elements.
+  size_t Size() const { return size; }
+
+ private:
+  //! The parent of each element; roots are their own parents.
+  std::unique_ptr<std::atomic<size_t>[]> parent;
+  //! The number of elements.
+  size_t size;
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
@@ -27,11 +27,15 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
+#include "dtb_rules.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
+#include <mlpack/core/tree/instrumented_rules.hpp>
 
 namespace mlpack {
 namespace emst /** Euclidean Minimum Spanning Trees. */ {
@@ -68,6 +72,11 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * If OpenMP is available, each Boruvka round is run in parallel: the search
+ * for the nearest neighbor of each component is split between threads (see
+ * tree::ParallelDualTreeTraverser), as are the resets of the tree statistics
+ * between rounds.
+ *
  * @tparam MetricType The metric to use.
  * @tparam MatType The type of data matrix to use.
  * @tparam TreeType Type of tree to use.  This should follow the TreeType policy
@@ -87,6 +96,9 @@ class DualTreeBoruvka
   typedef TreeType<MetricType, DTBStat, MatType> Tree;
 
  private:
+  //! The rules used for each Boruvka round.
+  typedef tree::TraversalRules<DTBRules<MetricType, Tree>> RuleType;
+
   //! Permutations of points during tree building.
   std::vector<size_t> oldFromNew;
   //! Pointer to the root of the tree.
@@ -103,14 +115,20 @@ class DualTreeBoruvka
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
   //! Connections.
-  UnionFind connections;
+  ConcurrentUnionFind connections;
 
   //! List of edge nodes.
   arma::Col<size_t> neighborsInComponent;
   //! List of edge nodes.
   arma::Col<size_t> neighborsOutComponent;
-  //! List of edge distances.
-  arma::vec neighborsDistances;
+  //! List of edge distances.  These are lowered concurrently by every thread
+  //! during a round.
+  std::vector<std::atomic<double>> neighborsDistances;
+
+  //! The number of base cases performed so far.
+  size_t baseCases;
+  //! The number of node combinations scored so far.
+  size_t scores;
 
   //! Total distance of the tree.
   double totalDist;
@@ -182,6 +200,12 @@ class DualTreeBoruvka
    */
   void AddEdge(const size_t e1, const size_t e2, const double distance);
 
+  /**
+   * Fill the candidate edge of each component from the candidates found by
+   * each copy of the rules during a round.
+   */
+  void MergeCandidates(std::vector<RuleType>& rules);
+
   /**
    * Adds all the edges found in one iteration to the list of neighbors.
    */
@@ -198,6 +222,12 @@ class DualTreeBoruvka
    */
   void CleanupHelper(Tree* tree);
 
+  /**
+   * Reset the statistic of the given node and check whether it is fully
+   * connected, assuming that its children have already been handled.
+   */
+  void CleanupNode(Tree* node);
+
   /**
    * The values stored in the tree must be reset on each iteration.
    */
@@ -58,6 +58,9 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(!naive),
     naive(naive),
     connections(dataset.n_cols),
+    neighborsDistances(dataset.n_cols),
+    baseCases(0),
+    scores(0),
     totalDist(0.0),
     metric(metric)
 {
@@ -65,8 +68,8 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
 
   neighborsInComponent.set_size(data.n_cols);
   neighborsOutComponent.set_size(data.n_cols);
-  neighborsDistances.set_size(data.n_cols);
-  neighborsDistances.fill(DBL_MAX);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    neighborsDistances[i].store(DBL_MAX, std::memory_order_relaxed);
 }
 
 template<
@@ -83,6 +86,9 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(false),
     naive(false),
     connections(data.n_cols),
+    neighborsDistances(data.n_cols),
+    baseCases(0),
+    scores(0),
     totalDist(0.0),
     metric(metric)
 {
@@ -90,8 +96,8 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
 
   neighborsInComponent.set_size(data.n_cols);
   neighborsOutComponent.set_size(data.n_cols);
-  neighborsDistances.set_size(data.n_cols);
-  neighborsDistances.fill(DBL_MAX);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    neighborsDistances[i].store(DBL_MAX, std::memory_order_relaxed);
 }
 
 template<
@@ -123,22 +129,42 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
 
   totalDist = 0; // Reset distance.
 
-  typedef DTBRules<MetricType, Tree> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
   while (edges.size() < (data.n_cols - 1))
   {
+    // Each thread works with its own copy of the rules, which records the
+    // candidate edges that thread found.
+    RuleType rules(data, connections, neighborsDistances, metric);
     if (naive)
     {
-      // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
+      // Full O(N^2) traversal, with the query points split between threads.
+      size_t numThreads = 1;
+      #ifdef HAS_OPENMP
+      numThreads = omp_get_max_threads();
+      #endif
+      std::vector<RuleType> threadRules(numThreads, rules);
+
+      #pragma omp parallel num_threads(numThreads)
+      {
+        size_t thread = 0;
+        #ifdef HAS_OPENMP
+        thread = omp_get_thread_num();
+        #endif
+
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+          for (size_t j = 0; j < data.n_cols; ++j)
+            threadRules[thread].BaseCase(i, j);
+      }
+
+      MergeCandidates(threadRules);
     }
     else
     {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+      tree::ParallelDualTreeTraverser<Tree, RuleType,
+          Tree::template DualTreeTraverser> traverser(rules);
       traverser.Traverse(*tree, *tree);
+
+      MergeCandidates(traverser.Rules());
     }
 
     AddAllEdges();
@@ -148,8 +174,8 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     Log::Info << edges.size() << " edges found so far." << std::endl;
     if (!naive)
     {
-      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
-      Log::Info << rules.Scores() << " cumulative node combinations scored."
+      Log::Info << baseCases << " cumulative base cases." << std::endl;
+      Log::Info << scores << " cumulative node combinations scored."
           << std::endl;
     }
   }
@@ -184,6 +210,46 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::AddEdge(
     edges.push_back(EdgePair(e2, e1, distance));
 }
 
+/**
+ * Fill the candidate edge of each component from the candidates found by each
+ * copy of the rules.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::MergeCandidates(
+    std::vector<RuleType>& rules)
+{
+  // The distance of a component is only ever lowered by the copy of the rules
+  // that records the edge, so exactly one candidate of each component has the
+  // final distance, and no two threads write the same component.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) rules.size(); ++t)
+  {
+    const std::vector<typename RuleType::Candidate>& candidates =
+        rules[t].Candidates();
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+      const size_t component = candidates[i].component;
+      if (candidates[i].distance ==
+          neighborsDistances[component].load(std::memory_order_relaxed))
+      {
+        neighborsInComponent[component] = candidates[i].inComponent;
+        neighborsOutComponent[component] = candidates[i].outComponent;
+      }
+    }
+  }
+
+  for (size_t t = 0; t < rules.size(); ++t)
+  {
+    baseCases += rules[t].BaseCases();
+    scores += rules[t].Scores();
+  }
+}
+
 /**
  * Adds all the edges found in one iteration to the list of neighbors.
  */
@@ -202,10 +268,13 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
     size_t outEdge = neighborsOutComponent[component];
     if (connections.Find(inEdge) != connections.Find(outEdge))
     {
+      const double distance =
+          neighborsDistances[component].load(std::memory_order_relaxed);
+
       // totalDist = totalDist + dist;
       // changed to make this agree with the cover tree code
-      totalDist += neighborsDistances[component];
-      AddEdge(inEdge, outEdge, neighborsDistances[component]);
+      totalDist += distance;
+      AddEdge(inEdge, outEdge, distance);
       connections.Union(inEdge, outEdge);
     }
   }
@@ -277,16 +346,30 @@ template<
              typename TreeStatType,
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
+{
+  // Recurse into all children.
+  for (size_t i = 0; i < tree->NumChildren(); ++i)
+    CleanupHelper(&tree->Child(i));
+
+  CleanupNode(tree);
+}
+
+/**
+ * Reset the statistic of a single node, once its children have been reset.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupNode(Tree* tree)
 {
   // Reset the statistic information.
   tree->Stat().MaxNeighborDistance() = DBL_MAX;
   tree->Stat().MinNeighborDistance() = DBL_MAX;
   tree->Stat().Bound() = DBL_MAX;
 
-  // Recurse into all children.
-  for (size_t i = 0; i < tree->NumChildren(); ++i)
-    CleanupHelper(&tree->Child(i));
-
   // Get the component of the first child or point.  Then we will check to see
   // if all other components of children and points are the same.
   const int component = (tree->NumChildren() != 0) ?
@@ -318,11 +401,54 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup()
 {
-  for (size_t i = 0; i < data.n_cols; i++)
-    neighborsDistances[i] = DBL_MAX;
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; i++)
+    neighborsDistances[i].store(DBL_MAX, std::memory_order_relaxed);
+
+  if (naive)
+    return;
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+  numThreads = omp_get_max_threads();
+  #endif
+
+  // Expand the top of the tree, level by level, until there are enough
+  // subtrees for every thread to have a few to reset.
+  std::vector<Tree*> subtrees(1, tree);
+  std::vector<Tree*> expanded;
+  std::vector<Tree*> next;
+  while (numThreads > 1 && subtrees.size() < 4 * numThreads)
+  {
+    next.clear();
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (subtrees[i]->NumChildren() == 0)
+      {
+        next.push_back(subtrees[i]);
+        continue;
+      }
+
+      expanded.push_back(subtrees[i]);
+      for (size_t j = 0; j < subtrees[i]->NumChildren(); ++j)
+        next.push_back(&subtrees[i]->Child(j));
+    }
+
+    // Every subtree is a leaf.
+    if (next.size() == subtrees.size())
+      break;
+
+    subtrees.swap(next);
+  }
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+    CleanupHelper(subtrees[i]);
 
-  if (!naive)
-    CleanupHelper(tree);
+  // The expanded nodes were found top-down, so going backwards handles the
+  // children of each node before the node itself.
+  for (size_t i = expanded.size(); i > 0; --i)
+    CleanupNode(expanded[i - 1]);
 }
 
 } // namespace emst
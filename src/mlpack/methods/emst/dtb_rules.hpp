@@ -16,18 +16,43 @@
 
 #include <mlpack/core/tree/traversal_info.hpp>
 
+#include "concurrent_union_find.hpp"
+
 namespace mlpack {
 namespace emst {
 
+/**
+ * The rules for one Boruvka round of DualTreeBoruvka: find, for each
+ * component, the nearest point that is not in that component.
+ *
+ * The distance to the candidate nearest neighbor of each component is shared
+ * by all copies of the rules, and is only ever lowered, with an atomic
+ * compare-and-swap, so the rules can be copied for each thread and used with
+ * the ParallelDualTreeTraverser.  Each time a copy lowers the distance of a
+ * component, it records the candidate edge in its own list; after the
+ * traversal, the single edge of each component whose distance is the final one
+ * is the nearest neighbor of the component.
+ */
 template<typename MetricType, typename TreeType>
 class DTBRules
 {
  public:
+  //! A candidate edge for a component, found during the traversal.
+  struct Candidate
+  {
+    //! The component the edge leaves.
+    size_t component;
+    //! The endpoint of the edge inside the component.
+    size_t inComponent;
+    //! The endpoint of the edge outside the component.
+    size_t outComponent;
+    //! The length of the edge.
+    double distance;
+  };
+
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
-           arma::vec& neighborsDistances,
-           arma::Col<size_t>& neighborsInComponent,
-           arma::Col<size_t>& neighborsOutComponent,
+           ConcurrentUnionFind& connections,
+           std::vector<std::atomic<double>>& neighborsDistances,
            MetricType& metric);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
@@ -97,23 +122,24 @@ class DTBRules
   //! Modify the number of node combinations that have been scored.
   size_t& Scores() { return scores; }
 
+  //! Get the candidate edges found by this copy of the rules.
+  const std::vector<Candidate>& Candidates() const { return candidates; }
+  //! Modify the candidate edges found by this copy of the rules.
+  std::vector<Candidate>& Candidates() { return candidates; }
+
  private:
   //! The data points.
   const arma::mat& dataSet;
 
   //! Stores the tree structure so far
-  UnionFind& connections;
+  ConcurrentUnionFind& connections;
 
-  //! The distance to the candidate nearest neighbor for each component.
-  arma::vec& neighborsDistances;
+  //! The distance to the candidate nearest neighbor for each component, shared
+  //! by all copies of the rules.
+  std::vector<std::atomic<double>>& neighborsDistances;
 
-  //! The index of the point in the component that is an endpoint of the
-  //! candidate edge.
-  arma::Col<size_t>& neighborsInComponent;
-
-  //! The index of the point outside of the component that is an endpoint
-  //! of the candidate edge.
-  arma::Col<size_t>& neighborsOutComponent;
+  //! The candidate edges found by this copy of the rules.
+  std::vector<Candidate> candidates;
 
   //! The instantiated metric.
   MetricType& metric;
@@ -123,6 +149,13 @@ class DTBRules
    */
   inline double CalculateBound(TreeType& queryNode) const;
 
+  //! Get the current distance to the candidate nearest neighbor of the given
+  //! component.
+  double NeighborDistance(const size_t component) const
+  {
+    return neighborsDistances[component].load(std::memory_order_relaxed);
+  }
+
   TraversalInfoType traversalInfo;
 
   //! The number of base cases calculated.
@@ -18,17 +18,13 @@ namespace emst {
 template<typename MetricType, typename TreeType>
 DTBRules<MetricType, TreeType>::
 DTBRules(const arma::mat& dataSet,
-         UnionFind& connections,
-         arma::vec& neighborsDistances,
-         arma::Col<size_t>& neighborsInComponent,
-         arma::Col<size_t>& neighborsOutComponent,
+         ConcurrentUnionFind& connections,
+         std::vector<std::atomic<double>>& neighborsDistances,
          MetricType& metric)
 :
   dataSet(dataSet),
   connections(connections),
   neighborsDistances(neighborsDistances),
-  neighborsInComponent(neighborsInComponent),
-  neighborsOutComponent(neighborsOutComponent),
   metric(metric),
   baseCases(0),
   scores(0)
@@ -44,31 +40,41 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
   // Check if the points are in the same component at this iteration.
   // If not, return the distance between them.  Also, store a better result as
   // the current neighbor, if necessary.
-  double newUpperBound = -1.0;
 
   // Find the index of the component the query is in.
   size_t queryComponentIndex = connections.Find(queryIndex);
 
   size_t referenceComponentIndex = connections.Find(referenceIndex);
 
+  std::atomic<double>& bound = neighborsDistances[queryComponentIndex];
   if (queryComponentIndex != referenceComponentIndex)
   {
     ++baseCases;
     double distance = metric.Evaluate(dataSet.col(queryIndex),
                                       dataSet.col(referenceIndex));
 
-    if (distance < neighborsDistances[queryComponentIndex])
+    // Other threads may be lowering the same distance, so only record the
+    // edge if this thread actually made it the new candidate.
+    double current = bound.load(std::memory_order_relaxed);
+    while (distance < current)
     {
-      Log::Assert(queryIndex != referenceIndex);
-
-      neighborsDistances[queryComponentIndex] = distance;
-      neighborsInComponent[queryComponentIndex] = queryIndex;
-      neighborsOutComponent[queryComponentIndex] = referenceIndex;
+      if (bound.compare_exchange_weak(current, distance,
+          std::memory_order_relaxed))
+      {
+        Log::Assert(queryIndex != referenceIndex);
+
+        Candidate candidate;
+        candidate.component = queryComponentIndex;
+        candidate.inComponent = queryIndex;
+        candidate.outComponent = referenceIndex;
+        candidate.distance = distance;
+        candidates.push_back(candidate);
+        break;
+      }
     }
   }
 
-  if (newUpperBound < neighborsDistances[queryComponentIndex])
-    newUpperBound = neighborsDistances[queryComponentIndex];
+  const double newUpperBound = bound.load(std::memory_order_relaxed);
 
   Log::Assert(newUpperBound >= 0.0);
 
@@ -93,7 +99,7 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for the query's component, we prune.
-  return neighborsDistances[queryComponentIndex] < distance
+  return NeighborDistance(queryComponentIndex) < distance
       ? DBL_MAX : distance;
 }
 
@@ -104,7 +110,7 @@ double DTBRules<MetricType, TreeType>::Rescore(const size_t queryIndex,
 {
   // We don't need to check component membership again, because it can't
   // change inside a single iteration.
-  return (oldScore > neighborsDistances[connections.Find(queryIndex)])
+  return (oldScore > NeighborDistance(connections.Find(queryIndex)))
       ? DBL_MAX : oldScore;
 }
 
@@ -153,7 +159,7 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
     const size_t pointComponent = connections.Find(queryNode.Point(i));
-    const double bound = neighborsDistances[pointComponent];
+    const double bound = NeighborDistance(pointComponent);
 
     if (bound > worstPointBound)
       worstPointBound = bound;
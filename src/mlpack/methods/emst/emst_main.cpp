@@ -29,6 +29,7 @@
 #include <mlpack/core/util/mlpack_main.hpp>
 
 #include "dtb.hpp"
+#include "single_linkage.hpp"
 
 PROGRAM_INFO("Fast Euclidean Minimum Spanning Tree",
     "This program can compute the Euclidean minimum spanning tree of a set of "
@@ -56,7 +57,21 @@ PROGRAM_INFO("Fast Euclidean Minimum Spanning Tree",
     "The output matrix is a three-dimensional matrix, where each row indicates "
     "an edge.  The first dimension corresponds to the lesser index of the edge;"
     " the second dimension corresponds to the greater index of the edge; and "
-    "the third column corresponds to the distance between the two points.");
+    "the third column corresponds to the distance between the two points."
+    "\n\n"
+    "The minimum spanning tree can also be used for single-linkage "
+    "hierarchical clustering.  If the " + PRINT_PARAM_STRING("dendrogram") +
+    " output parameter is given, the single-linkage dendrogram is saved: each "
+    "row is a merge, in increasing order of distance, holding the indices of "
+    "the two clusters that are merged, the distance of the merge, and the "
+    "number of points of the new cluster.  The points are clusters 0 to n - 1, "
+    "and the cluster made by the i'th merge is cluster n + i.  If one or more "
+    "distances are given with the " + PRINT_PARAM_STRING("thresholds") +
+    " parameter, the flat clustering at each of those distances is saved with "
+    "the " + PRINT_PARAM_STRING("assignments") + " output parameter; column i "
+    "of the output holds the cluster of each point for the i'th threshold.  "
+    "Clusters with fewer than " + PRINT_PARAM_STRING("min_cluster_size") +
+    " points are marked as noise, with the assignment SIZE_MAX.");
 
 PARAM_MATRIX_IN_REQ("input", "Input data matrix.", "i");
 PARAM_MATRIX_OUT("output", "Output data.  Stored as an edge list.", "o");
@@ -65,6 +80,15 @@ PARAM_INT_IN("leaf_size", "Leaf size in the kd-tree.  One-element leaves give "
     "the empirically best performance, but at the cost of greater memory "
     "requirements.", "l", 1);
 
+PARAM_MATRIX_OUT("dendrogram", "Single-linkage dendrogram, with one merge for "
+    "each row.", "d");
+PARAM_VECTOR_IN(double, "thresholds", "Distances at which to cut the "
+    "single-linkage dendrogram into flat clusterings.", "t");
+PARAM_UMATRIX_OUT("assignments", "Cluster assignments of each point for each "
+    "threshold.", "a");
+PARAM_INT_IN("min_cluster_size", "Minimum number of points in a cluster of the "
+    "flat clusterings; points of smaller clusters are noise.", "m", 1);
+
 using namespace mlpack;
 using namespace mlpack::emst;
 using namespace mlpack::tree;
@@ -74,9 +98,20 @@ using namespace std;
 
 static void mlpackMain()
 {
-  RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
+  RequireAtLeastOnePassed({ "output", "dendrogram", "assignments" }, false,
+      "no output will be saved");
+
+  ReportIgnoredParam({{ "assignments", false }}, "thresholds");
+  ReportIgnoredParam({{ "assignments", false }}, "min_cluster_size");
+  if (CLI::HasParam("assignments") && !CLI::HasParam("thresholds"))
+    Log::Fatal << "Must specify " << PRINT_PARAM_STRING("thresholds")
+        << " to save " << PRINT_PARAM_STRING("assignments") << "!" << endl;
+
+  RequireParamValue<int>("min_cluster_size", [](int x) { return x > 0; }, true,
+      "minimum cluster size must be at least 1");
 
   arma::mat dataPoints = std::move(CLI::GetParam<arma::mat>("input"));
+  arma::mat mst;
 
   // Do naive computation if necessary.
   if (CLI::GetParam<bool>("naive"))
@@ -85,11 +120,7 @@ static void mlpackMain()
 
     DualTreeBoruvka<> naive(dataPoints, true);
 
-    arma::mat naiveResults;
-    naive.ComputeMST(naiveResults);
-
-    if (CLI::HasParam("output"))
-      CLI::GetParam<arma::mat>("output") = std::move(naiveResults);
+    naive.ComputeMST(mst);
   }
   else
   {
@@ -138,7 +169,39 @@ static void mlpackMain()
       unmappedResults(2, i) = results(2, i);
     }
 
-    if (CLI::HasParam("output"))
-      CLI::GetParam<arma::mat>("output") = std::move(unmappedResults);
+    mst = std::move(unmappedResults);
+  }
+
+  if (CLI::HasParam("dendrogram") || CLI::HasParam("assignments"))
+  {
+    Timer::Start("single_linkage");
+    SingleLinkage linkage(mst, dataPoints.n_cols);
+
+    if (CLI::HasParam("assignments"))
+    {
+      const std::vector<double>& thresholdList =
+          CLI::GetParam<std::vector<double>>("thresholds");
+      const arma::vec thresholds(thresholdList);
+      const size_t minClusterSize =
+          (size_t) CLI::GetParam<int>("min_cluster_size");
+
+      arma::Mat<size_t> assignments;
+      arma::Row<size_t> numClusters;
+      linkage.Cut(thresholds, assignments, numClusters, minClusterSize);
+      for (size_t i = 0; i < thresholds.n_elem; ++i)
+      {
+        Log::Info << numClusters[i] << " clusters at distance "
+            << thresholds[i] << "." << endl;
+      }
+
+      CLI::GetParam<arma::Mat<size_t>>("assignments") = std::move(assignments);
+    }
+
+    if (CLI::HasParam("dendrogram"))
+      CLI::GetParam<arma::mat>("dendrogram") = linkage.Dendrogram();
+    Timer::Stop("single_linkage");
   }
+
+  if (CLI::HasParam("output"))
+    CLI::GetParam<arma::mat>("output") = std::move(mst);
 }
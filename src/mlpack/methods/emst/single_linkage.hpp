@@ -0,0 +1,147 @@
+/**
+ * @file single_linkage.hpp
+ *
+ * Single-linkage hierarchical clustering from a minimum spanning tree, such as
+ * the one computed by DualTreeBoruvka.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_SINGLE_LINKAGE_HPP
+#define MLPACK_METHODS_EMST_SINGLE_LINKAGE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "union_find.hpp"
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * The SingleLinkage class builds the single-linkage dendrogram of a dataset
+ * from its minimum spanning tree, and cuts it at distance thresholds to get
+ * flat clusterings.  Two points are in the same cluster at threshold t if they
+ * are connected by a path of spanning tree edges no longer than t, which is
+ * exactly single-linkage clustering.
+ *
+ * The edges are sorted once, when the object is constructed.  Any number of
+ * thresholds can then be cut in a single pass over the sorted edges: the
+ * clustering for each threshold is emitted as soon as every edge no longer than
+ * it has been merged, either to a visitor (so that each clustering can be
+ * written out while the next one is computed) or into one compact matrix.
+ *
+ * @code
+ * arma::mat mst;
+ * DualTreeBoruvka<> dtb(data);
+ * dtb.ComputeMST(mst);
+ *
+ * SingleLinkage linkage(mst);
+ * arma::Mat<size_t> assignments;
+ * arma::Row<size_t> numClusters;
+ * linkage.Cut(arma::vec("0.5 1.0 2.0"), assignments, numClusters);
+ * @endcode
+ *
+ * Clusters with fewer points than a minimum cluster size can be marked as
+ * noise (with the assignment SIZE_MAX), as DBSCAN does.
+ */
+class SingleLinkage
+{
+ public:
+  /**
+   * Build the dendrogram from the given spanning tree, in the format returned
+   * by DualTreeBoruvka::ComputeMST(): one column for each edge, holding the two
+   * point indices and the length of the edge.  The edges do not need to be
+   * sorted.  A spanning forest may be given too, if the number of points is
+   * specified.
+   *
+   * @param spanningTree Edges of the minimum spanning tree.
+   * @param numPoints Number of points; if 0, this is the number of edges plus
+   *     one.
+   */
+  SingleLinkage(const arma::mat& spanningTree, const size_t numPoints = 0);
+
+  /**
+   * Cut the dendrogram at each of the given thresholds, in a single pass over
+   * the edges, and give the clustering of each threshold to the visitor as soon
+   * as it is found.  The thresholds are visited in increasing order, and the
+   * visitor is called as
+   *
+   * @code
+   * visitor(thresholdIndex, assignments, numClusters);
+   * @endcode
+   *
+   * where thresholdIndex is the index of the threshold in the given vector,
+   * assignments is an arma::Row<size_t> with the cluster of each point (or
+   * SIZE_MAX for noise), and numClusters is the number of clusters.  Clusters
+   * are numbered in the order of their first point.  The assignments are only
+   * valid until the visitor returns.
+   *
+   * @param thresholds Distances to cut the dendrogram at.
+   * @param visitor Function to call with the clustering of each threshold.
+   * @param minClusterSize Minimum number of points in a cluster; points of
+   *     smaller clusters are noise.
+   */
+  template<typename VisitorType>
+  void Cut(const arma::vec& thresholds,
+           VisitorType&& visitor,
+           const size_t minClusterSize = 1) const;
+
+  /**
+   * Cut the dendrogram at each of the given thresholds, in a single pass over
+   * the edges, and store all the clusterings.  Row i of the assignments holds
+   * the cluster of each point for thresholds[i] (or SIZE_MAX for noise).
+   *
+   * @param thresholds Distances to cut the dendrogram at.
+   * @param assignments Matrix to store the assignments in.
+   * @param numClusters Vector to store the number of clusters of each
+   *     threshold in.
+   * @param minClusterSize Minimum number of points in a cluster; points of
+   *     smaller clusters are noise.
+   */
+  void Cut(const arma::vec& thresholds,
+           arma::Mat<size_t>& assignments,
+           arma::Row<size_t>& numClusters,
+           const size_t minClusterSize = 1) const;
+
+  /**
+   * Get the dendrogram.  It has one column for each merge, in increasing order
+   * of distance, in the same format as the linkage matrices of SciPy: the first
+   * two rows hold the indices of the two clusters that are merged, the third
+   * row holds the distance of the merge, and the fourth row holds the number of
+   * points of the new cluster.  Points are the clusters 0 to n - 1, and the
+   * cluster made by merge i is cluster n + i.
+   */
+  const arma::mat& Dendrogram() const { return dendrogram; }
+
+  //! Get the number of points.
+  size_t NumPoints() const { return numPoints; }
+
+ private:
+  //! The number of points.
+  size_t numPoints;
+  //! The endpoints of each edge, sorted by length.
+  arma::Mat<size_t> sortedEdges;
+  //! The length of each edge, sorted.
+  arma::vec sortedDistances;
+  //! The dendrogram.
+  arma::mat dendrogram;
+
+  /**
+   * Set the assignments of each point from the components of the given
+   * UnionFind structure, and return the number of clusters.
+   */
+  size_t Label(UnionFind& components,
+               const size_t minClusterSize,
+               arma::Row<size_t>& assignments,
+               arma::Col<size_t>& clusterSizes,
+               arma::Col<size_t>& labels) const;
+};
+
+} // namespace emst
+} // namespace mlpack
+
+// Include implementation.
+#include "single_linkage_impl.hpp"
+
+#endif
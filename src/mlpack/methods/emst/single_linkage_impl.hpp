@@ -0,0 +1,175 @@
+/**
+ * @file single_linkage_impl.hpp
+ *
+ * Implementation of single-linkage clustering from a minimum spanning tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_SINGLE_LINKAGE_IMPL_HPP
+#define MLPACK_METHODS_EMST_SINGLE_LINKAGE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "single_linkage.hpp"
+
+namespace mlpack {
+namespace emst {
+
+inline SingleLinkage::SingleLinkage(const arma::mat& spanningTree,
+                                    const size_t numPoints) :
+    numPoints(numPoints == 0 ? spanningTree.n_cols + 1 : numPoints)
+{
+  if (spanningTree.n_cols > 0 && spanningTree.n_rows != 3)
+  {
+    std::ostringstream oss;
+    oss << "SingleLinkage::SingleLinkage(): spanning tree must have 3 rows, "
+        << "but it has " << spanningTree.n_rows << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (spanningTree.n_cols >= this->numPoints)
+  {
+    std::ostringstream oss;
+    oss << "SingleLinkage::SingleLinkage(): a spanning tree of "
+        << this->numPoints << " points has at most " << this->numPoints - 1
+        << " edges, but " << spanningTree.n_cols << " were given!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Sort the edges once; every cut is then a single pass over them.
+  const arma::uvec order = (spanningTree.n_cols == 0) ? arma::uvec() :
+      arma::stable_sort_index(arma::vec(spanningTree.row(2).t()));
+  sortedEdges.set_size(2, spanningTree.n_cols);
+  sortedDistances.set_size(spanningTree.n_cols);
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    sortedEdges(0, i) = (size_t) spanningTree(0, order[i]);
+    sortedEdges(1, i) = (size_t) spanningTree(1, order[i]);
+    sortedDistances[i] = spanningTree(2, order[i]);
+
+    if (sortedEdges(0, i) >= this->numPoints ||
+        sortedEdges(1, i) >= this->numPoints)
+    {
+      std::ostringstream oss;
+      oss << "SingleLinkage::SingleLinkage(): edge " << order[i] << " joins "
+          << "point " << std::max(sortedEdges(0, i), sortedEdges(1, i))
+          << ", but there are only " << this->numPoints << " points!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  // Build the dendrogram by merging along the sorted edges.  clusterOf holds
+  // the dendrogram cluster of each component, indexed by its root.
+  UnionFind components(this->numPoints);
+  arma::Col<size_t> clusterOf =
+      arma::linspace<arma::Col<size_t>>(0, this->numPoints - 1,
+      this->numPoints);
+  arma::Col<size_t> clusterSize(this->numPoints, arma::fill::ones);
+
+  dendrogram.set_size(4, sortedEdges.n_cols);
+  for (size_t i = 0; i < sortedEdges.n_cols; ++i)
+  {
+    const size_t rootA = components.Find(sortedEdges(0, i));
+    const size_t rootB = components.Find(sortedEdges(1, i));
+    if (rootA == rootB)
+    {
+      std::ostringstream oss;
+      oss << "SingleLinkage::SingleLinkage(): edge " << order[i] << " closes "
+          << "a cycle; the given edges are not a spanning tree!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    dendrogram(0, i) = std::min(clusterOf[rootA], clusterOf[rootB]);
+    dendrogram(1, i) = std::max(clusterOf[rootA], clusterOf[rootB]);
+    dendrogram(2, i) = sortedDistances[i];
+    dendrogram(3, i) = clusterSize[rootA] + clusterSize[rootB];
+
+    components.Union(rootA, rootB);
+    const size_t root = components.Find(rootA);
+    clusterOf[root] = this->numPoints + i;
+    clusterSize[root] = dendrogram(3, i);
+  }
+}
+
+template<typename VisitorType>
+void SingleLinkage::Cut(const arma::vec& thresholds,
+                        VisitorType&& visitor,
+                        const size_t minClusterSize) const
+{
+  const arma::uvec order = arma::stable_sort_index(thresholds);
+
+  UnionFind components(numPoints);
+  arma::Row<size_t> assignments(numPoints);
+  arma::Col<size_t> clusterSizes(numPoints);
+  arma::Col<size_t> labels(numPoints);
+
+  size_t edge = 0;
+  for (size_t t = 0; t < order.n_elem; ++t)
+  {
+    // Merge every edge that is no longer than this threshold.
+    const double threshold = thresholds[order[t]];
+    while (edge < sortedDistances.n_elem && sortedDistances[edge] <= threshold)
+    {
+      components.Union(sortedEdges(0, edge), sortedEdges(1, edge));
+      ++edge;
+    }
+
+    const size_t numClusters = Label(components, minClusterSize, assignments,
+        clusterSizes, labels);
+    visitor(order[t], (const arma::Row<size_t>&) assignments, numClusters);
+  }
+}
+
+inline void SingleLinkage::Cut(const arma::vec& thresholds,
+                               arma::Mat<size_t>& assignments,
+                               arma::Row<size_t>& numClusters,
+                               const size_t minClusterSize) const
+{
+  assignments.set_size(thresholds.n_elem, numPoints);
+  numClusters.set_size(thresholds.n_elem);
+
+  Cut(thresholds, [&](const size_t index,
+                      const arma::Row<size_t>& thresholdAssignments,
+                      const size_t thresholdClusters)
+  {
+    assignments.row(index) = thresholdAssignments;
+    numClusters[index] = thresholdClusters;
+  }, minClusterSize);
+}
+
+inline size_t SingleLinkage::Label(UnionFind& components,
+                                   const size_t minClusterSize,
+                                   arma::Row<size_t>& assignments,
+                                   arma::Col<size_t>& clusterSizes,
+                                   arma::Col<size_t>& labels) const
+{
+  // Find the root and the size of the component of each point.
+  clusterSizes.zeros();
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    assignments[i] = components.Find(i);
+    ++clusterSizes[assignments[i]];
+  }
+
+  // Number the clusters that are large enough in the order of their first
+  // point.
+  labels.fill(SIZE_MAX);
+  size_t numClusters = 0;
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    const size_t root = assignments[i];
+    if (labels[root] == SIZE_MAX && clusterSizes[root] >= minClusterSize)
+      labels[root] = numClusters++;
+
+    assignments[i] = labels[root];
+  }
+
+  return numClusters;
+}
+
+} // namespace emst
+} // namespace mlpack
+
+#endif
@@ -17,7 +17,6 @@
 #include <mlpack/core/metrics/ip_metric.hpp>
 #include "fastmks_stat.hpp"
 #include <mlpack/core/tree/cover_tree.hpp>
-#include <queue>
 
 namespace mlpack {
 namespace fastmks /** Fast max-kernel search. */ {
@@ -271,20 +270,34 @@ class FastMKS
   //! The instantiated inner-product metric induced by the given kernel.
   metric::IPMetric<KernelType> metric;
 
-  //! Candidate represents a possible candidate point (value, index).
-  typedef std::pair<double, size_t> Candidate;
+  //! The number of query points whose candidates are searched for at once by
+  //! NaiveSearch().
+  static const size_t NaiveQueryBlockSize = 1024;
+  //! The number of reference points whose kernel values with a block of query
+  //! points are computed at once by NaiveSearch().
+  static const size_t NaiveReferenceBlockSize = 4096;
 
-  //! Compare two candidates based on the value.
-  struct CandidateCmp {
-    bool operator()(const Candidate& c1, const Candidate& c2)
-    {
-      return c1.first > c2.first;
-    };
-  };
+  /**
+   * Run brute-force search on the given query points (which are the reference
+   * points if monochromatic is true; then a point is never its own
+   * candidate).  The results are stored in indices and kernels, which must
+   * already have the right size.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const bool monochromatic);
 
-  //! Use a priority queue to represent the list of candidate points.
-  typedef std::priority_queue<Candidate, std::vector<Candidate>,
-      CandidateCmp> CandidateList;
+  /**
+   * Run single-tree search on the given query points (which may be the
+   * reference set), in parallel over the query points.  The results are
+   * stored in indices and kernels, which must already have the right size.
+   */
+  void SingleTreeSearch(const MatType& querySet,
+                        const size_t k,
+                        arma::Mat<size_t>& indices,
+                        arma::mat& kernels);
 };
 
 } // namespace fastmks
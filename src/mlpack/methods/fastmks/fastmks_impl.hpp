@@ -16,8 +16,11 @@
 #include "fastmks.hpp"
 
 #include "fastmks_rules.hpp"
+#include <mlpack/core/tree/instrumented_rules.hpp>
 
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+#include <mlpack/core/tree/parallel_single_tree_traverser.hpp>
 
 namespace mlpack {
 namespace fastmks {
@@ -304,33 +307,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(querySet, k, indices, kernels, false);
 
     Timer::Stop("computing_products");
 
@@ -340,20 +317,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Single-tree implementation.
   if (singleMode)
   {
-    // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
-    typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, querySet, k, metric.Kernel());
-
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
-
-    rules.GetResults(indices, kernels);
+    SingleTreeSearch(querySet, k, indices, kernels);
 
     Timer::Stop("computing_products");
     return;
@@ -400,7 +364,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   kernels.set_size(k, queryTree->Dataset().n_cols);
 
   Timer::Start("computing_products");
-  typedef FastMKSRules<KernelType, Tree> RuleType;
+  typedef tree::TraversalRules<FastMKSRules<KernelType, Tree>> RuleType;
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
 
   typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
@@ -433,36 +397,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
-
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(*referenceSet, k, indices, kernels, true);
 
     Timer::Stop("computing_products");
 
@@ -472,25 +407,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Single-tree implementation.
   if (singleMode)
   {
-    // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
-    typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel());
-
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    // Save the number of pruned nodes.
-    const size_t numPrunes = traverser.NumPrunes();
-
-    Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
-
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
-
-    rules.GetResults(indices, kernels);
+    SingleTreeSearch(*referenceSet, k, indices, kernels);
 
     Timer::Stop("computing_products");
     return;
@@ -557,6 +474,127 @@ void FastMKS<KernelType, MatType, TreeType>::serialize(
   }
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool monochromatic)
+{
+  typedef neighbor::CandidateList<neighbor::FurthestNeighborSort>
+      CandidateListType;
+
+  // The candidates of a block of query points are found together: the kernel
+  // values between the block and each block of reference points are computed
+  // at once (with one matrix product for inner-product kernels), and then each
+  // query point of the block updates its candidates in parallel.
+  for (size_t qBegin = 0; qBegin < querySet.n_cols;
+      qBegin += NaiveQueryBlockSize)
+  {
+    const size_t qEnd = std::min(qBegin + NaiveQueryBlockSize,
+        (size_t) querySet.n_cols);
+    const MatType queryBlock = querySet.cols(qBegin, qEnd - 1);
+
+    CandidateListType candidates(qEnd - qBegin, k, -DBL_MAX);
+
+    arma::mat blockKernels;
+    for (size_t rBegin = 0; rBegin < referenceSet->n_cols;
+        rBegin += NaiveReferenceBlockSize)
+    {
+      const size_t rEnd = std::min(rBegin + NaiveReferenceBlockSize,
+          (size_t) referenceSet->n_cols);
+      const MatType referenceBlock = referenceSet->cols(rBegin, rEnd - 1);
+
+      kernel::KernelMatrix<KernelType>::Compute(referenceBlock, queryBlock,
+          metric.Kernel(), blockKernels);
+
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t b = 0; b < (omp_size_t) blockKernels.n_cols; ++b)
+      {
+        const size_t q = qBegin + b;
+        for (size_t i = 0; i < blockKernels.n_rows; ++i)
+        {
+          // Don't return the point as its own candidate.
+          if (monochromatic && q == rBegin + i)
+            continue;
+
+          candidates.Insert(b, blockKernels(i, b), rBegin + i);
+        }
+      }
+    }
+
+    arma::Mat<size_t> blockIndices(k, qEnd - qBegin);
+    arma::mat blockValues(k, qEnd - qBegin);
+    for (size_t b = 0; b < qEnd - qBegin; ++b)
+      candidates.GetResults(blockIndices, blockValues, b);
+
+    indices.cols(qBegin, qEnd - 1) = blockIndices;
+    kernels.cols(qBegin, qEnd - 1) = blockValues;
+  }
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::SingleTreeSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels)
+{
+  typedef tree::TraversalRules<FastMKSRules<KernelType, Tree>> RuleType;
+
+  // The self-kernels are computed once, and shared by the rules of all the
+  // threads.
+  const bool monochromatic = (&querySet == referenceSet);
+  arma::vec referenceKernels, queryKernels;
+  RuleType::SelfKernels(*referenceSet, metric.Kernel(), referenceKernels);
+  if (!monochromatic)
+    RuleType::SelfKernels(querySet, metric.Kernel(), queryKernels);
+
+  // Create rules object (this will store the results).
+  RuleType rules(*referenceSet, querySet, k, metric.Kernel(), referenceKernels,
+      monochromatic ? referenceKernels : queryKernels);
+
+  // Each thread traverses its own blocks of query points with its own copy of
+  // the rules.
+  typedef typename Tree::template SingleTreeTraverser<RuleType> TraverserType;
+  tree::ParallelSingleTreeTraverser<Tree, RuleType, TraverserType>
+      traverser(rules);
+  traverser.Traverse(querySet.n_cols, *referenceTree);
+
+  size_t baseCases = 0;
+  size_t scores = 0;
+  for (size_t i = 0; i < traverser.Rules().size(); ++i)
+  {
+    baseCases += traverser.Rules()[i].BaseCases();
+    scores += traverser.Rules()[i].Scores();
+  }
+
+  Log::Info << "Pruned " << traverser.NumPrunes() << " nodes." << std::endl;
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
+
+  if (traverser.Rules().size() == 1)
+  {
+    // Only one set of rules was used, so it holds every result.
+    traverser.Rules()[0].GetResults(indices, kernels);
+    return;
+  }
+
+  // Otherwise, the results of each query point are held by the rules of the
+  // thread that traversed its block.
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    traverser.Rules()[traverser.QueryOwner(i)].GetResults(indices, kernels, i);
+}
+
 } // namespace fastmks
 } // namespace mlpack
 
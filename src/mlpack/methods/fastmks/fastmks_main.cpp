@@ -12,6 +12,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/util/serve_queries.hpp>
 
 #include "fastmks.hpp"
 #include "fastmks_model.hpp"
@@ -51,7 +52,19 @@ PROGRAM_INFO("FastMKS (Fast Max-Kernel Search)",
     "\n\n"
     "This program performs FastMKS using a cover tree.  The base used to build "
     "the cover tree can be specified with the " + PRINT_PARAM_STRING("base") +
-    " parameter.");
+    " parameter."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("server") + " is specified, the model is kept "
+    "in memory and batches of query points are read from standard input, one "
+    "point per line with values separated by commas or spaces; an empty line "
+    "ends a batch.  For each batch, one line is written to standard output for "
+    "each query point, holding the " + PRINT_PARAM_STRING("k") + " indices "
+    "followed by the " + PRINT_PARAM_STRING("k") + " kernel values, and an "
+    "empty line ends the answer.  This continues until standard input is "
+    "closed, so the cost of loading or building the model is paid only once.  "
+    "Since informational messages are also written to standard output, " +
+    PRINT_PARAM_STRING("verbose") + " should not be combined with " +
+    PRINT_PARAM_STRING("server") + ".");
 
 // Model-building parameters.
 PARAM_MATRIX_IN("reference", "The reference dataset.", "r");
@@ -83,6 +96,9 @@ PARAM_FLAG("single", "If true, single-tree search is used (as opposed to "
 PARAM_MATRIX_OUT("kernels", "Output matrix of kernels.", "p");
 PARAM_UMATRIX_OUT("indices", "Output matrix of indices.", "i");
 
+PARAM_FLAG("server", "If set, keep the model in memory and answer batches of "
+    "query points read from standard input until it is closed.", "");
+
 static void mlpackMain()
 {
   // Validate command-line parameters.
@@ -97,7 +113,15 @@ static void mlpackMain()
   ReportIgnoredParam({{ "k", false }}, "kernels");
   ReportIgnoredParam({{ "k", false }}, "query");
 
-  if (CLI::HasParam("k"))
+  // In server mode, the number of results must be known, and results are
+  // written to standard output.
+  const bool server = CLI::HasParam("server");
+  if (server)
+  {
+    RequireAtLeastOnePassed({ "k" }, true, "the number of maximum kernels "
+        "must be given in server mode");
+  }
+  else if (CLI::HasParam("k"))
   {
     RequireAtLeastOnePassed({ "indices", "kernels" }, false,
         "no output will be saved");
@@ -188,8 +212,9 @@ static void mlpackMain()
   model->Naive() = CLI::HasParam("naive");
   model->SingleMode() = CLI::HasParam("single");
 
-  // Should we do search?
-  if (CLI::HasParam("k"))
+  // Should we do search?  In server mode, only a given query set is searched
+  // before serving.
+  if (CLI::HasParam("k") && (!server || CLI::HasParam("query")))
   {
     arma::mat kernels;
     arma::Mat<size_t> indices;
@@ -216,6 +241,25 @@ static void mlpackMain()
     CLI::GetParam<arma::Mat<size_t>>("indices") = std::move(indices);
   }
 
+  // Answer queries from standard input, if desired.
+  if (server)
+  {
+    const size_t k = (size_t) CLI::GetParam<int>("k");
+    const double base = CLI::GetParam<double>("base");
+    Log::Info << "Serving " << k << "-maximum-kernel queries from standard "
+        << "input." << endl;
+
+    const size_t numBatches = ServeQueries(std::cin, std::cout, 0,
+        [&](const arma::mat& queries,
+            arma::Mat<size_t>& indices,
+            arma::mat& kernels)
+    {
+      model->Search(queries, k, indices, kernels, base);
+    });
+
+    Log::Info << "Answered " << numBatches << " query batches." << endl;
+  }
+
   // Save the model.
   CLI::GetParam<FastMKSModel*>("output_model") = model;
 }
@@ -16,7 +16,10 @@
 #include <mlpack/core/kernels/kernel_traits.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/traversal_info.hpp>
-#include <boost/heap/priority_queue.hpp>
+#include <mlpack/methods/neighbor_search/candidate_list.hpp>
+#include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
+
+#include <unordered_map>
 
 namespace mlpack {
 namespace fastmks {
@@ -48,6 +51,38 @@ class FastMKSRules
                const size_t k,
                KernelType& kernel);
 
+  /**
+   * Construct the FastMKSRules object with precomputed self-kernels
+   * (sqrt(K(x, x)) for each point), as computed by SelfKernels().  The
+   * vectors are not copied, so they must outlive the rules and any copy of
+   * them; this way, the rules of several threads can share them.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param k Number of candidates to search for.
+   * @param kernel Kernel to run FastMKS with.
+   * @param referenceKernels Self-kernel of each reference point.
+   * @param queryKernels Self-kernel of each query point.
+   */
+  FastMKSRules(const typename TreeType::Mat& referenceSet,
+               const typename TreeType::Mat& querySet,
+               const size_t k,
+               KernelType& kernel,
+               const arma::vec& referenceKernels,
+               const arma::vec& queryKernels);
+
+  /**
+   * Compute the self-kernel sqrt(K(x, x)) of each point of the given dataset,
+   * in parallel.
+   *
+   * @param data Dataset to compute the self-kernels of.
+   * @param kernel Kernel to evaluate.
+   * @param selfKernels Vector to store the self-kernels in.
+   */
+  static void SelfKernels(const typename TreeType::Mat& data,
+                          KernelType& kernel,
+                          arma::vec& selfKernels);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -56,6 +91,18 @@ class FastMKSRules
    */
   void GetResults(arma::Mat<size_t>& indices, arma::mat& products);
 
+  /**
+   * Store the list of candidates of the given query point in its column of the
+   * given matrices, which must already have the right size.
+   *
+   * @param indices Matrix storing lists of candidate for each query point.
+   * @param products Matrix storing kernel value for each candidate.
+   * @param queryIndex Index of the query point.
+   */
+  void GetResults(arma::Mat<size_t>& indices,
+                  arma::mat& products,
+                  const size_t queryIndex);
+
   //! Compute the base case (kernel value) between two points.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -130,34 +177,35 @@ class FastMKSRules
   //! The query dataset.
   const typename TreeType::Mat& querySet;
 
-  //! Candidate represents a possible candidate point (value, index).
-  typedef std::pair<double, size_t> Candidate;
-
-  //! Compare two candidates based on the value.
-  struct CandidateCmp {
-    bool operator()(const Candidate& c1, const Candidate& c2) const
-    {
-      return c1.first > c2.first;
-    };
-  };
-
-  //! Use a min heap to represent the list of candidate points.
-  //! We will use a boost::heap::priority_queue instead of a std::priority_queue
-  //! because we need to iterate over all the candidates and std::priority_queue
-  //! doesn't provide that interface.
-  typedef boost::heap::priority_queue<Candidate,
-      boost::heap::compare<CandidateCmp>> CandidateList;
-
-  //! Set of candidates for each point.
-  std::vector<CandidateList> candidates;
+  //! Set of candidates for each point.  Each list starts with k candidates
+  //! (-DBL_MAX, size_t() - 1); larger kernel values are better, so they are
+  //! ordered like the distances of furthest neighbor search.
+  neighbor::CandidateList<neighbor::FurthestNeighborSort> candidates;
 
   //! Number of points to search for.
   const size_t k;
 
-  //! Cached query set self-kernels (|| q || for each q).
-  arma::vec queryKernels;
-  //! Cached reference set self-kernels (|| r || for each r).
-  arma::vec referenceKernels;
+  //! Query set self-kernels computed by these rules, if none were given.
+  arma::vec ownQueryKernels;
+  //! Reference set self-kernels computed by these rules, if none were given.
+  arma::vec ownReferenceKernels;
+  //! Given query set self-kernels, or NULL.
+  const arma::vec* givenQueryKernels;
+  //! Given reference set self-kernels, or NULL.
+  const arma::vec* givenReferenceKernels;
+
+  //! Get the query set self-kernels (|| q || for each q).
+  const arma::vec& QueryKernels() const
+  {
+    return givenQueryKernels ? *givenQueryKernels : ownQueryKernels;
+  }
+
+  //! Get the reference set self-kernels (|| r || for each r).
+  const arma::vec& ReferenceKernels() const
+  {
+    return givenReferenceKernels ? *givenReferenceKernels :
+        ownReferenceKernels;
+  }
 
   //! The instantiated kernel.
   KernelType& kernel;
@@ -169,6 +217,14 @@ class FastMKSRules
   //! The last kernel evaluation resulting from BaseCase().
   double lastKernel;
 
+  //! The query index that the kernel values in lastKernels belong to.
+  size_t lastScoreQueryIndex;
+  //! The kernel value between the last query point given to single-tree
+  //! Score() and the centroid of each reference node it scored.  This is held
+  //! by the rules rather than by the node statistics, so that the rules of
+  //! several threads can traverse the same tree at once.
+  std::unordered_map<const TreeType*, double> lastKernels;
+
   //! Calculate the bound for a given query node.
   double CalculateBound(TreeType& queryNode) const;
 
@@ -26,42 +26,67 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     KernelType& kernel) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(querySet.n_cols, k, -DBL_MAX),
     k(k),
+    givenQueryKernels(NULL),
+    givenReferenceKernels(NULL),
     kernel(kernel),
     lastQueryIndex(-1),
     lastReferenceIndex(-1),
     lastKernel(0.0),
+    lastScoreQueryIndex(-1),
     baseCases(0),
     scores(0)
 {
   // Precompute each self-kernel.
-  queryKernels.set_size(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; ++i)
-    queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(i),
-                                           querySet.col(i)));
+  SelfKernels(querySet, kernel, ownQueryKernels);
+  SelfKernels(referenceSet, kernel, ownReferenceKernels);
 
-  referenceKernels.set_size(referenceSet.n_cols);
-  for (size_t i = 0; i < referenceSet.n_cols; ++i)
-    referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
-                                               referenceSet.col(i)));
+  // Set to invalid memory, so that the first node combination does not try to
+  // dereference null pointers.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
 
+template<typename KernelType, typename TreeType>
+FastMKSRules<KernelType, TreeType>::FastMKSRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    const size_t k,
+    KernelType& kernel,
+    const arma::vec& referenceKernels,
+    const arma::vec& queryKernels) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    candidates(querySet.n_cols, k, -DBL_MAX),
+    k(k),
+    givenQueryKernels(&queryKernels),
+    givenReferenceKernels(&referenceKernels),
+    kernel(kernel),
+    lastQueryIndex(-1),
+    lastReferenceIndex(-1),
+    lastKernel(0.0),
+    lastScoreQueryIndex(-1),
+    baseCases(0),
+    scores(0)
+{
   // Set to invalid memory, so that the first node combination does not try to
   // dereference null pointers.
   traversalInfo.LastQueryNode() = (TreeType*) this;
   traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
 
-  // Let's build the list of candidate points for each query point.
-  // It will be initialized with k candidates: (-DBL_MAX, size_t() - 1)
-  // The list of candidates will be updated when visiting new points with the
-  // BaseCase() method.
-  const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-
-  CandidateList pqueue;
-  pqueue.reserve(k);
-  for (size_t i = 0; i < k; i++)
-    pqueue.push(def);
-  std::vector<CandidateList> tmp(querySet.n_cols, pqueue);
-  candidates.swap(tmp);
+template<typename KernelType, typename TreeType>
+void FastMKSRules<KernelType, TreeType>::SelfKernels(
+    const typename TreeType::Mat& data,
+    KernelType& kernel,
+    arma::vec& selfKernels)
+{
+  selfKernels.set_size(data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    selfKernels[i] = sqrt(kernel.Evaluate(data.col(i), data.col(i)));
 }
 
 template<typename KernelType, typename TreeType>
@@ -73,15 +98,16 @@ void FastMKSRules<KernelType, TreeType>::GetResults(
   products.set_size(k, querySet.n_cols);
 
   for (size_t i = 0; i < querySet.n_cols; i++)
-  {
-    CandidateList& pqueue = candidates[i];
-    for (size_t j = 1; j <= k; j++)
-    {
-      indices(k - j, i) = pqueue.top().second;
-      products(k - j, i) = pqueue.top().first;
-      pqueue.pop();
-    }
-  }
+    candidates.GetResults(indices, products, i);
+}
+
+template<typename KernelType, typename TreeType>
+void FastMKSRules<KernelType, TreeType>::GetResults(
+    arma::Mat<size_t>& indices,
+    arma::mat& products,
+    const size_t queryIndex)
+{
+  candidates.GetResults(indices, products, queryIndex);
 }
 
 template<typename KernelType, typename TreeType>
@@ -128,17 +154,31 @@ template<typename KernelType, typename TreeType>
 double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
                                                  TreeType& referenceNode)
 {
+  // The kernel values of the previous query point are not needed anymore.
+  if (queryIndex != lastScoreQueryIndex)
+  {
+    lastKernels.clear();
+    lastScoreQueryIndex = queryIndex;
+  }
+
   // Compare with the current best.
-  const double bestKernel = candidates[queryIndex].top().first;
+  const double bestKernel = candidates.Top(queryIndex).first;
+
+  // The parent has always been scored before its children, unless this is the
+  // root.
+  typename std::unordered_map<const TreeType*, double>::const_iterator
+      parentKernel = lastKernels.end();
+  if (referenceNode.Parent() != NULL)
+    parentKernel = lastKernels.find(referenceNode.Parent());
 
   // See if we can perform a parent-child prune.
   const double furthestDist = referenceNode.FurthestDescendantDistance();
-  if (referenceNode.Parent() != NULL)
+  if (parentKernel != lastKernels.end())
   {
     double maxKernelBound;
     const double parentDist = referenceNode.ParentDistance();
     const double combinedDistBound = parentDist + furthestDist;
-    const double lastKernel = referenceNode.Parent()->Stat().LastKernel();
+    const double lastKernel = parentKernel->second;
     if (kernel::KernelTraits<KernelType>::IsNormalized)
     {
       const double squaredDist = std::pow(combinedDistBound, 2.0);
@@ -157,7 +197,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     else
     {
       maxKernelBound = lastKernel +
-          combinedDistBound * queryKernels[queryIndex];
+          combinedDistBound * QueryKernels()[queryIndex];
     }
 
     if (maxKernelBound < bestKernel)
@@ -172,10 +212,10 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
   {
     // Could it be that this kernel evaluation has already been calculated?
     if (tree::TreeTraits<TreeType>::HasSelfChildren &&
-        referenceNode.Parent() != NULL &&
+        parentKernel != lastKernels.end() &&
         referenceNode.Point(0) == referenceNode.Parent()->Point(0))
     {
-      kernelEval = referenceNode.Parent()->Stat().LastKernel();
+      kernelEval = parentKernel->second;
     }
     else
     {
@@ -190,7 +230,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     kernelEval = kernel.Evaluate(querySet.col(queryIndex), refCenter);
   }
 
-  referenceNode.Stat().LastKernel() = kernelEval;
+  lastKernels[&referenceNode] = kernelEval;
 
   double maxKernel;
   if (kernel::KernelTraits<KernelType>::IsNormalized)
@@ -210,7 +250,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
   }
   else
   {
-    maxKernel = kernelEval + furthestDist * queryKernels[queryIndex];
+    maxKernel = kernelEval + furthestDist * QueryKernels()[queryIndex];
   }
 
   // We return the inverse of the maximum kernel so that larger kernels are
@@ -412,7 +452,7 @@ double FastMKSRules<KernelType, TreeType>::Rescore(const size_t queryIndex,
                                                    TreeType& /*referenceNode*/,
                                                    const double oldScore) const
 {
-  const double bestKernel = candidates[queryIndex].top().first;
+  const double bestKernel = candidates.Top(queryIndex).first;
 
   return ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
 }
@@ -459,11 +499,11 @@ double FastMKSRules<KernelType, TreeType>::CalculateBound(TreeType& queryNode)
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
     const size_t point = queryNode.Point(i);
-    const CandidateList& candidatesPoints = candidates[point];
-    if (candidatesPoints.top().first < worstPointKernel)
-      worstPointKernel = candidatesPoints.top().first;
+    const double worstCandidateKernel = candidates.Top(point).first;
+    if (worstCandidateKernel < worstPointKernel)
+      worstPointKernel = worstCandidateKernel;
 
-    if (candidatesPoints.top().first == -DBL_MAX)
+    if (worstCandidateKernel == -DBL_MAX)
       continue; // Avoid underflow.
 
     // This should be (queryDescendantDistance + centroidDistance) for any tree
@@ -478,11 +518,13 @@ double FastMKSRules<KernelType, TreeType>::CalculateBound(TreeType& queryNode)
     // where p_j^*(p_q) is the j'th kernel candidate for query point p_q and
     // k_j^*(p_q) is K(p_q, p_j^*(p_q)).
     double worstPointCandidateKernel = DBL_MAX;
-    typedef typename CandidateList::const_iterator iter;
-    for (iter it = candidatesPoints.begin(); it != candidatesPoints.end(); ++it)
+    typedef neighbor::CandidateList<
+        neighbor::FurthestNeighborSort>::Candidate Candidate;
+    for (const Candidate* it = candidates.Begin(point);
+        it != candidates.End(point); ++it)
     {
       const double candidateKernel = it->first - queryDescendantDistance *
-          referenceKernels[it->second];
+          ReferenceKernels()[it->second];
       if (candidateKernel < worstPointCandidateKernel)
         worstPointCandidateKernel = candidateKernel;
     }
@@ -529,13 +571,7 @@ inline void FastMKSRules<KernelType, TreeType>::InsertNeighbor(
     const size_t index,
     const double product)
 {
-  CandidateList& pqueue = candidates[queryIndex];
-  if (product > pqueue.top().first)
-  {
-    Candidate c = std::make_pair(product, index);
-    pqueue.pop();
-    pqueue.push(c);
-  }
+  candidates.Insert(queryIndex, product, index);
 }
 
 } // namespace fastmks
@@ -0,0 +1,104 @@
+/**
+ * @file component_log_probabilities.hpp
+ *
+ * Evaluate the weighted log-density of every component of a Gaussian mixture
+ * for a set of observations, in parallel over components and blocks of
+ * observations.  This is shared by GMM, EMFit and OnlineEMFit.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_COMPONENT_LOG_PROBABILITIES_HPP
+#define MLPACK_METHODS_GMM_COMPONENT_LOG_PROBABILITIES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * Compute the log of the weighted probability of each observation under each
+ * component, so that logProbs(j, i) = log(weights[i]) + log(p_i(x_j)).  Each
+ * (component, block of points) pair is a separate task, so this scales with
+ * the number of threads even when there are only a few components.
+ *
+ * @param observations Observations to evaluate, one per column.
+ * @param dists Components of the mixture.
+ * @param weights A priori weights of the components.
+ * @param logProbs Matrix to store the log-probabilities in (one row for each
+ *     observation, one column for each component).
+ */
+inline void ComponentLogProbabilities(
+    const arma::mat& observations,
+    const std::vector<distribution::GaussianDistribution>& dists,
+    const arma::vec& weights,
+    arma::mat& logProbs)
+{
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+
+  logProbs.set_size(observations.n_cols, dists.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t task = 0; task < (omp_size_t) (numBlocks * dists.size());
+      ++task)
+  {
+    const size_t component = task / numBlocks;
+    const size_t begin = (task % numBlocks) * blockSize;
+    const size_t count = std::min(blockSize,
+        (size_t) observations.n_cols - begin);
+
+    // Alias the block of points and the part of the output it fills.
+    const arma::mat block(const_cast<double*>(observations.colptr(begin)),
+        observations.n_rows, count, false, true);
+    arma::vec logProbsAlias(logProbs.colptr(component) + begin, count, false,
+        true);
+
+    dists[component].LogProbability(block, logProbsAlias);
+    logProbsAlias += std::log(weights[component]);
+  }
+}
+
+/**
+ * Turn the output of ComponentLogProbabilities() into the probability of each
+ * component given each observation (each row then sums to 1), and return the
+ * log-likelihood of each observation.  Observations that are impossible under
+ * every component get a row of zeros and a log-likelihood of -inf.
+ *
+ * @param logProbs Weighted log-probabilities; overwritten with the conditional
+ *     probabilities.
+ * @param logLikelihoods Vector to store the log-likelihood of each observation
+ *     in.
+ */
+inline void NormalizeLogProbabilities(arma::mat& logProbs,
+                                      arma::vec& logLikelihoods)
+{
+  logLikelihoods.set_size(logProbs.n_rows);
+
+  // Subtract the largest value before exponentiating, so that points far from
+  // every component do not underflow to zero.
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) logProbs.n_rows; ++j)
+  {
+    const double maxLogProb = logProbs.row(j).max();
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+    {
+      logProbs.row(j).zeros();
+      logLikelihoods[j] = maxLogProb;
+      continue;
+    }
+
+    logProbs.row(j) = arma::exp(logProbs.row(j) - maxLogProb);
+    const double probSum = arma::accu(logProbs.row(j));
+    logProbs.row(j) /= probSum;
+    logLikelihoods[j] = maxLogProb + std::log(probSum);
+  }
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -148,19 +148,24 @@ class EMFit
                          arma::vec& weights);
 
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * Calculate the conditional probability of each Gaussian given each
+   * observation, and the log-likelihood of the model.  Yes, the log-likelihood
+   * is reimplemented in the GMM code.  Intuition suggests that the
+   * log-likelihood is not the best way to determine if the EM algorithm has
+   * converged.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param covariances Vector of covariance matrices.
+   * @param observations Data matrix.
+   * @param dists Distributions of the model.
    * @param weights Vector of a priori weights.
+   * @param condProb Matrix to store the conditional probabilities in (one row
+   *     for each observation, one column for each Gaussian).
+   * @return The log-likelihood of the model.
    */
-  double LogLikelihood(const arma::mat& data,
-                       const std::vector<distribution::GaussianDistribution>&
-                           dists,
-                       const arma::vec& weights) const;
+  double ExpectationStep(
+      const arma::mat& observations,
+      const std::vector<distribution::GaussianDistribution>& dists,
+      const arma::vec& weights,
+      arma::mat& condProb) const;
 
   // Armadillo uses uword internally as an OpenMP index type, which crashes
   // Visual Studio.
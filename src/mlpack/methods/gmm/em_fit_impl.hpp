@@ -16,6 +16,7 @@
 // In case it hasn't been included yet.
 #include "em_fit.hpp"
 #include "diagonal_constraint.hpp"
+#include "component_log_probabilities.hpp"
 
 namespace mlpack {
 namespace gmm {
@@ -55,13 +56,15 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // The E-step also gives the log-likelihood of the current model, so each
+  // iteration needs to evaluate the Gaussians only once.
+  arma::mat condProb;
+  double l = ExpectationStep(observations, dists, weights, condProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -70,27 +73,6 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
     // Store the sum of the probability of each state over all the observations.
     arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
 
@@ -123,9 +105,11 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     // probabilities.
     weights = probRowSums / observations.n_cols;
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate the conditional probabilities of choosing
+    // a particular Gaussian given the observations and the new theta value,
+    // and the new log-likelihood.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = ExpectationStep(observations, dists, weights, condProb);
 
     iteration++;
   }
@@ -142,39 +126,20 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // The E-step also gives the log-likelihood of the current model, so each
+  // iteration needs to evaluate the Gaussians only once.
+  arma::mat condProb;
+  double l = ExpectationStep(observations, dists, weights, condProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
     // This will store the sum of probabilities of each state over all the
     // observations.
     arma::vec probRowSums(dists.size());
@@ -211,9 +176,11 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     // probabilities.
     weights = probRowSums / accu(probabilities);
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate the conditional probabilities of choosing
+    // a particular Gaussian given the observations and the new theta value,
+    // and the new log-likelihood.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = ExpectationStep(observations, dists, weights, condProb);
 
     iteration++;
   }
@@ -287,31 +254,27 @@ InitialClustering(const arma::mat& observations,
 }
 
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LogLikelihood(
-    const arma::mat& observations,
-    const std::vector<distribution::GaussianDistribution>& dists,
-    const arma::vec& weights) const
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+ExpectationStep(const arma::mat& observations,
+                const std::vector<distribution::GaussianDistribution>& dists,
+                const arma::vec& weights,
+                arma::mat& condProb) const
 {
-  double logLikelihood = 0;
+  // This is done in log-space, and in parallel over Gaussians and blocks of
+  // points.
+  arma::vec logLikelihoods;
+  ComponentLogProbabilities(observations, dists, weights, condProb);
+  NormalizeLogProbabilities(condProb, logLikelihoods);
 
-  arma::vec phis;
-  arma::mat likelihoods(dists.size(), observations.n_cols);
-
-  for (size_t i = 0; i < dists.size(); ++i)
-  {
-    dists[i].Probability(observations, phis);
-    likelihoods.row(i) = weights(i) * trans(phis);
-  }
   // Now sum over every point.
   for (size_t j = 0; j < observations.n_cols; ++j)
   {
-    if (accu(likelihoods.col(j)) == 0)
+    if (logLikelihoods[j] == -std::numeric_limits<double>::infinity())
       Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
           << "outlier." << std::endl;
-    logLikelihood += log(accu(likelihoods.col(j)));
   }
 
-  return logLikelihood;
+  return arma::accu(logLikelihoods);
 }
 
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
@@ -12,6 +12,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include "gmm.hpp"
+#include "component_log_probabilities.hpp"
 
 namespace mlpack {
 namespace gmm {
@@ -76,6 +77,29 @@ double GMM::Probability(const arma::vec& observation,
   return weights[component] * dists[component].Probability(observation);
 }
 
+/**
+ * Return the probability of each of the given observations being from this
+ * GMM.
+ */
+void GMM::Probability(const arma::mat& observations,
+                      arma::vec& probabilities) const
+{
+  LogProbability(observations, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
+/**
+ * Return the log-probability of each of the given observations being from this
+ * GMM.
+ */
+void GMM::LogProbability(const arma::mat& observations,
+                         arma::vec& logProbabilities) const
+{
+  arma::mat logProbs;
+  ComponentLogProbabilities(observations, dists, weights, logProbs);
+  NormalizeLogProbabilities(logProbs, logProbabilities);
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
@@ -108,21 +132,24 @@ arma::vec GMM::Random() const
 void GMM::Classify(const arma::mat& observations,
                    arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  // Evaluate every component for every point at once; the most probable
+  // component is the one with the largest weighted log-probability.
+  arma::mat logProbs;
+  ComponentLogProbabilities(observations, dists, weights, logProbs);
 
-  // We should not have to fill this with values, because each one should be
-  // overwritten.
   labels.set_size(observations.n_cols);
-  for (size_t i = 0; i < observations.n_cols; ++i)
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) observations.n_cols; ++i)
   {
-    // Find maximum probability component.
-    double probability = 0;
+    // Find maximum probability component.  Ties go to the last component.
+    double logProbability = -std::numeric_limits<double>::infinity();
+    labels[i] = 0;
     for (size_t j = 0; j < gaussians; ++j)
     {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
+      if (logProbs(i, j) >= logProbability)
       {
-        probability = newProb;
+        logProbability = logProbs(i, j);
         labels[i] = j;
       }
     }
@@ -137,20 +164,13 @@ double GMM::LogLikelihood(
     const std::vector<distribution::GaussianDistribution>& distsL,
     const arma::vec& weightsL) const
 {
-  double loglikelihood = 0;
-  arma::vec phis;
-  arma::mat likelihoods(gaussians, data.n_cols);
-
-  for (size_t i = 0; i < gaussians; i++)
-  {
-    distsL[i].Probability(data, phis);
-    likelihoods.row(i) = weightsL(i) * trans(phis);
-  }
+  arma::mat logProbs;
+  arma::vec logLikelihoods;
+  ComponentLogProbabilities(data, distsL, weightsL, logProbs);
+  NormalizeLogProbabilities(logProbs, logLikelihoods);
 
   // Now sum over every point.
-  for (size_t j = 0; j < data.n_cols; j++)
-    loglikelihood += log(accu(likelihoods.col(j)));
-  return loglikelihood;
+  return arma::accu(logLikelihoods);
 }
 
 } // namespace gmm
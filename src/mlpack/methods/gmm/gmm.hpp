@@ -17,6 +17,8 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+// This fitting method can also update a model with batches of data.
+#include "online_em_fit.hpp"
 
 namespace mlpack {
 namespace gmm /** Gaussian Mixture Models. */ {
@@ -174,6 +176,28 @@ class GMM
   double Probability(const arma::vec& observation,
                      const size_t component) const;
 
+  /**
+   * Compute the probability of each of the given observations (one per column)
+   * under this distribution.  The Gaussians are evaluated in parallel over
+   * components and blocks of observations.
+   *
+   * @param observations Observations to evaluate the probability of.
+   * @param probabilities Vector to store the probabilities in.
+   */
+  void Probability(const arma::mat& observations,
+                   arma::vec& probabilities) const;
+
+  /**
+   * Compute the log-probability of each of the given observations (one per
+   * column) under this distribution.  This is computed in log-space, so it
+   * does not underflow for observations far from every component.
+   *
+   * @param observations Observations to evaluate the log-probability of.
+   * @param logProbabilities Vector to store the log-probabilities in.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -241,6 +265,34 @@ class GMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Update the model with a batch of observations, for fitting data that
+   * arrives in batches.  The FittingType must keep the state of the fit between
+   * calls (OnlineEMFit<> keeps running sufficient statistics), so the same
+   * fitter should be given for every batch.  If the fitter has not seen any
+   * batch yet, the initial model is found from this batch unless
+   * useExistingModel is true.
+   *
+   * @code
+   * GMM gmm(5, 10);
+   * OnlineEMFit<> fitter;
+   * for (size_t i = 0; i < batches.size(); ++i)
+   *   gmm.Update(batches[i], fitter);
+   * @endcode
+   *
+   * @tparam FittingType The type of fitting method which should be used; it
+   *     must provide an Update() method as OnlineEMFit<> does.
+   * @param batch Batch of observations.
+   * @param fitter Fitting object that holds the state of the fit.
+   * @param useExistingModel If true, the existing model is used as the initial
+   *     model when the fitter has not seen any batch yet.
+   * @return The log-likelihood of the batch under the model before the update.
+   */
+  template<typename FittingType>
+  double Update(const arma::mat& batch,
+                FittingType& fitter,
+                const bool useExistingModel = false);
+
   /**
    * Classify the given observations as being from an individual component in
    * this GMM.  The resultant classifications are stored in the 'labels' object,
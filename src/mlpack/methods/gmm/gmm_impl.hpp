@@ -187,6 +187,22 @@ double GMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Update the GMM with a batch of observations.
+ */
+template<typename FittingType>
+double GMM::Update(const arma::mat& batch,
+                   FittingType& fitter,
+                   const bool useExistingModel)
+{
+  const double logLikelihood = fitter.Update(batch, dists, weights,
+      useExistingModel);
+
+  Log::Debug << "GMM::Update(): log-likelihood of batch of " << batch.n_cols
+      << " points is " << logLikelihood << "." << std::endl;
+  return logLikelihood;
+}
+
 /**
  * Serialize the object.
  */
@@ -0,0 +1,233 @@
+/**
+ * @file online_em_fit.hpp
+ *
+ * Utility class to fit a GMM with online (stochastic) EM, which processes the
+ * data in mini-batches.  Used by GMM::Train<>() and GMM::Update<>().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to observations with the online EM algorithm of Cappé
+ * and Moulines ("On-line expectation-maximization algorithm for latent data
+ * models", 2009).  Instead of recomputing the model from all the observations
+ * on every iteration, it keeps running sufficient statistics of the mixture
+ * (the weight, first moment and second moment of each component).  For each
+ * mini-batch, the statistics of the batch are computed with the current model
+ * (the E-step), the running statistics are moved towards them with step size
+ *
+ *   gamma_t = (t + 1)^(-kappa)
+ *
+ * where t is the number of batches seen so far, and the model is recomputed
+ * from the running statistics (the M-step).  kappa must be in (0.5, 1]; with
+ * kappa = 1 the running statistics are the plain average over every batch.
+ *
+ * The statistics are kept between calls, so Update() can be used to fit a GMM
+ * to data that arrives in batches and is never held in memory all at once:
+ *
+ * @code
+ * GMM gmm(5, 10);
+ * OnlineEMFit<> fitter;
+ * while (stream.NextBatch(batch))
+ *   gmm.Update(batch, fitter);
+ * @endcode
+ *
+ * The first batch is used to find the initial model with the
+ * InitialClusteringType (as EMFit does), unless the existing model is to be
+ * used.
+ *
+ * The Estimate() methods make GMM::Train() run online EM over a dataset held in
+ * memory: each pass visits the points in a random order, in batches.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint>
+class OnlineEMFit
+{
+ public:
+  /**
+   * Construct the OnlineEMFit object.  The maximum number of iterations is the
+   * maximum number of passes over the data made by Estimate(); it stops earlier
+   * if the log-likelihood of a pass changes by less than the tolerance.
+   *
+   * @param maxIterations Maximum number of passes over the data in Estimate().
+   * @param tolerance Log-likelihood tolerance required for convergence.
+   * @param batchSize Number of points in each mini-batch of Estimate().
+   * @param kappa Exponent of the step size schedule, in (0.5, 1].
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Object which applies constraints to the covariances.
+   */
+  OnlineEMFit(const size_t maxIterations = 10,
+              const double tolerance = 1e-10,
+              const size_t batchSize = 1000,
+              const double kappa = 0.6,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) using online EM.
+   * Any statistics of earlier calls are discarded.  The size of the vectors
+   * (indicating the number of components) must already be set.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store the trained model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) using online EM,
+   * taking into account the probability of each point being from this mixture.
+   * Any statistics of earlier calls are discarded.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions to store the trained model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Update the model with one batch of observations: compute the statistics of
+   * the batch, fold them into the running statistics, and recompute the model.
+   * If no batch has been seen yet, the initial model is found by clustering
+   * this batch, unless useInitialModel is true.
+   *
+   * @param batch Batch of observations.
+   * @param dists Distributions of the model, to be updated.
+   * @param weights A priori weights of the model, to be updated.
+   * @param useInitialModel If true and no batch has been seen yet, the given
+   *      model is used as the initial model.
+   * @return Log-likelihood of the batch under the model before the update.
+   */
+  double Update(const arma::mat& batch,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  //! Forget the running statistics, so that the next batch starts over.
+  void Reset();
+
+  //! Get the number of batches that have been seen since the last Reset().
+  size_t Steps() const { return steps; }
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the maximum number of passes over the data in Estimate().
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of passes over the data in Estimate().
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for the convergence of Estimate().
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for the convergence of Estimate().
+  double& Tolerance() { return tolerance; }
+
+  //! Get the batch size used by Estimate().
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size used by Estimate().
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the exponent of the step size schedule.
+  double Kappa() const { return kappa; }
+  //! Modify the exponent of the step size schedule.
+  double& Kappa() { return kappa; }
+
+  //! Serialize the fitter, including the running statistics.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  /**
+   * Run the online EM algorithm over the given observations, in random
+   * batches.  This is a helper function for both overloads of Estimate().
+   */
+  void EstimatePasses(const arma::mat& observations,
+                      const arma::vec& probabilities,
+                      std::vector<distribution::GaussianDistribution>& dists,
+                      arma::vec& weights,
+                      const bool useInitialModel);
+
+  /**
+   * Find the initial model from the given observations with the
+   * InitialClusteringType, in the same way EMFit does.
+   */
+  void InitialClustering(const arma::mat& observations,
+                         std::vector<distribution::GaussianDistribution>& dists,
+                         arma::vec& weights);
+
+  /**
+   * Run one step of online EM on the given batch, where each point has the
+   * given probability of being from the mixture.
+   *
+   * @return Log-likelihood of the batch under the model before the step.
+   */
+  double Step(const arma::mat& batch,
+              const arma::vec& probabilities,
+              std::vector<distribution::GaussianDistribution>& dists,
+              arma::vec& weights);
+
+  //! Maximum passes over the data in Estimate().
+  size_t maxIterations;
+  //! Tolerance for convergence of Estimate().
+  double tolerance;
+  //! Number of points in each batch of Estimate().
+  size_t batchSize;
+  //! Exponent of the step size schedule.
+  double kappa;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+
+  //! Number of batches seen since the last Reset().
+  size_t steps;
+  //! Running average of the responsibility of each component.
+  arma::vec sumWeights;
+  //! Running average of the responsibility-weighted points (one column for
+  //! each component).
+  arma::mat sumMeans;
+  //! Running average of the responsibility-weighted outer products of the
+  //! points (one slice for each component).
+  arma::cube sumCovariances;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,266 @@
+/**
+ * @file online_em_fit_impl.hpp
+ *
+ * Implementation of online EM for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+#include "component_log_probabilities.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::OnlineEMFit(
+    const size_t maxIterations,
+    const double tolerance,
+    const size_t batchSize,
+    const double kappa,
+    InitialClusteringType clusterer,
+    CovarianceConstraintPolicy constraint) :
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    batchSize(batchSize),
+    kappa(kappa),
+    clusterer(clusterer),
+    constraint(constraint),
+    steps(0)
+{ /* Nothing to do. */ }
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  EstimatePasses(observations, arma::ones<arma::vec>(observations.n_cols),
+      dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    const arma::vec& probabilities,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  EstimatePasses(observations, probabilities, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+double OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Update(
+    const arma::mat& batch,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  if (dists.empty())
+    Log::Fatal << "OnlineEMFit::Update(): the model has no components!"
+        << std::endl;
+
+  if (batch.n_rows != dists[0].Mean().n_elem)
+    Log::Fatal << "OnlineEMFit::Update(): batch has dimensionality "
+        << batch.n_rows << ", but the model has dimensionality "
+        << dists[0].Mean().n_elem << "!" << std::endl;
+
+  if (batch.n_cols == 0)
+    return 0.0;
+
+  if (steps == 0 && !useInitialModel)
+  {
+    if (batch.n_cols < dists.size())
+      Log::Fatal << "OnlineEMFit::Update(): cannot find " << dists.size()
+          << " initial components from a batch of " << batch.n_cols
+          << " points!" << std::endl;
+
+    InitialClustering(batch, dists, weights);
+  }
+
+  return Step(batch, arma::ones<arma::vec>(batch.n_cols), dists, weights);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Reset()
+{
+  steps = 0;
+  sumWeights.reset();
+  sumMeans.reset();
+  sumCovariances.reset();
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+EstimatePasses(const arma::mat& observations,
+               const arma::vec& probabilities,
+               std::vector<distribution::GaussianDistribution>& dists,
+               arma::vec& weights,
+               const bool useInitialModel)
+{
+  if (batchSize == 0)
+    Log::Fatal << "OnlineEMFit::Estimate(): batch size must be positive!"
+        << std::endl;
+
+  if (observations.n_cols == 0)
+    Log::Fatal << "OnlineEMFit::Estimate(): no observations given!"
+        << std::endl;
+
+  Reset();
+  if (!useInitialModel)
+    InitialClustering(observations, dists, weights);
+
+  double l = -DBL_MAX;
+  double lOld = -DBL_MAX;
+  size_t iteration = 0;
+  arma::mat batch;
+  while (iteration != maxIterations)
+  {
+    // Visit the points in a different order on every pass, so that each batch
+    // is a random sample of the data.  The log-likelihood of the pass is the
+    // sum of that of each batch, evaluated as the model changes.
+    const arma::uvec order = arma::shuffle(arma::linspace<arma::uvec>(0,
+        observations.n_cols - 1, observations.n_cols));
+
+    lOld = l;
+    l = 0.0;
+    for (size_t begin = 0; begin < observations.n_cols; begin += batchSize)
+    {
+      const size_t end = std::min(begin + batchSize,
+          (size_t) observations.n_cols) - 1;
+      const arma::uvec indices = order.subvec(begin, end);
+
+      batch = observations.cols(indices);
+      l += Step(batch, probabilities.elem(indices), dists, weights);
+    }
+
+    Log::Info << "OnlineEMFit::Estimate(): pass " << iteration << ", "
+        << "log-likelihood " << l << "." << std::endl;
+
+    ++iteration;
+    if (std::abs(l - lOld) < tolerance)
+      break;
+  }
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+InitialClustering(const arma::mat& observations,
+                  std::vector<distribution::GaussianDistribution>& dists,
+                  arma::vec& weights)
+{
+  // EMFit counts the initial clustering as its first iteration, so with one
+  // iteration it only runs the clusterer and turns the clusters into
+  // Gaussians.
+  EMFit<InitialClusteringType, CovarianceConstraintPolicy> initialFit(1);
+  initialFit.Clusterer() = clusterer;
+  initialFit.Constraint() = constraint;
+  initialFit.Estimate(observations, dists, weights, false);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+double OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Step(
+    const arma::mat& batch,
+    const arma::vec& probabilities,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights)
+{
+  if (kappa <= 0.5 || kappa > 1.0)
+    Log::Fatal << "OnlineEMFit: kappa must be in (0.5, 1], but it is " << kappa
+        << "!" << std::endl;
+
+  // E-step: find the responsibility of each component for each point.  This is
+  // done in log-space, so that points far from every component do not end up
+  // with no responsibility at all.
+  arma::mat condProb;
+  arma::vec logLikelihoods;
+  ComponentLogProbabilities(batch, dists, weights, condProb);
+  NormalizeLogProbabilities(condProb, logLikelihoods);
+  condProb.each_col() %= probabilities;
+  const double logLikelihood = arma::accu(logLikelihoods);
+
+  // The statistics of the batch are averages over its points, so that batches
+  // of any size are on the same scale as the running statistics.
+  const double totalProbability = arma::accu(probabilities);
+  if (totalProbability <= 0.0)
+    return logLikelihood;
+
+  const arma::vec batchWeights = arma::sum(condProb, 0).t() / totalProbability;
+  const arma::mat batchMeans = (batch * condProb) / totalProbability;
+  arma::cube batchCovariances(batch.n_rows, batch.n_rows, dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const arma::mat weighted = batch.each_row() % condProb.col(i).t();
+    batchCovariances.slice(i) = (weighted * batch.t()) / totalProbability;
+  }
+
+  // Move the running statistics towards those of the batch.  The first batch
+  // becomes the running statistics.
+  if (steps == 0)
+  {
+    sumWeights = batchWeights;
+    sumMeans = batchMeans;
+    sumCovariances = std::move(batchCovariances);
+  }
+  else
+  {
+    const double stepSize = std::pow((double) steps + 1.0, -kappa);
+    sumWeights = (1.0 - stepSize) * sumWeights + stepSize * batchWeights;
+    sumMeans = (1.0 - stepSize) * sumMeans + stepSize * batchMeans;
+    sumCovariances = (1.0 - stepSize) * sumCovariances +
+        stepSize * batchCovariances;
+  }
+  ++steps;
+
+  // M-step: recompute the model from the running statistics.  Components that
+  // have never been responsible for any point are left as they are.
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    if (sumWeights[i] <= 0.0)
+      continue;
+
+    dists[i].Mean() = sumMeans.col(i) / sumWeights[i];
+    arma::mat covariance = sumCovariances.slice(i) / sumWeights[i] -
+        dists[i].Mean() * dists[i].Mean().t();
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  weights = sumWeights / arma::accu(sumWeights);
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename Archive>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(tolerance);
+  ar & BOOST_SERIALIZATION_NVP(batchSize);
+  ar & BOOST_SERIALIZATION_NVP(kappa);
+  ar & BOOST_SERIALIZATION_NVP(clusterer);
+  ar & BOOST_SERIALIZATION_NVP(constraint);
+  ar & BOOST_SERIALIZATION_NVP(steps);
+  ar & BOOST_SERIALIZATION_NVP(sumWeights);
+  ar & BOOST_SERIALIZATION_NVP(sumMeans);
+  ar & BOOST_SERIALIZATION_NVP(sumCovariances);
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
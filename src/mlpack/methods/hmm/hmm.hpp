@@ -16,10 +16,28 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/dists/discrete_distribution.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 
 namespace mlpack {
 namespace hmm /** Hidden Markov Models. */ {
 
+//! Detect a Probability() method.
+HAS_EXACT_METHOD_FORM(Probability, HasProbabilityCheck);
+
+//! The form of a Probability() method that evaluates a batch of observations.
+template<typename Distribution>
+using BatchProbabilityForm =
+    void(Distribution::*)(const arma::mat&, arma::vec&) const;
+
+//! Detect a LogProbability() method.
+HAS_EXACT_METHOD_FORM(LogProbability, HasLogProbabilityCheck);
+
+//! The form of a LogProbability() method that evaluates a batch of
+//! observations.
+template<typename Distribution>
+using BatchLogProbabilityForm =
+    void(Distribution::*)(const arma::mat&, arma::vec&) const;
+
 /**
  * A class that represents a Hidden Markov Model with an arbitrary type of
  * emission distribution.  This HMM class supports training (supervised and
@@ -50,6 +68,15 @@ namespace hmm /** Hidden Markov Models. */ {
  * };
  * @endcode
  *
+ * If the distribution also provides a method
+ * void Probability(const arma::mat&, arma::vec&) const, which evaluates every
+ * column of a matrix at once (like GaussianDistribution does), it is used to
+ * compute the emission probabilities of a whole sequence with one call per
+ * state.  Likewise, a method
+ * void LogProbability(const arma::mat&, arma::vec&) const is used by the
+ * Viterbi algorithm, and by the Forward-Backward algorithm for observations
+ * that are so unlikely under every state that their probabilities underflow.
+ *
  * See the mlpack::distribution::DiscreteDistribution class for an example.  One
  * would use the DiscreteDistribution class when the observations are
  * non-negative integers.  Other distributions could be Gaussians, a mixture of
@@ -207,7 +234,9 @@ class HMM
    * @param backwardProb Matrix in which the backward probabilities of each
    *    state at each time interval will be stored.
    * @param scales Vector in which the scaling factors at each time interval
-   *    will be stored.
+   *    will be stored.  The emission probabilities of an observation that
+   *    underflow for every state are scaled up first, so then the scaling
+   *    factors don't sum to the log-likelihood.
    * @return Log-likelihood of most likely state sequence.
    */
   double Estimate(const arma::mat& dataSeq,
@@ -267,6 +296,34 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence of each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are processed in
+   * parallel, and each thread reuses its buffers across the sequences it is
+   * given.  The state sequences are stored one after the other in stateSeq, in
+   * the order of the data sequences.
+   *
+   * @param dataSeq Vector of sequences of observations.
+   * @param stateSeq Row in which the concatenated most probable state sequences
+   *    will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of the most
+   *    probable state sequence of each data sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               arma::Row<size_t>& stateSeq,
+               arma::vec& logLikelihoods) const;
+
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  The
+   * sequences are processed in parallel.
+   *
+   * @param dataSeq Vector of data sequences to evaluate the likelihood of.
+   * @param logLikelihoods Vector in which the log-likelihood of each sequence
+   *    will be stored.
+   */
+  void LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                     arma::vec& logLikelihoods) const;
+
   /**
    * HMM filtering. Computes the k-step-ahead expected emission at each time
    * conditioned only on prior observations. That is
@@ -359,6 +416,47 @@ class HMM
                 const arma::vec& scales,
                 arma::mat& backwardProb) const;
 
+  /**
+   * The Forward algorithm, which also returns the emission probabilities of
+   * each state for each observation (as computed by EmissionProbabilities()),
+   * so they can be reused by Backward().
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param scales Vector in which scaling factors will be saved.
+   * @param forwardProb Matrix in which forward probabilities will be saved.
+   * @param emissionProb Matrix in which emission probabilities will be saved.
+   * @return Log-likelihood of the data sequence.
+   */
+  double Forward(const arma::mat& dataSeq,
+                 arma::vec& scales,
+                 arma::mat& forwardProb,
+                 arma::mat& emissionProb) const;
+
+  /**
+   * The Backward algorithm, given the scaling factors and emission
+   * probabilities found by Forward().
+   *
+   * @param scales Vector of scaling factors.
+   * @param emissionProb Emission probabilities of each state (rows) for each
+   *     observation (columns).
+   * @param backwardProb Matrix in which backward probabilities will be saved.
+   */
+  void Backward(const arma::vec& scales,
+                const arma::mat& emissionProb,
+                arma::mat& backwardProb) const;
+
+  /**
+   * Compute the probability of each observation in the given data sequence
+   * under the emission distribution of each state.  The returned matrix has
+   * rows equal to the number of hidden states and columns equal to the number
+   * of observations.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param emissionProb Matrix in which emission probabilities will be saved.
+   */
+  void EmissionProbabilities(const arma::mat& dataSeq,
+                             arma::mat& emissionProb) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
@@ -366,6 +464,57 @@ class HMM
   arma::mat transition;
 
  private:
+  /**
+   * Run the Viterbi algorithm on the given data sequence, given the logs of the
+   * transposed transition matrix.  stateSeq must already have one element per
+   * observation.  The trellis matrices are given so that they can be reused
+   * between sequences.
+   */
+  double Viterbi(const arma::mat& dataSeq,
+                 const arma::mat& logTrans,
+                 arma::Row<size_t>& stateSeq,
+                 arma::mat& logStateProb,
+                 arma::mat& stateSeqBack,
+                 arma::mat& logEmissionProb) const;
+
+  //! Compute the emission probabilities with one batch call per state.
+  void EmissionProbabilities(const arma::mat& dataSeq,
+                             arma::mat& emissionProb,
+                             const std::true_type /* batch */) const;
+
+  //! Compute the emission probabilities one observation at a time.
+  void EmissionProbabilities(const arma::mat& dataSeq,
+                             arma::mat& emissionProb,
+                             const std::false_type /* batch */) const;
+
+  /**
+   * Scale up the emission probabilities of the observations for which they are
+   * so small for every state that the forward probabilities would underflow.
+   * They are computed again from the log-probabilities, and scaled so that the
+   * largest of each observation is 1.
+   *
+   * @param dataSeq Data sequence the emission probabilities were computed for.
+   * @param emissionProb Emission probabilities to scale.
+   * @return Sum of the logs of the factors the probabilities were divided by.
+   */
+  double RescaleEmissionProbabilities(const arma::mat& dataSeq,
+                                      arma::mat& emissionProb) const;
+
+  //! Compute the logs of the emission probabilities of each state for each
+  //! observation.
+  void LogEmissionProbabilities(const arma::mat& dataSeq,
+                                arma::mat& logEmissionProb) const;
+
+  //! Compute the log emission probabilities with one batch call per state.
+  void LogEmissionProbabilities(const arma::mat& dataSeq,
+                                arma::mat& logEmissionProb,
+                                const std::true_type /* batch */) const;
+
+  //! Compute the log emission probabilities from the emission probabilities.
+  void LogEmissionProbabilities(const arma::mat& dataSeq,
+                                arma::mat& logEmissionProb,
+                                const std::false_type /* batch */) const;
+
   //! Initial state probability vector.
   arma::vec initial;
 
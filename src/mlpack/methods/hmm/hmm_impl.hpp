@@ -104,10 +104,31 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   }
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The observations
+  // themselves never change, so we gather them only once; each sequence starts
+  // at offsets[seq] in the list.
   std::vector<arma::vec> emissionProb(transition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> offsets(dataSeq.size());
+  size_t sumTime = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = sumTime;
+    if (dataSeq[seq].n_cols > 0)
+      emissionList.cols(sumTime, sumTime + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    sumTime += dataSeq[seq].n_cols;
+  }
+
+  // The E-step is run in parallel over sequences; each thread collects its own
+  // estimates of the initial and transition probabilities.
+  size_t maxThreads = 1;
+  #ifdef HAS_OPENMP
+    maxThreads = omp_get_max_threads();
+  #endif
+  std::vector<arma::vec> localInitial(maxThreads);
+  std::vector<arma::mat> localTransition(maxThreads);
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -115,60 +136,80 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   for (size_t iter = 0; iter < iterations; iter++)
   {
     // Clear new transition matrix and emission probabilities.
-    arma::vec newInitial(transition.n_rows);
-    newInitial.zeros();
-    arma::mat newTransition(transition.n_rows, transition.n_cols);
-    newTransition.zeros();
+    for (size_t i = 0; i < maxThreads; ++i)
+    {
+      localInitial[i].zeros(transition.n_rows);
+      localTransition[i].zeros(transition.n_rows, transition.n_cols);
+    }
 
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    #pragma omp parallel reduction(+:loglik)
     {
+      size_t thread = 0;
+      #ifdef HAS_OPENMP
+        thread = omp_get_thread_num();
+      #endif
+
       arma::mat stateProb;
       arma::mat forward;
       arma::mat backward;
+      arma::mat seqEmissionProb;
       arma::vec scales;
 
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += Estimate(dataSeq[seq], stateProb, forward, backward, scales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < transition.n_cols; ++j)
-        newInitial[j] += stateProb(j, 0);
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      // Loop over each sequence.
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
       {
-        for (size_t j = 0; j < transition.n_cols; ++j)
+        const size_t length = dataSeq[seq].n_cols;
+
+        // Add the log-likelihood of this sequence.  This is the E-step.
+        loglik += Forward(dataSeq[seq], scales, forward, seqEmissionProb);
+        Backward(scales, seqEmissionProb, backward);
+        stateProb = forward % backward;
+
+        // Add to estimate of initial probability for state j.
+        localInitial[thread] += stateProb.col(0);
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.  The sum over t
+        // for T_ij is the product of the scaled backward probabilities
+        // b(i, t + 1) E_i(seq[d][t + 1]) / s(t + 1) with the forward
+        // probabilities; we postpone multiplication of the old T_ij until
+        // later.
+        if (length > 1)
         {
-          if (t < dataSeq[seq].n_cols - 1)
-          {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < transition.n_rows; i++)
-              newTransition(i, j) += forward(j, t) * backward(i, t + 1) *
-                  emission[i].Probability(dataSeq[seq].unsafe_col(t + 1)) /
-                  scales[t + 1];
-          }
-
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = stateProb(j, t);
+          arma::mat scaledBackward = backward.tail_cols(length - 1) %
+              seqEmissionProb.tail_cols(length - 1);
+          scaledBackward.each_row() /= scales.tail(length - 1).t();
+          localTransition[thread] += scaledBackward *
+              forward.head_cols(length - 1).t();
+        }
+
+        // Store the weights of the observations, for Distribution::Train().
+        if (length > 0)
+        {
+          for (size_t j = 0; j < transition.n_cols; ++j)
+            emissionProb[j].subvec(offsets[seq], offsets[seq] + length - 1) =
+                stateProb.row(j).t();
         }
-        sumTime++;
       }
     }
 
+    arma::vec newInitial = std::move(localInitial[0]);
+    arma::mat newTransition = std::move(localTransition[0]);
+    for (size_t i = 1; i < maxThreads; ++i)
+    {
+      newInitial += localInitial[i];
+      newTransition += localTransition[i];
+    }
+
     if (std::abs(oldLoglik - loglik) < tolerance)
     {
       Log::Debug << "Converged after " << iter << " iterations." << std::endl;
@@ -314,16 +355,18 @@ double HMM<Distribution>::Estimate(const arma::mat& dataSeq,
                                    arma::mat& backwardProb,
                                    arma::vec& scales) const
 {
-  // First run the forward-backward algorithm.
-  Forward(dataSeq, scales, forwardProb);
-  Backward(dataSeq, scales, backwardProb);
+  // First run the forward-backward algorithm.  The emission probabilities are
+  // only computed once, by Forward().
+  arma::mat emissionProb;
+  const double logLikelihood = Forward(dataSeq, scales, forwardProb,
+      emissionProb);
+  Backward(scales, emissionProb, backwardProb);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
   stateProb = forwardProb % backwardProb;
 
-  // Finally assemble the log-likelihood and return it.
-  return accu(log(scales));
+  return logLikelihood;
 }
 
 /**
@@ -399,53 +442,64 @@ template<typename Distribution>
 double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Row<size_t>& stateSeq) const
 {
-  // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
-  stateSeq.set_size(dataSeq.n_cols);
-  arma::mat logStateProb(transition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(transition.n_rows, dataSeq.n_cols);
-
   // Store the logs of the transposed transition matrix.  This is because we
   // will be using the rows of the transition matrix.
-  arma::mat logTrans(log(trans(transition)));
+  const arma::mat logTrans(log(trans(transition)));
 
-  // The calculation of the first state is slightly different; the probability
-  // of the first state being state j is the maximum probability that the state
-  // came to be j from another state.
-  logStateProb.col(0).zeros();
-  for (size_t state = 0; state < transition.n_rows; state++)
-  {
-    logStateProb(state, 0) = log(initial[state] *
-        emission[state].Probability(dataSeq.unsafe_col(0)));
-    stateSeqBack(state, 0) = state;
-  }
+  arma::mat logStateProb;
+  arma::mat stateSeqBack;
+  arma::mat logEmissionProb;
+  stateSeq.set_size(dataSeq.n_cols);
+  return Viterbi(dataSeq, logTrans, stateSeq, logStateProb, stateSeqBack,
+      logEmissionProb);
+}
 
-  // Store the best first state.
-  arma::uword index;
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+/**
+ * Compute the most probable hidden state sequence of each of the given
+ * observation sequences, in parallel.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeq,
+                                arma::Row<size_t>& stateSeq,
+                                arma::vec& logLikelihoods) const
+{
+  // Find where the state sequence of each data sequence starts in the output.
+  std::vector<size_t> offsets(dataSeq.size() + 1, 0);
+  for (size_t seq = 0; seq < dataSeq.size(); ++seq)
+    offsets[seq + 1] = offsets[seq] + dataSeq[seq].n_cols;
+
+  stateSeq.set_size(offsets.back());
+  logLikelihoods.set_size(dataSeq.size());
+
+  const arma::mat logTrans(log(trans(transition)));
+
+  // The sequences are processed in parallel, so the BLAS calls inside of the
+  // Viterbi algorithm should only use one thread.
+  util::SingleThreadedBLAS singleThreadedBLAS;
+
+  #pragma omp parallel
   {
-    // Assemble the state probability for this element.
-    // Given that we are in state j, we use state with the highest probability
-    // of being the previous state.
-    for (size_t j = 0; j < transition.n_rows; j++)
+    // The trellis is reused by every sequence this thread processes.
+    arma::mat logStateProb;
+    arma::mat stateSeqBack;
+    arma::mat logEmissionProb;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); ++seq)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
-      logStateProb(j, t) = prob.max(index) +
-          log(emission[j].Probability(dataSeq.unsafe_col(t)));
-        stateSeqBack(j, t) = index;
+      if (dataSeq[seq].n_cols == 0)
+      {
+        logLikelihoods[seq] = 0.0;
+        continue;
+      }
+
+      // Write the states directly into the output.
+      arma::Row<size_t> states(stateSeq.memptr() + offsets[seq],
+          dataSeq[seq].n_cols, false, true);
+      logLikelihoods[seq] = Viterbi(dataSeq[seq], logTrans, states,
+          logStateProb, stateSeqBack, logEmissionProb);
     }
   }
-
-  // Backtrack to find the most probable state sequence.
-  logStateProb.unsafe_col(dataSeq.n_cols - 1).max(index);
-  stateSeq[dataSeq.n_cols - 1] = index;
-  for (size_t t = 2; t <= dataSeq.n_cols; t++)
-    stateSeq[dataSeq.n_cols - t] =
-        stateSeqBack(stateSeq[dataSeq.n_cols - t + 1], dataSeq.n_cols - t + 1);
-
-  return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
 }
 
 /**
@@ -454,13 +508,42 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 template<typename Distribution>
 double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
 {
-  arma::mat forward;
+  arma::mat forward, emissionProb;
   arma::vec scales;
 
-  Forward(dataSeq, scales, forward);
+  return Forward(dataSeq, scales, forward, emissionProb);
+}
 
-  // The log-likelihood is the log of the scales for each time step.
-  return accu(log(scales));
+/**
+ * Compute the log-likelihood of each of the given data sequences, in parallel.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                                      arma::vec& logLikelihoods) const
+{
+  logLikelihoods.set_size(dataSeq.size());
+
+  util::SingleThreadedBLAS singleThreadedBLAS;
+
+  #pragma omp parallel
+  {
+    arma::mat forward;
+    arma::mat emissionProb;
+    arma::vec scales;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); ++seq)
+    {
+      if (dataSeq[seq].n_cols == 0)
+      {
+        logLikelihoods[seq] = 0.0;
+        continue;
+      }
+
+      logLikelihoods[seq] = Forward(dataSeq[seq], scales, forward,
+          emissionProb);
+    }
+  }
 }
 
 /**
@@ -512,76 +595,249 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& scales,
                                 arma::mat& forwardProb) const
+{
+  arma::mat emissionProb;
+  Forward(dataSeq, scales, forwardProb, emissionProb);
+}
+
+template<typename Distribution>
+double HMM<Distribution>::Forward(const arma::mat& dataSeq,
+                                  arma::vec& scales,
+                                  arma::mat& forwardProb,
+                                  arma::mat& emissionProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardProb.zeros(transition.n_rows, dataSeq.n_cols);
-  scales.zeros(dataSeq.n_cols);
+  EmissionProbabilities(dataSeq, emissionProb);
+  const double logScale = RescaleEmissionProbabilities(dataSeq, emissionProb);
+  forwardProb.set_size(transition.n_rows, dataSeq.n_cols);
+  scales.set_size(dataSeq.n_cols);
 
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < transition.n_rows; state++)
-    forwardProb(state, 0) = initial(state) *
-        emission[state].Probability(dataSeq.unsafe_col(0));
+  forwardProb.col(0) = initial % emissionProb.col(0);
 
   // Then normalize the column.
   scales[0] = accu(forwardProb.col(0));
   if (scales[0] > 0.0)
     forwardProb.col(0) /= scales[0];
 
-  // Now compute the probabilities for each successive observation.
+  // Now compute the probabilities for each successive observation.  The
+  // forward probability of state j at time t is the sum over all states of the
+  // probability of the previous state transitioning to the current state, times
+  // the probability of state j emitting the given observation.
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      forwardProb(j, t) = accu(forwardProb.col(t - 1) %
-          trans(transition.row(j))) *
-          emission[j].Probability(dataSeq.unsafe_col(t));
-    }
+    forwardProb.col(t) = (transition * forwardProb.col(t - 1)) %
+        emissionProb.col(t);
 
     // Normalize probability.
     scales[t] = accu(forwardProb.col(t));
     if (scales[t] > 0.0)
       forwardProb.col(t) /= scales[t];
   }
+
+  // The log-likelihood is the log of the scales for each time step, and of the
+  // factors the emission probabilities were scaled by.
+  return accu(log(scales)) + logScale;
 }
 
 template<typename Distribution>
 void HMM<Distribution>::Backward(const arma::mat& dataSeq,
                                  const arma::vec& scales,
                                  arma::mat& backwardProb) const
+{
+  arma::mat emissionProb;
+  EmissionProbabilities(dataSeq, emissionProb);
+  RescaleEmissionProbabilities(dataSeq, emissionProb);
+  Backward(scales, emissionProb, backwardProb);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::vec& scales,
+                                 const arma::mat& emissionProb,
+                                 arma::mat& backwardProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardProb.zeros(transition.n_rows, dataSeq.n_cols);
+  backwardProb.set_size(transition.n_rows, emissionProb.n_cols);
 
   // The last element probability is 1.
-  backwardProb.col(dataSeq.n_cols - 1).fill(1);
+  backwardProb.col(emissionProb.n_cols - 1).fill(1);
+
+  // Now step backwards through all other observations.  The backward
+  // probability of state j at time t is the sum over all states of the
+  // probability of the next state having been a transition from the current
+  // state multiplied by the probability of each of those states emitting the
+  // given observation.
+  for (size_t t = emissionProb.n_cols - 2; t + 1 > 0; t--)
+  {
+    backwardProb.col(t) = transition.t() * (backwardProb.col(t + 1) %
+        emissionProb.col(t + 1));
+
+    // Normalize by the weights from the forward algorithm.
+    if (scales[t + 1] > 0.0)
+      backwardProb.col(t) /= scales[t + 1];
+  }
+}
+
+/**
+ * The Viterbi algorithm, with the trellis given by the caller.
+ */
+template<typename Distribution>
+double HMM<Distribution>::Viterbi(const arma::mat& dataSeq,
+                                  const arma::mat& logTrans,
+                                  arma::Row<size_t>& stateSeq,
+                                  arma::mat& logStateProb,
+                                  arma::mat& stateSeqBack,
+                                  arma::mat& logEmissionProb) const
+{
+  // This is an implementation of the Viterbi algorithm for finding the most
+  // probable sequence of states to produce the observed data sequence.  We
+  // don't use log-likelihoods to save that little bit of time, but we'll
+  // calculate the log-likelihood at the end of it all.
+  logStateProb.set_size(transition.n_rows, dataSeq.n_cols);
+  stateSeqBack.set_size(transition.n_rows, dataSeq.n_cols);
 
-  // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  // The calculation of the first state is slightly different; the probability
+  // of the first state being state j is the maximum probability that the state
+  // came to be j from another state.
+  LogEmissionProbabilities(dataSeq, logEmissionProb);
+
+  logStateProb.col(0) = log(initial) + logEmissionProb.col(0);
+  for (size_t state = 0; state < transition.n_rows; state++)
+    stateSeqBack(state, 0) = state;
+
+  // Store the best first state.
+  arma::uword index;
+  for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
+    // Assemble the state probability for this element.
+    // Given that we are in state j, we use state with the highest probability
+    // of being the previous state.
     for (size_t j = 0; j < transition.n_rows; j++)
     {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < transition.n_rows; state++)
-        backwardProb(j, t) += transition(state, j) * backwardProb(state, t + 1)
-            * emission[state].Probability(dataSeq.unsafe_col(t + 1));
-
-      // Normalize by the weights from the forward algorithm.
-      if (scales[t + 1] > 0.0)
-        backwardProb(j, t) /= scales[t + 1];
+      arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
+      logStateProb(j, t) = prob.max(index) + logEmissionProb(j, t);
+        stateSeqBack(j, t) = index;
     }
   }
+
+  // Backtrack to find the most probable state sequence.
+  logStateProb.unsafe_col(dataSeq.n_cols - 1).max(index);
+  stateSeq[dataSeq.n_cols - 1] = index;
+  for (size_t t = 2; t <= dataSeq.n_cols; t++)
+    stateSeq[dataSeq.n_cols - t] =
+        stateSeqBack(stateSeq[dataSeq.n_cols - t + 1], dataSeq.n_cols - t + 1);
+
+  return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::EmissionProbabilities(const arma::mat& dataSeq,
+                                              arma::mat& emissionProb) const
+{
+  EmissionProbabilities(dataSeq, emissionProb,
+      std::integral_constant<bool, HasProbabilityCheck<Distribution,
+          BatchProbabilityForm>::value>());
+}
+
+template<typename Distribution>
+void HMM<Distribution>::EmissionProbabilities(
+    const arma::mat& dataSeq,
+    arma::mat& emissionProb,
+    const std::true_type /* batch */) const
+{
+  emissionProb.set_size(transition.n_rows, dataSeq.n_cols);
+  arma::vec probabilities;
+  for (size_t state = 0; state < transition.n_rows; state++)
+  {
+    emission[state].Probability(dataSeq, probabilities);
+    emissionProb.row(state) = probabilities.t();
+  }
+}
+
+template<typename Distribution>
+void HMM<Distribution>::EmissionProbabilities(
+    const arma::mat& dataSeq,
+    arma::mat& emissionProb,
+    const std::false_type /* batch */) const
+{
+  emissionProb.set_size(transition.n_rows, dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; t++)
+    for (size_t state = 0; state < transition.n_rows; state++)
+      emissionProb(state, t) = emission[state].Probability(
+          dataSeq.unsafe_col(t));
+}
+
+template<typename Distribution>
+double HMM<Distribution>::RescaleEmissionProbabilities(
+    const arma::mat& dataSeq,
+    arma::mat& emissionProb) const
+{
+  // Below this, the products with the transition and forward probabilities
+  // may underflow.
+  const double threshold = std::sqrt(std::numeric_limits<double>::min());
+  const arma::uvec underflow = arma::find(arma::max(emissionProb, 0) <
+      threshold);
+  if (underflow.n_elem == 0)
+    return 0.0;
+
+  arma::mat logEmissionProb;
+  LogEmissionProbabilities(arma::mat(dataSeq.cols(underflow)),
+      logEmissionProb);
+
+  double logScale = 0.0;
+  for (size_t i = 0; i < underflow.n_elem; ++i)
+  {
+    // If the log-probabilities underflowed too, the observation is impossible.
+    const double maxLogProb = logEmissionProb.col(i).max();
+    if (!std::isfinite(maxLogProb))
+      continue;
+
+    emissionProb.col(underflow[i]) = exp(logEmissionProb.col(i) - maxLogProb);
+    logScale += maxLogProb;
+  }
+
+  return logScale;
+}
+
+template<typename Distribution>
+void HMM<Distribution>::LogEmissionProbabilities(
+    const arma::mat& dataSeq,
+    arma::mat& logEmissionProb) const
+{
+  LogEmissionProbabilities(dataSeq, logEmissionProb,
+      std::integral_constant<bool, HasLogProbabilityCheck<Distribution,
+          BatchLogProbabilityForm>::value>());
+}
+
+template<typename Distribution>
+void HMM<Distribution>::LogEmissionProbabilities(
+    const arma::mat& dataSeq,
+    arma::mat& logEmissionProb,
+    const std::true_type /* batch */) const
+{
+  logEmissionProb.set_size(transition.n_rows, dataSeq.n_cols);
+  arma::vec logProbabilities;
+  for (size_t state = 0; state < transition.n_rows; state++)
+  {
+    emission[state].LogProbability(dataSeq, logProbabilities);
+    logEmissionProb.row(state) = logProbabilities.t();
+  }
+}
+
+template<typename Distribution>
+void HMM<Distribution>::LogEmissionProbabilities(
+    const arma::mat& dataSeq,
+    arma::mat& logEmissionProb,
+    const std::false_type /* batch */) const
+{
+  EmissionProbabilities(dataSeq, logEmissionProb);
+  logEmissionProb = log(logEmissionProb);
 }
 
 //! Serialize the HMM.
@@ -37,12 +37,24 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Sequence Log-Likelihood", "This "
     PRINT_DATASET("seq") + " with the pre-trained HMM " + PRINT_MODEL("hmm") +
     ", the following command may be used: "
     "\n\n" +
-    PRINT_CALL("hmm_loglik", "input", "seq", "input_model", "hmm"));
+    PRINT_CALL("hmm_loglik", "input", "seq", "input_model", "hmm") +
+    "\n\n"
+    "Many sequences can be evaluated at once by concatenating their "
+    "observations in " + PRINT_PARAM_STRING("input") + " and giving the "
+    "length of each sequence with the " + PRINT_PARAM_STRING("lengths") +
+    " parameter.  The sequences are then evaluated in parallel, the "
+    "log-likelihood of each sequence is given by the " +
+    PRINT_PARAM_STRING("log_likelihoods") + " output, and " +
+    PRINT_PARAM_STRING("log_likelihood") + " is their sum.");
 
 PARAM_MATRIX_IN_REQ("input", "File containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "File containing HMM.", "m");
+PARAM_UROW_IN("lengths", "Lengths of the sequences concatenated in the "
+    "input, if it holds more than one sequence.", "l");
 
 PARAM_DOUBLE_OUT("log_likelihood", "Log-likelihood of the sequence.");
+PARAM_COL_OUT("log_likelihoods", "Log-likelihood of each sequence, if "
+    "sequence lengths are given.", "o");
 
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
@@ -70,9 +82,38 @@ struct Loglik
           << hmm.Emission()[0].Dimensionality() << ")!" << endl;
     }
 
-    const double loglik = hmm.LogLikelihood(dataSeq);
+    if (CLI::HasParam("lengths"))
+    {
+      const arma::Row<size_t> lengths =
+          std::move(CLI::GetParam<arma::Row<size_t>>("lengths"));
+      if (arma::accu(lengths) != dataSeq.n_cols)
+      {
+        Log::Fatal << "The sequence lengths sum to " << arma::accu(lengths)
+            << ", but there are " << dataSeq.n_cols << " observations!"
+            << endl;
+      }
+
+      // Every sequence is an alias of its columns of the input.
+      std::vector<mat> sequences;
+      sequences.reserve(lengths.n_elem);
+      for (size_t i = 0, start = 0; i < lengths.n_elem; start += lengths[i++])
+      {
+        sequences.push_back(mat(dataSeq.colptr(start), dataSeq.n_rows,
+            lengths[i], false, false));
+      }
+
+      arma::vec logLikelihoods;
+      hmm.LogLikelihood(sequences, logLikelihoods);
 
-    CLI::GetParam<double>("log_likelihood") = loglik;
+      CLI::GetParam<double>("log_likelihood") = arma::accu(logLikelihoods);
+      CLI::GetParam<arma::vec>("log_likelihoods") = std::move(logLikelihoods);
+    }
+    else
+    {
+      const double loglik = hmm.LogLikelihood(dataSeq);
+
+      CLI::GetParam<double>("log_likelihood") = loglik;
+    }
   }
 };
 
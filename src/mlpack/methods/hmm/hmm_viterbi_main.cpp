@@ -41,10 +41,19 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Viterbi State Prediction", "This "
     ", the following command could be used:"
     "\n\n" +
     PRINT_CALL("hmm_viterbi", "input", "obs", "input_model", "hmm", "output",
-        "states"));
+        "states") +
+    "\n\n"
+    "Many sequences can be processed at once by concatenating their "
+    "observations in " + PRINT_PARAM_STRING("input") + " and giving the "
+    "length of each sequence with the " + PRINT_PARAM_STRING("lengths") +
+    " parameter.  The sequences are then processed in parallel, and the "
+    "predicted state sequences are concatenated in the same order in " +
+    PRINT_PARAM_STRING("output") + ".");
 
 PARAM_MATRIX_IN_REQ("input", "Matrix containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "Trained HMM to use.", "m");
+PARAM_UROW_IN("lengths", "Lengths of the sequences concatenated in the "
+    "input, if it holds more than one sequence.", "l");
 PARAM_UMATRIX_OUT("output", "File to save predicted state sequence to.", "o");
 
 // Because we don't know what the type of our HMM is, we need to write a
@@ -74,7 +83,33 @@ struct Viterbi
     }
 
     arma::Row<size_t> sequence;
-    hmm.Predict(dataSeq, sequence);
+    if (CLI::HasParam("lengths"))
+    {
+      const arma::Row<size_t> lengths =
+          std::move(CLI::GetParam<arma::Row<size_t>>("lengths"));
+      if (arma::accu(lengths) != dataSeq.n_cols)
+      {
+        Log::Fatal << "The sequence lengths sum to " << arma::accu(lengths)
+            << ", but there are " << dataSeq.n_cols << " observations!"
+            << endl;
+      }
+
+      // Every sequence is an alias of its columns of the input.
+      std::vector<mat> sequences;
+      sequences.reserve(lengths.n_elem);
+      for (size_t i = 0, start = 0; i < lengths.n_elem; start += lengths[i++])
+      {
+        sequences.push_back(mat(dataSeq.colptr(start), dataSeq.n_rows,
+            lengths[i], false, false));
+      }
+
+      arma::vec logLikelihoods;
+      hmm.Predict(sequences, sequence, logLikelihoods);
+    }
+    else
+    {
+      hmm.Predict(dataSeq, sequence);
+    }
 
     // Save output.
     CLI::GetParam<arma::Mat<size_t>>("output") = std::move(sequence);
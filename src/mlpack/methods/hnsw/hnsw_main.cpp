@@ -0,0 +1,255 @@
+/**
+ * @file hnsw_main.cpp
+ *
+ * This file computes the approximate nearest-neighbors using a hierarchical
+ * navigable small world graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/util/serve_queries.hpp>
+
+#include "hnsw_search.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("K-Approximate-Nearest-Neighbor Search with HNSW",
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of points using a hierarchical navigable small world (HNSW) graph.  You "
+    "may specify a separate set of reference points and query points, or just "
+    "a reference set which will be used as both the reference and query set "
+    "(in which case each point is not its own neighbor)."
+    "\n\n"
+    "For example, the following will return 5 neighbors from the data for each "
+    "point in " + PRINT_DATASET("input") + " and store the distances in " +
+    PRINT_DATASET("distances") + " and the neighbors in " +
+    PRINT_DATASET("neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("hnsw", "k", 5, "reference", "input", "distances", "distances",
+        "neighbors", "neighbors") +
+    "\n\n"
+    "The output is organized such that row i and column j in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points."
+    "\n\n"
+    "Each point is linked to up to " + PRINT_PARAM_STRING("links") + " of its "
+    "neighbors in the graph (twice as many on the bottom layer of the graph); "
+    "more links give better recall for high-dimensional data, at the cost of "
+    "memory and build time.  The " + PRINT_PARAM_STRING("ef_construction") +
+    " parameter sets the number of candidate neighbors considered when the "
+    "graph is built, and the " + PRINT_PARAM_STRING("ef_search") + " parameter "
+    "sets the number considered by searches; larger values give better recall "
+    "and slower builds or searches.  The " + PRINT_PARAM_STRING("ef_search") +
+    " parameter may be changed when a saved model is used."
+    "\n\n"
+    "Because this is approximate-nearest-neighbors search, and because the "
+    "graph is built in parallel, results may be different from run to run.  "
+    "The " + PRINT_PARAM_STRING("seed") + " parameter can be specified to set "
+    "the random seed."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("server") + " is specified, the model is kept "
+    "in memory and batches of query points are read from standard input, one "
+    "point per line with values separated by commas or spaces; an empty line "
+    "ends a batch.  For each batch, one line is written to standard output for "
+    "each query point, holding the " + PRINT_PARAM_STRING("k") + " neighbor "
+    "indices followed by the " + PRINT_PARAM_STRING("k") + " distances, and an "
+    "empty line ends the answer.  This continues until standard input is "
+    "closed.  Since informational messages are also written to standard "
+    "output, " + PRINT_PARAM_STRING("verbose") + " should not be combined with "
+    + PRINT_PARAM_STRING("server") + ".");
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(HNSWSearch<>, "input_model", "Input HNSW model.", "m");
+PARAM_MODEL_OUT(HNSWSearch<>, "output_model", "Output for trained HNSW model.",
+    "M");
+
+// For testing recall.
+PARAM_UMATRIX_IN("true_neighbors", "Matrix of true neighbors to compute "
+    "recall with (the recall is printed when -v is specified).", "t");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+
+PARAM_INT_IN("links", "The number of links of each point on the upper layers "
+    "of the graph.", "L", 16);
+PARAM_INT_IN("ef_construction", "The number of candidate neighbors considered "
+    "when the graph is built.", "c", 200);
+PARAM_INT_IN("ef_search", "The number of candidate neighbors considered by "
+    "searches.", "e", 50);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+PARAM_FLAG("server", "If set, keep the model in memory and answer batches of "
+    "query points read from standard input until it is closed.", "");
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  // Get all the parameters after checking them.
+  if (CLI::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+  }
+  RequireParamValue<int>("links", [](int x) { return x >= 2; }, true,
+      "number of links must be at least 2");
+  RequireParamValue<int>("ef_construction", [](int x) { return x > 0; }, true,
+      "ef_construction must be greater than 0");
+  RequireParamValue<int>("ef_search", [](int x) { return x > 0; }, true,
+      "ef_search must be greater than 0");
+
+  const size_t k = CLI::GetParam<int>("k");
+
+  RequireOnlyOnePassed({ "input_model", "reference" }, true);
+
+  // In server mode, the number of neighbors must be known, and results are
+  // written to standard output.
+  const bool server = CLI::HasParam("server");
+  if (server)
+  {
+    RequireAtLeastOnePassed({ "k" }, true, "the number of neighbors must be "
+        "given in server mode");
+  }
+  else
+  {
+    RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" },
+        false, "no results will be saved");
+  }
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+
+  ReportIgnoredParam({{ "reference", false }}, "links");
+  ReportIgnoredParam({{ "reference", false }}, "ef_construction");
+
+  if (CLI::HasParam("input_model") && !CLI::HasParam("k"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("k") << " not passed; no search will be "
+        << "performed!" << std::endl;
+  }
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  HNSWSearch<>* hnsw;
+  if (CLI::HasParam("reference"))
+  {
+    arma::mat referenceData =
+        std::move(CLI::GetParam<arma::mat>("reference"));
+    Log::Info << "Using reference data from '"
+        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+        << referenceData.n_rows << " x " << referenceData.n_cols << ")."
+        << endl;
+
+    const size_t links = (size_t) CLI::GetParam<int>("links");
+    const size_t efConstruction =
+        (size_t) CLI::GetParam<int>("ef_construction");
+    Log::Info << "Building HNSW graph with " << links << " links per point "
+        << "and ef_construction " << efConstruction << "." << endl;
+
+    hnsw = new HNSWSearch<>();
+    Timer::Start("graph_building");
+    hnsw->Train(std::move(referenceData), links, efConstruction);
+    Timer::Stop("graph_building");
+  }
+  else // We must have an input model.
+  {
+    hnsw = CLI::GetParam<HNSWSearch<>*>("input_model");
+  }
+
+  // The search parameter may be changed for a saved model.
+  hnsw->EfSearch() = (size_t) CLI::GetParam<int>("ef_search");
+
+  // In server mode, only a given query set is searched before serving.
+  const bool search = CLI::HasParam("k") && (!server || CLI::HasParam("query"));
+  if (search)
+  {
+    Log::Info << "Computing " << k << " approximate nearest neighbors with "
+        << "ef_search " << hnsw->EfSearch() << "." << endl;
+
+    Timer::Start("computing_neighbors");
+    if (CLI::HasParam("query"))
+    {
+      arma::mat queryData = std::move(CLI::GetParam<arma::mat>("query"));
+      Log::Info << "Loaded query data from '"
+          << CLI::GetPrintableParam<arma::mat>("query") << "' ("
+          << queryData.n_rows << " x " << queryData.n_cols << ")." << endl;
+
+      hnsw->Search(queryData, k, neighbors, distances);
+    }
+    else
+    {
+      hnsw->Search(k, neighbors, distances);
+    }
+    Timer::Stop("computing_neighbors");
+
+    Log::Info << "Neighbors computed." << endl;
+  }
+
+  // Compute recall, if desired.
+  if (CLI::HasParam("true_neighbors"))
+  {
+    const arma::Mat<size_t> trueNeighbors =
+        std::move(CLI::GetParam<arma::Mat<size_t>>("true_neighbors"));
+
+    if (trueNeighbors.n_rows != neighbors.n_rows ||
+        trueNeighbors.n_cols != neighbors.n_cols)
+    {
+      Log::Fatal << "The true neighbors file must have the same number of "
+          << "values as the set of neighbors being queried!" << endl;
+    }
+
+    Log::Info << "Using true neighbor indices from '"
+        << CLI::GetPrintableParam<arma::Mat<size_t>>("true_neighbors") << "'."
+        << endl;
+
+    const double recallPercentage = 100 * HNSWSearch<>::ComputeRecall(
+        neighbors, trueNeighbors);
+
+    Log::Info << "Recall: " << recallPercentage << endl;
+  }
+
+  // Save output, if we did a search.
+  if (search)
+  {
+    CLI::GetParam<arma::mat>("distances") = std::move(distances);
+    CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+
+  // Answer queries from standard input, if desired.
+  if (server)
+  {
+    Log::Info << "Serving " << k << "-approximate-nearest-neighbor queries "
+        << "from standard input." << endl;
+
+    const size_t numBatches = ServeQueries(std::cin, std::cout,
+        hnsw->ReferenceSet().n_rows, [&](const arma::mat& queries,
+                                         arma::Mat<size_t>& batchNeighbors,
+                                         arma::mat& batchDistances)
+    {
+      hnsw->Search(queries, k, batchNeighbors, batchDistances);
+    });
+
+    Log::Info << "Answered " << numBatches << " query batches." << endl;
+  }
+
+  CLI::GetParam<HNSWSearch<>*>("output_model") = hnsw;
+}
@@ -0,0 +1,290 @@
+/**
+ * @file hnsw_search.hpp
+ *
+ * Defines the HNSWSearch class, which performs approximate nearest neighbor
+ * search with a hierarchical navigable small world graph.
+ *
+ * For more information on the algorithm, see the following paper:
+ *
+ * @code
+ * @article{malkov2018efficient,
+ *   title={Efficient and Robust Approximate Nearest Neighbor Search Using
+ *       Hierarchical Navigable Small World Graphs},
+ *   author={Malkov, Yu A. and Yashunin, D. A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   year={2018}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <mutex>
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSWSearch class builds a hierarchical navigable small world (HNSW) graph
+ * on the reference set, and uses it to compute the approximate nearest
+ * neighbors of query points.  Each reference point is a node of the bottom
+ * layer of the graph, and of each layer above it with a probability that
+ * decreases geometrically; every node is linked to up to M of its close
+ * neighbors on each of its layers (2M on the bottom layer).  A search descends
+ * greedily through the sparse upper layers and then explores the bottom layer
+ * with a beam of efSearch candidates, so increasing efSearch trades speed for
+ * recall.
+ *
+ * The graph is built by inserting the points in parallel with OpenMP; each node
+ * is locked while its links are read or modified.  Because of this, and because
+ * the layers of the points are random, the graph (and so the results) may
+ * differ from run to run.  The searches of different query points are run in
+ * parallel too.
+ *
+ * @code
+ * HNSWSearch<> hnsw(std::move(referenceSet), 16, 200);
+ * hnsw.EfSearch() = 100;
+ * hnsw.Search(querySet, k, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MetricType The metric to use; this should satisfy the triangle
+ *     inequality for the graph to be navigable (for instance, LMetric or
+ *     IPMetric).
+ * @tparam MatType The type of the data matrix.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSWSearch
+{
+ public:
+  //! The type of the elements of the data.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Build the graph on the given reference set.  In order to avoid copying the
+   * reference set, consider passing it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param m Number of links of each node on the upper layers (each node has
+   *     up to 2m links on the bottom layer); 5 to 48 is a sensible range, and
+   *     higher-dimensional data benefits from larger values.
+   * @param efConstruction Number of candidate neighbors considered when a point
+   *     is inserted.
+   * @param efSearch Number of candidate neighbors considered by searches (at
+   *     least k are always considered).
+   * @param metric An optional instantiated metric.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t m = 16,
+             const size_t efConstruction = 200,
+             const size_t efSearch = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Create an HNSWSearch object with no reference set.  Train() must be called
+   * before any search is performed.
+   */
+  HNSWSearch();
+
+  /**
+   * Build the graph on the given reference set, replacing any previous graph.
+   * In order to avoid copying the reference set, consider passing it with
+   * std::move().  A std::invalid_argument is thrown if the reference set is
+   * empty or m is less than 2.
+   *
+   * @param referenceSet Set of reference points.
+   * @param m Number of links of each node on the upper layers.
+   * @param efConstruction Number of candidate neighbors considered when a point
+   *     is inserted.
+   */
+  void Train(MatType referenceSet,
+             const size_t m = 16,
+             const size_t efConstruction = 200);
+
+  /**
+   * Compute the approximate nearest neighbors of the given query points, and
+   * store the output in the given matrices.  The matrices will be set to the
+   * size of k by the number of query points.  If fewer than k neighbors are
+   * found for a point (which can only happen if the graph is disconnected), the
+   * missing neighbors are given the index of the number of reference points and
+   * the largest possible distance.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::Mat<ElemType>& distances);
+
+  /**
+   * Compute the approximate nearest neighbors of the points of the reference
+   * set, not counting each point as its own neighbor.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::Mat<ElemType>& distances);
+
+  /**
+   * Compute the recall (% of neighbors found) given the neighbors returned by
+   * HNSWSearch::Search and a "ground truth" set of neighbors.  The recall
+   * returned will be in the range [0, 1].
+   *
+   * @param foundNeighbors Set of neighbors to compute recall of.
+   * @param realNeighbors Set of "ground truth" neighbors to compute recall
+   *     against.
+   */
+  static double ComputeRecall(const arma::Mat<size_t>& foundNeighbors,
+                              const arma::Mat<size_t>& realNeighbors);
+
+  //! Serialize the HNSW model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+  //! Return the reference dataset.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of links of each node on the upper layers.
+  size_t M() const { return m; }
+  //! Get the number of candidates considered when a point is inserted.
+  size_t EfConstruction() const { return efConstruction; }
+
+  //! Get the number of candidates considered by searches.
+  size_t EfSearch() const { return efSearch; }
+  //! Modify the number of candidates considered by searches.
+  size_t& EfSearch() { return efSearch; }
+
+  //! Get the index of the top layer of the graph.
+  size_t MaxLevel() const { return maxLevel; }
+  //! Get the index of the point searches start from.
+  size_t EntryPoint() const { return entryPoint; }
+
+  //! Get the index of the top layer the given point is a node of.
+  size_t Level(const size_t point) const { return graph[point].size() - 1; }
+  //! Get the links of the given point on the given layer.
+  const std::vector<size_t>& Neighbors(const size_t point,
+                                       const size_t layer) const
+  {
+    return graph[point][layer];
+  }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  //! A candidate neighbor: its distance and its index.
+  typedef std::pair<ElemType, size_t> Candidate;
+
+  /**
+   * The set of points visited by a search.  Each search gets a new tag, so the
+   * marks don't have to be cleared between searches.
+   */
+  class VisitedSet
+  {
+   public:
+    //! Create the set for the given number of points.
+    VisitedSet(const size_t numPoints) : marks(numPoints, 0), tag(0) { }
+
+    //! Empty the set.
+    void Clear() { ++tag; }
+
+    //! Add the given point to the set, and return false if it was there.
+    bool Visit(const size_t point)
+    {
+      if (marks[point] == tag)
+        return false;
+      marks[point] = tag;
+      return true;
+    }
+
+   private:
+    //! The tag of the last search that visited each point.
+    std::vector<size_t> marks;
+    //! The tag of the current search.
+    size_t tag;
+  };
+
+  /**
+   * Search the given layer of the graph for the ef nearest neighbors of the
+   * query, starting from the given candidates.  On return, the candidates hold
+   * the neighbors found, sorted by increasing distance.  If locks are given,
+   * the links of each node are copied under its lock.
+   */
+  template<typename VecType>
+  void SearchLayer(const VecType& query,
+                   std::vector<Candidate>& candidates,
+                   const size_t ef,
+                   const size_t layer,
+                   VisitedSet& visited,
+                   std::mutex* locks);
+
+  /**
+   * Search the graph for the ef nearest neighbors of the query, and store
+   * them in the given candidates, sorted by increasing distance.
+   */
+  template<typename VecType>
+  void SearchGraph(const VecType& query,
+                   const size_t ef,
+                   VisitedSet& visited,
+                   std::vector<Candidate>& candidates);
+
+  /**
+   * Select the links of a node among the given candidates, sorted by
+   * increasing distance to the node.  A candidate is kept only if it is closer
+   * to the node than to every candidate kept before it, so that the links
+   * point in diverse directions.
+   */
+  void SelectNeighbors(const std::vector<Candidate>& candidates,
+                       const size_t maxNeighbors,
+                       std::vector<size_t>& neighbors);
+
+  //! Insert the given point into the graph.
+  void Insert(const size_t point,
+              VisitedSet& visited,
+              std::mutex* locks,
+              std::mutex& entryLock);
+
+  //! Reference dataset.
+  MatType referenceSet;
+  //! The links of each point on each of its layers.
+  std::vector<std::vector<std::vector<size_t>>> graph;
+  //! The number of links of each node on the upper layers.
+  size_t m;
+  //! The number of candidates considered when a point is inserted.
+  size_t efConstruction;
+  //! The number of candidates considered by searches.
+  size_t efSearch;
+  //! The index of the top layer of the graph.
+  size_t maxLevel;
+  //! The point searches start from; it is a node of the top layer.
+  size_t entryPoint;
+  //! The instantiated metric.
+  MetricType metric;
+}; // class HNSWSearch
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
@@ -0,0 +1,427 @@
+/**
+ * @file hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+#include <memory>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(MatType referenceSet,
+                                            const size_t m,
+                                            const size_t efConstruction,
+                                            const size_t efSearch,
+                                            const MetricType metric) :
+    m(m),
+    efConstruction(efConstruction),
+    efSearch(efSearch),
+    maxLevel(0),
+    entryPoint(0),
+    metric(metric)
+{
+  Train(std::move(referenceSet), m, efConstruction);
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch() :
+    m(16),
+    efConstruction(200),
+    efSearch(50),
+    maxLevel(0),
+    entryPoint(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Train(MatType referenceSetIn,
+                                            const size_t mIn,
+                                            const size_t efConstructionIn)
+{
+  if (referenceSetIn.n_cols == 0)
+  {
+    throw std::invalid_argument("HNSWSearch::Train(): the reference set must "
+        "not be empty");
+  }
+  if (mIn < 2)
+  {
+    throw std::invalid_argument("HNSWSearch::Train(): the number of links per "
+        "node must be at least 2");
+  }
+
+  referenceSet = std::move(referenceSetIn);
+  m = mIn;
+  efConstruction = std::max(efConstructionIn, m);
+
+  // Draw the top layer of each point; the probability that a point is a node
+  // of layer l is m^-l.
+  const size_t numPoints = referenceSet.n_cols;
+  const double levelMultiplier = 1.0 / std::log((double) m);
+  graph.clear();
+  graph.resize(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    const size_t level = (size_t) (-std::log(1.0 - math::Random()) *
+        levelMultiplier);
+    graph[i].resize(level + 1);
+  }
+
+  // The first point is inserted alone, and the others are inserted in parallel.
+  entryPoint = 0;
+  maxLevel = Level(0);
+
+  std::unique_ptr<std::mutex[]> locks(new std::mutex[numPoints]);
+  std::mutex entryLock;
+
+  #pragma omp parallel
+  {
+    VisitedSet visited(numPoints);
+
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t i = 1; i < (omp_size_t) numPoints; ++i)
+      Insert((size_t) i, visited, locks.get(), entryLock);
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const MatType& querySet,
+                                             const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::Mat<ElemType>& distances)
+{
+  if (k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  const size_t ef = std::max(efSearch, k);
+
+  #pragma omp parallel
+  {
+    VisitedSet visited(referenceSet.n_cols);
+    std::vector<Candidate> candidates;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      SearchGraph(querySet.col(i), ef, visited, candidates);
+
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (j < candidates.size())
+        {
+          neighbors(j, i) = candidates[j].second;
+          distances(j, i) = candidates[j].first;
+        }
+        else
+        {
+          neighbors(j, i) = referenceSet.n_cols;
+          distances(j, i) = std::numeric_limits<ElemType>::max();
+        }
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::Mat<ElemType>& distances)
+{
+  if (k >= referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points (and each point is not its own neighbor)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, referenceSet.n_cols);
+  distances.set_size(k, referenceSet.n_cols);
+  const size_t ef = std::max(efSearch, k + 1);
+
+  #pragma omp parallel
+  {
+    VisitedSet visited(referenceSet.n_cols);
+    std::vector<Candidate> candidates;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+    {
+      SearchGraph(referenceSet.col(i), ef, visited, candidates);
+
+      // Skip the point itself (which is almost always the first candidate).
+      size_t j = 0;
+      for (size_t c = 0; c < candidates.size() && j < k; ++c)
+      {
+        if (candidates[c].second == (size_t) i)
+          continue;
+
+        neighbors(j, i) = candidates[c].second;
+        distances(j, i) = candidates[c].first;
+        ++j;
+      }
+
+      for (; j < k; ++j)
+      {
+        neighbors(j, i) = referenceSet.n_cols;
+        distances(j, i) = std::numeric_limits<ElemType>::max();
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+double HNSWSearch<MetricType, MatType>::ComputeRecall(
+    const arma::Mat<size_t>& foundNeighbors,
+    const arma::Mat<size_t>& realNeighbors)
+{
+  if (foundNeighbors.n_rows != realNeighbors.n_rows ||
+      foundNeighbors.n_cols != realNeighbors.n_cols)
+    throw std::invalid_argument("HNSWSearch::ComputeRecall(): matrices "
+        "provided must have equal size");
+
+  const size_t queries = foundNeighbors.n_cols;
+  const size_t neighbors = foundNeighbors.n_rows; // Should be equal to k.
+
+  // The recall is the set intersection of found and real neighbors.
+  size_t found = 0;
+  for (size_t col = 0; col < queries; ++col)
+    for (size_t row = 0; row < neighbors; ++row)
+      for (size_t nei = 0; nei < realNeighbors.n_rows; ++nei)
+        if (realNeighbors(row, col) == foundNeighbors(nei, col))
+        {
+          found++;
+          break;
+        }
+
+  return ((double) found) / realNeighbors.n_elem;
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchLayer(
+    const VecType& query,
+    std::vector<Candidate>& candidates,
+    const size_t ef,
+    const size_t layer,
+    VisitedSet& visited,
+    std::mutex* locks)
+{
+  // The candidates still to be expanded, closest first, and the ef closest
+  // points found, farthest first.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> toExpand;
+  std::priority_queue<Candidate> found;
+
+  visited.Clear();
+  for (size_t i = 0; i < candidates.size(); ++i)
+  {
+    visited.Visit(candidates[i].second);
+    toExpand.push(candidates[i]);
+    found.push(candidates[i]);
+    if (found.size() > ef)
+      found.pop();
+  }
+
+  std::vector<size_t> linksCopy;
+  while (!toExpand.empty())
+  {
+    const Candidate current = toExpand.top();
+    if (found.size() >= ef && current.first > found.top().first)
+      break;
+    toExpand.pop();
+
+    // During construction, other threads may be modifying the links.
+    const std::vector<size_t>* links = &graph[current.second][layer];
+    if (locks)
+    {
+      std::lock_guard<std::mutex> lock(locks[current.second]);
+      linksCopy = *links;
+      links = &linksCopy;
+    }
+
+    for (size_t i = 0; i < links->size(); ++i)
+    {
+      const size_t neighbor = (*links)[i];
+      if (!visited.Visit(neighbor))
+        continue;
+
+      const ElemType distance = metric.Evaluate(query,
+          referenceSet.col(neighbor));
+      if (found.size() < ef || distance < found.top().first)
+      {
+        toExpand.push(Candidate(distance, neighbor));
+        found.push(Candidate(distance, neighbor));
+        if (found.size() > ef)
+          found.pop();
+      }
+    }
+  }
+
+  candidates.resize(found.size());
+  for (size_t i = found.size(); i > 0; --i)
+  {
+    candidates[i - 1] = found.top();
+    found.pop();
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchGraph(
+    const VecType& query,
+    const size_t ef,
+    VisitedSet& visited,
+    std::vector<Candidate>& candidates)
+{
+  // Descend greedily to the bottom layer, and search it with a beam of ef
+  // candidates.
+  candidates.assign(1, Candidate(metric.Evaluate(query,
+      referenceSet.col(entryPoint)), entryPoint));
+  for (size_t layer = maxLevel; layer > 0; --layer)
+    SearchLayer(query, candidates, 1, layer, visited, NULL);
+
+  SearchLayer(query, candidates, ef, 0, visited, NULL);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    const size_t maxNeighbors,
+    std::vector<size_t>& neighbors)
+{
+  neighbors.clear();
+  for (size_t i = 0; i < candidates.size() &&
+      neighbors.size() < maxNeighbors; ++i)
+  {
+    bool keep = true;
+    for (size_t j = 0; j < neighbors.size(); ++j)
+    {
+      if (metric.Evaluate(referenceSet.col(candidates[i].second),
+          referenceSet.col(neighbors[j])) < candidates[i].first)
+      {
+        keep = false;
+        break;
+      }
+    }
+
+    if (keep)
+      neighbors.push_back(candidates[i].second);
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Insert(const size_t point,
+                                             VisitedSet& visited,
+                                             std::mutex* locks,
+                                             std::mutex& entryLock)
+{
+  // A point that becomes the new entry point holds the entry lock until it is
+  // linked, so it is never reached before it has links.  This is rare, since
+  // only one point in m reaches each new layer.
+  std::unique_lock<std::mutex> entry(entryLock);
+  const size_t start = entryPoint;
+  const size_t top = maxLevel;
+  const size_t level = Level(point);
+  if (level <= top)
+    entry.unlock();
+
+  const auto query = referenceSet.col(point);
+  std::vector<Candidate> candidates(1, Candidate(metric.Evaluate(query,
+      referenceSet.col(start)), start));
+  for (size_t layer = top; layer > level; --layer)
+    SearchLayer(query, candidates, 1, layer, visited, locks);
+
+  std::vector<size_t> links;
+  std::vector<Candidate> neighborCandidates;
+  for (size_t layer = std::min(level, top) + 1; layer > 0; --layer)
+  {
+    const size_t l = layer - 1;
+    const size_t maxLinks = (l == 0) ? 2 * m : m;
+
+    SearchLayer(query, candidates, efConstruction, l, visited, locks);
+    SelectNeighbors(candidates, m, links);
+    {
+      std::lock_guard<std::mutex> lock(locks[point]);
+      graph[point][l] = links;
+    }
+
+    // Link the neighbors back to the point, reselecting the links of those
+    // that have too many.
+    for (size_t i = 0; i < links.size(); ++i)
+    {
+      const size_t neighbor = links[i];
+      std::lock_guard<std::mutex> lock(locks[neighbor]);
+      std::vector<size_t>& neighborLinks = graph[neighbor][l];
+      neighborLinks.push_back(point);
+      if (neighborLinks.size() <= maxLinks)
+        continue;
+
+      neighborCandidates.resize(neighborLinks.size());
+      for (size_t j = 0; j < neighborLinks.size(); ++j)
+      {
+        neighborCandidates[j] = Candidate(metric.Evaluate(
+            referenceSet.col(neighbor), referenceSet.col(neighborLinks[j])),
+            neighborLinks[j]);
+      }
+      std::sort(neighborCandidates.begin(), neighborCandidates.end());
+      SelectNeighbors(neighborCandidates, maxLinks, neighborLinks);
+    }
+  }
+
+  if (level > top)
+  {
+    entryPoint = point;
+    maxLevel = level;
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  ar & BOOST_SERIALIZATION_NVP(graph);
+  ar & BOOST_SERIALIZATION_NVP(m);
+  ar & BOOST_SERIALIZATION_NVP(efConstruction);
+  ar & BOOST_SERIALIZATION_NVP(efSearch);
+  ar & BOOST_SERIALIZATION_NVP(maxLevel);
+  ar & BOOST_SERIALIZATION_NVP(entryPoint);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -106,6 +106,12 @@ class BinaryNumericSplit
   //! The probability of the majority class given the points seen so far.
   double MajorityProbability() const;
 
+  /**
+   * Get the approximate number of bytes of memory used by this object; this
+   * grows with the number of points seen, since all of them are stored.
+   */
+  size_t MemoryUsage() const;
+
   //! Serialize the object.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
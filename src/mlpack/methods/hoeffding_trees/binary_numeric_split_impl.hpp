@@ -168,6 +168,18 @@ double BinaryNumericSplit<FitnessFunction, ObservationType>::
   return double(arma::max(classCounts)) / double(arma::accu(classCounts));
 }
 
+template<typename FitnessFunction, typename ObservationType>
+size_t BinaryNumericSplit<FitnessFunction, ObservationType>::MemoryUsage()
+    const
+{
+  // Each element of the multimap is a tree node with three pointers and a
+  // color besides the element itself.
+  const size_t nodeSize = sizeof(std::pair<const ObservationType, size_t>) +
+      4 * sizeof(void*);
+  return sizeof(*this) + sortedElements.size() * nodeSize +
+      classCounts.n_elem * sizeof(size_t);
+}
+
 template<typename FitnessFunction, typename ObservationType>
 template<typename Archive>
 void BinaryNumericSplit<FitnessFunction, ObservationType>::serialize(
@@ -106,6 +106,12 @@ class HoeffdingCategoricalSplit
   //! Get the probability of the majority class given the points seen so far.
   double MajorityProbability() const;
 
+  //! Get the approximate number of bytes of memory used by this object.
+  size_t MemoryUsage() const
+  {
+    return sizeof(*this) + sufficientStatistics.n_elem * sizeof(size_t);
+  }
+
   //! Serialize the categorical split.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */)
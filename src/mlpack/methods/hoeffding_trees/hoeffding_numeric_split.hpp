@@ -116,6 +116,9 @@ class HoeffdingNumericSplit
   //! Return the probability of the majority class.
   double MajorityProbability() const;
 
+  //! Return the approximate number of bytes of memory used by this object.
+  size_t MemoryUsage() const;
+
   //! Return the number of bins.
   size_t Bins() const { return bins; }
 
@@ -124,7 +127,8 @@ class HoeffdingNumericSplit
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
-  //! Before binning, this holds the points we have seen so far.
+  //! Before binning, this holds the points we have seen so far.  It is only
+  //! allocated once the first point is seen, and freed after binning.
   arma::Col<ObservationType> observations;
   //! This holds the labels of the points before binning.
   arma::Col<size_t> labels;
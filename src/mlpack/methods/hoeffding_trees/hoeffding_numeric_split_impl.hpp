@@ -22,30 +22,24 @@ HoeffdingNumericSplit<FitnessFunction, ObservationType>::HoeffdingNumericSplit(
     const size_t numClasses,
     const size_t bins,
     const size_t observationsBeforeBinning) :
-    observations(observationsBeforeBinning - 1),
-    labels(observationsBeforeBinning - 1),
     bins(bins),
     observationsBeforeBinning(observationsBeforeBinning),
     samplesSeen(0),
     sufficientStatistics(arma::zeros<arma::Mat<size_t>>(numClasses, bins))
 {
-  observations.zeros();
-  labels.zeros();
+  // The observations are allocated when the first point is seen.
 }
 
 template<typename FitnessFunction, typename ObservationType>
 HoeffdingNumericSplit<FitnessFunction, ObservationType>::HoeffdingNumericSplit(
     const size_t numClasses,
     const HoeffdingNumericSplit& other) :
-    observations(other.observationsBeforeBinning - 1),
-    labels(other.observationsBeforeBinning - 1),
     bins(other.bins),
     observationsBeforeBinning(other.observationsBeforeBinning),
     samplesSeen(0),
     sufficientStatistics(arma::zeros<arma::Mat<size_t>>(numClasses, bins))
 {
-  observations.zeros();
-  labels.zeros();
+  // The observations are allocated when the first point is seen.
 }
 
 template<typename FitnessFunction, typename ObservationType>
@@ -55,6 +49,14 @@ void HoeffdingNumericSplit<FitnessFunction, ObservationType>::Train(
 {
   if (samplesSeen < observationsBeforeBinning - 1)
   {
+    // Allocate the observations only when they are needed, so that splits that
+    // have not seen any points (or are only used to hold parameters) are small.
+    if (samplesSeen == 0)
+    {
+      observations.zeros(observationsBeforeBinning - 1);
+      labels.zeros(observationsBeforeBinning - 1);
+    }
+
     // Add this to the samples we have seen.
     observations[samplesSeen] = value;
     labels[samplesSeen] = label;
@@ -92,6 +94,10 @@ void HoeffdingNumericSplit<FitnessFunction, ObservationType>::Train(
 
       sufficientStatistics(labels[i], bin)++;
     }
+
+    // The observations are not needed anymore.
+    observations.reset();
+    labels.reset();
   }
 
   // If we've gotten to here, then we need to add the point to the sufficient
@@ -186,6 +192,15 @@ double HoeffdingNumericSplit<FitnessFunction, ObservationType>::
   }
 }
 
+template<typename FitnessFunction, typename ObservationType>
+size_t HoeffdingNumericSplit<FitnessFunction, ObservationType>::MemoryUsage()
+    const
+{
+  return sizeof(*this) +
+      (observations.n_elem + splitPoints.n_elem) * sizeof(ObservationType) +
+      (labels.n_elem + sufficientStatistics.n_elem) * sizeof(size_t);
+}
+
 template<typename FitnessFunction, typename ObservationType>
 template<typename Archive>
 void HoeffdingNumericSplit<FitnessFunction, ObservationType>::serialize(
@@ -48,6 +48,22 @@ namespace tree {
  * are handled.  As far as the actual splitting goes, the meat of the splitting
  * procedure will be contained in those two classes.
  *
+ * Every leaf keeps the statistics of a split for every dimension, so the memory
+ * of the tree grows with the number of leaves.  As in the VFDT paper, a memory
+ * budget can be set with MaxMemory(): in streaming mode, every checkInterval
+ * samples, the leaves are ranked by how promising they are (the number of
+ * training points they misclassified), and as many of the most promising
+ * leaves as fit in the budget keep their statistics.  The other leaves are
+ * deactivated: their statistics are freed and they only count the classes of
+ * their points, to keep predicting their majority class.  A deactivated leaf is
+ * reactivated, with fresh statistics, when it becomes promising enough.  With
+ * DropPoorAttributes(), a leaf also frees the statistics of any dimension whose
+ * gain is worse than the best gain by more than the Hoeffding bound, and stops
+ * considering that dimension for its split.
+ *
+ * NumericSplitType and CategoricalSplitType must provide MemoryUsage(), which
+ * returns the approximate number of bytes of memory used by the split.
+ *
  * @tparam FitnessFunction Fitness function to use.
  * @tparam NumericSplitType Technique for splitting numeric features.
  * @tparam CategoricalSplitType Technique for splitting categorical features.
@@ -87,6 +103,14 @@ class HoeffdingTree
    *      in batch training mode.
    * @param minSamples If the node has seen this many points or fewer, no split
    *      will be allowed.
+   * @param categoricalSplitIn Split object to take the parameters of the
+   *      categorical splits from.
+   * @param numericSplitIn Split object to take the parameters of the numeric
+   *      splits from.
+   * @param maxMemory Maximum number of bytes of memory for the tree, enforced
+   *      by deactivating leaves in streaming mode (0 means no limit).
+   * @param dropPoorAttributes Whether the leaves drop the dimensions that can't
+   *      be the best split.
    */
   template<typename MatType>
   HoeffdingTree(const MatType& data,
@@ -101,7 +125,9 @@ class HoeffdingTree
                 const CategoricalSplitType<FitnessFunction>& categoricalSplitIn
                     = CategoricalSplitType<FitnessFunction>(0, 0),
                 const NumericSplitType<FitnessFunction>& numericSplitIn =
-                    NumericSplitType<FitnessFunction>(0));
+                    NumericSplitType<FitnessFunction>(0),
+                const size_t maxMemory = 0,
+                const bool dropPoorAttributes = false);
 
   /**
    * Construct the Hoeffding tree with the given parameters, but training on no
@@ -156,7 +182,10 @@ class HoeffdingTree
 
   /**
    * Train on a set of points, either in streaming mode or in batch mode, with
-   * the given labels.
+   * the given labels.  In streaming mode, the points are trained on as one
+   * mini-batch: each leaf takes all of its points up to its next split check
+   * at once, and updates the statistics of the dimensions in parallel.  The
+   * resulting tree is the same as when training on each point in turn.
    *
    * @param data Data points to train on.
    * @param label Labels of data points.
@@ -234,6 +263,27 @@ class HoeffdingTree
   //! Modify the number of samples before a split check is performed.
   void CheckInterval(const size_t checkInterval);
 
+  //! Get the maximum number of bytes of memory for the tree (0 if unlimited).
+  size_t MaxMemory() const { return maxMemory; }
+  //! Modify the maximum number of bytes of memory for the tree.
+  void MaxMemory(const size_t maxMemory);
+
+  //! Get whether the leaves drop the dimensions that can't be the best split.
+  bool DropPoorAttributes() const { return dropPoorAttributes; }
+  //! Modify whether the leaves drop the dimensions that can't be the best
+  //! split.
+  void DropPoorAttributes(const bool dropPoorAttributes);
+
+  //! Get whether this leaf keeps its split statistics (false if it has been
+  //! deactivated to stay within the memory budget).
+  bool Active() const { return active; }
+
+  /**
+   * Get the approximate number of bytes of memory used by this node and all of
+   * its descendants, including the statistics of the leaves.
+   */
+  size_t MemoryUsage() const;
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -305,9 +355,56 @@ class HoeffdingTree
 
   //! Serialize the split.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
+  /**
+   * Train on the points of the given dataset with the given indices, in that
+   * order, in streaming mode.
+   *
+   * @param data Dataset holding the points to train on.
+   * @param labels Labels of the points of the dataset.
+   * @param indices Indices of the points to train on.
+   */
+  template<typename MatType>
+  void TrainPoints(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const std::vector<size_t>& indices);
+
+  /**
+   * Train this leaf on a single point in streaming mode.
+   *
+   * @param point Point to train on.
+   * @param label Label of point to train on.
+   */
+  template<typename VecType>
+  void TrainLeaf(const VecType& point, const size_t label);
+
+  //! Set the majority class and its probability from the class counts.
+  void UpdateMajorityClass();
+
+  //! Return the number of bytes of memory used by the splits of this leaf.
+  size_t SplitsMemoryUsage() const;
+
+  /**
+   * Free the statistics of this leaf, keeping only one split object of each
+   * type (without any statistics) to hold the parameters of the splits.
+   */
+  void Deactivate();
+
+  //! Create fresh statistics for every dimension of a deactivated leaf.
+  void Reactivate();
+
+  /**
+   * Count the samples seen since the last memory check, and if there have been
+   * checkInterval of them, deactivate and reactivate leaves so that the tree
+   * stays within maxMemory.  This is called on the node that training was
+   * called on.
+   *
+   * @param samples Number of samples just trained on.
+   */
+  void CheckMemory(const size_t samples);
+
   // We need to keep some information for before we have split.
 
   //! Information for splitting of numeric features (used before split).
@@ -336,6 +433,23 @@ class HoeffdingTree
   bool ownsInfo;
   //! The required probability of success for a split to be performed.
   double successProbability;
+  //! The maximum number of bytes of memory for the tree (0 if unlimited).
+  size_t maxMemory;
+  //! Whether leaves drop the dimensions that can't be the best split.
+  bool dropPoorAttributes;
+
+  //! The number of points of each class this node has seen (used before
+  //! split).
+  arma::Col<size_t> classCounts;
+  //! Whether the split statistics of this leaf are kept.
+  bool active;
+  //! Whether each dimension has been dropped by this leaf (used before split).
+  std::vector<bool> droppedDimensions;
+  //! The memory used by the splits of this leaf, updated when there is a
+  //! memory budget.
+  size_t splitsMemory;
+  //! The number of samples trained on since the last memory check.
+  size_t samplesSinceMemoryCheck;
 
   // And we need to keep some information for after we have split.
 
@@ -357,6 +471,26 @@ class HoeffdingTree
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the HoeffdingTree class.  Version 1 stores
+//! the class counts and the memory budget.  (BOOST_TEMPLATE_CLASS_VERSION()
+//! can't be used, since the template has three parameters.)
+namespace boost {
+namespace serialization {
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+struct version<mlpack::tree::HoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 #include "hoeffding_tree_impl.hpp"
 
 #endif
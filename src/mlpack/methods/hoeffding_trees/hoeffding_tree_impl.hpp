@@ -15,6 +15,9 @@
 // In case it hasn't been included yet.
 #include "hoeffding_tree.hpp"
 #include <stack>
+#include <algorithm>
+#include <functional>
+#include <mlpack/core/util/parallel_blocks.hpp>
 
 namespace mlpack {
 namespace tree {
@@ -38,7 +41,9 @@ HoeffdingTree<
                  const size_t minSamples,
                  const CategoricalSplitType<FitnessFunction>&
                      categoricalSplitIn,
-                 const NumericSplitType<FitnessFunction>& numericSplitIn) :
+                 const NumericSplitType<FitnessFunction>& numericSplitIn,
+                 const size_t maxMemory,
+                 const bool dropPoorAttributes) :
     dimensionMappings(new std::unordered_map<size_t,
         std::pair<size_t, size_t>>()),
     ownsMappings(true),
@@ -50,6 +55,13 @@ HoeffdingTree<
     datasetInfo(new data::DatasetInfo(datasetInfo)),
     ownsInfo(true),
     successProbability(successProbability),
+    maxMemory(maxMemory),
+    dropPoorAttributes(dropPoorAttributes),
+    classCounts(arma::zeros<arma::Col<size_t>>(numClasses)),
+    active(true),
+    droppedDimensions(datasetInfo.Dimensionality(), false),
+    splitsMemory(0),
+    samplesSinceMemoryCheck(0),
     splitDimension(size_t(-1)),
     categoricalSplit(0),
     numericSplit()
@@ -73,6 +85,9 @@ HoeffdingTree<
     }
   }
 
+  if (maxMemory != 0)
+    splitsMemory = SplitsMemoryUsage();
+
   // Now train.
   Train(data, labels, batchTraining);
 }
@@ -106,6 +121,13 @@ HoeffdingTree<
     datasetInfo(new data::DatasetInfo(datasetInfo)),
     ownsInfo(true),
     successProbability(successProbability),
+    maxMemory(0),
+    dropPoorAttributes(false),
+    classCounts(arma::zeros<arma::Col<size_t>>(numClasses)),
+    active(true),
+    droppedDimensions(datasetInfo.Dimensionality(), false),
+    splitsMemory(0),
+    samplesSinceMemoryCheck(0),
     splitDimension(size_t(-1)),
     categoricalSplit(0),
     numericSplit()
@@ -168,6 +190,11 @@ HoeffdingTree<
     datasetInfo(new data::DatasetInfo()),
     ownsInfo(true),
     successProbability(0.95),
+    maxMemory(0),
+    dropPoorAttributes(false),
+    active(true),
+    splitsMemory(0),
+    samplesSinceMemoryCheck(0),
     splitDimension(size_t(-1)),
     categoricalSplit(0),
     numericSplit()
@@ -194,6 +221,13 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     datasetInfo(new data::DatasetInfo(*other.datasetInfo)),
     ownsInfo(true),
     successProbability(other.successProbability),
+    maxMemory(other.maxMemory),
+    dropPoorAttributes(other.dropPoorAttributes),
+    classCounts(other.classCounts),
+    active(other.active),
+    droppedDimensions(other.droppedDimensions),
+    splitsMemory(other.splitsMemory),
+    samplesSinceMemoryCheck(other.samplesSinceMemoryCheck),
     splitDimension(other.splitDimension),
     majorityClass(other.majorityClass),
     majorityProbability(other.majorityProbability),
@@ -239,8 +273,10 @@ void HoeffdingTree<
     // Don't split if there are fewer than five points.
     size_t oldMaxSamples = maxSamples;
     maxSamples = std::max(size_t(data.n_cols - 1), size_t(5));
+    std::vector<size_t> indices(data.n_cols);
     for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+      indices[i] = i;
+    TrainPoints(data, labels, indices);
     maxSamples = oldMaxSamples;
 
     // Now, if we did split, find out which points go to which child, and
@@ -289,14 +325,146 @@ void HoeffdingTree<
       }
     }
   }
-  else
+  else if (maxMemory == 0)
   {
-    // We aren't training in batch mode; loop through the points.
+    // We aren't training in batch mode, so the points are streamed, but as a
+    // mini-batch: this gives the same tree as training on each point in turn.
+    std::vector<size_t> indices(data.n_cols);
     for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+      indices[i] = i;
+    TrainPoints(data, labels, indices);
+  }
+  else
+  {
+    // With a memory budget, the mini-batch is cut at each memory check.
+    size_t begin = 0;
+    while (begin < data.n_cols)
+    {
+      const size_t count = std::min((samplesSinceMemoryCheck < checkInterval) ?
+          checkInterval - samplesSinceMemoryCheck : 1, data.n_cols - begin);
+      std::vector<size_t> indices(count);
+      for (size_t i = 0; i < count; ++i)
+        indices[i] = begin + i;
+      TrainPoints(data, labels, indices);
+      CheckMemory(count);
+      begin += count;
+    }
   }
 }
 
+//! Stream a mini-batch of points through the tree.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainPoints(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const std::vector<size_t>& indices)
+{
+  size_t next = 0;
+  if (splitDimension == size_t(-1) && !active)
+  {
+    // A deactivated leaf only counts the classes, to keep its majority class.
+    for (size_t j = 0; j < indices.size(); ++j)
+      ++classCounts[labels[indices[j]]];
+    UpdateMajorityClass();
+    return;
+  }
+
+  if (splitDimension == size_t(-1))
+  {
+    // Find the split object of each dimension.
+    const size_t dimensionality = data.n_rows;
+    std::vector<size_t> types(dimensionality);
+    std::vector<size_t> splitIndices(dimensionality);
+    size_t numericIndex = 0;
+    size_t categoricalIndex = 0;
+    for (size_t i = 0; i < dimensionality; ++i)
+    {
+      types[i] = datasetInfo->Type(i);
+      if (types[i] == data::Datatype::categorical)
+        splitIndices[i] = categoricalIndex++;
+      else if (types[i] == data::Datatype::numeric)
+        splitIndices[i] = numericIndex++;
+    }
+
+    while (next < indices.size() && splitDimension == size_t(-1))
+    {
+      // Take all the points up to the next split check.  Nothing that depends
+      // on the statistics is used before then, so the points can be given to
+      // each dimension in turn instead of one at a time; the statistics of a
+      // dimension then stay in cache for the whole chunk, and the dimensions
+      // are independent, so they are updated in parallel.
+      const size_t chunk = std::min(checkInterval - (numSamples %
+          checkInterval), indices.size() - next);
+
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) dimensionality; ++i)
+      {
+        if (droppedDimensions[i])
+          continue;
+
+        if (types[i] == data::Datatype::categorical)
+        {
+          CategoricalSplitType<FitnessFunction>& split =
+              categoricalSplits[splitIndices[i]];
+          for (size_t j = next; j < next + chunk; ++j)
+            split.Train(data(i, indices[j]), labels[indices[j]]);
+        }
+        else if (types[i] == data::Datatype::numeric)
+        {
+          NumericSplitType<FitnessFunction>& split =
+              numericSplits[splitIndices[i]];
+          for (size_t j = next; j < next + chunk; ++j)
+            split.Train(data(i, indices[j]), labels[indices[j]]);
+        }
+      }
+
+      for (size_t j = next; j < next + chunk; ++j)
+        ++classCounts[labels[indices[j]]];
+      UpdateMajorityClass();
+
+      numSamples += chunk;
+      next += chunk;
+      if (maxMemory != 0)
+        splitsMemory = SplitsMemoryUsage();
+
+      // Check for a split, if we should.
+      if (numSamples % checkInterval == 0)
+      {
+        const size_t numChildren = SplitCheck();
+        if (numChildren > 0)
+        {
+          // We need to add a bunch of children.
+          // Delete children, if we have them.
+          children.clear();
+          CreateChildren();
+        }
+      }
+    }
+  }
+
+  if (next == indices.size())
+    return;
+
+  // Already split.  Pass the rest of the points to the relevant children, in
+  // the same order.
+  std::vector<std::vector<size_t>> childIndices(children.size());
+  for (size_t j = next; j < indices.size(); ++j)
+  {
+    const size_t direction = CalculateDirection(data.col(indices[j]));
+    childIndices[direction].push_back(indices[j]);
+  }
+
+  for (size_t i = 0; i < children.size(); ++i)
+    if (childIndices[i].size() > 0)
+      children[i]->TrainPoints(data, labels, childIndices[i]);
+}
+
 //! Train on a set of points.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -344,6 +512,12 @@ void HoeffdingTree<
     }
   }
 
+  classCounts.zeros(numClasses);
+  active = true;
+  droppedDimensions.assign(datasetInfo->Dimensionality(), false);
+  if (maxMemory != 0)
+    splitsMemory = SplitsMemoryUsage();
+
   // Remove any old children.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -364,50 +538,69 @@ void HoeffdingTree<
     CategoricalSplitType
 >::Train(const VecType& point, const size_t label)
 {
-  if (splitDimension == size_t(-1))
-  {
-    ++numSamples;
-    size_t numericIndex = 0;
-    size_t categoricalIndex = 0;
-    for (size_t i = 0; i < point.n_rows; ++i)
-    {
-      if (datasetInfo->Type(i) == data::Datatype::categorical)
-        categoricalSplits[categoricalIndex++].Train(point[i], label);
-      else if (datasetInfo->Type(i) == data::Datatype::numeric)
-        numericSplits[numericIndex++].Train(point[i], label);
-    }
+  // Pass the training point down to the leaf it falls into.
+  HoeffdingTree* node = this;
+  while (node->splitDimension != size_t(-1))
+    node = node->children[node->CalculateDirection(point)];
+
+  node->TrainLeaf(point, label);
+
+  if (maxMemory != 0)
+    CheckMemory(1);
+}
+
+//! Train a leaf on one point.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename VecType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainLeaf(const VecType& point, const size_t label)
+{
+  ++classCounts[label];
+  UpdateMajorityClass();
 
-    // Grab majority class from splits.
-    if (categoricalSplits.size() > 0)
+  // A deactivated leaf only counts the classes.
+  if (!active)
+    return;
+
+  ++numSamples;
+  size_t numericIndex = 0;
+  size_t categoricalIndex = 0;
+  for (size_t i = 0; i < point.n_rows; ++i)
+  {
+    if (datasetInfo->Type(i) == data::Datatype::categorical)
     {
-      majorityClass = categoricalSplits[0].MajorityClass();
-      majorityProbability = categoricalSplits[0].MajorityProbability();
+      if (!droppedDimensions[i])
+        categoricalSplits[categoricalIndex].Train(point[i], label);
+      ++categoricalIndex;
     }
-    else
+    else if (datasetInfo->Type(i) == data::Datatype::numeric)
     {
-      majorityClass = numericSplits[0].MajorityClass();
-      majorityProbability = numericSplits[0].MajorityProbability();
+      if (!droppedDimensions[i])
+        numericSplits[numericIndex].Train(point[i], label);
+      ++numericIndex;
     }
+  }
 
-    // Check for a split, if we should.
-    if (numSamples % checkInterval == 0)
+  if (maxMemory != 0)
+    splitsMemory = SplitsMemoryUsage();
+
+  // Check for a split, if we should.
+  if (numSamples % checkInterval == 0)
+  {
+    const size_t numChildren = SplitCheck();
+    if (numChildren > 0)
     {
-      const size_t numChildren = SplitCheck();
-      if (numChildren > 0)
-      {
-        // We need to add a bunch of children.
-        // Delete children, if we have them.
-        children.clear();
-        CreateChildren();
-      }
+      // We need to add a bunch of children.
+      // Delete children, if we have them.
+      children.clear();
+      CreateChildren();
     }
   }
-  else
-  {
-    // Already split.  Pass the training point to the relevant child.
-    size_t direction = CalculateDirection(point);
-    children[direction]->Train(point, label);
-  }
 }
 
 template<typename FitnessFunction,
@@ -419,8 +612,8 @@ size_t HoeffdingTree<
     CategoricalSplitType
 >::SplitCheck()
 {
-  // Do nothing if we've already split.
-  if (splitDimension != size_t(-1))
+  // Do nothing if we've already split, or if this leaf has no statistics.
+  if (splitDimension != size_t(-1) || !active)
     return 0;
 
   // If not enough points have been seen, we cannot split.
@@ -435,24 +628,39 @@ size_t HoeffdingTree<
   const double epsilon = std::sqrt(rSquared *
       std::log(1.0 / (1.0 - successProbability)) / (2 * numSamples));
 
-  // Find the best and second best possible splits.
-  double largest = -DBL_MAX;
-  size_t largestIndex = 0;
-  double secondLargest = -DBL_MAX;
-  for (size_t i = 0; i < categoricalSplits.size() + numericSplits.size(); ++i)
+  // Evaluate the splits of every dimension in parallel.  Some split procedures
+  // can split multiple ways, but we only care about the best two splits that
+  // can be done in every network.
+  const size_t numDimensions = categoricalSplits.size() + numericSplits.size();
+  arma::vec bestGains(numDimensions, arma::fill::zeros);
+  arma::vec secondBestGains(numDimensions, arma::fill::zeros);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numDimensions; ++i)
   {
-    size_t type = dimensionMappings->at(i).first;
-    size_t index = dimensionMappings->at(i).second;
+    // A dropped dimension has no statistics, so it has no gain.
+    if (droppedDimensions[i])
+      continue;
+
+    const size_t type = dimensionMappings->at(i).first;
+    const size_t index = dimensionMappings->at(i).second;
 
-    // Some split procedures can split multiple ways, but we only care about the
-    // best two splits that can be done in every network.
-    double bestGain = 0.0;
-    double secondBestGain = 0.0;
     if (type == data::Datatype::categorical)
-      categoricalSplits[index].EvaluateFitnessFunction(bestGain,
-          secondBestGain);
+      categoricalSplits[index].EvaluateFitnessFunction(bestGains[i],
+          secondBestGains[i]);
     else if (type == data::Datatype::numeric)
-      numericSplits[index].EvaluateFitnessFunction(bestGain, secondBestGain);
+      numericSplits[index].EvaluateFitnessFunction(bestGains[i],
+          secondBestGains[i]);
+  }
+
+  // Find the best and second best possible splits, going through the
+  // dimensions in order.
+  double largest = -DBL_MAX;
+  size_t largestIndex = 0;
+  double secondLargest = -DBL_MAX;
+  for (size_t i = 0; i < numDimensions; ++i)
+  {
+    const double bestGain = bestGains[i];
+    const double secondBestGain = secondBestGains[i];
 
     // See if these gains are better than the previous.
     if (bestGain > largest)
@@ -495,7 +703,36 @@ size_t HoeffdingTree<
   }
   else
   {
-    return 0; // Don't split.
+    // Don't split.  But a dimension whose gain is worse than the best gain by
+    // more than epsilon can't be the best split (with the required
+    // probability), so we can stop keeping statistics for it.
+    if (dropPoorAttributes)
+    {
+      for (size_t i = 0; i < numDimensions; ++i)
+      {
+        if (droppedDimensions[i] || largest - bestGains[i] <= epsilon)
+          continue;
+
+        droppedDimensions[i] = true;
+        const size_t type = dimensionMappings->at(i).first;
+        const size_t index = dimensionMappings->at(i).second;
+        if (type == data::Datatype::categorical)
+        {
+          categoricalSplits[index] = CategoricalSplitType<FitnessFunction>(0,
+              0, categoricalSplits[index]);
+        }
+        else if (type == data::Datatype::numeric)
+        {
+          numericSplits[index] = NumericSplitType<FitnessFunction>(0,
+              numericSplits[index]);
+        }
+      }
+
+      if (maxMemory != 0)
+        splitsMemory = SplitsMemoryUsage();
+    }
+
+    return 0;
   }
 }
 
@@ -563,6 +800,285 @@ void HoeffdingTree<
     children[i]->CheckInterval(checkInterval);
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::MaxMemory(const size_t maxMemory)
+{
+  this->maxMemory = maxMemory;
+  // The memory of the splits is only tracked when there is a budget.
+  if (children.size() == 0 && maxMemory != 0)
+    splitsMemory = SplitsMemoryUsage();
+  for (size_t i = 0; i < children.size(); ++i)
+    children[i]->MaxMemory(maxMemory);
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::DropPoorAttributes(const bool dropPoorAttributes)
+{
+  this->dropPoorAttributes = dropPoorAttributes;
+  for (size_t i = 0; i < children.size(); ++i)
+    children[i]->DropPoorAttributes(dropPoorAttributes);
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+size_t HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::MemoryUsage() const
+{
+  size_t memory = 0;
+  std::stack<const HoeffdingTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    const HoeffdingTree* node = stack.top();
+    stack.pop();
+    memory += sizeof(HoeffdingTree) + node->SplitsMemoryUsage() +
+        node->classCounts.n_elem * sizeof(size_t) +
+        node->children.size() * sizeof(HoeffdingTree*);
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push(&node->Child(i));
+  }
+  return memory;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::UpdateMajorityClass()
+{
+  arma::uword maxIndex = 0;
+  const size_t maxCount = classCounts.max(maxIndex);
+  majorityClass = size_t(maxIndex);
+  majorityProbability = double(maxCount) / double(arma::accu(classCounts));
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+size_t HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::SplitsMemoryUsage() const
+{
+  size_t memory = 0;
+  for (size_t i = 0; i < numericSplits.size(); ++i)
+    memory += numericSplits[i].MemoryUsage();
+  for (size_t i = 0; i < categoricalSplits.size(); ++i)
+    memory += categoricalSplits[i].MemoryUsage();
+  return memory;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Deactivate()
+{
+  // Swapping with new vectors frees the memory of the vectors too.
+  if (numericSplits.size() > 0)
+  {
+    std::vector<NumericSplitType<FitnessFunction>>(1,
+        NumericSplitType<FitnessFunction>(0, numericSplits[0])).swap(
+        numericSplits);
+  }
+  if (categoricalSplits.size() > 0)
+  {
+    std::vector<CategoricalSplitType<FitnessFunction>>(1,
+        CategoricalSplitType<FitnessFunction>(0, 0, categoricalSplits[0])).swap(
+        categoricalSplits);
+  }
+
+  // The fresh statistics of a reactivated leaf won't drop anything.
+  droppedDimensions.assign(droppedDimensions.size(), false);
+  numSamples = 0;
+  active = false;
+  splitsMemory = SplitsMemoryUsage();
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Reactivate()
+{
+  std::vector<NumericSplitType<FitnessFunction>> newNumericSplits;
+  std::vector<CategoricalSplitType<FitnessFunction>> newCategoricalSplits;
+  for (size_t i = 0; i < datasetInfo->Dimensionality(); ++i)
+  {
+    if (datasetInfo->Type(i) == data::Datatype::categorical)
+    {
+      newCategoricalSplits.push_back(CategoricalSplitType<FitnessFunction>(
+          datasetInfo->NumMappings(i), numClasses, categoricalSplits[0]));
+    }
+    else
+    {
+      newNumericSplits.push_back(NumericSplitType<FitnessFunction>(numClasses,
+          numericSplits[0]));
+    }
+  }
+
+  numericSplits.swap(newNumericSplits);
+  categoricalSplits.swap(newCategoricalSplits);
+  numSamples = 0;
+  active = true;
+  splitsMemory = SplitsMemoryUsage();
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::CheckMemory(const size_t samples)
+{
+  samplesSinceMemoryCheck += samples;
+  if (samplesSinceMemoryCheck < checkInterval)
+    return;
+  samplesSinceMemoryCheck = 0;
+
+  // Find the leaves, and the memory used by the nodes without the splits.
+  std::vector<HoeffdingTree*> leaves;
+  size_t memory = 0;
+  bool allActive = true;
+  std::stack<HoeffdingTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    HoeffdingTree* node = stack.top();
+    stack.pop();
+    memory += sizeof(HoeffdingTree) + node->classCounts.n_elem *
+        sizeof(size_t) + node->children.size() * sizeof(HoeffdingTree*);
+    if (node->children.size() == 0)
+    {
+      leaves.push_back(node);
+      allActive &= node->active;
+    }
+    for (size_t i = 0; i < node->children.size(); ++i)
+      stack.push(node->children[i]);
+  }
+
+  size_t splitsMemoryTotal = 0;
+  for (size_t i = 0; i < leaves.size(); ++i)
+    splitsMemoryTotal += leaves[i]->splitsMemory;
+
+  // Nothing to do if everything fits and no leaf is waiting to be reactivated.
+  if (allActive && memory + splitsMemoryTotal <= maxMemory)
+    return;
+
+  // The memory of the splits of a deactivated leaf, which only holds one split
+  // of each type, and the memory of fresh statistics for a reactivated leaf.
+  // All the leaves use the same parameters, so these are the same for every
+  // leaf.  (Only leaves are sure to know the number of classes, since split
+  // nodes forget it when loaded.)
+  const HoeffdingTree& leaf = *leaves[0];
+  size_t inactiveMemory = 0;
+  size_t freshMemory = 0;
+  for (size_t i = 0; i < leaf.datasetInfo->Dimensionality(); ++i)
+  {
+    if (leaf.datasetInfo->Type(i) == data::Datatype::categorical)
+    {
+      freshMemory += CategoricalSplitType<FitnessFunction>(
+          leaf.datasetInfo->NumMappings(i), leaf.numClasses,
+          leaf.categoricalSplits[0]).MemoryUsage();
+    }
+    else
+    {
+      freshMemory += NumericSplitType<FitnessFunction>(leaf.numClasses,
+          leaf.numericSplits[0]).MemoryUsage();
+    }
+  }
+  if (leaf.numericSplits.size() > 0)
+  {
+    inactiveMemory += NumericSplitType<FitnessFunction>(0,
+        leaf.numericSplits[0]).MemoryUsage();
+  }
+  if (leaf.categoricalSplits.size() > 0)
+  {
+    inactiveMemory += CategoricalSplitType<FitnessFunction>(0, 0,
+        leaf.categoricalSplits[0]).MemoryUsage();
+  }
+
+  // As in VFDT, the promise of a leaf is the number of training points it
+  // misclassified; it is high for leaves that see many points and are not
+  // sure of their class.  Going from the most promising leaf, keep (or
+  // create) the statistics of each leaf while they fit in the budget.
+  std::vector<std::pair<size_t, size_t>> promises(leaves.size());
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    const arma::Col<size_t>& counts = leaves[i]->classCounts;
+    const size_t errors = (counts.n_elem == 0) ? 0 :
+        arma::accu(counts) - counts.max();
+    promises[i] = std::make_pair(errors, leaves.size() - i);
+  }
+  std::sort(promises.begin(), promises.end(),
+      std::greater<std::pair<size_t, size_t>>());
+
+  memory += leaves.size() * inactiveMemory;
+  for (size_t i = 0; i < promises.size(); ++i)
+  {
+    HoeffdingTree* node = leaves[leaves.size() - promises[i].second];
+    const size_t activeMemory = node->active ? node->splitsMemory :
+        freshMemory;
+    const size_t extraMemory = (activeMemory > inactiveMemory) ?
+        activeMemory - inactiveMemory : 0;
+
+    if (memory + extraMemory <= maxMemory)
+    {
+      memory += extraMemory;
+      if (!node->active)
+        node->Reactivate();
+    }
+    else if (node->active)
+    {
+      node->Deactivate();
+    }
+  }
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -674,8 +1190,11 @@ void HoeffdingTree<
 >::Classify(const MatType& data, arma::Row<size_t>& predictions) const
 {
   predictions.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    predictions[i] = Classify(data.col(i));
+  util::ParallelBlocks(data.n_cols, [&](const size_t begin, const size_t end)
+  {
+    for (size_t i = begin; i <= end; ++i)
+      predictions[i] = Classify(data.col(i));
+  });
 }
 
 //! Batch classification with probabilities.
@@ -695,8 +1214,11 @@ void HoeffdingTree<
 {
   predictions.set_size(data.n_cols);
   probabilities.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    Classify(data.col(i), predictions[i], probabilities[i]);
+  util::ParallelBlocks(data.n_cols, [&](const size_t begin, const size_t end)
+  {
+    for (size_t i = begin; i <= end; ++i)
+      Classify(data.col(i), predictions[i], probabilities[i]);
+  });
 }
 
 template<
@@ -757,11 +1279,17 @@ void HoeffdingTree<
     }
 
     children[i]->MajorityClass() = childMajorities[i];
+    children[i]->dropPoorAttributes = dropPoorAttributes;
+    children[i]->MaxMemory(maxMemory);
   }
 
-  // Eliminate now-unnecessary split information.
-  numericSplits.clear();
-  categoricalSplits.clear();
+  // Eliminate now-unnecessary split information (and free the memory of the
+  // vectors too).
+  std::vector<NumericSplitType<FitnessFunction>>().swap(numericSplits);
+  std::vector<CategoricalSplitType<FitnessFunction>>().swap(categoricalSplits);
+  classCounts.reset();
+  std::vector<bool>().swap(droppedDimensions);
+  splitsMemory = 0;
 }
 
 template<
@@ -774,7 +1302,7 @@ void HoeffdingTree<
     FitnessFunction,
     NumericSplitType,
     CategoricalSplitType
->::serialize(Archive& ar, const unsigned int /* version */)
+>::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(splitDimension);
 
@@ -807,6 +1335,24 @@ void HoeffdingTree<
   ar & BOOST_SERIALIZATION_NVP(majorityClass);
   ar & BOOST_SERIALIZATION_NVP(majorityProbability);
 
+  // Older models have no memory budget.
+  if (version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(maxMemory);
+    ar & BOOST_SERIALIZATION_NVP(dropPoorAttributes);
+  }
+  else if (Archive::is_loading::value)
+  {
+    maxMemory = 0;
+    dropPoorAttributes = false;
+  }
+
+  if (Archive::is_loading::value)
+  {
+    splitsMemory = 0;
+    samplesSinceMemoryCheck = 0;
+  }
+
   // Depending on whether or not we have split yet, we may need to save
   // different things.
   if (splitDimension == size_t(-1))
@@ -840,16 +1386,41 @@ void HoeffdingTree<
       numericSplit = typename NumericSplitType<FitnessFunction>::SplitInfo();
     }
 
+    if (version > 0)
+    {
+      ar & BOOST_SERIALIZATION_NVP(classCounts);
+      ar & BOOST_SERIALIZATION_NVP(active);
+      ar & BOOST_SERIALIZATION_NVP(droppedDimensions);
+    }
+    else if (Archive::is_loading::value)
+    {
+      // Older models don't store the class counts, so start them from the
+      // majority class, which is then kept until the other classes have been
+      // seen more often.
+      classCounts.zeros(numClasses);
+      if (numClasses > 0)
+        classCounts[majorityClass] = size_t(majorityProbability * numSamples);
+      active = true;
+      droppedDimensions.assign(datasetInfo->Dimensionality(), false);
+    }
+
     // There's no need to serialize if there's no information contained in the
-    // splits.
-    if (numSamples == 0)
+    // splits (but a deactivated leaf has only one split of each type).
+    if (numSamples == 0 && active)
+    {
+      if (Archive::is_loading::value && maxMemory != 0)
+        splitsMemory = SplitsMemoryUsage();
       return;
+    }
 
     // Serialize numeric splits.
     ar & BOOST_SERIALIZATION_NVP(numericSplits);
 
     // Serialize categorical splits.
     ar & BOOST_SERIALIZATION_NVP(categoricalSplits);
+
+    if (Archive::is_loading::value && maxMemory != 0)
+      splitsMemory = SplitsMemoryUsage();
   }
   else
   {
@@ -874,6 +1445,9 @@ void HoeffdingTree<
 
       numericSplits.clear();
       categoricalSplits.clear();
+      classCounts.reset();
+      active = true;
+      droppedDimensions.clear();
 
       numSamples = 0;
       numClasses = 0;
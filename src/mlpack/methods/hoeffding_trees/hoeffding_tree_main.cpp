@@ -44,6 +44,15 @@ PROGRAM_INFO("Hoeffding trees",
     PRINT_PARAM_STRING("batch_mode") + " option, but this may not be the best "
     "option for large datasets."
     "\n\n"
+    "When a new model is trained in streaming mode, the memory used by the "
+    "tree can be limited to " + PRINT_PARAM_STRING("max_memory") + " "
+    "megabytes: the least promising leaves are then deactivated (they stop "
+    "collecting the statistics needed to split, but still predict their "
+    "majority class), and reactivated when they become more promising.  With "
+    "the " + PRINT_PARAM_STRING("drop_poor_attributes") + " option, each leaf "
+    "also stops collecting statistics for the dimensions that can't be its "
+    "best split."
+    "\n\n"
     "When a model is trained, it may be saved via the " +
     PRINT_PARAM_STRING("output_model") + " output parameter.  A model may be "
     "loaded from file for further training or testing with the " +
@@ -103,6 +112,10 @@ PARAM_FLAG("batch_mode", "If true, samples will be considered in batch instead "
 PARAM_FLAG("info_gain", "If set, information gain is used instead of Gini "
     "impurity for calculating Hoeffding bounds.", "i");
 PARAM_INT_IN("passes", "Number of passes to take over the dataset.", "s", 1);
+PARAM_INT_IN("max_memory", "Maximum memory for the tree, in megabytes, when "
+    "training in streaming mode (0 means no limit).", "x", 0);
+PARAM_FLAG("drop_poor_attributes", "If set, each leaf stops collecting "
+    "statistics for the dimensions that can't be its best split.", "D");
 
 PARAM_INT_IN("bins", "If the 'domingos' split strategy is used, this specifies "
     "the number of bins for each numeric split.", "B", 10);
@@ -129,6 +142,10 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "training", false }}, "batch_mode");
   ReportIgnoredParam({{ "training", false }}, "passes");
+  ReportIgnoredParam({{ "training", false }}, "max_memory");
+  ReportIgnoredParam({{ "training", false }}, "drop_poor_attributes");
+  ReportIgnoredParam({{ "input_model", true }}, "max_memory");
+  ReportIgnoredParam({{ "input_model", true }}, "drop_poor_attributes");
 
   if (CLI::HasParam("test"))
   {
@@ -138,6 +155,8 @@ static void mlpackMain()
 
   RequireParamInSet<string>("numeric_split_strategy", { "domingos", "binary" },
       true, "unrecognized numeric split strategy");
+  RequireParamValue<int>("max_memory", [](int x) { return x >= 0; }, true,
+      "maximum memory must be nonnegative");
 
   // Do we need to load a model or do we already have one?
   HoeffdingTreeModel* model;
@@ -173,6 +192,8 @@ static void mlpackMain()
     const size_t observationsBeforeBinning = (size_t)
         CLI::GetParam<int>("observations_before_binning");
     size_t passes = (size_t) CLI::GetParam<int>("passes");
+    const size_t maxMemory = (size_t) CLI::GetParam<int>("max_memory") *
+        1024 * 1024;
     if (passes > 1)
       batchTraining = false; // We already warned about this earlier.
 
@@ -209,7 +230,8 @@ static void mlpackMain()
       // Build the model.
       model->BuildModel(trainingSet, datasetInfo, labels,
           arma::max(labels) + 1, batchTraining, confidence, maxSamples,
-          100, minSamples, bins, observationsBeforeBinning);
+          100, minSamples, bins, observationsBeforeBinning, maxMemory,
+          CLI::HasParam("drop_poor_attributes"));
       --passes; // This model-building takes one pass.
     }
 
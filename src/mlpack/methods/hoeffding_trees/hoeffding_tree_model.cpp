@@ -133,7 +133,9 @@ void HoeffdingTreeModel::BuildModel(
     const size_t checkInterval,
     const size_t minSamples,
     const size_t bins,
-    const size_t observationsBeforeBinning)
+    const size_t observationsBeforeBinning,
+    const size_t maxMemory,
+    const bool dropPoorAttributes)
 {
   // Depending on the type, create the tree.
   switch (type)
@@ -147,14 +149,18 @@ void HoeffdingTreeModel::BuildModel(
         giniHoeffdingTree = new GiniHoeffdingTreeType(dataset, datasetInfo,
             labels, numClasses, batchTraining, successProbability, maxSamples,
             checkInterval, minSamples,
-            HoeffdingCategoricalSplit<GiniImpurity>(0, 0), ns);
+            HoeffdingCategoricalSplit<GiniImpurity>(0, 0), ns, maxMemory,
+            dropPoorAttributes);
       }
       break;
 
     case GINI_BINARY:
       giniBinaryTree = new GiniBinaryTreeType(dataset, datasetInfo, labels,
           numClasses, batchTraining, successProbability, maxSamples,
-          checkInterval, minSamples);
+          checkInterval, minSamples,
+          HoeffdingCategoricalSplit<GiniImpurity>(0, 0),
+          BinaryDoubleNumericSplit<GiniImpurity>(0), maxMemory,
+          dropPoorAttributes);
       break;
 
     case INFO_HOEFFDING:
@@ -166,14 +172,18 @@ void HoeffdingTreeModel::BuildModel(
         infoHoeffdingTree = new InfoHoeffdingTreeType(dataset, datasetInfo,
             labels, numClasses, batchTraining, successProbability, maxSamples,
             checkInterval, minSamples,
-            HoeffdingCategoricalSplit<InformationGain>(0, 0), ns);
+            HoeffdingCategoricalSplit<InformationGain>(0, 0), ns, maxMemory,
+            dropPoorAttributes);
       }
       break;
 
     case INFO_BINARY:
       infoBinaryTree = new InfoBinaryTreeType(dataset, datasetInfo, labels,
           numClasses, batchTraining, successProbability, maxSamples,
-          checkInterval, minSamples);
+          checkInterval, minSamples,
+          HoeffdingCategoricalSplit<InformationGain>(0, 0),
+          BinaryDoubleNumericSplit<InformationGain>(0), maxMemory,
+          dropPoorAttributes);
       break;
   }
 }
@@ -110,6 +110,10 @@ class HoeffdingTreeModel
    * @param bins Number of bins, for Hoeffding numeric split.
    * @param observationsBeforeBinning Number of observations before binning, for
    *      Hoeffding numeric split.
+   * @param maxMemory Maximum number of bytes of memory for the tree, enforced
+   *      by deactivating leaves in streaming mode (0 means no limit).
+   * @param dropPoorAttributes Whether the leaves drop the dimensions that can't
+   *      be the best split.
    */
   void BuildModel(const arma::mat& dataset,
                   const data::DatasetInfo& datasetInfo,
@@ -121,7 +125,9 @@ class HoeffdingTreeModel
                   const size_t checkInterval,
                   const size_t minSamples,
                   const size_t bins,
-                  const size_t observationsBeforeBinning);
+                  const size_t observationsBeforeBinning,
+                  const size_t maxMemory = 0,
+                  const bool dropPoorAttributes = false);
 
   /**
    * Train in streaming mode on the given dataset.  This takes one pass.  Be
@@ -0,0 +1,227 @@
+/**
+ * @file kde.hpp
+ *
+ * Definition of the KDE class, which performs kernel density estimation with
+ * trees.
+ *
+ * For more information on dual-tree kernel density estimation, see the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{gray2003nonparametric,
+ *   title={Nonparametric density estimation: Toward computational
+ *       tractability},
+ *   author={Gray, Alexander G. and Moore, Andrew W.},
+ *   booktitle={Proceedings of the 2003 SIAM International Conference on Data
+ *       Mining},
+ *   pages={203--211},
+ *   year={2003}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_HPP
+#define MLPACK_METHODS_KDE_KDE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+
+#include "kde_stat.hpp"
+
+namespace mlpack {
+namespace kde /** Kernel density estimation. */ {
+
+//! The ways of computing the estimates.
+enum KDEMode
+{
+  KDE_NAIVE_MODE,
+  KDE_SINGLE_TREE_MODE,
+  KDE_DUAL_TREE_MODE
+};
+
+/**
+ * The KDE class estimates the density of a set of reference points at each
+ * point of a set of query points, as the average value of a kernel between the
+ * query point and the reference points.  The estimates are not normalized: to
+ * obtain a probability density, divide them by the normalizer of the kernel
+ * (for instance GaussianKernel::Normalizer()), as KDEModel does.
+ *
+ * In the single-tree and dual-tree modes, the sum of the kernel values of a
+ * reference node is approximated whenever the kernel varies little enough over
+ * the node (see KDERules), so that each estimate is within
+ *
+ *   relError * (true estimate) + absError
+ *
+ * of the exact, naive estimate.  The query points (or query subtrees) are
+ * handled in parallel with OpenMP in all three modes.
+ *
+ * @code
+ * KDE<> kde(0.01);
+ * kde.Train(referenceSet);
+ * kde.Evaluate(querySet, estimations);
+ * @endcode
+ *
+ * @tparam KernelType The kernel to use; its Evaluate(distance) function must
+ *     decrease with the distance.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The tree type to use; trees whose nodes share points (such
+ *     as the cover tree, whose nodes hold their centroid) are not supported.
+ */
+template<typename KernelType = kernel::GaussianKernel,
+         typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class KDE
+{
+ public:
+  //! Convenience typedef.
+  typedef TreeType<MetricType, KDEStat, MatType> Tree;
+
+  static_assert(!tree::TreeTraits<Tree>::HasSelfChildren,
+      "KDE cannot use trees with self-children, since their points would be "
+      "counted more than once.");
+
+  /**
+   * Initialize the KDE object.  Train() must be called before estimates can be
+   * computed.
+   *
+   * @param relError Relative error tolerance of each estimate.
+   * @param absError Absolute error tolerance of each estimate.
+   * @param kernel Instantiated kernel.
+   * @param mode How to compute the estimates.
+   * @param metric Instantiated metric.
+   */
+  KDE(const double relError = 0.05,
+      const double absError = 0.0,
+      const KernelType kernel = KernelType(),
+      const KDEMode mode = KDE_DUAL_TREE_MODE,
+      const MetricType metric = MetricType());
+
+  //! Copy the given KDE object.
+  KDE(const KDE& other);
+
+  //! Take ownership of the given KDE object.
+  KDE(KDE&& other);
+
+  //! Copy the given KDE object.
+  KDE& operator=(KDE other);
+
+  //! Delete the reference tree.
+  ~KDE();
+
+  /**
+   * Set the reference set and build the reference tree on it.  The reference
+   * set is taken by value; use std::move() to avoid a copy.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Estimate the density of the reference set at each query point.  A
+   * std::invalid_argument is thrown if the dimensionality of the query set
+   * does not match the reference set, and a std::runtime_error if the model
+   * has not been trained.
+   *
+   * @param querySet Set of query points.
+   * @param estimations Vector to store the estimate for each query point in.
+   */
+  void Evaluate(const MatType& querySet, arma::vec& estimations);
+
+  /**
+   * Estimate the density of the reference set at each reference point (each
+   * point counts itself).
+   *
+   * @param estimations Vector to store the estimate for each reference point
+   *     in.
+   */
+  void Evaluate(arma::vec& estimations);
+
+  //! Get the reference tree (NULL if the model is not trained).
+  const Tree* ReferenceTree() const { return referenceTree; }
+
+  //! Get whether the model has been trained.
+  bool IsTrained() const { return referenceTree != NULL; }
+
+  //! Get the relative error tolerance.
+  double RelativeError() const { return relError; }
+  //! Modify the relative error tolerance.
+  double& RelativeError() { return relError; }
+
+  //! Get the absolute error tolerance.
+  double AbsoluteError() const { return absError; }
+  //! Modify the absolute error tolerance.
+  double& AbsoluteError() { return absError; }
+
+  //! Get the mode.
+  KDEMode Mode() const { return mode; }
+  //! Modify the mode.
+  KDEMode& Mode() { return mode; }
+
+  //! Get the kernel.
+  const KernelType& Kernel() const { return kernel; }
+  //! Modify the kernel.
+  KernelType& Kernel() { return kernel; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get the number of base cases of the last estimation.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores of the last estimation.
+  size_t Scores() const { return scores; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Sum the kernel values of the reference points at each query point, in
+   * dual-tree mode if a query tree is given, and otherwise as the mode says.
+   * The sums are in the order of the query set (or query tree).
+   */
+  void ComputeSums(const MatType& querySet,
+                   Tree* queryTree,
+                   arma::vec& sums);
+
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+  //! The instantiated kernel.
+  KernelType kernel;
+  //! How to compute the estimates.
+  KDEMode mode;
+  //! The instantiated metric.
+  MetricType metric;
+
+  //! The reference tree (NULL if the model is not trained).
+  Tree* referenceTree;
+  //! The mapping from the points of the reference tree to the original points.
+  std::vector<size_t> oldFromNewReferences;
+
+  //! The number of base cases of the last estimation.
+  size_t baseCases;
+  //! The number of scores of the last estimation.
+  size_t scores;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_impl.hpp"
+
+#endif
@@ -0,0 +1,382 @@
+/**
+ * @file kde_impl.hpp
+ *
+ * Implementation of the KDE class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_IMPL_HPP
+#define MLPACK_METHODS_KDE_KDE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde.hpp"
+
+// The rules for traversal.
+#include "kde_rules.hpp"
+#include <mlpack/core/tree/instrumented_rules.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
+#include <mlpack/core/tree/parallel_single_tree_traverser.hpp>
+
+namespace mlpack {
+namespace kde {
+
+//! Call the tree constructor that does mapping.
+template<typename TreeType, typename MatType>
+TreeType* BuildTree(
+    MatType&& dataset,
+    std::vector<size_t>& oldFromNew,
+    const typename std::enable_if<
+        tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
+{
+  return new TreeType(std::forward<MatType>(dataset), oldFromNew);
+}
+
+//! Call the tree constructor that does not do mapping.
+template<typename TreeType, typename MatType>
+TreeType* BuildTree(
+    MatType&& dataset,
+    const std::vector<size_t>& /* oldFromNew */,
+    const typename std::enable_if<
+        !tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
+{
+  return new TreeType(std::forward<MatType>(dataset));
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(
+    const double relError,
+    const double absError,
+    const KernelType kernel,
+    const KDEMode mode,
+    const MetricType metric) :
+    relError(relError),
+    absError(absError),
+    kernel(kernel),
+    mode(mode),
+    metric(metric),
+    referenceTree(NULL),
+    baseCases(0),
+    scores(0)
+{
+  if (relError < 0.0 || absError < 0.0)
+  {
+    std::ostringstream oss;
+    oss << "KDE::KDE(): the error tolerances (relative " << relError
+        << ", absolute " << absError << ") must not be negative!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(const KDE& other) :
+    relError(other.relError),
+    absError(other.absError),
+    kernel(other.kernel),
+    mode(other.mode),
+    metric(other.metric),
+    referenceTree(other.referenceTree ? new Tree(*other.referenceTree) : NULL),
+    oldFromNewReferences(other.oldFromNewReferences),
+    baseCases(other.baseCases),
+    scores(other.scores)
+{
+  // Nothing to do.
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(KDE&& other) :
+    relError(other.relError),
+    absError(other.absError),
+    kernel(std::move(other.kernel)),
+    mode(other.mode),
+    metric(std::move(other.metric)),
+    referenceTree(other.referenceTree),
+    oldFromNewReferences(std::move(other.oldFromNewReferences)),
+    baseCases(other.baseCases),
+    scores(other.scores)
+{
+  // Clear the other object.
+  other.referenceTree = NULL;
+  other.baseCases = 0;
+  other.scores = 0;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>&
+KDE<KernelType, MetricType, MatType, TreeType>::operator=(KDE other)
+{
+  // Clean memory first.
+  delete referenceTree;
+
+  // Move the other model.
+  relError = other.relError;
+  absError = other.absError;
+  kernel = std::move(other.kernel);
+  mode = other.mode;
+  metric = std::move(other.metric);
+  referenceTree = other.referenceTree;
+  oldFromNewReferences = std::move(other.oldFromNewReferences);
+  baseCases = other.baseCases;
+  scores = other.scores;
+
+  other.referenceTree = NULL;
+
+  return *this;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::~KDE()
+{
+  delete referenceTree;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Train(
+    MatType referenceSet)
+{
+  // The tree is built in every mode, so that the mode can be changed later.
+  delete referenceTree;
+
+  Timer::Start("kde/tree_building");
+  referenceTree = BuildTree<Tree>(std::move(referenceSet),
+      oldFromNewReferences);
+  Timer::Stop("kde/tree_building");
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Evaluate(
+    const MatType& querySet,
+    arma::vec& estimations)
+{
+  if (!referenceTree)
+    throw std::runtime_error("KDE::Evaluate(): the model has not been "
+        "trained!");
+
+  const MatType& referenceSet = referenceTree->Dataset();
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KDE::Evaluate(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet.n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (mode == KDE_DUAL_TREE_MODE && querySet.n_cols > 0)
+  {
+    Timer::Start("kde/tree_building");
+    std::vector<size_t> oldFromNewQueries;
+    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+    Timer::Stop("kde/tree_building");
+
+    arma::vec sums;
+    ComputeSums(queryTree->Dataset(), queryTree, sums);
+    delete queryTree;
+
+    // Map the query points back to their original order, if necessary.
+    if (tree::TreeTraits<Tree>::RearrangesDataset)
+    {
+      estimations.set_size(querySet.n_cols);
+      for (size_t i = 0; i < sums.n_elem; ++i)
+        estimations[oldFromNewQueries[i]] = sums[i];
+    }
+    else
+    {
+      estimations = std::move(sums);
+    }
+  }
+  else
+  {
+    ComputeSums(querySet, NULL, estimations);
+  }
+
+  if (referenceSet.n_cols > 0)
+    estimations /= referenceSet.n_cols;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Evaluate(
+    arma::vec& estimations)
+{
+  if (!referenceTree)
+    throw std::runtime_error("KDE::Evaluate(): the model has not been "
+        "trained!");
+
+  // The reference tree is also the query tree.
+  const MatType& referenceSet = referenceTree->Dataset();
+  arma::vec sums;
+  ComputeSums(referenceSet, (mode == KDE_DUAL_TREE_MODE) ? referenceTree :
+      NULL, sums);
+
+  // Map the reference points back to their original order, if necessary.
+  if (tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    estimations.set_size(referenceSet.n_cols);
+    for (size_t i = 0; i < sums.n_elem; ++i)
+      estimations[oldFromNewReferences[i]] = sums[i];
+  }
+  else
+  {
+    estimations = std::move(sums);
+  }
+
+  if (referenceSet.n_cols > 0)
+    estimations /= referenceSet.n_cols;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::ComputeSums(
+    const MatType& querySet,
+    Tree* queryTree,
+    arma::vec& sums)
+{
+  const MatType& referenceSet = referenceTree->Dataset();
+  sums.zeros(querySet.n_cols);
+  baseCases = 0;
+  scores = 0;
+
+  // If there are no points, there is nothing to be done.
+  if (querySet.n_cols == 0 || referenceSet.n_cols == 0)
+    return;
+
+  Timer::Start("kde/computing_estimations");
+
+  typedef tree::TraversalRules<KDERules<MetricType, KernelType, Tree>>
+      RuleType;
+
+  if (queryTree)
+  {
+    // Each thread traverses its own query subtrees with its own copy of the
+    // rules, and approximations are added to the points of the query node, so
+    // the threads write to disjoint sums.
+    RuleType rules(referenceSet, querySet, sums, relError, absError, metric,
+        kernel);
+    tree::ParallelDualTreeTraverser<Tree, RuleType,
+        Tree::template DualTreeTraverser> traverser(rules);
+
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    for (size_t i = 0; i < traverser.Rules().size(); ++i)
+    {
+      baseCases += traverser.Rules()[i].BaseCases();
+      scores += traverser.Rules()[i].Scores();
+    }
+  }
+  else if (mode == KDE_NAIVE_MODE)
+  {
+    // The naive brute-force solution.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      double sum = 0.0;
+      for (size_t j = 0; j < referenceSet.n_cols; ++j)
+        sum += kernel.Evaluate(metric.Evaluate(querySet.col(i),
+            referenceSet.col(j)));
+      sums[i] = sum;
+    }
+
+    baseCases = querySet.n_cols * referenceSet.n_cols;
+  }
+  else
+  {
+    // Each thread traverses its own blocks of query points with its own copy
+    // of the rules.
+    RuleType rules(referenceSet, querySet, sums, relError, absError, metric,
+        kernel);
+    tree::ParallelSingleTreeTraverser<Tree, RuleType,
+        typename Tree::template SingleTreeTraverser<RuleType>> traverser(rules,
+        true);
+
+    traverser.Traverse(querySet.n_cols, *referenceTree);
+
+    for (size_t i = 0; i < traverser.Rules().size(); ++i)
+    {
+      baseCases += traverser.Rules()[i].BaseCases();
+      scores += traverser.Rules()[i].Scores();
+    }
+  }
+
+  Timer::Stop("kde/computing_estimations");
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename Archive>
+void KDE<KernelType, MetricType, MatType, TreeType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(relError);
+  ar & BOOST_SERIALIZATION_NVP(absError);
+  ar & BOOST_SERIALIZATION_NVP(kernel);
+  ar & BOOST_SERIALIZATION_NVP(mode);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+
+  // Delete the current reference tree, if we are loading.
+  if (Archive::is_loading::value)
+  {
+    delete referenceTree;
+    referenceTree = NULL;
+    baseCases = 0;
+    scores = 0;
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(referenceTree);
+  ar & BOOST_SERIALIZATION_NVP(oldFromNewReferences);
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
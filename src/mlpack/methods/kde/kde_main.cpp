@@ -0,0 +1,155 @@
+/**
+ * @file kde_main.cpp
+ *
+ * Executable for kernel density estimation with trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "kde_model.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::kde;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("Kernel Density Estimation",
+    "This program estimates the probability density of a set of reference "
+    "points at each point of a set of query points, with a Gaussian or "
+    "Epanechnikov kernel of a given bandwidth.  If no query set is given, the "
+    "density is estimated at each reference point (each point counts itself)."
+    "\n\n"
+    "By default, the estimates are computed with a dual-tree algorithm that "
+    "approximates the contribution of groups of reference points when the "
+    "kernel varies little over them; the error of each estimate is at most " +
+    PRINT_PARAM_STRING("rel_error") + " times its value plus " +
+    PRINT_PARAM_STRING("abs_error") + " (divided by the normalizer of the "
+    "kernel).  The " + PRINT_PARAM_STRING("algorithm") + " parameter selects "
+    "'dual-tree', 'single-tree' or exact 'naive' computation."
+    "\n\n"
+    "For example, the following will estimate the density of the points in " +
+    PRINT_DATASET("reference") + " at the points in " + PRINT_DATASET("query") +
+    " with a Gaussian kernel of bandwidth 0.2 and store them in " +
+    PRINT_DATASET("predictions") + ":"
+    "\n\n" +
+    PRINT_CALL("kde", "reference", "reference", "query", "query", "bandwidth",
+        0.2, "predictions", "predictions") +
+    "\n\n"
+    "The model can be saved with " + PRINT_PARAM_STRING("output_model") +
+    " and reused with " + PRINT_PARAM_STRING("input_model") + ".");
+
+// Input data or model.
+PARAM_MATRIX_IN("reference", "Input reference dataset.", "r");
+PARAM_MATRIX_IN("query", "Query dataset (if not given, the reference dataset "
+    "is used).", "q");
+PARAM_MODEL_IN(KDEModel, "input_model", "Pre-trained KDE model.", "m");
+PARAM_MODEL_OUT(KDEModel, "output_model", "If specified, the KDE model will be "
+    "saved here.", "M");
+
+// Model parameters.
+PARAM_STRING_IN("kernel", "Kernel to use: 'gaussian' or 'epanechnikov'.", "k",
+    "gaussian");
+PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd' or 'ball'.", "t",
+    "kd");
+PARAM_DOUBLE_IN("bandwidth", "Bandwidth of the kernel.", "b", 1.0);
+
+// Estimation parameters.
+PARAM_STRING_IN("algorithm", "Algorithm to use: 'dual-tree', 'single-tree' or "
+    "'naive'.", "a", "dual-tree");
+PARAM_DOUBLE_IN("rel_error", "Relative error tolerance of each estimate.", "e",
+    0.05);
+PARAM_DOUBLE_IN("abs_error", "Absolute error tolerance of each estimate "
+    "(before normalization).", "E", 0.0);
+
+// Output.
+PARAM_COL_OUT("predictions", "Vector to store the density estimates in.", "p");
+
+static void mlpackMain()
+{
+  // A user cannot specify both reference data and a model.
+  RequireOnlyOnePassed({ "reference", "input_model" }, true);
+
+  ReportIgnoredParam({{ "input_model", true }}, "kernel");
+  ReportIgnoredParam({{ "input_model", true }}, "tree_type");
+  ReportIgnoredParam({{ "input_model", true }}, "bandwidth");
+
+  RequireAtLeastOnePassed({ "predictions", "output_model" }, false,
+      "no results will be saved");
+
+  RequireParamInSet<string>("algorithm", { "dual-tree", "single-tree",
+      "naive" }, true, "unknown algorithm");
+  RequireParamValue<double>("rel_error", [](double x) { return x >= 0.0; },
+      true, "relative error must be non-negative");
+  RequireParamValue<double>("abs_error", [](double x) { return x >= 0.0; },
+      true, "absolute error must be non-negative");
+
+  KDEModel* model;
+  if (CLI::HasParam("reference"))
+  {
+    RequireParamInSet<string>("kernel", { "gaussian", "epanechnikov" }, true,
+        "unknown kernel");
+    RequireParamInSet<string>("tree_type", { "kd", "ball" }, true,
+        "unknown tree type");
+    RequireParamValue<double>("bandwidth", [](double x) { return x > 0.0; },
+        true, "bandwidth must be positive");
+
+    model = new KDEModel();
+    model->Bandwidth() = CLI::GetParam<double>("bandwidth");
+    model->KernelType() = (CLI::GetParam<string>("kernel") == "gaussian") ?
+        KDEModel::GAUSSIAN_KERNEL : KDEModel::EPANECHNIKOV_KERNEL;
+    model->TreeType() = (CLI::GetParam<string>("tree_type") == "kd") ?
+        KDEModel::KD_TREE : KDEModel::BALL_TREE;
+
+    arma::mat referenceSet = std::move(CLI::GetParam<arma::mat>("reference"));
+
+    Log::Info << "Using reference data from '"
+        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+        << referenceSet.n_rows << "x" << referenceSet.n_cols << ")." << endl;
+
+    model->BuildModel(std::move(referenceSet));
+  }
+  else
+  {
+    model = CLI::GetParam<KDEModel*>("input_model");
+  }
+
+  model->RelativeError() = CLI::GetParam<double>("rel_error");
+  model->AbsoluteError() = CLI::GetParam<double>("abs_error");
+
+  const string algorithm = CLI::GetParam<string>("algorithm");
+  if (algorithm == "naive")
+    model->Mode() = KDE_NAIVE_MODE;
+  else if (algorithm == "single-tree")
+    model->Mode() = KDE_SINGLE_TREE_MODE;
+  else
+    model->Mode() = KDE_DUAL_TREE_MODE;
+
+  if (CLI::HasParam("predictions"))
+  {
+    arma::vec estimations;
+    if (CLI::HasParam("query"))
+    {
+      arma::mat querySet = std::move(CLI::GetParam<arma::mat>("query"));
+      Log::Info << "Using query data from '"
+          << CLI::GetPrintableParam<arma::mat>("query") << "' ("
+          << querySet.n_rows << "x" << querySet.n_cols << ")." << endl;
+
+      model->Evaluate(std::move(querySet), estimations);
+    }
+    else
+    {
+      model->Evaluate(estimations);
+    }
+
+    CLI::GetParam<arma::vec>("predictions") = std::move(estimations);
+  }
+
+  CLI::GetParam<KDEModel*>("output_model") = model;
+}
@@ -0,0 +1,232 @@
+/**
+ * @file kde_model.hpp
+ *
+ * A serializable model for kernel density estimation, which abstracts away the
+ * types of kernel and tree and normalizes the estimates.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_MODEL_HPP
+#define MLPACK_METHODS_KDE_KDE_MODEL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/epanechnikov_kernel.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <boost/variant.hpp>
+#include "kde.hpp"
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * Alias template for the KDE types held by KDEModel.
+ */
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+using KDEType = KDE<KernelType, metric::EuclideanDistance, arma::mat,
+    TreeType>;
+
+/**
+ * EvaluateVisitor sets the parameters of the given KDEType and computes the
+ * estimates at the given query points, or at the reference points if no query
+ * set is given.
+ */
+class EvaluateVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The query set (NULL for the reference set).
+  const arma::mat* querySet;
+  //! The output estimates.
+  arma::vec& estimations;
+  //! The relative error tolerance.
+  const double relError;
+  //! The absolute error tolerance.
+  const double absError;
+  //! How to compute the estimates.
+  const KDEMode mode;
+
+ public:
+  //! Compute the estimates with the given KDE object.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+
+  //! Construct the EvaluateVisitor with the given parameters.
+  EvaluateVisitor(const arma::mat* querySet,
+                  arma::vec& estimations,
+                  const double relError,
+                  const double absError,
+                  const KDEMode mode) :
+      querySet(querySet),
+      estimations(estimations),
+      relError(relError),
+      absError(absError),
+      mode(mode)
+  { }
+};
+
+/**
+ * DeleteVisitor deletes the given KDEType instance.
+ */
+class DeleteVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Delete the KDEType object.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const { delete kde; }
+};
+
+/**
+ * The KDEModel class wraps the KDE class with a Gaussian or Epanechnikov
+ * kernel of a given bandwidth and a kd-tree or ball tree, and divides the
+ * estimates by the normalizer of the kernel, so that they are values of a
+ * probability density.  It is used by the kde binding.
+ */
+class KDEModel
+{
+ public:
+  //! The kernels that can be used.
+  enum KernelTypes
+  {
+    GAUSSIAN_KERNEL,
+    EPANECHNIKOV_KERNEL
+  };
+
+  //! The trees that can be used.
+  enum TreeTypes
+  {
+    KD_TREE,
+    BALL_TREE
+  };
+
+  //! The type of the KDE objects that can be held.
+  typedef boost::variant<KDEType<kernel::GaussianKernel, tree::KDTree>*,
+                         KDEType<kernel::GaussianKernel, tree::BallTree>*,
+                         KDEType<kernel::EpanechnikovKernel, tree::KDTree>*,
+                         KDEType<kernel::EpanechnikovKernel, tree::BallTree>*>
+      KDEVariant;
+
+  /**
+   * Initialize the model with the given parameters.  BuildModel() must be
+   * called before estimates can be computed.
+   *
+   * @param bandwidth Bandwidth of the kernel.
+   * @param relError Relative error tolerance of each estimate.
+   * @param absError Absolute error tolerance of each estimate.
+   * @param kernelType Type of kernel to use.
+   * @param treeType Type of tree to use.
+   */
+  KDEModel(const double bandwidth = 1.0,
+           const double relError = 0.05,
+           const double absError = 0.0,
+           const KernelTypes kernelType = GAUSSIAN_KERNEL,
+           const TreeTypes treeType = KD_TREE);
+
+  //! Copy the given model.
+  KDEModel(const KDEModel& other);
+
+  //! Take ownership of the given model.
+  KDEModel(KDEModel&& other);
+
+  //! Copy the given model.  Use std::move() if the old copy is not needed.
+  KDEModel& operator=(KDEModel other);
+
+  //! Clean memory.
+  ~KDEModel();
+
+  /**
+   * Build the model on the given reference set, with the current kernel type,
+   * bandwidth and tree type.  This takes possession of the reference set.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void BuildModel(arma::mat&& referenceSet);
+
+  /**
+   * Estimate the density at each query point.  This takes possession of the
+   * query set.
+   *
+   * @param querySet Set of query points.
+   * @param estimations Output: the estimate for each query point.
+   */
+  void Evaluate(arma::mat&& querySet, arma::vec& estimations);
+
+  /**
+   * Estimate the density at each reference point.
+   *
+   * @param estimations Output: the estimate for each reference point.
+   */
+  void Evaluate(arma::vec& estimations);
+
+  //! Get the bandwidth of the kernel.
+  double Bandwidth() const { return bandwidth; }
+  //! Modify the bandwidth of the kernel (call BuildModel() afterwards).
+  double& Bandwidth() { return bandwidth; }
+
+  //! Get the relative error tolerance.
+  double RelativeError() const { return relError; }
+  //! Modify the relative error tolerance.
+  double& RelativeError() { return relError; }
+
+  //! Get the absolute error tolerance.
+  double AbsoluteError() const { return absError; }
+  //! Modify the absolute error tolerance.
+  double& AbsoluteError() { return absError; }
+
+  //! Get the type of kernel.
+  KernelTypes KernelType() const { return kernelType; }
+  //! Modify the type of kernel (call BuildModel() afterwards).
+  KernelTypes& KernelType() { return kernelType; }
+
+  //! Get the type of tree.
+  TreeTypes TreeType() const { return treeType; }
+  //! Modify the type of tree (call BuildModel() afterwards).
+  TreeTypes& TreeType() { return treeType; }
+
+  //! Get how the estimates are computed.
+  KDEMode Mode() const { return mode; }
+  //! Modify how the estimates are computed.
+  KDEMode& Mode() { return mode; }
+
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Divide the estimates by the normalizer of the kernel.
+  void Normalize(arma::vec& estimations) const;
+
+  //! The bandwidth of the kernel.
+  double bandwidth;
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+  //! The type of kernel.
+  KernelTypes kernelType;
+  //! The type of tree.
+  TreeTypes treeType;
+  //! How the estimates are computed.
+  KDEMode mode;
+  //! The dimensionality of the reference set (0 if the model is not built).
+  size_t dimensionality;
+
+  //! The KDE object, NULL if the model is not built.
+  KDEVariant kde;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_model_impl.hpp"
+
+#endif
@@ -0,0 +1,217 @@
+/**
+ * @file kde_model_impl.hpp
+ *
+ * Implementation of KDEModel and its visitors.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_MODEL_IMPL_HPP
+#define MLPACK_METHODS_KDE_KDE_MODEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_model.hpp"
+
+#include <boost/serialization/variant.hpp>
+
+namespace mlpack {
+namespace kde {
+
+//! Compute the estimates with the given KDE object.
+template<typename KDEType>
+void EvaluateVisitor::operator()(KDEType* kde) const
+{
+  if (!kde)
+    throw std::runtime_error("KDEModel::Evaluate(): the model has not been "
+        "built!");
+
+  kde->RelativeError() = relError;
+  kde->AbsoluteError() = absError;
+  kde->Mode() = mode;
+
+  if (querySet)
+    kde->Evaluate(*querySet, estimations);
+  else
+    kde->Evaluate(estimations);
+}
+
+/**
+ * CopyVisitor makes a deep copy of the given KDEType instance.
+ */
+class CopyVisitor : public boost::static_visitor<KDEModel::KDEVariant>
+{
+ public:
+  //! Copy the KDEType object.
+  template<typename KDEType>
+  KDEModel::KDEVariant operator()(const KDEType* kde) const
+  {
+    return kde ? new KDEType(*kde) : NULL;
+  }
+};
+
+inline KDEModel::KDEModel(const double bandwidth,
+                          const double relError,
+                          const double absError,
+                          const KernelTypes kernelType,
+                          const TreeTypes treeType) :
+    bandwidth(bandwidth),
+    relError(relError),
+    absError(absError),
+    kernelType(kernelType),
+    treeType(treeType),
+    mode(KDE_DUAL_TREE_MODE),
+    dimensionality(0)
+{
+  // Nothing to do.
+}
+
+// Copy constructor.
+inline KDEModel::KDEModel(const KDEModel& other) :
+    bandwidth(other.bandwidth),
+    relError(other.relError),
+    absError(other.absError),
+    kernelType(other.kernelType),
+    treeType(other.treeType),
+    mode(other.mode),
+    dimensionality(other.dimensionality),
+    kde(boost::apply_visitor(CopyVisitor(), other.kde))
+{
+  // Nothing to do.
+}
+
+// Move constructor.
+inline KDEModel::KDEModel(KDEModel&& other) :
+    bandwidth(other.bandwidth),
+    relError(other.relError),
+    absError(other.absError),
+    kernelType(other.kernelType),
+    treeType(other.treeType),
+    mode(other.mode),
+    dimensionality(other.dimensionality),
+    kde(std::move(other.kde))
+{
+  // Reset the other model.
+  other.dimensionality = 0;
+  other.kde = decltype(other.kde)();
+}
+
+inline KDEModel& KDEModel::operator=(KDEModel other)
+{
+  boost::apply_visitor(DeleteVisitor(), kde);
+
+  bandwidth = other.bandwidth;
+  relError = other.relError;
+  absError = other.absError;
+  kernelType = other.kernelType;
+  treeType = other.treeType;
+  mode = other.mode;
+  dimensionality = other.dimensionality;
+  kde = std::move(other.kde);
+
+  other.kde = decltype(other.kde)();
+
+  return *this;
+}
+
+// Clean memory.
+inline KDEModel::~KDEModel()
+{
+  boost::apply_visitor(DeleteVisitor(), kde);
+}
+
+inline void KDEModel::BuildModel(arma::mat&& referenceSet)
+{
+  if (bandwidth <= 0.0)
+  {
+    std::ostringstream oss;
+    oss << "KDEModel::BuildModel(): the bandwidth (" << bandwidth << ") must "
+        << "be positive!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Clean memory, if necessary.
+  boost::apply_visitor(DeleteVisitor(), kde);
+  kde = decltype(kde)();
+
+  dimensionality = referenceSet.n_rows;
+  if (kernelType == GAUSSIAN_KERNEL && treeType == KD_TREE)
+  {
+    KDEType<kernel::GaussianKernel, tree::KDTree>* k =
+        new KDEType<kernel::GaussianKernel, tree::KDTree>(relError, absError,
+        kernel::GaussianKernel(bandwidth), mode);
+    kde = k;
+    k->Train(std::move(referenceSet));
+  }
+  else if (kernelType == GAUSSIAN_KERNEL)
+  {
+    KDEType<kernel::GaussianKernel, tree::BallTree>* k =
+        new KDEType<kernel::GaussianKernel, tree::BallTree>(relError, absError,
+        kernel::GaussianKernel(bandwidth), mode);
+    kde = k;
+    k->Train(std::move(referenceSet));
+  }
+  else if (treeType == KD_TREE)
+  {
+    KDEType<kernel::EpanechnikovKernel, tree::KDTree>* k =
+        new KDEType<kernel::EpanechnikovKernel, tree::KDTree>(relError,
+        absError, kernel::EpanechnikovKernel(bandwidth), mode);
+    kde = k;
+    k->Train(std::move(referenceSet));
+  }
+  else
+  {
+    KDEType<kernel::EpanechnikovKernel, tree::BallTree>* k =
+        new KDEType<kernel::EpanechnikovKernel, tree::BallTree>(relError,
+        absError, kernel::EpanechnikovKernel(bandwidth), mode);
+    kde = k;
+    k->Train(std::move(referenceSet));
+  }
+}
+
+inline void KDEModel::Evaluate(arma::mat&& querySet, arma::vec& estimations)
+{
+  boost::apply_visitor(EvaluateVisitor(&querySet, estimations, relError,
+      absError, mode), kde);
+  Normalize(estimations);
+}
+
+inline void KDEModel::Evaluate(arma::vec& estimations)
+{
+  boost::apply_visitor(EvaluateVisitor(NULL, estimations, relError, absError,
+      mode), kde);
+  Normalize(estimations);
+}
+
+inline void KDEModel::Normalize(arma::vec& estimations) const
+{
+  if (kernelType == GAUSSIAN_KERNEL)
+    estimations /= kernel::GaussianKernel(bandwidth).Normalizer(
+        dimensionality);
+  else
+    estimations /= kernel::EpanechnikovKernel(bandwidth).Normalizer(
+        dimensionality);
+}
+
+template<typename Archive>
+void KDEModel::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(bandwidth);
+  ar & BOOST_SERIALIZATION_NVP(relError);
+  ar & BOOST_SERIALIZATION_NVP(absError);
+  ar & BOOST_SERIALIZATION_NVP(kernelType);
+  ar & BOOST_SERIALIZATION_NVP(treeType);
+  ar & BOOST_SERIALIZATION_NVP(mode);
+  ar & BOOST_SERIALIZATION_NVP(dimensionality);
+
+  if (Archive::is_loading::value)
+    boost::apply_visitor(DeleteVisitor(), kde);
+
+  ar & BOOST_SERIALIZATION_NVP(kde);
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ * @file kde_rules.hpp
+ *
+ * Rules for the single-tree and dual-tree traversals of kernel density
+ * estimation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_RULES_HPP
+#define MLPACK_METHODS_KDE_KDE_RULES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/traversal_info.hpp>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * The KDERules class is a template helper class used by the KDE class when
+ * estimating densities with a tree.  The sum of the kernel values between a
+ * query point (or node) and all the points of a reference node is
+ * approximated when the kernel varies little enough over the node: if the
+ * kernel takes values between minKernel and maxKernel over the pair, the sum
+ * is approximated by the number of reference points times (maxKernel +
+ * minKernel) / 2, which is done if
+ *
+ *   maxKernel - minKernel <= 2 * (absError + relError * minKernel).
+ *
+ * Each approximated kernel value is then off by at most absError + relError
+ * times the true kernel value, and so is the average of the kernel values,
+ * which is the density estimate.  The kernel must be a decreasing function of
+ * the distance, like GaussianKernel or EpanechnikovKernel.
+ *
+ * The estimates are accumulated in a vector that is indexed by query point;
+ * copies of the rules share it, so the traversals of disjoint query points can
+ * run in parallel.
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam KernelType The kernel to use for the estimation.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API, and
+ *     must not hold the same point in more than one node.
+ */
+template<typename MetricType, typename KernelType, typename TreeType>
+class KDERules
+{
+ public:
+  /**
+   * Construct the KDERules object.  This is usually done from within the KDE
+   * class at estimation time.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param densities Vector to add the sum of the kernel values of each query
+   *     point to.
+   * @param relError Relative error tolerance.
+   * @param absError Absolute error tolerance.
+   * @param metric Instantiated metric.
+   * @param kernel Instantiated kernel.
+   */
+  KDERules(const arma::mat& referenceSet,
+           const arma::mat& querySet,
+           arma::vec& densities,
+           const double relError,
+           const double absError,
+           MetricType& metric,
+           KernelType& kernel);
+
+  /**
+   * Compute the base case between the given query point and reference point.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndex Index of reference point.
+   */
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Get the score for recursion order.  DBL_MAX indicates that the node has
+   * been approximated, and should not be recursed into.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   */
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  Approximations don't depend on
+   * the order of the traversal, so this returns the old score.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(const size_t /* queryIndex */,
+                 TreeType& /* referenceNode */,
+                 const double oldScore) const { return oldScore; }
+
+  /**
+   * Get the score for recursion order.  DBL_MAX indicates that the node
+   * combination has been approximated, and should not be recursed into.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   */
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  Approximations don't depend on
+   * the order of the traversal, so this returns the old score.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(TreeType& /* queryNode */,
+                 TreeType& /* referenceNode */,
+                 const double oldScore) const { return oldScore; }
+
+  typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
+
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores.
+  size_t Scores() const { return scores; }
+
+ private:
+  /**
+   * If the kernel varies little enough between the given distances, add the
+   * approximate sum of the kernel values of the given number of reference
+   * points to the given value, and return true.
+   */
+  bool Approximate(const math::Range& distances,
+                   const size_t numReferences,
+                   double& density) const;
+
+  //! The reference set.
+  const arma::mat& referenceSet;
+  //! The query set.
+  const arma::mat& querySet;
+  //! The sum of the kernel values of each query point.
+  arma::vec& densities;
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The instantiated kernel.
+  KernelType& kernel;
+
+  //! The last query index.
+  size_t lastQueryIndex;
+  //! The last reference index.
+  size_t lastReferenceIndex;
+
+  TraversalInfoType traversalInfo;
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of scores.
+  size_t scores;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_rules_impl.hpp"
+
+#endif
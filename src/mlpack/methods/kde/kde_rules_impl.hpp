@@ -0,0 +1,122 @@
+/**
+ * @file kde_rules_impl.hpp
+ *
+ * Implementation of the rules of kernel density estimation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_RULES_IMPL_HPP
+#define MLPACK_METHODS_KDE_KDE_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_rules.hpp"
+
+namespace mlpack {
+namespace kde {
+
+template<typename MetricType, typename KernelType, typename TreeType>
+KDERules<MetricType, KernelType, TreeType>::KDERules(
+    const arma::mat& referenceSet,
+    const arma::mat& querySet,
+    arma::vec& densities,
+    const double relError,
+    const double absError,
+    MetricType& metric,
+    KernelType& kernel) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    densities(densities),
+    relError(relError),
+    absError(absError),
+    metric(metric),
+    kernel(kernel),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline
+double KDERules<MetricType, KernelType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  // Some traversals may call the same base case twice in a row.
+  if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
+    return 0.0;
+
+  const double distance = metric.Evaluate(querySet.col(queryIndex),
+      referenceSet.col(referenceIndex));
+  densities[queryIndex] += kernel.Evaluate(distance);
+  ++baseCases;
+
+  lastQueryIndex = queryIndex;
+  lastReferenceIndex = referenceIndex;
+
+  return distance;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+bool KDERules<MetricType, KernelType, TreeType>::Approximate(
+    const math::Range& distances,
+    const size_t numReferences,
+    double& density) const
+{
+  // The kernel decreases with the distance.
+  const double maxKernel = kernel.Evaluate(distances.Lo());
+  const double minKernel = kernel.Evaluate(distances.Hi());
+  if (maxKernel - minKernel > 2 * (absError + relError * minKernel))
+    return false;
+
+  density += numReferences * (maxKernel + minKernel) / 2;
+  return true;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  ++scores;
+  const math::Range distances =
+      referenceNode.RangeDistance(querySet.col(queryIndex));
+
+  if (Approximate(distances, referenceNode.NumDescendants(),
+      densities[queryIndex]))
+    return DBL_MAX;
+
+  // Closer nodes are visited first.
+  return distances.Lo();
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  ++scores;
+  const math::Range distances = queryNode.RangeDistance(referenceNode);
+
+  // The approximation is the same for every query point in the node.
+  double density = 0.0;
+  if (Approximate(distances, referenceNode.NumDescendants(), density))
+  {
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+      densities[queryNode.Descendant(i)] += density;
+
+    return DBL_MAX;
+  }
+
+  return distances.Lo();
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ * @file kde_stat.hpp
+ *
+ * Defines the KDEStat class, the tree statistic used by KDE.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_STAT_HPP
+#define MLPACK_METHODS_KDE_KDE_STAT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * Statistic class for KDE, to be set to the StatisticType of the tree type
+ * that kernel density estimation is performed with.  The pruning rules of KDE
+ * only need the bounds of the nodes, so this holds nothing; since the
+ * traversals never modify the statistics, the queries can be handled in
+ * parallel.
+ */
+class KDEStat
+{
+ public:
+  //! Initialize the statistic.
+  KDEStat() { }
+
+  /**
+   * Initialize the statistic given a tree node that this statistic belongs to.
+   * In this case, we ignore the node.
+   */
+  template<typename TreeType>
+  KDEStat(TreeType& /* node */) { }
+
+  //! Serialize the statistic (there is nothing to serialize).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+};
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -30,6 +30,8 @@
 #include <mlpack/methods/nystroem_method/kmeans_selection.hpp>
 #include <mlpack/methods/nystroem_method/nystroem_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_fourier_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/block_krylov_method.hpp>
 
 #include "kernel_pca.hpp"
 
@@ -93,7 +95,23 @@ PROGRAM_INFO("Kernel Principal Components Analysis",
     "the kernel matrix; to specify the sampling scheme, the " +
     PRINT_PARAM_STRING("sampling") + " parameter is used.  The "
     "sampling scheme for the Nystr\u00F6m method can be chosen from the "
-    "following list: 'kmeans', 'random', 'ordered'.");
+    "following list: 'kmeans', 'random', 'ordered'."
+    "\n\n"
+    "For the 'gaussian' and 'laplacian' kernels, random Fourier features "
+    "(\"Random features for large-scale kernel machines\", 2008) can be used "
+    "instead by specifying the " + PRINT_PARAM_STRING("random_features") +
+    " parameter: PCA is then performed on " +
+    PRINT_PARAM_STRING("num_frequencies") + " random frequencies (twice as "
+    "many features), which takes time linear in the number of points.  If " +
+    PRINT_PARAM_STRING("fastfood") + " is also given, the features are "
+    "computed with Fastfood, which is faster for high-dimensional data."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("krylov_method") + " is specified, only the " +
+    PRINT_PARAM_STRING("new_dimensionality") + " kernel principal components "
+    "with the largest eigenvalues are computed, with a randomized block Krylov "
+    "method, instead of the full eigendecomposition of the kernel matrix.  For "
+    "large datasets the kernel matrix is not stored; it is computed in blocks "
+    "when it is needed.");
 
 PARAM_MATRIX_IN_REQ("input", "Input dataset to perform KPCA on.", "i");
 PARAM_MATRIX_OUT("output", "Matrix to save modified dataset to.", "o");
@@ -109,9 +127,19 @@ PARAM_FLAG("center", "If set, the transformed data will be centered about the "
 
 PARAM_FLAG("nystroem_method", "If set, the nystroem method will be used.", "n");
 
+PARAM_FLAG("krylov_method", "If set, only the top eigenvectors of the kernel "
+    "matrix are computed, with a randomized block Krylov method.", "K");
+
 PARAM_STRING_IN("sampling", "Sampling scheme to use for the nystroem method: "
     "'kmeans', 'random', 'ordered'", "s", "kmeans");
 
+PARAM_FLAG("random_features", "If set, random Fourier features will be used "
+    "(only for 'gaussian' and 'laplacian' kernels).", "r");
+PARAM_INT_IN("num_frequencies", "Number of random frequencies, if random "
+    "Fourier features are used.", "F", 100);
+PARAM_FLAG("fastfood", "If set, the random Fourier features are computed with "
+    "Fastfood.", "f");
+
 PARAM_DOUBLE_IN("kernel_scale", "Scale, for 'hyptan' kernel.", "S", 1.0);
 PARAM_DOUBLE_IN("offset", "Offset, for 'hyptan' and 'polynomial' kernels.", "O",
     0.0);
@@ -125,6 +153,7 @@ template<typename KernelType>
 void RunKPCA(arma::mat& dataset,
              const bool centerTransformedData,
              const bool nystroem,
+             const bool krylov,
              const size_t newDim,
              const string& sampling,
              KernelType& kernel)
@@ -157,6 +186,12 @@ void RunKPCA(arma::mat& dataset,
         << "choices are 'kmeans', 'random' and 'ordered'" << endl;
     }
   }
+  else if (krylov)
+  {
+    KernelPCA<KernelType, BlockKrylovKernelRule<KernelType>> kpca(kernel,
+        centerTransformedData);
+    kpca.Apply(dataset, newDim);
+  }
   else
   {
     KernelPCA<KernelType> kpca(kernel, centerTransformedData);
@@ -164,6 +199,37 @@ void RunKPCA(arma::mat& dataset,
   }
 }
 
+//! Run KPCA on the random Fourier features of the dataset.
+template<typename KernelType>
+void RunRandomFeaturesKPCA(arma::mat& dataset,
+                           const bool centerTransformedData,
+                           const bool fastfood,
+                           const size_t numFrequencies,
+                           const size_t newDim,
+                           KernelType& kernel)
+{
+  arma::mat transformedData, eigvec;
+  arma::vec eigval;
+  if (fastfood)
+  {
+    KernelPCA<KernelType, RandomFourierKernelRule<KernelType, true>> kpca(
+        kernel, centerTransformedData);
+    kpca.Apply(dataset, transformedData, eigval, eigvec, numFrequencies);
+  }
+  else
+  {
+    KernelPCA<KernelType, RandomFourierKernelRule<KernelType>> kpca(kernel,
+        centerTransformedData);
+    kpca.Apply(dataset, transformedData, eigval, eigvec, numFrequencies);
+  }
+
+  // Keep the dimensions with the largest eigenvalues.
+  if (newDim < transformedData.n_rows)
+    transformedData.shed_rows(newDim, transformedData.n_rows - 1);
+
+  dataset = std::move(transformedData);
+}
+
 static void mlpackMain()
 {
   RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
@@ -194,20 +260,69 @@ static void mlpackMain()
   const bool centerTransformedData = CLI::HasParam("center");
   const bool nystroem = CLI::HasParam("nystroem_method");
   const string sampling = CLI::GetParam<string>("sampling");
+  const bool krylov = CLI::HasParam("krylov_method");
+  if (krylov && nystroem)
+  {
+    Log::Fatal << "Cannot specify both " << PRINT_PARAM_STRING(
+        "nystroem_method") << " and " << PRINT_PARAM_STRING("krylov_method")
+        << "!" << endl;
+  }
+
+  const bool randomFeatures = CLI::HasParam("random_features");
+  const bool fastfood = CLI::HasParam("fastfood");
+  if (randomFeatures)
+  {
+    if (kernelType != "gaussian" && kernelType != "laplacian")
+    {
+      Log::Fatal << "Random Fourier features can only be used with the "
+          << "'gaussian' and 'laplacian' kernels!" << endl;
+    }
+
+    if (nystroem)
+    {
+      Log::Fatal << "Cannot specify both " << PRINT_PARAM_STRING(
+          "nystroem_method") << " and " << PRINT_PARAM_STRING(
+          "random_features") << "!" << endl;
+    }
+
+    if (krylov)
+    {
+      Log::Fatal << "Cannot specify both " << PRINT_PARAM_STRING(
+          "krylov_method") << " and " << PRINT_PARAM_STRING(
+          "random_features") << "!" << endl;
+    }
+
+    RequireParamValue<int>("num_frequencies", [](int x) { return x > 0; },
+        true, "number of frequencies must be positive");
+  }
+  else
+  {
+    ReportIgnoredParam("num_frequencies", "random features are not used");
+    ReportIgnoredParam("fastfood", "random features are not used");
+  }
+  const size_t numFrequencies = (size_t) CLI::GetParam<int>("num_frequencies");
 
   if (kernelType == "linear")
   {
     LinearKernel kernel;
-    RunKPCA<LinearKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    RunKPCA<LinearKernel>(dataset, centerTransformedData, nystroem, krylov,
+        newDim, sampling, kernel);
   }
   else if (kernelType == "gaussian")
   {
     const double bandwidth = CLI::GetParam<double>("bandwidth");
 
     GaussianKernel kernel(bandwidth);
-    RunKPCA<GaussianKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    if (randomFeatures)
+    {
+      RunRandomFeaturesKPCA<GaussianKernel>(dataset, centerTransformedData,
+          fastfood, numFrequencies, newDim, kernel);
+    }
+    else
+    {
+      RunKPCA<GaussianKernel>(dataset, centerTransformedData, nystroem,
+          krylov, newDim, sampling, kernel);
+    }
   }
   else if (kernelType == "polynomial")
   {
@@ -215,7 +330,7 @@ static void mlpackMain()
     const double offset = CLI::GetParam<double>("offset");
 
     PolynomialKernel kernel(degree, offset);
-    RunKPCA<PolynomialKernel>(dataset, centerTransformedData, nystroem,
+    RunKPCA<PolynomialKernel>(dataset, centerTransformedData, nystroem, krylov,
         newDim, sampling, kernel);
   }
   else if (kernelType == "hyptan")
@@ -225,15 +340,23 @@ static void mlpackMain()
 
     HyperbolicTangentKernel kernel(scale, offset);
     RunKPCA<HyperbolicTangentKernel>(dataset, centerTransformedData, nystroem,
-        newDim, sampling, kernel);
+        krylov, newDim, sampling, kernel);
   }
   else if (kernelType == "laplacian")
   {
     const double bandwidth = CLI::GetParam<double>("bandwidth");
 
     LaplacianKernel kernel(bandwidth);
-    RunKPCA<LaplacianKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    if (randomFeatures)
+    {
+      RunRandomFeaturesKPCA<LaplacianKernel>(dataset, centerTransformedData,
+          fastfood, numFrequencies, newDim, kernel);
+    }
+    else
+    {
+      RunKPCA<LaplacianKernel>(dataset, centerTransformedData, nystroem,
+          krylov, newDim, sampling, kernel);
+    }
   }
   else if (kernelType == "epanechnikov")
   {
@@ -241,13 +364,13 @@ static void mlpackMain()
 
     EpanechnikovKernel kernel(bandwidth);
     RunKPCA<EpanechnikovKernel>(dataset, centerTransformedData, nystroem,
-        newDim, sampling, kernel);
+        krylov, newDim, sampling, kernel);
   }
   else if (kernelType == "cosine")
   {
     CosineDistance kernel;
-    RunKPCA<CosineDistance>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    RunKPCA<CosineDistance>(dataset, centerTransformedData, nystroem, krylov,
+        newDim, sampling, kernel);
   }
 
   // Save the output dataset.
@@ -0,0 +1,189 @@
+/**
+ * @file block_krylov_method.hpp
+ *
+ * Compute only the top eigenvectors of the centered kernel matrix, with a
+ * randomized block Krylov method.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_PCA_BLOCK_KRYLOV_METHOD_HPP
+#define MLPACK_METHODS_KERNEL_PCA_BLOCK_KRYLOV_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+#include "naive_method.hpp"
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * Compute the top rank eigenvectors of the centered kernel matrix with a
+ * randomized block Krylov method, the same scheme as RandomizedBlockKrylovSVD:
+ *
+ * @code
+ * @inproceedings{Musco2015,
+ *   author    = {Cameron Musco and Christopher Musco},
+ *   title     = {Randomized Block Krylov Methods for Stronger and Faster
+ *                Approximate Singular Value Decomposition},
+ *   booktitle = {Annual Conference on Neural Information Processing Systems
+ *                2015},
+ *   pages     = {1396--1404},
+ *   year      = {2015}
+ * }
+ * @endcode
+ *
+ * A random block of rank + Oversampling vectors is multiplied MaxIterations
+ * times by the centered kernel matrix, the resulting Krylov subspace is
+ * orthonormalized, and the small projected matrix is eigendecomposed.  This
+ * takes (MaxIterations + 2) products of the kernel matrix with a thin block
+ * instead of a full eigendecomposition, which costs O(n^3).
+ *
+ * The centered kernel matrix is never formed: it is H K H, with H = I - 1 1^T /
+ * n, so each product centers the block, multiplies it by K and centers the
+ * result.  If K has at most MaxStoredElements entries, it is computed once and
+ * kept; otherwise it is computed again for each product, in blocks of rows of
+ * at most MaxStoredElements entries, so that the memory used is linear in the
+ * number of points.
+ *
+ * If the Krylov subspace would not be smaller than the number of points, the
+ * exact NaiveKernelRule is used instead.
+ *
+ * @tparam KernelType Kernel to be used for computation.
+ */
+template<typename KernelType>
+class BlockKrylovKernelRule
+{
+ public:
+  //! Number of products of the block with the kernel matrix.
+  static const size_t MaxIterations = 3;
+  //! Number of extra vectors in the block.
+  static const size_t Oversampling = 10;
+  //! Largest number of entries of the kernel matrix to store at once.
+  static const size_t MaxStoredElements = 1 << 24;
+
+  /**
+   * Compute the top rank eigenvectors of the centered kernel matrix.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors will be written to this matrix.
+   * @param rank Number of eigenvectors to compute.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t rank,
+                                KernelType kernel = KernelType())
+  {
+    const size_t n = data.n_cols;
+    const size_t blockSize = rank + Oversampling;
+    if (rank == 0 || blockSize * (MaxIterations + 1) >= n)
+    {
+      NaiveKernelRule<KernelType>::ApplyKernelMatrix(data, transformedData,
+          eigval, eigvec, rank, kernel);
+
+      // Keep only the top rank eigenvectors, like the iterative method.
+      if (rank > 0 && rank < eigval.n_elem)
+      {
+        eigval.shed_rows(rank, eigval.n_elem - 1);
+        eigvec.shed_cols(rank, eigvec.n_cols - 1);
+        transformedData.shed_rows(rank, transformedData.n_rows - 1);
+      }
+      return;
+    }
+
+    // Compute the whole kernel matrix, if it is small enough.
+    arma::mat kernelMatrix;
+    if (n * n <= MaxStoredElements)
+      kernel::KernelMatrix<KernelType>::Compute(data, kernel, kernelMatrix);
+
+    // Build the block Krylov subspace, orthonormalizing each block.
+    arma::mat block = arma::randn<arma::mat>(n, blockSize);
+    arma::mat krylov(n, blockSize * (MaxIterations + 1));
+    arma::mat product, r;
+    arma::qr_econ(product, r, block);
+    krylov.cols(0, blockSize - 1) = product;
+    for (size_t i = 1; i <= MaxIterations; ++i)
+    {
+      Multiply(data, kernel, kernelMatrix, product, block);
+      arma::qr_econ(product, r, block);
+      krylov.cols(i * blockSize, (i + 1) * blockSize - 1) = product;
+    }
+
+    // Project the centered kernel matrix onto the subspace.
+    arma::mat q;
+    arma::qr_econ(q, r, krylov);
+    arma::mat kq;
+    Multiply(data, kernel, kernelMatrix, q, kq);
+    arma::mat t = q.t() * kq;
+    t = 0.5 * (t + t.t());
+
+    arma::vec values;
+    arma::mat vectors;
+    arma::eig_sym(values, vectors, t);
+
+    // The eigenvalues are in ascending order; keep the rank largest.
+    eigval = arma::flipud(values.tail(rank));
+    vectors = arma::fliplr(vectors.tail_cols(rank));
+    eigvec = q * vectors;
+
+    // data may be the same object as transformedData, so it can't be used
+    // after this.
+    transformedData = (kq * vectors).t();
+    transformedData.each_col() /= arma::sqrt(eigval);
+  }
+
+ private:
+  /**
+   * Multiply the centered kernel matrix by the given block.
+   *
+   * @param data Input data points.
+   * @param kernel Kernel to be used for computation.
+   * @param kernelMatrix Kernel matrix, or an empty matrix if it is computed in
+   *     blocks.
+   * @param x Block to multiply.
+   * @param result Matrix to store the product in.
+   */
+  static void Multiply(const arma::mat& data,
+                       KernelType& kernel,
+                       const arma::mat& kernelMatrix,
+                       const arma::mat& x,
+                       arma::mat& result)
+  {
+    arma::mat centered = x;
+    centered.each_row() -= arma::mean(centered, 0);
+
+    if (!kernelMatrix.is_empty())
+    {
+      result = kernelMatrix * centered;
+    }
+    else
+    {
+      const size_t n = data.n_cols;
+      const size_t rows = std::max(size_t(1), MaxStoredElements / n);
+      result.set_size(n, x.n_cols);
+      arma::mat kernelRows;
+      for (size_t begin = 0; begin < n; begin += rows)
+      {
+        const size_t end = std::min(n, begin + rows) - 1;
+        const arma::mat points = data.cols(begin, end);
+        kernel::KernelMatrix<KernelType>::Compute(points, data, kernel,
+            kernelRows);
+        result.rows(begin, end) = kernelRows * centered;
+      }
+    }
+
+    result.each_row() -= arma::mean(result, 0);
+  }
+};
+
+} // namespace kpca
+} // namespace mlpack
+
+#endif
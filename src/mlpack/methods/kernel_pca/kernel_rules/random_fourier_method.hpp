@@ -0,0 +1,83 @@
+/**
+ * @file random_fourier_method.hpp
+ *
+ * Use random Fourier features for approximating kernel PCA with a
+ * shift-invariant kernel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_METHOD_HPP
+#define MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/random_fourier_features/random_fourier_features.hpp>
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * Approximate kernel PCA by ordinary PCA on random Fourier features: the
+ * centered features Z (2 * rank dimensions) give the centered kernel matrix
+ * approximation Z^T Z, so its eigenvalues are those of the 2 * rank by 2 * rank
+ * matrix Z Z^T, and the cost is linear in the number of points.  As the
+ * kernel must be shift-invariant, only GaussianKernel and LaplacianKernel can
+ * be used.
+ *
+ * The eigenvectors that are returned are the principal directions in the
+ * feature space (2 * rank dimensions), not the eigenvectors of the kernel
+ * matrix.
+ *
+ * @tparam KernelType Shift-invariant kernel to approximate.
+ * @tparam UseFastfood Whether to compute the features with Fastfood.
+ */
+template<typename KernelType, bool UseFastfood = false>
+class RandomFourierKernelRule
+{
+ public:
+  /**
+   * Compute the kernel PCA of the random Fourier features of the data.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec Principal directions in the feature space will be written to
+   *     this matrix.
+   * @param rank Number of random frequencies to use.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t rank,
+                                KernelType kernel = KernelType())
+  {
+    kernel::RandomFourierFeatures rff(kernel, data.n_rows, rank, UseFastfood);
+    arma::mat features;
+    rff.Transform(data, features);
+
+    // Centering the features centers the approximate kernel matrix exactly.
+    features.each_col() -= arma::mean(features, 1);
+
+    // Eigendecompose the (uncentered) covariance of the features.
+    arma::eig_sym(eigval, eigvec, features * features.t());
+
+    // Swap the eigenvalues since they are ordered backwards (we need largest
+    // to smallest).
+    for (size_t i = 0; i < floor(eigval.n_elem / 2.0); ++i)
+      eigval.swap_rows(i, (eigval.n_elem - 1) - i);
+
+    // Flip the coefficients to produce the same effect.
+    eigvec = arma::fliplr(eigvec);
+
+    transformedData = eigvec.t() * features;
+  }
+};
+
+} // namespace kpca
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file centroid_update.hpp
+ *
+ * Helpers to accumulate points of any element type into centroids, which are
+ * always held in double precision, and to combine the centroid sums of several
+ * threads.  This lets KMeans cluster arma::fmat data without converting the
+ * whole dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_CENTROID_UPDATE_HPP
+#define MLPACK_METHODS_KMEANS_CENTROID_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * Add the given point to the given column of a centroid matrix.  If the point
+ * holds doubles (dense or sparse), this is just operator+=.
+ */
+template<typename CentroidType, typename VecType>
+inline void AddPoint(
+    CentroidType&& centroid,
+    const VecType& point,
+    const typename std::enable_if<std::is_same<typename VecType::elem_type,
+        double>::value>::type* = 0)
+{
+  centroid += point;
+}
+
+/**
+ * Add the given point to the given column of a centroid matrix, converting
+ * each element to double.  This avoids building a temporary vector for each
+ * point.
+ */
+template<typename CentroidType, typename VecType>
+inline void AddPoint(
+    CentroidType&& centroid,
+    const VecType& point,
+    const typename std::enable_if<!std::is_same<typename VecType::elem_type,
+        double>::value>::type* = 0)
+{
+  for (size_t d = 0; d < point.n_elem; ++d)
+    centroid[d] += (double) point[d];
+}
+
+/**
+ * Return the given point as a double-precision dense vector.
+ */
+template<typename VecType>
+inline arma::vec ToCentroid(
+    const VecType& point,
+    const typename std::enable_if<std::is_same<typename VecType::elem_type,
+        double>::value>::type* = 0)
+{
+  return arma::vec(point);
+}
+
+template<typename VecType>
+inline arma::vec ToCentroid(
+    const VecType& point,
+    const typename std::enable_if<!std::is_same<typename VecType::elem_type,
+        double>::value>::type* = 0)
+{
+  return arma::conv_to<arma::vec>::from(point);
+}
+
+/**
+ * Combine per-thread centroid sums and counts into those of thread 0, in
+ * log2(numThreads) rounds where pairs of threads are merged at once.  This must
+ * be called by every thread of a parallel region, after each thread has filled
+ * sums[thread] and counts[thread].
+ */
+inline void ReduceThreadSums(std::vector<arma::mat>& sums,
+                             std::vector<arma::Col<size_t>>& counts,
+                             const size_t thread,
+                             const size_t numThreads)
+{
+  for (size_t step = 1; step < numThreads; step *= 2)
+  {
+    #pragma omp barrier
+    if (thread % (2 * step) == 0 && thread + step < numThreads)
+    {
+      sums[thread] += sums[thread + step];
+      counts[thread] += counts[thread + step];
+    }
+  }
+
+  // Make sure no thread leaves before the last merge is done.
+  #pragma omp barrier
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
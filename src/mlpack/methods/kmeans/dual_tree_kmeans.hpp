@@ -30,6 +30,11 @@ namespace kmeans {
  * dataset.  The conditions under which this will perform best are probably
  * limited to the case where k is close to the number of points in the dataset,
  * and the number of iterations of the k-means algorithm will be few.
+ *
+ * If OpenMP is available, each iteration runs in parallel: the top of the tree
+ * on the points is split into disjoint subtrees that are traversed by different
+ * threads, and the bounds of large subtrees are updated as separate tasks
+ * between iterations.
  */
 template<
     typename MetricType,
@@ -73,6 +78,10 @@ class DualTreeKMeans
                  arma::mat& newCentroids,
                  arma::Col<size_t>& counts);
 
+  //! Get the minimum number of points in a subtree for its bounds to be
+  //! updated by a separate task.
+  static size_t MinimumParallelSize() { return 1024; }
+
   //! Return the number of distance calculations.
   size_t DistanceCalculations() const { return distanceCalculations; }
   //! Modify the number of distance calculations.
@@ -97,12 +106,14 @@ class DualTreeKMeans
   arma::vec upperBounds;
   //! Lower bounds on second closest cluster distance for each point.
   arma::vec lowerBounds;
-  //! Indicator of whether or not the point is pruned.
-  std::vector<bool> prunedPoints;
+  //! Indicator of whether or not the point is pruned.  This is not a
+  //! std::vector<bool>, so that different threads can set the indicators of
+  //! different points.
+  std::vector<char> prunedPoints;
 
   arma::Row<size_t> assignments;
 
-  std::vector<bool> visited; // Was the point visited this iteration?
+  std::vector<char> visited; // Was the point visited this iteration?
 
   arma::mat lastIterationCentroids; // For sanity checks.
 
@@ -119,6 +130,12 @@ class DualTreeKMeans
                   const double parentLowerBound = DBL_MAX,
                   const double adjustedParentLowerBound = 0.0);
 
+  //! Run the dual-tree traversal of the tree on the points against the tree on
+  //! the centroids with the given rules, splitting the tree between the
+  //! threads.
+  template<typename RuleType>
+  void Traverse(const RuleType& rules, Tree& centroidTree);
+
   //! Extract the centroids of the clusters.
   void ExtractCentroids(Tree& node,
                         arma::mat& newCentroids,
@@ -19,6 +19,19 @@
 #include "dual_tree_kmeans.hpp"
 
 #include "dual_tree_kmeans_rules.hpp"
+#include "centroid_update.hpp"
+#include <mlpack/core/tree/instrumented_rules.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+// Updating the bounds of subtrees concurrently needs OpenMP tasks (OpenMP 3.0);
+// with older implementations, such as Visual Studio's, the bounds are updated
+// serially.
+#if defined(HAS_OPENMP) && defined(_OPENMP) && (_OPENMP >= 200805)
+  #define MLPACK_DUAL_TREE_KMEANS_USE_TASKS
+#endif
 
 namespace mlpack {
 namespace kmeans {
@@ -100,9 +113,11 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     arma::Col<size_t>& counts)
 {
   // Build a tree on the centroids.  This will make a copy if necessary, which
-  // is unfortunate, but I don't see a reasonable way around it.
+  // is unfortunate, but I don't see a reasonable way around it.  The tree holds
+  // the same type of matrix as the dataset, so the centroids are converted.
   std::vector<size_t> oldFromNewCentroids;
-  Tree* centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
+  Tree* centroidTree = BuildTree<Tree>(arma::conv_to<MatType>::from(centroids),
+      oldFromNewCentroids);
 
   // Find the nearest neighbors of each of the clusters.  We have to make our
   // own TreeType, which is a little bit abuse, but we know for sure the
@@ -136,7 +151,16 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
 
     Timer::Stop("knn");
 
+#ifdef MLPACK_DUAL_TREE_KMEANS_USE_TASKS
+    // The bounds of large subtrees are updated as tasks.
+    #pragma omp parallel if(dataset.n_cols >= MinimumParallelSize())
+    {
+      #pragma omp single
+      UpdateTree(*tree, centroids);
+    }
+#else
     UpdateTree(*tree, centroids);
+#endif
 
     for (size_t i = 0; i < dataset.n_cols; ++i)
       visited[i] = false;
@@ -150,22 +174,18 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
 
   // We won't use the KNN class here because we have our own set of rules.
   lastIterationCentroids = centroids;
-  typedef DualTreeKMeansRules<MetricType, Tree> RuleType;
+  typedef tree::TraversalRules<DualTreeKMeansRules<MetricType, Tree>> RuleType;
   RuleType rules(nns.ReferenceTree().Dataset(), dataset, assignments,
       upperBounds, lowerBounds, metric, prunedPoints, oldFromNewCentroids,
       visited);
 
-  typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
-      traverser(rules);
-
   Timer::Start("tree_mod");
   CoalesceTree(*tree);
   Timer::Stop("tree_mod");
 
   // Set the number of pruned centroids in the root to 0.
   tree->Stat().Pruned() = 0;
-  traverser.Traverse(*tree, nns.ReferenceTree());
-  distanceCalculations += rules.BaseCases() + rules.Scores();
+  Traverse(rules, nns.ReferenceTree());
 
   Timer::Start("tree_mod");
   DecoalesceTree(*tree);
@@ -206,6 +226,83 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   return std::sqrt(residual);
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void DualTreeKMeans<MetricType, MatType, TreeType>::Traverse(
+    const RuleType& rules,
+    Tree& centroidTree)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+  numThreads = omp_get_max_threads();
+  #endif
+
+  // Expand the top of the tree, largest node first, until there are enough
+  // subtrees for every thread to have a few.  Statically pruned nodes are not
+  // expanded, and not traversed either, since Score() would prune them at once.
+  // The expanded nodes are never scored, so like the root they are marked as
+  // having no pruned centroids; the roots of the subtrees then take their
+  // bounds from them when they are scored.
+  std::vector<Tree*> subtrees(1, tree);
+  while (numThreads > 1 && subtrees.size() < 4 * numThreads)
+  {
+    size_t largest = subtrees.size();
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (subtrees[i]->NumChildren() > 0 &&
+          !subtrees[i]->Stat().StaticPruned() &&
+          (largest == subtrees.size() || subtrees[i]->NumDescendants() >
+          subtrees[largest]->NumDescendants()))
+        largest = i;
+    }
+
+    // Every subtree is a leaf or statically pruned.
+    if (largest == subtrees.size())
+      break;
+
+    Tree* node = subtrees[largest];
+    node->Stat().Pruned() = 0;
+    subtrees[largest] = &node->Child(0);
+    for (size_t i = 1; i < node->NumChildren(); ++i)
+      subtrees.push_back(&node->Child(i));
+  }
+
+  // Every point belongs to exactly one subtree, so the bounds and assignments
+  // of each point, and the statistics of each node below the split, are only
+  // touched by one copy of the rules.
+  std::vector<RuleType> threadRules(numThreads, rules);
+
+  #pragma omp parallel num_threads(numThreads)
+  {
+    size_t thread = 0;
+    #ifdef HAS_OPENMP
+    thread = omp_get_thread_num();
+    #endif
+
+    RuleType& rule = threadRules[thread];
+    typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
+        traverser(rule);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+    {
+      if (subtrees[i]->Stat().StaticPruned())
+        continue;
+
+      rule.TraversalInfo() = rules.TraversalInfo();
+      traverser.Traverse(*subtrees[i], centroidTree);
+    }
+  }
+
+  for (size_t i = 0; i < threadRules.size(); ++i)
+    distanceCalculations += threadRules[i].BaseCases() +
+        threadRules[i].Scores();
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -328,6 +425,7 @@ visited[node.Descendant(i)] << ".\n";
                    node.MaxDistance(centroids.col(node.Stat().Owner())));
       adjustedUpperBound = node.Stat().UpperBound();
 
+      #pragma omp atomic
       ++distanceCalculations;
       if (node.Stat().UpperBound() < node.Stat().LowerBound())
         node.Stat().StaticPruned() = true;
@@ -339,15 +437,29 @@ visited[node.Descendant(i)] << ".\n";
   }
 
   // Recurse into children, and if all the children (and all the points) are
-  // pruned, then we can mark this as statically pruned.
-  bool allChildrenPruned = true;
+  // pruned, then we can mark this as statically pruned.  The children only
+  // touch their own descendants, so large children are updated as tasks.
+  const arma::mat* centroidsPtr = &centroids;
   for (size_t i = 0; i < node.NumChildren(); ++i)
   {
-    UpdateTree(node.Child(i), centroids, unadjustedUpperBound,
-        adjustedUpperBound, unadjustedLowerBound, adjustedLowerBound);
+    Tree* child = &node.Child(i);
+#ifdef MLPACK_DUAL_TREE_KMEANS_USE_TASKS
+    #pragma omp task if(child->NumDescendants() >= MinimumParallelSize()) \
+        firstprivate(child, centroidsPtr, unadjustedUpperBound, \
+        adjustedUpperBound, unadjustedLowerBound, adjustedLowerBound)
+#endif
+    UpdateTree(*child, *centroidsPtr, unadjustedUpperBound, adjustedUpperBound,
+        unadjustedLowerBound, adjustedLowerBound);
+  }
+
+#ifdef MLPACK_DUAL_TREE_KMEANS_USE_TASKS
+  #pragma omp taskwait
+#endif
+
+  bool allChildrenPruned = true;
+  for (size_t i = 0; i < node.NumChildren(); ++i)
     if (!node.Child(i).Stat().StaticPruned())
       allChildrenPruned = false;
-  }
 
   bool allPointsPruned = true;
   if (tree::TreeTraits<Tree>::HasSelfChildren && node.NumChildren() > 0)
@@ -400,6 +512,7 @@ visited[node.Descendant(i)] << ".\n";
         // Attempt to tighten the bound.
         upperBounds[index] = metric.Evaluate(dataset.col(index),
                                              centroids.col(owner));
+        #pragma omp atomic
         ++distanceCalculations;
         if (upperBounds[index] < pruningLowerBound)
         {
@@ -526,7 +639,7 @@ node.Stat().UpperBound() << " and owner " << node.Stat().Owner() << ".\n";
       for (size_t i = 0; i < node.NumPoints(); ++i)
       {
         const size_t owner = assignments[node.Point(i)];
-        newCentroids.col(owner) += dataset.col(node.Point(i));
+        AddPoint(newCentroids.col(owner), dataset.col(node.Point(i)));
         ++newCounts[owner];
 
 /*
@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_KMEANS_DUAL_TREE_KMEANS_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include "centroid_update.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -23,15 +24,18 @@ template<typename MetricType, typename TreeType>
 class DualTreeKMeansRules
 {
  public:
-  DualTreeKMeansRules(const arma::mat& centroids,
-                      const arma::mat& dataset,
+  //! The type of the matrices held by the trees.
+  typedef typename TreeType::Mat MatType;
+
+  DualTreeKMeansRules(const MatType& centroids,
+                      const MatType& dataset,
                       arma::Row<size_t>& assignments,
                       arma::vec& upperBounds,
                       arma::vec& lowerBounds,
                       MetricType& metric,
-                      const std::vector<bool>& prunedPoints,
+                      const std::vector<char>& prunedPoints,
                       const std::vector<size_t>& oldFromNewCentroids,
-                      std::vector<bool>& visited);
+                      std::vector<char>& visited);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -56,18 +60,18 @@ class DualTreeKMeansRules
   size_t& Scores() { return scores; }
 
  private:
-  const arma::mat& centroids;
-  const arma::mat& dataset;
+  const MatType& centroids;
+  const MatType& dataset;
   arma::Row<size_t>& assignments;
   arma::vec& upperBounds;
   arma::vec& lowerBounds;
   MetricType& metric;
 
-  const std::vector<bool>& prunedPoints;
+  const std::vector<char>& prunedPoints;
 
   const std::vector<size_t>& oldFromNewCentroids;
 
-  std::vector<bool>& visited;
+  std::vector<char>& visited;
 
   size_t baseCases;
   size_t scores;
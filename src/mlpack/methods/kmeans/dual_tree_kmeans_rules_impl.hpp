@@ -19,15 +19,15 @@ namespace kmeans {
 
 template<typename MetricType, typename TreeType>
 DualTreeKMeansRules<MetricType, TreeType>::DualTreeKMeansRules(
-    const arma::mat& centroids,
-    const arma::mat& dataset,
+    const MatType& centroids,
+    const MatType& dataset,
     arma::Row<size_t>& assignments,
     arma::vec& upperBounds,
     arma::vec& lowerBounds,
     MetricType& metric,
-    const std::vector<bool>& prunedPoints,
+    const std::vector<char>& prunedPoints,
     const std::vector<size_t>& oldFromNewCentroids,
-    std::vector<bool>& visited) :
+    std::vector<char>& visited) :
     centroids(centroids),
     dataset(dataset),
     assignments(assignments),
@@ -251,9 +251,10 @@ inline double DualTreeKMeansRules<MetricType, TreeType>::Score(
     }
     else if (distances.Hi() < queryNode.Stat().UpperBound())
     {
-      // Tighten upper bound.
-      const double tighterBound =
-          queryNode.MaxDistance(centroids.col(referenceNode.Descendant(0)));
+      // Tighten upper bound.  Not every tree type takes a point of any
+      // element type here, so pass a double-precision copy.
+      const double tighterBound = queryNode.MaxDistance(
+          ToCentroid(centroids.col(referenceNode.Descendant(0))));
       ++scores; // Count extra distance calculation.
 
       if (tighterBound <= queryNode.Stat().UpperBound())
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_KMEANS_DTNN_STATISTIC_HPP
 
 #include <mlpack/methods/neighbor_search/neighbor_search_stat.hpp>
+#include "centroid_update.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -57,7 +58,7 @@ class DualTreeKMeansStatistic : public
       if (tree::TreeTraits<TreeType>::HasSelfChildren && i == 0 &&
           node.NumChildren() > 0)
         continue;
-      centroid += node.Dataset().col(node.Point(i));
+      AddPoint(centroid, node.Dataset().col(node.Point(i)));
     }
 
     for (size_t i = 0; i < node.NumChildren(); ++i)
@@ -18,6 +18,7 @@
 #include "sample_initialization.hpp"
 #include "max_variance_new_cluster.hpp"
 #include "naive_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
 
@@ -61,9 +62,12 @@ namespace kmeans /** K-Means clustering. */ {
  *     arma::mat& newCentroids, arma::Col<size_t>& counts, MetricType& metric,
  *     const size_t iteration)'.
  * @tparam LloydStepType Implementation of single Lloyd step to use.
+ * @tparam MatType Type of data matrix.  Centroids are always held in double
+ *     precision, so single-precision data (arma::fmat) can be clustered with
+ *     any of the Lloyd step types without converting it.
  *
  * @see RandomPartition, SampleInitialization, RefinedStart, AllowEmptyClusters,
- *      MaxVarianceNewCluster, NaiveKMeans, ElkanKMeans
+ *      MaxVarianceNewCluster, NaiveKMeans, ElkanKMeans, MiniBatchKMeans
  */
 template<typename MetricType = metric::EuclideanDistance,
          typename InitialPartitionPolicy = SampleInitialization,
@@ -98,7 +102,7 @@ class KMeans
    * initial guess of the cluster assignments; to do this, set initialGuess to
    * true.
    *
-   * @tparam MatType Type of matrix (arma::mat or arma::sp_mat).
+   * @tparam MatType Type of matrix (arma::mat, arma::fmat or arma::sp_mat).
    * @param data Dataset to cluster.
    * @param clusters Number of clusters to compute.
    * @param assignments Vector to store cluster assignments in.
@@ -116,7 +120,7 @@ class KMeans
    * specified by filling the centroids matrix with the initial centroids and
    * specifying initialGuess = true.
    *
-   * @tparam MatType Type of matrix (arma::mat or arma::sp_mat).
+   * @tparam MatType Type of matrix (arma::mat, arma::fmat or arma::sp_mat).
    * @param data Dataset to cluster.
    * @param clusters Number of clusters to compute.
    * @param centroids Matrix in which centroids are stored.
@@ -138,7 +142,7 @@ class KMeans
    * supersedes initialCentroidGuess, so if both are set to true, the
    * assignments vector is used.
    *
-   * @tparam MatType Type of matrix (arma::mat or arma::sp_mat).
+   * @tparam MatType Type of matrix (arma::mat, arma::fmat or arma::sp_mat).
    * @param data Dataset to cluster.
    * @param clusters Number of clusters to compute.
    * @param assignments Vector to store cluster assignments in.
@@ -155,6 +159,71 @@ class KMeans
                const bool initialAssignmentGuess = false,
                const bool initialCentroidGuess = false);
 
+  /**
+   * Run k-means the given number of times, each time from different initial
+   * centroids given by the InitialPartitionPolicy, and keep the clustering
+   * with the lowest inertia (the sum of the squared distances of the points to
+   * their centroids).  The restarts run in parallel with OpenMP, each one on a
+   * single thread, and share the dataset.  Each restart draws its random
+   * numbers from its own stream, so for a given random seed the result doesn't
+   * depend on the number of threads (unless restarts are pruned, see below).
+   *
+   * Restarts that are clearly losing are stopped early: after pruneIteration
+   * iterations, a restart whose inertia is more than pruneRatio times the
+   * inertia of the best restart finished so far is abandoned.  Since the
+   * inertia only decreases with the iterations, such a restart would rarely
+   * catch up.  Set pruneRatio to 0 to run every restart to convergence.
+   *
+   * @param data Dataset to cluster.
+   * @param clusters Number of clusters to compute.
+   * @param restarts Number of clusterings to run.
+   * @param assignments Vector to store the cluster assignments in.
+   * @param centroids Matrix to store the centroids in.
+   * @param pruneIteration Iteration after which losing restarts are stopped.
+   * @param pruneRatio Inertia ratio to the best restart above which a restart
+   *     is stopped (0 disables pruning).
+   * @return The inertia of the returned clustering.
+   */
+  double ClusterWithRestarts(const MatType& data,
+                             const size_t clusters,
+                             const size_t restarts,
+                             arma::Row<size_t>& assignments,
+                             arma::mat& centroids,
+                             const size_t pruneIteration = 5,
+                             const double pruneRatio = 1.5);
+
+  /**
+   * Update the centroids with a batch of points, for clustering data that is
+   * streamed in batches (and may never fit in memory).  Each centroid is moved
+   * towards the points of the batch closest to it, with learning rate
+   * 1 / (number of points assigned to it so far); see MiniBatchKMeans.  The
+   * LloydStepType is not used.
+   *
+   * If centroids is empty, the InitialPartitionPolicy is first run on the
+   * batch to find the initial centroids, and counts is reset.  After the
+   * batch, the EmptyClusterPolicy is called for each cluster that has not had
+   * any point assigned to it yet.
+   *
+   * @code
+   * KMeans<> k;
+   * arma::mat centroids;
+   * arma::Col<size_t> counts;
+   * while (LoadNextBatch(batch))
+   *   k.Update(batch, 10, centroids, counts);
+   * @endcode
+   *
+   * @param batch Batch of points.
+   * @param clusters Number of clusters to compute (only used when centroids is
+   *     empty).
+   * @param centroids Current centroids, to be updated.
+   * @param counts Number of points assigned to each cluster so far, to be
+   *     updated.
+   */
+  void Update(const MatType& batch,
+              const size_t clusters,
+              arma::mat& centroids,
+              arma::Col<size_t>& counts);
+
   //! Get the maximum number of iterations.
   size_t MaxIterations() const { return maxIterations; }
   //! Set the maximum number of iterations.
@@ -181,6 +250,16 @@ class KMeans
   void serialize(Archive& ar, const unsigned int version);
 
  private:
+  /**
+   * Assign each point to its closest centroid, and return the inertia of the
+   * clustering (the sum of the squared distances of the points to their
+   * centroids).
+   */
+  static double Assign(const MatType& data,
+                       const arma::mat& centroids,
+                       MetricType& metric,
+                       arma::Row<size_t>& assignments);
+
   //! Maximum number of iterations before giving up.
   size_t maxIterations;
   //! Instantiated distance metric.
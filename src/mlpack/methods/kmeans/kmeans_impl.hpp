@@ -14,6 +14,7 @@
 
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/util/sfinae_utility.hpp>
+#include "centroid_update.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -78,6 +79,28 @@ bool GetInitialAssignmentsOrCentroids(
   return false;
 }
 
+//! Compute the centroid of each cluster from the given assignments.  The
+//! centroids of empty clusters are left at the origin.
+template<typename MatType>
+void CentroidsFromAssignments(const MatType& data,
+                              const size_t clusters,
+                              const arma::Row<size_t>& assignments,
+                              arma::mat& centroids)
+{
+  arma::Row<size_t> counts;
+  counts.zeros(clusters);
+  centroids.zeros(data.n_rows, clusters);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    centroids.col(assignments[i]) += ToCentroid(data.col(i));
+    counts[assignments[i]]++;
+  }
+
+  for (size_t i = 0; i < clusters; ++i)
+    if (counts[i] != 0)
+      centroids.col(i) /= counts[i];
+}
+
 /**
  * Construct the K-Means object.
  */
@@ -187,18 +210,7 @@ Cluster(const MatType& data,
     {
       // The partitioner gives assignments, so we need to calculate centroids
       // from those assignments.
-      arma::Row<size_t> counts;
-      counts.zeros(clusters);
-      centroids.zeros(data.n_rows, clusters);
-      for (size_t i = 0; i < data.n_cols; ++i)
-      {
-        centroids.col(assignments[i]) += arma::vec(data.col(i));
-        counts[assignments[i]]++;
-      }
-
-      for (size_t i = 0; i < clusters; ++i)
-        if (counts[i] != 0)
-          centroids.col(i) /= counts[i];
+      CentroidsFromAssignments(data, clusters, assignments, centroids);
     }
   }
 
@@ -294,27 +306,190 @@ Cluster(const MatType& data,
           << data.n_cols << ")!" << std::endl;
 
     // Calculate initial centroids.
-    arma::Row<size_t> counts;
-    counts.zeros(clusters);
-    centroids.zeros(data.n_rows, clusters);
-    for (size_t i = 0; i < data.n_cols; ++i)
-    {
-      centroids.col(assignments[i]) += arma::vec(data.col(i));
-      counts[assignments[i]]++;
-    }
-
-    for (size_t i = 0; i < clusters; ++i)
-      if (counts[i] != 0)
-        centroids.col(i) /= counts[i];
+    CentroidsFromAssignments(data, clusters, assignments, centroids);
   }
 
   Cluster(data, clusters, centroids,
       initialAssignmentGuess || initialCentroidGuess);
 
   // Calculate final assignments in parallel over the entire dataset.
+  Assign(data, centroids, metric, assignments);
+}
+
+/**
+ * Run k-means several times from different initial centroids, in parallel, and
+ * keep the best clustering.
+ */
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+double KMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+ClusterWithRestarts(const MatType& data,
+                    const size_t clusters,
+                    const size_t restarts,
+                    arma::Row<size_t>& assignments,
+                    arma::mat& centroids,
+                    const size_t pruneIteration,
+                    const double pruneRatio)
+{
+  if (restarts == 0)
+    Log::Fatal << "KMeans::ClusterWithRestarts(): the number of restarts must "
+        << "be positive!" << std::endl;
+
+  if (clusters > data.n_cols)
+    Log::Warn << "KMeans::ClusterWithRestarts(): more clusters requested than "
+        << "points given." << std::endl;
+  else if (clusters == 0)
+    Log::Warn << "KMeans::ClusterWithRestarts(): zero clusters requested.  "
+        << "This probably isn't going to work.  Brace for crash." << std::endl;
+
+  // Draw the key of the random stream of each restart beforehand, so that the
+  // numbers a restart draws don't depend on the thread that runs it.
+  std::vector<uint64_t> keys(restarts);
+  for (size_t r = 0; r < restarts; ++r)
+    keys[r] = math::RandKey();
+
+  std::vector<arma::mat> results(restarts);
+  // The inertia of each restart; pruned restarts keep DBL_MAX.
+  arma::vec inertias(restarts);
+  inertias.fill(DBL_MAX);
+  // The lowest inertia of the restarts finished so far.
+  double bestInertia = DBL_MAX;
+
+  // The restarts run in parallel, so the BLAS calls of each use one thread.
+  util::SingleThreadedBLAS singleThreadedBLAS;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t r = 0; r < (omp_size_t) restarts; ++r)
+  {
+    // The restart draws from its own stream, whatever the thread running it
+    // and the number of threads.
+    math::ThreadRandomStream stream(keys[r]);
+
+    // The policies may keep state, so each restart has its own copies.
+    MetricType restartMetric(metric);
+    InitialPartitionPolicy restartPartitioner(partitioner);
+    EmptyClusterPolicy restartEmptyClusterAction(emptyClusterAction);
+
+    arma::mat& restartCentroids = results[r];
+    arma::Row<size_t> initialAssignments;
+    if (GetInitialAssignmentsOrCentroids(restartPartitioner, data, clusters,
+        initialAssignments, restartCentroids))
+    {
+      CentroidsFromAssignments(data, clusters, initialAssignments,
+          restartCentroids);
+    }
+
+    // This is the loop of Cluster(), without the logging, and with the check
+    // for pruning.
+    arma::Col<size_t> counts(clusters);
+    size_t iteration = 0;
+    LloydStepType<MetricType, MatType> lloydStep(data, restartMetric);
+    arma::mat centroidsOther;
+    double cNorm;
+    bool pruned = false;
+
+    do
+    {
+      if (iteration % 2 == 0)
+        cNorm = lloydStep.Iterate(restartCentroids, centroidsOther, counts);
+      else
+        cNorm = lloydStep.Iterate(centroidsOther, restartCentroids, counts);
+
+      for (size_t i = 0; i < counts.n_elem; i++)
+      {
+        if (counts[i] == 0)
+        {
+          if (iteration % 2 == 0)
+            restartEmptyClusterAction.EmptyCluster(data, i, restartCentroids,
+                centroidsOther, counts, restartMetric, iteration);
+          else
+            restartEmptyClusterAction.EmptyCluster(data, i, centroidsOther,
+                restartCentroids, counts, restartMetric, iteration);
+        }
+      }
+
+      iteration++;
+      if (std::isnan(cNorm) || std::isinf(cNorm))
+        cNorm = 1e-4; // Keep iterating.
+
+      // Stop the restart if it is clearly worse than the best one so far.
+      if (pruneRatio > 0.0 && iteration == pruneIteration && cNorm > 1e-5 &&
+          iteration != maxIterations)
+      {
+        double best;
+        #pragma omp critical(kmeans_restarts_best)
+        best = bestInertia;
+
+        if (best != DBL_MAX)
+        {
+          arma::Row<size_t> currentAssignments;
+          const arma::mat& current = (iteration % 2 == 1) ? centroidsOther :
+              restartCentroids;
+          if (Assign(data, current, restartMetric, currentAssignments) >
+              pruneRatio * best)
+            pruned = true;
+        }
+      }
+    } while (!pruned && cNorm > 1e-5 && iteration != maxIterations);
+
+    if (pruned)
+    {
+      restartCentroids.reset();
+      continue;
+    }
+
+    // If we ended on an even iteration, then the centroids are in the
+    // centroidsOther matrix.
+    if ((iteration - 1) % 2 == 0)
+      restartCentroids.steal_mem(centroidsOther);
+
+    arma::Row<size_t> restartAssignments;
+    inertias[r] = Assign(data, restartCentroids, restartMetric,
+        restartAssignments);
+
+    #pragma omp critical(kmeans_restarts_best)
+    bestInertia = std::min(bestInertia, inertias[r]);
+  }
+
+  // At least one restart finished, since restarts are only pruned once another
+  // one has finished.
+  const size_t best = inertias.index_min();
+  Log::Info << "KMeans::ClusterWithRestarts(): restart " << best << " of "
+      << restarts << " has the lowest inertia (" << inertias[best] << "); "
+      << arma::accu(inertias == DBL_MAX) << " restarts were stopped early."
+      << std::endl;
+
+  centroids = std::move(results[best]);
+  return Assign(data, centroids, metric, assignments);
+}
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+double KMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+Assign(const MatType& data,
+       const arma::mat& centroids,
+       MetricType& metric,
+       arma::Row<size_t>& assignments)
+{
   assignments.set_size(data.n_cols);
 
-  #pragma omp parallel for
+  double inertia = 0.0;
+  #pragma omp parallel for reduction(+:inertia)
   for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
     // Find the closest centroid to this point.
@@ -334,6 +509,65 @@ Cluster(const MatType& data,
 
     Log::Assert(closestCluster != centroids.n_cols);
     assignments[i] = closestCluster;
+    inertia += minDistance * minDistance;
+  }
+
+  return inertia;
+}
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void KMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+Update(const MatType& batch,
+       const size_t clusters,
+       arma::mat& centroids,
+       arma::Col<size_t>& counts)
+{
+  if (centroids.n_cols == 0)
+  {
+    if (clusters == 0 || clusters > batch.n_cols)
+      Log::Fatal << "KMeans::Update(): cannot find " << clusters << " initial "
+          << "centroids from a batch of " << batch.n_cols << " points!"
+          << std::endl;
+
+    // Get the initial centroids from the first batch, just like Cluster().
+    arma::Row<size_t> assignments;
+    if (GetInitialAssignmentsOrCentroids(partitioner, batch, clusters,
+        assignments, centroids))
+      CentroidsFromAssignments(batch, clusters, assignments, centroids);
+
+    counts.zeros(centroids.n_cols);
+  }
+
+  if (batch.n_rows != centroids.n_rows)
+    Log::Fatal << "KMeans::Update(): batch has dimensionality " << batch.n_rows
+        << ", but centroids have dimensionality " << centroids.n_rows << "!"
+        << std::endl;
+
+  // The number of points seen before this batch identifies the batch to the
+  // EmptyClusterPolicy, like the iteration number does in Cluster().
+  const size_t seen = arma::accu(counts);
+
+  const arma::mat oldCentroids(centroids);
+  MiniBatchKMeans<MetricType, MatType>::Update(batch, metric, centroids,
+      counts);
+
+  for (size_t i = 0; i < counts.n_elem; i++)
+  {
+    if (counts[i] == 0)
+    {
+      Log::Info << "Cluster " << i << " is empty.\n";
+      emptyClusterAction.EmptyCluster(batch, i, oldCentroids, centroids,
+          counts, metric, seen);
+    }
   }
 }
 
@@ -21,6 +21,7 @@
 #include "hamerly_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
 
 using namespace mlpack;
 using namespace mlpack::kmeans;
@@ -49,8 +50,10 @@ PROGRAM_INFO("K-Means Clustering", "This program performs K-Means clustering "
     "options include the Pelleg-Moore tree-based algorithm ('pelleg-moore'), "
     "Elkan's triangle-inequality based algorithm ('elkan'), Hamerly's "
     "modification to Elkan's algorithm ('hamerly'), the dual-tree k-means "
-    "algorithm ('dualtree'), and the dual-tree k-means algorithm using the "
-    "cover tree ('dualtree-covertree')."
+    "algorithm ('dualtree'), the dual-tree k-means algorithm using the "
+    "cover tree ('dualtree-covertree'), and approximate mini-batch k-means, "
+    "which only looks at a random sample of 1000 points per iteration "
+    "('minibatch')."
     "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the " + PRINT_PARAM_STRING("allow_empty_clusters") + " option.  When "
@@ -65,6 +68,13 @@ PROGRAM_INFO("K-Means Clustering", "This program performs K-Means clustering "
     "calculate; therefore, specifying either of these parameters will often "
     "accelerate runtime."
     "\n\n"
+    "K-means can be run several times from different initial centroids with "
+    "the " + PRINT_PARAM_STRING("restarts") + " parameter; the restarts run in "
+    "parallel, and the clustering with the lowest inertia (sum of squared "
+    "distances of the points to their centroids) is kept.  Restarts whose "
+    "inertia is much higher than that of the best finished restart after a "
+    "few iterations are stopped early."
+    "\n\n"
     "Initial clustering assignments may be specified using the " +
     PRINT_PARAM_STRING("initial_centroids") + " parameter, and the maximum "
     "number of iterations may be specified with the " +
@@ -111,6 +121,9 @@ PARAM_INT_IN("max_iterations", "Maximum number of iterations before k-means "
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 PARAM_MATRIX_IN("initial_centroids", "Start with the specified initial "
     "centroids.", "I");
+PARAM_INT_IN("restarts", "Number of times k-means is run from different "
+    "initial centroids; the clustering with the lowest inertia is kept.", "R",
+    1);
 
 // Parameters for "refined start" k-means.
 PARAM_FLAG("refined_start", "Use the refined initial point strategy by Bradley "
@@ -121,8 +134,12 @@ PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
     "start sampling (use when --refined_start is specified).", "p", 0.02);
 
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
-    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
-    "'dualtree-covertree').", "a", "naive");
+    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', "
+    "'dualtree-covertree', or 'minibatch').", "a", "naive");
+PARAM_STRING_IN("precision", "Precision to cluster the data in ('double' or "
+    "'float').  With 'float', the points are converted to single precision "
+    "before clustering; the centroids are still computed in double "
+    "precision.", "", "double");
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -140,6 +157,21 @@ template<typename InitialPartitionPolicy,
          template<class, class> class LloydStepType>
 void RunKMeans(const InitialPartitionPolicy& ipp);
 
+// Run k-means on the given dataset, which may be of any matrix type.
+template<typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void ClusterDataset(const MatType& dataset,
+                    const InitialPartitionPolicy& ipp,
+                    const size_t maxIterations,
+                    const size_t clusters,
+                    const size_t restarts,
+                    const bool initialCentroidGuess,
+                    const bool computeAssignments,
+                    arma::Row<size_t>& assignments,
+                    arma::mat& centroids);
+
 static void mlpackMain()
 {
   // Initialize random seed.
@@ -193,8 +225,8 @@ template<typename InitialPartitionPolicy, typename EmptyClusterPolicy>
 void FindLloydStepType(const InitialPartitionPolicy& ipp)
 {
   RequireParamInSet<string>("algorithm", { "elkan", "hamerly", "pelleg-moore",
-      "dualtree", "dualtree-covertree", "naive" }, true, "unknown k-means "
-      "algorithm");
+      "dualtree", "dualtree-covertree", "naive", "minibatch" }, true,
+      "unknown k-means algorithm");
 
   const string algorithm = CLI::GetParam<string>("algorithm");
   if (algorithm == "elkan")
@@ -212,6 +244,9 @@ void FindLloydStepType(const InitialPartitionPolicy& ipp)
         CoverTreeDualTreeKMeans>(ipp);
   else if (algorithm == "naive")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, NaiveKMeans>(ipp);
+  else if (algorithm == "minibatch")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        MiniBatchKMeans>(ipp);
 }
 
 // Given the template parameters, sanitize/load input and run k-means.
@@ -242,6 +277,12 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
     "maximum iterations must be positive or 0 (for no limit)");
   const int maxIterations = CLI::GetParam<int>("max_iterations");
 
+  RequireParamValue<int>("restarts", [](int x) { return x > 0; }, true,
+      "number of restarts must be positive");
+  ReportIgnoredParam({{ "initial_centroids", true }}, "restarts");
+  const size_t restarts = CLI::HasParam("initial_centroids") ? 1 :
+      (size_t) CLI::GetParam<int>("restarts");
+
   // Make sure we have an output file if we're not doing the work in-place.
   RequireAtLeastOnePassed({ "in_place", "output", "centroid" }, false,
       "no results will be saved");
@@ -263,20 +304,38 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
       Log::Info << "Using initial centroid guesses." << endl;
   }
 
+  RequireParamInSet<string>("precision", { "double", "float" }, true,
+      "unknown precision");
+
+  // The assignments are only needed if we are saving them.
+  const bool computeAssignments = CLI::HasParam("output") ||
+      CLI::HasParam("in_place");
+  arma::Row<size_t> assignments;
+
   Timer::Start("clustering");
-  KMeans<metric::EuclideanDistance,
-         InitialPartitionPolicy,
-         EmptyClusterPolicy,
-         LloydStepType> kmeans(maxIterations, metric::EuclideanDistance(), ipp);
+  if (CLI::GetParam<string>("precision") == "float")
+  {
+    const arma::fmat floatDataset = arma::conv_to<arma::fmat>::from(dataset);
+
+    // The double-precision copy is only needed if it is part of the output.
+    if (!CLI::HasParam("in_place") && (!CLI::HasParam("output") ||
+        CLI::HasParam("labels_only")))
+      dataset.reset();
 
-  if (CLI::HasParam("output") || CLI::HasParam("in_place"))
+    ClusterDataset<InitialPartitionPolicy, EmptyClusterPolicy,
+        LloydStepType>(floatDataset, ipp, maxIterations, clusters, restarts,
+        initialCentroidGuess, computeAssignments, assignments, centroids);
+  }
+  else
   {
-    // We need to get the assignments.
-    arma::Row<size_t> assignments;
-    kmeans.Cluster(dataset, clusters, assignments, centroids,
-        false, initialCentroidGuess);
-    Timer::Stop("clustering");
+    ClusterDataset<InitialPartitionPolicy, EmptyClusterPolicy,
+        LloydStepType>(dataset, ipp, maxIterations, clusters, restarts,
+        initialCentroidGuess, computeAssignments, assignments, centroids);
+  }
+  Timer::Stop("clustering");
 
+  if (computeAssignments)
+  {
     // Now figure out what to do with our results.
     if (CLI::HasParam("in_place"))
     {
@@ -317,14 +376,46 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
       }
     }
   }
-  else
-  {
-    // Just save the centroids.
-    kmeans.Cluster(dataset, clusters, centroids, initialCentroidGuess);
-    Timer::Stop("clustering");
-  }
 
   // Should we write the centroids to a file?
   if (CLI::HasParam("centroid"))
     CLI::GetParam<arma::mat>("centroid") = std::move(centroids);
 }
+
+// Run k-means on the given dataset, which may be of any matrix type.
+template<typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void ClusterDataset(const MatType& dataset,
+                    const InitialPartitionPolicy& ipp,
+                    const size_t maxIterations,
+                    const size_t clusters,
+                    const size_t restarts,
+                    const bool initialCentroidGuess,
+                    const bool computeAssignments,
+                    arma::Row<size_t>& assignments,
+                    arma::mat& centroids)
+{
+  KMeans<metric::EuclideanDistance,
+         InitialPartitionPolicy,
+         EmptyClusterPolicy,
+         LloydStepType,
+         MatType> kmeans(maxIterations, metric::EuclideanDistance(), ipp);
+
+  if (restarts > 1)
+  {
+    const double inertia = kmeans.ClusterWithRestarts(dataset, clusters,
+        restarts, assignments, centroids);
+    Log::Info << "Inertia of the best clustering: " << inertia << "." << endl;
+  }
+  else if (computeAssignments)
+  {
+    kmeans.Cluster(dataset, clusters, assignments, centroids, false,
+        initialCentroidGuess);
+  }
+  else
+  {
+    kmeans.Cluster(dataset, clusters, centroids, initialCentroidGuess);
+  }
+}
@@ -0,0 +1,128 @@
+/**
+ * @file mini_batch_kmeans.hpp
+ *
+ * An implementation of mini-batch k-means (Sculley, "Web-scale k-means
+ * clustering", 2010) as a Lloyd step type for KMeans.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * MiniBatchKMeans is a Lloyd step type for KMeans that, instead of passing
+ * over the whole dataset, samples a mini-batch of points on each iteration and
+ * moves the centroid closest to each sampled point towards it.  Each centroid
+ * has its own learning rate, 1 / (number of points it has been assigned so
+ * far), so that every centroid is the running mean of the points assigned to
+ * it.  Each iteration only costs O(batchSize * k) distance calculations, at
+ * the expense of an approximate result.
+ *
+ * The per-centroid counts are kept in the counts vector, which KMeans passes
+ * back unchanged (except by the EmptyClusterPolicy) between iterations.
+ *
+ * The static Update() function applies the same update to a batch of points
+ * that is given by the user; KMeans::Update() uses it to cluster data that is
+ * streamed in batches and never held in memory all at once.
+ *
+ * @code
+ * KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+ *     MiniBatchKMeans> k(100);
+ * k.Cluster(data, 10, centroids);
+ * @endcode
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat, arma::fmat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points to sample on each iteration.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = 1000);
+
+  /**
+   * Run a single iteration of mini-batch k-means: sample batchSize points
+   * (with replacement), and move the closest centroid towards each one.  The
+   * counts are cumulative over all the iterations so far.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points assigned to each cluster so far.
+   * @return The norm of the change of the centroids.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  /**
+   * Move the closest centroid towards each point of the given batch.  The
+   * closest centroids are found in parallel (with the centroids as they were
+   * before the batch), and then the points are applied one after another.
+   * counts must hold the number of points assigned to each centroid before
+   * this batch (all zeros for the first batch), and is updated.
+   *
+   * @param batch Batch of points.
+   * @param metric Instantiated metric.
+   * @param centroids Current centroids, to be updated.
+   * @param counts Number of points assigned to each centroid so far.
+   */
+  static void Update(const MatType& batch,
+                     MetricType& metric,
+                     arma::mat& centroids,
+                     arma::Col<size_t>& counts);
+
+  //! Get the number of distance calculations.
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+ private:
+  /**
+   * Apply the update for the given columns of the data.
+   */
+  static void UpdateColumns(const MatType& data,
+                            const arma::Col<size_t>& indices,
+                            MetricType& metric,
+                            arma::mat& centroids,
+                            arma::Col<size_t>& counts);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The number of points to sample on each iteration.
+  size_t batchSize;
+  //! The number of iterations run so far.
+  size_t iteration;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
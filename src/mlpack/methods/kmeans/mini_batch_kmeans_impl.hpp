@@ -0,0 +1,144 @@
+/**
+ * @file mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of the MiniBatchKMeans Lloyd step type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+#include "centroid_update.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric,
+                                                      const size_t batchSize) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    iteration(0),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // On the first iteration, the counts given by KMeans aren't initialized.
+  // After that, they hold the number of points assigned to each cluster so far.
+  if (iteration == 0 || counts.n_elem != centroids.n_cols)
+    counts.zeros(centroids.n_cols);
+  ++iteration;
+
+  // Sample the batch; if it is at least as large as the dataset, just use every
+  // point.
+  arma::Col<size_t> indices;
+  if (batchSize >= dataset.n_cols)
+  {
+    indices.set_size(dataset.n_cols);
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      indices[i] = i;
+  }
+  else
+  {
+    indices.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+      indices[i] = math::RandIndex(dataset.n_cols);
+  }
+
+  newCentroids = centroids;
+  UpdateColumns(dataset, indices, metric, newCentroids, counts);
+  distanceCalculations += indices.n_elem * centroids.n_cols;
+
+  // Calculate how much the centroids moved.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+template<typename MetricType, typename MatType>
+void MiniBatchKMeans<MetricType, MatType>::Update(const MatType& batch,
+                                                  MetricType& metric,
+                                                  arma::mat& centroids,
+                                                  arma::Col<size_t>& counts)
+{
+  if (counts.n_elem != centroids.n_cols)
+    Log::Fatal << "MiniBatchKMeans::Update(): number of counts ("
+        << counts.n_elem << ") does not match number of centroids ("
+        << centroids.n_cols << ")!" << std::endl;
+
+  arma::Col<size_t> indices(batch.n_cols);
+  for (size_t i = 0; i < batch.n_cols; ++i)
+    indices[i] = i;
+
+  UpdateColumns(batch, indices, metric, centroids, counts);
+}
+
+template<typename MetricType, typename MatType>
+void MiniBatchKMeans<MetricType, MatType>::UpdateColumns(
+    const MatType& data,
+    const arma::Col<size_t>& indices,
+    MetricType& metric,
+    arma::mat& centroids,
+    arma::Col<size_t>& counts)
+{
+  // Find the closest centroid to each point of the batch, in parallel.
+  arma::Col<size_t> closest(indices.n_elem);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) indices.n_elem; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(data.col(indices[i]),
+          centroids.unsafe_col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    closest[i] = closestCluster;
+  }
+
+  // Now move each centroid towards its points with learning rate 1 / count;
+  // this keeps each centroid at the mean of all the points assigned to it.
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    const size_t c = closest[i];
+    ++counts[c];
+
+    centroids.col(c) *= double(counts[c] - 1);
+    AddPoint(centroids.col(c), data.col(indices[i]));
+    centroids.col(c) /= double(counts[c]);
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
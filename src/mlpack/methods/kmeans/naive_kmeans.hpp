@@ -15,6 +15,7 @@
 #ifndef MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 
 namespace mlpack {
 namespace kmeans {
@@ -57,6 +58,34 @@ class NaiveKMeans
   size_t DistanceCalculations() const { return distanceCalculations; }
 
  private:
+  /**
+   * Whether the closest centroids can be found with matrix products, which
+   * needs the (squared) Euclidean distance and dense double-precision data.
+   */
+  typedef std::integral_constant<bool,
+      (std::is_same<MetricType, metric::EuclideanDistance>::value ||
+       std::is_same<MetricType, metric::SquaredEuclideanDistance>::value) &&
+      std::is_same<MatType, arma::mat>::value> UseProducts;
+
+  /**
+   * Assign the points handled by this thread to their closest centroids, and
+   * add them to the given sums and counts.  This must be called inside a
+   * parallel region by every thread.
+   */
+  void AssignPoints(const arma::mat& centroids,
+                    arma::mat& localCentroids,
+                    arma::Col<size_t>& localCounts,
+                    std::false_type /* useProducts */);
+
+  /**
+   * Assign the points handled by this thread to their closest centroids, using
+   * one matrix product per block of points.
+   */
+  void AssignPoints(const arma::mat& centroids,
+                    arma::mat& localCentroids,
+                    arma::Col<size_t>& localCounts,
+                    std::true_type /* useProducts */);
+
   //! The dataset.
   const MatType& dataset;
   //! The instantiated metric.
@@ -18,6 +18,7 @@
 
 // In case it hasn't been included yet.
 #include "naive_kmeans.hpp"
+#include "centroid_update.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -36,50 +37,40 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
                                                  arma::mat& newCentroids,
                                                  arma::Col<size_t>& counts)
 {
-  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
-  counts.zeros(centroids.n_cols);
+  // The current state of the k-means is private for each thread; the states
+  // are combined pairwise at the end instead of one thread at a time.
+#ifdef HAS_OPENMP
+  const size_t maxThreads = omp_get_max_threads();
+#else
+  const size_t maxThreads = 1;
+#endif
+  std::vector<arma::mat> localCentroids(maxThreads);
+  std::vector<arma::Col<size_t>> localCounts(maxThreads);
 
   // Find the closest centroid to each point and update the new centroids.
-  // Computed in parallel over the complete dataset
+  // Computed in parallel over the complete dataset.
   #pragma omp parallel
   {
-    // The current state of the K-means is private for each thread
-    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
-        arma::fill::zeros);
-    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
-
-    #pragma omp for
-    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
-    {
-      // Find the closest centroid to this point.
-      double minDistance = std::numeric_limits<double>::infinity();
-      size_t closestCluster = centroids.n_cols; // Invalid value.
+#ifdef HAS_OPENMP
+    const size_t thread = omp_get_thread_num();
+    const size_t numThreads = omp_get_num_threads();
+#else
+    const size_t thread = 0;
+    const size_t numThreads = 1;
+#endif
 
-      for (size_t j = 0; j < centroids.n_cols; j++)
-      {
-        const double distance = metric.Evaluate(dataset.col(i),
-            centroids.unsafe_col(j));
-        if (distance < minDistance)
-        {
-          minDistance = distance;
-          closestCluster = j;
-        }
-      }
+    localCentroids[thread].zeros(centroids.n_rows, centroids.n_cols);
+    localCounts[thread].zeros(centroids.n_cols);
 
-      Log::Assert(closestCluster != centroids.n_cols);
+    AssignPoints(centroids, localCentroids[thread], localCounts[thread],
+        UseProducts());
 
-      // We now have the minimum distance centroid index.  Update that centroid.
-      localCentroids.unsafe_col(closestCluster) += dataset.col(i);
-      localCounts(closestCluster)++;
-    }
-    // Combine calculated state from each thread
-    #pragma omp critical
-    {
-      newCentroids += localCentroids;
-      counts += localCounts;
-    }
+    ReduceThreadSums(localCentroids, localCounts, thread, numThreads);
   }
 
+  newCentroids.steal_mem(localCentroids[0]);
+  counts.steal_mem(localCounts[0]);
+
   // Now normalize the centroid.
   for (size_t i = 0; i < centroids.n_cols; ++i)
     if (counts(i) != 0)
@@ -99,6 +90,88 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   return std::sqrt(cNorm);
 }
 
+template<typename MetricType, typename MatType>
+void NaiveKMeans<MetricType, MatType>::AssignPoints(
+    const arma::mat& centroids,
+    arma::mat& localCentroids,
+    arma::Col<size_t>& localCounts,
+    std::false_type /* useProducts */)
+{
+  #pragma omp for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+  {
+    // Find the closest centroid to this point.
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; j++)
+    {
+      const double distance = metric.Evaluate(dataset.col(i),
+          centroids.unsafe_col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+
+    // We now have the minimum distance centroid index.  Update that centroid.
+    AddPoint(localCentroids.unsafe_col(closestCluster), dataset.col(i));
+    localCounts(closestCluster)++;
+  }
+}
+
+template<typename MetricType, typename MatType>
+void NaiveKMeans<MetricType, MatType>::AssignPoints(
+    const arma::mat& centroids,
+    arma::mat& localCentroids,
+    arma::Col<size_t>& localCounts,
+    std::true_type /* useProducts */)
+{
+  // ||x - c||^2 = ||x||^2 - 2 x^T c + ||c||^2, and ||x||^2 doesn't change which
+  // centroid is closest, so the closest centroids to a block of points can be
+  // found from one matrix product.  The blocks are small enough that the
+  // products of each thread stay in cache.
+  const arma::rowvec centroidNorms = arma::sum(arma::square(centroids), 0);
+  const size_t blockSize = std::max((size_t) 16,
+      std::min((size_t) 1024, (size_t) 65536 / centroids.n_cols));
+  const size_t numBlocks = (dataset.n_cols + blockSize - 1) / blockSize;
+
+  arma::mat products;
+
+  #pragma omp for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) dataset.n_cols);
+    products = centroids.t() * dataset.cols(begin, end - 1);
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      const double* pointProducts = products.colptr(i - begin);
+
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
+      for (size_t j = 0; j < centroids.n_cols; j++)
+      {
+        const double distance = centroidNorms[j] - 2.0 * pointProducts[j];
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
+      }
+
+      Log::Assert(closestCluster != centroids.n_cols);
+
+      localCentroids.unsafe_col(closestCluster) += dataset.col(i);
+      localCounts(closestCluster)++;
+    }
+  }
+}
+
 } // namespace kmeans
 } // namespace mlpack
 
@@ -24,6 +24,9 @@ namespace kmeans {
  * clustering.  This algorithm builds a kd-tree on the data points and traverses
  * it in order to determine the closest clusters to each point.
  *
+ * If OpenMP is available, the top of the tree is split into disjoint subtrees
+ * at each iteration, and the subtrees are traversed by different threads.
+ *
  * For more information on the algorithm, see
  *
  * @code
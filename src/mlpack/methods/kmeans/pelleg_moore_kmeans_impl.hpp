@@ -15,6 +15,11 @@
 
 #include "pelleg_moore_kmeans.hpp"
 #include "pelleg_moore_kmeans_rules.hpp"
+#include <mlpack/core/tree/instrumented_rules.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace kmeans {
@@ -50,16 +55,85 @@ double PellegMooreKMeans<MetricType, MatType>::Iterate(
   counts.zeros(centroids.n_cols);
 
   // Create rules object.
-  typedef PellegMooreKMeansRules<MetricType, TreeType> RulesType;
+  typedef tree::TraversalRules<PellegMooreKMeansRules<MetricType,
+      TreeType>> RulesType;
   RulesType rules(dataset, centroids, newCentroids, counts, metric);
 
-  // Use single-tree traverser.
-  typename TreeType::template SingleTreeTraverser<RulesType> traverser(rules);
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+  numThreads = omp_get_max_threads();
+  #endif
+
+  // Expand the top of the tree, largest node first, until there are enough
+  // subtrees for every thread to have a few.  Just like in the traversal, each
+  // node except the root is scored once, when its parent is expanded; the
+  // children that are dominated by a single cluster are pruned, and leaves
+  // have their points assigned by Score(), so neither is kept.
+  std::vector<TreeType*> subtrees(1, tree);
+  while (numThreads > 1 && subtrees.size() < 4 * numThreads)
+  {
+    size_t largest = subtrees.size();
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (!subtrees[i]->IsLeaf() && (largest == subtrees.size() ||
+          subtrees[i]->NumDescendants() > subtrees[largest]->NumDescendants()))
+        largest = i;
+    }
+
+    // Every subtree is a leaf.
+    if (largest == subtrees.size())
+      break;
+
+    TreeType* node = subtrees[largest];
+    subtrees.erase(subtrees.begin() + largest);
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+    {
+      if (rules.Score(0, node->Child(i)) != DBL_MAX &&
+          !node->Child(i).IsLeaf())
+        subtrees.push_back(&node->Child(i));
+    }
+  }
+
+  // Each thread collects the points it assigns in its own centroids and
+  // counts.  The blacklist of a node is only written when it is scored, and
+  // only read by its children, so the statistics need no synchronization.
+  // The team may be smaller than numThreads (for instance in a nested
+  // region), so every accumulator is initialized here.
+  std::vector<arma::mat> threadCentroids(numThreads,
+      arma::mat(centroids.n_rows, centroids.n_cols, arma::fill::zeros));
+  std::vector<arma::Col<size_t>> threadCounts(numThreads,
+      arma::Col<size_t>(centroids.n_cols, arma::fill::zeros));
+  std::vector<size_t> threadDistanceCalculations(numThreads, 0);
+
+  #pragma omp parallel num_threads(numThreads)
+  {
+    size_t thread = 0;
+    #ifdef HAS_OPENMP
+    thread = omp_get_thread_num();
+    #endif
+
+    RulesType threadRules(dataset, centroids, threadCentroids[thread],
+        threadCounts[thread], metric);
 
-  // Now, do a traversal with a fake query index (since the query index is
-  // irrelevant; we are checking each node with all clusters.
-  traverser.Traverse(0, *tree);
+    // Use single-tree traverser.
+    typename TreeType::template SingleTreeTraverser<RulesType>
+        traverser(threadRules);
 
+    // Now, do a traversal with a fake query index (since the query index is
+    // irrelevant; we are checking each node with all clusters.
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+      traverser.Traverse(0, *subtrees[i]);
+
+    threadDistanceCalculations[thread] = threadRules.DistanceCalculations();
+  }
+
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    newCentroids += threadCentroids[t];
+    counts += threadCounts[t];
+    distanceCalculations += threadDistanceCalculations[t];
+  }
   distanceCalculations += rules.DistanceCalculations();
 
   // Now, calculate how far the clusters moved, after normalizing them.
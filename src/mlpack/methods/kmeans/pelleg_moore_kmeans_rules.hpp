@@ -14,6 +14,8 @@
 #ifndef MLPACK_METHODS_KMEANS_PELLEG_MOORE_KMEANS_RULES_HPP
 #define MLPACK_METHODS_KMEANS_PELLEG_MOORE_KMEANS_RULES_HPP
 
+#include "centroid_update.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -157,7 +157,8 @@ double PellegMooreKMeansRules<MetricType, TreeType>::Score(
     }
 
     // Add to resulting centroid.
-    newCentroids.col(bestCluster) += dataset.col(referenceNode.Point(i));
+    AddPoint(newCentroids.col(bestCluster),
+        dataset.col(referenceNode.Point(i)));
     ++counts(bestCluster);
   }
 
@@ -13,6 +13,8 @@
 #ifndef MLPACK_METHODS_KMEANS_PELLEG_MOORE_KMEANS_STATISTIC_HPP
 #define MLPACK_METHODS_KMEANS_PELLEG_MOORE_KMEANS_STATISTIC_HPP
 
+#include "centroid_update.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -44,7 +46,7 @@ class PellegMooreKMeansStatistic
 
     for (size_t i = 0; i < node.NumPoints(); ++i)
     {
-      centroid += node.Dataset().col(node.Point(i));
+      AddPoint(centroid, node.Dataset().col(node.Point(i)));
     }
 
     if (node.NumDescendants() > 0)
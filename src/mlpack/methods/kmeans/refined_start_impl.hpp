@@ -55,7 +55,9 @@ void RefinedStart::Cluster(const MatType& data,
     // cluster, we re-initialize that cluster as the point furthest away from
     // the cluster with maximum variance.  This is not *exactly* what the paper
     // implements, but it is quite similar, and we'll call it "good enough".
-    KMeans<> kmeans;
+    // The sample keeps the element type of the data.
+    KMeans<metric::EuclideanDistance, SampleInitialization,
+        MaxVarianceNewCluster, NaiveKMeans, MatType> kmeans;
     kmeans.Cluster(sampledData, clusters, centroids);
 
     // Store the sampled centroids.
@@ -21,6 +21,7 @@ LARS::LARS(const bool useCholesky,
            const double lambda2,
            const double tolerance) :
     matGram(&matGramInternal),
+    cholSize(0),
     useCholesky(useCholesky),
     lasso((lambda1 != 0)),
     lambda1(lambda1),
@@ -35,6 +36,7 @@ LARS::LARS(const bool useCholesky,
            const double lambda2,
            const double tolerance) :
     matGram(&gramMatrix),
+    cholSize(0),
     useCholesky(useCholesky),
     lasso((lambda1 != 0)),
     lambda1(lambda1),
@@ -75,6 +77,88 @@ void LARS::Train(const arma::mat& matX,
 {
   Timer::Start("lars_regression");
 
+  // This matrix may end up holding the transpose -- if necessary.
+  arma::mat dataTrans;
+  // dataRef is row-major.
+  const arma::mat& dataRef = (transposeData ? dataTrans : matX);
+  if (transposeData)
+    dataTrans = trans(matX);
+
+  ComputeGram(dataRef);
+
+  // Compute X' * y.
+  const arma::vec vecXTy = trans(y * dataRef);
+
+  TrainPath(vecXTy, beta);
+
+  Timer::Stop("lars_regression");
+}
+
+void LARS::Train(const arma::mat& matX,
+                 const arma::mat& responses,
+                 arma::mat& beta,
+                 const bool transposeData)
+{
+  Timer::Start("lars_regression");
+
+  // This matrix may end up holding the transpose -- if necessary.
+  arma::mat dataTrans;
+  // dataRef is row-major.
+  const arma::mat& dataRef = (transposeData ? dataTrans : matX);
+  if (transposeData)
+    dataTrans = trans(matX);
+
+  if (responses.n_rows == 0)
+  {
+    beta.set_size(dataRef.n_cols, 0);
+    Timer::Stop("lars_regression");
+    return;
+  }
+
+  // The Gram matrix and X' * Y are computed once for all the targets.
+  ComputeGram(dataRef);
+  const arma::mat matXTy = trans(responses * dataRef);
+
+  beta.set_size(dataRef.n_cols, responses.n_rows);
+
+  // The paths of all the targets but the last one are computed in parallel,
+  // with one LARS object for each thread that uses our Gram matrix.  The last
+  // path is computed by this object, so that it is available afterwards.
+  const size_t numTargets = responses.n_rows;
+  #pragma omp parallel if (numTargets > 2)
+  {
+    LARS lars(useCholesky, *matGram, lambda1, lambda2, tolerance);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t t = 0; t < (omp_size_t) numTargets - 1; ++t)
+    {
+      // This is an alias, so the solution is written directly into beta.
+      arma::vec betaCol = beta.unsafe_col(t);
+      lars.TrainPath(matXTy.col(t), betaCol);
+    }
+  }
+
+  arma::vec betaCol = beta.unsafe_col(numTargets - 1);
+  TrainPath(matXTy.col(numTargets - 1), betaCol);
+
+  Timer::Stop("lars_regression");
+}
+
+void LARS::ComputeGram(const arma::mat& dataRef)
+{
+  // A precalculated Gram matrix is used as long as it has the right size.
+  if ((matGram != &matGramInternal) &&
+      (matGram->n_elem == dataRef.n_cols * dataRef.n_cols))
+    return;
+
+  matGram = &matGramInternal;
+  matGramInternal = trans(dataRef) * dataRef;
+}
+
+void LARS::TrainPath(const arma::vec& vecXTy, arma::vec& beta)
+{
+  const size_t dims = vecXTy.n_elem;
+
   // Clear any previous solution information.
   betaPath.clear();
   lambdaPath.clear();
@@ -84,27 +168,21 @@ void LARS::Train(const arma::mat& matX,
   isIgnored.clear();
   matUtriCholFactor.reset();
 
-  // This matrix may end up holding the transpose -- if necessary.
-  arma::mat dataTrans;
-  // dataRef is row-major.
-  const arma::mat& dataRef = (transposeData ? dataTrans : matX);
-  if (transposeData)
-    dataTrans = trans(matX);
-
-  // Compute X' * y.
-  arma::vec vecXTy = trans(y * dataRef);
+  // The Cholesky factor is built in a buffer big enough to hold all the
+  // dimensions, so it is never reallocated.
+  cholSize = 0;
+  if (useCholesky && (cholBuffer.n_rows != dims))
+    cholBuffer.zeros(dims, dims);
 
   // Set up active set variables.  In the beginning, the active set has size 0
   // (all dimensions are inactive).
-  isActive.resize(dataRef.n_cols, false);
+  isActive.resize(dims, false);
 
   // Set up ignores set variables. Initialized empty.
-  isIgnored.resize(dataRef.n_cols, false);
+  isIgnored.resize(dims, false);
 
-  // Initialize yHat and beta.
-  beta = arma::zeros(dataRef.n_cols);
-  arma::vec yHat = arma::zeros(dataRef.n_rows);
-  arma::vec yHatDirection(dataRef.n_rows);
+  // Initialize beta.
+  beta = arma::zeros(dims);
 
   bool lassocond = false;
 
@@ -128,28 +206,19 @@ void LARS::Train(const arma::mat& matX,
   if (maxCorr < lambda1)
   {
     lambdaPath[0] = lambda1;
-    Timer::Stop("lars_regression");
     return;
   }
 
-  // Compute the Gram matrix.  If this is the elastic net problem, we will add
-  // lambda2 * I_n to the matrix.
-  if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
-  {
-    // In this case, matGram should reference matGramInternal.
-    matGramInternal = trans(dataRef) * dataRef;
-
-    if (elasticNet && !useCholesky)
-      matGramInternal += lambda2 * arma::eye(dataRef.n_cols, dataRef.n_cols);
-  }
+  // The correlations of each dimension with the direction in output space.
+  arma::vec dirCorr;
 
   // Main loop.
-  while (((activeSet.size() + ignoreSet.size()) < dataRef.n_cols) &&
+  while (((activeSet.size() + ignoreSet.size()) < dims) &&
          (maxCorr > tolerance))
   {
     // Compute the maximum correlation among inactive dimensions.
     maxCorr = 0;
-    for (size_t i = 0; i < dataRef.n_cols; i++)
+    for (size_t i = 0; i < dims; i++)
     {
       if ((!isActive[i]) && (!isIgnored[i]) && (fabs(corr(i)) > maxCorr))
       {
@@ -168,7 +237,7 @@ void LARS::Train(const arma::mat& matX,
         //   newGramCol[i] = dot(matX.col(activeSet[i]), matX.col(changeInd));
         // }
         // This is equivalent to the above 5 lines.
-        arma::vec newGramCol = matGram->elem(changeInd * dataRef.n_cols +
+        arma::vec newGramCol = matGram->elem(changeInd * dims +
             arma::conv_to<arma::uvec>::from(activeSet));
 
         CholeskyInsert((*matGram)(changeInd, changeInd), newGramCol);
@@ -192,8 +261,7 @@ void LARS::Train(const arma::mat& matX,
     if (useCholesky)
     {
       // Check for singularity.
-      const double lastUtriElement = matUtriCholFactor(
-          matUtriCholFactor.n_cols - 1, matUtriCholFactor.n_rows - 1);
+      const double lastUtriElement = cholBuffer(cholSize - 1, cholSize - 1);
       if (std::abs(lastUtriElement) > tolerance)
       {
         // Ok, no singularity.
@@ -208,8 +276,7 @@ void LARS::Train(const arma::mat& matX,
          *    = Solve(R % S, Solve(R^T, s)
          *    = s % Solve(R, Solve(R^T, s))
          */
-        unnormalizedBetaDirection = solve(trimatu(matUtriCholFactor),
-            solve(trimatl(trans(matUtriCholFactor)), s));
+        CholeskySolve(s, unnormalizedBetaDirection);
 
         normalization = 1.0 / sqrt(dot(s, unnormalizedBetaDirection));
         betaDirection = normalization * unnormalizedBetaDirection;
@@ -223,7 +290,7 @@ void LARS::Train(const arma::mat& matX,
             << std::endl;
         Deactivate(activeSet.size() - 1);
         Ignore(changeInd);
-        CholeskyDelete(matUtriCholFactor.n_rows - 1);
+        CholeskyDelete(cholSize - 1);
         continue;
       }
     }
@@ -234,6 +301,10 @@ void LARS::Train(const arma::mat& matX,
         for (size_t j = 0; j < activeSet.size(); j++)
           matGramActive(i, j) = (*matGram)(activeSet[i], activeSet[j]);
 
+      // If this is the elastic net problem, we add lambda2 * I to the matrix.
+      if (elasticNet)
+        matGramActive.diag() += lambda2;
+
       // Check for singularity.
       arma::mat matS = s * arma::ones<arma::mat>(1, activeSet.size());
       const bool solvedOk = solve(unnormalizedBetaDirection,
@@ -258,23 +329,24 @@ void LARS::Train(const arma::mat& matX,
       }
     }
 
-    // compute "equiangular" direction in output space
-    ComputeYHatDirection(dataRef, betaDirection, yHatDirection);
-
     double gamma = maxCorr / normalization;
 
     // If not all variables are active.
-    if ((activeSet.size() + ignoreSet.size()) < dataRef.n_cols)
+    if ((activeSet.size() + ignoreSet.size()) < dims)
     {
-      // Compute correlations with direction.
-      for (size_t ind = 0; ind < dataRef.n_cols; ind++)
+      // Compute correlations with the "equiangular" direction in output space,
+      // X' X betaDirection, from the Gram matrix.
+      GramProduct(betaDirection, dirCorr);
+
+      for (size_t ind = 0; ind < dims; ind++)
       {
         if (isActive[ind] || isIgnored[ind])
           continue;
 
-        double dirCorr = dot(dataRef.col(ind), yHatDirection);
-        double val1 = (maxCorr - corr(ind)) / (normalization - dirCorr);
-        double val2 = (maxCorr + corr(ind)) / (normalization + dirCorr);
+        const double val1 = (maxCorr - corr(ind)) /
+            (normalization - dirCorr(ind));
+        const double val2 = (maxCorr + corr(ind)) /
+            (normalization + dirCorr(ind));
         if ((val1 > 0) && (val1 < gamma))
           gamma = val1;
         if ((val2 > 0) && (val2 < gamma))
@@ -307,9 +379,6 @@ void LARS::Train(const arma::mat& matX,
       }
     }
 
-    // Update the prediction.
-    yHat += gamma * yHatDirection;
-
     // Update the estimator.
     for (size_t i = 0; i < activeSet.size(); i++)
     {
@@ -334,7 +403,14 @@ void LARS::Train(const arma::mat& matX,
       Deactivate(changeInd);
     }
 
-    corr = vecXTy - trans(dataRef) * yHat;
+    // The correlations with the residual are X' (y - X beta) = X' y - G beta,
+    // and only the active dimensions of beta are nonzero.
+    arma::vec activeBeta(activeSet.size());
+    for (size_t i = 0; i < activeSet.size(); i++)
+      activeBeta(i) = beta(activeSet[i]);
+
+    GramProduct(activeBeta, corr);
+    corr = vecXTy - corr;
     if (elasticNet)
       corr -= lambda2 * beta;
 
@@ -360,7 +436,11 @@ void LARS::Train(const arma::mat& matX,
   // Unfortunate copy...
   beta = betaPath.back();
 
-  Timer::Stop("lars_regression");
+  if (cholSize > 0)
+  {
+    matUtriCholFactor = cholBuffer(arma::span(0, cholSize - 1),
+                                   arma::span(0, cholSize - 1));
+  }
 }
 
 void LARS::Train(const arma::mat& data,
@@ -401,13 +481,26 @@ void LARS::Ignore(const size_t varInd)
   ignoreSet.push_back(varInd);
 }
 
-void LARS::ComputeYHatDirection(const arma::mat& matX,
-                                const arma::vec& betaDirection,
-                                arma::vec& yHatDirection)
+void LARS::GramProduct(const arma::vec& activeValues,
+                       arma::vec& products) const
 {
-  yHatDirection.fill(0);
-  for (size_t i = 0; i < activeSet.size(); i++)
-    yHatDirection += betaDirection(i) * matX.col(activeSet[i]);
+  const arma::mat& gram = *matGram;
+  products.set_size(gram.n_cols);
+
+  // Each dimension only reads one column of the (symmetric) Gram matrix, so
+  // the dimensions are split between threads, unless there is so little work
+  // that starting the threads would cost more.
+  const bool parallel = (gram.n_cols * activeSet.size() >= 100000);
+  #pragma omp parallel for schedule(static) if (parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) gram.n_cols; ++i)
+  {
+    const double* gramCol = gram.colptr(i);
+    double product = 0.0;
+    for (size_t j = 0; j < activeSet.size(); ++j)
+      product += gramCol[activeSet[j]] * activeValues[j];
+
+    products[i] = product;
+  }
 }
 
 void LARS::InterpolateBeta()
@@ -426,114 +519,97 @@ void LARS::InterpolateBeta()
   lambdaPath[pathLength - 1] = lambda1;
 }
 
-void LARS::CholeskyInsert(const arma::vec& newX, const arma::mat& X)
-{
-  if (matUtriCholFactor.n_rows == 0)
-  {
-    matUtriCholFactor = arma::mat(1, 1);
-
-    if (elasticNet)
-      matUtriCholFactor(0, 0) = sqrt(dot(newX, newX) + lambda2);
-    else
-      matUtriCholFactor(0, 0) = norm(newX, 2);
-  }
-  else
-  {
-    arma::vec newGramCol = trans(X) * newX;
-    CholeskyInsert(dot(newX, newX), newGramCol);
-  }
-}
-
 void LARS::CholeskyInsert(double sqNormNewX, const arma::vec& newGramCol)
 {
-  int n = matUtriCholFactor.n_rows;
+  const size_t n = cholSize;
 
-  if (n == 0)
-  {
-    matUtriCholFactor = arma::mat(1, 1);
+  if (elasticNet)
+    sqNormNewX += lambda2;
 
-    if (elasticNet)
-      matUtriCholFactor(0, 0) = sqrt(sqNormNewX + lambda2);
-    else
-      matUtriCholFactor(0, 0) = sqrt(sqNormNewX);
-  }
-  else
+  // The new column of R is the solution of R^T k = newGramCol, computed in
+  // place by forward substitution.
+  double* newCol = cholBuffer.colptr(n);
+  for (size_t i = 0; i < n; ++i)
   {
-    arma::mat matNewR = arma::mat(n + 1, n + 1);
+    const double* col = cholBuffer.colptr(i);
+    double value = newGramCol[i];
+    for (size_t k = 0; k < i; ++k)
+      value -= col[k] * newCol[k];
 
-    if (elasticNet)
-      sqNormNewX += lambda2;
+    newCol[i] = value / col[i];
+  }
 
-    arma::vec matUtriCholFactork = solve(trimatl(trans(matUtriCholFactor)),
-        newGramCol);
+  double sqNormNewCol = 0.0;
+  for (size_t i = 0; i < n; ++i)
+    sqNormNewCol += newCol[i] * newCol[i];
 
-    matNewR(arma::span(0, n - 1), arma::span(0, n - 1)) = matUtriCholFactor;
-    matNewR(arma::span(0, n - 1), n) = matUtriCholFactork;
-    matNewR(n, arma::span(0, n - 1)).fill(0.0);
-    matNewR(n, n) = sqrt(sqNormNewX - dot(matUtriCholFactork,
-                                          matUtriCholFactork));
+  for (size_t j = 0; j < n; ++j)
+    cholBuffer(n, j) = 0.0;
+  cholBuffer(n, n) = sqrt(sqNormNewX - sqNormNewCol);
 
-    matUtriCholFactor = matNewR;
-  }
+  ++cholSize;
 }
 
-void LARS::GivensRotate(const arma::vec::fixed<2>& x,
-                        arma::vec::fixed<2>& rotatedX,
-                        arma::mat& matG)
+void LARS::CholeskySolve(const arma::vec& b, arma::vec& x) const
 {
-  if (x(1) == 0)
-  {
-    matG = arma::eye(2, 2);
-    rotatedX = x;
-  }
-  else
-  {
-    double r = norm(x, 2);
-    matG = arma::mat(2, 2);
+  const size_t n = cholSize;
+  x = b;
 
-    double scaledX1 = x(0) / r;
-    double scaledX2 = x(1) / r;
+  // Solve R^T z = b by forward substitution.
+  for (size_t i = 0; i < n; ++i)
+  {
+    const double* col = cholBuffer.colptr(i);
+    double value = x[i];
+    for (size_t k = 0; k < i; ++k)
+      value -= col[k] * x[k];
 
-    matG(0, 0) = scaledX1;
-    matG(1, 0) = -scaledX2;
-    matG(0, 1) = scaledX2;
-    matG(1, 1) = scaledX1;
+    x[i] = value / col[i];
+  }
 
-    rotatedX = arma::vec(2);
-    rotatedX(0) = r;
-    rotatedX(1) = 0;
+  // Solve R x = z by backward substitution, one column of R at a time.
+  for (size_t j = n; j > 0; --j)
+  {
+    const double* col = cholBuffer.colptr(j - 1);
+    x[j - 1] /= col[j - 1];
+    for (size_t k = 0; k < j - 1; ++k)
+      x[k] -= x[j - 1] * col[k];
   }
 }
 
 void LARS::CholeskyDelete(const size_t colToKill)
 {
-  size_t n = matUtriCholFactor.n_rows;
+  const size_t n = cholSize - 1;
 
-  if (colToKill == (n - 1))
+  // Remove column colToKill by shifting the next columns to the left; this
+  // leaves one nonzero element below the diagonal of each of them.
+  for (size_t j = colToKill; j < n; ++j)
   {
-    matUtriCholFactor = matUtriCholFactor(arma::span(0, n - 2),
-                                          arma::span(0, n - 2));
+    std::copy(cholBuffer.colptr(j + 1), cholBuffer.colptr(j + 1) + j + 2,
+        cholBuffer.colptr(j));
   }
-  else
-  {
-    matUtriCholFactor.shed_col(colToKill); // remove column colToKill
-    n--;
 
-    for (size_t k = colToKill; k < n; k++)
+  // Zero these elements with Givens rotations of the rows k and k + 1.
+  for (size_t k = colToKill; k < n; ++k)
+  {
+    const double a = cholBuffer(k, k);
+    const double b = cholBuffer(k + 1, k);
+    if (b == 0)
+      continue;
+
+    const double r = std::hypot(a, b);
+    const double c = a / r;
+    const double s = b / r;
+
+    cholBuffer(k, k) = r;
+    cholBuffer(k + 1, k) = 0.0;
+    for (size_t j = k + 1; j < n; ++j)
     {
-      arma::mat matG;
-      arma::vec::fixed<2> rotatedVec;
-      GivensRotate(matUtriCholFactor(arma::span(k, k + 1), k), rotatedVec,
-          matG);
-      matUtriCholFactor(arma::span(k, k + 1), k) = rotatedVec;
-      if (k < n - 1)
-      {
-        matUtriCholFactor(arma::span(k, k + 1), arma::span(k + 1, n - 1)) =
-            matG * matUtriCholFactor(arma::span(k, k + 1),
-            arma::span(k + 1, n - 1));
-      }
+      const double x = cholBuffer(k, j);
+      const double y = cholBuffer(k + 1, j);
+      cholBuffer(k, j) = c * x + s * y;
+      cholBuffer(k + 1, j) = -s * x + c * y;
     }
-
-    matUtriCholFactor.shed_row(n);
   }
+
+  cholSize = n;
 }
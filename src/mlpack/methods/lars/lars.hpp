@@ -30,7 +30,6 @@ namespace mlpack {
 namespace regression {
 
 // beta is the estimator
-// yHat is the prediction from the current estimator
 
 /**
  * An implementation of LARS, a stage-wise homotopy-based algorithm for
@@ -189,6 +188,24 @@ class LARS
              arma::vec& beta,
              const bool transposeData = true);
 
+  /**
+   * Run LARS for several vectors of targets on the same data at once.  The
+   * Gram matrix and X' * y are computed once for all vectors, and the paths of
+   * the vectors are computed in parallel.  Afterwards, BetaPath(),
+   * LambdaPath() and ActiveSet() describe the path of the last vector.
+   *
+   * @param data Column-major input data (or row-major input data if
+   *     transposeData = false).
+   * @param responses Vectors of targets, one in each row.
+   * @param beta Matrix to store the solutions in; column i is the solution for
+   *     row i of responses.
+   * @param transposeData Set to false if the data is row-major.
+   */
+  void Train(const arma::mat& data,
+             const arma::mat& responses,
+             arma::mat& beta,
+             const bool transposeData = true);
+
   /**
    * Run LARS.  The input matrix (like all mlpack matrices) should be
    * column-major -- each column is an observation and each row is a dimension.
@@ -252,6 +269,12 @@ class LARS
   //! Upper triangular cholesky factor; initially 0x0 matrix.
   arma::mat matUtriCholFactor;
 
+  //! Buffer holding the Cholesky factor while training, in its top left
+  //! corner; it is big enough for all dimensions, so it is never reallocated.
+  arma::mat cholBuffer;
+  //! Size of the Cholesky factor held by cholBuffer.
+  size_t cholSize;
+
   //! Whether or not to use Cholesky decomposition when solving linear system.
   bool useCholesky;
 
@@ -309,22 +332,42 @@ class LARS
    */
   void Ignore(const size_t varInd);
 
-  // compute "equiangular" direction in output space
-  void ComputeYHatDirection(const arma::mat& matX,
-                            const arma::vec& betaDirection,
-                            arma::vec& yHatDirection);
+  /**
+   * Make sure that matGram points to the Gram matrix of the given (row-major)
+   * data.  A precalculated Gram matrix is used if it has the right size;
+   * otherwise the Gram matrix is computed and held by matGramInternal.
+   *
+   * @param dataRef Row-major input data.
+   */
+  void ComputeGram(const arma::mat& dataRef);
+
+  /**
+   * Compute the solution path from X' * y and the Gram matrix, which must
+   * already be set.
+   *
+   * @param vecXTy X' * y.
+   * @param beta Vector to store the solution in.
+   */
+  void TrainPath(const arma::vec& vecXTy, arma::vec& beta);
+
+  /**
+   * Compute G_A' * activeValues, where G_A holds the columns of the Gram
+   * matrix of the active dimensions, in parallel over the dimensions.  For the
+   * coefficients of the active dimensions, this gives the correlations of all
+   * dimensions with the corresponding prediction, without computing it.
+   */
+  void GramProduct(const arma::vec& activeValues, arma::vec& products) const;
 
   // interpolate to compute last solution vector
   void InterpolateBeta();
 
-  void CholeskyInsert(const arma::vec& newX, const arma::mat& X);
-
+  //! Add a column to the Cholesky factor, in place.
   void CholeskyInsert(double sqNormNewX, const arma::vec& newGramCol);
 
-  void GivensRotate(const arma::vec::fixed<2>& x,
-                    arma::vec::fixed<2>& rotatedX,
-                    arma::mat& G);
+  //! Solve R' R x = b with the Cholesky factor R.
+  void CholeskySolve(const arma::vec& b, arma::vec& x) const;
 
+  //! Remove a column from the Cholesky factor, in place.
   void CholeskyDelete(const size_t colToKill);
 };
 
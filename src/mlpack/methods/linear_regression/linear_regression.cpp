@@ -13,6 +13,10 @@
 #include "linear_regression.hpp"
 #include <mlpack/core/util/log.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::regression;
 
@@ -51,40 +55,165 @@ void LinearRegression::Train(const arma::mat& predictors,
   /*
    * We want to calculate the a_i coefficients of:
    * \sum_{i=0}^n (a_i * x_i^i)
-   * In order to get the intercept value, we will add a row of ones.
+   * In order to get the intercept value, we consider that the predictors have
+   * an extra row of ones in front of them (but we never form it).
    */
+  const size_t dims = predictors.n_rows + (intercept ? 1 : 0);
+  gram.zeros(dims, dims);
+  crossProducts.zeros(dims);
 
-  // We store the number of rows and columns of the predictors.
-  // Reminder: Armadillo stores the data transposed from how we think of it,
-  //           that is, columns are actually rows (see: column major order).
-  const size_t nCols = predictors.n_cols;
+  Accumulate(predictors, responses, weights);
+  Solve();
+}
 
-  arma::mat p = predictors;
-  arma::rowvec r = responses;
+void LinearRegression::Update(const arma::mat& predictors,
+                              const arma::rowvec& responses)
+{
+  Update(predictors, responses, arma::rowvec());
+}
 
-  // Here we add the row of ones to the predictors.
-  // The intercept is not penalized. Add an "all ones" row to design and set
-  // intercept = false to get a penalized intercept.
-  if (intercept)
+void LinearRegression::Update(const arma::mat& predictors,
+                              const arma::rowvec& responses,
+                              const arma::rowvec& weights)
+{
+  // Without sufficient statistics (the model was never trained, or it was
+  // loaded from an older model file), there is nothing to update.
+  if (gram.n_elem == 0)
+  {
+    if (parameters.n_elem > 0)
+    {
+      Log::Warn << "LinearRegression::Update(): the model has no sufficient "
+          << "statistics; training on the given points only." << std::endl;
+    }
+
+    Train(predictors, responses, weights, intercept);
+    return;
+  }
+
+  if (predictors.n_rows + (intercept ? 1 : 0) != gram.n_rows)
+  {
+    Log::Fatal << "LinearRegression::Update(): the new points must have the "
+        << "same dimensionality as the training points!" << std::endl;
+  }
+
+  Accumulate(predictors, responses, weights);
+  Solve();
+}
+
+void LinearRegression::Accumulate(const arma::mat& predictors,
+                                  const arma::rowvec& responses,
+                                  const arma::rowvec& weights)
+{
+  if (responses.n_elem != predictors.n_cols)
   {
-    p.insert_rows(0, arma::ones<arma::mat>(1, nCols));
+    Log::Fatal << "LinearRegression: the number of responses ("
+        << responses.n_elem << ") must match the number of points ("
+        << predictors.n_cols << ")!" << std::endl;
   }
 
-  if (weights.n_elem > 0)
+  const bool weighted = (weights.n_elem > 0);
+  if (weighted && weights.n_elem != predictors.n_cols)
   {
-    p = p * diagmat(sqrt(weights));
-    r = sqrt(weights) % responses;
+    Log::Fatal << "LinearRegression: the number of weights (" << weights.n_elem
+        << ") must match the number of points (" << predictors.n_cols << ")!"
+        << std::endl;
   }
 
-  // Convert to this form:
-  // a * (X X^T) = y X^T.
-  // Then we'll use Armadillo to solve it.
-  // The total runtime of this should be O(d^2 N) + O(d^3) + O(dN).
-  // (assuming the SVD is used to solve it)
-  arma::mat cov = p * p.t() +
-      lambda * arma::eye<arma::mat>(p.n_rows, p.n_rows);
+  if (predictors.n_cols == 0)
+    return;
 
-  parameters = arma::solve(cov, p * r.t());
+  // The statistics of each block of points are computed in parallel, and each
+  // thread sums the statistics of its blocks locally.  The blocks are given to
+  // the threads in a fixed order and the thread sums are added in thread
+  // order, so the result only depends on the number of threads.
+  const size_t numBlocks = (predictors.n_cols + AccumulateBlockSize - 1) /
+      AccumulateBlockSize;
+#ifdef HAS_OPENMP
+  const size_t maxThreads = std::min((size_t) omp_get_max_threads(),
+      numBlocks);
+#else
+  const size_t maxThreads = 1;
+#endif
+  std::vector<arma::mat> localGram(maxThreads);
+  std::vector<arma::vec> localCrossProducts(maxThreads);
+
+  #pragma omp parallel num_threads(maxThreads)
+  {
+#ifdef HAS_OPENMP
+    const size_t thread = omp_get_thread_num();
+#else
+    const size_t thread = 0;
+#endif
+
+    localGram[thread].zeros(gram.n_rows, gram.n_cols);
+    localCrossProducts[thread].zeros(crossProducts.n_elem);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * AccumulateBlockSize;
+      const size_t end = std::min(begin + AccumulateBlockSize,
+          (size_t) predictors.n_cols) - 1;
+
+      // An alias of the points of the block, to avoid copying them.
+      const arma::mat block(const_cast<double*>(predictors.colptr(begin)),
+          predictors.n_rows, end - begin + 1, false, true);
+
+      // Apply the weights once; then X W X^T = (X W) X^T and X W y^T =
+      // X (W y^T).
+      arma::rowvec blockResponses = responses.subvec(begin, end);
+      arma::mat weightedBlock;
+      double weightSum = (double) block.n_cols;
+      if (weighted)
+      {
+        const arma::rowvec blockWeights = weights.subvec(begin, end);
+        weightedBlock = block.each_row() % blockWeights;
+        blockResponses %= blockWeights;
+        weightSum = arma::accu(blockWeights);
+      }
+      const arma::mat& wb = weighted ? weightedBlock : block;
+
+      arma::mat& g = localGram[thread];
+      arma::vec& c = localCrossProducts[thread];
+      if (intercept)
+      {
+        // The extra row of ones gives the (weighted) number of points and the
+        // sums of the points and responses.
+        const arma::vec sums = arma::sum(wb, 1);
+        g(0, 0) += weightSum;
+        g.submat(1, 0, g.n_rows - 1, 0) += sums;
+        g.submat(0, 1, 0, g.n_cols - 1) += sums.t();
+        g.submat(1, 1, g.n_rows - 1, g.n_cols - 1) += wb * block.t();
+
+        c[0] += arma::accu(blockResponses);
+        c.subvec(1, c.n_elem - 1) += block * blockResponses.t();
+      }
+      else
+      {
+        g += wb * block.t();
+        c += block * blockResponses.t();
+      }
+    }
+  }
+
+  for (size_t t = 0; t < maxThreads; ++t)
+  {
+    // Fewer threads than requested may have been started.
+    if (localGram[t].n_elem == 0)
+      continue;
+
+    gram += localGram[t];
+    crossProducts += localCrossProducts[t];
+  }
+}
+
+void LinearRegression::Solve()
+{
+  // Solve (X X^T + lambda I) a = X y^T with Armadillo.  The total runtime of
+  // this should be O(d^3), since the O(d^2 N) part has already been done when
+  // the statistics were accumulated.
+  parameters = arma::solve(gram +
+      lambda * arma::eye<arma::mat>(gram.n_rows, gram.n_cols), crossProducts);
 }
 
 void LinearRegression::Predict(const arma::mat& points,
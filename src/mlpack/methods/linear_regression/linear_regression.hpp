@@ -63,10 +63,9 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data. Careful! This will
-   * completely ignore and overwrite the existing model. This particular
-   * implementation does not have an incremental training algorithm.  To set the
-   * regularization parameter lambda, call Lambda() or set a different value in
-   * the constructor.
+   * completely ignore and overwrite the existing model; to add points to the
+   * existing model, use Update() instead.  To set the regularization parameter
+   * lambda, call Lambda() or set a different value in the constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -78,10 +77,10 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data and weights. Careful!
-   * This will completely ignore and overwrite the existing model. This
-   * particular implementation does not have an incremental training algorithm.
-   * To set the regularization parameter lambda, call Lambda() or set a
-   * different value in the constructor.
+   * This will completely ignore and overwrite the existing model; to add points
+   * to the existing model, use Update() instead.  To set the regularization
+   * parameter lambda, call Lambda() or set a different value in the
+   * constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -93,6 +92,35 @@ class LinearRegression
              const arma::rowvec& weights,
              const bool intercept = true);
 
+  /**
+   * Update the model with the given new points, as if they had been part of
+   * the training set.  The model keeps the sufficient statistics X X^T and
+   * X y^T of all the points it has seen, so the cost of an update is O(d^2 N)
+   * for N new points plus the O(d^3) solve, and the old points are not
+   * needed.  The current value of Lambda() is used for the solve.
+   *
+   * If the model has never been trained (or was loaded from a model file that
+   * holds no statistics), this is the same as calling Train() with the current
+   * value of Intercept().
+   *
+   * @param predictors X, the matrix of new data points.
+   * @param responses y, the responses to the new data points.
+   */
+  void Update(const arma::mat& predictors, const arma::rowvec& responses);
+
+  /**
+   * Update the model with the given new points and weights, as if they had
+   * been part of the training set.  See the other overload of Update() for
+   * more details.
+   *
+   * @param predictors X, the matrix of new data points.
+   * @param responses y, the responses to the new data points.
+   * @param weights Observation weights of the new data points.
+   */
+  void Update(const arma::mat& predictors,
+              const arma::rowvec& responses,
+              const arma::rowvec& weights);
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -138,14 +166,41 @@ class LinearRegression
    * Serialize the model.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */)
+  void serialize(Archive& ar, const unsigned int version)
   {
     ar & BOOST_SERIALIZATION_NVP(parameters);
     ar & BOOST_SERIALIZATION_NVP(lambda);
     ar & BOOST_SERIALIZATION_NVP(intercept);
+
+    // Older models don't have the sufficient statistics, so they can't be
+    // updated.
+    if (version > 0)
+    {
+      ar & BOOST_SERIALIZATION_NVP(gram);
+      ar & BOOST_SERIALIZATION_NVP(crossProducts);
+    }
+    else if (Archive::is_loading::value)
+    {
+      gram.clear();
+      crossProducts.clear();
+    }
   }
 
  private:
+  /**
+   * Add the statistics of the given points to gram and crossProducts, in
+   * blocks of points that are processed in parallel.
+   */
+  void Accumulate(const arma::mat& predictors,
+                  const arma::rowvec& responses,
+                  const arma::rowvec& weights);
+
+  //! Compute the parameters from gram, crossProducts and lambda.
+  void Solve();
+
+  //! The number of points in each block processed by Accumulate().
+  static const size_t AccumulateBlockSize = 4096;
+
   /**
    * The calculated B.
    * Initialized and filled by constructor to hold the least squares solution.
@@ -160,9 +215,20 @@ class LinearRegression
 
   //! Indicates whether first parameter is intercept.
   bool intercept;
+
+  //! The (weighted) sum of x x^T over all the points seen so far, with the
+  //! row of ones of the intercept if it is used.  Lambda is not included.
+  arma::mat gram;
+
+  //! The (weighted) sum of x y over all the points seen so far, with the row
+  //! of ones of the intercept if it is used.
+  arma::vec crossProducts;
 };
 
 } // namespace regression
 } // namespace mlpack
 
+//! Set the serialization version of the LinearRegression class.
+BOOST_CLASS_VERSION(mlpack::regression::LinearRegression, 1);
+
 #endif // MLPACK_METHODS_LINEAR_REGRESSION_HPP
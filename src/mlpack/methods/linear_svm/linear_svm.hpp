@@ -0,0 +1,284 @@
+/**
+ * @file linear_svm.hpp
+ *
+ * Definition of the LinearSVM class, a linear support vector machine trained
+ * with dual coordinate descent.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_SVM_LINEAR_SVM_HPP
+#define MLPACK_METHODS_LINEAR_SVM_LINEAR_SVM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace svm {
+
+/**
+ * A linear support vector machine, trained by solving the dual problem with
+ * coordinate descent, as in LIBLINEAR:
+ *
+ * @code
+ * @inproceedings{hsieh2008dual,
+ *   title     = {A dual coordinate descent method for large-scale linear
+ *                SVM},
+ *   author    = {Hsieh, Cho-Jui and Chang, Kai-Wei and Lin, Chih-Jen and
+ *                Keerthi, S. Sathiya and Sundararajan, S.},
+ *   booktitle = {Proceedings of the 25th International Conference on Machine
+ *                Learning},
+ *   pages     = {408--415},
+ *   year      = {2008}
+ * }
+ * @endcode
+ *
+ * Each pass visits the dual variables in a random order and updates each one
+ * exactly, which only needs one dot product and one update of the weights with
+ * the point, so a pass costs O(nnz) on sparse data.  The squared norms of the
+ * points are computed once, in parallel.  Variables that are stuck at a bound
+ * are shrunk (left out of the following passes) until the remaining problem
+ * has converged, and then the whole problem is checked again.  Both the hinge
+ * loss (L1-loss SVM) and the squared hinge loss (L2-loss SVM) are supported.
+ * The intercept, if it is used, is learned as the weight of an extra feature
+ * that is 1 for every point (so it is regularized too, as in LIBLINEAR).
+ *
+ * With more than two classes, one binary SVM is trained for each class against
+ * all the others; the classes are trained in parallel with OpenMP.  A point is
+ * assigned to the class with the largest score.  Classify() splits the points
+ * into blocks of columns, which are scored in parallel.
+ *
+ * This solves the same problem as the primal objective in
+ * sparse_svm/sparse_svm_function.hpp, which is meant to be optimized with
+ * ParallelSGD, but the dual solver needs no step size and usually converges in
+ * a few passes.
+ *
+ * The training and test data can be dense (arma::mat) or sparse
+ * (arma::sp_mat); the training gives the same model for both.  The random
+ * order of the passes comes from mlpack's random number generator, so the
+ * model only depends on math::RandomSeed() and not on the number of threads.
+ *
+ * @code
+ * arma::sp_mat data; // Points in columns.
+ * arma::Row<size_t> labels; // Labels in [0, numClasses).
+ * svm::LinearSVM svm(data, labels, 2, 1.0);
+ *
+ * arma::Row<size_t> predictions;
+ * svm.Classify(testData, predictions);
+ * @endcode
+ */
+class LinearSVM
+{
+ public:
+  /**
+   * Create the LinearSVM without training it; call Train() before
+   * classifying.
+   *
+   * @param c Cost of violating the margin (larger values regularize less).
+   * @param squaredHinge If true, use the squared hinge loss.
+   * @param fitIntercept If true, also learn an intercept.
+   * @param maxIterations Maximum number of passes over the data; 0 means no
+   *     limit.
+   * @param tolerance Stop when the projected gradient of the dual is within
+   *     this range.
+   */
+  LinearSVM(const double c = 1.0,
+            const bool squaredHinge = false,
+            const bool fitIntercept = true,
+            const size_t maxIterations = 1000,
+            const double tolerance = 0.1);
+
+  /**
+   * Create the LinearSVM and train it on the given data.  The labels must be
+   * in the range [0, numClasses); data::NormalizeLabels() can be used to get
+   * labels in that range.
+   *
+   * @param data Training data, with one point per column.
+   * @param labels Labels of the points.
+   * @param numClasses Number of classes (at least 2).
+   * @param c Cost of violating the margin (larger values regularize less).
+   * @param squaredHinge If true, use the squared hinge loss.
+   * @param fitIntercept If true, also learn an intercept.
+   * @param maxIterations Maximum number of passes over the data; 0 means no
+   *     limit.
+   * @param tolerance Stop when the projected gradient of the dual is within
+   *     this range.
+   */
+  template<typename MatType>
+  LinearSVM(const MatType& data,
+            const arma::Row<size_t>& labels,
+            const size_t numClasses = 2,
+            const double c = 1.0,
+            const bool squaredHinge = false,
+            const bool fitIntercept = true,
+            const size_t maxIterations = 1000,
+            const double tolerance = 0.1);
+
+  /**
+   * Train the model on the given data, with the current parameters.  Any
+   * previous model is replaced.
+   *
+   * @param data Training data, with one point per column.
+   * @param labels Labels of the points, in the range [0, numClasses).
+   * @param numClasses Number of classes (at least 2).
+   */
+  template<typename MatType>
+  void Train(const MatType& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses = 2);
+
+  /**
+   * Classify the given point.
+   *
+   * @param point Point to classify.
+   * @return The predicted class.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given points, in parallel.
+   *
+   * @param data Points to classify, one per column.
+   * @param predictions Row to store the predicted classes in.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points, in parallel, and also return the score of each
+   * point for each class (the value of the decision function of the SVM of
+   * that class).
+   *
+   * @param data Points to classify, one per column.
+   * @param predictions Row to store the predicted classes in.
+   * @param scores Matrix to store the scores in, with one row per class.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& scores) const;
+
+  /**
+   * Return the percentage of the given points that are classified correctly.
+   *
+   * @param data Points to classify, one per column.
+   * @param labels True labels of the points.
+   */
+  template<typename MatType>
+  double ComputeAccuracy(const MatType& data,
+                         const arma::Row<size_t>& labels) const;
+
+  //! Get the cost of violating the margin.
+  double C() const { return c; }
+  //! Modify the cost of violating the margin.
+  double& C() { return c; }
+
+  //! Get whether the squared hinge loss is used.
+  bool SquaredHinge() const { return squaredHinge; }
+  //! Modify whether the squared hinge loss is used.
+  bool& SquaredHinge() { return squaredHinge; }
+
+  //! Get whether an intercept is learned.
+  bool FitIntercept() const { return fitIntercept; }
+  //! Modify whether an intercept is learned.
+  bool& FitIntercept() { return fitIntercept; }
+
+  //! Get the maximum number of passes over the data.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of passes over the data.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance of the optimization.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance of the optimization.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the number of classes of the model.
+  size_t NumClasses() const { return weights.n_cols; }
+
+  //! Get the weights, with one column per class.
+  const arma::mat& Weights() const { return weights; }
+  //! Modify the weights.  You had better know what you are doing!
+  arma::mat& Weights() { return weights; }
+
+  //! Get the intercepts of the classes.
+  const arma::vec& Biases() const { return biases; }
+  //! Modify the intercepts of the classes.
+  arma::vec& Biases() { return biases; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Solve the dual problem of one binary SVM, where the points with
+   * positive[i] != 0 are the positive class.
+   *
+   * @param data Training data.
+   * @param sqNorms Squared norm of each point (plus 1 with an intercept).
+   * @param positive Whether each point is in the positive class.
+   * @param seed Seed for the order of the passes.
+   * @param w Vector to store the weights in.
+   * @param b Value to store the intercept in.
+   * @return The number of passes over the data.
+   */
+  template<typename MatType>
+  size_t TrainBinary(const MatType& data,
+                     const arma::vec& sqNorms,
+                     const std::vector<char>& positive,
+                     const size_t seed,
+                     arma::vec& w,
+                     double& b) const;
+
+  //! Return the dot product of the given point of a dense matrix with w.
+  static double ColumnDot(const arma::mat& data,
+                          const size_t i,
+                          const arma::vec& w);
+  //! Return the dot product of the given point of a sparse matrix with w.
+  static double ColumnDot(const arma::sp_mat& data,
+                          const size_t i,
+                          const arma::vec& w);
+
+  //! Add the given point of a dense matrix, times the scale, to w.
+  static void AddColumn(const arma::mat& data,
+                        const size_t i,
+                        const double scale,
+                        arma::vec& w);
+  //! Add the given point of a sparse matrix, times the scale, to w.
+  static void AddColumn(const arma::sp_mat& data,
+                        const size_t i,
+                        const double scale,
+                        arma::vec& w);
+
+  //! Return the squared norm of the given point of a dense matrix.
+  static double ColumnSqNorm(const arma::mat& data, const size_t i);
+  //! Return the squared norm of the given point of a sparse matrix.
+  static double ColumnSqNorm(const arma::sp_mat& data, const size_t i);
+
+  //! Cost of violating the margin.
+  double c;
+  //! Whether the squared hinge loss is used.
+  bool squaredHinge;
+  //! Whether an intercept is learned.
+  bool fitIntercept;
+  //! Maximum number of passes over the data.
+  size_t maxIterations;
+  //! Tolerance of the optimization.
+  double tolerance;
+
+  //! The weights of each class.
+  arma::mat weights;
+  //! The intercept of each class.
+  arma::vec biases;
+};
+
+} // namespace svm
+} // namespace mlpack
+
+// Include implementation.
+#include "linear_svm_impl.hpp"
+
+#endif
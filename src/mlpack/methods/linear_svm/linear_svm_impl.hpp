@@ -0,0 +1,372 @@
+/**
+ * @file linear_svm_impl.hpp
+ *
+ * Implementation of the LinearSVM class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_SVM_LINEAR_SVM_IMPL_HPP
+#define MLPACK_METHODS_LINEAR_SVM_LINEAR_SVM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "linear_svm.hpp"
+
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/util/parallel_blocks.hpp>
+#include <random>
+
+namespace mlpack {
+namespace svm {
+
+inline LinearSVM::LinearSVM(const double c,
+                            const bool squaredHinge,
+                            const bool fitIntercept,
+                            const size_t maxIterations,
+                            const double tolerance) :
+    c(c),
+    squaredHinge(squaredHinge),
+    fitIntercept(fitIntercept),
+    maxIterations(maxIterations),
+    tolerance(tolerance)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+LinearSVM::LinearSVM(const MatType& data,
+                     const arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     const double c,
+                     const bool squaredHinge,
+                     const bool fitIntercept,
+                     const size_t maxIterations,
+                     const double tolerance) :
+    c(c),
+    squaredHinge(squaredHinge),
+    fitIntercept(fitIntercept),
+    maxIterations(maxIterations),
+    tolerance(tolerance)
+{
+  Train(data, labels, numClasses);
+}
+
+template<typename MatType>
+void LinearSVM::Train(const MatType& data,
+                      const arma::Row<size_t>& labels,
+                      const size_t numClasses)
+{
+  if (numClasses < 2)
+  {
+    Log::Fatal << "LinearSVM::Train(): the number of classes must be at least "
+        << "2!" << std::endl;
+  }
+
+  if (labels.n_elem != data.n_cols)
+  {
+    Log::Fatal << "LinearSVM::Train(): there are " << data.n_cols << " points "
+        << "but " << labels.n_elem << " labels!" << std::endl;
+  }
+
+  if (labels.n_elem > 0 && arma::max(labels) >= numClasses)
+  {
+    Log::Fatal << "LinearSVM::Train(): labels must be in the range [0, "
+        << numClasses << ")!" << std::endl;
+  }
+
+  if (c <= 0.0)
+    Log::Fatal << "LinearSVM::Train(): C must be positive!" << std::endl;
+
+  // The diagonal of the dual problem is used in every update.
+  const size_t n = data.n_cols;
+  arma::vec sqNorms(n);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    sqNorms[i] = ColumnSqNorm(data, i) + (fitIntercept ? 1.0 : 0.0);
+  }
+
+  weights.zeros(data.n_rows, numClasses);
+  biases.zeros(numClasses);
+
+  // Two classes need only one SVM, for class 1; with more classes, each class
+  // is trained against all the others.  Each problem gets its own seed, so the
+  // result doesn't depend on the order the problems are solved in.
+  const size_t numProblems = (numClasses == 2) ? 1 : numClasses;
+  std::vector<size_t> seeds(numProblems);
+  for (size_t k = 0; k < numProblems; ++k)
+    seeds[k] = (size_t) math::RandInt(std::numeric_limits<int>::max());
+
+  std::vector<size_t> iterations(numProblems);
+
+  #pragma omp parallel for schedule(dynamic) if (numProblems > 1)
+  for (omp_size_t k = 0; k < (omp_size_t) numProblems; ++k)
+  {
+    const size_t positiveClass = (numClasses == 2) ? 1 : k;
+    std::vector<char> positive(n);
+    for (size_t i = 0; i < n; ++i)
+      positive[i] = (labels[i] == positiveClass);
+
+    arma::vec w;
+    double b;
+    iterations[k] = TrainBinary(data, sqNorms, positive, seeds[k], w, b);
+
+    weights.col(positiveClass) = w;
+    biases[positiveClass] = b;
+    if (numClasses == 2)
+    {
+      weights.col(0) = -w;
+      biases[0] = -b;
+    }
+  }
+
+  for (size_t k = 0; k < numProblems; ++k)
+  {
+    Log::Info << "LinearSVM::Train(): ";
+    if (numProblems > 1)
+      Log::Info << "class " << k << ": ";
+    Log::Info << iterations[k] << " passes over the data." << std::endl;
+  }
+}
+
+template<typename VecType>
+size_t LinearSVM::Classify(const VecType& point) const
+{
+  const arma::vec scores = weights.t() * point + biases;
+  return scores.index_max();
+}
+
+template<typename MatType>
+void LinearSVM::Classify(const MatType& data,
+                         arma::Row<size_t>& predictions) const
+{
+  arma::mat scores;
+  Classify(data, predictions, scores);
+}
+
+template<typename MatType>
+void LinearSVM::Classify(const MatType& data,
+                         arma::Row<size_t>& predictions,
+                         arma::mat& scores) const
+{
+  scores.set_size(weights.n_cols, data.n_cols);
+  predictions.set_size(data.n_cols);
+
+  // Each block of points is scored with one matrix product.
+  util::ParallelBlocks(data.n_cols, [&](const size_t begin, const size_t end)
+  {
+    scores.cols(begin, end) = weights.t() * data.cols(begin, end);
+    scores.cols(begin, end).each_col() += biases;
+    for (size_t i = begin; i <= end; ++i)
+      predictions[i] = scores.col(i).index_max();
+  });
+}
+
+template<typename MatType>
+double LinearSVM::ComputeAccuracy(const MatType& data,
+                                  const arma::Row<size_t>& labels) const
+{
+  arma::Row<size_t> predictions;
+  Classify(data, predictions);
+
+  const size_t correct = arma::accu(predictions == labels);
+  return (double) correct / (double) labels.n_elem * 100.0;
+}
+
+template<typename Archive>
+void LinearSVM::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(c);
+  ar & BOOST_SERIALIZATION_NVP(squaredHinge);
+  ar & BOOST_SERIALIZATION_NVP(fitIntercept);
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(tolerance);
+  ar & BOOST_SERIALIZATION_NVP(weights);
+  ar & BOOST_SERIALIZATION_NVP(biases);
+}
+
+template<typename MatType>
+size_t LinearSVM::TrainBinary(const MatType& data,
+                              const arma::vec& sqNorms,
+                              const std::vector<char>& positive,
+                              const size_t seed,
+                              arma::vec& w,
+                              double& b) const
+{
+  // The hinge loss bounds the dual variables by C; the squared hinge loss
+  // instead adds 1 / (2C) to the diagonal.
+  const double inf = std::numeric_limits<double>::infinity();
+  const double upper = squaredHinge ? inf : c;
+  const double diag = squaredHinge ? 0.5 / c : 0.0;
+
+  const size_t n = data.n_cols;
+  w.zeros(data.n_rows);
+  b = 0.0;
+
+  std::vector<double> alpha(n, 0.0);
+  std::vector<size_t> index(n);
+  for (size_t i = 0; i < n; ++i)
+    index[i] = i;
+  size_t activeSize = n;
+
+  // Bounds of the projected gradient in the last pass, used for shrinking.
+  double pgMaxOld = inf;
+  double pgMinOld = -inf;
+
+  std::mt19937 rng((std::mt19937::result_type) seed);
+  size_t iteration = 0;
+  while (maxIterations == 0 || iteration < maxIterations)
+  {
+    ++iteration;
+    std::shuffle(index.begin(), index.begin() + activeSize, rng);
+
+    double pgMax = -inf;
+    double pgMin = inf;
+    size_t s = 0;
+    while (s < activeSize)
+    {
+      const size_t i = index[s];
+      const double y = positive[i] ? 1.0 : -1.0;
+      const double g = y * (ColumnDot(data, i, w) + b) - 1.0 + diag * alpha[i];
+
+      // Compute the projected gradient, and shrink the variable if it is at a
+      // bound and is likely to stay there.
+      double pg = 0.0;
+      if (alpha[i] == 0.0)
+      {
+        if (g > pgMaxOld)
+        {
+          std::swap(index[s], index[--activeSize]);
+          continue;
+        }
+        else if (g < 0.0)
+        {
+          pg = g;
+        }
+      }
+      else if (alpha[i] == upper)
+      {
+        if (g < pgMinOld)
+        {
+          std::swap(index[s], index[--activeSize]);
+          continue;
+        }
+        else if (g > 0.0)
+        {
+          pg = g;
+        }
+      }
+      else
+      {
+        pg = g;
+      }
+
+      pgMax = std::max(pgMax, pg);
+      pgMin = std::min(pgMin, pg);
+
+      if (std::abs(pg) > 1e-12)
+      {
+        const double oldAlpha = alpha[i];
+        const double q = sqNorms[i] + diag;
+        if (q > 0.0)
+          alpha[i] = std::min(std::max(oldAlpha - g / q, 0.0), upper);
+        else
+          alpha[i] = (g < 0.0) ? upper : 0.0;
+
+        const double delta = (alpha[i] - oldAlpha) * y;
+        AddColumn(data, i, delta, w);
+        if (fitIntercept)
+          b += delta;
+      }
+
+      ++s;
+    }
+
+    if (pgMax - pgMin <= tolerance)
+    {
+      // The shrunk problem has converged; check the whole problem again, or
+      // stop if nothing was shrunk.
+      if (activeSize == n)
+        break;
+
+      activeSize = n;
+      pgMaxOld = inf;
+      pgMinOld = -inf;
+      continue;
+    }
+
+    pgMaxOld = (pgMax <= 0.0) ? inf : pgMax;
+    pgMinOld = (pgMin >= 0.0) ? -inf : pgMin;
+  }
+
+  return iteration;
+}
+
+inline double LinearSVM::ColumnDot(const arma::mat& data,
+                                   const size_t i,
+                                   const arma::vec& w)
+{
+  const double* x = data.colptr(i);
+  const double* wMem = w.memptr();
+  double result = 0.0;
+  for (size_t j = 0; j < data.n_rows; ++j)
+    result += x[j] * wMem[j];
+  return result;
+}
+
+inline double LinearSVM::ColumnDot(const arma::sp_mat& data,
+                                   const size_t i,
+                                   const arma::vec& w)
+{
+  const double* wMem = w.memptr();
+  double result = 0.0;
+  for (size_t k = data.col_ptrs[i]; k < data.col_ptrs[i + 1]; ++k)
+    result += data.values[k] * wMem[data.row_indices[k]];
+  return result;
+}
+
+inline void LinearSVM::AddColumn(const arma::mat& data,
+                                 const size_t i,
+                                 const double scale,
+                                 arma::vec& w)
+{
+  const double* x = data.colptr(i);
+  double* wMem = w.memptr();
+  for (size_t j = 0; j < data.n_rows; ++j)
+    wMem[j] += scale * x[j];
+}
+
+inline void LinearSVM::AddColumn(const arma::sp_mat& data,
+                                 const size_t i,
+                                 const double scale,
+                                 arma::vec& w)
+{
+  double* wMem = w.memptr();
+  for (size_t k = data.col_ptrs[i]; k < data.col_ptrs[i + 1]; ++k)
+    wMem[data.row_indices[k]] += scale * data.values[k];
+}
+
+inline double LinearSVM::ColumnSqNorm(const arma::mat& data, const size_t i)
+{
+  const double* x = data.colptr(i);
+  double result = 0.0;
+  for (size_t j = 0; j < data.n_rows; ++j)
+    result += x[j] * x[j];
+  return result;
+}
+
+inline double LinearSVM::ColumnSqNorm(const arma::sp_mat& data,
+                                      const size_t i)
+{
+  double result = 0.0;
+  for (size_t k = data.col_ptrs[i]; k < data.col_ptrs[i + 1]; ++k)
+    result += data.values[k] * data.values[k];
+  return result;
+}
+
+} // namespace svm
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,254 @@
+/**
+ * @file linear_svm_main.cpp
+ *
+ * Main executable for the linear support vector machine.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/data/normalize_labels.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "linear_svm.hpp"
+
+using namespace mlpack;
+using namespace mlpack::svm;
+using namespace mlpack::util;
+using namespace std;
+using namespace arma;
+
+PROGRAM_INFO("Linear Support Vector Machine",
+    "An implementation of linear support vector machines, trained with dual "
+    "coordinate descent (the solver of LIBLINEAR).  Given labeled training "
+    "data, this program can train a model (with the " +
+    PRINT_PARAM_STRING("training") + " and " + PRINT_PARAM_STRING("labels") +
+    " parameters), and an existing model can be loaded with the " +
+    PRINT_PARAM_STRING("input_model") + " parameter.  Points given with the " +
+    PRINT_PARAM_STRING("test") + " parameter are classified, and the "
+    "predictions can be saved with the " + PRINT_PARAM_STRING("predictions") +
+    " output parameter; the score of each point for each class can be saved "
+    "with " + PRINT_PARAM_STRING("scores") + ".  The trained model can be saved"
+    " with the " + PRINT_PARAM_STRING("output_model") + " output parameter."
+    "\n\n"
+    "The training data given with the " + PRINT_PARAM_STRING("training") +
+    " parameter may have class labels as its last dimension, if " +
+    PRINT_PARAM_STRING("labels") + " is not given.  With more than two "
+    "classes, one SVM is trained for each class against all the others, in "
+    "parallel.  The " + PRINT_PARAM_STRING("c") + " parameter is the cost of "
+    "violating the margin; the squared hinge loss can be used instead of the "
+    "hinge loss with " + PRINT_PARAM_STRING("squared_hinge") + ", and " +
+    PRINT_PARAM_STRING("no_intercept") + " trains a model without an "
+    "intercept.  Training stops after " + PRINT_PARAM_STRING("max_iterations") +
+    " passes over the data, or when the dual problem is solved within " +
+    PRINT_PARAM_STRING("tolerance") + ".  If less than half of the entries of "
+    "the training or test data are nonzero, the data is converted to a sparse "
+    "matrix, which makes each pass over the data cost time proportional to the "
+    "number of nonzero entries."
+    "\n\n"
+    "For example, to train a linear SVM on " + PRINT_DATASET("data") + " with "
+    "labels " + PRINT_DATASET("labels") + " and C = 10, saving the model to " +
+    PRINT_MODEL("svm_model") + ", the following command may be used:"
+    "\n\n" +
+    PRINT_CALL("linear_svm", "training", "data", "labels", "labels", "c", 10.0,
+        "output_model", "svm_model") +
+    "\n\n"
+    "Then, to classify the points in " + PRINT_DATASET("test") + " with that "
+    "model, saving the predictions to " + PRINT_DATASET("predictions") + ", "
+    "the following command may be used:"
+    "\n\n" +
+    PRINT_CALL("linear_svm", "input_model", "svm_model", "test", "test",
+        "predictions", "predictions"));
+
+// When we save a model, we must also save the class mappings.  So we use this
+// auxiliary structure to store both the SVM and the mapping, and we'll save
+// this.
+class LinearSVMModel
+{
+ private:
+  LinearSVM svm;
+  Col<size_t> map;
+
+ public:
+  LinearSVM& SVM() { return svm; }
+  const LinearSVM& SVM() const { return svm; }
+
+  Col<size_t>& Map() { return map; }
+  const Col<size_t>& Map() const { return map; }
+
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(svm);
+    ar & BOOST_SERIALIZATION_NVP(map);
+  }
+};
+
+// Training parameters.
+PARAM_MATRIX_IN("training", "A matrix containing the training set.", "t");
+PARAM_UROW_IN("labels", "A matrix containing labels for the training set.",
+    "l");
+PARAM_DOUBLE_IN("c", "Cost of violating the margin (larger values regularize "
+    "less).", "c", 1.0);
+PARAM_FLAG("squared_hinge", "Use the squared hinge loss instead of the hinge "
+    "loss.", "s");
+PARAM_FLAG("no_intercept", "Do not learn an intercept.", "N");
+PARAM_INT_IN("max_iterations", "Maximum number of passes over the data (0 "
+    "indicates no limit).", "n", 1000);
+PARAM_DOUBLE_IN("tolerance", "Tolerance of the dual coordinate descent.", "e",
+    0.1);
+
+// Model loading/saving.
+PARAM_MODEL_IN(LinearSVMModel, "input_model", "Existing model to use.", "m");
+PARAM_MODEL_OUT(LinearSVMModel, "output_model", "Output for trained linear SVM "
+    "model.", "M");
+
+// Testing/classification parameters.
+PARAM_MATRIX_IN("test", "A matrix containing the test set.", "T");
+PARAM_UROW_OUT("predictions", "The matrix in which the predicted labels for "
+    "the test set will be written.", "p");
+PARAM_MATRIX_OUT("scores", "The matrix in which the score of each test point "
+    "for each class will be written.", "S");
+
+// Return whether the given matrix should be converted to a sparse matrix.
+static bool UseSparse(const mat& data)
+{
+  const size_t nonzeros = (size_t) accu(data != 0.0);
+  return (2 * nonzeros < data.n_elem);
+}
+
+static void mlpackMain()
+{
+  // We must either load a model or train a model.
+  RequireAtLeastOnePassed({ "input_model", "training" }, true);
+
+  // If the user isn't going to save the output model or any predictions, we
+  // should issue a warning.
+  RequireAtLeastOnePassed({ "output_model", "predictions", "scores" }, false,
+      "no output will be saved");
+  ReportIgnoredParam({{ "test", false }}, "predictions");
+  ReportIgnoredParam({{ "test", false }}, "scores");
+  ReportIgnoredParam({{ "training", false }}, "labels");
+
+  // Check parameter validity.
+  RequireParamValue<double>("c", [](double x) { return x > 0.0; }, true,
+      "C must be positive");
+  RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; },
+      true, "maximum number of iterations must be nonnegative");
+  RequireParamValue<double>("tolerance", [](double x) { return x > 0.0; },
+      true, "tolerance must be positive");
+
+  LinearSVMModel* model;
+  if (CLI::HasParam("input_model"))
+    model = CLI::GetParam<LinearSVMModel*>("input_model");
+  else
+    model = new LinearSVMModel();
+
+  if (CLI::HasParam("training"))
+  {
+    mat trainingData = std::move(CLI::GetParam<mat>("training"));
+
+    Row<size_t> labelsIn;
+    if (CLI::HasParam("labels"))
+    {
+      labelsIn = std::move(CLI::GetParam<Row<size_t>>("labels"));
+      if (labelsIn.n_elem != trainingData.n_cols)
+      {
+        if (!CLI::HasParam("input_model"))
+          delete model;
+
+        Log::Fatal << "The labels must have the same number of points as the "
+            << "training set." << endl;
+      }
+    }
+    else
+    {
+      if (trainingData.n_rows < 2)
+      {
+        if (!CLI::HasParam("input_model"))
+          delete model;
+
+        Log::Fatal << "Can't get labels from training data since it has less "
+            << "than 2 rows." << endl;
+      }
+
+      // Use the last row of the training data as the labels.
+      Log::Info << "Using the last dimension of training set as labels."
+          << endl;
+      labelsIn = conv_to<Row<size_t>>::from(
+          trainingData.row(trainingData.n_rows - 1));
+      trainingData.shed_row(trainingData.n_rows - 1);
+    }
+
+    Row<size_t> labels;
+    data::NormalizeLabels(labelsIn, labels, model->Map());
+    const size_t numClasses = model->Map().n_elem;
+    if (numClasses < 2)
+    {
+      if (!CLI::HasParam("input_model"))
+        delete model;
+
+      Log::Fatal << "The training set must have at least 2 classes!" << endl;
+    }
+
+    LinearSVM& svm = model->SVM();
+    svm.C() = CLI::GetParam<double>("c");
+    svm.SquaredHinge() = CLI::HasParam("squared_hinge");
+    svm.FitIntercept() = !CLI::HasParam("no_intercept");
+    svm.MaxIterations() = (size_t) CLI::GetParam<int>("max_iterations");
+    svm.Tolerance() = CLI::GetParam<double>("tolerance");
+
+    Timer::Start("training");
+    if (UseSparse(trainingData))
+    {
+      Log::Info << "Training on the training set as a sparse matrix." << endl;
+      const sp_mat sparseData(trainingData);
+      svm.Train(sparseData, labels, numClasses);
+    }
+    else
+    {
+      svm.Train(trainingData, labels, numClasses);
+    }
+    Timer::Stop("training");
+  }
+
+  if (CLI::HasParam("test"))
+  {
+    mat testData = std::move(CLI::GetParam<mat>("test"));
+    const LinearSVM& svm = model->SVM();
+    if (testData.n_rows != svm.Weights().n_rows)
+    {
+      const size_t dimensionality = svm.Weights().n_rows;
+      if (!CLI::HasParam("input_model"))
+        delete model;
+
+      Log::Fatal << "Test data dimensionality (" << testData.n_rows << ") "
+          << "must be the same as the dimensionality of the model ("
+          << dimensionality << ")!" << endl;
+    }
+
+    Row<size_t> predictions;
+    mat scores;
+    Timer::Start("testing");
+    if (UseSparse(testData))
+      svm.Classify(sp_mat(testData), predictions, scores);
+    else
+      svm.Classify(testData, predictions, scores);
+    Timer::Stop("testing");
+
+    if (CLI::HasParam("predictions"))
+    {
+      Row<size_t> results;
+      data::RevertLabels(predictions, model->Map(), results);
+      CLI::GetParam<Row<size_t>>("predictions") = std::move(results);
+    }
+
+    if (CLI::HasParam("scores"))
+      CLI::GetParam<mat>("scores") = std::move(scores);
+  }
+
+  CLI::GetParam<LinearSVMModel*>("output_model") = model;
+}
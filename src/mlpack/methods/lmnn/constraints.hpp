@@ -26,6 +26,15 @@ namespace lmnn {
  * of each data point), Impostors() (used for calculating impostors of each
  * data point) and Triplets() (Generates sets of {dataset, target neighbors,
  * impostors} tripltets.)
+ *
+ * Impostors are recomputed many times on slowly changing datasets (the
+ * dataset transformed by the current LMNN transformation), so the reference
+ * tree of each class (which holds the points of the other classes) is kept
+ * between calls.  If the points of a tree have not moved, the tree is reused
+ * as it is; if they have moved by a small distance since the tree was built
+ * (see RefitTolerance()), only the bounds of the tree are recomputed;
+ * otherwise the tree is built again.  The impostors of the different classes
+ * are searched in parallel.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class Constraints
@@ -34,6 +43,8 @@ class Constraints
   //! Convenience typedef.
   typedef neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType>
       KNN;
+  //! The type of the reference tree of each class.
+  typedef typename KNN::Tree Tree;
 
   /**
    * Constructor for creating a Constraints instance.
@@ -178,6 +189,16 @@ class Constraints
   //! Modify the number of target neighbors (k).
   size_t& K() { return k; }
 
+  //! Get the largest total displacement of the points of a reference tree,
+  //! relative to the diameter of the points when the tree was built, for which
+  //! the bounds of the tree are recomputed instead of building it again.
+  double RefitTolerance() const { return refitTolerance; }
+  //! Modify the largest total displacement of the points of a reference tree,
+  //! relative to the diameter of the points when the tree was built, for which
+  //! the bounds of the tree are recomputed instead of building it again (0
+  //! means that trees are built again whenever the points move).
+  double& RefitTolerance() { return refitTolerance; }
+
   //! Access the boolean value of precalculated.
   const bool& PreCalulated() const { return precalculated; }
   //! Modify the value of precalculated.
@@ -199,12 +220,56 @@ class Constraints
   //! False if nothing has ever been precalculated.
   bool precalculated;
 
+  //! The relative displacement of the points for which trees are refitted.
+  double refitTolerance;
+
+  //! For each class, the k-nearest-neighbor search on the points of the other
+  //! classes, used to find impostors.  It is empty until it is first needed.
+  std::vector<KNN> impostorSearchers;
+
+  //! For each class, the index in indexDiff of each point of its reference
+  //! tree.
+  std::vector<std::vector<size_t>> oldFromNewDiff;
+
+  //! For each class, the diameter of the points of its reference tree when it
+  //! was built.
+  std::vector<double> treeDiameters;
+
+  //! For each class, the total displacement of the points of its reference
+  //! tree since it was built.
+  std::vector<double> treeDisplacements;
+
   /**
   * Precalculate the unique labels, and indices of similar
   * and different datapoints on the basis of labels.
   */
   inline void Precalculate(const arma::Row<size_t>& labels);
 
+  /**
+  * Throw an exception if one of the given sets of indices (one for each class)
+  * has fewer than minCount points.
+  */
+  inline void CheckCount(const std::vector<arma::uvec>& indices,
+                         const size_t minCount,
+                         const std::string& functionName) const;
+
+  /**
+  * Make the reference tree of the given class hold the current points of the
+  * other classes, by reusing it, recomputing its bounds or building it again.
+  */
+  void UpdateTree(const arma::mat& dataset, const size_t classIndex);
+
+  /**
+  * Find the impostors of the given query points, which all belong to the given
+  * class, and map them to their index in the dataset.
+  */
+  void SearchImpostors(const arma::mat& dataset,
+                       const size_t classIndex,
+                       const arma::mat& querySet,
+                       arma::Mat<size_t>& neighbors,
+                       arma::mat& distances,
+                       const arma::vec& norms);
+
   /**
   * Re-order neighbors on the basis of increasing norm in case
   * of ties among distances.
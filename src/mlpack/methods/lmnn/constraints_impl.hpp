@@ -24,7 +24,8 @@ Constraints<MetricType>::Constraints(
     const arma::Row<size_t>& labels,
     const size_t k) :
     k(k),
-    precalculated(false)
+    precalculated(false),
+    refitTolerance(0.1)
 {
   // Ensure a valid k is passed.
   size_t minCount = arma::min(arma::histc(labels, arma::unique(labels)));
@@ -86,15 +87,18 @@ void Constraints<MetricType>::TargetNeighbors(arma::Mat<size_t>& outputMatrix,
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
+  CheckCount(indexSame, k + 1, "TargetNeighbors");
 
-  // KNN instance.
-  KNN knn;
+  // The classes are independent, so they are handled in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
+  {
+    // KNN instance.
+    KNN knn;
 
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
     // Perform KNN search with same class points as both reference
     // set and query set.
     knn.Train(dataset.cols(indexSame[i]));
@@ -125,23 +129,23 @@ void Constraints<MetricType>::TargetNeighbors(arma::Mat<size_t>& outputMatrix,
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
+  CheckCount(indexSame, k, "TargetNeighbors");
 
   arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
+  // The classes are independent, so they are handled in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
+  {
+    // KNN instance.
+    KNN knn;
 
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
     // Calculate Target Neighbors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    arma::uvec subIndexSame = arma::find(sublabels == uniqueLabels[i]);
 
     // Perform KNN search with same class points as both reference
     // set and query set.
@@ -170,27 +174,19 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
+  CheckCount(indexDiff, k, "Impostors");
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
+  // The classes are independent, so they are handled in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
   {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+
     // Perform KNN search with differently labeled points as reference
     // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
+    SearchImpostors(dataset, i, dataset.cols(indexSame[i]), neighbors,
+        distances, norms);
 
     // Store impostors.
     outputMatrix.cols(indexSame[i]) = neighbors;
@@ -208,27 +204,19 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
+  CheckCount(indexDiff, k, "Impostors");
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
+  // The classes are independent, so they are handled in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
   {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+
     // Perform KNN search with differently labeled points as reference
     // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
+    SearchImpostors(dataset, i, dataset.cols(indexSame[i]), neighbors,
+        distances, norms);
 
     // Store impostors.
     outputNeighbors.cols(indexSame[i]) = neighbors;
@@ -248,36 +236,27 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
+  CheckCount(indexDiff, k, "Impostors");
 
   arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
+  // The classes are independent, so they are handled in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
   {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+
     // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    arma::uvec subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    if (subIndexSame.n_elem == 0)
+      continue;
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
+    SearchImpostors(dataset, i, subDataset.cols(subIndexSame), neighbors,
+        distances, norms);
 
     // Store impostors.
     outputMatrix.cols(begin + subIndexSame) = neighbors;
@@ -297,36 +276,27 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
+  CheckCount(indexDiff, k, "Impostors");
 
   arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
+  // The classes are independent, so they are handled in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
   {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+
     // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    arma::uvec subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    if (subIndexSame.n_elem == 0)
+      continue;
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
+    SearchImpostors(dataset, i, subDataset.cols(subIndexSame), neighbors,
+        distances, norms);
 
     // Store impostors.
     outputNeighbors.cols(begin + subIndexSame) = neighbors;
@@ -347,35 +317,25 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
+  CheckCount(indexDiff, k, "Impostors");
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
+  // The classes are independent, so they are handled in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
   {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+
     // Calculate impostors.
-    subIndexSame = arma::find(labels.cols(points.head(numPoints)) ==
+    arma::uvec subIndexSame = arma::find(labels.cols(points.head(numPoints)) ==
         uniqueLabels[i]);
+    if (subIndexSame.n_elem == 0)
+      continue;
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(points.elem(subIndexSame)),
-        k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
+    SearchImpostors(dataset, i, dataset.cols(points.elem(subIndexSame)),
+        neighbors, distances, norms);
 
     // Store impostors.
     outputNeighbors.cols(points.elem(subIndexSame)) = neighbors;
@@ -439,9 +399,110 @@ inline void Constraints<MetricType>::Precalculate(
     indexDiff[i] = arma::find(labels != uniqueLabels[i]);
   }
 
+  // The reference trees of the old labels can't be used anymore.
+  impostorSearchers.clear();
+  impostorSearchers.resize(uniqueLabels.n_elem);
+  oldFromNewDiff.clear();
+  oldFromNewDiff.resize(uniqueLabels.n_elem);
+  treeDiameters.assign(uniqueLabels.n_elem, 0.0);
+  treeDisplacements.assign(uniqueLabels.n_elem, 0.0);
+
   precalculated = true;
 }
 
+template<typename MetricType>
+inline void Constraints<MetricType>::CheckCount(
+    const std::vector<arma::uvec>& indices,
+    const size_t minCount,
+    const std::string& functionName) const
+{
+  // This is checked before the classes are searched in parallel, since
+  // exceptions can't be thrown out of a parallel loop.
+  for (size_t i = 0; i < indices.size(); i++)
+  {
+    if (indices[i].n_elem < minCount)
+    {
+      std::stringstream ss;
+      ss << "Constraints::" << functionName << "(): requested value of k ("
+          << k << ") is too large; only " << indices[i].n_elem << " points "
+          << "can be searched for some class!";
+      throw std::invalid_argument(ss.str());
+    }
+  }
+}
+
+template<typename MetricType>
+void Constraints<MetricType>::UpdateTree(const arma::mat& dataset,
+                                         const size_t classIndex)
+{
+  const arma::uvec& indices = indexDiff[classIndex];
+  std::vector<size_t>& oldFromNew = oldFromNewDiff[classIndex];
+
+  if (oldFromNew.size() == indices.n_elem)
+  {
+    // Find how far the points have moved since the tree was updated.
+    arma::mat& treePoints =
+        impostorSearchers[classIndex].ReferenceTree().Dataset();
+    double displacement = 0.0;
+    for (size_t j = 0; j < oldFromNew.size(); j++)
+    {
+      displacement = std::max(displacement, arma::norm(
+          dataset.col(indices[oldFromNew[j]]) - treePoints.col(j)));
+    }
+
+    // If the points haven't moved, the tree can be used as it is.
+    if (displacement == 0.0)
+      return;
+
+    // If they haven't moved much since the tree was built, its splits are
+    // still good, so only the bounds are recomputed.
+    treeDisplacements[classIndex] += displacement;
+    if (treeDisplacements[classIndex] <=
+        refitTolerance * treeDiameters[classIndex])
+    {
+      for (size_t j = 0; j < oldFromNew.size(); j++)
+        treePoints.col(j) = dataset.col(indices[oldFromNew[j]]);
+
+      impostorSearchers[classIndex].ReferenceTree().RefitBounds();
+      return;
+    }
+  }
+
+  // Build the tree again.
+  arma::mat points = dataset.cols(indices);
+  treeDiameters[classIndex] = arma::norm(arma::max(points, 1) -
+      arma::min(points, 1));
+  treeDisplacements[classIndex] = 0.0;
+
+  Tree tree(std::move(points), oldFromNew);
+  impostorSearchers[classIndex].Train(std::move(tree));
+}
+
+template<typename MetricType>
+void Constraints<MetricType>::SearchImpostors(const arma::mat& dataset,
+                                              const size_t classIndex,
+                                              const arma::mat& querySet,
+                                              arma::Mat<size_t>& neighbors,
+                                              arma::mat& distances,
+                                              const arma::vec& norms)
+{
+  UpdateTree(dataset, classIndex);
+  impostorSearchers[classIndex].Search(querySet, k, neighbors, distances);
+
+  // Map the neighbors from the order of the reference tree to the order of
+  // the differently labeled points.
+  for (size_t j = 0; j < neighbors.n_elem; j++)
+    neighbors(j) = oldFromNewDiff[classIndex][neighbors(j)];
+
+  // Re-order neighbors on the basis of increasing norm in case
+  // of ties among distances.
+  ReorderResults(distances, neighbors, norms);
+
+  // Re-map neighbors to their index.
+  for (size_t j = 0; j < neighbors.n_elem; j++)
+    neighbors(j) = indexDiff[classIndex].at(neighbors(j));
+}
+
 } // namespace lmnn
 } // namespace mlpack
 
@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_LOGISTIC_REGRESSION_LOGISTIC_REGRESSION_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/streaming_function.hpp>
 
 namespace mlpack {
 namespace regression {
@@ -49,8 +50,12 @@ class LogisticRegressionFunction
 
   //! Return the matrix of predictors.
   const MatType& Predictors() const { return predictors; }
+  //! Modify the matrix of predictors.
+  MatType& Predictors() { return predictors; }
   //! Return the vector of responses.
   const arma::Row<size_t>& Responses() const { return responses; }
+  //! Modify the vector of responses.
+  arma::Row<size_t>& Responses() { return responses; }
 
   /**
   * Shuffle the order of function visitation.  This may be called by the optimizer.
@@ -119,6 +124,27 @@ class LogisticRegressionFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * for the given batch of points, as a sparse matrix.  Only the intercept and
+   * the weights of the features that are non-zero in the given points are
+   * affected by those points, so if lambda is 0 the gradient is as sparse as
+   * the points are, and no dense vector of the size of the model is ever
+   * formed; this is the form used by ParallelSGD.  If lambda is not 0, the
+   * regularization makes the gradient dense.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the starting point to use for objective function
+   *     gradient evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *     function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
    * with the given parameters, and with respect to only one feature in the
@@ -171,6 +197,44 @@ class LogisticRegressionFunction
 };
 
 } // namespace regression
+
+namespace data {
+
+/**
+ * When LogisticRegressionFunction is trained with a StreamingFunction, it only
+ * holds one chunk of the data at a time.  The regularization term of a batch
+ * is scaled by the number of points the function holds, so lambda is scaled by
+ * the fraction of the dataset in the chunk to give the same objective as
+ * training on the whole dataset.
+ */
+template<typename MatType>
+class ChunkSetter<regression::LogisticRegressionFunction<MatType>>
+{
+ public:
+  ChunkSetter(const regression::LogisticRegressionFunction<MatType>& function) :
+      lambda(function.Lambda())
+  { }
+
+  template<typename PredictorsType, typename ResponsesType>
+  void Set(regression::LogisticRegressionFunction<MatType>& function,
+           PredictorsType&& predictors,
+           ResponsesType&& responses,
+           const size_t numPoints)
+  {
+    math::ClearAlias(function.Predictors());
+    math::ClearAlias(function.Responses());
+
+    function.Predictors() = std::move(predictors);
+    function.Responses() = arma::conv_to<arma::Row<size_t>>::from(responses);
+    function.Lambda() = lambda * function.Predictors().n_cols / numPoints;
+  }
+
+ private:
+  //! The regularization parameter for the whole dataset.
+  double lambda;
+};
+
+} // namespace data
 } // namespace mlpack
 
 // Include implementation.
@@ -199,6 +199,56 @@ void LogisticRegressionFunction<MatType>::Gradient(
       predictors.cols(begin, begin + batchSize - 1).t() + regularization;
 }
 
+//! Evaluate the gradient of the logistic regression objective function for a
+//! given batch size, as a sparse matrix.
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+                const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize) const
+{
+  const arma::rowvec exponents = parameters(0, 0) +
+      parameters.tail_cols(parameters.n_elem - 1) *
+      predictors.cols(begin, begin + batchSize - 1);
+  // Calculating the sigmoid function values.
+  const arma::rowvec diffs = 1.0 / (1.0 + arma::exp(-exponents)) -
+      arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
+      begin + batchSize - 1));
+
+  // Every non-zero value of a point adds to the weight of its feature; the
+  // contributions are collected and summed when the sparse gradient is built.
+  const arma::sp_mat batch(predictors.cols(begin, begin + batchSize - 1));
+  arma::umat locations(2, batch.n_nonzero + 1);
+  arma::vec values(batch.n_nonzero + 1);
+
+  locations(0, 0) = 0;
+  locations(1, 0) = 0;
+  values[0] = arma::accu(diffs);
+
+  size_t k = 1;
+  for (arma::sp_mat::const_iterator it = batch.begin(); it != batch.end();
+       ++it, ++k)
+  {
+    locations(0, k) = 0;
+    locations(1, k) = it.row() + 1;
+    values[k] = diffs[it.col()] * (*it);
+  }
+
+  gradient = arma::sp_mat(true, locations, values, parameters.n_rows,
+      parameters.n_cols);
+
+  // Regularization term.
+  if (lambda != 0.0)
+  {
+    arma::mat regularization = arma::zeros<arma::mat>(arma::size(parameters));
+    regularization.tail_cols(parameters.n_elem - 1) = lambda *
+        parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
+        batchSize;
+    gradient += arma::sp_mat(regularization);
+  }
+}
+
 /**
  * Evaluate the partial gradient of the logistic regression objective
  * function with respect to the individual features in the parameter.
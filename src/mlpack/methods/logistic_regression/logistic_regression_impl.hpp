@@ -17,6 +17,8 @@
 // In case it hasn't been included yet.
 #include "logistic_regression.hpp"
 
+#include <mlpack/core/util/parallel_blocks.hpp>
+
 namespace mlpack {
 namespace regression {
 
@@ -115,10 +117,15 @@ void LogisticRegression<MatType>::Classify(const MatType& dataset,
 {
   // Calculate sigmoid function for each point.  The (1.0 - decisionBoundary)
   // term correctly sets an offset so that floor() returns 0 or 1 correctly.
-  labels = arma::conv_to<arma::Row<size_t>>::from((1.0 /
-      (1.0 + arma::exp(-parameters(0) -
-      parameters.tail_cols(parameters.n_elem - 1) * dataset))) +
-      (1.0 - decisionBoundary));
+  // Blocks of points are handled in parallel.
+  labels.set_size(dataset.n_cols);
+  util::ParallelBlocks(dataset.n_cols, [&](const size_t begin, const size_t end)
+  {
+    labels.cols(begin, end) = arma::conv_to<arma::Row<size_t>>::from((1.0 /
+        (1.0 + arma::exp(-parameters(0) -
+        parameters.tail_cols(parameters.n_elem - 1) *
+        dataset.cols(begin, end)))) + (1.0 - decisionBoundary));
+  });
 }
 
 template<typename MatType>
@@ -128,9 +135,14 @@ void LogisticRegression<MatType>::Classify(const MatType& dataset,
   // Set correct size of output matrix.
   probabilities.set_size(2, dataset.n_cols);
 
-  probabilities.row(1) = 1.0 / (1.0 + arma::exp(-parameters(0) -
-      parameters.tail_cols(parameters.n_elem - 1) * dataset));
-  probabilities.row(0) = 1.0 - probabilities.row(1);
+  util::ParallelBlocks(dataset.n_cols, [&](const size_t begin, const size_t end)
+  {
+    probabilities.submat(1, begin, 1, end) = 1.0 / (1.0 +
+        arma::exp(-parameters(0) - parameters.tail_cols(parameters.n_elem - 1) *
+        dataset.cols(begin, end)));
+    probabilities.submat(0, begin, 0, end) = 1.0 -
+        probabilities.submat(1, begin, 1, end);
+  });
 }
 
 template<typename MatType>
@@ -16,11 +16,13 @@
 #include "logistic_regression.hpp"
 
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/methods/random_fourier_features/random_fourier_features.hpp>
 
 using namespace std;
 using namespace mlpack;
 using namespace mlpack::regression;
 using namespace mlpack::optimization;
+using namespace mlpack::kernel;
 using namespace mlpack::util;
 
 PROGRAM_INFO("L2-regularized Logistic Regression and Prediction",
@@ -95,7 +97,12 @@ PROGRAM_INFO("L2-regularized Logistic Regression and Prediction",
     PRINT_DATASET("predictions") + "', the following command may be used: "
     "\n\n" +
     PRINT_CALL("logistic_regression", "input_model", "lr_model", "test", "test",
-        "output", "predictions"));
+        "output", "predictions") +
+    "\n\n"
+    "Kernel logistic regression can be approximated by giving a random Fourier "
+    "features transform created by preprocess_random_features with " +
+    PRINT_PARAM_STRING("feature_model") + ".  It is applied to the training "
+    "and test data, and must also be given when a saved model is used.");
 
 // Training parameters.
 PARAM_MATRIX_IN("training", "A matrix containing the training set (the matrix "
@@ -115,6 +122,9 @@ PARAM_INT_IN("max_iterations", "Maximum iterations for optimizer (0 indicates "
 PARAM_DOUBLE_IN("step_size", "Step size for SGD optimizer.",
     "s", 0.01);
 PARAM_INT_IN("batch_size", "Batch size for SGD.", "b", 64);
+PARAM_MODEL_IN(RandomFourierFeatures, "feature_model", "Random Fourier "
+    "features transform (see preprocess_random_features) to apply to the "
+    "training and test data.", "F");
 
 // Model loading/saving.
 PARAM_MODEL_IN(LogisticRegression<>, "input_model", "Existing model "
@@ -133,6 +143,28 @@ PARAM_DOUBLE_IN("decision_boundary", "Decision boundary for prediction; if the "
     "logistic function for a point is less than the boundary, the class is "
     "taken to be 0; otherwise, the class is 1.", "d", 0.5);
 
+// Map the given data to random Fourier features, if a transform was given.
+static void ApplyFeatureModel(arma::mat& data, const string& paramName)
+{
+  if (!CLI::HasParam("feature_model"))
+    return;
+
+  const RandomFourierFeatures* rff =
+      CLI::GetParam<RandomFourierFeatures*>("feature_model");
+  if (rff->Dimensionality() != data.n_rows)
+  {
+    Log::Fatal << "The transform given with "
+        << PRINT_PARAM_STRING("feature_model") << " is for "
+        << rff->Dimensionality() << "-dimensional data, but "
+        << PRINT_PARAM_STRING(paramName) << " has " << data.n_rows
+        << " dimensions!" << endl;
+  }
+
+  arma::mat features;
+  rff->Transform(data, features);
+  data = std::move(features);
+}
+
 static void mlpackMain()
 {
   // Collect command-line options.
@@ -272,6 +304,15 @@ static void mlpackMain()
         << "!" << endl;
   }
 
+  // Map the training data to random Fourier features, if requested; a new
+  // model then has to match the dimensionality of the features.
+  if (CLI::HasParam("training") && CLI::HasParam("feature_model"))
+  {
+    ApplyFeatureModel(regressors, "training");
+    if (!CLI::HasParam("input_model"))
+      model->Parameters() = arma::zeros<arma::rowvec>(regressors.n_rows + 1);
+  }
+
   // Now, do the training.
   if (CLI::HasParam("training"))
   {
@@ -304,6 +345,7 @@ static void mlpackMain()
   if (CLI::HasParam("test"))
   {
     testSet = std::move(CLI::GetParam<arma::mat>("test"));
+    ApplyFeatureModel(testSet, "test");
 
     // Checking the dimensionality of the test data.
     if (testSet.n_rows != model->Parameters().n_cols - 1)
@@ -13,6 +13,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/util/serve_queries.hpp>
 
 #include <mlpack/core/metrics/lmetric.hpp>
 
@@ -49,7 +50,19 @@ PROGRAM_INFO("K-Approximate-Nearest-Neighbor Search with LSH",
     " parameter can be specified to set the random seed."
     "\n\n"
     "This program also has many other parameters to control its functionality;"
-    " see the parameter-specific documentation for more information.");
+    " see the parameter-specific documentation for more information."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("server") + " is specified, the model is kept "
+    "in memory and batches of query points are read from standard input, one "
+    "point per line with values separated by commas or spaces; an empty line "
+    "ends a batch.  For each batch, one line is written to standard output for "
+    "each query point, holding the " + PRINT_PARAM_STRING("k") + " neighbor "
+    "indices followed by the " + PRINT_PARAM_STRING("k") + " distances, and an "
+    "empty line ends the answer.  This continues until standard input is "
+    "closed, so the cost of loading or building the model is paid only once.  "
+    "Since informational messages are also written to standard output, " +
+    PRINT_PARAM_STRING("verbose") + " should not be combined with " +
+    PRINT_PARAM_STRING("server") + ".");
 
 // Define our input parameters that this program will take.
 PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
@@ -81,6 +94,8 @@ PARAM_INT_IN("second_hash_size", "The size of the second level hash table.",
 PARAM_INT_IN("bucket_size", "The size of a bucket in the second level hash.",
     "B", 500);
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+PARAM_FLAG("server", "If set, keep the model in memory and answer batches of "
+    "query points read from standard input until it is closed.", "");
 
 static void mlpackMain()
 {
@@ -105,9 +120,22 @@ static void mlpackMain()
   size_t bucketSize = CLI::GetParam<int>("bucket_size");
 
   RequireOnlyOnePassed({ "input_model", "reference" }, true);
-  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
-      "no results will be saved");
-  if (CLI::HasParam("k"))
+
+  // In server mode, the number of neighbors must be known, and results are
+  // written to standard output.
+  const bool server = CLI::HasParam("server");
+  if (server)
+  {
+    RequireAtLeastOnePassed({ "k" }, true, "the number of neighbors must be "
+        "given in server mode");
+  }
+  else
+  {
+    RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" },
+        false, "no results will be saved");
+  }
+
+  if (CLI::HasParam("k") && !server)
   {
     RequireAtLeastOnePassed({ "query", "reference" }, true, "must pass set to "
         "search");
@@ -174,7 +202,9 @@ static void mlpackMain()
     allkann = CLI::GetParam<LSHSearch<>*>("input_model");
   }
 
-  if (CLI::HasParam("k"))
+  // In server mode, only a given query set is searched before serving.
+  const bool search = CLI::HasParam("k") && (!server || CLI::HasParam("query"));
+  if (search)
   {
     Log::Info << "Computing " << k << " distance approximate nearest neighbors."
         << endl;
@@ -221,10 +251,27 @@ static void mlpackMain()
   }
 
   // Save output, if we did a search..
-  if (CLI::HasParam("k"))
+  if (search)
   {
     CLI::GetParam<arma::mat>("distances") = std::move(distances);
     CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
   }
+  // Answer queries from standard input, if desired.
+  if (server)
+  {
+    Log::Info << "Serving " << k << "-approximate-nearest-neighbor queries "
+        << "from standard input." << endl;
+
+    const size_t numBatches = ServeQueries(std::cin, std::cout,
+        allkann->ReferenceSet().n_rows, [&](const arma::mat& queries,
+                                            arma::Mat<size_t>& batchNeighbors,
+                                            arma::mat& batchDistances)
+    {
+      allkann->Search(queries, k, batchNeighbors, batchDistances, 0, numProbes);
+    });
+
+    Log::Info << "Answered " << numBatches << " query batches." << endl;
+  }
+
   CLI::GetParam<LSHSearch<>*>("output_model") = allkann;
 }
@@ -240,6 +240,44 @@ class LSHSearch
               const size_t numTablesToSearch = 0,
               size_t T = 0);
 
+  /**
+   * Add the given points to the reference set, without retraining the model.
+   * The new points get the indices ReferenceSet().n_cols to
+   * ReferenceSet().n_cols + points.n_cols - 1.  They are hashed with the
+   * existing projections and offsets and appended to their buckets; just like
+   * in Train(), a point is not added to a bucket that already holds bucketSize
+   * points.  The points removed with Remove() are dropped from the buckets,
+   * which makes room for the new points.
+   *
+   * Since the buckets are stored one after the other, each call copies the
+   * second hash table, so points should be inserted in batches rather than one
+   * at a time.  The hash width is not recomputed, so if the distribution of
+   * the data changes a lot, the model should be trained again.
+   *
+   * @param points Points to add to the reference set.
+   */
+  void Insert(const arma::mat& points);
+
+  /**
+   * Remove the point with the given index from the reference set.  The point
+   * is marked as removed and is never returned as a neighbor again, but it
+   * stays in the reference set, so the indices of the other points don't
+   * change; it is dropped from the hash table by the next call to Insert(), and
+   * from the reference set by the next call to Train().  Removing a point twice
+   * has no effect.
+   *
+   * @param index Index of the point to remove.
+   */
+  void Remove(const size_t index);
+
+  //! Return whether the point with the given index was removed.
+  bool IsRemoved(const size_t index) const
+  { return !removed.empty() && removed[index]; }
+
+  //! Return the number of points that were removed from the reference set.
+  size_t NumRemoved() const
+  { return std::count(removed.begin(), removed.end(), true); }
+
   /**
    * Compute the recall (% of neighbors found) given the neighbors returned by
    * LSHSearch::Search and a "ground truth" set of neighbors.  The recall
@@ -280,9 +318,20 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  /**
+   * Get the second hash table, with one vector for each non-empty bucket.  The
+   * table is built from the compact representation (see BucketContents()), so
+   * this makes a copy; it is meant for inspection, not for searching.
+   */
+  std::vector<arma::Col<size_t>> SecondHashTable() const;
+
+  //! Get the points in the non-empty buckets of the second hash table, bucket
+  //! after bucket.
+  const arma::Col<arma::u32>& BucketContents() const { return bucketContents; }
+
+  //! Get the offset of each non-empty bucket in BucketContents(); bucket i
+  //! holds the elements from BucketOffsets()[i] to BucketOffsets()[i + 1] - 1.
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -297,24 +346,90 @@ class LSHSearch
 
  private:
   /**
-   * This function takes a query and hashes it into each of the hash tables to
-   * get keys for the query and then the key is hashed to a bucket of the second
-   * hash table and all the points (if any) in those buckets are collected as
-   * the potential neighbor candidates.
+   * Scratch space used to answer one query at a time.  Each thread of a search
+   * keeps one QueryBuffers object for all of its queries, so that the buffers
+   * are only allocated when the first query is processed.
+   */
+  struct QueryBuffers
+  {
+    //! The projections of the current block of queries (see
+    //! ProjectQueries()).
+    arma::mat blockCodes;
+    //! The code of the query in each table.
+    arma::mat allProjInTables;
+    //! The second hash table bucket of each probing bin (rows) in each table
+    //! (columns).
+    arma::Mat<size_t> hashMat;
+    //! The codes of the additional probing bins of one table (one per column).
+    arma::mat additionalProbingBins;
+    //! The score, action and position of each multiprobe perturbation.
+    arma::vec scores;
+    arma::Col<short int> actions;
+    arma::Col<size_t> positions;
+    //! The perturbations in increasing order of score, and their scores.
+    arma::uvec order;
+    arma::vec sortedScores;
+    //! Storage for multiprobe perturbation sets; only some are in use.
+    std::vector<std::vector<bool>> perturbationSets;
+    //! The perturbation sets being extended.
+    std::vector<bool> currentSet, shiftedSet, expandedSet;
+    //! The min-heap of (score, perturbation set index) pairs.
+    std::vector<std::pair<double, size_t>> minHeap;
+    //! One bit for each reference point; set while the point is a candidate.
+    std::vector<uint64_t> found;
+    //! The candidate neighbors of the query, in increasing order.
+    std::vector<size_t> referenceIndices;
+    //! The heap of the best k (distance, index) candidates.
+    std::vector<std::pair<double, size_t>> candidates;
+  };
+
+  /**
+   * Compute the bucket of the second hash table of each of the given points in
+   * each table.  The tables are hashed in parallel.
    *
-   * @param queryPoint The query point currently being processed.
-   * @param referenceIndices The list of neighbor candidates obtained from
-   *    hashing the query into all the hash tables and eventually into
-   *    multiple buckets of the second hash table.
-   * @param numTablesToSearch The number of tables to perform the search in. If
-   *    0, all tables are searched.
+   * @param points Points to hash.
+   * @param secondHashVectors Matrix to store the buckets in; the bucket of
+   *    point j in table i is held in (i, j).
+   */
+  void HashPoints(const arma::mat& points,
+                  arma::Mat<size_t>& secondHashVectors) const;
+
+  /**
+   * Project a block of queries in the first numTablesToSearch tables, with one
+   * matrix multiplication per table for the whole block.  Column i of codes
+   * holds the projections of query (begin + i), offsets included, table after
+   * table: numProj elements for each table.
+   *
+   * @param querySet Set of query points.
+   * @param begin Index of the first query of the block.
+   * @param end Index one past the last query of the block.
+   * @param numTablesToSearch The number of tables to project the queries in.
+   * @param codes Matrix to store the projections in.
+   */
+  void ProjectQueries(const arma::mat& querySet,
+                      const size_t begin,
+                      const size_t end,
+                      const size_t numTablesToSearch,
+                      arma::mat& codes) const;
+
+  /**
+   * This function takes the projections of a query in each of the hash tables
+   * to get keys for the query and then the key is hashed to a bucket of the
+   * second hash table and all the points (if any) in those buckets are
+   * collected as the potential neighbor candidates.
+   *
+   * The candidates are stored in buffers.referenceIndices, in increasing
+   * order and without duplicates.
+   *
+   * @param queryCodesNotFloored The projections of the query, offsets
+   *    included, with one column for each table to search (as computed by
+   *    ProjectQueries()).
+   * @param buffers The buffers of the calling thread.
    * @param T The number of additional probing bins for multiprobe LSH. If 0,
    *    single-probe is used.
    */
-  template<typename VecType>
-  void ReturnIndicesFromTable(const VecType& queryPoint,
-                              arma::uvec& referenceIndices,
-                              size_t numTablesToSearch,
+  void ReturnIndicesFromTable(const arma::mat& queryCodesNotFloored,
+                              QueryBuffers& buffers,
                               const size_t T) const;
 
   /**
@@ -329,12 +444,15 @@ class LSHSearch
    * @param k Number of neighbors to search for.
    * @param neighbors Matrix holding output neighbors.
    * @param distances Matrix holding output distances.
+   * @param candidates Vector to store the heap of candidate neighbors in.
+   * @return The number of distances that were computed.
    */
-  void BaseCase(const size_t queryIndex,
-                const arma::uvec& referenceIndices,
-                const size_t k,
-                arma::Mat<size_t>& neighbors,
-                arma::mat& distances) const;
+  size_t BaseCase(const size_t queryIndex,
+                  const std::vector<size_t>& referenceIndices,
+                  const size_t k,
+                  arma::Mat<size_t>& neighbors,
+                  arma::mat& distances,
+                  std::vector<std::pair<double, size_t>>& candidates) const;
 
   /**
    * This is a helper function that computes the distance of the query to the
@@ -349,13 +467,16 @@ class LSHSearch
    * @param querySet Set of query points.
    * @param neighbors Matrix holding output neighbors.
    * @param distances Matrix holding output distances.
+   * @param candidates Vector to store the heap of candidate neighbors in.
+   * @return The number of distances that were computed.
    */
-  void BaseCase(const size_t queryIndex,
-                const arma::uvec& referenceIndices,
-                const size_t k,
-                const arma::mat& querySet,
-                arma::Mat<size_t>& neighbors,
-                arma::mat& distances) const;
+  size_t BaseCase(const size_t queryIndex,
+                  const std::vector<size_t>& referenceIndices,
+                  const size_t k,
+                  const arma::mat& querySet,
+                  arma::Mat<size_t>& neighbors,
+                  arma::mat& distances,
+                  std::vector<std::pair<double, size_t>>& candidates) const;
 
   /**
    * This function implements the core idea behind Multiprobe LSH. It is called
@@ -368,13 +489,13 @@ class LSHSearch
    * @param queryCodeNotFloored vector containing the projection location of the
    *    query.
    * @param T number of additional probing bins.
-   * @param additionalProbingBins matrix. Each column will hold one additional
-   *    bin.
+   * @param buffers The buffers of the calling thread.  Each column of
+   *    buffers.additionalProbingBins will hold one additional bin.
   */
   void GetAdditionalProbingBins(const arma::vec& queryCode,
                                 const arma::vec& queryCodeNotFloored,
                                 const size_t T,
-                                arma::mat& additionalProbingBins) const;
+                                QueryBuffers& buffers) const;
 
   /**
    * Returns the score of a perturbation vector generated by perturbation set A.
@@ -440,18 +561,24 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The final hash table: the points in each of the (< secondHashSize)
+  //! non-empty buckets, bucket after bucket, with (<= bucketSize) points in
+  //! each bucket.
+  arma::Col<arma::u32> bucketContents;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The offset of each non-empty bucket in bucketContents, followed by the
+  //! length of bucketContents.
+  arma::Col<size_t> bucketOffsets;
 
-  //! For a particular hash value, points to the row in secondHashTable
-  //! corresponding to this value. Length secondHashSize.
+  //! For a particular hash value, points to the non-empty bucket corresponding
+  //! to this value (or holds secondHashSize if the bucket is empty).  Length
+  //! secondHashSize.
   arma::Col<size_t> bucketRowInHashTable;
 
+  //! For each point of the reference set, whether it was removed; empty if no
+  //! point was removed since the model was trained.
+  std::vector<bool> removed;
+
   //! The number of distance evaluations.
   size_t distanceEvaluations;
 
@@ -465,10 +592,6 @@ class LSHSearch
       return !SortPolicy::IsBetter(c2.first, c1.first);
     };
   };
-
-  //! Use a priority queue to represent the list of candidate neighbors.
-  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-      CandidateList;
 }; // class LSHSearch
 
 } // namespace neighbor
@@ -476,7 +599,7 @@ class LSHSearch
 
 //! Set the serialization version of the LSHSearch class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::LSHSearch<SortPolicy>, 1);
+    mlpack::neighbor::LSHSearch<SortPolicy>, 3);
 
 // Include implementation.
 #include "lsh_search_impl.hpp"
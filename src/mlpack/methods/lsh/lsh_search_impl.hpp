@@ -83,9 +83,10 @@ LSHSearch<SortPolicy>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
+    bucketContents(other.bucketContents),
+    bucketOffsets(other.bucketOffsets),
     bucketRowInHashTable(other.bucketRowInHashTable),
+    removed(other.removed),
     distanceEvaluations(other.distanceEvaluations)
 {
   // Nothing to do.
@@ -103,9 +104,10 @@ LSHSearch<SortPolicy>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
+    bucketContents(std::move(other.bucketContents)),
+    bucketOffsets(std::move(other.bucketOffsets)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
+    removed(std::move(other.removed)),
     distanceEvaluations(other.distanceEvaluations)
 {
   // Reset other model to defaults.
@@ -130,9 +132,10 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(const LSHSearch& other)
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
+  bucketContents = other.bucketContents;
+  bucketOffsets = other.bucketOffsets;
   bucketRowInHashTable = other.bucketRowInHashTable;
+  removed = other.removed;
   distanceEvaluations = other.distanceEvaluations;
 
   return *this;
@@ -151,9 +154,10 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(LSHSearch&& other)
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
+  bucketContents = std::move(other.bucketContents);
+  bucketOffsets = std::move(other.bucketOffsets);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
+  removed = std::move(other.removed);
   distanceEvaluations = other.distanceEvaluations;
 
   // Reset other model to defaults.
@@ -177,8 +181,19 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
                                   const size_t bucketSize,
                                   const arma::cube &projection)
 {
+  // The buckets hold 32-bit point indices.
+  if (referenceSet.n_cols > std::numeric_limits<arma::u32>::max())
+  {
+    std::ostringstream oss;
+    oss << "LSHSearch::Train(): the reference set has " << referenceSet.n_cols
+        << " points, but at most " << std::numeric_limits<arma::u32>::max()
+        << " are supported.";
+    throw std::invalid_argument(oss.str());
+  }
+
   // Set new reference set.
   this->referenceSet = std::move(referenceSet);
+  removed.clear();
 
   // Set new parameters.
   this->numProj = numProj;
@@ -251,31 +266,98 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
         "tables provided must be equal to numProj");
   }
 
-  // We will store the second hash vectors in this matrix; the second hash
-  // vector for table i will be held in row i.  We have to use int and not
-  // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
+  // Step IV and V: hash each point in each table into the second hash table.
+  arma::Mat<size_t> secondHashVectors;
+  HashPoints(this->referenceSet, secondHashVectors);
+
+  // Now, using the hash vectors for each table, count the number of rows we
+  // have in the second hash table.
+  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
+  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
+    secondHashBinCounts[secondHashVectors[i]]++;
+
+  // Enforce the maximum bucket size.
+  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
+      { return std::min(val, effectiveBucketSize); });
 
-  for (size_t i = 0; i < numTables; i++)
+  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
+
+  // The buckets are stored one after the other, in the order in which they are
+  // first hit when going through the tables.  So we first assign the rows, and
+  // then compute where each one starts.
+  bucketOffsets.zeros(numRowsInTable + 1);
+  size_t currentRow = 0;
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      const size_t hashInd = secondHashVectors(i, j);
+      if (bucketRowInHashTable[hashInd] == secondHashSize)
+      {
+        bucketRowInHashTable[hashInd] = currentRow;
+        bucketOffsets[currentRow + 1] = secondHashBinCounts[hashInd];
+        currentRow++;
+      }
+    }
+  }
+
+  for (size_t r = 0; r < numRowsInTable; ++r)
+    bucketOffsets[r + 1] += bucketOffsets[r];
+
+  // Next we must assign each point in each table to the right bucket, as long
+  // as the bucket is not full.
+  bucketContents.set_size(bucketOffsets[numRowsInTable]);
+  arma::Col<size_t> bucketEnd = bucketOffsets.head(numRowsInTable);
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; j++)
+    {
+      // The point ID is 'j'.
+      const size_t index = bucketRowInHashTable[secondHashVectors(i, j)];
+      if (bucketEnd[index] < bucketOffsets[index + 1])
+        bucketContents[bucketEnd[index]++] = (arma::u32) j;
+    } // Loop over all points in the reference set.
+  } // Loop over tables.
+
+  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
+            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
+            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
+            << std::endl;
+}
+
+// Compute the second hash table bucket of each point in each table.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::HashPoints(const arma::mat& points,
+                                       arma::Mat<size_t>& secondHashVectors)
+    const
+{
+  // We will store the second hash vectors in this matrix; the second hash
+  // vector for table i will be held in row i.  The tables are independent, so
+  // they are hashed in parallel.
+  secondHashVectors.set_size(numTables, points.n_cols);
+
+  // The projections of each table are BLAS calls, which should use one thread.
+  util::SingleThreadedBLAS singleThreadedBLAS;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numTables; i++)
   {
     // Step IV: create the 'numProj'-dimensional key for each point in each
     // table.
 
     // The following code performs the task of hashing each point to a
     // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
+    // 'points.n_cols') key matrix.
     //
     // For a single table, let the 'numProj' projections be denoted by 'proj_i'
     // and the corresponding offset be 'offset_i'.  Then the key of a single
     // point is obtained as:
     // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
-    arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1,
-                                       this->referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (this->referenceSet);
-    hashMat += offsetMat;
+    arma::mat hashMat = projections.slice(i).t() * points;
+    hashMat.each_col() += offsets.unsafe_col(i);
     hashMat /= hashWidth;
 
-    // Step V: Putting the points in the 'secondHashTable' by hashing the key.
+    // Step V: Putting the points in the second hash table by hashing the key.
     // Now we hash every key, point ID to its corresponding bucket.  We must
     // also normalize the hashes to the range [0, secondHashSize).
     arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
@@ -295,77 +377,150 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
       }
     }
   }
+}
 
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
+// Add points to the trained model.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::Insert(const arma::mat& points)
+{
+  if (projections.n_slices == 0)
+  {
+    throw std::invalid_argument("LSHSearch::Insert(): the model must be "
+        "trained before points are inserted");
+  }
 
-  // Enforce the maximum bucket size.
-  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
-  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
-      { return std::min(val, effectiveBucketSize); });
+  if (points.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "LSHSearch::Insert(): dimensionality of points (" << points.n_rows
+        << ") is not equal to the dimensionality the model was trained on ("
+        << referenceSet.n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
 
-  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
+  const size_t oldSize = referenceSet.n_cols;
+  if (oldSize + points.n_cols > std::numeric_limits<arma::u32>::max())
+  {
+    std::ostringstream oss;
+    oss << "LSHSearch::Insert(): the reference set would have "
+        << oldSize + points.n_cols << " points, but at most "
+        << std::numeric_limits<arma::u32>::max() << " are supported.";
+    throw std::invalid_argument(oss.str());
+  }
 
-  // Next we must assign each point in each table to the right second hash
-  // table.
-  size_t currentRow = 0;
+  // Hash the new points with the existing projections and offsets.
+  arma::Mat<size_t> secondHashVectors;
+  HashPoints(points, secondHashVectors);
+
+  referenceSet.insert_cols(oldSize, points);
+  if (!removed.empty())
+    removed.resize(referenceSet.n_cols, false);
+
+  // The removed points are dropped from the buckets, which makes room for the
+  // new points.  Count the points left in each bucket.
+  const size_t oldRows = bucketOffsets.n_elem - 1;
+  std::vector<size_t> sizes(oldRows, 0);
+  for (size_t r = 0; r < oldRows; ++r)
+  {
+    for (size_t j = bucketOffsets[r]; j < bucketOffsets[r + 1]; ++j)
+      if (removed.empty() || !removed[bucketContents[j]])
+        ++sizes[r];
+  }
+
+  // Now find the bucket of each new point in each table.  Empty buckets get a
+  // new row, and, just like in Train(), points that don't fit in a full bucket
+  // are not added.
+  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  arma::Mat<size_t> rows(numTables, points.n_cols);
   for (size_t i = 0; i < numTables; ++i)
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
-    for (size_t j = 0; j < secondHashVectors.n_cols; j++)
+    for (size_t j = 0; j < points.n_cols; ++j)
     {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
+      const size_t hashInd = secondHashVectors(i, j);
       if (bucketRowInHashTable[hashInd] == secondHashSize)
       {
-        bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
+        bucketRowInHashTable[hashInd] = sizes.size();
+        sizes.push_back(0);
       }
 
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
+      const size_t row = bucketRowInHashTable[hashInd];
+      if (sizes[row] < effectiveBucketSize)
+      {
+        rows(i, j) = row;
+        ++sizes[row];
+      }
+      else
+      {
+        rows(i, j) = SIZE_MAX;
+      }
+    }
+  }
 
-  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
-            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
-            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
-            << std::endl;
+  // Rebuild the buckets: the points already in each bucket come first, then
+  // the new points.
+  arma::Col<size_t> newOffsets(sizes.size() + 1);
+  newOffsets[0] = 0;
+  for (size_t r = 0; r < sizes.size(); ++r)
+    newOffsets[r + 1] = newOffsets[r] + sizes[r];
+
+  arma::Col<arma::u32> newContents(newOffsets[sizes.size()]);
+  arma::Col<size_t> bucketEnd = newOffsets.head(sizes.size());
+  for (size_t r = 0; r < oldRows; ++r)
+  {
+    for (size_t j = bucketOffsets[r]; j < bucketOffsets[r + 1]; ++j)
+      if (removed.empty() || !removed[bucketContents[j]])
+        newContents[bucketEnd[r]++] = bucketContents[j];
+  }
+
+  for (size_t i = 0; i < numTables; ++i)
+    for (size_t j = 0; j < points.n_cols; ++j)
+      if (rows(i, j) != SIZE_MAX)
+        newContents[bucketEnd[rows(i, j)]++] = (arma::u32) (oldSize + j);
+
+  bucketOffsets = std::move(newOffsets);
+  bucketContents = std::move(newContents);
+}
+
+// Mark a point of the reference set as removed.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::Remove(const size_t index)
+{
+  if (index >= referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "LSHSearch::Remove(): index " << index << " is out of range "
+        << "(the reference set has " << referenceSet.n_cols << " points)";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (removed.empty())
+    removed.resize(referenceSet.n_cols, false);
+  removed[index] = true;
 }
 
 // Base case where the query set is the reference set.  (So, we can't return
 // ourselves as the nearest neighbor.)
 template<typename SortPolicy>
 inline force_inline
-void LSHSearch<SortPolicy>::BaseCase(const size_t queryIndex,
-                                     const arma::uvec& referenceIndices,
-                                     const size_t k,
-                                     arma::Mat<size_t>& neighbors,
-                                     arma::mat& distances) const
+size_t LSHSearch<SortPolicy>::BaseCase(
+    const size_t queryIndex,
+    const std::vector<size_t>& referenceIndices,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    std::vector<Candidate>& candidates) const
 {
   // Let's build the list of candidate neighbors for the given query point.
   // It will be initialized with k candidates:
   // (WorstDistance, referenceSet.n_cols)
+  // The candidates are kept as a heap in the given (reused) vector.
   const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
       referenceSet.n_cols);
-  std::vector<Candidate> vect(k, def);
-  CandidateList pqueue(CandidateCmp(), std::move(vect));
+  candidates.assign(k, def);
+  std::make_heap(candidates.begin(), candidates.end(), CandidateCmp());
 
-  for (size_t j = 0; j < referenceIndices.n_elem; ++j)
+  size_t evaluations = 0;
+  for (size_t j = 0; j < referenceIndices.size(); ++j)
   {
     const size_t referenceIndex = referenceIndices[j];
     // If the points are the same, skip this point.
@@ -375,43 +530,51 @@ void LSHSearch<SortPolicy>::BaseCase(const size_t queryIndex,
     const double distance = metric::EuclideanDistance::Evaluate(
         referenceSet.unsafe_col(queryIndex),
         referenceSet.unsafe_col(referenceIndex));
+    ++evaluations;
 
     Candidate c = std::make_pair(distance, referenceIndex);
     // If this distance is better than the worst candidate, let's insert it.
-    if (CandidateCmp()(c, pqueue.top()))
+    if (CandidateCmp()(c, candidates.front()))
     {
-      pqueue.pop();
-      pqueue.push(c);
+      std::pop_heap(candidates.begin(), candidates.end(), CandidateCmp());
+      candidates.back() = c;
+      std::push_heap(candidates.begin(), candidates.end(), CandidateCmp());
     }
   }
 
   for (size_t j = 1; j <= k; j++)
   {
-    neighbors(k - j, queryIndex) = pqueue.top().second;
-    distances(k - j, queryIndex) = pqueue.top().first;
-    pqueue.pop();
+    neighbors(k - j, queryIndex) = candidates.front().second;
+    distances(k - j, queryIndex) = candidates.front().first;
+    std::pop_heap(candidates.begin(), candidates.end(), CandidateCmp());
+    candidates.pop_back();
   }
+
+  return evaluations;
 }
 
 // Base case for bichromatic search.
 template<typename SortPolicy>
 inline force_inline
-void LSHSearch<SortPolicy>::BaseCase(const size_t queryIndex,
-                                     const arma::uvec& referenceIndices,
-                                     const size_t k,
-                                     const arma::mat& querySet,
-                                     arma::Mat<size_t>& neighbors,
-                                     arma::mat& distances) const
+size_t LSHSearch<SortPolicy>::BaseCase(
+    const size_t queryIndex,
+    const std::vector<size_t>& referenceIndices,
+    const size_t k,
+    const arma::mat& querySet,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    std::vector<Candidate>& candidates) const
 {
   // Let's build the list of candidate neighbors for the given query point.
   // It will be initialized with k candidates:
   // (WorstDistance, referenceSet.n_cols)
+  // The candidates are kept as a heap in the given (reused) vector.
   const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
       referenceSet.n_cols);
-  std::vector<Candidate> vect(k, def);
-  CandidateList pqueue(CandidateCmp(), std::move(vect));
+  candidates.assign(k, def);
+  std::make_heap(candidates.begin(), candidates.end(), CandidateCmp());
 
-  for (size_t j = 0; j < referenceIndices.n_elem; ++j)
+  for (size_t j = 0; j < referenceIndices.size(); ++j)
   {
     const size_t referenceIndex = referenceIndices[j];
     const double distance = metric::EuclideanDistance::Evaluate(
@@ -420,19 +583,23 @@ void LSHSearch<SortPolicy>::BaseCase(const size_t queryIndex,
 
     Candidate c = std::make_pair(distance, referenceIndex);
     // If this distance is better than the worst candidate, let's insert it.
-    if (CandidateCmp()(c, pqueue.top()))
+    if (CandidateCmp()(c, candidates.front()))
     {
-      pqueue.pop();
-      pqueue.push(c);
+      std::pop_heap(candidates.begin(), candidates.end(), CandidateCmp());
+      candidates.back() = c;
+      std::push_heap(candidates.begin(), candidates.end(), CandidateCmp());
     }
   }
 
   for (size_t j = 1; j <= k; j++)
   {
-    neighbors(k - j, queryIndex) = pqueue.top().second;
-    distances(k - j, queryIndex) = pqueue.top().first;
-    pqueue.pop();
+    neighbors(k - j, queryIndex) = candidates.front().second;
+    distances(k - j, queryIndex) = candidates.front().first;
+    std::pop_heap(candidates.begin(), candidates.end(), CandidateCmp());
+    candidates.pop_back();
   }
+
+  return referenceIndices.size();
 }
 
 template<typename SortPolicy>
@@ -489,26 +656,15 @@ inline force_inline
 bool LSHSearch<SortPolicy>::PerturbationValid(
     const std::vector<bool>& A) const
 {
-  // Use check to mark dimensions we have seen before in A. If a dimension is
-  // seen twice (or more), A is not a valid perturbation.
-  std::vector<bool> check(numProj);
-
   if (A.size() > 2 * numProj)
     return false; // This should never happen.
 
-  // Check that we only see each dimension once. If not, vector is not valid.
-  for (size_t i = 0; i < A.size(); ++i)
-  {
-    // Only check dimensions that were included.
-    if (!A[i])
-      continue;
+  // Positions i and i + numProj of A act on the same dimension.  If both are
+  // included, A is not a valid perturbation.
+  for (size_t i = numProj; i < A.size(); ++i)
+    if (A[i] && A[i - numProj])
+      return false;
 
-    // If dimesnion is unseen thus far, mark it as seen.
-    if (check[i % numProj] == false)
-      check[i % numProj] = true;
-    else
-      return false; // If dimension was seen before, set is not valid.
-  }
   // If we didn't fail, set is valid.
   return true;
 }
@@ -519,13 +675,14 @@ void LSHSearch<SortPolicy>::GetAdditionalProbingBins(
     const arma::vec& queryCode,
     const arma::vec& queryCodeNotFloored,
     const size_t T,
-    arma::mat& additionalProbingBins) const
+    QueryBuffers& buffers) const
 {
   // No additional bins requested. Our work is done.
   if (T == 0)
     return;
 
   // Each column of additionalProbingBins is the code of a bin.
+  arma::mat& additionalProbingBins = buffers.additionalProbingBins;
   additionalProbingBins.set_size(numProj, T);
 
   // Copy the query's code, then in the end we will  add/subtract according
@@ -533,34 +690,29 @@ void LSHSearch<SortPolicy>::GetAdditionalProbingBins(
   for (size_t c = 0; c < T; ++c)
     additionalProbingBins.col(c) = queryCode;
 
-
-  // Calculate query point's projection position.
-  arma::mat projection = queryCodeNotFloored;
-
-  // Use projection to calculate query's distance from hash limits.
-  arma::vec limLow = projection - queryCode * hashWidth;
-  arma::vec limHigh = hashWidth - limLow;
-
-  // Calculate scores. score = distance^2.
-  arma::vec scores(2 * numProj);
-  scores.rows(0, numProj - 1) = arma::pow(limLow, 2);
-  scores.rows(numProj, (2 * numProj) - 1) = arma::pow(limHigh, 2);
-
-  // Actions vector describes what perturbation (-1/+1) corresponds to a score.
-  arma::Col<short int> actions(2 * numProj); // will be [-1 ... 1 ...]
-  actions.rows(0, numProj - 1) = // First numProj rows.
-    -1 * arma::ones< arma::Col<short int> > (numProj); // -1s
-  actions.rows(numProj, (2 * numProj) - 1) = // Last numProj rows.
-    arma::ones< arma::Col<short int> > (numProj); // 1s
-
-
-  // Acting dimension vector shows which coordinate to transform according to
-  // actions (actions are described by actions vector above).
-  arma::Col<size_t> positions(2 * numProj); // Will be [0 1 2 ... 0 1 2 ...].
-  positions.rows(0, numProj - 1) =
-    arma::linspace< arma::Col<size_t> >(0, numProj - 1, numProj);
-  positions.rows(numProj, 2 * numProj - 1) =
-    arma::linspace< arma::Col<size_t> >(0, numProj - 1, numProj);
+  // Use the query's projection position to calculate its distance from hash
+  // limits, and from that the scores (score = distance^2).  Actions describe
+  // what perturbation (-1/+1) corresponds to a score, and positions show which
+  // coordinate to transform according to actions.  They will be
+  // [-1 ... 1 ...] and [0 1 2 ... 0 1 2 ...].
+  arma::vec& scores = buffers.scores;
+  arma::Col<short int>& actions = buffers.actions;
+  arma::Col<size_t>& positions = buffers.positions;
+  scores.set_size(2 * numProj);
+  actions.set_size(2 * numProj);
+  positions.set_size(2 * numProj);
+  for (size_t d = 0; d < numProj; ++d)
+  {
+    const double limLow = queryCodeNotFloored[d] - queryCode[d] * hashWidth;
+    const double limHigh = hashWidth - limLow;
+
+    scores[d] = limLow * limLow;
+    scores[numProj + d] = limHigh * limHigh;
+    actions[d] = -1;
+    actions[numProj + d] = 1;
+    positions[d] = d;
+    positions[numProj + d] = d;
+  }
 
   // Special case: No need to create heap for 1 or 2 codes.
   if (T <= 2)
@@ -611,11 +763,14 @@ void LSHSearch<SortPolicy>::GetAdditionalProbingBins(
   }
 
   // General case: more than 2 perturbation vectors require use of minheap.
-  // Sort everything in increasing order.
-  arma::uvec sortidx = arma::sort_index(scores);
-  scores = scores(sortidx);
-  actions = actions(sortidx);
-  positions = positions(sortidx);
+  // Sort everything in increasing order; position s of a perturbation set
+  // refers to the score, action and position order[s].
+  arma::uvec& order = buffers.order;
+  order = arma::sort_index(scores);
+  arma::vec& sortedScores = buffers.sortedScores;
+  sortedScores.set_size(2 * numProj);
+  for (size_t s = 0; s < 2 * numProj; ++s)
+    sortedScores[s] = scores[order[s]];
 
   // Theory:
   // A probing sequence is a sequence of T probing bins where a query's
@@ -632,58 +787,70 @@ void LSHSearch<SortPolicy>::GetAdditionalProbingBins(
   // dimensions specified by the set to queryCode+action (action is {-1, 1}).
 
   // Perturbation sets (A) mark with 1 the (score, action, dimension) positions
-  // included in a given perturbation vector. Other spaces are 0.
-  std::vector<bool> Ao(2 * numProj);
-  Ao[0] = 1; // Smallest vector includes only smallest score.
-
-  std::vector< std::vector<bool> > perturbationSets;
-  perturbationSets.push_back(Ao); // Storage of perturbation sets.
-
-  std::priority_queue<
-    std::pair<double, size_t>,        // contents: pairs of (score, index)
-    std::vector<                      // container: vector of pairs
-      std::pair<double, size_t>
-      >,
-    std::greater< std::pair<double, size_t> > // comparator of pairs
-  > minHeap; // our minheap
+  // included in a given perturbation vector. Other spaces are 0.  The first
+  // numSets vectors of perturbationSets are in use; the rest are kept from
+  // earlier queries so that their memory can be reused.
+  std::vector<std::vector<bool>>& perturbationSets = buffers.perturbationSets;
+  size_t numSets = 0;
+  auto addSet = [&perturbationSets, &numSets](const std::vector<bool>& A)
+  {
+    if (numSets == perturbationSets.size())
+      perturbationSets.push_back(A);
+    else
+      perturbationSets[numSets] = A;
+    ++numSets;
+  };
+
+  std::vector<bool>& Ai = buffers.currentSet;
+  std::vector<bool>& As = buffers.shiftedSet;
+  std::vector<bool>& Ae = buffers.expandedSet;
+  Ai.assign(2 * numProj, false);
+  Ai[0] = 1; // Smallest vector includes only smallest score.
+  addSet(Ai); // Storage of perturbation sets.
+
+  // Our minheap of pairs of (score, index).
+  typedef std::pair<double, size_t> HeapEntry;
+  typedef std::greater<HeapEntry> HeapCmp;
+  std::vector<HeapEntry>& minHeap = buffers.minHeap;
+  minHeap.clear();
 
   // Start by adding the lowest scoring set to the minheap.
-  minHeap.push(std::make_pair(PerturbationScore(Ao, scores), 0));
+  minHeap.push_back(std::make_pair(PerturbationScore(Ai, sortedScores), 0));
 
   // Loop invariable: after pvec iterations, additionalProbingBins contains pvec
   // valid codes of the lowest-scoring bins (bins most likely to contain
   // neighbors of the query).
   for (size_t pvec = 0; pvec < T; ++pvec)
   {
-    std::vector<bool> Ai;
     do
     {
       // Get the perturbation set corresponding to the minimum score.
-      Ai = perturbationSets[ minHeap.top().second ];
-      minHeap.pop(); // .top() returns, .pop() removes
+      std::pop_heap(minHeap.begin(), minHeap.end(), HeapCmp());
+      Ai = perturbationSets[minHeap.back().second];
+      minHeap.pop_back();
 
       // Shift operation on Ai (replace max with max+1).
-      std::vector<bool> As = Ai;
+      As = Ai;
 
       // Don't add invalid sets.
       if (PerturbationShift(As) && PerturbationValid(As))
       {
-        perturbationSets.push_back(As); // add shifted set to sets
-        minHeap.push(
-            std::make_pair(PerturbationScore(As, scores),
-            perturbationSets.size() - 1));
+        addSet(As); // add shifted set to sets
+        minHeap.push_back(std::make_pair(PerturbationScore(As, sortedScores),
+            numSets - 1));
+        std::push_heap(minHeap.begin(), minHeap.end(), HeapCmp());
       }
 
       // Expand operation on Ai (add max+1 to set).
-      std::vector<bool> Ae = Ai;
+      Ae = Ai;
 
       // Don't add invalid sets.
       if (PerturbationExpand(Ae) && PerturbationValid(Ae))
       {
-        perturbationSets.push_back(Ae); // add expanded set to sets
-        minHeap.push(
-            std::make_pair(PerturbationScore(Ae, scores),
-            perturbationSets.size() - 1));
+        addSet(Ae); // add expanded set to sets
+        minHeap.push_back(std::make_pair(PerturbationScore(Ae, sortedScores),
+            numSets - 1));
+        std::push_heap(minHeap.begin(), minHeap.end(), HeapCmp());
       }
     } while (!PerturbationValid(Ai)); // Discard invalid perturbations
 
@@ -691,54 +858,62 @@ void LSHSearch<SortPolicy>::GetAdditionalProbingBins(
     for (size_t pos = 0; pos < Ai.size(); ++pos)
     {
       // If Ai[pos] is marked, add action to probing vector.
-      additionalProbingBins(positions(pos), pvec) += Ai[pos] ? actions(pos) : 0;
+      if (Ai[pos])
+        additionalProbingBins(positions[order[pos]], pvec) +=
+            actions[order[pos]];
     }
   }
 }
 
 template<typename SortPolicy>
-template<typename VecType>
+void LSHSearch<SortPolicy>::ProjectQueries(const arma::mat& querySet,
+                                           const size_t begin,
+                                           const size_t end,
+                                           const size_t numTablesToSearch,
+                                           arma::mat& codes) const
+{
+  // Project the queries in each of the 'numTablesToSearch' hash tables using
+  // the 'numProj' projections for each table.  All queries of the block share
+  // one matrix multiplication per table.
+  codes.set_size(numProj * numTablesToSearch, end - begin);
+  for (size_t i = 0; i < numTablesToSearch; ++i)
+  {
+    codes.rows(i * numProj, (i + 1) * numProj - 1) =
+        projections.slice(i).t() * querySet.cols(begin, end - 1);
+    codes.rows(i * numProj, (i + 1) * numProj - 1).each_col() +=
+        offsets.unsafe_col(i);
+  }
+}
+
+template<typename SortPolicy>
 void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
-    const VecType& queryPoint,
-    arma::uvec& referenceIndices,
-    size_t numTablesToSearch,
+    const arma::mat& queryCodesNotFloored,
+    QueryBuffers& buffers,
     const size_t T) const
 {
-  // Decide on the number of tables to look into.
-  if (numTablesToSearch == 0) // If no user input is given, search all.
-    numTablesToSearch = numTables;
-
-  // Sanity check to make sure that the existing number of tables is not
-  // exceeded.
-  if (numTablesToSearch > numTables)
-    numTablesToSearch = numTables;
-
-  // Hash the query in each of the 'numTablesToSearch' hash tables using the
-  // 'numProj' projections for each table. This gives us 'numTablesToSearch'
-  // keys for the query where each key is a 'numProj' dimensional integer
-  // vector.
-
-  // Compute the projection of the query in each table.
-  arma::mat allProjInTables(numProj, numTablesToSearch);
-  arma::mat queryCodesNotFloored(numProj, numTablesToSearch);
-  for (size_t i = 0; i < numTablesToSearch; i++)
-    queryCodesNotFloored.unsafe_col(i) = projections.slice(i).t() * queryPoint;
-
-  queryCodesNotFloored += offsets.cols(0, numTablesToSearch - 1);
+  // The projections of the query give us 'numTablesToSearch' keys for the
+  // query, where each key is a 'numProj' dimensional integer vector.  The
+  // buffers keep their size between queries, so this allocates nothing after
+  // the first query.
+  const size_t numTablesToSearch = queryCodesNotFloored.n_cols;
+  arma::mat& allProjInTables = buffers.allProjInTables;
   allProjInTables = arma::floor(queryCodesNotFloored / hashWidth);
 
   // Use hashMat to store the primary probing codes and any additional codes
   // from multiprobe LSH.
-  arma::Mat<size_t> hashMat;
+  arma::Mat<size_t>& hashMat = buffers.hashMat;
   hashMat.set_size(T + 1, numTablesToSearch);
 
   // Compute the primary hash value of each key of the query into a bucket of
-  // the secondHashTable using the secondHashWeights.
-  hashMat.row(0) = arma::conv_to<arma::Row<size_t>> // Floor by typecasting
-      ::from(secondHashWeights.t() * allProjInTables);
-  // Mod to compute 2nd-level codes.
+  // the second hash table using the secondHashWeights, flooring by typecasting
+  // (negative values become 0) and then taking the mod to compute 2nd-level
+  // codes.  The codes have integer values, so the dot products are exact.
   for (size_t i = 0; i < numTablesToSearch; i++)
-    hashMat(0, i) = (hashMat(0, i) % secondHashSize);
+  {
+    const double code = arma::dot(secondHashWeights,
+        allProjInTables.unsafe_col(i));
+    hashMat(0, i) = ((code < 0.0) ? 0 : (size_t) code) % secondHashSize;
+  }
 
   // Compute hash codes of additional probing bins.
   if (T > 0)
@@ -746,105 +921,80 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
     for (size_t i = 0; i < numTablesToSearch; ++i)
     {
       // Construct this table's probing sequence of length T.
-      arma::mat additionalProbingBins;
       GetAdditionalProbingBins(allProjInTables.unsafe_col(i),
-                                queryCodesNotFloored.unsafe_col(i),
-                                T,
-                                additionalProbingBins);
-
-      // Map each probing bin to a bin in secondHashTable (just like we did for
-      // the primary hash table).
-      hashMat(arma::span(1, T), i) = // Compute code of rows 1:end of column i
-        arma::conv_to< arma::Col<size_t> >:: // floor by typecasting to size_t
-        from(secondHashWeights.t() * additionalProbingBins);
+                               queryCodesNotFloored.unsafe_col(i),
+                               T,
+                               buffers);
+
+      // Map each probing bin to a bin in the second hash table (just like we
+      // did for the primary hash table).
       for (size_t p = 1; p < T + 1; ++p)
-        hashMat(p, i) = (hashMat(p, i) % secondHashSize);
+      {
+        const double code = arma::dot(secondHashWeights,
+            buffers.additionalProbingBins.unsafe_col(p - 1));
+        hashMat(p, i) = ((code < 0.0) ? 0 : (size_t) code) % secondHashSize;
+      }
     }
   }
 
-  // Count number of points hashed in the same bucket as the query.
-  size_t maxNumPoints = 0;
-  for (size_t i = 0; i < numTablesToSearch; ++i)
+  // Collect the reference points hashed in the same buckets as the query.  A
+  // bitset over the reference set marks the points that were already found,
+  // so that each one is only added once.
+  std::vector<size_t>& referenceIndices = buffers.referenceIndices;
+  std::vector<uint64_t>& found = buffers.found;
+  const size_t numWords = (referenceSet.n_cols + 63) / 64;
+  if (found.size() != numWords)
+    found.assign(numWords, 0);
+
+  referenceIndices.clear();
+  for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables.
   {
-    for (size_t p = 0; p < T + 1; ++p)
+    for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
     {
-      const size_t hashInd = hashMat(p, i); // find query's bucket
+      const size_t hashInd = hashMat(p, i); // Find the query's bucket.
       const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
-    }
-  }
-
-  // There are two ways to proceed here:
-  // Either allocate a maxNumPoints-size vector, place all candidates, and run
-  // unique on the vector to discard duplicates.
-  // Or allocate a referenceSet.n_cols size vector (i.e. number of reference
-  // points) of zeros, and mark found indices as 1.
-  // Option 1 runs faster for small maxNumPoints but worse for larger values, so
-  // we choose based on a heuristic.
-  const float cutoff = 0.1;
-  const float selectivity = static_cast<float>(maxNumPoints) /
-      static_cast<float>(referenceSet.n_cols);
-
-  if (selectivity > cutoff)
-  {
-    // Heuristic: larger maxNumPoints means we should use find() because it
-    // should be faster.
-    // Reference points hashed in the same bucket as the query are set to >0.
-    arma::Col<size_t> refPointsConsidered;
-    refPointsConsidered.zeros(referenceSet.n_cols);
+      if (tableRow >= secondHashSize)
+        continue;
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // for all tables
-    {
-      for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
+      for (size_t j = bucketOffsets[tableRow]; j < bucketOffsets[tableRow + 1];
+          ++j)
       {
-        // get the sequence code
-        size_t hashInd = hashMat(p, i);
-        size_t tableRow = bucketRowInHashTable[hashInd];
+        const size_t index = bucketContents[j];
+        if (!removed.empty() && removed[index])
+          continue;
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
+        const uint64_t bit = uint64_t(1) << (index % 64);
+        if (!(found[index / 64] & bit))
         {
-          // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
+          found[index / 64] |= bit;
+          referenceIndices.push_back(index);
         }
       }
     }
-
-    // Only keep reference points found in at least one bucket.
-    referenceIndices = arma::find(refPointsConsidered > 0);
-    return;
   }
-  else
-  {
-    // Heuristic: smaller maxNumPoints means we should use unique() because it
-    // should be faster.
-    // Allocate space for the query's potential neighbors.
-    arma::uvec refPointsConsideredSmall;
-    refPointsConsideredSmall.zeros(maxNumPoints);
-
-    // Retrieve candidates.
-    size_t start = 0;
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables
+  // Return the candidates in increasing order, and clear the bitset for the
+  // next query.  When many points were found, it's faster to read them back
+  // from the bitset than to sort them.
+  if (referenceIndices.size() > numWords)
+  {
+    referenceIndices.clear();
+    for (size_t w = 0; w < numWords; ++w)
     {
-      for (size_t p = 0; p < T + 1; ++p)
-      {
-        const size_t hashInd =  hashMat(p, i); // Find the query's bucket.
-        const size_t tableRow = bucketRowInHashTable[hashInd];
+      if (found[w] == 0)
+        continue;
 
-        if (tableRow < secondHashSize)
-        {
-          // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
-       }
-      }
+      for (size_t b = 0; b < 64; ++b)
+        if (found[w] & (uint64_t(1) << b))
+          referenceIndices.push_back(64 * w + b);
+      found[w] = 0;
     }
-
-    // Keep only one copy of each candidate.
-    referenceIndices = arma::unique(refPointsConsideredSmall);
-    return;
+  }
+  else
+  {
+    std::sort(referenceIndices.begin(), referenceIndices.end());
+    for (size_t j = 0; j < referenceIndices.size(); ++j)
+      found[referenceIndices[j] / 64] = 0;
   }
 }
 
@@ -901,37 +1051,56 @@ void LSHSearch<SortPolicy>::Search(const arma::mat& querySet,
         <<" additional probing bins per table per query." << std::endl;
 
   size_t avgIndicesReturned = 0;
+  size_t evaluations = 0;
 
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  // Decide on the number of tables to look into; if no user input is given,
+  // search all.
+  const size_t tablesToSearch = (numTablesToSearch == 0 ||
+      numTablesToSearch > numTables) ? numTables : numTablesToSearch;
+
+  // Parallelization to process more than one block of queries at a time.  The
+  // queries of a block are projected together, and each thread reuses one set
+  // of buffers for all of its queries.
+  const size_t blockSize = 64;
+  const size_t numBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+  util::SingleThreadedBLAS singleThreadedBLAS;
+  #pragma omp parallel shared(resultingNeighbors, distances) \
+      reduction(+:avgIndicesReturned, evaluations)
   {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running
-    // #pragma omp atomic
-    avgIndicesReturned = avgIndicesReturned + refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
+    QueryBuffers buffers;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+      ProjectQueries(querySet, begin, end, tablesToSearch, buffers.blockCodes);
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        // Hash every query into every hash table and eventually into the
+        // second hash table to obtain the neighbor candidates.
+        const arma::mat queryCodes(buffers.blockCodes.colptr(i - begin),
+            numProj, tablesToSearch, false, true);
+        ReturnIndicesFromTable(queryCodes, buffers, Teffective);
+
+        // An informative book-keeping for the number of neighbor candidates
+        // returned on average.
+        avgIndicesReturned += buffers.referenceIndices.size();
+
+          // Sequentially go through all the candidates and save the best 'k'
+          // candidates.
+          evaluations += BaseCase(i, buffers.referenceIndices, k, querySet,
+              resultingNeighbors, distances, buffers.candidates);
+      }
+    }
   }
 
   Timer::Stop("computing_neighbors");
 
-  distanceEvaluations += avgIndicesReturned;
+  distanceEvaluations += evaluations;
   avgIndicesReturned /= querySet.n_cols;
   Log::Info << avgIndicesReturned << " distinct indices returned on average." <<
       std::endl;
@@ -967,37 +1136,58 @@ Search(const size_t k,
       " additional probing bins per table per query."<< std::endl;
 
   size_t avgIndicesReturned = 0;
+  size_t evaluations = 0;
 
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+  // Decide on the number of tables to look into; if no user input is given,
+  // search all.
+  const size_t tablesToSearch = (numTablesToSearch == 0 ||
+      numTablesToSearch > numTables) ? numTables : numTablesToSearch;
+
+  // Parallelization to process more than one block of queries at a time.  The
+  // queries of a block are projected together, and each thread reuses one set
+  // of buffers for all of its queries.
+  const size_t blockSize = 64;
+  const size_t numBlocks = (referenceSet.n_cols + blockSize - 1) / blockSize;
+  util::SingleThreadedBLAS singleThreadedBLAS;
+  #pragma omp parallel shared(resultingNeighbors, distances) \
+      reduction(+:avgIndicesReturned, evaluations)
   {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running.
-    // #pragma omp atomic
-    avgIndicesReturned += refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, resultingNeighbors, distances);
+    QueryBuffers buffers;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) referenceSet.n_cols);
+      ProjectQueries(referenceSet, begin, end, tablesToSearch,
+          buffers.blockCodes);
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        // Hash every query into every hash table and eventually into the
+        // second hash table to obtain the neighbor candidates.
+        const arma::mat queryCodes(buffers.blockCodes.colptr(i - begin),
+            numProj, tablesToSearch, false, true);
+        ReturnIndicesFromTable(queryCodes, buffers, Teffective);
+
+        // An informative book-keeping for the number of neighbor candidates
+        // returned on average.
+        avgIndicesReturned += buffers.referenceIndices.size();
+
+          // Sequentially go through all the candidates and save the best 'k'
+          // candidates.  The query itself is a candidate but is not evaluated.
+          evaluations += BaseCase(i, buffers.referenceIndices, k,
+              resultingNeighbors, distances, buffers.candidates);
+      }
+    }
   }
 
   Timer::Stop("computing_neighbors");
 
-  distanceEvaluations += avgIndicesReturned;
+  distanceEvaluations += evaluations;
   avgIndicesReturned /= referenceSet.n_cols;
   Log::Info << avgIndicesReturned << " distinct indices returned on average." <<
       std::endl;
@@ -1030,6 +1220,21 @@ double LSHSearch<SortPolicy>::ComputeRecall(
   return ((double) found) / realNeighbors.n_elem;
 }
 
+template<typename SortPolicy>
+std::vector<arma::Col<size_t>> LSHSearch<SortPolicy>::SecondHashTable() const
+{
+  std::vector<arma::Col<size_t>> secondHashTable(bucketOffsets.n_elem > 0 ?
+      bucketOffsets.n_elem - 1 : 0);
+  for (size_t i = 0; i < secondHashTable.size(); ++i)
+  {
+    secondHashTable[i].set_size(bucketOffsets[i + 1] - bucketOffsets[i]);
+    for (size_t j = 0; j < secondHashTable[i].n_elem; ++j)
+      secondHashTable[i][j] = bucketContents[bucketOffsets[i] + j];
+  }
+
+  return secondHashTable;
+}
+
 template<typename SortPolicy>
 template<typename Archive>
 void LSHSearch<SortPolicy>::serialize(Archive& ar,
@@ -1064,78 +1269,93 @@ void LSHSearch<SortPolicy>::serialize(Archive& ar,
   ar & BOOST_SERIALIZATION_NVP(secondHashSize);
   ar & BOOST_SERIALIZATION_NVP(secondHashWeights);
   ar & BOOST_SERIALIZATION_NVP(bucketSize);
-  // needs specific handling for new version
 
-  // Backward compatibility: in older versions of LSHSearch, the secondHashTable
-  // was stored as an arma::Mat<size_t>.  So we need to properly load that, then
-  // prune it down to size.
-  if (version == 0)
+  // Backward compatibility: older versions of LSHSearch stored each bucket of
+  // the second hash table in its own vector of size_t, with the number of
+  // points of each bucket in bucketContentSize.  We load them and then pack
+  // the buckets one after the other.
+  if (version < 2)
   {
-    arma::Mat<size_t> tmpSecondHashTable;
-    ar & BOOST_SERIALIZATION_NVP(tmpSecondHashTable);
-
-    // The old secondHashTable was stored in row-major format, so we transpose
-    // it.
-    tmpSecondHashTable = tmpSecondHashTable.t();
+    std::vector<arma::Col<size_t>> secondHashTable;
+    arma::Col<size_t> bucketContentSize;
 
-    secondHashTable.resize(tmpSecondHashTable.n_cols);
-    for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+    // In the oldest versions of LSHSearch, the secondHashTable was stored as an
+    // arma::Mat<size_t>.  So we need to properly load that, then prune it down
+    // to size.
+    if (version == 0)
     {
-      // Find length of each column.  We know we are at the end of the list when
-      // the value referenceSet.n_cols is seen.
+      arma::Mat<size_t> tmpSecondHashTable;
+      ar & BOOST_SERIALIZATION_NVP(tmpSecondHashTable);
 
-      size_t len = 0;
-      for (; len < tmpSecondHashTable.n_rows; ++len)
-        if (tmpSecondHashTable(len, i) == referenceSet.n_cols)
-          break;
+      // The old secondHashTable was stored in row-major format, so we
+      // transpose it.
+      tmpSecondHashTable = tmpSecondHashTable.t();
 
-      // Set the size of the new column correctly.
-      secondHashTable[i].set_size(len);
-      for (size_t j = 0; j < len; ++j)
-        secondHashTable[i](j) = tmpSecondHashTable(j, i);
-    }
-  }
-  else
-  {
-    size_t tables;
-    if (Archive::is_saving::value)
-      tables = secondHashTable.size();
-    ar & BOOST_SERIALIZATION_NVP(tables);
+      secondHashTable.resize(tmpSecondHashTable.n_cols);
+      for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+      {
+        // Find length of each column.  We know we are at the end of the list
+        // when the value referenceSet.n_cols is seen.
+
+        size_t len = 0;
+        for (; len < tmpSecondHashTable.n_rows; ++len)
+          if (tmpSecondHashTable(len, i) == referenceSet.n_cols)
+            break;
+
+        // Set the size of the new column correctly.
+        secondHashTable[i].set_size(len);
+        for (size_t j = 0; j < len; ++j)
+          secondHashTable[i](j) = tmpSecondHashTable(j, i);
+      }
 
-    // Set size of second hash table if needed.
-    if (Archive::is_loading::value)
+      // The old versions also held bucketContentSize for all possible buckets
+      // (of size secondHashSize).  So we need to shrink it.  But we can't do
+      // that until we have bucketRowInHashTable, so we also have to load that.
+      arma::Col<size_t> tmpBucketContentSize;
+      ar & BOOST_SERIALIZATION_NVP(tmpBucketContentSize);
+      ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+
+      // Compress into a smaller vector by just dropping all of the zeros.
+      bucketContentSize.zeros(secondHashTable.size());
+      for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
+        if (tmpBucketContentSize[i] > 0)
+          bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
+    }
+    else
     {
-      secondHashTable.clear();
+      size_t tables = 0;
+      ar & BOOST_SERIALIZATION_NVP(tables);
       secondHashTable.resize(tables);
-    }
 
-    ar & BOOST_SERIALIZATION_NVP(secondHashTable);
-  }
+      ar & BOOST_SERIALIZATION_NVP(secondHashTable);
+      ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
+      ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+    }
 
-  // Backward compatibility: old versions of LSHSearch held bucketContentSize
-  // for all possible buckets (of size secondHashSize), but now we hold a
-  // compressed representation.
-  if (version == 0)
-  {
-    // The vector was stored in the old uncompressed form.  So we need to shrink
-    // it.  But we can't do that until we have bucketRowInHashTable, so we also
-    // have to load that.
-    arma::Col<size_t> tmpBucketContentSize;
-    ar & BOOST_SERIALIZATION_NVP(tmpBucketContentSize);
-    ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+    bucketOffsets.set_size(secondHashTable.size() + 1);
+    bucketOffsets[0] = 0;
+    for (size_t i = 0; i < secondHashTable.size(); ++i)
+      bucketOffsets[i + 1] = bucketOffsets[i] + bucketContentSize[i];
 
-    // Compress into a smaller vector by just dropping all of the zeros.
-    bucketContentSize.set_size(secondHashTable.size());
-    for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
-      if (tmpBucketContentSize[i] > 0)
-        bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
+    bucketContents.set_size(bucketOffsets[secondHashTable.size()]);
+    for (size_t i = 0; i < secondHashTable.size(); ++i)
+      for (size_t j = 0; j < bucketContentSize[i]; ++j)
+        bucketContents[bucketOffsets[i] + j] =
+            (arma::u32) secondHashTable[i][j];
   }
   else
   {
-    ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
+    ar & BOOST_SERIALIZATION_NVP(bucketContents);
+    ar & BOOST_SERIALIZATION_NVP(bucketOffsets);
     ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
   }
 
+  // Points could only be removed since version 3.
+  if (version >= 3)
+    ar & BOOST_SERIALIZATION_NVP(removed);
+  else if (Archive::is_loading::value)
+    removed.clear();
+
   ar & BOOST_SERIALIZATION_NVP(distanceEvaluations);
 }
 
@@ -82,7 +82,12 @@ void MatrixCompletion::InitSDP()
   sdp.SDP().C().eye(m + n, m + n);
   sdp.SDP().SparseB() = 2. * values;
   const size_t p = indices.n_cols;
-  for (size_t i = 0; i < p; i++)
+
+  // Each constraint only has two entries, so LRSDP evaluates it with a dot
+  // product of two rows of the solution; the constraints are independent and
+  // are filled in parallel.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) p; i++)
   {
     sdp.SDP().SparseA()[i].zeros(m + n, m + n);
     sdp.SDP().SparseA()[i](indices(0, i), m + indices(1, i)) = 1.;
@@ -94,8 +99,9 @@ void MatrixCompletion::Recover(arma::mat& recovered)
 {
   recovered = sdp.Function().GetInitialPoint();
   sdp.Optimize(recovered);
-  recovered = recovered * trans(recovered);
-  recovered = recovered(arma::span(0, m - 1), arma::span(m, m + n - 1));
+
+  // Only the upper right block of R * R^T is needed.
+  recovered = recovered.rows(0, m - 1) * trans(recovered.rows(m, m + n - 1));
 }
 
 size_t MatrixCompletion::DefaultRank(const size_t m,
@@ -27,6 +27,11 @@ namespace meanshift /** Mean shift clustering. */ {
  * apply mean shift algorithm until maximum iterations or convergence.  Then
  * remove duplicate centroids.
  *
+ * All seeds are shifted at the same time, in parallel when OpenMP is
+ * available, using one range search per iteration on a tree that is built only
+ * once.  A seed stops as soon as it gets within half the radius of a centroid
+ * that has already converged, since it would end up as a duplicate.
+ *
  * A simple example of how to run mean shift clustering is shown below.
  *
  * @code
@@ -129,30 +134,38 @@ class MeanShift
    * Use kernel to calculate new centroid given dataset and valid neighbors.
    *
    * @param data The whole dataset
-   * @param neighbors Valid neighbors
-   * @param distances Distances to neighbors
+   * @param neighbors Valid neighbors of all seeds
+   * @param distances Distances to neighbors of all seeds
+   * @param begin Position of the first neighbor of the seed
+   * @param end Position past the last neighbor of the seed
    # @param centroid Store calculated centroid
    */
   template<bool ApplyKernel = UseKernel>
   typename std::enable_if<ApplyKernel, bool>::type
   CalculateCentroid(const MatType& data,
-                    const std::vector<size_t>& neighbors,
-                    const std::vector<double>& distances,
+                    const arma::Col<size_t>& neighbors,
+                    const arma::vec& distances,
+                    const size_t begin,
+                    const size_t end,
                     arma::colvec& centroid);
 
   /**
    * Use mean to calculate new centroid given dataset and valid neighbors.
    *
    * @param data The whole dataset
-   * @param neighbors Valid neighbors
-   * @param distances Distances to neighbors
+   * @param neighbors Valid neighbors of all seeds
+   * @param distances Distances to neighbors of all seeds
+   * @param begin Position of the first neighbor of the seed
+   * @param end Position past the last neighbor of the seed
    # @param centroid Store calculated centroid
    */
   template<bool ApplyKernel = UseKernel>
   typename std::enable_if<!ApplyKernel, bool>::type
   CalculateCentroid(const MatType& data,
-                    const std::vector<size_t>& neighbors,
-                    const std::vector<double>&, /*unused*/
+                    const arma::Col<size_t>& neighbors,
+                    const arma::vec&, /*unused*/
+                    const size_t begin,
+                    const size_t end,
                     arma::colvec& centroid);
 
   /**
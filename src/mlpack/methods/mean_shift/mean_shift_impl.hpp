@@ -18,7 +18,8 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
 
-#include "map"
+#include <boost/functional/hash.hpp>
+#include <unordered_map>
 
 // In case it hasn't been included yet.
 #include "mean_shift.hpp"
@@ -71,20 +72,13 @@ EstimateRadius(const MatType& data, double ratio)
   return sum(maxDistances) / (double) data.n_cols;
 }
 
-// Class to compare two vectors.
-template <typename VecType>
-class less
+// Hash function for the integer coordinates of a bin.
+class BinHash
 {
  public:
-  bool operator()(const VecType& first, const VecType& second) const
+  size_t operator()(const std::vector<double>& bin) const
   {
-    for (size_t i = 0; i < first.n_rows; ++i)
-    {
-      if (first[i] == second[i])
-        continue;
-      return first(i) < second(i);
-    }
-    return false;
+    return boost::hash_range(bin.begin(), bin.end());
   }
 };
 
@@ -96,37 +90,51 @@ void MeanShift<UseKernel, KernelType, MatType>::GenSeeds(
     const int minFreq,
     MatType& seeds)
 {
-  typedef arma::colvec VecType;
-  std::map<VecType, int, less<VecType> > allSeeds;
+  // The points are counted in a hashed grid.  The bins are kept in the order
+  // in which they are first seen, so that the seeds don't depend on the hash
+  // function.
+  std::unordered_map<std::vector<double>, size_t, BinHash> binIndices;
+  std::vector<std::vector<double>> bins;
+  std::vector<int> binCounts;
+
+  std::vector<double> binnedPoint(data.n_rows);
   for (size_t i = 0; i < data.n_cols; ++i)
   {
-    VecType binnedPoint = arma::floor(data.unsafe_col(i) / binSize);
-    if (allSeeds.find(binnedPoint) == allSeeds.end())
-      allSeeds[binnedPoint] = 1;
+    for (size_t d = 0; d < data.n_rows; ++d)
+      binnedPoint[d] = std::floor(data(d, i) / binSize);
+
+    std::unordered_map<std::vector<double>, size_t, BinHash>::const_iterator it
+        = binIndices.find(binnedPoint);
+    if (it == binIndices.end())
+    {
+      binIndices[binnedPoint] = bins.size();
+      bins.push_back(binnedPoint);
+      binCounts.push_back(1);
+    }
     else
-      allSeeds[binnedPoint]++;
+    {
+      ++binCounts[it->second];
+    }
   }
 
   // Remove seeds with too few points.  First we count the number of seeds we
   // end up with, then we add them.
-  std::map<VecType, int, less<VecType> >::iterator it;
   size_t count = 0;
-  for (it = allSeeds.begin(); it != allSeeds.end(); ++it)
-    if (it->second >= minFreq)
+  for (size_t b = 0; b < bins.size(); ++b)
+    if (binCounts[b] >= minFreq)
       ++count;
 
   seeds.set_size(data.n_rows, count);
   count = 0;
-  for (it = allSeeds.begin(); it != allSeeds.end(); ++it)
+  for (size_t b = 0; b < bins.size(); ++b)
   {
-    if (it->second >= minFreq)
+    if (binCounts[b] >= minFreq)
     {
-      seeds.col(count) = it->first;
+      for (size_t d = 0; d < data.n_rows; ++d)
+        seeds(d, count) = bins[b][d] * binSize;
       ++count;
     }
   }
-
-  seeds *= binSize;
 }
 
 // Calculate new centroid with given kernel.
@@ -135,12 +143,14 @@ template<bool ApplyKernel>
 typename std::enable_if<ApplyKernel, bool>::type
 MeanShift<UseKernel, KernelType, MatType>::
 CalculateCentroid(const MatType& data,
-                  const std::vector<size_t>& neighbors,
-                  const std::vector<double>& distances,
+                  const arma::Col<size_t>& neighbors,
+                  const arma::vec& distances,
+                  const size_t begin,
+                  const size_t end,
                   arma::colvec& centroid)
 {
   double sumWeight = 0;
-  for (size_t i = 0; i < neighbors.size(); ++i)
+  for (size_t i = begin; i < end; ++i)
   {
     if (distances[i] > 0)
     {
@@ -165,14 +175,16 @@ template<bool ApplyKernel>
 typename std::enable_if<!ApplyKernel, bool>::type
 MeanShift<UseKernel, KernelType, MatType>::
 CalculateCentroid(const MatType& data,
-                  const std::vector<size_t>& neighbors,
-                  const std::vector<double>&, /*unused*/
+                  const arma::Col<size_t>& neighbors,
+                  const arma::vec&, /*unused*/
+                  const size_t begin,
+                  const size_t end,
                   arma::colvec& centroid)
 {
-  for (size_t i = 0; i < neighbors.size(); ++i)
+  for (size_t i = begin; i < end; ++i)
     centroid += data.unsafe_col(neighbors[i]);
 
-  centroid /= neighbors.size();
+  centroid /= (end - begin);
   return true;
 }
 
@@ -202,39 +214,95 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
     pSeeds = &seeds;
   }
 
-  // Holds all centroids before removing duplicate ones.
-  arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  // Holds all centroids before removing duplicate ones.  The initial centroid
+  // of each seed is the seed itself.
+  arma::mat allCentroids(*pSeeds);
 
   assignments.set_size(data.n_cols);
 
+  // The tree is built once; at each iteration, all the seeds that are still
+  // moving are shifted at once, with a single batched range search.
   range::RangeSearch<> rangeSearcher(data);
   math::Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
-
-  // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  arma::Col<size_t> offsets;
+  arma::Col<size_t> neighbors;
+  arma::vec distances;
+
+  // What happened to each active seed during an iteration.
+  enum SeedState { SHIFTED, CONVERGED, STOPPED };
+
+  std::vector<size_t> active(pSeeds->n_cols);
+  for (size_t i = 0; i < active.size(); ++i)
+    active[i] = i;
+
+  arma::mat queries;
+  std::vector<SeedState> states;
+  for (size_t completedIterations = 0; !active.empty() &&
+      (completedIterations < maxIterations || forceConvergence);
+      completedIterations++)
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations
-      || forceConvergence; completedIterations++)
-    {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+    queries.set_size(pSeeds->n_rows, active.size());
+    for (size_t j = 0; j < active.size(); ++j)
+      queries.col(j) = allCentroids.unsafe_col(active[j]);
 
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() <= 1)
-        break;
+    rangeSearcher.Search(queries, validRadius, offsets, neighbors, distances);
+
+    // The seeds are independent, so they are shifted in parallel; the modes
+    // are only modified below, once all seeds have been shifted.
+    states.resize(active.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t j = 0; j < (omp_size_t) active.size(); ++j)
+    {
+      const size_t i = active[j];
+      if (offsets[j + 1] - offsets[j] <= 1)
+      {
+        states[j] = STOPPED;
+        continue;
+      }
 
       // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
+      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+      if (!CalculateCentroid(data, neighbors, distances, offsets[j],
+          offsets[j + 1], newCentroid))
         newCentroid = allCentroids.unsafe_col(i);
 
       // If the mean shift vector is small enough, it has converged.
       if (metric::EuclideanDistance::Evaluate(newCentroid,
           allCentroids.unsafe_col(i)) < 1e-3 * radius)
+      {
+        states[j] = CONVERGED;
+        continue;
+      }
+
+      // Update the centroid.
+      allCentroids.col(i) = newCentroid;
+      states[j] = SHIFTED;
+
+      // A seed that gets within half the radius of a mode that has already
+      // converged would almost surely converge to that same mode, and then be
+      // removed as a duplicate; so there is no need to go on.
+      for (size_t k = 0; k < centroids.n_cols; ++k)
+      {
+        if (metric::EuclideanDistance::Evaluate(allCentroids.unsafe_col(i),
+            centroids.unsafe_col(k)) < 0.5 * radius)
+        {
+          states[j] = STOPPED;
+          break;
+        }
+      }
+    }
+
+    // Add the new modes, in the order of the seeds, so that the results don't
+    // depend on the number of threads.
+    size_t numActive = 0;
+    for (size_t j = 0; j < active.size(); ++j)
+    {
+      const size_t i = active[j];
+      if (states[j] == SHIFTED)
+      {
+        active[numActive++] = i;
+      }
+      else if (states[j] == CONVERGED)
       {
         // Determine if the new centroid is duplicate with old ones.
         bool isDuplicated = false;
@@ -251,14 +319,9 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
 
         if (!isDuplicated)
           centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
-
-        // Get out of the loop.
-        break;
       }
-
-      // Update the centroid.
-      allCentroids.col(i) = newCentroid;
     }
+    active.resize(numActive);
   }
 
   // If no centroid has converged due to too little iterations and without
@@ -228,14 +228,59 @@ class NaiveBayesClassifier
   /**
    * Compute the unnormalized posterior log probability of given points (log
    * likelihood). Results are returned as arma::mat, and each column represents
-   * a point, each row represents log likelihood of a class.
+   * a point, each row represents log likelihood of a class.  All the classes
+   * and points are handled at once with matrix products; dense points are
+   * centered first, to keep the precision.
    *
    * @param data Set of points to compute posterior log probability for.
    * @param logLikelihoods Matrix to store log likelihoods in.
    */
   template<typename MatType>
   void LogLikelihood(const MatType& data,
-                     ModelMatType& logLikelihoods) const;
+                     ModelMatType& logLikelihoods,
+                     const typename std::enable_if<
+                         !arma::is_SpMat<MatType>::value>::type* = 0) const;
+
+  //! Compute the log likelihoods of the given sparse points, which are not
+  //! centered so that they stay sparse.
+  template<typename MatType>
+  void LogLikelihood(const MatType& data,
+                     ModelMatType& logLikelihoods,
+                     const typename std::enable_if<
+                         arma::is_SpMat<MatType>::value>::type* = 0) const;
+
+  /**
+   * Compute the log likelihoods of the given points, which have already been
+   * centered on the given center (which is then subtracted from the means).
+   */
+  template<typename MatType>
+  void CenteredLogLikelihood(const MatType& data,
+                             const arma::Col<ElemType>& center,
+                             ModelMatType& logLikelihoods) const;
+
+  /**
+   * Store in the variances the sum of the squared deviations of the given dense
+   * points from the mean of their class.
+   *
+   * @param data Points the model is trained on.
+   * @param labels Labels of the points.
+   * @param labelMatrix Sparse one-hot matrix of the labels (one row per point).
+   */
+  template<typename MatType>
+  void SumSquaredDeviations(const MatType& data,
+                            const arma::Row<size_t>& labels,
+                            const arma::SpMat<ElemType>& labelMatrix,
+                            const typename std::enable_if<
+                                !arma::is_SpMat<MatType>::value>::type* = 0);
+
+  //! Store in the variances the sum of the squared deviations of the given
+  //! sparse points from the mean of their class.
+  template<typename MatType>
+  void SumSquaredDeviations(const MatType& data,
+                            const arma::Row<size_t>& labels,
+                            const arma::SpMat<ElemType>& labelMatrix,
+                            const typename std::enable_if<
+                                arma::is_SpMat<MatType>::value>::type* = 0);
 };
 
 } // namespace naive_bayes
@@ -22,6 +22,8 @@
 // In case it hasn't been included already.
 #include "naive_bayes_classifier.hpp"
 
+#include <mlpack/core/util/parallel_blocks.hpp>
+
 namespace mlpack {
 namespace naive_bayes {
 
@@ -109,14 +111,27 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     // Fist, de-normalize probabilities.
     probabilities *= trainingPoints;
 
+    // The count of each point's class once the point has been added is all
+    // that the updates of different dimensions share, so it is computed
+    // first; then every dimension is updated independently, in parallel.
+    // Each element of the model goes through the same updates as when the
+    // points are added one by one.
+    arma::Col<ElemType> counts(data.n_cols);
     for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
+      counts[j] = ++probabilities[labels[j]];
 
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+    {
+      for (size_t j = 0; j < data.n_cols; ++j)
+      {
+        const size_t label = labels[j];
+        const ElemType value = data(d, j);
+
+        const ElemType delta = value - means(d, label);
+        means(d, label) += delta / counts[j];
+        variances(d, label) += delta * (value - means(d, label));
+      }
     }
 
     for (size_t i = 0; i < probabilities.n_elem; ++i)
@@ -129,34 +144,32 @@ void NaiveBayesClassifier<ModelMatType>::Train(
   {
     // Set all parameters to zero.
     probabilities.zeros();
-    means.zeros();
-    variances.zeros();
-
-    // Don't use incremental algorithm.  This is a two-pass algorithm.  It is
-    // possible to calculate the means and variances using a faster one-pass
-    // algorithm but there are some precision and stability issues.  If this is
-    // too slow, it's an option to use the faster algorithm by default and then
-    // have this (and the incremental algorithm) be other options.
 
-    // Calculate the means.
+    // Don't use incremental algorithm.  This is a two-pass algorithm for dense
+    // data (see SumSquaredDeviations()).  The sums over the points of each
+    // class are all computed at once, as the product of the data with a
+    // sparse one-hot matrix of the labels.
+    arma::umat locations(2, data.n_cols);
     for (size_t j = 0; j < data.n_cols; ++j)
     {
-      const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
+      locations(0, j) = j;
+      locations(1, j) = labels[j];
+      ++probabilities[labels[j]];
     }
 
+    const arma::SpMat<ElemType> labelMatrix(locations,
+        arma::ones<arma::Col<ElemType>>(data.n_cols), data.n_cols, numClasses);
+
+    // Calculate the means.
+    means = data * labelMatrix;
+
     // Normalize means.
     for (size_t i = 0; i < probabilities.n_elem; ++i)
       if (probabilities[i] != 0.0)
         means.col(i) /= probabilities[i];
 
     // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
-    }
+    SumSquaredDeviations(data, labels, labelMatrix);
 
     // Normalize variances.
     for (size_t i = 0; i < probabilities.n_elem; ++i)
@@ -198,34 +211,105 @@ void NaiveBayesClassifier<ModelMatType>::Train(const VecType& point,
   probabilities /= trainingPoints;
 }
 
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::SumSquaredDeviations(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const arma::SpMat<ElemType>& labelMatrix,
+    const typename std::enable_if<!arma::is_SpMat<MatType>::value>::type*)
+{
+  // Two passes are used for dense data, since subtracting the squared means
+  // from the sums of squares can lose a lot of precision.
+  const arma::uvec labelIndices = arma::conv_to<arma::uvec>::from(labels);
+  variances = arma::square(data - means.cols(labelIndices)) * labelMatrix;
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::SumSquaredDeviations(
+    const MatType& data,
+    const arma::Row<size_t>& /* labels */,
+    const arma::SpMat<ElemType>& labelMatrix,
+    const typename std::enable_if<arma::is_SpMat<MatType>::value>::type*)
+{
+  // Subtracting the means would make sparse data dense, so the sums of squares
+  // are used instead: sum (x - mu)^2 = sum x^2 - n mu^2.
+  variances = arma::square(data) * labelMatrix;
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+    variances.col(i) -= probabilities[i] * arma::square(means.col(i));
+
+  // Rounding could make some of these slightly negative.
+  variances.elem(arma::find(variances < 0)).zeros();
+}
+
 template<typename ModelMatType>
 template<typename MatType>
 void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
     const MatType& data,
-    ModelMatType& logLikelihoods) const
+    ModelMatType& logLikelihoods,
+    const typename std::enable_if<!arma::is_SpMat<MatType>::value>::type*) const
 {
   static_assert(std::is_same<ElemType, typename MatType::elem_type>::value,
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  logLikelihoods = arma::log(arma::repmat(probabilities, 1, data.n_cols));
-  ModelMatType invVar = 1.0 / variances;
+  // Center the points (and the means) on the mean of the training points, so
+  // that expanding the squares in CenteredLogLikelihood() does not lose
+  // precision when the features are far from zero.
+  const arma::Col<ElemType> center = means * probabilities;
+  ModelMatType centeredData(data);
+  centeredData.each_col() -= center;
 
-  // Calculate the joint log likelihood of point for each of the
-  // means.n_cols.
+  CenteredLogLikelihood(centeredData, center, logLikelihoods);
+}
 
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; i++)
-  {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    ModelMatType diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    ModelMatType rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::Mat<ElemType> exponents = arma::sum(diffs % rhs, 0);
-
-    logLikelihoods.row(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        std::log(arma::det(arma::diagmat(variances.col(i)))) + exponents);
-  }
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
+    const MatType& data,
+    ModelMatType& logLikelihoods,
+    const typename std::enable_if<arma::is_SpMat<MatType>::value>::type*) const
+{
+  static_assert(std::is_same<ElemType, typename MatType::elem_type>::value,
+      "NaiveBayesClassifier: element type of given data must match the element "
+      "type of the model!");
+
+  // Centering would make the data dense, so it is used as is.
+  CenteredLogLikelihood(data, arma::zeros<arma::Col<ElemType>>(means.n_rows),
+      logLikelihoods);
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::CenteredLogLikelihood(
+    const MatType& data,
+    const arma::Col<ElemType>& center,
+    ModelMatType& logLikelihoods) const
+{
+  // The joint log likelihood of point x for class i is (this is an adaptation
+  // of gmm::phi() for the case where the covariance is a diagonal matrix)
+  //
+  //   log(p_i) - (d / 2) log(2 pi) - 0.5 sum_k log(var_ki)
+  //       - 0.5 sum_k (x_k - mu_ki)^2 / var_ki,
+  //
+  // and expanding the square gives, for all classes and points at once,
+  //
+  //   ((mu % invVar)^T x) - 0.5 (invVar^T (x % x)) + (terms of each class),
+  //
+  // so that everything is computed with two matrix products.
+  const ModelMatType invVar = 1.0 / variances;
+  ModelMatType centeredMeans(means);
+  centeredMeans.each_col() -= center;
+
+  const ModelMatType classTerms = arma::log(probabilities) +
+      ElemType(data.n_rows / -2.0 * log(2 * M_PI)) -
+      0.5 * arma::sum(arma::log(variances), 0).t() -
+      0.5 * arma::sum(arma::square(centeredMeans) % invVar, 0).t();
+
+  logLikelihoods = (centeredMeans % invVar).t() * data -
+      0.5 * (invVar.t() * arma::square(data));
+  logLikelihoods.each_col() += classTerms.col(0);
 }
 
 template<typename ModelMatType>
@@ -266,7 +350,11 @@ void NaiveBayesClassifier<ModelMatType>::Classify(
   // term.
   ModelMatType logLikelihoods;
   LogLikelihood(point, logLikelihoods);
-  const double logProbX = log(arma::accu(exp(logLikelihoods))); // Log(Prob(X)).
+
+  // Log(Prob(X)), computed in log-space so that it doesn't underflow.
+  const ElemType maxLogLikelihood = logLikelihoods.max();
+  const ElemType logProbX = maxLogLikelihood +
+      std::log(arma::accu(arma::exp(logLikelihoods - maxLogLikelihood)));
   logLikelihoods -= logProbX;
 
   arma::uword maxIndex = 0;
@@ -287,15 +375,21 @@ void NaiveBayesClassifier<ModelMatType>::Classify(
 
   predictions.set_size(data.n_cols);
 
-  ModelMatType logLikelihoods;
-  LogLikelihood(data, logLikelihoods);
-
-  for (size_t i = 0; i < data.n_cols; ++i)
+  // The log likelihoods of each block of points are computed with matrix
+  // products, and the blocks are handled in parallel.
+  util::ParallelBlocks(data.n_cols, [&](const size_t begin, const size_t end)
   {
-    arma::uword maxIndex = 0;
-    logLikelihoods.unsafe_col(i).max(maxIndex);
-    predictions[i] = maxIndex;
-  }
+    const MatType block = data.cols(begin, end);
+    ModelMatType logLikelihoods;
+    LogLikelihood(block, logLikelihoods);
+
+    for (size_t i = 0; i < logLikelihoods.n_cols; ++i)
+    {
+      arma::uword maxIndex = 0;
+      logLikelihoods.unsafe_col(i).max(maxIndex);
+      predictions[begin + i] = maxIndex;
+    }
+  });
 }
 
 template<typename ModelMatType>
@@ -314,27 +408,34 @@ void NaiveBayesClassifier<ModelMatType>::Classify(
       "type of the model!");
 
   predictions.set_size(data.n_cols);
+  predictionProbs.set_size(means.n_cols, data.n_cols);
 
-  ModelMatType logLikelihoods;
-  LogLikelihood(data, logLikelihoods);
-
-  // This will hold log(Prob(X)) for each point.
-  arma::Col<ElemType> logProbX(data.n_cols);
-  for (size_t j = 0; j < data.n_cols; ++j)
+  // Blocks of points are handled in parallel.
+  util::ParallelBlocks(data.n_cols, [&](const size_t begin, const size_t end)
   {
-    logProbX(j) = log(arma::accu(exp(logLikelihoods.col(j))));
-    logLikelihoods.col(j) -= logProbX(j);
-  }
-
-  predictionProbs = arma::exp(logLikelihoods);
-
-  // Now calculate maximum probabilities for each point.
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    arma::uword maxIndex = 0;
-    logLikelihoods.unsafe_col(i).max(maxIndex);
-    predictions[i] = maxIndex;
-  }
+    const MatType block = data.cols(begin, end);
+    ModelMatType logLikelihoods;
+    LogLikelihood(block, logLikelihoods);
+
+    // Subtract log(Prob(X)) from the log likelihoods of each point; it is
+    // computed in log-space so that it doesn't underflow.
+    const arma::Row<ElemType> maxLogLikelihoods =
+        arma::max(logLikelihoods, 0);
+    logLikelihoods.each_row() -= maxLogLikelihoods;
+    const arma::Row<ElemType> logProbX =
+        arma::log(arma::sum(arma::exp(logLikelihoods), 0));
+    logLikelihoods.each_row() -= logProbX;
+
+    predictionProbs.cols(begin, end) = arma::exp(logLikelihoods);
+
+    // Now calculate maximum probabilities for each point.
+    for (size_t i = 0; i < logLikelihoods.n_cols; ++i)
+    {
+      arma::uword maxIndex = 0;
+      logLikelihoods.unsafe_col(i).max(maxIndex);
+      predictions[begin + i] = maxIndex;
+    }
+  });
 }
 
 template<typename ModelMatType>
@@ -86,6 +86,12 @@ class NCA
   const OptimizerType& Optimizer() const { return optimizer; }
   OptimizerType& Optimizer() { return optimizer; }
 
+  //! Get the function to optimize.
+  const SoftmaxErrorFunction<MetricType>& ErrorFunction() const
+  { return errorFunction; }
+  //! Modify the function to optimize (for instance, to truncate the softmax).
+  SoftmaxErrorFunction<MetricType>& ErrorFunction() { return errorFunction; }
+
  private:
   //! Dataset reference.
   const arma::mat& dataset;
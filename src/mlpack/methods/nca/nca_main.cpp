@@ -82,7 +82,14 @@ PROGRAM_INFO("Neighborhood Components Analysis (NCA)",
     "mlpack L-BFGS documentation (in lbfgs.hpp) or the vast set of published "
     "literature on L-BFGS."
     "\n\n"
-    "By default, the SGD optimizer is used.");
+    "By default, the SGD optimizer is used."
+    "\n\n"
+    "The exact objective takes time quadratic in the number of points.  For "
+    "large datasets, the softmax of each point can be restricted to the "
+    "neighbors whose kernel value exp(-d(A x_i, A x_k)) is at least " +
+    PRINT_PARAM_STRING("truncation") + "; these neighbors are found with a "
+    "kd-tree and are searched again every " +
+    PRINT_PARAM_STRING("refresh_interval") + " passes over the dataset.");
 
 PARAM_MATRIX_IN_REQ("input", "Input dataset to run NCA on.", "i");
 PARAM_MATRIX_OUT("output", "Output matrix for learned distance matrix.", "o");
@@ -115,6 +122,12 @@ PARAM_DOUBLE_IN("min_step", "Minimum step of line search for L-BFGS.", "m",
 PARAM_DOUBLE_IN("max_step", "Maximum step of line search for L-BFGS.", "M",
     1e20);
 
+PARAM_DOUBLE_IN("truncation", "Smallest kernel value kept in the softmax of "
+    "each point; 0 computes the softmax exactly.", "u", 0.0);
+PARAM_INT_IN("refresh_interval", "Number of passes over the dataset after "
+    "which the neighbors of the truncated softmax are searched again.", "R",
+    10);
+
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -156,6 +169,15 @@ static void mlpackMain()
     ReportIgnoredParam("batch_size", "SGD optimizer is not being used");
   }
 
+  RequireParamValue<double>("truncation", [](double x)
+      { return x >= 0.0 && x < 1.0; }, true, "truncation must be in [0, 1)");
+  RequireParamValue<int>("refresh_interval", [](int x) { return x >= 0; },
+      true, "refresh interval must be non-negative");
+  if (CLI::GetParam<double>("truncation") == 0.0)
+  {
+    ReportIgnoredParam("refresh_interval", "the softmax is not truncated");
+  }
+
   const double stepSize = CLI::GetParam<double>("step_size");
   const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
   const double tolerance = CLI::GetParam<double>("tolerance");
@@ -168,6 +190,9 @@ static void mlpackMain()
   const double minStep = CLI::GetParam<double>("min_step");
   const double maxStep = CLI::GetParam<double>("max_step");
   const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
+  const double truncation = CLI::GetParam<double>("truncation");
+  const size_t refreshInterval =
+      (size_t) CLI::GetParam<int>("refresh_interval");
 
   // Load data.
   arma::mat data = std::move(CLI::GetParam<arma::mat>("input"));
@@ -227,6 +252,8 @@ static void mlpackMain()
     nca.Optimizer().Tolerance() = tolerance;
     nca.Optimizer().Shuffle() = shuffle;
     nca.Optimizer().BatchSize() = batchSize;
+    nca.ErrorFunction().Truncation() = truncation;
+    nca.ErrorFunction().RefreshInterval() = refreshInterval;
 
     nca.LearnDistance(distance);
   }
@@ -241,6 +268,8 @@ static void mlpackMain()
     nca.Optimizer().MaxLineSearchTrials() = maxLineSearchTrials;
     nca.Optimizer().MinStep() = minStep;
     nca.Optimizer().MaxStep() = maxStep;
+    nca.ErrorFunction().Truncation() = truncation;
+    nca.ErrorFunction().RefreshInterval() = refreshInterval;
 
     nca.LearnDistance(distance);
   }
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/range_search/range_search.hpp>
 
 namespace mlpack {
 namespace nca {
@@ -38,6 +39,16 @@ namespace nca {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * Computing the softmax exactly takes O(n^2) time for each evaluation.  If a
+ * truncation is set with Truncation(), the softmax of each point is instead
+ * restricted to its neighbors k with exp(-d(A x_i, A x_k)) at least as large as
+ * the truncation; these neighborhoods are found with a kd-tree range search in
+ * the projected space, and are only searched again every RefreshInterval()
+ * passes over the dataset.  In between, the kernel values are computed with
+ * the current projection, but the neighborhoods are kept as they are.  When
+ * the truncation is used, MetricType must be usable with kd-trees (for
+ * instance an LMetric).
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -129,6 +140,20 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the smallest kernel value exp(-d(A x_i, A x_k)) that is kept in the
+  //! softmax (0 means that the softmax is computed exactly).
+  double Truncation() const { return truncation; }
+  //! Modify the smallest kernel value exp(-d(A x_i, A x_k)) that is kept in the
+  //! softmax (0 means that the softmax is computed exactly).
+  double& Truncation() { return truncation; }
+
+  //! Get the number of passes over the dataset after which the truncated
+  //! neighborhoods are searched again.
+  size_t RefreshInterval() const { return refreshInterval; }
+  //! Modify the number of passes over the dataset after which the truncated
+  //! neighborhoods are searched again (0 searches them at every evaluation).
+  size_t& RefreshInterval() { return refreshInterval; }
+
  private:
   //! The dataset.  This is an alias until Shuffle() is called.
   arma::mat dataset;
@@ -152,6 +177,34 @@ class SoftmaxErrorFunction
   //! False if nothing has ever been precalculated (only at construction time).
   bool precalculated;
 
+  //! The smallest kernel value kept in the softmax, or 0 for the exact
+  //! softmax.
+  double truncation;
+  //! The number of passes over the dataset between two searches of the
+  //! neighborhoods.
+  size_t refreshInterval;
+  //! The number of points evaluated since the neighborhoods were searched.
+  size_t pointsSinceRefresh;
+  //! The neighbors of point i are neighbors[offsets[i]] to
+  //! neighbors[offsets[i + 1] - 1].  Empty until the neighborhoods have been
+  //! searched.
+  arma::Col<size_t> offsets;
+  //! The neighbors of each point, when the softmax is truncated.
+  arma::Col<size_t> neighbors;
+  //! The kernel value of each neighbor, for the non-separable Evaluate() and
+  //! Gradient().
+  arma::vec kernels;
+
+  /**
+   * Search the neighborhoods of all points in the stretched dataset again if
+   * they have never been searched or if RefreshInterval() passes over the
+   * dataset have been made since the last search, then count the given number
+   * of evaluated points.  This is only used when the softmax is truncated.
+   *
+   * @param numPoints Number of points that are about to be evaluated.
+   */
+  void UpdateNeighborhoods(const size_t numPoints);
+
   /**
    * Precalculate the denominators and numerators that will make up the p_ij,
    * but only if the coordinates matrix is different than the last coordinates
@@ -161,7 +214,7 @@ class SoftmaxErrorFunction
    * This will update last_coordinates_ and stretched_dataset_, and also
    * calculate the p_i and denominators_ which are used in the calculation of
    * p_i or p_ij.  The calculation will be O((n * (n + 1)) / 2), which is not
-   * great.
+   * great, unless the softmax is truncated.
    *
    * @param coordinates Coordinates matrix to use for precalculation.
    */
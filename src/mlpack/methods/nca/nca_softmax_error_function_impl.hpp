@@ -27,23 +27,54 @@ SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
     dataset(math::MakeAlias(const_cast<arma::mat&>(dataset), false)),
     labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
     metric(metric),
-    precalculated(false)
+    precalculated(false),
+    truncation(0.0),
+    refreshInterval(10),
+    pointsSinceRefresh(0)
 { /* nothing to do */ }
 
 //! Shuffle the dataset.
 template<typename MetricType>
 void SoftmaxErrorFunction<MetricType>::Shuffle()
 {
-  arma::mat newDataset;
-  arma::Row<size_t> newLabels;
+  // Generate ordering.
+  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+      dataset.n_cols - 1, dataset.n_cols));
 
-  math::ShuffleData(dataset, labels, newDataset, newLabels);
+  arma::mat newDataset = dataset.cols(ordering);
+  arma::Row<size_t> newLabels = labels.cols(ordering);
 
   math::ClearAlias(dataset);
   math::ClearAlias(labels);
 
   dataset = std::move(newDataset);
   labels = std::move(newLabels);
+
+  // The kernel values and the stretched dataset are in the old order.
+  precalculated = false;
+
+  // Reorder the truncated neighborhoods, if there are any, so that they don't
+  // have to be searched again.
+  if (offsets.n_elem == dataset.n_cols + 1)
+  {
+    arma::uvec newFromOld(dataset.n_cols);
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      newFromOld[ordering[i]] = i;
+
+    arma::Col<size_t> newOffsets(dataset.n_cols + 1);
+    arma::Col<size_t> newNeighbors(neighbors.n_elem);
+    newOffsets[0] = 0;
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      const size_t oldPoint = ordering[i];
+      newOffsets[i + 1] = newOffsets[i];
+      for (size_t j = offsets[oldPoint]; j < offsets[oldPoint + 1]; ++j)
+        newNeighbors[newOffsets[i + 1]++] = newFromOld[neighbors[j]];
+    }
+
+    offsets = std::move(newOffsets);
+    neighbors = std::move(newNeighbors);
+  }
 }
 
 //! The non-separable implementation, which uses Precalculate() to save time.
@@ -65,17 +96,27 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
                                                   const size_t batchSize)
 {
   // Unfortunately each evaluation will take O(N) time because it requires a
-  // scan over all points in the dataset.  Our objective is to compute p_i.
-  double denominator = 0;
-  double numerator = 0;
+  // scan over all points in the dataset (or over the neighborhood of the point,
+  // if the softmax is truncated).  Our objective is to compute p_i.
   double result = 0;
 
   // It's quicker to do this now than one point at a time later.
   stretchedDataset = coordinates * dataset;
+  const bool truncated = (truncation > 0.0);
+  if (truncated)
+    UpdateNeighborhoods(batchSize);
+
   for (size_t i = begin; i < begin + batchSize; i++)
   {
-    for (size_t k = 0; k < dataset.n_cols; ++k)
+    double denominator = 0;
+    double numerator = 0;
+
+    const size_t kBegin = truncated ? offsets[i] : 0;
+    const size_t kEnd = truncated ? offsets[i + 1] : dataset.n_cols;
+    for (size_t j = kBegin; j < kEnd; ++j)
     {
+      const size_t k = truncated ? neighbors[j] : j;
+
       // Don't consider the case where the points are the same.
       if (k == i)
         continue;
@@ -92,10 +133,12 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
     }
 
     // Now the result is just a simple division, but we have to be sure that the
-    // denominator is not 0.
+    // denominator is not 0.  With a truncated softmax, this only means that the
+    // point has no neighbor.
     if (denominator == 0.0)
     {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
+      if (!truncated)
+        Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
       continue;
     }
 
@@ -127,6 +170,43 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
   arma::mat sum;
   sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
+
+  // With a truncated softmax, the same terms are added once for each point i
+  // and each of its neighbors k, using the kernel values computed by
+  // Precalculate().  Each point is handled independently, so the terms are
+  // summed in parallel.
+  if (truncation > 0.0)
+  {
+    #pragma omp parallel
+    {
+      arma::mat threadSum;
+      threadSum.zeros(sum.n_rows, sum.n_cols);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+      {
+        for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+        {
+          const size_t k = neighbors[j];
+          const double p_ik = kernels[j] / denominators(i);
+
+          // Subtract x_i from x_k.  We are not using stretched points here.
+          arma::vec x_ik = dataset.col(i) - dataset.col(k);
+          if (labels[i] == labels[k])
+            threadSum += ((p[i] - 1) * p_ik) * (x_ik * trans(x_ik));
+          else
+            threadSum += (p[i] * p_ik) * (x_ik * trans(x_ik));
+        }
+      }
+
+      #pragma omp critical
+      sum += threadSum;
+    }
+
+    gradient = -2 * coordinates * sum;
+    return;
+  }
+
   for (size_t i = 0; i < stretchedDataset.n_cols; i++)
   {
     for (size_t k = (i + 1); k < stretchedDataset.n_cols; k++)
@@ -172,6 +252,10 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
 
   // Compute the stretched dataset.
   stretchedDataset = coordinates * dataset;
+  const bool truncated = (truncation > 0.0);
+  if (truncated)
+    UpdateNeighborhoods(batchSize);
+
   for (size_t i = begin; i < begin + batchSize; i++)
   {
     numerator = 0;
@@ -180,8 +264,13 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
     firstTerm.zeros(coordinates.n_rows, coordinates.n_cols);
     secondTerm.zeros(coordinates.n_rows, coordinates.n_cols);
 
-    for (size_t k = 0; k < dataset.n_cols; ++k)
+    // If the softmax is truncated, only the neighbors of the point are used.
+    const size_t kBegin = truncated ? offsets[i] : 0;
+    const size_t kEnd = truncated ? offsets[i + 1] : dataset.n_cols;
+    for (size_t j = kBegin; j < kEnd; ++j)
     {
+      const size_t k = truncated ? neighbors[j] : j;
+
       // Don't consider the case where the points are the same.
       if (i == k)
         continue;
@@ -211,7 +300,10 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
     double p = 0;
     if (denominator == 0)
     {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
+      // With a truncated softmax, this only means that the point has no
+      // neighbor.
+      if (!truncated)
+        Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
       // If the denominator is zero, then all p_ik should be zero and there is
       // no gradient contribution from this point.
       continue;
@@ -263,23 +355,49 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   // order of O((n * (n + 1)) / 2), which really isn't all that great.
   p.zeros(stretchedDataset.n_cols);
   denominators.zeros(stretchedDataset.n_cols);
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+  if (truncation > 0.0)
   {
-    for (size_t j = (i + 1); j < stretchedDataset.n_cols; j++)
+    // Only the neighbors of each point are used.  They are stored
+    // symmetrically, so each point can be handled independently and in
+    // parallel; the kernel values are saved for Gradient().
+    UpdateNeighborhoods(stretchedDataset.n_cols);
+    kernels.set_size(neighbors.n_elem);
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) stretchedDataset.n_cols; ++i)
     {
-      // Evaluate exp(-d(x_i, x_j)).
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(j)));
-
-      // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
-      denominators[i] += eval;
-      denominators[j] += eval;
+      for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+      {
+        const size_t k = neighbors[j];
+        kernels[j] = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
+                                          stretchedDataset.unsafe_col(k)));
 
-      // If i and j are the same class, add to numerator of both.
-      if (labels[i] == labels[j])
+        denominators[i] += kernels[j];
+        if (labels[i] == labels[k])
+          p[i] += kernels[j];
+      }
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+    {
+      for (size_t j = (i + 1); j < stretchedDataset.n_cols; j++)
       {
-        p[i] += eval;
-        p[j] += eval;
+        // Evaluate exp(-d(x_i, x_j)).
+        double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
+                                           stretchedDataset.unsafe_col(j)));
+
+        // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
+        denominators[i] += eval;
+        denominators[j] += eval;
+
+        // If i and j are the same class, add to numerator of both.
+        if (labels[i] == labels[j])
+        {
+          p[i] += eval;
+          p[j] += eval;
+        }
       }
     }
   }
@@ -304,6 +422,27 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   precalculated = true;
 }
 
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::UpdateNeighborhoods(
+    const size_t numPoints)
+{
+  if (offsets.n_elem != stretchedDataset.n_cols + 1 ||
+      pointsSinceRefresh >= refreshInterval * stretchedDataset.n_cols)
+  {
+    // The kernel value exp(-d) is at least the truncation when d is at most
+    // -log(truncation).
+    range::RangeSearch<MetricType, arma::mat, tree::KDTree> rs(
+        stretchedDataset, false, false, metric);
+    arma::vec distances;
+    rs.Search(math::Range(0.0, -std::log(truncation)), offsets, neighbors,
+        distances);
+
+    pointsSinceRefresh = 0;
+  }
+
+  pointsSinceRefresh += numPoints;
+}
+
 } // namespace nca
 } // namespace mlpack
 
@@ -0,0 +1,144 @@
+/**
+ * @file candidate_list.hpp
+ *
+ * Storage of the k best candidates of every query point, shared by the rules of
+ * the tree-based search methods.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_CANDIDATE_LIST_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_CANDIDATE_LIST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <algorithm>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The CandidateList class holds the k best candidates (value, index) found so
+ * far for each of a set of query points.  The candidates of a query point are
+ * a bounded heap with the worst candidate on top, and the heaps of all query
+ * points are stored one after another in a single buffer, so no memory is
+ * allocated per query point and a search touches contiguous memory.
+ *
+ * The order of the candidates is given by SortPolicy::IsBetter(); this is the
+ * same order as the std::priority_queue that the search rules used before, so
+ * the results are unchanged.
+ *
+ * @tparam SortPolicy The sort policy for the values of the candidates (for
+ *     instance NearestNeighborSort or FurthestNeighborSort).
+ */
+template<typename SortPolicy>
+class CandidateList
+{
+ public:
+  //! Candidate represents a possible candidate (value, index).
+  typedef std::pair<double, size_t> Candidate;
+
+  /**
+   * Create the candidate lists of the given number of query points, each one
+   * holding k copies of (worstValue, size_t() - 1).
+   *
+   * @param numQueries Number of query points.
+   * @param k Number of candidates for each query point.
+   * @param worstValue The value of the initial candidates.
+   */
+  CandidateList(const size_t numQueries,
+                const size_t k,
+                const double worstValue = SortPolicy::WorstDistance()) :
+      k(k),
+      candidates(numQueries * k, std::make_pair(worstValue, size_t() - 1))
+  { /* Nothing to do. */ }
+
+  //! Get the worst candidate of the given query point.
+  const Candidate& Top(const size_t queryIndex) const
+  {
+    return candidates[queryIndex * k];
+  }
+
+  /**
+   * Insert the given candidate for the given query point, if its value is
+   * strictly better than the current worst candidate, which is then removed.
+   *
+   * @param queryIndex Index of the query point.
+   * @param value Value of the candidate (usually a distance).
+   * @param index Index of the candidate.
+   * @return Whether the candidate was inserted.
+   */
+  bool Insert(const size_t queryIndex, const double value, const size_t index)
+  {
+    Candidate* begin = &candidates[queryIndex * k];
+    const Candidate c = std::make_pair(value, index);
+    if (!CandidateCmp()(c, *begin))
+      return false;
+
+    std::pop_heap(begin, begin + k, CandidateCmp());
+    begin[k - 1] = c;
+    std::push_heap(begin, begin + k, CandidateCmp());
+    return true;
+  }
+
+  //! Get a pointer to the first candidate of the given query point (they are
+  //! not sorted).
+  const Candidate* Begin(const size_t queryIndex) const
+  {
+    return &candidates[queryIndex * k];
+  }
+
+  //! Get a pointer past the last candidate of the given query point.
+  const Candidate* End(const size_t queryIndex) const
+  {
+    return &candidates[queryIndex * k] + k;
+  }
+
+  /**
+   * Store the candidates of the given query point in the corresponding column
+   * of the given matrices, which must already have k rows, best candidate
+   * first.  The candidate list of this query point can't be used anymore
+   * after this.
+   *
+   * @param indices Matrix storing the indices of the candidates.
+   * @param values Matrix storing the values of the candidates.
+   * @param queryIndex Index of the query point.
+   */
+  void GetResults(arma::Mat<size_t>& indices,
+                  arma::mat& values,
+                  const size_t queryIndex)
+  {
+    Candidate* begin = &candidates[queryIndex * k];
+    std::sort_heap(begin, begin + k, CandidateCmp());
+    for (size_t j = 0; j < k; ++j)
+    {
+      indices(j, queryIndex) = begin[j].second;
+      values(j, queryIndex) = begin[j].first;
+    }
+  }
+
+  //! Get the number of candidates of each query point.
+  size_t K() const { return k; }
+
+ private:
+  //! Compare two candidates based on the value; the worst one is the largest.
+  struct CandidateCmp
+  {
+    bool operator()(const Candidate& c1, const Candidate& c2) const
+    {
+      return !SortPolicy::IsBetter(c2.first, c1.first);
+    }
+  };
+
+  //! The number of candidates of each query point.
+  size_t k;
+
+  //! The heaps of candidates of all query points.
+  std::vector<Candidate> candidates;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file ivf_search.hpp
+ *
+ * Definition of the IVFSearch class, an inverted file index that partitions
+ * the reference set with k-means and only searches the partitions closest to
+ * each query.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_IVF_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_IVF_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include "quantized_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * IVFSearch is an inverted file index for approximate k-nearest-neighbor
+ * search with the Euclidean distance.  The reference set is clustered with
+ * k-means, and each reference point is stored in the inverted list of its
+ * closest centroid.  A query is compared with the centroids, and only the
+ * points in the lists of its nProbe closest centroids are searched, so that
+ * nProbe trades speed for recall (with nProbe equal to the number of lists,
+ * the search is exact).
+ *
+ * The lists are stored contiguously, one after the other, so that each list is
+ * scanned as a block of consecutive columns: the distances between a query and
+ * the points of a list are computed with a single matrix-vector product, and
+ * the distances between a block of queries and the centroids with a single
+ * matrix product.  The queries are searched in parallel with OpenMP.
+ *
+ * Instead of the points themselves, the lists can hold a QuantizedSearch model
+ * of the residuals of the points (their difference with their centroid), which
+ * takes one byte per dimension.  The distances are then approximate, and the
+ * best candidates can be re-ranked with exact distances computed from the
+ * original reference set, which may be memory-mapped so that only the
+ * candidates' columns are read:
+ *
+ * @code
+ * // 1000 lists with quantized residuals; search the 8 closest lists.
+ * IVFSearch<> ivf(referenceSet, 1000, true, 8);
+ *
+ * // Re-rank the best 100 candidates of each query with exact distances.
+ * ivf.Search(querySet, referenceSet, 10, 100, neighbors, distances);
+ * @endcode
+ *
+ * Only a sample of the reference set (256 points per list, at most) is
+ * clustered, and then every point is assigned to its closest centroid.
+ *
+ * @tparam KMeansType The k-means clustering used to find the centroids.
+ */
+template<typename KMeansType = kmeans::KMeans<>>
+class IVFSearch
+{
+ public:
+  /**
+   * Create an empty IVFSearch object.  Be sure to call Train() before calling
+   * Search().
+   */
+  IVFSearch() : nProbe(1), quantized(false) { }
+
+  /**
+   * Build the index on the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLists Number of inverted lists (k-means clusters).
+   * @param quantize If true, store the quantized residuals of the points
+   *     instead of the points.
+   * @param nProbe Number of lists searched for each query.
+   * @param kmeans Instantiated k-means object used to find the centroids.
+   */
+  IVFSearch(const arma::mat& referenceSet,
+            const size_t numLists,
+            const bool quantize = false,
+            const size_t nProbe = 1,
+            KMeansType kmeans = KMeansType());
+
+  /**
+   * Build the index on the given reference set, replacing any existing index.
+   * A std::invalid_argument is thrown if the reference set is empty or if
+   * numLists is 0 or larger than the number of reference points.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLists Number of inverted lists (k-means clusters).
+   * @param quantize If true, store the quantized residuals of the points
+   *     instead of the points.
+   * @param kmeans Instantiated k-means object used to find the centroids.
+   */
+  void Train(const arma::mat& referenceSet,
+             const size_t numLists,
+             const bool quantize = false,
+             KMeansType kmeans = KMeansType());
+
+  /**
+   * Search for the k neighbors of each point in the query set in the NProbe()
+   * closest lists.  If the residuals are quantized, the returned distances are
+   * approximate.  If fewer than k points are found in the lists, the missing
+   * neighbors are given the index of the number of reference points and the
+   * largest possible distance.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances in.
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Search for the k neighbors of each point in the query set: find the best
+   * numCandidates points in the NProbe() closest lists, then take the best k
+   * of those using exact distances computed from referenceSet.  The returned
+   * distances are exact.
+   *
+   * @param querySet Set of query points.
+   * @param referenceSet The reference set that the index was trained on.
+   * @param k Number of neighbors to search for.
+   * @param numCandidates Number of candidates to re-rank for each query (at
+   *     least k).
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the exact distances in.
+   */
+  void Search(const arma::mat& querySet,
+              const arma::mat& referenceSet,
+              const size_t k,
+              const size_t numCandidates,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Get the number of inverted lists.
+  size_t NumLists() const { return centroids.n_cols; }
+  //! Get the centroid of each list.
+  const arma::mat& Centroids() const { return centroids; }
+  //! Get the offset of each list in Indices(), followed by the number of
+  //! reference points.
+  const arma::Col<size_t>& ListOffsets() const { return listOffsets; }
+  //! Get the index of each stored point in the reference set, in list order.
+  const arma::Col<size_t>& Indices() const { return indices; }
+  //! Get the stored points, in list order (empty if they are quantized).
+  const arma::mat& Points() const { return points; }
+
+  //! Get whether the residuals of the points are quantized.
+  bool Quantized() const { return quantized; }
+  //! Get the model of the quantized residuals, in list order.
+  const QuantizedSearch<>& Residuals() const { return residuals; }
+
+  //! Get the number of lists searched for each query.
+  size_t NProbe() const { return nProbe; }
+  //! Modify the number of lists searched for each query.
+  size_t& NProbe() { return nProbe; }
+
+  //! Serialize the index.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Assign each of the given points to the list of its closest centroid.
+  void Assign(const arma::mat& data, arma::Row<size_t>& assignments) const;
+
+  //! Check the query set and k, and set the size of the output matrices.
+  void CheckSearch(const arma::mat& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& neighbors,
+                   arma::mat& distances) const;
+
+  /**
+   * Fill heap with the best numCandidates (squared distance, index) pairs for
+   * the given query in its closest lists, given the products of the query with
+   * the centroids.  The heap is ordered so that its front is the worst
+   * candidate; the indices are positions in Indices().
+   */
+  void Candidates(const arma::vec& query,
+                  const arma::vec& centroidProducts,
+                  const size_t numCandidates,
+                  std::vector<std::pair<double, size_t>>& heap,
+                  std::vector<std::pair<double, size_t>>& lists,
+                  arma::vec& scores,
+                  std::vector<float>& offsets) const;
+
+  //! Add the given candidate to the heap of the best numCandidates.
+  static void Push(std::vector<std::pair<double, size_t>>& heap,
+                   const size_t numCandidates,
+                   const std::pair<double, size_t>& candidate);
+
+  //! The number of queries whose distances to the centroids are computed
+  //! together.
+  static size_t BlockSize() { return 64; }
+
+  //! The centroid of each list.
+  arma::mat centroids;
+  //! The squared norm of each centroid.
+  arma::vec centroidNorms;
+  //! The offset of each list in indices, followed by the number of points.
+  arma::Col<size_t> listOffsets;
+  //! The index of each stored point in the reference set.
+  arma::Col<size_t> indices;
+  //! The stored points (empty if they are quantized).
+  arma::mat points;
+  //! The squared norm of each stored point (empty if they are quantized).
+  arma::vec pointNorms;
+  //! The quantized residuals of the points (if they are quantized).
+  QuantizedSearch<> residuals;
+  //! The number of lists searched for each query.
+  size_t nProbe;
+  //! Whether the residuals of the points are quantized.
+  bool quantized;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ivf_search_impl.hpp"
+
+#endif
@@ -0,0 +1,426 @@
+/**
+ * @file ivf_search_impl.hpp
+ *
+ * Implementation of the IVFSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_IVF_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_IVF_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ivf_search.hpp"
+
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename KMeansType>
+IVFSearch<KMeansType>::IVFSearch(const arma::mat& referenceSet,
+                                 const size_t numLists,
+                                 const bool quantize,
+                                 const size_t nProbe,
+                                 KMeansType kmeans) :
+    nProbe(nProbe),
+    quantized(quantize)
+{
+  Train(referenceSet, numLists, quantize, kmeans);
+}
+
+template<typename KMeansType>
+void IVFSearch<KMeansType>::Train(const arma::mat& referenceSet,
+                                  const size_t numLists,
+                                  const bool quantize,
+                                  KMeansType kmeans)
+{
+  if (referenceSet.n_elem == 0)
+  {
+    throw std::invalid_argument("IVFSearch::Train(): reference set is "
+        "empty!");
+  }
+
+  if (numLists == 0 || numLists > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "IVFSearch::Train(): the number of lists (" << numLists << ") must "
+        << "be positive and at most the number of reference points ("
+        << referenceSet.n_cols << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  quantized = quantize;
+
+  // A sample of a few hundred points per list is enough to find the
+  // centroids.
+  const size_t sampleSize = 256 * numLists;
+  if (referenceSet.n_cols > sampleSize)
+  {
+    arma::uvec sample;
+    math::ObtainDistinctSamples(0, referenceSet.n_cols, sampleSize, sample);
+    const arma::mat sampleSet = referenceSet.cols(sample);
+    kmeans.Cluster(sampleSet, numLists, centroids);
+  }
+  else
+  {
+    kmeans.Cluster(referenceSet, numLists, centroids);
+  }
+  centroidNorms = arma::sum(arma::square(centroids), 0).t();
+
+  arma::Row<size_t> assignments;
+  Assign(referenceSet, assignments);
+
+  // Lay the lists out one after the other, with the points of each list in
+  // increasing order.
+  listOffsets.zeros(numLists + 1);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    ++listOffsets[assignments[i] + 1];
+  for (size_t l = 0; l < numLists; ++l)
+    listOffsets[l + 1] += listOffsets[l];
+
+  arma::Col<size_t> positions = listOffsets.subvec(0, numLists - 1);
+  indices.set_size(referenceSet.n_cols);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    indices[positions[assignments[i]]++] = i;
+
+  if (!quantized)
+  {
+    points.set_size(referenceSet.n_rows, referenceSet.n_cols);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) indices.n_elem; ++j)
+      points.col(j) = referenceSet.col(indices[j]);
+
+    pointNorms = arma::sum(arma::square(points), 0).t();
+    residuals = QuantizedSearch<>();
+  }
+  else
+  {
+    arma::mat residualSet(referenceSet.n_rows, referenceSet.n_cols);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) indices.n_elem; ++j)
+    {
+      residualSet.col(j) = referenceSet.col(indices[j]) -
+          centroids.col(assignments[indices[j]]);
+    }
+
+    residuals.Train(residualSet);
+    points.reset();
+    pointNorms.reset();
+  }
+}
+
+template<typename KMeansType>
+void IVFSearch<KMeansType>::Assign(const arma::mat& data,
+                                   arma::Row<size_t>& assignments) const
+{
+  assignments.set_size(data.n_cols);
+  const size_t numBlocks = (data.n_cols + BlockSize() - 1) / BlockSize();
+
+  // The closest centroid c to a point p minimizes ||c||^2 - 2 c^T p, so the
+  // products of a block of points with all centroids are all that is needed.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize();
+    const size_t end = std::min(begin + BlockSize(), (size_t) data.n_cols);
+    const arma::mat products = centroids.t() * data.cols(begin, end - 1);
+
+    for (size_t i = 0; i < end - begin; ++i)
+    {
+      size_t best = 0;
+      double bestScore = DBL_MAX;
+      for (size_t l = 0; l < centroids.n_cols; ++l)
+      {
+        const double score = centroidNorms[l] - 2 * products(l, i);
+        if (score < bestScore)
+        {
+          bestScore = score;
+          best = l;
+        }
+      }
+
+      assignments[begin + i] = best;
+    }
+  }
+}
+
+template<typename KMeansType>
+void IVFSearch<KMeansType>::CheckSearch(const arma::mat& querySet,
+                                        const size_t k,
+                                        arma::Mat<size_t>& neighbors,
+                                        arma::mat& distances) const
+{
+  if (querySet.n_rows != centroids.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "IVFSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << centroids.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > indices.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "IVFSearch::Search(): requested " << k << " neighbors, but "
+        << "reference set has " << indices.n_elem << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+}
+
+template<typename KMeansType>
+void IVFSearch<KMeansType>::Push(std::vector<std::pair<double, size_t>>& heap,
+                                 const size_t numCandidates,
+                                 const std::pair<double, size_t>& candidate)
+{
+  if (heap.size() < numCandidates)
+  {
+    heap.push_back(candidate);
+    std::push_heap(heap.begin(), heap.end());
+  }
+  else if (candidate < heap.front())
+  {
+    std::pop_heap(heap.begin(), heap.end());
+    heap.back() = candidate;
+    std::push_heap(heap.begin(), heap.end());
+  }
+}
+
+template<typename KMeansType>
+void IVFSearch<KMeansType>::Candidates(
+    const arma::vec& query,
+    const arma::vec& centroidProducts,
+    const size_t numCandidates,
+    std::vector<std::pair<double, size_t>>& heap,
+    std::vector<std::pair<double, size_t>>& lists,
+    arma::vec& scores,
+    std::vector<float>& offsets) const
+{
+  // Find the lists with the closest centroids.
+  const size_t numLists = centroids.n_cols;
+  const size_t probes = std::min(std::max(nProbe, (size_t) 1), numLists);
+  lists.resize(numLists);
+  for (size_t l = 0; l < numLists; ++l)
+    lists[l] = std::make_pair(centroidNorms[l] - 2 * centroidProducts[l], l);
+  std::partial_sort(lists.begin(), lists.begin() + probes, lists.end());
+
+  const double queryNorm = arma::dot(query, query);
+  const size_t dims = centroids.n_rows;
+
+  heap.clear();
+  for (size_t p = 0; p < probes; ++p)
+  {
+    const size_t l = lists[p].second;
+    const size_t begin = listOffsets[l];
+    const size_t end = listOffsets[l + 1];
+    if (begin == end)
+      continue;
+
+    if (!quantized)
+    {
+      // ||q - x||^2 = ||q||^2 + ||x||^2 - 2 x^T q, for the whole list at once.
+      scores = pointNorms.subvec(begin, end - 1) -
+          2 * (points.cols(begin, end - 1).t() * query);
+      for (size_t j = begin; j < end; ++j)
+      {
+        Push(heap, numCandidates, std::make_pair(std::max(scores[j - begin] +
+            queryNorm, 0.0), j));
+      }
+    }
+    else
+    {
+      // The residual of the query with the centroid of the list is compared
+      // with the reconstructed residuals, as in QuantizedSearch.  The offsets
+      // of the dimensions are followed by their quantization steps.
+      const arma::Mat<unsigned char>& codes = residuals.Codes();
+      const arma::vec& minimums = residuals.Minimums();
+      const arma::vec& steps = residuals.Scales();
+      offsets.resize(2 * dims);
+      for (size_t d = 0; d < dims; ++d)
+      {
+        offsets[d] = float(query[d] - centroids(d, l) - minimums[d]);
+        offsets[dims + d] = float(steps[d]);
+      }
+
+      for (size_t j = begin; j < end; ++j)
+      {
+        const unsigned char* code = codes.colptr(j);
+        float distance = 0.0f;
+        for (size_t d = 0; d < dims; ++d)
+        {
+          const float diff = offsets[d] - offsets[dims + d] * float(code[d]);
+          distance += diff * diff;
+        }
+
+        Push(heap, numCandidates, std::make_pair((double) distance, j));
+      }
+    }
+  }
+}
+
+template<typename KMeansType>
+void IVFSearch<KMeansType>::Search(const arma::mat& querySet,
+                                   const size_t k,
+                                   arma::Mat<size_t>& neighbors,
+                                   arma::mat& distances) const
+{
+  CheckSearch(querySet, k, neighbors, distances);
+  if (k == 0)
+    return;
+
+  const size_t numBlocks = (querySet.n_cols + BlockSize() - 1) / BlockSize();
+
+  #pragma omp parallel
+  {
+    std::vector<std::pair<double, size_t>> heap, lists;
+    arma::vec scores;
+    std::vector<float> offsets;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * BlockSize();
+      const size_t end = std::min(begin + BlockSize(),
+          (size_t) querySet.n_cols);
+      const arma::mat products = centroids.t() *
+          querySet.cols(begin, end - 1);
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        const arma::vec query(const_cast<double*>(querySet.colptr(i)),
+            querySet.n_rows, false, true);
+        const arma::vec queryProducts(const_cast<double*>(
+            products.colptr(i - begin)), products.n_rows, false, true);
+        Candidates(query, queryProducts, k, heap, lists, scores, offsets);
+        std::sort_heap(heap.begin(), heap.end());
+
+        for (size_t j = 0; j < k; ++j)
+        {
+          if (j < heap.size())
+          {
+            neighbors(j, i) = indices[heap[j].second];
+            distances(j, i) = std::sqrt(heap[j].first);
+          }
+          else
+          {
+            neighbors(j, i) = indices.n_elem;
+            distances(j, i) = DBL_MAX;
+          }
+        }
+      }
+    }
+  }
+}
+
+template<typename KMeansType>
+void IVFSearch<KMeansType>::Search(const arma::mat& querySet,
+                                   const arma::mat& referenceSet,
+                                   const size_t k,
+                                   const size_t numCandidates,
+                                   arma::Mat<size_t>& neighbors,
+                                   arma::mat& distances) const
+{
+  CheckSearch(querySet, k, neighbors, distances);
+  if (referenceSet.n_rows != centroids.n_rows ||
+      referenceSet.n_cols != indices.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "IVFSearch::Search(): reference set has size "
+        << referenceSet.n_rows << "x" << referenceSet.n_cols << ", but the "
+        << "model was trained on a " << centroids.n_rows << "x"
+        << indices.n_elem << " reference set!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numCandidates < k)
+  {
+    std::ostringstream oss;
+    oss << "IVFSearch::Search(): number of candidates (" << numCandidates
+        << ") must be at least k (" << k << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k == 0)
+    return;
+
+  const size_t numBlocks = (querySet.n_cols + BlockSize() - 1) / BlockSize();
+
+  #pragma omp parallel
+  {
+    std::vector<std::pair<double, size_t>> heap, lists;
+    arma::vec scores;
+    std::vector<float> offsets;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * BlockSize();
+      const size_t end = std::min(begin + BlockSize(),
+          (size_t) querySet.n_cols);
+      const arma::mat products = centroids.t() *
+          querySet.cols(begin, end - 1);
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        const arma::vec query(const_cast<double*>(querySet.colptr(i)),
+            querySet.n_rows, false, true);
+        const arma::vec queryProducts(const_cast<double*>(
+            products.colptr(i - begin)), products.n_rows, false, true);
+        Candidates(query, queryProducts, numCandidates, heap, lists, scores,
+            offsets);
+
+        // Re-rank the candidates with their exact distances.
+        for (size_t j = 0; j < heap.size(); ++j)
+        {
+          heap[j].second = indices[heap[j].second];
+          heap[j].first = metric::EuclideanDistance::Evaluate(query,
+              referenceSet.col(heap[j].second));
+        }
+
+        const size_t found = std::min(k, heap.size());
+        std::partial_sort(heap.begin(), heap.begin() + found, heap.end());
+
+        for (size_t j = 0; j < k; ++j)
+        {
+          if (j < found)
+          {
+            neighbors(j, i) = heap[j].second;
+            distances(j, i) = heap[j].first;
+          }
+          else
+          {
+            neighbors(j, i) = indices.n_elem;
+            distances(j, i) = DBL_MAX;
+          }
+        }
+      }
+    }
+  }
+}
+
+template<typename KMeansType>
+template<typename Archive>
+void IVFSearch<KMeansType>::serialize(Archive& ar,
+                                      const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(centroids);
+  ar & BOOST_SERIALIZATION_NVP(centroidNorms);
+  ar & BOOST_SERIALIZATION_NVP(listOffsets);
+  ar & BOOST_SERIALIZATION_NVP(indices);
+  ar & BOOST_SERIALIZATION_NVP(points);
+  ar & BOOST_SERIALIZATION_NVP(pointNorms);
+  ar & BOOST_SERIALIZATION_NVP(residuals);
+  ar & BOOST_SERIALIZATION_NVP(nProbe);
+  ar & BOOST_SERIALIZATION_NVP(quantized);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
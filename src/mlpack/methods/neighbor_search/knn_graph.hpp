@@ -0,0 +1,182 @@
+/**
+ * @file knn_graph.hpp
+ *
+ * Definition of the KNNGraph class, which builds an approximate
+ * k-nearest-neighbor graph of a dataset with NN-Descent.
+ *
+ * For more information on the algorithm, see the following paper:
+ *
+ * @code
+ * @inproceedings{dong2011efficient,
+ *   title={Efficient k-nearest neighbor graph construction for generic
+ *       similarity measures},
+ *   author={Dong, Wei and Charikar, Moses and Li, Kai},
+ *   booktitle={Proceedings of the 20th International Conference on World Wide
+ *       Web},
+ *   pages={577--586},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_KNN_GRAPH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_KNN_GRAPH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <mutex>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * KNNGraph computes the approximate k nearest neighbors of every point of a
+ * dataset (the k-nearest-neighbor graph) with NN-Descent.  Each point starts
+ * with k random neighbors, and each iteration compares the neighbors of each
+ * point with each other (a "local join"): a neighbor of a neighbor is likely to
+ * be a neighbor.  Only pairs involving a neighbor that is new since the last
+ * iteration are compared, a fraction of the new neighbors given by the sample
+ * rate is used each time, and the iterations stop when fewer than delta * k
+ * neighbors per point were changed by the last one.
+ *
+ * The output is the same as that of NeighborSearch::Search(k, neighbors,
+ * distances): each point is not its own neighbor, and the neighbors of each
+ * point are sorted by increasing distance.  The local joins are run in
+ * parallel with OpenMP; each neighbor list is locked while it is updated, so
+ * the results may differ slightly from run to run.
+ *
+ * @code
+ * KNNGraph<> graph;
+ * graph.Build(dataset, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MetricType The metric to use.
+ * @tparam MatType The type of the data matrix.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class KNNGraph
+{
+ public:
+  /**
+   * Create the KNNGraph object.
+   *
+   * @param maxIterations Maximum number of iterations (0 means no limit).
+   * @param sampleRate Fraction of the new neighbors of each point that take
+   *     part in each local join, in (0, 1].
+   * @param delta The iterations stop when fewer than delta * k neighbors per
+   *     point were changed by the last one.
+   * @param metric An optional instantiated metric.
+   */
+  KNNGraph(const size_t maxIterations = 30,
+           const double sampleRate = 0.5,
+           const double delta = 0.001,
+           const MetricType metric = MetricType());
+
+  /**
+   * Compute the approximate k nearest neighbors of each point in the dataset.
+   * A std::invalid_argument is thrown if k is not smaller than the number of
+   * points.
+   *
+   * @param dataset Dataset to build the graph of.
+   * @param k Number of neighbors of each point.
+   * @param neighbors Matrix to store the neighbors of each point in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Build(const MatType& dataset,
+             const size_t k,
+             arma::Mat<size_t>& neighbors,
+             arma::mat& distances);
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the sample rate.
+  double SampleRate() const { return sampleRate; }
+  //! Modify the sample rate.
+  double& SampleRate() { return sampleRate; }
+
+  //! Get the termination threshold.
+  double Delta() const { return delta; }
+  //! Modify the termination threshold.
+  double& Delta() { return delta; }
+
+  //! Get the number of iterations of the last call to Build().
+  size_t Iterations() const { return iterations; }
+  //! Get the number of distance evaluations of the last call to Build().
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  //! A neighbor in a neighbor list.
+  struct Neighbor
+  {
+    //! The distance to the neighbor.
+    double distance;
+    //! The index of the neighbor.
+    size_t index;
+    //! Whether the neighbor has not yet taken part in a local join.
+    bool isNew;
+
+    //! Neighbors are ordered by distance, and then by index.
+    bool operator<(const Neighbor& other) const
+    {
+      return (distance < other.distance) ||
+          (distance == other.distance && index < other.index);
+    }
+  };
+
+  /**
+   * Try to add the given neighbor to the neighbor list of the given point,
+   * which is a max-heap.  Return whether the list changed.
+   */
+  static bool Update(std::vector<Neighbor>& list, const Neighbor& neighbor);
+
+  /**
+   * Compare the given points, and try to add each to the neighbor list of the
+   * other.  Return the number of lists that changed.
+   */
+  size_t Join(const MatType& dataset,
+              const size_t a,
+              const size_t b,
+              std::vector<std::vector<Neighbor>>& lists,
+              std::mutex* locks);
+
+  //! Keep a random sample of the given number of elements of the list.
+  static void Sample(std::vector<size_t>& list,
+                     const size_t size,
+                     math::Philox& generator);
+
+  //! The maximum number of iterations.
+  size_t maxIterations;
+  //! The fraction of the new neighbors that take part in each local join.
+  double sampleRate;
+  //! The termination threshold.
+  double delta;
+  //! The number of iterations of the last call to Build().
+  size_t iterations;
+  //! The number of distance evaluations of the last call to Build().
+  size_t distanceEvaluations;
+  //! The instantiated metric.
+  MetricType metric;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "knn_graph_impl.hpp"
+
+#endif
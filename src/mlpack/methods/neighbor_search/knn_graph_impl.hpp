@@ -0,0 +1,293 @@
+/**
+ * @file knn_graph_impl.hpp
+ *
+ * Implementation of the KNNGraph class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_KNN_GRAPH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_KNN_GRAPH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "knn_graph.hpp"
+
+#include <memory>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+KNNGraph<MetricType, MatType>::KNNGraph(const size_t maxIterations,
+                                        const double sampleRate,
+                                        const double delta,
+                                        const MetricType metric) :
+    maxIterations(maxIterations),
+    sampleRate(sampleRate),
+    delta(delta),
+    iterations(0),
+    distanceEvaluations(0),
+    metric(metric)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename MatType>
+void KNNGraph<MetricType, MatType>::Build(const MatType& dataset,
+                                          const size_t k,
+                                          arma::Mat<size_t>& neighbors,
+                                          arma::mat& distances)
+{
+  const size_t n = dataset.n_cols;
+  if (k >= n)
+  {
+    std::ostringstream oss;
+    oss << "KNNGraph::Build(): requested " << k << " neighbors, but the "
+        << "dataset has " << n << " points (and each point is not its own "
+        << "neighbor)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (sampleRate <= 0.0 || sampleRate > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "KNNGraph::Build(): the sample rate (" << sampleRate << ") must be "
+        << "in (0, 1]!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  iterations = 0;
+  neighbors.set_size(k, n);
+  distances.set_size(k, n);
+  if (k == 0)
+  {
+    distanceEvaluations = 0;
+    return;
+  }
+
+  // The neighbor list of each point is a max-heap, so its front is its worst
+  // neighbor.
+  std::vector<std::vector<Neighbor>> lists(n);
+  std::unique_ptr<std::mutex[]> locks(new std::mutex[n]);
+  size_t evaluations = 0;
+
+  // Each point starts with k distinct random neighbors.  The random numbers of
+  // each point come from their own stream, so they don't depend on the number
+  // of threads.
+  const uint64_t initialKey = math::RandKey();
+  #pragma omp parallel for schedule(static) reduction(+:evaluations)
+  for (omp_size_t v = 0; v < (omp_size_t) n; ++v)
+  {
+    math::Philox generator(initialKey, v);
+    std::uniform_int_distribution<size_t> distribution(0, n - 2);
+    lists[v].reserve(k);
+    while (lists[v].size() < k)
+    {
+      size_t u = distribution(generator);
+      if (u >= (size_t) v)
+        ++u; // Skip the point itself.
+
+      bool duplicate = false;
+      for (size_t j = 0; j < lists[v].size(); ++j)
+        duplicate |= (lists[v][j].index == u);
+      if (duplicate)
+        continue;
+
+      Neighbor neighbor;
+      neighbor.distance = metric.Evaluate(dataset.col(v), dataset.col(u));
+      neighbor.index = u;
+      neighbor.isNew = true;
+      lists[v].push_back(neighbor);
+      ++evaluations;
+    }
+
+    std::make_heap(lists[v].begin(), lists[v].end());
+  }
+
+  const size_t sampleSize = std::max((size_t) std::ceil(sampleRate * k),
+      (size_t) 1);
+  std::vector<std::vector<size_t>> newNeighbors(n), oldNeighbors(n);
+  std::vector<std::vector<size_t>> newReverse(n), oldReverse(n);
+
+  while (maxIterations == 0 || iterations < maxIterations)
+  {
+    ++iterations;
+    const uint64_t key = math::RandKey();
+
+    // Collect the neighbors of each point that take part in the join: its old
+    // neighbors, and a sample of its new neighbors, which become old.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t v = 0; v < (omp_size_t) n; ++v)
+    {
+      std::vector<size_t> newPositions;
+      oldNeighbors[v].clear();
+      for (size_t j = 0; j < lists[v].size(); ++j)
+      {
+        if (lists[v][j].isNew)
+          newPositions.push_back(j);
+        else
+          oldNeighbors[v].push_back(lists[v][j].index);
+      }
+
+      math::Philox generator(key, 2 * v);
+      Sample(newPositions, sampleSize, generator);
+
+      newNeighbors[v].clear();
+      for (size_t j = 0; j < newPositions.size(); ++j)
+      {
+        newNeighbors[v].push_back(lists[v][newPositions[j]].index);
+        lists[v][newPositions[j]].isNew = false;
+      }
+    }
+
+    // Each point is also joined with a sample of the points it is a neighbor
+    // of.
+    for (size_t v = 0; v < n; ++v)
+    {
+      newReverse[v].clear();
+      oldReverse[v].clear();
+    }
+    for (size_t v = 0; v < n; ++v)
+    {
+      for (size_t j = 0; j < newNeighbors[v].size(); ++j)
+        newReverse[newNeighbors[v][j]].push_back(v);
+      for (size_t j = 0; j < oldNeighbors[v].size(); ++j)
+        oldReverse[oldNeighbors[v][j]].push_back(v);
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t v = 0; v < (omp_size_t) n; ++v)
+    {
+      math::Philox generator(key, 2 * v + 1);
+      Sample(newReverse[v], sampleSize, generator);
+      Sample(oldReverse[v], sampleSize, generator);
+
+      newNeighbors[v].insert(newNeighbors[v].end(), newReverse[v].begin(),
+          newReverse[v].end());
+      std::sort(newNeighbors[v].begin(), newNeighbors[v].end());
+      newNeighbors[v].erase(std::unique(newNeighbors[v].begin(),
+          newNeighbors[v].end()), newNeighbors[v].end());
+
+      oldNeighbors[v].insert(oldNeighbors[v].end(), oldReverse[v].begin(),
+          oldReverse[v].end());
+      std::sort(oldNeighbors[v].begin(), oldNeighbors[v].end());
+      oldNeighbors[v].erase(std::unique(oldNeighbors[v].begin(),
+          oldNeighbors[v].end()), oldNeighbors[v].end());
+    }
+
+    // The local joins: compare the new neighbors of each point with each other
+    // and with its old neighbors.  Pairs of old neighbors have already been
+    // compared.
+    size_t updates = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:updates, evaluations)
+    for (omp_size_t v = 0; v < (omp_size_t) n; ++v)
+    {
+      const std::vector<size_t>& newList = newNeighbors[v];
+      const std::vector<size_t>& oldList = oldNeighbors[v];
+      for (size_t i = 0; i < newList.size(); ++i)
+      {
+        for (size_t j = i + 1; j < newList.size(); ++j)
+        {
+          updates += Join(dataset, newList[i], newList[j], lists, locks.get());
+          ++evaluations;
+        }
+
+        for (size_t j = 0; j < oldList.size(); ++j)
+        {
+          if (oldList[j] == newList[i])
+            continue;
+
+          updates += Join(dataset, newList[i], oldList[j], lists, locks.get());
+          ++evaluations;
+        }
+      }
+    }
+
+    Log::Info << "KNNGraph::Build(): iteration " << iterations << ", "
+        << updates << " neighbors updated." << std::endl;
+
+    if (updates < delta * n * k)
+      break;
+  }
+
+  distanceEvaluations = evaluations;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t v = 0; v < (omp_size_t) n; ++v)
+  {
+    std::sort_heap(lists[v].begin(), lists[v].end());
+    for (size_t j = 0; j < k; ++j)
+    {
+      neighbors(j, v) = lists[v][j].index;
+      distances(j, v) = lists[v][j].distance;
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+bool KNNGraph<MetricType, MatType>::Update(std::vector<Neighbor>& list,
+                                           const Neighbor& neighbor)
+{
+  if (!(neighbor < list.front()))
+    return false;
+
+  for (size_t j = 0; j < list.size(); ++j)
+    if (list[j].index == neighbor.index)
+      return false;
+
+  std::pop_heap(list.begin(), list.end());
+  list.back() = neighbor;
+  std::push_heap(list.begin(), list.end());
+  return true;
+}
+
+template<typename MetricType, typename MatType>
+size_t KNNGraph<MetricType, MatType>::Join(
+    const MatType& dataset,
+    const size_t a,
+    const size_t b,
+    std::vector<std::vector<Neighbor>>& lists,
+    std::mutex* locks)
+{
+  Neighbor neighbor;
+  neighbor.distance = metric.Evaluate(dataset.col(a), dataset.col(b));
+  neighbor.isNew = true;
+
+  size_t updates = 0;
+  {
+    neighbor.index = b;
+    std::lock_guard<std::mutex> lock(locks[a]);
+    updates += Update(lists[a], neighbor);
+  }
+  {
+    neighbor.index = a;
+    std::lock_guard<std::mutex> lock(locks[b]);
+    updates += Update(lists[b], neighbor);
+  }
+
+  return updates;
+}
+
+template<typename MetricType, typename MatType>
+void KNNGraph<MetricType, MatType>::Sample(std::vector<size_t>& list,
+                                           const size_t size,
+                                           math::Philox& generator)
+{
+  if (list.size() <= size)
+    return;
+
+  // A partial Fisher-Yates shuffle.
+  for (size_t i = 0; i < size; ++i)
+  {
+    std::uniform_int_distribution<size_t> distribution(i, list.size() - 1);
+    std::swap(list[i], list[distribution(generator)]);
+  }
+  list.resize(size);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
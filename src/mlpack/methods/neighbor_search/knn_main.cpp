@@ -15,6 +15,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/util/serve_queries.hpp>
 
 #include <string>
 #include <fstream>
@@ -23,6 +24,7 @@
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
 #include "ns_model.hpp"
+#include "ns_model_tuner.hpp"
 
 using namespace std;
 using namespace mlpack;
@@ -53,7 +55,27 @@ PROGRAM_INFO("k-Nearest-Neighbors Search",
     "neighbors output matrix corresponds to the index of the point in the "
     "reference set which is the j'th nearest neighbor from the point in the "
     "query set with index i.  Row j and column i in the distances output matrix"
-    " corresponds to the distance between those two points.");
+    " corresponds to the distance between those two points."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("server") + " is specified, the model is kept "
+    "in memory and batches of query points are read from standard input, one "
+    "point per line with values separated by commas or spaces; an empty line "
+    "ends a batch.  For each batch, one line is written to standard output for "
+    "each query point, holding the " + PRINT_PARAM_STRING("k") + " neighbor "
+    "indices followed by the " + PRINT_PARAM_STRING("k") + " distances, and an "
+    "empty line ends the answer.  This continues until standard input is "
+    "closed, so the cost of loading or building the model is paid only once.  "
+    "Since informational messages are also written to standard output, " +
+    PRINT_PARAM_STRING("verbose") + " should not be combined with " +
+    PRINT_PARAM_STRING("server") + "."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("auto") + " is specified, the tree type, leaf "
+    "size and search algorithm are chosen automatically: the intrinsic "
+    "dimension of the reference set is estimated, and short trials of the "
+    "candidate configurations are timed on a subsample of the reference set.  "
+    "The fastest configuration is used and stored in the output model.  The "
+    "number of reference points used for the trials can be set with " +
+    PRINT_PARAM_STRING("auto_sample_size") + ".");
 
 // Define our input parameters that this program will take.
 PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
@@ -89,6 +111,12 @@ PARAM_DOUBLE_IN("tau", "Overlapping size (only valid for spill trees).", "u",
 PARAM_DOUBLE_IN("rho", "Balance threshold (only valid for spill trees).", "b",
     0.7);
 
+PARAM_FLAG("auto", "If set, choose the tree type, leaf size and search "
+    "algorithm automatically by timing trials on a subsample of the reference "
+    "set.", "");
+PARAM_INT_IN("auto_sample_size", "Maximum number of reference points used for "
+    "the trials of --auto.", "", 5000);
+
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
@@ -98,6 +126,13 @@ PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
     "'dual_tree', 'greedy'.", "a", "dual_tree");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
+PARAM_DOUBLE_IN("max_time_us", "If specified, the search of each query set "
+    "stops after this many microseconds and returns the best neighbors found "
+    "so far (0 means no limit).  This implies single-tree search.", "", 0);
+
+// Server mode.
+PARAM_FLAG("server", "If set, keep the model in memory and answer batches of "
+    "query points read from standard input until it is closed.", "");
 
 static void mlpackMain()
 {
@@ -113,6 +148,18 @@ static void mlpackMain()
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
   ReportIgnoredParam({{ "input_model", true }}, "tau");
   ReportIgnoredParam({{ "input_model", true }}, "rho");
+  ReportIgnoredParam({{ "input_model", true }}, "auto");
+  ReportIgnoredParam({{ "auto", false }}, "auto_sample_size");
+  if (CLI::HasParam("auto"))
+  {
+    ReportIgnoredParam("tree_type", "the tree type is chosen automatically");
+    ReportIgnoredParam("leaf_size", "the leaf size is chosen automatically");
+    if (CLI::GetParam<double>("max_time_us") == 0)
+    {
+      ReportIgnoredParam("algorithm", "the search algorithm is chosen "
+          "automatically");
+    }
+  }
   if (CLI::HasParam("input_model") && CLI::HasParam("leaf_size"))
   {
     Log::Warn << PRINT_PARAM_STRING("leaf_size") << " will only be considered"
@@ -120,12 +167,20 @@ static void mlpackMain()
         << endl;
   }
 
+  // In server mode, the number of neighbors must be known.
+  const bool server = CLI::HasParam("server");
+  if (server)
+  {
+    RequireAtLeastOnePassed({ "k" }, true, "the number of neighbors must be "
+        "given in server mode");
+  }
+
   // The user should give something to do...
   RequireAtLeastOnePassed({ "k", "output_model" }, false,
       "no results will be saved");
 
   // If the user specifies k but no output files, they should be warned.
-  if (CLI::HasParam("k"))
+  if (CLI::HasParam("k") && !server)
   {
     RequireAtLeastOnePassed({ "neighbors", "distances" }, false,
         "nearest neighbor search results will not be saved");
@@ -165,6 +220,11 @@ static void mlpackMain()
   RequireParamValue<double>("epsilon", [](double x) { return x >= 0.0; }, true,
       "epsilon must be positive");
 
+  // Sanity check on the time budget.
+  const double maxTime = CLI::GetParam<double>("max_time_us");
+  RequireParamValue<double>("max_time_us", [](double x) { return x >= 0.0; },
+      true, "max_time_us must be positive");
+
   // We either have to load the reference data, or we have to load the model.
   KNNModel* knn;
 
@@ -182,6 +242,16 @@ static void mlpackMain()
   else if (algorithm == "greedy")
     searchMode = GREEDY_SINGLE_TREE_MODE;
 
+  // Only the single-tree search can be stopped early.
+  if (maxTime != 0 && searchMode != SINGLE_TREE_MODE)
+  {
+    if (CLI::HasParam("algorithm"))
+      Log::Warn << PRINT_PARAM_STRING("max_time_us") << " is specified, so "
+          << "single-tree search is used instead of '" << algorithm << "'."
+          << endl;
+    searchMode = SINGLE_TREE_MODE;
+  }
+
   if (CLI::HasParam("reference"))
   {
     knn = new KNNModel();
@@ -238,8 +308,43 @@ static void mlpackMain()
         << referenceSet.n_rows << " x " << referenceSet.n_cols << ")."
         << endl;
 
-    knn->BuildModel(std::move(referenceSet), size_t(lsInt), searchMode,
-        epsilon);
+    size_t leafSize = size_t(lsInt);
+    if (CLI::HasParam("auto") && referenceSet.n_cols > 1)
+    {
+      RequireParamValue<int>("auto_sample_size", [](int x) { return x > 1; },
+          true, "the sample size must be greater than 1");
+
+      // Time the trials for the requested number of neighbors, if it is
+      // valid.
+      size_t trialK = 1;
+      if (CLI::HasParam("k") && CLI::GetParam<int>("k") > 0)
+      {
+        trialK = std::min((size_t) CLI::GetParam<int>("k"),
+            (size_t) referenceSet.n_cols - 1);
+      }
+
+      Timer::Start("auto_tuning");
+      NSModelTuner<NearestNeighborSort> tuner(
+          (size_t) CLI::GetParam<int>("auto_sample_size"));
+      const NSModelTuner<NearestNeighborSort>::Trial& best =
+          tuner.Tune(referenceSet, trialK);
+      Timer::Stop("auto_tuning");
+
+      knn->TreeType() = best.treeType;
+      leafSize = best.leafSize;
+      knn->LeafSize() = leafSize;
+      // Only the single-tree search can be stopped early.
+      if (maxTime == 0)
+        searchMode = best.searchMode;
+
+      Log::Info << "Selected " << knn->TreeName() << " with leaf size "
+          << leafSize << " and " << (searchMode == NAIVE_MODE ? "naive" :
+          searchMode == SINGLE_TREE_MODE ? "single-tree" : "dual-tree")
+          << " search, out of " << tuner.Trials().size() << " trials." << endl;
+    }
+
+    knn->BuildModel(std::move(referenceSet), leafSize, searchMode, epsilon);
+    knn->MaxTime() = maxTime;
   }
   else
   {
@@ -249,6 +354,7 @@ static void mlpackMain()
     // Adjust search mode.
     knn->SearchMode() = searchMode;
     knn->Epsilon() = epsilon;
+    knn->MaxTime() = maxTime;
 
     // If leaf_size wasn't provided, let's consider the current value in the
     // loaded model.  Else, update it (only considered when building the query
@@ -262,8 +368,9 @@ static void mlpackMain()
         << " dataset)." << endl;
   }
 
-  // Perform search, if desired.
-  if (CLI::HasParam("k"))
+  // Perform search, if desired.  In server mode, only a given query set is
+  // searched before serving.
+  if (CLI::HasParam("k") && (!server || CLI::HasParam("query")))
   {
     const size_t k = (size_t) CLI::GetParam<int>("k");
 
@@ -304,6 +411,11 @@ static void mlpackMain()
     else
       knn->Search(k, neighbors, distances);
     Log::Info << "Search complete." << endl;
+    if (maxTime != 0)
+    {
+      Log::Info << "Achieved epsilon: " << knn->AchievedEpsilon() << "."
+          << endl;
+    }
 
     // Save output.
     CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
@@ -312,7 +424,8 @@ static void mlpackMain()
     // Calculate the effective error, if desired.
     if (CLI::HasParam("true_distances"))
     {
-      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0)
+      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0 &&
+          maxTime == 0)
         Log::Warn << PRINT_PARAM_STRING("true_distances") << "specified, but "
             << "the search is exact, so there is no need to calculate the "
             << "error!" << endl;
@@ -332,7 +445,8 @@ static void mlpackMain()
     // Calculate the recall, if desired.
     if (CLI::HasParam("true_neighbors"))
     {
-      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0)
+      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0 &&
+          maxTime == 0)
         Log::Warn << PRINT_PARAM_STRING("true_neighbors") << " specified, but "
             << " the search is exact, so there is no need to calculate the "
             << "recall!" << endl;
@@ -349,5 +463,23 @@ static void mlpackMain()
     }
   }
 
+  // Answer queries from standard input, if desired.
+  if (server)
+  {
+    const size_t k = (size_t) CLI::GetParam<int>("k");
+    Log::Info << "Serving " << k << "-nearest-neighbor queries from standard "
+        << "input." << endl;
+
+    const size_t numBatches = ServeQueries(std::cin, std::cout,
+        knn->Dataset().n_rows, [&](const arma::mat& queries,
+                                   arma::Mat<size_t>& neighbors,
+                                   arma::mat& distances)
+    {
+      knn->Search(arma::mat(queries), k, neighbors, distances);
+    });
+
+    Log::Info << "Answered " << numBatches << " query batches." << endl;
+  }
+
   CLI::GetParam<KNNModel*>("output_model") = knn;
 }
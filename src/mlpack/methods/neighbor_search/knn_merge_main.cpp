@@ -0,0 +1,144 @@
+/**
+ * @file knn_merge_main.cpp
+ *
+ * Executable to merge the results of neighbor searches on different shards of
+ * a reference set.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "sharded_neighbor_search.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("k-Nearest-Neighbors Merge",
+    "This program merges the results of two k-nearest-neighbor searches of the "
+    "same query points on different shards of a reference set, as computed by "
+    "the knn program, into the k nearest neighbors in the union of the shards. "
+    " This allows a reference set that does not fit on one machine to be split "
+    "into shards, each searched on its own machine; the results of all the "
+    "shards are then merged, pairwise, in any order."
+    "\n\n"
+    "The indices of the neighbors given with " +
+    PRINT_PARAM_STRING("neighbors") + " and " +
+    PRINT_PARAM_STRING("other_neighbors") + " are increased by " +
+    PRINT_PARAM_STRING("offset") + " and " +
+    PRINT_PARAM_STRING("other_offset") + " respectively, so that the indices "
+    "of each shard can be turned into indices in the whole reference set.  The "
+    + PRINT_PARAM_STRING("k") + " best neighbors are kept (by default, as many "
+    "as in " + PRINT_PARAM_STRING("neighbors") + ").  If " +
+    PRINT_PARAM_STRING("furthest") + " is specified, the results are furthest "
+    "neighbor results, as computed by the kfn program."
+    "\n\n"
+    "For example, if the reference set has been split into two shards of "
+    "1000000 points, whose results are " + PRINT_DATASET("n1") + " and " +
+    PRINT_DATASET("d1") + ", and " + PRINT_DATASET("n2") + " and " +
+    PRINT_DATASET("d2") + ", the following will merge them into " +
+    PRINT_DATASET("neighbors") + " and " + PRINT_DATASET("distances") + ":"
+    "\n\n" +
+    PRINT_CALL("knn_merge", "neighbors", "n1", "distances", "d1",
+        "other_neighbors", "n2", "other_distances", "d2", "other_offset",
+        1000000, "output_neighbors", "neighbors", "output_distances",
+        "distances"));
+
+// Input results.
+PARAM_UMATRIX_IN_REQ("neighbors", "Matrix of neighbors of the first results.",
+    "n");
+PARAM_MATRIX_IN_REQ("distances", "Matrix of distances of the first results.",
+    "d");
+PARAM_INT_IN("offset", "Offset added to the indices of the first results.",
+    "o", 0);
+PARAM_UMATRIX_IN_REQ("other_neighbors", "Matrix of neighbors of the second "
+    "results.", "N");
+PARAM_MATRIX_IN_REQ("other_distances", "Matrix of distances of the second "
+    "results.", "D");
+PARAM_INT_IN("other_offset", "Offset added to the indices of the second "
+    "results.", "O", 0);
+
+PARAM_INT_IN("k", "Number of neighbors to keep (0 indicates the number of "
+    "neighbors of the first results).", "k", 0);
+PARAM_FLAG("furthest", "If set, the results are furthest neighbor results.",
+    "F");
+
+// Output results.
+PARAM_UMATRIX_OUT("output_neighbors", "Matrix to output the merged neighbors "
+    "into.", "a");
+PARAM_MATRIX_OUT("output_distances", "Matrix to output the merged distances "
+    "into.", "e");
+
+static void mlpackMain()
+{
+  RequireAtLeastOnePassed({ "output_neighbors", "output_distances" }, false,
+      "no results will be saved");
+
+  RequireParamValue<int>("offset", [](int x) { return x >= 0; }, true,
+      "offset must be non-negative");
+  RequireParamValue<int>("other_offset", [](int x) { return x >= 0; }, true,
+      "offset must be non-negative");
+  RequireParamValue<int>("k", [](int x) { return x >= 0; }, true,
+      "k must be non-negative");
+
+  const arma::Mat<size_t>& neighbors =
+      CLI::GetParam<arma::Mat<size_t>>("neighbors");
+  const arma::mat& distances = CLI::GetParam<arma::mat>("distances");
+  const arma::Mat<size_t>& otherNeighbors =
+      CLI::GetParam<arma::Mat<size_t>>("other_neighbors");
+  const arma::mat& otherDistances =
+      CLI::GetParam<arma::mat>("other_distances");
+
+  if (neighbors.n_rows != distances.n_rows ||
+      neighbors.n_cols != distances.n_cols)
+  {
+    Log::Fatal << PRINT_PARAM_STRING("neighbors") << " and "
+        << PRINT_PARAM_STRING("distances") << " must have the same size!"
+        << endl;
+  }
+
+  if (otherNeighbors.n_rows != otherDistances.n_rows ||
+      otherNeighbors.n_cols != otherDistances.n_cols)
+  {
+    Log::Fatal << PRINT_PARAM_STRING("other_neighbors") << " and "
+        << PRINT_PARAM_STRING("other_distances") << " must have the same size!"
+        << endl;
+  }
+
+  if (neighbors.n_cols != otherNeighbors.n_cols)
+  {
+    Log::Fatal << "The results have different numbers of query points ("
+        << neighbors.n_cols << " and " << otherNeighbors.n_cols << ")!" << endl;
+  }
+
+  const size_t k = (CLI::GetParam<int>("k") == 0) ? neighbors.n_rows :
+      (size_t) CLI::GetParam<int>("k");
+  const size_t offset = (size_t) CLI::GetParam<int>("offset");
+  const size_t otherOffset = (size_t) CLI::GetParam<int>("other_offset");
+
+  arma::Mat<size_t> mergedNeighbors;
+  arma::mat mergedDistances;
+  if (CLI::HasParam("furthest"))
+  {
+    ShardedNeighborSearch<FurthestNeighborSort>::Merge(neighbors, distances,
+        offset, otherNeighbors, otherDistances, otherOffset, k,
+        mergedNeighbors, mergedDistances);
+  }
+  else
+  {
+    ShardedNeighborSearch<NearestNeighborSort>::Merge(neighbors, distances,
+        offset, otherNeighbors, otherDistances, otherOffset, k,
+        mergedNeighbors, mergedDistances);
+  }
+
+  CLI::GetParam<arma::Mat<size_t>>("output_neighbors") =
+      std::move(mergedNeighbors);
+  CLI::GetParam<arma::mat>("output_distances") = std::move(mergedDistances);
+}
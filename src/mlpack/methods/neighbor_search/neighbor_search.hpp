@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 #include <vector>
 #include <string>
 
@@ -24,15 +25,39 @@
 #include "neighbor_search_stat.hpp"
 #include "sort_policies/nearest_neighbor_sort.hpp"
 #include "neighbor_search_rules.hpp"
+#include "candidate_list.hpp"
 
 namespace mlpack {
 // Neighbor-search routines. These include all-nearest-neighbors and
 // all-furthest-neighbors searches.
 namespace neighbor  {
 
-// Forward declaration.
+// Forward declarations.
 template<typename SortPolicy>
 class TrainVisitor;
+template<typename SortPolicy>
+class InsertVisitor;
+template<typename SortPolicy>
+class RemoveVisitor;
+
+HAS_MEM_FUNC(InsertPoint, HasInsertPointCheck);
+HAS_MEM_FUNC(DeletePoint, HasDeletePointCheck);
+
+/**
+ * SupportsIncrementalUpdates<TreeType>::value is true if points can be inserted
+ * into and deleted from a tree of type TreeType without rebuilding it (this is
+ * the case for the RectangleTree family).  That requires InsertPoint() and
+ * DeletePoint() methods that take the index of a point in the dataset, and a
+ * tree that does not rearrange its dataset.
+ */
+template<typename TreeType>
+struct SupportsIncrementalUpdates
+{
+  static const bool value =
+      !tree::TreeTraits<TreeType>::RearrangesDataset &&
+      HasInsertPointCheck<TreeType, void(TreeType::*)(const size_t)>::value &&
+      HasDeletePointCheck<TreeType, bool(TreeType::*)(const size_t)>::value;
+};
 
 //! NeighborSearchMode represents the different neighbor search modes available.
 enum NeighborSearchMode
@@ -224,6 +249,30 @@ class NeighborSearch
    */
   void Train(Tree&& referenceTree);
 
+  /**
+   * Add the given points to the reference set.  The new points get the indices
+   * ReferenceSet().n_cols to ReferenceSet().n_cols + points.n_cols - 1 (in the
+   * original order of the reference set).  If the tree supports incremental
+   * updates (see SupportsIncrementalUpdates), the points are inserted into the
+   * existing tree; otherwise, the tree is rebuilt on the new reference set.
+   *
+   * @param points Points to add to the reference set.
+   */
+  void Insert(const MatType& points);
+
+  /**
+   * Remove the point with the given index from the reference set.  To keep the
+   * indices of the reference set contiguous, the last point of the reference
+   * set takes the index of the removed point, and the indices of all other
+   * points are unchanged.  If the tree supports incremental updates (see
+   * SupportsIncrementalUpdates), the existing tree is updated; otherwise, the
+   * tree is rebuilt on the new reference set.
+   *
+   * @param index Index of the point to remove, in the original order of the
+   *     reference set.
+   */
+  void Remove(const size_t index);
+
   /**
    * For each point in the query set, compute the nearest neighbors and store
    * the output in the given matrices.  The matrices will be set to the size of
@@ -339,6 +388,39 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
+  //! Get the maximum number of base cases of a single-tree search (0 indicates
+  //! no limit).
+  size_t MaxBaseCases() const { return maxBaseCases; }
+  //! Modify the maximum number of base cases of a single-tree search (0
+  //! indicates no limit).  When a limit is set, single-tree search becomes an
+  //! anytime search; see MaxTime().
+  size_t& MaxBaseCases() { return maxBaseCases; }
+
+  //! Get the maximum time of a single-tree search, in microseconds (0
+  //! indicates no limit).
+  double MaxTime() const { return maxTime; }
+  /**
+   * Modify the maximum time of a single-tree search, in microseconds (0
+   * indicates no limit).  When this or MaxBaseCases() is set, single-tree
+   * search visits the reference tree best node first for each query point, and
+   * stops when the budget is spent; the budget is shared evenly among the
+   * query points, and whatever a query point does not use is left to the next
+   * ones.  The best neighbors found so far are returned, and AchievedEpsilon()
+   * gives the relative error they are guaranteed to be within.
+   */
+  double& MaxTime() { return maxTime; }
+
+  /**
+   * Get a bound on the relative error of the results of the last search, in
+   * the same sense as Epsilon(): for nearest neighbor search, each returned
+   * distance is at most (1 + AchievedEpsilon()) times the true one.  This is
+   * 0 for naive search, Epsilon() for complete tree searches, larger for
+   * single-tree searches that ran out of budget, and DBL_MAX when nothing is
+   * known (for greedy search, or when the budget ran out before a query point
+   * had k candidates).
+   */
+  double AchievedEpsilon() const { return achievedEpsilon; }
+
   //! Access the reference dataset.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
@@ -368,6 +450,12 @@ class NeighborSearch
   NeighborSearchMode searchMode;
   //! Indicates the relative error to be considered in approximate search.
   double epsilon;
+  //! The maximum number of base cases of a single-tree search.
+  size_t maxBaseCases;
+  //! The maximum time of a single-tree search, in microseconds.
+  double maxTime;
+  //! The bound on the relative error of the results of the last search.
+  double achievedEpsilon;
 
   //! Instantiation of metric.
   MetricType metric;
@@ -381,9 +469,133 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  /**
+   * Perform a dual-tree search of the given query tree against the reference
+   * tree with the given rules, spreading the traversal over all available
+   * threads.  The results are stored in neighbors and distances, which must
+   * already have the right size, and the numbers of base cases and scores are
+   * added to baseCases and scores.
+   *
+   * @param queryTree Query tree to search with.
+   * @param rules Rules to use for the traversal; these are copied once per
+   *     thread.
+   * @param neighbors Matrix to store the neighbor indices in.
+   * @param distances Matrix to store the neighbor distances in.
+   */
+  template<typename RuleType>
+  void DualTreeSearch(Tree& queryTree,
+                      const RuleType& rules,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances);
+
+  //! Whether naive search can compute the distances with matrix products.
+  typedef std::integral_constant<bool,
+      (std::is_same<MetricType, metric::EuclideanDistance>::value ||
+       std::is_same<MetricType, metric::SquaredEuclideanDistance>::value) &&
+      std::is_same<MatType, arma::mat>::value> UseProducts;
+
+  /**
+   * Perform a naive search by computing the distances between blocks of query
+   * points and blocks of reference points with matrix products, as
+   * ||q - r||^2 = ||q||^2 + ||r||^2 - 2 q^T r, and selecting the k best
+   * neighbors of each query point in the same pass.  This is only possible
+   * for the Euclidean distances; otherwise false is returned and nothing is
+   * done.  The distances of the selected neighbors are recomputed exactly.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to find.
+   * @param sameSet Whether the query set is the reference set (then a point
+   *     is not its own neighbor).
+   * @param neighbors Matrix to store the neighbor indices in.
+   * @param distances Matrix to store the neighbor distances in.
+   */
+  bool ProductSearch(const MatType& querySet,
+                     const size_t k,
+                     const bool sameSet,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances,
+                     std::true_type /* useProducts */);
+
+  //! Naive search with matrix products isn't possible with this metric.
+  bool ProductSearch(const MatType& /* querySet */,
+                     const size_t /* k */,
+                     const bool /* sameSet */,
+                     arma::Mat<size_t>& /* neighbors */,
+                     arma::mat& /* distances */,
+                     std::false_type /* useProducts */)
+  {
+    return false;
+  }
+
+  /**
+   * Gather the results of a parallel single-tree traversal of the given number
+   * of query points from the rules of each thread.  The results are stored in
+   * neighbors and distances, which must already have the right size, and the
+   * numbers of base cases and scores are added to baseCases and scores.
+   *
+   * @param traverser Parallel single-tree traverser that was used.
+   * @param numQueries Number of query points.
+   * @param neighbors Matrix to store the neighbor indices in.
+   * @param distances Matrix to store the neighbor distances in.
+   */
+  template<typename ParallelTraverserType>
+  void CollectResults(ParallelTraverserType& traverser,
+                      const size_t numQueries,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances);
+
+  /**
+   * Traverse the reference tree for each query point with a best-first
+   * single-tree traversal that stops when the budget given by maxBaseCases and
+   * maxTime is spent.
+   *
+   * @param rules Rules to use for the traversal.
+   * @param numQueries Number of query points.
+   * @param remainingScores Will hold, for each query point, the best score of
+   *     the reference nodes that were not visited (DBL_MAX if none).
+   */
+  template<typename RuleType>
+  void BudgetedTraversal(RuleType& rules,
+                         const size_t numQueries,
+                         std::vector<double>& remainingScores);
+
+  /**
+   * Set achievedEpsilon for the given results of a budgeted traversal, with
+   * the best scores of the reference nodes the traversal did not visit.
+   */
+  void SetAchievedEpsilon(const arma::mat& distances,
+                          const std::vector<double>& remainingScores);
+
+  //! Return a copy of the reference set, in its original order.
+  MatType OriginalReferenceSet() const;
+
+  //! Insert the given points into the reference tree without rebuilding it.
+  template<typename TreeT = Tree>
+  typename std::enable_if<SupportsIncrementalUpdates<TreeT>::value, void>::type
+  InsertIntoTree(const MatType& points);
+
+  //! Insert the given points by rebuilding the reference tree.
+  template<typename TreeT = Tree>
+  typename std::enable_if<!SupportsIncrementalUpdates<TreeT>::value, void>::type
+  InsertIntoTree(const MatType& points);
+
+  //! Remove the given point from the reference tree without rebuilding it.
+  template<typename TreeT = Tree>
+  typename std::enable_if<SupportsIncrementalUpdates<TreeT>::value, void>::type
+  RemoveFromTree(const size_t index);
+
+  //! Remove the given point by rebuilding the reference tree.
+  template<typename TreeT = Tree>
+  typename std::enable_if<!SupportsIncrementalUpdates<TreeT>::value, void>::type
+  RemoveFromTree(const size_t index);
+
   //! The NSModel class should have access to internal members.
   template<typename SortPol>
   friend class TrainVisitor;
+  template<typename SortPol>
+  friend class InsertVisitor;
+  template<typename SortPol>
+  friend class RemoveVisitor;
 }; // class NeighborSearch
 
 } // namespace neighbor
@@ -395,4 +607,7 @@ class NeighborSearch
 // Include convenience typedefs.
 #include "typedef.hpp"
 
+// The common instantiations are compiled into libmlpack.
+#include "neighbor_search_instantiations.hpp"
+
 #endif
@@ -15,7 +15,11 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
+#include <mlpack/core/tree/priority_single_tree_traverser.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
+#include <mlpack/core/tree/parallel_single_tree_traverser.hpp>
 #include "neighbor_search_rules.hpp"
+#include <mlpack/core/tree/instrumented_rules.hpp>
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
 
 namespace mlpack {
@@ -67,6 +71,9 @@ SingleTreeTraversalType>::NeighborSearch(MatType referenceSetIn,
     setOwner(mode == NAIVE_MODE),
     searchMode(mode),
     epsilon(epsilon),
+    maxBaseCases(0),
+    maxTime(0),
+    achievedEpsilon(0),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -96,6 +103,9 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
     setOwner(false),
     searchMode(mode),
     epsilon(epsilon),
+    maxBaseCases(0),
+    maxTime(0),
+    achievedEpsilon(0),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -124,6 +134,9 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     setOwner(true),
     searchMode(mode),
     epsilon(epsilon),
+    maxBaseCases(0),
+    maxTime(0),
+    achievedEpsilon(0),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -159,6 +172,9 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     setOwner(!other.referenceTree),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
+    maxBaseCases(other.maxBaseCases),
+    maxTime(other.maxTime),
+    achievedEpsilon(other.achievedEpsilon),
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
@@ -185,6 +201,9 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     setOwner(other.setOwner),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
+    maxBaseCases(other.maxBaseCases),
+    maxTime(other.maxTime),
+    achievedEpsilon(other.achievedEpsilon),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
@@ -198,6 +217,9 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
   other.setOwner = true;
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
+  other.maxBaseCases = 0;
+  other.maxTime = 0;
+  other.achievedEpsilon = 0;
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
@@ -242,6 +264,9 @@ NeighborSearch<SortPolicy,
   setOwner = (other.referenceTree == NULL);
   searchMode = other.searchMode;
   epsilon = other.epsilon;
+  maxBaseCases = other.maxBaseCases;
+  maxTime = other.maxTime;
+  achievedEpsilon = other.achievedEpsilon;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
@@ -286,6 +311,9 @@ NeighborSearch<SortPolicy,
   setOwner = other.setOwner;
   searchMode = other.searchMode;
   epsilon = other.epsilon;
+  maxBaseCases = other.maxBaseCases;
+  maxTime = other.maxTime;
+  achievedEpsilon = other.achievedEpsilon;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
@@ -299,6 +327,9 @@ NeighborSearch<SortPolicy,
   other.setOwner = true;
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
+  other.maxBaseCases = 0;
+  other.maxTime = 0;
+  other.achievedEpsilon = 0;
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
@@ -461,6 +492,202 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree&& referenceTree)
   setOwner = false;
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Insert(const MatType& points)
+{
+  // With no reference points yet, there is nothing to update.
+  if (referenceSet->n_cols == 0)
+  {
+    Train(MatType(points));
+    return;
+  }
+
+  if (points.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "NeighborSearch::Insert(): dimensionality of points ("
+        << points.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << referenceSet->n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (searchMode == NAIVE_MODE)
+  {
+    MatType newReferenceSet = OriginalReferenceSet();
+    newReferenceSet.insert_cols(newReferenceSet.n_cols, points);
+    Train(std::move(newReferenceSet));
+    return;
+  }
+
+  InsertIntoTree(points);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Remove(const size_t index)
+{
+  if (index >= referenceSet->n_cols)
+  {
+    std::ostringstream oss;
+    oss << "NeighborSearch::Remove(): index " << index << " is out of range "
+        << "(the reference set has " << referenceSet->n_cols << " points)";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (searchMode == NAIVE_MODE)
+  {
+    MatType newReferenceSet = OriginalReferenceSet();
+    newReferenceSet.col(index) = newReferenceSet.col(newReferenceSet.n_cols - 1);
+    newReferenceSet.shed_col(newReferenceSet.n_cols - 1);
+    Train(std::move(newReferenceSet));
+    return;
+  }
+
+  RemoveFromTree(index);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+MatType NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::OriginalReferenceSet() const
+{
+  if (oldFromNewReferences.empty())
+    return *referenceSet;
+
+  // Undo the permutation made when the tree was built.
+  MatType originalSet(referenceSet->n_rows, referenceSet->n_cols);
+  for (size_t i = 0; i < referenceSet->n_cols; ++i)
+    originalSet.col(oldFromNewReferences[i]) = referenceSet->col(i);
+
+  return originalSet;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TreeT>
+typename std::enable_if<SupportsIncrementalUpdates<TreeT>::value, void>::type
+NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::InsertIntoTree(
+    const MatType& points)
+{
+  // The reference set is the dataset of the tree, so the tree sees the new
+  // columns.
+  MatType& dataset = referenceTree->Dataset();
+  const size_t oldNumPoints = dataset.n_cols;
+  dataset.insert_cols(oldNumPoints, points);
+  referenceSet = &referenceTree->Dataset();
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+    referenceTree->InsertPoint(oldNumPoints + i);
+
+  // The bounds of new and changed nodes must not be trusted by the next
+  // monochromatic search.
+  treeNeedsReset = true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TreeT>
+typename std::enable_if<!SupportsIncrementalUpdates<TreeT>::value, void>::type
+NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::InsertIntoTree(
+    const MatType& points)
+{
+  MatType newReferenceSet = OriginalReferenceSet();
+  newReferenceSet.insert_cols(newReferenceSet.n_cols, points);
+  Train(std::move(newReferenceSet));
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TreeT>
+typename std::enable_if<SupportsIncrementalUpdates<TreeT>::value, void>::type
+NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::RemoveFromTree(
+    const size_t index)
+{
+  MatType& dataset = referenceTree->Dataset();
+  const size_t last = dataset.n_cols - 1;
+
+  // The last point moves into the column of the removed point, so it has to be
+  // taken out of the tree too and inserted again under its new index.
+  referenceTree->DeletePoint(index);
+  if (index != last)
+  {
+    referenceTree->DeletePoint(last);
+    dataset.col(index) = dataset.col(last);
+  }
+
+  dataset.shed_col(last);
+  referenceSet = &referenceTree->Dataset();
+
+  if (index != last)
+    referenceTree->InsertPoint(index);
+
+  // The bounds of changed nodes must not be trusted by the next monochromatic
+  // search.
+  treeNeedsReset = true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TreeT>
+typename std::enable_if<!SupportsIncrementalUpdates<TreeT>::value, void>::type
+NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::RemoveFromTree(
+    const size_t index)
+{
+  MatType newReferenceSet = OriginalReferenceSet();
+  newReferenceSet.col(index) = newReferenceSet.col(newReferenceSet.n_cols - 1);
+  newReferenceSet.shed_col(newReferenceSet.n_cols - 1);
+  Train(std::move(newReferenceSet));
+}
+
 /**
  * Computes the best neighbors and stores them in resultingNeighbors and
  * distances.
@@ -492,6 +719,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   baseCases = 0;
   scores = 0;
+  achievedEpsilon = (searchMode == NAIVE_MODE) ? 0.0 :
+      (searchMode == GREEDY_SINGLE_TREE_MODE) ? DBL_MAX : epsilon;
 
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
@@ -519,12 +748,20 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   neighborPtr->set_size(k, querySet.n_cols);
   distancePtr->set_size(k, querySet.n_cols);
 
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+  typedef tree::TraversalRules<NeighborSearchRules<SortPolicy, MetricType,
+      Tree>> RuleType;
 
   switch (searchMode)
   {
     case NAIVE_MODE:
     {
+      if (ProductSearch(querySet, k, false, *neighborPtr, *distancePtr,
+          UseProducts()))
+      {
+        baseCases += querySet.n_cols * referenceSet->n_cols;
+        break;
+      }
+
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
@@ -543,12 +780,22 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
+      if (maxBaseCases == 0 && maxTime == 0)
+      {
+        // Each thread traverses its own blocks of query points with its own
+        // copy of the rules.
+        tree::ParallelSingleTreeTraverser<Tree, RuleType,
+            SingleTreeTraversalType<RuleType>> traverser(rules,
+            !tree::TreeTraits<Tree>::HasSelfChildren);
+        traverser.Traverse(querySet.n_cols, *referenceTree);
+
+        CollectResults(traverser, querySet.n_cols, *neighborPtr, *distancePtr);
+        break;
+      }
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // A budgeted search is sequential, so that the budget can be shared.
+      std::vector<double> remainingScores;
+      BudgetedTraversal(rules, querySet.n_cols, remainingScores);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -559,6 +806,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
 
       rules.GetResults(*neighborPtr, *distancePtr);
+      SetAchievedEpsilon(*distancePtr, remainingScores);
       break;
     }
     case DUAL_TREE_MODE:
@@ -573,20 +821,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
-      traverser.Traverse(*queryTree, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
-      rules.GetResults(*neighborPtr, *distancePtr);
+      DualTreeSearch(*queryTree, rules, *neighborPtr, *distancePtr);
 
       delete queryTree;
       break;
@@ -596,25 +831,15 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric);
 
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
-      // Set the value of minBaseCases.
-      traverser.MinBaseCases() = k;
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      // Create the traverser, and set the value of minBaseCases for each
+      // thread.
+      typedef tree::GreedySingleTreeTraverser<Tree, RuleType> TraverserType;
+      tree::ParallelSingleTreeTraverser<Tree, RuleType, TraverserType>
+          traverser(rules, !tree::TreeTraits<Tree>::HasSelfChildren);
+      traverser.Traverse(querySet.n_cols, *referenceTree,
+          [k](TraverserType& t) { t.MinBaseCases() = k; });
 
-      rules.GetResults(*neighborPtr, *distancePtr);
+      CollectResults(traverser, querySet.n_cols, *neighborPtr, *distancePtr);
       break;
     }
   }
@@ -714,6 +939,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   baseCases = 0;
   scores = 0;
+  achievedEpsilon = epsilon;
 
   // Get a reference to the query set.
   const MatType& querySet = queryTree.Dataset();
@@ -729,23 +955,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   distances.set_size(k, querySet.n_cols);
 
   // Create the helper object for the traversal.
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+  typedef tree::TraversalRules<NeighborSearchRules<SortPolicy, MetricType,
+      Tree>> RuleType;
   RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
 
-  // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(queryTree, *referenceTree);
-
-  scores += rules.Scores();
-  baseCases += rules.BaseCases();
-
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
-
-  rules.GetResults(*neighborPtr, distances);
-
-  Log::Info << rules.Scores() << " node combinations were scored.\n";
-  Log::Info << rules.BaseCases() << " base cases were calculated.\n";
+  DualTreeSearch(queryTree, rules, *neighborPtr, distances);
 
   Timer::Stop("computing_neighbors");
 
@@ -800,6 +1014,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   baseCases = 0;
   scores = 0;
+  achievedEpsilon = (searchMode == NAIVE_MODE) ? 0.0 :
+      (searchMode == GREEDY_SINGLE_TREE_MODE) ? DBL_MAX : epsilon;
 
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
@@ -816,31 +1032,57 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   neighborPtr->set_size(k, referenceSet->n_cols);
   distancePtr->set_size(k, referenceSet->n_cols);
 
-  // Create the helper object for the traversal.
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
-      true /* don't return the same point as nearest neighbor */);
+  // The helper object for the traversal.  Each search mode creates its own, so
+  // that the product-based naive search doesn't allocate the candidate lists.
+  typedef tree::TraversalRules<NeighborSearchRules<SortPolicy, MetricType,
+      Tree>> RuleType;
 
   switch (searchMode)
   {
     case NAIVE_MODE:
     {
+      if (ProductSearch(*referenceSet, k, true, *neighborPtr, *distancePtr,
+          UseProducts()))
+      {
+        baseCases += referenceSet->n_cols * referenceSet->n_cols;
+        break;
+      }
+
+      RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+
       // The naive brute-force solution.
       for (size_t i = 0; i < referenceSet->n_cols; ++i)
         for (size_t j = 0; j < referenceSet->n_cols; ++j)
           rules.BaseCase(i, j);
 
       baseCases += referenceSet->n_cols * referenceSet->n_cols;
+
+      rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
     case SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
+      RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      if (maxBaseCases == 0 && maxTime == 0)
+      {
+        // Each thread traverses its own blocks of query points with its own
+        // copy of the rules.
+        tree::ParallelSingleTreeTraverser<Tree, RuleType,
+            SingleTreeTraversalType<RuleType>> traverser(rules,
+            !tree::TreeTraits<Tree>::HasSelfChildren);
+        traverser.Traverse(referenceSet->n_cols, *referenceTree);
+
+        CollectResults(traverser, referenceSet->n_cols, *neighborPtr,
+            *distancePtr);
+        break;
+      }
+
+      // A budgeted search is sequential, so that the budget can be shared.
+      std::vector<double> remainingScores;
+      BudgetedTraversal(rules, referenceSet->n_cols, remainingScores);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -849,10 +1091,16 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+
+      rules.GetResults(*neighborPtr, *distancePtr);
+      SetAchievedEpsilon(*distancePtr, remainingScores);
       break;
     }
     case DUAL_TREE_MODE:
     {
+      RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+
       // The dual-tree monochromatic search case may require resetting the
       // bounds in the tree.
       if (treeNeedsReset)
@@ -873,60 +1121,43 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         }
       }
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
       if (tree::IsSpillTree<Tree>::value)
       {
         // For Dual Tree Search on SpillTree, the queryTree must be built with
         // non overlapping (tau = 0).
         Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        DualTreeSearch(queryTree, rules, *neighborPtr, *distancePtr);
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
+        DualTreeSearch(*referenceTree, rules, *neighborPtr, *distancePtr);
         // Next time we perform this search, we'll need to reset the tree.
         treeNeedsReset = true;
       }
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
       // Next time we perform this search, we'll need to reset the tree.
       treeNeedsReset = true;
       break;
     }
     case GREEDY_SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
-      // Set the value of minBaseCases.
-      traverser.MinBaseCases() = k;
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+
+      // Create the traverser, and set the value of minBaseCases for each
+      // thread.
+      typedef tree::GreedySingleTreeTraverser<Tree, RuleType> TraverserType;
+      tree::ParallelSingleTreeTraverser<Tree, RuleType, TraverserType>
+          traverser(rules, !tree::TreeTraits<Tree>::HasSelfChildren);
+      traverser.Traverse(referenceSet->n_cols, *referenceTree,
+          [k](TraverserType& t) { t.MinBaseCases() = k; });
+
+      CollectResults(traverser, referenceSet->n_cols, *neighborPtr,
+          *distancePtr);
       break;
     }
   }
 
-  rules.GetResults(*neighborPtr, *distancePtr);
-
   Timer::Stop("computing_neighbors");
 
   // Do we need to map the reference indices?
@@ -953,6 +1184,287 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DualTreeSearch(
+    Tree& queryTree,
+    const RuleType& rules,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  // Each thread traverses its own query subtrees with its own copy of the
+  // rules.
+  tree::ParallelDualTreeTraverser<Tree, RuleType, DualTreeTraversalType>
+      traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+
+  size_t traversalScores = 0;
+  size_t traversalBaseCases = 0;
+  for (size_t i = 0; i < traverser.Rules().size(); ++i)
+  {
+    traversalScores += traverser.Rules()[i].Scores();
+    traversalBaseCases += traverser.Rules()[i].BaseCases();
+  }
+
+  scores += traversalScores;
+  baseCases += traversalBaseCases;
+
+  Log::Info << traversalScores << " node combinations were scored."
+      << std::endl;
+  Log::Info << traversalBaseCases << " base cases were calculated."
+      << std::endl;
+
+  if (traverser.NumSubtrees() == 1 && &traverser.Subtree(0) == &queryTree)
+  {
+    // The query tree was not split, so one set of rules holds every result.
+    traverser.Rules()[traverser.SubtreeOwner(0)].GetResults(neighbors,
+        distances);
+    return;
+  }
+
+  // Otherwise, the results of each query point are held by the rules of the
+  // thread that traversed its subtree.
+  for (size_t i = 0; i < traverser.NumSubtrees(); ++i)
+  {
+    RuleType& subtreeRules = traverser.Rules()[traverser.SubtreeOwner(i)];
+    const Tree& subtree = traverser.Subtree(i);
+    for (size_t j = 0; j < subtree.NumDescendants(); ++j)
+      subtreeRules.GetResults(neighbors, distances, subtree.Descendant(j));
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+bool NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ProductSearch(
+    const MatType& querySet,
+    const size_t k,
+    const bool sameSet,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    std::true_type /* useProducts */)
+{
+  const MatType& references = *referenceSet;
+  const arma::rowvec queryNorms = arma::sum(arma::square(querySet), 0);
+  const arma::rowvec referenceNorms = arma::sum(arma::square(references), 0);
+
+  // The squared distances are selected on, since the order is the same.  Each
+  // block of products is small enough to stay in cache, and each thread works
+  // on its own query points, so the candidate lists can be shared.
+  CandidateList<SortPolicy> candidates(querySet.n_cols, k);
+  const size_t queryBlockSize = 256;
+  const size_t referenceBlockSize = 1024;
+  const size_t numQueryBlocks = (querySet.n_cols + queryBlockSize - 1) /
+      queryBlockSize;
+
+  // The products of each thread already use all cores.
+  util::SingleThreadedBLAS singleThreadedBLAS;
+
+  #pragma omp parallel
+  {
+    arma::mat products;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numQueryBlocks; ++b)
+    {
+      const size_t queryBegin = b * queryBlockSize;
+      const size_t queryEnd = std::min(queryBegin + queryBlockSize,
+          (size_t) querySet.n_cols);
+
+      for (size_t referenceBegin = 0; referenceBegin < references.n_cols;
+           referenceBegin += referenceBlockSize)
+      {
+        const size_t referenceEnd = std::min(referenceBegin +
+            referenceBlockSize, (size_t) references.n_cols);
+        products = references.cols(referenceBegin, referenceEnd - 1).t() *
+            querySet.cols(queryBegin, queryEnd - 1);
+
+        for (size_t q = queryBegin; q < queryEnd; ++q)
+        {
+          const double* queryProducts = products.colptr(q - queryBegin);
+          for (size_t r = referenceBegin; r < referenceEnd; ++r)
+          {
+            if (sameSet && q == r)
+              continue;
+
+            const double distance = std::max(queryNorms[q] +
+                referenceNorms[r] - 2.0 * queryProducts[r - referenceBegin],
+                0.0);
+            candidates.Insert(q, distance, r);
+          }
+        }
+      }
+    }
+
+    // Recompute the distances of the neighbors exactly, since the products
+    // lose precision for close points, and sort them again.
+    std::vector<std::pair<double, size_t>> results(k);
+    #pragma omp for
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      const std::pair<double, size_t>* c = candidates.Begin(q);
+      for (size_t j = 0; j < k; ++j)
+      {
+        results[j] = std::make_pair(metric.Evaluate(querySet.col(q),
+            references.col(c[j].second)), c[j].second);
+      }
+
+      std::sort(results.begin(), results.end(),
+          [](const std::pair<double, size_t>& a,
+             const std::pair<double, size_t>& b)
+          {
+            return SortPolicy::IsBetter(a.first, b.first) ||
+                (a.first == b.first && a.second < b.second);
+          });
+
+      for (size_t j = 0; j < k; ++j)
+      {
+        distances(j, q) = results[j].first;
+        neighbors(j, q) = results[j].second;
+      }
+    }
+  }
+
+  return true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename ParallelTraverserType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::CollectResults(
+    ParallelTraverserType& traverser,
+    const size_t numQueries,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  size_t traversalScores = 0;
+  size_t traversalBaseCases = 0;
+  for (size_t i = 0; i < traverser.Rules().size(); ++i)
+  {
+    traversalScores += traverser.Rules()[i].Scores();
+    traversalBaseCases += traverser.Rules()[i].BaseCases();
+  }
+
+  scores += traversalScores;
+  baseCases += traversalBaseCases;
+
+  Log::Info << traversalScores << " node combinations were scored."
+      << std::endl;
+  Log::Info << traversalBaseCases << " base cases were calculated."
+      << std::endl;
+
+  if (traverser.Rules().size() == 1)
+  {
+    // Only one set of rules was used, so it holds every result.
+    traverser.Rules()[0].GetResults(neighbors, distances);
+    return;
+  }
+
+  // Otherwise, the results of each query point are held by the rules of the
+  // thread that traversed its block.
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Rules()[traverser.QueryOwner(i)].GetResults(neighbors, distances,
+        i);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::BudgetedTraversal(
+    RuleType& rules,
+    const size_t numQueries,
+    std::vector<double>& remainingScores)
+{
+  typedef tree::PrioritySingleTreeTraverser<Tree, RuleType> TraverserType;
+  typedef typename TraverserType::Clock Clock;
+  TraverserType traverser(rules);
+
+  // Query point i may use the budget up to the (i + 1)'th share, so whatever
+  // a query point does not use is left to the next ones.
+  const typename Clock::time_point start = Clock::now();
+  remainingScores.resize(numQueries);
+  for (size_t i = 0; i < numQueries; ++i)
+  {
+    const double share = (double) (i + 1) / (double) numQueries;
+    if (maxBaseCases != 0)
+      traverser.BaseCaseLimit() = (size_t) (share * maxBaseCases);
+    if (maxTime != 0)
+    {
+      traverser.Deadline() = start +
+          std::chrono::duration_cast<typename Clock::duration>(
+          std::chrono::duration<double, std::micro>(share * maxTime));
+    }
+
+    traverser.Traverse(i, *referenceTree);
+    remainingScores[i] = traverser.RemainingScore();
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SetAchievedEpsilon(
+    const arma::mat& distances,
+    const std::vector<double>& remainingScores)
+{
+  for (size_t i = 0; i < distances.n_cols; ++i)
+  {
+    // Skip query points whose traversal was complete.
+    if (remainingScores[i] == DBL_MAX)
+      continue;
+
+    // No point that was not visited can be closer (for nearest neighbor
+    // search) than this bound.
+    const double bound = SortPolicy::ConvertToDistance(remainingScores[i]);
+    const double distance = distances(distances.n_rows - 1, i);
+    if (bound == distance || !SortPolicy::IsBetter(bound, distance))
+      continue;
+
+    if (distance == SortPolicy::WorstDistance() || bound == 0)
+    {
+      achievedEpsilon = DBL_MAX;
+      return;
+    }
+
+    achievedEpsilon = std::max(achievedEpsilon,
+        std::abs(distance - bound) / bound);
+  }
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
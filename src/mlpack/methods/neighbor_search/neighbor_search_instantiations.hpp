@@ -0,0 +1,51 @@
+/**
+ * @file neighbor_search_instantiations.hpp
+ *
+ * Declarations of the explicit instantiations of the NeighborSearch class that
+ * are compiled into libmlpack (in neighbor_search_instantiations.cpp):
+ * k-nearest and k-furthest neighbor search with the Euclidean distance on
+ * arma::mat, with kd-trees, ball trees, cover trees and R trees.  Code that
+ * uses one of these types links to the compiled instantiation instead of
+ * compiling the search (and the trees and traversals behind it) again.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_INSTANTIATIONS_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_INSTANTIATIONS_HPP
+
+#include "neighbor_search.hpp"
+
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/rectangle_tree.hpp>
+#include "sort_policies/nearest_neighbor_sort.hpp"
+#include "sort_policies/furthest_neighbor_sort.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+extern template class NeighborSearch<NearestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::KDTree>;
+extern template class NeighborSearch<NearestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::BallTree>;
+extern template class NeighborSearch<NearestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::StandardCoverTree>;
+extern template class NeighborSearch<NearestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::RTree>;
+
+extern template class NeighborSearch<FurthestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::KDTree>;
+extern template class NeighborSearch<FurthestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::BallTree>;
+extern template class NeighborSearch<FurthestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::StandardCoverTree>;
+extern template class NeighborSearch<FurthestNeighborSort,
+    metric::EuclideanDistance, arma::mat, tree::RTree>;
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
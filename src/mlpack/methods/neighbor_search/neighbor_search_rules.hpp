@@ -15,7 +15,9 @@
 
 #include <mlpack/core/tree/traversal_info.hpp>
 
-#include <queue>
+#include "candidate_list.hpp"
+#include "partial_distance.hpp"
+
 
 namespace mlpack {
 namespace neighbor {
@@ -63,6 +65,21 @@ class NeighborSearchRules
    */
   void GetResults(arma::Mat<size_t>& neighbors, arma::mat& distances);
 
+  /**
+   * Store the list of candidates for the given query point in the
+   * corresponding column of the given matrices, which must already have k rows
+   * and a column for each query point.  This can be called only once for each
+   * query point.
+   *
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param queryIndex Index of the query point to store the candidates of.
+   */
+  void GetResults(arma::Mat<size_t>& neighbors,
+                  arma::mat& distances,
+                  const size_t queryIndex);
+
   /**
    * Get the distance from the query point to the reference point.
    * This will update the list of candidates with the new point if appropriate
@@ -73,6 +90,20 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Evaluate the base cases between every point of the given query leaf and
+   * every point of the given reference leaf.  Query points for which the
+   * reference leaf is pruned by Score() are skipped, and the evaluation of a
+   * distance stops early when it cannot improve the candidates of the query
+   * point (when this is known to be safe for the sort policy and metric).  The
+   * results are the same as with BaseCase().
+   *
+   * @param queryNode Query leaf.
+   * @param referenceNode Reference leaf.
+   * @return The number of base cases that were considered.
+   */
+  size_t BaseCaseBlock(TreeType& queryNode, TreeType& referenceNode);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -164,23 +195,9 @@ class NeighborSearchRules
   //! The query set.
   const typename TreeType::Mat& querySet;
 
-  //! Candidate represents a possible candidate neighbor (distance, index).
-  typedef std::pair<double, size_t> Candidate;
-
-  //! Compare two candidates based on the distance.
-  struct CandidateCmp {
-    bool operator()(const Candidate& c1, const Candidate& c2)
-    {
-      return !SortPolicy::IsBetter(c2.first, c1.first);
-    };
-  };
-
-  //! Use a priority queue to represent the list of candidate neighbors.
-  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-      CandidateList;
-
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Set of candidate neighbors for each point.  Each list starts with k
+  //! candidates (WorstDistance, size_t() - 1) and is updated by BaseCase().
+  CandidateList<SortPolicy> candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -190,6 +190,118 @@ class TrainVisitor : public boost::static_visitor<void>
                const double rho);
 };
 
+/**
+ * InsertVisitor adds points to the reference set of the given NSType.  Tree
+ * types that accept leafSize as a parameter are rebuilt here with the proper
+ * leafSize, just like TrainVisitor does; all other types use
+ * NeighborSearch::Insert().
+ */
+template<typename SortPolicy>
+class InsertVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The points to add.
+  const arma::mat& points;
+  //! The leaf size, used only by BinarySpaceTree.
+  size_t leafSize;
+  //! Overlapping size (for spill trees).
+  const double tau;
+  //! Balance threshold (for spill trees).
+  const double rho;
+
+  //! Rebuild the given NSType with the new points considering the leafSize.
+  template<typename NSType>
+  void InsertLeaf(NSType* ns) const;
+
+ public:
+  //! Alias template necessary for visual c++ compiler.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  using NSTypeT = NSType<SortPolicy, TreeType>;
+
+  //! Default Insert on the given NSType instance.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  void operator()(NSTypeT<TreeType>* ns) const;
+
+  //! Insert on the given NSType specialized for KDTrees.
+  void operator()(NSTypeT<tree::KDTree>* ns) const;
+
+  //! Insert on the given NSType specialized for BallTrees.
+  void operator()(NSTypeT<tree::BallTree>* ns) const;
+
+  //! Insert specialized for SPTrees.
+  void operator()(SpillKNN* ns) const;
+
+  //! Insert specialized for octrees.
+  void operator()(NSTypeT<tree::Octree>* ns) const;
+
+  //! Construct the InsertVisitor object with the given points, leafSize for
+  //! BinarySpaceTrees, and tau and rho for spill trees.
+  InsertVisitor(const arma::mat& points,
+                const size_t leafSize,
+                const double tau,
+                const double rho);
+};
+
+/**
+ * RemoveVisitor removes a point from the reference set of the given NSType.
+ * Tree types that accept leafSize as a parameter are rebuilt here with the
+ * proper leafSize, just like TrainVisitor does; all other types use
+ * NeighborSearch::Remove().
+ */
+template<typename SortPolicy>
+class RemoveVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The index of the point to remove.
+  size_t index;
+  //! The leaf size, used only by BinarySpaceTree.
+  size_t leafSize;
+  //! Overlapping size (for spill trees).
+  const double tau;
+  //! Balance threshold (for spill trees).
+  const double rho;
+
+  //! Rebuild the given NSType without the point considering the leafSize.
+  template<typename NSType>
+  void RemoveLeaf(NSType* ns) const;
+
+ public:
+  //! Alias template necessary for visual c++ compiler.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  using NSTypeT = NSType<SortPolicy, TreeType>;
+
+  //! Default Remove on the given NSType instance.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  void operator()(NSTypeT<TreeType>* ns) const;
+
+  //! Remove on the given NSType specialized for KDTrees.
+  void operator()(NSTypeT<tree::KDTree>* ns) const;
+
+  //! Remove on the given NSType specialized for BallTrees.
+  void operator()(NSTypeT<tree::BallTree>* ns) const;
+
+  //! Remove specialized for SPTrees.
+  void operator()(SpillKNN* ns) const;
+
+  //! Remove specialized for octrees.
+  void operator()(NSTypeT<tree::Octree>* ns) const;
+
+  //! Construct the RemoveVisitor object with the given index, leafSize for
+  //! BinarySpaceTrees, and tau and rho for spill trees.
+  RemoveVisitor(const size_t index,
+                const size_t leafSize,
+                const double tau,
+                const double rho);
+};
+
 /**
  * SearchModeVisitor exposes the SearchMode() method of the given NSType.
  */
@@ -212,6 +324,40 @@ class EpsilonVisitor : public boost::static_visitor<double&>
   double& operator()(NSType *ns) const;
 };
 
+/**
+ * MaxBaseCasesVisitor exposes the MaxBaseCases() method of the given NSType.
+ */
+class MaxBaseCasesVisitor : public boost::static_visitor<size_t&>
+{
+ public:
+  //! Return the maximum number of base cases of a single-tree search.
+  template<typename NSType>
+  size_t& operator()(NSType* ns) const;
+};
+
+/**
+ * MaxTimeVisitor exposes the MaxTime() method of the given NSType.
+ */
+class MaxTimeVisitor : public boost::static_visitor<double&>
+{
+ public:
+  //! Return the maximum time of a single-tree search, in microseconds.
+  template<typename NSType>
+  double& operator()(NSType* ns) const;
+};
+
+/**
+ * AchievedEpsilonVisitor exposes the AchievedEpsilon() method of the given
+ * NSType.
+ */
+class AchievedEpsilonVisitor : public boost::static_visitor<double>
+{
+ public:
+  //! Return the bound on the relative error of the last search.
+  template<typename NSType>
+  double operator()(NSType* ns) const;
+};
+
 /**
  * ReferenceSetVisitor exposes the referenceSet of the given NSType.
  */
@@ -223,6 +369,17 @@ class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
   const arma::mat& operator()(NSType *ns) const;
 };
 
+/**
+ * InitializedVisitor returns whether the given NSType instance exists.
+ */
+class InitializedVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Return whether the NSType object exists.
+  template<typename NSType>
+  bool operator()(NSType* ns) const;
+};
+
 /**
  * DeleteVisitor deletes the given NSType instance.
  */
@@ -242,6 +399,9 @@ class DeleteVisitor : public boost::static_visitor<void>
  * flexibility as the NeighborSearch class.  So if you are using it outside of
  * mlpack_knn and mlpack_kfn, be aware that it is limited!
  *
+ * NSModel only holds double-precision (arma::mat) searchers.  To search
+ * single-precision data, use NeighborSearch with arma::fmat directly.
+ *
  * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
  */
 template<typename SortPolicy>
@@ -363,6 +523,17 @@ class NSModel
   double Epsilon() const;
   double& Epsilon();
 
+  //! Expose MaxBaseCases (0 indicates no limit).
+  size_t MaxBaseCases() const;
+  size_t& MaxBaseCases();
+
+  //! Expose MaxTime, in microseconds (0 indicates no limit).
+  double MaxTime() const;
+  double& MaxTime();
+
+  //! Get the bound on the relative error of the results of the last search.
+  double AchievedEpsilon() const;
+
   //! Expose leafSize.
   size_t LeafSize() const { return leafSize; }
   size_t& LeafSize() { return leafSize; }
@@ -389,6 +560,21 @@ class NSModel
                   const NeighborSearchMode searchMode,
                   const double epsilon = 0);
 
+  /**
+   * Add the given points to the reference set, updating the reference tree in
+   * place when the tree type allows it (the R tree family); other tree types
+   * are rebuilt.  The points are projected onto the random basis, if one is
+   * used.
+   */
+  void Insert(arma::mat&& points);
+
+  /**
+   * Remove the given point from the reference set; the last reference point
+   * takes its index.  The reference tree is updated in place when the tree
+   * type allows it (the R tree family); other tree types are rebuilt.
+   */
+  void Remove(const size_t index);
+
   //! Perform neighbor search.  The query set will be reordered.
   void Search(arma::mat&& querySet,
               const size_t k,
@@ -404,12 +590,116 @@ class NSModel
   std::string TreeName() const;
 };
 
+/**
+ * NSModelHeader holds the parameters of a saved NSModel: the tree type, the
+ * leaf size, the spill tree parameters, whether a random basis is used, and
+ * the size of the reference set.  These are stored at the beginning of the
+ * NSModel archive, so an NSModelHeader is loaded by reading only the
+ * beginning of a model file, and the trees and the reference set are never
+ * deserialized.  This makes it cheap to list or validate saved models; see
+ * data::LazyModel.
+ *
+ * Only binary and text archives can be read partially; an XML archive has to
+ * be read completely.  The dimensionality and size of the reference set are
+ * only known for models saved since version 2 of NSModel (otherwise they are
+ * 0, except for the dimensionality of models with a random basis).
+ *
+ * @tparam SortPolicy The sort policy of the model.
+ */
+template<typename SortPolicy>
+class NSModelHeader
+{
+ public:
+  //! Create an empty header.
+  NSModelHeader() :
+      treeType(NSModel<SortPolicy>::KD_TREE),
+      leafSize(0),
+      tau(0),
+      rho(0),
+      randomBasis(false),
+      dimensionality(0),
+      referenceSize(0)
+  { }
+
+  //! Get the header of the given (trained) model.
+  NSModelHeader(const NSModel<SortPolicy>& model) :
+      treeType(model.TreeType()),
+      leafSize(model.LeafSize()),
+      tau(model.Tau()),
+      rho(model.Rho()),
+      randomBasis(model.RandomBasis()),
+      dimensionality(model.Dataset().n_rows),
+      referenceSize(model.Dataset().n_cols)
+  { }
+
+  //! Get the tree type.
+  typename NSModel<SortPolicy>::TreeTypes TreeType() const { return treeType; }
+  //! Get the leaf size.
+  size_t LeafSize() const { return leafSize; }
+  //! Get the overlapping size of spill trees.
+  double Tau() const { return tau; }
+  //! Get the balance threshold of spill trees.
+  double Rho() const { return rho; }
+  //! Get whether the points are projected onto a random basis.
+  bool RandomBasis() const { return randomBasis; }
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get the number of reference points.
+  size_t ReferenceSize() const { return referenceSize; }
+
+  /**
+   * Load the header from the beginning of an NSModel archive; this may only be
+   * used for loading.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version)
+  {
+    ar & BOOST_SERIALIZATION_NVP(treeType);
+    if (version > 0)
+    {
+      ar & BOOST_SERIALIZATION_NVP(leafSize);
+      ar & BOOST_SERIALIZATION_NVP(tau);
+      ar & BOOST_SERIALIZATION_NVP(rho);
+    }
+    ar & BOOST_SERIALIZATION_NVP(randomBasis);
+
+    arma::mat q;
+    ar & BOOST_SERIALIZATION_NVP(q);
+
+    if (version > 1)
+    {
+      ar & BOOST_SERIALIZATION_NVP(dimensionality);
+      ar & BOOST_SERIALIZATION_NVP(referenceSize);
+    }
+    else if (randomBasis)
+    {
+      dimensionality = q.n_rows;
+    }
+  }
+
+ private:
+  //! The tree type.
+  typename NSModel<SortPolicy>::TreeTypes treeType;
+  //! The leaf size.
+  size_t leafSize;
+  //! The overlapping size of spill trees.
+  double tau;
+  //! The balance threshold of spill trees.
+  double rho;
+  //! Whether the points are projected onto a random basis.
+  bool randomBasis;
+  //! The dimensionality of the reference set.
+  size_t dimensionality;
+  //! The number of reference points.
+  size_t referenceSize;
+};
+
 } // namespace neighbor
 } // namespace mlpack
 
 //! Set the serialization version of the NSModel class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::NSModel<SortPolicy>, 1);
+    mlpack::neighbor::NSModel<SortPolicy>, 2);
 
 // Include implementation.
 #include "ns_model_impl.hpp"
@@ -225,6 +225,164 @@ void TrainVisitor<SortPolicy>::TrainLeaf(NSType* ns) const
   }
 }
 
+//! Save parameters for Insert.
+template<typename SortPolicy>
+InsertVisitor<SortPolicy>::InsertVisitor(const arma::mat& points,
+                                         const size_t leafSize,
+                                         const double tau,
+                                         const double rho) :
+    points(points),
+    leafSize(leafSize),
+    tau(tau),
+    rho(rho)
+{}
+
+//! Default Insert on the given NSType instance.
+template<typename SortPolicy>
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void InsertVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
+{
+  if (ns)
+    return ns->Insert(points);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert on the given NSType specialized for KDTrees.
+template<typename SortPolicy>
+void InsertVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
+{
+  if (ns)
+    return InsertLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert on the given NSType specialized for BallTrees.
+template<typename SortPolicy>
+void InsertVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
+{
+  if (ns)
+    return InsertLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert specialized for SPTrees.
+template<typename SortPolicy>
+void InsertVisitor<SortPolicy>::operator()(SpillKNN* ns) const
+{
+  if (ns)
+    return InsertLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Insert specialized for Octrees.
+template<typename SortPolicy>
+void InsertVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
+{
+  if (ns)
+    return InsertLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Rebuild the given NSType considering the leafSize.
+template<typename SortPolicy>
+template<typename NSType>
+void InsertVisitor<SortPolicy>::InsertLeaf(NSType* ns) const
+{
+  if (ns->ReferenceSet().n_cols > 0 &&
+      points.n_rows != ns->ReferenceSet().n_rows)
+  {
+    // Let NeighborSearch::Insert() report the error.
+    ns->Insert(points);
+    return;
+  }
+
+  arma::mat referenceSet = ns->OriginalReferenceSet();
+  referenceSet.insert_cols(referenceSet.n_cols, points);
+  TrainVisitor<SortPolicy> tn(std::move(referenceSet), leafSize, tau, rho);
+  tn(ns);
+}
+
+//! Save parameters for Remove.
+template<typename SortPolicy>
+RemoveVisitor<SortPolicy>::RemoveVisitor(const size_t index,
+                                         const size_t leafSize,
+                                         const double tau,
+                                         const double rho) :
+    index(index),
+    leafSize(leafSize),
+    tau(tau),
+    rho(rho)
+{}
+
+//! Default Remove on the given NSType instance.
+template<typename SortPolicy>
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RemoveVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
+{
+  if (ns)
+    return ns->Remove(index);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Remove on the given NSType specialized for KDTrees.
+template<typename SortPolicy>
+void RemoveVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
+{
+  if (ns)
+    return RemoveLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Remove on the given NSType specialized for BallTrees.
+template<typename SortPolicy>
+void RemoveVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
+{
+  if (ns)
+    return RemoveLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Remove specialized for SPTrees.
+template<typename SortPolicy>
+void RemoveVisitor<SortPolicy>::operator()(SpillKNN* ns) const
+{
+  if (ns)
+    return RemoveLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Remove specialized for Octrees.
+template<typename SortPolicy>
+void RemoveVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
+{
+  if (ns)
+    return RemoveLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Rebuild the given NSType considering the leafSize.
+template<typename SortPolicy>
+template<typename NSType>
+void RemoveVisitor<SortPolicy>::RemoveLeaf(NSType* ns) const
+{
+  if (index >= ns->ReferenceSet().n_cols)
+  {
+    // Let NeighborSearch::Remove() report the error.
+    ns->Remove(index);
+    return;
+  }
+
+  arma::mat referenceSet = ns->OriginalReferenceSet();
+  referenceSet.col(index) = referenceSet.col(referenceSet.n_cols - 1);
+  referenceSet.shed_col(referenceSet.n_cols - 1);
+  TrainVisitor<SortPolicy> tn(std::move(referenceSet), leafSize, tau, rho);
+  tn(ns);
+}
+
 //! Return the search mode.
 template<typename NSType>
 NeighborSearchMode& SearchModeVisitor::operator()(NSType* ns) const
@@ -243,6 +401,33 @@ double& EpsilonVisitor::operator()(NSType* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Expose the MaxBaseCases method of the given NSType.
+template<typename NSType>
+size_t& MaxBaseCasesVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->MaxBaseCases();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Expose the MaxTime method of the given NSType.
+template<typename NSType>
+double& MaxTimeVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->MaxTime();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Expose the AchievedEpsilon method of the given NSType.
+template<typename NSType>
+double AchievedEpsilonVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->AchievedEpsilon();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Expose the referenceSet of the given NSType.
 template<typename NSType>
 const arma::mat& ReferenceSetVisitor::operator()(NSType* ns) const
@@ -252,6 +437,13 @@ const arma::mat& ReferenceSetVisitor::operator()(NSType* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Return whether the model exists.
+template<typename NSType>
+bool InitializedVisitor::operator()(NSType* ns) const
+{
+  return (ns != NULL);
+}
+
 //! Clean memory, if necessary.
 template<typename NSType>
 void DeleteVisitor::operator()(NSType* ns) const
@@ -372,6 +564,23 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const unsigned int version)
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
   ar & BOOST_SERIALIZATION_NVP(q);
 
+  // Since version 2, the size of the reference set is stored before the
+  // search object, so that NSModelHeader can be read without the trees.
+  if (version > 1)
+  {
+    size_t dimensionality = 0;
+    size_t referenceSize = 0;
+    if (Archive::is_saving::value &&
+        boost::apply_visitor(InitializedVisitor(), nSearch))
+    {
+      dimensionality = Dataset().n_rows;
+      referenceSize = Dataset().n_cols;
+    }
+
+    ar & BOOST_SERIALIZATION_NVP(dimensionality);
+    ar & BOOST_SERIALIZATION_NVP(referenceSize);
+  }
+
   // This should never happen, but just in case, be clean with memory.
   if (Archive::is_loading::value)
     boost::apply_visitor(DeleteVisitor(), nSearch);
@@ -412,6 +621,36 @@ double& NSModel<SortPolicy>::Epsilon()
   return boost::apply_visitor(EpsilonVisitor(), nSearch);
 }
 
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::MaxBaseCases() const
+{
+  return boost::apply_visitor(MaxBaseCasesVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+size_t& NSModel<SortPolicy>::MaxBaseCases()
+{
+  return boost::apply_visitor(MaxBaseCasesVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+double NSModel<SortPolicy>::MaxTime() const
+{
+  return boost::apply_visitor(MaxTimeVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+double& NSModel<SortPolicy>::MaxTime()
+{
+  return boost::apply_visitor(MaxTimeVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+double NSModel<SortPolicy>::AchievedEpsilon() const
+{
+  return boost::apply_visitor(AchievedEpsilonVisitor(), nSearch);
+}
+
 //! Build the reference tree.
 template<typename SortPolicy>
 void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
@@ -526,6 +765,26 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
   }
 }
 
+//! Add points to the reference set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Insert(arma::mat&& points)
+{
+  // We may need to map the points randomly.
+  if (randomBasis)
+    points = q * points;
+
+  InsertVisitor<SortPolicy> insert(points, leafSize, tau, rho);
+  boost::apply_visitor(insert, nSearch);
+}
+
+//! Remove a point from the reference set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Remove(const size_t index)
+{
+  RemoveVisitor<SortPolicy> remove(index, leafSize, tau, rho);
+  boost::apply_visitor(remove, nSearch);
+}
+
 //! Perform neighbor search.  The query set will be reordered.
 template<typename SortPolicy>
 void NSModel<SortPolicy>::Search(arma::mat&& querySet,
@@ -589,6 +848,12 @@ void NSModel<SortPolicy>::Search(const size_t k,
   if (Epsilon() != 0 && SearchMode() != NAIVE_MODE)
     Log::Info << "Maximum of " << Epsilon() * 100 << "% relative error."
         << std::endl;
+  if (SearchMode() == SINGLE_TREE_MODE && MaxBaseCases() != 0)
+    Log::Info << "Stopping after " << MaxBaseCases() << " base cases."
+        << std::endl;
+  if (SearchMode() == SINGLE_TREE_MODE && MaxTime() != 0)
+    Log::Info << "Stopping after " << MaxTime() << " microseconds."
+        << std::endl;
 
   MonoSearchVisitor search(k, neighbors, distances);
   boost::apply_visitor(search, nSearch);
@@ -0,0 +1,150 @@
+/**
+ * @file ns_model_tuner.hpp
+ *
+ * Automatic selection of the tree type, leaf size and search mode of an
+ * NSModel, by timing short trials on a subsample of the reference set.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NS_MODEL_TUNER_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NS_MODEL_TUNER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "ns_model.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The NSModelTuner chooses the configuration of an NSModel (tree type, leaf
+ * size and search mode) for a given reference set.  Which configuration is
+ * fastest depends on the dimensionality and the intrinsic dimensionality of
+ * the data, and on the machine, so the tuner measures it:
+ *
+ *  - a subsample of the reference set is drawn, and its intrinsic dimension is
+ *    estimated with the maximum likelihood estimator of Levina and Bickel
+ *    ("Maximum likelihood estimation of intrinsic dimension", 2005);
+ *  - the candidate configurations are chosen from the dimensionality, the
+ *    intrinsic dimension and the size of the L1 data cache (leaves that don't
+ *    fit in the cache aren't tried);
+ *  - each candidate builds its tree on the subsample and searches it with a
+ *    set of query points drawn from the subsample, and the candidate with the
+ *    lowest total time is selected.
+ *
+ * Only exact searches are tried, so the choice never changes the results.
+ * Since the trials are run on a subsample, brute-force search is only tried
+ * when the whole reference set is used for the trials or when the intrinsic
+ * dimension is so high that trees are unlikely to help.
+ *
+ * @code
+ * NSModelTuner<NearestNeighborSort> tuner;
+ * const NSModelTuner<NearestNeighborSort>::Trial& best =
+ *     tuner.Tune(referenceSet, k);
+ *
+ * NSModel<NearestNeighborSort> model(best.treeType);
+ * model.BuildModel(std::move(referenceSet), best.leafSize, best.searchMode);
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy of the model to tune.
+ */
+template<typename SortPolicy>
+class NSModelTuner
+{
+ public:
+  //! A configuration tried by the tuner, with the time its trial took.
+  struct Trial
+  {
+    //! The tree type.
+    typename NSModel<SortPolicy>::TreeTypes treeType;
+    //! The leaf size.
+    size_t leafSize;
+    //! The search mode.
+    NeighborSearchMode searchMode;
+    //! The time taken to build the tree, in seconds.
+    double buildTime;
+    //! The time taken by the search, in seconds.
+    double searchTime;
+  };
+
+  /**
+   * Create the tuner.
+   *
+   * @param sampleSize Maximum number of reference points used for the trials.
+   * @param numQueries Number of query points searched in each trial.
+   */
+  NSModelTuner(const size_t sampleSize = 5000, const size_t numQueries = 500);
+
+  /**
+   * Time the candidate configurations on a subsample of the given reference
+   * set, and return the fastest.  A std::invalid_argument is thrown if k is
+   * not smaller than the number of reference points.
+   *
+   * @param referenceSet Reference set the model will be built on.
+   * @param k Number of neighbors that will be searched for.
+   * @return The fastest configuration.
+   */
+  const Trial& Tune(const arma::mat& referenceSet, const size_t k);
+
+  /**
+   * Estimate the intrinsic dimension of the given dataset, from the distances
+   * of each point to its k nearest neighbors.  Duplicate points are ignored.
+   *
+   * @param dataset Dataset to estimate the intrinsic dimension of.
+   * @param k Number of neighbors used for each point.
+   */
+  static double IntrinsicDimension(const arma::mat& dataset,
+                                   const size_t k = 10);
+
+  //! Get the trials of the last call to Tune(), in the order they were run.
+  const std::vector<Trial>& Trials() const { return trials; }
+
+  //! Get the fastest trial of the last call to Tune().
+  const Trial& Best() const { return trials[best]; }
+
+  //! Get the intrinsic dimension estimated by the last call to Tune().
+  double EstimatedDimension() const { return estimatedDimension; }
+
+  //! Get the maximum number of reference points used for the trials.
+  size_t SampleSize() const { return sampleSize; }
+  //! Modify the maximum number of reference points used for the trials.
+  size_t& SampleSize() { return sampleSize; }
+
+  //! Get the number of query points searched in each trial.
+  size_t NumQueries() const { return numQueries; }
+  //! Modify the number of query points searched in each trial.
+  size_t& NumQueries() { return numQueries; }
+
+ private:
+  //! Get the leaf sizes to try for points of the given dimensionality.
+  static std::vector<size_t> LeafSizes(const size_t dimensionality);
+
+  //! Build and search with the given configuration, and store the trial.
+  void RunTrial(const arma::mat& sample,
+                const arma::mat& queries,
+                const size_t k,
+                const typename NSModel<SortPolicy>::TreeTypes treeType,
+                const size_t leafSize,
+                const NeighborSearchMode searchMode);
+
+  //! The maximum number of reference points used for the trials.
+  size_t sampleSize;
+  //! The number of query points searched in each trial.
+  size_t numQueries;
+  //! The trials of the last call to Tune().
+  std::vector<Trial> trials;
+  //! The index of the fastest trial.
+  size_t best;
+  //! The intrinsic dimension estimated by the last call to Tune().
+  double estimatedDimension;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ns_model_tuner_impl.hpp"
+
+#endif
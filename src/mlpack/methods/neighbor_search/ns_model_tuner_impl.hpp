@@ -0,0 +1,230 @@
+/**
+ * @file ns_model_tuner_impl.hpp
+ *
+ * Implementation of the NSModelTuner class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NS_MODEL_TUNER_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NS_MODEL_TUNER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ns_model_tuner.hpp"
+
+#include <chrono>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy>
+NSModelTuner<SortPolicy>::NSModelTuner(const size_t sampleSize,
+                                       const size_t numQueries) :
+    sampleSize(sampleSize),
+    numQueries(numQueries),
+    best(0),
+    estimatedDimension(0.0)
+{
+  // Nothing to do.
+}
+
+template<typename SortPolicy>
+const typename NSModelTuner<SortPolicy>::Trial&
+NSModelTuner<SortPolicy>::Tune(const arma::mat& referenceSet, const size_t k)
+{
+  typedef NSModel<SortPolicy> ModelType;
+
+  if (k == 0 || k >= referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "NSModelTuner::Tune(): k must be positive and less than the "
+        << "number of reference points (" << referenceSet.n_cols << "), but "
+        << "it is " << k << ".";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Draw the subsample the trials are run on.  Collisions between the samples
+  // may make it a little smaller than sampleSize.
+  arma::mat sample;
+  if (referenceSet.n_cols > sampleSize)
+  {
+    arma::uvec indices;
+    math::ObtainDistinctSamples(0, referenceSet.n_cols, sampleSize, indices);
+    if (indices.n_elem > k)
+      sample = referenceSet.cols(indices);
+  }
+  if (sample.n_cols == 0)
+    sample = referenceSet;
+  const bool fullSet = (sample.n_cols == referenceSet.n_cols);
+
+  arma::uvec queryIndices;
+  math::ObtainDistinctSamples(0, sample.n_cols, std::max(numQueries,
+      (size_t) 1), queryIndices);
+  const arma::mat queries = sample.cols(queryIndices);
+
+  // A thousand points are enough for the estimate.
+  const size_t dimensionPoints = std::min(sample.n_cols, (size_t) 1000);
+  estimatedDimension = IntrinsicDimension(
+      sample.cols(0, dimensionPoints - 1));
+
+  const size_t dimensionality = referenceSet.n_rows;
+  Log::Info << "Estimated intrinsic dimension: " << estimatedDimension
+      << " (the data has " << dimensionality << " dimensions)." << std::endl;
+
+  // The candidate tree types.  kd-trees, ball trees and cover trees are always
+  // tried; the others only where they are known to do well.
+  std::vector<typename ModelType::TreeTypes> treeTypes;
+  treeTypes.push_back(ModelType::KD_TREE);
+  treeTypes.push_back(ModelType::BALL_TREE);
+  if (dimensionality <= 4)
+    treeTypes.push_back(ModelType::OCTREE);
+  if (dimensionality <= 8)
+    treeTypes.push_back(ModelType::R_STAR_TREE);
+  if (estimatedDimension > 4)
+    treeTypes.push_back(ModelType::VP_TREE);
+  if (estimatedDimension < dimensionality / 2.0)
+    treeTypes.push_back(ModelType::MAX_RP_TREE);
+
+  const std::vector<size_t> leafSizes = LeafSizes(dimensionality);
+
+  // The trials are run quietly.
+  const bool ignoring = Log::Info.ignoreInput;
+  Log::Info.ignoreInput = true;
+
+  trials.clear();
+  for (size_t t = 0; t < treeTypes.size(); ++t)
+  {
+    for (size_t l = 0; l < leafSizes.size(); ++l)
+    {
+      RunTrial(sample, queries, k, treeTypes[t], leafSizes[l],
+          SINGLE_TREE_MODE);
+      RunTrial(sample, queries, k, treeTypes[t], leafSizes[l],
+          DUAL_TREE_MODE);
+    }
+  }
+
+  // Cover trees have no leaf size.
+  RunTrial(sample, queries, k, ModelType::COVER_TREE, 20, SINGLE_TREE_MODE);
+  RunTrial(sample, queries, k, ModelType::COVER_TREE, 20, DUAL_TREE_MODE);
+
+  // Trials on a subsample favor brute-force search, whose cost grows linearly
+  // with the number of reference points.
+  if (fullSet || estimatedDimension > 20)
+    RunTrial(sample, queries, k, ModelType::KD_TREE, 20, NAIVE_MODE);
+
+  Log::Info.ignoreInput = ignoring;
+
+  best = 0;
+  for (size_t i = 1; i < trials.size(); ++i)
+  {
+    if (trials[i].buildTime + trials[i].searchTime <
+        trials[best].buildTime + trials[best].searchTime)
+      best = i;
+  }
+
+  return trials[best];
+}
+
+template<typename SortPolicy>
+double NSModelTuner<SortPolicy>::IntrinsicDimension(const arma::mat& dataset,
+                                                    const size_t k)
+{
+  // At least two neighbors are needed to compare their distances.
+  const size_t numNeighbors = std::min(k, (size_t) dataset.n_cols - 1);
+  if (dataset.n_cols < 3 || numNeighbors < 2)
+    return (double) dataset.n_rows;
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  NeighborSearch<NearestNeighborSort, metric::EuclideanDistance> knn(dataset);
+  knn.Search(numNeighbors, neighbors, distances);
+
+  // Average the inverse of the estimate of each point, as suggested by MacKay
+  // and Ghahramani; this is less biased than averaging the estimates.
+  double sum = 0.0;
+  size_t count = 0;
+  for (size_t i = 0; i < distances.n_cols; ++i)
+  {
+    if (distances(0, i) == 0.0)
+      continue;
+
+    const double logFarthest = std::log(distances(numNeighbors - 1, i));
+    double inverse = 0.0;
+    for (size_t j = 0; j < numNeighbors - 1; ++j)
+      inverse += logFarthest - std::log(distances(j, i));
+
+    sum += inverse / (numNeighbors - 1);
+    ++count;
+  }
+
+  if (count == 0 || sum == 0.0)
+    return 0.0;
+
+  return count / sum;
+}
+
+template<typename SortPolicy>
+std::vector<size_t> NSModelTuner<SortPolicy>::LeafSizes(
+    const size_t dimensionality)
+{
+  // Get the size of the L1 data cache, if the system can tell.
+  size_t cacheSize = 32768;
+  #ifdef _SC_LEVEL1_DCACHE_SIZE
+  const long systemCacheSize = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+  if (systemCacheSize > 0)
+    cacheSize = (size_t) systemCacheSize;
+  #endif
+
+  // Larger leaves are only tried if their points fit in the cache together.
+  const size_t pointSize = std::max(dimensionality, (size_t) 1) *
+      sizeof(double);
+  std::vector<size_t> leafSizes(1, 8);
+  for (size_t leafSize = 16; leafSize <= 64; leafSize *= 2)
+    if (leafSize * pointSize <= cacheSize)
+      leafSizes.push_back(leafSize);
+
+  return leafSizes;
+}
+
+template<typename SortPolicy>
+void NSModelTuner<SortPolicy>::RunTrial(
+    const arma::mat& sample,
+    const arma::mat& queries,
+    const size_t k,
+    const typename NSModel<SortPolicy>::TreeTypes treeType,
+    const size_t leafSize,
+    const NeighborSearchMode searchMode)
+{
+  typedef std::chrono::steady_clock Clock;
+
+  NSModel<SortPolicy> model(treeType);
+  arma::mat referenceCopy(sample);
+  arma::mat queryCopy(queries);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  const Clock::time_point start = Clock::now();
+  model.BuildModel(std::move(referenceCopy), leafSize, searchMode);
+  const Clock::time_point built = Clock::now();
+  model.Search(std::move(queryCopy), k, neighbors, distances);
+  const Clock::time_point end = Clock::now();
+
+  Trial trial;
+  trial.treeType = treeType;
+  trial.leafSize = leafSize;
+  trial.searchMode = searchMode;
+  trial.buildTime = std::chrono::duration<double>(built - start).count();
+  trial.searchTime = std::chrono::duration<double>(end - built).count();
+  trials.push_back(trial);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
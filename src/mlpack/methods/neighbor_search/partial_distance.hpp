@@ -0,0 +1,88 @@
+/**
+ * @file partial_distance.hpp
+ *
+ * Early termination of distance evaluations that cannot improve the list of
+ * candidates of a query point, used by NeighborSearchRules::BaseCaseBlock().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_PARTIAL_DISTANCE_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_PARTIAL_DISTANCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include "sort_policies/nearest_neighbor_sort.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * PartialDistance::Exceeds() returns true only if the distance between the
+ * given query and reference points is certainly worse than the given bound, so
+ * that the reference point cannot be a candidate.  When it returns false, the
+ * distance has to be evaluated as usual.
+ *
+ * By default nothing is known about the metric, so the distance is always
+ * evaluated.
+ */
+template<typename SortPolicy, typename MetricType, typename MatType>
+struct PartialDistance
+{
+  static bool Exceeds(const MatType& /* querySet */,
+                      const size_t /* queryIndex */,
+                      const MatType& /* referenceSet */,
+                      const size_t /* referenceIndex */,
+                      const double /* bound */)
+  {
+    return false;
+  }
+};
+
+/**
+ * For nearest neighbor search with the Euclidean distance, the squared
+ * differences are summed one dimension at a time, and the evaluation stops as
+ * soon as the partial sum is larger than the squared bound.  The bound is
+ * enlarged by a margin that covers the rounding errors of both the partial sum
+ * and the full evaluation, so a point is never skipped when the full
+ * evaluation would tie with the bound; the results are exactly the same as
+ * without early termination.
+ */
+template<bool TakeRoot, typename eT>
+struct PartialDistance<NearestNeighborSort, metric::LMetric<2, TakeRoot>,
+    arma::Mat<eT>>
+{
+  static bool Exceeds(const arma::Mat<eT>& querySet,
+                      const size_t queryIndex,
+                      const arma::Mat<eT>& referenceSet,
+                      const size_t referenceIndex,
+                      const double bound)
+  {
+    if (bound == DBL_MAX)
+      return false;
+
+    const size_t n = querySet.n_rows;
+    const double limit = (TakeRoot ? bound * bound : bound) *
+        (1.0 + 8.0 * (n + 2) * std::numeric_limits<eT>::epsilon());
+
+    const eT* q = querySet.colptr(queryIndex);
+    const eT* r = referenceSet.colptr(referenceIndex);
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double diff = (double) q[i] - (double) r[i];
+      sum += diff * diff;
+      if (sum > limit)
+        return true;
+    }
+
+    return false;
+  }
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * @file quantized_search.hpp
+ *
+ * Definition of the QuantizedSearch class, which stores the reference set with
+ * one byte per dimension and searches it with asymmetric distances.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "sort_policies/nearest_neighbor_sort.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * QuantizedSearch is a brute-force approximate k-nearest-neighbor (or
+ * k-furthest-neighbor) search over a scalar-quantized copy of the reference
+ * set.  Each dimension of the reference set is mapped linearly from its range
+ * [min, max] onto the integers 0 to 255, so each point takes one byte per
+ * dimension instead of eight; the quantization error of each coordinate is at
+ * most (max - min) / 510.
+ *
+ * Distances are asymmetric: queries are not quantized, and the Euclidean
+ * distance between a query and the reconstruction of each reference point is
+ * computed directly from the codes.  Optionally, the best candidates under
+ * this approximate distance can be re-ranked with exact distances computed
+ * from the original reference set (which may be memory-mapped, so that only
+ * the candidates' columns are read):
+ *
+ * @code
+ * QuantizedSearch<> qs(referenceSet);
+ *
+ * // Approximate distances only.
+ * qs.Search(querySet, 10, neighbors, distances);
+ *
+ * // Re-rank the best 100 candidates of each query with exact distances.
+ * qs.Search(querySet, referenceSet, 10, 100, neighbors, distances);
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ */
+template<typename SortPolicy = NearestNeighborSort>
+class QuantizedSearch
+{
+ public:
+  /**
+   * Create an empty QuantizedSearch object.  Be sure to call Train() before
+   * calling Search().
+   */
+  QuantizedSearch() { }
+
+  /**
+   * Quantize the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  QuantizedSearch(const arma::mat& referenceSet);
+
+  /**
+   * Quantize the given reference set, replacing any existing model.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const arma::mat& referenceSet);
+
+  /**
+   * Search for the k neighbors of each point in the query set, using only the
+   * quantized reference set.  The returned distances are approximate.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the approximate distances in.
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Search for the k neighbors of each point in the query set: find the best
+   * numCandidates points using the quantized reference set, then take the best
+   * k of those using exact distances computed from referenceSet.  The returned
+   * distances are exact.
+   *
+   * @param querySet Set of query points.
+   * @param referenceSet The reference set that the model was trained on.
+   * @param k Number of neighbors to search for.
+   * @param numCandidates Number of candidates to re-rank for each query (at
+   *     least k; it is reduced to the size of the reference set if needed).
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the exact distances in.
+   */
+  void Search(const arma::mat& querySet,
+              const arma::mat& referenceSet,
+              const size_t k,
+              const size_t numCandidates,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Return the reconstruction of the given reference point from its codes.
+   *
+   * @param index Index of the reference point.
+   */
+  arma::vec Reconstruct(const size_t index) const;
+
+  //! Get the codes of the reference set (one column per point).
+  const arma::Mat<unsigned char>& Codes() const { return codes; }
+  //! Get the minimum of each dimension.
+  const arma::vec& Minimums() const { return minimums; }
+  //! Get the width of one quantization step in each dimension.
+  const arma::vec& Scales() const { return scales; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Check the query set and k, and set the size of the output matrices.
+  void CheckSearch(const arma::mat& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& neighbors,
+                   arma::mat& distances) const;
+
+  /**
+   * Fill heap with the best numCandidates (squared distance, index) pairs for
+   * the given query, using the quantized reference set.  The heap is ordered so
+   * that its front is the worst candidate.  offsets and steps are work vectors.
+   */
+  void ApproximateCandidates(const double* query,
+                             const size_t numCandidates,
+                             std::vector<std::pair<double, size_t>>& heap,
+                             std::vector<float>& offsets,
+                             std::vector<float>& steps) const;
+
+  //! The code of each dimension of each reference point.
+  arma::Mat<unsigned char> codes;
+  //! The minimum of each dimension.
+  arma::vec minimums;
+  //! The width of one quantization step in each dimension.
+  arma::vec scales;
+
+  //! Compare two candidates based on the distance; better candidates are
+  //! "less than" worse ones.
+  struct CandidateCmp
+  {
+    bool operator()(const std::pair<double, size_t>& c1,
+                    const std::pair<double, size_t>& c2) const
+    {
+      // Break ties by index, so that results don't depend on the order the
+      // candidates are seen in.
+      if (c1.first == c2.first)
+        return c1.second < c2.second;
+      return SortPolicy::IsBetter(c1.first, c2.first);
+    }
+  };
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_search_impl.hpp"
+
+#endif
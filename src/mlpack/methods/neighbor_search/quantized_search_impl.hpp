@@ -0,0 +1,249 @@
+/**
+ * @file quantized_search_impl.hpp
+ *
+ * Implementation of the QuantizedSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantized_search.hpp"
+
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy>
+QuantizedSearch<SortPolicy>::QuantizedSearch(const arma::mat& referenceSet)
+{
+  Train(referenceSet);
+}
+
+template<typename SortPolicy>
+void QuantizedSearch<SortPolicy>::Train(const arma::mat& referenceSet)
+{
+  if (referenceSet.n_elem == 0)
+  {
+    throw std::invalid_argument("QuantizedSearch::Train(): reference set is "
+        "empty!");
+  }
+
+  minimums = arma::min(referenceSet, 1);
+  scales = (arma::max(referenceSet, 1) - minimums) / 255.0;
+
+  codes.set_size(referenceSet.n_rows, referenceSet.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+  {
+    for (size_t d = 0; d < referenceSet.n_rows; ++d)
+    {
+      // Dimensions with only one value always get code 0.
+      if (scales[d] == 0.0)
+      {
+        codes(d, i) = 0;
+        continue;
+      }
+
+      const double step = (referenceSet(d, i) - minimums[d]) / scales[d];
+      codes(d, i) = (unsigned char) std::min(std::floor(step + 0.5), 255.0);
+    }
+  }
+}
+
+template<typename SortPolicy>
+void QuantizedSearch<SortPolicy>::CheckSearch(
+    const arma::mat& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances) const
+{
+  if (querySet.n_rows != codes.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << codes.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > codes.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedSearch::Search(): requested " << k << " neighbors, but "
+        << "reference set has " << codes.n_cols << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+}
+
+template<typename SortPolicy>
+void QuantizedSearch<SortPolicy>::ApproximateCandidates(
+    const double* query,
+    const size_t numCandidates,
+    std::vector<std::pair<double, size_t>>& heap,
+    std::vector<float>& offsets,
+    std::vector<float>& steps) const
+{
+  // The reconstruction of the code c in dimension d is
+  // minimums[d] + c * scales[d], so the difference to the query in that
+  // dimension is offsets[d] - c * steps[d].  The approximate distances are
+  // accumulated in single precision, which is plenty given the quantization
+  // error.
+  const size_t dims = codes.n_rows;
+  offsets.resize(dims);
+  steps.resize(dims);
+  for (size_t d = 0; d < dims; ++d)
+  {
+    offsets[d] = float(query[d] - minimums[d]);
+    steps[d] = float(scales[d]);
+  }
+
+  heap.clear();
+  for (size_t j = 0; j < codes.n_cols; ++j)
+  {
+    const unsigned char* code = codes.colptr(j);
+    float distance = 0.0f;
+    for (size_t d = 0; d < dims; ++d)
+    {
+      const float diff = offsets[d] - steps[d] * float(code[d]);
+      distance += diff * diff;
+    }
+
+    const std::pair<double, size_t> c(distance, j);
+    if (heap.size() < numCandidates)
+    {
+      heap.push_back(c);
+      std::push_heap(heap.begin(), heap.end(), CandidateCmp());
+    }
+    else if (CandidateCmp()(c, heap.front()))
+    {
+      std::pop_heap(heap.begin(), heap.end(), CandidateCmp());
+      heap.back() = c;
+      std::push_heap(heap.begin(), heap.end(), CandidateCmp());
+    }
+  }
+}
+
+template<typename SortPolicy>
+void QuantizedSearch<SortPolicy>::Search(const arma::mat& querySet,
+                                         const size_t k,
+                                         arma::Mat<size_t>& neighbors,
+                                         arma::mat& distances) const
+{
+  CheckSearch(querySet, k, neighbors, distances);
+  if (k == 0)
+    return;
+
+  #pragma omp parallel
+  {
+    std::vector<std::pair<double, size_t>> heap;
+    std::vector<float> offsets, steps;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      ApproximateCandidates(querySet.colptr(i), k, heap, offsets, steps);
+      std::sort_heap(heap.begin(), heap.end(), CandidateCmp());
+
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, i) = heap[j].second;
+        distances(j, i) = std::sqrt(heap[j].first);
+      }
+    }
+  }
+}
+
+template<typename SortPolicy>
+void QuantizedSearch<SortPolicy>::Search(const arma::mat& querySet,
+                                         const arma::mat& referenceSet,
+                                         const size_t k,
+                                         const size_t numCandidates,
+                                         arma::Mat<size_t>& neighbors,
+                                         arma::mat& distances) const
+{
+  CheckSearch(querySet, k, neighbors, distances);
+  if (referenceSet.n_rows != codes.n_rows ||
+      referenceSet.n_cols != codes.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedSearch::Search(): reference set has size "
+        << referenceSet.n_rows << "x" << referenceSet.n_cols << ", but the "
+        << "model was trained on a " << codes.n_rows << "x" << codes.n_cols
+        << " reference set!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numCandidates < k)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedSearch::Search(): number of candidates (" << numCandidates
+        << ") must be at least k (" << k << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k == 0)
+    return;
+
+  const size_t effectiveCandidates = std::min(numCandidates,
+      (size_t) codes.n_cols);
+
+  #pragma omp parallel
+  {
+    std::vector<std::pair<double, size_t>> heap;
+    std::vector<float> offsets, steps;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      ApproximateCandidates(querySet.colptr(i), effectiveCandidates, heap,
+          offsets, steps);
+
+      // Re-rank the candidates with their exact distances.
+      for (size_t j = 0; j < heap.size(); ++j)
+      {
+        heap[j].first = metric::EuclideanDistance::Evaluate(querySet.col(i),
+            referenceSet.col(heap[j].second));
+      }
+
+      std::partial_sort(heap.begin(), heap.begin() + k, heap.end(),
+          CandidateCmp());
+
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, i) = heap[j].second;
+        distances(j, i) = heap[j].first;
+      }
+    }
+  }
+}
+
+template<typename SortPolicy>
+arma::vec QuantizedSearch<SortPolicy>::Reconstruct(const size_t index) const
+{
+  return minimums + scales % arma::conv_to<arma::vec>::from(codes.col(index));
+}
+
+template<typename SortPolicy>
+template<typename Archive>
+void QuantizedSearch<SortPolicy>::serialize(Archive& ar,
+                                            const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(codes);
+  ar & BOOST_SERIALIZATION_NVP(minimums);
+  ar & BOOST_SERIALIZATION_NVP(scales);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
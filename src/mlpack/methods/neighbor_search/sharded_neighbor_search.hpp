@@ -0,0 +1,198 @@
+/**
+ * @file sharded_neighbor_search.hpp
+ *
+ * Definition of the ShardedNeighborSearch class, which splits the reference set
+ * into shards that are searched independently, and merges the k best neighbors
+ * of every shard.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "neighbor_search.hpp"
+
+#include <deque>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * ShardedNeighborSearch splits the reference set into shards of consecutive
+ * points, and builds a separate NeighborSearch object (with its own tree) on
+ * each shard.  Every shard is searched for the k best neighbors of all query
+ * points, and the results of the shards are then merged pairwise, in a tree
+ * reduction, into the k best neighbors overall.  The shards are searched in
+ * parallel with OpenMP, as are the merges of each level of the reduction.
+ *
+ * The results are the same as those of a single NeighborSearch object on the
+ * whole reference set (up to ties), in the same format: the indices of the
+ * neighbors are indices in the whole reference set, in its original order.
+ *
+ * Shards can also be added one at a time with AddShard(), so that they can be
+ * loaded separately; and since the merge works on the output of any search,
+ * results computed on different machines (for instance with the knn program,
+ * one shard per machine) can be merged with Merge() or the knn_merge program,
+ * given the offset of each shard in the whole reference set.
+ *
+ * @code
+ * // Split the reference set into 8 shards.
+ * ShardedNeighborSearch<> sharded(referenceSet, 8);
+ * sharded.Search(querySet, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The tree type to use for each shard.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename MetricType = mlpack::metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class ShardedNeighborSearch
+{
+ public:
+  //! The type of the search object of each shard.
+  typedef NeighborSearch<SortPolicy, MetricType, MatType, TreeType> NSType;
+
+  /**
+   * Create a ShardedNeighborSearch object without any shards.  Shards must be
+   * added with Train() or AddShard() before Search() is called.
+   *
+   * @param mode Neighbor search mode of each shard.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param metric An optional instance of the MetricType class.
+   */
+  ShardedNeighborSearch(const NeighborSearchMode mode = DUAL_TREE_MODE,
+                        const double epsilon = 0,
+                        const MetricType metric = MetricType());
+
+  /**
+   * Split the given reference set into the given number of shards (of nearly
+   * equal size), and build the search object of each shard.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numShards Number of shards.
+   * @param mode Neighbor search mode of each shard.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param metric An optional instance of the MetricType class.
+   */
+  ShardedNeighborSearch(const MatType& referenceSet,
+                        const size_t numShards,
+                        const NeighborSearchMode mode = DUAL_TREE_MODE,
+                        const double epsilon = 0,
+                        const MetricType metric = MetricType());
+
+  /**
+   * Split the given reference set into the given number of shards (of nearly
+   * equal size), replacing any existing shards.  The search objects of the
+   * shards are built in parallel.  A std::invalid_argument is thrown if
+   * numShards is 0 or larger than the number of reference points.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numShards Number of shards.
+   */
+  void Train(const MatType& referenceSet, const size_t numShards);
+
+  /**
+   * Add a shard holding the given points; they get the indices following those
+   * of the points of the existing shards.
+   *
+   * @param shard Points of the shard.
+   */
+  void AddShard(MatType shard);
+
+  /**
+   * Search every shard for the k best neighbors of each point in the query
+   * set, and merge the results.  The matrices will be set to k rows and one
+   * column per query point.  A std::invalid_argument is thrown if there are
+   * fewer than k reference points in all the shards.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Merge two sets of neighbor search results for the same query points into
+   * the k best neighbors of each query point.  Each column of the inputs must
+   * be sorted, best neighbor first, as returned by NeighborSearch::Search();
+   * the inputs can have different numbers of rows.  The given offsets are added
+   * to the indices of each input (except to the indices of missing neighbors,
+   * size_t() - 1).  If there are fewer than k neighbors in the inputs, the
+   * missing neighbors get the index size_t() - 1 and the distance
+   * SortPolicy::WorstDistance().
+   *
+   * @param neighbors1 Neighbors of the first results.
+   * @param distances1 Distances of the first results.
+   * @param offset1 Offset to add to the indices of the first results.
+   * @param neighbors2 Neighbors of the second results.
+   * @param distances2 Distances of the second results.
+   * @param offset2 Offset to add to the indices of the second results.
+   * @param k Number of neighbors to keep.
+   * @param neighbors Matrix to store the merged neighbors in.
+   * @param distances Matrix to store the merged distances in.
+   */
+  static void Merge(const arma::Mat<size_t>& neighbors1,
+                    const arma::mat& distances1,
+                    const size_t offset1,
+                    const arma::Mat<size_t>& neighbors2,
+                    const arma::mat& distances2,
+                    const size_t offset2,
+                    const size_t k,
+                    arma::Mat<size_t>& neighbors,
+                    arma::mat& distances);
+
+  //! Get the number of shards.
+  size_t NumShards() const { return shards.size(); }
+  //! Get the search object of the given shard.
+  const NSType& Shard(const size_t i) const { return shards[i]; }
+  //! Modify the search object of the given shard.
+  NSType& Shard(const size_t i) { return shards[i]; }
+  //! Get the index of the first point of each shard, followed by the total
+  //! number of reference points.
+  const std::vector<size_t>& Offsets() const { return offsets; }
+
+  //! Get the search mode of the shards.
+  NeighborSearchMode SearchMode() const { return searchMode; }
+  //! Get the relative approximate error of the shards.
+  double Epsilon() const { return epsilon; }
+
+  //! Serialize the shards.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The search object of each shard (a deque, so that adding a shard doesn't
+  //! copy the others).
+  std::deque<NSType> shards;
+  //! The index of the first point of each shard, and the number of points.
+  std::vector<size_t> offsets;
+  //! The search mode of the shards.
+  NeighborSearchMode searchMode;
+  //! The relative approximate error of the shards.
+  double epsilon;
+  //! The metric of the shards.
+  MetricType metric;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "sharded_neighbor_search_impl.hpp"
+
+#endif
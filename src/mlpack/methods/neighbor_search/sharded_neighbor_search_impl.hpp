@@ -0,0 +1,295 @@
+/**
+ * @file sharded_neighbor_search_impl.hpp
+ *
+ * Implementation of the ShardedNeighborSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sharded_neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+ShardedNeighborSearch(const NeighborSearchMode mode,
+                      const double epsilon,
+                      const MetricType metric) :
+    offsets(1, 0),
+    searchMode(mode),
+    epsilon(epsilon),
+    metric(metric)
+{
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+ShardedNeighborSearch(const MatType& referenceSet,
+                      const size_t numShards,
+                      const NeighborSearchMode mode,
+                      const double epsilon,
+                      const MetricType metric) :
+    offsets(1, 0),
+    searchMode(mode),
+    epsilon(epsilon),
+    metric(metric)
+{
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+
+  Train(referenceSet, numShards);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::Train(
+    const MatType& referenceSet,
+    const size_t numShards)
+{
+  if (numShards == 0 || numShards > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "ShardedNeighborSearch::Train(): the number of shards ("
+        << numShards << ") must be positive and at most the number of "
+        << "reference points (" << referenceSet.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The first referenceSet.n_cols % numShards shards get one more point.
+  offsets.resize(numShards + 1);
+  offsets[0] = 0;
+  for (size_t s = 0; s < numShards; ++s)
+  {
+    offsets[s + 1] = offsets[s] + referenceSet.n_cols / numShards +
+        ((s < referenceSet.n_cols % numShards) ? 1 : 0);
+  }
+
+  shards.clear();
+  shards.resize(numShards);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t s = 0; s < (omp_size_t) numShards; ++s)
+  {
+    shards[s] = NSType(MatType(referenceSet.cols(offsets[s],
+        offsets[s + 1] - 1)), searchMode, epsilon, metric);
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::AddShard(
+    MatType shard)
+{
+  if (shard.n_cols == 0)
+    throw std::invalid_argument("ShardedNeighborSearch::AddShard(): the shard "
+        "is empty!");
+
+  if (!shards.empty() && shard.n_rows != shards[0].ReferenceSet().n_rows)
+  {
+    std::ostringstream oss;
+    oss << "ShardedNeighborSearch::AddShard(): the dimensionality of the shard "
+        << "(" << shard.n_rows << ") is not the dimensionality of the other "
+        << "shards (" << shards[0].ReferenceSet().n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  offsets.push_back(offsets.back() + shard.n_cols);
+  shards.emplace_back(std::move(shard), searchMode, epsilon, metric);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  if (shards.empty())
+    throw std::invalid_argument("ShardedNeighborSearch::Search(): no shards "
+        "have been added!");
+
+  if (k > offsets.back())
+  {
+    std::ostringstream oss;
+    oss << "ShardedNeighborSearch::Search(): requested " << k << " neighbors, "
+        << "but the shards only hold " << offsets.back() << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Search each shard, and turn the indices of the results into indices in the
+  // whole reference set.
+  const size_t numShards = shards.size();
+  std::vector<arma::Mat<size_t>> shardNeighbors(numShards);
+  std::vector<arma::mat> shardDistances(numShards);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t s = 0; s < (omp_size_t) numShards; ++s)
+  {
+    const size_t shardK = std::min(k, offsets[s + 1] - offsets[s]);
+    shards[s].Search(querySet, shardK, shardNeighbors[s], shardDistances[s]);
+
+    for (size_t i = 0; i < shardNeighbors[s].n_elem; ++i)
+      if (shardNeighbors[s][i] != size_t() - 1)
+        shardNeighbors[s][i] += offsets[s];
+  }
+
+  // Merge the results pairwise: at each level, the results of shard s are
+  // merged with those of shard s + step.
+  for (size_t step = 1; step < numShards; step *= 2)
+  {
+    const size_t numMerges = (numShards + 2 * step - 1) / (2 * step);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t m = 0; m < (omp_size_t) numMerges; ++m)
+    {
+      const size_t s = 2 * step * m;
+      if (s + step >= numShards)
+        continue;
+
+      Merge(shardNeighbors[s], shardDistances[s], 0, shardNeighbors[s + step],
+          shardDistances[s + step], 0, k, shardNeighbors[s], shardDistances[s]);
+      shardNeighbors[s + step].reset();
+      shardDistances[s + step].reset();
+    }
+  }
+
+  neighbors = std::move(shardNeighbors[0]);
+  distances = std::move(shardDistances[0]);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::Merge(
+    const arma::Mat<size_t>& neighbors1,
+    const arma::mat& distances1,
+    const size_t offset1,
+    const arma::Mat<size_t>& neighbors2,
+    const arma::mat& distances2,
+    const size_t offset2,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  if (neighbors1.n_rows != distances1.n_rows ||
+      neighbors1.n_cols != distances1.n_cols ||
+      neighbors2.n_rows != distances2.n_rows ||
+      neighbors2.n_cols != distances2.n_cols)
+  {
+    throw std::invalid_argument("ShardedNeighborSearch::Merge(): the neighbors "
+        "and distances of each result must have the same size!");
+  }
+
+  if (neighbors1.n_cols != neighbors2.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "ShardedNeighborSearch::Merge(): the results have different numbers "
+        << "of query points (" << neighbors1.n_cols << " and "
+        << neighbors2.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The outputs may be the same matrices as the inputs.
+  arma::Mat<size_t> mergedNeighbors(k, neighbors1.n_cols);
+  arma::mat mergedDistances(k, neighbors1.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t q = 0; q < (omp_size_t) neighbors1.n_cols; ++q)
+  {
+    size_t i = 0, j = 0;
+    for (size_t r = 0; r < k; ++r)
+    {
+      // The first results win ties.
+      if (i < neighbors1.n_rows && (j == neighbors2.n_rows ||
+          !SortPolicy::IsBetter(distances2(j, q), distances1(i, q))))
+      {
+        const size_t index = neighbors1(i, q);
+        mergedNeighbors(r, q) = (index == size_t() - 1) ? index :
+            index + offset1;
+        mergedDistances(r, q) = distances1(i++, q);
+      }
+      else if (j < neighbors2.n_rows)
+      {
+        const size_t index = neighbors2(j, q);
+        mergedNeighbors(r, q) = (index == size_t() - 1) ? index :
+            index + offset2;
+        mergedDistances(r, q) = distances2(j++, q);
+      }
+      else
+      {
+        mergedNeighbors(r, q) = size_t() - 1;
+        mergedDistances(r, q) = SortPolicy::WorstDistance();
+      }
+    }
+  }
+
+  neighbors = std::move(mergedNeighbors);
+  distances = std::move(mergedDistances);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename Archive>
+void ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(searchMode);
+  ar & BOOST_SERIALIZATION_NVP(epsilon);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+  ar & BOOST_SERIALIZATION_NVP(offsets);
+
+  size_t numShards = shards.size();
+  ar & BOOST_SERIALIZATION_NVP(numShards);
+  if (Archive::is_loading::value)
+  {
+    shards.clear();
+    shards.resize(numShards);
+  }
+
+  for (size_t s = 0; s < numShards; ++s)
+    ar & boost::serialization::make_nvp("shard", shards[s]);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
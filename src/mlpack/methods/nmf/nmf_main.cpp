@@ -20,6 +20,7 @@
 #include <mlpack/methods/amf/update_rules/nmf_mult_dist.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_mult_div.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
+#include <mlpack/methods/amf/update_rules/nmf_nnls.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
 
 using namespace mlpack;
@@ -48,6 +49,10 @@ PROGRAM_INFO("Non-negative Matrix Factorization", "This program performs "
     " - multdiv: multiplicative divergence-based update rules (Lee and Seung "
     "1999)\n"
     " - als: alternating least squares update rules (Paatero and Tapper 1994)"
+    "\n"
+    " - nnls: alternating nonnegative least squares update rules, solved "
+    "exactly with block principal pivoting (Kim and Park 2011); each update "
+    "solves the problems of the columns in parallel"
     "\n\n"
     "The maximum number of iterations is specified with " +
     PRINT_PARAM_STRING("max_iterations") + ", and the minimum residue "
@@ -75,7 +80,7 @@ PARAM_DOUBLE_IN("min_residue", "The minimum root mean square residue allowed "
     "for each iteration, below which the program terminates.", "e", 1e-5);
 
 PARAM_STRING_IN("update_rules", "Update rules for each iteration; ( multdist | "
-    "multdiv | als ).", "u", "multdist");
+    "multdiv | als | nnls ).", "u", "multdist");
 
 PARAM_MATRIX_IN("initial_w", "Initial W matrix.", "p");
 PARAM_MATRIX_IN("initial_h", "Initial H matrix.", "q");
@@ -97,8 +102,8 @@ static void mlpackMain()
   // Validate parameters.
   RequireParamValue<int>("rank", [](int x) { return x > 0; }, true,
       "the rank of the factorization must be greater than 0");
-  RequireParamInSet<string>("update_rules", { "multdist", "multdiv", "als" },
-      true, "unknown update rules");
+  RequireParamInSet<string>("update_rules", { "multdist", "multdiv", "als",
+      "nnls" }, true, "unknown update rules");
   RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; },
       true, "max_iterations must be non-negative");
 
@@ -184,6 +189,31 @@ static void mlpackMain()
       amf.Apply(V, r, W, H);
     }
   }
+  else if (updateRules == "nnls")
+  {
+    Log::Info << "Performing NMF with alternating nonnegative least squares "
+        << "update rules." << std::endl;
+
+    SimpleResidueTermination srt(minResidue, maxIterations);
+    if (CLI::HasParam("initial_w"))
+    {
+      // Initialization with given W, H matrices.
+      GivenInitialization ginit = GivenInitialization(
+          std::move(CLI::GetParam<arma::mat>("initial_w")),
+          std::move(CLI::GetParam<arma::mat>("initial_h")));
+      AMF<SimpleResidueTermination,
+          GivenInitialization,
+          NMFNNLSUpdate> amf(srt, ginit);
+      amf.Apply(V, r, W, H);
+    }
+    else
+    {
+      AMF<SimpleResidueTermination,
+        RandomInitialization,
+        NMFNNLSUpdate> amf(srt);
+      amf.Apply(V, r, W, H);
+    }
+  }
 
   // Save results.
   if (CLI::HasParam("w"))
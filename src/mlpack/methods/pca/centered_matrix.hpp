@@ -0,0 +1,124 @@
+/**
+ * @file centered_matrix.hpp
+ *
+ * A view of a dataset with its mean subtracted from every point (and possibly
+ * scaled by the standard deviation of each dimension) that never forms the
+ * centered matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_CENTERED_MATRIX_HPP
+#define MLPACK_METHODS_PCA_CENTERED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * CenteredMatrix represents the matrix C = D^-1 (X - mu 1^T), where X is the
+ * dataset (one point per column), mu is the mean of the points, and D is
+ * either the identity or, if the data is scaled, the diagonal matrix of the
+ * standard deviations of the dimensions.  Products with C, its covariance and
+ * projections of C are computed from X, mu and D directly, so no copy of the
+ * dataset is made; this lets PCA work on datasets that only fit in memory
+ * once.
+ *
+ * The dataset is held by reference, so it must outlive the CenteredMatrix and
+ * must not be modified while the CenteredMatrix is in use.
+ */
+class CenteredMatrix
+{
+ public:
+  /**
+   * Compute the mean of the given dataset and, if scale is true, the
+   * standard deviation of each dimension.  Dimensions with zero standard
+   * deviation are divided by 1e-50 instead.
+   *
+   * @param data Dataset to center.
+   * @param scale Whether to scale each dimension by its standard deviation.
+   */
+  CenteredMatrix(const arma::mat& data, const bool scale = false);
+
+  /**
+   * Compute result = C * x.
+   *
+   * @param x Matrix with as many rows as the dataset has points.
+   * @param result Matrix to store the product in.
+   */
+  void Multiply(const arma::mat& x, arma::mat& result) const;
+
+  /**
+   * Compute result = C^T * y.
+   *
+   * @param y Matrix with as many rows as the dataset has dimensions.
+   * @param result Matrix to store the product in.
+   */
+  void TransposeMultiply(const arma::mat& y, arma::mat& result) const;
+
+  /**
+   * Compute result = basis^T * C, the projection of the centered points on
+   * the columns of the given basis.  The result may be the dataset itself, in
+   * which case the CenteredMatrix must not be used afterwards.
+   *
+   * @param basis Matrix with as many rows as the dataset has dimensions.
+   * @param result Matrix to store the projection in.
+   */
+  void Project(const arma::mat& basis, arma::mat& result) const;
+
+  /**
+   * Compute the covariance matrix C * C^T / (n - 1).  The outer products are
+   * accumulated over blocks of points in parallel, each block being centered
+   * in a small buffer; this is the cheapest way to get the exact principal
+   * components when there are far fewer dimensions than points.
+   *
+   * @param covariance Matrix to store the covariance in.
+   */
+  void Covariance(arma::mat& covariance) const;
+
+  /**
+   * Form the centered (and scaled) matrix explicitly, for the decomposition
+   * methods that need it.
+   *
+   * @param centered Matrix to store C in.
+   */
+  void Materialize(arma::mat& centered) const;
+
+  //! Get the (uncentered) dataset.
+  const arma::mat& Data() const { return data; }
+  //! Get the mean of the points.
+  const arma::vec& Mean() const { return mean; }
+  //! Get whether each dimension is scaled by its standard deviation.
+  bool Scaled() const { return scaled; }
+  //! Get the standard deviation of each dimension (empty if not scaled).
+  const arma::vec& StdDev() const { return stdDev; }
+
+  //! Get the number of dimensions.
+  size_t NumRows() const { return data.n_rows; }
+  //! Get the number of points.
+  size_t NumCols() const { return data.n_cols; }
+
+ private:
+  //! The number of points handled by one thread at once.
+  static const size_t BlockSize = 256;
+
+  //! The dataset.
+  const arma::mat& data;
+  //! The mean of the points.
+  arma::vec mean;
+  //! Whether each dimension is scaled by its standard deviation.
+  bool scaled;
+  //! The standard deviation of each dimension, if scaled.
+  arma::vec stdDev;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+// Include implementation.
+#include "centered_matrix_impl.hpp"
+
+#endif
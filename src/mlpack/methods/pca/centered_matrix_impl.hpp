@@ -0,0 +1,191 @@
+/**
+ * @file centered_matrix_impl.hpp
+ *
+ * Implementation of the CenteredMatrix class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_CENTERED_MATRIX_IMPL_HPP
+#define MLPACK_METHODS_PCA_CENTERED_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "centered_matrix.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace pca {
+
+inline CenteredMatrix::CenteredMatrix(const arma::mat& data,
+                                      const bool scale) :
+    data(data),
+    scaled(scale)
+{
+  #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+  #else
+    const size_t numThreads = 1;
+  #endif
+
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+
+  // Each thread sums its blocks of points; the sums are added in a fixed
+  // order, so the result doesn't depend on the scheduling.
+  std::vector<arma::vec> partials(numThreads,
+      arma::zeros<arma::vec>(data.n_rows));
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    #ifdef HAS_OPENMP
+      arma::vec& partial = partials[omp_get_thread_num()];
+    #else
+      arma::vec& partial = partials[0];
+    #endif
+
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) data.n_cols);
+    partial += arma::sum(data.cols(begin, end - 1), 1);
+  }
+
+  mean = std::move(partials[0]);
+  for (size_t t = 1; t < numThreads; ++t)
+    mean += partials[t];
+  if (data.n_cols > 0)
+    mean /= data.n_cols;
+
+  if (!scale)
+    return;
+
+  for (size_t t = 0; t < numThreads; ++t)
+    partials[t].zeros(data.n_rows);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    #ifdef HAS_OPENMP
+      arma::vec& partial = partials[omp_get_thread_num()];
+    #else
+      arma::vec& partial = partials[0];
+    #endif
+
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) data.n_cols);
+    arma::mat block = data.cols(begin, end - 1);
+    block.each_col() -= mean;
+    partial += arma::sum(arma::square(block), 1);
+  }
+
+  stdDev = std::move(partials[0]);
+  for (size_t t = 1; t < numThreads; ++t)
+    stdDev += partials[t];
+  if (data.n_cols > 1)
+    stdDev = arma::sqrt(stdDev / (data.n_cols - 1));
+  else
+    stdDev.zeros();
+
+  // If there are any zeroes, make them very small.
+  for (size_t i = 0; i < stdDev.n_elem; ++i)
+    if (stdDev[i] == 0)
+      stdDev[i] = 1e-50;
+}
+
+inline void CenteredMatrix::Multiply(const arma::mat& x,
+                                     arma::mat& result) const
+{
+  // (X - mu 1^T) x = X x - mu (1^T x).
+  result = data * x;
+  result -= mean * arma::sum(x, 0);
+
+  if (scaled)
+    result.each_col() /= stdDev;
+}
+
+inline void CenteredMatrix::TransposeMultiply(const arma::mat& y,
+                                              arma::mat& result) const
+{
+  arma::mat scaledY = y;
+  if (scaled)
+    scaledY.each_col() /= stdDev;
+
+  // (X - mu 1^T)^T y = X^T y - 1 (mu^T y).
+  result = data.t() * scaledY;
+  result.each_row() -= mean.t() * scaledY;
+}
+
+inline void CenteredMatrix::Project(const arma::mat& basis,
+                                    arma::mat& result) const
+{
+  arma::mat scaledBasis = basis;
+  if (scaled)
+    scaledBasis.each_col() /= stdDev;
+
+  // The offsets must be computed before the result is written, since it may
+  // be the dataset.
+  const arma::vec offsets = scaledBasis.t() * mean;
+  result = scaledBasis.t() * data;
+  result.each_col() -= offsets;
+}
+
+inline void CenteredMatrix::Covariance(arma::mat& covariance) const
+{
+  #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+  #else
+    const size_t numThreads = 1;
+  #endif
+
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+
+  std::vector<arma::mat> partials(numThreads,
+      arma::zeros<arma::mat>(data.n_rows, data.n_rows));
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    #ifdef HAS_OPENMP
+      arma::mat& partial = partials[omp_get_thread_num()];
+    #else
+      arma::mat& partial = partials[0];
+    #endif
+
+    // Centering each block before its outer products are taken is more
+    // accurate than subtracting n mu mu^T at the end.
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) data.n_cols);
+    arma::mat block = data.cols(begin, end - 1);
+    block.each_col() -= mean;
+    partial += block * block.t();
+  }
+
+  covariance = std::move(partials[0]);
+  for (size_t t = 1; t < numThreads; ++t)
+    covariance += partials[t];
+
+  if (scaled)
+  {
+    covariance.each_col() /= stdDev;
+    covariance.each_row() /= stdDev.t();
+  }
+
+  covariance /= (data.n_cols - 1);
+}
+
+inline void CenteredMatrix::Materialize(arma::mat& centered) const
+{
+  centered = data;
+  centered.each_col() -= mean;
+
+  if (scaled)
+    centered.each_col() /= stdDev;
+}
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
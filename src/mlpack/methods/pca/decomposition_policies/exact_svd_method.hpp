@@ -17,6 +17,7 @@
 #define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_EXACT_SVD_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/pca/centered_matrix.hpp>
 
 namespace mlpack {
 namespace pca {
@@ -69,6 +70,52 @@ class ExactSVDPolicy
     // Project the samples to the principals.
     transformedData = arma::trans(eigvec) * centeredData;
   }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set using the
+   * exact SVD method, without forming the centered data.  When there are no
+   * more dimensions than points, the principal components are the
+   * eigenvectors of the covariance matrix, which is accumulated blockwise and
+   * in parallel.  Otherwise, the covariance matrix would be larger than the
+   * data, so the centered data is formed and decomposed as usual.
+   *
+   * @param centeredData Centered data.
+   * @param transformedData Matrix to put results of PCA into; it may be the
+   *     dataset of centeredData.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const CenteredMatrix& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    if (centeredData.NumRows() > centeredData.NumCols())
+    {
+      arma::mat centered;
+      centeredData.Materialize(centered);
+      Apply(centeredData.Data(), centered, transformedData, eigVal, eigvec,
+          rank);
+      return;
+    }
+
+    arma::mat covariance;
+    centeredData.Covariance(covariance);
+
+    // The eigenvalues are given in increasing order.
+    arma::vec values;
+    arma::mat vectors;
+    arma::eig_sym(values, vectors, covariance);
+
+    // Rounding can make the smallest eigenvalues slightly negative.
+    eigVal = arma::clamp(arma::flipud(values), 0.0, DBL_MAX);
+    eigvec = arma::fliplr(vectors);
+
+    // Project the samples to the principals.
+    centeredData.Project(eigvec, transformedData);
+  }
 };
 
 } // namespace pca
@@ -77,6 +77,29 @@ class RandomizedBlockKrylovSVDPolicy
     transformedData = arma::trans(eigvec) * centeredData;
   }
 
+  /**
+   * Apply Principal Component Analysis to a data set that is read from disk
+   * one chunk of columns at a time, using the randomized block krylov SVD.
+   * The data is centered on the fly; the transformed data is not computed,
+   * since it has as many columns as the data.
+   *
+   * @param data Dataset to read.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(data::StreamingDataset<>& data,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    svd::RandomizedBlockKrylovSVD rsvd(maxIterations, blockSize);
+    rsvd.Apply(data, eigvec, eigVal, rank, true);
+
+    // The covariance matrix is X * X' / (N - 1).
+    eigVal %= eigVal / (data.NumCols() - 1);
+  }
+
   //! Get the number of iterations for the power method.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the number of iterations for the power method.
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/randomized_svd/randomized_svd.hpp>
+#include <mlpack/methods/pca/centered_matrix.hpp>
 
 namespace mlpack {
 namespace pca {
@@ -77,6 +78,74 @@ class RandomizedSVDPolicy
     transformedData = arma::trans(eigvec) * centeredData;
   }
 
+  /**
+   * Apply Principal Component Analysis to the provided data set using the
+   * randomized SVD, without forming the centered data: the randomized SVD
+   * subtracts the mean from its products with the data.  If the data is
+   * scaled, the centered and scaled data has to be formed.
+   *
+   * @param centeredData Centered data.
+   * @param transformedData Matrix to put results of PCA into; it may be the
+   *     dataset of centeredData.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const CenteredMatrix& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    // This matrix will store the right singular values; we do not need them.
+    arma::mat v;
+
+    svd::RandomizedSVD rsvd(iteratedPower, maxIterations);
+    if (centeredData.Scaled())
+    {
+      arma::mat centered;
+      centeredData.Materialize(centered);
+      rsvd.Apply(centered, eigvec, eigVal, v, rank,
+          arma::mat(centered.n_rows, 1, arma::fill::zeros));
+    }
+    else
+    {
+      rsvd.Apply(centeredData.Data(), eigvec, eigVal, v, rank,
+          arma::mat(centeredData.Mean()));
+    }
+
+    // Now we must square the singular values to get the eigenvalues.
+    // In addition we must divide by the number of points, because the
+    // covariance matrix is X * X' / (N - 1).
+    eigVal %= eigVal / (centeredData.NumCols() - 1);
+
+    // Project the samples to the principals.
+    centeredData.Project(eigvec, transformedData);
+  }
+
+  /**
+   * Apply Principal Component Analysis to a data set that is read from disk
+   * one chunk of columns at a time, using the randomized SVD.  The data is
+   * centered on the fly; the transformed data is not computed, since it has as
+   * many columns as the data.
+   *
+   * @param data Dataset to read.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(data::StreamingDataset<>& data,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    svd::RandomizedSVD rsvd(iteratedPower, maxIterations);
+    rsvd.Apply(data, eigvec, eigVal, rank, true);
+
+    // The covariance matrix is X * X' / (N - 1).
+    eigVal %= eigVal / (data.NumCols() - 1);
+  }
+
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
   //! Modify the size of the normalized power iterations.
@@ -17,11 +17,38 @@
 #define MLPACK_METHODS_PCA_PCA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/streaming_dataset.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+#include <mlpack/methods/pca/centered_matrix.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
 
 namespace mlpack {
 namespace pca {
 
+/**
+ * This gives us a HasCenteredApplyCheck object that we can use to tell whether
+ * a DecompositionPolicy can work with a CenteredMatrix.
+ */
+HAS_MEM_FUNC(Apply, HasCenteredApplyCheck);
+
+/**
+ * 'value' is true if the DecompositionPolicy class has a member
+ * Apply(const CenteredMatrix& centeredData, arma::mat& transformedData,
+ * arma::vec& eigVal, arma::mat& eigvec, const size_t rank), so that PCA
+ * doesn't need to make a centered copy of the data.
+ */
+template<typename DecompositionPolicy>
+struct HasCenteredApply
+{
+  static const bool value =
+    HasCenteredApplyCheck<DecompositionPolicy,
+        void(DecompositionPolicy::*)(const CenteredMatrix&,
+                                     arma::mat&,
+                                     arma::vec&,
+                                     arma::mat&,
+                                     const size_t)>::value;
+};
+
 /**
  * This class implements principal components analysis (PCA). This is a
  * common, widely-used technique that is often used for either dimensionality
@@ -104,6 +131,24 @@ class PCA
    */
   double Apply(arma::mat& data, const double varRetained);
 
+  /**
+   * Apply Principal Component Analysis to a data set that is read from disk
+   * one chunk of columns at a time, computing only the given number of
+   * principal components.  The data is centered on the fly and is never held
+   * in memory as a whole.  This is only available for the decomposition
+   * policies that can work with streamed data (RandomizedSVDPolicy and
+   * RandomizedBlockKrylovSVDPolicy), and the data can't be scaled.
+   *
+   * @param data Dataset to read.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Number of principal components to compute.
+   */
+  void Apply(data::StreamingDataset<>& data,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank);
+
   //! Get whether or not this PCA object will scale (by standard deviation)
   //! the data when PCA is performed.
   bool ScaleData() const { return scaleData; }
@@ -112,6 +157,34 @@ class PCA
   bool& ScaleData() { return scaleData; }
 
  private:
+  /**
+   * Decompose the data with a policy that works with a CenteredMatrix, so the
+   * data is never copied.  It is safe to pass the same matrix reference for
+   * both data and transformedData.
+   */
+  template<typename Policy = DecompositionPolicy>
+  void Decompose(const arma::mat& data,
+                 arma::mat& transformedData,
+                 arma::vec& eigVal,
+                 arma::mat& eigvec,
+                 const size_t rank,
+                 const typename std::enable_if_t<
+                     HasCenteredApply<Policy>::value>* = 0);
+
+  /**
+   * Decompose the data with a policy that needs the centered (and scaled)
+   * data.  It is safe to pass the same matrix reference for both data and
+   * transformedData.
+   */
+  template<typename Policy = DecompositionPolicy>
+  void Decompose(const arma::mat& data,
+                 arma::mat& transformedData,
+                 arma::vec& eigVal,
+                 arma::mat& eigvec,
+                 const size_t rank,
+                 const typename std::enable_if_t<
+                     !HasCenteredApply<Policy>::value>* = 0);
+
   //! Scaling the data is when we reduce the variance of each dimension to 1.
   void ScaleData(arma::mat& centeredData)
   {
@@ -48,15 +48,7 @@ void PCA<DecompositionPolicy>::Apply(const arma::mat& data,
 {
   Timer::Start("pca");
 
-  // Center the data into a temporary matrix.
-  arma::mat centeredData;
-  math::Center(data, centeredData);
-
-  // Scale the data if the user ask for.
-  ScaleData(centeredData);
-
-  decomposition.Apply(data, centeredData, transformedData, eigVal, eigvec,
-      data.n_rows);
+  Decompose(data, transformedData, eigVal, eigvec, data.n_rows);
 
   Timer::Stop("pca");
 }
@@ -77,6 +69,25 @@ void PCA<DecompositionPolicy>::Apply(const arma::mat& data,
   Apply(data, transformedData, eigVal, eigvec);
 }
 
+template<typename DecompositionPolicy>
+void PCA<DecompositionPolicy>::Apply(data::StreamingDataset<>& data,
+                                     arma::vec& eigVal,
+                                     arma::mat& eigvec,
+                                     const size_t rank)
+{
+  if (scaleData)
+  {
+    Log::Fatal << "PCA::Apply(): streamed data can't be scaled!"
+        << std::endl;
+  }
+
+  Timer::Start("pca");
+
+  decomposition.Apply(data, eigVal, eigvec, rank);
+
+  Timer::Stop("pca");
+}
+
 /**
  * Use PCA for dimensionality reduction on the given dataset.  This will save
  * the newDimension largest principal components of the data and remove the
@@ -106,14 +117,7 @@ double PCA<DecompositionPolicy>::Apply(arma::mat& data,
 
   Timer::Start("pca");
 
-  // Center the data into a temporary matrix.
-  arma::mat centeredData;
-  math::Center(data, centeredData);
-
-  // Scale the data if the user ask for.
-  ScaleData(centeredData);
-
-  decomposition.Apply(data, centeredData, data, eigVal, eigvec, newDimension);
+  Decompose(data, data, eigVal, eigvec, newDimension);
 
   if (newDimension < eigvec.n_rows)
     // Drop unnecessary rows.
@@ -173,6 +177,43 @@ double PCA<DecompositionPolicy>::Apply(arma::mat& data,
   return varSum;
 }
 
+template<typename DecompositionPolicy>
+template<typename Policy>
+void PCA<DecompositionPolicy>::Decompose(
+    const arma::mat& data,
+    arma::mat& transformedData,
+    arma::vec& eigVal,
+    arma::mat& eigvec,
+    const size_t rank,
+    const typename std::enable_if_t<HasCenteredApply<Policy>::value>*)
+{
+  // The mean (and the standard deviations) are subtracted on the fly.
+  CenteredMatrix centeredData(data, scaleData);
+
+  decomposition.Apply(centeredData, transformedData, eigVal, eigvec, rank);
+}
+
+template<typename DecompositionPolicy>
+template<typename Policy>
+void PCA<DecompositionPolicy>::Decompose(
+    const arma::mat& data,
+    arma::mat& transformedData,
+    arma::vec& eigVal,
+    arma::mat& eigvec,
+    const size_t rank,
+    const typename std::enable_if_t<!HasCenteredApply<Policy>::value>*)
+{
+  // Center the data into a temporary matrix.
+  arma::mat centeredData;
+  math::Center(data, centeredData);
+
+  // Scale the data if the user ask for.
+  ScaleData(centeredData);
+
+  decomposition.Apply(data, centeredData, transformedData, eigVal, eigvec,
+      rank);
+}
+
 } // namespace pca
 } // namespace mlpack
 
@@ -26,6 +26,14 @@ namespace perceptron {
  * network).  It converges if the supplied training dataset is linearly
  * separable.
  *
+ * By default the weights are updated after each misclassified point.  If the
+ * batch size is larger than 1, the points are instead scored in mini-batches
+ * with one matrix product per batch, and the updates of all the misclassified
+ * points of a batch are added up and applied at once (the batch perceptron).
+ * The points of a large batch are split into blocks that are scored in
+ * parallel with OpenMP, so with a batch size of the whole dataset each pass is
+ * parallel; the result doesn't depend on the number of threads.
+ *
  * @tparam LearnPolicy Options of SimpleWeightUpdate and GradientDescent.
  * @tparam WeightInitializationPolicy Option of ZeroInitialization and
  *      RandomInitialization.
@@ -45,10 +53,13 @@ class Perceptron
    * @param dimensionality Dimensionality of the dataset.
    * @param maxIterations Maximum number of iterations for the perceptron
    *      learning algorithm.
+   * @param batchSize Number of points in each mini-batch; 1 updates the weights
+   *      after each point.
    */
   Perceptron(const size_t numClasses = 0,
              const size_t dimensionality = 0,
-             const size_t maxIterations = 1000);
+             const size_t maxIterations = 1000,
+             const size_t batchSize = 1);
 
   /**
    * Constructor: constructs the perceptron by building the weights matrix,
@@ -62,15 +73,18 @@ class Perceptron
    * @param numClasses Number of classes in the dataset.
    * @param maxIterations Maximum number of iterations for the perceptron
    *      learning algorithm.
+   * @param batchSize Number of points in each mini-batch; 1 updates the weights
+   *      after each point.
    */
   Perceptron(const MatType& data,
              const arma::Row<size_t>& labels,
              const size_t numClasses,
-             const size_t maxIterations = 1000);
+             const size_t maxIterations = 1000,
+             const size_t batchSize = 1);
 
   /**
-   * Alternate constructor which copies parameters from an already initiated
-   * perceptron.
+   * Alternate constructor which copies parameters (the maximum number of
+   * iterations and the batch size) from an already initiated perceptron.
    *
    * @param other The other initiated Perceptron object from which we copy the
    *       values from.
@@ -120,13 +134,18 @@ class Perceptron
    * Serialize the perceptron.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
   //! Get the maximum number of iterations.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of points in each mini-batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each mini-batch.
+  size_t& BatchSize() { return batchSize; }
+
   //! Get the number of classes this perceptron has been trained for.
   size_t NumClasses() const { return weights.n_cols; }
 
@@ -141,9 +160,24 @@ class Perceptron
   arma::vec& Biases() { return biases; }
 
  private:
+  /**
+   * Make one pass over the data, updating the weights after each mini-batch.
+   *
+   * @param data Dataset on which training should be performed.
+   * @param labels Labels of the dataset.
+   * @param instanceWeights Cost of mispredicting each point (or empty).
+   * @return Whether all the points were classified correctly.
+   */
+  bool TrainBatches(const MatType& data,
+                    const arma::Row<size_t>& labels,
+                    const arma::rowvec& instanceWeights);
+
   //! The maximum number of iterations during training.
   size_t maxIterations;
 
+  //! The number of points in each mini-batch.
+  size_t batchSize;
+
   /**
    * Stores the weights for each of the input class labels.  Each column
    * corresponds to the weights for one class label, and each row corresponds to
@@ -159,6 +193,25 @@ class Perceptron
 } // namespace perceptron
 } // namespace mlpack
 
+//! Set the serialization version of the Perceptron class.  Version 1 stores
+//! the batch size.
+namespace boost {
+namespace serialization {
+
+template<typename LearnPolicy,
+         typename WeightInitializationPolicy,
+         typename MatType>
+struct version<mlpack::perceptron::Perceptron<LearnPolicy,
+    WeightInitializationPolicy, MatType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 #include "perceptron_impl.hpp"
 
 #endif
@@ -14,6 +14,8 @@
 
 #include "perceptron.hpp"
 
+#include <mlpack/core/util/parallel_blocks.hpp>
+
 namespace mlpack {
 namespace perceptron {
 
@@ -29,8 +31,10 @@ template<
 Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const size_t numClasses,
     const size_t dimensionality,
-    const size_t maxIterations) :
-    maxIterations(maxIterations)
+    const size_t maxIterations,
+    const size_t batchSize) :
+    maxIterations(maxIterations),
+    batchSize(batchSize)
 {
   WeightInitializationPolicy wip;
   wip.Initialize(weights, biases, dimensionality, numClasses);
@@ -45,6 +49,7 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
  * @param labels Labels of dataset.
  * @param maxIterations Maximum number of iterations for the perceptron learning
  *      algorithm.
+ * @param batchSize Number of points in each mini-batch.
  */
 template<
     typename LearnPolicy,
@@ -55,8 +60,10 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const MatType& data,
     const arma::Row<size_t>& labels,
     const size_t numClasses,
-    const size_t maxIterations) :
-    maxIterations(maxIterations)
+    const size_t maxIterations,
+    const size_t batchSize) :
+    maxIterations(maxIterations),
+    batchSize(batchSize)
 {
   // Start training.
   Train(data, labels, numClasses);
@@ -84,7 +91,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const arma::rowvec& instanceWeights) :
-    maxIterations(other.maxIterations)
+    maxIterations(other.maxIterations),
+    batchSize(other.batchSize)
 {
   Train(data, labels, numClasses, instanceWeights);
 }
@@ -106,16 +114,22 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::vec tempLabelMat;
-  arma::uword maxIndex = 0;
+  predictedLabels.set_size(test.n_cols);
 
-  // Could probably be faster if done in batch.
-  for (size_t i = 0; i < test.n_cols; i++)
+  // The scores of each block of points are computed at once, and the blocks
+  // are handled in parallel.
+  util::ParallelBlocks(test.n_cols, [&](const size_t begin, const size_t end)
   {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
-    predictedLabels(0, i) = maxIndex;
-  }
+    arma::mat scores = weights.t() * test.cols(begin, end);
+    scores.each_col() += biases;
+
+    arma::uword maxIndex = 0;
+    for (size_t i = 0; i < scores.n_cols; i++)
+    {
+      scores.unsafe_col(i).max(maxIndex);
+      predictedLabels(0, begin + i) = maxIndex;
+    }
+  });
 }
 
 /**
@@ -155,6 +169,17 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
 
   const bool hasWeights = (instanceWeights.n_elem > 0);
 
+  // With mini-batches, each pass is made by TrainBatches().
+  if (batchSize > 1)
+  {
+    while ((i < maxIterations) && (!converged))
+    {
+      i++;
+      converged = TrainBatches(data, labels, instanceWeights);
+    }
+    return;
+  }
+
   while ((i < maxIterations) && (!converged))
   {
     // This outer loop is for each iteration, and we use the 'converged'
@@ -192,6 +217,84 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
   }
 }
 
+/**
+ * Make one pass over the data in mini-batches.  The points of each batch are
+ * scored with the current weights, in parallel blocks; each block adds up the
+ * updates of its misclassified points, and the sums of the blocks are added to
+ * the weights in order.
+ */
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+bool Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::TrainBatches(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const arma::rowvec& instanceWeights)
+{
+  const bool hasWeights = (instanceWeights.n_elem > 0);
+  const size_t blockSize = util::DefaultBlockSize;
+
+  bool converged = true;
+  std::vector<arma::mat> weightUpdates;
+  std::vector<arma::vec> biasUpdates;
+  std::vector<char> blockConverged;
+  for (size_t batchBegin = 0; batchBegin < data.n_cols;
+       batchBegin += batchSize)
+  {
+    const size_t batchEnd = std::min(data.n_cols, batchBegin + batchSize) - 1;
+    const size_t numPoints = batchEnd - batchBegin + 1;
+    const size_t numBlocks = (numPoints + blockSize - 1) / blockSize;
+
+    weightUpdates.resize(numBlocks);
+    biasUpdates.resize(numBlocks);
+    blockConverged.assign(numBlocks, 1);
+    util::ParallelBlocks(numPoints, [&](const size_t begin, const size_t end)
+    {
+      const size_t block = begin / blockSize;
+      arma::mat& blockWeights = weightUpdates[block];
+      arma::vec& blockBiases = biasUpdates[block];
+      blockWeights.zeros(weights.n_rows, weights.n_cols);
+      blockBiases.zeros(biases.n_elem);
+
+      arma::mat scores = weights.t() * data.cols(batchBegin + begin,
+          batchBegin + end);
+      scores.each_col() += biases;
+
+      LearnPolicy lp;
+      arma::uword maxIndex = 0;
+      for (size_t k = 0; k < scores.n_cols; ++k)
+      {
+        const size_t j = batchBegin + begin + k;
+        scores.unsafe_col(k).max(maxIndex);
+        if (maxIndex != labels(0, j))
+        {
+          blockConverged[block] = 0;
+          if (hasWeights)
+            lp.UpdateWeights(data.col(j), blockWeights, blockBiases, maxIndex,
+                labels(0, j), instanceWeights(j));
+          else
+            lp.UpdateWeights(data.col(j), blockWeights, blockBiases, maxIndex,
+                labels(0, j));
+        }
+      }
+    }, blockSize);
+
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      if (blockConverged[b])
+        continue;
+
+      converged = false;
+      weights += weightUpdates[b];
+      biases += biasUpdates[b];
+    }
+  }
+
+  return converged;
+}
+
 //! Serialize the perceptron.
 template<typename LearnPolicy,
          typename WeightInitializationPolicy,
@@ -199,11 +302,15 @@ template<typename LearnPolicy,
 template<typename Archive>
 void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::serialize(
     Archive& ar,
-    const unsigned int /* version */)
+    const unsigned int version)
 {
-  // We just need to serialize the maximum number of iterations, the weights,
-  // and the biases.
+  // We just need to serialize the maximum number of iterations, the batch
+  // size, the weights, and the biases.
   ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(batchSize);
+  else if (Archive::is_loading::value)
+    batchSize = 1;
   ar & BOOST_SERIALIZATION_NVP(weights);
   ar & BOOST_SERIALIZATION_NVP(biases);
 }
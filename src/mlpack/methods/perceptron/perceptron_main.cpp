@@ -51,6 +51,12 @@ PROGRAM_INFO("Perceptron",
     "the " + PRINT_PARAM_STRING("labels") + " parameter may be used to specify "
     "a separate matrix of labels."
     "\n\n"
+    "By default the weights are updated after each misclassified point.  If " +
+    PRINT_PARAM_STRING("batch_size") + " is larger than 1, the points are "
+    "scored in mini-batches of that size, and the updates of the misclassified "
+    "points of each mini-batch are applied at once; large mini-batches are "
+    "scored in parallel."
+    "\n\n"
     "All these options make it easy to train a perceptron, and then re-use that"
     " perceptron for later classification.  The invocation below trains a "
     "perceptron on " + PRINT_DATASET("training_data") + " with labels " +
@@ -107,6 +113,8 @@ PARAM_UROW_IN("labels", "A matrix containing labels for the training set.",
     "l");
 PARAM_INT_IN("max_iterations", "The maximum number of iterations the "
     "perceptron is to be run", "n", 1000);
+PARAM_INT_IN("batch_size", "Number of points in each mini-batch (1 updates the "
+    "weights after each point).", "b", 1);
 
 // Model loading/saving.
 PARAM_MODEL_IN(PerceptronModel, "input_model", "Input perceptron model.", "m");
@@ -122,6 +130,7 @@ static void mlpackMain()
 {
   // First, get all parameters and validate them.
   const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
+  const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
 
   // We must either load a model or train a model.
   RequireAtLeastOnePassed({ "input_model", "training" }, true);
@@ -135,6 +144,8 @@ static void mlpackMain()
   // Check parameter validity.
   RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; },
       true, "maximum number of iterations must be nonnegative");
+  RequireParamValue<int>("batch_size", [](int x) { return x > 0; }, true,
+      "batch size must be positive");
 
   // Now, load our model, if there is one.
   PerceptronModel* p;
@@ -221,7 +232,8 @@ static void mlpackMain()
     {
       // Create and train the classifier.
       Timer::Start("training");
-      p->P() = Perceptron<>(trainingData, labels, numClasses, maxIterations);
+      p->P() = Perceptron<>(trainingData, labels, numClasses, maxIterations,
+          batchSize);
       Timer::Stop("training");
     }
     else
@@ -249,6 +261,7 @@ static void mlpackMain()
       // Now train.
       Timer::Start("training");
       p->P().MaxIterations() = maxIterations;
+      p->P().BatchSize() = batchSize;
       p->P().Train(trainingData, labels.t(), numClasses);
       Timer::Stop("training");
     }
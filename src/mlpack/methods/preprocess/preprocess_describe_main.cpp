@@ -12,6 +12,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/moments.hpp>
 
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
@@ -62,85 +63,6 @@ PARAM_FLAG("row_major", "If specified, the program will calculate statistics "
     "across rows, not across columns.  (Remember that in mlpack, a column "
     "represents a point, so this option is generally not necessary.)", "r");
 
-/**
- * Calculates the sum of deviations to the Nth Power.
- *
- * @param input Vector that captures a dimension of a dataset.
- * @param rowMean Mean of the given vector.
- * @param n Degree of power.
- * @return sum of nth power deviations.
- */
-double SumNthPowerDeviations(const arma::rowvec& input,
-                             const double& fMean,
-                             size_t n)
-{
-  return arma::sum(arma::pow(input - fMean, static_cast<double>(n)));
-}
-
-/**
- * Calculates Skewness of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Skewness of the given vector.
- */
-double Skewness(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double skewness = 0;
-  const double S3 = pow(fStd, 3);
-  const double M3 = SumNthPowerDeviations(input, fMean, 3);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population skewness
-    skewness = M3 / (n * S3);
-  }
-  else
-  {
-    // Calculate sample skewness.
-    skewness = n * M3 / ((n - 1) * (n - 2) * S3);
-  }
-  return skewness;
-}
-
-/**
- * Calculates excess kurtosis of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Kurtosis of the given vector.
- */
-double Kurtosis(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double kurtosis = 0;
-  const double M4 = SumNthPowerDeviations(input, fMean, 4);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population excess kurtosis.
-    const double M2 = SumNthPowerDeviations(input, fMean, 2);
-    kurtosis = n * (M4 / pow(M2, 2)) - 3;
-  }
-  else
-  {
-    // Calculate sample excess kurtosis.
-    const double S4 = pow(fStd, 4);
-    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
-    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
-    const double normM = M4 / S4;
-    kurtosis = normC * normM - norm3;
-  }
-  return kurtosis;
-}
-
 /**
  * Calculates standard error of standard deviation.
  *
@@ -184,9 +106,14 @@ static void mlpackMain()
       % "dim" % "var" % "mean" % "std" % "median" % "min" % "max"
       % "range" % "skew" % "kurt" % "SE" << endl;
 
+  // All the moments are computed in a single (parallel) pass over the data.
+  std::vector<Moments> moments;
+  ComputeMoments(data, moments, rowMajor);
+
   // Lambda function to print out the results.
   auto PrintStatResults = [&](size_t dim, bool rowMajor)
   {
+    // The median still needs a copy of the feature.
     arma::rowvec feature;
     if (rowMajor)
       feature = arma::conv_to<arma::rowvec>::from(data.col(dim));
@@ -194,24 +121,24 @@ static void mlpackMain()
       feature = data.row(dim);
 
     // f at the front of the variable names means "feature".
-    const double fMax = arma::max(feature);
-    const double fMin = arma::min(feature);
-    const double fMean = arma::mean(feature);
-    const double fStd = arma::stddev(feature, population);
+    const Moments& fMoments = moments[dim];
+    const double fMax = fMoments.Max();
+    const double fMin = fMoments.Min();
+    const double fStd = fMoments.StdDev(population);
 
     // Print statistics of the given dimension.
     Log::Info << boost::format(numberFormat)
         % dim
-        % arma::var(feature, population)
-        % fMean
+        % fMoments.Variance(population)
+        % fMoments.Mean()
         % fStd
         % arma::median(feature)
         % fMin
         % fMax
         % (fMax - fMin) // range
-        % Skewness(feature, fStd, fMean, population)
-        % Kurtosis(feature, fStd, fMean, population)
-        % StandardError(feature.n_elem, fStd)
+        % fMoments.Skewness(population)
+        % fMoments.Kurtosis(population)
+        % StandardError(fMoments.Count(), fStd)
         << endl;
   };
 
@@ -219,6 +146,12 @@ static void mlpackMain()
   // dimension. If a dimension is not specified, describe all dimensions.
   if (CLI::HasParam("dimension"))
   {
+    if (dimension >= moments.size())
+    {
+      Log::Fatal << "Invalid dimension " << dimension << "; the data has "
+          << moments.size() << " dimensions." << endl;
+    }
+
     PrintStatResults(dimension, rowMajor);
   }
   else
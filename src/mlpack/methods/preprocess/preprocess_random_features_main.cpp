@@ -0,0 +1,138 @@
+/**
+ * @file preprocess_random_features_main.cpp
+ *
+ * Executable that maps a dataset to random Fourier features.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/methods/random_fourier_features/random_fourier_features.hpp>
+
+using namespace mlpack;
+using namespace mlpack::kernel;
+using namespace mlpack::util;
+using namespace std;
+
+PROGRAM_INFO("Random Fourier Features", "This utility maps a dataset to random "
+    "Fourier features, so that the dot product of the features of two points "
+    "approximates a shift-invariant kernel between them.  The features can then"
+    " be given to linear methods, such as logistic regression or softmax "
+    "regression, to approximate the corresponding kernel methods in time "
+    "linear in the number of points."
+    "\n\n"
+    "The kernel can be 'gaussian', K(x, y) = exp(-(|| x - y || ^ 2) / (2 * "
+    "(bandwidth ^ 2))), or 'laplacian', K(x, y) = exp(-(|| x - y ||) / "
+    "bandwidth), with the bandwidth given by " +
+    PRINT_PARAM_STRING("bandwidth") + ".  The output has twice as many "
+    "dimensions as the number of random frequencies, " +
+    PRINT_PARAM_STRING("num_frequencies") + ".  If " +
+    PRINT_PARAM_STRING("fastfood") + " is given, the features are computed "
+    "with Fastfood, which is faster for high-dimensional data."
+    "\n\n"
+    "The transform can be saved with " + PRINT_PARAM_STRING("output_model") +
+    " and applied to other data (for instance a test set) with " +
+    PRINT_PARAM_STRING("input_model") + "."
+    "\n\n"
+    "For example, the following maps " + PRINT_DATASET("X") + " to 1000 "
+    "features for a Gaussian kernel of bandwidth 0.5, saving them to " +
+    PRINT_DATASET("Y") + " and the transform to " + PRINT_MODEL("rff") + ":"
+    "\n\n" +
+    PRINT_CALL("preprocess_random_features", "input", "X", "bandwidth", 0.5,
+        "num_frequencies", 500, "output", "Y", "output_model", "rff") +
+    "\n\n"
+    "and the following applies the same transform to " +
+    PRINT_DATASET("X_test") + ":"
+    "\n\n" +
+    PRINT_CALL("preprocess_random_features", "input", "X_test", "input_model",
+        "rff", "output", "Y_test"));
+
+PARAM_MATRIX_IN_REQ("input", "Matrix containing the dataset to transform.",
+    "i");
+PARAM_MATRIX_OUT("output", "Matrix to save the features to.", "o");
+
+PARAM_MODEL_IN(RandomFourierFeatures, "input_model", "Existing transform to "
+    "apply.", "m");
+PARAM_MODEL_OUT(RandomFourierFeatures, "output_model", "If specified, the "
+    "transform will be saved here.", "M");
+
+PARAM_STRING_IN("kernel", "Kernel to approximate: 'gaussian' or 'laplacian'.",
+    "k", "gaussian");
+PARAM_DOUBLE_IN("bandwidth", "Bandwidth of the kernel.", "b", 1.0);
+PARAM_INT_IN("num_frequencies", "Number of random frequencies.", "F", 100);
+PARAM_FLAG("fastfood", "If set, the features are computed with Fastfood.",
+    "f");
+PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) std::time(NULL));
+
+  RequireAtLeastOnePassed({ "output", "output_model" }, false,
+      "no output will be saved");
+
+  ReportIgnoredParam({{ "input_model", true }}, "kernel");
+  ReportIgnoredParam({{ "input_model", true }}, "bandwidth");
+  ReportIgnoredParam({{ "input_model", true }}, "num_frequencies");
+  ReportIgnoredParam({{ "input_model", true }}, "fastfood");
+
+  arma::mat input = std::move(CLI::GetParam<arma::mat>("input"));
+
+  RandomFourierFeatures* rff;
+  if (CLI::HasParam("input_model"))
+  {
+    rff = CLI::GetParam<RandomFourierFeatures*>("input_model");
+    if (rff->Dimensionality() != input.n_rows)
+    {
+      Log::Fatal << "The transform in " << PRINT_PARAM_STRING("input_model")
+          << " was built for " << rff->Dimensionality() << "-dimensional "
+          << "data, but the input has " << input.n_rows << " dimensions!"
+          << endl;
+    }
+  }
+  else
+  {
+    RequireParamInSet<string>("kernel", { "gaussian", "laplacian" }, true,
+        "unknown kernel");
+    RequireParamValue<double>("bandwidth", [](double x) { return x > 0.0; },
+        true, "bandwidth must be positive");
+    RequireParamValue<int>("num_frequencies", [](int x) { return x > 0; },
+        true, "number of frequencies must be positive");
+
+    const double bandwidth = CLI::GetParam<double>("bandwidth");
+    const size_t numFrequencies = (size_t) CLI::GetParam<int>(
+        "num_frequencies");
+    const bool fastfood = CLI::HasParam("fastfood");
+
+    rff = new RandomFourierFeatures();
+    if (CLI::GetParam<string>("kernel") == "gaussian")
+    {
+      rff->Train(GaussianKernel(bandwidth), input.n_rows, numFrequencies,
+          fastfood);
+    }
+    else
+    {
+      rff->Train(LaplacianKernel(bandwidth), input.n_rows, numFrequencies,
+          fastfood);
+    }
+  }
+
+  if (CLI::HasParam("output"))
+  {
+    Timer::Start("random_features");
+    arma::mat output;
+    rff->Transform(input, output);
+    Timer::Stop("random_features");
+
+    CLI::GetParam<arma::mat>("output") = std::move(output);
+  }
+
+  CLI::GetParam<RandomFourierFeatures*>("output_model") = rff;
+}
@@ -48,10 +48,22 @@ PROGRAM_INFO("Split Data", "This utility takes a dataset and optionally labels "
     "\n\n" +
     PRINT_CALL("preprocess_split", "input", "X", "input_labels", "y",
         "test_ratio", 0.3, "training", "X_train", "training_labels", "y_train",
-        "test", "X_test", "test_labels", "y_test"));
+        "test", "X_test", "test_labels", "y_test") +
+    "\n\n"
+    "With labels, the " + PRINT_PARAM_STRING("stratify_data") + " flag keeps "
+    "the proportion of every class the same in the training and test sets."
+    "\n\n"
+    "A dataset too large to be loaded can be split from an Armadillo binary "
+    "file given with " + PRINT_PARAM_STRING("stream_input") + " instead of " +
+    PRINT_PARAM_STRING("input") + ".  It is read " +
+    PRINT_PARAM_STRING("chunk_size") + " points at a time, and the training "
+    "and test sets are written as they are read to the Armadillo binary files "
+    "given with " + PRINT_PARAM_STRING("stream_training") + " and " +
+    PRINT_PARAM_STRING("stream_test") + ".  In this mode the test set is still "
+    "a random subset of the points, but the points are not reordered.");
 
 // Define parameters for data.
-PARAM_MATRIX_IN_REQ("input", "Matrix containing data.", "i");
+PARAM_MATRIX_IN("input", "Matrix containing data.", "i");
 PARAM_MATRIX_OUT("training", "Matrix to save training data to.", "t");
 PARAM_MATRIX_OUT("test", "Matrix to save test data to.", "T");
 
@@ -66,6 +78,18 @@ PARAM_DOUBLE_IN("test_ratio", "Ratio of test set; if not set,"
 
 PARAM_INT_IN("seed", "Random seed (0 for std::time(NULL)).", "s", 0);
 
+PARAM_FLAG("stratify_data", "Keep the proportion of every class in the "
+    "training and test sets (requires labels).", "z");
+
+PARAM_STRING_IN("stream_input", "Armadillo binary file containing data to "
+    "split without loading it.", "S", "");
+PARAM_STRING_IN("stream_training", "Armadillo binary file to write the "
+    "training data to when splitting a streamed dataset.", "a", "");
+PARAM_STRING_IN("stream_test", "Armadillo binary file to write the test data "
+    "to when splitting a streamed dataset.", "b", "");
+PARAM_INT_IN("chunk_size", "Number of points read at once when splitting a "
+    "streamed dataset.", "c", 100000);
+
 using namespace mlpack;
 using namespace mlpack::util;
 using namespace arma;
@@ -81,10 +105,42 @@ static void mlpackMain()
   else
     mlpack::math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
 
-  // Make sure the user specified output filenames.
-  RequireAtLeastOnePassed({ "training" }, false, "no training set will be "
-      "saved");
-  RequireAtLeastOnePassed({ "test" }, false, "no test set will be saved");
+  RequireOnlyOnePassed({ "input", "stream_input" });
+
+  // Check test_ratio.
+  RequireParamValue<double>("test_ratio",
+      [](double x) { return x >= 0.0 && x <= 1.0; }, true,
+      "test ratio must be between 0.0 and 1.0");
+
+  if (!CLI::HasParam("test_ratio")) // If test_ratio is not set, warn the user.
+  {
+    Log::Warn << "You did not specify " << PRINT_PARAM_STRING("test_ratio")
+        << ", so it will be automatically set to 0.2." << endl;
+  }
+
+  if (CLI::HasParam("stream_input"))
+  {
+    RequireAtLeastOnePassed({ "stream_training" }, true, "the training set "
+        "of a streamed dataset must be written to a file");
+    RequireAtLeastOnePassed({ "stream_test" }, true, "the test set of a "
+        "streamed dataset must be written to a file");
+    RequireParamValue<int>("chunk_size", [](int x) { return x > 0; }, true,
+        "chunk size must be positive");
+    ReportIgnoredParam({{ "stream_input", true }}, "training");
+    ReportIgnoredParam({{ "stream_input", true }}, "test");
+    ReportIgnoredParam({{ "stream_input", true }}, "stratify_data");
+  }
+  else
+  {
+    ReportIgnoredParam({{ "stream_input", false }}, "stream_training");
+    ReportIgnoredParam({{ "stream_input", false }}, "stream_test");
+    ReportIgnoredParam({{ "stream_input", false }}, "chunk_size");
+
+    // Make sure the user specified output filenames.
+    RequireAtLeastOnePassed({ "training" }, false, "no training set will be "
+        "saved");
+    RequireAtLeastOnePassed({ "test" }, false, "no test set will be saved");
+  }
 
   // Check on label parameters.
   if (CLI::HasParam("input_labels"))
@@ -98,17 +154,52 @@ static void mlpackMain()
   {
     ReportIgnoredParam({{ "input_labels", true }}, "training_labels");
     ReportIgnoredParam({{ "input_labels", true }}, "test_labels");
+    ReportIgnoredParam({{ "input_labels", false }}, "stratify_data");
   }
 
-  // Check test_ratio.
-  RequireParamValue<double>("test_ratio",
-      [](double x) { return x >= 0.0 && x <= 1.0; }, true,
-      "test ratio must be between 0.0 and 1.0");
-
-  if (!CLI::HasParam("test_ratio")) // If test_ratio is not set, warn the user.
+  if (CLI::HasParam("stream_input"))
   {
-    Log::Warn << "You did not specify " << PRINT_PARAM_STRING("test_ratio")
-        << ", so it will be automatically set to 0.2." << endl;
+    // The dataset is never loaded; each chunk is written to the outputs as
+    // soon as it is read.
+    data::StreamingDataset<> dataset(CLI::GetParam<string>("stream_input"),
+        (size_t) CLI::GetParam<int>("chunk_size"));
+    const arma::uvec testIndices = data::StreamingSplit(dataset,
+        CLI::GetParam<string>("stream_training"),
+        CLI::GetParam<string>("stream_test"), testRatio);
+    Log::Info << "Training data contains " << dataset.NumCols() -
+        testIndices.n_elem << " points." << endl;
+    Log::Info << "Test data contains " << testIndices.n_elem << " points."
+        << endl;
+
+    if (CLI::HasParam("input_labels"))
+    {
+      arma::Mat<size_t>& labels =
+          CLI::GetParam<arma::Mat<size_t>>("input_labels");
+      if (labels.n_cols != dataset.NumCols())
+      {
+        Log::Fatal << "The labels must have the same number of points as the "
+            << "dataset (" << dataset.NumCols() << ")!" << endl;
+      }
+
+      std::vector<bool> inTestSet(labels.n_cols, false);
+      for (size_t i = 0; i < testIndices.n_elem; ++i)
+        inTestSet[testIndices[i]] = true;
+
+      arma::Mat<size_t> trainingLabels(1, labels.n_cols - testIndices.n_elem);
+      size_t trainingPoint = 0;
+      for (size_t i = 0; i < labels.n_cols; ++i)
+        if (!inTestSet[i])
+          trainingLabels[trainingPoint++] = labels(0, i);
+
+      if (CLI::HasParam("training_labels"))
+        CLI::GetParam<arma::Mat<size_t>>("training_labels") =
+            std::move(trainingLabels);
+      if (CLI::HasParam("test_labels"))
+        CLI::GetParam<arma::Mat<size_t>>("test_labels") =
+            labels.cols(testIndices);
+    }
+
+    return;
   }
 
   // Load the data.
@@ -121,22 +212,32 @@ static void mlpackMain()
         CLI::GetParam<arma::Mat<size_t>>("input_labels");
     arma::Row<size_t> labelsRow = labels.row(0);
 
-    const auto value = data::Split(data, labelsRow, testRatio);
-    Log::Info << "Training data contains " << get<0>(value).n_cols << " points."
+    arma::mat trainData, testData;
+    arma::Row<size_t> trainLabels, testLabels;
+    if (CLI::HasParam("stratify_data"))
+    {
+      data::StratifiedSplit(data, labelsRow, trainData, testData, trainLabels,
+          testLabels, testRatio);
+    }
+    else
+    {
+      data::Split(data, labelsRow, trainData, testData, trainLabels,
+          testLabels, testRatio);
+    }
+    Log::Info << "Training data contains " << trainData.n_cols << " points."
         << endl;
-    Log::Info << "Test data contains " << get<1>(value).n_cols << " points."
+    Log::Info << "Test data contains " << testData.n_cols << " points."
         << endl;
 
     if (CLI::HasParam("training"))
-      CLI::GetParam<arma::mat>("training") = std::move(get<0>(value));
+      CLI::GetParam<arma::mat>("training") = std::move(trainData);
     if (CLI::HasParam("test"))
-      CLI::GetParam<arma::mat>("test") = std::move(get<1>(value));
+      CLI::GetParam<arma::mat>("test") = std::move(testData);
     if (CLI::HasParam("training_labels"))
       CLI::GetParam<arma::Mat<size_t>>("training_labels") =
-          std::move(get<2>(value));
+          std::move(trainLabels);
     if (CLI::HasParam("test_labels"))
-      CLI::GetParam<arma::Mat<size_t>>("test_labels") =
-          std::move(get<3>(value));
+      CLI::GetParam<arma::Mat<size_t>>("test_labels") = std::move(testLabels);
   }
   else // We have no labels, so just split the dataset.
   {
@@ -77,7 +77,8 @@ class Radical
    * Vasicek's m-spacing estimator of entropy, with overlap modification from
    * (Learned-Miller and Fisher, 2003).
    *
-   * @param x Empirical sample (one-dimensional) over which to estimate entropy.
+   * @param x Empirical sample (one-dimensional) over which to estimate entropy;
+   *     it is sorted in place.
    */
   double Vasicek(arma::vec& x) const;
 
@@ -88,7 +89,9 @@ class Radical
    */
   void CopyAndPerturb(arma::mat& xNew, const arma::mat& x) const;
 
-  //! Two-dimensional version of RADICAL.
+  //! Two-dimensional version of RADICAL.  The angles are searched in
+  //! parallel, after all the noise is drawn, so the result only depends on the
+  //! random seed.
   double DoRadical2D(const arma::mat& matX);
 
   //! Get the standard deviation of the additive Gaussian noise.
@@ -131,8 +134,6 @@ class Radical
 
   //! Internal matrix, held as member variable to prevent memory reallocations.
   arma::mat perturbed;
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat candidate;
 };
 
 void WhitenFeatureMajorMatrix(const arma::mat& matX,
@@ -3,7 +3,8 @@
  * @author Ryan Curtin
  *
  * Implementation of the Bootstrap() function, which creates a bootstrapped
- * dataset from the given input dataset.
+ * dataset from the given input dataset, and of the BootstrapCounts() function,
+ * which draws a bootstrap sample as the number of times each point is drawn.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -47,6 +48,31 @@ void Bootstrap(const MatType& dataset,
   }
 }
 
+/**
+ * Draw a bootstrap sample of a dataset with the given number of points, as the
+ * number of times each point is drawn: numPoints points are drawn uniformly
+ * with replacement, so the counts follow a multinomial distribution.  Points
+ * with a count of zero are out of the bag.  Unlike Bootstrap(), this doesn't
+ * copy any data, so the sample can be given to a learner as instance weights.
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param generator Random number generator to draw the points with.
+ * @param counts Will hold the number of times each point was drawn.
+ */
+template<typename GeneratorType>
+void BootstrapCounts(const size_t numPoints,
+                     GeneratorType& generator,
+                     arma::Row<size_t>& counts)
+{
+  counts.zeros(numPoints);
+  if (numPoints == 0)
+    return;
+
+  std::uniform_int_distribution<size_t> distribution(0, numPoints - 1);
+  for (size_t i = 0; i < numPoints; ++i)
+    ++counts[distribution(generator)];
+}
+
 } // namespace tree
 } // namespace mlpack
 
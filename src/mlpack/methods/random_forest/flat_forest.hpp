@@ -0,0 +1,233 @@
+/**
+ * @file flat_forest.hpp
+ *
+ * Definition of the FlatForest class, a compact read-only representation of a
+ * trained RandomForest or DecisionTree that is laid out for fast prediction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Whether or not a numeric split type sends a point to the left child (child
+ * 0) when its value is at most classProbabilities[0], and to the right child
+ * otherwise.  This holds for BestBinaryNumericSplit and HistogramNumericSplit;
+ * specialize this for other numeric split types that behave the same way, so
+ * that they can be used with FlatForest.
+ */
+template<typename NumericSplitType>
+struct IsThresholdNumericSplit
+{
+  static const bool value = false;
+};
+
+template<typename FitnessFunction>
+struct IsThresholdNumericSplit<BestBinaryNumericSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+template<typename FitnessFunction>
+struct IsThresholdNumericSplit<HistogramNumericSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+/**
+ * Whether or not a categorical split type sends a point with category c to
+ * child c.  This holds for AllCategoricalSplit; specialize this for other
+ * categorical split types that behave the same way, so that they can be used
+ * with FlatForest.
+ */
+template<typename CategoricalSplitType>
+struct IsIndexCategoricalSplit
+{
+  static const bool value = false;
+};
+
+template<typename FitnessFunction>
+struct IsIndexCategoricalSplit<AllCategoricalSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+/**
+ * A FlatForest is a "compiled" copy of a trained RandomForest (or of a single
+ * DecisionTree) that can only be used for prediction.  Instead of a tree of
+ * separately allocated nodes, each with its own std::vector of children and
+ * class probability vector, the nodes of every tree are stored in a few
+ * contiguous arrays (split dimension, split threshold, node type, and offset of
+ * the first child or of the leaf probabilities), with the children of each node
+ * next to each other.  All leaf class probabilities are held in one matrix.
+ *
+ * Batch classification traverses the trees for blocks of points at a time: for
+ * each block, every point is sent down the first tree, then every point down
+ * the second tree, and so on, so that the top levels of each tree stay in cache
+ * while many points use them.  The predictions and probabilities are the same
+ * as those given by the original model.
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses, 100);
+ * FlatForest<> flat(rf);
+ *
+ * arma::Row<size_t> predictions;
+ * arma::mat probabilities;
+ * flat.Classify(testData, predictions, probabilities);
+ * @endcode
+ *
+ * The numeric and categorical split types of the model must satisfy
+ * IsThresholdNumericSplit and IsIndexCategoricalSplit; this is the case for
+ * every split type in mlpack.
+ *
+ * @tparam ElemType Type of the split thresholds (this should be the ElemType of
+ *     the model).
+ */
+template<typename ElemType = double>
+class FlatForest
+{
+ public:
+  /**
+   * Create an empty FlatForest.  Classify() will throw an exception until a
+   * model is compiled into it.
+   */
+  FlatForest() : numClasses(0) { }
+
+  /**
+   * Compile the given random forest.  An exception is thrown if the forest has
+   * not been trained.
+   *
+   * @param forest Random forest to compile.
+   */
+  template<typename FitnessFunction,
+           typename DimensionSelectionType,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType>
+  FlatForest(const RandomForest<FitnessFunction, DimensionSelectionType,
+      NumericSplitType, CategoricalSplitType, ElemType>& forest);
+
+  /**
+   * Compile the given decision tree.
+   *
+   * @param tree Decision tree to compile.
+   */
+  template<typename FitnessFunction,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename DimensionSelectionType,
+           bool NoRecursion>
+  FlatForest(const DecisionTree<FitnessFunction, NumericSplitType,
+      CategoricalSplitType, DimensionSelectionType, ElemType, NoRecursion>&
+      tree);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to be classified.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point and return the predicted class
+   * probabilities for each class.
+   *
+   * @param point Point to be classified.
+   * @param prediction size_t to store predicted class in.
+   * @param probabilities Output vector of class probabilities.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * predicted class probabilities for each point.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the total number of nodes in all trees.
+  size_t NumNodes() const { return types.size(); }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  /**
+   * Serialize the compiled forest.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The types of nodes.
+  enum NodeType
+  {
+    LEAF = 0,
+    NUMERIC = 1,
+    CATEGORICAL = 2
+  };
+
+  /**
+   * Append the nodes of the given tree in breadth-first order, so that the
+   * children of each node are contiguous.  The class probabilities of its
+   * leaves are appended to leafValues.
+   */
+  template<typename TreeType>
+  void Compile(const TreeType& tree, std::vector<double>& leafValues);
+
+  //! Return the column of leafProbabilities for the leaf of the given tree
+  //! that the point falls in.
+  template<typename VecType>
+  size_t Leaf(const size_t tree, const VecType& point) const;
+
+  //! The index of the root node of each tree.
+  std::vector<size_t> roots;
+  //! The type of each node (a NodeType).
+  std::vector<unsigned char> types;
+  //! The dimension each node splits on (unused for leaves).
+  std::vector<size_t> dimensions;
+  //! The threshold of each numeric node (unused for other nodes).
+  std::vector<ElemType> thresholds;
+  //! For internal nodes, the index of the first child; for leaves, the column
+  //! of leafProbabilities holding the class probabilities of the leaf.
+  std::vector<size_t> offsets;
+  //! The class probabilities of each leaf, one column per leaf.
+  arma::mat leafProbabilities;
+  //! The number of classes.
+  size_t numClasses;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file flat_forest_impl.hpp
+ *
+ * Implementation of the FlatForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename ElemType>
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+FlatForest<ElemType>::FlatForest(const RandomForest<FitnessFunction,
+    DimensionSelectionType, NumericSplitType, CategoricalSplitType, ElemType>&
+    forest) :
+    numClasses(0)
+{
+  if (forest.NumTrees() == 0)
+  {
+    throw std::invalid_argument("FlatForest::FlatForest(): no random forest "
+        "trained!");
+  }
+
+  numClasses = forest.Tree(0).NumClasses();
+  std::vector<double> leafValues;
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    Compile(forest.Tree(i), leafValues);
+
+  leafProbabilities = arma::mat(leafValues.data(), numClasses,
+      leafValues.size() / numClasses);
+}
+
+template<typename ElemType>
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+FlatForest<ElemType>::FlatForest(const DecisionTree<FitnessFunction,
+    NumericSplitType, CategoricalSplitType, DimensionSelectionType, ElemType,
+    NoRecursion>& tree) :
+    numClasses(tree.NumClasses())
+{
+  std::vector<double> leafValues;
+  Compile(tree, leafValues);
+
+  leafProbabilities = arma::mat(leafValues.data(), numClasses,
+      leafValues.size() / numClasses);
+}
+
+template<typename ElemType>
+template<typename TreeType>
+void FlatForest<ElemType>::Compile(const TreeType& tree,
+                                   std::vector<double>& leafValues)
+{
+  static_assert(IsThresholdNumericSplit<typename TreeType::NumericSplit>::value,
+      "FlatForest: the numeric split type must send points at most "
+      "classProbabilities[0] left (see IsThresholdNumericSplit)");
+  static_assert(
+      IsIndexCategoricalSplit<typename TreeType::CategoricalSplit>::value,
+      "FlatForest: the categorical split type must send category c to child c "
+      "(see IsIndexCategoricalSplit)");
+
+  roots.push_back(types.size());
+
+  // Visit the nodes in breadth-first order; the children of each node are
+  // added to the queue (and get their indices) together.
+  std::vector<const TreeType*> queue(1, &tree);
+  for (size_t i = 0; i < queue.size(); ++i)
+  {
+    const TreeType& node = *queue[i];
+    if (node.NumChildren() == 0)
+    {
+      if (node.classProbabilities.n_elem != numClasses)
+      {
+        throw std::invalid_argument("FlatForest: the trees have different "
+            "numbers of classes");
+      }
+
+      types.push_back(LEAF);
+      dimensions.push_back(0);
+      thresholds.push_back(ElemType(0));
+      offsets.push_back(leafValues.size() / numClasses);
+      leafValues.insert(leafValues.end(), node.classProbabilities.begin(),
+          node.classProbabilities.end());
+      continue;
+    }
+
+    const bool categorical = ((data::Datatype)
+        node.dimensionTypeOrMajorityClass == data::Datatype::categorical);
+    types.push_back(categorical ? CATEGORICAL : NUMERIC);
+    dimensions.push_back(node.splitDimension);
+    thresholds.push_back(categorical ? ElemType(0) :
+        node.classProbabilities[0]);
+    offsets.push_back(roots.back() + queue.size());
+
+    for (size_t c = 0; c < node.NumChildren(); ++c)
+      queue.push_back(&node.Child(c));
+  }
+}
+
+template<typename ElemType>
+template<typename VecType>
+inline size_t FlatForest<ElemType>::Leaf(const size_t tree,
+                                         const VecType& point) const
+{
+  size_t node = roots[tree];
+  while (types[node] != LEAF)
+  {
+    const typename VecType::elem_type value = point[dimensions[node]];
+    if (types[node] == NUMERIC)
+      node = offsets[node] + ((value <= thresholds[node]) ? 0 : 1);
+    else
+      node = offsets[node] + (size_t) value;
+  }
+
+  return offsets[node];
+}
+
+template<typename ElemType>
+template<typename VecType>
+size_t FlatForest<ElemType>::Classify(const VecType& point) const
+{
+  // Pass off to another Classify() overload.
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+
+  return prediction;
+}
+
+template<typename ElemType>
+template<typename VecType>
+void FlatForest<ElemType>::Classify(const VecType& point,
+                                    size_t& prediction,
+                                    arma::vec& probabilities) const
+{
+  // Check edge case.
+  if (roots.size() == 0)
+  {
+    probabilities.clear();
+    prediction = 0;
+
+    throw std::invalid_argument("FlatForest::Classify(): no model compiled!");
+  }
+
+  probabilities.zeros(numClasses);
+  for (size_t t = 0; t < roots.size(); ++t)
+    probabilities += leafProbabilities.unsafe_col(Leaf(t, point));
+
+  // Find maximum element after renormalizing probabilities.
+  probabilities /= roots.size();
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+
+  // Set prediction.
+  prediction = (size_t) maxIndex;
+}
+
+template<typename ElemType>
+template<typename MatType>
+void FlatForest<ElemType>::Classify(const MatType& data,
+                                    arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename ElemType>
+template<typename MatType>
+void FlatForest<ElemType>::Classify(const MatType& data,
+                                    arma::Row<size_t>& predictions,
+                                    arma::mat& probabilities) const
+{
+  // Check edge case.
+  if (roots.size() == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("FlatForest::Classify(): no model compiled!");
+  }
+
+  probabilities.zeros(numClasses, data.n_cols);
+  predictions.set_size(data.n_cols);
+
+  // Each block of points goes down one tree at a time, so that the nodes of
+  // that tree are reused by every point of the block while they are in cache.
+  const size_t blockSize = 64;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+
+    for (size_t t = 0; t < roots.size(); ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        const double* leaf = leafProbabilities.colptr(Leaf(t, data.col(i)));
+        double* probs = probabilities.colptr(i);
+        for (size_t c = 0; c < numClasses; ++c)
+          probs[c] += leaf[c];
+      }
+    }
+
+    // Find maximum element after renormalizing probabilities.
+    for (size_t i = begin; i < end; ++i)
+    {
+      arma::vec probs(probabilities.colptr(i), numClasses, false, true);
+      probs /= roots.size();
+
+      arma::uword maxIndex = 0;
+      probs.max(maxIndex);
+      predictions[i] = (size_t) maxIndex;
+    }
+  }
+}
+
+template<typename ElemType>
+template<typename Archive>
+void FlatForest<ElemType>::serialize(Archive& ar,
+                                     const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(roots);
+  ar & BOOST_SERIALIZATION_NVP(types);
+  ar & BOOST_SERIALIZATION_NVP(dimensions);
+  ar & BOOST_SERIALIZATION_NVP(thresholds);
+  ar & BOOST_SERIALIZATION_NVP(offsets);
+  ar & BOOST_SERIALIZATION_NVP(leafProbabilities);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
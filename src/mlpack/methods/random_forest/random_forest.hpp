@@ -35,7 +35,10 @@ class RandomForest
    * Construct the random forest without any training or specifying the number
    * of trees.  Predict() will throw an exception until Train() is called.
    */
-  RandomForest() { }
+  RandomForest() :
+      weightedBootstrap(true),
+      oobError(std::numeric_limits<double>::quiet_NaN())
+  { }
 
   /**
    * Create a random forest, training on the given labeled training data with
@@ -257,17 +260,40 @@ class RandomForest
   //! Get the number of trees in the forest.
   size_t NumTrees() const { return trees.size(); }
 
+  /**
+   * Get whether each tree is trained on its bootstrap sample through instance
+   * weights (the default): the points that were drawn are given to the tree
+   * once each, weighted by the number of times they were drawn.  Otherwise,
+   * every tree is trained on a copy of the sample with the repeated points.
+   * Both give the same distribution of samples, but the weighted sample holds
+   * only about 63% of the points, and no point twice.
+   */
+  bool WeightedBootstrap() const { return weightedBootstrap; }
+  //! Modify whether each tree is trained on its sample through weights.
+  bool& WeightedBootstrap() { return weightedBootstrap; }
+
+  /**
+   * Get the out-of-bag error of the last call to Train(): the fraction of the
+   * training points that are misclassified by the trees whose bootstrap sample
+   * doesn't contain them.  Points that are in the sample of every tree aren't
+   * counted.  This is NaN if the forest hasn't been trained since it was
+   * constructed or loaded, or if no point was out of the bag.
+   */
+  double OutOfBagError() const { return oobError; }
+
   /**
    * Serialize the random forest.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
   /**
    * Perform the training of the decision tree.  The template bool parameters
    * control whether or not the datasetInfo or weights arguments should be
-   * ignored.
+   * ignored.  The trees are trained in parallel, each on a bootstrap sample
+   * drawn from its own stream of a Philox generator, and the out-of-bag error
+   * is computed along the way.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Dimension information for the dataset (may be ignored).
@@ -291,11 +317,36 @@ class RandomForest
 
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
+  //! Whether the trees are trained on their samples through weights.
+  bool weightedBootstrap;
+  //! The out-of-bag error of the last training.
+  double oobError;
 };
 
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the RandomForest class.  Version 1 stores
+//! whether the trees are trained on their samples through weights.
+namespace boost {
+namespace serialization {
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+struct version<mlpack::tree::RandomForest<FitnessFunction,
+    DimensionSelectionType, NumericSplitType, CategoricalSplitType, ElemType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "random_forest_impl.hpp"
 
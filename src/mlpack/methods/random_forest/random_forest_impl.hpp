@@ -15,6 +15,8 @@
 // In case it hasn't been included yet.
 #include "random_forest.hpp"
 
+#include <mlpack/core/util/parallel_blocks.hpp>
+
 namespace mlpack {
 namespace tree {
 
@@ -36,7 +38,9 @@ RandomForest<
                 const arma::Row<size_t>& labels,
                 const size_t numClasses,
                 const size_t numTrees,
-                const size_t minimumLeafSize)
+                const size_t minimumLeafSize) :
+    weightedBootstrap(true),
+    oobError(std::numeric_limits<double>::quiet_NaN())
 {
   // Pass off work to the Train() method.
   data::DatasetInfo info; // Ignored.
@@ -64,7 +68,9 @@ RandomForest<
                 const arma::Row<size_t>& labels,
                 const size_t numClasses,
                 const size_t numTrees,
-                const size_t minimumLeafSize)
+                const size_t minimumLeafSize) :
+    weightedBootstrap(true),
+    oobError(std::numeric_limits<double>::quiet_NaN())
 {
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
@@ -91,7 +97,9 @@ RandomForest<
                 const size_t numClasses,
                 const arma::rowvec& weights,
                 const size_t numTrees,
-                const size_t minimumLeafSize)
+                const size_t minimumLeafSize) :
+    weightedBootstrap(true),
+    oobError(std::numeric_limits<double>::quiet_NaN())
 {
   // Pass off work to the Train() method.
   data::DatasetInfo info; // Ignored by Train().
@@ -119,7 +127,9 @@ RandomForest<
                 const size_t numClasses,
                 const arma::rowvec& weights,
                 const size_t numTrees,
-                const size_t minimumLeafSize)
+                const size_t minimumLeafSize) :
+    weightedBootstrap(true),
+    oobError(std::numeric_limits<double>::quiet_NaN())
 {
   // Pass off work to the Train() method.
   Train<true, true>(dataset, datasetInfo, labels, numClasses, weights, numTrees,
@@ -333,9 +343,11 @@ void RandomForest<
 
   predictions.set_size(data.n_cols);
 
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < data.n_cols; ++i)
-    predictions[i] = Classify(data.col(i));
+  util::ParallelBlocks(data.n_cols, [&](const size_t begin, const size_t end)
+  {
+    for (size_t i = begin; i <= end; ++i)
+      predictions[i] = Classify(data.col(i));
+  });
 }
 
 template<
@@ -368,12 +380,14 @@ void RandomForest<
 
   probabilities.set_size(trees[0].NumClasses(), data.n_cols);
   predictions.set_size(data.n_cols);
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < data.n_cols; ++i)
+  util::ParallelBlocks(data.n_cols, [&](const size_t begin, const size_t end)
   {
-    arma::vec probs = probabilities.unsafe_col(i);
-    Classify(data.col(i), predictions[i], probs);
-  }
+    for (size_t i = begin; i <= end; ++i)
+    {
+      arma::vec probs = probabilities.unsafe_col(i);
+      Classify(data.col(i), predictions[i], probs);
+    }
+  });
 }
 
 template<
@@ -390,13 +404,18 @@ void RandomForest<
     NumericSplitType,
     CategoricalSplitType,
     ElemType
->::serialize(Archive& ar, const unsigned int /* version */)
+>::serialize(Archive& ar, const unsigned int version)
 {
   size_t numTrees;
   if (Archive::is_loading::value)
+  {
     trees.clear();
+    oobError = std::numeric_limits<double>::quiet_NaN();
+  }
   else
+  {
     numTrees = trees.size();
+  }
 
   ar & BOOST_SERIALIZATION_NVP(numTrees);
 
@@ -405,6 +424,11 @@ void RandomForest<
     trees.resize(numTrees);
 
   ar & BOOST_SERIALIZATION_NVP(trees);
+
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(weightedBootstrap);
+  else if (Archive::is_loading::value)
+    weightedBootstrap = true; // Older models use the default.
 }
 
 template<
@@ -432,41 +456,113 @@ void RandomForest<
   // Train each tree individually.
   trees.resize(numTrees); // This will fill the vector with untrained trees.
 
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < numTrees; ++i)
+  // Each tree draws its sample from its own stream, so the samples don't depend
+  // on the number of threads.
+  const uint64_t key = math::RandKey();
+
+  // The votes of the trees for the points out of their bag.
+  arma::Mat<size_t> oobVotes(numClasses, dataset.n_cols, arma::fill::zeros);
+
+  // The trees are trained in parallel, so the BLAS calls of each use one
+  // thread.
+  util::SingleThreadedBLAS singleThreadedBLAS;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numTrees; ++i)
   {
-    MatType bootstrapDataset;
-    arma::Row<size_t> bootstrapLabels;
-    arma::rowvec bootstrapWeights;
-    Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-        bootstrapLabels, bootstrapWeights);
+    math::Philox generator(key, i);
+    arma::Row<size_t> counts;
+    BootstrapCounts(dataset.n_cols, generator, counts);
+
+    // Either give each drawn point once with the number of times it was drawn
+    // as its weight, or repeat it that many times.
+    arma::uvec indices;
+    if (weightedBootstrap)
+    {
+      indices = arma::find(counts);
+    }
+    else
+    {
+      indices.set_size(dataset.n_cols);
+      size_t index = 0;
+      for (size_t j = 0; j < counts.n_elem; ++j)
+        for (size_t c = 0; c < counts[j]; ++c)
+          indices[index++] = j;
+    }
+
+    MatType bootstrapDataset = dataset.cols(indices);
+    arma::Row<size_t> bootstrapLabels = labels.cols(indices);
 
     // Now build the decision tree.
-    if (UseWeights)
+    if (UseWeights || weightedBootstrap)
     {
+      arma::rowvec bootstrapWeights;
+      if (weightedBootstrap)
+      {
+        bootstrapWeights = arma::conv_to<arma::rowvec>::from(
+            counts.cols(indices));
+        if (UseWeights)
+          bootstrapWeights %= weights.cols(indices);
+      }
+      else
+      {
+        bootstrapWeights = weights.cols(indices);
+      }
+
       if (UseDatasetInfo)
       {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses, weights,
-            minimumLeafSize);
+        trees[i].Train(std::move(bootstrapDataset), datasetInfo,
+            std::move(bootstrapLabels), numClasses,
+            std::move(bootstrapWeights), minimumLeafSize);
       }
       else
       {
-        trees[i].Train(dataset, labels, numClasses, weights, minimumLeafSize);
+        trees[i].Train(std::move(bootstrapDataset),
+            std::move(bootstrapLabels), numClasses,
+            std::move(bootstrapWeights), minimumLeafSize);
       }
     }
     else
     {
       if (UseDatasetInfo)
       {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses,
-            minimumLeafSize);
+        trees[i].Train(std::move(bootstrapDataset), datasetInfo,
+            std::move(bootstrapLabels), numClasses, minimumLeafSize);
       }
       else
       {
-        trees[i].Train(dataset, labels, numClasses, minimumLeafSize);
+        trees[i].Train(std::move(bootstrapDataset),
+            std::move(bootstrapLabels), numClasses, minimumLeafSize);
       }
     }
+
+    // Let the tree vote for the points out of its bag.
+    for (size_t j = 0; j < counts.n_elem; ++j)
+    {
+      if (counts[j] > 0)
+        continue;
+
+      const size_t prediction = trees[i].Classify(dataset.col(j));
+      size_t* votes = oobVotes.colptr(j);
+      #pragma omp atomic
+      ++votes[prediction];
+    }
+  }
+
+  // Each point is classified by the majority of the trees it was out of.
+  size_t oobPoints = 0;
+  size_t oobErrors = 0;
+  for (size_t j = 0; j < dataset.n_cols; ++j)
+  {
+    if (arma::accu(oobVotes.col(j)) == 0)
+      continue;
+
+    ++oobPoints;
+    if (oobVotes.col(j).index_max() != labels[j])
+      ++oobErrors;
   }
+
+  oobError = (oobPoints > 0) ? double(oobErrors) / double(oobPoints) :
+      std::numeric_limits<double>::quiet_NaN();
 }
 
 } // namespace tree
@@ -175,6 +175,13 @@ static void mlpackMain()
     // Train the model.
     rfModel->rf.Train(data, labels, numClasses, numTrees, minimumLeafSize);
 
+    // The out-of-bag error estimates the error on points that weren't seen.
+    if (!std::isnan(rfModel->rf.OutOfBagError()))
+    {
+      Log::Info << "Out-of-bag error: " << rfModel->rf.OutOfBagError() << "."
+          << endl;
+    }
+
     // Did we want training accuracy?
     if (CLI::HasParam("print_training_accuracy"))
     {
@@ -0,0 +1,90 @@
+/**
+ * @file kernel_spectrum.hpp
+ *
+ * Sampling of the spectral distribution of shift-invariant kernels, used by
+ * random Fourier features.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOURIER_FEATURES_KERNEL_SPECTRUM_HPP
+#define MLPACK_METHODS_RANDOM_FOURIER_FEATURES_KERNEL_SPECTRUM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * By Bochner's theorem, a shift-invariant kernel k(x, y) = k(x - y) with
+ * k(0) = 1 is the Fourier transform of a probability distribution, its
+ * spectral distribution: k(x - y) = E[cos(w^T (x - y))] when w is drawn from
+ * it.  KernelSpectrum<KernelType> draws frequencies w from the spectral
+ * distribution of KernelType; it is only defined for shift-invariant kernels.
+ *
+ * A specialization must provide
+ *
+ * @code
+ * static void Sample(const KernelType& kernel,
+ *                    const size_t dimensionality,
+ *                    const size_t numFrequencies,
+ *                    arma::mat& frequencies);
+ * @endcode
+ *
+ * which fills frequencies with numFrequencies columns, each drawn from the
+ * spectral distribution in the given dimensionality.
+ */
+template<typename KernelType>
+class KernelSpectrum
+{
+  static_assert(sizeof(KernelType) == 0, "KernelSpectrum is only defined for "
+      "shift-invariant kernels (GaussianKernel and LaplacianKernel).");
+};
+
+/**
+ * The spectral distribution of the Gaussian kernel with bandwidth sigma is a
+ * Gaussian with covariance I / sigma^2.
+ */
+template<>
+class KernelSpectrum<GaussianKernel>
+{
+ public:
+  static void Sample(const GaussianKernel& kernel,
+                     const size_t dimensionality,
+                     const size_t numFrequencies,
+                     arma::mat& frequencies)
+  {
+    frequencies.randn(dimensionality, numFrequencies);
+    frequencies /= kernel.Bandwidth();
+  }
+};
+
+/**
+ * The spectral distribution of the Laplacian kernel with bandwidth sigma,
+ * exp(-|| x - y || / sigma), is a multivariate Cauchy distribution with scale
+ * 1 / sigma: w = z / (sigma |u|), with z drawn from N(0, I) and u from N(0, 1).
+ */
+template<>
+class KernelSpectrum<LaplacianKernel>
+{
+ public:
+  static void Sample(const LaplacianKernel& kernel,
+                     const size_t dimensionality,
+                     const size_t numFrequencies,
+                     arma::mat& frequencies)
+  {
+    frequencies.randn(dimensionality, numFrequencies);
+    arma::rowvec scales = kernel.Bandwidth() *
+        arma::abs(arma::randn<arma::rowvec>(numFrequencies));
+    frequencies.each_row() /= scales;
+  }
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file random_fourier_features.cpp
+ *
+ * Implementation of the non-templated functions of RandomFourierFeatures.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "random_fourier_features.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kernel;
+
+RandomFourierFeatures::RandomFourierFeatures() :
+    dimensionality(0),
+    numFrequencies(0),
+    fastfood(false),
+    paddedDimensionality(0)
+{
+  // Nothing to do.
+}
+
+void RandomFourierFeatures::Transform(const arma::mat& input,
+                                      arma::mat& output) const
+{
+  if (numFrequencies == 0)
+    throw std::runtime_error("RandomFourierFeatures::Transform(): the "
+        "transform has not been trained!");
+
+  if (input.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "RandomFourierFeatures::Transform(): dimensionality of the input ("
+        << input.n_rows << ") does not match the dimensionality of the "
+        << "transform (" << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  output.set_size(2 * numFrequencies, input.n_cols);
+  const double scale = 1.0 / std::sqrt((double) numFrequencies);
+
+  // Each block of points is projected with one matrix product (or with
+  // Fastfood), so the transform streams through the input.
+  const size_t numBlocks = (input.n_cols + BlockSize() - 1) / BlockSize();
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize();
+    const size_t end = std::min(begin + BlockSize(), (size_t) input.n_cols);
+
+    arma::mat projections;
+    if (fastfood)
+      FastfoodProject(input.cols(begin, end - 1), projections);
+    else
+      projections = frequencies * input.cols(begin, end - 1);
+
+    output.submat(0, begin, numFrequencies - 1, end - 1) =
+        scale * arma::cos(projections);
+    output.submat(numFrequencies, begin, 2 * numFrequencies - 1, end - 1) =
+        scale * arma::sin(projections);
+  }
+}
+
+void RandomFourierFeatures::FastfoodProject(const arma::mat& input,
+                                            arma::mat& projections) const
+{
+  projections.set_size(numFrequencies, input.n_cols);
+  arma::vec padded(paddedDimensionality);
+  arma::vec permuted(paddedDimensionality);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    for (size_t b = 0; b < signs.n_cols; ++b)
+    {
+      // H B x, with x padded with zeros.
+      padded.zeros();
+      padded.subvec(0, dimensionality - 1) = input.col(i);
+      padded %= signs.col(b);
+      WalshHadamard(padded.memptr(), paddedDimensionality);
+
+      // S H G P (H B x).
+      for (size_t j = 0; j < paddedDimensionality; ++j)
+        permuted[j] = gaussians(j, b) * padded[permutations(j, b)];
+      WalshHadamard(permuted.memptr(), paddedDimensionality);
+      permuted %= scales.col(b);
+
+      // The last block may only be partly used.
+      const size_t first = b * paddedDimensionality;
+      const size_t count = std::min(paddedDimensionality,
+          numFrequencies - first);
+      projections.col(i).subvec(first, first + count - 1) =
+          permuted.subvec(0, count - 1);
+    }
+  }
+}
+
+void RandomFourierFeatures::WalshHadamard(double* v, const size_t n)
+{
+  for (size_t h = 1; h < n; h *= 2)
+  {
+    for (size_t i = 0; i < n; i += 2 * h)
+    {
+      for (size_t j = i; j < i + h; ++j)
+      {
+        const double a = v[j];
+        const double b = v[j + h];
+        v[j] = a + b;
+        v[j + h] = a - b;
+      }
+    }
+  }
+}
@@ -0,0 +1,179 @@
+/**
+ * @file random_fourier_features.hpp
+ *
+ * Definition of the RandomFourierFeatures class, which maps points to an
+ * explicit feature space in which the dot product approximates a
+ * shift-invariant kernel.
+ *
+ * For more information, see the following papers:
+ *
+ * @code
+ * @inproceedings{rahimi2008random,
+ *   title={Random features for large-scale kernel machines},
+ *   author={Rahimi, Ali and Recht, Benjamin},
+ *   booktitle={Advances in Neural Information Processing Systems},
+ *   pages={1177--1184},
+ *   year={2008}
+ * }
+ *
+ * @inproceedings{le2013fastfood,
+ *   title={Fastfood: Approximating kernel expansions in loglinear time},
+ *   author={Le, Quoc and Sarl{\'o}s, Tam{\'a}s and Smola, Alexander},
+ *   booktitle={Proceedings of the 30th International Conference on Machine
+ *       Learning},
+ *   pages={244--252},
+ *   year={2013}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_HPP
+#define MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+#include "kernel_spectrum.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * RandomFourierFeatures maps points x to
+ *
+ *   z(x) = [cos(W x); sin(W x)] / sqrt(D),
+ *
+ * where the D rows of W are frequencies drawn from the spectral distribution
+ * of a shift-invariant kernel (see KernelSpectrum), so that z(x)^T z(y) is an
+ * unbiased estimate of k(x, y) with variance O(1 / D).  Kernel methods can then
+ * be replaced by linear methods on the 2D features, whose cost is linear in
+ * the number of points: for instance KernelPCA with RandomFourierKernelRule,
+ * or LogisticRegression and SoftmaxRegression trained on the transformed data.
+ *
+ * W x is computed for blocks of points at a time, as a matrix product, and the
+ * blocks are transformed in parallel with OpenMP.  If Fastfood is used, W is
+ * instead the product S H G P H B of diagonal scaling (S), Gaussian (G) and
+ * random sign (B) matrices, a permutation (P) and Walsh-Hadamard transforms
+ * (H), stacked as needed to get D rows: it takes O(D) memory instead of O(D d),
+ * and W x is computed in O(D log d) time.  The input is padded with zeros to a
+ * power of two for Fastfood.
+ *
+ * The transform only depends on the random frequencies, so it can be applied
+ * to any number of batches of points once it has been trained.
+ *
+ * @code
+ * RandomFourierFeatures rff(GaussianKernel(0.5), data.n_rows, 500);
+ * arma::mat features;
+ * rff.Transform(data, features); // features has 1000 rows.
+ * @endcode
+ */
+class RandomFourierFeatures
+{
+ public:
+  /**
+   * Create an empty transform; Train() must be called before Transform().
+   */
+  RandomFourierFeatures();
+
+  /**
+   * Create the transform for the given kernel, drawing its random frequencies.
+   *
+   * @param kernel Shift-invariant kernel to approximate.
+   * @param dimensionality Dimensionality of the input points.
+   * @param numFrequencies Number of random frequencies (the output has twice
+   *     as many dimensions).
+   * @param fastfood Whether to use Fastfood instead of a dense projection.
+   */
+  template<typename KernelType>
+  RandomFourierFeatures(const KernelType& kernel,
+                        const size_t dimensionality,
+                        const size_t numFrequencies,
+                        const bool fastfood = false);
+
+  /**
+   * Draw new random frequencies for the given kernel.  A std::invalid_argument
+   * is thrown if the dimensionality or the number of frequencies is 0.
+   *
+   * @param kernel Shift-invariant kernel to approximate.
+   * @param dimensionality Dimensionality of the input points.
+   * @param numFrequencies Number of random frequencies (the output has twice
+   *     as many dimensions).
+   * @param fastfood Whether to use Fastfood instead of a dense projection.
+   */
+  template<typename KernelType>
+  void Train(const KernelType& kernel,
+             const size_t dimensionality,
+             const size_t numFrequencies,
+             const bool fastfood = false);
+
+  /**
+   * Compute the features of the given points.  A std::invalid_argument is
+   * thrown if the dimensionality of the points is not the dimensionality the
+   * transform was trained for.
+   *
+   * @param input Points to transform (one per column).
+   * @param output Matrix to store the features in: OutputDimensionality() rows
+   *     and one column per point.
+   */
+  void Transform(const arma::mat& input, arma::mat& output) const;
+
+  //! Get the dimensionality of the input points.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get the number of random frequencies.
+  size_t NumFrequencies() const { return numFrequencies; }
+  //! Get the dimensionality of the features.
+  size_t OutputDimensionality() const { return 2 * numFrequencies; }
+  //! Get whether Fastfood is used.
+  bool Fastfood() const { return fastfood; }
+
+  //! Get the frequencies of the dense projection (one per row; empty if
+  //! Fastfood is used).
+  const arma::mat& Frequencies() const { return frequencies; }
+
+  //! Serialize the transform.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Compute W x for the given points, with Fastfood.
+  void FastfoodProject(const arma::mat& input, arma::mat& projections) const;
+
+  //! Apply the (unnormalized) Walsh-Hadamard transform to v in place.
+  static void WalshHadamard(double* v, const size_t n);
+
+  //! The number of points transformed at a time.
+  static size_t BlockSize() { return 256; }
+
+  //! The dimensionality of the input points.
+  size_t dimensionality;
+  //! The number of random frequencies.
+  size_t numFrequencies;
+  //! Whether Fastfood is used.
+  bool fastfood;
+
+  //! The frequencies of the dense projection, one per row.
+  arma::mat frequencies;
+
+  //! The dimensionality of the input after padding, for Fastfood.
+  size_t paddedDimensionality;
+  //! The random signs of each Fastfood block (one block per column).
+  arma::mat signs;
+  //! The permutation of each Fastfood block.
+  arma::Mat<size_t> permutations;
+  //! The Gaussian diagonal of each Fastfood block.
+  arma::mat gaussians;
+  //! The scaling diagonal of each Fastfood block.
+  arma::mat scales;
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "random_fourier_features_impl.hpp"
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file random_fourier_features_impl.hpp
+ *
+ * Implementation of the templated functions of RandomFourierFeatures.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "random_fourier_features.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+template<typename KernelType>
+RandomFourierFeatures::RandomFourierFeatures(const KernelType& kernel,
+                                             const size_t dimensionality,
+                                             const size_t numFrequencies,
+                                             const bool fastfood)
+{
+  Train(kernel, dimensionality, numFrequencies, fastfood);
+}
+
+template<typename KernelType>
+void RandomFourierFeatures::Train(const KernelType& kernel,
+                                  const size_t dimensionality,
+                                  const size_t numFrequencies,
+                                  const bool fastfood)
+{
+  if (dimensionality == 0 || numFrequencies == 0)
+  {
+    std::ostringstream oss;
+    oss << "RandomFourierFeatures::Train(): the dimensionality ("
+        << dimensionality << ") and the number of frequencies ("
+        << numFrequencies << ") must be positive!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  this->dimensionality = dimensionality;
+  this->numFrequencies = numFrequencies;
+  this->fastfood = fastfood;
+
+  if (!fastfood)
+  {
+    arma::mat w;
+    KernelSpectrum<KernelType>::Sample(kernel, dimensionality, numFrequencies,
+        w);
+    frequencies = w.t();
+
+    paddedDimensionality = 0;
+    signs.clear();
+    permutations.clear();
+    gaussians.clear();
+    scales.clear();
+    return;
+  }
+
+  frequencies.clear();
+
+  // Each block of Fastfood gives paddedDimensionality frequencies.
+  paddedDimensionality = 1;
+  while (paddedDimensionality < dimensionality)
+    paddedDimensionality *= 2;
+  const size_t numBlocks = (numFrequencies + paddedDimensionality - 1) /
+      paddedDimensionality;
+
+  signs.set_size(paddedDimensionality, numBlocks);
+  for (size_t i = 0; i < signs.n_elem; ++i)
+    signs[i] = (math::Random() < 0.5) ? -1.0 : 1.0;
+
+  permutations.set_size(paddedDimensionality, numBlocks);
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    permutations.col(b) = arma::conv_to<arma::Col<size_t>>::from(
+        arma::randperm(paddedDimensionality));
+  }
+
+  gaussians.randn(paddedDimensionality, numBlocks);
+
+  // Each row of H G P H B has norm sqrt(paddedDimensionality) * ||G||, so S
+  // rescales the rows to the norms of frequencies drawn from the spectrum.
+  scales.set_size(paddedDimensionality, numBlocks);
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    arma::mat w;
+    KernelSpectrum<KernelType>::Sample(kernel, paddedDimensionality,
+        paddedDimensionality, w);
+    scales.col(b) = arma::sqrt(arma::sum(arma::square(w), 0)).t() /
+        (std::sqrt((double) paddedDimensionality) *
+        arma::norm(gaussians.col(b)));
+  }
+}
+
+template<typename Archive>
+void RandomFourierFeatures::serialize(Archive& ar,
+                                      const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(dimensionality);
+  ar & BOOST_SERIALIZATION_NVP(numFrequencies);
+  ar & BOOST_SERIALIZATION_NVP(fastfood);
+  ar & BOOST_SERIALIZATION_NVP(frequencies);
+  ar & BOOST_SERIALIZATION_NVP(paddedDimensionality);
+  ar & BOOST_SERIALIZATION_NVP(signs);
+  ar & BOOST_SERIALIZATION_NVP(permutations);
+  ar & BOOST_SERIALIZATION_NVP(gaussians);
+  ar & BOOST_SERIALIZATION_NVP(scales);
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -11,6 +11,7 @@
  */
 
 #include "randomized_svd.hpp"
+#include "streaming_products.hpp"
 
 namespace mlpack {
 namespace svd {
@@ -72,5 +73,69 @@ void RandomizedSVD::Apply(const arma::mat& data,
   Apply(data, u, s, v, rank, rowMean);
 }
 
+void RandomizedSVD::Apply(data::StreamingDataset<>& data,
+                          arma::mat& u,
+                          arma::vec& s,
+                          const size_t rank,
+                          const bool center)
+{
+  arma::vec mean;
+  if (center)
+    StreamingProducts::Mean(data, mean);
+
+  ApplyStreaming(data, u, s, rank, center ? &mean : NULL);
+}
+
+void RandomizedSVD::Apply(data::StreamingDataset<>& data,
+                          arma::mat& u,
+                          arma::vec& s,
+                          arma::mat& v,
+                          const size_t rank,
+                          const bool center)
+{
+  arma::vec mean;
+  if (center)
+    StreamingProducts::Mean(data, mean);
+  const arma::vec* meanPtr = center ? &mean : NULL;
+
+  ApplyStreaming(data, u, s, rank, meanPtr);
+  StreamingProducts::RightSingularVectors(data, u, s, meanPtr, v);
+}
+
+void RandomizedSVD::ApplyStreaming(data::StreamingDataset<>& data,
+                                   arma::mat& u,
+                                   arma::vec& s,
+                                   const size_t rank,
+                                   const arma::vec* mean)
+{
+  if (rank > data.NumRows() || rank > data.NumCols())
+  {
+    Log::Fatal << "RandomizedSVD::Apply(): rank " << rank << " is larger "
+        << "than the dimensions of the data (" << data.NumRows() << " x "
+        << data.NumCols() << ")!" << std::endl;
+  }
+
+  // The number of random vectors to sample, at least the rank.
+  size_t numVectors = (iteratedPower == 0) ? rank + 2 : iteratedPower;
+  numVectors = std::min(std::max(numVectors, rank), data.NumRows());
+
+  // Apply the Gram matrix of the data to a random matrix, and orthonormalize
+  // the result.  Since C C^T has the same left singular vectors as C and its
+  // singular values are squared, this is already one power iteration.
+  arma::mat Q = arma::randn<arma::mat>(data.NumRows(), numVectors);
+  arma::mat Y, R;
+  StreamingProducts::GramProduct(data, Q, mean, Y);
+  arma::qr_econ(Q, R, Y);
+
+  // Perform normalized power iterations.
+  for (size_t i = 0; i < maxIterations; ++i)
+  {
+    StreamingProducts::GramProduct(data, Q, mean, Y);
+    arma::qr_econ(Q, R, Y);
+  }
+
+  StreamingProducts::RayleighRitz(data, Q, mean, rank, u, s);
+}
+
 } // namespace svd
 } // namespace mlpack
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/streaming_dataset.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -136,6 +137,51 @@ class RandomizedSVD
              arma::mat& v,
              const size_t rank);
 
+  /**
+   * Compute the leading singular values and left singular vectors of a matrix
+   * that is read from disk one chunk of columns at a time, so that it never
+   * needs to fit in memory.  If center is true, the mean of the columns is
+   * subtracted from every column on the fly, as for Principal Component
+   * Analysis, without forming the centered matrix.
+   *
+   * Each normalized power iteration is one pass over the data (the products
+   * with the transposed matrix are consumed block by block), and the
+   * singular values are extracted with one more pass; centering adds one
+   * pass to compute the mean.  With the default of two iterations, the
+   * decomposition reads the data three or four times.
+   *
+   * @param data Dataset to decompose.
+   * @param u First unitary matrix.
+   * @param s Vector of singular values.
+   * @param rank Rank of the approximation.
+   * @param center Whether to center the columns of the data.
+   */
+  void Apply(data::StreamingDataset<>& data,
+             arma::mat& u,
+             arma::vec& s,
+             const size_t rank,
+             const bool center = false);
+
+  /**
+   * Compute the leading singular values and both sets of singular vectors of
+   * a matrix that is read from disk one chunk of columns at a time; see the
+   * overload above.  The right singular vectors take one more pass over the
+   * data, and have one row for each column of the data.
+   *
+   * @param data Dataset to decompose.
+   * @param u First unitary matrix.
+   * @param s Vector of singular values.
+   * @param v Second unitary matrix.
+   * @param rank Rank of the approximation.
+   * @param center Whether to center the columns of the data.
+   */
+  void Apply(data::StreamingDataset<>& data,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v,
+             const size_t rank,
+             const bool center = false);
+
   /**
    * Apply Principal Component Analysis to the provided matrix data set
    * using the randomized SVD.
@@ -247,6 +293,17 @@ class RandomizedSVD
   double& Epsilon() { return eps; }
 
  private:
+  /**
+   * Compute the leading singular values and left singular vectors of a
+   * streamed matrix, whose columns are centered with the given mean if it is
+   * not NULL.
+   */
+  void ApplyStreaming(data::StreamingDataset<>& data,
+                      arma::mat& u,
+                      arma::vec& s,
+                      const size_t rank,
+                      const arma::vec* mean);
+
   //! Locally stored size of the normalized power iterations.
   size_t iteratedPower;
 
@@ -0,0 +1,180 @@
+/**
+ * @file streaming_products.cpp
+ *
+ * Implementation of the products with a streamed matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "streaming_products.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace svd {
+
+void StreamingProducts::Mean(data::StreamingDataset<>& data, arma::vec& mean)
+{
+  mean.zeros(data.NumRows());
+
+  arma::mat chunk;
+  for (size_t c = 0; c < data.NumChunks(); ++c)
+  {
+    data.Chunk(c, NextChunk(data, c), chunk);
+    mean += arma::sum(chunk, 1);
+  }
+
+  if (data.NumCols() > 0)
+    mean /= data.NumCols();
+}
+
+void StreamingProducts::GramProduct(data::StreamingDataset<>& data,
+                                    const arma::mat& x,
+                                    const arma::vec* mean,
+                                    arma::mat& result)
+{
+  #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+  #else
+    const size_t numThreads = 1;
+  #endif
+
+  // Each thread sums the products of its blocks; the sums are added in a fixed
+  // order at the end, so the result doesn't depend on the scheduling.
+  std::vector<arma::mat> partials(numThreads,
+      arma::zeros<arma::mat>(data.NumRows(), x.n_cols));
+
+  // For the centered matrix, C^T x = A^T x - 1 * (mean^T x).
+  arma::rowvec meanProducts;
+  if (mean)
+    meanProducts = mean->t() * x;
+
+  arma::mat chunk;
+  for (size_t c = 0; c < data.NumChunks(); ++c)
+  {
+    data.Chunk(c, NextChunk(data, c), chunk);
+
+    const size_t numBlocks = (chunk.n_cols + ProductBlockSize - 1) /
+        ProductBlockSize;
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      #ifdef HAS_OPENMP
+        arma::mat& partial = partials[omp_get_thread_num()];
+      #else
+        arma::mat& partial = partials[0];
+      #endif
+
+      const size_t begin = b * ProductBlockSize;
+      const size_t end = std::min(begin + ProductBlockSize,
+          (size_t) chunk.n_cols);
+
+      arma::mat products = chunk.cols(begin, end - 1).t() * x;
+      if (mean)
+      {
+        products.each_row() -= meanProducts;
+        partial += chunk.cols(begin, end - 1) * products -
+            (*mean) * arma::sum(products, 0);
+      }
+      else
+      {
+        partial += chunk.cols(begin, end - 1) * products;
+      }
+    }
+  }
+
+  result = std::move(partials[0]);
+  for (size_t t = 1; t < numThreads; ++t)
+    result += partials[t];
+}
+
+void StreamingProducts::TransposeProduct(data::StreamingDataset<>& data,
+                                         const arma::mat& x,
+                                         const arma::vec* mean,
+                                         arma::mat& result)
+{
+  result.set_size(data.NumCols(), x.n_cols);
+
+  arma::rowvec meanProducts;
+  if (mean)
+    meanProducts = mean->t() * x;
+
+  arma::mat chunk;
+  for (size_t c = 0; c < data.NumChunks(); ++c)
+  {
+    data.Chunk(c, NextChunk(data, c), chunk);
+    const size_t offset = c * data.ChunkSize();
+
+    const size_t numBlocks = (chunk.n_cols + ProductBlockSize - 1) /
+        ProductBlockSize;
+
+    // Every block fills its own rows of the result.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * ProductBlockSize;
+      const size_t end = std::min(begin + ProductBlockSize,
+          (size_t) chunk.n_cols);
+
+      result.rows(offset + begin, offset + end - 1) =
+          chunk.cols(begin, end - 1).t() * x;
+      if (mean)
+        result.rows(offset + begin, offset + end - 1).each_row() -=
+            meanProducts;
+    }
+  }
+}
+
+void StreamingProducts::RayleighRitz(data::StreamingDataset<>& data,
+                                     const arma::mat& basis,
+                                     const arma::vec* mean,
+                                     const size_t rank,
+                                     arma::mat& u,
+                                     arma::vec& s)
+{
+  arma::mat gramProducts;
+  GramProduct(data, basis, mean, gramProducts);
+
+  // Remove the asymmetry caused by rounding.
+  arma::mat projected = basis.t() * gramProducts;
+  projected = 0.5 * (projected + projected.t());
+
+  arma::vec eigval;
+  arma::mat eigvec;
+  arma::eig_sym(eigval, eigvec, projected);
+
+  // The eigenvalues are in increasing order; the largest ones are needed.
+  const size_t n = eigval.n_elem;
+  s.set_size(rank);
+  u.set_size(basis.n_rows, rank);
+  for (size_t i = 0; i < rank; ++i)
+  {
+    s[i] = std::sqrt(std::max(eigval[n - 1 - i], 0.0));
+    u.col(i) = basis * eigvec.col(n - 1 - i);
+  }
+}
+
+void StreamingProducts::RightSingularVectors(data::StreamingDataset<>& data,
+                                             const arma::mat& u,
+                                             const arma::vec& s,
+                                             const arma::vec* mean,
+                                             arma::mat& v)
+{
+  TransposeProduct(data, u, mean, v);
+
+  for (size_t i = 0; i < s.n_elem; ++i)
+  {
+    if (s[i] > 0.0)
+      v.col(i) /= s[i];
+    else
+      v.col(i).zeros();
+  }
+}
+
+} // namespace svd
+} // namespace mlpack
@@ -0,0 +1,137 @@
+/**
+ * @file streaming_products.hpp
+ *
+ * Matrix products with a matrix that is read from disk one block of columns
+ * at a time, as needed by the out-of-core randomized SVD methods.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_STREAMING_PRODUCTS_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_STREAMING_PRODUCTS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/streaming_dataset.hpp>
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * StreamingProducts computes products with a matrix C that is stored on disk
+ * and read through a data::StreamingDataset.  C is either the stored matrix A
+ * or, if a mean vector is given, the centered matrix A - mean * 1^T, which is
+ * never formed: the mean is subtracted from the products instead.
+ *
+ * Each function makes exactly one pass over the dataset.  The columns of each
+ * chunk are split into blocks that are multiplied in parallel, and the next
+ * chunk is read in the background while the current one is in use.  Since the
+ * last chunk of a pass reads the first one ahead, consecutive passes don't
+ * wait for the disk either.
+ *
+ * Only matrices with as many rows as the stored matrix (or as many as the
+ * rank of the decomposition) are held in memory, except for
+ * TransposeProduct(), whose result has one row per stored column.
+ */
+class StreamingProducts
+{
+ public:
+  /**
+   * Compute the mean of the columns of the stored matrix.
+   *
+   * @param data Dataset to read.
+   * @param mean Vector to store the mean in.
+   */
+  static void Mean(data::StreamingDataset<>& data, arma::vec& mean);
+
+  /**
+   * Compute result = C * C^T * x.  Each chunk of columns is multiplied with x
+   * and then with the result right away, so the products with C^T are never
+   * stored.
+   *
+   * @param data Dataset to read.
+   * @param x Matrix to multiply, with as many rows as the stored matrix.
+   * @param mean Mean to subtract from every column, or NULL to use the stored
+   *     matrix as it is.
+   * @param result Matrix to store the product in.
+   */
+  static void GramProduct(data::StreamingDataset<>& data,
+                          const arma::mat& x,
+                          const arma::vec* mean,
+                          arma::mat& result);
+
+  /**
+   * Compute result = C^T * x, which has one row for each column of the stored
+   * matrix.
+   *
+   * @param data Dataset to read.
+   * @param x Matrix to multiply, with as many rows as the stored matrix.
+   * @param mean Mean to subtract from every column, or NULL to use the stored
+   *     matrix as it is.
+   * @param result Matrix to store the product in.
+   */
+  static void TransposeProduct(data::StreamingDataset<>& data,
+                               const arma::mat& x,
+                               const arma::vec* mean,
+                               arma::mat& result);
+
+  /**
+   * Approximate the leading singular values and left singular vectors of C
+   * from an orthonormal basis Q of a subspace that nearly holds them (the
+   * Rayleigh-Ritz method).  The eigendecomposition of the small matrix
+   * Q^T C C^T Q, obtained with one call to GramProduct(), gives the singular
+   * values of Q^T C and, through Q, the singular vectors.  Because the
+   * singular values are squared, those much smaller than the largest one are
+   * less accurate than with an SVD of Q^T C, which would need to be stored.
+   *
+   * @param data Dataset to read.
+   * @param basis Orthonormal basis Q, with as many rows as the stored matrix.
+   * @param mean Mean to subtract from every column, or NULL to use the stored
+   *     matrix as it is.
+   * @param rank Number of singular values and vectors to compute; it can't be
+   *     larger than the number of columns of the basis.
+   * @param u Matrix to store the left singular vectors in.
+   * @param s Vector to store the singular values in, in decreasing order.
+   */
+  static void RayleighRitz(data::StreamingDataset<>& data,
+                           const arma::mat& basis,
+                           const arma::vec* mean,
+                           const size_t rank,
+                           arma::mat& u,
+                           arma::vec& s);
+
+  /**
+   * Compute the right singular vectors v = C^T u diag(s)^-1 that correspond to
+   * the given left singular vectors and singular values.  Vectors whose
+   * singular value is zero are set to zero.
+   *
+   * @param data Dataset to read.
+   * @param u Left singular vectors.
+   * @param s Singular values.
+   * @param mean Mean to subtract from every column, or NULL to use the stored
+   *     matrix as it is.
+   * @param v Matrix to store the right singular vectors in.
+   */
+  static void RightSingularVectors(data::StreamingDataset<>& data,
+                                   const arma::mat& u,
+                                   const arma::vec& s,
+                                   const arma::vec* mean,
+                                   arma::mat& v);
+
+ private:
+  //! The number of columns of a chunk multiplied by one thread at once.
+  static const size_t ProductBlockSize = 1024;
+
+  //! Get the index of the chunk to read ahead after the given one.
+  static size_t NextChunk(const data::StreamingDataset<>& data,
+                          const size_t index)
+  {
+    return (index + 1) % data.NumChunks();
+  }
+};
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
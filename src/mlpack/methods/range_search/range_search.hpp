@@ -262,6 +262,106 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, returning the results in compressed sparse row (CSR) layout:
+   *
+   * - offsets has one more element than the number of query points, and
+   *   offsets[i] is the position of the first result of query point i in
+   *   neighbors and distances; the last element is the number of results.
+   *
+   * - neighbors[offsets[i]] to neighbors[offsets[i + 1] - 1] are the indices of
+   *   the reference points in the range of query point i, and distances holds
+   *   their distances at the same positions.
+   *
+   * - The results of a query point are not sorted in any particular order.
+   *
+   * Every thread stores its results in its own flat buffer, so this takes far
+   * less memory and time than the overload with nested vectors when there are
+   * many results.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param offsets Offset of the results of each query point.
+   * @param neighbors Indices of the results.
+   * @param distances Distances of the results.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Given a pre-built query tree, search for all reference points in the given
+   * range for each point in the query set, returning the results in CSR layout
+   * (see the overload that takes a query set).  The query indices are those of
+   * the query tree's dataset.  If either naive or singleMode are set to true,
+   * this will throw an invalid_argument exception.
+   *
+   * @param queryTree Tree built on query points.
+   * @param range Range of distances in which to search.
+   * @param offsets Offset of the results of each query point.
+   * @param neighbors Indices of the results.
+   * @param distances Distances of the results.
+   */
+  void Search(Tree* queryTree,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, returning the results in CSR layout (see the overload that takes a
+   * query set).  A point is not returned in its own range.
+   *
+   * @param range Range of distances in which to search.
+   * @param offsets Offset of the results of each query point.
+   * @param neighbors Indices of the results.
+   * @param distances Distances of the results.
+   */
+  void Search(const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Count the reference points in the given range of each point in the query
+   * set, without storing them.  The distances to the points of reference nodes
+   * that lie entirely in the range are not computed.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param counts Filled with the number of results of each query point.
+   */
+  void Count(const MatType& querySet,
+             const math::Range& range,
+             arma::Col<size_t>& counts);
+
+  /**
+   * Given a pre-built query tree, count the reference points in the given range
+   * of each point in the query set, without storing them.  The query indices
+   * are those of the query tree's dataset.  If either naive or singleMode are
+   * set to true, this will throw an invalid_argument exception.
+   *
+   * @param queryTree Tree built on query points.
+   * @param range Range of distances in which to search.
+   * @param counts Filled with the number of results of each query point.
+   */
+  void Count(Tree* queryTree,
+             const math::Range& range,
+             arma::Col<size_t>& counts);
+
+  /**
+   * Count the points in the given range of each point in the reference set,
+   * without storing them.  A point is not counted in its own range.
+   *
+   * @param range Range of distances in which to search.
+   * @param counts Filled with the number of results of each point.
+   */
+  void Count(const math::Range& range, arma::Col<size_t>& counts);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -312,6 +412,34 @@ class RangeSearch
   //! The total number of scores during the last search.
   size_t scores;
 
+  /**
+   * Run the search with rules that store their results in objects of the
+   * given type.  Each copy of the rules starts with a copy of initialResults,
+   * and the results of all copies are returned in threadResults, together
+   * with the mappings from the indices they hold to the original indices.
+   *
+   * @param querySet Set of query points, or NULL to search with the reference
+   *     set.
+   * @param queryTree Tree built on the query points, or NULL if it must be
+   *     built.
+   * @param range Range of distances in which to search.
+   * @param initialResults Results object copied for each copy of the rules.
+   * @param threadResults Filled with the results of each copy of the rules.
+   * @param oldFromNewQueries Holds the mappings of the query tree, if it is
+   *     built.
+   * @param queryMapping Set to the mapping of query indices, or NULL.
+   * @param referenceMapping Set to the mapping of reference indices, or NULL.
+   */
+  template<typename ResultType>
+  void SearchResults(const MatType* querySet,
+                     Tree* queryTree,
+                     const math::Range& range,
+                     const ResultType& initialResults,
+                     std::vector<ResultType>& threadResults,
+                     std::vector<size_t>& oldFromNewQueries,
+                     const std::vector<size_t>*& queryMapping,
+                     const std::vector<size_t>*& referenceMapping);
+
   //! For access to mappings when building models.
   friend class TrainVisitor;
 };
@@ -17,6 +17,9 @@
 
 // The rules for traversal.
 #include "range_search_rules.hpp"
+#include <mlpack/core/tree/instrumented_rules.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
+#include <mlpack/core/tree/parallel_single_tree_traverser.hpp>
 
 namespace mlpack {
 namespace range {
@@ -322,7 +325,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   distancePtr->resize(querySet.n_cols);
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
+  typedef tree::TraversalRules<RangeSearchRules<MetricType, Tree>> RuleType;
 
   // Reset counts.
   baseCases = 0;
@@ -342,17 +345,24 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
+    // Create the traverser.  Each thread traverses its own blocks of query
+    // points with its own copy of the rules; results are written for disjoint
+    // query points, so they can all share the result vectors.  With
+    // self-children, the rules cache distances in the reference tree, so only
+    // one thread can be used.
     RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
         metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    tree::ParallelSingleTreeTraverser<Tree, RuleType,
+        typename Tree::template SingleTreeTraverser<RuleType>> traverser(rules,
+        !tree::TreeTraits<Tree>::HasSelfChildren);
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    traverser.Traverse(querySet.n_cols, *referenceTree);
 
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    for (size_t i = 0; i < traverser.Rules().size(); ++i)
+    {
+      baseCases += traverser.Rules()[i].BaseCases();
+      scores += traverser.Rules()[i].Scores();
+    }
   }
   else // Dual-tree recursion.
   {
@@ -363,15 +373,21 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     Timer::Stop("range_search/tree_building");
     Timer::Start("range_search/computing_neighbors");
 
-    // Create the traverser.
+    // Create the traverser.  Each thread traverses its own query subtrees with
+    // its own copy of the rules; results are written for disjoint query
+    // points, so they can all share the result vectors.
     RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
         *distancePtr, metric);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    tree::ParallelDualTreeTraverser<Tree, RuleType,
+        Tree::template DualTreeTraverser> traverser(rules);
 
     traverser.Traverse(*queryTree, *referenceTree);
 
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    for (size_t i = 0; i < traverser.Rules().size(); ++i)
+    {
+      baseCases += traverser.Rules()[i].BaseCases();
+      scores += traverser.Rules()[i].Scores();
+    }
 
     // Clean up tree memory.
     delete queryTree;
@@ -484,19 +500,25 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   distances.resize(querySet.n_cols);
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
+  typedef tree::TraversalRules<RangeSearchRules<MetricType, Tree>> RuleType;
   RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
       distances, metric);
 
   // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  tree::ParallelDualTreeTraverser<Tree, RuleType,
+      Tree::template DualTreeTraverser> traverser(rules);
 
   traverser.Traverse(*queryTree, *referenceTree);
 
   Timer::Stop("range_search/computing_neighbors");
 
-  baseCases = rules.BaseCases();
-  scores = rules.Scores();
+  baseCases = 0;
+  scores = 0;
+  for (size_t i = 0; i < traverser.Rules().size(); ++i)
+  {
+    baseCases += traverser.Rules()[i].BaseCases();
+    scores += traverser.Rules()[i].Scores();
+  }
 
   // Do we need to map indices?
   if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
@@ -551,7 +573,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   distancePtr->resize(referenceSet->n_cols);
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
+  typedef tree::TraversalRules<RangeSearchRules<MetricType, Tree>> RuleType;
   RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
       *distancePtr, metric, true /* don't return the query in the results */);
 
@@ -567,25 +589,36 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    // Create the traverser; each thread uses its own copy of the rules.
+    tree::ParallelSingleTreeTraverser<Tree, RuleType,
+        typename Tree::template SingleTreeTraverser<RuleType>> traverser(rules,
+        !tree::TreeTraits<Tree>::HasSelfChildren);
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    traverser.Traverse(referenceSet->n_cols, *referenceTree);
 
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+    baseCases = 0;
+    scores = 0;
+    for (size_t i = 0; i < traverser.Rules().size(); ++i)
+    {
+      baseCases += traverser.Rules()[i].BaseCases();
+      scores += traverser.Rules()[i].Scores();
+    }
   }
   else // Dual-tree recursion.
   {
     // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    tree::ParallelDualTreeTraverser<Tree, RuleType,
+        Tree::template DualTreeTraverser> traverser(rules);
 
     traverser.Traverse(*referenceTree, *referenceTree);
 
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+    baseCases = 0;
+    scores = 0;
+    for (size_t i = 0; i < traverser.Rules().size(); ++i)
+    {
+      baseCases += traverser.Rules()[i].BaseCases();
+      scores += traverser.Rules()[i].Scores();
+    }
   }
 
   Timer::Stop("range_search/computing_neighbors");
@@ -618,6 +651,265 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  std::vector<CSRRangeResults> results;
+  std::vector<size_t> oldFromNewQueries;
+  const std::vector<size_t>* queryMapping;
+  const std::vector<size_t>* referenceMapping;
+  SearchResults(&querySet, NULL, range, CSRRangeResults(), results,
+      oldFromNewQueries, queryMapping, referenceMapping);
+
+  CSRRangeResults::Assemble(results, querySet.n_cols, queryMapping,
+      referenceMapping, offsets, neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    Tree* queryTree,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  std::vector<CSRRangeResults> results;
+  std::vector<size_t> oldFromNewQueries;
+  const std::vector<size_t>* queryMapping;
+  const std::vector<size_t>* referenceMapping;
+  SearchResults((const MatType*) NULL, queryTree, range, CSRRangeResults(),
+      results, oldFromNewQueries, queryMapping, referenceMapping);
+
+  CSRRangeResults::Assemble(results, queryTree->Dataset().n_cols,
+      queryMapping, referenceMapping, offsets, neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  std::vector<CSRRangeResults> results;
+  std::vector<size_t> oldFromNewQueries;
+  const std::vector<size_t>* queryMapping;
+  const std::vector<size_t>* referenceMapping;
+  SearchResults((const MatType*) NULL, NULL, range, CSRRangeResults(), results,
+      oldFromNewQueries, queryMapping, referenceMapping);
+
+  CSRRangeResults::Assemble(results, referenceSet->n_cols, queryMapping,
+      referenceMapping, offsets, neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  std::vector<CountRangeResults> results;
+  std::vector<size_t> oldFromNewQueries;
+  const std::vector<size_t>* queryMapping;
+  const std::vector<size_t>* referenceMapping;
+  SearchResults(&querySet, NULL, range, CountRangeResults(querySet.n_cols),
+      results, oldFromNewQueries, queryMapping, referenceMapping);
+
+  CountRangeResults::Assemble(results, querySet.n_cols, queryMapping, counts);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    Tree* queryTree,
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  const size_t numQueries = queryTree->Dataset().n_cols;
+  std::vector<CountRangeResults> results;
+  std::vector<size_t> oldFromNewQueries;
+  const std::vector<size_t>* queryMapping;
+  const std::vector<size_t>* referenceMapping;
+  SearchResults((const MatType*) NULL, queryTree, range,
+      CountRangeResults(numQueries), results, oldFromNewQueries, queryMapping,
+      referenceMapping);
+
+  CountRangeResults::Assemble(results, numQueries, queryMapping, counts);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  std::vector<CountRangeResults> results;
+  std::vector<size_t> oldFromNewQueries;
+  const std::vector<size_t>* queryMapping;
+  const std::vector<size_t>* referenceMapping;
+  SearchResults((const MatType*) NULL, NULL, range,
+      CountRangeResults(referenceSet->n_cols), results, oldFromNewQueries,
+      queryMapping, referenceMapping);
+
+  CountRangeResults::Assemble(results, referenceSet->n_cols, queryMapping,
+      counts);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename ResultType>
+void RangeSearch<MetricType, MatType, TreeType>::SearchResults(
+    const MatType* querySet,
+    Tree* queryTree,
+    const math::Range& range,
+    const ResultType& initialResults,
+    std::vector<ResultType>& threadResults,
+    std::vector<size_t>& oldFromNewQueries,
+    const std::vector<size_t>*& queryMapping,
+    const std::vector<size_t>*& referenceMapping)
+{
+  threadResults.clear();
+
+  if (querySet && querySet->n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "RangeSearch::Search(): dimensionalities of query set ("
+        << querySet->n_rows << ") and reference set (" << referenceSet->n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (queryTree && (singleMode || naive))
+    throw std::invalid_argument("cannot call RangeSearch::Search() with a "
+        "query tree when naive or singleMode are set to true");
+
+  // Reference indices only need to be mapped if we built the reference tree
+  // ourselves.  When searching with the reference set, the query indices are
+  // reference indices too.
+  const bool sameSet = (querySet == NULL && queryTree == NULL);
+  referenceMapping = (tree::TreeTraits<Tree>::RearrangesDataset && treeOwner) ?
+      &oldFromNewReferences : NULL;
+  queryMapping = sameSet ? referenceMapping : NULL;
+
+  // Reset counts.
+  baseCases = 0;
+  scores = 0;
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  Timer::Start("range_search/computing_neighbors");
+
+  typedef tree::TraversalRules<RangeSearchRules<MetricType, Tree,
+      ResultType>> RuleType;
+
+  if (naive)
+  {
+    const MatType& queries = sameSet ? *referenceSet : *querySet;
+    RuleType rules(*referenceSet, queries, range, initialResults, metric,
+        sameSet);
+
+    // The naive brute-force solution.
+    for (size_t i = 0; i < queries.n_cols; ++i)
+      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
+
+    baseCases = (queries.n_cols * referenceSet->n_cols);
+    threadResults.push_back(std::move(rules.Results()));
+  }
+  else if (singleMode)
+  {
+    // Each thread traverses its own blocks of query points with its own copy
+    // of the rules, and so with its own results.
+    const MatType& queries = sameSet ? *referenceSet : *querySet;
+    RuleType rules(*referenceSet, queries, range, initialResults, metric,
+        sameSet);
+    tree::ParallelSingleTreeTraverser<Tree, RuleType,
+        typename Tree::template SingleTreeTraverser<RuleType>> traverser(rules,
+        !tree::TreeTraits<Tree>::HasSelfChildren);
+
+    traverser.Traverse(queries.n_cols, *referenceTree);
+
+    for (size_t i = 0; i < traverser.Rules().size(); ++i)
+    {
+      baseCases += traverser.Rules()[i].BaseCases();
+      scores += traverser.Rules()[i].Scores();
+      threadResults.push_back(std::move(traverser.Rules()[i].Results()));
+    }
+  }
+  else // Dual-tree recursion.
+  {
+    // Build the query tree, if we weren't given one.
+    Tree* builtTree = NULL;
+    if (querySet)
+    {
+      Timer::Stop("range_search/computing_neighbors");
+      Timer::Start("range_search/tree_building");
+      builtTree = BuildTree<Tree>(*querySet, oldFromNewQueries);
+      Timer::Stop("range_search/tree_building");
+      Timer::Start("range_search/computing_neighbors");
+
+      if (tree::TreeTraits<Tree>::RearrangesDataset)
+        queryMapping = &oldFromNewQueries;
+    }
+
+    Tree& queryNode = builtTree ? *builtTree :
+        (queryTree ? *queryTree : *referenceTree);
+
+    // Each thread traverses its own query subtrees with its own copy of the
+    // rules, and so with its own results.
+    RuleType rules(*referenceSet, queryNode.Dataset(), range, initialResults,
+        metric, sameSet);
+    tree::ParallelDualTreeTraverser<Tree, RuleType,
+        Tree::template DualTreeTraverser> traverser(rules);
+
+    traverser.Traverse(queryNode, *referenceTree);
+
+    for (size_t i = 0; i < traverser.Rules().size(); ++i)
+    {
+      baseCases += traverser.Rules()[i].BaseCases();
+      scores += traverser.Rules()[i].Scores();
+      threadResults.push_back(std::move(traverser.Rules()[i].Results()));
+    }
+
+    // Clean up tree memory.
+    delete builtTree;
+  }
+
+  Timer::Stop("range_search/computing_neighbors");
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
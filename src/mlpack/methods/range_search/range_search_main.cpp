@@ -55,12 +55,26 @@ PROGRAM_INFO("Range Search",
     " resultant CSV-like files may not be loadable by many programs.  However, "
     "at this time a better way to store this non-square result is not known.  "
     "As a result, any output files will be written as CSVs in this manner, "
-    "regardless of the given extension.");
+    "regardless of the given extension."
+    "\n\n"
+    "If only the number of points in the range of each query point is needed, "
+    "it can be saved with the " + PRINT_PARAM_STRING("counts_file") +
+    " parameter; line i of that file holds the number of points found for "
+    "query point i."
+    "\n\n"
+    "For example, the following will count the points within the range [0, "
+    "0.5] of each point in 'input.csv' and store the counts in 'counts.csv':"
+    "\n\n"
+    "$ range_search --max=0.5 --reference_file=input.csv\n"
+    "  --counts_file=counts.csv");
 
 // Define our input parameters that this program will take.
 PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
 PARAM_STRING_OUT("distances_file", "File to output distances into.", "d");
 PARAM_STRING_OUT("neighbors_file", "File to output neighbors into.", "n");
+PARAM_STRING_OUT("counts_file", "File to output the number of neighbors of "
+    "each query point into.  If neither neighbors nor distances are saved, the "
+    "neighbors are only counted, which is faster and uses less memory.", "c");
 
 // The option exists to load or save models.
 PARAM_MODEL_IN(RSModel, "input_model", "File containing pre-trained range "
@@ -113,14 +127,15 @@ static void mlpackMain()
   // If the user specifies a range but not output files, they should be warned.
   if (CLI::HasParam("min") || CLI::HasParam("max"))
   {
-    RequireAtLeastOnePassed({ "neighbors_file", "distances_file" }, false,
-        "no range search results will be saved");
+    RequireAtLeastOnePassed({ "neighbors_file", "distances_file",
+        "counts_file" }, false, "no range search results will be saved");
   }
 
   if (!CLI::HasParam("min") && !CLI::HasParam("max"))
   {
     ReportIgnoredParam("neighbors_file", "no range is specified for searching");
     ReportIgnoredParam("distances_file", "no range is specified for searching");
+    ReportIgnoredParam("counts_file", "no range is specified for searching");
   }
 
   if (CLI::HasParam("input_model") &&
@@ -232,14 +247,25 @@ static void mlpackMain()
       Log::Warn << PRINT_PARAM_STRING("single_mode") << " ignored because "
           << PRINT_PARAM_STRING("naive") << " is present." << endl;
 
-    // Now run the search.
-    vector<vector<size_t>> neighbors;
-    vector<vector<double>> distances;
-
-    if (CLI::HasParam("query"))
-      rs->Search(std::move(queryData), r, neighbors, distances);
+    // Now run the search.  If neither the neighbors nor the distances are
+    // needed, only count them.  Otherwise the results are stored in CSR
+    // layout, with the results of query point i at positions offsets[i] to
+    // offsets[i + 1] - 1 of neighbors and distances.
+    const bool countOnly = !CLI::HasParam("neighbors_file") &&
+        !CLI::HasParam("distances_file");
+    arma::Col<size_t> counts;
+    arma::Col<size_t> offsets;
+    arma::Col<size_t> neighbors;
+    arma::vec distances;
+
+    if (countOnly && CLI::HasParam("query"))
+      rs->Count(std::move(queryData), r, counts);
+    else if (countOnly)
+      rs->Count(r, counts);
+    else if (CLI::HasParam("query"))
+      rs->Search(std::move(queryData), r, offsets, neighbors, distances);
     else
-      rs->Search(r, neighbors, distances);
+      rs->Search(r, offsets, neighbors, distances);
 
     Log::Info << "Search complete." << endl;
 
@@ -256,15 +282,15 @@ static void mlpackMain()
       else
       {
         // Loop over each point.
-        for (size_t i = 0; i < distances.size(); ++i)
+        for (size_t i = 0; i + 1 < offsets.n_elem; ++i)
         {
           // Store the distances of each point.  We may have 0 points to store,
           // so we must account for that possibility.
-          for (size_t j = 0; j + 1 < distances[i].size(); ++j)
-            distancesStr << distances[i][j] << ", ";
+          for (size_t j = offsets[i]; j + 1 < offsets[i + 1]; ++j)
+            distancesStr << distances[j] << ", ";
 
-          if (distances[i].size() > 0)
-            distancesStr << distances[i][distances[i].size() - 1];
+          if (offsets[i + 1] > offsets[i])
+            distancesStr << distances[offsets[i + 1] - 1];
 
           distancesStr << endl;
         }
@@ -285,15 +311,15 @@ static void mlpackMain()
       else
       {
         // Loop over each point.
-        for (size_t i = 0; i < neighbors.size(); ++i)
+        for (size_t i = 0; i + 1 < offsets.n_elem; ++i)
         {
           // Store the neighbors of each point.  We may have 0 points to store,
           // so we must account for that possibility.
-          for (size_t j = 0; j + 1 < neighbors[i].size(); ++j)
-            neighborsStr << neighbors[i][j] << ", ";
+          for (size_t j = offsets[i]; j + 1 < offsets[i + 1]; ++j)
+            neighborsStr << neighbors[j] << ", ";
 
-          if (neighbors[i].size() > 0)
-            neighborsStr << neighbors[i][neighbors[i].size() - 1];
+          if (offsets[i + 1] > offsets[i])
+            neighborsStr << neighbors[offsets[i + 1] - 1];
 
           neighborsStr << endl;
         }
@@ -301,6 +327,27 @@ static void mlpackMain()
         neighborsStr.close();
       }
     }
+
+    if (CLI::HasParam("counts_file"))
+    {
+      if (!countOnly)
+        counts = arma::diff(offsets);
+
+      const string countsFile = CLI::GetParam<string>("counts_file");
+      fstream countsStr(countsFile.c_str(), fstream::out);
+      if (!countsStr.is_open())
+      {
+        Log::Warn << "Cannot open file '" << countsFile << "' to save output"
+            << " counts to!" << endl;
+      }
+      else
+      {
+        for (size_t i = 0; i < counts.n_elem; ++i)
+          countsStr << counts[i] << endl;
+
+        countsStr.close();
+      }
+    }
   }
 
   // Save the output model.
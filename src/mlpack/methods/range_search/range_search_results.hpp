@@ -0,0 +1,229 @@
+/**
+ * @file range_search_results.hpp
+ *
+ * Classes that store the results found by RangeSearchRules: nested vectors of
+ * neighbors and distances, thread-local buffers that are assembled into a
+ * compressed sparse row (CSR) layout, or only the number of results of each
+ * query point.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * NestedRangeResults stores the results in one vector of neighbors and one
+ * vector of distances for each query point, as returned by the
+ * RangeSearch::Search() overloads that take nested vectors.  Copies of the
+ * object share the vectors, so the rules of different threads must handle
+ * disjoint query points.
+ */
+class NestedRangeResults
+{
+ public:
+  //! The distances of the results are stored, so they must be computed.
+  static const bool StoresDistances = true;
+
+  /**
+   * Store the results in the given vectors, which must already hold one
+   * element for each query point.
+   */
+  NestedRangeResults(std::vector<std::vector<size_t>>& neighbors,
+                     std::vector<std::vector<double>>& distances) :
+      neighbors(&neighbors),
+      distances(&distances)
+  { /* Nothing to do. */ }
+
+  //! Prepare to add up to the given number of results for a query point.
+  void Reserve(const size_t queryIndex, const size_t numResults)
+  {
+    const size_t oldSize = (*neighbors)[queryIndex].size();
+    (*neighbors)[queryIndex].reserve(oldSize + numResults);
+    (*distances)[queryIndex].reserve(oldSize + numResults);
+  }
+
+  //! Add a result for the given query point.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    (*neighbors)[queryIndex].push_back(referenceIndex);
+    (*distances)[queryIndex].push_back(distance);
+  }
+
+ private:
+  //! The neighbors of each query point.
+  std::vector<std::vector<size_t>>* neighbors;
+  //! The distances of each query point.
+  std::vector<std::vector<double>>* distances;
+};
+
+/**
+ * CSRRangeResults stores the results in flat buffers of (query, neighbor,
+ * distance) triples.  Each copy of the object (that is, each thread) has its
+ * own buffers, so no two threads ever write to the same memory and no memory
+ * is allocated per query point.  Once the search is done, Assemble() gathers
+ * the buffers of all threads in compressed sparse row (CSR) layout.
+ */
+class CSRRangeResults
+{
+ public:
+  //! The distances of the results are stored, so they must be computed.
+  static const bool StoresDistances = true;
+
+  //! The buffers grow geometrically, so there is nothing to reserve.
+  void Reserve(const size_t /* queryIndex */, const size_t /* numResults */)
+  { }
+
+  //! Add a result for the given query point.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    queries.push_back(queryIndex);
+    neighbors.push_back(referenceIndex);
+    distances.push_back(distance);
+  }
+
+  /**
+   * Gather the results of all the given buffers in CSR layout: the neighbors
+   * of query point i are neighbors[offsets[i]] to neighbors[offsets[i + 1] -
+   * 1], and their distances are at the same positions of distances.  The
+   * buffers are emptied while they are gathered.
+   *
+   * @param results Buffers of results to gather.
+   * @param numQueries Number of query points.
+   * @param queryMapping Original index of each query point of the results, or
+   *     NULL if the indices don't need to be mapped.
+   * @param referenceMapping Original index of each reference point of the
+   *     results, or NULL if the indices don't need to be mapped.
+   * @param offsets Filled with the offset of the results of each query point,
+   *     followed by the total number of results.
+   * @param neighbors Filled with the indices of the results.
+   * @param distances Filled with the distances of the results.
+   */
+  static void Assemble(std::vector<CSRRangeResults>& results,
+                       const size_t numQueries,
+                       const std::vector<size_t>* queryMapping,
+                       const std::vector<size_t>* referenceMapping,
+                       arma::Col<size_t>& offsets,
+                       arma::Col<size_t>& neighbors,
+                       arma::vec& distances)
+  {
+    // Count the results of each query point, then turn the counts into
+    // offsets.
+    offsets.zeros(numQueries + 1);
+    for (size_t t = 0; t < results.size(); ++t)
+    {
+      for (size_t i = 0; i < results[t].queries.size(); ++i)
+      {
+        const size_t query = results[t].queries[i];
+        ++offsets[(queryMapping ? (*queryMapping)[query] : query) + 1];
+      }
+    }
+
+    for (size_t i = 0; i < numQueries; ++i)
+      offsets[i + 1] += offsets[i];
+
+    neighbors.set_size(offsets[numQueries]);
+    distances.set_size(offsets[numQueries]);
+
+    // Place every result at the next free position of its query point.
+    arma::Col<size_t> next = offsets.head(numQueries);
+    for (size_t t = 0; t < results.size(); ++t)
+    {
+      for (size_t i = 0; i < results[t].queries.size(); ++i)
+      {
+        const size_t query = results[t].queries[i];
+        const size_t reference = results[t].neighbors[i];
+        const size_t position =
+            next[queryMapping ? (*queryMapping)[query] : query]++;
+
+        neighbors[position] = referenceMapping ?
+            (*referenceMapping)[reference] : reference;
+        distances[position] = results[t].distances[i];
+      }
+
+      // Release the memory of the buffers as soon as possible.
+      std::vector<size_t>().swap(results[t].queries);
+      std::vector<size_t>().swap(results[t].neighbors);
+      std::vector<double>().swap(results[t].distances);
+    }
+  }
+
+ private:
+  //! The query point of each result.
+  std::vector<size_t> queries;
+  //! The neighbor of each result.
+  std::vector<size_t> neighbors;
+  //! The distance of each result.
+  std::vector<double> distances;
+};
+
+/**
+ * CountRangeResults only stores the number of results of each query point.
+ * Since no distance is stored, the distances to the points of reference nodes
+ * that lie entirely in the range are never computed.  Each copy of the object
+ * has its own counts, which are summed by Assemble().
+ */
+class CountRangeResults
+{
+ public:
+  //! Distances are not stored, so they don't need to be computed.
+  static const bool StoresDistances = false;
+
+  //! Create the counts for the given number of query points.
+  CountRangeResults(const size_t numQueries) : counts(numQueries, 0)
+  { /* Nothing to do. */ }
+
+  //! Nothing to reserve when only counting.
+  void Reserve(const size_t /* queryIndex */, const size_t /* numResults */)
+  { }
+
+  //! Count a result for the given query point.
+  void Add(const size_t queryIndex,
+           const size_t /* referenceIndex */,
+           const double /* distance */)
+  {
+    ++counts[queryIndex];
+  }
+
+  /**
+   * Sum the counts of all the given objects.
+   *
+   * @param results Counts to sum.
+   * @param numQueries Number of query points.
+   * @param queryMapping Original index of each query point of the results, or
+   *     NULL if the indices don't need to be mapped.
+   * @param counts Filled with the number of results of each query point.
+   */
+  static void Assemble(const std::vector<CountRangeResults>& results,
+                       const size_t numQueries,
+                       const std::vector<size_t>* queryMapping,
+                       arma::Col<size_t>& counts)
+  {
+    counts.zeros(numQueries);
+    for (size_t t = 0; t < results.size(); ++t)
+    {
+      for (size_t i = 0; i < results[t].counts.size(); ++i)
+        counts[queryMapping ? (*queryMapping)[i] : i] += results[t].counts[i];
+    }
+  }
+
+ private:
+  //! The number of results of each query point.
+  std::vector<size_t> counts;
+};
+
+} // namespace range
+} // namespace mlpack
+
+#endif
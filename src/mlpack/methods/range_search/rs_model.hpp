@@ -116,6 +116,171 @@ class BiSearchVisitor : public boost::static_visitor<void>
                   const size_t leafSize);
 };
 
+/**
+ * RangeCSROutput holds the output of a range search in compressed sparse row
+ * (CSR) layout; see RangeSearch<>::Search().  It is used with
+ * MonoOutputSearchVisitor and BiOutputSearchVisitor.
+ */
+class RangeCSROutput
+{
+ public:
+  //! Store the output in the given objects.
+  RangeCSROutput(arma::Col<size_t>& offsets,
+                 arma::Col<size_t>& neighbors,
+                 arma::vec& distances) :
+      offsets(offsets),
+      neighbors(neighbors),
+      distances(distances)
+  { }
+
+  //! Search with the given query set.
+  template<typename RSType>
+  void Search(RSType& rs,
+              const arma::mat& querySet,
+              const math::Range& range);
+
+  //! Search with the given query tree.
+  template<typename RSType>
+  void Search(RSType& rs,
+              typename RSType::Tree* queryTree,
+              const math::Range& range);
+
+  //! Search with the reference set.
+  template<typename RSType>
+  void Search(RSType& rs, const math::Range& range);
+
+  //! Put the results of the points of a query tree back in the original order
+  //! of the query points.
+  void MapQueries(const std::vector<size_t>& oldFromNew);
+
+ private:
+  //! The offset of the results of each query point.
+  arma::Col<size_t>& offsets;
+  //! The indices of the results.
+  arma::Col<size_t>& neighbors;
+  //! The distances of the results.
+  arma::vec& distances;
+};
+
+/**
+ * RangeCountOutput holds the number of results of each query point of a range
+ * search; see RangeSearch<>::Count().  It is used with MonoOutputSearchVisitor
+ * and BiOutputSearchVisitor.
+ */
+class RangeCountOutput
+{
+ public:
+  //! Store the output in the given object.
+  RangeCountOutput(arma::Col<size_t>& counts) : counts(counts) { }
+
+  //! Search with the given query set.
+  template<typename RSType>
+  void Search(RSType& rs,
+              const arma::mat& querySet,
+              const math::Range& range);
+
+  //! Search with the given query tree.
+  template<typename RSType>
+  void Search(RSType& rs,
+              typename RSType::Tree* queryTree,
+              const math::Range& range);
+
+  //! Search with the reference set.
+  template<typename RSType>
+  void Search(RSType& rs, const math::Range& range);
+
+  //! Put the counts of the points of a query tree back in the original order
+  //! of the query points.
+  void MapQueries(const std::vector<size_t>& oldFromNew);
+
+ private:
+  //! The number of results of each query point.
+  arma::Col<size_t>& counts;
+};
+
+/**
+ * MonoOutputSearchVisitor executes a monochromatic range search on the given
+ * RSType, storing the results in the given output object (RangeCSROutput or
+ * RangeCountOutput).
+ */
+template<typename OutputType>
+class MonoOutputSearchVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The range to search for.
+  const math::Range& range;
+  //! The output of the search.
+  OutputType& output;
+
+ public:
+  //! Perform monochromatic search with the given RangeSearch object.
+  template<typename RSType>
+  void operator()(RSType* rs) const;
+
+  //! Construct the MonoOutputSearchVisitor with the given parameters.
+  MonoOutputSearchVisitor(const math::Range& range, OutputType& output) :
+      range(range),
+      output(output)
+  { }
+};
+
+/**
+ * BiOutputSearchVisitor executes a bichromatic range search on the given
+ * RSType, storing the results in the given output object (RangeCSROutput or
+ * RangeCountOutput).  Like BiSearchVisitor, a query tree with the proper
+ * leafSize is built for the tree types that accept it.
+ */
+template<typename OutputType>
+class BiOutputSearchVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The query set for the bichromatic search.
+  const arma::mat& querySet;
+  //! Range to search neighbours for.
+  const math::Range& range;
+  //! The output of the search.
+  OutputType& output;
+  //! The number of points in a leaf (for BinarySpaceTrees).
+  const size_t leafSize;
+
+  //! Bichromatic range search on the given RSType considering the leafSize.
+  template<typename RSType>
+  void SearchLeaf(RSType* rs) const;
+
+ public:
+  //! Alias template necessary for visual c++ compiler.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  using RSTypeT = RSType<TreeType>;
+
+  //! Default Bichromatic range search on the given RSType instance.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  void operator()(RSTypeT<TreeType>* rs) const;
+
+  //! Bichromatic range search on the given RSType specialized for KDTrees.
+  void operator()(RSTypeT<tree::KDTree>* rs) const;
+
+  //! Bichromatic range search on the given RSType specialized for BallTrees.
+  void operator()(RSTypeT<tree::BallTree>* rs) const;
+
+  //! Bichromatic range search specialized for octrees.
+  void operator()(RSTypeT<tree::Octree>* rs) const;
+
+  //! Construct the BiOutputSearchVisitor.
+  BiOutputSearchVisitor(const arma::mat& querySet,
+                        const math::Range& range,
+                        OutputType& output,
+                        const size_t leafSize) :
+      querySet(querySet),
+      range(range),
+      output(output),
+      leafSize(leafSize)
+  { }
+};
+
 /**
  * TrainVisitor sets the reference set to a new reference set on the given
  * RSType. We use template specialization to differentiate those tree types that
@@ -171,6 +336,17 @@ class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
   const arma::mat& operator()(RSType* rs) const;
 };
 
+/**
+ * InitializedVisitor returns whether the given RSType instance exists.
+ */
+class InitializedVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Return whether the RSType object exists.
+  template<typename RSType>
+  bool operator()(RSType* rs) const;
+};
+
 /**
  * DeleteVisitor deletes the given RSType instance.
  */
@@ -300,7 +476,7 @@ class RSModel
 
   //! Serialize the range search model.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
   //! Expose the dataset.
   const arma::mat& Dataset() const;
@@ -373,6 +549,61 @@ class RSModel
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Perform range search, returning the results in compressed sparse row
+   * layout.  This takes possession of the query set, so the query set will not
+   * be usable after the search.  For more information on the output format,
+   * see RangeSearch<>::Search().
+   *
+   * @param querySet Set of query points.
+   * @param range Range to search for.
+   * @param offsets Output: offset of the results of each query point.
+   * @param neighbors Output: neighbors falling within the desired range.
+   * @param distances Output: distances of neighbors.
+   */
+  void Search(arma::mat&& querySet,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Perform monochromatic range search, with the reference set as the query
+   * set, returning the results in compressed sparse row layout.  For more
+   * information on the output format, see RangeSearch<>::Search().
+   *
+   * @param range Range to search for.
+   * @param offsets Output: offset of the results of each query point.
+   * @param neighbors Output: neighbors falling within the desired range.
+   * @param distances Output: distances of neighbors.
+   */
+  void Search(const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Count the reference points in the range of each query point, without
+   * storing them.  This takes possession of the query set, so the query set
+   * will not be usable after the search.
+   *
+   * @param querySet Set of query points.
+   * @param range Range to search for.
+   * @param counts Output: number of neighbors of each query point.
+   */
+  void Count(arma::mat&& querySet,
+             const math::Range& range,
+             arma::Col<size_t>& counts);
+
+  /**
+   * Count the points in the range of each point of the reference set, without
+   * storing them.
+   *
+   * @param range Range to search for.
+   * @param counts Output: number of neighbors of each point.
+   */
+  void Count(const math::Range& range, arma::Col<size_t>& counts);
+
  private:
   /**
    * Return a string representing the name of the tree.  This is used for
@@ -380,15 +611,104 @@ class RSModel
    */
   std::string TreeName() const;
 
+  //! Log the kind of search that is about to be done.
+  void LogSearch(const math::Range& range) const;
+
   /**
    * Clean up memory.
    */
   void CleanMemory();
 };
 
+/**
+ * RSModelHeader holds the parameters of a saved RSModel: the tree type, the
+ * leaf size, whether a random basis is used, and the size of the reference set.
+ * These are stored at the beginning of the RSModel archive, so an RSModelHeader
+ * is loaded by reading only the beginning of a model file, and the trees and
+ * the reference set are never deserialized.  This makes it cheap to list or
+ * validate saved models; see data::LazyModel.
+ *
+ * Only binary and text archives can be read partially; an XML archive has to
+ * be read completely.  The leaf size and the size of the reference set are
+ * only known for models saved since version 1 of RSModel (otherwise they are 0,
+ * except for the dimensionality of models with a random basis).
+ */
+class RSModelHeader
+{
+ public:
+  //! Create an empty header.
+  RSModelHeader() :
+      treeType(RSModel::KD_TREE),
+      leafSize(0),
+      randomBasis(false),
+      dimensionality(0),
+      referenceSize(0)
+  { }
+
+  //! Get the header of the given (trained) model.
+  RSModelHeader(const RSModel& model) :
+      treeType(model.TreeType()),
+      leafSize(model.LeafSize()),
+      randomBasis(model.RandomBasis()),
+      dimensionality(model.Dataset().n_rows),
+      referenceSize(model.Dataset().n_cols)
+  { }
+
+  //! Get the tree type.
+  RSModel::TreeTypes TreeType() const { return treeType; }
+  //! Get the leaf size.
+  size_t LeafSize() const { return leafSize; }
+  //! Get whether the points are projected onto a random basis.
+  bool RandomBasis() const { return randomBasis; }
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get the number of reference points.
+  size_t ReferenceSize() const { return referenceSize; }
+
+  /**
+   * Load the header from the beginning of a RSModel archive; this may only be
+   * used for loading.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version)
+  {
+    ar & BOOST_SERIALIZATION_NVP(treeType);
+    ar & BOOST_SERIALIZATION_NVP(randomBasis);
+
+    arma::mat q;
+    ar & BOOST_SERIALIZATION_NVP(q);
+
+    if (version > 0)
+    {
+      ar & BOOST_SERIALIZATION_NVP(leafSize);
+      ar & BOOST_SERIALIZATION_NVP(dimensionality);
+      ar & BOOST_SERIALIZATION_NVP(referenceSize);
+    }
+    else if (randomBasis)
+    {
+      dimensionality = q.n_rows;
+    }
+  }
+
+ private:
+  //! The tree type.
+  RSModel::TreeTypes treeType;
+  //! The leaf size.
+  size_t leafSize;
+  //! Whether the points are projected onto a random basis.
+  bool randomBasis;
+  //! The dimensionality of the reference set.
+  size_t dimensionality;
+  //! The number of reference points.
+  size_t referenceSize;
+};
+
 } // namespace range
 } // namespace mlpack
 
+//! Set the serialization version of the RSModel class.
+BOOST_CLASS_VERSION(mlpack::range::RSModel, 1);
+
 // Include implementation (of serialize() and inline functions).
 #include "rs_model_impl.hpp"
 
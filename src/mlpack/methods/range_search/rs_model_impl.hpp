@@ -184,15 +184,7 @@ inline void RSModel::Search(arma::mat&& querySet,
   if (randomBasis)
     querySet = q * querySet;
 
-  Log::Info << "Search for points in the range [" << range.Lo() << ", "
-      << range.Hi() << "] with ";
-  if (!Naive() && !SingleMode())
-    Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
-  else if (!Naive())
-    Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
-  else
-    Log::Info << "brute-force (naive) search..." << std::endl;
-
+  LogSearch(range);
 
   BiSearchVisitor search(querySet, range, neighbors, distances,
       leafSize);
@@ -203,6 +195,74 @@ inline void RSModel::Search(arma::mat&& querySet,
 inline void RSModel::Search(const math::Range& range,
                             std::vector<std::vector<size_t>>& neighbors,
                             std::vector<std::vector<double>>& distances)
+{
+  LogSearch(range);
+
+  MonoSearchVisitor search(range, neighbors, distances);
+  boost::apply_visitor(search, rSearch);
+}
+
+// Perform range search with output in CSR layout.
+inline void RSModel::Search(arma::mat&& querySet,
+                            const math::Range& range,
+                            arma::Col<size_t>& offsets,
+                            arma::Col<size_t>& neighbors,
+                            arma::vec& distances)
+{
+  // We may need to map the query set randomly.
+  if (randomBasis)
+    querySet = q * querySet;
+
+  LogSearch(range);
+
+  RangeCSROutput output(offsets, neighbors, distances);
+  BiOutputSearchVisitor<RangeCSROutput> search(querySet, range, output,
+      leafSize);
+  boost::apply_visitor(search, rSearch);
+}
+
+// Perform range search with output in CSR layout (monochromatic case).
+inline void RSModel::Search(const math::Range& range,
+                            arma::Col<size_t>& offsets,
+                            arma::Col<size_t>& neighbors,
+                            arma::vec& distances)
+{
+  LogSearch(range);
+
+  RangeCSROutput output(offsets, neighbors, distances);
+  MonoOutputSearchVisitor<RangeCSROutput> search(range, output);
+  boost::apply_visitor(search, rSearch);
+}
+
+// Count the points in range.
+inline void RSModel::Count(arma::mat&& querySet,
+                           const math::Range& range,
+                           arma::Col<size_t>& counts)
+{
+  // We may need to map the query set randomly.
+  if (randomBasis)
+    querySet = q * querySet;
+
+  LogSearch(range);
+
+  RangeCountOutput output(counts);
+  BiOutputSearchVisitor<RangeCountOutput> search(querySet, range, output,
+      leafSize);
+  boost::apply_visitor(search, rSearch);
+}
+
+// Count the points in range (monochromatic case).
+inline void RSModel::Count(const math::Range& range, arma::Col<size_t>& counts)
+{
+  LogSearch(range);
+
+  RangeCountOutput output(counts);
+  MonoOutputSearchVisitor<RangeCountOutput> search(range, output);
+  boost::apply_visitor(search, rSearch);
+}
+
+// Log the kind of search.
+inline void RSModel::LogSearch(const math::Range& range) const
 {
   Log::Info << "Search for points in the range [" << range.Lo() << ", "
       << range.Hi() << "] with ";
@@ -212,9 +272,6 @@ inline void RSModel::Search(const math::Range& range,
     Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
   else
     Log::Info << "brute-force (naive) search..." << std::endl;
-
-  MonoSearchVisitor search(range, neighbors, distances);
-  boost::apply_visitor(search, rSearch);
 }
 
 // Get the name of the tree type.
@@ -350,6 +407,171 @@ void BiSearchVisitor::SearchLeaf(RSType* rs) const
     rs->Search(querySet, range, neighbors, distances);
 }
 
+//! Search with the given query set, storing the results in CSR layout.
+template<typename RSType>
+void RangeCSROutput::Search(RSType& rs,
+                            const arma::mat& querySet,
+                            const math::Range& range)
+{
+  rs.Search(querySet, range, offsets, neighbors, distances);
+}
+
+//! Search with the given query tree, storing the results in CSR layout.
+template<typename RSType>
+void RangeCSROutput::Search(RSType& rs,
+                            typename RSType::Tree* queryTree,
+                            const math::Range& range)
+{
+  rs.Search(queryTree, range, offsets, neighbors, distances);
+}
+
+//! Search with the reference set, storing the results in CSR layout.
+template<typename RSType>
+void RangeCSROutput::Search(RSType& rs, const math::Range& range)
+{
+  rs.Search(range, offsets, neighbors, distances);
+}
+
+//! Reorder the rows of the results to the original order of the query points.
+inline void RangeCSROutput::MapQueries(const std::vector<size_t>& oldFromNew)
+{
+  const size_t numQueries = offsets.n_elem - 1;
+  arma::Col<size_t> newOffsets(numQueries + 1);
+  newOffsets[0] = 0;
+  for (size_t i = 0; i < numQueries; ++i)
+    newOffsets[oldFromNew[i] + 1] = offsets[i + 1] - offsets[i];
+  for (size_t i = 0; i < numQueries; ++i)
+    newOffsets[i + 1] += newOffsets[i];
+
+  arma::Col<size_t> newNeighbors(neighbors.n_elem);
+  arma::vec newDistances(distances.n_elem);
+  for (size_t i = 0; i < numQueries; ++i)
+  {
+    const size_t count = offsets[i + 1] - offsets[i];
+    const size_t newOffset = newOffsets[oldFromNew[i]];
+    for (size_t j = 0; j < count; ++j)
+    {
+      newNeighbors[newOffset + j] = neighbors[offsets[i] + j];
+      newDistances[newOffset + j] = distances[offsets[i] + j];
+    }
+  }
+
+  offsets = std::move(newOffsets);
+  neighbors = std::move(newNeighbors);
+  distances = std::move(newDistances);
+}
+
+//! Count the results of the given query set.
+template<typename RSType>
+void RangeCountOutput::Search(RSType& rs,
+                              const arma::mat& querySet,
+                              const math::Range& range)
+{
+  rs.Count(querySet, range, counts);
+}
+
+//! Count the results of the given query tree.
+template<typename RSType>
+void RangeCountOutput::Search(RSType& rs,
+                              typename RSType::Tree* queryTree,
+                              const math::Range& range)
+{
+  rs.Count(queryTree, range, counts);
+}
+
+//! Count the results of the reference set.
+template<typename RSType>
+void RangeCountOutput::Search(RSType& rs, const math::Range& range)
+{
+  rs.Count(range, counts);
+}
+
+//! Reorder the counts to the original order of the query points.
+inline void RangeCountOutput::MapQueries(const std::vector<size_t>& oldFromNew)
+{
+  arma::Col<size_t> newCounts(counts.n_elem);
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    newCounts[oldFromNew[i]] = counts[i];
+  counts = std::move(newCounts);
+}
+
+//! Monochromatic range search on the given RSType instance.
+template<typename OutputType>
+template<typename RSType>
+void MonoOutputSearchVisitor<OutputType>::operator()(RSType* rs) const
+{
+  if (rs)
+    return output.Search(*rs, range);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Default Bichromatic range search on the given RSType instance.
+template<typename OutputType>
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void BiOutputSearchVisitor<OutputType>::operator()(RSTypeT<TreeType>* rs) const
+{
+  if (rs)
+    return output.Search(*rs, querySet, range);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Bichromatic range search on the given RSType specialized for KDTrees.
+template<typename OutputType>
+void BiOutputSearchVisitor<OutputType>::operator()(RSTypeT<tree::KDTree>* rs)
+    const
+{
+  if (rs)
+    return SearchLeaf(rs);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Bichromatic range search on the given RSType specialized for BallTrees.
+template<typename OutputType>
+void BiOutputSearchVisitor<OutputType>::operator()(RSTypeT<tree::BallTree>* rs)
+    const
+{
+  if (rs)
+    return SearchLeaf(rs);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Bichromatic range search specialized for Ocrees.
+template<typename OutputType>
+void BiOutputSearchVisitor<OutputType>::operator()(RSTypeT<tree::Octree>* rs)
+    const
+{
+  if (rs)
+    return SearchLeaf(rs);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Bichromatic range search on the given RSType considering the leafSize.
+template<typename OutputType>
+template<typename RSType>
+void BiOutputSearchVisitor<OutputType>::SearchLeaf(RSType* rs) const
+{
+  if (!rs->Naive() && !rs->SingleMode())
+  {
+    // Build a second tree and search.
+    Timer::Start("tree_building");
+    Log::Info << "Building query tree..." << std::endl;
+    std::vector<size_t> oldFromNewQueries;
+    typename RSType::Tree queryTree(std::move(querySet), oldFromNewQueries,
+        leafSize);
+    Log::Info << "Tree built." << std::endl;
+    Timer::Stop("tree_building");
+
+    output.Search(*rs, &queryTree, range);
+
+    // Remap the query points.
+    output.MapQueries(oldFromNewQueries);
+  }
+  else
+    output.Search(*rs, querySet, range);
+}
+
 //! Save parameters for Train.
 TrainVisitor::TrainVisitor(arma::mat&& referenceSet,
                            const size_t leafSize) :
@@ -421,6 +643,13 @@ const arma::mat& ReferenceSetVisitor::operator()(RSType* rs) const
   throw std::runtime_error("no range search model initialized");
 }
 
+//! Return whether the model exists.
+template<typename RSType>
+bool InitializedVisitor::operator()(RSType* rs) const
+{
+  return (rs != NULL);
+}
+
 //! For cleaning memory
 template<typename RSType>
 void DeleteVisitor::operator()(RSType* rs) const
@@ -449,12 +678,31 @@ bool& NaiveVisitor::operator()(RSType* rs) const
 
 // Serialize the model.
 template<typename Archive>
-void RSModel::serialize(Archive& ar, const unsigned int /* version */)
+void RSModel::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(treeType);
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
   ar & BOOST_SERIALIZATION_NVP(q);
 
+  // Since version 1, the leaf size and the size of the reference set are
+  // stored before the search object, so that RSModelHeader can be read without
+  // the trees.
+  if (version > 0)
+  {
+    size_t dimensionality = 0;
+    size_t referenceSize = 0;
+    if (Archive::is_saving::value &&
+        boost::apply_visitor(InitializedVisitor(), rSearch))
+    {
+      dimensionality = Dataset().n_rows;
+      referenceSize = Dataset().n_cols;
+    }
+
+    ar & BOOST_SERIALIZATION_NVP(leafSize);
+    ar & BOOST_SERIALIZATION_NVP(dimensionality);
+    ar & BOOST_SERIALIZATION_NVP(referenceSize);
+  }
+
   // This should never happen, but just in case...
   if (Archive::is_loading::value)
     boost::apply_visitor(DeleteVisitor(), rSearch);
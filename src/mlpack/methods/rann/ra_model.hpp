@@ -236,6 +236,17 @@ class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
   const arma::mat& operator()(RAType* ra) const;
 };
 
+/**
+ * InitializedVisitor returns whether the given RAType instance exists.
+ */
+class InitializedVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Return whether the RAType object exists.
+  template<typename RAType>
+  bool operator()(RAType* ra) const;
+};
+
 /**
  * DeleteVisitor deletes the give RAType Instance.
  */
@@ -352,7 +363,7 @@ class RAModel
 
   //! Serialize the model.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
   //! Expose the dataset.
   const arma::mat& Dataset() const;
@@ -433,9 +444,98 @@ class RAModel
   std::string TreeName() const;
 };
 
+/**
+ * RAModelHeader holds the parameters of a saved RAModel: the tree type, the
+ * leaf size, whether a random basis is used, and the size of the reference set.
+ * These are stored at the beginning of the RAModel archive, so an RAModelHeader
+ * is loaded by reading only the beginning of a model file, and the trees and
+ * the reference set are never deserialized.  This makes it cheap to list or
+ * validate saved models; see data::LazyModel.
+ *
+ * Only binary and text archives can be read partially; an XML archive has to
+ * be read completely.  The leaf size and the size of the reference set are
+ * only known for models saved since version 1 of RAModel (otherwise they are 0,
+ * except for the dimensionality of models with a random basis).
+ * @tparam SortPolicy The sort policy of the model.
+ */
+template<typename SortPolicy>
+class RAModelHeader
+{
+ public:
+  //! Create an empty header.
+  RAModelHeader() :
+      treeType(RAModel<SortPolicy>::KD_TREE),
+      leafSize(0),
+      randomBasis(false),
+      dimensionality(0),
+      referenceSize(0)
+  { }
+
+  //! Get the header of the given (trained) model.
+  RAModelHeader(const RAModel<SortPolicy>& model) :
+      treeType(model.TreeType()),
+      leafSize(model.LeafSize()),
+      randomBasis(model.RandomBasis()),
+      dimensionality(model.Dataset().n_rows),
+      referenceSize(model.Dataset().n_cols)
+  { }
+
+  //! Get the tree type.
+  typename RAModel<SortPolicy>::TreeTypes TreeType() const { return treeType; }
+  //! Get the leaf size.
+  size_t LeafSize() const { return leafSize; }
+  //! Get whether the points are projected onto a random basis.
+  bool RandomBasis() const { return randomBasis; }
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get the number of reference points.
+  size_t ReferenceSize() const { return referenceSize; }
+
+  /**
+   * Load the header from the beginning of a RAModel archive; this may only be
+   * used for loading.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version)
+  {
+    ar & BOOST_SERIALIZATION_NVP(treeType);
+    ar & BOOST_SERIALIZATION_NVP(randomBasis);
+
+    arma::mat q;
+    ar & BOOST_SERIALIZATION_NVP(q);
+
+    if (version > 0)
+    {
+      ar & BOOST_SERIALIZATION_NVP(leafSize);
+      ar & BOOST_SERIALIZATION_NVP(dimensionality);
+      ar & BOOST_SERIALIZATION_NVP(referenceSize);
+    }
+    else if (randomBasis)
+    {
+      dimensionality = q.n_rows;
+    }
+  }
+
+ private:
+  //! The tree type.
+  typename RAModel<SortPolicy>::TreeTypes treeType;
+  //! The leaf size.
+  size_t leafSize;
+  //! Whether the points are projected onto a random basis.
+  bool randomBasis;
+  //! The dimensionality of the reference set.
+  size_t dimensionality;
+  //! The number of reference points.
+  size_t referenceSize;
+};
+
 } // namespace neighbor
 } // namespace mlpack
 
+//! Set the serialization version of the RAModel class.
+BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
+    mlpack::neighbor::RAModel<SortPolicy>, 1);
+
 #include "ra_model_impl.hpp"
 
 #endif
@@ -243,6 +243,13 @@ bool& NaiveVisitor::operator()(RAType* ra) const
   throw std::runtime_error("no rank-approximate search model is initialized");
 }
 
+//! Return whether the model exists.
+template<typename RAType>
+bool InitializedVisitor::operator()(RAType* ra) const
+{
+  return (ra != NULL);
+}
+
 //! For cleaning memory
 template<typename RSType>
 void DeleteVisitor::operator()(RSType* rs) const
@@ -334,12 +341,31 @@ RAModel<SortPolicy>::~RAModel()
 template<typename SortPolicy>
 template<typename Archive>
 void RAModel<SortPolicy>::serialize(Archive& ar,
-                                    const unsigned int /* version */)
+                                    const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(treeType);
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
   ar & BOOST_SERIALIZATION_NVP(q);
 
+  // Since version 1, the leaf size and the size of the reference set are
+  // stored before the search object, so that RAModelHeader can be read without
+  // the trees.
+  if (version > 0)
+  {
+    size_t dimensionality = 0;
+    size_t referenceSize = 0;
+    if (Archive::is_saving::value &&
+        boost::apply_visitor(InitializedVisitor(), raSearch))
+    {
+      dimensionality = Dataset().n_rows;
+      referenceSize = Dataset().n_cols;
+    }
+
+    ar & BOOST_SERIALIZATION_NVP(leafSize);
+    ar & BOOST_SERIALIZATION_NVP(dimensionality);
+    ar & BOOST_SERIALIZATION_NVP(referenceSize);
+  }
+
   // This should never happen, but just in case, be clean with memory.
   if (Archive::is_loading::value)
   {
@@ -16,6 +16,8 @@
 #include <mlpack/prereqs.hpp>
 
 #include "ra_search_rules.hpp"
+#include <mlpack/core/tree/instrumented_rules.hpp>
+#include <mlpack/core/tree/parallel_single_tree_traverser.hpp>
 
 namespace mlpack {
 namespace neighbor {
@@ -44,6 +46,36 @@ TreeType* BuildTree(
   return new TreeType(std::forward<MatType>(dataset));
 }
 
+/**
+ * Store the results of a parallel single-tree traversal in the given matrices,
+ * and return the number of distance computations made by all threads.
+ */
+template<typename ParallelTraverserType>
+size_t CollectResults(ParallelTraverserType& traverser,
+                      const size_t numQueries,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances)
+{
+  size_t numDistComputations = 0;
+  for (size_t i = 0; i < traverser.Rules().size(); ++i)
+    numDistComputations += traverser.Rules()[i].NumDistComputations();
+
+  if (traverser.Rules().size() == 1)
+  {
+    // Only one set of rules was used, so it holds every result.
+    traverser.Rules()[0].GetResults(neighbors, distances);
+    return numDistComputations;
+  }
+
+  // Otherwise, the results of each query point are held by the rules of the
+  // thread that traversed its block.
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Rules()[traverser.QueryOwner(i)].GetResults(neighbors, distances,
+        i);
+
+  return numDistComputations;
+}
+
 } // namespace aux
 
 // Construct the object.
@@ -359,11 +391,14 @@ Search(const MatType& querySet,
   neighborPtr->set_size(k, querySet.n_cols);
   distancePtr->set_size(k, querySet.n_cols);
 
-  typedef RASearchRules<SortPolicy, MetricType, Tree> RuleType;
+  typedef tree::TraversalRules<RASearchRules<SortPolicy, MetricType,
+      Tree>> RuleType;
 
   if (naive)
   {
-    RuleType rules(*referenceSet, querySet, k, metric, tau, alpha, naive,
+    // The samples that the rules would draw for each query point in naive mode
+    // are drawn below instead, so that it can be done in parallel.
+    RuleType rules(*referenceSet, querySet, k, metric, tau, alpha, false,
         sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
 
     // Find how many samples from the reference set we need and sample uniformly
@@ -374,11 +409,18 @@ Search(const MatType& querySet,
     math::ObtainDistinctSamples(0, referenceSet->n_cols, numSamples,
         distinctSamples);
 
-    // Run the base case on each combination of query point and sampled
-    // reference point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-        rules.BaseCase(i, (size_t) distinctSamples[j]);
+    // Each query point is compared with its own samples and then with the
+    // shared samples.  Every thread draws from its own random number stream,
+    // and the rules can be used for different query points at once.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      arma::uvec querySamples;
+      math::ObtainDistinctSamples(0, referenceSet->n_cols, numSamples,
+          querySamples);
+      rules.BaseCases(i, querySamples);
+      rules.BaseCases(i, distinctSamples);
+    }
 
     rules.GetResults(*neighborPtr, *distancePtr);
   }
@@ -393,20 +435,26 @@ Search(const MatType& querySet,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+      // Create the traverser.  Each thread traverses its own blocks of query
+      // points with its own copy of the rules.  The rules don't store anything
+      // in the reference tree, so this works with every tree type.
+      tree::ParallelSingleTreeTraverser<Tree, RuleType,
+          typename Tree::template SingleTreeTraverser<RuleType>>
+          traverser(rules);
+
+      traverser.Traverse(querySet.n_cols, *referenceTree);
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      const size_t numDistComputations = aux::CollectResults(traverser,
+          querySet.n_cols, *neighborPtr, *distancePtr);
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
-          << (rules.NumDistComputations() / querySet.n_cols) << "."
-          << std::endl;
+          << (numDistComputations / querySet.n_cols) << "." << std::endl;
+    }
+    else
+    {
+      rules.GetResults(*neighborPtr, *distancePtr);
     }
-
-    rules.GetResults(*neighborPtr, *distancePtr);
   }
   else // Dual-tree recursion.
   {
@@ -532,7 +580,8 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   distances.set_size(k, querySet.n_cols);
 
   // Create the helper object for the tree traversal.
-  typedef RASearchRules<SortPolicy, MetricType, Tree> RuleType;
+  typedef tree::TraversalRules<RASearchRules<SortPolicy, MetricType,
+      Tree>> RuleType;
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
       naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
 
@@ -588,7 +637,8 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   distancePtr->set_size(k, referenceSet->n_cols);
 
   // Create the helper object for the tree traversal.
-  typedef RASearchRules<SortPolicy, MetricType, Tree> RuleType;
+  typedef tree::TraversalRules<RASearchRules<SortPolicy, MetricType,
+      Tree>> RuleType;
   RuleType rules(*referenceSet, *referenceSet, k, metric, tau, alpha, naive,
       sampleAtLeaves, firstLeafExact, singleSampleLimit, true /* same sets */);
 
@@ -609,12 +659,15 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    // Create the traverser.  Each thread traverses its own blocks of query
+    // points with its own copy of the rules.
+    tree::ParallelSingleTreeTraverser<Tree, RuleType,
+        typename Tree::template SingleTreeTraverser<RuleType>> traverser(rules);
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    traverser.Traverse(referenceSet->n_cols, *referenceTree);
+
+    aux::CollectResults(traverser, referenceSet->n_cols, *neighborPtr,
+        *distancePtr);
   }
   else
   {
@@ -624,7 +677,8 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
     traverser.Traverse(*referenceTree, *referenceTree);
   }
 
-  rules.GetResults(*neighborPtr, *distancePtr);
+  if (!singleMode)
+    rules.GetResults(*neighborPtr, *distancePtr);
 
   Timer::Stop("computing_neighbors");
 
@@ -15,8 +15,8 @@
 #define MLPACK_METHODS_RANN_RA_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/methods/neighbor_search/candidate_list.hpp>
 
-#include <queue>
 
 namespace mlpack {
 namespace neighbor {
@@ -75,6 +75,19 @@ class RASearchRules
    */
   void GetResults(arma::Mat<size_t>& neighbors, arma::mat& distances);
 
+  /**
+   * Store the list of candidates of the given query point in the given
+   * matrices, which must already have the right size.
+   *
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param queryIndex Index of the query point.
+   */
+  void GetResults(arma::Mat<size_t>& neighbors,
+                  arma::mat& distances,
+                  const size_t queryIndex);
+
   /**
    * Get the distance from the query point to the reference point.
    * This will update the list of candidates with the new point if appropriate.
@@ -84,6 +97,19 @@ class RASearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Evaluate the base cases between the query point and each of the given
+   * reference points at once.  All the distances are computed first, in one
+   * pass over the reference points, and the candidates are updated
+   * afterwards; the result is the same as calling BaseCase() for each
+   * reference point.  Calls for different query points may be made from
+   * different threads at the same time.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndices Indices of the reference points.
+   */
+  void BaseCases(const size_t queryIndex, const arma::uvec& referenceIndices);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -227,7 +253,9 @@ class RASearchRules
                  const double oldScore);
 
 
+  //! Get the number of distance calculations performed.
   size_t NumDistComputations() { return numDistComputations; }
+  //! Get the total number of samples made for all query points.
   size_t NumEffectiveSamples()
   {
     if (numSamplesMade.n_elem == 0)
@@ -248,23 +276,9 @@ class RASearchRules
   //! The query set.
   const arma::mat& querySet;
 
-  //! Candidate represents a possible candidate neighbor (distance, index).
-  typedef std::pair<double, size_t> Candidate;
-
-  //! Compare two candidates based on the distance.
-  struct CandidateCmp {
-    bool operator()(const Candidate& c1, const Candidate& c2)
-    {
-      return !SortPolicy::IsBetter(c2.first, c1.first);
-    };
-  };
-
-  //! Use a priority queue to represent the list of candidate neighbors.
-  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-      CandidateList;
-
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Set of candidate neighbors for each point.  Each list starts with k
+  //! candidates (WorstDistance, size_t() - 1) and is updated by BaseCase().
+  CandidateList<SortPolicy> candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -309,6 +323,19 @@ class RASearchRules
                       const size_t neighbor,
                       const double distance);
 
+  /**
+   * Approximate the given reference node for the given query point by
+   * evaluating the base cases with the given number of distinct points
+   * sampled uniformly from the descendants of the node.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Reference node to sample from.
+   * @param numSamples Number of points to sample.
+   */
+  void SampleNode(const size_t queryIndex,
+                  TreeType& referenceNode,
+                  const size_t numSamples);
+
   /**
    * Perform actual scoring for single-tree case.
    */
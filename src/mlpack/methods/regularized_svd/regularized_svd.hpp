@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/dsgd/dsgd.hpp>
 #include <mlpack/methods/cf/cf.hpp>
 
 #include "regularized_svd_function.hpp"
@@ -63,6 +64,8 @@ class RegularizedSVD
    * training on the passed data. The constructor initiates an object of class
    * RegularizedSVDFunction for optimization. It uses the SGD optimizer by
    * default. The optimizer uses a template specialization of Optimize().
+   * If OptimizerType is optimization::DSGD, the epochs are run with DSGD
+   * instead, which uses all threads without conflicting updates.
    *
    * @param iterations Number of optimization iterations.
    * @param alpha Learning rate for the SGD optimizer.
@@ -85,7 +88,39 @@ class RegularizedSVD
              arma::mat& u,
              arma::mat& v);
 
+  /**
+   * Continue the optimization of existing user and item matrices on the given
+   * (new) ratings only, for the number of iterations (epochs over data) given
+   * in the constructor.  Users and items that are not in u and v yet are
+   * added with random initial values.
+   *
+   * @param data New rating data matrix.
+   * @param u Item matrix to update.
+   * @param v User matrix to update.
+   */
+  void Update(const arma::mat& data,
+              arma::mat& u,
+              arma::mat& v);
+
  private:
+  /**
+   * Run SGD for the given number of epochs.  This uses the specialization of
+   * StandardSGD for the function.
+   */
+  template<typename FunctionType>
+  void Optimize(FunctionType& function,
+                arma::mat& parameters,
+                const std::false_type /* useDSGD */) const;
+
+  /**
+   * Run DSGD for the given number of epochs, which processes blocks of
+   * ratings that share no users and no items in parallel.
+   */
+  template<typename FunctionType>
+  void Optimize(FunctionType& function,
+                arma::mat& parameters,
+                const std::true_type /* useDSGD */) const;
+
   //! Number of optimization iterations.
   size_t iterations;
   //! Learning rate for the SGD optimizer.
@@ -44,6 +44,23 @@ class RegularizedSVDFunction
                          const size_t rank,
                          const double lambda);
 
+  /**
+   * Constructor for RegularizedSVDFunction class, with the given number of
+   * users and items.  This is useful when data only holds some of the ratings,
+   * for instance when new ratings are folded into an existing model.
+   *
+   * @param data Dataset for which SVD is calculated.
+   * @param rank Rank used for matrix factorization.
+   * @param lambda Regularization parameter used for optimization.
+   * @param numUsers Number of users (larger than any user in data).
+   * @param numItems Number of items (larger than any item in data).
+   */
+  RegularizedSVDFunction(const MatType& data,
+                         const size_t rank,
+                         const double lambda,
+                         const size_t numUsers,
+                         const size_t numItems);
+
   /**
    * Shuffle the points in the dataset.  This may be used by optimizers.
    */
@@ -96,6 +113,27 @@ class RegularizedSVDFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Take an SGD step on the given training example.  Only the parameters of
+   * the user and the item of the example are changed, so steps on examples
+   * that share no user and no item may be taken at the same time; this is
+   * used by the DSGD optimizer.
+   *
+   * @param parameters Parameters(user/item matrices) of the decomposition.
+   * @param i Index of the training example.
+   * @param stepSize Step size of the update.
+   */
+  void StochasticUpdate(arma::mat& parameters,
+                        const size_t i,
+                        const double stepSize) const;
+
+  /**
+   * Finish an epoch of StochasticUpdate() calls.  There is nothing to do,
+   * since every update only touches the parameters of its example.
+   */
+  void FinishEpoch(arma::mat& /* parameters */,
+                   const double /* stepSize */) const { }
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
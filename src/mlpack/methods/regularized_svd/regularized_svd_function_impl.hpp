@@ -34,6 +34,29 @@ RegularizedSVDFunction<MatType>::RegularizedSVDFunction(const MatType& data,
   initialPoint.randu(rank, numUsers + numItems);
 }
 
+template <typename MatType>
+RegularizedSVDFunction<MatType>::RegularizedSVDFunction(const MatType& data,
+                                                        const size_t rank,
+                                                        const double lambda,
+                                                        const size_t numUsers,
+                                                        const size_t numItems) :
+    data(math::MakeAlias(const_cast<MatType&>(data), false)),
+    rank(rank),
+    lambda(lambda),
+    numUsers(numUsers),
+    numItems(numItems)
+{
+  if (data.n_cols > 0 && (max(data.row(0)) >= numUsers ||
+      max(data.row(1)) >= numItems))
+  {
+    throw std::invalid_argument("RegularizedSVDFunction: data holds users or "
+        "items beyond the given number of users and items!");
+  }
+
+  // Initialize the parameters.
+  initialPoint.randu(rank, numUsers + numItems);
+}
+
 template<typename MatType>
 void RegularizedSVDFunction<MatType>::Shuffle()
 {
@@ -150,6 +173,30 @@ void RegularizedSVDFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template <typename MatType>
+void RegularizedSVDFunction<MatType>::StochasticUpdate(
+    arma::mat& parameters,
+    const size_t i,
+    const double stepSize) const
+{
+  // Indices for accessing the the correct parameter columns.
+  const size_t user = data(0, i);
+  const size_t item = data(1, i) + numUsers;
+
+  // Prediction error for the example.
+  const double rating = data(2, i);
+  const double ratingError = rating - arma::dot(parameters.col(user),
+                                                parameters.col(item));
+
+  // This is the step of the SGD specialization below, except that the item
+  // step uses the user vector from before the update.
+  const arma::vec userVec = parameters.col(user);
+  parameters.col(user) -= stepSize * (lambda * userVec -
+                                      ratingError * parameters.col(item));
+  parameters.col(item) -= stepSize * (lambda * parameters.col(item) -
+                                      ratingError * userVec);
+}
+
 } // namespace svd
 } // namespace mlpack
 
@@ -35,18 +35,16 @@ void RegularizedSVD<OptimizerType>::Apply(const arma::mat& data,
 {
   // batchSize is 1 in our implementation of Regularized SVD.
   // batchSize other than 1 has not been supported yet.
-  const int batchSize = 1;
   Log::Warn << "The batch size for optimizing RegularizedSVD is 1."
       << std::endl;
 
   // Make the optimizer object using a RegularizedSVDFunction object.
   RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
-  mlpack::optimization::StandardSGD optimizer(alpha, batchSize,
-      iterations * data.n_cols);
 
   // Get optimized parameters.
   arma::mat parameters = rSVDFunc.GetInitialPoint();
-  optimizer.Optimize(rSVDFunc, parameters);
+  Optimize(rSVDFunc, parameters,
+      std::is_same<OptimizerType, optimization::DSGD>());
 
   // Constants for extracting user and item matrices.
   const size_t numUsers = max(data.row(0)) + 1;
@@ -57,6 +55,57 @@ void RegularizedSVD<OptimizerType>::Apply(const arma::mat& data,
   v = parameters.submat(0, 0, rank - 1, numUsers - 1);
 }
 
+template<typename OptimizerType>
+void RegularizedSVD<OptimizerType>::Update(const arma::mat& data,
+                                           arma::mat& u,
+                                           arma::mat& v)
+{
+  if (data.n_cols == 0)
+    return;
+
+  const size_t rank = v.n_rows;
+  const size_t numUsers = std::max((size_t) v.n_cols,
+      (size_t) max(data.row(0)) + 1);
+  const size_t numItems = std::max((size_t) u.n_rows,
+      (size_t) max(data.row(1)) + 1);
+
+  // The parameters of new users and items keep their random initial values.
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda, numUsers,
+      numItems);
+  arma::mat parameters = rSVDFunc.GetInitialPoint();
+  parameters.cols(0, v.n_cols - 1) = v;
+  parameters.cols(numUsers, numUsers + u.n_rows - 1) = u.t();
+
+  Optimize(rSVDFunc, parameters,
+      std::is_same<OptimizerType, optimization::DSGD>());
+
+  u = parameters.submat(0, numUsers, rank - 1, numUsers + numItems - 1).t();
+  v = parameters.submat(0, 0, rank - 1, numUsers - 1);
+}
+
+template<typename OptimizerType>
+template<typename FunctionType>
+void RegularizedSVD<OptimizerType>::Optimize(
+    FunctionType& function,
+    arma::mat& parameters,
+    const std::false_type /* useDSGD */) const
+{
+  mlpack::optimization::StandardSGD optimizer(alpha, 1,
+      iterations * function.NumFunctions());
+  optimizer.Optimize(function, parameters);
+}
+
+template<typename OptimizerType>
+template<typename FunctionType>
+void RegularizedSVD<OptimizerType>::Optimize(
+    FunctionType& function,
+    arma::mat& parameters,
+    const std::true_type /* useDSGD */) const
+{
+  mlpack::optimization::DSGD optimizer(alpha, iterations);
+  optimizer.Optimize(function, parameters);
+}
+
 } // namespace svd
 } // namespace mlpack
 
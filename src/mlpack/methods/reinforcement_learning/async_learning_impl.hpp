@@ -14,7 +14,6 @@
 #define MLPACK_METHODS_RL_ASYNC_LEARNING_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
-#include "queue"
 
 namespace mlpack {
 namespace rl {
@@ -68,11 +67,16 @@ void AsyncLearning<
   NetworkType learningNetwork = std::move(this->learningNetwork);
   if (learningNetwork.Parameters().is_empty())
     learningNetwork.ResetParameters();
-  NetworkType targetNetwork = learningNetwork;
   size_t totalSteps = 0;
   PolicyType policy = this->policy;
   bool stop = false;
 
+  // The target network is shared as its parameters and a version, which is
+  // increased whenever the parameters are updated; every worker predicts with
+  // its own snapshot, which it refreshes when the version changes.
+  arma::mat targetParameters = learningNetwork.Parameters();
+  size_t targetVersion = 0;
+
   // Set up worker pool, worker 0 will be deterministic for evaluation.
   std::vector<WorkerType> workers;
   for (size_t i = 0; i <= config.NumWorkers(); ++i)
@@ -80,10 +84,6 @@ void AsyncLearning<
     workers.push_back(WorkerType(updater, environment, config, !i));
     workers.back().Initialize(learningNetwork);
   }
-  // Set up task queue corresponding to worker pool.
-  std::queue<size_t> tasks;
-  for (size_t i = 0; i <= config.NumWorkers(); ++i)
-    tasks.push(i);
 
   /**
    * Compute the number of threads for the for-loop. In general, we should use
@@ -95,45 +95,47 @@ void AsyncLearning<
   numThreads++;
   Log::Debug << numThreads << " threads will be used in total." << std::endl;
 
-  #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
-      targetNetwork, totalSteps, policy)
+  /**
+   * Every thread steps its own workers in turn: thread i owns the workers i,
+   * i + numThreads, i + 2 numThreads, and so on.  No worker is ever stepped by
+   * two threads, so the workers don't have to be handed out under a lock, and
+   * the deterministic worker 0, whose episodes are measured, always runs on
+   * thread 0.  The workers apply their gradients to the shared learning
+   * network without a lock (Hogwild!).
+   */
+  #pragma omp parallel for shared(stop, workers, learningNetwork, \
+      targetParameters, targetVersion, totalSteps, policy)
   for (omp_size_t i = 0; i < numThreads; ++i)
   {
-    #pragma omp critical
-    {
-      #ifdef HAS_OPENMP
-        Log::Debug << "Thread " << omp_get_thread_num() <<
-            " started." << std::endl;
-      #endif
-    }
-    size_t task = std::numeric_limits<size_t>::max();
-    while (!stop)
-    {
-      // Assign task to current thread from queue.
-      #pragma omp critical
-      {
-        if (task != std::numeric_limits<size_t>::max())
-          tasks.push(task);
+    #ifdef HAS_OPENMP
+      MLPACK_LOG_DEBUG << "Thread " << omp_get_thread_num() << " started."
+          << std::endl;
+    #endif
 
-        if (!tasks.empty())
-        {
-          task = tasks.front();
-          tasks.pop();
-        }
-      };
+    // This may happen when threads are more than workers.
+    if ((size_t) i >= workers.size())
+      continue;
 
-      // This may happen when threads are more than workers.
-      if (task == std::numeric_limits<size_t>::max())
-        continue;
+    size_t task = i;
+    while (true)
+    {
+      #pragma omp flush(stop)
+      if (stop)
+        break;
 
       // Get corresponding worker.
       WorkerType& worker = workers[task];
       double episodeReturn;
-      if (worker.Step(learningNetwork, targetNetwork, totalSteps,
-          policy, episodeReturn) && !task)
+      if (worker.Step(learningNetwork, targetParameters, targetVersion,
+          totalSteps, policy, episodeReturn) && !task)
       {
         stop = measure(episodeReturn);
+        #pragma omp flush(stop)
       }
+
+      task += numThreads;
+      if (task >= workers.size())
+        task = i;
     }
   }
 
@@ -15,7 +15,9 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "vector_environment.hpp"
 #include "replay/random_replay.hpp"
+#include "replay/prioritized_replay.hpp"
 #include "training_config.hpp"
 
 namespace mlpack {
@@ -45,7 +47,8 @@ namespace rl {
  * @tparam NetworkType The network to compute action value.
  * @tparam UpdaterType How to apply gradients when training.
  * @tparam PolicyType Behavior policy of the agent.
- * @tparam ReplayType Experience replay method.
+ * @tparam ReplayType Experience replay method (RandomReplay or
+ *     PrioritizedReplay).
  */
 template <
   typename EnvironmentType,
@@ -89,6 +92,18 @@ class QLearning
    */
   double Step();
 
+  /**
+   * Execute a step in each instance of the given vector of environments.  The
+   * action values of all instances are computed with one forward pass, every
+   * transition is stored for replay, and the network learns from one sampled
+   * batch.  Episodes that end are restarted by the vector of environments,
+   * which records their returns.
+   *
+   * @param environments The instances of the environment to step.
+   * @return Total reward of the step over all instances.
+   */
+  double Step(VectorEnvironment<EnvironmentType>& environments);
+
   /**
    * Execute an episode.
    * @return Return of the episode.
@@ -113,6 +128,11 @@ class QLearning
    */
   arma::Col<size_t> BestAction(const arma::mat& actionValues);
 
+  /**
+   * Learn from a batch sampled from the experience replay.
+   */
+  void TrainAgent();
+
   //! Locally-stored hyper-parameters.
   TrainingConfig config;
 
@@ -113,8 +113,81 @@ double QLearning<
   if (deterministic || totalSteps < config.ExplorationSteps())
     return reward;
 
-  // Start experience replay.
+  TrainAgent();
 
+  return reward;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+double QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Step(VectorEnvironment<EnvironmentType>& environments)
+{
+  // Get the action values of all instances with one forward pass.
+  arma::mat actionValues;
+  learningNetwork.Predict(environments.Encode(), actionValues);
+
+  // Select an action for each instance according to the behavior policy.
+  std::vector<ActionType> actions(environments.Size());
+  for (size_t i = 0; i < environments.Size(); ++i)
+    actions[i] = policy.Sample(actionValues.col(i), deterministic);
+
+  // Interact with all instances.
+  arma::colvec rewards;
+  arma::icolvec isTerminal;
+  environments.Sample(actions, rewards, isTerminal);
+
+  if (deterministic)
+    return arma::accu(rewards);
+
+  for (size_t i = 0; i < environments.Size(); ++i)
+  {
+    // Store the transition for replay.
+    replayMethod.Store(environments.PreviousStates()[i], actions[i],
+        rewards[i], environments.NextStates()[i], isTerminal[i]);
+
+    totalSteps++;
+
+    // Update target network
+    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
+      targetNetwork = learningNetwork;
+
+    if (totalSteps > config.ExplorationSteps())
+      policy.Anneal();
+  }
+
+  // Learn from one sampled batch per step of all instances.
+  if (totalSteps >= config.ExplorationSteps())
+    TrainAgent();
+
+  return arma::accu(rewards);
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::TrainAgent()
+{
   // Sample from previous experience.
   arma::mat sampledStates;
   arma::icolvec sampledActions;
@@ -149,21 +222,27 @@ double QLearning<
    * discounted reward. At terminal state, the agent wont perform any
    * action.
    */
+  arma::colvec tdErrors(sampledNextStates.n_cols);
   for (size_t i = 0; i < sampledNextStates.n_cols; ++i)
   {
-    if (isTerminal[i])
-      target(sampledActions[i], i) = sampledRewards[i];
-    else
-      target(sampledActions[i], i) = sampledRewards[i] + config.Discount() *
+    double updateTarget = sampledRewards[i];
+    if (!isTerminal[i])
+    {
+      updateTarget += config.Discount() *
           nextActionValues(bestActions[i], i);
+    }
+
+    tdErrors[i] = updateTarget - target(sampledActions[i], i);
+    target(sampledActions[i], i) = updateTarget;
   }
 
+  // Let the replay method update its priorities and weight the targets.
+  replayMethod.Update(tdErrors, sampledActions, target);
+
   // Learn form experience.
   arma::mat gradients;
   learningNetwork.Backward(target, gradients);
   updater.Update(learningNetwork.Parameters(), config.StepSize(), gradients);
-
-  return reward;
 }
 
 template <
@@ -0,0 +1,287 @@
+/**
+ * @file prioritized_replay.hpp
+ *
+ * This file is an implementation of prioritized experience replay.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_PRIORITIZED_REPLAY_HPP
+#define MLPACK_METHODS_RL_REPLAY_PRIORITIZED_REPLAY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "sum_tree.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of prioritized experience replay.
+ *
+ * Instead of sampling previous experiences uniformly, each transition is
+ * sampled with probability proportional to its priority p = (|d| + e)^alpha,
+ * where d is the temporal difference error of the last update computed for
+ * the transition.  New transitions get the largest priority seen so far, so
+ * that they are replayed at least once.  The priorities are kept in a sum tree,
+ * so sampling a batch and updating its priorities take O(batchSize log n)
+ * time.  The bias of the non-uniform sampling is corrected by weighting the
+ * update of transition i with the importance sampling weight
+ * (n P(i))^-beta, normalized by the largest weight of the batch; beta is
+ * annealed from its initial value to 1 during training.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{schaul2016prioritized,
+ *  title     = {Prioritized Experience Replay},
+ *  author    = {Schaul, Tom and Quan, John and Antonoglou, Ioannis and
+ *               Silver, David},
+ *  booktitle = {International Conference on Learning Representations},
+ *  year      = {2016}
+ * }
+ * @endcode
+ *
+ * @tparam EnvironmentType Desired task.
+ */
+template <typename EnvironmentType>
+class PrioritizedReplay
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  /**
+   * Construct an instance of prioritized experience replay class.
+   *
+   * @param batchSize Number of examples returned at each sample.
+   * @param capacity Total memory size in terms of number of examples.
+   * @param alpha How much prioritization is used (0 is uniform sampling).
+   * @param beta Initial exponent of the importance sampling weights.
+   * @param betaSteps Number of samples over which beta is annealed to 1.
+   * @param epsilon Small value added to the errors, so that every transition
+   *     has a non-zero priority.
+   * @param dimension The dimension of an encoded state.
+   */
+  PrioritizedReplay(const size_t batchSize,
+                    const size_t capacity,
+                    const double alpha = 0.6,
+                    const double beta = 0.4,
+                    const size_t betaSteps = 10000,
+                    const double epsilon = 1e-6,
+                    const size_t dimension = StateType::dimension) :
+      batchSize(batchSize),
+      capacity(capacity),
+      position(0),
+      alpha(alpha),
+      beta(beta),
+      betaIncrement(betaSteps > 0 ? (1.0 - beta) / betaSteps : 1.0),
+      epsilon(epsilon),
+      maxPriority(1.0),
+      states(dimension, capacity),
+      actions(capacity),
+      rewards(capacity),
+      nextStates(dimension, capacity),
+      isTerminal(capacity),
+      priorities(capacity),
+      full(false)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Store the given experience with the largest priority seen so far.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   */
+  void Store(const StateType& state,
+             ActionType action,
+             double reward,
+             const StateType& nextState,
+             bool isEnd)
+  {
+    states.col(position) = state.Encode();
+    actions(position) = action;
+    rewards(position) = reward;
+    nextStates.col(position) = nextState.Encode();
+    isTerminal(position) = isEnd;
+    priorities.Set(position, maxPriority);
+    position++;
+    if (position == capacity)
+    {
+      full = true;
+      position = 0;
+    }
+  }
+
+  /**
+   * Sample some experiences in proportion to their priorities.  The total
+   * priority is split into batchSize equal ranges, and one transition is drawn
+   * from each of them.  The sampled transitions and their importance sampling
+   * weights are remembered for the next call to Update().
+   *
+   * The output matrices keep their memory when they already have the size of a
+   * batch, so passing the same objects to every call doesn't allocate.
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   */
+  void Sample(arma::mat& sampledStates,
+              arma::icolvec& sampledActions,
+              arma::colvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::icolvec& isTerminal)
+  {
+    const size_t upperBound = full ? capacity : position;
+    const double total = priorities.Sum();
+    const double range = total / batchSize;
+
+    sampledIndices.set_size(batchSize);
+    weights.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      const double mass = (i + math::Random()) * range;
+      const size_t index = std::min(priorities.FindPrefixSum(mass),
+          upperBound - 1);
+      sampledIndices[i] = index;
+
+      const double probability = priorities.Get(index) / total;
+      weights[i] = std::pow(upperBound * probability, -beta);
+    }
+    weights /= weights.max();
+
+    beta = std::min(1.0, beta + betaIncrement);
+
+    sampledStates.set_size(states.n_rows, batchSize);
+    sampledNextStates.set_size(nextStates.n_rows, batchSize);
+    sampledActions.set_size(batchSize);
+    sampledRewards.set_size(batchSize);
+    isTerminal.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      const size_t index = sampledIndices[i];
+      sampledStates.col(i) = states.col(index);
+      sampledNextStates.col(i) = nextStates.col(index);
+      sampledActions[i] = actions[index];
+      sampledRewards[i] = rewards[index];
+      isTerminal[i] = this->isTerminal[index];
+    }
+  }
+
+  /**
+   * Update the priorities of the transitions returned by the last call to
+   * Sample() with their temporal difference errors, and weight their updates
+   * by the importance sampling weights.  The target of transition i is moved
+   * from action value + d to action value + w d, which scales the gradient of
+   * the squared error of the transition by w.
+   *
+   * @param tdErrors The temporal difference error of each sampled transition
+   *     (target minus the current action value).
+   * @param sampledActions The sampled actions.
+   * @param target The update targets of the network; modified in place.
+   */
+  void Update(const arma::colvec& tdErrors,
+              const arma::icolvec& sampledActions,
+              arma::mat& target)
+  {
+    for (size_t i = 0; i < sampledIndices.n_elem; ++i)
+    {
+      const double priority = std::pow(std::abs(tdErrors[i]) + epsilon,
+          alpha);
+      priorities.Set(sampledIndices[i], priority);
+      maxPriority = std::max(maxPriority, priority);
+
+      target(sampledActions[i], i) -= (1.0 - weights[i]) * tdErrors[i];
+    }
+  }
+
+  /**
+   * Get the number of transitions in the memory.
+   *
+   * @return Actual used memory size
+   */
+  const size_t& Size()
+  {
+    return full ? capacity : position;
+  }
+
+  //! Get the importance sampling weights of the last sample.
+  const arma::colvec& Weights() const { return weights; }
+
+  //! Get the indices of the transitions of the last sample.
+  const arma::Col<size_t>& SampledIndices() const { return sampledIndices; }
+
+  //! Get the priority of the given transition.
+  double Priority(const size_t index) const { return priorities.Get(index); }
+
+  //! Get the current exponent of the importance sampling weights.
+  double Beta() const { return beta; }
+
+ private:
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
+
+  //! Locally-stored total memory limit.
+  size_t capacity;
+
+  //! Indicate the position to store new transition.
+  size_t position;
+
+  //! Locally-stored amount of prioritization.
+  double alpha;
+
+  //! Locally-stored exponent of the importance sampling weights.
+  double beta;
+
+  //! Locally-stored increase of beta at each sample.
+  double betaIncrement;
+
+  //! Locally-stored value added to the errors.
+  double epsilon;
+
+  //! Locally-stored largest priority seen so far.
+  double maxPriority;
+
+  //! Locally-stored encoded previous states.
+  arma::mat states;
+
+  //! Locally-stored previous actions.
+  arma::icolvec actions;
+
+  //! Locally-stored previous rewards.
+  arma::colvec rewards;
+
+  //! Locally-stored encoded previous next states.
+  arma::mat nextStates;
+
+  //! Locally-stored termination information of previous experience.
+  arma::icolvec isTerminal;
+
+  //! Locally-stored priorities of previous experience.
+  SumTree priorities;
+
+  //! Locally-stored indices of the transitions of the last sample.
+  arma::Col<size_t> sampledIndices;
+
+  //! Locally-stored importance sampling weights of the last sample.
+  arma::colvec weights;
+
+  //! Locally-stored indicator that whether the memory is full or not
+  bool full;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
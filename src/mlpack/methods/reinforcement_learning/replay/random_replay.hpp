@@ -125,6 +125,19 @@ class RandomReplay
     isTerminal = this->isTerminal.elem(sampledIndices);
   }
 
+  /**
+   * Update the sampled experiences with their temporal difference errors.
+   * Random replay samples uniformly, so there is nothing to update.
+   *
+   * @param tdErrors The temporal difference error of each sampled transition.
+   * @param sampledActions The sampled actions.
+   * @param target The update targets of the network.
+   */
+  void Update(const arma::colvec& /* tdErrors */,
+              const arma::icolvec& /* sampledActions */,
+              arma::mat& /* target */)
+  { /* Nothing to do here. */ }
+
   /**
    * Get the number of transitions in the memory.
    *
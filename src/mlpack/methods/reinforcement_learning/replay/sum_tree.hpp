@@ -0,0 +1,114 @@
+/**
+ * @file sum_tree.hpp
+ *
+ * This file is an implementation of a sum tree, which stores non-negative
+ * values and supports proportional sampling and updates in logarithmic time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_SUM_TREE_HPP
+#define MLPACK_METHODS_RL_REPLAY_SUM_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of a sum tree.  The stored values are the leaves of a
+ * complete binary tree, and every internal node holds the sum of its
+ * children, so that the root holds the total.  Setting a value and finding the
+ * element at which a prefix sum is reached both walk a single path of the
+ * tree, and take O(log n) time.
+ *
+ * The tree is stored as an array: the root is node 1, the children of node i
+ * are the nodes 2i and 2i + 1, and the leaves are the nodes [n, 2n), where n is
+ * the number of elements rounded up to a power of two.
+ */
+class SumTree
+{
+ public:
+  /**
+   * Construct a sum tree that holds the given number of elements, all of which
+   * are zero.
+   *
+   * @param size Number of elements.
+   */
+  SumTree(const size_t size = 0) : size(size), leaves(1)
+  {
+    while (leaves < size)
+      leaves *= 2;
+
+    tree.zeros(2 * leaves);
+  }
+
+  /**
+   * Set the value of the given element.
+   *
+   * @param index Index of the element.
+   * @param value New non-negative value of the element.
+   */
+  void Set(const size_t index, const double value)
+  {
+    size_t node = index + leaves;
+    tree[node] = value;
+    for (node /= 2; node >= 1; node /= 2)
+      tree[node] = tree[2 * node] + tree[2 * node + 1];
+  }
+
+  //! Get the value of the given element.
+  double Get(const size_t index) const { return tree[index + leaves]; }
+
+  //! Get the sum of all elements.
+  double Sum() const { return tree[1]; }
+
+  /**
+   * Find the first element i such that the sum of the elements 0, ..., i is
+   * larger than the given mass.  Drawing the mass uniformly from [0, Sum())
+   * samples every element with probability proportional to its value.
+   *
+   * @param mass Prefix sum to search for.
+   * @return Index of the element.
+   */
+  size_t FindPrefixSum(double mass) const
+  {
+    size_t node = 1;
+    while (node < leaves)
+    {
+      if (mass < tree[2 * node] || tree[2 * node + 1] <= 0.0)
+      {
+        node = 2 * node;
+      }
+      else
+      {
+        mass -= tree[2 * node];
+        node = 2 * node + 1;
+      }
+    }
+
+    // Subtrees with a zero sum are never entered, so the search doesn't end on
+    // one of the padding leaves.
+    return std::min(node - leaves, size - 1);
+  }
+
+  //! Get the number of elements.
+  size_t Size() const { return size; }
+
+ private:
+  //! Locally-stored number of elements.
+  size_t size;
+
+  //! Locally-stored number of leaves (a power of two).
+  size_t leaves;
+
+  //! Locally-stored nodes of the tree; node 0 is unused.
+  arma::vec tree;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,195 @@
+/**
+ * @file vector_environment.hpp
+ *
+ * Wrapper that steps several instances of an RL environment together.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_VECTOR_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_VECTOR_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A vector of environments, which runs one episode in each of several
+ * instances of the same environment and steps all of them together.  The
+ * current states are encoded as the columns of one matrix, so that the action
+ * values of all instances can be computed with one batched forward pass of
+ * the network instead of one forward pass per instance.
+ *
+ * When the episode of an instance ends, because its next state is terminal or
+ * because it reached the step limit, its return is recorded and a new episode
+ * is started in that instance, so every instance always has a current state.
+ *
+ * @tparam EnvironmentType The environment of each instance.
+ */
+template <typename EnvironmentType>
+class VectorEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of instances of the environment, and start an
+   * episode in each of them.
+   *
+   * @param size Number of instances.
+   * @param stepLimit Maximum number of steps of an episode (0 means no limit).
+   * @param environment The environment each instance is copied from.
+   */
+  VectorEnvironment(const size_t size,
+                    const size_t stepLimit = 0,
+                    const EnvironmentType& environment = EnvironmentType()) :
+      environments(size, environment),
+      stepLimit(stepLimit)
+  {
+    InitialSample();
+  }
+
+  /**
+   * Start a new episode in every instance, and discard the recorded returns.
+   */
+  void InitialSample()
+  {
+    states.resize(environments.size());
+    previousStates.resize(environments.size());
+    nextStates.resize(environments.size());
+    steps.zeros(environments.size());
+    returns.zeros(environments.size());
+    episodeReturns.clear();
+
+    for (size_t i = 0; i < environments.size(); ++i)
+      Reset(i);
+  }
+
+  /**
+   * Take one step in every instance.  Afterwards PreviousStates() and
+   * NextStates() hold the transitions that were taken, and States() holds the
+   * current states, in which a new episode was started for every instance
+   * whose episode ended.
+   *
+   * @param actions The action of each instance.
+   * @param rewards The reward of each instance.
+   * @param isTerminal Whether the next state of each instance is terminal.
+   */
+  void Sample(const std::vector<ActionType>& actions,
+              arma::colvec& rewards,
+              arma::icolvec& isTerminal)
+  {
+    rewards.set_size(environments.size());
+    isTerminal.set_size(environments.size());
+
+    std::swap(previousStates, states);
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      rewards[i] = environments[i].Sample(previousStates[i], actions[i],
+          nextStates[i]);
+      isTerminal[i] = environments[i].IsTerminal(nextStates[i]);
+
+      steps[i]++;
+      returns[i] += rewards[i];
+      if (isTerminal[i] || (stepLimit && steps[i] >= stepLimit))
+      {
+        episodeReturns.push_back(returns[i]);
+        Reset(i);
+      }
+      else
+      {
+        states[i] = nextStates[i];
+        encodedStates.col(i) = states[i].Encode();
+      }
+    }
+  }
+
+  /**
+   * Get the current states of all instances, encoded as the columns of one
+   * matrix.
+   */
+  const arma::mat& Encode() const { return encodedStates; }
+
+  //! Get the current state of each instance.
+  const std::vector<StateType>& States() const { return states; }
+
+  //! Get the states the last call to Sample() started from.
+  const std::vector<StateType>& PreviousStates() const
+  { return previousStates; }
+
+  //! Get the states the last call to Sample() led to.
+  const std::vector<StateType>& NextStates() const { return nextStates; }
+
+  //! Get the returns of the episodes that ended since the last call to
+  //! InitialSample().
+  const std::vector<double>& EpisodeReturns() const { return episodeReturns; }
+  //! Modify the returns of the episodes that ended, e.g. to clear them.
+  std::vector<double>& EpisodeReturns() { return episodeReturns; }
+
+  //! Get the given instance.
+  const EnvironmentType& Environment(const size_t i) const
+  { return environments[i]; }
+  //! Modify the given instance.
+  EnvironmentType& Environment(const size_t i) { return environments[i]; }
+
+  //! Get the number of instances.
+  size_t Size() const { return environments.size(); }
+
+  //! Get the maximum number of steps of an episode.
+  size_t StepLimit() const { return stepLimit; }
+  //! Modify the maximum number of steps of an episode.
+  size_t& StepLimit() { return stepLimit; }
+
+ private:
+  //! Start a new episode in the given instance.
+  void Reset(const size_t i)
+  {
+    states[i] = environments[i].InitialSample();
+    steps[i] = 0;
+    returns[i] = 0.0;
+
+    const arma::colvec encoded = states[i].Encode();
+    if (encodedStates.n_cols != environments.size())
+      encodedStates.set_size(encoded.n_elem, environments.size());
+    encodedStates.col(i) = encoded;
+  }
+
+  //! Locally-stored instances of the environment.
+  std::vector<EnvironmentType> environments;
+
+  //! Locally-stored maximum number of steps of an episode.
+  size_t stepLimit;
+
+  //! Locally-stored current state of each instance.
+  std::vector<StateType> states;
+
+  //! Locally-stored states the last step started from.
+  std::vector<StateType> previousStates;
+
+  //! Locally-stored states the last step led to.
+  std::vector<StateType> nextStates;
+
+  //! Locally-stored encoded current states.
+  arma::mat encodedStates;
+
+  //! Locally-stored number of steps of the current episode of each instance.
+  arma::Col<size_t> steps;
+
+  //! Locally-stored return of the current episode of each instance.
+  arma::colvec returns;
+
+  //! Locally-stored returns of the episodes that ended.
+  std::vector<double> episodeReturns;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
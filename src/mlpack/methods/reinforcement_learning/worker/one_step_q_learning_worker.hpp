@@ -70,13 +70,19 @@ class OneStepQLearningWorker
         learningNetwork.Parameters().n_cols);
     // Build local network.
     network = learningNetwork;
+
+    // Build the local snapshot of the target network.
+    targetNetwork = learningNetwork;
+    targetVersion = 0;
   }
 
   /**
    * The agent will execute one step.
    *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
+   * @param targetParameters The shared parameters of the target network.
+   * @param version The shared version of the target network, which is
+   *     increased whenever targetParameters is updated.
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -84,7 +90,8 @@ class OneStepQLearningWorker
    * @return Indicate whether current episode ends after this step.
    */
   bool Step(NetworkType& learningNetwork,
-            NetworkType& targetNetwork,
+            arma::mat& targetParameters,
+            size_t& version,
             size_t& totalSteps,
             PolicyType& policy,
             double& totalReward)
@@ -108,7 +115,7 @@ class OneStepQLearningWorker
         totalReward = episodeReturn;
         Reset();
         // Sync with latest learning network.
-        network = learningNetwork;
+        network.Parameters() = learningNetwork.Parameters();
         return true;
       }
       state = nextState;
@@ -123,6 +130,9 @@ class OneStepQLearningWorker
 
     if (terminal || pendingIndex >= config.UpdateInterval())
     {
+      // Take the latest snapshot of the target network, if there is one.
+      SyncTargetNetwork(targetParameters, version);
+
       // Initialize the gradient storage.
       arma::mat totalGradients(learningNetwork.Parameters().n_rows,
           learningNetwork.Parameters().n_cols, arma::fill::zeros);
@@ -132,11 +142,7 @@ class OneStepQLearningWorker
 
         // Compute the target state-action value.
         arma::colvec actionValue;
-        #pragma omp critical
-        {
-          targetNetwork.Predict(
-              std::get<3>(transition).Encode(), actionValue);
-        };
+        targetNetwork.Predict(std::get<3>(transition).Encode(), actionValue);
         double targetActionValue = actionValue.max();
         if (terminal && i == pending.size() - 1)
           targetActionValue = 0;
@@ -165,8 +171,9 @@ class OneStepQLearningWorker
       updater.Update(learningNetwork.Parameters(),
           config.StepSize(), totalGradients);
 
-      // Sync the local network with the global network.
-      network = learningNetwork;
+      // Sync the local network with the global network.  Only the parameters
+      // are copied, into the memory the layers of the local network use.
+      network.Parameters() = learningNetwork.Parameters();
 
       pendingIndex = 0;
     }
@@ -175,7 +182,10 @@ class OneStepQLearningWorker
     if (totalSteps % config.TargetNetworkSyncInterval() == 0)
     {
       #pragma omp critical
-      { targetNetwork = learningNetwork; }
+      {
+        targetParameters = learningNetwork.Parameters();
+        version++;
+      }
     }
 
     policy.Anneal();
@@ -190,7 +200,33 @@ class OneStepQLearningWorker
     return false;
   }
 
+  //! Get the local network of the worker.
+  const NetworkType& Network() const { return network; }
+  //! Modify the local network of the worker.
+  NetworkType& Network() { return network; }
+
  private:
+  /**
+   * Copy the shared parameters of the target network into the local snapshot,
+   * if they were updated since the last copy.  The snapshot is only used by
+   * this worker, so predictions with it don't need a lock.
+   *
+   * @param targetParameters The shared parameters of the target network.
+   * @param version The shared version of the target network.
+   */
+  void SyncTargetNetwork(const arma::mat& targetParameters,
+                         const size_t& version)
+  {
+    if (targetVersion == version)
+      return;
+
+    #pragma omp critical
+    {
+      targetNetwork.Parameters() = targetParameters;
+      targetVersion = version;
+    }
+  }
+
   /**
    * Reset the worker for a new episode.
    */
@@ -229,6 +265,12 @@ class OneStepQLearningWorker
   //! Local network of the worker.
   NetworkType network;
 
+  //! Local snapshot of the target network.
+  NetworkType targetNetwork;
+
+  //! Version of the target network the local snapshot was taken from.
+  size_t targetVersion;
+
   //! Current state of the agent.
   StateType state;
 };
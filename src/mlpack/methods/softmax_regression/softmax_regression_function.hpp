@@ -14,10 +14,20 @@
 #define MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/streaming_function.hpp>
 
 namespace mlpack {
 namespace regression {
 
+/**
+ * The objective function of softmax regression, to be optimized by the mlpack
+ * optimizers.  The data can be dense or sparse; with sparse data
+ * (arma::sp_mat), nothing is ever densified except the class probabilities of
+ * the points of a batch.
+ *
+ * @tparam MatType Type of the data matrix (arma::mat or arma::sp_mat).
+ */
+template<typename MatType = arma::mat>
 class SoftmaxRegressionFunction
 {
  public:
@@ -32,7 +42,7 @@ class SoftmaxRegressionFunction
    * @param lambda L2-regularization constant.
    * @param fitIntercept Intercept term flag.
    */
-  SoftmaxRegressionFunction(const arma::mat& data,
+  SoftmaxRegressionFunction(const MatType& data,
                             const arma::Row<size_t>& labels,
                             const size_t numClasses,
                             const double lambda = 0.0001,
@@ -151,6 +161,24 @@ class SoftmaxRegressionFunction
                 arma::mat& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the gradient of the objective function on a subset of the data,
+   * as a sparse matrix.  Only the weights of the features that are non-zero in
+   * the given points (and the intercepts) are affected by those points, so if
+   * lambda is 0 the gradient is as sparse as the points are; this is the form
+   * used by ParallelSGD.  If lambda is not 0, the regularization makes the
+   * gradient dense.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Sparse matrix to store gradient into.
+   * @param batchSize Number of data points to evaluate gradient for.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t start,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters for a single feature indexed by j.
@@ -167,6 +195,9 @@ class SoftmaxRegressionFunction
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
+  //! Return the number of separable functions (the number of data points).
+  size_t NumFunctions() const { return data.n_cols; }
+
   //! Gets the number of classes.
   size_t NumClasses() const { return numClasses; }
 
@@ -184,9 +215,19 @@ class SoftmaxRegressionFunction
   //! Gets the intercept flag.
   bool FitIntercept() const { return fitIntercept; }
 
+  //! Gets the training data.
+  const MatType& Data() const { return data; }
+  //! Modify the training data.
+  MatType& Data() { return data; }
+
+  //! Gets the label matrix.
+  const arma::sp_mat& GroundTruth() const { return groundTruth; }
+  //! Modify the label matrix.
+  arma::sp_mat& GroundTruth() { return groundTruth; }
+
  private:
   //! Training data matrix.  This is an alias until the data is shuffled.
-  arma::mat data;
+  MatType data;
   //! Label matrix for the provided data.
   arma::sp_mat groundTruth;
   //! Initial parameter point.
@@ -200,6 +241,39 @@ class SoftmaxRegressionFunction
 };
 
 } // namespace regression
+
+namespace data {
+
+/**
+ * Give a chunk of data to a SoftmaxRegressionFunction that is trained with a
+ * StreamingFunction.  The labels of the chunk are converted to the label
+ * matrix used by the function.
+ */
+template<typename MatType>
+class ChunkSetter<regression::SoftmaxRegressionFunction<MatType>>
+{
+ public:
+  ChunkSetter(
+      const regression::SoftmaxRegressionFunction<MatType>& /* function */) { }
+
+  template<typename PredictorsType, typename ResponsesType>
+  void Set(regression::SoftmaxRegressionFunction<MatType>& function,
+           PredictorsType&& predictors,
+           ResponsesType&& responses,
+           const size_t /* numPoints */)
+  {
+    math::ClearAlias(function.Data());
+    function.Data() = std::move(predictors);
+    function.GetGroundTruthMatrix(
+        arma::conv_to<arma::Row<size_t>>::from(responses),
+        function.GroundTruth());
+  }
+};
+
+} // namespace data
 } // namespace mlpack
 
+// Include implementation.
+#include "softmax_regression_function_impl.hpp"
+
 #endif
@@ -15,12 +15,14 @@
 // In case it hasn't been included yet.
 #include "softmax_regression.hpp"
 
+#include <mlpack/core/util/parallel_blocks.hpp>
+
 namespace mlpack {
 namespace regression {
 
-template<typename OptimizerType>
+template<typename OptimizerType, typename MatType>
 SoftmaxRegression::SoftmaxRegression(
-    const arma::mat& data,
+    const MatType& data,
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const double lambda,
@@ -41,14 +43,103 @@ size_t SoftmaxRegression::Classify(const VecType& point) const
   return size_t(label(0));
 }
 
-template<typename OptimizerType>
-double SoftmaxRegression::Train(const arma::mat& data,
+template<typename MatType>
+void SoftmaxRegression::Classify(const MatType& dataset,
+                                 arma::Row<size_t>& labels)
+    const
+{
+  arma::mat probabilities;
+  Classify(dataset, labels, probabilities);
+}
+
+template<typename MatType>
+void SoftmaxRegression::Classify(const MatType& dataset,
+                                 arma::Row<size_t>& labels,
+                                 arma::mat& probabilities)
+    const
+{
+  Classify(dataset, probabilities);
+
+  // The prediction for each point is the class with the highest probability.
+  labels.set_size(dataset.n_cols);
+  util::ParallelBlocks(dataset.n_cols, [&](const size_t begin, const size_t end)
+  {
+    for (size_t i = begin; i <= end; ++i)
+      labels[i] = probabilities.col(i).index_max();
+  });
+}
+
+template<typename MatType>
+void SoftmaxRegression::Classify(const MatType& dataset,
+                                 arma::mat& probabilities)
+    const
+{
+  if (dataset.n_rows != FeatureSize())
+  {
+    std::ostringstream oss;
+    oss << "SoftmaxRegression::Classify(): dataset has " << dataset.n_rows
+        << " dimensions, but model has " << FeatureSize() << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Calculate the probabilities for each test input; blocks of points are
+  // handled in parallel.
+  probabilities.set_size(numClasses, dataset.n_cols);
+  util::ParallelBlocks(dataset.n_cols, [&](const size_t begin, const size_t end)
+  {
+    arma::mat hypothesis;
+    if (fitIntercept)
+    {
+      // In order to add the intercept term, we should compute following
+      // matrix:
+      //     [1; data] = arma::join_cols(ones(1, data.n_cols), data)
+      //     hypothesis = arma::exp(parameters * [1; data]).
+      //
+      // Since the cost of join maybe high due to the copy of original data,
+      // split the hypothesis computation to two components.
+      hypothesis = parameters.cols(1, parameters.n_cols - 1) *
+          dataset.cols(begin, end);
+      hypothesis.each_col() += parameters.col(0);
+      hypothesis = arma::exp(hypothesis);
+    }
+    else
+    {
+      hypothesis = arma::exp(parameters * dataset.cols(begin, end));
+    }
+
+    probabilities.cols(begin, end) = hypothesis.each_row() /
+        arma::sum(hypothesis, 0);
+  });
+}
+
+template<typename MatType>
+double SoftmaxRegression::ComputeAccuracy(
+    const MatType& testData,
+    const arma::Row<size_t>& labels) const
+{
+  arma::Row<size_t> predictions;
+
+  // Get predictions for the provided data.
+  Classify(testData, predictions);
+
+  // Increment count for every correctly predicted label.
+  size_t count = 0;
+  for (size_t i = 0; i < predictions.n_elem; i++)
+    if (predictions(i) == labels(i))
+      count++;
+
+  // Return percentage accuracy.
+  return (count * 100.0) / predictions.n_elem;
+}
+
+template<typename OptimizerType, typename MatType>
+double SoftmaxRegression::Train(const MatType& data,
                                 const arma::Row<size_t>& labels,
                                 const size_t numClasses,
                                 OptimizerType optimizer)
 {
-  SoftmaxRegressionFunction regressor(data, labels, numClasses,
-                                      lambda, fitIntercept);
+  SoftmaxRegressionFunction<MatType> regressor(data, labels, numClasses,
+                                               lambda, fitIntercept);
   if (parameters.is_empty())
     parameters = regressor.GetInitialPoint();
 
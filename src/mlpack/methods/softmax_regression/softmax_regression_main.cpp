@@ -14,6 +14,7 @@
 
 #include <mlpack/methods/softmax_regression/softmax_regression.hpp>
 #include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
+#include <mlpack/methods/random_fourier_features/random_fourier_features.hpp>
 
 #include <memory>
 #include <set>
@@ -21,6 +22,7 @@
 using namespace std;
 using namespace mlpack;
 using namespace mlpack::regression;
+using namespace mlpack::kernel;
 using namespace mlpack::util;
 
 // Define parameters for the executable.
@@ -71,7 +73,12 @@ PROGRAM_INFO("Softmax Regression", "This program performs softmax regression, "
     " " + PRINT_DATASET("predictions") + ", the following command can be used:"
     "\n\n" +
     PRINT_CALL("softmax_regression", "input_model", "sr_model", "test",
-        "test_points", "predictions", "predictions"));
+        "test_points", "predictions", "predictions") +
+    "\n\n"
+    "Kernel softmax regression can be approximated by giving a random Fourier "
+    "features transform created by preprocess_random_features with " +
+    PRINT_PARAM_STRING("feature_model") + ".  It is applied to the training "
+    "and test data, and must also be given when a saved model is used.");
 
 // Required options.
 PARAM_MATRIX_IN("training", "A matrix containing the training set (the matrix "
@@ -103,6 +110,13 @@ PARAM_DOUBLE_IN("lambda", "L2-regularization constant", "r", 0.0001);
 
 PARAM_FLAG("no_intercept", "Do not add the intercept term to the model.", "N");
 
+PARAM_MODEL_IN(RandomFourierFeatures, "feature_model", "Random Fourier "
+    "features transform (see preprocess_random_features) to apply to the "
+    "training and test data.", "F");
+
+// Map the given data to random Fourier features, if a transform was given.
+void ApplyFeatureModel(arma::mat& data, const string& paramName);
+
 // Count the number of classes in the given labels (if numClasses == 0).
 size_t CalculateNumberOfClasses(const size_t numClasses,
                                 const arma::Row<size_t>& trainLabels);
@@ -166,6 +180,27 @@ size_t CalculateNumberOfClasses(const size_t numClasses,
   }
 }
 
+void ApplyFeatureModel(arma::mat& data, const string& paramName)
+{
+  if (!CLI::HasParam("feature_model"))
+    return;
+
+  const RandomFourierFeatures* rff =
+      CLI::GetParam<RandomFourierFeatures*>("feature_model");
+  if (rff->Dimensionality() != data.n_rows)
+  {
+    Log::Fatal << "The transform given with "
+        << PRINT_PARAM_STRING("feature_model") << " is for "
+        << rff->Dimensionality() << "-dimensional data, but "
+        << PRINT_PARAM_STRING(paramName) << " has " << data.n_rows
+        << " dimensions!" << endl;
+  }
+
+  arma::mat features;
+  rff->Transform(data, features);
+  data = std::move(features);
+}
+
 template<typename Model>
 void TestClassifyAcc(size_t numClasses, const Model& model)
 {
@@ -182,6 +217,7 @@ void TestClassifyAcc(size_t numClasses, const Model& model)
 
   // Get the test dataset, and get predictions.
   arma::mat testData = std::move(CLI::GetParam<arma::mat>("test"));
+  ApplyFeatureModel(testData, "test");
 
   arma::Row<size_t> predictLabels;
   model.Classify(testData, predictLabels);
@@ -243,6 +279,7 @@ Model* TrainSoftmax(const size_t maxIterations)
   else
   {
     arma::mat trainData = std::move(CLI::GetParam<arma::mat>("training"));
+    ApplyFeatureModel(trainData, "training");
     arma::Row<size_t> trainLabels =
         std::move(CLI::GetParam<arma::Row<size_t>>("labels"));
 
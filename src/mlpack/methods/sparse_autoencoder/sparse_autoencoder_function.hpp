@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_SPARSE_AUTOENCODER_SPARSE_AUTOENCODER_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
 
 namespace mlpack {
 namespace nn {
@@ -22,6 +23,19 @@ namespace nn {
  * This is a class for the sparse autoencoder objective function. It can be used
  * to create learning models like self-taught learning, stacked autoencoders,
  * conditional random fields (CRFs), and so forth.
+ *
+ * The function is decomposable: each data point is one of the separable
+ * functions, so it can be optimized with SGD-like optimizers as well as with
+ * L-BFGS.  The objective for a batch of b points is the objective of the batch
+ * alone, with the reconstruction error summed instead of averaged and the
+ * regularization and sparsity terms scaled by b / n, so that the objective and
+ * gradient for all n points at once are those given by Evaluate() and
+ * Gradient().  The sparsity term is computed from the average activations of
+ * the batch, so the sum over smaller batches only approximates it.
+ *
+ * The activations and deltas of a batch are kept in buffers that are reused
+ * by the next call, so a SparseAutoencoderFunction must not be evaluated by
+ * several threads at once.
  */
 class SparseAutoencoderFunction
 {
@@ -70,6 +84,61 @@ class SparseAutoencoderFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluate the objective function and its gradient with the given
+   * parameters; this shares the feedforward pass between both.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the objective function for the given batch of points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the gradient of the objective function for the given batch of
+   * points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the objective function and its gradient for the given batch of
+   * points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
+
+  //! Shuffle the order of the points.  This may be called by the optimizer.
+  void Shuffle();
+
+  //! Return the number of separable functions (the number of points).
+  size_t NumFunctions() const { return data.n_cols; }
+
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
    * function of a real number 'x' is [1 / (1 + exp(-x))].
@@ -145,8 +214,17 @@ class SparseAutoencoderFunction
   }
 
  private:
-  //! The matrix of data points.
-  const arma::mat& data;
+  /**
+   * Compute the objective function for the given batch of points and, if
+   * gradient is not NULL, its gradient.
+   */
+  double EvaluateBatch(const arma::mat& parameters,
+                       const size_t begin,
+                       const size_t batchSize,
+                       arma::mat* gradient) const;
+
+  //! The matrix of data points.  This is an alias until shuffling is done.
+  arma::mat data;
   //! Initial parameter vector.
   arma::mat initialPoint;
   //! Size of the visible layer.
@@ -159,6 +237,15 @@ class SparseAutoencoderFunction
   double beta;
   //! Sparsity parameter.
   double rho;
+
+  //! Activations of the hidden layer for the last batch.
+  mutable arma::mat hiddenLayer;
+  //! Activations of the output layer for the last batch.
+  mutable arma::mat outputLayer;
+  //! Delta values of the output layer for the last batch.
+  mutable arma::mat delOut;
+  //! Delta values of the hidden layer for the last batch.
+  mutable arma::mat delHid;
 };
 
 } // namespace nn
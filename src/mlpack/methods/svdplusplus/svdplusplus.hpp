@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/dsgd/dsgd.hpp>
 #include <mlpack/methods/cf/cf.hpp>
 
 #include "svdplusplus_function.hpp"
@@ -76,6 +77,8 @@ class SVDPlusPlus
   /**
    * Constructor of SVDPlusPlus. By default SGD optimizer is used in
    * SVDPlusPlus. The optimizer uses a template specialization of Optimize().
+   * If OptimizerType is optimization::DSGD, the epochs are run with DSGD
+   * instead, which uses all threads without conflicting updates.
    *
    * @param iterations Number of optimization iterations.
    * @param alpha Learning rate for the SGD optimizer.
@@ -137,6 +140,24 @@ class SVDPlusPlus
                         const arma::mat& data);
 
  private:
+  /**
+   * Run SGD for the given number of epochs.  This uses the specialization of
+   * StandardSGD for the function.
+   */
+  template<typename FunctionType>
+  void Optimize(FunctionType& function,
+                arma::mat& parameters,
+                const std::false_type /* useDSGD */) const;
+
+  /**
+   * Run DSGD for the given number of epochs, which processes blocks of
+   * ratings that share no users and no items in parallel.
+   */
+  template<typename FunctionType>
+  void Optimize(FunctionType& function,
+                arma::mat& parameters,
+                const std::true_type /* useDSGD */) const;
+
   //! Number of optimization iterations.
   size_t iterations;
   //! Learning rate for the SGD optimizer.
@@ -105,6 +105,33 @@ class SVDPlusPlusFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Take an SGD step on the given training example; this is used by the DSGD
+   * optimizer.  The parameters of the user and the item of the example are
+   * updated directly.  The implicit item vectors are shared by all the users
+   * that interacted with the items, so their updates are collected per user
+   * instead, and applied by FinishEpoch().  Examples that share no user and no
+   * item may thus be used at the same time.
+   *
+   * @param parameters Parameters(user/item matrices, user/item bias,
+   *     item implicit matrix) of the decomposition.
+   * @param i Index of the training example.
+   * @param stepSize Step size of the update.
+   */
+  void StochasticUpdate(arma::mat& parameters,
+                        const size_t i,
+                        const double stepSize);
+
+  /**
+   * Apply the updates of the implicit item vectors collected by
+   * StochasticUpdate() since the last call, in parallel over the items.
+   *
+   * @param parameters Parameters(user/item matrices, user/item bias,
+   *     item implicit matrix) of the decomposition.
+   * @param stepSize Step size of the updates.
+   */
+  void FinishEpoch(arma::mat& parameters, const double stepSize);
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
@@ -144,6 +171,12 @@ class SVDPlusPlusFunction
   size_t numUsers;
   //! Number of items in the given dataset.
   size_t numItems;
+  //! The implicit data with one column per item, for FinishEpoch().
+  arma::sp_mat itemImplicitData;
+  //! The collected gradient terms of the implicit vectors, for every user.
+  arma::mat implicitUpdate;
+  //! The collected regularization of the implicit vectors, for every user.
+  arma::vec implicitDecay;
 };
 
 } // namespace svd
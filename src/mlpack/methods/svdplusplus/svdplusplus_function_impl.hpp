@@ -43,6 +43,9 @@ SVDPlusPlusFunction<MatType>::SVDPlusPlusFunction(const MatType& data,
   // Unused:
   //     row(rank).subvec(numUsers + numItems, numUsers + 2 * numItems - 1)
   initialPoint.randu(rank + 1, numUsers + 2 * numItems);
+
+  implicitUpdate.zeros(rank, numUsers);
+  implicitDecay.zeros(numUsers);
 }
 
 template<typename MatType>
@@ -284,6 +287,95 @@ void SVDPlusPlusFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template <typename MatType>
+void SVDPlusPlusFunction<MatType>::StochasticUpdate(arma::mat& parameters,
+                                                    const size_t i,
+                                                    const double stepSize)
+{
+  // Indices for accessing the the correct parameter columns.
+  const size_t user = data(0, i);
+  const size_t item = data(1, i) + numUsers;
+  const size_t implicitStart = numUsers + numItems;
+
+  // Calculate the squared error in the prediction.
+  const double rating = data(2, i);
+  const double userBias = parameters(rank, user);
+  const double itemBias = parameters(rank, item);
+
+  // Iterate through each item which the user interacted with to calculate
+  // user vector.
+  arma::vec userVec(rank, arma::fill::zeros);
+  arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+  arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+  size_t implicitCount = 0;
+  for (; it != it_end; ++it)
+  {
+    userVec += parameters.col(implicitStart + it.row()).subvec(0, rank - 1);
+    implicitCount += 1;
+  }
+  if (implicitCount != 0)
+    userVec /= std::sqrt(implicitCount);
+  userVec += parameters.col(user).subvec(0, rank - 1);
+
+  const double ratingError = rating - userBias - itemBias -
+      arma::dot(userVec, parameters.col(item).subvec(0, rank - 1));
+
+  // The implicit vectors get
+  //     y(k) -= stepSize * 2 * (lambda / N(u) * y(k) -
+  //         error / sqrt(N(u)) * v(j))
+  // from this example; both terms are collected for the user.
+  const arma::vec itemVec = parameters.col(item).subvec(0, rank - 1);
+  if (implicitCount != 0)
+  {
+    implicitUpdate.col(user) += ratingError / std::sqrt(implicitCount) *
+        itemVec;
+    implicitDecay[user] += lambda / implicitCount;
+  }
+
+  parameters.col(user).subvec(0, rank - 1) -= stepSize * 2 * (
+      lambda * parameters.col(user).subvec(0, rank - 1) -
+      ratingError * itemVec);
+  parameters.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
+      lambda * itemVec - ratingError * userVec);
+  parameters(rank, user) -= stepSize * 2 * (
+      lambda * parameters(rank, user) - ratingError);
+  parameters(rank, item) -= stepSize * 2 * (
+      lambda * parameters(rank, item) - ratingError);
+}
+
+template <typename MatType>
+void SVDPlusPlusFunction<MatType>::FinishEpoch(arma::mat& parameters,
+                                               const double stepSize)
+{
+  if (itemImplicitData.n_elem == 0)
+    itemImplicitData = implicitData.t();
+
+  // Each implicit vector sums the terms of the users that interacted with the
+  // item.  The regularization is applied as one shrinkage, which is clamped
+  // so that a large step can't flip the sign of the vector.
+  const size_t implicitStart = numUsers + numItems;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t k = 0; k < (omp_size_t) itemImplicitData.n_cols; ++k)
+  {
+    double decay = 0;
+    arma::vec update(rank, arma::fill::zeros);
+    arma::sp_mat::const_iterator it = itemImplicitData.begin_col(k);
+    for (; it != itemImplicitData.end_col(k); ++it)
+    {
+      decay += implicitDecay[it.row()];
+      update += implicitUpdate.col(it.row());
+    }
+
+    parameters.col(implicitStart + k).subvec(0, rank - 1) =
+        std::max(0.0, 1 - 2 * stepSize * decay) *
+        parameters.col(implicitStart + k).subvec(0, rank - 1) +
+        2 * stepSize * update;
+  }
+
+  implicitUpdate.zeros();
+  implicitDecay.zeros();
+}
+
 } // namespace svd
 } // namespace mlpack
 
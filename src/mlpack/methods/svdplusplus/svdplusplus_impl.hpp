@@ -40,7 +40,6 @@ void SVDPlusPlus<OptimizerType>::Apply(const arma::mat& data,
 {
   // batchSize is 1 in our implementation of SVDPlusPlus.
   // batchSize other than 1 has not been supported yet.
-  const int batchSize = 1;
   Log::Warn << "The batch size for optimizing SVDPlusPlus is 1."
       << std::endl;
   
@@ -50,12 +49,11 @@ void SVDPlusPlus<OptimizerType>::Apply(const arma::mat& data,
 
   // Make the optimizer object using a SVDPlusPlusFunction object.
   SVDPlusPlusFunction<arma::mat> svdPPFunc(data, cleanedData, rank, lambda);
-  mlpack::optimization::StandardSGD optimizer(alpha, batchSize,
-      iterations * data.n_cols);
 
   // Get optimized parameters.
   arma::mat parameters = svdPPFunc.GetInitialPoint();
-  optimizer.Optimize(svdPPFunc, parameters);
+  Optimize(svdPPFunc, parameters,
+      std::is_same<OptimizerType, optimization::DSGD>());
 
   // Constants for extracting user and item matrices.
   const size_t numUsers = max(data.row(0)) + 1;
@@ -111,6 +109,29 @@ void SVDPlusPlus<OptimizerType>::CleanData(const arma::mat& implicitData,
   cleanedData = arma::sp_mat(locations, values, maxItemID, maxUserID);
 }
 
+template<typename OptimizerType>
+template<typename FunctionType>
+void SVDPlusPlus<OptimizerType>::Optimize(
+    FunctionType& function,
+    arma::mat& parameters,
+    const std::false_type /* useDSGD */) const
+{
+  mlpack::optimization::StandardSGD optimizer(alpha, 1,
+      iterations * function.NumFunctions());
+  optimizer.Optimize(function, parameters);
+}
+
+template<typename OptimizerType>
+template<typename FunctionType>
+void SVDPlusPlus<OptimizerType>::Optimize(
+    FunctionType& function,
+    arma::mat& parameters,
+    const std::true_type /* useDSGD */) const
+{
+  mlpack::optimization::DSGD optimizer(alpha, iterations);
+  optimizer.Optimize(function, parameters);
+}
+
 } // namespace svd
 } // namespace mlpack
 
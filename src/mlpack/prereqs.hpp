@@ -116,6 +116,9 @@ or upgrade Boost to 1.59 or newer.
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
 
+// All code should be able to control the number of threads it uses.
+#include <mlpack/core/util/threads.hpp>
+
 // This can be removed with Visual Studio supports an OpenMP version with
 // unsigned loop variables.
 #ifdef _WIN32
@@ -710,6 +710,64 @@ BOOST_AUTO_TEST_CASE(ClassifyTest_IRIS)
   BOOST_REQUIRE_LE(lError, 0.30);
 }
 
+/**
+ * Make sure that classifying a dataset larger than one block gives the same
+ * labels as the weighted vote of the weak learners on each point.
+ */
+template<typename WeakLearnerType>
+void CheckBlockClassify(const WeakLearnerType& learner,
+                        const arma::mat& inputData,
+                        const arma::Row<size_t>& labels,
+                        const size_t numClasses)
+{
+  AdaBoost<WeakLearnerType> a(inputData, labels, numClasses, learner, 20,
+      1e-10);
+
+  // Perturbed copies of the data make a test set of several blocks.
+  arma::mat testData = arma::repmat(inputData, 1, 20);
+  testData += 0.1 * arma::randn<arma::mat>(testData.n_rows, testData.n_cols);
+
+  arma::Row<size_t> predictedLabels;
+  a.Classify(testData, predictedLabels);
+  BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, testData.n_cols);
+
+  arma::mat votes = arma::zeros<arma::mat>(numClasses, testData.n_cols);
+  for (size_t i = 0; i < a.WeakLearners(); ++i)
+  {
+    WeakLearnerType w(a.WeakLearner(i));
+    arma::Row<size_t> weakLabels(testData.n_cols);
+    w.Classify(testData, weakLabels);
+    for (size_t j = 0; j < testData.n_cols; ++j)
+      votes(weakLabels[j], j) += a.Alpha(i);
+  }
+
+  for (size_t j = 0; j < testData.n_cols; ++j)
+  {
+    arma::uword maxIndex = 0;
+    votes.col(j).max(maxIndex);
+    BOOST_REQUIRE_EQUAL(predictedLabels[j], maxIndex);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BlockClassifyTest)
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset iris.csv!");
+
+  arma::Mat<size_t> labels;
+  if (!data::Load("iris_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for iris_labels.txt");
+
+  const size_t numClasses = 3;
+
+  DecisionStump<> ds(inputData, labels.row(0), numClasses, 6);
+  CheckBlockClassify(ds, inputData, labels.row(0), numClasses);
+
+  Perceptron<> p(inputData, labels.row(0), numClasses, 400);
+  CheckBlockClassify(p, inputData, labels.row(0), numClasses);
+}
+
 /**
  * Ensure that the Train() function works like it is supposed to, by building
  * AdaBoost on one dataset and then re-training on another dataset.
@@ -150,6 +150,58 @@ BOOST_AUTO_TEST_CASE(SimpleAdamTestFunction)
   BOOST_REQUIRE_SMALL(coordinates[2], 0.1);
 }
 
+/**
+ * Tests the LazyAdam optimizer using a simple test function, whose gradients
+ * only have one non-zero entry each.
+ */
+BOOST_AUTO_TEST_CASE(SimpleLazyAdamTestFunction)
+{
+  SGDTestFunction f;
+  LazyAdam optimizer(1e-3, 1, 0.9, 0.999, 1e-8, 500000, 1e-9, true);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  optimizer.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_SMALL(coordinates[0], 0.1);
+  BOOST_REQUIRE_SMALL(coordinates[1], 0.1);
+  BOOST_REQUIRE_SMALL(coordinates[2], 0.1);
+}
+
+/**
+ * Make sure that LazyAdam takes the same steps as Adam for gradients with no
+ * zero entries, and leaves the entries with a zero gradient untouched.
+ */
+BOOST_AUTO_TEST_CASE(LazyAdamUpdateTest)
+{
+  AdamUpdate adam;
+  LazyAdamUpdate lazyAdam;
+  adam.Initialize(20, 1);
+  lazyAdam.Initialize(20, 1);
+
+  arma::mat iterate = arma::randu<arma::mat>(20, 1);
+  arma::mat lazyIterate = iterate;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    const arma::mat gradient = arma::randu<arma::mat>(20, 1) + 0.1;
+    adam.Update(iterate, 0.01, gradient);
+    lazyAdam.Update(lazyIterate, 0.01, gradient);
+  }
+
+  CheckMatrices(lazyIterate, iterate);
+
+  arma::mat gradient = arma::randu<arma::mat>(20, 1) + 0.1;
+  gradient.rows(5, 14).zeros();
+  const arma::mat previous = lazyIterate;
+  lazyAdam.Update(lazyIterate, 0.01, gradient);
+
+  CheckMatrices(lazyIterate.rows(5, 14), previous.rows(5, 14));
+  for (size_t i = 0; i < 5; ++i)
+  {
+    BOOST_REQUIRE_LT(lazyIterate(i), previous(i));
+    BOOST_REQUIRE_LT(lazyIterate(19 - i), previous(19 - i));
+  }
+}
+
 /**
  * Tests the AdaMax optimizer using a simple test function.
  */
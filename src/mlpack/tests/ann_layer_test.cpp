@@ -14,6 +14,8 @@
 
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/layer/layer_types.hpp>
+#include <mlpack/methods/ann/loss_functions/large_softmax_loss.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/init_rules/random_init.hpp>
 #include <mlpack/methods/ann/init_rules/const_init.hpp>
 #include <mlpack/methods/ann/init_rules/nguyen_widrow_init.hpp>
@@ -816,6 +818,59 @@ BOOST_AUTO_TEST_CASE(GradientLSTMLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * Numerical gradient test of an RNN whose layers are a mix of those whose
+ * outputs are kept for backpropagation through time and those whose outputs
+ * aren't, with calls to Evaluate() between the gradients.
+ */
+BOOST_AUTO_TEST_CASE(GradientRNNSavedOutputsTest)
+{
+  // RNN function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(2, 1, 5);
+      target.ones(1, 1, 5);
+      const size_t rho = 5;
+
+      model = new RNN<NegativeLogLikelihood<> >(rho);
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(2, 10);
+      model->Add<Linear<> >(10, 10);
+      model->Add<SigmoidLayer<> >();
+      model->Add<LSTM<> >(10, 4, rho);
+      model->Add<TanHLayer<> >();
+      model->Add<Linear<> >(4, 3);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      // Evaluating in training mode must not leave outputs behind that the
+      // gradient would read.
+      model->Evaluate(model->Parameters(), 0, 1, false);
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    RNN<NegativeLogLikelihood<> >* model;
+    arma::cube input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
+}
+
 /**
  * Test the FastLSTM layer with a user defined rho parameter and without.
  */
@@ -1036,6 +1091,54 @@ BOOST_AUTO_TEST_CASE(SimpleConcatLayerTest)
   BOOST_REQUIRE_EQUAL(arma::accu(delta), 0);
 }
 
+/**
+ * Test that the Concat layer gives the right outputs and errors when the
+ * modules write into its buffers over several passes.
+ */
+BOOST_AUTO_TEST_CASE(ConcatLayerReuseTest)
+{
+  arma::mat output, delta, outputA, outputB, deltaA, deltaB;
+
+  Linear<> moduleA(10, 5);
+  moduleA.Parameters().randu();
+  moduleA.Reset();
+
+  Linear<> moduleB(10, 3);
+  moduleB.Parameters().randu();
+  moduleB.Reset();
+
+  Concat<> module(true, false);
+  module.Add(moduleA);
+  module.Add(moduleB);
+
+  for (size_t pass = 0; pass < 3; ++pass)
+  {
+    arma::mat input = arma::randu(10, 1);
+    module.Forward(std::move(input), std::move(output));
+    moduleA.Forward(std::move(input), std::move(outputA));
+    moduleB.Forward(std::move(input), std::move(outputB));
+
+    BOOST_REQUIRE_EQUAL(output.n_rows, 5);
+    BOOST_REQUIRE_EQUAL(output.n_cols, 2);
+    CheckMatrices(arma::mat(output.col(0)), outputA);
+    CheckMatrices(arma::mat(output.submat(0, 1, 2, 1)), outputB);
+    BOOST_REQUIRE_EQUAL(output(3, 1), 0);
+    BOOST_REQUIRE_EQUAL(output(4, 1), 0);
+
+    arma::mat error = arma::randu(5, 2);
+    arma::mat errorA = error.col(0);
+    arma::mat errorB = error.submat(0, 1, 2, 1);
+    module.Backward(std::move(input), std::move(error), std::move(delta));
+    moduleA.Backward(std::move(input), std::move(errorA), std::move(deltaA));
+    moduleB.Backward(std::move(input), std::move(errorB), std::move(deltaB));
+
+    BOOST_REQUIRE_EQUAL(delta.n_rows, 10);
+    BOOST_REQUIRE_EQUAL(delta.n_cols, 2);
+    CheckMatrices(arma::mat(delta.col(0)), deltaA);
+    CheckMatrices(arma::mat(delta.col(1)), deltaB);
+  }
+}
+
 /**
  * Concat layer numerical gradient test.
  */
@@ -1195,6 +1298,70 @@ BOOST_AUTO_TEST_CASE(SimpleLookupLayerTest)
   BOOST_REQUIRE_CLOSE(arma::accu(gradient), arma::accu(error), 1e-3);
 }
 
+/**
+ * Make sure that the Lookup module adds up the gradient of repeated tokens and
+ * clears the columns of the previous batch.
+ */
+BOOST_AUTO_TEST_CASE(LookupLayerRepeatedTokenGradientTest)
+{
+  arma::mat gradient;
+  Lookup<> module(10, 3);
+  module.Parameters().randu();
+
+  arma::mat input("2; 5; 2");
+  arma::mat error = arma::randu<arma::mat>(3, 3);
+  module.Gradient(std::move(input), std::move(error), std::move(gradient));
+
+  CheckMatrices(gradient.col(1), error.col(0) + error.col(2));
+  CheckMatrices(gradient.col(4), error.col(1));
+  BOOST_REQUIRE_CLOSE(arma::accu(gradient), arma::accu(error), 1e-3);
+
+  // The next batch doesn't contain the token 5 anymore.
+  input = arma::mat("7; 2; 2");
+  error = arma::randu<arma::mat>(3, 3);
+  module.Gradient(std::move(input), std::move(error), std::move(gradient));
+
+  CheckMatrices(gradient.col(1), error.col(1) + error.col(2));
+  CheckMatrices(gradient.col(6), error.col(0));
+  BOOST_REQUIRE_SMALL(arma::accu(arma::abs(gradient.col(4))), 1e-10);
+  BOOST_REQUIRE_CLOSE(arma::accu(gradient), arma::accu(error), 1e-3);
+}
+
+/**
+ * Make sure that the embedding gradient of the Lookup module inside an FFN
+ * only depends on the current batch, whatever the optimizer left in the
+ * gradient, so that the embeddings of tokens that are never seen don't move.
+ */
+BOOST_AUTO_TEST_CASE(LookupLayerFFNGradientTest)
+{
+  // Only the tokens 1 to 5 of the vocabulary of 10 are used.
+  arma::mat data = arma::randi<arma::mat>(1, 100, arma::distr_param(1, 5));
+  arma::mat responses = arma::randu<arma::mat>(1, 100);
+
+  FFN<MeanSquaredError<> > model;
+  model.Add<Lookup<> >(10, 3);
+  model.Add<Linear<> >(3, 1);
+  model.ResetParameters();
+
+  // The embedding table is the first 3 x 10 parameters, one column per token.
+  const arma::mat initialParameters = model.Parameters();
+
+  model.Predictors() = data;
+  model.Responses() = responses;
+  arma::mat gradient = arma::randu<arma::mat>(model.Parameters().n_rows,
+      model.Parameters().n_cols);
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 10);
+  BOOST_REQUIRE_SMALL(arma::accu(arma::abs(gradient.rows(15, 29))), 1e-10);
+
+  optimization::StandardSGD sgd(0.01, 10, 1000);
+  model.Train(data, responses, sgd);
+
+  CheckMatrices(initialParameters.rows(15, 29),
+      model.Parameters().rows(15, 29));
+  BOOST_REQUIRE_GT(arma::accu(arma::abs(initialParameters.rows(0, 14) -
+      model.Parameters().rows(0, 14))), 0.0);
+}
+
 /**
  * Simple LogSoftMax module test.
  */
@@ -1253,6 +1420,146 @@ BOOST_AUTO_TEST_CASE(SimpleBilinearInterpolationLayerTest)
       arma::zeros(input.n_rows), 1e-12);
 }
 
+/**
+ * Make sure that the BilinearInterpolation layer interpolates every channel of
+ * every point of a batch like a single channel, over several passes.
+ */
+BOOST_AUTO_TEST_CASE(BatchBilinearInterpolationLayerTest)
+{
+  const size_t inRowSize = 3, inColSize = 4, outRowSize = 5, outColSize = 7;
+  const size_t depth = 2, batchSize = 3;
+  BilinearInterpolation<> layer(inRowSize, inColSize, outRowSize, outColSize,
+      depth);
+  BilinearInterpolation<> single(inRowSize, inColSize, outRowSize,
+      outColSize, 1);
+
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    arma::mat input = arma::randu(inRowSize * inColSize * depth, batchSize);
+    arma::mat output, delta;
+    layer.Forward(std::move(input), std::move(output));
+
+    arma::mat error = arma::randu(outRowSize * outColSize * depth,
+        batchSize);
+    layer.Backward(std::move(input), std::move(error), std::move(delta));
+
+    BOOST_REQUIRE_EQUAL(output.n_rows, outRowSize * outColSize * depth);
+    BOOST_REQUIRE_EQUAL(output.n_cols, batchSize);
+    BOOST_REQUIRE_EQUAL(delta.n_rows, input.n_rows);
+    BOOST_REQUIRE_EQUAL(delta.n_cols, batchSize);
+
+    const arma::mat inputSlices(input.memptr(), inRowSize * inColSize,
+        depth * batchSize);
+    const arma::mat outputSlices(output.memptr(), outRowSize * outColSize,
+        depth * batchSize);
+    const arma::mat errorSlices(error.memptr(), outRowSize * outColSize,
+        depth * batchSize);
+    const arma::mat deltaSlices(delta.memptr(), inRowSize * inColSize,
+        depth * batchSize);
+    for (size_t k = 0; k < depth * batchSize; ++k)
+    {
+      arma::mat sliceInput = inputSlices.col(k);
+      arma::mat sliceError = errorSlices.col(k);
+      arma::mat sliceOutput, sliceDelta;
+      single.Forward(std::move(sliceInput), std::move(sliceOutput));
+      single.Backward(std::move(sliceInput), std::move(sliceError),
+          std::move(sliceDelta));
+
+      CheckMatrices(arma::mat(outputSlices.col(k)), sliceOutput, 1e-10);
+      CheckMatrices(arma::mat(deltaSlices.col(k)), sliceDelta, 1e-10);
+    }
+  }
+}
+
+/**
+ * Compare the output and the error routing of the MaxPooling layer with a
+ * direct computation, and make sure that nested forward passes (as done by
+ * recurrent networks) are backpropagated in reverse order.
+ */
+BOOST_AUTO_TEST_CASE(SimpleMaxPoolingLayerTest)
+{
+  const size_t width = 6, height = 4, depth = 3, batch = 2;
+  MaxPooling<> layer(2, 2, 2, 2);
+  layer.InputWidth() = width;
+  layer.InputHeight() = height;
+
+  arma::mat inputs[2], outputs[2];
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    inputs[pass] = arma::randu<arma::mat>(width * height * depth, batch);
+    layer.Forward(std::move(inputs[pass]), std::move(outputs[pass]));
+
+    BOOST_REQUIRE_EQUAL(outputs[pass].n_rows, 3 * 2 * depth);
+    BOOST_REQUIRE_EQUAL(outputs[pass].n_cols, batch);
+
+    arma::cube in(inputs[pass].memptr(), width, height, depth * batch);
+    arma::cube out(outputs[pass].memptr(), 3, 2, depth * batch);
+    for (size_t s = 0; s < in.n_slices; ++s)
+      for (size_t j = 0; j < 2; ++j)
+        for (size_t i = 0; i < 3; ++i)
+          BOOST_REQUIRE_EQUAL(out(i, j, s), in.slice(s).submat(2 * i, 2 * j,
+              2 * i + 1, 2 * j + 1).max());
+  }
+
+  // The last pass is backpropagated first.
+  for (size_t pass = 2; pass-- > 0; )
+  {
+    arma::mat error = arma::randu<arma::mat>(outputs[pass].n_rows, batch);
+    arma::mat g;
+    layer.Backward(std::move(inputs[pass]), std::move(error), std::move(g));
+
+    BOOST_REQUIRE_EQUAL(g.n_rows, inputs[pass].n_rows);
+    BOOST_REQUIRE_EQUAL(g.n_cols, batch);
+
+    // Every error goes to the maximum of its window; everything else is zero.
+    arma::cube in(inputs[pass].memptr(), width, height, depth * batch);
+    arma::cube err(error.memptr(), 3, 2, depth * batch);
+    arma::cube grad(g.memptr(), width, height, depth * batch);
+    for (size_t s = 0; s < in.n_slices; ++s)
+    {
+      for (size_t j = 0; j < 2; ++j)
+      {
+        for (size_t i = 0; i < 3; ++i)
+        {
+          const arma::mat window = in.slice(s).submat(2 * i, 2 * j, 2 * i + 1,
+              2 * j + 1);
+          const arma::mat gradWindow = grad.slice(s).submat(2 * i, 2 * j,
+              2 * i + 1, 2 * j + 1);
+          const arma::uword index = window.index_max();
+          BOOST_REQUIRE_CLOSE(gradWindow(index), err(i, j, s), 1e-10);
+          BOOST_REQUIRE_CLOSE(arma::accu(gradWindow), err(i, j, s), 1e-10);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Compare the output of the MeanPooling layer with a direct computation.
+ */
+BOOST_AUTO_TEST_CASE(SimpleMeanPoolingLayerTest)
+{
+  const size_t width = 6, height = 4, depth = 2, batch = 3;
+  MeanPooling<> layer(3, 2, 3, 2);
+  layer.InputWidth() = width;
+  layer.InputHeight() = height;
+
+  arma::mat input = arma::randu<arma::mat>(width * height * depth, batch);
+  arma::mat output;
+  layer.Forward(std::move(input), std::move(output));
+
+  BOOST_REQUIRE_EQUAL(output.n_rows, 2 * 2 * depth);
+  BOOST_REQUIRE_EQUAL(output.n_cols, batch);
+
+  arma::cube in(input.memptr(), width, height, depth * batch);
+  arma::cube out(output.memptr(), 2, 2, depth * batch);
+  for (size_t s = 0; s < in.n_slices; ++s)
+    for (size_t j = 0; j < 2; ++j)
+      for (size_t i = 0; i < 2; ++i)
+        BOOST_REQUIRE_CLOSE(out(i, j, s), arma::accu(in.slice(s).submat(3 * i,
+            2 * j, 3 * i + 2, 2 * j + 1)) / 6.0, 1e-10);
+}
+
 /**
  * Tests the BatchNorm Layer, compares the layers parameters with
  * the values from another implementation.
@@ -1629,6 +1936,218 @@ BOOST_AUTO_TEST_CASE(GradientAtrousConvolutionLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-3);
 }
 
+/**
+ * Make sure that the Convolution and AtrousConvolution layers give the same
+ * results with Im2ColConvolution as with the default NaiveConvolution rules,
+ * for several input and output maps and a batch of several samples.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColConvolutionLayerTest)
+{
+  typedef Im2ColConvolution<ValidConvolution> ValidRule;
+  typedef Im2ColConvolution<FullConvolution> FullRule;
+
+  arma::mat input = arma::randu<arma::mat>(7 * 6 * 2, 3);
+
+  // Convolution with padding.
+  {
+    Convolution<> naive(2, 3, 3, 3, 1, 1, 1, 1, 7, 6);
+    Convolution<ValidRule, FullRule, ValidRule> im2col(2, 3, 3, 3, 1, 1, 1, 1,
+        7, 6);
+    naive.Parameters().randu();
+    im2col.Parameters() = naive.Parameters();
+    naive.Reset();
+    im2col.Reset();
+
+    arma::mat naiveOutput, im2colOutput;
+    naive.Forward(std::move(arma::mat(input)), std::move(naiveOutput));
+    im2col.Forward(std::move(arma::mat(input)), std::move(im2colOutput));
+    CheckMatrices(naiveOutput, im2colOutput, 1e-5);
+
+    arma::mat error = arma::randu<arma::mat>(naiveOutput.n_rows,
+        naiveOutput.n_cols);
+    arma::mat naiveDelta, im2colDelta;
+    naive.Backward(std::move(arma::mat(input)), std::move(arma::mat(error)),
+        std::move(naiveDelta));
+    im2col.Backward(std::move(arma::mat(input)), std::move(arma::mat(error)),
+        std::move(im2colDelta));
+    CheckMatrices(naiveDelta, im2colDelta, 1e-5);
+
+    arma::mat naiveGradient, im2colGradient;
+    naive.Gradient(std::move(arma::mat(input)), std::move(arma::mat(error)),
+        std::move(naiveGradient));
+    im2col.Gradient(std::move(arma::mat(input)), std::move(arma::mat(error)),
+        std::move(im2colGradient));
+    CheckMatrices(naiveGradient, im2colGradient, 1e-5);
+  }
+
+  // Atrous convolution.
+  {
+    AtrousConvolution<> naive(2, 3, 3, 3, 1, 1, 0, 0, 7, 6, 2, 2);
+    AtrousConvolution<ValidRule, FullRule, ValidRule> im2col(2, 3, 3, 3, 1, 1,
+        0, 0, 7, 6, 2, 2);
+    naive.Parameters().randu();
+    im2col.Parameters() = naive.Parameters();
+    naive.Reset();
+    im2col.Reset();
+
+    arma::mat naiveOutput, im2colOutput;
+    naive.Forward(std::move(arma::mat(input)), std::move(naiveOutput));
+    im2col.Forward(std::move(arma::mat(input)), std::move(im2colOutput));
+    CheckMatrices(naiveOutput, im2colOutput, 1e-5);
+
+    arma::mat error = arma::randu<arma::mat>(naiveOutput.n_rows,
+        naiveOutput.n_cols);
+    arma::mat naiveDelta, im2colDelta;
+    naive.Backward(std::move(arma::mat(input)), std::move(arma::mat(error)),
+        std::move(naiveDelta));
+    im2col.Backward(std::move(arma::mat(input)), std::move(arma::mat(error)),
+        std::move(im2colDelta));
+    CheckMatrices(naiveDelta, im2colDelta, 1e-5);
+
+    arma::mat naiveGradient, im2colGradient;
+    naive.Gradient(std::move(arma::mat(input)), std::move(arma::mat(error)),
+        std::move(naiveGradient));
+    im2col.Gradient(std::move(arma::mat(input)), std::move(arma::mat(error)),
+        std::move(im2colGradient));
+    CheckMatrices(naiveGradient, im2colGradient, 1e-5);
+  }
+}
+
+/**
+ * Convolution layer with Im2ColConvolution numerical gradient test, with a
+ * stride larger than one.
+ */
+BOOST_AUTO_TEST_CASE(GradientIm2ColConvolutionLayerTest)
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>, Im2ColConvolution<ValidConvolution>,
+      arma::mat, arma::mat> Im2ColConvolutionLayer;
+
+  // Add function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::linspace<arma::colvec>(0, 35, 36) / 35.0;
+      target = arma::mat("1");
+
+      model = new FFN<NegativeLogLikelihood<>, RandomInitialization,
+          Im2ColConvolutionLayer>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<Im2ColConvolutionLayer>(1, 2, 3, 3, 2, 2, 1, 1, 6, 6);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, RandomInitialization,
+        Im2ColConvolutionLayer>* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-3);
+}
+
+/**
+ * Make sure that the QuantizedLinear layer gives nearly the same results as
+ * the Linear layer it is created from.
+ */
+BOOST_AUTO_TEST_CASE(QuantizedLinearLayerTest)
+{
+  Linear<> linear(20, 10);
+  linear.Parameters().randn();
+  linear.Reset();
+
+  arma::mat input = arma::randn<arma::mat>(20, 8);
+  QuantizedLinear<> quantized(arma::reshape(linear.Parameters().rows(0, 199),
+      10, 20), linear.Parameters().rows(200, 209), arma::abs(input).max());
+
+  arma::mat output, quantizedOutput;
+  linear.Forward(std::move(arma::mat(input)), std::move(output));
+  quantized.Forward(std::move(arma::mat(input)), std::move(quantizedOutput));
+  BOOST_REQUIRE_EQUAL(quantizedOutput.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(quantizedOutput.n_cols, 8);
+  BOOST_REQUIRE_LE(arma::abs(output - quantizedOutput).max(),
+      0.02 * arma::abs(output).max());
+
+  arma::mat error = arma::randn<arma::mat>(10, 8);
+  arma::mat delta, quantizedDelta;
+  linear.Backward(std::move(arma::mat(input)), std::move(arma::mat(error)),
+      std::move(delta));
+  quantized.Backward(std::move(arma::mat(input)), std::move(arma::mat(error)),
+      std::move(quantizedDelta));
+  BOOST_REQUIRE_LE(arma::abs(delta - quantizedDelta).max(),
+      0.02 * arma::abs(delta).max());
+}
+
+/**
+ * Make sure that the QuantizedConvolution layer gives nearly the same results
+ * as the Convolution layer it is created from, with padding and with a stride
+ * larger than one.
+ */
+BOOST_AUTO_TEST_CASE(QuantizedConvolutionLayerTest)
+{
+  arma::mat input = arma::randn<arma::mat>(7 * 6 * 2, 3);
+
+  // Convolution with padding.
+  {
+    Convolution<> convolution(2, 3, 3, 3, 1, 1, 1, 1, 7, 6);
+    convolution.Parameters().randn();
+    convolution.Reset();
+    QuantizedConvolution<> quantized(2, 3, 3, 3, 1, 1, 1, 1, 7, 6,
+        convolution.Parameters(), arma::abs(input).max());
+
+    arma::mat output, quantizedOutput;
+    convolution.Forward(std::move(arma::mat(input)), std::move(output));
+    quantized.Forward(std::move(arma::mat(input)), std::move(quantizedOutput));
+    BOOST_REQUIRE_EQUAL(quantized.OutputWidth(), convolution.OutputWidth());
+    BOOST_REQUIRE_EQUAL(quantized.OutputHeight(), convolution.OutputHeight());
+    BOOST_REQUIRE_EQUAL(quantizedOutput.n_rows, output.n_rows);
+    BOOST_REQUIRE_EQUAL(quantizedOutput.n_cols, output.n_cols);
+    BOOST_REQUIRE_LE(arma::abs(output - quantizedOutput).max(),
+        0.02 * arma::abs(output).max());
+
+    arma::mat error = arma::randn<arma::mat>(output.n_rows, output.n_cols);
+    arma::mat delta, quantizedDelta;
+    convolution.Backward(std::move(arma::mat(input)),
+        std::move(arma::mat(error)), std::move(delta));
+    quantized.Backward(std::move(arma::mat(input)),
+        std::move(arma::mat(error)), std::move(quantizedDelta));
+    BOOST_REQUIRE_LE(arma::abs(delta - quantizedDelta).max(),
+        0.02 * arma::abs(delta).max());
+  }
+
+  // Convolution with a stride of two.
+  {
+    Convolution<> convolution(2, 3, 3, 3, 2, 2, 0, 0, 7, 6);
+    convolution.Parameters().randn();
+    convolution.Reset();
+    QuantizedConvolution<> quantized(2, 3, 3, 3, 2, 2, 0, 0, 7, 6,
+        convolution.Parameters(), arma::abs(input).max());
+
+    arma::mat output, quantizedOutput;
+    convolution.Forward(std::move(arma::mat(input)), std::move(output));
+    quantized.Forward(std::move(arma::mat(input)), std::move(quantizedOutput));
+    BOOST_REQUIRE_EQUAL(quantizedOutput.n_rows, output.n_rows);
+    BOOST_REQUIRE_EQUAL(quantizedOutput.n_cols, output.n_cols);
+    BOOST_REQUIRE_LE(arma::abs(output - quantizedOutput).max(),
+        0.02 * arma::abs(output).max());
+  }
+}
+
 /**
  * Tests the LayerNorm layer.
  */
@@ -2028,4 +2547,198 @@ BOOST_AUTO_TEST_CASE(GradientReparametrizationLayerBetaTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * Check the gradients of a network whose elementwise layers run in place.
+ * The sigmoid and the constant multiplication overwrite the output of the
+ * linear layer before them, and the rectifier only shares its delta, since the
+ * sigmoid needs its own output for the backward pass.
+ */
+BOOST_AUTO_TEST_CASE(GradientInPlaceLayersTest)
+{
+  // In-place layers function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(10, 1);
+      target = arma::mat("2");
+
+      model = new FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<Linear<> >(10, 8);
+      model->Add<SigmoidLayer<> >();
+      model->Add<ReLULayer<> >();
+      model->Add<Linear<> >(8, 5);
+      model->Add<MultiplyConstant<> >(2.0);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
+}
+
+/**
+ * The log-probabilities of the hierarchical softmax sum to one, and the
+ * training loss is the negative log-probability of the target.
+ */
+BOOST_AUTO_TEST_CASE(HierarchicalSoftmaxTest)
+{
+  arma::vec frequencies("5 1 1 3 8 2 1");
+  HierarchicalSoftmax<> module(5, 7, frequencies);
+  module.Parameters().randn();
+  arma::mat input = arma::randn(5, 4);
+  arma::mat logProbabilities, output;
+
+  // The most frequent class has the shortest path.
+  for (size_t c = 0; c < 7; ++c)
+    BOOST_REQUIRE_LE(module.PathLength(4), module.PathLength(c));
+
+  module.Deterministic() = true;
+  module.Forward(std::move(input), std::move(logProbabilities));
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_rows, 7);
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_cols, 4);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(arma::accu(arma::exp(logProbabilities.col(i))), 1.0,
+        1e-8);
+  }
+
+  module.Deterministic() = false;
+  module.Target() = arma::mat("3 7 1 5");
+  module.Forward(std::move(input), std::move(output));
+  BOOST_REQUIRE_EQUAL(output.n_rows, 1);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const size_t target = (size_t) module.Target()(i) - 1;
+    BOOST_REQUIRE_CLOSE(output(i), -logProbabilities(target, i), 1e-8);
+  }
+}
+
+/**
+ * HierarchicalSoftmax numerical gradient test.
+ */
+BOOST_AUTO_TEST_CASE(GradientHierarchicalSoftmaxTest)
+{
+  // HierarchicalSoftmax function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(10, 1);
+      target = arma::mat("4");
+
+      model = new FFN<LargeSoftmaxLoss<>, NguyenWidrowInitialization,
+          HierarchicalSoftmax<> >();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<Linear<> >(10, 6);
+      model->Add<SigmoidLayer<> >();
+      model->Add<HierarchicalSoftmax<> >(6, 9);
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      // Evaluate() runs the exact (deterministic) loss.
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<LargeSoftmaxLoss<>, NguyenWidrowInitialization,
+        HierarchicalSoftmax<> >* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
+}
+
+/**
+ * The log-probabilities of the sampled softmax sum to one, and for a fixed
+ * sample the gradients of the training loss match finite differences.
+ */
+BOOST_AUTO_TEST_CASE(SampledSoftmaxTest)
+{
+  arma::vec proposal = arma::linspace<arma::vec>(1, 20, 20);
+  SampledSoftmax<> module(4, 20, 6, proposal);
+  module.Parameters().randn();
+  module.Gradient().set_size(5, 20);
+  arma::mat input = arma::randn(4, 3);
+  arma::mat output, delta;
+
+  module.Deterministic() = true;
+  module.Forward(std::move(input), std::move(output));
+  BOOST_REQUIRE_EQUAL(output.n_rows, 20);
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(arma::accu(arma::exp(output.col(i))), 1.0, 1e-8);
+
+  // Draw the same classes for every evaluation.
+  module.Deterministic() = false;
+  module.Target() = arma::mat("2 20 11");
+  auto loss = [&]()
+  {
+    math::RandomSeed(7);
+    module.Forward(std::move(input), std::move(output));
+    return arma::accu(output);
+  };
+
+  loss();
+  BOOST_REQUIRE_EQUAL(output.n_rows, 1);
+  arma::mat gy = arma::ones(1, 3);
+  module.Backward(std::move(output), std::move(gy), std::move(delta));
+  module.Gradient(std::move(input), std::move(gy),
+      std::move(module.Gradient()));
+  const arma::mat gradient = module.Gradient();
+
+  const double perturbation = 1e-6;
+  for (size_t i = 0; i < module.Parameters().n_elem; ++i)
+  {
+    const double original = module.Parameters()[i];
+    module.Parameters()[i] = original + perturbation;
+    const double plus = loss();
+    module.Parameters()[i] = original - perturbation;
+    const double minus = loss();
+    module.Parameters()[i] = original;
+
+    BOOST_REQUIRE_SMALL((plus - minus) / (2 * perturbation) - gradient[i],
+        1e-5);
+  }
+
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    const double original = input[i];
+    input[i] = original + perturbation;
+    const double plus = loss();
+    input[i] = original - perturbation;
+    const double minus = loss();
+    input[i] = original;
+
+    BOOST_REQUIRE_SMALL((plus - minus) / (2 * perturbation) - delta[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -219,4 +219,72 @@ BOOST_AUTO_TEST_CASE(NStepQLearningTest)
   Log::Debug << "Total test episodes: " << testEpisodes << std::endl;
 }
 
+/**
+ * Run steps of the given worker until it updates the learning network, and
+ * make sure that the local network of the worker uses the updated weights.
+ */
+template<typename WorkerType>
+void CheckWorkerSync()
+{
+  FFN<MeanSquaredError<>, GaussianInitialization> learningNetwork(
+      MeanSquaredError<>(), GaussianInitialization(0, 0.1));
+  learningNetwork.Add<Linear<>>(4, 8);
+  learningNetwork.Add<ReLULayer<>>();
+  learningNetwork.Add<Linear<>>(8, 2);
+  learningNetwork.ResetParameters();
+
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.99;
+  config.UpdateInterval() = 1;
+  config.StepLimit() = 200;
+  config.TargetNetworkSyncInterval() = 200;
+  config.GradientLimit() = 40;
+
+  WorkerType worker(VanillaUpdate(), CartPole(), config, false);
+  worker.Initialize(learningNetwork);
+
+  const arma::colvec input("0.1 -0.2 0.3 -0.4");
+  arma::colvec before, learningOutput, workerOutput;
+  learningNetwork.Predict(input, before);
+  worker.Network().Predict(input, workerOutput);
+  CheckMatrices(before, workerOutput);
+
+  const arma::mat initialParameters = learningNetwork.Parameters();
+  arma::mat targetParameters = learningNetwork.Parameters();
+  size_t version = 0, totalSteps = 0;
+  double totalReward;
+  GreedyPolicy<CartPole> policy(0.7, 5000, 0.1);
+  for (size_t i = 0; i < 10 && arma::approx_equal(initialParameters,
+      learningNetwork.Parameters(), "absdiff", 0.0); ++i)
+  {
+    worker.Step(learningNetwork, targetParameters, version, totalSteps, policy,
+        totalReward);
+  }
+  BOOST_REQUIRE(!arma::approx_equal(initialParameters,
+      learningNetwork.Parameters(), "absdiff", 0.0));
+
+  learningNetwork.Predict(input, learningOutput);
+  worker.Network().Predict(input, workerOutput);
+  BOOST_REQUIRE_GT(arma::abs(workerOutput - before).max(), 0.0);
+  CheckMatrices(learningOutput, workerOutput);
+}
+
+/**
+ * Make sure that the workers use the weights of the learning network after an
+ * update.
+ */
+BOOST_AUTO_TEST_CASE(WorkerNetworkSyncTest)
+{
+  using Network = FFN<MeanSquaredError<>, GaussianInitialization>;
+  using Policy = GreedyPolicy<CartPole>;
+
+  CheckWorkerSync<OneStepQLearningWorker<CartPole, Network, VanillaUpdate,
+      Policy>>();
+  CheckWorkerSync<OneStepSarsaWorker<CartPole, Network, VanillaUpdate,
+      Policy>>();
+  CheckWorkerSync<NStepQLearningWorker<CartPole, Network, VanillaUpdate,
+      Policy>>();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -132,4 +132,28 @@ BOOST_AUTO_TEST_CASE(BBSArmijoLogisticRegressionTest)
   }
 }
 
+/**
+ * Run big-batch SGD using BBS_BB on logistic regression with the gradients of
+ * each batch computed in parallel, and make sure the results are acceptable.
+ */
+BOOST_AUTO_TEST_CASE(BBSBBParallelLogisticRegressionTest)
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  CreateLogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  BBS_BB bbsgd(30, 0.01, 0.1, 6000, 1e-3, true, true);
+  BOOST_REQUIRE(bbsgd.Parallel());
+  LogisticRegression<> lr(shuffledData, shuffledResponses, bbsgd, 0.5);
+
+  // Ensure that the error is close to zero.
+  const double acc = lr.ComputeAccuracy(data, responses);
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 0.3); // 0.3% error tolerance.
+
+  const double testAcc = lr.ComputeAccuracy(testData, testResponses);
+  BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
+}
+
 BOOST_AUTO_TEST_SUITE_END();
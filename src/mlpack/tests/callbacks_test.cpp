@@ -0,0 +1,143 @@
+/**
+ * @file callbacks_test.cpp
+ *
+ * Tests for the optimizer callbacks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
+#include <mlpack/core/optimizers/callbacks/validation_early_stopping.hpp>
+#include <mlpack/core/optimizers/problems/generalized_rosenbrock_function.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::optimization::test;
+
+/**
+ * A callback that counts the events it sees and asks to stop after a given
+ * number of epochs or steps.
+ */
+class CountingCallback : public Callback
+{
+ public:
+  CountingCallback(const size_t maxEpochs, const size_t maxSteps) :
+      maxEpochs(maxEpochs), maxSteps(maxSteps), begins(0), evaluations(0),
+      steps(0), epochs(0), ends(0) { }
+
+  void BeginOptimization(const arma::mat& /* iterate */) { ++begins; }
+
+  bool Evaluate(const arma::mat& /* iterate */, const double /* objective */)
+  {
+    ++evaluations;
+    return false;
+  }
+
+  bool StepTaken(const arma::mat& /* iterate */, const double /* objective */)
+  {
+    return (++steps == maxSteps);
+  }
+
+  bool EndEpoch(const arma::mat& /* iterate */,
+                const size_t epoch,
+                const double /* objective */)
+  {
+    BOOST_REQUIRE_EQUAL(epoch, epochs + 1);
+    return (++epochs == maxEpochs);
+  }
+
+  void EndOptimization(arma::mat& /* iterate */) { ++ends; }
+
+  size_t maxEpochs;
+  size_t maxSteps;
+  size_t begins;
+  size_t evaluations;
+  size_t steps;
+  size_t epochs;
+  size_t ends;
+};
+
+BOOST_AUTO_TEST_SUITE(CallbacksTest);
+
+/**
+ * Make sure SGD passes every event to the callbacks and stops when a callback
+ * asks for it at the end of an epoch.
+ */
+BOOST_AUTO_TEST_CASE(SGDEndEpochTerminationTest)
+{
+  GeneralizedRosenbrockFunction f(10);
+  StandardSGD s(0.0001, 1, 0, -1.0, false);
+  CountingCallback callback(3, 0);
+  s.Callbacks().Add(callback);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_EQUAL(callback.begins, 1);
+  BOOST_REQUIRE_EQUAL(callback.ends, 1);
+  BOOST_REQUIRE_EQUAL(callback.epochs, 3);
+  BOOST_REQUIRE_EQUAL(callback.steps, 3 * f.NumFunctions());
+  BOOST_REQUIRE_EQUAL(callback.evaluations, 3 * f.NumFunctions());
+}
+
+/**
+ * Make sure L-BFGS stops when a callback asks for it after a step.
+ */
+BOOST_AUTO_TEST_CASE(LBFGSStepTakenTerminationTest)
+{
+  GeneralizedRosenbrockFunction f(10);
+  L_BFGS lbfgs;
+  CountingCallback callback(0, 4);
+  lbfgs.Callbacks().Add(callback);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  lbfgs.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_EQUAL(callback.begins, 1);
+  BOOST_REQUIRE_EQUAL(callback.ends, 1);
+  BOOST_REQUIRE_EQUAL(callback.steps, 4);
+  BOOST_REQUIRE_EQUAL(callback.evaluations, 1);
+}
+
+/**
+ * Make sure the validation callback stops after the given patience and
+ * restores the point with the best validation objective.
+ */
+BOOST_AUTO_TEST_CASE(ValidationEarlyStoppingTest)
+{
+  // The validation objective improves for three epochs, then gets worse.
+  const double values[] = { 5.0, 4.0, 3.0, 3.5, 4.0, 5.0, 6.0, 7.0, 8.0 };
+  std::vector<arma::mat> validated;
+  ValidationEarlyStopping earlyStopping([&](const arma::mat& parameters)
+      {
+        validated.push_back(parameters);
+        return values[validated.size() - 1];
+      }, 2);
+
+  GeneralizedRosenbrockFunction f(10);
+  StandardSGD s(0.0001, 1, 0, -1.0, false);
+  s.Callbacks().Add(earlyStopping);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates);
+
+  // The validation of epoch 5 is the second without improvement; it is
+  // collected at the end of epoch 6, which stops the optimization.
+  BOOST_REQUIRE_EQUAL(earlyStopping.Objectives().size(), 5);
+  BOOST_REQUIRE_EQUAL(validated.size(), 5);
+  BOOST_REQUIRE_EQUAL(earlyStopping.BestEpoch(), 3);
+  BOOST_REQUIRE_CLOSE(earlyStopping.BestObjective(), 3.0, 1e-10);
+
+  BOOST_REQUIRE_EQUAL(coordinates.n_elem, validated[2].n_elem);
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(coordinates[i], validated[2][i]);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
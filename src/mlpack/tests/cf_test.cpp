@@ -13,6 +13,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/cf/cf.hpp>
+#include <mlpack/methods/cf/decomposition_policies/als_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/batch_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/bias_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/randomized_svd_method.hpp>
@@ -32,6 +33,7 @@
 #include <mlpack/methods/cf/interpolation_policies/average_interpolation.hpp>
 #include <mlpack/methods/cf/interpolation_policies/similarity_interpolation.hpp>
 #include <mlpack/methods/cf/interpolation_policies/regression_interpolation.hpp>
+#include <mlpack/methods/cf/ranking_policies/fastmks_ranking.hpp>
 
 #include <iostream>
 
@@ -225,10 +227,9 @@ template<typename DecompositionPolicy,
          typename NormalizationType = NoNormalization,
          typename NeighborSearchPolicy = EuclideanSearch,
          typename InterpolationPolicy = AverageInterpolation>
-void CFPredict(const double rmseBound = 2.0)
+void CFPredict(DecompositionPolicy& decomposition,
+               const double rmseBound = 2.0)
 {
-  DecompositionPolicy decomposition;
-
   // Small GroupLens dataset.
   arma::mat dataset;
 
@@ -258,6 +259,19 @@ void CFPredict(const double rmseBound = 2.0)
   BOOST_REQUIRE_LT(rmse, rmseBound);
 }
 
+// Do the same thing as the previous test, with a default-constructed
+// decomposition policy.
+template<typename DecompositionPolicy,
+         typename NormalizationType = NoNormalization,
+         typename NeighborSearchPolicy = EuclideanSearch,
+         typename InterpolationPolicy = AverageInterpolation>
+void CFPredict(const double rmseBound = 2.0)
+{
+  DecompositionPolicy decomposition;
+  CFPredict<DecompositionPolicy, NormalizationType, NeighborSearchPolicy,
+      InterpolationPolicy>(decomposition, rmseBound);
+}
+
 // Do the same thing as the previous test, but ensure that the ratings we
 // predict with the batch Predict() are the same as the individual Predict()
 // calls.
@@ -791,6 +805,45 @@ BOOST_AUTO_TEST_CASE(CFPredictSVDPPTest)
   CFPredict<SVDPlusPlusPolicy>();
 }
 
+/**
+ * Make sure that Predict() is returning reasonable results for alternating
+ * least squares.
+ */
+BOOST_AUTO_TEST_CASE(CFPredictALSTest)
+{
+  CFPredict<ALSPolicy>();
+}
+
+/**
+ * Make sure that Predict() is returning reasonable results for regularized SVD
+ * optimized with DSGD.
+ */
+BOOST_AUTO_TEST_CASE(CFPredictParallelRegSVDTest)
+{
+  RegSVDPolicy decomposition(10, true);
+  CFPredict(decomposition);
+}
+
+/**
+ * Make sure that Predict() is returning reasonable results for Bias SVD
+ * optimized with DSGD.
+ */
+BOOST_AUTO_TEST_CASE(CFPredictParallelBiasSVDTest)
+{
+  BiasSVDPolicy decomposition(10, 0.02, 0.05, true);
+  CFPredict(decomposition);
+}
+
+/**
+ * Make sure that Predict() is returning reasonable results for SVDPlusPlus
+ * optimized with DSGD.
+ */
+BOOST_AUTO_TEST_CASE(CFPredictParallelSVDPPTest)
+{
+  SVDPlusPlusPolicy decomposition(10, 0.001, 0.1, true);
+  CFPredict(decomposition);
+}
+
 // Compare batch Predict() and individual Predict() for randomized SVD.
 BOOST_AUTO_TEST_CASE(CFBatchPredictRandSVDTest)
 {
@@ -1223,4 +1276,146 @@ BOOST_AUTO_TEST_CASE(CFPredictRegressionInterpolation)
             RegressionInterpolation>();
 }
 
+/**
+ * Make sure that the recommendations found with FastMKSRanking are the same as
+ * those found by scoring every item.
+ */
+template<typename DecompositionPolicy>
+void FastMKSRankingRecommendations()
+{
+  DecompositionPolicy decomposition;
+
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  arma::Col<size_t> users(30);
+  for (size_t i = 0; i < users.n_elem; ++i)
+    users(i) = i;
+
+  arma::Mat<size_t> recommendations, mipsRecommendations;
+  c.GetRecommendations(10, recommendations, users);
+
+  FastMKSRanking ranking(c.Decomposition());
+  c.GetRecommendations(10, mipsRecommendations, users, ranking);
+
+  BOOST_REQUIRE_EQUAL(mipsRecommendations.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(mipsRecommendations.n_cols, users.n_elem);
+
+  // Allow for a few differences from near-ties between predicted ratings.
+  size_t differences = 0;
+  for (size_t i = 0; i < recommendations.n_elem; ++i)
+    if (recommendations[i] != mipsRecommendations[i])
+      ++differences;
+  BOOST_REQUIRE_LE(differences, recommendations.n_elem / 20);
+}
+
+BOOST_AUTO_TEST_CASE(FastMKSRankingRegSVDTest)
+{
+  FastMKSRankingRecommendations<RegSVDPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(FastMKSRankingBiasSVDTest)
+{
+  FastMKSRankingRecommendations<BiasSVDPolicy>();
+}
+
+/**
+ * Make sure the normalizations that depend on the item, which can't be used
+ * with a ranking policy, are recognized.
+ */
+BOOST_AUTO_TEST_CASE(NormalizationItemDependenceTest)
+{
+  BOOST_REQUIRE(!NormalizationTraits<NoNormalization>::IsItemDependent);
+  BOOST_REQUIRE(!NormalizationTraits<UserMeanNormalization>::IsItemDependent);
+  BOOST_REQUIRE(!NormalizationTraits<ZScoreNormalization>::IsItemDependent);
+  BOOST_REQUIRE(NormalizationTraits<ItemMeanNormalization>::IsItemDependent);
+  BOOST_REQUIRE(!NormalizationTraits<CombinedNormalization<
+      OverallMeanNormalization, UserMeanNormalization>>::IsItemDependent);
+  BOOST_REQUIRE(NormalizationTraits<CombinedNormalization<
+      OverallMeanNormalization, ItemMeanNormalization>>::IsItemDependent);
+}
+
+/**
+ * Fold the ratings of an existing user into the model as those of a new user,
+ * and make sure that the new user's factors fit its ratings at least as well
+ * as those of the original user.
+ */
+template<typename DecompositionPolicy>
+void UpdateNewUser()
+{
+  DecompositionPolicy decomposition;
+
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy> c(dataset, decomposition, 5, 5, 30);
+  const size_t numUsers = c.CleanedData().n_cols;
+  const size_t numItems = c.CleanedData().n_rows;
+
+  const arma::uvec userRatings = arma::find(dataset.row(0) == 0);
+  arma::mat newRatings = dataset.cols(userRatings);
+  newRatings.row(0).fill(numUsers);
+  c.Update(newRatings);
+
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_cols, numUsers + 1);
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_rows, numItems);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().H().n_cols, numUsers + 1);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().W().n_rows, numItems);
+
+  double oldError = 0.0, newError = 0.0;
+  for (size_t i = 0; i < newRatings.n_cols; ++i)
+  {
+    const size_t item = (size_t) newRatings(1, i);
+    oldError += std::pow(c.Decomposition().GetRating(0, item) -
+        newRatings(2, i), 2.0);
+    newError += std::pow(c.Decomposition().GetRating(numUsers, item) -
+        newRatings(2, i), 2.0);
+  }
+
+  BOOST_REQUIRE(arma::is_finite(c.Decomposition().H()));
+  BOOST_REQUIRE_LE(std::sqrt(newError / newRatings.n_cols),
+      std::sqrt(oldError / newRatings.n_cols) + 0.05);
+}
+
+BOOST_AUTO_TEST_CASE(UpdateNewUserNMFTest)
+{
+  UpdateNewUser<NMFPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(UpdateNewUserRegSVDTest)
+{
+  UpdateNewUser<RegSVDPolicy>();
+}
+
+/**
+ * Make sure that the online SGD epochs of RegSVDPolicy::Update() add new users
+ * and items to the model.
+ */
+BOOST_AUTO_TEST_CASE(UpdateOnlineRegSVDTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  RegSVDPolicy decomposition;
+  decomposition.OnlineUpdate() = true;
+  CFType<RegSVDPolicy> c(dataset, decomposition, 5, 5, 30);
+  const size_t numUsers = c.CleanedData().n_cols;
+  const size_t numItems = c.CleanedData().n_rows;
+
+  // A new user rates an existing item and a new item.
+  arma::mat newRatings("0 0; 0 0; 4 5");
+  newRatings.row(0).fill(numUsers);
+  newRatings(1, 1) = numItems;
+  c.Update(newRatings, 10);
+
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_cols, numUsers + 1);
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_rows, numItems + 1);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().H().n_cols, numUsers + 1);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().W().n_rows, numItems + 1);
+  BOOST_REQUIRE(arma::is_finite(c.Decomposition().W()));
+  BOOST_REQUIRE(arma::is_finite(c.Decomposition().H()));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
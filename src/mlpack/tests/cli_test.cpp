@@ -25,9 +25,12 @@ using Option = mlpack::bindings::cli::CLIOption<T>;
 static const std::string testName = "";
 
 #include <mlpack/core/util/param.hpp>
+#include <mlpack/core/util/binding_context.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
 
+#include <thread>
+
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -1125,4 +1128,121 @@ BOOST_AUTO_TEST_CASE(CppNameTest)
   BOOST_REQUIRE_EQUAL(CLI::Parameters().at("double").cppType, "double");
 }
 
+/**
+ * Make sure that each thread has its own parameters, and that settings stored
+ * in one thread can be restored in the others.
+ */
+BOOST_AUTO_TEST_CASE(ThreadSettingsTest)
+{
+  AddRequiredCLIOptions();
+
+  PARAM_INT_IN("thread_int", "Test int.", "", 0);
+  CLI::StoreSettings("thread_test");
+
+  std::vector<int> values(4, -1);
+  std::vector<int> hadParam(4, 1);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.push_back(std::thread([t, &values, &hadParam]()
+    {
+      // A new thread starts without any parameters.
+      hadParam[t] = (int) CLI::Parameters().count("thread_int");
+
+      CLI::RestoreSettings("thread_test");
+      CLI::GetParam<int>("thread_int") = t;
+      CLI::SetPassed("thread_int");
+
+      // Give the other threads time to set their own value.
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      values[t] = CLI::HasParam("thread_int") ?
+          CLI::GetParam<int>("thread_int") : -1;
+
+      CLI::ClearSettings();
+    }));
+  }
+
+  for (size_t t = 0; t < threads.size(); ++t)
+    threads[t].join();
+
+  for (int t = 0; t < 4; ++t)
+  {
+    BOOST_REQUIRE_EQUAL(hadParam[t], 0);
+    BOOST_REQUIRE_EQUAL(values[t], t);
+  }
+
+  // The stored settings were not modified by the threads.
+  CLI::RestoreSettings("thread_test");
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<int>("thread_int"), 0);
+  BOOST_REQUIRE(!CLI::HasParam("thread_int"));
+  CLI::ClearSettings();
+}
+
+/**
+ * Make sure that binding contexts hold their own parameters, both when they are
+ * used one after the other in the same thread and when they are used in
+ * different threads.
+ */
+BOOST_AUTO_TEST_CASE(BindingContextTest)
+{
+  AddRequiredCLIOptions();
+
+  PARAM_INT_IN("context_int", "Test int.", "", 0);
+  PARAM_INT_OUT("context_out", "Test output int.");
+  CLI::StoreSettings("context_test");
+  CLI::ClearSettings();
+
+  // Two contexts used alternately in this thread.
+  util::BindingContext a("context_test");
+  util::BindingContext b("context_test");
+  a.GetParam<int>("context_int") = 3;
+  a.SetPassed("context_int");
+  BOOST_REQUIRE(a.HasParam("context_int"));
+  BOOST_REQUIRE(!b.HasParam("context_int"));
+  BOOST_REQUIRE_EQUAL(b.GetParam<int>("context_int"), 0);
+
+  // The parameters of the thread are not those of the contexts.
+  BOOST_REQUIRE_EQUAL(CLI::Parameters().count("context_int"), 0);
+
+  // Scoped contexts nest.
+  {
+    util::ScopedBindingContext scopeA(a);
+    BOOST_REQUIRE_EQUAL(CLI::GetParam<int>("context_int"), 3);
+    {
+      util::ScopedBindingContext scopeB(b);
+      BOOST_REQUIRE_EQUAL(CLI::GetParam<int>("context_int"), 0);
+    }
+    BOOST_REQUIRE_EQUAL(CLI::GetParam<int>("context_int"), 3);
+  }
+  BOOST_REQUIRE_EQUAL(CLI::Parameters().count("context_int"), 0);
+
+  // Run a "binding" in each context, in parallel.
+  auto run = []()
+  {
+    CLI::GetParam<int>("context_out") = 2 * CLI::GetParam<int>("context_int");
+  };
+
+  std::vector<std::unique_ptr<util::BindingContext>> contexts;
+  for (int t = 0; t < 4; ++t)
+  {
+    contexts.emplace_back(new util::BindingContext("context_test"));
+    contexts[t]->GetParam<int>("context_int") = t;
+    contexts[t]->SetPassed("context_int");
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.push_back(std::thread([&contexts, &run, t]()
+        { contexts[t]->Run(run); }));
+  for (size_t t = 0; t < threads.size(); ++t)
+    threads[t].join();
+
+  for (int t = 0; t < 4; ++t)
+    BOOST_REQUIRE_EQUAL(contexts[t]->GetParam<int>("context_out"), 2 * t);
+
+  // A context can't be created from settings that don't exist.
+  BOOST_REQUIRE_THROW(util::BindingContext("no_such_settings"),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
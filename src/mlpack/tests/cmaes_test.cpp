@@ -45,6 +45,32 @@ BOOST_AUTO_TEST_CASE(SimpleTestFunction)
   BOOST_REQUIRE_SMALL(coordinates[2], 0.003);
 }
 
+/**
+ * Run CMA-ES with parallel evaluation of the offspring on the simple test
+ * function, both with the shared function and with a copy per thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelEvaluationTestFunction)
+{
+  SGDTestFunction f;
+  CMAES<> optimizer(0, -1, 1, 32, 200, -1, FullSelection(),
+      PARALLEL_EVALUATION);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  optimizer.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_SMALL(coordinates[0], 0.003);
+  BOOST_REQUIRE_SMALL(coordinates[1], 0.003);
+  BOOST_REQUIRE_SMALL(coordinates[2], 0.003);
+
+  optimizer.Evaluation() = PARALLEL_COPY_EVALUATION;
+  coordinates = f.GetInitialPoint();
+  optimizer.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_SMALL(coordinates[0], 0.003);
+  BOOST_REQUIRE_SMALL(coordinates[1], 0.003);
+  BOOST_REQUIRE_SMALL(coordinates[2], 0.003);
+}
+
 /**
  * Create the data for the logistic regression test case.
  */
@@ -151,6 +151,41 @@ BOOST_AUTO_TEST_CASE(CNELogisticRegressionTest)
   BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
 }
 
+/**
+ * Train logistic regression with the steady-state variant of CNE, evaluating
+ * the candidates in parallel with copies of the objective function.
+ */
+BOOST_AUTO_TEST_CASE(CNESteadyStateParallelLogisticRegressionTest)
+{
+  // Generate a two-Gaussian dataset.
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("9.0 9.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(3, 1000);
+  arma::Row<size_t> responses(1000);
+  arma::mat testData(3, 1000);
+  arma::Row<size_t> testResponses(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const bool second = (i % 2 == 1);
+    data.col(i) = second ? g2.Random() : g1.Random();
+    responses[i] = second;
+    testData.col(i) = second ? g2.Random() : g1.Random();
+    testResponses[i] = second;
+  }
+
+  CNE opt(200, 10000, 0.2, 0.2, 0.3, 65, -1, PARALLEL_COPY_EVALUATION, true);
+
+  LogisticRegression<> lr(data, responses, opt, 0.5);
+
+  // Ensure that the error is close to zero.
+  const double acc = lr.ComputeAccuracy(data, responses);
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 0.3); // 0.3% error tolerance.
+
+  const double testAcc = lr.ComputeAccuracy(testData, testResponses);
+  BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
+}
+
 /**
  * Training a vanilla network on a larger dataset using CNE optimizer.
  */
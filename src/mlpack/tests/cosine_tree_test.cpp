@@ -222,4 +222,47 @@ BOOST_AUTO_TEST_CASE(CosineTreeModifiedGramSchmidt)
   }
 }
 
+/**
+ * Make sure that the basis built by the cosine tree is orthonormal, and that
+ * it captures most of a low-rank dataset.
+ */
+BOOST_AUTO_TEST_CASE(CosineTreeBasisTest)
+{
+  // A rank-10 dataset with some noise.
+  arma::mat data = arma::randn(40, 10) * arma::randn(10, 2000) +
+      0.01 * arma::randn(40, 2000);
+
+  // The Monte Carlo error estimate is random, so the basis may miss part of
+  // the dataset; we require at least one success out of three.
+  size_t successes = 0;
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    CosineTree ctree(data, 0.01, 0.1);
+
+    arma::mat basis;
+    ctree.GetFinalBasis(basis);
+    BOOST_REQUIRE_EQUAL(basis.n_rows, data.n_rows);
+    BOOST_REQUIRE_GT(basis.n_cols, 0);
+
+    // Every vector is either zero or of unit norm, and orthogonal to the
+    // others.
+    const arma::mat products = basis.t() * basis;
+    for (size_t i = 0; i < basis.n_cols; ++i)
+    {
+      if (products(i, i) != 0.0)
+        BOOST_REQUIRE_CLOSE(products(i, i), 1.0, 1e-5);
+      for (size_t j = 0; j < i; ++j)
+        BOOST_REQUIRE_SMALL(products(i, j), 1e-5);
+    }
+
+    // The projection onto the basis should keep nearly all of the dataset.
+    const arma::mat residual = data - basis * (basis.t() * data);
+    if (arma::accu(arma::square(residual)) <
+        0.05 * arma::accu(arma::square(data)))
+      ++successes;
+  }
+
+  BOOST_REQUIRE_GT(successes, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
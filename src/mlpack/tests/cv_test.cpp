@@ -465,6 +465,75 @@ BOOST_AUTO_TEST_CASE(KFoldCVWithWeightedLRTest)
   BOOST_REQUIRE_CLOSE(1.0 - mse, 1.0, 1e-5);
 }
 
+/**
+ * Test that evaluating the folds in parallel gives the same result as
+ * evaluating them one at a time.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVParallelTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 100);
+  arma::rowvec responses = arma::randu<arma::rowvec>(3) * data +
+      0.1 * arma::randn<arma::rowvec>(100);
+
+  KFoldCV<LinearRegression, MSE> cv(5, data, responses, false);
+  const double serialMSE = cv.Evaluate(0.01);
+
+  cv.Parallel() = true;
+  const double parallelMSE = cv.Evaluate(0.01);
+
+  BOOST_REQUIRE_CLOSE(serialMSE, parallelMSE, 1e-5);
+
+  // The model of the last fold should be kept in both cases.
+  cv.Model();
+}
+
+/**
+ * Test that shuffling the data of k-fold cross-validation in place keeps the
+ * data points, responses, and weights together.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVInPlaceShuffleTest)
+{
+  arma::mat data = arma::randu<arma::mat>(1, 23);
+  arma::rowvec responses = 2 * data;
+  arma::rowvec weights = arma::ones<arma::rowvec>(23);
+
+  KFoldCV<LinearRegression, MSE> cv(4, data, responses, true);
+  BOOST_REQUIRE_SMALL(cv.Evaluate(), 1e-10);
+  cv.Shuffle();
+  BOOST_REQUIRE_SMALL(cv.Evaluate(), 1e-10);
+
+  KFoldCV<LinearRegression, MSE> weightedCV(4, data, responses, weights, true);
+  BOOST_REQUIRE_SMALL(weightedCV.Evaluate(), 1e-10);
+  weightedCV.Shuffle();
+  BOOST_REQUIRE_SMALL(weightedCV.Evaluate(), 1e-10);
+}
+
+/**
+ * Test that k-fold cross-validation is abandoned after the given number of
+ * folds when their mean doesn't reach the bound.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVMinFoldsTest)
+{
+  arma::mat data = arma::randu<arma::mat>(1, 10);
+  arma::rowvec responses = 2 * data + 0.1 * arma::randn<arma::rowvec>(10);
+
+  KFoldCV<LinearRegression, MSE> cv(2, data, responses, false);
+  const double fullMSE = cv.Evaluate();
+
+  // With the default bound every fold is evaluated.
+  cv.MinFolds() = 1;
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), fullMSE, 1e-5);
+
+  // Now nothing reaches the bound, so only the first fold is evaluated: it
+  // trains on the first half of the data and validates on the second one.
+  cv.Bound() = -DBL_MAX;
+  LinearRegression lr(data.cols(0, 4), responses.cols(0, 4));
+  const double firstFoldMSE = MSE::Evaluate(lr, data.cols(5, 9),
+      responses.cols(5, 9));
+
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), firstFoldMSE, 1e-5);
+}
+
 /**
  * Test k-fold cross-validation with decision trees constructed in multiple
  * ways.
@@ -11,6 +11,8 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/dbscan/dbscan.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/rectangle_tree.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -271,4 +273,70 @@ BOOST_AUTO_TEST_CASE(GaussiansSingleModeTest)
   }
 }
 
+/**
+ * Check that two sets of assignments describe the same partition of the
+ * points, regardless of how the clusters are numbered.
+ */
+void CheckSamePartition(const arma::Row<size_t>& a,
+                        const arma::Row<size_t>& b)
+{
+  BOOST_REQUIRE_EQUAL(a.n_elem, b.n_elem);
+  std::map<size_t, size_t> aToB, bToA;
+  for (size_t i = 0; i < a.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(a[i] == SIZE_MAX, b[i] == SIZE_MAX);
+    if (a[i] == SIZE_MAX)
+      continue;
+
+    if (aToB.count(a[i]) == 0)
+      aToB[a[i]] = b[i];
+    if (bToA.count(b[i]) == 0)
+      bToA[b[i]] = a[i];
+    BOOST_REQUIRE_EQUAL(aToB[a[i]], b[i]);
+    BOOST_REQUIRE_EQUAL(bToA[b[i]], a[i]);
+  }
+}
+
+/**
+ * Make sure the dual-tree clustering of batch mode, with several tree types,
+ * finds the same clusters as the list of neighbors found by naive search.
+ */
+BOOST_AUTO_TEST_CASE(DualTreeMatchesNaiveTest)
+{
+  // Many small, overlapping blobs give a lot of merges across tree nodes.
+  arma::mat points(2, 2000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    const double center = 3.0 * (i % 20);
+    points.col(i) = arma::vec({ center, (double) (i % 7) }) +
+        0.4 * arma::randn<arma::vec>(2);
+  }
+
+  for (const double epsilon : { 0.1, 0.3, 1.0, 3.0 })
+  {
+    range::RangeSearch<> naiveSearch(true);
+    DBSCAN<> naive(epsilon, 5, true, naiveSearch);
+    arma::Row<size_t> naiveAssignments;
+    const size_t naiveClusters = naive.Cluster(points, naiveAssignments);
+
+    DBSCAN<> kd(epsilon, 5);
+    arma::Row<size_t> kdAssignments;
+    BOOST_REQUIRE_EQUAL(kd.Cluster(points, kdAssignments), naiveClusters);
+    CheckSamePartition(naiveAssignments, kdAssignments);
+
+    DBSCAN<range::RangeSearch<metric::EuclideanDistance, arma::mat,
+        tree::StandardCoverTree>> cover(epsilon, 5);
+    arma::Row<size_t> coverAssignments;
+    BOOST_REQUIRE_EQUAL(cover.Cluster(points, coverAssignments),
+        naiveClusters);
+    CheckSamePartition(naiveAssignments, coverAssignments);
+
+    DBSCAN<range::RangeSearch<metric::EuclideanDistance, arma::mat,
+        tree::RTree>> r(epsilon, 5);
+    arma::Row<size_t> rAssignments;
+    BOOST_REQUIRE_EQUAL(r.Cluster(points, rAssignments), naiveClusters);
+    CheckSamePartition(naiveAssignments, rAssignments);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
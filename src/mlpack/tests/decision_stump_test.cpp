@@ -391,4 +391,34 @@ BOOST_AUTO_TEST_CASE(IntTest)
   BOOST_CHECK_EQUAL(predictedLabels(0, 7), 2);
 }
 
+/**
+ * Make sure that a stump trained from another stump on the same data, which
+ * reuses the sort order of the other stump, is the same as a stump trained
+ * from scratch with the same weights.
+ */
+BOOST_AUTO_TEST_CASE(WeightedStumpFromOtherTest)
+{
+  arma::mat dataset(5, 500, arma::fill::randu);
+  arma::Row<size_t> labels(500);
+  for (size_t i = 0; i < 500; ++i)
+    labels[i] = (dataset(3, i) + 0.3 * dataset(1, i) > 0.6) ? 1 : 0;
+  arma::rowvec weights(500, arma::fill::randu);
+  weights /= arma::accu(weights);
+
+  DecisionStump<> other(dataset, labels, 2, 10);
+  DecisionStump<> fromOther(other, dataset, labels, 2, weights);
+
+  DecisionStump<> fromScratch;
+  fromScratch.Train(dataset, labels, weights, 2, 10);
+
+  BOOST_REQUIRE_EQUAL(fromOther.SplitDimension(),
+      fromScratch.SplitDimension());
+  BOOST_REQUIRE_EQUAL(fromOther.Split().n_elem, fromScratch.Split().n_elem);
+  for (size_t i = 0; i < fromOther.Split().n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(fromOther.Split()[i], fromScratch.Split()[i]);
+    BOOST_REQUIRE_EQUAL(fromOther.BinLabels()[i], fromScratch.BinLabels()[i]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -367,6 +367,154 @@ BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * Make sure that EvaluateCounts() gives the same result as Evaluate() for both
+ * fitness functions.
+ */
+BOOST_AUTO_TEST_CASE(EvaluateCountsTest)
+{
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(100,
+      arma::distr_param(0, 4));
+  arma::rowvec weights = arma::randu<arma::rowvec>(100);
+
+  arma::vec counts(5, arma::fill::zeros);
+  arma::vec weightedCounts(5, arma::fill::zeros);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    counts[labels[i]]++;
+    weightedCounts[labels[i]] += weights[i];
+  }
+
+  BOOST_REQUIRE_CLOSE(GiniGain::EvaluateCounts(counts.memptr(), 5, 100.0),
+      GiniGain::Evaluate<false>(labels, 5, weights), 1e-5);
+  BOOST_REQUIRE_CLOSE(GiniGain::EvaluateCounts(weightedCounts.memptr(), 5,
+      arma::accu(weights)), GiniGain::Evaluate<true>(labels, 5, weights),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(InformationGain::EvaluateCounts(counts.memptr(), 5,
+      100.0), InformationGain::Evaluate<false>(labels, 5, weights), 1e-5);
+  BOOST_REQUIRE_CLOSE(InformationGain::EvaluateCounts(weightedCounts.memptr(),
+      5, arma::accu(weights)), InformationGain::Evaluate<true>(labels, 5,
+      weights), 1e-5);
+
+  // Empty sets have no impurity.
+  BOOST_REQUIRE_EQUAL(GiniGain::EvaluateCounts(counts.memptr(), 5, 0.0), 0.0);
+  BOOST_REQUIRE_EQUAL(InformationGain::EvaluateCounts(counts.memptr(), 5, 0.0),
+      0.0);
+}
+
+/**
+ * Check that the HistogramNumericSplit will split on an obviously splittable
+ * dimension.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitSimpleSplitTest)
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // Make sure that a split was made, and that weights make no difference.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_CLOSE(gain, weightedGain, 1e-5);
+
+  // The split is perfect, so we should be able to accomplish a gain of 0.
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+
+  // The split point should be between 0.4 and 0.5.
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_GT(classProbabilities[0], 0.4);
+  BOOST_REQUIRE_LT(classProbabilities[0], 0.5);
+}
+
+/**
+ * Check that the HistogramNumericSplit doesn't split when all the values are
+ * the same, or when the children would be too small.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitNoSplitTest)
+{
+  arma::vec values(11, arma::fill::zeros);
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem, arma::fill::ones);
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+
+  // Now the split is possible, but the leaves would be too small.
+  values = arma::vec("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 8, 1e-7, classProbabilities, aux);
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+}
+
+/**
+ * When there are fewer distinct values than bins, the HistogramNumericSplit
+ * should find the same split as the BestBinaryNumericSplit.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitMatchesBestBinaryTest)
+{
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::vec values = arma::floor(100.0 * arma::randu<arma::vec>(1000));
+    arma::Row<size_t> labels(1000);
+    for (size_t i = 0; i < values.n_elem; ++i)
+      labels[i] = (values[i] + 30.0 * math::Random() > 60.0) ? 1 : 0;
+    labels[0] = 2;
+    arma::rowvec weights = arma::randu<arma::rowvec>(1000);
+
+    arma::vec classProbabilities, histogramClassProbabilities;
+    BestBinaryNumericSplit<InformationGain>::AuxiliarySplitInfo<double> aux;
+    HistogramNumericSplit<InformationGain>::AuxiliarySplitInfo<double>
+        histogramAux;
+
+    const double bestGain = InformationGain::Evaluate<false>(labels, 3,
+        weights);
+    const double gain =
+        BestBinaryNumericSplit<InformationGain>::SplitIfBetter<false>(bestGain,
+        values, labels, 3, weights, 10, 1e-7, classProbabilities, aux);
+    const double histogramGain =
+        HistogramNumericSplit<InformationGain>::SplitIfBetter<false>(bestGain,
+        values, labels, 3, weights, 10, 1e-7, histogramClassProbabilities,
+        histogramAux);
+
+    BOOST_REQUIRE_CLOSE(gain, histogramGain, 1e-5);
+    BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+    BOOST_REQUIRE_EQUAL(histogramClassProbabilities.n_elem, 1);
+    BOOST_REQUIRE_CLOSE(classProbabilities[0], histogramClassProbabilities[0],
+        1e-5);
+
+    // The same should hold with weights.
+    const double weightedGain =
+        BestBinaryNumericSplit<InformationGain>::SplitIfBetter<true>(bestGain,
+        values, labels, 3, weights, 10, 1e-7, classProbabilities, aux);
+    const double histogramWeightedGain =
+        HistogramNumericSplit<InformationGain>::SplitIfBetter<true>(bestGain,
+        values, labels, 3, weights, 10, 1e-7, histogramClassProbabilities,
+        histogramAux);
+
+    BOOST_REQUIRE_CLOSE(weightedGain, histogramWeightedGain, 1e-5);
+    BOOST_REQUIRE_CLOSE(classProbabilities[0], histogramClassProbabilities[0],
+        1e-5);
+  }
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -664,6 +812,61 @@ BOOST_AUTO_TEST_CASE(SimpleGeneralizationTest)
   BOOST_REQUIRE_GT(wdcorrect, 0.75);
 }
 
+/**
+ * Make sure that a decision tree built with the HistogramNumericSplit
+ * generalizes well.
+ */
+BOOST_AUTO_TEST_CASE(HistogramSplitGeneralizationTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  // Initialize an all-ones weight matrix.
+  arma::rowvec weights(labels.n_cols, arma::fill::ones);
+
+  // Build decision trees.
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+  DecisionTree<GiniGain, HistogramNumericSplit> wd(inputData, labels, 3,
+      weights, 10);
+
+  // Load testing data.
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  arma::Row<size_t> predictions, weightedPredictions;
+  d.Classify(testData, predictions);
+  wd.Classify(testData, weightedPredictions);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+  BOOST_REQUIRE_EQUAL(weightedPredictions.n_elem, testData.n_cols);
+
+  // Figure out the accuracy.
+  double correct = 0.0;
+  double weightedCorrect = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+  {
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+    if (weightedPredictions[i] == trueTestLabels[i])
+      ++weightedCorrect;
+  }
+  correct /= predictions.n_elem;
+  weightedCorrect /= predictions.n_elem;
+
+  BOOST_REQUIRE_GT(correct, 0.75);
+  BOOST_REQUIRE_GT(weightedCorrect, 0.75);
+}
+
 /**
  * Test that we can build a decision tree on a simple categorical dataset.
  */
@@ -1126,4 +1329,161 @@ BOOST_AUTO_TEST_CASE(RegularisedDecisionTree)
   BOOST_REQUIRE_GT(count, 0);
 }
 
+/**
+ * Make sure that large trees, whose dimensions are evaluated and whose subtrees
+ * are built in parallel, are the same no matter how many threads are used.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainingTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  // Add some numeric dimensions, so that both Train() overloads have several
+  // dimensions to evaluate.
+  arma::mat numericData = arma::join_cols(d.rows(0, 1),
+      arma::randu<arma::mat>(3, d.n_cols));
+  arma::rowvec weights = arma::randu<arma::rowvec>(l.n_elem);
+
+  DecisionTree<> tree(d, di, l, 5, 10);
+  DecisionTree<> weightedTree(d, di, l, 5, weights, 10);
+  DecisionTree<> numericTree(numericData, l, 5, 10);
+
+  arma::Row<size_t> predictions, weightedPredictions, numericPredictions;
+  arma::mat probabilities, weightedProbabilities, numericProbabilities;
+  tree.Classify(d, predictions, probabilities);
+  weightedTree.Classify(d, weightedPredictions, weightedProbabilities);
+  numericTree.Classify(numericData, numericPredictions, numericProbabilities);
+
+  // The trees should fit the training set well.
+  BOOST_REQUIRE_GT(arma::accu(predictions == l), 0.7 * l.n_elem);
+  BOOST_REQUIRE_GT(arma::accu(weightedPredictions == l), 0.7 * l.n_elem);
+  BOOST_REQUIRE_GT(arma::accu(numericPredictions == l), 0.7 * l.n_elem);
+
+  // Now train again with a single thread; the trees should be identical.
+  #ifdef HAS_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  DecisionTree<> serialTree(d, di, l, 5, 10);
+  DecisionTree<> serialWeightedTree(d, di, l, 5, weights, 10);
+  DecisionTree<> serialNumericTree(numericData, l, 5, 10);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(numThreads);
+  #endif
+
+  arma::Row<size_t> serialPredictions;
+  arma::mat serialProbabilities;
+  serialTree.Classify(d, serialPredictions, serialProbabilities);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != serialPredictions), 0);
+  BOOST_REQUIRE_EQUAL(arma::accu(probabilities != serialProbabilities), 0);
+
+  serialWeightedTree.Classify(d, serialPredictions, serialProbabilities);
+  BOOST_REQUIRE_EQUAL(arma::accu(weightedPredictions != serialPredictions), 0);
+  BOOST_REQUIRE_EQUAL(arma::accu(weightedProbabilities != serialProbabilities),
+      0);
+
+  serialNumericTree.Classify(numericData, serialPredictions,
+      serialProbabilities);
+  BOOST_REQUIRE_EQUAL(arma::accu(numericPredictions != serialPredictions), 0);
+  BOOST_REQUIRE_EQUAL(arma::accu(numericProbabilities != serialProbabilities),
+      0);
+}
+
+/**
+ * Make sure that the dimensions of a node large enough to be evaluated in
+ * parallel are chosen as the serial loop would, when a dimension has to beat
+ * the best gain by a non-zero minimum gain split margin.
+ */
+BOOST_AUTO_TEST_CASE(ParallelMinimumGainSplitTest)
+{
+  // The root has more points than DecisionTree::MinimumParallelSize().
+  const size_t points = 2048;
+  const double minimumGainSplit = 0.05;
+
+  // Each dimension separates the classes a little better than the previous
+  // one, by less than the margin.
+  arma::Row<size_t> labels(points);
+  arma::mat data(4, points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = (i < points / 2) ? 0 : 1;
+    for (size_t d = 0; d < data.n_rows; ++d)
+    {
+      const bool flip = (math::Random() < 0.1 - 0.005 * d);
+      data(d, i) = (flip ? 1 - labels[i] : labels[i]) + 0.3 * math::Random();
+    }
+  }
+
+  // Find the split of the root in the same way as the serial loop, with each
+  // dimension evaluated against the best gain so far.
+  arma::rowvec weights;
+  double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  size_t bestDim = data.n_rows;
+  arma::vec bestProbabilities;
+  for (size_t d = 0; d < data.n_rows && bestGain < 0.0; ++d)
+  {
+    arma::vec probabilities;
+    BestBinaryNumericSplit<GiniGain>::AuxiliarySplitInfo<double> aux;
+    const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+        bestGain, data.row(d), labels, 2, weights, 10, minimumGainSplit,
+        probabilities, aux);
+    if (gain > bestGain)
+    {
+      bestGain = gain;
+      bestDim = d;
+      bestProbabilities = probabilities;
+    }
+  }
+  BOOST_REQUIRE_LT(bestDim, data.n_rows);
+
+  DecisionTree<> tree(data, labels, 2, 10, minimumGainSplit);
+  BOOST_REQUIRE_EQUAL(tree.NumChildren(), 2);
+  for (size_t i = 0; i < points; ++i)
+  {
+    const size_t direction = (data(bestDim, i) <= bestProbabilities[0]) ? 0 :
+        1;
+    BOOST_REQUIRE_EQUAL(tree.CalculateDirection(data.col(i)), direction);
+  }
+}
+
+/**
+ * Make sure that classifying a batch that spans several blocks (which are
+ * classified in parallel) gives the same results as classifying each point.
+ */
+BOOST_AUTO_TEST_CASE(LargeBatchClassifyTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 3000);
+  arma::Row<size_t> labels(3000);
+  for (size_t i = 0; i < 3000; ++i)
+    labels[i] = (dataset(0, i) > 0.5 ? 1 : 0) + (dataset(1, i) > 0.3 ? 1 : 0);
+
+  DecisionTree<> tree(dataset, labels, 3, 10);
+
+  arma::Row<size_t> predictions, predictions2;
+  arma::mat probabilities;
+  tree.Classify(dataset, predictions);
+  tree.Classify(dataset, predictions2, probabilities);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, 3000);
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, 3000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    tree.Classify(dataset.col(i), prediction, pointProbabilities);
+
+    BOOST_REQUIRE_EQUAL(tree.Classify(dataset.col(i)), predictions[i]);
+    BOOST_REQUIRE_EQUAL(prediction, predictions2[i]);
+    for (size_t c = 0; c < 3; ++c)
+      BOOST_REQUIRE_EQUAL(pointProbabilities[c], probabilities(c, i));
+  }
+
+  BOOST_REQUIRE_GT(arma::accu(predictions == labels), 0.9 * labels.n_elem);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
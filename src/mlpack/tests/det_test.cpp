@@ -453,6 +453,109 @@ BOOST_AUTO_TEST_CASE(TestSparseComputeValue)
   BOOST_REQUIRE_CLOSE(0.0, testDTree.ComputeValue(q4), 1e-10);
 }
 
+/**
+ * Make sure that the batched ComputeValue() gives the same results as the
+ * single-point one, for points inside and outside of the range of the tree.
+ */
+template<typename MatType>
+void CheckBatchComputeValue()
+{
+  arma::mat realData(4, 500, arma::fill::randu);
+  MatType testData(realData);
+
+  arma::Col<size_t> oTest = arma::linspace<arma::Col<size_t>>(0, 499, 500);
+  DTree<MatType> testDTree(testData);
+  double alpha = testDTree.Grow(testData, oTest, false, 10, 2);
+
+  // Some of the query points will be out of range.
+  arma::mat realQueries(4, 300, arma::fill::randu);
+  realQueries *= 1.2;
+  MatType queries(realQueries);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    arma::rowvec values;
+    testDTree.ComputeValue(queries, values);
+
+    BOOST_REQUIRE_EQUAL(values.n_elem, queries.n_cols);
+    for (size_t i = 0; i < queries.n_cols; ++i)
+    {
+      const typename MatType::vec_type query = queries.col(i);
+      const double value = testDTree.ComputeValue(query);
+      if (value == 0.0)
+        BOOST_REQUIRE_SMALL(values[i], 1e-10);
+      else
+        BOOST_REQUIRE_CLOSE(values[i], value, 1e-10);
+    }
+
+    // Check the pruned tree too.
+    alpha = testDTree.PruneAndUpdate(alpha, testData.n_cols, false);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestBatchComputeValue)
+{
+  CheckBatchComputeValue<arma::mat>();
+}
+
+BOOST_AUTO_TEST_CASE(TestSparseBatchComputeValue)
+{
+  CheckBatchComputeValue<arma::sp_mat>();
+}
+
+#ifndef _WIN32
+/**
+ * Make sure the two given trees have the same structure.
+ */
+void CheckSameTree(const DTree<arma::mat>& a, const DTree<arma::mat>& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Start(), b.Start());
+  BOOST_REQUIRE_EQUAL(a.End(), b.End());
+  BOOST_REQUIRE_EQUAL(a.SubtreeLeaves(), b.SubtreeLeaves());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_CLOSE(a.LogNegError(), b.LogNegError(), 1e-10);
+
+  if (a.NumChildren() == 0)
+    return;
+
+  BOOST_REQUIRE_EQUAL(a.SplitDim(), b.SplitDim());
+  BOOST_REQUIRE_EQUAL(a.SplitValue(), b.SplitValue());
+  CheckSameTree(*a.Left(), *b.Left());
+  CheckSameTree(*a.Right(), *b.Right());
+}
+
+/**
+ * Growing a tree with the dimensions sorted once at the root must give the same
+ * tree as sorting the points of every node.
+ */
+BOOST_AUTO_TEST_CASE(TestPresortedGrow)
+{
+  // Use few distinct values in some dimensions, to get many ties.
+  arma::mat data(5, 2000, arma::fill::randu);
+  data.row(1) = arma::floor(10 * data.row(1));
+  data.row(3) = arma::floor(3 * data.row(3));
+
+  arma::mat sortedData(data);
+  arma::Col<size_t> sortedOldFromNew =
+      arma::linspace<arma::Col<size_t>>(0, 1999, 2000);
+  DTree<arma::mat> sortedTree(sortedData);
+  const double sortedAlpha = sortedTree.Grow(sortedData, sortedOldFromNew,
+      false, 10, 3);
+
+  arma::mat unsortedData(data);
+  arma::Col<size_t> unsortedOldFromNew =
+      arma::linspace<arma::Col<size_t>>(0, 1999, 2000);
+  DTree<arma::mat> unsortedTree(unsortedData);
+  const double unsortedAlpha = unsortedTree.Grow(unsortedData,
+      unsortedOldFromNew, false, 10, 3, NULL);
+
+  BOOST_REQUIRE_CLOSE(sortedAlpha, unsortedAlpha, 1e-10);
+  CheckSameTree(sortedTree, unsortedTree);
+  for (size_t i = 0; i < sortedOldFromNew.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(sortedOldFromNew[i], unsortedOldFromNew[i]);
+}
+#endif
+
 /**
  * These are not yet implemented.
  *
@@ -0,0 +1,96 @@
+/**
+ * @file distributed_sgd_test.cpp
+ *
+ * Test file for DistributedSGD.  The tests run in a single process, where
+ * DistributedSGD has to behave like SGD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/distributed_sgd/distributed_sgd.hpp>
+#include <mlpack/core/optimizers/sgd/update_policies/momentum_update.hpp>
+#include <mlpack/core/optimizers/problems/generalized_rosenbrock_function.hpp>
+#include <mlpack/core/optimizers/problems/sgd_test_function.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace std;
+using namespace arma;
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::optimization::test;
+
+// Make sure MPI is initialized, if mlpack was built with it.
+static void InitializeMPI()
+{
+  #ifdef HAS_MPI
+  int initialized;
+  MPI_Initialized(&initialized);
+  if (!initialized)
+    MPI_Init(NULL, NULL);
+  #endif
+}
+
+BOOST_AUTO_TEST_SUITE(DistributedSGDTest);
+
+BOOST_AUTO_TEST_CASE(SimpleDistributedSGDTestFunction)
+{
+  InitializeMPI();
+
+  SGDTestFunction f;
+  DistributedSGD<> s(0.0003, 1, 5000000, 1e-9, true);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  double result = s.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_CLOSE(result, -1.0, 0.05);
+  BOOST_REQUIRE_SMALL(coordinates[0], 1e-3);
+  BOOST_REQUIRE_SMALL(coordinates[1], 1e-7);
+  BOOST_REQUIRE_SMALL(coordinates[2], 1e-7);
+}
+
+BOOST_AUTO_TEST_CASE(GeneralizedRosenbrockTest)
+{
+  InitializeMPI();
+
+  // Create the generalized Rosenbrock function.
+  GeneralizedRosenbrockFunction f(10);
+  MomentumUpdate momentumUpdate(0.4);
+  DistributedSGD<MomentumUpdate> s(0.0008, 1, 0, 1e-15, true, momentumUpdate,
+      NoDecay(), true, true);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  double result = s.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_SMALL(result, 1e-4);
+  for (size_t j = 0; j < 10; ++j)
+    BOOST_REQUIRE_CLOSE(coordinates[j], (double) 1.0, 1e-3);
+}
+
+/**
+ * Make sure that the checkpoint holds the iterate of the last checkpointed
+ * step.
+ */
+BOOST_AUTO_TEST_CASE(CheckpointTest)
+{
+  InitializeMPI();
+
+  GeneralizedRosenbrockFunction f(10);
+  DistributedSGD<> s(0.0008, 1, 1000, 1e-15, true, VanillaUpdate(), NoDecay(),
+      true, false, 100, "distributed_sgd_checkpoint.csv");
+
+  arma::mat coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates);
+
+  arma::mat checkpoint;
+  BOOST_REQUIRE(data::Load("distributed_sgd_checkpoint.csv", checkpoint));
+  CheckMatrices(checkpoint, coordinates, 1e-3);
+
+  remove("distributed_sgd_checkpoint.csv");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -188,6 +188,39 @@ BOOST_AUTO_TEST_CASE(MultiDiscreteDistributionTrainProTest)
   BOOST_REQUIRE_CLOSE(d.Probability("2 1 0"), 0.015625, 1e-5);
 }
 
+/**
+ * Make sure the batch probabilities of a multidimensional DiscreteDistribution
+ * are the same as the probabilities of each observation.
+ */
+BOOST_AUTO_TEST_CASE(MultiDiscreteDistributionBatchProbabilityTest)
+{
+  DiscreteDistribution d("5 3 4");
+  d.Train(arma::mat("0 4 1 1 2 3;"
+                    "0 1 1 2 2 0;"
+                    "3 1 1 2 2 0"));
+
+  arma::mat obs("0 1 4 3 2 0 1;"
+                "0 1 2 0 2 1 2;"
+                "3 1 0 2 2 1 3");
+
+  arma::vec probabilities, logProbabilities;
+  d.Probability(obs, probabilities);
+  d.LogProbability(obs, logProbabilities);
+
+  BOOST_REQUIRE_EQUAL(probabilities.n_elem, obs.n_cols);
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, obs.n_cols);
+  for (size_t i = 0; i < obs.n_cols; ++i)
+  {
+    const arma::vec observation = obs.col(i);
+    BOOST_REQUIRE_CLOSE(probabilities[i], d.Probability(observation), 1e-5);
+    if (probabilities[i] > 0)
+    {
+      BOOST_REQUIRE_CLOSE(logProbabilities[i], d.LogProbability(observation),
+          1e-5);
+    }
+  }
+}
+
 /*********************************/
 /** Gaussian Distribution Tests **/
 /*********************************/
@@ -393,6 +426,30 @@ BOOST_AUTO_TEST_CASE(GaussianMultipointMultivariateProbabilityTest)
   BOOST_REQUIRE_CLOSE(phis(5), -14.900192463287908, 1e-5);
 }
 
+/**
+ * Make sure the batch LogProbability() agrees with the single-point version
+ * when the points span several blocks.
+ */
+BOOST_AUTO_TEST_CASE(GaussianBatchLogProbabilityBlocksTest)
+{
+  arma::vec mean = "1 -2 0.5 3";
+  arma::mat cov("4 1 0 0.5;"
+                "1 3 0.2 0;"
+                "0 0.2 2 0.1;"
+                "0.5 0 0.1 1");
+  GaussianDistribution g(mean, cov);
+
+  arma::mat points(4, 2500, arma::fill::randn);
+  points *= 3.0;
+
+  arma::vec logProbs;
+  g.LogProbability(points, logProbs);
+
+  BOOST_REQUIRE_EQUAL(logProbs.n_elem, points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(logProbs[i], g.LogProbability(points.col(i)), 1e-7);
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
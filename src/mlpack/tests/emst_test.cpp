@@ -10,6 +10,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/emst/dtb.hpp>
+#include <mlpack/methods/emst/single_linkage.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -278,4 +279,133 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+/**
+ * Points on a grid have many edges of the same length, so the threads of each
+ * round may find different candidates for the same component.  The MST must
+ * still be a spanning tree with every edge of length 1.
+ */
+BOOST_AUTO_TEST_CASE(GridTiesTest)
+{
+  arma::mat inputData(2, 400);
+  for (size_t i = 0; i < 400; ++i)
+  {
+    inputData(0, i) = (double) (i % 20);
+    inputData(1, i) = (double) (i / 20);
+  }
+
+  DualTreeBoruvka<> dtb(inputData);
+  arma::mat results;
+  dtb.ComputeMST(results);
+
+  BOOST_REQUIRE_EQUAL(results.n_cols, 399);
+
+  UnionFind uf(400);
+  for (size_t i = 0; i < results.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(results(2, i), 1.0, 1e-5);
+
+    // No edge may close a cycle.
+    const size_t a = (size_t) results(0, i);
+    const size_t b = (size_t) results(1, i);
+    BOOST_REQUIRE_NE(uf.Find(a), uf.Find(b));
+    uf.Union(a, b);
+  }
+}
+
+/**
+ * Check the dendrogram and the flat clusterings of a small one-dimensional
+ * dataset by hand.
+ */
+BOOST_AUTO_TEST_CASE(SingleLinkageSimpleTest)
+{
+  arma::mat inputData("0.0 1.0 3.0 7.0");
+
+  DualTreeBoruvka<> dtb(inputData);
+  arma::mat results;
+  dtb.ComputeMST(results);
+
+  SingleLinkage linkage(results);
+  BOOST_REQUIRE_EQUAL(linkage.NumPoints(), 4);
+
+  const arma::mat& dendrogram = linkage.Dendrogram();
+  BOOST_REQUIRE_EQUAL(dendrogram.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(dendrogram.n_cols, 3);
+
+  // 0 and 1 merge at distance 1, then 2 joins them, then 3.
+  const arma::mat expected("0 2 3; 1 4 5; 1 2 4; 2 3 4");
+  for (size_t i = 0; i < expected.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(dendrogram[i], expected[i], 1e-5);
+
+  // The thresholds don't have to be sorted.
+  arma::Mat<size_t> assignments;
+  arma::Row<size_t> numClusters;
+  linkage.Cut(arma::vec("2.5 0.5 10.0"), assignments, numClusters);
+
+  BOOST_REQUIRE_EQUAL(assignments.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(assignments.n_cols, 4);
+  BOOST_REQUIRE_EQUAL(numClusters[0], 2);
+  BOOST_REQUIRE_EQUAL(numClusters[1], 4);
+  BOOST_REQUIRE_EQUAL(numClusters[2], 1);
+
+  const arma::Mat<size_t> expectedAssignments("0 0 0 1; 0 1 2 3; 0 0 0 0");
+  for (size_t i = 0; i < expectedAssignments.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], expectedAssignments[i]);
+
+  // With a minimum cluster size, the single point is noise.
+  linkage.Cut(arma::vec("2.5"), assignments, numClusters, 2);
+  BOOST_REQUIRE_EQUAL(numClusters[0], 1);
+  BOOST_REQUIRE_EQUAL(assignments(0, 0), 0);
+  BOOST_REQUIRE_EQUAL(assignments(0, 1), 0);
+  BOOST_REQUIRE_EQUAL(assignments(0, 2), 0);
+  BOOST_REQUIRE_EQUAL(assignments(0, 3), SIZE_MAX);
+}
+
+/**
+ * Make sure that the clusters at each threshold are the connected components
+ * of the graph of all pairs of points no further apart than the threshold, and
+ * that the visitor is called in increasing order of threshold.
+ */
+BOOST_AUTO_TEST_CASE(SingleLinkageBruteForceTest)
+{
+  arma::mat inputData(2, 300, arma::fill::randu);
+
+  DualTreeBoruvka<> dtb(inputData);
+  arma::mat results;
+  dtb.ComputeMST(results);
+
+  SingleLinkage linkage(results);
+  const arma::vec thresholds("0.1 0.02 0.05");
+
+  std::vector<size_t> visited;
+  linkage.Cut(thresholds, [&](const size_t index,
+                              const arma::Row<size_t>& assignments,
+                              const size_t numClusters)
+  {
+    visited.push_back(index);
+
+    // Find the components by brute force.
+    UnionFind uf(inputData.n_cols);
+    for (size_t i = 0; i < inputData.n_cols; ++i)
+      for (size_t j = i + 1; j < inputData.n_cols; ++j)
+        if (arma::norm(inputData.col(i) - inputData.col(j)) <=
+            thresholds[index])
+          uf.Union(i, j);
+
+    size_t maxAssignment = 0;
+    for (size_t i = 0; i < inputData.n_cols; ++i)
+    {
+      maxAssignment = std::max(maxAssignment, (size_t) assignments[i]);
+      for (size_t j = i + 1; j < inputData.n_cols; ++j)
+        BOOST_REQUIRE_EQUAL(uf.Find(i) == uf.Find(j),
+            assignments[i] == assignments[j]);
+    }
+    BOOST_REQUIRE_EQUAL(numClusters, maxAssignment + 1);
+  });
+
+  BOOST_REQUIRE_EQUAL(visited.size(), 3);
+  BOOST_REQUIRE_EQUAL(visited[0], 1);
+  BOOST_REQUIRE_EQUAL(visited[1], 2);
+  BOOST_REQUIRE_EQUAL(visited[2], 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -60,6 +60,46 @@ BOOST_AUTO_TEST_CASE(SingleTreeVsNaive)
   }
 }
 
+/**
+ * Make sure that the naive search and the parallel single-tree search give
+ * the exact results when the query and reference sets both span more than one
+ * block of the naive search.
+ */
+BOOST_AUTO_TEST_CASE(SingleTreeAndNaiveVsBruteForce)
+{
+  arma::mat referenceData(3, 4500, arma::fill::randn);
+  arma::mat queryData(3, 1100, arma::fill::randn);
+  GaussianKernel gk(0.8);
+
+  arma::Mat<size_t> naiveIndices, singleIndices;
+  arma::mat naiveKernels, singleKernels;
+
+  FastMKS<GaussianKernel> naive(referenceData, gk, false, true);
+  naive.Search(queryData, 5, naiveIndices, naiveKernels);
+
+  FastMKS<GaussianKernel> single(referenceData, gk, true);
+  single.Search(queryData, 5, singleIndices, singleKernels);
+
+  BOOST_REQUIRE_EQUAL(naiveIndices.n_cols, queryData.n_cols);
+  BOOST_REQUIRE_EQUAL(singleIndices.n_cols, queryData.n_cols);
+
+  for (size_t q = 0; q < queryData.n_cols; ++q)
+  {
+    arma::vec bruteKernels(referenceData.n_cols);
+    for (size_t r = 0; r < referenceData.n_cols; ++r)
+      bruteKernels[r] = gk.Evaluate(queryData.col(q), referenceData.col(r));
+    const arma::uvec order = arma::sort_index(bruteKernels, "descend");
+
+    for (size_t i = 0; i < 5; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(naiveIndices(i, q), order[i]);
+      BOOST_REQUIRE_EQUAL(singleIndices(i, q), order[i]);
+      BOOST_REQUIRE_CLOSE(naiveKernels(i, q), bruteKernels[order[i]], 1e-5);
+      BOOST_REQUIRE_CLOSE(singleKernels(i, q), bruteKernels[order[i]], 1e-5);
+    }
+  }
+}
+
 /**
  * Compare dual-tree and naive.
  */
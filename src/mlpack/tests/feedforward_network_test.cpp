@@ -14,6 +14,7 @@
 
 #include <mlpack/core/optimizers/rmsprop/rmsprop.hpp>
 #include <mlpack/core/optimizers/sgd/update_policies/vanilla_update.hpp>
+#include <mlpack/core/optimizers/sgdr/swa_sgdr.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
@@ -569,6 +570,263 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
       binaryPredictions);
 }
 
+/**
+ * Make sure that the parameters of a network saved in single and bfloat16
+ * precision are restored to within the precision they were saved with.
+ */
+BOOST_AUTO_TEST_CASE(ReducedPrecisionSerializationTest)
+{
+  arma::mat data = arma::randu<arma::mat>(10, 50);
+
+  FFN<NegativeLogLikelihood<>> model;
+  model.Add<Linear<>>(10, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 3);
+  model.Add<LogSoftMax<>>();
+  model.ResetParameters();
+
+  // Make sure NaNs and zeros survive the conversion too.
+  model.Parameters()[0] = 0.0;
+  model.Parameters()[1] = std::numeric_limits<double>::quiet_NaN();
+
+  const ParameterPrecision precisions[] = { SINGLE_PRECISION,
+      BFLOAT16_PRECISION };
+  // A bfloat16 number has 8 bits of mantissa.
+  const double tolerances[] = { 1e-5, 0.5 };
+
+  for (size_t p = 0; p < 2; ++p)
+  {
+    model.Precision() = precisions[p];
+
+    FFN<NegativeLogLikelihood<>> xmlModel, textModel, binaryModel;
+    SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+    BOOST_REQUIRE_EQUAL(xmlModel.Precision(), precisions[p]);
+    BOOST_REQUIRE_EQUAL(textModel.Precision(), precisions[p]);
+    BOOST_REQUIRE_EQUAL(binaryModel.Precision(), precisions[p]);
+
+    const arma::mat& parameters = model.Parameters();
+    BOOST_REQUIRE_EQUAL(binaryModel.Parameters().n_elem, parameters.n_elem);
+    BOOST_REQUIRE(std::isnan(xmlModel.Parameters()[1]));
+    BOOST_REQUIRE(std::isnan(textModel.Parameters()[1]));
+    BOOST_REQUIRE(std::isnan(binaryModel.Parameters()[1]));
+    for (size_t i = 0; i < parameters.n_elem; ++i)
+    {
+      if (i == 1)
+        continue;
+
+      if (parameters[i] == 0.0)
+      {
+        BOOST_REQUIRE_SMALL(xmlModel.Parameters()[i], 1e-10);
+        BOOST_REQUIRE_SMALL(textModel.Parameters()[i], 1e-10);
+        BOOST_REQUIRE_SMALL(binaryModel.Parameters()[i], 1e-10);
+      }
+      else
+      {
+        BOOST_REQUIRE_CLOSE(xmlModel.Parameters()[i], parameters[i],
+            tolerances[p]);
+        BOOST_REQUIRE_CLOSE(textModel.Parameters()[i], parameters[i],
+            tolerances[p]);
+        BOOST_REQUIRE_CLOSE(binaryModel.Parameters()[i], parameters[i],
+            tolerances[p]);
+      }
+    }
+  }
+
+  // Without the NaN, the reduced precision network should predict nearly the
+  // same as the original one.
+  model.Parameters()[1] = 0.1;
+  model.Precision() = BFLOAT16_PRECISION;
+  FFN<NegativeLogLikelihood<>> xmlModel, textModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::mat predictions, binaryPredictions;
+  model.Predict(data, predictions);
+  binaryModel.Predict(data, binaryPredictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(predictions[i] - binaryPredictions[i], 0.05);
+}
+
+/**
+ * Make sure that a quantized network predicts nearly the same as the original
+ * one, and that it can be serialized.
+ */
+BOOST_AUTO_TEST_CASE(QuantizeTest)
+{
+  arma::mat data = arma::randu<arma::mat>(36, 50);
+
+  FFN<NegativeLogLikelihood<>> model;
+  model.Add<Convolution<>>(1, 4, 3, 3, 1, 1, 1, 1, 6, 6);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(4 * 6 * 6, 10);
+  model.Add<SigmoidLayer<>>();
+  model.Add<LinearNoBias<>>(10, 3);
+  model.Add<LogSoftMax<>>();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  model.Quantize(data);
+
+  // All the parameters are held by the quantized modules now.
+  BOOST_REQUIRE_EQUAL(model.Parameters().n_elem, 0);
+
+  arma::mat quantizedPredictions;
+  model.Predict(data, quantizedPredictions);
+  BOOST_REQUIRE_EQUAL(quantizedPredictions.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(quantizedPredictions.n_cols, 50);
+  BOOST_REQUIRE_LE(arma::abs(predictions - quantizedPredictions).max(), 0.05);
+
+  FFN<NegativeLogLikelihood<>> xmlModel, textModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::mat xmlPredictions, textPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  textModel.Predict(data, textPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(quantizedPredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that folding the BatchNorm modules into the preceding Linear and
+ * LinearNoBias modules doesn't change the predictions of a trained network.
+ */
+BOOST_AUTO_TEST_CASE(FoldBatchNormTest)
+{
+  arma::mat data = arma::randn<arma::mat>(10, 200);
+  arma::mat labels = arma::randi<arma::mat>(1, 200,
+      arma::distr_param(1, 4));
+
+  FFN<NegativeLogLikelihood<>> model;
+  model.Add<Linear<>>(10, 8);
+  model.Add<BatchNorm<>>(8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<LinearNoBias<>>(8, 4);
+  model.Add<BatchNorm<>>(4);
+  model.Add<LogSoftMax<>>();
+
+  RMSProp opt(0.01, 20, 0.88, 1e-8, 200, -1);
+  model.Train(data, labels, opt);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  model.FoldBatchNorm();
+
+  // Both BatchNorm modules are gone, and the LinearNoBias module has a bias
+  // now.
+  BOOST_REQUIRE_EQUAL(model.Parameters().n_elem, (10 * 8 + 8) + (8 * 4 + 4));
+
+  arma::mat foldedPredictions;
+  model.Predict(data, foldedPredictions);
+  CheckMatrices(predictions, foldedPredictions, 1e-3);
+}
+
+/**
+ * Make sure that a network with BatchNorm modules makes the same predictions
+ * after it was serialized, and that the loaded statistics can be folded.
+ */
+BOOST_AUTO_TEST_CASE(BatchNormSerializationTest)
+{
+  arma::mat data = arma::randn<arma::mat>(10, 200);
+  arma::mat labels = arma::randi<arma::mat>(1, 200,
+      arma::distr_param(1, 4));
+
+  FFN<NegativeLogLikelihood<>> model;
+  model.Add<Linear<>>(10, 8);
+  model.Add<BatchNorm<>>(8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 4);
+  model.Add<LogSoftMax<>>();
+
+  RMSProp opt(0.01, 20, 0.88, 1e-8, 200, -1);
+  model.Train(data, labels, opt);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  FFN<NegativeLogLikelihood<>> xmlModel, textModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::mat xmlPredictions, textPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  textModel.Predict(data, textPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+
+  binaryModel.FoldBatchNorm();
+  binaryModel.Predict(data, binaryPredictions);
+  CheckMatrices(predictions, binaryPredictions, 1e-3);
+}
+
+/**
+ * Make sure that training with SWASGDR computes the statistics of the
+ * BatchNorm modules again for the averaged parameters.
+ */
+BOOST_AUTO_TEST_CASE(SWASGDRBatchNormStatisticsTest)
+{
+  arma::mat data = arma::randn<arma::mat>(10, 200);
+  arma::mat labels = arma::randi<arma::mat>(1, 200,
+      arma::distr_param(1, 4));
+
+  BatchNorm<>* batchNorm = new BatchNorm<>(8);
+  FFN<NegativeLogLikelihood<>> model;
+  model.Add<Linear<>>(10, 8);
+  model.Add(batchNorm);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 4);
+  model.Add<LogSoftMax<>>();
+
+  SWASGDR<VanillaUpdate> opt(50, 2.0, 10, 0.01, 20000, -1);
+  model.Train(data, labels, opt);
+  BOOST_REQUIRE_GT(opt.Averaged(), 0);
+
+  // The statistics of the BatchNorm module must be the statistics of the
+  // output of the first Linear module, with the averaged parameters.
+  arma::mat output;
+  model.Forward(data, output, 0, 0);
+
+  const arma::vec mean = arma::mean(output, 1);
+  const arma::vec variance = arma::var(output, 1, 1);
+  CheckMatrices(batchNorm->TrainingMean(), mean, 1e-5);
+  CheckMatrices(batchNorm->TrainingVariance(), variance, 1e-5);
+}
+
+/**
+ * Make sure that the modules of a copied network use the parameters of the
+ * copy, so that setting its parameters changes its predictions.
+ */
+BOOST_AUTO_TEST_CASE(CopyParametersTest)
+{
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(4, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 2);
+  model.ResetParameters();
+
+  FFN<MeanSquaredError<>> copy(model), assigned;
+  assigned = model;
+
+  // Change the parameters of the original network only.
+  model.Parameters().randu();
+
+  const arma::mat input = arma::randu<arma::mat>(4, 10);
+  arma::mat predictions, copyPredictions, assignedPredictions;
+  model.Predict(input, predictions);
+
+  copy.Parameters() = model.Parameters();
+  copy.Predict(input, copyPredictions);
+  CheckMatrices(predictions, copyPredictions);
+
+  assigned.Parameters() = model.Parameters();
+  assigned.Predict(input, assignedPredictions);
+  CheckMatrices(predictions, assignedPredictions);
+}
+
 /**
  * Test if the custom layers work. The target is to see if the code compiles
  * when the Train and Prediction are called.
@@ -667,4 +925,281 @@ BOOST_AUTO_TEST_CASE(PartialForwardTest)
   CheckMatrices(output, arma::ones(10, 1) * 20);
 }
 
+/**
+ * Test that batched prediction gives the same results as predicting each
+ * point individually, including when the batch size does not evenly divide
+ * the number of points.
+ */
+BOOST_AUTO_TEST_CASE(BatchedPredictTest)
+{
+  arma::mat data = arma::randu<arma::mat>(10, 53);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat singlePrediction, batchPrediction, largePrediction;
+  model.Predict(data, singlePrediction, 1);
+  model.Predict(data, batchPrediction, 16);
+  model.Predict(data, largePrediction, 1000);
+
+  BOOST_REQUIRE_EQUAL(singlePrediction.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(singlePrediction.n_cols, 53);
+  CheckMatrices(singlePrediction, batchPrediction);
+  CheckMatrices(singlePrediction, largePrediction);
+
+  // A batch size of 0 is rejected instead of looping forever.
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(model.Predict(data, batchPrediction, 0),
+      std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Test that the forward pass through the execution plan of the network gives
+ * the same results as computing each layer by hand, on the first pass (which
+ * sets the sizes of the layers) and on later passes with other batch sizes,
+ * and that a copy of the network runs through its own layers.
+ */
+BOOST_AUTO_TEST_CASE(ExecutionPlanTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 20);
+
+  FFN<NegativeLogLikelihood<> > model;
+  Linear<>* first = new Linear<>(4, 3);
+  model.Add(first);
+  model.Add<SigmoidLayer<> >();
+  Linear<>* second = new Linear<>(3, 2);
+  model.Add(second);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  // Compute the expected output by hand.
+  const arma::mat w1 = arma::reshape(first->Parameters().rows(0, 11), 3, 4);
+  const arma::vec b1 = first->Parameters().rows(12, 14);
+  const arma::mat w2 = arma::reshape(second->Parameters().rows(0, 5), 2, 3);
+  const arma::vec b2 = second->Parameters().rows(6, 7);
+
+  arma::mat hidden = w1 * data;
+  hidden.each_col() += b1;
+  hidden = 1.0 / (1.0 + arma::exp(-hidden));
+  arma::mat output = w2 * hidden;
+  output.each_col() += b2;
+  arma::mat expected = output;
+  for (size_t i = 0; i < output.n_cols; ++i)
+  {
+    const double maxOutput = output.col(i).max();
+    expected.col(i) = output.col(i) - maxOutput -
+        std::log(arma::accu(arma::exp(output.col(i) - maxOutput)));
+  }
+
+  arma::mat prediction;
+  model.Predict(data, prediction, 20);
+  CheckMatrices(prediction, expected);
+
+  model.Predict(data, prediction, 7);
+  CheckMatrices(prediction, expected);
+
+  model.Forward(data.cols(0, 4), prediction);
+  CheckMatrices(prediction, expected.cols(0, 4));
+
+  // The copy must not run through the layers of the original network.
+  FFN<NegativeLogLikelihood<> > copy(model);
+  model.ResetParameters();
+  model.Predict(data, prediction, 20);
+
+  arma::mat copyPrediction;
+  copy.Predict(data, copyPrediction, 20);
+  CheckMatrices(copyPrediction, expected);
+}
+
+/**
+ * Make sure that the execution plan is rebuilt when the modules of the network
+ * are replaced by the same number of other modules.
+ */
+BOOST_AUTO_TEST_CASE(ExecutionPlanReplacedModulesTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 20);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(4, 3);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(3, 2);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  FFN<NegativeLogLikelihood<> > other;
+  other.Add<Linear<> >(4, 5);
+  other.Add<TanHLayer<> >();
+  other.Add<Linear<> >(5, 2);
+  other.Add<LogSoftMax<> >();
+  other.ResetParameters();
+
+  arma::mat prediction, otherPrediction;
+  model.Predict(data, prediction);
+  other.Predict(data, otherPrediction);
+
+  // The plan of the model was built for its old modules.
+  model = other;
+  model.Predict(data, prediction);
+  CheckMatrices(prediction, otherPrediction);
+
+  // Adding a module must also update the plan.
+  model.Add<IdentityLayer<> >();
+  model.Predict(data, prediction);
+  CheckMatrices(prediction, otherPrediction);
+}
+
+/**
+ * Make sure that splitting a batch over several threads gives the same
+ * objective and gradient as running it at once.
+ */
+BOOST_AUTO_TEST_CASE(ParallelEvaluateWithGradientTest)
+{
+  arma::mat data = arma::randu<arma::mat>(6, 50);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 50) * 3) + 1;
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(6, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.Predictors() = data;
+  model.Responses() = labels;
+  model.ResetParameters();
+
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 50);
+
+  model.Threads() = 4;
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    arma::mat parallelGradient;
+    const double parallelObjective = model.EvaluateWithGradient(
+        model.Parameters(), 0, parallelGradient, 50);
+
+    BOOST_REQUIRE_CLOSE(parallelObjective, objective, 1e-5);
+    CheckMatrices(parallelGradient, gradient, 1e-5);
+  }
+
+  // A batch smaller than the number of threads still works.
+  model.Threads() = 1;
+  const double smallObjective = model.EvaluateWithGradient(model.Parameters(),
+      10, gradient, 3);
+  model.Threads() = 4;
+  arma::mat parallelGradient;
+  BOOST_REQUIRE_CLOSE(model.EvaluateWithGradient(model.Parameters(), 10,
+      parallelGradient, 3), smallObjective, 1e-5);
+  CheckMatrices(parallelGradient, gradient, 1e-5);
+}
+
+/**
+ * Shuffling should only change the order in which the points are visited: the
+ * data stays in place, and the objective over an epoch of batches is the same.
+ */
+BOOST_AUTO_TEST_CASE(ShuffleVisitationOrderTest)
+{
+  arma::mat data = arma::randu<arma::mat>(6, 50);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 50) * 3) + 1;
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(6, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.Predictors() = data;
+  model.Responses() = labels;
+  model.ResetParameters();
+
+  double objective = 0;
+  arma::mat gradient, epochGradient(arma::size(model.Parameters()),
+      arma::fill::zeros);
+  for (size_t begin = 0; begin < 50; begin += 7)
+  {
+    const size_t batchSize = std::min((size_t) 7, 50 - begin);
+    objective += model.Evaluate(model.Parameters(), begin, batchSize);
+    model.EvaluateWithGradient(model.Parameters(), begin, gradient, batchSize);
+    epochGradient += gradient;
+  }
+
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    model.Shuffle();
+    CheckMatrices(model.Predictors(), data);
+    CheckMatrices(model.Responses(), labels);
+
+    double shuffledObjective = 0;
+    arma::mat shuffledGradient(arma::size(model.Parameters()),
+        arma::fill::zeros);
+    for (size_t begin = 0; begin < 50; begin += 7)
+    {
+      const size_t batchSize = std::min((size_t) 7, 50 - begin);
+      shuffledObjective += model.Evaluate(model.Parameters(), begin,
+          batchSize);
+      model.EvaluateWithGradient(model.Parameters(), begin, gradient,
+          batchSize);
+      shuffledGradient += gradient;
+    }
+
+    BOOST_REQUIRE_CLOSE(shuffledObjective, objective, 1e-5);
+    CheckMatrices(shuffledGradient, epochGradient, 1e-5);
+  }
+}
+
+/**
+ * The batch loader should return the same batches whether or not it prepares
+ * them in the background, also when the batches are not asked for in order,
+ * and it should apply the transformation to every batch.
+ */
+BOOST_AUTO_TEST_CASE(BatchLoaderTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 23);
+  arma::mat labels = arma::randu<arma::mat>(2, 23);
+  arma::Col<size_t> order = arma::shuffle(arma::linspace<arma::Col<size_t>>(0,
+      22, 23));
+
+  BatchLoader<> prefetching(true);
+  BatchLoader<> direct(false);
+  BatchLoader<> transforming;
+  transforming.Transform() = [](arma::mat& input, arma::mat& target)
+      {
+        input *= 2.0;
+        target += 1.0;
+      };
+
+  // The last batches are requested out of order.
+  const size_t begins[] = { 0, 5, 10, 15, 20, 5, 0, 15 };
+  for (size_t b = 0; b < 8; ++b)
+  {
+    const size_t begin = begins[b];
+    const size_t batchSize = std::min((size_t) 5, 23 - begin);
+    BOOST_REQUIRE(direct.Gathers(order, begin, batchSize));
+
+    prefetching.Gather(data, labels, order, begin, batchSize);
+    direct.Gather(data, labels, order, begin, batchSize);
+    transforming.Gather(data, labels, order, begin, batchSize);
+
+    BOOST_REQUIRE_EQUAL(direct.Input().n_cols, batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      CheckMatrices(direct.Input().col(i), data.col(order[begin + i]));
+      CheckMatrices(direct.Target().col(i), labels.col(order[begin + i]));
+    }
+
+    CheckMatrices(prefetching.Input(), direct.Input());
+    CheckMatrices(prefetching.Target(), direct.Target());
+    CheckMatrices(transforming.Input(), 2.0 * direct.Input());
+    CheckMatrices(transforming.Target(), direct.Target() + 1.0);
+  }
+
+  // Without a transformation, points past the order are used in place.
+  arma::Col<size_t> empty;
+  BOOST_REQUIRE(!direct.Gathers(empty, 0, 5));
+  BOOST_REQUIRE(transforming.Gathers(empty, 0, 5));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -12,6 +12,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/optimizers/fw/frank_wolfe.hpp>
 #include <mlpack/core/optimizers/fw/constr_lpball.hpp>
+#include <mlpack/core/optimizers/fw/constr_structure_group.hpp>
 #include <mlpack/core/optimizers/fw/update_span.hpp>
 #include <mlpack/core/optimizers/fw/update_full_correction.hpp>
 #include <mlpack/core/optimizers/fw/update_classic.hpp>
@@ -117,6 +118,71 @@ BOOST_AUTO_TEST_CASE(PruneSupportOMP)
   BOOST_REQUIRE_SMALL(result, 1e-10);
 }
 
+/**
+ * Orthogonal Matching Pursuit over a large dictionary, where the oracle scans
+ * the gradient in several blocks, and the atoms are stored sparsely.
+ */
+BOOST_AUTO_TEST_CASE(LargeDictionaryOMP)
+{
+  const size_t k = 200000;
+  mat B1 = eye(20, 20);
+  mat B2 = 0.1 * randn(20, k);
+  mat A = join_horiz(B1, B2);
+  vec b(20, arma::fill::zeros);
+  b(0) = 1;
+  b(1) = 1;
+
+  FuncSq f(A, b);
+  ConstrLpBallSolver linearConstrSolver(1);
+  UpdateSpan updateRule;
+
+  OMP s(linearConstrSolver, updateRule);
+
+  vec coordinates = zeros<vec>(k + 20);
+  double result = s.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_SMALL(result, 1e-10);
+  BOOST_REQUIRE_SMALL(coordinates[0] - 1, 1e-10);
+  BOOST_REQUIRE_SMALL(coordinates[1] - 1, 1e-10);
+  for (size_t i = 2; i < coordinates.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(coordinates[i], 1e-10);
+}
+
+/**
+ * Sparse recovery with many groups of coordinates, which are scanned in
+ * parallel by the structured group solver.
+ */
+BOOST_AUTO_TEST_CASE(StructuredGroupFW)
+{
+  const size_t dim = 2000;
+  mat A = join_horiz(eye(20, 20), 0.01 * randn(20, dim - 20));
+  vec b(20, arma::fill::zeros);
+  b(0) = 1;
+  b(1) = 1;
+
+  // Groups of two consecutive coordinates.
+  std::vector<arma::uvec> groups(dim / 2);
+  for (size_t i = 0; i < groups.size(); ++i)
+  {
+    groups[i].set_size(2);
+    groups[i][0] = 2 * i;
+    groups[i][1] = 2 * i + 1;
+  }
+
+  FuncSq f(A, b);
+  GroupLpBall groupExtractor(2, dim, groups);
+  ConstrStructGroupSolver<GroupLpBall> linearConstrSolver(groupExtractor);
+  UpdateSpan updateRule;
+
+  FrankWolfe<ConstrStructGroupSolver<GroupLpBall>, UpdateSpan>
+      s(linearConstrSolver, updateRule);
+
+  vec coordinates = zeros<vec>(dim);
+  double result = s.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_SMALL(result, 1e-10);
+}
+
 /**
  * Simple test of sparse soluton in atom domain with atom norm constraint.
  */
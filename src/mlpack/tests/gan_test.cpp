@@ -129,6 +129,53 @@ BOOST_AUTO_TEST_CASE(GANTest)
   BOOST_REQUIRE_LE(generatedStd - originalStd, 0.2);
 }
 
+/*
+ * Make sure that running the Generator at the same time as the Discriminator
+ * gives the same objective and gradient as running them one after the other.
+ */
+BOOST_AUTO_TEST_CASE(GANParallelGradientTest)
+{
+  size_t batchSize = 8;
+  size_t noiseDim = 1;
+
+  arma::mat trainData(1, 200);
+  trainData.imbue( [&]() { return arma::as_scalar(RandNormal(4, 0.5));});
+
+  FFN<CrossEntropyError<> > discriminator;
+  discriminator.Add<Linear<> >(1, 8);
+  discriminator.Add<ReLULayer<> >();
+  discriminator.Add<Linear<> >(8, 1);
+  discriminator.Add<SigmoidLayer<> >();
+
+  FFN<CrossEntropyError<> > generator;
+  generator.Add<Linear<> >(noiseDim, 8);
+  generator.Add<SoftPlusLayer<> >();
+  generator.Add<Linear<> >(8, 1);
+
+  GaussianInitialization gaussian(0, 0.1);
+  std::function<double ()> noiseFunction = [](){ return math::Random(-8, 8) +
+      math::RandNormal(0, 1) * 0.01;};
+  GAN<FFN<CrossEntropyError<> >,
+      GaussianInitialization,
+      std::function<double()> >
+  gan(trainData, generator, discriminator, gaussian, noiseFunction,
+      noiseDim, batchSize, 1, 0, 1);
+  gan.Reset();
+
+  arma::mat gradient, parallelGradient;
+  math::RandomSeed(5);
+  const double objective = gan.EvaluateWithGradient(gan.Parameters(), 0,
+      gradient, batchSize);
+
+  gan.Parallel() = true;
+  math::RandomSeed(5);
+  const double parallelObjective = gan.EvaluateWithGradient(gan.Parameters(),
+      0, parallelGradient, batchSize);
+
+  BOOST_REQUIRE_CLOSE(objective, parallelObjective, 1e-5);
+  CheckMatrices(gradient, parallelGradient, 1e-5);
+}
+
 /*
  * Tests the GAN implementation of the O'Reilly Test on the MNIST dataset.
  * It's not viable to train on bigger parameters due to time constraints.
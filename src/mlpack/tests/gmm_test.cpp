@@ -856,4 +856,150 @@ BOOST_AUTO_TEST_CASE(DiagonalGMMTrainTest)
   }
 }
 
+/**
+ * Check that a mixture of three Gaussians streamed in batches is recovered by
+ * GMM::Update() with online EM.
+ */
+BOOST_AUTO_TEST_CASE(OnlineEMUpdateTest)
+{
+  std::vector<distribution::GaussianDistribution> dists;
+  dists.push_back(distribution::GaussianDistribution("0.0 0.0 0.0",
+      "1.0 0.2 0.0; 0.2 1.0 0.0; 0.0 0.0 0.5"));
+  dists.push_back(distribution::GaussianDistribution("10.0 -5.0 3.0",
+      "2.0 0.0 0.3; 0.0 1.0 0.0; 0.3 0.0 1.0"));
+  dists.push_back(distribution::GaussianDistribution("-8.0 6.0 -6.0",
+      "0.5 0.0 0.0; 0.0 1.5 0.4; 0.0 0.4 1.0"));
+  const arma::vec mixWeights("0.2 0.3 0.5");
+
+  GMM g(3, 3);
+  OnlineEMFit<> fitter;
+  arma::mat batch(3, 500);
+  for (size_t b = 0; b < 20; ++b)
+  {
+    for (size_t i = 0; i < batch.n_cols; ++i)
+    {
+      const double randValue = math::Random();
+      if (randValue <= 0.2)
+        batch.col(i) = dists[0].Random();
+      else if (randValue <= 0.5)
+        batch.col(i) = dists[1].Random();
+      else
+        batch.col(i) = dists[2].Random();
+    }
+
+    g.Update(batch, fitter);
+  }
+
+  BOOST_REQUIRE_EQUAL(fitter.Steps(), (size_t) 20);
+
+  // The components are in order of their weights.
+  arma::uvec sortedIndices = sort_index(g.Weights());
+  for (size_t i = 0; i < 3; ++i)
+  {
+    const distribution::GaussianDistribution& c =
+        g.Component(sortedIndices[i]);
+
+    BOOST_REQUIRE_SMALL(g.Weights()[sortedIndices[i]] - mixWeights[i], 0.05);
+    for (size_t d = 0; d < 3; ++d)
+      BOOST_REQUIRE_SMALL(c.Mean()[d] - dists[i].Mean()[d], 0.3);
+    for (size_t j = 0; j < 9; ++j)
+      BOOST_REQUIRE_SMALL(c.Covariance()[j] - dists[i].Covariance()[j], 0.4);
+  }
+}
+
+/**
+ * Check that GMM::Train() with online EM finds a model about as good as the
+ * one found with EM.
+ */
+BOOST_AUTO_TEST_CASE(OnlineEMTrainTest)
+{
+  distribution::GaussianDistribution d1("0.0 5.0", "1.0 0.3; 0.3 1.0");
+  distribution::GaussianDistribution d2("6.0 -2.0", "2.0 0.0; 0.0 0.5");
+
+  arma::mat points(2, 4000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    points.col(i) = (math::Random() <= 0.4) ? d1.Random() : d2.Random();
+
+  GMM em(2, 2);
+  const double emLikelihood = em.Train(points);
+
+  GMM online(2, 2);
+  const double onlineLikelihood = online.Train(points, 1, false,
+      OnlineEMFit<>(10, 1e-10, 200));
+
+  BOOST_REQUIRE_SMALL((emLikelihood - onlineLikelihood) /
+      std::abs(emLikelihood), 0.01);
+
+  arma::uvec sortedIndices = sort_index(online.Weights());
+  BOOST_REQUIRE_SMALL(online.Weights()[sortedIndices[0]] - 0.4, 0.05);
+  for (size_t d = 0; d < 2; ++d)
+  {
+    BOOST_REQUIRE_SMALL(online.Component(sortedIndices[0]).Mean()[d] -
+        d1.Mean()[d], 0.2);
+    BOOST_REQUIRE_SMALL(online.Component(sortedIndices[1]).Mean()[d] -
+        d2.Mean()[d], 0.2);
+  }
+}
+
+/**
+ * Make sure the batch GMM::Probability() and GMM::LogProbability() agree with
+ * the single-point Probability(), and that Classify() picks the most probable
+ * component.
+ */
+BOOST_AUTO_TEST_CASE(GMMBatchProbabilityTest)
+{
+  GMM g(3, 2);
+  g.Component(0) = distribution::GaussianDistribution("0 0", "1 0; 0 1");
+  g.Component(1) = distribution::GaussianDistribution("3 1", "2 0.5; 0.5 1");
+  g.Component(2) = distribution::GaussianDistribution("-2 4", "0.5 0; 0 3");
+  g.Weights() = "0.5 0.3 0.2";
+
+  arma::mat points(2, 3000, arma::fill::randn);
+  points *= 3.0;
+
+  arma::vec probabilities, logProbabilities;
+  arma::Row<size_t> labels;
+  g.Probability(points, probabilities);
+  g.LogProbability(points, logProbabilities);
+  g.Classify(points, labels);
+
+  BOOST_REQUIRE_EQUAL(probabilities.n_elem, points.n_cols);
+  BOOST_REQUIRE_EQUAL(labels.n_elem, points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    const double p = g.Probability(points.col(i));
+    BOOST_REQUIRE_CLOSE(probabilities[i], p, 1e-7);
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], std::log(p), 1e-7);
+
+    for (size_t j = 0; j < 3; ++j)
+      BOOST_REQUIRE_LE(g.Probability(points.col(i), j),
+          g.Probability(points.col(i), labels[i]) * (1 + 1e-10));
+  }
+}
+
+/**
+ * A point far from every component still has a finite log-probability, even
+ * though its probability underflows.
+ */
+BOOST_AUTO_TEST_CASE(GMMLogProbabilityFarPointTest)
+{
+  GMM g(2, 1);
+  g.Component(0) = distribution::GaussianDistribution("0", "1");
+  g.Component(1) = distribution::GaussianDistribution("1", "1");
+  g.Weights() = "0.5 0.5";
+
+  arma::mat points("60.0");
+  arma::vec logProbabilities;
+  g.LogProbability(points, logProbabilities);
+
+  // The second component dominates: log(0.5) + log N(60 | 1, 1).
+  const double expected = std::log(0.5) - 0.5 * std::log(2 * M_PI) -
+      0.5 * 59.0 * 59.0;
+  BOOST_REQUIRE_CLOSE(logProbabilities[0], expected, 1e-5);
+
+  arma::Row<size_t> labels;
+  g.Classify(points, labels);
+  BOOST_REQUIRE_EQUAL(labels[0], (size_t) 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -599,6 +599,143 @@ BOOST_AUTO_TEST_CASE(GaussianHMMSimpleTest)
   }
 }
 
+/**
+ * Make sure the log-likelihood and the state probabilities of a Gaussian HMM
+ * (whose emission probabilities are computed in batch) match those found by
+ * summing over every possible state sequence.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMBruteForceEstimateTest)
+{
+  const size_t states = 3;
+  const size_t length = 6;
+
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(GaussianDistribution("0.0 0.0", "1.0 0.2; 0.2 1.0"));
+  emission.push_back(GaussianDistribution("1.0 0.5", "2.0 0.0; 0.0 0.5"));
+  emission.push_back(GaussianDistribution("-1.0 1.0", "0.5 0.1; 0.1 1.5"));
+
+  arma::vec initial("0.5 0.3 0.2");
+  arma::mat transition("0.6 0.3 0.2; 0.3 0.4 0.3; 0.1 0.3 0.5");
+
+  HMM<GaussianDistribution> hmm(initial, transition, emission);
+
+  arma::mat observations(2, length, arma::fill::randn);
+
+  // Enumerate all states^length state sequences.
+  arma::mat bruteStateProb(states, length, arma::fill::zeros);
+  double total = 0.0;
+  arma::Row<size_t> stateSeq(length);
+  const size_t numSequences = (size_t) std::pow(states, length);
+  for (size_t code = 0; code < numSequences; ++code)
+  {
+    size_t c = code;
+    for (size_t t = 0; t < length; ++t, c /= states)
+      stateSeq[t] = c % states;
+
+    double p = initial[stateSeq[0]] *
+        emission[stateSeq[0]].Probability(observations.col(0));
+    for (size_t t = 1; t < length; ++t)
+      p *= transition(stateSeq[t], stateSeq[t - 1]) *
+          emission[stateSeq[t]].Probability(observations.col(t));
+
+    total += p;
+    for (size_t t = 0; t < length; ++t)
+      bruteStateProb(stateSeq[t], t) += p;
+  }
+  bruteStateProb /= total;
+
+  arma::mat stateProb;
+  const double logLikelihood = hmm.Estimate(observations, stateProb);
+
+  BOOST_REQUIRE_CLOSE(logLikelihood, std::log(total), 1e-5);
+  BOOST_REQUIRE_CLOSE(hmm.LogLikelihood(observations), std::log(total), 1e-5);
+  for (size_t i = 0; i < stateProb.n_elem; ++i)
+  {
+    if (bruteStateProb[i] < 1e-10)
+      BOOST_REQUIRE_SMALL(stateProb[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(stateProb[i], bruteStateProb[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure the log-likelihood and the state probabilities of a Gaussian HMM
+ * are still right when an observation is so far from every state that its
+ * emission probabilities underflow.  The brute force sum is taken in log-space.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMUnderflowTest)
+{
+  const size_t states = 3;
+  const size_t length = 6;
+
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(GaussianDistribution("0.0 0.0", "1.0 0.2; 0.2 1.0"));
+  emission.push_back(GaussianDistribution("1.0 0.5", "2.0 0.0; 0.0 0.5"));
+  emission.push_back(GaussianDistribution("-1.0 1.0", "0.5 0.1; 0.1 1.5"));
+
+  arma::vec initial("0.5 0.3 0.2");
+  arma::mat transition("0.6 0.3 0.2; 0.3 0.4 0.3; 0.1 0.3 0.5");
+
+  HMM<GaussianDistribution> hmm(initial, transition, emission);
+
+  arma::mat observations(2, length, arma::fill::randn);
+  observations(0, 2) = 60.0;
+  observations(1, 2) = -60.0;
+  BOOST_REQUIRE_EQUAL(emission[0].Probability(observations.col(2)), 0.0);
+
+  // Enumerate all states^length state sequences.
+  const size_t numSequences = (size_t) std::pow(states, length);
+  arma::vec logProb(numSequences);
+  arma::Mat<size_t> stateSeqs(length, numSequences);
+  for (size_t code = 0; code < numSequences; ++code)
+  {
+    size_t c = code;
+    for (size_t t = 0; t < length; ++t, c /= states)
+      stateSeqs(t, code) = c % states;
+
+    const size_t first = stateSeqs(0, code);
+    logProb[code] = std::log(initial[first]) +
+        emission[first].LogProbability(observations.col(0));
+    for (size_t t = 1; t < length; ++t)
+    {
+      const size_t state = stateSeqs(t, code);
+      logProb[code] += std::log(transition(state, stateSeqs(t - 1, code))) +
+          emission[state].LogProbability(observations.col(t));
+    }
+  }
+
+  const double maxLogProb = logProb.max();
+  const arma::vec prob = arma::exp(logProb - maxLogProb);
+  const double logTotal = maxLogProb + std::log(arma::accu(prob));
+
+  arma::mat bruteStateProb(states, length, arma::fill::zeros);
+  for (size_t code = 0; code < numSequences; ++code)
+    for (size_t t = 0; t < length; ++t)
+      bruteStateProb(stateSeqs(t, code), t) += prob[code];
+  bruteStateProb /= arma::accu(prob);
+
+  arma::mat stateProb;
+  const double logLikelihood = hmm.Estimate(observations, stateProb);
+
+  BOOST_REQUIRE_CLOSE(logLikelihood, logTotal, 1e-5);
+  BOOST_REQUIRE_CLOSE(hmm.LogLikelihood(observations), logTotal, 1e-5);
+  for (size_t i = 0; i < stateProb.n_elem; ++i)
+  {
+    if (bruteStateProb[i] < 1e-10)
+      BOOST_REQUIRE_SMALL(stateProb[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(stateProb[i], bruteStateProb[i], 1e-5);
+  }
+
+  // The most likely state sequence is the one with the highest probability.
+  arma::Row<size_t> predictions;
+  hmm.Predict(observations, predictions);
+  arma::uword best;
+  logProb.max(best);
+  for (size_t t = 0; t < length; ++t)
+    BOOST_REQUIRE_EQUAL(predictions[t], stateSeqs(t, best));
+}
+
 /**
  * Ensure that Gaussian HMMs can be trained properly, for the labeled training
  * case and also for the unlabeled training case.
@@ -783,6 +920,62 @@ BOOST_AUTO_TEST_CASE(GaussianHMMGenerateTest)
   }
 }
 
+/**
+ * Make sure that the batch Predict() and LogLikelihood() give the same results
+ * as the single-sequence versions.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMBatchPredictLogLikelihoodTest)
+{
+  HMM<GaussianDistribution> hmm(3, GaussianDistribution(2));
+  hmm.Transition() = arma::mat("0.4 0.6 0.8; 0.2 0.2 0.1; 0.4 0.2 0.1");
+  hmm.Emission()[0] = GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  hmm.Emission()[1] = GaussianDistribution("2.0 2.0", "1.0 0.5; 0.5 1.2");
+  hmm.Emission()[2] = GaussianDistribution("-2.0 1.0", "2.0 0.1; 0.1 1.0");
+
+  // Sequences of different lengths, including an empty one.
+  std::vector<arma::mat> observations(20);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    if (i == 7)
+      observations[i].set_size(2, 0);
+    else
+      hmm.Generate(5 + 13 * i, observations[i], states, i % 3);
+  }
+
+  arma::Row<size_t> stateSeq;
+  arma::vec viterbiLogLikelihoods;
+  hmm.Predict(observations, stateSeq, viterbiLogLikelihoods);
+
+  arma::vec logLikelihoods;
+  hmm.LogLikelihood(observations, logLikelihoods);
+
+  BOOST_REQUIRE_EQUAL(viterbiLogLikelihoods.n_elem, observations.size());
+  BOOST_REQUIRE_EQUAL(logLikelihoods.n_elem, observations.size());
+
+  size_t offset = 0;
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    if (observations[i].n_cols == 0)
+    {
+      BOOST_REQUIRE_EQUAL(viterbiLogLikelihoods[i], 0.0);
+      BOOST_REQUIRE_EQUAL(logLikelihoods[i], 0.0);
+      continue;
+    }
+
+    arma::Row<size_t> states;
+    const double viterbiLogLikelihood = hmm.Predict(observations[i], states);
+    BOOST_REQUIRE_CLOSE(viterbiLogLikelihoods[i], viterbiLogLikelihood, 1e-5);
+    BOOST_REQUIRE_CLOSE(logLikelihoods[i], hmm.LogLikelihood(observations[i]),
+        1e-5);
+
+    for (size_t t = 0; t < states.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL(stateSeq[offset + t], states[t]);
+    offset += states.n_elem;
+  }
+  BOOST_REQUIRE_EQUAL(stateSeq.n_elem, offset);
+}
+
 /**
  * Test that HMMs work with Gaussian mixture models.  We'll try putting in a
  * simple model by hand and making sure that prediction of observation sequences
@@ -0,0 +1,214 @@
+/**
+ * @file hnsw_test.cpp
+ *
+ * Unit tests for the 'HNSWSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/ip_metric.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::metric;
+
+BOOST_AUTO_TEST_SUITE(HNSWTest);
+
+/**
+ * Make sure that the recall against exact search is high for high-dimensional
+ * data, and that it does not decrease when efSearch is increased.
+ */
+BOOST_AUTO_TEST_CASE(HNSWRecallTest)
+{
+  const size_t k = 10;
+  arma::mat referenceData(32, 2000, arma::fill::randu);
+  arma::mat queryData(32, 200, arma::fill::randu);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, k, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData, 16, 100, 10);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, k, neighbors, distances);
+  const double lowRecall = HNSWSearch<>::ComputeRecall(neighbors,
+      trueNeighbors);
+
+  hnsw.EfSearch() = 200;
+  hnsw.Search(queryData, k, neighbors, distances);
+  const double highRecall = HNSWSearch<>::ComputeRecall(neighbors,
+      trueNeighbors);
+
+  BOOST_REQUIRE_GE(highRecall, 0.9);
+  BOOST_REQUIRE_GE(highRecall, lowRecall);
+
+  // The distances must be the distances to the returned neighbors, sorted.
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(distances(j, i), EuclideanDistance::Evaluate(
+          queryData.col(i), referenceData.col(neighbors(j, i))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+    }
+  }
+}
+
+/**
+ * When efSearch is at least the number of points, a small graph is searched
+ * exhaustively, so the results must be exact.
+ */
+BOOST_AUTO_TEST_CASE(HNSWExactSmallTest)
+{
+  arma::mat referenceData(5, 100, arma::fill::randu);
+  arma::mat queryData(5, 30, arma::fill::randu);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 5, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData, 8, 100, 100);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 5, neighbors, distances);
+
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+}
+
+/**
+ * Searching the reference set must not return each point as its own neighbor.
+ */
+BOOST_AUTO_TEST_CASE(HNSWMonochromaticTest)
+{
+  arma::mat referenceData(10, 500, arma::fill::randu);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(3, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData, 12, 100, 50);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(3, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 500);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+      BOOST_REQUIRE_NE(neighbors(j, i), i);
+
+  BOOST_REQUIRE_GE(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors),
+      0.95);
+}
+
+/**
+ * Check the structure of the graph: nodes have at most m links (2m on the
+ * bottom layer), links point to nodes of the same layer, and the entry point is
+ * a node of the top layer.
+ */
+BOOST_AUTO_TEST_CASE(HNSWGraphStructureTest)
+{
+  const size_t m = 6;
+  arma::mat referenceData(4, 1000, arma::fill::randu);
+  HNSWSearch<> hnsw(std::move(referenceData), m, 40);
+
+  BOOST_REQUIRE_EQUAL(hnsw.Level(hnsw.EntryPoint()), hnsw.MaxLevel());
+  for (size_t i = 0; i < hnsw.ReferenceSet().n_cols; ++i)
+  {
+    BOOST_REQUIRE_LE(hnsw.Level(i), hnsw.MaxLevel());
+    for (size_t l = 0; l <= hnsw.Level(i); ++l)
+    {
+      const std::vector<size_t>& links = hnsw.Neighbors(i, l);
+      BOOST_REQUIRE_LE(links.size(), (l == 0) ? 2 * m : m);
+      for (size_t j = 0; j < links.size(); ++j)
+      {
+        BOOST_REQUIRE_NE(links[j], i);
+        BOOST_REQUIRE_GE(hnsw.Level(links[j]), l);
+      }
+    }
+
+    // Every point but a lone first point must be linked to something.
+    BOOST_REQUIRE_GT(hnsw.Neighbors(i, 0).size(), 0);
+  }
+}
+
+/**
+ * The graph can be built with the metric induced by a kernel.  The Gaussian
+ * kernel induces a metric that is monotonic in the Euclidean distance, so the
+ * neighbors must mostly be the Euclidean neighbors.
+ */
+BOOST_AUTO_TEST_CASE(HNSWIPMetricTest)
+{
+  typedef IPMetric<kernel::GaussianKernel> MetricType;
+
+  arma::mat referenceData(8, 500, arma::fill::randu);
+  arma::mat queryData(8, 50, arma::fill::randu);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 5, trueNeighbors, trueDistances);
+
+  kernel::GaussianKernel gk(2.0);
+  MetricType metric(gk);
+  HNSWSearch<MetricType> hnsw(referenceData, 12, 100, 100, metric);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 5, neighbors, distances);
+
+  BOOST_REQUIRE_GE(HNSWSearch<MetricType>::ComputeRecall(neighbors,
+      trueNeighbors), 0.95);
+}
+
+/**
+ * Invalid parameters must be rejected.
+ */
+BOOST_AUTO_TEST_CASE(HNSWInvalidParametersTest)
+{
+  arma::mat referenceData(3, 20, arma::fill::randu);
+  arma::mat emptyData;
+
+  HNSWSearch<> hnsw;
+  BOOST_REQUIRE_THROW(hnsw.Train(emptyData), std::invalid_argument);
+  BOOST_REQUIRE_THROW(hnsw.Train(referenceData, 1), std::invalid_argument);
+
+  hnsw.Train(referenceData, 4, 10);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  arma::mat queryData(3, 5, arma::fill::randu);
+  arma::mat wrongQueryData(4, 5, arma::fill::randu);
+  BOOST_REQUIRE_THROW(hnsw.Search(queryData, 21, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(hnsw.Search(20, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(hnsw.Search(wrongQueryData, 2, neighbors, distances),
+      std::invalid_argument);
+
+  // The recall can only be computed for matrices of the same size.
+  arma::Mat<size_t> found(3, 4, arma::fill::zeros);
+  arma::Mat<size_t> real(3, 5, arma::fill::zeros);
+  BOOST_REQUIRE_THROW(HNSWSearch<>::ComputeRecall(found, real),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -970,6 +970,212 @@ BOOST_AUTO_TEST_CASE(MajorityProbabilityTest)
   BOOST_REQUIRE_CLOSE(probability, 0.625, 1e-5);
 }
 
+/**
+ * Make sure the two given trees are the same.
+ */
+template<typename TreeType>
+void CheckSameTree(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_EQUAL(a.SplitDimension(), b.SplitDimension());
+  BOOST_REQUIRE_EQUAL(a.MajorityClass(), b.MajorityClass());
+  BOOST_REQUIRE_EQUAL(a.MajorityProbability(), b.MajorityProbability());
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Streaming a dataset through a tree in mini-batches of various sizes must give
+ * exactly the same tree as training on one point at a time.
+ */
+template<template<typename> class NumericSplitType>
+void CheckMiniBatchStreaming()
+{
+  // Two numeric features and one categorical feature, all related to the label.
+  arma::mat dataset(3, 6000);
+  arma::Row<size_t> labels(6000);
+  data::DatasetInfo info(3);
+  info.MapString<double>("a", 2);
+  info.MapString<double>("b", 2);
+  info.MapString<double>("c", 2);
+  for (size_t i = 0; i < 6000; ++i)
+  {
+    labels[i] = RandInt(3);
+    dataset(0, i) = Random() + 0.5 * labels[i];
+    dataset(1, i) = Random() - 0.3 * labels[i];
+    dataset(2, i) = (Random() < 0.7) ? labels[i] : RandInt(3);
+  }
+
+  typedef HoeffdingTree<GiniImpurity, NumericSplitType> TreeType;
+  TreeType pointTree(info, 3, 0.95, 5000, 50, 50);
+  for (size_t i = 0; i < 6000; ++i)
+    pointTree.Train(dataset.col(i), labels[i]);
+
+  // The tree should have grown a bit, or the test wouldn't test much.
+  BOOST_REQUIRE_GT(pointTree.NumDescendants(), 2);
+
+  const size_t batchSizes[] = { 1, 7, 50, 333, 6000 };
+  for (size_t b = 0; b < 5; ++b)
+  {
+    TreeType batchTree(info, 3, 0.95, 5000, 50, 50);
+    for (size_t begin = 0; begin < 6000; begin += batchSizes[b])
+    {
+      const size_t end = std::min(begin + batchSizes[b], size_t(6000));
+      arma::mat batch = dataset.cols(begin, end - 1);
+      arma::Row<size_t> batchLabels = labels.cols(begin, end - 1);
+      batchTree.Train(batch, batchLabels, false);
+    }
+
+    CheckSameTree(pointTree, batchTree);
+
+    arma::Row<size_t> pointPredictions, batchPredictions;
+    arma::rowvec pointProbabilities, batchProbabilities;
+    pointTree.Classify(dataset, pointPredictions, pointProbabilities);
+    batchTree.Classify(dataset, batchPredictions, batchProbabilities);
+    for (size_t i = 0; i < 6000; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(pointPredictions[i], batchPredictions[i]);
+      BOOST_REQUIRE_EQUAL(pointProbabilities[i], batchProbabilities[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(MiniBatchStreamingTest)
+{
+  CheckMiniBatchStreaming<HoeffdingDoubleNumericSplit>();
+}
+
+BOOST_AUTO_TEST_CASE(BinaryMiniBatchStreamingTest)
+{
+  CheckMiniBatchStreaming<BinaryDoubleNumericSplit>();
+}
+
+/**
+ * Count the leaves of the given tree (or only the active ones).
+ */
+template<typename TreeType>
+size_t CountLeaves(const TreeType& tree, const bool activeOnly)
+{
+  if (tree.NumChildren() == 0)
+    return (tree.Active() || !activeOnly) ? 1 : 0;
+
+  size_t count = 0;
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    count += CountLeaves(tree.Child(i), activeOnly);
+  return count;
+}
+
+/**
+ * With a memory budget, streaming training should keep the tree within the
+ * budget by deactivating leaves, and still give a useful tree.
+ */
+BOOST_AUTO_TEST_CASE(MaxMemoryTest)
+{
+  // The binary numeric split stores every point, so without a budget the
+  // memory grows with the number of points.
+  const size_t numPoints = 20000;
+  arma::mat dataset(5, numPoints);
+  arma::Row<size_t> labels(numPoints);
+  data::DatasetInfo info(5);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    labels[i] = RandInt(3);
+    for (size_t d = 0; d < 5; ++d)
+      dataset(d, i) = Random() + 0.2 * (d + 1) * labels[i];
+  }
+
+  typedef HoeffdingTree<GiniImpurity, BinaryDoubleNumericSplit> TreeType;
+  TreeType fullTree(info, 3);
+  fullTree.Train(dataset, labels, false);
+  BOOST_REQUIRE_GT(fullTree.NumDescendants(), 2);
+  BOOST_REQUIRE_EQUAL(CountLeaves(fullTree, true), CountLeaves(fullTree,
+      false));
+
+  const size_t maxMemory = fullTree.MemoryUsage() / 4;
+  TreeType tree(info, 3);
+  tree.MaxMemory(maxMemory);
+  TreeType pointTree(info, 3);
+  pointTree.MaxMemory(maxMemory);
+  for (size_t begin = 0; begin < numPoints; begin += 1000)
+  {
+    // The budget is checked every 100 points, so it holds after each batch.
+    arma::mat batch = dataset.cols(begin, begin + 999);
+    arma::Row<size_t> batchLabels = labels.cols(begin, begin + 999);
+    tree.Train(batch, batchLabels, false);
+    BOOST_REQUIRE_LE(tree.MemoryUsage(), maxMemory);
+
+    for (size_t i = begin; i < begin + 1000; ++i)
+      pointTree.Train(dataset.col(i), labels[i]);
+  }
+
+  // Some leaves must have been deactivated.
+  BOOST_REQUIRE_GT(tree.NumDescendants(), 2);
+  BOOST_REQUIRE_LT(CountLeaves(tree, true), CountLeaves(tree, false));
+
+  // Training on one point at a time checks the memory at the same points.
+  CheckSameTree(tree, pointTree);
+
+  // The tree should still be better than chance.
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset, predictions);
+  const size_t correct = arma::accu(predictions == labels);
+  BOOST_REQUIRE_GT(correct, numPoints / 2);
+
+  // The budget and the deactivated leaves are kept by serialization.
+  TreeType xmlTree, textTree, binaryTree;
+  SerializeObjectAll(tree, xmlTree, textTree, binaryTree);
+  BOOST_REQUIRE_EQUAL(binaryTree.MaxMemory(), maxMemory);
+  BOOST_REQUIRE_EQUAL(CountLeaves(binaryTree, true), CountLeaves(tree, true));
+  CheckSameTree(tree, xmlTree);
+  CheckSameTree(tree, textTree);
+  CheckSameTree(tree, binaryTree);
+  BOOST_REQUIRE_EQUAL(binaryTree.MemoryUsage(), tree.MemoryUsage());
+}
+
+/**
+ * A leaf that drops its poor attributes should stop keeping statistics for
+ * dimensions that are only noise, but still split on the right dimension.
+ */
+BOOST_AUTO_TEST_CASE(DropPoorAttributesTest)
+{
+  // The first two dimensions are the same and give the label, so the leaf
+  // can't choose between them for a while; the others are noise.
+  arma::mat dataset(6, 2000);
+  arma::Row<size_t> labels(2000);
+  data::DatasetInfo info(6);
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    dataset(0, i) = Random();
+    dataset(1, i) = dataset(0, i);
+    for (size_t d = 2; d < 6; ++d)
+      dataset(d, i) = Random();
+    labels[i] = (dataset(0, i) > 0.5) ? 1 : 0;
+  }
+
+  typedef HoeffdingTree<GiniImpurity, BinaryDoubleNumericSplit> TreeType;
+  TreeType tree(info, 2, 0.999999);
+  TreeType dropTree(info, 2, 0.999999);
+  dropTree.DropPoorAttributes(true);
+  BOOST_REQUIRE_EQUAL(dropTree.DropPoorAttributes(), true);
+
+  arma::mat start = dataset.cols(0, 599);
+  arma::Row<size_t> startLabels = labels.cols(0, 599);
+  tree.Train(start, startLabels, false);
+  dropTree.Train(start, startLabels, false);
+
+  // Neither tree has split yet, but the noise dimensions were dropped.
+  BOOST_REQUIRE_EQUAL(tree.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(dropTree.NumChildren(), 0);
+  BOOST_REQUIRE_LT(dropTree.MemoryUsage(), tree.MemoryUsage() / 2);
+
+  arma::mat rest = dataset.cols(600, 1999);
+  arma::Row<size_t> restLabels = labels.cols(600, 1999);
+  dropTree.Train(rest, restLabels, false);
+  BOOST_REQUIRE_GT(dropTree.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(dropTree.SplitDimension(), 0);
+}
+
 /**
  * Make sure that batch training mode outperforms non-batch mode.
  */
@@ -12,6 +12,7 @@
 #include <mlpack/core/cv/metrics/mse.hpp>
 #include <mlpack/core/cv/metrics/accuracy.hpp>
 #include <mlpack/core/cv/simple_cv.hpp>
+#include <mlpack/core/cv/k_fold_cv.hpp>
 #include <mlpack/core/hpt/cv_function.hpp>
 #include <mlpack/core/hpt/fixed.hpp>
 #include <mlpack/core/hpt/hpt.hpp>
@@ -228,6 +229,101 @@ BOOST_AUTO_TEST_CASE(GridSearchTest)
   BOOST_REQUIRE_CLOSE(expectedLambda2, actualParameters(1, 0), 1e-5);
 }
 
+/**
+ * A simple function whose Evaluate() can be called from several threads at
+ * once, used to test parallel grid search.
+ */
+class QuadraticGridFunction
+{
+ public:
+  double Evaluate(const arma::mat& parameters)
+  {
+    return std::pow(parameters(0) - 2.0, 2.0) +
+        std::pow(parameters(1) + 1.0, 2.0);
+  }
+};
+
+/**
+ * Test that grid search finds the same point when the grid is evaluated in
+ * parallel.
+ */
+BOOST_AUTO_TEST_CASE(GridSearchParallelTest)
+{
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 2);
+  for (double x : {0.0, 1.0, 2.0, 3.0, 4.0})
+    datasetInfo.MapString<size_t>(x, 0);
+  for (double y : {-2.0, -1.0, 0.0, 1.0})
+    datasetInfo.MapString<size_t>(y, 1);
+
+  QuadraticGridFunction f;
+  arma::mat serialParameters, parallelParameters, copyParameters;
+  const double serialObjective = GridSearch().Optimize(f, serialParameters,
+      datasetInfo);
+  const double parallelObjective = GridSearch(PARALLEL_EVALUATION).Optimize(f,
+      parallelParameters, datasetInfo);
+  const double copyObjective = GridSearch(PARALLEL_COPY_EVALUATION).Optimize(f,
+      copyParameters, datasetInfo);
+
+  BOOST_REQUIRE_SMALL(serialObjective, 1e-10);
+  BOOST_REQUIRE_SMALL(parallelObjective, 1e-10);
+  BOOST_REQUIRE_SMALL(copyObjective, 1e-10);
+  for (const arma::mat& parameters :
+      {serialParameters, parallelParameters, copyParameters})
+  {
+    BOOST_REQUIRE_CLOSE(parameters(0), 2.0, 1e-5);
+    BOOST_REQUIRE_CLOSE(parameters(1), -1.0, 1e-5);
+  }
+}
+
+/**
+ * Test HyperParameterTuner with k-fold cross-validation whose folds are
+ * evaluated in parallel, and with configurations abandoned early.
+ */
+BOOST_AUTO_TEST_CASE(HPTKFoldCVParallelTest)
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double serialLambda1, serialLambda2;
+  HyperParameterTuner<LARS, MSE, KFoldCV, GridSearch> serialHpt(4, xs, ys,
+      false);
+  std::tie(serialLambda1, serialLambda2) = serialHpt.Optimize(
+      Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  double parallelLambda1, parallelLambda2;
+  HyperParameterTuner<LARS, MSE, KFoldCV, GridSearch> parallelHpt(4, xs, ys,
+      false);
+  parallelHpt.CV().Parallel() = true;
+  std::tie(parallelLambda1, parallelLambda2) = parallelHpt.Optimize(
+      Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  BOOST_REQUIRE_CLOSE(serialHpt.BestObjective(), parallelHpt.BestObjective(),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(serialLambda1, parallelLambda1, 1e-5);
+  BOOST_REQUIRE_CLOSE(serialLambda2, parallelLambda2, 1e-5);
+
+  // An abandoned configuration is never the best one, so the best objective
+  // is the full cross-validation score of the returned configuration.
+  double earlyLambda1, earlyLambda2;
+  HyperParameterTuner<LARS, MSE, KFoldCV, GridSearch> earlyHpt(4, xs, ys,
+      false);
+  earlyHpt.CV().MinFolds() = 1;
+  std::tie(earlyLambda1, earlyLambda2) = earlyHpt.Optimize(
+      Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  KFoldCV<LARS, MSE> cv(4, xs, ys, false);
+  BOOST_REQUIRE_CLOSE(earlyHpt.BestObjective(), cv.Evaluate(transposeData,
+      useCholesky, earlyLambda1, earlyLambda2), 1e-5);
+}
+
 /**
  * Test HyperParameterTuner.
  */
@@ -266,6 +266,65 @@ BOOST_AUTO_TEST_CASE(ListwiseDeletionTest)
   BOOST_REQUIRE_CLOSE(rowWiseInput(1, 3), 8.0, 1e-5);
 }
 
+/**
+ * Impute a large dataset with many missing values (split between threads) and
+ * compare with statistics computed directly.
+ */
+BOOST_AUTO_TEST_CASE(LargeImputationTest)
+{
+  arma::mat input = arma::randu<arma::mat>(4, 10001);
+  for (size_t i = 0; i < input.n_cols; i += 3)
+    input(1, i) = -1.0;
+  for (size_t i = 1; i < input.n_cols; i += 7)
+    input(1, i) = arma::datum::nan;
+
+  std::vector<double> valid;
+  for (size_t i = 0; i < input.n_cols; ++i)
+    if (input(1, i) != -1.0 && !std::isnan(input(1, i)))
+      valid.push_back(input(1, i));
+  const arma::vec validValues(valid);
+  const double mean = arma::mean(validValues);
+  const double median = arma::median(validValues);
+
+  arma::mat meanInput(input), medianInput(input), deletionInput(input);
+  MeanImputation<double>().Impute(meanInput, -1.0, 1, true);
+  MedianImputation<double>().Impute(medianInput, -1.0, 1, true);
+  ListwiseDeletion<double>().Impute(deletionInput, -1.0, 1, true);
+
+  BOOST_REQUIRE_EQUAL(deletionInput.n_cols, valid.size());
+  BOOST_REQUIRE_EQUAL(deletionInput.n_rows, input.n_rows);
+
+  size_t kept = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const bool missing = (input(1, i) == -1.0 || std::isnan(input(1, i)));
+    BOOST_REQUIRE_CLOSE(meanInput(1, i), missing ? mean : input(1, i), 1e-5);
+    BOOST_REQUIRE_CLOSE(medianInput(1, i), missing ? median : input(1, i),
+        1e-5);
+    for (size_t d = 0; d < input.n_rows; d += 2)
+    {
+      BOOST_REQUIRE_EQUAL(meanInput(d, i), input(d, i));
+      BOOST_REQUIRE_EQUAL(medianInput(d, i), input(d, i));
+    }
+
+    if (!missing)
+    {
+      for (size_t d = 0; d < input.n_rows; ++d)
+        BOOST_REQUIRE_EQUAL(deletionInput(d, kept), input(d, i));
+      ++kept;
+    }
+  }
+
+  // Row-wise deletion of the transposed dataset gives the transposed result.
+  arma::mat rowWiseInput = input.t();
+  ListwiseDeletion<double>().Impute(rowWiseInput, -1.0, 1, false);
+  BOOST_REQUIRE_EQUAL(rowWiseInput.n_rows, deletionInput.n_cols);
+  BOOST_REQUIRE_EQUAL(rowWiseInput.n_cols, deletionInput.n_rows);
+  for (size_t i = 0; i < rowWiseInput.n_rows; ++i)
+    for (size_t d = 0; d < rowWiseInput.n_cols; ++d)
+      BOOST_REQUIRE_EQUAL(rowWiseInput(i, d), deletionInput(d, i));
+}
+
 /**
  * Make sure we can map non-strings.
  */
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/optimizers/iqn/iqn.hpp>
+#include <mlpack/core/optimizers/iqn/liqn.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -85,4 +86,48 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionTest)
   }
 }
 
+/**
+ * Run limited-memory IQN on logistic regression and make sure the results are
+ * acceptable.
+ */
+BOOST_AUTO_TEST_CASE(LIQNLogisticRegressionTest)
+{
+  // Generate a two-Gaussian dataset.
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("9.0 9.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(3, 1000);
+  arma::Row<size_t> responses(1000);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    data.col(i) = g1.Random();
+    responses[i] = 0;
+  }
+  for (size_t i = 500; i < 1000; ++i)
+  {
+    data.col(i) = g2.Random();
+    responses[i] = 1;
+  }
+
+  // Shuffle the dataset.
+  arma::uvec indices = arma::shuffle(arma::linspace<arma::uvec>(0,
+      data.n_cols - 1, data.n_cols));
+  arma::mat shuffledData = data.cols(indices);
+  arma::Row<size_t> shuffledResponses = responses.cols(indices);
+
+  // Run with a couple of batch sizes and history lengths.
+  for (size_t batchSize = 1; batchSize < 9; batchSize += 4)
+  {
+    for (size_t numBasis = 2; numBasis <= 10; numBasis += 8)
+    {
+      LIQN liqn(0.01, batchSize, 5000, 1e-3, numBasis);
+      LogisticRegression<> lr(shuffledData, shuffledResponses, liqn, 0.5);
+
+      // Ensure that the error is close to zero.
+      const double acc = lr.ComputeAccuracy(data, responses);
+      BOOST_REQUIRE_CLOSE(acc, 100.0, 1.3); // 1.3% error tolerance.
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,188 @@
+/**
+ * @file kde_test.cpp
+ *
+ * Tests for the KDE class and KDEModel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/kernels/epanechnikov_kernel.hpp>
+#include <mlpack/methods/kde/kde.hpp>
+#include <mlpack/methods/kde/kde_model.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kde;
+using namespace mlpack::kernel;
+using namespace mlpack::metric;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(KDETest);
+
+/**
+ * Check the naive estimates on a tiny dataset by hand.
+ */
+BOOST_AUTO_TEST_CASE(KDENaiveTest)
+{
+  arma::mat referenceSet("0.0 1.0 3.0");
+  arma::mat querySet("0.0 2.0");
+
+  KDE<> kde(0.0, 0.0, GaussianKernel(1.0), KDE_NAIVE_MODE);
+  kde.Train(referenceSet);
+
+  arma::vec estimations;
+  kde.Evaluate(querySet, estimations);
+
+  BOOST_REQUIRE_EQUAL(estimations.n_elem, 2);
+  BOOST_REQUIRE_CLOSE(estimations[0],
+      (1.0 + std::exp(-0.5) + std::exp(-4.5)) / 3.0, 1e-10);
+  BOOST_REQUIRE_CLOSE(estimations[1],
+      (std::exp(-2.0) + 2 * std::exp(-0.5)) / 3.0, 1e-10);
+}
+
+/**
+ * Check that the estimates of the given mode are within the error tolerance of
+ * the naive estimates.
+ */
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckErrorBounds(const KernelType& kernel,
+                      const double relError,
+                      const double absError,
+                      const KDEMode mode)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 300);
+
+  KDE<KernelType, EuclideanDistance, arma::mat, TreeType> naive(0.0, 0.0,
+      kernel, KDE_NAIVE_MODE);
+  naive.Train(referenceSet);
+  KDE<KernelType, EuclideanDistance, arma::mat, TreeType> kde(relError,
+      absError, kernel, mode);
+  kde.Train(referenceSet);
+
+  arma::vec naiveEstimations, estimations;
+  naive.Evaluate(querySet, naiveEstimations);
+  kde.Evaluate(querySet, estimations);
+
+  BOOST_REQUIRE_EQUAL(estimations.n_elem, querySet.n_cols);
+  for (size_t i = 0; i < estimations.n_elem; ++i)
+  {
+    BOOST_REQUIRE_LE(std::abs(estimations[i] - naiveEstimations[i]),
+        relError * naiveEstimations[i] + absError + 1e-12);
+  }
+
+  // Some work has to be saved.
+  BOOST_REQUIRE_LT(kde.BaseCases(), naive.BaseCases());
+}
+
+/**
+ * Make sure the single-tree and dual-tree estimates with a Gaussian kernel are
+ * within the relative error tolerance, with both tree types.
+ */
+BOOST_AUTO_TEST_CASE(KDEGaussianRelativeErrorTest)
+{
+  CheckErrorBounds<GaussianKernel, KDTree>(GaussianKernel(2.0), 0.05, 0.0,
+      KDE_SINGLE_TREE_MODE);
+  CheckErrorBounds<GaussianKernel, KDTree>(GaussianKernel(2.0), 0.05, 0.0,
+      KDE_DUAL_TREE_MODE);
+  CheckErrorBounds<GaussianKernel, BallTree>(GaussianKernel(2.0), 0.05, 0.0,
+      KDE_SINGLE_TREE_MODE);
+  CheckErrorBounds<GaussianKernel, BallTree>(GaussianKernel(2.0), 0.05, 0.0,
+      KDE_DUAL_TREE_MODE);
+}
+
+/**
+ * Make sure the single-tree and dual-tree estimates with an Epanechnikov
+ * kernel are within the absolute error tolerance.
+ */
+BOOST_AUTO_TEST_CASE(KDEEpanechnikovAbsoluteErrorTest)
+{
+  CheckErrorBounds<EpanechnikovKernel, KDTree>(EpanechnikovKernel(0.2), 0.0,
+      0.01, KDE_SINGLE_TREE_MODE);
+  CheckErrorBounds<EpanechnikovKernel, KDTree>(EpanechnikovKernel(0.2), 0.0,
+      0.01, KDE_DUAL_TREE_MODE);
+}
+
+/**
+ * Make sure that monochromatic estimation gives the same results as
+ * bichromatic estimation with the reference set as the query set.
+ */
+BOOST_AUTO_TEST_CASE(KDEMonochromaticTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 500);
+
+  for (size_t m = 0; m < 3; ++m)
+  {
+    const KDEMode mode = (m == 0) ? KDE_NAIVE_MODE : (m == 1) ?
+        KDE_SINGLE_TREE_MODE : KDE_DUAL_TREE_MODE;
+    KDE<> kde(0.02, 0.0, GaussianKernel(0.5), mode);
+    kde.Train(dataset);
+
+    arma::vec monoEstimations, biEstimations;
+    kde.Evaluate(monoEstimations);
+    kde.Evaluate(dataset, biEstimations);
+
+    BOOST_REQUIRE_EQUAL(monoEstimations.n_elem, dataset.n_cols);
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      // The trees may not be identical, so approximations may differ by up to
+      // twice the tolerance.
+      BOOST_REQUIRE_LE(std::abs(monoEstimations[i] - biEstimations[i]),
+          0.04 * biEstimations[i] + 1e-12);
+    }
+  }
+}
+
+/**
+ * Make sure that invalid uses throw.
+ */
+BOOST_AUTO_TEST_CASE(KDEInvalidTest)
+{
+  arma::vec estimations;
+
+  KDE<> untrained;
+  BOOST_REQUIRE_THROW(untrained.Evaluate(estimations), std::runtime_error);
+
+  BOOST_REQUIRE_THROW(KDE<>(-0.1), std::invalid_argument);
+
+  KDE<> kde;
+  kde.Train(arma::randu<arma::mat>(3, 100));
+  BOOST_REQUIRE_THROW(kde.Evaluate(arma::randu<arma::mat>(4, 10), estimations),
+      std::invalid_argument);
+
+  KDEModel model(0.0);
+  BOOST_REQUIRE_THROW(model.BuildModel(arma::randu<arma::mat>(3, 100)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that the normalized estimates of KDEModel integrate to 1 in one
+ * dimension, for each kernel.
+ */
+BOOST_AUTO_TEST_CASE(KDEModelNormalizationTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(1, 200);
+  arma::mat grid = arma::linspace<arma::rowvec>(-1.0, 2.0, 3001);
+
+  for (size_t k = 0; k < 2; ++k)
+  {
+    KDEModel model(0.1, 0.01, 0.0, (k == 0) ? KDEModel::GAUSSIAN_KERNEL :
+        KDEModel::EPANECHNIKOV_KERNEL, (k == 0) ? KDEModel::KD_TREE :
+        KDEModel::BALL_TREE);
+    model.BuildModel(arma::mat(referenceSet));
+
+    arma::vec estimations;
+    model.Evaluate(arma::mat(grid), estimations);
+
+    BOOST_REQUIRE_CLOSE(arma::accu(estimations) * 0.001, 1.0, 2.0);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -11,7 +11,9 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/block_krylov_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_pca.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -150,4 +152,60 @@ BOOST_AUTO_TEST_CASE(CircleTransformationTestNystroem)
   BOOST_REQUIRE_EQUAL(ranges[1].Contains(ranges[2]), false);
 }
 
+/**
+ * The block Krylov rule should find the same top eigenvalues and transformed
+ * data as the full eigendecomposition of the naive rule.
+ */
+BOOST_AUTO_TEST_CASE(BlockKrylovNaiveTest)
+{
+  // Give each dimension a different variance, so the eigenvalues are well
+  // separated.
+  arma::mat dataset(5, 400);
+  dataset.randn();
+  for (size_t d = 0; d < dataset.n_rows; ++d)
+    dataset.row(d) *= (dataset.n_rows - d);
+
+  arma::mat naiveData, krylovData, naiveVec, krylovVec;
+  arma::vec naiveVal, krylovVal;
+
+  // With a linear kernel the centered kernel matrix has rank 5, so the
+  // solution should be (nearly) exact.
+  KernelPCA<LinearKernel> naive;
+  KernelPCA<LinearKernel, BlockKrylovKernelRule<LinearKernel>> krylov;
+  naive.Apply(dataset, naiveData, naiveVal, naiveVec);
+  krylov.Apply(dataset, krylovData, krylovVal, krylovVec, 3);
+
+  BOOST_REQUIRE_EQUAL(krylovVal.n_elem, 3);
+  BOOST_REQUIRE_EQUAL(krylovVec.n_rows, dataset.n_cols);
+  BOOST_REQUIRE_EQUAL(krylovVec.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(krylovData.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(krylovData.n_cols, dataset.n_cols);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(krylovVal[i], naiveVal[i], 1e-5);
+
+    // The components are only defined up to their sign.
+    const double sign = (arma::dot(krylovData.row(i), naiveData.row(i)) < 0) ?
+        -1.0 : 1.0;
+    BOOST_REQUIRE_SMALL(arma::norm(sign * krylovData.row(i) -
+        naiveData.row(i)) / arma::norm(naiveData.row(i)), 1e-5);
+  }
+
+  // With a Gaussian kernel the top eigenvalues should still be accurate.
+  KernelPCA<GaussianKernel> naiveGaussian(GaussianKernel(5.0));
+  KernelPCA<GaussianKernel, BlockKrylovKernelRule<GaussianKernel>>
+      krylovGaussian(GaussianKernel(5.0));
+  naiveGaussian.Apply(dataset, naiveData, naiveVal, naiveVec);
+  krylovGaussian.Apply(dataset, krylovData, krylovVal, krylovVec, 3);
+  BOOST_REQUIRE_EQUAL(krylovVal.n_elem, 3);
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(krylovVal[i], naiveVal[i], 1.0);
+
+  // Reducing the dimensionality in place should keep the top components.
+  arma::mat reduced(dataset);
+  krylovGaussian.Apply(reduced, 2);
+  BOOST_REQUIRE_EQUAL(reduced.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(reduced.n_cols, dataset.n_cols);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
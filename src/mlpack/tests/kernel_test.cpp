@@ -19,6 +19,8 @@
 #include <mlpack/core/kernels/polynomial_kernel.hpp>
 #include <mlpack/core/kernels/spherical_kernel.hpp>
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+#include <mlpack/core/kernels/triangular_kernel.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 
@@ -208,6 +210,54 @@ BOOST_AUTO_TEST_CASE(MDFullCovarianceTest)
   BOOST_REQUIRE_CLOSE(md.Evaluate(b, a), 15.7, 1e-5);
 }
 
+/**
+ * Make sure that the Euclidean distance between points stretched by the factor
+ * of the covariance matrix, and the batch Evaluate(), give the same distances
+ * as Evaluate(), for a positive definite and for a singular covariance matrix.
+ */
+BOOST_AUTO_TEST_CASE(MDTransformationTest)
+{
+  arma::mat r = arma::randu<arma::mat>(3, 5);
+  arma::mat covariances[2] = { r.t() * r + arma::eye<arma::mat>(5, 5),
+                               r.t() * r };
+
+  for (size_t c = 0; c < 2; ++c)
+  {
+    MahalanobisDistance<true> md(covariances[c]);
+
+    const arma::mat& l = md.Transformation();
+    const arma::mat product = l.t() * l;
+    for (size_t i = 0; i < product.n_elem; ++i)
+      BOOST_REQUIRE_SMALL(product[i] - covariances[c][i], 1e-8);
+
+    arma::mat a = arma::randu<arma::mat>(5, 20);
+    arma::mat b = arma::randu<arma::mat>(5, 15);
+    arma::mat stretchedA, stretchedB, distances;
+    md.Transform(a, stretchedA);
+    md.Transform(b, stretchedB);
+    md.Evaluate(a, b, distances);
+
+    BOOST_REQUIRE_EQUAL(distances.n_rows, a.n_cols);
+    BOOST_REQUIRE_EQUAL(distances.n_cols, b.n_cols);
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      for (size_t j = 0; j < b.n_cols; ++j)
+      {
+        const double d = md.Evaluate(a.col(i), b.col(j));
+        BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(stretchedA.col(i),
+            stretchedB.col(j)), d, 1e-5);
+        BOOST_REQUIRE_CLOSE(distances(i, j), d, 1e-5);
+      }
+    }
+  }
+
+  // Changing the covariance matrix has to reset the factor.
+  MahalanobisDistance<false> md(3);
+  BOOST_REQUIRE_CLOSE(md.Transformation()(0, 0), 1.0, 1e-5);
+  md.Covariance() *= 4.0;
+  BOOST_REQUIRE_CLOSE(md.Transformation()(0, 0), 2.0, 1e-5);
+}
+
 /**
  * Simple test case for the cosine distance.
  */
@@ -608,4 +658,132 @@ BOOST_AUTO_TEST_CASE(PSpectrumStringEvaluateTest)
   BOOST_REQUIRE_CLOSE(p.Evaluate(b, a), 11.0, 1e-5);
 }
 
+/**
+ * Make sure that the sparse p-spectra give the same evaluations as the counts
+ * of the substrings, and that the kernel matrix can be computed from them.
+ */
+BOOST_AUTO_TEST_CASE(PSpectrumStringSparseSpectrumTest)
+{
+  std::vector<std::vector<std::string> > datasets(2);
+  datasets[0].push_back("mellow jello");
+  datasets[0].push_back("hello yellow fellow");
+  datasets[0].push_back("obloblobloblob");
+  datasets[1].push_back("jell-o is yellow");
+  datasets[1].push_back("blob");
+  datasets[1].push_back("");
+
+  PSpectrumStringKernel p(datasets, 3);
+
+  arma::mat strings("0 0 0 1 1 1; 0 1 2 0 1 2");
+  arma::mat kernelMatrix;
+  KernelMatrix<PSpectrumStringKernel>::Compute(strings, p, kernelMatrix);
+
+  arma::mat sparseEvaluations(strings.n_cols, strings.n_cols);
+  for (size_t i = 0; i < strings.n_cols; ++i)
+    for (size_t j = 0; j < strings.n_cols; ++j)
+      sparseEvaluations(i, j) = p.Evaluate(strings.col(i), strings.col(j));
+
+  // Modifying the counts discards the sparse spectra, so the counts are used.
+  p.Counts();
+  for (size_t i = 0; i < strings.n_cols; ++i)
+  {
+    for (size_t j = 0; j < strings.n_cols; ++j)
+    {
+      const double eval = p.Evaluate(strings.col(i), strings.col(j));
+      BOOST_REQUIRE_CLOSE(sparseEvaluations(i, j), eval, 1e-5);
+      BOOST_REQUIRE_CLOSE(kernelMatrix(i, j), eval, 1e-5);
+    }
+  }
+
+  // "obloblobloblob" has 4 "obl", 4 "blo" and 4 "lob", and "blob" has one
+  // "blo" and one "lob".
+  BOOST_REQUIRE_CLOSE(sparseEvaluations(2, 4), 8.0, 1e-5);
+  BOOST_REQUIRE_SMALL(sparseEvaluations(5, 0), 1e-5);
+
+  // Change a count and rebuild the spectra.
+  p.Counts()[1][1]["blo"] = 3;
+  p.IndexSubstrings();
+  BOOST_REQUIRE_CLOSE(p.Evaluate(strings.col(2), strings.col(4)), 16.0, 1e-5);
+}
+
+/**
+ * A kernel that is neither radial nor a function of the inner product, so
+ * KernelMatrix has to evaluate it on every pair of points.
+ */
+class L1ExponentialKernel
+{
+ public:
+  template<typename VecTypeA, typename VecTypeB>
+  double Evaluate(const VecTypeA& a, const VecTypeB& b) const
+  {
+    return std::exp(-arma::norm(a - b, 1));
+  }
+};
+
+/**
+ * Make sure that the kernel matrices computed by KernelMatrix hold the same
+ * values as direct evaluations of the kernel.
+ */
+template<typename KernelType>
+void CheckKernelMatrix(KernelType& kernel)
+{
+  // More points than one block of pairs.
+  arma::mat a = arma::randu<arma::mat>(5, 150);
+  arma::mat b = arma::randu<arma::mat>(5, 70);
+
+  arma::mat kernelMatrix;
+  KernelMatrix<KernelType>::Compute(a, b, kernel, kernelMatrix);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, 150);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, 70);
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      const double value = kernel.Evaluate(a.col(i), b.col(j));
+      if (std::abs(value) < 1e-8)
+        BOOST_REQUIRE_SMALL(kernelMatrix(i, j), 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(kernelMatrix(i, j), value, 1e-5);
+    }
+  }
+
+  arma::mat symmetricMatrix;
+  KernelMatrix<KernelType>::Compute(a, kernel, symmetricMatrix);
+  BOOST_REQUIRE_EQUAL(symmetricMatrix.n_rows, 150);
+  BOOST_REQUIRE_EQUAL(symmetricMatrix.n_cols, 150);
+  for (size_t j = 0; j < a.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      const double value = kernel.Evaluate(a.col(i), a.col(j));
+      if (std::abs(value) < 1e-8)
+        BOOST_REQUIRE_SMALL(symmetricMatrix(i, j), 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(symmetricMatrix(i, j), value, 1e-5);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(KernelMatrixTest)
+{
+  LinearKernel linear;
+  CheckKernelMatrix(linear);
+  PolynomialKernel polynomial(3.0, 0.5);
+  CheckKernelMatrix(polynomial);
+  HyperbolicTangentKernel tanh(0.5, 0.1);
+  CheckKernelMatrix(tanh);
+  CosineDistance cosine;
+  CheckKernelMatrix(cosine);
+  GaussianKernel gaussian(0.5);
+  CheckKernelMatrix(gaussian);
+  LaplacianKernel laplacian(0.5);
+  CheckKernelMatrix(laplacian);
+  EpanechnikovKernel epanechnikov(2.0);
+  CheckKernelMatrix(epanechnikov);
+  TriangularKernel triangular(2.0);
+  CheckKernelMatrix(triangular);
+  L1ExponentialKernel l1;
+  CheckKernelMatrix(l1);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
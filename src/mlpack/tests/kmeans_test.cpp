@@ -7,6 +7,8 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#include <atomic>
+
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/kmeans/kmeans.hpp>
@@ -18,6 +20,7 @@
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
 
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
@@ -703,6 +706,50 @@ BOOST_AUTO_TEST_CASE(DTNNCoverTreeTest)
   }
 }
 
+/**
+ * Make sure that the Pelleg-Moore and dual-tree algorithms still return the
+ * same clusters as the naive method when their trees are large enough to be
+ * split between threads, and their bounds are updated by separate tasks.
+ */
+BOOST_AUTO_TEST_CASE(LargeTreeKMeansTest)
+{
+  arma::mat dataset(3, 8000);
+  dataset.randu();
+
+  const size_t k = 40;
+  arma::mat centroids(3, k);
+  centroids.randu();
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km;
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      PellegMooreKMeans> pellegMoore;
+  arma::Row<size_t> pmAssignments;
+  arma::mat pmCentroids(centroids);
+  pellegMoore.Cluster(dataset, k, pmAssignments, pmCentroids, false, true);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      DefaultDualTreeKMeans> dtnn;
+  arma::Row<size_t> dtnnAssignments;
+  arma::mat dtnnCentroids(centroids);
+  dtnn.Cluster(dataset, k, dtnnAssignments, dtnnCentroids, false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(assignments[i], pmAssignments[i]);
+    BOOST_REQUIRE_EQUAL(assignments[i], dtnnAssignments[i]);
+  }
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(naiveCentroids[i], pmCentroids[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(naiveCentroids[i], dtnnCentroids[i], 1e-5);
+  }
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
@@ -737,4 +784,384 @@ BOOST_AUTO_TEST_CASE(SampleInitializationTest)
   }
 }
 
+/**
+ * Make sure that k-means can cluster single-precision data, and that it finds
+ * the same clusters as it does on the same data in double precision.
+ */
+template<template<class, class> class LloydStepType>
+void CheckFloatKMeans(const arma::fmat& dataset,
+                      const arma::mat& initialCentroids)
+{
+  const arma::mat doubleDataset = arma::conv_to<arma::mat>::from(dataset);
+  const size_t k = initialCentroids.n_cols;
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      LloydStepType> doubleKMeans;
+  arma::Row<size_t> assignments;
+  arma::mat centroids(initialCentroids);
+  doubleKMeans.Cluster(doubleDataset, k, assignments, centroids, false, true);
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      LloydStepType, arma::fmat> floatKMeans;
+  arma::Row<size_t> floatAssignments;
+  arma::mat floatCentroids(initialCentroids);
+  floatKMeans.Cluster(dataset, k, floatAssignments, floatCentroids, false,
+      true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], floatAssignments[i]);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(centroids[i], floatCentroids[i], 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE(FloatKMeansTest)
+{
+  // Three well-separated Gaussian clusters.
+  arma::fmat dataset(5, 900, arma::fill::randn);
+  dataset.cols(300, 599) += 20.0f;
+  dataset.cols(600, 899) -= 20.0f;
+
+  arma::mat initialCentroids(5, 3);
+  initialCentroids.col(0) = arma::conv_to<arma::vec>::from(dataset.col(0));
+  initialCentroids.col(1) = arma::conv_to<arma::vec>::from(dataset.col(300));
+  initialCentroids.col(2) = arma::conv_to<arma::vec>::from(dataset.col(600));
+
+  CheckFloatKMeans<NaiveKMeans>(dataset, initialCentroids);
+  CheckFloatKMeans<ElkanKMeans>(dataset, initialCentroids);
+  CheckFloatKMeans<HamerlyKMeans>(dataset, initialCentroids);
+  CheckFloatKMeans<PellegMooreKMeans>(dataset, initialCentroids);
+  CheckFloatKMeans<DefaultDualTreeKMeans>(dataset, initialCentroids);
+  CheckFloatKMeans<CoverTreeDualTreeKMeans>(dataset, initialCentroids);
+
+  // The initial partition policies must work with single-precision data too.
+  KMeans<EuclideanDistance, RefinedStart, MaxVarianceNewCluster, NaiveKMeans,
+      arma::fmat> refined;
+  arma::Row<size_t> assignments;
+  refined.Cluster(dataset, 3, assignments);
+
+  BOOST_REQUIRE_EQUAL(assignments.n_elem, dataset.n_cols);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    BOOST_REQUIRE_LT(assignments[i], 3);
+}
+
+/**
+ * Make sure that one iteration of the naive Lloyd step, which finds the closest
+ * centroids with blocked matrix products for the Euclidean distance, gives the
+ * same centroids and counts as a brute-force computation.
+ */
+BOOST_AUTO_TEST_CASE(NaiveKMeansIterateTest)
+{
+  arma::mat dataset(7, 5000, arma::fill::randu);
+  arma::mat centroids(7, 40, arma::fill::randu);
+
+  // Compute the result by hand.
+  arma::mat trueCentroids(7, 40, arma::fill::zeros);
+  arma::Col<size_t> trueCounts(40, arma::fill::zeros);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    size_t closest = 0;
+    double minDistance = DBL_MAX;
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = EuclideanDistance::Evaluate(dataset.col(i),
+          centroids.col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closest = j;
+      }
+    }
+
+    trueCentroids.col(closest) += dataset.col(i);
+    trueCounts[closest]++;
+  }
+
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+    if (trueCounts[j] != 0)
+      trueCentroids.col(j) /= trueCounts[j];
+
+  EuclideanDistance metric;
+  NaiveKMeans<EuclideanDistance, arma::mat> naive(dataset, metric);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+  naive.Iterate(centroids, newCentroids, counts);
+
+  BOOST_REQUIRE_EQUAL(newCentroids.n_rows, 7);
+  BOOST_REQUIRE_EQUAL(newCentroids.n_cols, 40);
+  BOOST_REQUIRE_EQUAL(counts.n_elem, 40);
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    BOOST_REQUIRE_EQUAL(counts[j], trueCounts[j]);
+    for (size_t d = 0; d < 7; ++d)
+      BOOST_REQUIRE_CLOSE(newCentroids(d, j), trueCentroids(d, j), 1e-5);
+  }
+}
+
+/**
+ * Make sure that mini-batch k-means finds the three clusters of the simple
+ * dataset, starting from one point of each class.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansTest)
+{
+  const arma::mat data = trans(kMeansData);
+  arma::mat centroids(2, 3);
+  centroids.col(0) = data.col(0);
+  centroids.col(1) = data.col(13);
+  centroids.col(2) = data.col(20);
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      MiniBatchKMeans> kmeans;
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(data, 3, assignments, centroids, false, true);
+
+  for (size_t i = 0; i < 30; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], (i < 13) ? 0 : ((i < 20) ? 1 : 2));
+
+  // The centroids should have converged to the means of the classes.
+  BOOST_REQUIRE_SMALL(arma::norm(centroids.col(0) -
+      arma::mean(data.cols(0, 12), 1)), 1e-3);
+  BOOST_REQUIRE_SMALL(arma::norm(centroids.col(1) -
+      arma::mean(data.cols(13, 19), 1)), 1e-3);
+  BOOST_REQUIRE_SMALL(arma::norm(centroids.col(2) -
+      arma::mean(data.cols(20, 29), 1)), 1e-3);
+}
+
+/**
+ * Stream a dataset in batches through KMeans::Update(), and make sure that
+ * each centroid ends up at the mean of its cluster, and that empty clusters are
+ * handled by the EmptyClusterPolicy.
+ */
+BOOST_AUTO_TEST_CASE(StreamingKMeansTest)
+{
+  // Three well-separated clusters, in random order.
+  arma::mat data(3, 3000, arma::fill::randn);
+  arma::Row<size_t> labels(3000);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    labels[i] = math::RandInt(3);
+    data.col(i) += 50.0 * labels[i];
+  }
+
+  // Start from one point of each cluster, plus a centroid that no point will
+  // ever be assigned to.
+  arma::mat initialCentroids(3, 4);
+  initialCentroids.col(3).fill(-1000.0);
+  for (size_t c = 0; c < 3; ++c)
+    initialCentroids.col(c) = data.col(arma::uvec(arma::find(labels == c))[0]);
+
+  KMeans<EuclideanDistance, SampleInitialization, AllowEmptyClusters> allow;
+  KMeans<EuclideanDistance, SampleInitialization, KillEmptyClusters> kill;
+  arma::mat allowCentroids(initialCentroids), killCentroids(initialCentroids);
+  arma::Col<size_t> allowCounts(4, arma::fill::zeros);
+  arma::Col<size_t> killCounts(4, arma::fill::zeros);
+  for (size_t b = 0; b < 10; ++b)
+  {
+    const arma::mat batch = data.cols(300 * b, 300 * (b + 1) - 1);
+    allow.Update(batch, 4, allowCentroids, allowCounts);
+    kill.Update(batch, 4, killCentroids, killCounts);
+  }
+
+  // The empty centroid stays where it was, or is removed.
+  BOOST_REQUIRE_EQUAL(allowCentroids.n_cols, 4);
+  BOOST_REQUIRE_EQUAL(allowCounts[3], 0);
+  for (size_t d = 0; d < 3; ++d)
+    BOOST_REQUIRE_CLOSE(allowCentroids(d, 3), -1000.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(killCentroids.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(killCounts.n_elem, 3);
+
+  // Each of the other centroids is the mean of its cluster.
+  for (size_t c = 0; c < 3; ++c)
+  {
+    const arma::uvec points = arma::find(labels == c);
+    const arma::vec mean = arma::mean(data.cols(points), 1);
+
+    BOOST_REQUIRE_EQUAL(allowCounts[c], points.n_elem);
+    BOOST_REQUIRE_EQUAL(killCounts[c], points.n_elem);
+    BOOST_REQUIRE_SMALL(arma::norm(allowCentroids.col(c) - mean), 1e-8);
+    BOOST_REQUIRE_SMALL(arma::norm(killCentroids.col(c) - mean), 1e-8);
+  }
+
+  // Without initial centroids, the first batch is used to find them.
+  KMeans<> kmeans;
+  arma::mat centroids;
+  arma::Col<size_t> counts;
+  kmeans.Update(data.cols(0, 299), 3, centroids, counts);
+  BOOST_REQUIRE_EQUAL(centroids.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(counts.n_elem, 3);
+  BOOST_REQUIRE_EQUAL(arma::accu(counts), 300);
+}
+
+/**
+ * Make sure that the best of many restarts finds well-separated clusters,
+ * and that the returned inertia is the inertia of the returned clustering.
+ */
+BOOST_AUTO_TEST_CASE(RestartsTest)
+{
+  // Three well-separated clusters.  A single run from sampled initial points
+  // only finds them when it samples one point of each cluster.
+  arma::mat data(2, 300, arma::fill::randn);
+  arma::Row<size_t> labels(300);
+  for (size_t i = 0; i < 300; ++i)
+  {
+    labels[i] = i % 3;
+    data(labels[i] % 2, i) += 100.0 * (1 + labels[i] / 2);
+  }
+
+  KMeans<> kmeans;
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  const double inertia = kmeans.ClusterWithRestarts(data, 3, 40, assignments,
+      centroids);
+
+  BOOST_REQUIRE_EQUAL(centroids.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(assignments.n_elem, 300);
+
+  // Each cluster is found.
+  for (size_t i = 3; i < 300; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[i % 3]);
+  BOOST_REQUIRE_NE(assignments[0], assignments[1]);
+  BOOST_REQUIRE_NE(assignments[0], assignments[2]);
+  BOOST_REQUIRE_NE(assignments[1], assignments[2]);
+
+  double expectedInertia = 0.0;
+  for (size_t i = 0; i < 300; ++i)
+  {
+    expectedInertia += std::pow(arma::norm(data.col(i) -
+        centroids.col(assignments[i])), 2.0);
+  }
+  BOOST_REQUIRE_CLOSE(inertia, expectedInertia, 1e-5);
+}
+
+/**
+ * The restarts must give the same clustering with one thread as with several
+ * for the same random seed.
+ */
+BOOST_AUTO_TEST_CASE(RestartsThreadsTest)
+{
+  arma::mat data(3, 600, arma::fill::randn);
+  for (size_t i = 0; i < 600; ++i)
+    data(i % 3, i) += 10.0 * (i % 4);
+
+  #ifdef HAS_OPENMP
+  const int numThreads = omp_get_max_threads();
+  #endif
+
+  // Pruning depends on the order the restarts finish in, so it is disabled.
+  arma::Row<size_t> assignments[2];
+  arma::mat centroids[2];
+  double inertias[2];
+  for (size_t t = 0; t < 2; ++t)
+  {
+    #ifdef HAS_OPENMP
+    omp_set_num_threads((t == 0) ? 1 : 4);
+    #endif
+
+    math::RandomSeed(42);
+    KMeans<> kmeans;
+    inertias[t] = kmeans.ClusterWithRestarts(data, 4, 12, assignments[t],
+        centroids[t], 5, 0.0);
+  }
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(numThreads);
+  #endif
+
+  BOOST_REQUIRE_EQUAL(inertias[0], inertias[1]);
+  BOOST_REQUIRE_EQUAL(arma::accu(assignments[0] != assignments[1]), 0);
+  BOOST_REQUIRE_EQUAL(arma::accu(centroids[0] != centroids[1]), 0);
+}
+
+/**
+ * An initial partition policy that starts the first restart from one point of
+ * each cluster, and every other restart from points of the first cluster only.
+ */
+class OneGoodRestartInitialization
+{
+ public:
+  OneGoodRestartInitialization() : calls(new std::atomic<size_t>(0)) { }
+
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids)
+  {
+    const bool good = ((*calls)++ == 0);
+    centroids.set_size(data.n_rows, clusters);
+    for (size_t i = 0; i < clusters; ++i)
+      centroids.col(i) = data.col(good ? i : 3 * i);
+  }
+
+ private:
+  std::shared_ptr<std::atomic<size_t>> calls;
+};
+
+/**
+ * The Euclidean distance, counting the number of times it is evaluated.
+ */
+class CountingDistance
+{
+ public:
+  CountingDistance() : count(new std::atomic<size_t>(0)) { }
+
+  template<typename VecTypeA, typename VecTypeB>
+  double Evaluate(const VecTypeA& a, const VecTypeB& b)
+  {
+    ++(*count);
+    return EuclideanDistance::Evaluate(a, b);
+  }
+
+  size_t Count() const { return *count; }
+
+ private:
+  std::shared_ptr<std::atomic<size_t>> count;
+};
+
+/**
+ * Restarts from a bad initialization must be pruned, without changing the
+ * result.
+ */
+BOOST_AUTO_TEST_CASE(RestartsPruningTest)
+{
+  // Three well-separated clusters, with the points of each cluster every three
+  // columns.
+  arma::mat data(2, 300, arma::fill::randn);
+  for (size_t i = 0; i < 300; ++i)
+    data((i % 3) % 2, i) += 100.0 * (1 + (i % 3) / 2);
+
+  // With one thread, the first restart finishes before the others reach the
+  // pruning iteration.
+  #ifdef HAS_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  arma::Row<size_t> assignments[2];
+  arma::mat centroids[2];
+  double inertias[2];
+  size_t counts[2];
+  for (size_t p = 0; p < 2; ++p)
+  {
+    KMeans<CountingDistance, OneGoodRestartInitialization> kmeans;
+    inertias[p] = kmeans.ClusterWithRestarts(data, 3, 6, assignments[p],
+        centroids[p], 2, (p == 0) ? 0.0 : 1.5);
+    counts[p] = kmeans.Metric().Count();
+  }
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(numThreads);
+  #endif
+
+  // The good restart is the best one in both cases.
+  BOOST_REQUIRE_EQUAL(inertias[0], inertias[1]);
+  BOOST_REQUIRE_EQUAL(arma::accu(assignments[0] != assignments[1]), 0);
+  for (size_t i = 3; i < 300; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[0][i], assignments[0][i % 3]);
+
+  // The bad restarts stopped early, so fewer distances were computed.
+  BOOST_REQUIRE_LT(counts[1], counts[0]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
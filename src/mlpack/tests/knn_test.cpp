@@ -9,11 +9,22 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/lazy_model.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
+#include <mlpack/methods/neighbor_search/candidate_list.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/neighbor_search/ns_model_tuner.hpp>
+#include <mlpack/methods/neighbor_search/quantized_search.hpp>
+#include <mlpack/methods/neighbor_search/ivf_search.hpp>
+#include <mlpack/methods/neighbor_search/knn_graph.hpp>
+#include <mlpack/methods/neighbor_search/sharded_neighbor_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
+#include <mlpack/core/tree/instrumented_rules.hpp>
+#include <numeric>
+#include <mlpack/core/util/serve_queries.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -270,6 +281,160 @@ BOOST_AUTO_TEST_CASE(TrainTreeTest)
   }
 }
 
+/**
+ * Test that searching with a packed tree gives the same results, in both
+ * dual-tree and single-tree mode.
+ */
+BOOST_AUTO_TEST_CASE(PackedTreeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+
+  std::vector<size_t> oldFromNew;
+  KNN::Tree tree(dataset, oldFromNew);
+  KNN::Tree packedTree(dataset, oldFromNew);
+  packedTree.PackNodes();
+
+  KNN knn(std::move(tree));
+  KNN packedKnn(std::move(packedTree));
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    knn.SearchMode() = (mode == 0) ? DUAL_TREE_MODE : SINGLE_TREE_MODE;
+    packedKnn.SearchMode() = knn.SearchMode();
+
+    arma::Mat<size_t> neighbors, packedNeighbors;
+    arma::mat distances, packedDistances;
+    knn.Search(5, neighbors, distances);
+    packedKnn.Search(5, packedNeighbors, packedDistances);
+
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors[i], packedNeighbors[i]);
+      BOOST_REQUIRE_EQUAL(distances[i], packedDistances[i]);
+    }
+  }
+}
+
+/**
+ * Make sure that CandidateList keeps the k best candidates of each query point
+ * and returns them best first.
+ */
+BOOST_AUTO_TEST_CASE(CandidateListTest)
+{
+  CandidateList<NearestNeighborSort> candidates(3, 4);
+  arma::vec values = arma::randu<arma::vec>(50);
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    candidates.Insert(1, values[i], i);
+    candidates.Insert(2, -values[i], i);
+  }
+
+  arma::Mat<size_t> indices(4, 3);
+  arma::mat results(4, 3);
+  for (size_t q = 0; q < 3; ++q)
+    candidates.GetResults(indices, results, q);
+
+  const arma::uvec order = arma::sort_index(values);
+  for (size_t j = 0; j < 4; ++j)
+  {
+    BOOST_REQUIRE_EQUAL(indices(j, 0), size_t() - 1);
+    BOOST_REQUIRE_EQUAL(results(j, 0), DBL_MAX);
+    BOOST_REQUIRE_EQUAL(indices(j, 1), order[j]);
+    BOOST_REQUIRE_EQUAL(results(j, 1), values[order[j]]);
+    BOOST_REQUIRE_EQUAL(indices(j, 2), order[values.n_elem - 1 - j]);
+  }
+}
+
+/**
+ * Make sure that the blocked base cases between leaves give the same results as
+ * naive search, for a few leaf sizes.
+ */
+BOOST_AUTO_TEST_CASE(BaseCaseBlockTest)
+{
+  BOOST_REQUIRE((tree::HasBaseCaseBlock<NeighborSearchRules<NearestNeighborSort,
+      EuclideanDistance, KNN::Tree>, KNN::Tree>::value));
+
+  arma::mat referenceData = arma::randu<arma::mat>(10, 1500);
+  arma::mat queryData = arma::randu<arma::mat>(10, 500);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors, naiveQueryNeighbors;
+  arma::mat naiveDistances, naiveQueryDistances;
+  naive.Search(10, naiveNeighbors, naiveDistances);
+  naive.Search(queryData, 10, naiveQueryNeighbors, naiveQueryDistances);
+
+  const size_t leafSizes[] = { 1, 5, 20, 100 };
+  for (size_t l = 0; l < 4; ++l)
+  {
+    std::vector<size_t> oldFromNew;
+    KNN::Tree tree(referenceData, oldFromNew, leafSizes[l]);
+    KNN knn(std::move(tree));
+
+    arma::Mat<size_t> neighbors, queryNeighbors;
+    arma::mat distances, queryDistances;
+    knn.Search(10, neighbors, distances);
+    knn.Search(queryData, 10, queryNeighbors, queryDistances);
+
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+      BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+    }
+
+    for (size_t i = 0; i < queryNeighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(queryNeighbors[i], naiveQueryNeighbors[i]);
+      BOOST_REQUIRE_CLOSE(queryDistances[i], naiveQueryDistances[i], 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that naive search, which computes the distances with matrix
+ * products, finds the same neighbors as an explicit loop over all pairs, also
+ * when the points are far from the origin and the data spans several blocks.
+ */
+BOOST_AUTO_TEST_CASE(NaiveProductSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 2500) + 100.0;
+  arma::mat queryData = arma::randu<arma::mat>(5, 600) + 100.0;
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> neighbors, queryNeighbors;
+  arma::mat distances, queryDistances;
+  naive.Search(5, neighbors, distances);
+  naive.Search(queryData, 5, queryNeighbors, queryDistances);
+
+  BOOST_REQUIRE_EQUAL(naive.BaseCases(), queryData.n_cols *
+      referenceData.n_cols);
+
+  // Find the neighbors of the given points with a loop over all pairs.
+  auto check = [&](const arma::mat& points, const bool sameSet,
+                   const arma::Mat<size_t>& foundNeighbors,
+                   const arma::mat& foundDistances)
+  {
+    for (size_t i = 0; i < points.n_cols; ++i)
+    {
+      arma::vec d(referenceData.n_cols);
+      for (size_t j = 0; j < referenceData.n_cols; ++j)
+      {
+        d[j] = (sameSet && i == j) ? DBL_MAX :
+            EuclideanDistance::Evaluate(points.col(i), referenceData.col(j));
+      }
+
+      const arma::uvec order = arma::stable_sort_index(d);
+      for (size_t j = 0; j < 5; ++j)
+      {
+        BOOST_REQUIRE_EQUAL(foundNeighbors(j, i), order[j]);
+        BOOST_REQUIRE_CLOSE(foundDistances(j, i), d[order[j]], 1e-10);
+      }
+    }
+  };
+
+  check(referenceData, true, neighbors, distances);
+  check(queryData, false, queryNeighbors, queryDistances);
+}
+
 /**
  * Test that training with a tree throws an exception when in naive mode.
  */
@@ -754,6 +919,65 @@ BOOST_AUTO_TEST_CASE(SingleTreeVsNaive)
   }
 }
 
+/**
+ * Make sure that neighbor search works on single-precision data with every
+ * search mode, and gives the same results as on double-precision data.
+ */
+BOOST_AUTO_TEST_CASE(FloatSearchTest)
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  // Make sure both datasets hold exactly the same values.
+  const arma::fmat floatDataset = arma::conv_to<arma::fmat>::from(dataset);
+  dataset = arma::conv_to<arma::mat>::from(floatDataset);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> neighborsNaive;
+  arma::mat distancesNaive;
+  naive.Search(15, neighborsNaive, distancesNaive);
+
+  arma::Mat<size_t> neighborsNaiveBi;
+  arma::mat distancesNaiveBi;
+  naive.Search(dataset.cols(0, 99), 5, neighborsNaiveBi, distancesNaiveBi);
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat,
+      KDTree> FloatKNN;
+
+  const NeighborSearchMode modes[] = { NAIVE_MODE, SINGLE_TREE_MODE,
+      DUAL_TREE_MODE };
+  for (size_t m = 0; m < 3; ++m)
+  {
+    FloatKNN knn(floatDataset, modes[m]);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(15, neighbors, distances);
+
+    BOOST_REQUIRE_EQUAL(neighbors.n_rows, 15);
+    BOOST_REQUIRE_EQUAL(neighbors.n_cols, dataset.n_cols);
+
+    // Neighbors at (nearly) the same distance may be swapped, so only check
+    // the distances and the recall.
+    for (size_t i = 0; i < distances.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(distances[i], distancesNaive[i], 1e-3);
+    BOOST_REQUIRE_GE(KNN::Recall(neighbors, neighborsNaive), 0.99);
+
+    // Bichromatic search.
+    knn.Search(floatDataset.cols(0, 99), 5, neighbors, distances);
+    BOOST_REQUIRE_EQUAL(distances.n_cols, 100);
+    for (size_t i = 0; i < distances.n_elem; ++i)
+    {
+      // The first neighbor of each query is itself, at distance 0.
+      if (distancesNaiveBi[i] == 0.0)
+        BOOST_REQUIRE_SMALL(distances[i], 1e-5);
+      else
+        BOOST_REQUIRE_CLOSE(distances[i], distancesNaiveBi[i], 1e-3);
+    }
+  }
+}
+
 /**
  * Test the cover tree single-tree nearest-neighbors method against the naive
  * method.  This uses only a random reference dataset.
@@ -1466,4 +1690,997 @@ BOOST_AUTO_TEST_CASE(GreedyTreeSearch)
       0);
 }
 
+/**
+ * Make sure that splitting the query tree into subtrees with the
+ * ParallelDualTreeTraverser gives the same results as naive search, for both a
+ * kd-tree and a cover tree.  The minimum number of subtrees is set by hand so
+ * that the query tree is split even when only one thread is available.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeTraverserTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 300);
+  EuclideanDistance metric;
+
+  // First the kd-tree.  Both trees rearrange their datasets, so the naive
+  // search is run on the rearranged datasets.
+  {
+    typedef KNN::Tree TreeType;
+    typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+        TreeType> RuleType;
+
+    TreeType referenceTree(referenceData);
+    TreeType queryTree(queryData);
+
+    RuleType rules(referenceTree.Dataset(), queryTree.Dataset(), 5, metric);
+    ParallelDualTreeTraverser<TreeType, RuleType, TreeType::DualTreeTraverser>
+        traverser(rules, 10);
+    traverser.Traverse(queryTree, referenceTree);
+
+    BOOST_REQUIRE_GE(traverser.NumSubtrees(), 10);
+
+    arma::Mat<size_t> neighbors(5, queryData.n_cols);
+    arma::mat distances(5, queryData.n_cols);
+    size_t numPoints = 0;
+    for (size_t i = 0; i < traverser.NumSubtrees(); ++i)
+    {
+      RuleType& subtreeRules = traverser.Rules()[traverser.SubtreeOwner(i)];
+      const TreeType& subtree = traverser.Subtree(i);
+      numPoints += subtree.NumDescendants();
+      for (size_t j = 0; j < subtree.NumDescendants(); ++j)
+        subtreeRules.GetResults(neighbors, distances, subtree.Descendant(j));
+    }
+
+    BOOST_REQUIRE_EQUAL(numPoints, queryData.n_cols);
+
+    KNN naive(referenceTree.Dataset(), NAIVE_MODE);
+    arma::Mat<size_t> naiveNeighbors;
+    arma::mat naiveDistances;
+    naive.Search(queryTree.Dataset(), 5, naiveNeighbors, naiveDistances);
+
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+  }
+
+  // Now the cover tree, which does not rearrange its dataset.
+  {
+    typedef StandardCoverTree<EuclideanDistance,
+        NeighborSearchStat<NearestNeighborSort>, arma::mat> TreeType;
+    typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+        TreeType> RuleType;
+
+    TreeType referenceTree(referenceData);
+    TreeType queryTree(queryData);
+
+    RuleType rules(referenceData, queryData, 5, metric);
+    ParallelDualTreeTraverser<TreeType, RuleType, TreeType::DualTreeTraverser>
+        traverser(rules, 10);
+    traverser.Traverse(queryTree, referenceTree);
+
+    BOOST_REQUIRE_GE(traverser.NumSubtrees(), 10);
+
+    arma::Mat<size_t> neighbors(5, queryData.n_cols);
+    arma::mat distances(5, queryData.n_cols);
+    size_t numPoints = 0;
+    for (size_t i = 0; i < traverser.NumSubtrees(); ++i)
+    {
+      RuleType& subtreeRules = traverser.Rules()[traverser.SubtreeOwner(i)];
+      const TreeType& subtree = traverser.Subtree(i);
+      numPoints += subtree.NumDescendants();
+      for (size_t j = 0; j < subtree.NumDescendants(); ++j)
+        subtreeRules.GetResults(neighbors, distances, subtree.Descendant(j));
+    }
+
+    BOOST_REQUIRE_EQUAL(numPoints, queryData.n_cols);
+
+    KNN naive(referenceData, NAIVE_MODE);
+    arma::Mat<size_t> naiveNeighbors;
+    arma::mat naiveDistances;
+    naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+  }
+}
+
+/**
+ * Insert points into and remove points from a trained NeighborSearch object,
+ * and check that the results match a naive search on the equivalent dataset.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckIncrementalUpdates(const NeighborSearchMode mode)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 300);
+  arma::mat newPoints = arma::randu<arma::mat>(4, 50);
+  arma::mat querySet = arma::randu<arma::mat>(4, 40);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn(dataset, mode);
+  knn.Insert(newPoints);
+
+  arma::mat expected = arma::join_rows(dataset, newPoints);
+
+  // Remove the last point, and two points from the middle of the set.
+  const size_t removed[] = { 349, 3, 100 };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    knn.Remove(removed[i]);
+    expected.col(removed[i]) = expected.col(expected.n_cols - 1);
+    expected.shed_col(expected.n_cols - 1);
+  }
+
+  BOOST_REQUIRE_EQUAL(knn.ReferenceSet().n_cols, expected.n_cols);
+
+  KNN naive(expected, NAIVE_MODE);
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  knn.Search(querySet, 5, neighbors, distances);
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  knn.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Test Insert() and Remove() on trees that are updated in place (the R tree
+ * family) and on trees that are rebuilt.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalInsertRemoveTest)
+{
+  BOOST_REQUIRE(SupportsIncrementalUpdates<KNN::Tree>::value == false);
+  BOOST_REQUIRE(SupportsIncrementalUpdates<NeighborSearch<NearestNeighborSort,
+      EuclideanDistance, arma::mat, RTree>::Tree>::value == true);
+
+  CheckIncrementalUpdates<RTree>(DUAL_TREE_MODE);
+  CheckIncrementalUpdates<RStarTree>(SINGLE_TREE_MODE);
+  CheckIncrementalUpdates<KDTree>(DUAL_TREE_MODE);
+  CheckIncrementalUpdates<StandardCoverTree>(SINGLE_TREE_MODE);
+  CheckIncrementalUpdates<KDTree>(NAIVE_MODE);
+}
+
+/**
+ * Make sure NSModel::Insert() and NSModel::Remove() work, for a tree that is
+ * updated in place and one that is rebuilt with the model's leaf size.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelIncrementalUpdateTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 300);
+  arma::mat newPoints = arma::randu<arma::mat>(4, 50);
+  arma::mat querySet = arma::randu<arma::mat>(4, 40);
+
+  arma::mat expected = arma::join_rows(dataset, newPoints);
+  expected.col(10) = expected.col(expected.n_cols - 1);
+  expected.shed_col(expected.n_cols - 1);
+
+  KNN naive(expected, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 3, naiveNeighbors, naiveDistances);
+
+  KNNModel models[2];
+  models[0] = KNNModel(KNNModel::TreeTypes::KD_TREE, false);
+  models[1] = KNNModel(KNNModel::TreeTypes::R_TREE, false);
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    models[i].BuildModel(std::move(arma::mat(dataset)), 5, DUAL_TREE_MODE);
+    models[i].Insert(std::move(arma::mat(newPoints)));
+    models[i].Remove(10);
+
+    BOOST_REQUIRE_EQUAL(models[i].Dataset().n_cols, expected.n_cols);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    models[i].Search(std::move(arma::mat(querySet)), 3, neighbors, distances);
+
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+  }
+}
+
+/**
+ * Serve a few batches of queries with ServeQueries() and make sure that the
+ * answers match a regular search, and that malformed batches are reported
+ * without stopping the server.
+ */
+BOOST_AUTO_TEST_CASE(ServeQueriesTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 200);
+  arma::mat querySet = arma::randu<arma::mat>(3, 4);
+  KNN knn(dataset);
+
+  std::ostringstream request;
+  request << std::setprecision(17);
+  for (size_t i = 0; i < 2; ++i)
+    request << querySet(0, i) << "," << querySet(1, i) << " " << querySet(2, i)
+        << "\n";
+  request << "\n";
+  request << "1,2\n\n";
+  for (size_t i = 2; i < 4; ++i)
+    request << querySet(0, i) << "," << querySet(1, i) << "," << querySet(2, i)
+        << "\n";
+
+  std::istringstream input(request.str());
+  std::ostringstream output;
+  const size_t numBatches = util::ServeQueries(input, output, 3,
+      [&](const arma::mat& queries, arma::Mat<size_t>& neighbors,
+          arma::mat& distances)
+  {
+    knn.Search(queries, 2, neighbors, distances);
+  });
+
+  BOOST_REQUIRE_EQUAL(numBatches, 2);
+
+  // Parse the answers.
+  std::istringstream answer(output.str());
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(answer, line))
+    lines.push_back(line);
+
+  // Two answers of two lines, one error line, and an empty line after each.
+  BOOST_REQUIRE_EQUAL(lines.size(), 9);
+  BOOST_REQUIRE_EQUAL(lines[2], "");
+  BOOST_REQUIRE_EQUAL(lines[3].substr(0, 7), "error: ");
+  BOOST_REQUIRE_EQUAL(lines[4], "");
+  BOOST_REQUIRE_EQUAL(lines[8], "");
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(querySet, 2, neighbors, distances);
+
+  const size_t answerLines[] = { 0, 1, 5, 6 };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    std::string fields = lines[answerLines[i]];
+    std::replace(fields.begin(), fields.end(), ',', ' ');
+    std::istringstream iss(fields);
+
+    size_t n0, n1;
+    double d0, d1;
+    iss >> n0 >> n1 >> d0 >> d1;
+    BOOST_REQUIRE(!iss.fail());
+
+    BOOST_REQUIRE_EQUAL(n0, neighbors(0, i));
+    BOOST_REQUIRE_EQUAL(n1, neighbors(1, i));
+    BOOST_REQUIRE_CLOSE(d0, distances(0, i), 1e-5);
+    BOOST_REQUIRE_CLOSE(d1, distances(1, i), 1e-5);
+  }
+}
+
+/**
+ * Make sure that the quantized reference set can be reconstructed to within half
+ * a quantization step in each dimension.
+ */
+BOOST_AUTO_TEST_CASE(QuantizedSearchReconstructTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(8, 500);
+  dataset.row(3) *= 100.0;
+  dataset.row(5).fill(2.0); // A constant dimension.
+
+  QuantizedSearch<> qs(dataset);
+
+  BOOST_REQUIRE_EQUAL(qs.Codes().n_rows, 8);
+  BOOST_REQUIRE_EQUAL(qs.Codes().n_cols, 500);
+  BOOST_REQUIRE_EQUAL(qs.Scales()[5], 0.0);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    const arma::vec reconstruction = qs.Reconstruct(i);
+    for (size_t d = 0; d < dataset.n_rows; ++d)
+    {
+      BOOST_REQUIRE_LE(std::abs(reconstruction[d] - dataset(d, i)),
+          qs.Scales()[d] / 2.0 + 1e-10);
+    }
+  }
+}
+
+/**
+ * Compare the approximate and re-ranked results of QuantizedSearch with exact
+ * nearest neighbor search.
+ */
+BOOST_AUTO_TEST_CASE(QuantizedSearchTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(5, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(5, 200);
+
+  KNN knn(referenceSet);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(querySet, 5, trueNeighbors, trueDistances);
+
+  QuantizedSearch<> qs(referenceSet);
+  arma::Mat<size_t> neighbors, rerankedNeighbors;
+  arma::mat distances, rerankedDistances;
+  qs.Search(querySet, 5, neighbors, distances);
+  qs.Search(querySet, referenceSet, 5, 50, rerankedNeighbors,
+      rerankedDistances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 200);
+  BOOST_REQUIRE_EQUAL(rerankedNeighbors.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(rerankedNeighbors.n_cols, 200);
+
+  // The approximate distances can't be off by more than the length of half a
+  // quantization step in every dimension.
+  const double maxError = arma::norm(qs.Scales()) / 2.0 + 1e-5;
+
+  size_t found = 0, rerankedFound = 0;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 5; ++j)
+    {
+      const double exactDistance = arma::norm(querySet.col(i) -
+          referenceSet.col(neighbors(j, i)));
+      BOOST_REQUIRE_LE(std::abs(distances(j, i) - exactDistance), maxError);
+
+      BOOST_REQUIRE_CLOSE(rerankedDistances(j, i), arma::norm(querySet.col(i) -
+          referenceSet.col(rerankedNeighbors(j, i))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_GE(rerankedDistances(j, i), rerankedDistances(j - 1, i));
+
+      for (size_t l = 0; l < 5; ++l)
+      {
+        if (neighbors(j, i) == trueNeighbors(l, i))
+          ++found;
+        if (rerankedNeighbors(j, i) == trueNeighbors(l, i))
+          ++rerankedFound;
+      }
+    }
+  }
+
+  BOOST_REQUIRE_GE(found, 0.9 * trueNeighbors.n_elem);
+  BOOST_REQUIRE_GE(rerankedFound, 0.99 * trueNeighbors.n_elem);
+}
+
+/**
+ * Make sure QuantizedSearch checks its arguments.
+ */
+BOOST_AUTO_TEST_CASE(QuantizedSearchInvalidTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(5, 100);
+  QuantizedSearch<> qs(referenceSet);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  BOOST_REQUIRE_THROW(qs.Search(arma::randu<arma::mat>(4, 10), 3, neighbors,
+      distances), std::invalid_argument);
+  BOOST_REQUIRE_THROW(qs.Search(referenceSet, 101, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(qs.Search(referenceSet, referenceSet, 5, 4, neighbors,
+      distances), std::invalid_argument);
+  BOOST_REQUIRE_THROW(qs.Search(referenceSet, referenceSet.cols(0, 49), 5, 10,
+      neighbors, distances), std::invalid_argument);
+
+  QuantizedSearch<> empty;
+  BOOST_REQUIRE_THROW(empty.Train(arma::mat()), std::invalid_argument);
+}
+
+/**
+ * Return the fraction of the true neighbors that were found.
+ */
+double IVFRecall(const arma::Mat<size_t>& neighbors,
+                 const arma::Mat<size_t>& trueNeighbors)
+{
+  size_t found = 0;
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+      for (size_t l = 0; l < trueNeighbors.n_rows; ++l)
+        if (neighbors(j, i) == trueNeighbors(l, i))
+          ++found;
+
+  return double(found) / trueNeighbors.n_elem;
+}
+
+/**
+ * Make sure that each reference point is stored in the list of its closest
+ * centroid, and that the lists hold every point once.
+ */
+BOOST_AUTO_TEST_CASE(IVFSearchListsTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(4, 1000);
+  IVFSearch<> ivf(referenceSet, 20);
+
+  BOOST_REQUIRE_EQUAL(ivf.NumLists(), 20);
+  BOOST_REQUIRE_EQUAL(ivf.ListOffsets().n_elem, 21);
+  BOOST_REQUIRE_EQUAL(ivf.ListOffsets()[0], 0);
+  BOOST_REQUIRE_EQUAL(ivf.ListOffsets()[20], 1000);
+  BOOST_REQUIRE_EQUAL(ivf.Points().n_cols, 1000);
+
+  std::vector<bool> seen(1000, false);
+  for (size_t l = 0; l < ivf.NumLists(); ++l)
+  {
+    for (size_t j = ivf.ListOffsets()[l]; j < ivf.ListOffsets()[l + 1]; ++j)
+    {
+      const size_t index = ivf.Indices()[j];
+      BOOST_REQUIRE(!seen[index]);
+      seen[index] = true;
+
+      for (size_t d = 0; d < referenceSet.n_rows; ++d)
+        BOOST_REQUIRE_EQUAL(ivf.Points()(d, j), referenceSet(d, index));
+
+      const double distance = arma::norm(referenceSet.col(index) -
+          ivf.Centroids().col(l));
+      for (size_t c = 0; c < ivf.NumLists(); ++c)
+      {
+        BOOST_REQUIRE_LE(distance, arma::norm(referenceSet.col(index) -
+            ivf.Centroids().col(c)) + 1e-10);
+      }
+    }
+  }
+}
+
+/**
+ * Searching every list must give exact results, and searching more lists must
+ * not decrease the recall.
+ */
+BOOST_AUTO_TEST_CASE(IVFSearchTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(8, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(8, 300);
+
+  KNN knn(referenceSet);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(querySet, 5, trueNeighbors, trueDistances);
+
+  IVFSearch<> ivf(referenceSet, 25, false, 25);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivf.Search(querySet, 5, neighbors, distances);
+
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+
+  double lastRecall = 0.0;
+  for (size_t nProbe = 1; nProbe <= 8; nProbe *= 2)
+  {
+    ivf.NProbe() = nProbe;
+    ivf.Search(querySet, 5, neighbors, distances);
+    const double recall = IVFRecall(neighbors, trueNeighbors);
+    BOOST_REQUIRE_GE(recall, lastRecall);
+    lastRecall = recall;
+
+    // The distances are exact for the neighbors that were found.
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      for (size_t j = 0; j < 5; ++j)
+      {
+        BOOST_REQUIRE_CLOSE(distances(j, i), arma::norm(querySet.col(i) -
+            referenceSet.col(neighbors(j, i))), 1e-5);
+      }
+    }
+  }
+
+  BOOST_REQUIRE_GE(lastRecall, 0.9);
+}
+
+/**
+ * Check an index with quantized residuals, with and without re-ranking.
+ */
+BOOST_AUTO_TEST_CASE(IVFSearchQuantizedTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(8, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(8, 300);
+
+  KNN knn(referenceSet);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(querySet, 5, trueNeighbors, trueDistances);
+
+  IVFSearch<> ivf(referenceSet, 25, true, 25);
+  BOOST_REQUIRE(ivf.Quantized());
+  BOOST_REQUIRE_EQUAL(ivf.Points().n_elem, 0);
+  BOOST_REQUIRE_EQUAL(ivf.Residuals().Codes().n_cols, 2000);
+
+  arma::Mat<size_t> neighbors, rerankedNeighbors;
+  arma::mat distances, rerankedDistances;
+  ivf.Search(querySet, 5, neighbors, distances);
+  ivf.Search(querySet, referenceSet, 5, 50, rerankedNeighbors,
+      rerankedDistances);
+
+  // The approximate distances can't be off by more than the length of half a
+  // quantization step in every dimension.
+  const double maxError = arma::norm(ivf.Residuals().Scales()) / 2.0 + 1e-5;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 5; ++j)
+    {
+      const double exactDistance = arma::norm(querySet.col(i) -
+          referenceSet.col(neighbors(j, i)));
+      BOOST_REQUIRE_LE(std::abs(distances(j, i) - exactDistance), maxError);
+    }
+  }
+
+  BOOST_REQUIRE_GE(IVFRecall(neighbors, trueNeighbors), 0.9);
+
+  // With every list searched, re-ranking gives nearly exact results.
+  CheckMatrices(rerankedNeighbors, trueNeighbors);
+  CheckMatrices(rerankedDistances, trueDistances);
+}
+
+/**
+ * Make sure IVFSearch checks its arguments.
+ */
+BOOST_AUTO_TEST_CASE(IVFSearchInvalidTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(5, 100);
+
+  IVFSearch<> empty;
+  BOOST_REQUIRE_THROW(empty.Train(arma::mat(), 2), std::invalid_argument);
+  BOOST_REQUIRE_THROW(empty.Train(referenceSet, 0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(empty.Train(referenceSet, 101), std::invalid_argument);
+
+  IVFSearch<> ivf(referenceSet, 4);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  BOOST_REQUIRE_THROW(ivf.Search(arma::randu<arma::mat>(4, 10), 3, neighbors,
+      distances), std::invalid_argument);
+  BOOST_REQUIRE_THROW(ivf.Search(referenceSet, 101, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(ivf.Search(referenceSet, referenceSet, 5, 4, neighbors,
+      distances), std::invalid_argument);
+  BOOST_REQUIRE_THROW(ivf.Search(referenceSet, referenceSet.cols(0, 49), 5, 10,
+      neighbors, distances), std::invalid_argument);
+}
+
+/**
+ * Make sure that the NN-Descent graph is close to the exact k-nearest-neighbor
+ * graph, in the same format as NeighborSearch::Search(k, ...).
+ */
+BOOST_AUTO_TEST_CASE(KNNGraphTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(8, 2000);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(10, trueNeighbors, trueDistances);
+
+  KNNGraph<> graph;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  graph.Build(dataset, 10, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 2000);
+  BOOST_REQUIRE_EQUAL(distances.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(distances.n_cols, 2000);
+  BOOST_REQUIRE_GT(graph.Iterations(), 0);
+  BOOST_REQUIRE_LE(graph.Iterations(), graph.MaxIterations());
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 10; ++j)
+    {
+      BOOST_REQUIRE_NE(neighbors(j, i), i);
+      BOOST_REQUIRE_CLOSE(distances(j, i), arma::norm(dataset.col(i) -
+          dataset.col(neighbors(j, i))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_GE(distances(j, i), distances(j - 1, i));
+    }
+  }
+
+  BOOST_REQUIRE_GE(IVFRecall(neighbors, trueNeighbors), 0.95);
+
+  // NN-Descent must do much less work than comparing every pair of points.
+  BOOST_REQUIRE_LT(graph.DistanceEvaluations(),
+      dataset.n_cols * (dataset.n_cols - 1) / 2);
+}
+
+/**
+ * A graph with k = n - 1 must be exact.
+ */
+BOOST_AUTO_TEST_CASE(KNNGraphCompleteTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 30);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(29, trueNeighbors, trueDistances);
+
+  KNNGraph<> graph;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  graph.Build(dataset, 29, neighbors, distances);
+
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+}
+
+/**
+ * Make sure KNNGraph checks its arguments.
+ */
+BOOST_AUTO_TEST_CASE(KNNGraphInvalidTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 30);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  KNNGraph<> graph;
+  BOOST_REQUIRE_THROW(graph.Build(dataset, 30, neighbors, distances),
+      std::invalid_argument);
+
+  graph.SampleRate() = 0.0;
+  BOOST_REQUIRE_THROW(graph.Build(dataset, 5, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that a single-tree search with a limit on the number of base cases
+ * returns neighbors within the achieved epsilon of the true ones, and that
+ * with a limit that is never reached the results are exact.
+ */
+BOOST_AUTO_TEST_CASE(AnytimeSearchTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 100);
+
+  KNN naive(referenceSet, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  naive.Search(querySet, 5, trueNeighbors, trueDistances);
+
+  KNN knn(referenceSet, SINGLE_TREE_MODE);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  // A budget of 20 base cases per query point is too small to find all the
+  // true neighbors.
+  knn.MaxBaseCases() = 20 * querySet.n_cols;
+  knn.Search(querySet, 5, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, querySet.n_cols);
+  BOOST_REQUIRE_GE(knn.AchievedEpsilon(), 0.0);
+  if (knn.AchievedEpsilon() != DBL_MAX)
+  {
+    for (size_t i = 0; i < distances.n_elem; ++i)
+      BOOST_REQUIRE_LE(distances[i], (1.0 + knn.AchievedEpsilon()) *
+          trueDistances[i] + 1e-10);
+  }
+
+  // Now with a budget that is never exhausted.
+  knn.MaxBaseCases() = referenceSet.n_cols * querySet.n_cols;
+  knn.Search(querySet, 5, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(knn.AchievedEpsilon(), 0.0);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], trueNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], trueDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Run a single-tree search with the given tree type, on more query points than
+ * fit in one block of the parallel traversal, and check that the results match
+ * a naive search.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckParallelSingleTree(const NeighborSearchMode mode)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 500);
+  arma::mat querySet = arma::randu<arma::mat>(3, 150);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn(referenceSet, mode);
+  KNN naive(referenceSet, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  knn.Search(querySet, 4, neighbors, distances);
+  naive.Search(querySet, 4, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  knn.Search(4, neighbors, distances);
+  naive.Search(4, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure the parallel single-tree search gives exact results with all the
+ * kinds of trees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeTest)
+{
+  CheckParallelSingleTree<KDTree>(SINGLE_TREE_MODE);
+  CheckParallelSingleTree<StandardCoverTree>(SINGLE_TREE_MODE);
+  CheckParallelSingleTree<RTree>(SINGLE_TREE_MODE);
+  CheckParallelSingleTree<Octree>(SINGLE_TREE_MODE);
+  CheckParallelSingleTree<BallTree>(SINGLE_TREE_MODE);
+}
+
+/**
+ * The header of a saved model can be loaded without the model, and the model
+ * is only loaded when it is first used.
+ */
+BOOST_AUTO_TEST_CASE(LazyModelTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+  typedef NSModelHeader<NearestNeighborSort> KNNModelHeader;
+
+  arma::mat referenceData = arma::randu<arma::mat>(5, 300);
+  arma::mat queryData = arma::randu<arma::mat>(5, 20);
+
+  KNNModel model(KNNModel::TreeTypes::R_TREE, false);
+  model.Tau() = 0.3;
+  model.BuildModel(arma::mat(referenceData), 15, DUAL_TREE_MODE);
+
+  arma::Mat<size_t> neighbors, lazyNeighbors;
+  arma::mat distances, lazyDistances;
+  model.Search(arma::mat(queryData), 3, neighbors, distances);
+
+  const std::string filenames[3] = { "lazy_knn.bin", "lazy_knn.txt",
+      "lazy_knn.xml" };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    data::Save(filenames[i], "model", model, true);
+
+    data::LazyModel<KNNModel, KNNModelHeader> lazy(filenames[i]);
+    BOOST_REQUIRE_EQUAL(lazy.Loaded(), (i == 2)); // XML is loaded eagerly.
+    BOOST_REQUIRE_EQUAL(lazy.Header().TreeType(), KNNModel::TreeTypes::R_TREE);
+    BOOST_REQUIRE_EQUAL(lazy.Header().LeafSize(), 15);
+    BOOST_REQUIRE_CLOSE(lazy.Header().Tau(), 0.3, 1e-5);
+    BOOST_REQUIRE_EQUAL(lazy.Header().RandomBasis(), false);
+    BOOST_REQUIRE_EQUAL(lazy.Header().Dimensionality(), 5);
+    BOOST_REQUIRE_EQUAL(lazy.Header().ReferenceSize(), 300);
+
+    lazy.Model().Search(arma::mat(queryData), 3, lazyNeighbors, lazyDistances);
+    BOOST_REQUIRE(lazy.Loaded());
+    CheckMatrices(neighbors, lazyNeighbors);
+    CheckMatrices(distances, lazyDistances);
+
+    remove(filenames[i].c_str());
+  }
+
+  BOOST_REQUIRE_THROW((data::LazyModel<KNNModel, KNNModelHeader>(
+      "lazy_knn_missing.bin")), std::runtime_error);
+}
+
+/**
+ * Make sure that InstrumentedRules counts the base cases and scores of a
+ * dual-tree traversal, doesn't change its results, and reports its statistics
+ * as counters under the running timer.
+ */
+BOOST_AUTO_TEST_CASE(InstrumentedRulesTest)
+{
+  typedef KNN::Tree TreeType;
+  typedef InstrumentedRules<NeighborSearchRules<NearestNeighborSort,
+      EuclideanDistance, TreeType>> RuleType;
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  std::vector<size_t> referenceOldFromNew, queryOldFromNew;
+  TreeType referenceTree(referenceData, referenceOldFromNew);
+  TreeType queryTree(queryData, queryOldFromNew);
+  EuclideanDistance metric;
+
+  Timer::ResetAll();
+  Timer::EnableTiming();
+  Timer::Start("instrumented_test");
+
+  size_t baseCases;
+  {
+    RuleType rules(referenceTree.Dataset(), queryTree.Dataset(), 5, metric);
+    TreeType::DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, referenceTree);
+
+    // Every base case and score is recorded.
+    const TraversalStatistics& statistics = rules.Statistics();
+    baseCases = statistics.BaseCases();
+    BOOST_REQUIRE_EQUAL(baseCases, traverser.NumBaseCases());
+    BOOST_REQUIRE_GT(statistics.Scores(), 0);
+    BOOST_REQUIRE_LE(statistics.Prunes(), statistics.Scores());
+
+    const std::vector<size_t>& visits = statistics.ReferenceVisits();
+    const std::vector<size_t>& prunes = statistics.ReferencePrunes();
+    BOOST_REQUIRE_EQUAL(std::accumulate(visits.begin(), visits.end(),
+        (size_t) 0), statistics.Scores());
+    BOOST_REQUIRE_EQUAL(std::accumulate(prunes.begin(), prunes.end(),
+        (size_t) 0), statistics.Prunes());
+    BOOST_REQUIRE_EQUAL(std::accumulate(statistics.QueryVisits().begin(),
+        statistics.QueryVisits().end(), (size_t) 0), statistics.Scores());
+
+    // A copy starts with empty statistics.
+    RuleType copy(rules);
+    BOOST_REQUIRE_EQUAL(copy.Statistics().Scores(), 0);
+
+    // The results are the same as those of the search.
+    arma::Mat<size_t> neighbors, knnNeighbors;
+    arma::mat distances, knnDistances;
+    rules.GetResults(neighbors, distances);
+
+    KNN knn(referenceData);
+    knn.Search(queryData, 5, knnNeighbors, knnDistances);
+
+    // The query tree rearranged the query points.
+    for (size_t i = 0; i < queryData.n_cols; ++i)
+      for (size_t j = 0; j < 5; ++j)
+        BOOST_REQUIRE_CLOSE(distances(j, i),
+            knnDistances(j, queryOldFromNew[i]), 1e-5);
+  }
+
+  Timer::Stop("instrumented_test");
+
+  // The statistics are reported when the rules are destroyed (the copy has
+  // nothing to report).
+  BOOST_REQUIRE_EQUAL(
+      Timer::GetCounter("instrumented_test/traversal/base_cases"), baseCases);
+  BOOST_REQUIRE_GT(Timer::GetCounter("instrumented_test/traversal/scores"), 0);
+
+  Timer::ResetAll();
+  Timer::DisableTiming();
+}
+
+/**
+ * The intrinsic dimension of points on a plane embedded in ten dimensions
+ * should be estimated as about two.
+ */
+BOOST_AUTO_TEST_CASE(IntrinsicDimensionTest)
+{
+  arma::mat basis(10, 2, arma::fill::randn);
+  arma::mat coordinates(2, 1000, arma::fill::randu);
+  const arma::mat dataset = basis * coordinates;
+
+  const double dimension =
+      NSModelTuner<NearestNeighborSort>::IntrinsicDimension(dataset);
+  BOOST_REQUIRE_GT(dimension, 1.5);
+  BOOST_REQUIRE_LT(dimension, 2.5);
+}
+
+/**
+ * Make sure the configuration chosen by NSModelTuner is one of its trials, and
+ * that a model built with it gives exact results.
+ */
+BOOST_AUTO_TEST_CASE(NSModelTunerTest)
+{
+  arma::mat dataset(3, 1500, arma::fill::randu);
+
+  NSModelTuner<NearestNeighborSort> tuner(1000, 100);
+  const NSModelTuner<NearestNeighborSort>::Trial& best =
+      tuner.Tune(dataset, 3);
+
+  BOOST_REQUIRE_GT(tuner.Trials().size(), 1);
+  BOOST_REQUIRE_EQUAL(&best, &tuner.Best());
+  for (size_t i = 0; i < tuner.Trials().size(); ++i)
+  {
+    BOOST_REQUIRE_LE(best.buildTime + best.searchTime,
+        tuner.Trials()[i].buildTime + tuner.Trials()[i].searchTime);
+  }
+
+  // The subsample is smaller than the dataset, so naive search isn't tried.
+  BOOST_REQUIRE_LT(tuner.EstimatedDimension(), 20.0);
+  BOOST_REQUIRE_NE(best.searchMode, NAIVE_MODE);
+
+  NSModel<NearestNeighborSort> model(best.treeType);
+  model.BuildModel(arma::mat(dataset), best.leafSize, best.searchMode);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  model.Search(3, neighbors, distances);
+
+  KNN naive(dataset, NAIVE_MODE);
+  naive.Search(3, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // k must be less than the number of points.
+  BOOST_REQUIRE_THROW(tuner.Tune(dataset, 1500), std::invalid_argument);
+}
+
+/**
+ * Make sure that sharded search gives the same results as search on the whole
+ * reference set, for numbers of shards that are and aren't powers of two.
+ */
+BOOST_AUTO_TEST_CASE(ShardedSearchTest)
+{
+  arma::mat referenceSet(4, 1003, arma::fill::randu);
+  arma::mat querySet(4, 200, arma::fill::randu);
+
+  arma::Mat<size_t> naiveNeighbors, neighbors;
+  arma::mat naiveDistances, distances;
+  KNN naive(referenceSet, NAIVE_MODE);
+  naive.Search(querySet, 10, naiveNeighbors, naiveDistances);
+
+  const size_t numShards[] = { 1, 2, 5, 8 };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    ShardedNeighborSearch<> sharded(referenceSet, numShards[i]);
+    BOOST_REQUIRE_EQUAL(sharded.NumShards(), numShards[i]);
+    BOOST_REQUIRE_EQUAL(sharded.Offsets().back(), referenceSet.n_cols);
+
+    sharded.Search(querySet, 10, neighbors, distances);
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+  }
+
+  // Shards with fewer than k points.
+  ShardedNeighborSearch<> sharded(referenceSet, 200, SINGLE_TREE_MODE);
+  sharded.Search(querySet, 10, neighbors, distances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure that shards added one at a time give the same furthest neighbors
+ * as search on the whole reference set.
+ */
+BOOST_AUTO_TEST_CASE(ShardedAddShardTest)
+{
+  arma::mat referenceSet(3, 500, arma::fill::randu);
+
+  arma::Mat<size_t> naiveNeighbors, neighbors;
+  arma::mat naiveDistances, distances;
+  KFN naive(referenceSet, NAIVE_MODE);
+  naive.Search(referenceSet, 5, naiveNeighbors, naiveDistances);
+
+  ShardedNeighborSearch<FurthestNeighborSort> sharded;
+  sharded.AddShard(referenceSet.cols(0, 99));
+  sharded.AddShard(referenceSet.cols(100, 349));
+  sharded.AddShard(referenceSet.cols(350, 499));
+  BOOST_REQUIRE_EQUAL(sharded.Offsets()[2], 350);
+
+  sharded.Search(referenceSet, 5, neighbors, distances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  BOOST_REQUIRE_THROW(sharded.AddShard(arma::randu<arma::mat>(4, 10)),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(sharded.Search(referenceSet, 501, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Check Merge() on results by hand, with offsets and missing neighbors.
+ */
+BOOST_AUTO_TEST_CASE(ShardedMergeTest)
+{
+  arma::Mat<size_t> neighbors1("0 1; 2 0");
+  neighbors1(1, 1) = size_t() - 1;
+  arma::mat distances1("1.0 0.5; 3.0 0.0");
+  distances1(1, 1) = DBL_MAX;
+  arma::Mat<size_t> neighbors2("4 5; 6 7; 8 9");
+  arma::mat distances2("0.5 1.0; 2.0 2.0; 4.0 3.0");
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ShardedNeighborSearch<>::Merge(neighbors1, distances1, 100, neighbors2,
+      distances2, 0, 3, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 2);
+  BOOST_REQUIRE_EQUAL(neighbors(0, 0), 4);
+  BOOST_REQUIRE_EQUAL(neighbors(1, 0), 100);
+  BOOST_REQUIRE_EQUAL(neighbors(2, 0), 6);
+  BOOST_REQUIRE_EQUAL(neighbors(0, 1), 101);
+  BOOST_REQUIRE_EQUAL(neighbors(1, 1), 5);
+  BOOST_REQUIRE_EQUAL(neighbors(2, 1), 7);
+  BOOST_REQUIRE_CLOSE(distances(1, 0), 1.0, 1e-10);
+  BOOST_REQUIRE_CLOSE(distances(2, 1), 2.0, 1e-10);
+
+  // Ask for more neighbors than there are.
+  ShardedNeighborSearch<>::Merge(neighbors1, distances1, 0, neighbors2,
+      distances2, 0, 6, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(neighbors(3, 1), 9);
+  BOOST_REQUIRE_EQUAL(neighbors(4, 1), size_t() - 1);
+  BOOST_REQUIRE_EQUAL(neighbors(5, 1), size_t() - 1);
+  BOOST_REQUIRE_EQUAL(distances(5, 1), DBL_MAX);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -271,6 +271,52 @@ BOOST_AUTO_TEST_CASE(SingleDatasetSearch)
   BOOST_REQUIRE_EQUAL(distances.n_cols, 2500);
 }
 
+// Make sure that evaluating a block of base cases with BaseCases() gives the
+// same results as calling BaseCase() for each reference point, including when
+// the query point itself is among the reference points.
+BOOST_AUTO_TEST_CASE(BaseCasesTest)
+{
+  arma::mat dataset(5, 200);
+  dataset.randu();
+
+  typedef RASearchRules<NearestNeighborSort, EuclideanDistance,
+      RASearch<>::Tree> RuleType;
+
+  EuclideanDistance metric;
+  RuleType single(dataset, dataset, 3, metric, 20.0, 0.95, false, false, false,
+      20, true);
+  RuleType block(dataset, dataset, 3, metric, 20.0, 0.95, false, false, false,
+      20, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    arma::uvec samples;
+    math::ObtainDistinctSamples(0, dataset.n_cols, 50, samples);
+    if (i % 2 == 0)
+      samples[0] = i;
+
+    for (size_t j = 0; j < samples.n_elem; ++j)
+      single.BaseCase(i, samples[j]);
+    block.BaseCases(i, samples);
+  }
+
+  BOOST_REQUIRE_EQUAL(single.NumDistComputations(),
+      block.NumDistComputations());
+  BOOST_REQUIRE_EQUAL(single.NumEffectiveSamples(),
+      block.NumEffectiveSamples());
+
+  arma::Mat<size_t> singleNeighbors, blockNeighbors;
+  arma::mat singleDistances, blockDistances;
+  single.GetResults(singleNeighbors, singleDistances);
+  block.GetResults(blockNeighbors, blockDistances);
+
+  for (size_t i = 0; i < singleNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(singleNeighbors[i], blockNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(singleDistances[i], blockDistances[i], 1e-5);
+  }
+}
+
 // Test single-tree rank-approximate search with cover trees.
 BOOST_AUTO_TEST_CASE(SingleCoverTreeTest)
 {
@@ -715,4 +761,27 @@ BOOST_AUTO_TEST_CASE(RAModelTest)
   }
 }
 
+/**
+ * The header of a saved model can be loaded without the trees.
+ */
+BOOST_AUTO_TEST_CASE(RAModelHeaderTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 150);
+
+  RAModel<NearestNeighborSort> model(
+      RAModel<NearestNeighborSort>::TreeTypes::KD_TREE, false);
+  model.BuildModel(std::move(referenceData), 12, false, false);
+  data::Save("ra_header.txt", "model", model, true);
+
+  RAModelHeader<NearestNeighborSort> header;
+  BOOST_REQUIRE(data::Load("ra_header.txt", "model", header));
+  BOOST_REQUIRE_EQUAL(header.TreeType(),
+      RAModel<NearestNeighborSort>::TreeTypes::KD_TREE);
+  BOOST_REQUIRE_EQUAL(header.LeafSize(), 12);
+  BOOST_REQUIRE_EQUAL(header.Dimensionality(), 3);
+  BOOST_REQUIRE_EQUAL(header.ReferenceSize(), 150);
+
+  remove("ra_header.txt");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
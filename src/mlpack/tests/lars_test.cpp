@@ -352,4 +352,50 @@ BOOST_AUTO_TEST_CASE(TrainingConstructorWithNonDefaultsTest)
     BOOST_REQUIRE_CLOSE(beta[i], lars2.Beta()[i], 1e-5);
 }
 
+/**
+ * Make sure that training on several vectors of targets at once gives the same
+ * solutions as training on each of them separately, and that the path of the
+ * last vector is kept.
+ */
+BOOST_AUTO_TEST_CASE(MultipleTargetsTest)
+{
+  arma::mat X = arma::randn(20, 200);
+  arma::mat Y = arma::randn(10, 20) * X;
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const bool useCholesky = (i % 2 == 0);
+    const double lambda2 = (i < 2) ? 0.0 : 0.3;
+
+    LARS lars(useCholesky, 0.5, lambda2);
+    arma::mat betas;
+    lars.Train(X, Y, betas);
+
+    BOOST_REQUIRE_EQUAL(betas.n_rows, 20);
+    BOOST_REQUIRE_EQUAL(betas.n_cols, 10);
+
+    for (size_t t = 0; t < Y.n_rows; ++t)
+    {
+      LARS single(useCholesky, 0.5, lambda2);
+      arma::vec beta;
+      single.Train(X, Y.row(t), beta);
+
+      for (size_t j = 0; j < beta.n_elem; ++j)
+      {
+        if (std::abs(beta[j]) < 1e-8)
+          BOOST_REQUIRE_SMALL(betas(j, t), 1e-8);
+        else
+          BOOST_REQUIRE_CLOSE(betas(j, t), beta[j], 1e-5);
+      }
+
+      if (t == Y.n_rows - 1)
+      {
+        BOOST_REQUIRE_EQUAL(lars.BetaPath().size(), single.BetaPath().size());
+        BOOST_REQUIRE_EQUAL(lars.ActiveSet().size(),
+            single.ActiveSet().size());
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
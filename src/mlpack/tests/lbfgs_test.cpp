@@ -137,4 +137,57 @@ BOOST_AUTO_TEST_CASE(RosenbrockWoodFunctionTest)
   }
 }
 
+/**
+ * Tests that evaluating the trials of the line search in parallel takes the
+ * same steps as the serial line search.
+ */
+BOOST_AUTO_TEST_CASE(ParallelLineSearchTest)
+{
+  GeneralizedRosenbrockFunction f(16);
+
+  L_BFGS lbfgs(20);
+  arma::mat serialCoords = f.GetInitialPoint();
+  const double serialValue = lbfgs.Optimize(f, serialCoords);
+
+  lbfgs.LineSearchBatchSize() = 4;
+  arma::mat parallelCoords = f.GetInitialPoint();
+  const double parallelValue = lbfgs.Optimize(f, parallelCoords);
+
+  BOOST_REQUIRE_SMALL(serialValue, 1e-5);
+  BOOST_REQUIRE_SMALL(parallelValue, 1e-5);
+  for (size_t i = 0; i < serialCoords.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(serialCoords[i], parallelCoords[i], 1e-5);
+}
+
+/**
+ * Tests that a run which is interrupted and resumed from its checkpoint ends
+ * at the same point as an uninterrupted run.
+ */
+BOOST_AUTO_TEST_CASE(CheckpointResumeTest)
+{
+  GeneralizedRosenbrockFunction f(16);
+
+  L_BFGS lbfgs;
+  arma::mat coords = f.GetInitialPoint();
+  lbfgs.Optimize(f, coords);
+
+  // The first run stops early, leaving a checkpoint behind.
+  std::remove("lbfgs_checkpoint.bin");
+  L_BFGS interrupted;
+  interrupted.MaxIterations() = 12;
+  interrupted.Checkpointing() = Checkpoint("lbfgs_checkpoint.bin", 5);
+  arma::mat resumedCoords = f.GetInitialPoint();
+  interrupted.Optimize(f, resumedCoords);
+
+  // Now resume from the checkpoint (written after iteration 10) with a fresh
+  // starting point.
+  interrupted.MaxIterations() = 10000;
+  resumedCoords = f.GetInitialPoint();
+  interrupted.Optimize(f, resumedCoords);
+  std::remove("lbfgs_checkpoint.bin");
+
+  for (size_t i = 0; i < coords.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(coords[i], resumedCoords[i], 1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -199,4 +199,49 @@ BOOST_AUTO_TEST_CASE(LinearRegressionTrainTest)
     BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrTrain.Parameters()[i], 1e-5);
 }
 
+/**
+ * Test that a LinearRegression model trained on a dataset in several batches
+ * with Update() is the same as a model trained on the whole dataset, with and
+ * without intercept, weights and regularization.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionUpdateTest)
+{
+  // Enough points to have several blocks.
+  arma::mat dataset = arma::randu<arma::mat>(5, 10000);
+  arma::rowvec responses = arma::randu<arma::rowvec>(10000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(10000);
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const bool intercept = (i % 2 == 0);
+    const double lambda = (i < 2) ? 0.0 : 0.5;
+
+    LinearRegression lr(dataset, responses, lambda, intercept);
+    LinearRegression lrWeighted(dataset, responses, weights, lambda,
+        intercept);
+
+    LinearRegression lrUpdate(dataset.cols(0, 2999), responses.subvec(0, 2999),
+        lambda, intercept);
+    lrUpdate.Update(dataset.cols(3000, 3009), responses.subvec(3000, 3009));
+    lrUpdate.Update(dataset.cols(3010, 9999), responses.subvec(3010, 9999));
+
+    LinearRegression lrWeightedUpdate;
+    lrWeightedUpdate.Lambda() = lambda;
+    lrWeightedUpdate.Train(dataset.cols(0, 4999), responses.subvec(0, 4999),
+        weights.subvec(0, 4999), intercept);
+    lrWeightedUpdate.Update(dataset.cols(5000, 9999),
+        responses.subvec(5000, 9999), weights.subvec(5000, 9999));
+
+    BOOST_REQUIRE_EQUAL(lrUpdate.Parameters().n_elem, lr.Parameters().n_elem);
+    BOOST_REQUIRE_EQUAL(lrWeightedUpdate.Parameters().n_elem,
+        lrWeighted.Parameters().n_elem);
+    for (size_t j = 0; j < lr.Parameters().n_elem; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(lrUpdate.Parameters()[j], lr.Parameters()[j], 1e-5);
+      BOOST_REQUIRE_CLOSE(lrWeightedUpdate.Parameters()[j],
+          lrWeighted.Parameters()[j], 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,155 @@
+/**
+ * @file linear_svm_test.cpp
+ *
+ * Tests for the LinearSVM class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/linear_svm/linear_svm.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::svm;
+
+BOOST_AUTO_TEST_SUITE(LinearSVMTest);
+
+/**
+ * Make a dataset of Gaussian clusters around a center for each class, with the
+ * given distance between the centers.
+ */
+static void MakeClusters(const size_t numClasses,
+                         const size_t pointsPerClass,
+                         const double distance,
+                         arma::mat& data,
+                         arma::Row<size_t>& labels)
+{
+  const size_t dimensionality = 5;
+  data.randn(dimensionality, numClasses * pointsPerClass);
+  labels.set_size(numClasses * pointsPerClass);
+  for (size_t c = 0; c < numClasses; ++c)
+  {
+    arma::vec center(dimensionality, arma::fill::zeros);
+    center[c % dimensionality] = distance * (1 + c / dimensionality);
+    data.cols(c * pointsPerClass, (c + 1) * pointsPerClass - 1).each_col() +=
+        center;
+    labels.cols(c * pointsPerClass, (c + 1) * pointsPerClass - 1).fill(c);
+  }
+}
+
+/**
+ * Two well-separated classes should be classified perfectly, with both
+ * losses.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMSeparableTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  MakeClusters(2, 500, 20.0, data, labels);
+
+  LinearSVM svm(data, labels, 2);
+  BOOST_REQUIRE_EQUAL(svm.NumClasses(), 2);
+  BOOST_REQUIRE_CLOSE(svm.ComputeAccuracy(data, labels), 100.0, 1e-5);
+
+  // The model of class 0 is the negation of the model of class 1.
+  CheckMatrices(svm.Weights().col(0), -svm.Weights().col(1));
+  BOOST_REQUIRE_CLOSE(svm.Biases()[0], -svm.Biases()[1], 1e-5);
+
+  LinearSVM svm2(data, labels, 2, 1.0, true /* squared hinge */);
+  BOOST_REQUIRE_CLOSE(svm2.ComputeAccuracy(data, labels), 100.0, 1e-5);
+
+  // Classifying single points should give the same predictions.
+  arma::Row<size_t> predictions;
+  svm.Classify(data, predictions);
+  for (size_t i = 0; i < data.n_cols; i += 50)
+    BOOST_REQUIRE_EQUAL(svm.Classify(data.col(i)), predictions[i]);
+}
+
+/**
+ * One-vs-rest training should classify several separated classes well, and the
+ * scores should give the predictions.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMMulticlassTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  MakeClusters(4, 300, 25.0, data, labels);
+
+  LinearSVM svm(data, labels, 4, 10.0);
+  BOOST_REQUIRE_EQUAL(svm.NumClasses(), 4);
+  BOOST_REQUIRE_EQUAL(svm.Weights().n_rows, data.n_rows);
+
+  arma::Row<size_t> predictions;
+  arma::mat scores;
+  svm.Classify(data, predictions, scores);
+  BOOST_REQUIRE_EQUAL(scores.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(scores.n_cols, data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], scores.col(i).index_max());
+
+  BOOST_REQUIRE_GT(svm.ComputeAccuracy(data, labels), 97.0);
+}
+
+/**
+ * Training on a sparse matrix should give the same model as training on the
+ * same dense matrix.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMSparseDenseTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(100, 2000, 0.05);
+  const arma::mat data(sparseData);
+
+  // Label the points with a random hyperplane.
+  const arma::vec w = arma::randn<arma::vec>(100);
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = (arma::dot(w, data.col(i)) > 0.0) ? 1 : 0;
+
+  math::RandomSeed(10);
+  LinearSVM denseSVM(data, labels, 2, 5.0);
+  math::RandomSeed(10);
+  LinearSVM sparseSVM(sparseData, labels, 2, 5.0);
+
+  CheckMatrices(denseSVM.Weights(), sparseSVM.Weights());
+  CheckMatrices(denseSVM.Biases(), sparseSVM.Biases());
+
+  arma::Row<size_t> densePredictions, sparsePredictions;
+  denseSVM.Classify(data, densePredictions);
+  sparseSVM.Classify(sparseData, sparsePredictions);
+  CheckMatrices(densePredictions, sparsePredictions);
+
+  BOOST_REQUIRE_GT(sparseSVM.ComputeAccuracy(sparseData, labels), 90.0);
+}
+
+/**
+ * Make sure the model can be serialized.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMSerializationTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  MakeClusters(3, 200, 15.0, data, labels);
+
+  LinearSVM svm(data, labels, 3, 2.0, false, false);
+  LinearSVM xmlSVM, textSVM, binarySVM(5.0, true, true, 10, 0.5);
+  SerializeObjectAll(svm, xmlSVM, textSVM, binarySVM);
+
+  BOOST_REQUIRE_EQUAL(binarySVM.C(), 2.0);
+  BOOST_REQUIRE_EQUAL(binarySVM.SquaredHinge(), false);
+  BOOST_REQUIRE_EQUAL(binarySVM.FitIntercept(), false);
+  BOOST_REQUIRE_EQUAL(binarySVM.MaxIterations(), svm.MaxIterations());
+
+  CheckMatrices(svm.Weights(), xmlSVM.Weights(), textSVM.Weights(),
+      binarySVM.Weights());
+  CheckMatrices(svm.Biases(), xmlSVM.Biases(), textSVM.Biases(),
+      binarySVM.Biases());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
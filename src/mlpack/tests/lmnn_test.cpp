@@ -101,6 +101,81 @@ BOOST_AUTO_TEST_CASE(LMNNImpostorsTest)
   BOOST_REQUIRE_EQUAL(impostors(0, 5), 2);
 }
 
+/**
+ * Check that the impostors found by the given Constraints object for the given
+ * dataset are the same as those found by a new Constraints object, whose
+ * reference trees are built from scratch.
+ */
+void CheckImpostors(Constraints<>& constraint,
+                    const arma::mat& dataset,
+                    const arma::Row<size_t>& labels,
+                    const size_t k)
+{
+  arma::vec norm(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; i++)
+    norm(i) = arma::norm(dataset.col(i));
+
+  arma::Mat<size_t> impostors(k, dataset.n_cols), baselineImpostors(k,
+      dataset.n_cols);
+  arma::mat distances(k, dataset.n_cols), baselineDistances(k,
+      dataset.n_cols);
+  constraint.Impostors(impostors, distances, dataset, labels, norm);
+
+  Constraints<> baseline(dataset, labels, k);
+  baseline.Impostors(baselineImpostors, baselineDistances, dataset, labels,
+      norm);
+
+  for (size_t i = 0; i < impostors.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(impostors[i], baselineImpostors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], baselineDistances[i], 1e-5);
+  }
+
+  // The batch version should find the same impostors.
+  arma::Mat<size_t> batchImpostors(k, dataset.n_cols);
+  for (size_t begin = 0; begin < dataset.n_cols; begin += 100)
+  {
+    constraint.Impostors(batchImpostors, dataset, labels, norm, begin,
+        std::min((size_t) 100, dataset.n_cols - begin));
+  }
+
+  for (size_t i = 0; i < impostors.n_elem; i++)
+    BOOST_REQUIRE_EQUAL(batchImpostors[i], baselineImpostors[i]);
+}
+
+/**
+ * The impostors should be correct when the reference trees of the classes are
+ * reused, refitted or built again as the dataset is transformed.
+ */
+BOOST_AUTO_TEST_CASE(LMNNReusedImpostorsTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1000);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(1000,
+      arma::distr_param(0, 3));
+  const size_t k = 3;
+
+  Constraints<> constraint(dataset, labels, k);
+
+  // The trees are built.
+  CheckImpostors(constraint, dataset, labels, k);
+  // The trees are reused as they are.
+  CheckImpostors(constraint, dataset, labels, k);
+
+  // A small change of the transformation only refits the trees.
+  arma::mat transformation = arma::eye<arma::mat>(4, 4) +
+      0.01 * arma::randu<arma::mat>(4, 4);
+  CheckImpostors(constraint, transformation * dataset, labels, k);
+
+  // A large change builds them again.
+  transformation = arma::randu<arma::mat>(4, 4);
+  CheckImpostors(constraint, transformation * dataset, labels, k);
+
+  // Without refitting, the trees are built again every time the points move.
+  constraint.RefitTolerance() = 0.0;
+  transformation += 0.01 * arma::randu<arma::mat>(4, 4);
+  CheckImpostors(constraint, transformation * dataset, labels, k);
+}
+
 //
 // Tests for the LMNNFunction
 //
@@ -10,10 +10,19 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <sstream>
+#include <set>
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/data/load_arff.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
+#include <mlpack/core/data/streaming_dataset.hpp>
+
+#ifdef HAS_ARROW
+  #include <mlpack/core/data/load_arrow.hpp>
+  #include <arrow/api.h>
+  #include <arrow/io/api.h>
+  #include <parquet/arrow/writer.h>
+#endif
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -155,6 +164,47 @@ BOOST_AUTO_TEST_CASE(SaveCSVTest)
   remove("test_file.csv");
 }
 
+/**
+ * Make sure delimited text files are written with values that read back
+ * exactly, with and without transposing.
+ */
+BOOST_AUTO_TEST_CASE(SaveTextRoundTripTest)
+{
+  arma::mat test = arma::randn<arma::mat>(30, 200) * 1e4;
+  test(0, 0) = 0.1;
+  test(1, 0) = -1e-300;
+  arma::Mat<size_t> labels = arma::randi<arma::Mat<size_t>>(5, 100,
+      arma::distr_param(0, 1000000));
+
+  const char* filenames[] = { "test_file.csv", "test_file.tsv",
+      "test_file.txt" };
+  for (const char* filename : filenames)
+  {
+    for (const bool transpose : { true, false })
+    {
+      arma::mat test2;
+      BOOST_REQUIRE(data::Save(filename, test, true, transpose) == true);
+      BOOST_REQUIRE(data::Load(filename, test2, true, transpose) == true);
+
+      BOOST_REQUIRE_EQUAL(test2.n_rows, test.n_rows);
+      BOOST_REQUIRE_EQUAL(test2.n_cols, test.n_cols);
+      for (size_t i = 0; i < test.n_elem; ++i)
+        BOOST_REQUIRE_EQUAL(test2[i], test[i]);
+
+      arma::Mat<size_t> labels2;
+      BOOST_REQUIRE(data::Save(filename, labels, true, transpose) == true);
+      BOOST_REQUIRE(data::Load(filename, labels2, true, transpose) == true);
+
+      BOOST_REQUIRE_EQUAL(labels2.n_rows, labels.n_rows);
+      BOOST_REQUIRE_EQUAL(labels2.n_cols, labels.n_cols);
+      for (size_t i = 0; i < labels.n_elem; ++i)
+        BOOST_REQUIRE_EQUAL(labels2[i], labels[i]);
+    }
+
+    remove(filename);
+  }
+}
+
 /**
  * Make sure CSVs can be loaded in transposed form.
  */
@@ -766,6 +816,240 @@ BOOST_AUTO_TEST_CASE(SaveHDF5Test)
   remove("test_file.he5");
 }
 
+/**
+ * Make sure rows and columns can be selected when loading HDF5 files, both
+ * from contiguous datasets and from datasets stored in compressed chunks, and
+ * that HDF5 files can be streamed.
+ */
+BOOST_AUTO_TEST_CASE(LoadHDF5SelectionTest)
+{
+  arma::mat test(6, 250, arma::fill::randu);
+
+  // Armadillo writes a contiguous dataset.
+  BOOST_REQUIRE(data::Save("test_file.h5", test) == true);
+
+  // Write the same (transposed) matrix in compressed chunks of 7 points.
+  const arma::mat stored = trans(test);
+  hid_t file = H5Fcreate("test_chunked.h5", H5F_ACC_TRUNC, H5P_DEFAULT,
+      H5P_DEFAULT);
+  hsize_t dims[2] = { test.n_rows, test.n_cols };
+  hsize_t chunkDims[2] = { 4, 7 };
+  hid_t space = H5Screate_simple(2, dims, NULL);
+  hid_t plist = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(plist, 2, chunkDims);
+  H5Pset_deflate(plist, 6);
+  hid_t dataset = H5Dcreate(file, "dataset", H5T_NATIVE_DOUBLE, space,
+      H5P_DEFAULT, plist, H5P_DEFAULT);
+  H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+      stored.memptr());
+  H5Dclose(dataset);
+  H5Pclose(plist);
+  H5Sclose(space);
+  H5Fclose(file);
+
+  const char* filenames[] = { "test_file.h5", "test_chunked.h5" };
+  for (const char* filename : filenames)
+  {
+    arma::mat block;
+    BOOST_REQUIRE(data::Load(filename, block, arma::span::all,
+        arma::span(30, 99)) == true);
+    BOOST_REQUIRE_EQUAL(block.n_rows, 6);
+    BOOST_REQUIRE_EQUAL(block.n_cols, 70);
+    arma::mat expected = test.cols(30, 99);
+    CheckMatrices(block, expected);
+
+    BOOST_REQUIRE(data::Load(filename, block, arma::span(1, 4),
+        arma::span(5, 203)) == true);
+    expected = test.submat(1, 5, 4, 203);
+    CheckMatrices(block, expected);
+
+    // Without transposing, the selection is of the stored matrix.
+    BOOST_REQUIRE(data::Load(filename, block, arma::span(10, 19),
+        arma::span(2, 2), false, false) == true);
+    expected = trans(test.submat(2, 10, 2, 19));
+    CheckMatrices(block, expected);
+
+    BOOST_REQUIRE(data::Load(filename, block, arma::span::all,
+        arma::span(200, 250)) == false);
+    BOOST_REQUIRE(data::Load(filename, block, arma::span::all,
+        arma::span::all, false, true, "nothing") == false);
+
+    data::HDF5Dataset<> hdf5(filename);
+    BOOST_REQUIRE_EQUAL(hdf5.NumRows(), 250);
+    BOOST_REQUIRE_EQUAL(hdf5.NumCols(), 6);
+  }
+
+  // Only HDF5 files support selections.
+  BOOST_REQUIRE(data::Load("test_file.csv", test, arma::span::all,
+      arma::span(0, 1)) == false);
+
+  // Stream the points of an HDF5 file (saved without transposing, so each
+  // point is a column of the stored matrix).
+  hid_t file2 = H5Fcreate("test_stream.h5", H5F_ACC_TRUNC, H5P_DEFAULT,
+      H5P_DEFAULT);
+  hsize_t dims2[2] = { test.n_cols, test.n_rows };
+  hsize_t chunkDims2[2] = { 16, 6 };
+  space = H5Screate_simple(2, dims2, NULL);
+  plist = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(plist, 2, chunkDims2);
+  H5Pset_deflate(plist, 1);
+  dataset = H5Dcreate(file2, "dataset", H5T_NATIVE_DOUBLE, space, H5P_DEFAULT,
+      plist, H5P_DEFAULT);
+  H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+      test.memptr());
+  H5Dclose(dataset);
+  H5Pclose(plist);
+  H5Sclose(space);
+  H5Fclose(file2);
+
+  // The chunk size is rounded up to a multiple of the HDF5 chunks.
+  data::StreamingDataset<> stream("test_stream.h5", 40);
+  BOOST_REQUIRE_EQUAL(stream.NumRows(), 6);
+  BOOST_REQUIRE_EQUAL(stream.NumCols(), 250);
+  BOOST_REQUIRE_EQUAL(stream.ChunkSize(), 48);
+
+  arma::mat chunk;
+  for (size_t i = 0; i < stream.NumChunks(); ++i)
+  {
+    stream.Chunk(i, i + 1, chunk);
+    const size_t last = std::min((i + 1) * 48, (size_t) 250) - 1;
+    arma::mat expected = test.cols(i * 48, last);
+    CheckMatrices(chunk, expected);
+  }
+
+  remove("test_file.h5");
+  remove("test_chunked.h5");
+  remove("test_stream.h5");
+}
+
+#endif
+
+#ifdef HAS_ARROW
+/**
+ * Make sure matrices saved as Parquet and Arrow IPC files are loaded back
+ * correctly, with and without transposing.
+ */
+BOOST_AUTO_TEST_CASE(SaveLoadArrowTest)
+{
+  arma::mat test(4, 1000, arma::fill::randu);
+  const char* filenames[] = { "test_file.parquet", "test_file.arrow" };
+
+  for (size_t f = 0; f < 2; ++f)
+  {
+    for (size_t t = 0; t < 2; ++t)
+    {
+      const bool transpose = (t == 0);
+
+      arma::mat loaded;
+      BOOST_REQUIRE(data::Save(filenames[f], test, true, transpose) == true);
+      BOOST_REQUIRE(data::Load(filenames[f], loaded, true, transpose) == true);
+
+      BOOST_REQUIRE_EQUAL(loaded.n_rows, test.n_rows);
+      BOOST_REQUIRE_EQUAL(loaded.n_cols, test.n_cols);
+      for (size_t i = 0; i < test.n_elem; ++i)
+        BOOST_REQUIRE_EQUAL(loaded[i], test[i]);
+    }
+
+    remove(filenames[f]);
+  }
+
+  // Integer matrices are stored with integer columns.
+  arma::Mat<size_t> labels = arma::randi<arma::Mat<size_t>>(2, 100,
+      arma::distr_param(0, 10));
+  arma::Mat<size_t> loadedLabels;
+  BOOST_REQUIRE(data::Save("test_file.parquet", labels) == true);
+  BOOST_REQUIRE(data::Load("test_file.parquet", loadedLabels) == true);
+  BOOST_REQUIRE_EQUAL(loadedLabels.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(loadedLabels.n_cols, 100);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(loadedLabels[i], labels[i]);
+
+  remove("test_file.parquet");
+}
+
+/**
+ * Make sure that only the requested columns are loaded, in the requested
+ * order.
+ */
+BOOST_AUTO_TEST_CASE(LoadArrowColumnsTest)
+{
+  arma::mat test(5, 100, arma::fill::randu);
+  BOOST_REQUIRE(data::Save("test_file.parquet", test) == true);
+
+  arma::mat loaded;
+  data::LoadArrow("test_file.parquet", loaded, { "3", "1" });
+
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, 100);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(loaded(0, i), test(3, i));
+    BOOST_REQUIRE_EQUAL(loaded(1, i), test(1, i));
+  }
+
+  BOOST_REQUIRE_THROW(data::LoadArrow("test_file.parquet", loaded,
+      { "7" }), std::runtime_error);
+
+  remove("test_file.parquet");
+}
+
+/**
+ * Make sure the string columns of a Parquet file are mapped into the
+ * DatasetInfo, with nulls mapped like empty strings.
+ */
+BOOST_AUTO_TEST_CASE(LoadArrowStringColumnTest)
+{
+  const char* categories[] = { "hello", "goodbye", "coffee" };
+
+  arrow::StringBuilder stringBuilder;
+  arrow::DoubleBuilder doubleBuilder;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    if (i % 10 == 9)
+      BOOST_REQUIRE(stringBuilder.AppendNull().ok());
+    else
+      BOOST_REQUIRE(stringBuilder.Append(categories[i % 3]).ok());
+    BOOST_REQUIRE(doubleBuilder.Append(0.5 * i).ok());
+  }
+
+  std::shared_ptr<arrow::Array> strings, doubles;
+  BOOST_REQUIRE(stringBuilder.Finish(&strings).ok());
+  BOOST_REQUIRE(doubleBuilder.Finish(&doubles).ok());
+
+  std::shared_ptr<arrow::Table> table = arrow::Table::Make(
+      arrow::schema({ arrow::field("word", arrow::utf8()),
+                      arrow::field("value", arrow::float64()) }),
+      { strings, doubles });
+
+  std::shared_ptr<arrow::io::FileOutputStream> file =
+      arrow::io::FileOutputStream::Open("test_file.parquet").ValueOrDie();
+  BOOST_REQUIRE(parquet::arrow::WriteTable(*table,
+      arrow::default_memory_pool(), file, 1000).ok());
+  BOOST_REQUIRE(file->Close().ok());
+
+  arma::mat loaded;
+  data::DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test_file.parquet", loaded, info) == true);
+
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, 100);
+  BOOST_REQUIRE(info.Type(0) == data::Datatype::categorical);
+  BOOST_REQUIRE(info.Type(1) == data::Datatype::numeric);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(0), 4);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 0);
+
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const std::string expected = (i % 10 == 9) ? "" : categories[i % 3];
+    BOOST_REQUIRE_EQUAL(info.UnmapString(loaded(0, i), 0), expected);
+    BOOST_REQUIRE_EQUAL(loaded(1, i), 0.5 * i);
+  }
+
+  // String columns can't be loaded without a DatasetInfo.
+  BOOST_REQUIRE(data::Load("test_file.parquet", loaded) == false);
+
+  remove("test_file.parquet");
+}
 #endif
 
 /**
@@ -822,6 +1106,39 @@ BOOST_AUTO_TEST_CASE(NormalizeLabelTest)
     BOOST_REQUIRE_EQUAL(randLabels[i], revertedLabels[i]);
 }
 
+/**
+ * Label normalization of a long vector, which is split into chunks.  The labels
+ * must still be numbered in the order of their first appearance.
+ */
+BOOST_AUTO_TEST_CASE(NormalizeLongLabelsTest)
+{
+  arma::Row<size_t> randLabels =
+      arma::randi<arma::Row<size_t>>(200000, arma::distr_param(0, 999));
+  // Some labels only appear at the end.
+  randLabels.tail(10) = arma::linspace<arma::Row<size_t>>(1000, 1009, 10);
+
+  arma::Row<size_t> newLabels;
+  arma::Col<size_t> mappings;
+  data::NormalizeLabels(randLabels, newLabels, mappings);
+
+  std::vector<size_t> firstSeen;
+  std::set<size_t> seen;
+  for (size_t i = 0; i < randLabels.n_elem; ++i)
+  {
+    if (seen.insert(randLabels[i]).second)
+      firstSeen.push_back(randLabels[i]);
+  }
+
+  BOOST_REQUIRE_EQUAL(mappings.n_elem, firstSeen.size());
+  for (size_t i = 0; i < firstSeen.size(); ++i)
+    BOOST_REQUIRE_EQUAL(mappings[i], firstSeen[i]);
+
+  arma::Row<size_t> revertedLabels;
+  data::RevertLabels(newLabels, mappings, revertedLabels);
+  for (size_t i = 0; i < randLabels.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(randLabels[i], revertedLabels[i]);
+}
+
 // Test structures.
 class TestInner
 {
@@ -927,6 +1244,73 @@ BOOST_AUTO_TEST_CASE(LoadTextTest)
   BOOST_REQUIRE_EQUAL(y.inb.s, x.inb.s);
 }
 
+// Test structure holding matrices.
+class TestMatrices
+{
+ public:
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(values);
+    ar & BOOST_SERIALIZATION_NVP(cube);
+    ar & BOOST_SERIALIZATION_NVP(labels);
+  }
+
+  // Public members for testing.
+  arma::mat values;
+  arma::cube cube;
+  arma::Mat<size_t> labels;
+};
+
+/**
+ * Make sure the compressed formats load back what was saved, with the
+ * precision they were saved with, and that integer matrices stay exact.
+ */
+BOOST_AUTO_TEST_CASE(LoadCompressedTest)
+{
+  TestMatrices x;
+  x.values = arma::randn(50, 300) * 10;
+  x.cube = arma::randu(4, 5, 6);
+  x.labels = arma::randi<arma::Mat<size_t>>(3, 200, arma::distr_param(0, 1000));
+
+  const format formats[] = { format::compressed, format::compressed_float32,
+      format::compressed_float16 };
+  const double tolerances[] = { 0.0, 1e-6, 1e-3 };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(data::Save("test.bin.gz", "x", x, false, formats[i]),
+        true);
+
+    // The format doesn't need to be given to load the file.
+    TestMatrices y;
+    BOOST_REQUIRE_EQUAL(data::Load("test.bin.gz", "x", y, false), true);
+
+    BOOST_REQUIRE_EQUAL(y.values.n_rows, x.values.n_rows);
+    BOOST_REQUIRE_EQUAL(y.values.n_cols, x.values.n_cols);
+    for (size_t j = 0; j < x.values.n_elem; ++j)
+    {
+      BOOST_REQUIRE_LE(std::abs(y.values[j] - x.values[j]),
+          tolerances[i] * (1 + std::abs(x.values[j])));
+    }
+
+    BOOST_REQUIRE_EQUAL(y.cube.n_elem, x.cube.n_elem);
+    for (size_t j = 0; j < x.cube.n_elem; ++j)
+    {
+      BOOST_REQUIRE_LE(std::abs(y.cube[j] - x.cube[j]),
+          tolerances[i] * (1 + std::abs(x.cube[j])));
+    }
+
+    BOOST_REQUIRE_EQUAL(y.labels.n_elem, x.labels.n_elem);
+    for (size_t j = 0; j < x.labels.n_elem; ++j)
+      BOOST_REQUIRE_EQUAL(y.labels[j], x.labels[j]);
+
+    // Later binary archives use full precision again.
+    BOOST_REQUIRE(data::SerializationPrecision() == data::full);
+  }
+
+  remove("test.bin.gz");
+}
+
 /**
  * Test DatasetInfo by making a map for a dimension.
  */
@@ -1819,6 +2203,95 @@ BOOST_AUTO_TEST_CASE(CaseTest)
   BOOST_CHECK_EQUAL(dataset.n_cols, 3);
 }
 
+/**
+ * Make sure that nominal attributes and sparse instances are loaded by
+ * LoadARFF(), both into dense and sparse matrices.
+ */
+BOOST_AUTO_TEST_CASE(SparseARFFTest)
+{
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one numeric" << endl;
+  f << "@attribute 'two' {red, 'dark blue', green}" << endl;
+  f << "@attribute three string" << endl;
+  f << "@attribute four real" << endl;
+  f << "@data" << endl;
+  f << "1.5, green, hello, 0" << endl;
+  f << "{1 'dark blue', 3 -2.5} % comment" << endl;
+  f << "% comment" << endl;
+  f << "{}" << endl;
+  f << "{0 3, 2 \"good, bye\"}" << endl;
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  data::LoadARFF("test.arff", dataset, info);
+
+  BOOST_REQUIRE_EQUAL(info.Dimensionality(), 4);
+  BOOST_REQUIRE(info.Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE(info.Type(2) == Datatype::categorical);
+  BOOST_REQUIRE(info.Type(3) == Datatype::numeric);
+
+  // Nominal values are mapped in the order they are declared.
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 3);
+  BOOST_REQUIRE_EQUAL(info.UnmapString(0, 1), "red");
+  BOOST_REQUIRE_EQUAL(info.UnmapString(1, 1), "dark blue");
+  BOOST_REQUIRE_EQUAL(info.UnmapString(2, 1), "green");
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), 2);
+  BOOST_REQUIRE_EQUAL(info.UnmapString(1, 2), "good, bye");
+
+  arma::mat expected = "1.5 0.0 0.0 3.0;"
+                       "2.0 1.0 0.0 0.0;"
+                       "0.0 0.0 0.0 1.0;"
+                       "0.0 -2.5 0.0 0.0;";
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, 4);
+  for (size_t i = 0; i < expected.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(dataset[i], expected[i]);
+
+  // The sparse matrix must hold the same values.
+  arma::sp_mat sparse;
+  DatasetInfo sparseInfo;
+  data::LoadARFF("test.arff", sparse, sparseInfo);
+
+  BOOST_REQUIRE_EQUAL(sparse.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(sparse.n_cols, 4);
+  BOOST_REQUIRE_EQUAL(sparse.n_nonzero, 6);
+  for (size_t i = 0; i < expected.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL((double) sparse[i], expected[i]);
+
+  remove("test.arff");
+}
+
+/**
+ * Make sure that errors in ARFF instances are reported.
+ */
+BOOST_AUTO_TEST_CASE(BadARFFInstanceTest)
+{
+  const char* instances[] = { "1, 2, 3", "1, ?", "1, x", "{2 1}", "{0 1" };
+  for (const char* instance : instances)
+  {
+    fstream f;
+    f.open("test.arff", fstream::out);
+    f << "@relation test" << endl;
+    f << "@attribute one numeric" << endl;
+    f << "@attribute two numeric" << endl;
+    f << "@data" << endl;
+    f << "1, 2" << endl;
+    f << instance << endl;
+    f.close();
+
+    arma::mat dataset;
+    DatasetInfo info;
+    BOOST_REQUIRE_THROW(data::LoadARFF("test.arff", dataset, info),
+        std::runtime_error);
+  }
+
+  remove("test.arff");
+}
+
 /**
  * Test that a CSV with the wrong number of columns fails.
  */
@@ -1994,4 +2467,195 @@ BOOST_AUTO_TEST_CASE(DatasetMapperNonUniqueTest)
   BOOST_REQUIRE_EQUAL(dm.UnmapString(nan, 0, 2), "cheese");
 }
 
+/**
+ * Make sure that the parallel CSV loader gives the same matrix and mappings as
+ * LoadCSV, both transposed and non-transposed.
+ */
+BOOST_AUTO_TEST_CASE(LoadCSVParallelMatchesLoadCSVTest)
+{
+  const char* categories[] = { "hello", "goodbye", "coffee", "confusion" };
+
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    f << i << ", " << math::Random() << ", " << categories[(i * 7) % 4]
+        << ", " << ((i % 13 == 0) ? "x" : "1.5") << endl;
+  }
+  f.close();
+
+  for (size_t t = 0; t < 2; ++t)
+  {
+    const bool transpose = (t == 0);
+
+    arma::mat matrix, parallelMatrix;
+    DatasetInfo info, parallelInfo;
+
+    LoadCSV loader("test.csv");
+    loader.Load(matrix, info, transpose);
+    LoadCSVParallel parallelLoader("test.csv");
+    parallelLoader.Load(parallelMatrix, parallelInfo, transpose);
+
+    BOOST_REQUIRE_EQUAL(matrix.n_rows, parallelMatrix.n_rows);
+    BOOST_REQUIRE_EQUAL(matrix.n_cols, parallelMatrix.n_cols);
+    for (size_t i = 0; i < matrix.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(matrix[i], parallelMatrix[i]);
+
+    BOOST_REQUIRE_EQUAL(info.Dimensionality(), parallelInfo.Dimensionality());
+    for (size_t d = 0; d < info.Dimensionality(); ++d)
+    {
+      BOOST_REQUIRE(info.Type(d) == parallelInfo.Type(d));
+      BOOST_REQUIRE_EQUAL(info.NumMappings(d), parallelInfo.NumMappings(d));
+    }
+  }
+
+  remove("test.csv");
+}
+
+/**
+ * Make sure that the mappings merged by the parallel CSV loader for
+ * high-cardinality categorical dimensions are the ones LoadCSV creates.
+ */
+BOOST_AUTO_TEST_CASE(LoadCSVParallelManyCategoriesTest)
+{
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    f << "a" << math::RandInt(2000) << "," << i << ",b" << (i * 31) % 4999
+        << endl;
+  }
+  f.close();
+
+  for (size_t t = 0; t < 2; ++t)
+  {
+    const bool transpose = (t == 0);
+
+    arma::mat matrix, parallelMatrix;
+    DatasetInfo info, parallelInfo;
+
+    LoadCSV loader("test.csv");
+    loader.Load(matrix, info, transpose);
+    LoadCSVParallel parallelLoader("test.csv");
+    parallelLoader.Load(parallelMatrix, parallelInfo, transpose);
+
+    BOOST_REQUIRE_EQUAL(matrix.n_rows, parallelMatrix.n_rows);
+    BOOST_REQUIRE_EQUAL(matrix.n_cols, parallelMatrix.n_cols);
+    for (size_t i = 0; i < matrix.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(matrix[i], parallelMatrix[i]);
+
+    BOOST_REQUIRE_EQUAL(info.Dimensionality(), parallelInfo.Dimensionality());
+    for (size_t d = 0; d < info.Dimensionality(); ++d)
+    {
+      BOOST_REQUIRE(info.Type(d) == parallelInfo.Type(d));
+      BOOST_REQUIRE_EQUAL(info.NumMappings(d), parallelInfo.NumMappings(d));
+      for (size_t m = 0; m < info.NumMappings(d); ++m)
+      {
+        BOOST_REQUIRE_EQUAL(info.UnmapString(m, d),
+            parallelInfo.UnmapString(m, d));
+      }
+    }
+  }
+
+  remove("test.csv");
+}
+
+/**
+ * Make sure that HashingPolicy maps categorical strings to the same buckets in
+ * every file without storing mappings, and that HashFeatures() builds the
+ * matching sparse features.
+ */
+BOOST_AUTO_TEST_CASE(HashingPolicyTest)
+{
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < 3000; ++i)
+    f << "user" << (i * 17) % 2999 << "," << i << ",x" << i % 3 << endl;
+  f.close();
+
+  HashingPolicy policy(64, true);
+  DatasetMapper<HashingPolicy> info(policy);
+  arma::mat dataset;
+  BOOST_REQUIRE(data::Load("test.csv", dataset, info, true) == true);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, 3000);
+  BOOST_REQUIRE(info.Type(0) == Datatype::categorical);
+  BOOST_REQUIRE(info.Type(1) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(2) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(info.Policy().NumBuckets(), 64);
+
+  // Nothing is stored, and the values are the hashes of the strings.
+  for (size_t d = 0; d < 3; ++d)
+    BOOST_REQUIRE_EQUAL(info.NumMappings(d), 0);
+
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    std::ostringstream user, x;
+    user << "user" << (i * 17) % 2999;
+    x << "x" << i % 3;
+    BOOST_REQUIRE_EQUAL(dataset(0, i), info.Policy().Hash(user.str(), 0));
+    BOOST_REQUIRE_EQUAL(dataset(1, i), i);
+    BOOST_REQUIRE_EQUAL(dataset(2, i), info.Policy().Hash(x.str(), 2));
+    BOOST_REQUIRE_LT(dataset(0, i), 128);
+  }
+
+  // With the same policy, another file gets the same hashes.
+  DatasetMapper<HashingPolicy> dm(policy, 3);
+  BOOST_REQUIRE_EQUAL(dm.MapString<double>("user0", 0), dataset(0, 0));
+  BOOST_REQUIRE_EQUAL(dm.MapString<double>("x1", 2), dataset(2, 1));
+  BOOST_REQUIRE_EQUAL(dm.MapString<double>("3.5", 1), 3.5);
+
+  arma::sp_mat features;
+  HashFeatures(dataset, info, features);
+  BOOST_REQUIRE_EQUAL(features.n_rows, 65);
+  BOOST_REQUIRE_EQUAL(features.n_cols, 3000);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    arma::vec expected(65, arma::fill::zeros);
+    expected[0] = i;
+    for (size_t d = 0; d < 3; d += 2)
+    {
+      const size_t value = (size_t) dataset(d, i);
+      expected[1 + info.Policy().Bucket(value)] += info.Policy().Sign(value);
+    }
+
+    for (size_t r = 0; r < 65; ++r)
+      BOOST_REQUIRE_EQUAL((double) features(r, i), expected[r]);
+  }
+
+  remove("test.csv");
+}
+
+/**
+ * Make sure that FirstTouch() doesn't change the matrix, and that matrices
+ * loaded with first touch enabled are the same as without.
+ */
+BOOST_AUTO_TEST_CASE(FirstTouchTest)
+{
+  arma::mat matrix(5, 1000, arma::fill::randu);
+  arma::mat placed(matrix);
+  {
+    util::ScopedNumThreads threads(4);
+    data::FirstTouch(placed);
+  }
+  CheckMatrices(matrix, placed);
+
+  data::Save("test.csv", matrix);
+
+  arma::mat loaded;
+  data::SetFirstTouch(true);
+  BOOST_REQUIRE(data::FirstTouchEnabled());
+  BOOST_REQUIRE(data::Load("test.csv", loaded));
+  data::SetFirstTouch(false);
+  BOOST_REQUIRE(!data::FirstTouchEnabled());
+
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, matrix.n_rows);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, matrix.n_cols);
+  for (size_t i = 0; i < matrix.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(loaded[i], matrix[i], 1e-5);
+
+  remove("test.csv");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -13,6 +13,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/data/streaming_function.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -813,6 +814,62 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionSparseSGDTest)
     BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrSparse.Parameters()[i], 1e-5);
 }
 
+/**
+ * Make sure that the sparse gradient of a batch is the same as the dense one,
+ * for sparse and dense data and with and without regularization.
+ */
+template<typename MatType>
+void CheckSparseGradient(const MatType& dataset,
+                         const arma::Row<size_t>& labels,
+                         const double lambda)
+{
+  LogisticRegressionFunction<MatType> lrf(dataset, labels, lambda);
+  const arma::mat parameters = arma::randn<arma::mat>(1, dataset.n_rows + 1);
+
+  for (size_t batchSize = 1; batchSize <= 20; batchSize *= 4)
+  {
+    for (size_t begin = 0; begin + batchSize <= dataset.n_cols; begin += 13)
+    {
+      arma::mat gradient;
+      arma::sp_mat sparseGradient;
+      lrf.Gradient(parameters, begin, gradient, batchSize);
+      lrf.Gradient(parameters, begin, sparseGradient, batchSize);
+
+      BOOST_REQUIRE_EQUAL(sparseGradient.n_rows, gradient.n_rows);
+      BOOST_REQUIRE_EQUAL(sparseGradient.n_cols, gradient.n_cols);
+      if (lambda == 0.0)
+      {
+        // Only the features of the points (and the intercept) are affected.
+        BOOST_REQUIRE_LE(sparseGradient.n_nonzero, arma::sp_mat(
+            dataset.cols(begin, begin + batchSize - 1)).n_nonzero + 1);
+      }
+
+      const arma::mat denseGradient(sparseGradient);
+      for (size_t i = 0; i < gradient.n_elem; ++i)
+      {
+        if (std::abs(gradient[i]) < 1e-10)
+          BOOST_REQUIRE_SMALL(denseGradient[i], 1e-10);
+        else
+          BOOST_REQUIRE_CLOSE(gradient[i], denseGradient[i], 1e-8);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(LogisticRegressionSparseGradientTest)
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(50, 200, 0.05);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = math::RandInt(0, 2);
+
+  CheckSparseGradient(dataset, labels, 0.0);
+  CheckSparseGradient(dataset, labels, 0.5);
+  CheckSparseGradient(arma::mat(dataset), labels, 0.0);
+  CheckSparseGradient(arma::mat(dataset), labels, 0.5);
+}
+
 /**
  * Test multi-point classification (Classify()).
  */
@@ -963,4 +1020,163 @@ BOOST_AUTO_TEST_CASE(ClassifyProbabilitiesTest)
   }
 }
 
+/**
+ * Make sure that classifying a batch that spans several blocks (which are
+ * classified in parallel) gives the same predictions and probabilities as
+ * classifying each point.
+ */
+BOOST_AUTO_TEST_CASE(LargeBatchClassifyTest)
+{
+  arma::mat data = arma::randn<arma::mat>(3, 3000);
+  arma::Row<size_t> responses(3000);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    responses[i] = i % 2;
+    if (i % 2 == 1)
+      data.col(i) += 2.0;
+  }
+
+  LogisticRegression<> lr(data, responses, 0.5);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  lr.Classify(data, predictions);
+  lr.Classify(data, probabilities);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, 3000);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, 3000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(lr.Classify(data.col(i)), predictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], (probabilities(1, i) >= 0.5) ? 1 : 0);
+    BOOST_REQUIRE_CLOSE(probabilities(0, i) + probabilities(1, i), 1.0, 1e-5);
+  }
+}
+
+/**
+ * Make sure that a LogisticRegressionFunction that streams its data from disk
+ * gives the same objective and gradients as one that holds all of the data.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionStreamingFunctionTest)
+{
+  const size_t points = 1000;
+  const size_t dimension = 10;
+
+  arma::mat data(dimension, points, arma::fill::randu);
+  arma::Row<size_t> responses(points);
+  for (size_t i = 0; i < points; ++i)
+    responses[i] = (arma::accu(data.col(i)) > dimension / 2.0) ? 1 : 0;
+
+  data.save("streaming_predictors.bin", arma::arma_binary);
+  responses.save("streaming_responses.bin", arma::arma_binary);
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+
+  {
+    data::StreamingDataset<> predictorStream("streaming_predictors.bin", 100);
+    data::StreamingDataset<size_t> responseStream("streaming_responses.bin",
+        100);
+    BOOST_REQUIRE_EQUAL(predictorStream.NumRows(), dimension);
+    BOOST_REQUIRE_EQUAL(predictorStream.NumCols(), points);
+    BOOST_REQUIRE_EQUAL(predictorStream.NumChunks(), 10);
+
+    LogisticRegressionFunction<> chunkFunction(arma::mat(),
+        arma::Row<size_t>(), 0.5);
+    data::StreamingFunction<LogisticRegressionFunction<>, double, size_t>
+        streamingFunction(chunkFunction, predictorStream, responseStream);
+    BOOST_REQUIRE_EQUAL(streamingFunction.NumFunctions(), points);
+
+    const arma::mat parameters(1, dimension + 1, arma::fill::randu);
+    arma::mat gradient, streamingGradient;
+    for (size_t i = 0; i < points; i += 10)
+    {
+      BOOST_REQUIRE_CLOSE(streamingFunction.Evaluate(parameters, i, 10),
+          lrf.Evaluate(parameters, i, 10), 1e-5);
+
+      lrf.Gradient(parameters, i, gradient, 10);
+      streamingFunction.Gradient(parameters, i, streamingGradient, 10);
+      CheckMatrices(gradient, streamingGradient);
+    }
+
+    // Batches that span two chunks must also give the same results.
+    BOOST_REQUIRE_CLOSE(streamingFunction.Evaluate(parameters, 95, 10),
+        lrf.Evaluate(parameters, 95, 10), 1e-5);
+
+    // Make sure the function can be optimized.
+    arma::mat coordinates(1, dimension + 1, arma::fill::zeros);
+    StandardSGD sgd(0.01, 10, 5 * points);
+    sgd.Optimize(streamingFunction, coordinates);
+
+    const arma::mat initialCoordinates(1, dimension + 1, arma::fill::zeros);
+    BOOST_REQUIRE_LT(lrf.Evaluate(coordinates),
+        lrf.Evaluate(initialCoordinates));
+  }
+
+  remove("streaming_predictors.bin");
+  remove("streaming_responses.bin");
+}
+
+/**
+ * Make sure that every point is visited once when the last chunk is shorter
+ * than the others and the chunks are shuffled, so that the sum over all the
+ * batches is the objective and gradient over the whole dataset.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionStreamingShuffleRemainderTest)
+{
+  const size_t points = 1005;
+  const size_t dimension = 10;
+
+  arma::mat data(dimension, points, arma::fill::randu);
+  arma::Row<size_t> responses(points);
+  for (size_t i = 0; i < points; ++i)
+    responses[i] = (arma::accu(data.col(i)) > dimension / 2.0) ? 1 : 0;
+
+  data.save("streaming_predictors.bin", arma::arma_binary);
+  responses.save("streaming_responses.bin", arma::arma_binary);
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+
+  {
+    data::StreamingDataset<> predictorStream("streaming_predictors.bin", 100);
+    data::StreamingDataset<size_t> responseStream("streaming_responses.bin",
+        100);
+    BOOST_REQUIRE_EQUAL(predictorStream.NumChunks(), 11);
+
+    LogisticRegressionFunction<> chunkFunction(arma::mat(),
+        arma::Row<size_t>(), 0.5);
+    data::StreamingFunction<LogisticRegressionFunction<>, double, size_t>
+        streamingFunction(chunkFunction, predictorStream, responseStream);
+
+    const arma::mat parameters(1, dimension + 1, arma::fill::randu);
+    arma::mat gradient;
+    lrf.Gradient(parameters, gradient);
+    const double objective = lrf.Evaluate(parameters);
+
+    // Try a few orders, so that the short chunk is moved away from the end.
+    for (size_t trial = 0; trial < 5; ++trial)
+    {
+      streamingFunction.Shuffle();
+
+      double streamingObjective = 0.0;
+      arma::mat streamingGradient(gradient.n_rows, gradient.n_cols,
+          arma::fill::zeros);
+      arma::mat batchGradient;
+      for (size_t i = 0; i < points; i += 10)
+      {
+        const size_t batchSize = std::min(size_t(10), points - i);
+        streamingObjective += streamingFunction.Evaluate(parameters, i,
+            batchSize);
+        streamingFunction.Gradient(parameters, i, batchGradient, batchSize);
+        streamingGradient += batchGradient;
+      }
+
+      BOOST_REQUIRE_CLOSE(streamingObjective, objective, 1e-5);
+      CheckMatrices(gradient, streamingGradient);
+    }
+  }
+
+  remove("streaming_predictors.bin");
+  remove("streaming_responses.bin");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -20,6 +20,7 @@
 #include <mlpack/methods/ann/loss_functions/sigmoid_cross_entropy_error.hpp>
 #include <mlpack/methods/ann/loss_functions/cross_entropy_error.hpp>
 #include <mlpack/methods/ann/loss_functions/reconstruction_loss.hpp>
+#include <mlpack/methods/ann/loss_functions/softmax_cross_entropy.hpp>
 #include <mlpack/methods/ann/init_rules/nguyen_widrow_init.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
 
@@ -354,4 +355,83 @@ BOOST_AUTO_TEST_CASE(GradientReconstructionLossTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * The softmax cross-entropy should match the negative log likelihood of the
+ * log softmax, also for scores that overflow exp().
+ */
+BOOST_AUTO_TEST_CASE(SimpleSoftmaxCrossEntropyTest)
+{
+  arma::mat input = arma::randn(10, 6);
+  input.col(5) *= 1000;
+  arma::mat target("1 4 10 7 2 3");
+  SoftmaxCrossEntropy<> module;
+
+  arma::mat expectedOutput(10, 6);
+  double expectedError = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const double maxScore = input.col(i).max();
+    const double logSum = maxScore +
+        std::log(arma::accu(arma::exp(input.col(i) - maxScore)));
+    expectedOutput.col(i) = arma::exp(input.col(i) - logSum);
+    expectedOutput((size_t) target(i) - 1, i) -= 1;
+    expectedError += logSum - input((size_t) target(i) - 1, i);
+  }
+
+  const double error = module.Forward(std::move(input), std::move(target));
+  BOOST_REQUIRE_CLOSE(error, expectedError, 1e-8);
+
+  arma::mat output;
+  module.Backward(std::move(input), std::move(target), std::move(output));
+  BOOST_REQUIRE_EQUAL(output.n_rows, input.n_rows);
+  BOOST_REQUIRE_EQUAL(output.n_cols, input.n_cols);
+  for (size_t i = 0; i < output.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(output[i] - expectedOutput[i], 1e-10);
+
+  // Every column of the gradient sums to zero.
+  BOOST_REQUIRE_SMALL(arma::abs(arma::sum(output)).max(), 1e-10);
+}
+
+/*
+ * Softmax cross-entropy numerical gradient test.
+ */
+BOOST_AUTO_TEST_CASE(GradientSoftmaxCrossEntropyTest)
+{
+  // Linear function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(10, 1);
+      target = arma::mat("3");
+
+      model = new FFN<SoftmaxCrossEntropy<>, NguyenWidrowInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(10, 4);
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      arma::mat output;
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<SoftmaxCrossEntropy<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -87,6 +87,92 @@ void SetupLovaszTheta(const arma::mat& edges,
   lovasz.AugLag().Lambda()[0] = -double(vertices);
 }
 
+/**
+ * Evaluate the augmented Lagrangian of an LRSDP and its gradient directly,
+ * with every constraint matrix formed explicitly.
+ */
+void NaiveAugLagrangian(const SDP<arma::sp_mat>& sdp,
+                        const arma::mat& coordinates,
+                        const arma::vec& lambda,
+                        const double sigma,
+                        double& objective,
+                        arma::mat& gradient)
+{
+  const arma::mat rrt = coordinates * trans(coordinates);
+  arma::mat s(sdp.C());
+  objective = accu(arma::mat(sdp.C()) % rrt);
+  for (size_t i = 0; i < sdp.NumSparseConstraints(); ++i)
+  {
+    const arma::mat a(sdp.SparseA()[i]);
+    const double constraint = accu(a % rrt) - sdp.SparseB()[i];
+    objective += -lambda[i] * constraint + (sigma / 2.) * constraint *
+        constraint;
+    s -= (lambda[i] - sigma * constraint) * a;
+  }
+  gradient = 2 * s * coordinates;
+}
+
+/**
+ * Make sure that the entry-wise constraints are found, and that the augmented
+ * Lagrangian and its gradient are right with and without other constraints.
+ */
+BOOST_AUTO_TEST_CASE(EntryConstraintsTest)
+{
+  const size_t n = 30;
+  const arma::mat coordinates = arma::randu<arma::mat>(n, 4);
+
+  for (size_t withGeneral = 0; withGeneral < 2; ++withGeneral)
+  {
+    const size_t numConstraints = 40 + withGeneral;
+    SDP<arma::sp_mat> sdp(n, numConstraints, 0);
+    sdp.C().eye(n, n);
+    sdp.SparseB().randu();
+    for (size_t i = 0; i < 40; ++i)
+    {
+      const size_t j = i % n;
+      // Some of the constraints are on diagonal entries.
+      const size_t k = (i % 10 == 0) ? j : (7 * i + 3) % n;
+      sdp.SparseA()[i].zeros(n, n);
+      sdp.SparseA()[i](j, k) = 1.0 + i;
+      sdp.SparseA()[i](k, j) = 1.0 + i;
+    }
+    if (withGeneral)
+      sdp.SparseA()[40].eye(n, n);
+
+    LRSDPFunction<SDP<arma::sp_mat>> function(sdp, coordinates);
+    BOOST_REQUIRE_EQUAL(function.GeneralConstraints().size(), withGeneral);
+    BOOST_REQUIRE_EQUAL(function.UsesRRT(), (withGeneral == 1));
+    for (size_t i = 0; i < 40; ++i)
+      BOOST_REQUIRE(function.IsEntryConstraint()[i]);
+
+    const arma::vec lambda = arma::randu<arma::vec>(numConstraints);
+    const double sigma = 3.0;
+    AugLagrangianFunction<LRSDPFunction<SDP<arma::sp_mat>>> augLag(function,
+        lambda, sigma);
+
+    double naiveObjective;
+    arma::mat naiveGradient;
+    NaiveAugLagrangian(sdp, coordinates, lambda, sigma, naiveObjective,
+        naiveGradient);
+
+    // Evaluate() has to be called before Gradient().
+    const double objective = augLag.Evaluate(coordinates);
+    arma::mat gradient;
+    augLag.Gradient(coordinates, gradient);
+
+    BOOST_REQUIRE_CLOSE(objective, naiveObjective, 1e-7);
+    CheckMatrices(gradient, naiveGradient, 1e-7);
+
+    for (size_t i = 0; i < numConstraints; ++i)
+    {
+      const double constraint = accu(arma::mat(sdp.SparseA()[i]) %
+          (coordinates * trans(coordinates))) - sdp.SparseB()[i];
+      BOOST_REQUIRE_CLOSE(function.EvaluateConstraint(i, coordinates),
+          constraint, 1e-7);
+    }
+  }
+}
+
 /**
  * johnson8-4-4.co test case for Lovasz-Theta LRSDP.
  * See Monteiro and Burer 2004.
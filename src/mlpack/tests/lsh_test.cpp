@@ -912,4 +912,187 @@ BOOST_AUTO_TEST_CASE(MoveOperatorTest)
   CheckMatrices(distances, distances2);
 }
 
+/**
+ * Make sure that a batch of queries gets the same results and the same number
+ * of distance evaluations as the same queries searched one at a time, with and
+ * without multiprobe.
+ */
+BOOST_AUTO_TEST_CASE(BatchQueryTest)
+{
+  arma::mat rdata;
+  arma::mat qdata;
+  data::Load("iris_train.csv", rdata, true);
+  data::Load("iris_test.csv", qdata, true);
+
+  LSHSearch<> lshTest(rdata, 3, 16);
+
+  for (size_t T = 0; T < 5; T += 2)
+  {
+    arma::Mat<size_t> neighbors, singleNeighbors;
+    arma::mat distances, singleDistances;
+
+    lshTest.DistanceEvaluations() = 0;
+    lshTest.Search(qdata, 4, neighbors, distances, 0, T);
+    const size_t evaluations = lshTest.DistanceEvaluations();
+
+    lshTest.DistanceEvaluations() = 0;
+    for (size_t i = 0; i < qdata.n_cols; ++i)
+    {
+      lshTest.Search(arma::mat(qdata.col(i)), 4, singleNeighbors,
+          singleDistances, 0, T);
+
+      for (size_t j = 0; j < 4; ++j)
+      {
+        BOOST_REQUIRE_EQUAL(neighbors(j, i), singleNeighbors(j, 0));
+        BOOST_REQUIRE_EQUAL(distances(j, i), singleDistances(j, 0));
+      }
+    }
+
+    BOOST_REQUIRE_EQUAL(evaluations, lshTest.DistanceEvaluations());
+    BOOST_REQUIRE_GT(evaluations, 0);
+  }
+
+  // In monochromatic search, each point is not compared with itself.
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  lshTest.DistanceEvaluations() = 0;
+  lshTest.Search(4, neighbors, distances);
+  BOOST_REQUIRE_GT(lshTest.DistanceEvaluations(), 0);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    for (size_t j = 0; j < 4; ++j)
+      BOOST_REQUIRE_NE(neighbors(j, i), i);
+}
+
+/**
+ * Make sure that the buckets of the second hash table are stored one after the
+ * other, and that without a maximum bucket size each point is in one bucket
+ * of each table.
+ */
+BOOST_AUTO_TEST_CASE(CompactBucketsTest)
+{
+  arma::mat rdata;
+  data::Load("iris_train.csv", rdata, true);
+
+  const size_t numTables = 8;
+  LSHSearch<> lshTest(rdata, 3, numTables, 0.0, 99901, 0);
+
+  const arma::Col<arma::u32>& contents = lshTest.BucketContents();
+  const arma::Col<size_t>& offsets = lshTest.BucketOffsets();
+  BOOST_REQUIRE_GT(offsets.n_elem, 1);
+  BOOST_REQUIRE_EQUAL(offsets[0], 0);
+  BOOST_REQUIRE_EQUAL(offsets[offsets.n_elem - 1], contents.n_elem);
+  BOOST_REQUIRE_EQUAL(contents.n_elem, numTables * rdata.n_cols);
+
+  arma::Col<size_t> counts(rdata.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < contents.n_elem; ++i)
+  {
+    BOOST_REQUIRE_LT(contents[i], rdata.n_cols);
+    ++counts[contents[i]];
+  }
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], numTables);
+
+  const std::vector<arma::Col<size_t>> table = lshTest.SecondHashTable();
+  BOOST_REQUIRE_EQUAL(table.size(), offsets.n_elem - 1);
+  for (size_t i = 0; i < table.size(); ++i)
+  {
+    BOOST_REQUIRE_GT(table[i].n_elem, 0);
+    BOOST_REQUIRE_EQUAL(table[i].n_elem, offsets[i + 1] - offsets[i]);
+    for (size_t j = 0; j < table[i].n_elem; ++j)
+      BOOST_REQUIRE_EQUAL(table[i][j], contents[offsets[i] + j]);
+  }
+
+  // With a maximum bucket size, no bucket is larger.
+  LSHSearch<> smallBuckets(rdata, 3, numTables, 0.0, 99901, 5);
+  const arma::Col<size_t>& smallOffsets = smallBuckets.BucketOffsets();
+  for (size_t i = 0; i + 1 < smallOffsets.n_elem; ++i)
+    BOOST_REQUIRE_LE(smallOffsets[i + 1] - smallOffsets[i], 5);
+}
+
+/**
+ * Make sure that a model trained on part of a dataset, with the rest of the
+ * dataset inserted afterwards, finds the same neighbors as a model trained on
+ * the whole dataset with the same hash functions.
+ */
+BOOST_AUTO_TEST_CASE(InsertTest)
+{
+  arma::mat rdata;
+  arma::mat qdata;
+  data::Load("iris_train.csv", rdata, true);
+  data::Load("iris_test.csv", qdata, true);
+
+  const arma::cube projections(rdata.n_rows, 3, 8, arma::fill::randn);
+  const size_t half = rdata.n_cols / 2;
+
+  // The offsets and second hash weights are random, so both models must draw
+  // the same ones.  Unlimited buckets make the tables the same.
+  math::RandomSeed(42);
+  LSHSearch<> full(rdata, projections, 1.0, 99901, 0);
+  math::RandomSeed(42);
+  LSHSearch<> inserted(rdata.cols(0, half - 1), projections, 1.0, 99901, 0);
+  inserted.Insert(rdata.cols(half, rdata.n_cols - 1));
+
+  BOOST_REQUIRE_EQUAL(inserted.ReferenceSet().n_cols, rdata.n_cols);
+  BOOST_REQUIRE_EQUAL(inserted.BucketContents().n_elem,
+      full.BucketContents().n_elem);
+
+  arma::Mat<size_t> neighbors, insertedNeighbors;
+  arma::mat distances, insertedDistances;
+  full.Search(qdata, 3, neighbors, distances);
+  inserted.Search(qdata, 3, insertedNeighbors, insertedDistances);
+
+  CheckMatrices(neighbors, insertedNeighbors);
+  CheckMatrices(distances, insertedDistances);
+
+  // Points of the wrong dimensionality can't be inserted.
+  BOOST_REQUIRE_THROW(inserted.Insert(arma::mat(rdata.n_rows + 1, 3)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that removed points are never returned, and that they are dropped
+ * from the buckets when points are inserted.
+ */
+BOOST_AUTO_TEST_CASE(RemoveTest)
+{
+  arma::mat rdata;
+  arma::mat qdata;
+  data::Load("iris_train.csv", rdata, true);
+  data::Load("iris_test.csv", qdata, true);
+
+  LSHSearch<> lshTest(rdata, 3, 8, 0.0, 99901, 0);
+  for (size_t i = 0; i < rdata.n_cols; i += 3)
+    lshTest.Remove(i);
+  lshTest.Remove(0);
+
+  BOOST_REQUIRE_EQUAL(lshTest.NumRemoved(), (rdata.n_cols + 2) / 3);
+  BOOST_REQUIRE(lshTest.IsRemoved(3));
+  BOOST_REQUIRE(!lshTest.IsRemoved(4));
+  BOOST_REQUIRE_THROW(lshTest.Remove(rdata.n_cols), std::invalid_argument);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  lshTest.Search(qdata, 3, neighbors, distances);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+    BOOST_REQUIRE(neighbors[i] == rdata.n_cols || neighbors[i] % 3 != 0);
+
+  lshTest.Search(3, neighbors, distances);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+    BOOST_REQUIRE(neighbors[i] == rdata.n_cols || neighbors[i] % 3 != 0);
+
+  // Inserting points drops the removed points from the buckets, but they stay
+  // in the reference set.
+  const size_t oldSize = rdata.n_cols;
+  lshTest.Insert(qdata);
+  BOOST_REQUIRE_EQUAL(lshTest.ReferenceSet().n_cols, oldSize + qdata.n_cols);
+  BOOST_REQUIRE_EQUAL(lshTest.BucketContents().n_elem,
+      8 * (oldSize - lshTest.NumRemoved() + qdata.n_cols));
+  for (size_t i = 0; i < lshTest.BucketContents().n_elem; ++i)
+    BOOST_REQUIRE(!lshTest.IsRemoved(lshTest.BucketContents()[i]));
+
+  // Training again forgets the removed points.
+  lshTest.Train(rdata, 3, 8);
+  BOOST_REQUIRE_EQUAL(lshTest.NumRemoved(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
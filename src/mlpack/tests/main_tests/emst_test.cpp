@@ -129,4 +129,33 @@ BOOST_AUTO_TEST_CASE(EMSTFirstTwoOutputRowsIntegerTest)
   }
 }
 
+/**
+ * Check the dimensions of the dendrogram and the assignments.
+ */
+BOOST_AUTO_TEST_CASE(EMSTSingleLinkageOutputTest)
+{
+  arma::mat x;
+  if (!data::Load("test_data_3_1000.csv", x))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("thresholds", std::vector<double>({ 0.1, 0.5, 100.0 }));
+
+  mlpackMain();
+
+  const arma::mat& dendrogram = CLI::GetParam<arma::mat>("dendrogram");
+  BOOST_REQUIRE_EQUAL(dendrogram.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(dendrogram.n_cols, 999);
+  BOOST_REQUIRE_CLOSE(dendrogram(3, 998), 1000.0, 1e-5);
+
+  const arma::Mat<size_t>& assignments =
+      CLI::GetParam<arma::Mat<size_t>>("assignments");
+  BOOST_REQUIRE_EQUAL(assignments.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(assignments.n_cols, 1000);
+
+  // Every point is in the same cluster at the largest threshold.
+  for (size_t i = 0; i < assignments.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments(2, i), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -776,4 +776,28 @@ BOOST_AUTO_TEST_CASE(HoeffdingBinningTest)
       (CLI::GetParam<HoeffdingTreeModel*>("output_model"))->NumNodes(), 1);
 }
 
+/**
+ * Ensure that the maximum memory can't be negative.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingNegativeMaxMemoryTest)
+{
+  arma::mat inputData;
+  DatasetInfo info;
+  if (!data::Load("vc2.csv", inputData, info))
+    BOOST_FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  // Input training data.
+  SetInputParam("training", std::move(std::make_tuple(info, inputData)));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("max_memory", -1);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
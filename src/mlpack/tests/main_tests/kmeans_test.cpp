@@ -394,4 +394,64 @@ BOOST_AUTO_TEST_CASE(AlgorithmsSimilarTest)
   CheckMatrices(naiveCentroid, dualCoverTreeCentroid);
 }
 
+/**
+ * Check that clustering in single precision gives the same results as double
+ * precision, for both a naive and a tree-based Lloyd step.
+ */
+BOOST_AUTO_TEST_CASE(KmFloatPrecisionTest)
+{
+  // Three well-separated clusters.
+  arma::mat inputData(4, 600, arma::fill::randn);
+  inputData.cols(200, 399) += 20.0;
+  inputData.cols(400, 599) -= 20.0;
+
+  arma::mat initCentroid(4, 3);
+  initCentroid.col(0) = inputData.col(0);
+  initCentroid.col(1) = inputData.col(200);
+  initCentroid.col(2) = inputData.col(400);
+
+  const std::string algorithms[] = { "naive", "pelleg-moore", "dualtree" };
+  for (const std::string& algo : algorithms)
+  {
+    arma::mat outputs[2];
+    arma::mat centroids[2];
+    const std::string precisions[] = { "double", "float" };
+    for (size_t i = 0; i < 2; ++i)
+    {
+      ResetKmSettings();
+
+      SetInputParam("input", inputData);
+      SetInputParam("clusters", 3);
+      SetInputParam("algorithm", std::string(algo));
+      SetInputParam("precision", std::string(precisions[i]));
+      SetInputParam("initial_centroids", initCentroid);
+
+      mlpackMain();
+
+      outputs[i] = std::move(CLI::GetParam<arma::mat>("output"));
+      centroids[i] = std::move(CLI::GetParam<arma::mat>("centroid"));
+    }
+
+    // The output holds the (double-precision) input and the labels.
+    BOOST_REQUIRE_EQUAL(outputs[1].n_rows, inputData.n_rows + 1);
+    CheckMatrices(outputs[0].rows(0, 3), inputData);
+    CheckMatrices(outputs[0], outputs[1]);
+    CheckMatrices(centroids[0], centroids[1], 1e-3);
+  }
+}
+
+/**
+ * Make sure an unknown precision is rejected.
+ */
+BOOST_AUTO_TEST_CASE(KmInvalidPrecisionTest)
+{
+  SetInputParam("input", arma::mat(arma::randu<arma::mat>(3, 50)));
+  SetInputParam("clusters", 2);
+  SetInputParam("precision", std::string("half"));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
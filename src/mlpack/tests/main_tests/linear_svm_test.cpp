@@ -0,0 +1,157 @@
+/**
+ * @file linear_svm_test.cpp
+ *
+ * Test mlpackMain() of linear_svm_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#define BINDING_TYPE BINDING_TYPE_TEST
+
+#include <mlpack/core.hpp>
+static const std::string testName = "Linear Support Vector Machine";
+
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/methods/linear_svm/linear_svm_main.cpp>
+#include "test_helper.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct LinearSVMTestFixture
+{
+ public:
+  LinearSVMTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~LinearSVMTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(LinearSVMMainTest,
+                         LinearSVMTestFixture);
+
+/**
+ * Ensure that the predictions and scores have the right dimensions, and that
+ * the original labels are given back.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMOutputDimensionTest)
+{
+  arma::mat inputData;
+  if (!data::Load("trainSet.csv", inputData))
+    BOOST_FAIL("Cannot load train dataset trainSet.csv!");
+
+  // Shift the labels, so that they have to be normalized.
+  arma::Row<size_t> labels(inputData.n_cols);
+  for (size_t i = 0; i < inputData.n_cols; ++i)
+    labels[i] = inputData(inputData.n_rows - 1, i) + 3;
+  inputData.shed_row(inputData.n_rows - 1);
+
+  arma::mat testData;
+  if (!data::Load("testSet.csv", testData))
+    BOOST_FAIL("Cannot load test dataset testSet.csv!");
+  testData.shed_row(testData.n_rows - 1);
+  const size_t testSize = testData.n_cols;
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("test", std::move(testData));
+
+  mlpackMain();
+
+  const arma::Row<size_t>& predictions =
+      CLI::GetParam<arma::Row<size_t>>("predictions");
+  BOOST_REQUIRE_EQUAL(predictions.n_rows, 1);
+  BOOST_REQUIRE_EQUAL(predictions.n_cols, testSize);
+  BOOST_REQUIRE_GE(predictions.min(), 3);
+  BOOST_REQUIRE_LE(predictions.max(), 4);
+
+  const arma::mat& scores = CLI::GetParam<arma::mat>("scores");
+  BOOST_REQUIRE_EQUAL(scores.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(scores.n_cols, testSize);
+}
+
+/**
+ * Ensure that a saved model gives the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMModelReuseTest)
+{
+  arma::mat inputData;
+  if (!data::Load("trainSet.csv", inputData))
+    BOOST_FAIL("Cannot load train dataset trainSet.csv!");
+
+  arma::mat testData;
+  if (!data::Load("testSet.csv", testData))
+    BOOST_FAIL("Cannot load test dataset testSet.csv!");
+  testData.shed_row(testData.n_rows - 1);
+
+  // The labels are the last row of the training data.
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("test", testData);
+
+  mlpackMain();
+
+  arma::Row<size_t> output;
+  output = std::move(CLI::GetParam<arma::Row<size_t>>("predictions"));
+
+  // Reset passed parameters.
+  CLI::GetSingleton().Parameters()["training"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["test"].wasPassed = false;
+
+  SetInputParam("test", std::move(testData));
+  SetInputParam("input_model",
+                CLI::GetParam<LinearSVMModel*>("output_model"));
+
+  mlpackMain();
+
+  CheckMatrices(output, CLI::GetParam<arma::Row<size_t>>("predictions"));
+}
+
+/**
+ * Ensure that C must be positive.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMNonPositiveCTest)
+{
+  arma::mat inputData;
+  if (!data::Load("trainSet.csv", inputData))
+    BOOST_FAIL("Cannot load train dataset trainSet.csv!");
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("c", 0.0);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Ensure that the test data must have the dimensionality of the model.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMWrongDimensionTest)
+{
+  arma::mat inputData;
+  if (!data::Load("trainSet.csv", inputData))
+    BOOST_FAIL("Cannot load train dataset trainSet.csv!");
+
+  arma::mat testData = arma::randu<arma::mat>(inputData.n_rows + 2, 10);
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("test", std::move(testData));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+BOOST_AUTO_TEST_SUITE_END();
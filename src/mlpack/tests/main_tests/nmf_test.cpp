@@ -133,6 +133,33 @@ BOOST_AUTO_TEST_CASE(NMFAlsShapeTest)
   BOOST_REQUIRE_EQUAL(h.n_cols, 10);
 }
 
+/**
+ * Ensure the resulting matrices W, H have expected shape.
+ * NNLS update rule.
+ */
+BOOST_AUTO_TEST_CASE(NMFNnlsShapeTest)
+{
+  mat v = randu<mat>(10, 10);
+  int r = 5;
+
+  SetInputParam("update_rules", std::string("nnls"));
+  SetInputParam("input", std::move(v));
+  SetInputParam("rank", r);
+
+  // Perform NMF.
+  mlpackMain();
+
+  // Get resulting matrices.
+  const mat& w = CLI::GetParam<mat>("w");
+  const mat& h = CLI::GetParam<mat>("h");
+
+  // Check the shapes of W and H.
+  BOOST_REQUIRE_EQUAL(w.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(w.n_cols, 5);
+  BOOST_REQUIRE_EQUAL(h.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(h.n_cols, 10);
+}
+
 /**
  * Ensure the rank is positive.
  */
@@ -232,6 +232,24 @@ BOOST_AUTO_TEST_CASE(PerceptronMaxItrTest)
   Log::Fatal.ignoreInput = false;
 }
 
+/**
+ * Ensure that the batch size must be positive.
+ */
+BOOST_AUTO_TEST_CASE(PerceptronBatchSizeTest)
+{
+  arma::mat inputData;
+  if (!data::Load("trainSet.csv", inputData))
+    BOOST_FAIL("Cannot load train dataset trainSet.csv!");
+
+  // Input training data.
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("batch_size", (int) 0);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 /**
   * Ensuring that re-training of an existing model
   * with different of classes is checked.
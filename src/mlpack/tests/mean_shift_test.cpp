@@ -55,18 +55,12 @@ arma::mat meanShiftData("  0.0   0.0;" // Class 1.
 
 
 /**
- * 30-point 3-class test case for Mean Shift.
+ * Make sure that the given assignments of meanShiftData recover its three
+ * classes.  There is no restriction on how the clusters are ordered, so we have
+ * to be careful about that.
  */
-BOOST_AUTO_TEST_CASE(MeanShiftSimpleTest)
+void CheckSimpleAssignments(const arma::Row<size_t>& assignments)
 {
-  MeanShift<> meanShift;
-
-  arma::Row<size_t> assignments;
-  arma::mat centroids;
-  meanShift.Cluster((arma::mat) trans(meanShiftData), assignments, centroids);
-
-  // Now make sure we got it all right.  There is no restriction on how the
-  // clusters are ordered, so we have to be careful about that.
   size_t firstClass = assignments(0);
 
   for (size_t i = 1; i < 13; i++)
@@ -90,6 +84,55 @@ BOOST_AUTO_TEST_CASE(MeanShiftSimpleTest)
     BOOST_REQUIRE_EQUAL(assignments(i), thirdClass);
 }
 
+/**
+ * 30-point 3-class test case for Mean Shift.
+ */
+BOOST_AUTO_TEST_CASE(MeanShiftSimpleTest)
+{
+  MeanShift<> meanShift;
+
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  meanShift.Cluster((arma::mat) trans(meanShiftData), assignments, centroids);
+
+  // Now make sure we got it all right.
+  CheckSimpleAssignments(assignments);
+}
+
+/**
+ * Run mean shift with the Gaussian kernel from every point of the 30-point
+ * 3-class dataset, and with the seeds of the hashed grid; the modes found from
+ * the other seeds stop most of them early, but the three classes must still be
+ * found, with one centroid each.
+ */
+BOOST_AUTO_TEST_CASE(MeanShiftKernelSeedsTest)
+{
+  const arma::mat data = trans(meanShiftData);
+
+  for (size_t useSeeds = 0; useSeeds < 2; ++useSeeds)
+  {
+    MeanShift<true> meanShift(1.0);
+
+    arma::Row<size_t> assignments;
+    arma::mat centroids;
+    meanShift.Cluster(data, assignments, centroids, true, (useSeeds == 1));
+
+    BOOST_REQUIRE_EQUAL(centroids.n_cols, 3);
+    CheckSimpleAssignments(assignments);
+
+    // Each centroid must be close to the mean of its class.
+    const arma::vec means[3] = { arma::mean(data.cols(0, 12), 1),
+                                 arma::mean(data.cols(13, 19), 1),
+                                 arma::mean(data.cols(20, 29), 1) };
+    const size_t firsts[3] = { 0, 13, 20 };
+    for (size_t c = 0; c < 3; ++c)
+    {
+      BOOST_REQUIRE_SMALL(metric::EuclideanDistance::Evaluate(means[c],
+          centroids.col(assignments[firsts[c]])), 0.3);
+    }
+  }
+}
+
 // Generate samples from four Gaussians, and make sure mean shift nearly
 // recovers those four centers.
 BOOST_AUTO_TEST_CASE(GaussianClustering)
@@ -10,6 +10,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -87,4 +88,61 @@ BOOST_AUTO_TEST_CASE(LINFMetricTest)
                       lMetric.Evaluate(a2, b2), 1e-5);
 }
 
+/**
+ * Make sure the vectorized kernels give the same results as the Armadillo
+ * expressions, for lengths that do and do not fill whole registers, and for
+ * columns of a matrix.
+ */
+template<typename eT>
+void CheckKernels(const eT tolerance)
+{
+  for (size_t n = 1; n < 70; n += 3)
+  {
+    arma::Mat<eT> references(n, 10, arma::fill::randn);
+    arma::Col<eT> query(n, arma::fill::randn);
+
+    for (size_t j = 0; j < references.n_cols; ++j)
+    {
+      const arma::Col<eT> reference = references.col(j);
+
+      BOOST_REQUIRE_CLOSE(SquaredEuclideanDistance::Evaluate(query,
+          references.col(j)),
+          arma::accu(arma::square(query - reference)), tolerance);
+      BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(references.col(j),
+          query), std::sqrt(arma::accu(arma::square(query - reference))),
+          tolerance);
+      BOOST_REQUIRE_CLOSE(ManhattanDistance::Evaluate(query, reference),
+          arma::accu(arma::abs(query - reference)), tolerance);
+      // The inner product may be close to zero, so check the absolute error.
+      BOOST_REQUIRE_SMALL((eT) mlpack::kernel::LinearKernel::Evaluate(query,
+          references.col(j)) - arma::dot(query, reference),
+          (eT) (tolerance * 1e-2 * n));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SIMDKernelsTest)
+{
+  CheckKernels<double>(1e-8);
+  CheckKernels<float>(1e-2);
+}
+
+#ifndef ARMA_NO_DEBUG
+/**
+ * Vectors of different sizes must still be rejected when the vectorized
+ * kernels are used.
+ */
+BOOST_AUTO_TEST_CASE(SIMDKernelsSizeMismatchTest)
+{
+  arma::vec a(10, arma::fill::randu);
+  arma::vec b(7, arma::fill::randu);
+
+  BOOST_REQUIRE_THROW(SquaredEuclideanDistance::Evaluate(a, b),
+      std::logic_error);
+  BOOST_REQUIRE_THROW(ManhattanDistance::Evaluate(a, b), std::logic_error);
+  BOOST_REQUIRE_THROW(mlpack::kernel::LinearKernel::Evaluate(a, b),
+      std::logic_error);
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -314,4 +314,106 @@ BOOST_AUTO_TEST_CASE(SeparateTrainIndividualIncrementalTest)
   }
 }
 
+/**
+ * Make sure that the probabilities given by batch classification are the same
+ * as the ones given for each point separately, and that they don't underflow
+ * when the points are very unlikely under every class.
+ */
+BOOST_AUTO_TEST_CASE(BatchClassifyProbabilitiesTest)
+{
+  // Two classes of points that are far from the origin.
+  arma::mat trainData = arma::randn<arma::mat>(4, 500);
+  arma::Row<size_t> labels(500);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    labels[i] = i % 2;
+    trainData.col(i) += (i % 2 == 0) ? 1000.0 : 1002.0;
+  }
+
+  NaiveBayesClassifier<> nbc(trainData, labels, 2);
+
+  // The last points are so far from both classes that their likelihoods
+  // underflow.
+  arma::mat testData = arma::randn<arma::mat>(4, 50) + 1001.0;
+  testData.col(48).fill(1100.0);
+  testData.col(49).fill(900.0);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  nbc.Classify(testData, predictions, probabilities);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, 50);
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, 50);
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    nbc.Classify(testData.col(i), prediction, pointProbabilities);
+
+    BOOST_REQUIRE_EQUAL(prediction, predictions[i]);
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+    for (size_t c = 0; c < 2; ++c)
+    {
+      BOOST_REQUIRE(std::isfinite(probabilities(c, i)));
+      if (probabilities(c, i) < 1e-5)
+        BOOST_REQUIRE_SMALL(pointProbabilities[c], 1e-5);
+      else
+        BOOST_REQUIRE_CLOSE(probabilities(c, i), pointProbabilities[c], 1e-5);
+    }
+  }
+
+  // Points far above the data are closer to the class with the larger mean.
+  BOOST_REQUIRE_EQUAL(predictions[48], 1);
+  BOOST_REQUIRE_EQUAL(predictions[49], 0);
+}
+
+/**
+ * Make sure that training on and classifying sparse data gives the same
+ * results as for the same dense data.
+ */
+BOOST_AUTO_TEST_CASE(SparseTrainTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(20, 300, 0.2);
+  arma::mat data(sparseData);
+
+  arma::Row<size_t> labels(300);
+  for (size_t i = 0; i < 300; ++i)
+    labels[i] = i % 3;
+
+  NaiveBayesClassifier<> nbc(data, labels, 3);
+  NaiveBayesClassifier<> sparseNbc(sparseData, labels, 3);
+
+  for (size_t i = 0; i < nbc.Means().n_elem; ++i)
+  {
+    if (std::abs(nbc.Means()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(sparseNbc.Means()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Means()[i], sparseNbc.Means()[i], 1e-5);
+  }
+
+  for (size_t i = 0; i < nbc.Variances().n_elem; ++i)
+  {
+    if (std::abs(nbc.Variances()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(sparseNbc.Variances()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Variances()[i], sparseNbc.Variances()[i], 1e-5);
+  }
+
+  arma::Row<size_t> predictions, sparsePredictions;
+  arma::mat probabilities, sparseProbabilities;
+  nbc.Classify(data, predictions, probabilities);
+  sparseNbc.Classify(sparseData, sparsePredictions, sparseProbabilities);
+
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+  {
+    if (probabilities[i] < 1e-5)
+      BOOST_REQUIRE_SMALL(sparseProbabilities[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(probabilities[i], sparseProbabilities[i], 1e-3);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -249,6 +249,114 @@ BOOST_AUTO_TEST_CASE(SoftmaxSeparableGradient)
   BOOST_REQUIRE_CLOSE(gradient(1, 1), -2.0 * -0.1435886, 0.01);
 }
 
+/**
+ * With a truncation so small that every point is in every neighborhood, the
+ * truncated softmax should give the same objective and gradients as the exact
+ * softmax.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxTinyTruncationTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 100);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(100,
+      arma::distr_param(0, 2));
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  SoftmaxErrorFunction<SquaredEuclideanDistance> truncatedSef(data, labels);
+  truncatedSef.Truncation() = 1e-50;
+
+  arma::mat coordinates = arma::eye<arma::mat>(3, 3) +
+      0.5 * arma::randu<arma::mat>(3, 3);
+
+  BOOST_REQUIRE_CLOSE(truncatedSef.Evaluate(coordinates),
+      sef.Evaluate(coordinates), 1e-8);
+
+  arma::mat gradient, truncatedGradient;
+  sef.Gradient(coordinates, gradient);
+  truncatedSef.Gradient(coordinates, truncatedGradient);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(truncatedGradient[i], gradient[i], 1e-6);
+
+  for (size_t begin = 0; begin < 100; begin += 20)
+  {
+    BOOST_REQUIRE_CLOSE(truncatedSef.Evaluate(coordinates, begin, 20),
+        sef.Evaluate(coordinates, begin, 20), 1e-8);
+
+    sef.Gradient(coordinates, begin, gradient, 20);
+    truncatedSef.Gradient(coordinates, begin, truncatedGradient, 20);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(truncatedGradient[i], gradient[i], 1e-6);
+  }
+}
+
+/**
+ * The truncated softmax should only use the neighbors whose kernel value is at
+ * least the truncation.  Compare with a brute-force computation.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxTruncationTest)
+{
+  arma::mat data = arma::randu<arma::mat>(2, 300);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(300,
+      arma::distr_param(0, 1));
+  const double truncation = 0.1;
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  sef.Truncation() = truncation;
+
+  arma::mat coordinates = 3.0 * arma::eye<arma::mat>(2, 2);
+  arma::mat stretched = coordinates * data;
+
+  double objective = 0.0;
+  arma::vec p(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    double numerator = 0.0, denominator = 0.0;
+    for (size_t k = 0; k < data.n_cols; ++k)
+    {
+      const double eval = std::exp(-SquaredEuclideanDistance::Evaluate(
+          stretched.col(i), stretched.col(k)));
+      if (k == i || eval < truncation)
+        continue;
+
+      denominator += eval;
+      if (labels[i] == labels[k])
+        numerator += eval;
+    }
+
+    p[i] = (denominator == 0.0) ? 0.0 : numerator / denominator;
+    objective -= p[i];
+  }
+
+  BOOST_REQUIRE_CLOSE(sef.Evaluate(coordinates), objective, 1e-8);
+
+  double separableObjective = 0.0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+    separableObjective += sef.Evaluate(coordinates, i, 1);
+  BOOST_REQUIRE_CLOSE(separableObjective, objective, 1e-8);
+}
+
+/**
+ * Shuffling should keep the truncated neighborhoods consistent with the points.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxTruncationShuffleTest)
+{
+  arma::mat data = arma::randu<arma::mat>(2, 200);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(200,
+      arma::distr_param(0, 1));
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  sef.Truncation() = 0.2;
+  sef.RefreshInterval() = 1000;
+
+  arma::mat coordinates = 2.0 * arma::eye<arma::mat>(2, 2);
+  const double objective = sef.Evaluate(coordinates);
+
+  // The sum of the separable objectives doesn't depend on the order of the
+  // points, and the neighborhoods are not searched again.
+  sef.Shuffle();
+  BOOST_REQUIRE_CLOSE(sef.Evaluate(coordinates, 0, 200), objective, 1e-8);
+  BOOST_REQUIRE_CLOSE(sef.Evaluate(coordinates), objective, 1e-8);
+}
+
 //
 // Tests for the NCA algorithm.
 //
@@ -322,4 +430,35 @@ BOOST_AUTO_TEST_CASE(NCALBFGSSimpleDataset)
   BOOST_REQUIRE_LT(arma::norm(finalGradient, 2), 1e-6);
 }
 
+/**
+ * NCA with a truncated softmax should still separate the points of our simple
+ * dataset.
+ */
+BOOST_AUTO_TEST_CASE(NCALBFGSTruncatedSimpleDataset)
+{
+  // Useful but simple dataset with six points and two classes.
+  arma::mat data           = "-0.1 -0.1 -0.1  0.1  0.1  0.1;"
+                             " 1.0  0.0 -1.0  1.0  0.0 -1.0 ";
+  arma::Row<size_t> labels = " 0    0    0    1    1    1   ";
+
+  NCA<SquaredEuclideanDistance, L_BFGS> nca(data, labels);
+  nca.Optimizer().NumBasis() = 5;
+  nca.ErrorFunction().Truncation() = 1e-10;
+  nca.ErrorFunction().RefreshInterval() = 2;
+
+  arma::mat outputMatrix;
+  nca.LearnDistance(outputMatrix);
+
+  // Ensure that the exact objective function is better now.
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+
+  double initObj = sef.Evaluate(arma::eye<arma::mat>(2, 2));
+  double finalObj = sef.Evaluate(outputMatrix);
+
+  // Cross-class kernel values below the truncation are ignored during the
+  // optimization, so the final objective is close, but not equal, to optimal.
+  BOOST_REQUIRE_LT(finalObj, initObj);
+  BOOST_REQUIRE_LT(finalObj, -5.5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -15,7 +15,9 @@
 #include <mlpack/methods/amf/init_rules/given_init.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_mult_div.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
+#include <mlpack/methods/amf/update_rules/nmf_nnls.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_mult_dist.hpp>
+#include <mlpack/methods/amf/update_rules/svd_batch_learning.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -131,6 +133,59 @@ BOOST_AUTO_TEST_CASE(NMFALSTest)
       0.08);
 }
 
+/**
+ * Check that the product of the calculated factorization is close to the
+ * input matrix, with the alternating nonnegative least squares update rule.
+ */
+BOOST_AUTO_TEST_CASE(NMFNNLSTest)
+{
+  mat w = randu<mat>(20, 12);
+  mat h = randu<mat>(12, 20);
+  mat v = w * h;
+  size_t r = 12;
+
+  SimpleResidueTermination srt(1e-12, 1000);
+  AMF<SimpleResidueTermination, RandomAcolInitialization<>, NMFNNLSUpdate>
+        nmf(srt);
+  nmf.Apply(v, r, w, h);
+
+  BOOST_REQUIRE(arma::all(arma::vectorise(w) >= 0)
+      && arma::all(arma::vectorise(h) >= 0));
+
+  // Unlike NMFALSUpdate, each update is optimal, so this should converge
+  // better.
+  const mat wh = w * h;
+  BOOST_REQUIRE_SMALL(arma::norm(v - wh, "fro") / arma::norm(v, "fro"),
+      0.05);
+}
+
+/**
+ * Make sure the solutions of NMFNNLSUpdate::SolveNNLS() satisfy the optimality
+ * conditions of the nonnegative least squares problem: x >= 0, G x - b >= 0,
+ * and x^T (G x - b) = 0.
+ */
+BOOST_AUTO_TEST_CASE(NNLSOptimalityTest)
+{
+  const mat c = randn<mat>(30, 8);
+  const mat gram = c.t() * c;
+  const mat rhs = c.t() * randn<mat>(30, 2000);
+
+  mat x;
+  NMFNNLSUpdate::SolveNNLS(gram, rhs, x);
+  BOOST_REQUIRE_EQUAL(x.n_rows, 8);
+  BOOST_REQUIRE_EQUAL(x.n_cols, 2000);
+
+  const mat y = gram * x - rhs;
+  BOOST_REQUIRE_GE(x.min(), 0.0);
+  BOOST_REQUIRE_GE(y.min(), -1e-6);
+  BOOST_REQUIRE_SMALL(arma::abs(x % y).max(), 1e-6);
+
+  // Starting from the solution should give the same solution.
+  mat x2(x);
+  NMFNNLSUpdate::SolveNNLS(gram, rhs, x2);
+  BOOST_REQUIRE_SMALL(arma::norm(x - x2, "fro") / arma::norm(x, "fro"), 1e-8);
+}
+
 /**
  * Check the if the product of the calculated factorization is close to the
  * input matrix, with a sparse input matrix. Random Acol initialization,
@@ -233,6 +288,51 @@ BOOST_AUTO_TEST_CASE(SparseNMFALSTest)
       1e-5);
 }
 
+/**
+ * The sparse versions of the multiplicative divergence and batch SVD update
+ * rules only evaluate W * H at the nonzero entries of V.  Make sure that they
+ * take the same steps as the dense versions.
+ */
+template<typename UpdateRuleType>
+void CheckSparseUpdateRule(UpdateRuleType sparseRule, UpdateRuleType denseRule)
+{
+  sp_mat v;
+  v.sprandu(20, 15, 0.3);
+  // Ensure there is at least one nonzero element in every row and column.
+  for (size_t i = 0; i < 15; ++i)
+  {
+    v(i, i) += 0.1;
+    v(i + 5, i) += 0.1;
+  }
+  mat dv(v);
+
+  mat w(20, 4, fill::randu), h(4, 15, fill::randu);
+  mat dw(w), dh(h);
+
+  sparseRule.Initialize(v, 4);
+  denseRule.Initialize(dv, 4);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    sparseRule.WUpdate(v, w, h);
+    sparseRule.HUpdate(v, w, h);
+    denseRule.WUpdate(dv, dw, dh);
+    denseRule.HUpdate(dv, dw, dh);
+  }
+
+  for (size_t i = 0; i < w.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(w[i], dw[i], 1e-5);
+  for (size_t i = 0; i < h.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(h[i], dh[i], 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(SparseUpdateRulesTest)
+{
+  CheckSparseUpdateRule(NMFMultiplicativeDivergenceUpdate(),
+      NMFMultiplicativeDivergenceUpdate());
+  CheckSparseUpdateRule(SVDBatchLearning(0.001, 0.01, 0.01, 0.5),
+      SVDBatchLearning(0.001, 0.01, 0.01, 0.5));
+}
+
 /**
  * Check if all elements in W and H are non-negative.
  * Default Case.
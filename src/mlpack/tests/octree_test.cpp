@@ -346,4 +346,69 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   delete textTree;
 }
 
+/**
+ * Large trees are sorted by Morton code before they are split; make sure the
+ * mappings and the bounds are still correct.
+ */
+BOOST_AUTO_TEST_CASE(LargeOctreeTest)
+{
+  arma::mat dataset(3, 150000, arma::fill::randu);
+  std::vector<size_t> oldFromNew;
+  Octree<> t(dataset, oldFromNew);
+
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), dataset.n_cols);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    BOOST_REQUIRE_SMALL(arma::norm(dataset.col(oldFromNew[i]) -
+        t.Dataset().col(i)), 1e-10);
+  }
+
+  CheckOverlap(t);
+  CheckFurthestDistances(t);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Check that two trees built from the same data are identical.
+ */
+template<typename TreeType>
+void CheckSameTree(TreeType& node1, TreeType& node2)
+{
+  CheckSameNode(node1, node2);
+  BOOST_REQUIRE_CLOSE(node1.ParentDistance() + 1.0,
+      node2.ParentDistance() + 1.0, 1e-10);
+
+  for (size_t i = 0; i < node1.NumChildren(); ++i)
+    CheckSameTree(node1.Child(i), node2.Child(i));
+}
+
+/**
+ * Building a large tree in parallel should give exactly the same tree as
+ * building it serially.
+ */
+BOOST_AUTO_TEST_CASE(ParallelOctreeBuildTest)
+{
+  arma::mat dataset(3, 200000, arma::fill::randu);
+
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  std::vector<size_t> serialOldFromNew;
+  Octree<> serialTree(dataset, serialOldFromNew);
+
+  omp_set_num_threads(std::max(threads, 4));
+  std::vector<size_t> oldFromNew;
+  Octree<> tree(dataset, oldFromNew);
+  omp_set_num_threads(threads);
+
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), serialOldFromNew.size());
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(oldFromNew[i], serialOldFromNew[i]);
+  CheckMatrices(tree.Dataset(), serialTree.Dataset());
+
+  CheckSameTree(tree, serialTree);
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
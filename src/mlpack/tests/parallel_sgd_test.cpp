@@ -14,6 +14,7 @@
 #include <mlpack/core/optimizers/parallel_sgd/decay_policies/exponential_backoff.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/sparse_test_function.hpp>
 #include <mlpack/core/optimizers/problems/generalized_rosenbrock_function.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 
 // We need some thorough testing.
 #define private public
@@ -103,6 +104,65 @@ BOOST_AUTO_TEST_CASE(GeneralizedRosenbrockTest)
   }
 }
 
+/**
+ * With a single thread and a merge interval of 1, the dense update policy
+ * should also behave like normal SGD.
+ */
+BOOST_AUTO_TEST_CASE(DenseBatchUpdateGeneralizedRosenbrockTest)
+{
+  for (size_t i = 10; i < 50; i += 5)
+  {
+    GeneralizedRosenbrockFunction f(i);
+
+    ConstantStep decayPolicy(0.001);
+    DenseBatchUpdate updatePolicy(1);
+
+    ParallelSGD<ConstantStep, DenseBatchUpdate> s(0, f.NumFunctions(), 1e-12,
+        true, decayPolicy, updatePolicy);
+
+    arma::mat coordinates = f.GetInitialPoint();
+
+    omp_set_num_threads(1);
+    double result = s.Optimize(f, coordinates);
+
+    BOOST_REQUIRE_SMALL(result, 1e-8);
+    for (size_t j = 0; j < i; ++j)
+      BOOST_REQUIRE_CLOSE(coordinates[j], (double) 1.0, 0.01);
+  }
+}
+
+/**
+ * Train a logistic regression model on sparse data with the sparse gradients
+ * of LogisticRegressionFunction, and make sure that the classes are separated.
+ */
+BOOST_AUTO_TEST_CASE(SparseLogisticRegressionTest)
+{
+  // The points of each class only have non-zero values in their half of the
+  // dimensions.
+  arma::sp_mat dataset(100, 1000);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    labels[i] = i % 2;
+    for (size_t j = 0; j < 5; ++j)
+      dataset(50 * labels[i] + math::RandInt(0, 50), i) = math::Random(0.5, 1);
+  }
+
+  regression::LogisticRegressionFunction<arma::sp_mat> f(dataset, labels);
+
+  const size_t threadsAvailable = omp_get_max_threads();
+  ConstantStep decayPolicy(0.5);
+  ParallelSGD<ConstantStep> s(100, std::ceil((float) f.NumFunctions() /
+      threadsAvailable), 1e-8, true, decayPolicy);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates);
+
+  regression::LogisticRegression<arma::sp_mat> lr(dataset.n_rows);
+  lr.Parameters() = coordinates;
+  BOOST_REQUIRE_GE(lr.ComputeAccuracy(dataset, labels), 99.0);
+}
+
 #endif
 
 /**
@@ -207,6 +207,106 @@ BOOST_AUTO_TEST_CASE(ArmaComparisonRandomizedPCATest)
   ArmaComparisonPCA<RandomizedSVDPolicy>();
 }
 
+/**
+ * Make sure that the products computed by CenteredMatrix match the ones with
+ * the explicitly centered (and scaled) data.
+ */
+BOOST_AUTO_TEST_CASE(CenteredMatrixTest)
+{
+  arma::mat data = arma::randu<arma::mat>(6, 1000);
+  data.row(2) *= 50.0;
+  data.row(4) += 10.0;
+
+  for (size_t scale = 0; scale < 2; ++scale)
+  {
+    arma::mat centered;
+    math::Center(data, centered);
+    if (scale)
+    {
+      arma::vec stdDev = arma::stddev(centered, 0, 1);
+      centered.each_col() /= stdDev;
+    }
+
+    CenteredMatrix centeredMatrix(data, scale == 1);
+
+    arma::mat materialized;
+    centeredMatrix.Materialize(materialized);
+    CheckMatrices(materialized, centered, 1e-3);
+
+    const arma::mat x = arma::randn<arma::mat>(1000, 3);
+    arma::mat product;
+    centeredMatrix.Multiply(x, product);
+    CheckMatrices(product, centered * x, 1e-3);
+
+    const arma::mat y = arma::randn<arma::mat>(6, 3);
+    centeredMatrix.TransposeMultiply(y, product);
+    CheckMatrices(product, centered.t() * y, 1e-3);
+
+    centeredMatrix.Project(y, product);
+    CheckMatrices(product, y.t() * centered, 1e-3);
+
+    arma::mat covariance;
+    centeredMatrix.Covariance(covariance);
+    CheckMatrices(covariance, centered * centered.t() / 999, 1e-3);
+  }
+}
+
+/**
+ * Make sure that PCA on a streamed dataset finds the same leading principal
+ * components as exact PCA on the data in memory.
+ */
+template<typename DecompositionPolicy>
+void StreamingPCA(const DecompositionPolicy& decomposition)
+{
+  // Data with three large principal components.
+  arma::mat basis = arma::randn<arma::mat>(10, 3);
+  arma::mat data = basis * arma::randn<arma::mat>(3, 400) +
+      0.01 * arma::randn<arma::mat>(10, 400);
+  data.each_col() += arma::linspace<arma::vec>(-5, 5, 10);
+  data.save("pca_streaming.bin", arma::arma_binary);
+
+  arma::mat transformedData, eigvec, streamingEigvec;
+  arma::vec eigval, streamingEigval;
+  PCA<ExactSVDPolicy> exactPCA;
+  exactPCA.Apply(data, transformedData, eigval, eigvec);
+
+  {
+    data::StreamingDataset<> dataset("pca_streaming.bin", 64);
+    PCA<DecompositionPolicy> pca(false, decomposition);
+    pca.Apply(dataset, streamingEigval, streamingEigvec, 3);
+  }
+
+  remove("pca_streaming.bin");
+
+  BOOST_REQUIRE_EQUAL(streamingEigval.n_elem, 3);
+  BOOST_REQUIRE_EQUAL(streamingEigvec.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(streamingEigvec.n_cols, 3);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(streamingEigval[i], eigval[i], 1e-3);
+
+    // The eigenvectors are only defined up to their sign.
+    BOOST_REQUIRE_CLOSE(std::abs(arma::dot(streamingEigvec.col(i),
+        eigvec.col(i))), 1.0, 1e-3);
+  }
+}
+
+/**
+ * Streamed PCA with the randomized SVD.
+ */
+BOOST_AUTO_TEST_CASE(StreamingRandomizedPCATest)
+{
+  StreamingPCA(RandomizedSVDPolicy(0, 3));
+}
+
+/**
+ * Streamed PCA with the randomized block krylov SVD.
+ */
+BOOST_AUTO_TEST_CASE(StreamingRandomizedBlockKrylovPCATest)
+{
+  StreamingPCA(RandomizedBlockKrylovSVDPolicy(3));
+}
+
 /**
  * Test that dimensionality reduction with exact-svd PCA works the same way
  * MATLAB does (which should be correct!).
@@ -255,4 +255,41 @@ BOOST_AUTO_TEST_CASE(SecondaryConstructor)
   Perceptron<> p2(p1);
 }
 
+/**
+ * Mini-batch training should converge on linearly separable data, both with
+ * small batches and with one batch of the whole dataset (which is split into
+ * several parallel blocks).
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchTraining)
+{
+  // Three well-separated Gaussian clusters, around (20, 0), (0, 20) and
+  // (-20, -20).
+  arma::mat trainData(2, 3000);
+  trainData.randn();
+  arma::Row<size_t> labels(3000);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    labels[i] = i % 3;
+    if (labels[i] == 2)
+      trainData.col(i) -= 20.0;
+    else
+      trainData(labels[i], i) += 20.0;
+  }
+
+  Perceptron<> p1(trainData, labels, 3, 1000, 64);
+  BOOST_REQUIRE_EQUAL(p1.BatchSize(), 64);
+  Perceptron<> p2(trainData, labels, 3, 1000, trainData.n_cols);
+  BOOST_REQUIRE_EQUAL(p2.BatchSize(), trainData.n_cols);
+
+  arma::Row<size_t> predictedLabels;
+  p1.Classify(trainData, predictedLabels);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictedLabels != labels), 0);
+  p2.Classify(trainData, predictedLabels);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictedLabels != labels), 0);
+
+  // A perceptron built from another one should use its batch size.
+  Perceptron<> p3(p1, trainData, labels, 3, arma::rowvec());
+  BOOST_REQUIRE_EQUAL(p3.BatchSize(), 64);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
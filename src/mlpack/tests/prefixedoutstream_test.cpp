@@ -11,6 +11,7 @@
  */
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 #include <mlpack/core.hpp>
 
@@ -239,4 +240,88 @@ BOOST_AUTO_TEST_CASE(TestArmaCustomPrecision)
       BASH_GREEN "[INFO ] " BASH_CLEAR "   4.0000   4.5000   5.0000\n");
 }
 
+/**
+ * Make sure that a LogMessage writes its whole message, prefixed, when it is
+ * destroyed, and terminates it with a newline if necessary.
+ */
+BOOST_AUTO_TEST_CASE(TestLogMessage)
+{
+  std::stringstream ss;
+  PrefixedOutStream pss(ss, BASH_GREEN "[INFO ] " BASH_CLEAR);
+
+  LogMessage(pss) << "Value " << 3 << "." << std::endl;
+  BOOST_REQUIRE_EQUAL(ss.str(), BASH_GREEN "[INFO ] " BASH_CLEAR "Value 3.\n");
+
+  ss.str("");
+  LogMessage(pss) << "Two\nlines";
+  BOOST_REQUIRE_EQUAL(ss.str(), BASH_GREEN "[INFO ] " BASH_CLEAR "Two\n"
+      BASH_GREEN "[INFO ] " BASH_CLEAR "lines\n");
+}
+
+/**
+ * Make sure that the operands of MLPACK_LOG_INFO are not evaluated when
+ * Log::Info ignores its input.
+ */
+BOOST_AUTO_TEST_CASE(TestLogMacroSkipsDisabledStream)
+{
+  const bool ignoreInput = Log::Info.ignoreInput;
+  Log::Info.ignoreInput = true;
+
+  size_t evaluated = 0;
+  auto evaluate = [&evaluated]() { return ++evaluated; };
+  MLPACK_LOG_INFO << "Evaluated " << evaluate() << " times." << std::endl;
+  for (size_t i = 0; i < 10; ++i)
+    MLPACK_LOG_INFO << evaluate();
+  #ifndef DEBUG
+    MLPACK_LOG_DEBUG << evaluate();
+  #endif
+
+  BOOST_REQUIRE_EQUAL(evaluated, 0);
+  Log::Info.ignoreInput = ignoreInput;
+}
+
+/**
+ * Make sure that messages written from many threads through the asynchronous
+ * sink are all written whole, with a timestamp and thread index.
+ */
+BOOST_AUTO_TEST_CASE(TestAsyncLogSink)
+{
+  std::stringstream ss;
+  PrefixedOutStream pss(ss, "[TEST ] ");
+
+  LogSink::StartAsync();
+  BOOST_REQUIRE(LogSink::Async());
+
+  std::thread threads[4];
+  for (size_t t = 0; t < 4; ++t)
+  {
+    threads[t] = std::thread([&pss, t]()
+        {
+          for (size_t i = 0; i < 100; ++i)
+            LogMessage(pss) << "message " << i << " of thread " << t << "."
+                << std::endl;
+        });
+  }
+
+  for (size_t t = 0; t < 4; ++t)
+    threads[t].join();
+
+  LogSink::Flush();
+  LogSink::StopAsync();
+  BOOST_REQUIRE(!LogSink::Async());
+
+  size_t lines = 0;
+  std::string line;
+  while (std::getline(ss, line))
+  {
+    BOOST_REQUIRE_EQUAL(line.compare(0, 8, "[TEST ] "), 0);
+    BOOST_REQUIRE_NE(line.find("] message "), std::string::npos);
+    BOOST_REQUIRE_NE(line.find(" [thread "), std::string::npos);
+    BOOST_REQUIRE_EQUAL(line.back(), '.');
+    ++lines;
+  }
+
+  BOOST_REQUIRE_EQUAL(lines, 400);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -173,6 +173,136 @@ BOOST_AUTO_TEST_CASE(CartPoleWithDoubleDQN)
   BOOST_REQUIRE(converged);
 }
 
+//! Test DQN with prioritized replay in Cart Pole task.
+BOOST_AUTO_TEST_CASE(CartPoleWithPrioritizedDQN)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of iterations using random weights. If this works 1 of 4 times, I'm fine
+  // with that.
+  size_t episodes = 0;
+  bool converged = false;
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    // Set up the network.
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+    PrioritizedReplay<CartPole> replayMethod(10, 10000, 0.6, 0.4, 10000);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+    config.DoubleQLearning() = false;
+    config.StepLimit() = 200;
+
+    // Set up the DQN agent.
+    QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy),
+        decltype(replayMethod)> agent(std::move(config), std::move(model),
+        std::move(policy), std::move(replayMethod));
+
+    arma::running_stat<double> averageReturn;
+
+    for (episodes = 0; episodes <= 1000; ++episodes)
+    {
+      double episodeReturn = agent.Episode();
+      averageReturn(episodeReturn);
+
+      Log::Debug << "Average return: " << averageReturn.mean()
+          << " Episode return: " << episodeReturn << std::endl;
+      if (averageReturn.mean() > 35)
+      {
+        agent.Deterministic() = true;
+        arma::running_stat<double> testReturn;
+        for (size_t i = 0; i < 10; ++i)
+          testReturn(agent.Episode());
+        Log::Debug << "Average return in deterministic test: "
+            << testReturn.mean() << std::endl;
+        break;
+      }
+    }
+
+    if (episodes < 1000)
+    {
+      converged = true;
+      break;
+    }
+  }
+
+  BOOST_REQUIRE(converged);
+}
+
+//! Test DQN stepping several Cart Pole instances together.
+BOOST_AUTO_TEST_CASE(CartPoleWithVectorEnvironmentDQN)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of iterations using random weights. If this works 1 of 4 times, I'm fine
+  // with that.
+  bool converged = false;
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    // Set up the network.
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+    RandomReplay<CartPole> replayMethod(10, 10000);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+    config.DoubleQLearning() = false;
+
+    // Set up the DQN agent.
+    QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy)>
+        agent(std::move(config), std::move(model), std::move(policy),
+        std::move(replayMethod));
+
+    VectorEnvironment<CartPole> environments(4, 200);
+
+    // Each instance runs up to 1000 episodes.
+    arma::running_stat<double> averageReturn;
+    for (size_t step = 0; step < 200000; ++step)
+    {
+      agent.Step(environments);
+      for (const double episodeReturn : environments.EpisodeReturns())
+        averageReturn(episodeReturn);
+      environments.EpisodeReturns().clear();
+
+      if (averageReturn.count() > 4000)
+        break;
+
+      if (averageReturn.count() > 0 && averageReturn.mean() > 35)
+      {
+        converged = true;
+        break;
+      }
+    }
+
+    Log::Debug << "Average return: " << averageReturn.mean() << std::endl;
+    if (converged)
+      break;
+  }
+
+  BOOST_REQUIRE(converged);
+}
+
 //! Test DQN in Acrobat task.
 BOOST_AUTO_TEST_CASE(AcrobatWithDQN)
 {
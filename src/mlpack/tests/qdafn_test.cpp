@@ -187,6 +187,43 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   }
 }
 
+/**
+ * Make sure the returned distances are the distances to the returned
+ * neighbors, in decreasing order, and that the candidate sets of the tables
+ * are laid out one after the other.
+ */
+BOOST_AUTO_TEST_CASE(QDAFNDistancesTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(8, 400);
+  arma::mat querySet = arma::randu<arma::mat>(8, 100);
+
+  QDAFN<> qdafn(dataset, 10, 30);
+
+  BOOST_REQUIRE_EQUAL(qdafn.Candidates().n_cols, 300);
+  for (size_t t = 0; t < qdafn.NumProjections(); ++t)
+  {
+    const arma::mat candidateSet = qdafn.CandidateSet(t);
+    for (size_t i = 0; i < candidateSet.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(candidateSet[i], qdafn.Candidates()[t * 240 + i]);
+  }
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  qdafn.Search(querySet, 5, neighbors, distances);
+
+  for (size_t q = 0; q < querySet.n_cols; ++q)
+  {
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_LT(neighbors(j, q), dataset.n_cols);
+      BOOST_REQUIRE_CLOSE(distances(j, q), metric::EuclideanDistance::Evaluate(
+          querySet.col(q), dataset.col(neighbors(j, q))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_GE(distances(j - 1, q), distances(j, q));
+    }
+  }
+}
+
 // Make sure QDAFN works with sparse data.
 BOOST_AUTO_TEST_CASE(SparseTest)
 {
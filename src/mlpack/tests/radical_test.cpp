@@ -58,4 +58,41 @@ BOOST_AUTO_TEST_CASE(Radical_Test_Radical3D)
   BOOST_REQUIRE_CLOSE(valBest, valEst, 2.0);
 }
 
+/**
+ * Make sure that the parallel angle search of DoRadical2D() finds the same
+ * angle as a sequential search over the same perturbed data.
+ */
+BOOST_AUTO_TEST_CASE(Radical2DSeedTest)
+{
+  mat matX = randn(200, 2);
+  matX.col(1) += 0.5 * matX.col(0);
+
+  Radical rad(0.175, 5, 60, 0, 10);
+
+  math::RandomSeed(17);
+  const double theta = rad.DoRadical2D(matX);
+
+  // Draw the same noise again, and search the angles one by one.
+  math::RandomSeed(17);
+  mat perturbed;
+  rad.CopyAndPerturb(perturbed, matX);
+
+  size_t best = 0;
+  double bestValue = DBL_MAX;
+  for (size_t i = 0; i < rad.Angles(); ++i)
+  {
+    const double angle = (i / (double) rad.Angles()) * M_PI / 2.0;
+    vec y1 = cos(angle) * perturbed.col(0) - sin(angle) * perturbed.col(1);
+    vec y2 = sin(angle) * perturbed.col(0) + cos(angle) * perturbed.col(1);
+    const double value = rad.Vasicek(y1) + rad.Vasicek(y2);
+    if (value < bestValue)
+    {
+      bestValue = value;
+      best = i;
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(theta, (best / (double) rad.Angles()) * M_PI / 2.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/flat_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -96,6 +97,29 @@ BOOST_AUTO_TEST_CASE(BootstrapWeightsTest)
   }
 }
 
+/**
+ * Make sure bootstrap counts describe a sample of the right size, with about
+ * a third of the points out of the bag.
+ */
+BOOST_AUTO_TEST_CASE(BootstrapCountsTest)
+{
+  math::Philox generator(math::RandKey());
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::Row<size_t> counts;
+    BootstrapCounts(10000, generator, counts);
+
+    BOOST_REQUIRE_EQUAL(counts.n_elem, 10000);
+    BOOST_REQUIRE_EQUAL(arma::accu(counts), 10000);
+
+    // The expected fraction of points out of the bag is (1 - 1/n)^n, which is
+    // about 1/e.
+    const size_t outOfBag = arma::accu(counts == 0);
+    BOOST_REQUIRE_GT(outOfBag, 3400);
+    BOOST_REQUIRE_LT(outOfBag, 3950);
+  }
+}
+
 /**
  * Make sure an empty forest cannot predict.
  */
@@ -300,8 +324,9 @@ BOOST_AUTO_TEST_CASE(WeightedCategoricalLearningTest)
 }
 
 /**
- * Test that learning with a leaf size of 1 successfully memorizes the training
- * set.
+ * Test that learning with a leaf size of 1 nearly memorizes the training set.
+ * Each tree only sees its bootstrap sample, so a point may be outvoted by the
+ * trees that didn't see it.
  */
 BOOST_AUTO_TEST_CASE(LeafSize1Test)
 {
@@ -319,7 +344,42 @@ BOOST_AUTO_TEST_CASE(LeafSize1Test)
   rf.Classify(dataset, predictions);
 
   const size_t correct = arma::accu(predictions == labels);
-  BOOST_REQUIRE_EQUAL(correct, dataset.n_cols);
+  BOOST_REQUIRE_GE(correct, size_t(0.95 * dataset.n_cols));
+}
+
+/**
+ * Make sure that both bootstrap modes learn, and that the out-of-bag error is
+ * a reasonable estimate of the error on the test set.
+ */
+BOOST_AUTO_TEST_CASE(OutOfBagErrorTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    RandomForest<GiniGain, RandomDimensionSelect> rf;
+    BOOST_REQUIRE(std::isnan(rf.OutOfBagError()));
+
+    rf.WeightedBootstrap() = (mode == 0);
+    rf.Train(dataset, labels, 3, 20 /* 20 trees */, 5);
+
+    arma::Row<size_t> predictions;
+    rf.Classify(testDataset, predictions);
+    const double testError = 1.0 -
+        double(arma::accu(predictions == testLabels)) / testLabels.n_elem;
+
+    BOOST_REQUIRE_LE(testError, 0.3);
+    BOOST_REQUIRE(!std::isnan(rf.OutOfBagError()));
+    BOOST_REQUIRE_LE(rf.OutOfBagError(), 0.35);
+    BOOST_REQUIRE_LE(std::abs(rf.OutOfBagError() - testError), 0.15);
+  }
 }
 
 /**
@@ -372,6 +432,9 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   data::Load("vc2_labels.txt", labels);
 
   RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 10);
+  // The sampling mode is used the next time the forest is trained, so it must
+  // be saved too.
+  rf.WeightedBootstrap() = false;
 
   arma::Row<size_t> beforePredictions;
   arma::mat beforeProbabilities;
@@ -381,6 +444,10 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   binaryForest.Train(dataset, labels, 3, 3, 50);
   SerializeObjectAll(rf, xmlForest, textForest, binaryForest);
 
+  BOOST_REQUIRE(!xmlForest.WeightedBootstrap());
+  BOOST_REQUIRE(!textForest.WeightedBootstrap());
+  BOOST_REQUIRE(!binaryForest.WeightedBootstrap());
+
   // Now check that we get the same results serializing other things.
   arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
   arma::mat xmlProbabilities, textProbabilities, binaryProbabilities;
@@ -395,4 +462,124 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
       binaryProbabilities);
 }
 
+/**
+ * Make sure that a compiled forest gives exactly the same predictions and
+ * probabilities as the random forest it was compiled from, on both numeric and
+ * categorical data.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 5);
+  FlatForest<> flat(rf);
+
+  BOOST_REQUIRE_EQUAL(flat.NumTrees(), 10);
+  BOOST_REQUIRE_EQUAL(flat.NumClasses(), 3);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(dataset, predictions, probabilities);
+  flat.Classify(dataset, flatPredictions, flatProbabilities);
+
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+
+  // Check the single-point overloads too.
+  for (size_t i = 0; i < dataset.n_cols; i += 10)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    flat.Classify(dataset.col(i), prediction, pointProbabilities);
+
+    BOOST_REQUIRE_EQUAL(prediction, predictions[i]);
+    BOOST_REQUIRE_EQUAL(flat.Classify(dataset.col(i)), predictions[i]);
+    CheckMatrices(pointProbabilities, arma::vec(probabilities.col(i)));
+  }
+
+  // Now use categorical data.
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  RandomForest<> categoricalRf(d, di, l, 5, 5 /* 5 trees */, 5);
+  FlatForest<> categoricalFlat(categoricalRf);
+
+  categoricalRf.Classify(d, predictions, probabilities);
+  categoricalFlat.Classify(d, flatPredictions, flatProbabilities);
+
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+}
+
+/**
+ * Make sure that a compiled decision tree gives the same results as the tree.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestDecisionTreeTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  DecisionTree<> dt(d, di, l, 5, 5);
+  FlatForest<> flat(dt);
+
+  BOOST_REQUIRE_EQUAL(flat.NumTrees(), 1);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  dt.Classify(d, predictions, probabilities);
+  flat.Classify(d, flatPredictions, flatProbabilities);
+
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+
+  // An empty FlatForest can't predict.
+  FlatForest<> empty;
+  BOOST_REQUIRE_THROW(empty.Classify(d, predictions), std::invalid_argument);
+  BOOST_REQUIRE_THROW(empty.Classify(d.col(0)), std::invalid_argument);
+
+  // An untrained forest can't be compiled.
+  RandomForest<> rf;
+  BOOST_REQUIRE_THROW(FlatForest<> f(rf), std::invalid_argument);
+}
+
+/**
+ * Make sure that a compiled forest can be serialized.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestSerializationTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 10);
+  FlatForest<> flat(rf);
+
+  arma::Row<size_t> beforePredictions;
+  arma::mat beforeProbabilities;
+  flat.Classify(dataset, beforePredictions, beforeProbabilities);
+
+  FlatForest<> xmlForest, textForest, binaryForest;
+  SerializeObjectAll(flat, xmlForest, textForest, binaryForest);
+
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, textProbabilities, binaryProbabilities;
+
+  xmlForest.Classify(dataset, xmlPredictions, xmlProbabilities);
+  textForest.Classify(dataset, textPredictions, textProbabilities);
+  binaryForest.Classify(dataset, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(beforePredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(beforeProbabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
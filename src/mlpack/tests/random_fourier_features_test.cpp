@@ -0,0 +1,163 @@
+/**
+ * @file random_fourier_features_test.cpp
+ *
+ * Tests for RandomFourierFeatures and RandomFourierKernelRule.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/random_fourier_features/random_fourier_features.hpp>
+#include <mlpack/methods/kernel_pca/kernel_pca.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_fourier_method.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kernel;
+using namespace mlpack::kpca;
+
+BOOST_AUTO_TEST_SUITE(RandomFourierFeaturesTest);
+
+/**
+ * Check that the dot products of the features of the given points approximate
+ * the kernel.
+ */
+template<typename KernelType>
+void CheckKernelApproximation(const KernelType& kernel, const bool fastfood)
+{
+  // The dimensionality is not a power of two, so Fastfood has to pad.
+  arma::mat data = arma::randu<arma::mat>(5, 100);
+
+  RandomFourierFeatures rff(kernel, data.n_rows, 2000, fastfood);
+  arma::mat features;
+  rff.Transform(data, features);
+
+  BOOST_REQUIRE_EQUAL(features.n_rows, 4000);
+  BOOST_REQUIRE_EQUAL(features.n_cols, data.n_cols);
+
+  const arma::mat approximation = features.t() * features;
+  double totalError = 0.0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    for (size_t j = 0; j < data.n_cols; ++j)
+    {
+      const double error = std::abs(approximation(i, j) -
+          kernel.Evaluate(data.col(i), data.col(j)));
+      BOOST_REQUIRE_LE(error, 0.15);
+      totalError += error;
+    }
+  }
+
+  BOOST_REQUIRE_LE(totalError / (data.n_cols * data.n_cols), 0.03);
+}
+
+/**
+ * Make sure the dense features approximate the Gaussian kernel.
+ */
+BOOST_AUTO_TEST_CASE(GaussianKernelApproximationTest)
+{
+  CheckKernelApproximation(GaussianKernel(0.5), false);
+}
+
+/**
+ * Make sure the Fastfood features approximate the Gaussian kernel.
+ */
+BOOST_AUTO_TEST_CASE(GaussianKernelFastfoodTest)
+{
+  CheckKernelApproximation(GaussianKernel(0.5), true);
+}
+
+/**
+ * Make sure the dense and Fastfood features approximate the Laplacian kernel.
+ */
+BOOST_AUTO_TEST_CASE(LaplacianKernelApproximationTest)
+{
+  CheckKernelApproximation(LaplacianKernel(1.0), false);
+  CheckKernelApproximation(LaplacianKernel(1.0), true);
+}
+
+/**
+ * Make sure that transforming blocks of points separately gives the same
+ * features as transforming all of them at once.
+ */
+BOOST_AUTO_TEST_CASE(TransformBatchTest)
+{
+  arma::mat data = arma::randu<arma::mat>(8, 600);
+
+  for (size_t f = 0; f < 2; ++f)
+  {
+    RandomFourierFeatures rff(GaussianKernel(1.0), data.n_rows, 64, f == 1);
+
+    arma::mat features, firstFeatures, secondFeatures;
+    rff.Transform(data, features);
+    rff.Transform(data.cols(0, 299), firstFeatures);
+    rff.Transform(data.cols(300, 599), secondFeatures);
+
+    CheckMatrices(features, arma::join_rows(firstFeatures, secondFeatures));
+  }
+}
+
+/**
+ * Make sure that invalid uses throw.
+ */
+BOOST_AUTO_TEST_CASE(RandomFourierFeaturesInvalidTest)
+{
+  arma::mat features;
+
+  RandomFourierFeatures untrained;
+  BOOST_REQUIRE_THROW(untrained.Transform(arma::randu<arma::mat>(3, 10),
+      features), std::runtime_error);
+
+  BOOST_REQUIRE_THROW(RandomFourierFeatures(GaussianKernel(), 0, 10),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(RandomFourierFeatures(GaussianKernel(), 3, 0),
+      std::invalid_argument);
+
+  RandomFourierFeatures rff(GaussianKernel(), 3, 10);
+  BOOST_REQUIRE_THROW(rff.Transform(arma::randu<arma::mat>(4, 10), features),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that the leading eigenvalues of kernel PCA with random Fourier
+ * features are close to the exact ones.
+ */
+BOOST_AUTO_TEST_CASE(RandomFourierKernelRuleTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 200);
+
+  arma::mat transformedData, eigvec;
+  arma::vec eigval;
+  KernelPCA<GaussianKernel> exact(GaussianKernel(0.5));
+  exact.Apply(data, transformedData, eigval, eigvec);
+
+  for (size_t f = 0; f < 2; ++f)
+  {
+    arma::mat approxTransformedData, approxEigvec;
+    arma::vec approxEigval;
+    if (f == 0)
+    {
+      KernelPCA<GaussianKernel, RandomFourierKernelRule<GaussianKernel>>
+          approx(GaussianKernel(0.5));
+      approx.Apply(data, approxTransformedData, approxEigval, approxEigvec,
+          1000);
+    }
+    else
+    {
+      KernelPCA<GaussianKernel, RandomFourierKernelRule<GaussianKernel, true>>
+          approx(GaussianKernel(0.5));
+      approx.Apply(data, approxTransformedData, approxEigval, approxEigvec,
+          1000);
+    }
+
+    BOOST_REQUIRE_EQUAL(approxEigval.n_elem, 2000);
+    BOOST_REQUIRE_EQUAL(approxTransformedData.n_cols, data.n_cols);
+    for (size_t i = 0; i < 3; ++i)
+      BOOST_REQUIRE_LE(std::abs(approxEigval[i] - eigval[i]), 0.1 * eigval[0]);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -67,6 +67,27 @@ BOOST_AUTO_TEST_CASE(DiscreteUniformRandomTest)
   }
 }
 
+// Make sure that RandIndex() can draw indices beyond the range of an int.
+BOOST_AUTO_TEST_CASE(RandIndexLargeRangeTest)
+{
+  const size_t hiExclusive = ((size_t) 1 << 33) + 5;
+  size_t aboveIntRange = 0;
+  for (size_t iter = 0; iter < 1000; ++iter)
+  {
+    const size_t index = RandIndex(hiExclusive);
+    BOOST_REQUIRE_LT(index, hiExclusive);
+    if (index > (size_t) std::numeric_limits<int>::max())
+      ++aboveIntRange;
+  }
+
+  // About three quarters of the draws should be above the range of an int.
+  BOOST_REQUIRE_GT(aboveIntRange, 600);
+
+  // A single index can only be 0.
+  for (size_t iter = 0; iter < 10; ++iter)
+    BOOST_REQUIRE_EQUAL(RandIndex(1), (size_t) 0);
+}
+
 // Test for RandInt() sampler from discrete (possibly nonuniform) distribution.
 BOOST_AUTO_TEST_CASE(WeightedRandomTest)
 {
@@ -97,4 +118,113 @@ BOOST_AUTO_TEST_CASE(WeightedRandomTest)
   }
 }
 
+// Check Philox against the known answer of its reference implementation, and
+// make sure that skipping numbers gives the same stream.
+BOOST_AUTO_TEST_CASE(PhiloxTest)
+{
+  Philox generator(0, 0);
+  BOOST_REQUIRE_EQUAL(generator(), 0x6627e8d5u);
+  BOOST_REQUIRE_EQUAL(generator(), 0xe169c58du);
+  BOOST_REQUIRE_EQUAL(generator(), 0xbc57ac4cu);
+  BOOST_REQUIRE_EQUAL(generator(), 0x9b00dbd8u);
+
+  const size_t skips[] = { 0, 1, 3, 4, 13, 1002 };
+  for (const size_t skip : skips)
+  {
+    Philox a(17, 3), b(17, 3);
+    b();
+    for (size_t i = 0; i < skip + 1; ++i)
+      a();
+    b.Discard(skip);
+    for (size_t i = 0; i < 10; ++i)
+      BOOST_REQUIRE_EQUAL(a(), b());
+  }
+
+  // Different streams differ.
+  Philox c(17, 0), d(17, 1);
+  size_t same = 0;
+  for (size_t i = 0; i < 100; ++i)
+    same += (c() == d());
+  BOOST_REQUIRE_LT(same, 2);
+}
+
+// Draw random numbers inside a parallel region, and make sure that every
+// thread gets the same numbers after the generators are reseeded.
+BOOST_AUTO_TEST_CASE(ParallelRandomTest)
+{
+  const size_t points = 10000;
+  arma::vec first(points), second(points);
+
+  RandomSeed(42);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) points; ++i)
+    first[i] = Random() + RandNormal() + RandInt(10);
+
+  RandomSeed(42);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) points; ++i)
+    second[i] = Random() + RandNormal() + RandInt(10);
+
+  for (size_t i = 0; i < points; ++i)
+    BOOST_REQUIRE_EQUAL(first[i], second[i]);
+
+  // The numbers should still look uniform.
+  arma::vec uniform(points);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) points; ++i)
+    uniform[i] = Random();
+
+  BOOST_REQUIRE_SMALL(arma::mean(uniform) - 0.5, 0.02);
+  BOOST_REQUIRE_GE(uniform.min(), 0.0);
+  BOOST_REQUIRE_LT(uniform.max(), 1.0);
+}
+
+// Make sure RandFill() and RandNormalFill() give the expected distributions and
+// can be reproduced.
+BOOST_AUTO_TEST_CASE(RandFillTest)
+{
+  arma::mat uniform(100, 1000), uniform2(100, 1000);
+  RandomSeed(7);
+  RandFill(uniform, -2.0, 4.0);
+  RandomSeed(7);
+  RandFill(uniform2, -2.0, 4.0);
+
+  for (size_t i = 0; i < uniform.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(uniform[i], uniform2[i]);
+
+  BOOST_REQUIRE_GE(uniform.min(), -2.0);
+  BOOST_REQUIRE_LT(uniform.max(), 4.0);
+  BOOST_REQUIRE_SMALL(arma::mean(arma::vectorise(uniform)) - 1.0, 0.05);
+
+  // Successive fills differ.
+  RandFill(uniform2, -2.0, 4.0);
+  BOOST_REQUIRE_GT(arma::accu(uniform != uniform2), uniform.n_elem - 10);
+
+  arma::vec normal(100000);
+  RandNormalFill(normal, 3.0, 2.0);
+  BOOST_REQUIRE_SMALL(arma::mean(normal) - 3.0, 0.05);
+  BOOST_REQUIRE_SMALL(arma::stddev(normal) - 2.0, 0.05);
+}
+
+// Make sure RandBernoulliFill() samples with the given probabilities.
+BOOST_AUTO_TEST_CASE(RandBernoulliFillTest)
+{
+  arma::mat probabilities(2, 50000);
+  probabilities.row(0).fill(0.2);
+  probabilities.row(1).fill(0.7);
+  probabilities.col(0).zeros();
+  probabilities.col(1).ones();
+
+  arma::mat samples(probabilities);
+  RandBernoulliFill(samples);
+
+  BOOST_REQUIRE(arma::all(arma::vectorise((samples == 0) + (samples == 1))));
+  BOOST_REQUIRE_EQUAL(samples(0, 0), 0.0);
+  BOOST_REQUIRE_EQUAL(samples(1, 0), 0.0);
+  BOOST_REQUIRE_EQUAL(samples(0, 1), 1.0);
+  BOOST_REQUIRE_EQUAL(samples(1, 1), 1.0);
+  BOOST_REQUIRE_SMALL(arma::mean(samples.row(0)) - 0.2, 0.01);
+  BOOST_REQUIRE_SMALL(arma::mean(samples.row(1)) - 0.7, 0.01);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
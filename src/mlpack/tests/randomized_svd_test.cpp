@@ -64,4 +64,55 @@ BOOST_AUTO_TEST_CASE(RandomizedSVDReconstructionError)
   BOOST_REQUIRE_SMALL(error, 1e-5);
 }
 
+/**
+ * The randomized SVD of a streamed dataset should match the exact SVD of the
+ * centered data, and reconstruct it.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDStreamingTest)
+{
+  // A centered matrix of rank 3, moved away from the origin.
+  arma::mat U = arma::randn<arma::mat>(20, 3);
+  arma::mat V = arma::randn<arma::mat>(500, 3);
+  V.each_row() -= arma::mean(V, 0);
+
+  arma::mat R;
+  arma::qr_econ(U, R, U);
+
+  arma::mat centeredData = U * arma::diagmat(arma::vec("10 3 1")) * V.t();
+  arma::mat data = centeredData;
+  data.each_col() += arma::linspace<arma::vec>(1, 20, 20);
+
+  data.save("randomized_svd_streaming.bin", arma::arma_binary);
+
+  arma::mat U1, V1;
+  arma::vec s1;
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  arma::mat U2, V2;
+  arma::vec s2;
+  {
+    // Chunks that are not a multiple of the number of points.
+    data::StreamingDataset<> dataset("randomized_svd_streaming.bin", 70);
+
+    svd::RandomizedSVD rSVD(0, 2);
+    rSVD.Apply(dataset, U2, s2, V2, 3, true);
+  }
+
+  remove("randomized_svd_streaming.bin");
+
+  BOOST_REQUIRE_EQUAL(U2.n_rows, 20);
+  BOOST_REQUIRE_EQUAL(U2.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(s2.n_elem, 3);
+  BOOST_REQUIRE_EQUAL(V2.n_rows, 500);
+  BOOST_REQUIRE_EQUAL(V2.n_cols, 3);
+
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(s2[i], s1[i], 1e-5);
+
+  arma::mat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+  const double error = arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1696,4 +1696,194 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   }
 }
 
+/**
+ * Make sure that the results in CSR layout and the counts are the same as the
+ * nested results.
+ */
+void CheckCSRResults(const vector<vector<size_t>>& baselineNeighbors,
+                     const vector<vector<double>>& baselineDistances,
+                     const arma::Col<size_t>& offsets,
+                     const arma::Col<size_t>& neighbors,
+                     const arma::vec& distances,
+                     const arma::Col<size_t>& counts)
+{
+  BOOST_REQUIRE_EQUAL(offsets.n_elem, baselineNeighbors.size() + 1);
+  BOOST_REQUIRE_EQUAL(counts.n_elem, baselineNeighbors.size());
+  BOOST_REQUIRE_EQUAL(offsets[0], 0);
+  BOOST_REQUIRE_EQUAL(neighbors.n_elem, offsets[offsets.n_elem - 1]);
+  BOOST_REQUIRE_EQUAL(distances.n_elem, offsets[offsets.n_elem - 1]);
+
+  vector<vector<size_t>> csrNeighbors(baselineNeighbors.size());
+  vector<vector<double>> csrDistances(baselineNeighbors.size());
+  for (size_t i = 0; i < baselineNeighbors.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(counts[i], baselineNeighbors[i].size());
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+    {
+      csrNeighbors[i].push_back(neighbors[j]);
+      csrDistances[i].push_back(distances[j]);
+    }
+  }
+
+  vector<vector<pair<double, size_t>>> baselineSorted, sorted;
+  SortResults(baselineNeighbors, baselineDistances, baselineSorted);
+  SortResults(csrNeighbors, csrDistances, sorted);
+
+  for (size_t i = 0; i < sorted.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(sorted[i].size(), baselineSorted[i].size());
+    for (size_t j = 0; j < sorted[i].size(); ++j)
+    {
+      BOOST_REQUIRE_EQUAL(sorted[i][j].second, baselineSorted[i][j].second);
+      BOOST_REQUIRE_CLOSE(sorted[i][j].first, baselineSorted[i][j].first,
+          1e-5);
+    }
+  }
+}
+
+/**
+ * Search in CSR layout and count with the given RangeSearch object, and compare
+ * with the nested results.
+ */
+template<typename RSType>
+void CheckCSRSearch(RSType& rs, const arma::mat& querySet, const Range& range)
+{
+  vector<vector<size_t>> baselineNeighbors;
+  vector<vector<double>> baselineDistances;
+  arma::Col<size_t> offsets, neighbors, counts;
+  arma::vec distances;
+
+  // Bichromatic search.
+  rs.Search(querySet, range, baselineNeighbors, baselineDistances);
+  rs.Search(querySet, range, offsets, neighbors, distances);
+  rs.Count(querySet, range, counts);
+  CheckCSRResults(baselineNeighbors, baselineDistances, offsets, neighbors,
+      distances, counts);
+
+  // Monochromatic search.
+  rs.Search(range, baselineNeighbors, baselineDistances);
+  rs.Search(range, offsets, neighbors, distances);
+  rs.Count(range, counts);
+  CheckCSRResults(baselineNeighbors, baselineDistances, offsets, neighbors,
+      distances, counts);
+}
+
+/**
+ * The CSR layout and the counts should hold the same results as the nested
+ * vectors, with every search mode and with trees that do and don't rearrange
+ * the dataset.
+ */
+BOOST_AUTO_TEST_CASE(CSRSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 300);
+  const Range range(0.05, 0.2);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    const bool naive = (mode == 0);
+    const bool singleMode = (mode == 1);
+
+    RangeSearch<> kdSearch(referenceData, naive, singleMode);
+    CheckCSRSearch(kdSearch, queryData, range);
+
+    RangeSearch<EuclideanDistance, arma::mat, StandardCoverTree> coverSearch(
+        referenceData, naive, singleMode);
+    CheckCSRSearch(coverSearch, queryData, range);
+
+    RangeSearch<EuclideanDistance, arma::mat, RTree> rSearch(referenceData,
+        naive, singleMode);
+    CheckCSRSearch(rSearch, queryData, range);
+  }
+
+  // Search with a query tree.
+  typedef RangeSearch<>::Tree TreeType;
+  RangeSearch<> rs(referenceData);
+  TreeType queryTree(queryData);
+
+  vector<vector<size_t>> baselineNeighbors;
+  vector<vector<double>> baselineDistances;
+  arma::Col<size_t> offsets, neighbors, counts;
+  arma::vec distances;
+  rs.Search(&queryTree, range, baselineNeighbors, baselineDistances);
+  rs.Search(&queryTree, range, offsets, neighbors, distances);
+  rs.Count(&queryTree, range, counts);
+  CheckCSRResults(baselineNeighbors, baselineDistances, offsets, neighbors,
+      distances, counts);
+}
+
+/**
+ * RSModel should give the same results in CSR layout and as counts as in
+ * nested vectors.
+ */
+BOOST_AUTO_TEST_CASE(RSModelCSRTest)
+{
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+  const Range range(0.25, 0.75);
+
+  const RSModel::TreeTypes treeTypes[] = { RSModel::TreeTypes::KD_TREE,
+      RSModel::TreeTypes::COVER_TREE, RSModel::TreeTypes::BALL_TREE,
+      RSModel::TreeTypes::R_TREE, RSModel::TreeTypes::OCTREE };
+
+  for (size_t t = 0; t < 5; ++t)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      RSModel model(treeTypes[t], false);
+      arma::mat referenceCopy(referenceData);
+      model.BuildModel(std::move(referenceCopy), 5, (j == 2), (j == 1));
+
+      vector<vector<size_t>> baselineNeighbors;
+      vector<vector<double>> baselineDistances;
+      arma::Col<size_t> offsets, neighbors, counts;
+      arma::vec distances;
+
+      arma::mat queryCopy(queryData);
+      model.Search(std::move(queryCopy), range, baselineNeighbors,
+          baselineDistances);
+      queryCopy = queryData;
+      model.Search(std::move(queryCopy), range, offsets, neighbors, distances);
+      queryCopy = queryData;
+      model.Count(std::move(queryCopy), range, counts);
+      CheckCSRResults(baselineNeighbors, baselineDistances, offsets,
+          neighbors, distances, counts);
+
+      model.Search(range, baselineNeighbors, baselineDistances);
+      model.Search(range, offsets, neighbors, distances);
+      model.Count(range, counts);
+      CheckCSRResults(baselineNeighbors, baselineDistances, offsets,
+          neighbors, distances, counts);
+    }
+  }
+}
+
+/**
+ * The header of a saved model can be loaded without the trees.
+ */
+BOOST_AUTO_TEST_CASE(RSModelHeaderTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 200);
+
+  RSModel model(RSModel::TreeTypes::BALL_TREE, true);
+  model.BuildModel(std::move(referenceData), 25, false, false);
+  data::Save("rs_header.bin", "model", model, true);
+
+  RSModelHeader header;
+  BOOST_REQUIRE(data::Load("rs_header.bin", "model", header));
+  BOOST_REQUIRE_EQUAL(header.TreeType(), RSModel::TreeTypes::BALL_TREE);
+  BOOST_REQUIRE_EQUAL(header.LeafSize(), 25);
+  BOOST_REQUIRE_EQUAL(header.RandomBasis(), true);
+  BOOST_REQUIRE_EQUAL(header.Dimensionality(), 4);
+  BOOST_REQUIRE_EQUAL(header.ReferenceSize(), 200);
+
+  // The full model still loads, with its leaf size.
+  RSModel loaded;
+  BOOST_REQUIRE(data::Load("rs_header.bin", "model", loaded));
+  BOOST_REQUIRE_EQUAL(loaded.LeafSize(), 25);
+  CheckMatrices(loaded.Dataset(), model.Dataset());
+
+  remove("rs_header.bin");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
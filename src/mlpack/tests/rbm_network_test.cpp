@@ -208,6 +208,39 @@ BOOST_AUTO_TEST_CASE(ssRBMClassificationTest)
   BOOST_REQUIRE_GE(ssRbmClassificationAccuracy, 76.18);
 }
 
+/*
+ * Make sure that the persistent chains of the BinaryRBM are sampled as one
+ * matrix, and that the gradient stays finite.
+ */
+BOOST_AUTO_TEST_CASE(BinaryRBMPersistentChainsTest)
+{
+  arma::mat trainData;
+  trainData.load("digits_train.arm");
+
+  const size_t batchSize = 10;
+  const size_t numChains = 25;
+  GaussianInitialization gaussian(0, 0.1);
+  RBM<GaussianInitialization> model(trainData, gaussian, trainData.n_rows, 50,
+      batchSize, 1, 1, 2, 8, 1, true, numChains);
+  model.Reset();
+
+  arma::mat output;
+  model.Gibbs(std::move(trainData.cols(0, batchSize - 1)), std::move(output));
+  BOOST_REQUIRE_EQUAL(output.n_rows, trainData.n_rows);
+  BOOST_REQUIRE_EQUAL(output.n_cols, numChains);
+  BOOST_REQUIRE(arma::all(arma::vectorise((output == 0) + (output == 1))));
+
+  arma::mat gradient;
+  model.Gradient(model.Parameters(), 0, gradient, batchSize);
+  BOOST_REQUIRE_EQUAL(gradient.n_elem, model.Parameters().n_elem);
+  BOOST_REQUIRE(arma::is_finite(gradient));
+
+  // Both phases sum over batchSize columns of values in [0, max], since the
+  // chains are scaled to the batch.
+  BOOST_REQUIRE_LE(arma::abs(gradient).max(), 2.0 * batchSize *
+      trainData.max());
+}
+
 template<typename MatType = arma::mat>
 void BuildVanillaNetwork(MatType& trainData,
                          const size_t hiddenLayerSize)
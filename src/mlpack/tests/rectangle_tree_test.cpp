@@ -369,6 +369,61 @@ BOOST_AUTO_TEST_CASE(TreeBalance)
   BOOST_REQUIRE_EQUAL(tree.TreeDepth(), GetMinLevel(tree));
 }
 
+/**
+ * A function to count the leaves of a tree.
+ */
+template<typename TreeType>
+size_t CountLeaves(const TreeType& tree)
+{
+  if (tree.IsLeaf())
+    return 1;
+
+  size_t numLeaves = 0;
+  for (size_t i = 0; i < tree.NumChildren(); i++)
+    numLeaves += CountLeaves(tree.Child(i));
+
+  return numLeaves;
+}
+
+// Make sure that the R tree and the R* tree, which are packed with
+// Sort-Tile-Recursive, are valid, balanced and use as few leaves as possible.
+BOOST_AUTO_TEST_CASE(SortTileRecursiveBuildTest)
+{
+  arma::mat dataset;
+  dataset.randu(3, 10000);
+
+  typedef RTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef RStarTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> StarTreeType;
+
+  TreeType tree(dataset, 20, 6, 5, 2, 0);
+  StarTreeType starTree(dataset, 20, 6, 5, 2, 0);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 10000);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  CheckFills(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+  BOOST_REQUIRE_EQUAL(CountLeaves(tree), 500);
+
+  BOOST_REQUIRE_EQUAL(starTree.NumDescendants(), 10000);
+  CheckExactContainment(starTree);
+  CheckHierarchy(starTree);
+  CheckFills(starTree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(starTree), GetMaxLevel(starTree));
+  BOOST_REQUIRE_EQUAL(CountLeaves(starTree), 500);
+
+  // Every point must be in exactly one leaf.
+  std::vector<size_t> counts(dataset.n_cols, 0);
+  for (size_t i = 0; i < tree.NumDescendants(); i++)
+    counts[tree.Descendant(i)]++;
+  for (size_t i = 0; i < counts.size(); i++)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+}
+
 // A test to see if point deletion is working correctly.  We build a tree, then
 // delete numIter points and test that the query gives correct results.  It is
 // remotely possible that this test will give a false negative if it should
@@ -867,6 +867,190 @@ BOOST_AUTO_TEST_CASE(LSTMBatchSizeTest)
   BatchSizeTest<LSTM<>>();
 }
 
+/**
+ * Make sure the gradient of an LSTM is still right when the batch size changes,
+ * like it does for the last batch of an epoch.
+ */
+BOOST_AUTO_TEST_CASE(LSTMBatchSizeChangeTest)
+{
+  const size_t rho = 5;
+
+  RNN<> model(rho);
+  model.Predictors() = arma::randu(1, 4, rho);
+  model.Responses() = arma::ones(1, 4, rho);
+  model.Add<IdentityLayer<> >();
+  model.Add<Linear<> >(1, 10);
+  model.Add<LSTM<> >(10, 3, rho);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat gradient, batchGradient, firstGradient, secondGradient;
+  model.Gradient(model.Parameters(), 0, gradient, 4);
+
+  // The gradient of a smaller batch is the sum of the gradients of its points.
+  model.Gradient(model.Parameters(), 2, batchGradient, 2);
+  model.Gradient(model.Parameters(), 2, firstGradient, 1);
+  model.Gradient(model.Parameters(), 3, secondGradient, 1);
+  CheckMatrices(batchGradient, arma::mat(firstGradient + secondGradient));
+
+  // Going back to the larger batch must not pick up the state of the smaller
+  // ones.
+  arma::mat newGradient;
+  model.Gradient(model.Parameters(), 0, newGradient, 4);
+  CheckMatrices(gradient, newGradient);
+}
+
+/**
+ * Make sure a trained LSTM can be serialized and trained further.
+ */
+BOOST_AUTO_TEST_CASE(LSTMSerializationTrainTest)
+{
+  const size_t rho = 5;
+  arma::cube input = arma::randu(1, 6, rho);
+  arma::cube labels = arma::ones(1, 6, rho);
+
+  RNN<> model(rho);
+  model.Add<Linear<> >(1, 4);
+  model.Add<LSTM<> >(4, 4, rho);
+  model.Add<Linear<> >(4, 2);
+  model.Add<LogSoftMax<> >();
+
+  // The last batch of each epoch is smaller.
+  StandardSGD opt(0.1, 4, input.n_cols /* 1 epoch */, -100, false);
+  model.Train(input, labels, opt);
+
+  RNN<> xmlModel(rho), textModel(rho), binaryModel(rho);
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  model.Train(input, labels, opt);
+  xmlModel.Train(input, labels, opt);
+  textModel.Train(input, labels, opt);
+  binaryModel.Train(input, labels, opt);
+
+  CheckMatrices(model.Parameters(), xmlModel.Parameters(),
+      textModel.Parameters(), binaryModel.Parameters());
+}
+
+/**
+ * The archive of an LSTM layer from before the weights of the gates were
+ * stored together; the weights and bias of each gate are stored separately, in
+ * the order output gate, forget gate, input gate and hidden layer.
+ */
+struct LegacyLSTM
+{
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    size_t bpttSteps = rho, batchSize = 0, batchStep = 0, forwardStep = 0,
+        backwardStep = 0, gradientStep = 0, gradientStepIdx = 0;
+    arma::mat cell, inputGateActivation, forgetGateActivation,
+        outputGateActivation, hiddenLayerActivation, cellActivation,
+        prevError, outParameter;
+
+    ar & BOOST_SERIALIZATION_NVP(weights);
+    ar & BOOST_SERIALIZATION_NVP(inSize);
+    ar & BOOST_SERIALIZATION_NVP(outSize);
+    ar & BOOST_SERIALIZATION_NVP(rho);
+    ar & BOOST_SERIALIZATION_NVP(bpttSteps);
+    ar & BOOST_SERIALIZATION_NVP(batchSize);
+    ar & BOOST_SERIALIZATION_NVP(batchStep);
+    ar & BOOST_SERIALIZATION_NVP(forwardStep);
+    ar & BOOST_SERIALIZATION_NVP(backwardStep);
+    ar & BOOST_SERIALIZATION_NVP(gradientStep);
+    ar & BOOST_SERIALIZATION_NVP(gradientStepIdx);
+    ar & BOOST_SERIALIZATION_NVP(cell);
+    ar & BOOST_SERIALIZATION_NVP(inputGateActivation);
+    ar & BOOST_SERIALIZATION_NVP(forgetGateActivation);
+    ar & BOOST_SERIALIZATION_NVP(outputGateActivation);
+    ar & BOOST_SERIALIZATION_NVP(hiddenLayerActivation);
+    ar & BOOST_SERIALIZATION_NVP(cellActivation);
+    ar & BOOST_SERIALIZATION_NVP(prevError);
+    ar & BOOST_SERIALIZATION_NVP(outParameter);
+  }
+
+  arma::mat weights;
+  size_t inSize;
+  size_t outSize;
+  size_t rho;
+};
+
+/**
+ * Make sure the weights of an LSTM stored in the old layout are loaded
+ * correctly, by comparing two steps of the loaded layer with the old
+ * implementation of the forward pass.
+ */
+BOOST_AUTO_TEST_CASE(LSTMLegacyWeightsTest)
+{
+  const size_t inSize = 3, outSize = 2;
+
+  LegacyLSTM legacy;
+  legacy.inSize = inSize;
+  legacy.outSize = outSize;
+  legacy.rho = 2;
+  legacy.weights = arma::randu(4 * outSize * inSize + 7 * outSize +
+      4 * outSize * outSize, 1) - 0.5;
+
+  std::stringstream stream;
+  {
+    boost::archive::text_oarchive o(stream);
+    o << BOOST_SERIALIZATION_NVP(legacy);
+  }
+
+  LSTM<> lstm;
+  {
+    boost::archive::text_iarchive i(stream);
+    i >> BOOST_SERIALIZATION_NVP(lstm);
+  }
+
+  lstm.Reset();
+  lstm.ResetCell(2);
+
+  // Split the old weights into the gates; gate 0 is the output gate, gate 1
+  // the forget gate, gate 2 the input gate and gate 3 the hidden layer, and
+  // the peephole connections are in the same order.
+  const arma::mat& w = legacy.weights;
+  const size_t inputBlock = outSize * inSize + outSize;
+  const size_t outputOffset = 4 * inputBlock;
+  const size_t peepholeOffset = outputOffset + 4 * outSize * outSize;
+  std::vector<arma::mat> inputWeight(4), bias(4), outputWeight(4),
+      peephole(3);
+  for (size_t g = 0; g < 4; ++g)
+  {
+    inputWeight[g] = arma::reshape(w.rows(g * inputBlock,
+        g * inputBlock + outSize * inSize - 1), outSize, inSize);
+    bias[g] = w.rows(g * inputBlock + outSize * inSize,
+        (g + 1) * inputBlock - 1);
+    outputWeight[g] = arma::reshape(w.rows(outputOffset +
+        g * outSize * outSize, outputOffset + (g + 1) * outSize * outSize - 1),
+        outSize, outSize);
+  }
+  for (size_t p = 0; p < 3; ++p)
+  {
+    peephole[p] = w.rows(peepholeOffset + p * outSize,
+        peepholeOffset + (p + 1) * outSize - 1);
+  }
+
+  arma::mat h = arma::zeros(outSize, 1), c = arma::zeros(outSize, 1);
+  for (size_t step = 0; step < 2; ++step)
+  {
+    arma::mat x = arma::randu(inSize, 1);
+
+    const arma::mat inputGate = 1.0 / (1.0 + arma::exp(-(inputWeight[2] * x +
+        bias[2] + outputWeight[2] * h + peephole[2] % c)));
+    const arma::mat forgetGate = 1.0 / (1.0 + arma::exp(-(inputWeight[1] * x +
+        bias[1] + outputWeight[1] * h + peephole[1] % c)));
+    const arma::mat hidden = arma::tanh(inputWeight[3] * x + bias[3] +
+        outputWeight[3] * h);
+    c = forgetGate % c + inputGate % hidden;
+    const arma::mat outputGate = 1.0 / (1.0 + arma::exp(-(inputWeight[0] * x +
+        bias[0] + outputWeight[0] * h + peephole[0] % c)));
+    h = outputGate % arma::tanh(c);
+
+    arma::mat output;
+    lstm.Forward(std::move(x), std::move(output));
+    CheckMatrices(output, h);
+  }
+}
+
 /**
  * Ensure fast LSTMs work with larger batch sizes.
  */
@@ -18,7 +18,9 @@
 #include <mlpack/methods/reinforcement_learning/environment/cart_pole.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/acrobat.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/pendulum.hpp>
+#include <mlpack/methods/reinforcement_learning/vector_environment.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/prioritized_replay.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -118,6 +120,48 @@ BOOST_AUTO_TEST_CASE(SimpleCartPoleTest)
   BOOST_REQUIRE_EQUAL(2, CartPole::Action::size);
 }
 
+/**
+ * Step a vector of Cart Pole instances and check that each instance follows
+ * the dynamics of a single environment and restarts when its episode ends.
+ */
+BOOST_AUTO_TEST_CASE(VectorEnvironmentTest)
+{
+  VectorEnvironment<CartPole> environments(4, 5);
+  BOOST_REQUIRE_EQUAL(environments.Size(), 4);
+  BOOST_REQUIRE_EQUAL(environments.Encode().n_rows, CartPole::State::dimension);
+  BOOST_REQUIRE_EQUAL(environments.Encode().n_cols, 4);
+
+  CartPole env;
+  std::vector<CartPole::Action> actions(4, CartPole::Action::forward);
+  actions[1] = CartPole::Action::backward;
+  arma::colvec rewards;
+  arma::icolvec isTerminal;
+  for (size_t step = 0; step < 12; ++step)
+  {
+    const arma::mat encoded = environments.Encode();
+    environments.Sample(actions, rewards, isTerminal);
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+      CheckMatrices(environments.PreviousStates()[i].Encode(),
+          arma::mat(encoded.col(i)));
+
+      CartPole::State nextState;
+      const double reward = env.Sample(environments.PreviousStates()[i],
+          actions[i], nextState);
+      BOOST_REQUIRE_CLOSE(rewards[i], reward, 1e-5);
+      CheckMatrices(environments.NextStates()[i].Encode(), nextState.Encode());
+      BOOST_REQUIRE_EQUAL(isTerminal[i], env.IsTerminal(nextState));
+
+      CheckMatrices(arma::mat(environments.Encode().col(i)),
+          environments.States()[i].Encode());
+    }
+  }
+
+  // Every instance reached the step limit twice.
+  BOOST_REQUIRE_GE(environments.EpisodeReturns().size(), 8);
+}
+
 /**
  * Construct a random replay instance and check if it works as
  * it should be.
@@ -166,6 +210,113 @@ BOOST_AUTO_TEST_CASE(RandomReplayTest)
   }
 }
 
+/**
+ * Check that the sum tree keeps the sums of its elements and finds the element
+ * at which a prefix sum is reached.
+ */
+BOOST_AUTO_TEST_CASE(SumTreeTest)
+{
+  // A size that isn't a power of two leaves some padding leaves.
+  SumTree tree(5);
+  const arma::vec values("1.0 0.0 2.0 3.0 0.5");
+  for (size_t i = 0; i < values.n_elem; ++i)
+    tree.Set(i, values[i]);
+
+  BOOST_REQUIRE_CLOSE(tree.Sum(), 6.5, 1e-10);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(0.0), 0);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(0.99), 0);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(1.0), 2);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(2.99), 2);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(3.0), 3);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(6.2), 4);
+
+  // A mass beyond the total must not reach the padding leaves.
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(10.0), 4);
+
+  tree.Set(3, 0.0);
+  BOOST_REQUIRE_CLOSE(tree.Sum(), 3.5, 1e-10);
+  BOOST_REQUIRE_CLOSE(tree.Get(2), 2.0, 1e-10);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(3.0), 4);
+}
+
+/**
+ * Construct a prioritized replay instance and check that transitions are
+ * sampled in proportion to their priorities, and that the importance sampling
+ * weights scale the update targets.
+ */
+BOOST_AUTO_TEST_CASE(PrioritizedReplayTest)
+{
+  // Use full prioritization and fixed, full importance sampling correction.
+  PrioritizedReplay<MountainCar> replay(100, 4, 1.0, 1.0, 1, 0.0);
+  MountainCar env;
+  MountainCar::State state = env.InitialSample();
+  MountainCar::Action action = MountainCar::Action::forward;
+  MountainCar::State nextState;
+  env.Sample(state, action, nextState);
+
+  // The reward of each transition is its index.
+  for (size_t i = 0; i < 4; ++i)
+    replay.Store(state, action, i, nextState, false);
+
+  BOOST_REQUIRE_EQUAL(4, replay.Size());
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+
+  // All new transitions have the same priority, so the weights are all one.
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+  BOOST_REQUIRE_EQUAL(sampledState.n_cols, 100);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(replay.Weights()[i], 1.0, 1e-5);
+    BOOST_REQUIRE_CLOSE(sampledReward[i], replay.SampledIndices()[i], 1e-5);
+  }
+
+  // Give transition i the error i, so transition 0 is never sampled again.
+  arma::colvec tdErrors(100);
+  for (size_t i = 0; i < 100; ++i)
+    tdErrors[i] = sampledReward[i];
+  arma::mat target(MountainCar::Action::size, 100, arma::fill::zeros);
+  replay.Update(tdErrors, sampledAction, target);
+
+  BOOST_REQUIRE_CLOSE(replay.Priority(3), 3.0, 1e-5);
+  BOOST_REQUIRE_SMALL(replay.Priority(0), 1e-5);
+
+  arma::vec counts(4, arma::fill::zeros);
+  for (size_t trial = 0; trial < 100; ++trial)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward,
+        sampledNextState, sampledTerminal);
+    for (size_t i = 0; i < 100; ++i)
+    {
+      const size_t index = replay.SampledIndices()[i];
+      counts[index]++;
+
+      // With beta = 1 the weight is inversely proportional to the priority.
+      BOOST_REQUIRE_CLOSE(replay.Weights()[i], 1.0 / index, 1e-5);
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(counts[0], 0);
+  BOOST_REQUIRE_CLOSE(counts[1] / 10000, 1.0 / 6.0, 10);
+  BOOST_REQUIRE_CLOSE(counts[2] / 10000, 2.0 / 6.0, 10);
+  BOOST_REQUIRE_CLOSE(counts[3] / 10000, 3.0 / 6.0, 10);
+
+  // The target of each transition is moved by the weighted error.
+  tdErrors.ones();
+  target.zeros();
+  replay.Update(tdErrors, sampledAction, target);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(target(sampledAction[i], i) + 1.0,
+        replay.Weights()[i], 1e-5);
+  }
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/optimizers/sa/sa.hpp>
+#include <mlpack/core/optimizers/sa/parallel_tempering_sa.hpp>
 #include <mlpack/core/optimizers/sa/exponential_schedule.hpp>
 #include <mlpack/core/optimizers/problems/generalized_rosenbrock_function.hpp>
 #include <mlpack/core/optimizers/problems/rosenbrock_function.hpp>
@@ -110,4 +111,55 @@ BOOST_AUTO_TEST_CASE(RastrigrinFunctionTest)
   BOOST_REQUIRE_GE(successes, 1);
 }
 
+/**
+ * Run parallel tempering on the Rastrigin function, with the chains in
+ * parallel; the exchanges should let the cold chains escape the local minima.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTemperingRastriginTest)
+{
+  size_t successes = 0;
+
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    RastriginFunction f(2);
+    ExponentialSchedule schedule;
+    ParallelTemperingSA<> pt(schedule, 4, 0.3, 100, 2000000, 100, 50, 1000,
+        1e-12, 2, 2.0, 0.5, 0.1, PARALLEL_COPY_EVALUATION);
+    arma::mat coordinates = f.GetInitialPoint();
+
+    const double result = pt.Optimize(f, coordinates);
+    BOOST_REQUIRE_GT(pt.ProposedSwaps(), 0);
+    BOOST_REQUIRE_LE(pt.AcceptedSwaps(), pt.ProposedSwaps());
+
+    // The returned point is the best one found.
+    BOOST_REQUIRE_CLOSE(result, f.Evaluate(coordinates), 1e-10);
+
+    if ((std::abs(result) < 1e-3) &&
+        (std::abs(coordinates[0]) < 1e-3) &&
+        (std::abs(coordinates[1]) < 1e-3))
+    {
+      ++successes;
+      break; // No need to continue.
+    }
+  }
+
+  BOOST_REQUIRE_GE(successes, 1);
+}
+
+/**
+ * Make sure that invalid ladders are rejected.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTemperingInvalidTest)
+{
+  RosenbrockFunction f;
+  ExponentialSchedule schedule;
+  arma::mat coordinates = f.GetInitialPoint();
+
+  ParallelTemperingSA<> noChains(schedule, 0);
+  BOOST_REQUIRE_THROW(noChains.Optimize(f, coordinates), std::invalid_argument);
+
+  ParallelTemperingSA<> badRatio(schedule, 4, 1.5);
+  BOOST_REQUIRE_THROW(badRatio.Optimize(f, coordinates), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,179 @@
+/**
+ * @file scaling_test.cpp
+ *
+ * Tests for the scaler classes and the single-pass computation of the moments
+ * of a dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/data/moments.hpp>
+#include <mlpack/core/data/scaler_methods/min_max_scaler.hpp>
+#include <mlpack/core/data/scaler_methods/standard_scaler.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+BOOST_AUTO_TEST_SUITE(ScalingTest);
+
+/**
+ * Make sure the single-pass moments match the ones computed with several
+ * passes, for datasets that are split between threads.
+ */
+BOOST_AUTO_TEST_CASE(ComputeMomentsTest)
+{
+  arma::mat data = arma::exp(arma::randn<arma::mat>(4, 10000));
+  data.row(2) += 1e6; // The moments must be robust to a large mean.
+
+  std::vector<Moments> moments;
+  ComputeMoments(data, moments);
+  BOOST_REQUIRE_EQUAL(moments.size(), 4);
+
+  for (size_t j = 0; j < 4; ++j)
+  {
+    const arma::rowvec feature = data.row(j);
+    const double mean = arma::mean(feature);
+    const arma::rowvec deviations = feature - mean;
+    const double n = feature.n_elem;
+    const double m2 = arma::accu(arma::pow(deviations, 2));
+    const double m3 = arma::accu(arma::pow(deviations, 3));
+    const double m4 = arma::accu(arma::pow(deviations, 4));
+
+    BOOST_REQUIRE_EQUAL(moments[j].Count(), 10000);
+    BOOST_REQUIRE_CLOSE(moments[j].Mean(), mean, 1e-8);
+    BOOST_REQUIRE_CLOSE(moments[j].Variance(), arma::var(feature), 1e-4);
+    BOOST_REQUIRE_CLOSE(moments[j].Variance(true), arma::var(feature, 1),
+        1e-4);
+    BOOST_REQUIRE_EQUAL(moments[j].Min(), arma::min(feature));
+    BOOST_REQUIRE_EQUAL(moments[j].Max(), arma::max(feature));
+    BOOST_REQUIRE_CLOSE(moments[j].Skewness(true),
+        m3 / (n * std::pow(m2 / n, 1.5)), 1e-3);
+    BOOST_REQUIRE_CLOSE(moments[j].Kurtosis(true), n * m4 / (m2 * m2) - 3,
+        1e-3);
+  }
+
+  // The moments of each point.
+  ComputeMoments(data, moments, true);
+  BOOST_REQUIRE_EQUAL(moments.size(), 10000);
+  for (size_t i = 0; i < data.n_cols; i += 1000)
+  {
+    BOOST_REQUIRE_CLOSE(moments[i].Mean(), arma::mean(data.col(i)), 1e-8);
+    BOOST_REQUIRE_CLOSE(moments[i].Variance(), arma::var(data.col(i)), 1e-6);
+  }
+}
+
+/**
+ * Merging two accumulators gives the same moments as accumulating all the
+ * values in one.
+ */
+BOOST_AUTO_TEST_CASE(MomentsMergeTest)
+{
+  const arma::vec values = arma::randu<arma::vec>(1000);
+
+  Moments all, first, second;
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    all.Add(values[i]);
+    if (i < 300)
+      first.Add(values[i]);
+    else
+      second.Add(values[i]);
+  }
+  first.Merge(second);
+
+  BOOST_REQUIRE_EQUAL(first.Count(), all.Count());
+  BOOST_REQUIRE_CLOSE(first.Mean(), all.Mean(), 1e-10);
+  BOOST_REQUIRE_CLOSE(first.Variance(), all.Variance(), 1e-8);
+  BOOST_REQUIRE_CLOSE(first.Skewness(), all.Skewness(), 1e-6);
+  BOOST_REQUIRE_CLOSE(first.Kurtosis(), all.Kurtosis(), 1e-6);
+  BOOST_REQUIRE_EQUAL(first.Min(), all.Min());
+  BOOST_REQUIRE_EQUAL(first.Max(), all.Max());
+}
+
+/**
+ * Make sure the MinMaxScaler scales to the requested range and back, also in
+ * place.
+ */
+BOOST_AUTO_TEST_CASE(MinMaxScalerTest)
+{
+  arma::mat data = arma::randn<arma::mat>(5, 5000);
+  data.row(3).fill(2.0); // A constant dimension is only shifted.
+
+  MinMaxScaler scaler(-1, 3);
+  scaler.Fit(data);
+
+  arma::mat scaled;
+  scaler.Transform(data, scaled);
+  for (size_t j = 0; j < 5; ++j)
+  {
+    if (j == 3)
+      continue;
+
+    BOOST_REQUIRE_CLOSE(arma::min(scaled.row(j)), -1.0, 1e-8);
+    BOOST_REQUIRE_CLOSE(arma::max(scaled.row(j)), 3.0, 1e-8);
+  }
+  for (size_t i = 0; i < scaled.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(scaled(3, i), -1.0, 1e-8);
+
+  arma::mat inPlace = data;
+  scaler.Transform(inPlace, inPlace);
+  CheckMatrices(inPlace, scaled);
+
+  arma::mat reverted;
+  scaler.InverseTransform(scaled, reverted);
+  CheckMatrices(reverted, data);
+}
+
+/**
+ * Make sure the StandardScaler centers and scales each dimension, also in
+ * place.
+ */
+BOOST_AUTO_TEST_CASE(StandardScalerTest)
+{
+  arma::mat data = 3 * arma::randn<arma::mat>(5, 5000) + 10;
+
+  StandardScaler scaler;
+  scaler.Fit(data);
+
+  arma::mat scaled;
+  scaler.Transform(data, scaled);
+  for (size_t j = 0; j < 5; ++j)
+  {
+    BOOST_REQUIRE_SMALL(arma::mean(scaled.row(j)), 1e-10);
+    BOOST_REQUIRE_CLOSE(arma::stddev(scaled.row(j), 1), 1.0, 1e-8);
+  }
+
+  arma::mat inPlace = data;
+  scaler.Transform(inPlace, inPlace);
+  CheckMatrices(inPlace, scaled);
+
+  scaler.InverseTransform(inPlace, inPlace);
+  CheckMatrices(inPlace, data);
+}
+
+/**
+ * A scaler can't transform data with another number of dimensions.
+ */
+BOOST_AUTO_TEST_CASE(ScalerDimensionTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 100);
+  arma::mat other = arma::randu<arma::mat>(3, 100);
+  arma::mat output;
+
+  MinMaxScaler minMax;
+  minMax.Fit(data);
+  BOOST_REQUIRE_THROW(minMax.Transform(other, output), std::invalid_argument);
+
+  StandardScaler standard;
+  standard.Fit(data);
+  BOOST_REQUIRE_THROW(standard.Transform(other, output),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -13,6 +13,7 @@
 #include <mlpack/core/optimizers/scd/scd.hpp>
 #include <mlpack/core/optimizers/scd/descent_policies/greedy_descent.hpp>
 #include <mlpack/core/optimizers/scd/descent_policies/cyclic_descent.hpp>
+#include <mlpack/core/optimizers/scd/descent_policies/lazy_greedy_descent.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/sparse_test_function.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression_function.hpp>
 #include <mlpack/methods/softmax_regression/softmax_regression_function.hpp>
@@ -96,6 +97,93 @@ BOOST_AUTO_TEST_CASE(GreedyDescentTest)
   BOOST_REQUIRE_EQUAL(descentPolicy.DescentFeature(0, point, f), 1);
 }
 
+/**
+ * The lazy greedy descent policy should pick the same features as the greedy
+ * descent policy.
+ */
+BOOST_AUTO_TEST_CASE(LazyGreedyDescentTest)
+{
+  arma::mat point("1; 2; 3; 4;");
+
+  SparseTestFunction f;
+
+  LazyGreedyDescent descentPolicy;
+  BOOST_REQUIRE_EQUAL(descentPolicy.DescentFeature(0, point, f), 2);
+
+  // The magnitude of the other features is only refreshed when they reach the
+  // top of the heap, so rebuild it for the new point.
+  point[1] = 10;
+  LazyGreedyDescent rebuildingPolicy(1);
+  BOOST_REQUIRE_EQUAL(rebuildingPolicy.DescentFeature(0, point, f), 1);
+}
+
+/**
+ * SCD with the lazy greedy descent policy should find the minimum of the
+ * sparse test function, whose features don't interact.
+ */
+BOOST_AUTO_TEST_CASE(LazyGreedyDescentSCDTest)
+{
+  SparseTestFunction f;
+  SCD<LazyGreedyDescent> s(0.4);
+
+  arma::mat iterate = f.GetInitialPoint();
+  double result = s.Optimize(f, iterate);
+
+  BOOST_REQUIRE_CLOSE(result, 123.75, 0.01);
+  BOOST_REQUIRE_CLOSE(iterate[0], 2, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[1], 1, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[2], 1.5, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[3], 4, 0.02);
+}
+
+/**
+ * Shotgun should find the minimum of the sparse test function when all the
+ * features are updated at once, since they don't interact.
+ */
+BOOST_AUTO_TEST_CASE(ShotgunDisjointFeatureTest)
+{
+  SparseTestFunction f;
+  SCD<CyclicDescent> s(0.4, 100000, 1e-5, 1e3, CyclicDescent(), 4);
+
+  arma::mat iterate = f.GetInitialPoint();
+  double result = s.Optimize(f, iterate);
+
+  BOOST_REQUIRE_CLOSE(result, 123.75, 0.01);
+  BOOST_REQUIRE_CLOSE(iterate[0], 2, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[1], 1, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[2], 1.5, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[3], 4, 0.02);
+}
+
+/**
+ * Run Shotgun on the logistic regression problem of PreCalcSCDTest, with the
+ * number of parallel updates given by ShotgunParallelism().
+ */
+BOOST_AUTO_TEST_CASE(ShotgunPreCalcSCDTest)
+{
+  arma::mat predictors("0 0 0.4; 0 0 0.6; 0 0.3 0; 0.2 0 0; 0.2 -0.5 0;");
+  arma::Row<size_t> responses("1  1  0;");
+
+  // Orthogonal features can all be updated at once; identical features can't.
+  BOOST_REQUIRE_EQUAL(SCD<>::ShotgunParallelism(arma::mat(arma::eye(5, 5))),
+      5);
+  BOOST_REQUIRE_LE(SCD<>::ShotgunParallelism(arma::mat(5, 3,
+      arma::fill::ones)), 2);
+
+  const size_t parallelism = SCD<>::ShotgunParallelism(predictors);
+  BOOST_REQUIRE_GE(parallelism, 1);
+  BOOST_REQUIRE_LE(parallelism, 5);
+
+  LogisticRegressionFunction<arma::mat> f(predictors, responses, 0.0001);
+
+  SCD<> s(0.02, 60000, 1e-5, 1e3, RandomDescent(), parallelism);
+  arma::mat iterate = f.InitialPoint();
+
+  double objective = s.Optimize(f, iterate);
+
+  BOOST_REQUIRE_LE(objective, 0.055);
+}
+
 /**
  * Test the cyclic descent policy.
  */
@@ -193,7 +281,7 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionPartialGradientTest)
 
   // 2 objects for 2 terms in the cost function. Each term contributes towards
   // the gradient and thus need to be checked independently.
-  SoftmaxRegressionFunction srf(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0);
 
   // Create a random set of parameters.
   arma::mat parameters;
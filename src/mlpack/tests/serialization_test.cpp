@@ -23,6 +23,8 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/flat_tree.hpp>
+#include <mlpack/core/tree/prefetching_single_tree_traverser.hpp>
 
 #include <mlpack/methods/perceptron/perceptron.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
@@ -32,6 +34,10 @@
 #include <mlpack/methods/naive_bayes/naive_bayes_classifier.hpp>
 #include <mlpack/methods/rann/ra_search.hpp>
 #include <mlpack/methods/lsh/lsh_search.hpp>
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/neighbor_search/ivf_search.hpp>
+#include <mlpack/methods/kde/kde_model.hpp>
+#include <mlpack/methods/random_fourier_features/random_fourier_features.hpp>
 #include <mlpack/methods/decision_stump/decision_stump.hpp>
 #include <mlpack/methods/lars/lars.hpp>
 #include <mlpack/methods/ann/rbm/rbm.hpp>
@@ -757,6 +763,192 @@ BOOST_AUTO_TEST_CASE(RectangleTreeOverwriteTest)
   }
 }
 
+// Make sure that the bounds of every node of two trees are the same.
+template<typename TreeType>
+void CheckFlatTreeBounds(TreeType& tree, TreeType& flatTree)
+{
+  BOOST_REQUIRE_EQUAL(tree.Bound().Dim(), flatTree.Bound().Dim());
+  for (size_t d = 0; d < tree.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_CLOSE(tree.Bound()[d].Lo(), flatTree.Bound()[d].Lo(), 1e-8);
+    BOOST_REQUIRE_CLOSE(tree.Bound()[d].Hi(), flatTree.Bound()[d].Hi(), 1e-8);
+  }
+
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    CheckFlatTreeBounds(tree.Child(i), flatTree.Child(i));
+}
+
+/**
+ * Save a kd-tree in the flat layout, map it, and make sure the tree and the
+ * search results are the same.
+ */
+BOOST_AUTO_TEST_CASE(FlatBinarySpaceTreeTest)
+{
+  using neighbor::KNN;
+  arma::mat data = arma::randu<arma::mat>(5, 2000);
+  std::vector<size_t> oldFromNew;
+  KNN::Tree tree(data, oldFromNew);
+
+  SaveFlat("flat_tree.bin", tree, oldFromNew);
+
+  {
+    MappedTree<KNN::Tree> mapped("flat_tree.bin");
+    CheckTrees(tree, mapped.Tree(), mapped.Tree(), mapped.Tree());
+    CheckFlatTreeBounds(tree, mapped.Tree());
+    BOOST_REQUIRE(mapped.OldFromNew() == oldFromNew);
+
+    arma::mat querySet = arma::randu<arma::mat>(5, 500);
+    arma::mat distances, flatDistances;
+    arma::Mat<size_t> neighbors, flatNeighbors;
+
+    KNN knn(tree.Dataset(), NAIVE_MODE);
+    knn.Search(querySet, 5, neighbors, distances);
+
+    KNN flatKnn(std::move(mapped.Tree()));
+    flatKnn.Search(querySet, 5, flatNeighbors, flatDistances);
+
+    CheckMatrices(neighbors, flatNeighbors);
+    CheckMatrices(distances, flatDistances);
+  }
+
+  remove("flat_tree.bin");
+}
+
+/**
+ * Search a mapped kd-tree with the prefetching single-tree traverser, and make
+ * sure the results are the same as with a naive search.
+ */
+BOOST_AUTO_TEST_CASE(FlatTreePrefetchingSearchTest)
+{
+  using neighbor::KNN;
+  arma::mat data = arma::randu<arma::mat>(5, 2000);
+  KNN::Tree tree(data);
+
+  SaveFlat("flat_tree.bin", tree);
+
+  {
+    MappedTree<KNN::Tree> mapped("flat_tree.bin");
+
+    arma::mat querySet = arma::randu<arma::mat>(5, 200);
+    arma::mat distances, flatDistances;
+    arma::Mat<size_t> neighbors, flatNeighbors;
+
+    KNN knn(tree.Dataset(), NAIVE_MODE);
+    knn.Search(querySet, 5, neighbors, distances);
+
+    NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, KDTree,
+        KNN::Tree::DualTreeTraverser, PrefetchingSingleTreeTraverser>
+        flatKnn(std::move(mapped.Tree()), SINGLE_TREE_MODE);
+    flatKnn.Search(querySet, 5, flatNeighbors, flatDistances);
+
+    CheckMatrices(neighbors, flatNeighbors);
+    CheckMatrices(distances, flatDistances);
+  }
+
+  remove("flat_tree.bin");
+}
+
+/**
+ * Save a ball tree in the flat layout and map it.
+ */
+BOOST_AUTO_TEST_CASE(FlatBallTreeTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 500);
+  typedef BallTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(data);
+
+  SaveFlat("flat_tree.bin", tree);
+
+  {
+    MappedTree<TreeType> mapped("flat_tree.bin");
+    CheckTrees(tree, mapped.Tree(), mapped.Tree(), mapped.Tree());
+    CheckFlatTreeBounds(tree, mapped.Tree());
+    BOOST_REQUIRE_EQUAL(mapped.OldFromNew().size(), 0);
+  }
+
+  remove("flat_tree.bin");
+}
+
+/**
+ * Save a cover tree in the flat layout and map it.
+ */
+BOOST_AUTO_TEST_CASE(FlatCoverTreeTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 500);
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+  TreeType tree(data);
+
+  SaveFlat("flat_tree.bin", tree);
+
+  {
+    MappedTree<TreeType> mapped("flat_tree.bin");
+    CheckTrees(tree, mapped.Tree(), mapped.Tree(), mapped.Tree());
+
+    std::stack<TreeType*> stack, flatStack;
+    stack.push(&tree);
+    flatStack.push(&mapped.Tree());
+    while (!stack.empty())
+    {
+      TreeType* node = stack.top();
+      TreeType* flatNode = flatStack.top();
+      stack.pop();
+      flatStack.pop();
+
+      BOOST_REQUIRE_EQUAL(node->Scale(), flatNode->Scale());
+      BOOST_REQUIRE_CLOSE(node->Base(), flatNode->Base(), 1e-5);
+
+      for (size_t i = 0; i < node->NumChildren(); ++i)
+      {
+        stack.push(&node->Child(i));
+        flatStack.push(&flatNode->Child(i));
+      }
+    }
+  }
+
+  remove("flat_tree.bin");
+}
+
+/**
+ * Make sure that a flat tree can't be loaded as a different type of tree, and
+ * that corrupt files are rejected.
+ */
+BOOST_AUTO_TEST_CASE(FlatTreeInvalidFileTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 100);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  typedef BallTree<EuclideanDistance, EmptyStatistic, arma::mat> OtherType;
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::fmat> FloatType;
+  TreeType tree(data);
+
+  SaveFlat("flat_tree.bin", tree);
+  BOOST_REQUIRE_THROW(MappedTree<OtherType>("flat_tree.bin"),
+      std::runtime_error);
+  BOOST_REQUIRE_THROW(MappedTree<FloatType>("flat_tree.bin"),
+      std::runtime_error);
+
+  // Cut the file in the middle of the dataset.
+  std::ifstream in("flat_tree.bin", std::ios::binary);
+  std::vector<char> contents((std::istreambuf_iterator<char>(in)),
+      std::istreambuf_iterator<char>());
+  in.close();
+
+  std::ofstream out("flat_tree.bin", std::ios::binary | std::ios::trunc);
+  out.write(contents.data(), contents.size() - 8 * data.n_rows);
+  out.close();
+  BOOST_REQUIRE_THROW(MappedTree<TreeType>("flat_tree.bin"),
+      std::runtime_error);
+
+  // Not a flat tree at all.
+  out.open("flat_tree.bin", std::ios::trunc);
+  out << "1, 2, 3" << std::endl;
+  out.close();
+  BOOST_REQUIRE_THROW(MappedTree<TreeType>("flat_tree.bin"),
+      std::runtime_error);
+
+  remove("flat_tree.bin");
+}
+
 BOOST_AUTO_TEST_CASE(PerceptronTest)
 {
   // Create a perceptron.  Train it randomly.  Then check that it hasn't
@@ -772,7 +964,7 @@ BOOST_AUTO_TEST_CASE(PerceptronTest)
       labels[i] = 1;
   }
 
-  Perceptron<> p(data, labels, 2, 15);
+  Perceptron<> p(data, labels, 2, 15, 10);
 
   Perceptron<> pXml(2, 3), pText(2, 3), pBinary(2, 3);
   SerializeObjectAll(p, pXml, pText, pBinary);
@@ -785,6 +977,9 @@ BOOST_AUTO_TEST_CASE(PerceptronTest)
   BOOST_REQUIRE_EQUAL(p.MaxIterations(), pXml.MaxIterations());
   BOOST_REQUIRE_EQUAL(p.MaxIterations(), pText.MaxIterations());
   BOOST_REQUIRE_EQUAL(p.MaxIterations(), pBinary.MaxIterations());
+  BOOST_REQUIRE_EQUAL(p.BatchSize(), pXml.BatchSize());
+  BOOST_REQUIRE_EQUAL(p.BatchSize(), pText.BatchSize());
+  BOOST_REQUIRE_EQUAL(p.BatchSize(), pBinary.BatchSize());
 }
 
 BOOST_AUTO_TEST_CASE(LogisticRegressionTest)
@@ -1235,16 +1430,110 @@ BOOST_AUTO_TEST_CASE(LSHTest)
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), textLsh.BucketSize());
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), binaryLsh.BucketSize());
 
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      xmlLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      textLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      binaryLsh.SecondHashTable().size());
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      textLsh.BucketOffsets(), binaryLsh.BucketOffsets());
+
+  // SecondHashTable() builds a copy of the table.
+  const std::vector<arma::Col<size_t>> table = lsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> xmlTable = xmlLsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> textTable = textLsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> binaryTable =
+      binaryLsh.SecondHashTable();
 
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      textLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  BOOST_REQUIRE_EQUAL(table.size(), xmlTable.size());
+  BOOST_REQUIRE_EQUAL(table.size(), textTable.size());
+  BOOST_REQUIRE_EQUAL(table.size(), binaryTable.size());
+
+  for (size_t i = 0; i < table.size(); ++i)
+    CheckMatrices(table[i], xmlTable[i], textTable[i], binaryTable[i]);
+}
+
+/**
+ * Test that an HNSW model can be serialized and deserialized, and gives the
+ * same results afterwards.
+ */
+BOOST_AUTO_TEST_CASE(HNSWTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+  arma::mat queryData = arma::randu<arma::mat>(10, 20);
+
+  HNSWSearch<> hnsw(referenceData, 8, 50, 30);
+
+  HNSWSearch<> xmlHnsw;
+  arma::mat textData = arma::randu<arma::mat>(5, 50);
+  HNSWSearch<> textHnsw(textData, 4, 10);
+  HNSWSearch<> binaryHnsw(referenceData, 12, 20);
+
+  SerializeObjectAll(hnsw, xmlHnsw, textHnsw, binaryHnsw);
+
+  CheckMatrices(hnsw.ReferenceSet(), xmlHnsw.ReferenceSet(),
+      textHnsw.ReferenceSet(), binaryHnsw.ReferenceSet());
+
+  BOOST_REQUIRE_EQUAL(hnsw.M(), xmlHnsw.M());
+  BOOST_REQUIRE_EQUAL(hnsw.M(), textHnsw.M());
+  BOOST_REQUIRE_EQUAL(hnsw.M(), binaryHnsw.M());
+  BOOST_REQUIRE_EQUAL(hnsw.EfSearch(), xmlHnsw.EfSearch());
+  BOOST_REQUIRE_EQUAL(hnsw.EfSearch(), textHnsw.EfSearch());
+  BOOST_REQUIRE_EQUAL(hnsw.EfSearch(), binaryHnsw.EfSearch());
+  BOOST_REQUIRE_EQUAL(hnsw.EntryPoint(), xmlHnsw.EntryPoint());
+  BOOST_REQUIRE_EQUAL(hnsw.EntryPoint(), textHnsw.EntryPoint());
+  BOOST_REQUIRE_EQUAL(hnsw.EntryPoint(), binaryHnsw.EntryPoint());
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+
+  hnsw.Search(queryData, 5, neighbors, distances);
+  xmlHnsw.Search(queryData, 5, xmlNeighbors, xmlDistances);
+  textHnsw.Search(queryData, 5, textNeighbors, textDistances);
+  binaryHnsw.Search(queryData, 5, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
+
+/**
+ * Test that an IVF index, with and without quantized residuals, gives the same
+ * results after it is serialized and deserialized.
+ */
+BOOST_AUTO_TEST_CASE(IVFSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(6, 500);
+  arma::mat queryData = arma::randu<arma::mat>(6, 20);
+
+  for (size_t q = 0; q < 2; ++q)
+  {
+    IVFSearch<> ivf(referenceData, 10, (q == 1), 3);
+
+    IVFSearch<> xmlIvf;
+    IVFSearch<> textIvf(arma::randu<arma::mat>(6, 50), 2);
+    IVFSearch<> binaryIvf(referenceData, 5, (q == 0));
+
+    SerializeObjectAll(ivf, xmlIvf, textIvf, binaryIvf);
+
+    CheckMatrices(ivf.Centroids(), xmlIvf.Centroids(), textIvf.Centroids(),
+        binaryIvf.Centroids());
+    CheckMatrices(ivf.ListOffsets(), xmlIvf.ListOffsets(),
+        textIvf.ListOffsets(), binaryIvf.ListOffsets());
+    CheckMatrices(ivf.Indices(), xmlIvf.Indices(), textIvf.Indices(),
+        binaryIvf.Indices());
+    BOOST_REQUIRE_EQUAL(xmlIvf.Quantized(), (q == 1));
+    BOOST_REQUIRE_EQUAL(textIvf.Quantized(), (q == 1));
+    BOOST_REQUIRE_EQUAL(binaryIvf.Quantized(), (q == 1));
+    BOOST_REQUIRE_EQUAL(xmlIvf.NProbe(), 3);
+    BOOST_REQUIRE_EQUAL(textIvf.NProbe(), 3);
+    BOOST_REQUIRE_EQUAL(binaryIvf.NProbe(), 3);
+
+    arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+    arma::mat distances, xmlDistances, textDistances, binaryDistances;
+
+    ivf.Search(queryData, 5, neighbors, distances);
+    xmlIvf.Search(queryData, 5, xmlNeighbors, xmlDistances);
+    textIvf.Search(queryData, 5, textNeighbors, textDistances);
+    binaryIvf.Search(queryData, 5, binaryNeighbors, binaryDistances);
+
+    CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+    CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+  }
 }
 
 // Make sure serialization works for the decision stump.
@@ -1784,4 +2073,77 @@ BOOST_AUTO_TEST_CASE(ssRBMTest)
   CheckMatrices(Rbm.Weight(), RbmBinary.Weight());
 }
 
+/**
+ * Test that a KDE model gives the same estimates after it is serialized and
+ * deserialized.
+ */
+BOOST_AUTO_TEST_CASE(KDEModelTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 300);
+  arma::mat queryData = arma::randu<arma::mat>(4, 50);
+
+  kde::KDEModel model(0.4, 0.01, 0.0, kde::KDEModel::EPANECHNIKOV_KERNEL,
+      kde::KDEModel::BALL_TREE);
+  model.BuildModel(arma::mat(referenceData));
+
+  kde::KDEModel xmlModel;
+  kde::KDEModel textModel(2.0);
+  textModel.BuildModel(arma::randu<arma::mat>(4, 30));
+  kde::KDEModel binaryModel(0.1);
+  binaryModel.BuildModel(arma::mat(referenceData));
+
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  BOOST_REQUIRE_EQUAL(xmlModel.Bandwidth(), 0.4);
+  BOOST_REQUIRE_EQUAL(textModel.Bandwidth(), 0.4);
+  BOOST_REQUIRE_EQUAL(binaryModel.Bandwidth(), 0.4);
+  BOOST_REQUIRE_EQUAL(xmlModel.KernelType(),
+      kde::KDEModel::EPANECHNIKOV_KERNEL);
+  BOOST_REQUIRE_EQUAL(textModel.TreeType(), kde::KDEModel::BALL_TREE);
+  BOOST_REQUIRE_EQUAL(binaryModel.Dimensionality(), 4);
+
+  arma::vec estimations, xmlEstimations, textEstimations, binaryEstimations;
+  model.Evaluate(arma::mat(queryData), estimations);
+  xmlModel.Evaluate(arma::mat(queryData), xmlEstimations);
+  textModel.Evaluate(arma::mat(queryData), textEstimations);
+  binaryModel.Evaluate(arma::mat(queryData), binaryEstimations);
+
+  CheckMatrices(estimations, xmlEstimations, textEstimations,
+      binaryEstimations);
+}
+
+/**
+ * Make sure that dense and Fastfood random Fourier features give the same
+ * features after serialization.
+ */
+BOOST_AUTO_TEST_CASE(RandomFourierFeaturesTest)
+{
+  arma::mat data = arma::randu<arma::mat>(6, 100);
+
+  for (size_t f = 0; f < 2; ++f)
+  {
+    kernel::RandomFourierFeatures rff(kernel::LaplacianKernel(2.0), 6, 50,
+        f == 1);
+
+    kernel::RandomFourierFeatures xmlRff;
+    kernel::RandomFourierFeatures textRff(kernel::GaussianKernel(), 3, 10);
+    kernel::RandomFourierFeatures binaryRff(kernel::GaussianKernel(), 6, 20,
+        f == 0);
+
+    SerializeObjectAll(rff, xmlRff, textRff, binaryRff);
+
+    BOOST_REQUIRE_EQUAL(xmlRff.Dimensionality(), 6);
+    BOOST_REQUIRE_EQUAL(textRff.NumFrequencies(), 50);
+    BOOST_REQUIRE_EQUAL(binaryRff.Fastfood(), f == 1);
+
+    arma::mat features, xmlFeatures, textFeatures, binaryFeatures;
+    rff.Transform(data, features);
+    xmlRff.Transform(data, xmlFeatures);
+    textRff.Transform(data, textFeatures);
+    binaryRff.Transform(data, binaryFeatures);
+
+    CheckMatrices(features, xmlFeatures, textFeatures, binaryFeatures);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -58,4 +58,44 @@ BOOST_AUTO_TEST_CASE(GeneralizedRosenbrockTest)
   }
 }
 
+/**
+ * Tests that a run which is interrupted and resumed from its checkpoint,
+ * including the momentum of the update policy, ends at the same point as an
+ * uninterrupted run.
+ */
+BOOST_AUTO_TEST_CASE(CheckpointResumeTest)
+{
+  GeneralizedRosenbrockFunction f(10);
+  const size_t epoch = f.NumFunctions();
+
+  MomentumSGD s(0.0001, 1, 20 * epoch, -1.0, false);
+  arma::mat coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates);
+
+  // The first run stops after 12 epochs, leaving the checkpoint of epoch 10.
+  std::remove("sgd_checkpoint.bin");
+  MomentumSGD interrupted(0.0001, 1, 12 * epoch, -1.0, false);
+  interrupted.Checkpointing() = Checkpoint("sgd_checkpoint.bin", 5);
+  arma::mat resumedCoordinates = f.GetInitialPoint();
+  interrupted.Optimize(f, resumedCoordinates);
+
+  interrupted.MaxIterations() = 20 * epoch;
+  resumedCoordinates = f.GetInitialPoint();
+  interrupted.Optimize(f, resumedCoordinates);
+  std::remove("sgd_checkpoint.bin");
+
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(coordinates[i], resumedCoordinates[i], 1e-10);
+
+  // A checkpoint for an iterate of a different size is an error.
+  interrupted.Checkpointing().Interval() = 1;
+  interrupted.MaxIterations() = 2 * epoch;
+  resumedCoordinates = f.GetInitialPoint();
+  interrupted.Optimize(f, resumedCoordinates);
+  arma::mat wrongSize(5, 1, arma::fill::zeros);
+  BOOST_REQUIRE_THROW(interrupted.Optimize(f, wrongSize),
+      std::invalid_argument);
+  std::remove("sgd_checkpoint.bin");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -12,6 +12,8 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/optimizers/sgdr/snapshot_ensembles.hpp>
 #include <mlpack/core/optimizers/sgdr/snapshot_sgdr.hpp>
+#include <mlpack/core/optimizers/sgdr/stochastic_weight_averaging.hpp>
+#include <mlpack/core/optimizers/sgdr/swa_sgdr.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -130,4 +132,102 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionTest)
   }
 }
 
+/**
+ * Make sure that the running average of stochastic weight averaging is the
+ * average of the snapshots snapshot ensembles keep with the same parameters,
+ * and that the step sizes are the same.
+ */
+BOOST_AUTO_TEST_CASE(StochasticWeightAveragingSnapshotsTest)
+{
+  const double stepSize = 0.5;
+
+  for (size_t restart = 5; restart < 100; restart += 10)
+  {
+    for (size_t mult = 2; mult < 5; ++mult)
+    {
+      double snapshotStepSize = stepSize;
+      double averagingStepSize = stepSize;
+
+      SnapshotEnsembles snapshotEnsembles(restart, double(mult), stepSize,
+          1000, 2);
+      StochasticWeightAveraging averaging(restart, double(mult), stepSize,
+          1000, 2);
+      snapshotEnsembles.EpochBatches() = 10 / (double) 1000;
+      averaging.EpochBatches() = 10 / (double) 1000;
+
+      for (size_t i = 0; i < 1000; ++i)
+      {
+        arma::mat iterate = arma::randu<arma::mat>(3, 2);
+        snapshotEnsembles.Update(iterate, snapshotStepSize, iterate);
+        averaging.Update(iterate, averagingStepSize, iterate);
+        BOOST_REQUIRE_CLOSE(snapshotStepSize, averagingStepSize, 1e-10);
+      }
+
+      BOOST_REQUIRE_EQUAL(averaging.Averaged(),
+          snapshotEnsembles.Snapshots().size());
+
+      arma::mat average = arma::zeros<arma::mat>(3, 2);
+      for (size_t i = 0; i < snapshotEnsembles.Snapshots().size(); ++i)
+        average += snapshotEnsembles.Snapshots()[i];
+      average /= snapshotEnsembles.Snapshots().size();
+
+      CheckMatrices(average, averaging.Average(), 1e-8);
+    }
+  }
+}
+
+/**
+ * Run SGDR with stochastic weight averaging on logistic regression and make
+ * sure the results are acceptable.
+ */
+BOOST_AUTO_TEST_CASE(SWASGDRLogisticRegressionTest)
+{
+  // Generate a two-Gaussian dataset.
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("9.0 9.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(3, 1000);
+  arma::Row<size_t> responses(1000);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    data.col(i) = g1.Random();
+    responses[i] = 0;
+  }
+  for (size_t i = 500; i < 1000; ++i)
+  {
+    data.col(i) = g2.Random();
+    responses[i] = 1;
+  }
+
+  // Create a test set.
+  arma::mat testData(3, 1000);
+  arma::Row<size_t> testResponses(1000);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    testData.col(i) = g1.Random();
+    testResponses[i] = 0;
+  }
+  for (size_t i = 500; i < 1000; ++i)
+  {
+    testData.col(i) = g2.Random();
+    testResponses[i] = 1;
+  }
+
+  for (size_t batchSize = 5; batchSize < 50; batchSize += 15)
+  {
+    SWASGDR<> sgdr(50, 2.0, batchSize, 0.01, 10000, 1e-3);
+    LogisticRegression<> lr(data, responses, sgdr, 0.5);
+
+    // Ensure that the error is close to zero.
+    const double acc = lr.ComputeAccuracy(data, responses);
+    BOOST_REQUIRE_CLOSE(acc, 100.0, 0.3); // 0.3% error tolerance.
+
+    const double testAcc = lr.ComputeAccuracy(testData, testResponses);
+    BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
+
+    // The snapshots are not kept once they are averaged.
+    BOOST_REQUIRE(sgdr.Average().is_empty());
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -39,7 +39,7 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionEvaluate)
     labels(i) = math::RandInt(0, numClasses);
 
   // Create a SoftmaxRegressionFunction. Regularization term ignored.
-  SoftmaxRegressionFunction srf(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -84,9 +84,9 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionRegularizationEvaluate)
     labels(i) = math::RandInt(0, numClasses);
 
   // 3 objects for comparing regularization costs.
-  SoftmaxRegressionFunction srfNoReg(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srfSmallReg(data, labels, numClasses, 1);
-  SoftmaxRegressionFunction srfBigReg(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srfNoReg(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srfSmallReg(data, labels, numClasses, 1);
+  SoftmaxRegressionFunction<> srfBigReg(data, labels, numClasses, 20);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -126,8 +126,8 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionGradient)
 
   // 2 objects for 2 terms in the cost function. Each term contributes towards
   // the gradient and thus need to be checked independently.
-  SoftmaxRegressionFunction srf1(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srf2(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srf1(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf2(data, labels, numClasses, 20);
 
   // Create a random set of parameters.
   arma::mat parameters;
@@ -669,4 +669,103 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionComputeProbabilitiesAndLabelsTest)
   }
 }
 
+/**
+ * Make sure that the sparse gradient of a batch is the same as the dense one,
+ * for sparse and dense data.
+ */
+template<typename MatType>
+void CheckSoftmaxSparseGradient(const MatType& dataset,
+                                const arma::Row<size_t>& labels,
+                                const double lambda,
+                                const bool fitIntercept)
+{
+  SoftmaxRegressionFunction<MatType> srf(dataset, labels, 3, lambda,
+      fitIntercept);
+  const arma::mat parameters = srf.GetInitialPoint();
+
+  for (size_t batchSize = 1; batchSize <= 20; batchSize *= 4)
+  {
+    for (size_t begin = 0; begin + batchSize <= dataset.n_cols; begin += 13)
+    {
+      arma::mat gradient;
+      arma::sp_mat sparseGradient;
+      srf.Gradient(parameters, begin, gradient, batchSize);
+      srf.Gradient(parameters, begin, sparseGradient, batchSize);
+
+      BOOST_REQUIRE_EQUAL(sparseGradient.n_rows, gradient.n_rows);
+      BOOST_REQUIRE_EQUAL(sparseGradient.n_cols, gradient.n_cols);
+
+      const arma::mat denseGradient(sparseGradient);
+      for (size_t i = 0; i < gradient.n_elem; ++i)
+      {
+        if (std::abs(gradient[i]) < 1e-10)
+          BOOST_REQUIRE_SMALL(denseGradient[i], 1e-10);
+        else
+          BOOST_REQUIRE_CLOSE(gradient[i], denseGradient[i], 1e-8);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionSparseGradientTest)
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(40, 200, 0.05);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = math::RandInt(0, 3);
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const double lambda = (i % 2 == 0) ? 0.0 : 0.1;
+    const bool fitIntercept = (i >= 2);
+    CheckSoftmaxSparseGradient(dataset, labels, lambda, fitIntercept);
+    CheckSoftmaxSparseGradient(arma::mat(dataset), labels, lambda,
+        fitIntercept);
+  }
+}
+
+/**
+ * Train softmax regression on sparse data and the same dense data, and make
+ * sure that the models and the predictions are the same.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionSparseTrainTest)
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(20, 600, 0.2);
+  const arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(600);
+  for (size_t i = 0; i < 600; ++i)
+    labels[i] = math::RandInt(0, 3);
+
+  SoftmaxRegression sr(dataset.n_rows, 3, true);
+  SoftmaxRegression srSparse(dataset.n_rows, 3, true);
+  srSparse.Parameters() = sr.Parameters();
+
+  sr.Train(denseDataset, labels, 3);
+  srSparse.Train(dataset, labels, 3);
+
+  BOOST_REQUIRE_EQUAL(sr.Parameters().n_elem, srSparse.Parameters().n_elem);
+  for (size_t i = 0; i < sr.Parameters().n_elem; ++i)
+  {
+    if (std::abs(sr.Parameters()[i]) < 1e-4)
+      BOOST_REQUIRE_SMALL(srSparse.Parameters()[i], 1e-4);
+    else
+      BOOST_REQUIRE_CLOSE(sr.Parameters()[i], srSparse.Parameters()[i], 1e-4);
+  }
+
+  arma::Row<size_t> predictions, sparsePredictions;
+  arma::mat probabilities, sparseProbabilities;
+  sr.Classify(denseDataset, predictions, probabilities);
+  sr.Classify(dataset, sparsePredictions, sparseProbabilities);
+
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], sparsePredictions[i]);
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(probabilities[i], sparseProbabilities[i], 1e-8);
+
+  BOOST_REQUIRE_CLOSE(sr.ComputeAccuracy(denseDataset, labels),
+      sr.ComputeAccuracy(dataset, labels), 1e-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
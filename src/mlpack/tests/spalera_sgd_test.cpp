@@ -86,4 +86,28 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionTest)
   }
 }
 
+/**
+ * Make sure that a batch split among the threads gives the same objective and
+ * gradient as a single call to EvaluateWithGradient().
+ */
+BOOST_AUTO_TEST_CASE(BatchEvaluateWithGradientTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 1000);
+  arma::Row<size_t> responses = arma::randi<arma::Row<size_t>>(1000,
+      arma::distr_param(0, 1));
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+
+  const arma::mat iterate = arma::randu<arma::mat>(1, 6);
+  arma::mat gradient, parallelGradient;
+  const double objective = lrf.EvaluateWithGradient(iterate, 100, gradient,
+      800);
+  const double parallelObjective = BatchEvaluateWithGradient(lrf, iterate,
+      100, parallelGradient, 800, true, 1);
+
+  BOOST_REQUIRE_CLOSE(parallelObjective, objective, 1e-8);
+  BOOST_REQUIRE_EQUAL(parallelGradient.n_elem, gradient.n_elem);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(parallelGradient[i], gradient[i], 1e-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,11 +11,13 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/sparse_autoencoder/sparse_autoencoder.hpp>
+#include <mlpack/core/optimizers/sgd/sgd.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
 using namespace mlpack;
+using namespace mlpack::optimization;
 using namespace mlpack::nn;
 
 BOOST_AUTO_TEST_SUITE(SparseAutoencoderTest);
@@ -268,4 +270,110 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionGradient)
   }
 }
 
+/**
+ * Make sure that the objective and gradient for a batch holding every point
+ * are those of the whole dataset, and that the reconstruction error and weight
+ * decay terms add up over smaller batches.
+ */
+BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionBatches)
+{
+  const size_t points = 1000;
+  const size_t vSize = 20;
+  const size_t hSize = 10;
+
+  arma::mat data;
+  data.randu(vSize, points);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize, 0.5, 3);
+  // Without the sparsity term, the batches decompose the objective exactly.
+  SparseAutoencoderFunction safNoKL(data, vSize, hSize, 0.5, 0);
+
+  BOOST_REQUIRE_EQUAL(saf.NumFunctions(), points);
+
+  arma::mat parameters;
+  parameters.randu(2 * hSize + 1, vSize + 1);
+
+  arma::mat gradient, fullGradient, sepGradient;
+  saf.Gradient(parameters, gradient);
+  const double objective = saf.Evaluate(parameters);
+
+  const double fullObjective = saf.EvaluateWithGradient(parameters, 0,
+      fullGradient, points);
+  BOOST_REQUIRE_CLOSE(fullObjective, objective, 1e-8);
+  BOOST_REQUIRE_CLOSE(saf.Evaluate(parameters, 0, points), objective, 1e-8);
+  BOOST_REQUIRE_EQUAL(fullGradient.n_rows, gradient.n_rows);
+  BOOST_REQUIRE_EQUAL(fullGradient.n_cols, gradient.n_cols);
+  saf.Gradient(parameters, 0, sepGradient, points);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    if (std::abs(gradient[i]) < 1e-10)
+    {
+      BOOST_REQUIRE_SMALL(fullGradient[i], 1e-10);
+      BOOST_REQUIRE_SMALL(sepGradient[i], 1e-10);
+    }
+    else
+    {
+      BOOST_REQUIRE_CLOSE(fullGradient[i], gradient[i], 1e-8);
+      BOOST_REQUIRE_CLOSE(sepGradient[i], gradient[i], 1e-8);
+    }
+  }
+
+  // Sum over batches of 100 points.
+  safNoKL.Gradient(parameters, gradient);
+  arma::mat sumGradient = arma::zeros<arma::mat>(gradient.n_rows,
+      gradient.n_cols);
+  double sumObjective = 0.0;
+  for (size_t begin = 0; begin < points; begin += 100)
+  {
+    arma::mat batchGradient;
+    sumObjective += safNoKL.EvaluateWithGradient(parameters, begin,
+        batchGradient, 100);
+    sumGradient += batchGradient;
+  }
+
+  BOOST_REQUIRE_CLOSE(sumObjective, safNoKL.Evaluate(parameters), 1e-8);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    if (std::abs(gradient[i]) < 1e-10)
+      BOOST_REQUIRE_SMALL(sumGradient[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(sumGradient[i], gradient[i], 1e-6);
+  }
+}
+
+/**
+ * Train a sparse autoencoder with mini-batch SGD and make sure the objective
+ * decreases.
+ */
+BOOST_AUTO_TEST_CASE(SparseAutoencoderMiniBatchSGDTest)
+{
+  const size_t vSize = 10;
+  const size_t hSize = 5;
+
+  arma::mat data;
+  data.randu(vSize, 500);
+
+  // Keep the data to make sure shuffling doesn't modify it.
+  const arma::mat originalData(data);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize);
+  arma::mat parameters = saf.GetInitialPoint();
+  const double initialObjective = saf.Evaluate(parameters);
+
+  StandardSGD sgd(0.1, 10, 50 * data.n_cols, 0.0, true);
+  const double objective = sgd.Optimize(saf, parameters);
+  BOOST_REQUIRE_LT(objective, initialObjective);
+
+  // The model can be trained with the same optimizer.
+  SparseAutoencoder encoder(data, vSize, hSize, 0.0001, 3, 0.01, sgd);
+
+  arma::mat features;
+  encoder.GetNewFeatures(data, features);
+  BOOST_REQUIRE_EQUAL(features.n_rows, hSize);
+  BOOST_REQUIRE_EQUAL(features.n_cols, data.n_cols);
+
+  for (size_t i = 0; i < data.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(data[i], originalData[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
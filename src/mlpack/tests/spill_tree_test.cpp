@@ -308,4 +308,50 @@ BOOST_AUTO_TEST_CASE(SpillTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+#ifdef HAS_OPENMP
+
+/**
+ * Check that two spill trees built from the same data are identical.
+ */
+template<typename TreeType>
+void CheckSameSpillTree(TreeType& node1, TreeType& node2)
+{
+  BOOST_REQUIRE_EQUAL(node1.NumChildren(), node2.NumChildren());
+  BOOST_REQUIRE_EQUAL(node1.NumPoints(), node2.NumPoints());
+  BOOST_REQUIRE_EQUAL(node1.NumDescendants(), node2.NumDescendants());
+  BOOST_REQUIRE_EQUAL(node1.Overlap(), node2.Overlap());
+  for (size_t i = 0; i < node1.NumPoints(); ++i)
+    BOOST_REQUIRE_EQUAL(node1.Point(i), node2.Point(i));
+
+  BOOST_REQUIRE_CLOSE(node1.ParentDistance() + 1.0,
+      node2.ParentDistance() + 1.0, 1e-10);
+  BOOST_REQUIRE_CLOSE(node1.FurthestDescendantDistance() + 1.0,
+      node2.FurthestDescendantDistance() + 1.0, 1e-10);
+
+  for (size_t i = 0; i < node1.NumChildren(); ++i)
+    CheckSameSpillTree(node1.Child(i), node2.Child(i));
+}
+
+/**
+ * Building a large spill tree in parallel should give exactly the same tree as
+ * building it serially.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSpillTreeBuildTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 200000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  TreeType serialTree(dataset, 0.01);
+
+  omp_set_num_threads(std::max(threads, 4));
+  TreeType tree(dataset, 0.01);
+  omp_set_num_threads(threads);
+
+  CheckSameSpillTree(tree, serialTree);
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
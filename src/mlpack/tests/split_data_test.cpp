@@ -170,4 +170,135 @@ BOOST_AUTO_TEST_CASE(SplitLabeledDataLargerTest)
   CheckDuplication(std::get<2>(value), std::get<3>(value));
 }
 
+/**
+ * Split a dataset in place, and make sure the outputs are aliases of the
+ * shuffled input that hold every point once.
+ */
+BOOST_AUTO_TEST_CASE(InPlaceSplitTest)
+{
+  mat input(100, 497);
+  input.randu();
+  // Put the column index in the first row, so the points can be identified.
+  for (size_t i = 0; i < input.n_cols; ++i)
+    input(0, i) = i;
+  const mat original(input);
+
+  Row<size_t> labels = arma::linspace<Row<size_t>>(0, input.n_cols - 1,
+      input.n_cols);
+
+  mat trainData, testData;
+  Row<size_t> trainLabels, testLabels;
+  InPlaceSplit(input, labels, trainData, testData, trainLabels, testLabels,
+      0.3);
+
+  const size_t testSize = size_t(0.3 * 497);
+  BOOST_REQUIRE_EQUAL(trainData.n_cols, 497 - testSize);
+  BOOST_REQUIRE_EQUAL(testData.n_cols, testSize);
+  BOOST_REQUIRE_EQUAL(trainLabels.n_elem, 497 - testSize);
+  BOOST_REQUIRE_EQUAL(testLabels.n_elem, testSize);
+  BOOST_REQUIRE_EQUAL(trainData.memptr(), input.memptr());
+  BOOST_REQUIRE_EQUAL(testData.memptr(), input.colptr(497 - testSize));
+  BOOST_REQUIRE_EQUAL(trainLabels.memptr(), labels.memptr());
+
+  // Every column is a column of the original dataset, with its label.
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t index = (size_t) input(0, i);
+    BOOST_REQUIRE_EQUAL(labels[i], index);
+    for (size_t d = 0; d < input.n_rows; ++d)
+      BOOST_REQUIRE_EQUAL(input(d, i), original(d, index));
+  }
+
+  CheckDuplication(trainLabels, testLabels);
+
+  // The unlabeled version.
+  mat input2(original);
+  InPlaceSplit(input2, trainData, testData, 0.3);
+  BOOST_REQUIRE_EQUAL(trainData.n_cols, 497 - testSize);
+  BOOST_REQUIRE_EQUAL(testData.n_cols, testSize);
+  CheckMatEqual(original, input2);
+}
+
+/**
+ * Make sure a stratified split keeps the proportion of every class.
+ */
+BOOST_AUTO_TEST_CASE(StratifiedSplitTest)
+{
+  mat input(3, 1000);
+  input.randu();
+  Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    labels[i] = (i < 500) ? 0 : ((i < 800) ? 1 : 2);
+  labels = arma::shuffle(labels);
+
+  mat trainData, testData;
+  Row<size_t> trainLabels, testLabels;
+  StratifiedSplit(input, labels, trainData, testData, trainLabels, testLabels,
+      0.2);
+
+  BOOST_REQUIRE_EQUAL(testData.n_cols, 200);
+  BOOST_REQUIRE_EQUAL(trainData.n_cols, 800);
+  BOOST_REQUIRE_EQUAL(arma::accu(testLabels == 0), 100);
+  BOOST_REQUIRE_EQUAL(arma::accu(testLabels == 1), 60);
+  BOOST_REQUIRE_EQUAL(arma::accu(testLabels == 2), 40);
+  BOOST_REQUIRE_EQUAL(arma::accu(trainLabels == 0), 400);
+  BOOST_REQUIRE_EQUAL(arma::accu(trainLabels == 1), 240);
+  BOOST_REQUIRE_EQUAL(arma::accu(trainLabels == 2), 160);
+
+  // The in-place version gives the same proportions.
+  mat input2(input);
+  Row<size_t> labels2(labels);
+  InPlaceSplit(input2, labels2, trainData, testData, trainLabels, testLabels,
+      0.2, true);
+  BOOST_REQUIRE_EQUAL(arma::accu(testLabels == 0), 100);
+  BOOST_REQUIRE_EQUAL(arma::accu(testLabels == 1), 60);
+  BOOST_REQUIRE_EQUAL(arma::accu(testLabels == 2), 40);
+  CheckMatEqual(input, input2);
+}
+
+/**
+ * Split a dataset from disk and make sure the two files hold the points of the
+ * dataset, in order.
+ */
+BOOST_AUTO_TEST_CASE(StreamingSplitTest)
+{
+  mat input(5, 1003);
+  input.randu();
+  for (size_t i = 0; i < input.n_cols; ++i)
+    input(0, i) = i;
+  input.save("split_input.bin", arma::arma_binary);
+
+  // Chunks of 100 points, so the last one is smaller.
+  StreamingDataset<> dataset("split_input.bin", 100);
+  const arma::uvec testIndices = StreamingSplit(dataset, "split_train.bin",
+      "split_test.bin", 0.25);
+
+  mat trainData, testData;
+  trainData.load("split_train.bin", arma::arma_binary);
+  testData.load("split_test.bin", arma::arma_binary);
+
+  BOOST_REQUIRE_EQUAL(testIndices.n_elem, size_t(0.25 * 1003));
+  BOOST_REQUIRE_EQUAL(testData.n_cols, testIndices.n_elem);
+  BOOST_REQUIRE_EQUAL(trainData.n_cols, 1003 - testIndices.n_elem);
+  BOOST_REQUIRE_EQUAL(trainData.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(testData.n_rows, 5);
+
+  // Merge the two sets back in order.
+  size_t train = 0, test = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const bool inTest = (test < testIndices.n_elem && testIndices[test] == i);
+    const mat& set = inTest ? testData : trainData;
+    const size_t j = inTest ? test++ : train++;
+    for (size_t d = 0; d < input.n_rows; ++d)
+      BOOST_REQUIRE_EQUAL(set(d, j), input(d, i));
+  }
+  BOOST_REQUIRE_EQUAL(test, testIndices.n_elem);
+  BOOST_REQUIRE_EQUAL(train, trainData.n_cols);
+
+  remove("split_input.bin");
+  remove("split_train.bin");
+  remove("split_test.bin");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,8 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/optimizers/svrg/svrg.hpp>
+#include <mlpack/core/optimizers/svrg/async_svrg.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/sparse_test_function.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -18,6 +20,7 @@
 
 using namespace mlpack;
 using namespace mlpack::optimization;
+using namespace mlpack::optimization::test;
 
 BOOST_AUTO_TEST_SUITE(SVRGTest);
 
@@ -74,4 +77,51 @@ BOOST_AUTO_TEST_CASE(SVRGBBLogisticRegressionTest)
   }
 }
 
+/**
+ * Computing the snapshot in parallel should give the same logistic regression
+ * model as computing it serially, up to the order of the floating point sums.
+ */
+BOOST_AUTO_TEST_CASE(SVRGParallelSnapshotTest)
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  // Don't shuffle, so that both runs visit the functions in the same order.
+  SVRG serialOptimizer(0.001, 35, 10, 0, 1e-5, false);
+  SVRG parallelOptimizer(0.001, 35, 10, 0, 1e-5, false, SVRGUpdate(),
+      NoDecay(), true, true);
+
+  LogisticRegression<> serialLr(shuffledData, shuffledResponses,
+      serialOptimizer, 0.5);
+  LogisticRegression<> parallelLr(shuffledData, shuffledResponses,
+      parallelOptimizer, 0.5);
+
+  CheckMatrices(serialLr.Parameters(), parallelLr.Parameters(), 1e-4);
+
+  const double acc = parallelLr.ComputeAccuracy(data, responses);
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 1.5); // 1.5% error tolerance.
+}
+
+/**
+ * Run asynchronous SVRG on a sparse function and make sure it finds the
+ * vertices of the parabolas.
+ */
+BOOST_AUTO_TEST_CASE(AsyncSVRGSparseTest)
+{
+  SparseTestFunction f;
+  AsyncSVRG optimizer(0.4, 1000, 0, 1e-8, true);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  const double result = optimizer.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_CLOSE(result, 123.75, 0.01);
+  BOOST_REQUIRE_CLOSE(coordinates[0], 2, 0.02);
+  BOOST_REQUIRE_CLOSE(coordinates[1], 1, 0.02);
+  BOOST_REQUIRE_CLOSE(coordinates[2], 1.5, 0.02);
+  BOOST_REQUIRE_CLOSE(coordinates[3], 4, 0.02);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
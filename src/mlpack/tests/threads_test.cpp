@@ -0,0 +1,139 @@
+/**
+ * @file threads_test.cpp
+ *
+ * Tests for the control of the number of threads used by mlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/parallel_blocks.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::util;
+
+BOOST_AUTO_TEST_SUITE(ThreadsTest);
+
+/**
+ * Make sure that SetNumThreads() sets the number of threads, and that
+ * ScopedNumThreads changes it only while it exists.
+ */
+BOOST_AUTO_TEST_CASE(SetNumThreadsTest)
+{
+  const size_t original = NumThreads();
+
+  SetNumThreads(3);
+#ifdef HAS_OPENMP
+  BOOST_REQUIRE_EQUAL(NumThreads(), 3);
+#else
+  BOOST_REQUIRE_EQUAL(NumThreads(), 1);
+#endif
+  if (BLASNumThreads() > 0)
+    BOOST_REQUIRE_EQUAL(BLASNumThreads(), 3);
+
+  {
+    ScopedNumThreads threads(2);
+#ifdef HAS_OPENMP
+    BOOST_REQUIRE_EQUAL(NumThreads(), 2);
+#endif
+    {
+      ScopedNumThreads innerThreads(1);
+      BOOST_REQUIRE_EQUAL(NumThreads(), 1);
+    }
+#ifdef HAS_OPENMP
+    BOOST_REQUIRE_EQUAL(NumThreads(), 2);
+#endif
+  }
+#ifdef HAS_OPENMP
+  BOOST_REQUIRE_EQUAL(NumThreads(), 3);
+#endif
+
+  // Using the number of processors gives at least one thread.
+  SetNumThreads(0);
+  BOOST_REQUIRE_GE(NumThreads(), 1);
+
+  SetNumThreads(original);
+}
+
+/**
+ * Make sure that SingleThreadedBLAS makes the BLAS library use one thread, and
+ * that the number of BLAS threads is restored when the last object is
+ * destroyed.
+ */
+BOOST_AUTO_TEST_CASE(SingleThreadedBLASTest)
+{
+  const size_t original = NumThreads();
+  SetNumThreads(4);
+  const size_t blasThreads = BLASNumThreads();
+
+  {
+    SingleThreadedBLAS outer;
+    if (blasThreads > 0 && NumThreads() > 1)
+      BOOST_REQUIRE_EQUAL(BLASNumThreads(), 1);
+
+    {
+      SingleThreadedBLAS inner;
+      if (blasThreads > 0 && NumThreads() > 1)
+        BOOST_REQUIRE_EQUAL(BLASNumThreads(), 1);
+    }
+
+    // The outer object still exists.
+    if (blasThreads > 0 && NumThreads() > 1)
+      BOOST_REQUIRE_EQUAL(BLASNumThreads(), 1);
+  }
+
+  BOOST_REQUIRE_EQUAL(BLASNumThreads(), blasThreads);
+
+  // A number of threads set inside a parallel region is used after it.
+  {
+    SingleThreadedBLAS singleThreadedBLAS;
+    SetNumThreads(2);
+    if (blasThreads > 0 && NumThreads() > 1)
+      BOOST_REQUIRE_EQUAL(BLASNumThreads(), 1);
+  }
+
+  if (blasThreads > 0)
+    BOOST_REQUIRE_EQUAL(BLASNumThreads(), 2);
+
+  SetNumThreads(original);
+}
+
+/**
+ * Make sure that ParallelBlocks() visits every point exactly once, in blocks
+ * of the right size, for batches smaller and larger than one block.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBlocksTest)
+{
+  const size_t sizes[] = { 0, 1, 99, 100, 101, 1000, 1234 };
+  for (size_t s = 0; s < 7; ++s)
+  {
+    const size_t numPoints = sizes[s];
+    arma::Col<size_t> visits(numPoints, arma::fill::zeros);
+    arma::Col<size_t> blockSizes(numPoints, arma::fill::zeros);
+    ParallelBlocks(numPoints, [&](const size_t begin, const size_t end)
+    {
+      for (size_t i = begin; i <= end; ++i)
+      {
+        ++visits[i];
+        blockSizes[i] = end - begin + 1;
+      }
+    }, 100);
+
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(visits[i], 1);
+      // Only the last block may be smaller.
+      if (i < (numPoints / 100) * 100)
+        BOOST_REQUIRE_EQUAL(blockSizes[i], 100);
+      else
+        BOOST_REQUIRE_EQUAL(blockSizes[i], numPoints % 100);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -19,6 +19,7 @@
 #endif
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/util/memory_usage.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -147,4 +148,214 @@ BOOST_AUTO_TEST_CASE(DisabledTimingTest)
   BOOST_REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
 
+/**
+ * Timers started while another timer is running should be recorded under a
+ * hierarchical path, with the right counts.
+ */
+BOOST_AUTO_TEST_CASE(NestedTimerStatisticsTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+
+  Timer::Start("outer_timer");
+  for (size_t i = 0; i < 3; ++i)
+  {
+    Timer::Start("inner_timer");
+    #ifdef _WIN32
+    Sleep(1);
+    #else
+    usleep(1000);
+    #endif
+    Timer::Stop("inner_timer");
+  }
+  Timer::Stop("outer_timer");
+
+  // A timer that is not nested has no parent.
+  Timer::Start("inner_timer");
+  Timer::Stop("inner_timer");
+
+  const TimerStatistics outer = Timer::GetStatistics("outer_timer");
+  const TimerStatistics nested =
+      Timer::GetStatistics("outer_timer/inner_timer");
+  const TimerStatistics inner = Timer::GetStatistics("inner_timer");
+
+  BOOST_REQUIRE_EQUAL(outer.count, 1);
+  BOOST_REQUIRE_EQUAL(nested.count, 3);
+  BOOST_REQUIRE_EQUAL(inner.count, 1);
+  BOOST_REQUIRE(nested.min <= nested.max);
+  BOOST_REQUIRE_GE(nested.min.count(), 1000);
+  BOOST_REQUIRE(nested.total <= outer.total);
+
+  // The flat timer sums all paths.
+  BOOST_REQUIRE(Timer::Get("inner_timer") == nested.total + inner.total);
+
+  Timer::ResetAll();
+  Timer::DisableTiming();
+}
+
+/**
+ * A ScopedTimer should stop its timer when it goes out of scope, even if an
+ * exception is thrown.
+ */
+BOOST_AUTO_TEST_CASE(ScopedTimerTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+
+  {
+    ScopedTimer t("scoped_timer");
+    #ifdef _WIN32
+    Sleep(10);
+    #else
+    usleep(10000);
+    #endif
+  }
+
+  BOOST_REQUIRE(!CLI::GetSingleton().timer.GetState("scoped_timer",
+      std::this_thread::get_id()));
+  BOOST_REQUIRE_GE(Timer::Get("scoped_timer").count(), 10000);
+
+  try
+  {
+    ScopedTimer t("scoped_timer");
+    throw std::runtime_error("error");
+  }
+  catch (std::runtime_error&) { }
+
+  BOOST_REQUIRE(!CLI::GetSingleton().timer.GetState("scoped_timer",
+      std::this_thread::get_id()));
+  BOOST_REQUIRE_EQUAL(Timer::GetStatistics("scoped_timer").count, 2);
+
+  Timer::ResetAll();
+  Timer::DisableTiming();
+}
+
+/**
+ * Make sure that timers run on different threads are attributed to different
+ * threads, and that they are all written to the trace.
+ */
+BOOST_AUTO_TEST_CASE(TimerTraceTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+
+  Timer::Start("trace_timer");
+  std::thread threads[3];
+  for (size_t i = 0; i < 3; ++i)
+  {
+    threads[i] = std::thread([]()
+        {
+          Timer::Start("thread_timer");
+          Timer::Stop("thread_timer");
+        });
+  }
+
+  for (size_t i = 0; i < 3; ++i)
+    threads[i].join();
+  Timer::Stop("trace_timer");
+
+  // The main thread and each of the three threads.
+  std::map<size_t, std::map<std::string, TimerStatistics>> threadStatistics =
+      CLI::GetSingleton().timer.GetThreadStatistics();
+  BOOST_REQUIRE_EQUAL(threadStatistics.size(), 4);
+  BOOST_REQUIRE_EQUAL(Timer::GetStatistics("thread_timer").count, 3);
+
+  std::ostringstream stream;
+  CLI::GetSingleton().timer.WriteTrace(stream);
+  const std::string trace = stream.str();
+
+  BOOST_REQUIRE_NE(trace.find("\"traceEvents\""), std::string::npos);
+  BOOST_REQUIRE_NE(trace.find("\"name\": \"trace_timer\""), std::string::npos);
+  BOOST_REQUIRE_NE(trace.find("\"thread_timer\": {\"count\": 3"),
+      std::string::npos);
+
+  // One complete event for each run.
+  size_t numEvents = 0;
+  for (size_t pos = trace.find("\"ph\": \"X\""); pos != std::string::npos;
+       pos = trace.find("\"ph\": \"X\"", pos + 1))
+    ++numEvents;
+  BOOST_REQUIRE_EQUAL(numEvents, 4);
+
+  Timer::ResetAll();
+  Timer::DisableTiming();
+}
+
+/**
+ * Make sure that counters are recorded under the innermost running timer,
+ * ignored when timing is disabled, and written to the trace.
+ */
+BOOST_AUTO_TEST_CASE(TimerCounterTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+
+  Timer::AddCounter("top_counter", 2);
+  Timer::Start("counter_timer");
+  Timer::AddCounter("inner_counter");
+  Timer::AddCounter("inner_counter", 4);
+  Timer::Stop("counter_timer");
+
+  BOOST_REQUIRE_EQUAL(Timer::GetCounter("top_counter"), 2);
+  BOOST_REQUIRE_EQUAL(Timer::GetCounter("counter_timer/inner_counter"), 5);
+  BOOST_REQUIRE_EQUAL(Timer::GetCounter("inner_counter"), 0);
+
+  std::ostringstream stream;
+  CLI::GetSingleton().timer.WriteTrace(stream);
+  BOOST_REQUIRE_NE(stream.str().find(
+      "\"counter_timer/inner_counter\": 5"), std::string::npos);
+
+  Timer::DisableTiming();
+  Timer::AddCounter("top_counter", 2);
+  BOOST_REQUIRE_EQUAL(Timer::GetCounter("top_counter"), 2);
+
+  Timer::ResetAll();
+  BOOST_REQUIRE_EQUAL(Timer::GetCounter("top_counter"), 0);
+}
+
+/**
+ * Make sure that the memory used while a timer runs is recorded when memory
+ * tracking is enabled.
+ */
+BOOST_AUTO_TEST_CASE(TimerMemoryTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+
+  // Without memory tracking, nothing is recorded.
+  Timer::Start("untracked_timer");
+  Timer::Stop("untracked_timer");
+  BOOST_REQUIRE_EQUAL(Timer::GetMemoryStatistics("untracked_timer").peak, 0);
+
+  Timer::EnableMemoryTracking(1);
+  Timer::Start("memory_timer");
+  {
+    // Touch 64MB, so that it is resident.
+    arma::vec data(8 * 1024 * 1024);
+    data.fill(1.0);
+    BOOST_REQUIRE_EQUAL(arma::accu(data), data.n_elem);
+
+    // Give the sampling thread time to see the memory.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  Timer::Stop("memory_timer");
+  Timer::DisableMemoryTracking();
+
+  const MemoryStatistics m = Timer::GetMemoryStatistics("memory_timer");
+  if (util::ResidentMemory() > 0)
+  {
+    BOOST_REQUIRE_GE(m.peak, m.current);
+    BOOST_REQUIRE_GE(m.growth, 32 * 1024 * 1024);
+    BOOST_REQUIRE_GE(util::PeakResidentMemory(), m.peak);
+  }
+
+  std::ostringstream stream;
+  CLI::GetSingleton().timer.WriteTrace(stream);
+  BOOST_REQUIRE_NE(stream.str().find("\"memory\": {"), std::string::npos);
+  BOOST_REQUIRE_NE(stream.str().find("\"memory_timer\": {\"peak_bytes\""),
+      std::string::npos);
+
+  Timer::DisableTiming();
+  Timer::ResetAll();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1359,6 +1359,200 @@ BOOST_AUTO_TEST_CASE(KdTreeTest)
   TreeType root(dataset);
 }
 
+/**
+ * Make sure the two trees have the same structure, points and bounds.
+ */
+template<typename TreeType>
+void CheckSameTree(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_CLOSE(a.ParentDistance() + 1.0, b.ParentDistance() + 1.0,
+      1e-10);
+  BOOST_REQUIRE_CLOSE(a.FurthestDescendantDistance() + 1.0,
+      b.FurthestDescendantDistance() + 1.0, 1e-10);
+
+  arma::vec aCenter, bCenter;
+  a.Center(aCenter);
+  b.Center(bCenter);
+  CheckMatrices(aCenter, bCenter, 1e-10);
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Packing the nodes of a tree should not change it, and every node below the
+ * root should then be in one block, in preorder.
+ */
+BOOST_AUTO_TEST_CASE(PackedKDTreeTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset(4, 5000, arma::fill::randu);
+  TreeType tree(dataset);
+  TreeType copy(tree);
+
+  BOOST_REQUIRE(!tree.IsPacked());
+  tree.PackNodes();
+  BOOST_REQUIRE(tree.IsPacked());
+  tree.PackNodes();
+  CheckSameTree(tree, copy);
+  CheckPointBounds(tree);
+
+  // In preorder, the left child directly follows its parent, and every node
+  // directly follows the last node of the subtree before it.
+  std::stack<TreeType*> stack;
+  stack.push(tree.Right());
+  stack.push(tree.Left());
+  TreeType* last = NULL;
+  while (!stack.empty())
+  {
+    TreeType* node = stack.top();
+    stack.pop();
+    BOOST_REQUIRE(node == (last ? last + 1 : tree.Left()));
+    last = node;
+
+    if (!node->IsLeaf())
+    {
+      stack.push(node->Right());
+      stack.push(node->Left());
+    }
+  }
+
+  // Moving the tree keeps the block.
+  TreeType moved(std::move(tree));
+  BOOST_REQUIRE(moved.IsPacked());
+  BOOST_REQUIRE(!tree.IsPacked());
+  BOOST_REQUIRE_EQUAL(moved.Left()->Parent(), &moved);
+  CheckSameTree(moved, copy);
+
+  // A copy of a packed tree is a regular tree.
+  TreeType copy2(moved);
+  BOOST_REQUIRE(!copy2.IsPacked());
+  CheckSameTree(copy2, copy);
+}
+
+/**
+ * Check that the bound of every node of a kd-tree is the tightest bound of its
+ * points, and that the furthest descendant distances match.
+ */
+template<typename TreeType>
+void CheckTightBounds(const TreeType& node)
+{
+  const arma::mat points = node.Dataset().cols(node.Begin(),
+      node.Begin() + node.Count() - 1);
+  const arma::vec minima = arma::min(points, 1);
+  const arma::vec maxima = arma::max(points, 1);
+  for (size_t d = 0; d < points.n_rows; ++d)
+  {
+    BOOST_REQUIRE_EQUAL(node.Bound()[d].Lo(), minima[d]);
+    BOOST_REQUIRE_EQUAL(node.Bound()[d].Hi(), maxima[d]);
+  }
+
+  BOOST_REQUIRE_CLOSE(node.FurthestDescendantDistance(),
+      0.5 * node.Bound().Diameter(), 1e-10);
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    CheckTightBounds(node.Child(i));
+}
+
+/**
+ * After the points of a kd-tree are transformed, RefitBounds() should give
+ * every node the bound of its points again, without moving any point.
+ */
+BOOST_AUTO_TEST_CASE(RefitKDTreeTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset(3, 3000, arma::fill::randu);
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew);
+
+  arma::mat transformation = arma::eye<arma::mat>(3, 3) +
+      0.2 * arma::randu<arma::mat>(3, 3);
+  tree.Dataset() = transformation * tree.Dataset();
+  tree.RefitBounds();
+
+  BOOST_REQUIRE(CheckPointBounds(tree));
+  CheckTightBounds(tree);
+
+  // The points are still in the same place in the tree.
+  arma::mat transformed = transformation * dataset;
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    for (size_t d = 0; d < 3; ++d)
+    {
+      BOOST_REQUIRE_CLOSE(tree.Dataset()(d, i),
+          transformed(d, oldFromNew[i]), 1e-10);
+    }
+  }
+
+  // The parent distances are those between the centers of the new bounds.
+  std::stack<TreeType*> stack;
+  stack.push(&tree);
+  while (!stack.empty())
+  {
+    TreeType* node = stack.top();
+    stack.pop();
+    if (node->IsLeaf())
+      continue;
+
+    arma::vec center, childCenter;
+    node->Center(center);
+    for (size_t i = 0; i < 2; ++i)
+    {
+      node->Child(i).Center(childCenter);
+      BOOST_REQUIRE_CLOSE(node->Child(i).ParentDistance() + 1.0,
+          EuclideanDistance::Evaluate(center, childCenter) + 1.0, 1e-10);
+      stack.push(&node->Child(i));
+    }
+  }
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Building a large tree in parallel should give exactly the same tree as
+ * building it serially.
+ */
+template<typename TreeType>
+void CheckParallelBuild()
+{
+  arma::mat dataset(3, 200000, arma::fill::randu);
+
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  std::vector<size_t> serialOldFromNew;
+  TreeType serialTree(dataset, serialOldFromNew);
+
+  omp_set_num_threads(std::max(threads, 4));
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew);
+  omp_set_num_threads(threads);
+
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), serialOldFromNew.size());
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(oldFromNew[i], serialOldFromNew[i]);
+  CheckMatrices(tree.Dataset(), serialTree.Dataset());
+
+  CheckSameTree(tree, serialTree);
+  CheckPointBounds(tree);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelKDTreeBuildTest)
+{
+  CheckParallelBuild<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+}
+
+BOOST_AUTO_TEST_CASE(ParallelBallTreeBuildTest)
+{
+  CheckParallelBuild<BallTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+}
+
+#endif
+
 BOOST_AUTO_TEST_CASE(MaxRPTreeTest)
 {
   typedef MaxRPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
@@ -1926,6 +2120,51 @@ BOOST_AUTO_TEST_CASE(CoverTreeConstructionTest)
   // implementation.
 }
 
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure two cover trees have the same structure.
+ */
+template<typename TreeType>
+void CheckSameCoverTree(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Point(), b.Point());
+  BOOST_REQUIRE_EQUAL(a.Scale(), b.Scale());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_EQUAL(a.NumDescendants(), b.NumDescendants());
+  BOOST_REQUIRE_EQUAL(a.ParentDistance(), b.ParentDistance());
+  BOOST_REQUIRE_EQUAL(a.FurthestDescendantDistance(),
+      b.FurthestDescendantDistance());
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameCoverTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * A cover tree built with several threads should be the same as one built
+ * serially.
+ */
+BOOST_AUTO_TEST_CASE(ParallelCoverTreeConstructionTest)
+{
+  arma::mat dataset(5, 20000, arma::fill::randu);
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  TreeType serialTree(dataset);
+
+  omp_set_num_threads(std::max(threads, 4));
+  TreeType tree(dataset);
+  omp_set_num_threads(threads);
+
+  BOOST_REQUIRE_EQUAL(tree.DistanceComps(), serialTree.DistanceComps());
+  CheckSameCoverTree(tree, serialTree);
+}
+
+#endif
+
 /**
  * Create a cover tree on sparse data and make sure it's accurate.
  */
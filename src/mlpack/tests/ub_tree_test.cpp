@@ -49,6 +49,114 @@ BOOST_AUTO_TEST_CASE(AddressTest)
   }
 }
 
+/**
+ * Interleave the bits of the values one bit at a time.
+ */
+template<typename AddressElemType>
+void ReferenceInterleave(const arma::Col<AddressElemType>& values,
+                         arma::Col<AddressElemType>& address)
+{
+  constexpr size_t order = sizeof(AddressElemType) * CHAR_BIT;
+  address.zeros(values.n_elem);
+  for (size_t i = 0; i < order; i++)
+    for (size_t j = 0; j < values.n_elem; j++)
+    {
+      size_t bit = (i * values.n_elem + j) % order;
+      size_t row = (i * values.n_elem + j) / order;
+
+      address(row) |= (((values(j) >> (order - 1 - i)) & 1) <<
+          (order - 1 - bit));
+    }
+}
+
+template<typename AddressElemType>
+void CheckInterleave(const size_t dimensionality)
+{
+  arma::Col<AddressElemType> values(dimensionality);
+  arma::Col<AddressElemType> address(dimensionality);
+  arma::Col<AddressElemType> reference;
+  arma::Col<AddressElemType> recovered(dimensionality);
+  const addr::BitInterleaver<AddressElemType> interleaver(dimensionality);
+
+  for (size_t trial = 0; trial < 20; trial++)
+  {
+    for (size_t i = 0; i < dimensionality; i++)
+    {
+      values[i] = 0;
+      for (size_t k = 0; k < sizeof(AddressElemType); k++)
+        values[i] = (values[i] << 8) | (AddressElemType) RandInt(256);
+    }
+
+    interleaver.Interleave(values, address);
+    ReferenceInterleave(values, reference);
+    for (size_t i = 0; i < dimensionality; i++)
+      BOOST_REQUIRE_EQUAL(address[i], reference[i]);
+
+    interleaver.Deinterleave(address, recovered);
+    for (size_t i = 0; i < dimensionality; i++)
+      BOOST_REQUIRE_EQUAL(recovered[i], values[i]);
+  }
+}
+
+/**
+ * Make sure the field-based bit interleaving matches the bit-by-bit one, for
+ * dimensionalities that do and don't divide the number of bits, and for more
+ * dimensions than bits.
+ */
+BOOST_AUTO_TEST_CASE(BitInterleaverTest)
+{
+  const size_t dims[] = { 1, 2, 3, 5, 8, 13, 32, 64, 70 };
+  for (size_t d : dims)
+  {
+    CheckInterleave<uint64_t>(d);
+    CheckInterleave<uint32_t>(d);
+  }
+}
+
+/**
+ * Make sure that the batch address computation gives the same addresses as
+ * PointToAddress(), and that SortAddresses() sorts them.
+ */
+BOOST_AUTO_TEST_CASE(SortedAddressesTest)
+{
+  arma::mat dataset(5, 1000);
+  dataset.randn();
+  // Add some duplicate points.
+  dataset.cols(900, 999) = dataset.cols(0, 99);
+
+  arma::Mat<uint64_t> addresses;
+  addr::PointsToAddresses(addresses, dataset);
+
+  BOOST_REQUIRE_EQUAL(addresses.n_rows, dataset.n_rows);
+  BOOST_REQUIRE_EQUAL(addresses.n_cols, dataset.n_cols);
+
+  arma::Col<uint64_t> address(dataset.n_rows);
+  for (size_t i = 0; i < dataset.n_cols; i++)
+  {
+    addr::PointToAddress(address, dataset.col(i));
+    for (size_t k = 0; k < dataset.n_rows; k++)
+      BOOST_REQUIRE_EQUAL(addresses(k, i), address[k]);
+  }
+
+  std::vector<size_t> order;
+  addr::SortAddresses(addresses, order);
+
+  BOOST_REQUIRE_EQUAL(order.size(), dataset.n_cols);
+  std::vector<bool> seen(dataset.n_cols, false);
+  for (size_t i = 0; i < order.size(); i++)
+  {
+    BOOST_REQUIRE_LT(order[i], dataset.n_cols);
+    BOOST_REQUIRE(!seen[order[i]]);
+    seen[order[i]] = true;
+
+    if (i > 0)
+    {
+      BOOST_REQUIRE_LE(addr::CompareAddresses(addresses.col(order[i - 1]),
+          addresses.col(order[i])), 0);
+    }
+  }
+}
+
 template<typename TreeType>
 void CheckSplit(const TreeType& tree)
 {
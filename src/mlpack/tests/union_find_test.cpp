@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include <boost/test/unit_test.hpp>
@@ -51,4 +52,63 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
 
+BOOST_AUTO_TEST_CASE(TestConcurrentUnion)
+{
+  static const size_t testSize = 10;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  for (size_t i = 0; i < testSize; i++)
+    BOOST_REQUIRE(testUnionFind.Find(i) == i);
+
+  BOOST_REQUIRE(testUnionFind.Union(0, 1));
+  BOOST_REQUIRE(testUnionFind.Union(2, 3));
+  BOOST_REQUIRE(testUnionFind.Union(0, 2));
+  BOOST_REQUIRE(testUnionFind.Union(5, 0));
+  BOOST_REQUIRE(testUnionFind.Union(0, 6));
+
+  // These are already in the same component.
+  BOOST_REQUIRE(!testUnionFind.Union(3, 6));
+
+  BOOST_REQUIRE(testUnionFind.Find(0) == testUnionFind.Find(1));
+  BOOST_REQUIRE(testUnionFind.Find(2) == testUnionFind.Find(3));
+  BOOST_REQUIRE(testUnionFind.Find(1) == testUnionFind.Find(5));
+  BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
+  BOOST_REQUIRE(testUnionFind.Find(4) == 4);
+}
+
+/**
+ * Merge from many threads at once, and make sure exactly the right number of
+ * merges succeed and the components are right.
+ */
+BOOST_AUTO_TEST_CASE(TestConcurrentUnionParallel)
+{
+  static const size_t testSize = 100000;
+  static const size_t numComponents = 7;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  // Merge each point with a random point of the same residue class.
+  arma::Col<size_t> partners(testSize);
+  for (size_t i = 0; i < testSize; ++i)
+  {
+    const size_t classSize = (testSize - (i % numComponents) +
+        numComponents - 1) / numComponents;
+    partners[i] = (i % numComponents) + numComponents *
+        math::RandInt(classSize);
+  }
+
+  size_t merges = 0;
+  #pragma omp parallel for reduction(+:merges)
+  for (omp_size_t i = 0; i < (omp_size_t) testSize; ++i)
+  {
+    if (testUnionFind.Union(i, partners[i]))
+      ++merges;
+    if (testUnionFind.Union(i, i % numComponents))
+      ++merges;
+  }
+
+  BOOST_REQUIRE_EQUAL(merges, testSize - numComponents);
+  for (size_t i = 0; i < testSize; ++i)
+    BOOST_REQUIRE_EQUAL(testUnionFind.Find(i), i % numComponents);
+}
+
 BOOST_AUTO_TEST_SUITE_END();